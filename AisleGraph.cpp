@@ -0,0 +1,599 @@
+#include "AisleGraph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "PolygonBvh.hpp"
+#include "Trace.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr float AISLE_UNREACHED = std::numeric_limits<float>::max();
+		constexpr float AISLE_SQRT2 = 1.41421356F;
+
+		// Largest grid a build allocates: 4M cells, about 40 MB with edges and tables
+		constexpr std::size_t MAX_GRID_CELLS = 4U * 1024U * 1024U;
+
+		// How far nodeAt() looks for a node around a point that is not on one
+		constexpr int NODE_SEARCH_RINGS = 8;
+
+		// Cached route nodes kept before the cache starts over: 16 MB
+		constexpr std::size_t MAX_CACHED_ROUTE_NODES = 4U * 1024U * 1024U;
+
+		// Min-heap on f for std::push_heap / std::pop_heap
+		template <typename Entry>
+		[[nodiscard]] bool laterOpenEntry(const Entry& a, const Entry& b) noexcept {
+			return a.f > b.f;
+		}
+
+		[[nodiscard]] float segmentDistanceSq(const sf::Vector2f& point, const WallSegment& wall) noexcept {
+			const sf::Vector2f span = wall.to - wall.from;
+			const float lengthSq = span.x * span.x + span.y * span.y;
+			float t = 0.0F;
+			if (lengthSq > 0.0F) {
+				t = std::clamp(((point.x - wall.from.x) * span.x + (point.y - wall.from.y) * span.y) / lengthSq, 0.0F, 1.0F);
+			}
+			const sf::Vector2f offset = point - (wall.from + span * t);
+			return offset.x * offset.x + offset.y * offset.y;
+		}
+
+		[[nodiscard]] sf::Vector2f bayCentre(const sf::FloatRect& bay) noexcept {
+			return bay.position + bay.size * 0.5F;
+		}
+	}
+
+	void AisleGraph::build(const Scene& scene, const sf::FloatRect& area, const AisleGraphConfig& config) {
+		OKPP_TRACE_SCOPE("aisle graph build");
+		float cell = (config.cellSize > 0.0F) ? config.cellSize : AisleGraphConfig{}.cellSize;
+		const auto columnsFor = [&area](float size) { return std::max(1, static_cast<int>(std::ceil(area.size.x / size))); };
+		const auto rowsFor = [&area](float size) { return std::max(1, static_cast<int>(std::ceil(area.size.y / size))); };
+		while (static_cast<std::size_t>(columnsFor(cell)) * static_cast<std::size_t>(rowsFor(cell)) > MAX_GRID_CELLS) {
+			cell *= 2.0F;
+		}
+		m_origin = area.position;
+		m_cellSize = cell;
+		m_cols = columnsFor(cell);
+		m_rows = rowsFor(cell);
+
+		// A cell is blocked if its centre is within half a cell plus the clearance of a shape,
+		// or if it overlaps a bay at all: bays are reached from their entries, never driven through
+		const std::size_t cells = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+		std::vector<std::uint8_t> blocked(cells, 0U);
+		const float half = cell * 0.5F;
+		const float reach = half + std::max(config.clearance, 0.0F);
+		const auto centre = [&](int cx, int cy) {
+			return m_origin + sf::Vector2f{ (static_cast<float>(cx) + 0.5F) * cell, (static_cast<float>(cy) + 0.5F) * cell };
+		};
+		const auto forCells = [&](const sf::Vector2f& low, const sf::Vector2f& high, auto&& visit) {
+			const int x0 = std::clamp(static_cast<int>(std::floor((low.x - m_origin.x) / cell)), 0, m_cols - 1);
+			const int y0 = std::clamp(static_cast<int>(std::floor((low.y - m_origin.y) / cell)), 0, m_rows - 1);
+			const int x1 = std::clamp(static_cast<int>(std::floor((high.x - m_origin.x) / cell)), 0, m_cols - 1);
+			const int y1 = std::clamp(static_cast<int>(std::floor((high.y - m_origin.y) / cell)), 0, m_rows - 1);
+			for (int cy = y0; cy <= y1; ++cy) {
+				for (int cx = x0; cx <= x1; ++cx) {
+					std::uint8_t& state = blocked[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(cx)];
+					if (state == 0U && visit(centre(cx, cy))) {
+						state = 1U;
+					}
+				}
+			}
+		};
+		for (const Obstacle& obstacle : scene.obstacles) {
+			const float radius = obstacle.radius + reach;
+			const sf::Vector2f extent{ radius, radius };
+			forCells(obstacle.center - extent, obstacle.center + extent, [&](const sf::Vector2f& at) {
+				const sf::Vector2f offset = at - obstacle.center;
+				return offset.x * offset.x + offset.y * offset.y < radius * radius;
+			});
+		}
+		for (const WallSegment& wall : scene.walls) {
+			const sf::Vector2f low{ std::min(wall.from.x, wall.to.x) - reach, std::min(wall.from.y, wall.to.y) - reach };
+			const sf::Vector2f high{ std::max(wall.from.x, wall.to.x) + reach, std::max(wall.from.y, wall.to.y) + reach };
+			forCells(low, high, [&](const sf::Vector2f& at) { return segmentDistanceSq(at, wall) < reach * reach; });
+		}
+		for (const sf::FloatRect& bay : scene.parkBays) {
+			const sf::Vector2f low = bay.position - sf::Vector2f{ half, half };
+			const sf::Vector2f high = bay.position + bay.size + sf::Vector2f{ half, half };
+			forCells(low, high, [&](const sf::Vector2f& at) {
+				return at.x > low.x && at.x < high.x && at.y > low.y && at.y < high.y;
+			});
+		}
+		if (!scene.polygons.empty()) {
+			PolygonBvh polygons;
+			polygons.build(scene.polygons);
+			forCells(m_origin, m_origin + area.size, [&](const sf::Vector2f& at) {
+				return polygons.nearestSq(at, reach * reach) < reach * reach;
+			});
+		}
+
+		m_cellNode.assign(cells, NONE);
+		m_nodeCell.clear();
+		for (std::size_t c = 0U; c < cells; ++c) {
+			if (blocked[c] == 0U) {
+				m_cellNode[c] = static_cast<std::uint32_t>(m_nodeCell.size());
+				m_nodeCell.push_back(static_cast<std::uint32_t>(c));
+			}
+		}
+		buildEdges(blocked);
+		buildAisles(scene, config.maxAisleCells);
+
+		// Bays hang off the nearest node that is outside them
+		m_bayEntry.assign(scene.parkBays.size(), NONE);
+		m_bayApproach.assign(scene.parkBays.size(), 0.0F);
+		for (std::size_t bay = 0U; bay < scene.parkBays.size(); ++bay) {
+			const sf::FloatRect& rect = scene.parkBays[bay];
+			const int rings = static_cast<int>(std::ceil(std::max(rect.size.x, rect.size.y) * 0.5F / cell)) + NODE_SEARCH_RINGS;
+			const sf::Vector2f target = bayCentre(rect);
+			m_bayEntry[bay] = nearestNode(target, rings);
+			if (m_bayEntry[bay] != NONE) {
+				const sf::Vector2f offset = position(m_bayEntry[bay]) - target;
+				m_bayApproach[bay] = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+			}
+		}
+		m_entryStart.assign(m_nodeCell.size() + 1U, 0U);
+		for (const std::uint32_t entry : m_bayEntry) {
+			if (entry != NONE) {
+				++m_entryStart[entry + 1U];
+			}
+		}
+		for (std::size_t node = 0U; node < m_nodeCell.size(); ++node) {
+			m_entryStart[node + 1U] += m_entryStart[node];
+		}
+		m_entryBays.assign(m_entryStart.back(), 0U);
+		std::vector<std::uint32_t> filled(m_entryStart.begin(), m_entryStart.end() - 1);
+		for (std::uint32_t bay = 0U; bay < m_bayEntry.size(); ++bay) {
+			if (m_bayEntry[bay] != NONE) {
+				m_entryBays[filled[m_bayEntry[bay]]++] = bay;
+			}
+		}
+		buildLandmarks(std::min(config.landmarks, MAX_LANDMARKS));
+	}
+
+	void AisleGraph::buildEdges(const std::vector<std::uint8_t>& blocked) {
+		const auto open = [&](int cx, int cy) {
+			return cx >= 0 && cy >= 0 && cx < m_cols && cy < m_rows
+				&& blocked[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(cx)] == 0U;
+		};
+		constexpr int NEIGHBOURS[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+		m_edgeStart.assign(m_nodeCell.size() + 1U, 0U);
+		m_edges.clear();
+		for (std::size_t node = 0U; node < m_nodeCell.size(); ++node) {
+			m_edgeStart[node] = static_cast<std::uint32_t>(m_edges.size());
+			const int cx = static_cast<int>(m_nodeCell[node] % static_cast<std::uint32_t>(m_cols));
+			const int cy = static_cast<int>(m_nodeCell[node] / static_cast<std::uint32_t>(m_cols));
+			for (std::size_t n = 0U; n < 8U; ++n) {
+				const int nx = cx + NEIGHBOURS[n][0];
+				const int ny = cy + NEIGHBOURS[n][1];
+				// A diagonal step needs both cells beside it open, so no route clips a pillar's corner
+				if (!open(nx, ny) || (n >= 4U && (!open(nx, cy) || !open(cx, ny)))) {
+					continue;
+				}
+				m_edges.push_back({ m_cellNode[static_cast<std::size_t>(ny) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(nx)],
+					(n < 4U) ? m_cellSize : m_cellSize * AISLE_SQRT2 });
+			}
+		}
+		m_edgeStart.back() = static_cast<std::uint32_t>(m_edges.size());
+
+		// Components by flood fill, so a route between two never searches
+		m_component.assign(m_nodeCell.size(), NONE);
+		std::vector<std::uint32_t> stack;
+		std::uint32_t components = 0U;
+		for (std::uint32_t seed = 0U; seed < m_nodeCell.size(); ++seed) {
+			if (m_component[seed] != NONE) {
+				continue;
+			}
+			m_component[seed] = components;
+			stack.push_back(seed);
+			while (!stack.empty()) {
+				const std::uint32_t node = stack.back();
+				stack.pop_back();
+				for (std::uint32_t e = m_edgeStart[node]; e < m_edgeStart[node + 1U]; ++e) {
+					if (m_component[m_edges[e].to] == NONE) {
+						m_component[m_edges[e].to] = components;
+						stack.push_back(m_edges[e].to);
+					}
+				}
+			}
+			++components;
+		}
+	}
+
+	void AisleGraph::buildAisles(const Scene& scene, std::uint32_t maxAisleCells) {
+		// Capacity in car lengths, the car lying along the aisle
+		const float carLength = std::max(2.0F * std::max(scene.carHalfExtent.x, scene.carHalfExtent.y), m_cellSize);
+		const std::uint32_t longest = std::max(maxAisleCells, 1U);
+		m_nodeAisle.assign(m_nodeCell.size(), NONE);
+		m_aisleCapacity.clear();
+		std::uint32_t runCells = 0U;
+		std::uint32_t previousCell = NONE;
+		for (std::uint32_t node = 0U; node < m_nodeCell.size(); ++node) {
+			const std::uint32_t cellIndex = m_nodeCell[node];
+			const bool continues = previousCell != NONE && cellIndex == previousCell + 1U
+				&& (cellIndex % static_cast<std::uint32_t>(m_cols)) != 0U && runCells < longest;
+			if (!continues) {
+				m_aisleCapacity.push_back(0U);
+				runCells = 0U;
+			}
+			++runCells;
+			m_nodeAisle[node] = static_cast<std::uint32_t>(m_aisleCapacity.size() - 1U);
+			m_aisleCapacity.back() = std::max(1U, static_cast<std::uint32_t>(static_cast<float>(runCells) * m_cellSize / carLength));
+			previousCell = cellIndex;
+		}
+	}
+
+	void AisleGraph::buildLandmarks(std::uint32_t count) {
+		const std::size_t nodes = m_nodeCell.size();
+		m_landmarkCount = (nodes == 0U) ? 0U : count;
+		m_landmarkDistance.assign(static_cast<std::size_t>(m_landmarkCount) * nodes, AISLE_UNREACHED);
+
+		struct Settle {
+			float f = 0.0F;
+			std::uint32_t node = 0U;
+		};
+		std::vector<Settle> open;
+		const auto distancesFrom = [&](std::uint32_t source, float* distance) {
+			distance[source] = 0.0F;
+			open.push_back({ 0.0F, source });
+			while (!open.empty()) {
+				std::pop_heap(open.begin(), open.end(), laterOpenEntry<Settle>);
+				const Settle entry = open.back();
+				open.pop_back();
+				if (entry.f > distance[entry.node]) {
+					continue;
+				}
+				for (std::uint32_t e = m_edgeStart[entry.node]; e < m_edgeStart[entry.node + 1U]; ++e) {
+					const float reached = entry.f + m_edges[e].length;
+					if (reached < distance[m_edges[e].to]) {
+						distance[m_edges[e].to] = reached;
+						open.push_back({ reached, m_edges[e].to });
+						std::push_heap(open.begin(), open.end(), laterOpenEntry<Settle>);
+					}
+				}
+			}
+		};
+
+		// Farthest-first: each landmark is the node farthest from those before it (a node no
+		// landmark reaches counts as farthest, so every component gets one while there are
+		// landmarks left); the first is the node farthest from node 0
+		std::vector<float> nearestLandmark(nodes, AISLE_UNREACHED);
+		std::vector<float> fromFirst(nodes, AISLE_UNREACHED);
+		if (m_landmarkCount > 0U) {
+			distancesFrom(0U, fromFirst.data());
+		}
+		for (std::uint32_t k = 0U; k < m_landmarkCount; ++k) {
+			const std::vector<float>& spread = (k == 0U) ? fromFirst : nearestLandmark;
+			std::uint32_t landmark = 0U;
+			for (std::uint32_t node = 1U; node < nodes; ++node) {
+				const bool fartherThanBest = (k == 0U)
+					? (spread[node] < AISLE_UNREACHED && (spread[landmark] >= AISLE_UNREACHED || spread[node] > spread[landmark]))
+					: spread[node] > spread[landmark];
+				landmark = fartherThanBest ? node : landmark;
+			}
+			float* row = m_landmarkDistance.data() + static_cast<std::size_t>(k) * nodes;
+			distancesFrom(landmark, row);
+			for (std::size_t node = 0U; node < nodes; ++node) {
+				nearestLandmark[node] = std::min(nearestLandmark[node], row[node]);
+			}
+		}
+	}
+
+	float AisleGraph::lowerBound(std::uint32_t a, std::uint32_t b) const {
+		// Octile distance: exact on an open grid of eight-neighbour steps
+		const sf::Vector2f offset = position(a) - position(b);
+		const float dx = std::fabs(offset.x);
+		const float dy = std::fabs(offset.y);
+		float bound = std::max(dx, dy) + (AISLE_SQRT2 - 1.0F) * std::min(dx, dy);
+
+		// Landmarks: |d(L, a) - d(L, b)| <= d(a, b) for every landmark reaching both
+		const std::size_t nodes = m_nodeCell.size();
+		for (std::uint32_t k = 0U; k < m_landmarkCount; ++k) {
+			const float* row = m_landmarkDistance.data() + static_cast<std::size_t>(k) * nodes;
+			if (row[a] < AISLE_UNREACHED && row[b] < AISLE_UNREACHED) {
+				bound = std::max(bound, std::fabs(row[a] - row[b]));
+			}
+		}
+		return bound;
+	}
+
+	std::uint32_t AisleGraph::nearestNode(const sf::Vector2f& point, int rings) const {
+		if (m_nodeCell.empty()) {
+			return NONE;
+		}
+		const int px = std::clamp(static_cast<int>(std::floor((point.x - m_origin.x) / m_cellSize)), 0, m_cols - 1);
+		const int py = std::clamp(static_cast<int>(std::floor((point.y - m_origin.y) / m_cellSize)), 0, m_rows - 1);
+		std::uint32_t best = NONE;
+		float bestSq = AISLE_UNREACHED;
+		for (int ring = 0; ring <= rings; ++ring) {
+			for (int cy = py - ring; cy <= py + ring; ++cy) {
+				if (cy < 0 || cy >= m_rows) {
+					continue;
+				}
+				// Only the ring's outline: its first and last rows whole, the sides in between
+				const int stride = (cy == py - ring || cy == py + ring) ? 1 : std::max(2 * ring, 1);
+				for (int cx = px - ring; cx <= px + ring; cx += stride) {
+					if (cx < 0 || cx >= m_cols) {
+						continue;
+					}
+					const std::uint32_t node = m_cellNode[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(cx)];
+					if (node == NONE) {
+						continue;
+					}
+					const sf::Vector2f offset = position(node) - point;
+					const float distanceSq = offset.x * offset.x + offset.y * offset.y;
+					if (distanceSq < bestSq) {
+						bestSq = distanceSq;
+						best = node;
+					}
+				}
+			}
+			// Every cell of the next ring is at least ring cells away
+			const float nextRing = static_cast<float>(ring) * m_cellSize;
+			if (best != NONE && bestSq <= nextRing * nextRing) {
+				break;
+			}
+		}
+		return best;
+	}
+
+	std::uint32_t AisleGraph::nodeAt(const sf::Vector2f& point) const {
+		return nearestNode(point, NODE_SEARCH_RINGS);
+	}
+
+	sf::Vector2f AisleGraph::position(std::uint32_t node) const {
+		const std::uint32_t cellIndex = m_nodeCell[node];
+		const std::uint32_t columns = static_cast<std::uint32_t>(m_cols);
+		return m_origin + sf::Vector2f{ (static_cast<float>(cellIndex % columns) + 0.5F) * m_cellSize,
+			(static_cast<float>(cellIndex / columns) + 0.5F) * m_cellSize };
+	}
+
+	void AisleRouter::reset(const AisleGraph& graph) {
+		m_graph = &graph;
+		const std::size_t nodes = graph.nodeCount();
+		m_occupied.assign(graph.bayCount(), 0U);
+		m_fieldDistance.assign(nodes, AISLE_UNREACHED);
+		m_fieldBay.assign(nodes, AisleGraph::NONE);
+		m_levels.assign(graph.aisleCount(), 0U);
+		m_raisedAt.assign(graph.aisleCount(), 0U);
+		m_stampedLevels.assign(graph.aisleCount(), 0U);
+		m_generation = 0U;
+		m_lastRaise = 0U;
+		m_congested = 0U;
+		m_g.assign(nodes, AISLE_UNREACHED);
+		m_parent.assign(nodes, AisleGraph::NONE);
+		m_stamp.assign(nodes, 0U);
+		m_search = 0U;
+		m_cache.clear();
+		m_routeNodes.clear();
+		m_stats = {};
+
+		m_fieldOpen.clear();
+		for (std::uint32_t bay = 0U; bay < graph.bayCount(); ++bay) {
+			seedBay(bay);
+		}
+		settleField();
+		m_stats.fieldUpdates = 0U;
+	}
+
+	void AisleRouter::seedBay(std::uint32_t bay) {
+		const std::uint32_t entry = m_graph->m_bayEntry[bay];
+		if (entry == AisleGraph::NONE || m_graph->m_bayApproach[bay] >= m_fieldDistance[entry]) {
+			return;
+		}
+		m_fieldDistance[entry] = m_graph->m_bayApproach[bay];
+		m_fieldBay[entry] = bay;
+		m_fieldOpen.push_back({ m_fieldDistance[entry], entry });
+		std::push_heap(m_fieldOpen.begin(), m_fieldOpen.end(), laterOpenEntry<OpenEntry>);
+	}
+
+	void AisleRouter::settleField() {
+		const AisleGraph& graph = *m_graph;
+		while (!m_fieldOpen.empty()) {
+			std::pop_heap(m_fieldOpen.begin(), m_fieldOpen.end(), laterOpenEntry<OpenEntry>);
+			const OpenEntry entry = m_fieldOpen.back();
+			m_fieldOpen.pop_back();
+			if (entry.f > m_fieldDistance[entry.node]) {
+				continue;
+			}
+			++m_stats.fieldUpdates;
+			for (std::uint32_t e = graph.m_edgeStart[entry.node]; e < graph.m_edgeStart[entry.node + 1U]; ++e) {
+				const AisleGraph::Edge& edge = graph.m_edges[e];
+				const float reached = entry.f + edge.length;
+				if (reached < m_fieldDistance[edge.to]) {
+					m_fieldDistance[edge.to] = reached;
+					m_fieldBay[edge.to] = m_fieldBay[entry.node];
+					m_fieldOpen.push_back({ reached, edge.to });
+					std::push_heap(m_fieldOpen.begin(), m_fieldOpen.end(), laterOpenEntry<OpenEntry>);
+				}
+			}
+		}
+	}
+
+	void AisleRouter::setOccupied(std::uint32_t bay, bool occupied) {
+		const std::uint8_t state = occupied ? 1U : 0U;
+		if (m_graph == nullptr || m_occupied[bay] == state) {
+			return;
+		}
+		m_occupied[bay] = state;
+		if (!occupied) {
+			// Freed: it can only bring nodes nearer, so relax outwards from its entry while it does
+			seedBay(bay);
+			settleField();
+			return;
+		}
+
+		// Filled: the nodes that counted on it are one connected patch around its entry (each
+		// reached it through a neighbour that did too); every other node keeps its bay and distance
+		const std::uint32_t entry = m_graph->m_bayEntry[bay];
+		if (entry == AisleGraph::NONE || m_fieldBay[entry] != bay) {
+			return;
+		}
+		const AisleGraph& graph = *m_graph;
+		m_region.clear();
+		m_region.push_back(entry);
+		m_fieldBay[entry] = AisleGraph::NONE;
+		for (std::size_t i = 0U; i < m_region.size(); ++i) {
+			const std::uint32_t node = m_region[i];
+			m_fieldDistance[node] = AISLE_UNREACHED;
+			for (std::uint32_t e = graph.m_edgeStart[node]; e < graph.m_edgeStart[node + 1U]; ++e) {
+				const std::uint32_t next = graph.m_edges[e].to;
+				if (m_fieldBay[next] == bay) {
+					m_fieldBay[next] = AisleGraph::NONE;
+					m_region.push_back(next);
+				}
+			}
+		}
+
+		// The patch is solved again from its rim: the free bays entered from inside it and the
+		// neighbours outside it
+		for (const std::uint32_t node : m_region) {
+			for (std::uint32_t i = graph.m_entryStart[node]; i < graph.m_entryStart[node + 1U]; ++i) {
+				if (m_occupied[graph.m_entryBays[i]] == 0U) {
+					seedBay(graph.m_entryBays[i]);
+				}
+			}
+		}
+		for (const std::uint32_t node : m_region) {
+			for (std::uint32_t e = graph.m_edgeStart[node]; e < graph.m_edgeStart[node + 1U]; ++e) {
+				const AisleGraph::Edge& edge = graph.m_edges[e];
+				const float reached = m_fieldDistance[edge.to] + edge.length;
+				if (m_fieldBay[edge.to] != AisleGraph::NONE && reached < m_fieldDistance[node]) {
+					m_fieldDistance[node] = reached;
+					m_fieldBay[node] = m_fieldBay[edge.to];
+				}
+			}
+			if (m_fieldBay[node] != AisleGraph::NONE) {
+				m_fieldOpen.push_back({ m_fieldDistance[node], node });
+				std::push_heap(m_fieldOpen.begin(), m_fieldOpen.end(), laterOpenEntry<OpenEntry>);
+			}
+		}
+		settleField();
+	}
+
+	void AisleRouter::setQueues(const std::vector<std::uint32_t>& queues) {
+		bool raised = false;
+		m_congested = 0U;
+		const std::size_t aisles = std::min(queues.size(), m_levels.size());
+		for (std::size_t aisle = 0U; aisle < aisles; ++aisle) {
+			const std::uint32_t capacity = m_graph->m_aisleCapacity[aisle];
+			const std::uint32_t level = static_cast<std::uint32_t>(std::min<std::uint64_t>(
+				static_cast<std::uint64_t>(queues[aisle]) * LEVEL_STEPS / capacity, MAX_LEVEL));
+			// A rise of one level is tolerated: a car crossing from aisle to aisle does not make
+			// every route through both stale. Falling resets the mark the next rise counts from
+			if (level > m_stampedLevels[aisle] + 1U) {
+				m_raisedAt[aisle] = m_generation + 1U;
+				m_stampedLevels[aisle] = level;
+				raised = true;
+			}
+			else if (level < m_stampedLevels[aisle]) {
+				m_stampedLevels[aisle] = level;
+			}
+			m_levels[aisle] = level;
+			m_congested += (level >= LEVEL_STEPS) ? 1U : 0U;
+		}
+		if (raised) {
+			m_lastRaise = ++m_generation;
+		}
+	}
+
+	bool AisleRouter::fresh(const CachedRoute& route) const {
+		if (m_lastRaise <= route.solvedAt) {
+			return true; // nothing got more congested since
+		}
+		std::uint32_t previous = AisleGraph::NONE;
+		for (std::uint32_t i = 0U; i < route.count; ++i) {
+			const std::uint32_t aisle = m_graph->m_nodeAisle[m_routeNodes[route.offset + i]];
+			if (aisle != previous && m_raisedAt[aisle] > route.solvedAt) {
+				return false;
+			}
+			previous = aisle;
+		}
+		return true;
+	}
+
+	bool AisleRouter::route(std::uint32_t from, std::uint32_t bay, AisleRoute& out) {
+		++m_stats.routes;
+		out = {};
+		if (m_graph == nullptr || from >= m_graph->nodeCount() || bay >= m_graph->bayCount()) {
+			return false;
+		}
+		const AisleGraph& graph = *m_graph;
+		const std::uint32_t goal = graph.m_bayEntry[bay];
+		if (goal == AisleGraph::NONE || !graph.connected(from, goal)) {
+			return false;
+		}
+
+		const std::uint64_t key = (static_cast<std::uint64_t>(from) << 32U) | bay;
+		const auto cached = m_cache.find(key);
+		if (cached != m_cache.end() && fresh(cached->second)) {
+			++m_stats.cacheHits;
+			out = { m_routeNodes.data() + cached->second.offset, cached->second.count, bay, cached->second.cost };
+			return true;
+		}
+
+		// A* on the congested costs; the landmark bound ignores congestion, so it stays admissible
+		if (++m_search == 0U) {
+			std::fill(m_stamp.begin(), m_stamp.end(), 0U);
+			m_search = 1U;
+		}
+		m_open.clear();
+		m_stamp[from] = m_search;
+		m_g[from] = 0.0F;
+		m_parent[from] = AisleGraph::NONE;
+		m_open.push_back({ graph.lowerBound(from, goal), 0.0F, from });
+		while (!m_open.empty()) {
+			std::pop_heap(m_open.begin(), m_open.end(), laterOpenEntry<SearchEntry>);
+			const SearchEntry entry = m_open.back();
+			m_open.pop_back();
+			if (entry.node == goal) {
+				break;
+			}
+			if (entry.g > m_g[entry.node]) {
+				continue; // superseded by a cheaper way to the same node
+			}
+			++m_stats.expansions;
+			for (std::uint32_t e = graph.m_edgeStart[entry.node]; e < graph.m_edgeStart[entry.node + 1U]; ++e) {
+				const AisleGraph::Edge& edge = graph.m_edges[e];
+				const float reached = entry.g + stepCost(edge);
+				if (m_stamp[edge.to] != m_search || reached < m_g[edge.to]) {
+					m_stamp[edge.to] = m_search;
+					m_g[edge.to] = reached;
+					m_parent[edge.to] = entry.node;
+					m_open.push_back({ reached + graph.lowerBound(edge.to, goal), reached, edge.to });
+					std::push_heap(m_open.begin(), m_open.end(), laterOpenEntry<SearchEntry>);
+				}
+			}
+		}
+		if (m_stamp[goal] != m_search) {
+			return false;
+		}
+
+		// Back to back in the node store, start first; the store starts over once it is full
+		std::size_t count = 0U;
+		for (std::uint32_t node = goal; node != AisleGraph::NONE; node = m_parent[node]) {
+			++count;
+		}
+		if (m_routeNodes.size() + count > MAX_CACHED_ROUTE_NODES) {
+			m_cache.clear();
+			m_routeNodes.clear();
+		}
+		const std::size_t offset = m_routeNodes.size();
+		m_routeNodes.resize(offset + count);
+		std::size_t slot = offset + count;
+		for (std::uint32_t node = goal; node != AisleGraph::NONE; node = m_parent[node]) {
+			m_routeNodes[--slot] = node;
+		}
+
+		// Every node on the route gets its suffix: the rest of an optimal route is optimal from there
+		const float total = m_g[goal] + graph.m_bayApproach[bay];
+		for (std::size_t i = 0U; i < count; ++i) {
+			const std::uint32_t node = m_routeNodes[offset + i];
+			m_cache[(static_cast<std::uint64_t>(node) << 32U) | bay] = { static_cast<std::uint32_t>(offset + i),
+				static_cast<std::uint32_t>(count - i), m_generation, total - m_g[node] };
+		}
+		out = { m_routeNodes.data() + offset, count, bay, total };
+		return true;
+	}
+
+} // namespace sim
@@ -0,0 +1,240 @@
+/*
+==============================================================================
+Aisle Graph - routing cars through the lot's aisles to free bays
+==============================================================================
+ - The lot is cut into square cells; the cells clear of pillars, walls,
+   polygons and bays are the graph's nodes, linked to their eight
+   neighbours (never past a blocked corner). Horizontal runs of nodes, cut
+   to at most maxAisleCells, are the aisles, and every bay hangs off the
+   node nearest its centre (its entry)
+ - Precomputed distance tables: the distance from a few landmarks, picked
+   farthest-first, to every node. By the triangle inequality any two rows
+   bound the distance between two nodes from below; that bound (or the
+   straight-line one, whichever is larger) is A*'s heuristic (ALT), so a
+   route expands little more than the nodes along it
+ - AisleRouter keeps, for every node, the distance to its nearest free bay
+   (a Dijkstra field seeded from every free bay's entry), so "which free bay
+   is nearest" is a lookup. The field is updated incrementally: a bay that
+   frees up re-relaxes only the nodes it is now nearer to, one that fills
+   re-solves only the nodes that were counting on it, from their neighbours
+ - Congestion: the caller counts the cars in each aisle or bound for a bay
+   off it (setQueues(), once per tick); an aisle over its capacity costs up
+   to five times as much to drive through, so A* routes spread over
+   parallel aisles
+ - Routes are cached per (start node, bay), and every node along a route
+   gets its own suffix as an entry, so a car that moves on along its route
+   keeps hitting. An entry is stale once an aisle along it got two levels
+   more congested than when it was solved; that is checked when it is read,
+   so invalidating costs nothing up front. One level of drift and aisles
+   elsewhere easing leave cached routes as they are
+ - Single-threaded: one router per simulation, updated and queried serially
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Scene.hpp"
+
+namespace sim {
+
+	struct AisleGraphConfig {
+		float cellSize = 72.0F;           // node cell edge (half a car width)
+		float clearance = 36.0F;          // kept between a node cell and a pillar, wall or polygon
+		std::uint32_t maxAisleCells = 16U; // longest aisle, in cells
+		std::uint32_t landmarks = 4U;     // distance tables (at most MAX_LANDMARKS)
+	};
+
+	class AisleGraph {
+	public:
+		static constexpr std::uint32_t NONE = 0xFFFFFFFFU;
+		static constexpr std::uint32_t MAX_LANDMARKS = 8U;
+
+		/**
+		 * @brief Rebuilds the graph over area from the scene's pillars, walls, polygons and bays.
+		 *
+		 * The scene's own walls only: area's sides do not block, so cars
+		 * spawned outside the lot are still on the graph. MISRA: the cell
+		 * size is doubled until the grid has at most 4M cells.
+		 */
+		void build(const Scene& scene, const sf::FloatRect& area, const AisleGraphConfig& config = {});
+
+		/**
+		 * @brief Node nearest point within a few cells of it; NONE if there is none.
+		 */
+		[[nodiscard]] std::uint32_t nodeAt(const sf::Vector2f& point) const;
+
+		[[nodiscard]] sf::Vector2f position(std::uint32_t node) const;
+		[[nodiscard]] std::size_t nodeCount() const noexcept { return m_nodeCell.size(); }
+		[[nodiscard]] std::size_t aisleCount() const noexcept { return m_aisleCapacity.size(); }
+		[[nodiscard]] std::size_t bayCount() const noexcept { return m_bayEntry.size(); }
+		[[nodiscard]] float cellSize() const noexcept { return m_cellSize; }
+
+		[[nodiscard]] std::uint32_t aisleOf(std::uint32_t node) const { return m_nodeAisle[node]; }
+		[[nodiscard]] std::uint32_t aisleCapacity(std::uint32_t aisle) const { return m_aisleCapacity[aisle]; } // cars
+
+		/**
+		 * @brief Node a car enters the bay from; NONE if no node is near it.
+		 */
+		[[nodiscard]] std::uint32_t bayEntry(std::uint32_t bay) const { return m_bayEntry[bay]; }
+
+		/**
+		 * @brief Never more than the shortest distance from a to b.
+		 */
+		[[nodiscard]] float lowerBound(std::uint32_t a, std::uint32_t b) const;
+
+		// Nodes that can reach each other share a component
+		[[nodiscard]] bool connected(std::uint32_t a, std::uint32_t b) const { return m_component[a] == m_component[b]; }
+
+	private:
+		friend class AisleRouter;
+
+		struct Edge {
+			std::uint32_t to = 0U;
+			float length = 0.0F;
+		};
+
+		[[nodiscard]] std::uint32_t nearestNode(const sf::Vector2f& point, int rings) const;
+		void buildEdges(const std::vector<std::uint8_t>& blocked);
+		void buildAisles(const Scene& scene, std::uint32_t maxAisleCells);
+		void buildLandmarks(std::uint32_t count);
+
+		sf::Vector2f m_origin{ 0.0F, 0.0F };
+		float m_cellSize = 1.0F;
+		int m_cols = 0;
+		int m_rows = 0;
+		std::vector<std::uint32_t> m_cellNode; // m_cols * m_rows, NONE where blocked
+		std::vector<std::uint32_t> m_nodeCell;
+		std::vector<std::uint32_t> m_edgeStart; // node count + 1 offsets into m_edges
+		std::vector<Edge> m_edges;
+		std::vector<std::uint32_t> m_nodeAisle;
+		std::vector<std::uint32_t> m_aisleCapacity;
+		std::vector<std::uint32_t> m_component;
+		std::vector<std::uint32_t> m_bayEntry;
+		std::vector<float> m_bayApproach; // entry node to bay centre
+		std::vector<std::uint32_t> m_entryStart; // node count + 1 offsets into m_entryBays
+		std::vector<std::uint32_t> m_entryBays;  // the bays entered from each node
+		std::uint32_t m_landmarkCount = 0U;
+		std::vector<float> m_landmarkDistance; // landmark k's row is [k * node count, (k + 1) * node count)
+	};
+
+	// A route as cached: valid until the router is next changed or asked for another route
+	struct AisleRoute {
+		const std::uint32_t* nodes = nullptr; // start node first, the bay's entry last
+		std::size_t count = 0U;
+		std::uint32_t bay = AisleGraph::NONE;
+		float cost = 0.0F; // congested length, entry to bay centre included
+	};
+
+	struct AisleRouterStats {
+		std::uint64_t routes = 0U;       // route() calls
+		std::uint64_t cacheHits = 0U;    // answered from the cache
+		std::uint64_t expansions = 0U;   // nodes A* expanded on misses
+		std::uint64_t fieldUpdates = 0U; // free-bay field nodes settled again after occupancy changes
+	};
+
+	class AisleRouter {
+	public:
+		static constexpr std::uint32_t LEVEL_STEPS = 4U; // congestion levels per capacity's worth of cars
+		static constexpr std::uint32_t MAX_LEVEL = 16U;  // four times over capacity and beyond
+		static constexpr float LEVEL_COST = 0.25F;       // extra cost factor per level
+
+		/**
+		 * @brief Routes over graph (which must outlive the router); every bay free, no queues.
+		 */
+		void reset(const AisleGraph& graph);
+
+		/**
+		 * @brief Marks a bay and updates the free-bay field around it; cheap if nothing changed.
+		 */
+		void setOccupied(std::uint32_t bay, bool occupied);
+
+		/**
+		 * @brief Free bay with the shortest (uncongested) drive from node; NONE if none is reachable.
+		 */
+		[[nodiscard]] std::uint32_t nearestFreeBay(std::uint32_t node) const {
+			return (node < m_fieldBay.size()) ? m_fieldBay[node] : AisleGraph::NONE;
+		}
+
+		/**
+		 * @brief Cars per aisle (graph.aisleCount() entries), as congestion levels for the next routes.
+		 */
+		void setQueues(const std::vector<std::uint32_t>& queues);
+
+		/**
+		 * @brief Cheapest congested route from node to bay; false if bay cannot be reached.
+		 */
+		[[nodiscard]] bool route(std::uint32_t from, std::uint32_t bay, AisleRoute& out);
+
+		[[nodiscard]] std::uint32_t level(std::uint32_t aisle) const { return m_levels[aisle]; }
+
+		/**
+		 * @brief Aisles holding at least their capacity as of the last setQueues().
+		 */
+		[[nodiscard]] std::size_t congestedAisles() const noexcept { return m_congested; }
+
+		[[nodiscard]] const AisleRouterStats& stats() const noexcept { return m_stats; }
+
+	private:
+		struct OpenEntry {
+			float f = 0.0F;
+			std::uint32_t node = 0U;
+		};
+
+		struct SearchEntry {
+			float f = 0.0F;
+			float g = 0.0F;
+			std::uint32_t node = 0U;
+		};
+
+		struct CachedRoute {
+			std::uint32_t offset = 0U; // into m_routeNodes
+			std::uint32_t count = 0U;
+			std::uint32_t solvedAt = 0U; // m_generation when solved
+			float cost = 0.0F;
+		};
+
+		void seedBay(std::uint32_t bay);
+		void settleField();
+		[[nodiscard]] bool fresh(const CachedRoute& route) const;
+		[[nodiscard]] float stepCost(const AisleGraph::Edge& edge) const {
+			return edge.length * (1.0F + static_cast<float>(m_levels[m_graph->m_nodeAisle[edge.to]]) * LEVEL_COST);
+		}
+
+		const AisleGraph* m_graph = nullptr;
+		std::vector<std::uint8_t> m_occupied; // per bay
+
+		// Free-bay field
+		std::vector<float> m_fieldDistance;
+		std::vector<std::uint32_t> m_fieldBay;
+		std::vector<std::uint32_t> m_region; // nodes being re-solved
+		std::vector<OpenEntry> m_fieldOpen;
+
+		// Congestion; an aisle's level last rose past m_stampedLevels[aisle] + 1 in generation m_raisedAt[aisle]
+		std::vector<std::uint32_t> m_levels;
+		std::vector<std::uint32_t> m_stampedLevels;
+		std::vector<std::uint32_t> m_raisedAt;
+		std::uint32_t m_generation = 0U;
+		std::uint32_t m_lastRaise = 0U;
+		std::size_t m_congested = 0U;
+
+		// A* scratch; a node's g is only valid once stamped with the current search
+		std::vector<float> m_g;
+		std::vector<std::uint32_t> m_parent;
+		std::vector<std::uint32_t> m_stamp;
+		std::uint32_t m_search = 0U;
+		std::vector<SearchEntry> m_open;
+
+		std::unordered_map<std::uint64_t, CachedRoute> m_cache; // (start node << 32) | bay
+		std::vector<std::uint32_t> m_routeNodes; // every cached route, back to back
+		AisleRouterStats m_stats;
+	};
+
+} // namespace sim
@@ -0,0 +1,110 @@
+#include "AllocationCheck.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Log.hpp"
+#include "MemoryAccounting.hpp"
+
+namespace prof {
+
+	namespace {
+		// Namespace-scope atomics are zero-initialized before any allocation
+		std::atomic<std::uint64_t> g_allocatedBytes{ 0U };
+		std::atomic<bool> g_hooksActive{ false };
+		std::atomic<bool> g_trapArmed{ false };
+		std::atomic<std::uint64_t> g_trapFrame{ 0U };
+	}
+
+	void noteAllocation(std::size_t bytes) noexcept {
+		countAllocation();
+		g_allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+		if (g_trapArmed.load(std::memory_order_relaxed)) {
+			// stderr is unbuffered: no allocation on the way out
+			std::fprintf(stderr, "Error: heap allocation of %zu bytes in steady-state frame %llu\n", bytes,
+				static_cast<unsigned long long>(g_trapFrame.load(std::memory_order_relaxed)));
+			std::abort();
+		}
+	}
+
+	void markAllocationHooks() noexcept {
+		g_hooksActive.store(true, std::memory_order_relaxed);
+	}
+
+	bool allocationHooksActive() noexcept {
+		return g_hooksActive.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t allocatedBytes() noexcept {
+		return g_allocatedBytes.load(std::memory_order_relaxed);
+	}
+
+	FrameAllocationCheck::FrameAllocationCheck(const AllocationCheckSettings& settings) noexcept
+		: m_settings(settings), m_warmupLeft(settings.warmupFrames) {
+	}
+
+	void FrameAllocationCheck::beginFrame() noexcept {
+		m_judged = m_warmupLeft == 0U;
+		if (!m_judged) {
+			--m_warmupLeft;
+		}
+		m_frameAllocations = allocationCount();
+		m_frameBytes = allocatedBytes();
+		if (m_judged && m_settings.trap) {
+			g_trapFrame.store(m_report.frames, std::memory_order_relaxed);
+			g_trapArmed.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	void FrameAllocationCheck::endFrame() noexcept {
+		g_trapArmed.store(false, std::memory_order_relaxed);
+		const std::uint64_t allocations = allocationCount() - m_frameAllocations;
+		const std::uint64_t bytes = allocatedBytes() - m_frameBytes;
+		const std::uint64_t frame = m_report.frames++;
+		if (!m_judged) {
+			return;
+		}
+
+		++m_report.steadyFrames;
+		if (allocations == 0U) {
+			return;
+		}
+		if (m_report.allocatingFrames < LOGGED_FRAMES) {
+			OKPP_LOG_WARNING("Warning: steady-state frame %llu allocated %llu times (%llu bytes)",
+				static_cast<unsigned long long>(frame), static_cast<unsigned long long>(allocations),
+				static_cast<unsigned long long>(bytes));
+		}
+		++m_report.allocatingFrames;
+		m_report.allocations += allocations;
+		m_report.bytes += bytes;
+		if (allocations > m_report.worstAllocations) {
+			m_report.worstAllocations = allocations;
+			m_report.worstFrame = frame;
+		}
+	}
+
+	void FrameAllocationCheck::settle() noexcept {
+		g_trapArmed.store(false, std::memory_order_relaxed);
+		m_judged = false;
+		m_warmupLeft = m_settings.warmupFrames;
+	}
+
+	void FrameAllocationCheck::logReport() const {
+		if (!allocationHooksActive()) {
+			OKPP_LOG_WARNING("Warning: allocation check without allocation hooks (configure with OKPP_ALLOC_CHECK=ON)");
+			return;
+		}
+		if (m_report.allocatingFrames == 0U) {
+			OKPP_LOG_INFO("Allocation check: %llu steady-state frames of %llu, none allocated",
+				static_cast<unsigned long long>(m_report.steadyFrames), static_cast<unsigned long long>(m_report.frames));
+			return;
+		}
+		OKPP_LOG_WARNING("Warning: allocation check: %llu of %llu steady-state frames allocated (%llu allocations, "
+			"%llu bytes); worst was frame %llu with %llu",
+			static_cast<unsigned long long>(m_report.allocatingFrames), static_cast<unsigned long long>(m_report.steadyFrames),
+			static_cast<unsigned long long>(m_report.allocations), static_cast<unsigned long long>(m_report.bytes),
+			static_cast<unsigned long long>(m_report.worstFrame), static_cast<unsigned long long>(m_report.worstAllocations));
+	}
+
+} // namespace prof
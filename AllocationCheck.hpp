@@ -0,0 +1,110 @@
+/*
+==============================================================================
+Allocation Check - heap allocations per frame of the main loop
+==============================================================================
+ - A debug mode that holds the frame loop to its promise of not touching
+   the heap once it is running: frame arenas, pools and reserved buffers
+   carry every per-frame list, so a steady-state frame should allocate
+   nothing at all
+ - Counting needs the replacement operator new/delete of AllocationHooks.cpp,
+   linked into the front-end by configuring with OKPP_ALLOC_CHECK=ON; in any
+   other build allocationHooksActive() is false and the check reports that
+   it cannot see anything
+ - Allocations are counted from every thread, so the render thread and the
+   pool workers a frame waits on are judged with it
+ - The first warm-up frames are not judged (caches, atlases and reserved
+   buffers fill there), nor are the frames after settle(), which the loop
+   calls when it legitimately rebuilds something (a streamed tile, a tuning
+   reload, an asset still decoding)
+ - Report mode logs the first offending frames and a summary on exit; trap
+   mode aborts inside the offending operator new, so a debugger or core
+   dump shows the call stack that allocated
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace prof {
+
+	struct AllocationCheckSettings {
+		std::uint32_t warmupFrames = 120U; // not judged after start and after each settle()
+		bool trap = false;                 // abort on the allocation instead of reporting the frame
+	};
+
+	struct AllocationCheckReport {
+		std::uint64_t frames = 0U;           // frames seen
+		std::uint64_t steadyFrames = 0U;     // frames judged (past warm-up)
+		std::uint64_t allocatingFrames = 0U; // judged frames that allocated
+		std::uint64_t allocations = 0U;      // in judged frames
+		std::uint64_t bytes = 0U;
+		std::uint64_t worstFrame = 0U;       // index of the judged frame with the most allocations
+		std::uint64_t worstAllocations = 0U;
+	};
+
+	/**
+	 * @brief Counts one allocation of bytes; called by the replacement operator new.
+	 *
+	 * MISRA: must not allocate. Aborts when a trap is armed (steady frame under trap mode).
+	 */
+	void noteAllocation(std::size_t bytes) noexcept;
+
+	/**
+	 * @brief Records that the replacement operators are linked in; called once by AllocationHooks.cpp.
+	 */
+	void markAllocationHooks() noexcept;
+
+	/**
+	 * @brief True if this binary counts its heap allocations.
+	 */
+	[[nodiscard]] bool allocationHooksActive() noexcept;
+
+	/**
+	 * @brief Bytes requested from operator new so far (0 unless the hooks are linked in).
+	 */
+	[[nodiscard]] std::uint64_t allocatedBytes() noexcept;
+
+	class FrameAllocationCheck {
+	public:
+		// Offending frames logged one by one; later ones only reach the summary
+		static constexpr std::uint32_t LOGGED_FRAMES = 10U;
+
+		explicit FrameAllocationCheck(const AllocationCheckSettings& settings = {}) noexcept;
+
+		FrameAllocationCheck(const FrameAllocationCheck&) = delete;
+		FrameAllocationCheck& operator=(const FrameAllocationCheck&) = delete;
+
+		/**
+		 * @brief Starts a frame: snapshots the counters, arms the trap on a steady frame.
+		 */
+		void beginFrame() noexcept;
+
+		/**
+		 * @brief Ends the frame: disarms the trap and judges what the frame allocated.
+		 */
+		void endFrame() noexcept;
+
+		/**
+		 * @brief Starts the warm-up over; the current frame and the next warmupFrames are not judged.
+		 */
+		void settle() noexcept;
+
+		[[nodiscard]] const AllocationCheckReport& report() const noexcept { return m_report; }
+
+		/**
+		 * @brief Logs the summary: steady frames, how many allocated and the worst one.
+		 */
+		void logReport() const;
+
+	private:
+		AllocationCheckSettings m_settings;
+		AllocationCheckReport m_report;
+		std::uint64_t m_frameAllocations = 0U; // counters at beginFrame()
+		std::uint64_t m_frameBytes = 0U;
+		std::uint32_t m_warmupLeft = 0U;
+		bool m_judged = false; // this frame counts
+	};
+
+} // namespace prof
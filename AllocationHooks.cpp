@@ -0,0 +1,116 @@
+/*
+==============================================================================
+Allocation Hooks - counting replacements of the global operator new/delete
+==============================================================================
+ - Linked into the front-end only when configured with OKPP_ALLOC_CHECK=ON;
+   every other build keeps the library's allocator untouched
+ - Every form of operator new (plain, array, nothrow, over-aligned) is
+   counted through prof::noteAllocation(); the array and nothrow forms
+   forward to the plain ones, as the standard library's do
+ - Over-aligned blocks come from _aligned_malloc on MSVC and std::aligned_alloc
+   elsewhere, whose size must be a multiple of the alignment
+==============================================================================
+*/
+
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCheck.hpp"
+
+namespace {
+
+	[[nodiscard]] void* allocOrNull(std::size_t size) noexcept {
+		return std::malloc((size > 0U) ? size : 1U);
+	}
+
+	[[nodiscard]] void* alignedAllocOrNull(std::size_t size, std::align_val_t alignment) noexcept {
+		const auto align = static_cast<std::size_t>(alignment);
+#if defined(_MSC_VER)
+		return _aligned_malloc((size > 0U) ? size : 1U, align);
+#else
+		const std::size_t rounded = ((size + align - 1U) / align) * align;
+		return std::aligned_alloc(align, (rounded > 0U) ? rounded : align);
+#endif
+	}
+
+	void alignedFree(void* memory) noexcept {
+#if defined(_MSC_VER)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+	// Marks the hooks as linked in before main(); a namespace-scope object of this TU is
+	// only constructed when the TU is part of the program
+	struct AllocationHooksMarker {
+		AllocationHooksMarker() noexcept { prof::markAllocationHooks(); }
+	};
+	const AllocationHooksMarker g_allocationHooksMarker;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+	prof::noteAllocation(size);
+	if (void* const memory = allocOrNull(size)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	prof::noteAllocation(size);
+	return allocOrNull(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return ::operator new(size, std::nothrow);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	prof::noteAllocation(size);
+	if (void* const memory = alignedAllocOrNull(size, alignment)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return ::operator new(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+	alignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+	alignedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+	alignedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+	alignedFree(memory);
+}
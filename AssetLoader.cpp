@@ -0,0 +1,203 @@
+#include "AssetLoader.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+
+#include "Trace.hpp"
+
+namespace assets {
+
+	AssetLoader::~AssetLoader() {
+		for (auto& job : m_jobs) {
+			sim::sharedPool().wait(job.decode->group);
+		}
+	}
+
+	void AssetLoader::start(Job job, std::function<bool()> decode) {
+		job.decode = std::make_unique<Decode>();
+		Decode* status = job.decode.get();
+		m_jobs.push_back(std::move(job));
+		sim::sharedPool().submit(status->group, [status, decode = std::move(decode)]() {
+			status->ok = decode();
+		});
+	}
+
+	void AssetLoader::requestImage(const std::string& path) {
+		Job job;
+		job.path = path;
+		job.image = std::make_unique<sf::Image>();
+		// The image lives on the heap, so moving the job does not move what the worker writes to
+		sf::Image* image = job.image.get();
+		const AssetPack* pack = (m_pack != nullptr && m_pack->contains(path)) ? m_pack : nullptr;
+		const TextureCache* cache = (m_textureCache != nullptr && m_textureCache->enabled()) ? m_textureCache : nullptr;
+		start(std::move(job), [image, path, pack, cache]() {
+			OKPP_TRACE_SCOPE("decode image");
+			if (cache == nullptr) {
+				if (pack != nullptr) {
+					AssetBytes bytes;
+					return pack->read(path, bytes) && image->loadFromMemory(bytes.data(), bytes.size());
+				}
+				if (!image->loadFromFile(path)) {
+					std::cerr << "Error: Failed to load image from "
+						<< std::filesystem::absolute(path) << '\n';
+					return false;
+				}
+				return true;
+			}
+
+			// The key needs the encoded bytes anyway, so a loose file is mapped rather than opened by SFML
+			AssetBytes packed;
+			MappedFile loose;
+			const bool read = (pack != nullptr) ? pack->read(path, packed) : loose.open(path);
+			if (!read) {
+				std::cerr << "Error: Failed to load image from "
+					<< std::filesystem::absolute(path) << '\n';
+				return false;
+			}
+			const unsigned char* bytes = (pack != nullptr) ? packed.data() : loose.data();
+			const std::size_t size = (pack != nullptr) ? packed.size() : loose.size();
+			const std::uint64_t key = assetHash(bytes, size);
+			CachedTexture cached;
+			if (cache->load(key, cached)) {
+				image->resize(cached.size, cached.pixels);
+				return true;
+			}
+			if (!image->loadFromMemory(bytes, size)) {
+				std::cerr << "Error: Failed to load image from "
+					<< std::filesystem::absolute(path) << '\n';
+				return false;
+			}
+			(void)cache->store(key, image->getSize(), image->getPixelsPtr());
+			return true;
+		});
+	}
+
+	void AssetLoader::requestCompressedTexture(const std::string& path) {
+		Job job;
+		job.path = path;
+		job.compressed = std::make_unique<gfx::CompressedTexture>();
+		gfx::CompressedTexture* compressed = job.compressed.get();
+		const AssetPack* pack = (m_pack != nullptr && m_pack->contains(path)) ? m_pack : nullptr;
+		start(std::move(job), [compressed, path, pack]() {
+			OKPP_TRACE_SCOPE("read cooked texture");
+			if (pack != nullptr) {
+				AssetBytes bytes;
+				return pack->read(path, bytes) && gfx::loadCompressedTexture(bytes.data(), bytes.size(), path, *compressed);
+			}
+			return gfx::loadCompressedTexture(path, *compressed);
+		});
+	}
+
+	void AssetLoader::requestSound(const std::string& path) {
+		Job job;
+		job.path = path;
+		job.sound = std::make_unique<sf::SoundBuffer>();
+		job.charge = prof::MemoryCharge(prof::MemorySubsystem::AudioBuffers, prof::MemoryKind::Heap);
+		sf::SoundBuffer* sound = job.sound.get();
+		const AssetPack* pack = (m_pack != nullptr && m_pack->contains(path)) ? m_pack : nullptr;
+		start(std::move(job), [sound, path, pack]() {
+			OKPP_TRACE_SCOPE("decode sound");
+			if (pack != nullptr) {
+				AssetBytes bytes;
+				return pack->read(path, bytes) && sound->loadFromMemory(bytes.data(), bytes.size());
+			}
+			if (!sound->loadFromFile(path)) {
+				std::cerr << "Error: Failed to load sound from "
+					<< std::filesystem::absolute(path) << '\n';
+				return false;
+			}
+			return true;
+		});
+	}
+
+	void AssetLoader::requestCookedSound(const std::string& path) {
+		Job job;
+		job.path = path;
+		job.sound = std::make_unique<sf::SoundBuffer>();
+		job.charge = prof::MemoryCharge(prof::MemorySubsystem::AudioBuffers, prof::MemoryKind::Heap);
+		sf::SoundBuffer* sound = job.sound.get();
+		const AssetPack* pack = (m_pack != nullptr && m_pack->contains(path)) ? m_pack : nullptr;
+		start(std::move(job), [sound, path, pack]() {
+			OKPP_TRACE_SCOPE("read cooked sound");
+			audio::CookedSound cooked;
+			AssetBytes bytes;
+			const bool read = (pack != nullptr)
+				? pack->read(path, bytes) && audio::loadCookedSound(bytes.data(), bytes.size(), path, cooked)
+				: audio::loadCookedSound(path, cooked);
+			if (!read) {
+				return false;
+			}
+			const std::vector<sf::SoundChannel> channels = (cooked.channelCount == 1U)
+				? std::vector<sf::SoundChannel>{ sf::SoundChannel::Mono }
+				: std::vector<sf::SoundChannel>{ sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight };
+			if (!sound->loadFromSamples(cooked.samples.data(), cooked.samples.size(), cooked.channelCount,
+				cooked.sampleRate, channels)) {
+				std::cerr << "Error: Failed to load cooked sound " << path << '\n';
+				return false;
+			}
+			return true;
+		});
+	}
+
+	bool AssetLoader::poll() {
+		bool changed = false;
+		for (auto& job : m_jobs) {
+			// done() acquires the task's writes, ok included
+			if (job.finished || !job.decode->group.done()) {
+				continue;
+			}
+			job.ok = job.decode->ok;
+			job.finished = true;
+			if (job.ok) {
+				job.charge.set(decodedBytes(job));
+			}
+			++m_finished;
+			changed = true;
+		}
+		return changed;
+	}
+
+	std::size_t AssetLoader::decodedBytes(const Job& job) {
+		if (job.image) {
+			return prof::rgbaTextureBytes(job.image->getSize().x, job.image->getSize().y);
+		}
+		if (job.compressed) {
+			return gfx::textureBytes(*job.compressed);
+		}
+		if (job.sound) {
+			return static_cast<std::size_t>(job.sound->getSampleCount()) * sizeof(std::int16_t);
+		}
+		return 0U;
+	}
+
+	const AssetLoader::Job* AssetLoader::find(const std::string& path) const {
+		for (const auto& job : m_jobs) {
+			if (job.path == path) {
+				return &job;
+			}
+		}
+		return nullptr;
+	}
+
+	const sf::Image* AssetLoader::image(const std::string& path) const {
+		const Job* job = find(path);
+		return (job != nullptr && job->finished && job->ok) ? job->image.get() : nullptr;
+	}
+
+	const gfx::CompressedTexture* AssetLoader::compressedTexture(const std::string& path) const {
+		const Job* job = find(path);
+		return (job != nullptr && job->finished && job->ok) ? job->compressed.get() : nullptr;
+	}
+
+	const sf::SoundBuffer* AssetLoader::sound(const std::string& path) const {
+		const Job* job = find(path);
+		return (job != nullptr && job->finished && job->ok) ? job->sound.get() : nullptr;
+	}
+
+	bool AssetLoader::finished(const std::string& path) const {
+		const Job* job = find(path);
+		return job != nullptr && job->finished;
+	}
+
+} // namespace assets
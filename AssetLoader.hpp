@@ -0,0 +1,148 @@
+/*
+==============================================================================
+Asset Loader - decodes images and sounds on worker threads
+==============================================================================
+ - Every request queues its decode on the shared pool right away, so
+   start-up waits for the slowest single asset instead of the sum of all
+   of them, without a thread of its own per asset
+ - Workers only produce CPU-side data (sf::Image pixels, cooked texture
+   blocks, sf::SoundBuffer PCM); cooked sounds are copied into their
+   buffer without a decoder; turning them into textures stays on the
+   thread that owns the GL context
+ - With an asset pack set, paths the pack contains are decoded from its
+   mapping through loadFromMemory(); anything else falls back to the file
+ - With a texture cache set, an image whose bytes were decoded before is
+   copied out of the cache entry instead (see TextureCache.hpp), and a
+   fresh decode is written back for the next launch
+ - poll() is called once per frame from the main thread and never blocks
+ - Decoded data stays resident and is charged to the texture and audio
+   memory subsystems once it arrives
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AssetPack.hpp"
+#include "CompressedTexture.hpp"
+#include "CookedSound.hpp"
+#include "MemoryAccounting.hpp"
+#include "TextureCache.hpp"
+#include "ThreadPool.hpp"
+
+namespace assets {
+
+	class AssetLoader {
+	public:
+		AssetLoader() = default;
+		~AssetLoader(); // waits for decodes still queued or in flight
+
+		AssetLoader(const AssetLoader&) = delete;
+		AssetLoader& operator=(const AssetLoader&) = delete;
+
+		/**
+		 * @brief Serves later requests from pack where it has the path; null reads loose files only.
+		 *
+		 * The pack must outlive the loader, since queued decodes read from it.
+		 */
+		void setPack(const AssetPack* pack) noexcept { m_pack = pack; }
+
+		/**
+		 * @brief Looks later image requests up in cache before decoding; null always decodes.
+		 *
+		 * The cache must outlive the loader, since queued decodes use it.
+		 */
+		void setTextureCache(const TextureCache* cache) noexcept { m_textureCache = cache; }
+
+		/**
+		 * @brief Starts decoding an image file; fetch it with image() once ready.
+		 */
+		void requestImage(const std::string& path);
+
+		/**
+		 * @brief Starts reading a cooked texture container (see TextureCooker.hpp).
+		 */
+		void requestCompressedTexture(const std::string& path);
+
+		/**
+		 * @brief Starts decoding a sound file into PCM; fetch it with sound() once ready.
+		 */
+		void requestSound(const std::string& path);
+
+		/**
+		 * @brief Starts reading a cooked sound (see CookedSound.hpp); fetch it with sound() once ready.
+		 */
+		void requestCookedSound(const std::string& path);
+
+		/**
+		 * @brief Collects finished decodes; returns true if any finished since the last call.
+		 */
+		[[nodiscard]] bool poll();
+
+		/**
+		 * @brief Decoded image, or null while it is still loading or if it failed.
+		 *
+		 * The pointer stays valid for the lifetime of the loader.
+		 */
+		[[nodiscard]] const sf::Image* image(const std::string& path) const;
+
+		/**
+		 * @brief Cooked texture blocks, or null while still loading or if reading failed.
+		 *
+		 * The pointer stays valid for the lifetime of the loader.
+		 */
+		[[nodiscard]] const gfx::CompressedTexture* compressedTexture(const std::string& path) const;
+
+		/**
+		 * @brief Decoded sound, or null while it is still loading or if it failed.
+		 *
+		 * The pointer stays valid for the lifetime of the loader.
+		 */
+		[[nodiscard]] const sf::SoundBuffer* sound(const std::string& path) const;
+
+		/**
+		 * @brief True once the asset has finished, successfully or not.
+		 */
+		[[nodiscard]] bool finished(const std::string& path) const;
+
+		[[nodiscard]] std::size_t requestedCount() const noexcept { return m_jobs.size(); }
+		[[nodiscard]] std::size_t finishedCount() const noexcept { return m_finished; }
+		[[nodiscard]] bool done() const noexcept { return m_finished == m_jobs.size(); }
+
+	private:
+		// Written by the pool task; on the heap so moving the job does not move it
+		struct Decode {
+			sim::TaskGroup group;
+			bool ok = false;
+		};
+
+		struct Job {
+			std::string path;
+			std::unique_ptr<sf::Image> image;                   // set for image requests
+			std::unique_ptr<gfx::CompressedTexture> compressed; // set for cooked texture requests
+			std::unique_ptr<sf::SoundBuffer> sound;             // set for sound requests
+			std::unique_ptr<Decode> decode;
+			prof::MemoryCharge charge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Heap }; // decoded bytes, audio for sounds
+			bool finished = false;
+			bool ok = false;
+		};
+
+		void start(Job job, std::function<bool()> decode);
+		[[nodiscard]] const Job* find(const std::string& path) const;
+		[[nodiscard]] static std::size_t decodedBytes(const Job& job);
+
+		const AssetPack* m_pack = nullptr;
+		const TextureCache* m_textureCache = nullptr;
+		std::vector<Job> m_jobs;
+		std::size_t m_finished = 0U;
+	};
+
+} // namespace assets
@@ -0,0 +1,420 @@
+#include "AssetPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+namespace assets {
+
+	struct AssetPack::Entry {
+		std::uint32_t nameOffset = 0U; // into the name bytes
+		std::uint32_t nameLength = 0U;
+		std::uint32_t flags = 0U;
+		std::uint32_t reserved = 0U;
+		std::uint64_t offset = 0U;      // of the payload, from the start of the file
+		std::uint64_t storedBytes = 0U; // payload bytes in the file
+		std::uint64_t size = 0U;        // bytes once decompressed
+	};
+
+	namespace {
+		constexpr char PACK_MAGIC[8] = { 'O', 'K', 'P', 'K', '0', '0', '0', '1' };
+
+		struct PackHeader {
+			char magic[8];
+			std::uint32_t entryCount;
+			std::uint32_t nameBytes;
+		};
+
+		static_assert(sizeof(PackHeader) == 16U, "the header is written raw and must have no padding");
+
+		constexpr std::uint32_t ENTRY_LZ4 = 1U;
+
+		// LZ4 block format: matches of at least 4 bytes, at most 64 KiB back; the last
+		// 5 bytes are literals and the last match starts at least 12 bytes before the end
+		constexpr std::size_t LZ4_MIN_MATCH = 4U;
+		constexpr std::size_t LZ4_LAST_LITERALS = 5U;
+		constexpr std::size_t LZ4_MATCH_LIMIT = 12U;
+		constexpr std::size_t LZ4_MAX_OFFSET = 65535U;
+		constexpr std::uint32_t LZ4_HASH_BITS = 16U;
+		constexpr std::uint32_t LZ4_NO_POSITION = 0xFFFFFFFFU;
+
+		[[nodiscard]] std::uint32_t read32(const unsigned char* bytes) noexcept {
+			std::uint32_t value = 0U;
+			std::memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+
+		[[nodiscard]] std::uint32_t lz4Hash(std::uint32_t sequence) noexcept {
+			return (sequence * 2654435761U) >> (32U - LZ4_HASH_BITS);
+		}
+
+		// A length field past its 4-bit nibble: runs of 255, then the remainder
+		void putLength(std::vector<unsigned char>& out, std::size_t length) {
+			for (; length >= 255U; length -= 255U) {
+				out.push_back(255U);
+			}
+			out.push_back(static_cast<unsigned char>(length));
+		}
+
+		void putSequence(std::vector<unsigned char>& out, const unsigned char* literals, std::size_t literalCount,
+			std::size_t offset, std::size_t matchLength)
+		{
+			const std::size_t matchCode = (matchLength > 0U) ? matchLength - LZ4_MIN_MATCH : 0U;
+			out.push_back(static_cast<unsigned char>((std::min<std::size_t>(literalCount, 15U) << 4U)
+				| std::min<std::size_t>(matchCode, 15U)));
+			if (literalCount >= 15U) {
+				putLength(out, literalCount - 15U);
+			}
+			out.insert(out.end(), literals, literals + literalCount);
+			if (matchLength == 0U) {
+				return; // the last sequence has literals only
+			}
+			out.push_back(static_cast<unsigned char>(offset));
+			out.push_back(static_cast<unsigned char>(offset >> 8U));
+			if (matchCode >= 15U) {
+				putLength(out, matchCode - 15U);
+			}
+		}
+
+		// Reads a length continued past its nibble; false if the block ends first
+		[[nodiscard]] bool readLength(const unsigned char*& in, const unsigned char* end, std::size_t& length) noexcept {
+			unsigned char next = 255U;
+			while (next == 255U) {
+				if (in == end) {
+					return false;
+				}
+				next = *in++;
+				length += next;
+			}
+			return true;
+		}
+
+		[[nodiscard]] bool readFile(const std::filesystem::path& path, std::vector<unsigned char>& bytes) {
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file) {
+				return false;
+			}
+			bytes.resize(static_cast<std::size_t>(file.tellg()));
+			file.seekg(0);
+			return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())));
+		}
+	}
+
+	std::vector<unsigned char> lz4Compress(const unsigned char* source, std::size_t size) {
+		std::vector<unsigned char> out;
+		std::vector<std::uint32_t> table;
+		lz4Compress(source, size, out, table);
+		return out;
+	}
+
+	void lz4Compress(const unsigned char* source, std::size_t size, std::vector<unsigned char>& out,
+		std::vector<std::uint32_t>& table)
+	{
+		out.clear();
+		table.assign(std::size_t{ 1 } << LZ4_HASH_BITS, LZ4_NO_POSITION); // sized even for an empty source
+		if (size == 0U) {
+			return;
+		}
+		out.reserve(size + size / 255U + 16U);
+		std::size_t anchor = 0U;
+		std::size_t i = 0U;
+		const std::size_t searchEnd = (size > LZ4_MATCH_LIMIT) ? size - LZ4_MATCH_LIMIT : 0U;
+		const std::size_t matchEnd = size - std::min(size, LZ4_LAST_LITERALS);
+		while (i < searchEnd) {
+			const std::uint32_t sequence = read32(source + i);
+			std::uint32_t& slot = table[lz4Hash(sequence)];
+			const std::uint32_t candidate = slot;
+			slot = static_cast<std::uint32_t>(i);
+			if (candidate == LZ4_NO_POSITION || i - candidate > LZ4_MAX_OFFSET || read32(source + candidate) != sequence) {
+				++i;
+				continue;
+			}
+
+			std::size_t length = LZ4_MIN_MATCH;
+			while (i + length < matchEnd && source[candidate + length] == source[i + length]) {
+				++length;
+			}
+			putSequence(out, source + anchor, i - anchor, i - candidate, length);
+			i += length;
+			anchor = i;
+		}
+		putSequence(out, source + anchor, size - anchor, 0U, 0U);
+	}
+
+	bool lz4Decompress(const unsigned char* block, std::size_t blockSize, unsigned char* out, std::size_t size) {
+		const unsigned char* in = block;
+		const unsigned char* const inEnd = block + blockSize;
+		std::size_t written = 0U;
+		while (in < inEnd) {
+			const unsigned char token = *in++;
+			std::size_t literals = token >> 4U;
+			if (literals == 15U && !readLength(in, inEnd, literals)) {
+				return false;
+			}
+			if (literals > static_cast<std::size_t>(inEnd - in) || literals > size - written) {
+				return false;
+			}
+			std::memcpy(out + written, in, literals);
+			in += literals;
+			written += literals;
+			if (in == inEnd) {
+				break; // the last sequence has no match
+			}
+
+			if (inEnd - in < 2) {
+				return false;
+			}
+			const std::size_t offset = static_cast<std::size_t>(in[0]) | (static_cast<std::size_t>(in[1]) << 8U);
+			in += 2;
+			std::size_t length = token & 0x0FU;
+			if (length == 15U && !readLength(in, inEnd, length)) {
+				return false;
+			}
+			length += LZ4_MIN_MATCH;
+			if (offset == 0U || offset > written || length > size - written) {
+				return false;
+			}
+			// Byte by byte: a match may overlap the bytes it produces
+			for (std::size_t k = 0U; k < length; ++k, ++written) {
+				out[written] = out[written - offset];
+			}
+		}
+		return written == size;
+	}
+
+	bool AssetPack::open(const std::string& path) {
+		close();
+		if (!m_file.open(path)) {
+			return false;
+		}
+
+		const unsigned char* const data = m_file.data();
+		const std::size_t size = m_file.size();
+		PackHeader header{};
+		if (size >= sizeof(header)) {
+			std::memcpy(&header, data, sizeof(header));
+		}
+		if (size < sizeof(header) || std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) {
+			std::cerr << "Error: " << path << " is not an asset pack\n";
+			m_file.close();
+			return false;
+		}
+		const std::uint64_t tocEnd = sizeof(header) + static_cast<std::uint64_t>(header.entryCount) * sizeof(Entry)
+			+ header.nameBytes;
+		if (tocEnd > size) {
+			std::cerr << "Error: asset pack " << path << " is truncated\n";
+			m_file.close();
+			return false;
+		}
+		m_path = path;
+		m_toc = data + sizeof(header);
+		m_names = reinterpret_cast<const char*>(m_toc + static_cast<std::size_t>(header.entryCount) * sizeof(Entry));
+		m_entryCount = header.entryCount;
+
+		// Every payload inside the file and past the table, stored ones at their own size, names in order
+		std::string_view previous;
+		for (std::size_t i = 0U; i < m_entryCount; ++i) {
+			Entry entry;
+			entryAt(i, entry);
+			const bool lz4 = (entry.flags & ENTRY_LZ4) != 0U;
+			const bool valid = static_cast<std::uint64_t>(entry.nameOffset) + entry.nameLength <= header.nameBytes
+				&& entry.offset >= tocEnd && entry.offset % PAYLOAD_ALIGNMENT == 0U
+				&& entry.offset <= size && entry.storedBytes <= size - entry.offset
+				&& (lz4 || entry.storedBytes == entry.size)
+				&& static_cast<std::size_t>(entry.size) == entry.size
+				&& (i == 0U || previous < nameOf(entry));
+			if (!valid) {
+				std::cerr << "Error: asset pack " << path << " has a corrupt table of contents (entry " << i << ")\n";
+				close();
+				return false;
+			}
+			previous = nameOf(entry);
+		}
+		return true;
+	}
+
+	void AssetPack::close() {
+		m_file.close();
+		m_path.clear();
+		m_toc = nullptr;
+		m_names = nullptr;
+		m_entryCount = 0U;
+	}
+
+	bool AssetPack::contains(std::string_view name) const noexcept {
+		Entry entry;
+		return find(name, entry);
+	}
+
+	bool AssetPack::read(std::string_view name, AssetBytes& bytes) const {
+		Entry entry;
+		if (!find(name, entry)) {
+			std::cerr << "Error: no asset " << name << " in " << m_path << '\n';
+			return false;
+		}
+		const unsigned char* const stored = m_file.data() + entry.offset;
+		const auto size = static_cast<std::size_t>(entry.size);
+		if ((entry.flags & ENTRY_LZ4) == 0U) {
+			bytes.m_owned.clear();
+			bytes.m_data = stored;
+			bytes.m_size = size;
+			return true;
+		}
+
+		bytes.m_owned.resize(size);
+		if (!lz4Decompress(stored, static_cast<std::size_t>(entry.storedBytes), bytes.m_owned.data(), size)) {
+			std::cerr << "Error: asset " << name << " in " << m_path << " is corrupt\n";
+			bytes.m_owned.clear();
+			bytes.m_data = nullptr;
+			bytes.m_size = 0U;
+			return false;
+		}
+		bytes.m_data = bytes.m_owned.data();
+		bytes.m_size = size;
+		return true;
+	}
+
+	std::vector<std::string> AssetPack::names(std::string_view prefix) const {
+		std::vector<std::string> found;
+		for (std::size_t i = 0U; i < m_entryCount; ++i) {
+			Entry entry;
+			entryAt(i, entry);
+			const std::string_view name = nameOf(entry);
+			if (name.substr(0U, prefix.size()) == prefix) {
+				found.emplace_back(name);
+			}
+		}
+		return found;
+	}
+
+	void AssetPack::entryAt(std::size_t index, Entry& entry) const noexcept {
+		static_assert(sizeof(Entry) == 40U, "table of contents records are written raw and must have no padding");
+		std::memcpy(&entry, m_toc + index * sizeof(Entry), sizeof(Entry));
+	}
+
+	bool AssetPack::find(std::string_view name, Entry& entry) const noexcept {
+		std::size_t first = 0U;
+		std::size_t count = m_entryCount;
+		while (count > 0U) {
+			const std::size_t half = count / 2U;
+			entryAt(first + half, entry);
+			if (nameOf(entry) < name) {
+				first += half + 1U;
+				count -= half + 1U;
+			}
+			else {
+				count = half;
+			}
+		}
+		if (first == m_entryCount) {
+			return false;
+		}
+		entryAt(first, entry);
+		return nameOf(entry) == name;
+	}
+
+	std::string_view AssetPack::nameOf(const Entry& entry) const noexcept {
+		return { m_names + entry.nameOffset, entry.nameLength };
+	}
+
+	bool writeAssetPack(const std::string& directory, const std::string& packPath, AssetPackStats* stats) {
+		namespace fs = std::filesystem;
+		struct Source {
+			std::string name;
+			fs::path path;
+			std::vector<unsigned char> stored;
+			std::uint64_t size = 0U;
+			bool lz4 = false;
+		};
+
+		const fs::path root = fs::path(directory).lexically_normal();
+		std::error_code error;
+		const fs::path packFile = fs::weakly_canonical(packPath, error);
+		std::vector<Source> sources;
+		for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+			std::error_code same;
+			if (!it->is_regular_file() || fs::equivalent(it->path(), packFile, same)) {
+				continue;
+			}
+			Source source;
+			source.path = it->path();
+			source.name = (root / it->path().lexically_relative(root)).generic_string();
+			sources.push_back(std::move(source));
+		}
+		if (error) {
+			std::cerr << "Error: Failed to list assets in " << fs::absolute(root) << '\n';
+			return false;
+		}
+		std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) { return a.name < b.name; });
+
+		AssetPackStats packed;
+		std::uint32_t nameBytes = 0U;
+		for (Source& source : sources) {
+			if (!readFile(source.path, source.stored)) {
+				std::cerr << "Error: Failed to read asset " << source.path << '\n';
+				return false;
+			}
+			source.size = source.stored.size();
+			std::vector<unsigned char> block = lz4Compress(source.stored.data(), source.stored.size());
+			if (!block.empty() && block.size() <= source.stored.size() - source.stored.size() / 8U) {
+				source.stored = std::move(block);
+				source.lz4 = true;
+				++packed.compressed;
+			}
+			nameBytes += static_cast<std::uint32_t>(source.name.size());
+			packed.sourceBytes += source.size;
+		}
+
+		PackHeader header{};
+		std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+		header.entryCount = static_cast<std::uint32_t>(sources.size());
+		header.nameBytes = nameBytes;
+
+		std::vector<AssetPack::Entry> entries(sources.size());
+		std::uint64_t offset = sizeof(header) + entries.size() * sizeof(AssetPack::Entry) + nameBytes;
+		std::uint32_t nameOffset = 0U;
+		for (std::size_t i = 0U; i < sources.size(); ++i) {
+			offset = (offset + PAYLOAD_ALIGNMENT - 1U) / PAYLOAD_ALIGNMENT * PAYLOAD_ALIGNMENT;
+			AssetPack::Entry& entry = entries[i];
+			entry.nameOffset = nameOffset;
+			entry.nameLength = static_cast<std::uint32_t>(sources[i].name.size());
+			entry.flags = sources[i].lz4 ? ENTRY_LZ4 : 0U;
+			entry.offset = offset;
+			entry.storedBytes = sources[i].stored.size();
+			entry.size = sources[i].size;
+			nameOffset += entry.nameLength;
+			offset += entry.storedBytes;
+		}
+
+		std::ofstream file(packPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: Failed to create asset pack " << packPath << '\n';
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(AssetPack::Entry)));
+		for (const Source& source : sources) {
+			file.write(source.name.data(), static_cast<std::streamsize>(source.name.size()));
+		}
+		const char padding[PAYLOAD_ALIGNMENT] = {};
+		for (std::size_t i = 0U; i < sources.size(); ++i) {
+			file.write(padding, static_cast<std::streamsize>(entries[i].offset - static_cast<std::uint64_t>(file.tellp())));
+			file.write(reinterpret_cast<const char*>(sources[i].stored.data()), static_cast<std::streamsize>(sources[i].stored.size()));
+		}
+		if (!file) {
+			std::cerr << "Error: Failed to write asset pack " << packPath << '\n';
+			return false;
+		}
+
+		packed.entries = sources.size();
+		packed.packBytes = offset;
+		if (stats != nullptr) {
+			*stats = packed;
+		}
+		return true;
+	}
+
+} // namespace assets
@@ -0,0 +1,124 @@
+/*
+==============================================================================
+Asset Pack - every asset file in one memory-mapped archive
+==============================================================================
+ - One open() and one mapping for the whole assets directory instead of an
+   open, stat and read per loose file, which is what cold start pays for
+   on slow storage
+ - Layout: header, table of contents (one fixed-size record per entry,
+   sorted by name), the name bytes, then the payloads, each starting on a
+   PAYLOAD_ALIGNMENT boundary
+ - Entries are named by their path as the loose file would be opened
+   (e.g. "assets/beep.mp3"), so callers look up the paths they already use
+ - A payload is stored as is, or as one LZ4 block when that saves at least
+   an eighth of it; already compressed images and sounds stay stored and
+   are read straight from the mapping without a copy
+ - The bytes of an entry feed SFML's loadFromMemory() (or an
+   sf::MemoryInputStream) directly
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+namespace assets {
+
+	constexpr std::size_t PAYLOAD_ALIGNMENT = 64U;
+
+	// Bytes of one entry: a view of the mapping when stored, owned when decompressed
+	class AssetBytes {
+	public:
+		[[nodiscard]] const unsigned char* data() const noexcept { return m_data; }
+		[[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+	private:
+		friend class AssetPack;
+
+		const unsigned char* m_data = nullptr;
+		std::size_t m_size = 0U;
+		std::vector<unsigned char> m_owned;
+	};
+
+	struct AssetPackStats {
+		std::size_t entries = 0U;
+		std::size_t compressed = 0U;   // entries stored as LZ4 blocks
+		std::uint64_t sourceBytes = 0U;
+		std::uint64_t packBytes = 0U;
+	};
+
+	class AssetPack {
+	public:
+		/**
+		 * @brief Maps the pack and validates its table of contents; false (logged) if either fails.
+		 */
+		[[nodiscard]] bool open(const std::string& path);
+		void close();
+
+		[[nodiscard]] bool isOpen() const noexcept { return m_toc != nullptr; }
+		[[nodiscard]] bool contains(std::string_view name) const noexcept;
+
+		/**
+		 * @brief The bytes of entry name, decompressing it if it is an LZ4 block.
+		 *
+		 * Returns false (logged) if there is no such entry or its block is corrupt.
+		 * Safe to call from several threads at once; views stay valid while the pack is open.
+		 */
+		[[nodiscard]] bool read(std::string_view name, AssetBytes& bytes) const;
+
+		/**
+		 * @brief Names of the entries starting with prefix, in name order.
+		 */
+		[[nodiscard]] std::vector<std::string> names(std::string_view prefix = {}) const;
+
+		[[nodiscard]] std::size_t entryCount() const noexcept { return m_entryCount; }
+
+	private:
+		struct Entry;
+		friend bool writeAssetPack(const std::string& directory, const std::string& packPath, AssetPackStats* stats);
+
+		// The table of contents is read with memcpy; the mapping gives no alignment guarantee for it
+		void entryAt(std::size_t index, Entry& entry) const noexcept;
+		[[nodiscard]] bool find(std::string_view name, Entry& entry) const noexcept;
+		[[nodiscard]] std::string_view nameOf(const Entry& entry) const noexcept;
+
+		MappedFile m_file;
+		std::string m_path;
+		const unsigned char* m_toc = nullptr;
+		const char* m_names = nullptr;
+		std::size_t m_entryCount = 0U;
+	};
+
+	/**
+	 * @brief Packs every regular file under directory into a pack at packPath.
+	 *
+	 * Entries are named directory/relative path with '/' separators. Returns
+	 * false (logged) if a file cannot be read or the pack cannot be written.
+	 */
+	[[nodiscard]] bool writeAssetPack(const std::string& directory, const std::string& packPath,
+		AssetPackStats* stats = nullptr);
+
+	/**
+	 * @brief LZ4 block of source (the frame-less block format); empty if source is empty.
+	 */
+	[[nodiscard]] std::vector<unsigned char> lz4Compress(const unsigned char* source, std::size_t size);
+
+	/**
+	 * @brief As above into out, reusing out and the match table; once both have grown
+	 *        to the largest source they no longer allocate (streamed block logs).
+	 */
+	void lz4Compress(const unsigned char* source, std::size_t size, std::vector<unsigned char>& out,
+		std::vector<std::uint32_t>& table);
+
+	/**
+	 * @brief Decodes an LZ4 block into exactly size bytes; false if it is corrupt or decodes to another size.
+	 */
+	[[nodiscard]] bool lz4Decompress(const unsigned char* block, std::size_t blockSize, unsigned char* out, std::size_t size);
+
+} // namespace assets
@@ -0,0 +1,35 @@
+#include "AudioAssets.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+
+namespace audio {
+
+	const sf::SoundBuffer& AudioCache::buffer(const std::string& path) {
+		const auto found = m_buffers.find(path);
+		if (found != m_buffers.end()) {
+			return *found->second;
+		}
+
+		auto decoded = std::make_unique<sf::SoundBuffer>();
+		if (!decoded->loadFromFile(path)) {
+			std::cerr << "Error: Failed to load sound from "
+				<< std::filesystem::absolute(path) << '\n';
+		}
+
+		m_charge.set(m_charge.bytes() + static_cast<std::size_t>(decoded->getSampleCount()) * sizeof(std::int16_t));
+
+		// Failures are cached too, so a missing file is only reported once
+		return *m_buffers.emplace(path, std::move(decoded)).first->second;
+	}
+
+	bool AudioCache::shouldStream(const std::string& path) {
+		sf::InputSoundFile file;
+		if (!file.openFromFile(path)) {
+			return false;
+		}
+		return file.getDuration() > sf::seconds(LONG_ASSET_SECONDS);
+	}
+
+} // namespace audio
@@ -0,0 +1,52 @@
+/*
+==============================================================================
+Audio Assets - decode-once cache for sound effects
+==============================================================================
+ - Each short asset is decoded into PCM exactly once and shared by every
+   sf::Sound that plays it
+ - Only assets longer than LONG_ASSET_SECONDS should be streamed with
+   sf::Music; shouldStream() checks the file header without decoding
+ - The decoded samples are charged to the audio memory subsystem
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Audio.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "MemoryAccounting.hpp"
+
+namespace audio {
+
+	// Assets longer than this are streamed instead of decoded up front
+	constexpr float LONG_ASSET_SECONDS = 10.0F;
+
+	class AudioCache {
+	public:
+		/**
+		 * @brief Decoded PCM for path, decoded on the first request only.
+		 *
+		 * On failure the error is logged once and an empty (silent) buffer is
+		 * returned, so callers can always construct an sf::Sound from it.
+		 * References stay valid for the lifetime of the cache.
+		 */
+		[[nodiscard]] const sf::SoundBuffer& buffer(const std::string& path);
+
+		/**
+		 * @brief True if the asset is long enough to be worth streaming.
+		 */
+		[[nodiscard]] static bool shouldStream(const std::string& path);
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_buffers.size(); }
+
+	private:
+		std::unordered_map<std::string, std::unique_ptr<sf::SoundBuffer>> m_buffers;
+		prof::MemoryCharge m_charge{ prof::MemorySubsystem::AudioBuffers, prof::MemoryKind::Heap }; // all samples
+	};
+
+} // namespace audio
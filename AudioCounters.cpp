@@ -0,0 +1,98 @@
+#include "AudioCounters.hpp"
+
+#include <algorithm>
+
+#include "Log.hpp"
+
+namespace prof {
+
+	namespace {
+		// Upper edge of the bucket holding the rank-th beep, in milliseconds
+		[[nodiscard]] float bucketPercentileMs(const std::array<std::uint32_t, AudioCounters::LATENESS_BUCKETS>& counts,
+			std::uint64_t total, float p) noexcept {
+			const auto rank = static_cast<std::uint64_t>(p / 100.0F * static_cast<float>(total - 1U)) + 1U;
+			std::uint64_t seen = 0U;
+			for (std::size_t i = 0U; i < counts.size(); ++i) {
+				seen += counts[i];
+				if (seen >= rank) {
+					return static_cast<float>(i + 1U) * AudioCounters::LATENESS_BUCKET_MS;
+				}
+			}
+			return static_cast<float>(counts.size()) * AudioCounters::LATENESS_BUCKET_MS;
+		}
+	}
+
+	void AudioCounters::recordBeep(float lateMs) noexcept {
+		const float late = std::max(lateMs, 0.0F);
+		const auto bucket = std::min(static_cast<std::size_t>(late / LATENESS_BUCKET_MS), LATENESS_BUCKETS - 1U);
+		m_lateness[bucket].fetch_add(1U, std::memory_order_relaxed);
+		m_beeps.fetch_add(1U, std::memory_order_relaxed);
+		if (late > LATE_BEEP_MS) {
+			m_lateBeeps.fetch_add(1U, std::memory_order_relaxed);
+		}
+		// Single writer, so a plain compare suffices
+		if (late > m_lateMaxMs.load(std::memory_order_relaxed)) {
+			m_lateMaxMs.store(late, std::memory_order_relaxed);
+		}
+	}
+
+	void AudioCounters::recordFill(float fillMs) noexcept {
+		const float fill = std::max(fillMs, 0.0F);
+		m_fillMs.store(fill, std::memory_order_relaxed);
+		const float lowest = m_fillMinMs.load(std::memory_order_relaxed);
+		if (lowest < 0.0F || fill < lowest) {
+			m_fillMinMs.store(fill, std::memory_order_relaxed);
+		}
+
+		// Counted once per starvation, not once per poll spent starved
+		if (fill <= 0.0F && !m_starved) {
+			m_underruns.fetch_add(1U, std::memory_order_relaxed);
+		}
+		m_starved = fill <= 0.0F;
+	}
+
+	void AudioCounters::setVoices(std::uint64_t steals, std::uint64_t drops, std::uint32_t busy, std::uint32_t count) noexcept {
+		m_voiceSteals.store(steals, std::memory_order_relaxed);
+		m_voiceDrops.store(drops, std::memory_order_relaxed);
+		m_voicesBusy.store(busy, std::memory_order_relaxed);
+		m_voiceCount.store(count, std::memory_order_relaxed);
+	}
+
+	AudioReport AudioCounters::report() const noexcept {
+		AudioReport report;
+		std::array<std::uint32_t, LATENESS_BUCKETS> counts{};
+		std::uint64_t total = 0U;
+		for (std::size_t i = 0U; i < LATENESS_BUCKETS; ++i) {
+			counts[i] = m_lateness[i].load(std::memory_order_relaxed);
+			total += counts[i];
+		}
+		// The buckets are the source of truth for the percentiles; m_beeps may already be one ahead
+		report.beeps = total;
+		report.lateBeeps = std::min(m_lateBeeps.load(std::memory_order_relaxed), total);
+		if (total > 0U) {
+			report.lateP50Ms = bucketPercentileMs(counts, total, 50.0F);
+			report.lateP99Ms = bucketPercentileMs(counts, total, 99.0F);
+			report.lateMaxMs = m_lateMaxMs.load(std::memory_order_relaxed);
+		}
+		report.underruns = m_underruns.load(std::memory_order_relaxed);
+		report.fillMs = m_fillMs.load(std::memory_order_relaxed);
+		report.fillMinMs = std::max(m_fillMinMs.load(std::memory_order_relaxed), 0.0F);
+		report.voiceSteals = m_voiceSteals.load(std::memory_order_relaxed);
+		report.voiceDrops = m_voiceDrops.load(std::memory_order_relaxed);
+		report.voicesBusy = m_voicesBusy.load(std::memory_order_relaxed);
+		report.voiceCount = m_voiceCount.load(std::memory_order_relaxed);
+		return report;
+	}
+
+	void AudioCounters::logReport() const {
+		const AudioReport report = this->report();
+		OKPP_LOG_INFO("Beep lateness over %llu beeps, ms p50/p99/max: %.2f / %.2f / %.2f (%llu later than %.1f ms)",
+			static_cast<unsigned long long>(report.beeps), static_cast<double>(report.lateP50Ms),
+			static_cast<double>(report.lateP99Ms), static_cast<double>(report.lateMaxMs),
+			static_cast<unsigned long long>(report.lateBeeps), static_cast<double>(LATE_BEEP_MS));
+		OKPP_LOG_INFO("Audio buffers: %llu underruns, lowest fill %.1f ms; voices: %llu stolen, %llu dropped",
+			static_cast<unsigned long long>(report.underruns), static_cast<double>(report.fillMinMs),
+			static_cast<unsigned long long>(report.voiceSteals), static_cast<unsigned long long>(report.voiceDrops));
+	}
+
+} // namespace prof
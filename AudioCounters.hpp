@@ -0,0 +1,98 @@
+/*
+==============================================================================
+Audio Counters - beep timing and audio buffer health, from the audio thread
+==============================================================================
+ - Lateness: how long after its scheduled wheel tick a sample beep's
+   play() was called; the audio thread waking late under CPU load shows
+   up here first. Kept as a histogram of LATENESS_BUCKET_MS buckets, so
+   recording is a couple of relaxed atomic adds and percentiles need no
+   history
+ - Fill: audio the synth stream has queued ahead of the device. An
+   underrun is counted each time the fill falls to zero while the
+   stream is playing; the device then plays silence
+ - Voices: steals (a busy voice cut off for a closer beep) and drops (a
+   beep lost because every voice was closer) from the VoicePool
+ - One writer (the audio thread), any number of readers: the profiler
+   overlay, the telemetry and the report logged at exit
+ - No SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace prof {
+
+	// Beeps later than this break the warning cadence audibly; they are counted as late
+	constexpr float LATE_BEEP_MS = 5.0F;
+
+	struct AudioReport {
+		std::uint64_t beeps = 0U;        // sample beeps with a recorded lateness
+		std::uint64_t lateBeeps = 0U;    // of those, later than LATE_BEEP_MS
+		float lateP50Ms = 0.0F;
+		float lateP99Ms = 0.0F;
+		float lateMaxMs = 0.0F;
+		std::uint64_t underruns = 0U;
+		float fillMs = 0.0F;             // queued ahead of the device at the last poll (synth only)
+		float fillMinMs = 0.0F;          // lowest fill seen while playing
+		std::uint64_t voiceSteals = 0U;
+		std::uint64_t voiceDrops = 0U;
+		std::uint32_t voicesBusy = 0U;
+		std::uint32_t voiceCount = 0U;
+	};
+
+	class AudioCounters {
+	public:
+		static constexpr float LATENESS_BUCKET_MS = 0.25F;
+		static constexpr std::size_t LATENESS_BUCKETS = 256U; // the last one also takes everything later
+
+		AudioCounters() = default;
+
+		AudioCounters(const AudioCounters&) = delete;
+		AudioCounters& operator=(const AudioCounters&) = delete;
+
+		/**
+		 * @brief A beep started lateMs after it was due.
+		 */
+		void recordBeep(float lateMs) noexcept;
+
+		/**
+		 * @brief The stream's queued audio at this poll; a fall to zero while playing is an underrun.
+		 */
+		void recordFill(float fillMs) noexcept;
+
+		/**
+		 * @brief Voice pool totals as they stand now.
+		 */
+		void setVoices(std::uint64_t steals, std::uint64_t drops, std::uint32_t busy, std::uint32_t count) noexcept;
+
+		/**
+		 * @brief Current totals and lateness percentiles; may be called from any thread.
+		 */
+		[[nodiscard]] AudioReport report() const noexcept;
+
+		/**
+		 * @brief Logs the report, one line for lateness and one for buffers and voices.
+		 */
+		void logReport() const;
+
+	private:
+		std::array<std::atomic<std::uint32_t>, LATENESS_BUCKETS> m_lateness{};
+		std::atomic<std::uint64_t> m_beeps{ 0U };
+		std::atomic<std::uint64_t> m_lateBeeps{ 0U };
+		std::atomic<float> m_lateMaxMs{ 0.0F };
+		std::atomic<std::uint64_t> m_underruns{ 0U };
+		std::atomic<float> m_fillMs{ 0.0F };
+		std::atomic<float> m_fillMinMs{ -1.0F }; // -1 until the first poll
+		std::atomic<std::uint64_t> m_voiceSteals{ 0U };
+		std::atomic<std::uint64_t> m_voiceDrops{ 0U };
+		std::atomic<std::uint32_t> m_voicesBusy{ 0U };
+		std::atomic<std::uint32_t> m_voiceCount{ 0U };
+		bool m_starved = false; // audio thread only: the fill is at zero since the last underrun
+	};
+
+} // namespace prof
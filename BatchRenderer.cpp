@@ -0,0 +1,171 @@
+#include "BatchRenderer.hpp"
+
+#include <SFML/Window/Context.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include "Trace.hpp"
+
+namespace gfx {
+
+	namespace {
+		[[nodiscard]] gl::ProcAddress batchLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+	}
+
+	BatchRenderer::~BatchRenderer() {
+		finish();
+	}
+
+	bool BatchRenderer::start(const sf::Vector2u& tileSize, const sf::Vector2u& passSize, const sf::FloatRect& world,
+		sf::Color background, sim::ThreadPool& pool, TileSink sink)
+	{
+		if (tileSize.x == 0U || tileSize.y == 0U || tileSize.x > passSize.x || tileSize.y > passSize.y) {
+			std::cerr << "Error: a " << tileSize.x << 'x' << tileSize.y << " image does not fit a "
+				<< passSize.x << 'x' << passSize.y << " batch pass\n";
+			return false;
+		}
+		if (!gl::loaded() && !gl::load(&batchLoader)) {
+			std::cerr << "Error: pixel buffers are unavailable, cannot batch render\n";
+			return false;
+		}
+		m_columns = passSize.x / tileSize.x;
+		m_rows = passSize.y / tileSize.y;
+		const sf::Vector2u size{ m_columns * tileSize.x, m_rows * tileSize.y };
+		sf::RenderTexture texture;
+		if (!texture.resize(size)) {
+			std::cerr << "Error: Failed to create a " << size.x << 'x' << size.y << " batch texture\n";
+			return false;
+		}
+		m_texture.emplace(std::move(texture));
+		m_texture->clear(background);
+
+		m_tileSize = tileSize;
+		m_view = sf::View(world);
+		m_background = background;
+		m_pool = &pool;
+		m_sink = std::move(sink);
+		m_stats = {};
+
+		if (!m_texture->setActive(true)) {
+			return false;
+		}
+		const gl::Api& api = gl::api();
+		const auto bytes = static_cast<gl::SizeiPtr>(size.x) * static_cast<gl::SizeiPtr>(size.y) * 4;
+		api.GenBuffers(static_cast<GLsizei>(m_packBuffers.size()), m_packBuffers.data());
+		for (const GLuint buffer : m_packBuffers) {
+			api.BindBuffer(gl::PIXEL_PACK_BUFFER, buffer);
+			api.BufferData(gl::PIXEL_PACK_BUFFER, bytes, nullptr, gl::STREAM_READ);
+		}
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, 0U);
+		m_passPixels.resize(static_cast<std::size_t>(bytes));
+		m_cells.reserve(tilesPerPass());
+		return true;
+	}
+
+	void BatchRenderer::add(std::uint64_t index, const DrawFn& draw) {
+		if (!m_texture) {
+			return;
+		}
+		const auto cell = static_cast<std::uint32_t>(m_cells.size());
+		const float columns = static_cast<float>(m_columns);
+		const float rows = static_cast<float>(m_rows);
+		m_view.setViewport({ { static_cast<float>(cell % m_columns) / columns, static_cast<float>(cell / m_columns) / rows },
+			{ 1.0F / columns, 1.0F / rows } });
+		m_texture->setView(m_view);
+		draw(*m_texture);
+		m_cells.push_back(index);
+		if (m_cells.size() == tilesPerPass()) {
+			flushPass();
+		}
+	}
+
+	void BatchRenderer::flushPass() {
+		OKPP_TRACE_SCOPE("batch readback");
+		m_texture->display();
+		if (!m_texture->setActive(true)) {
+			m_cells.clear();
+			return;
+		}
+		const gl::Api& api = gl::api();
+		const sf::Vector2u size = m_texture->getSize();
+
+		// This pass's transfer starts now; the previous one has had a whole pass to finish
+		const std::size_t current = m_nextBuffer;
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, m_packBuffers[current]);
+		glReadPixels(0, 0, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		m_passIndices[current].swap(m_cells);
+		m_cells.clear();
+		++m_stats.passes;
+
+		m_nextBuffer = current ^ 1U;
+		collect(m_nextBuffer);
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, 0U);
+		m_texture->clear(m_background);
+	}
+
+	void BatchRenderer::collect(std::size_t buffer) {
+		std::vector<std::uint64_t>& indices = m_passIndices[buffer];
+		if (indices.empty()) {
+			return;
+		}
+		// The cutting tasks of the pass before still read m_passPixels
+		m_pool->wait(m_group);
+
+		const gl::Api& api = gl::api();
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, m_packBuffers[buffer]);
+		const void* pixels = api.MapBuffer(gl::PIXEL_PACK_BUFFER, gl::READ_ONLY);
+		if (pixels == nullptr) {
+			std::cerr << "Error: Failed to map a batch pass, " << indices.size() << " images lost\n";
+			indices.clear();
+			return;
+		}
+		std::memcpy(m_passPixels.data(), pixels, m_passPixels.size());
+		(void)api.UnmapBuffer(gl::PIXEL_PACK_BUFFER);
+
+		const std::size_t passWidth = m_texture->getSize().x;
+		const std::size_t passHeight = m_texture->getSize().y;
+		for (std::size_t cell = 0U; cell < indices.size(); ++cell) {
+			const std::uint64_t index = indices[cell];
+			m_pool->submit(m_group, [this, cell, index, passWidth, passHeight]() {
+				SoftImage tile;
+				tile.width = m_tileSize.x;
+				tile.height = m_tileSize.y;
+				tile.pixels.resize(static_cast<std::size_t>(tile.width) * tile.height * 4U);
+				const std::size_t left = (cell % m_columns) * tile.width;
+				const std::size_t top = (cell / m_columns) * tile.height;
+				const std::size_t rowBytes = static_cast<std::size_t>(tile.width) * 4U;
+				// glReadPixels rows run bottom-up
+				for (std::size_t y = 0U; y < tile.height; ++y) {
+					const std::size_t sourceRow = passHeight - 1U - (top + y);
+					std::memcpy(tile.pixels.data() + y * rowBytes, m_passPixels.data() + (sourceRow * passWidth + left) * 4U, rowBytes);
+				}
+				m_sink(index, tile);
+			});
+		}
+		m_stats.tiles += indices.size();
+		indices.clear();
+	}
+
+	void BatchRenderer::finish() {
+		if (!m_texture) {
+			return;
+		}
+		if (!m_cells.empty()) {
+			flushPass();
+		}
+		if (m_texture->setActive(true)) {
+			collect(m_nextBuffer ^ 1U);
+			gl::api().BindBuffer(gl::PIXEL_PACK_BUFFER, 0U);
+			gl::api().DeleteBuffers(static_cast<GLsizei>(m_packBuffers.size()), m_packBuffers.data());
+			m_packBuffers = {};
+		}
+		m_pool->wait(m_group);
+		m_texture.reset();
+	}
+
+} // namespace gfx
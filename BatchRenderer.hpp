@@ -0,0 +1,99 @@
+/*
+==============================================================================
+Batch Renderer - many scene states per pass into one render texture (--render-batch)
+==============================================================================
+ - Each state is drawn into its own cell of a large off-screen texture,
+   the cell a viewport of the same world view, so one pass holds as many
+   images as fit and no window or display() is needed per image
+ - A full pass is read back through one of two pixel-pack buffers and
+   mapped only after the next pass has been drawn, by which time its
+   transfer has finished, so drawing never waits on the GPU
+ - The mapped pass is copied out in one block; its cells are cut apart
+   (rows flipped, GL reads bottom-up) and handed to the sink as tasks on
+   the job system, at most one pass behind the GPU
+ - Cells are numbered by the caller; the sink may run on any worker, in
+   any order
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "GlFunctions.hpp"
+#include "SoftRasterizer.hpp"
+#include "ThreadPool.hpp"
+
+namespace gfx {
+
+	struct BatchStats {
+		std::uint64_t tiles = 0U;
+		std::uint64_t passes = 0U;
+	};
+
+	class BatchRenderer {
+	public:
+		// Draws one state into target, whose view already maps the world onto its cell
+		using DrawFn = std::function<void(sf::RenderTarget& target)>;
+		// Receives one finished image; runs on a pool worker
+		using TileSink = std::function<void(std::uint64_t index, const SoftImage& tile)>;
+
+		BatchRenderer() = default;
+		~BatchRenderer();
+
+		BatchRenderer(const BatchRenderer&) = delete;
+		BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+		/**
+		 * @brief Starts passes of tileSize cells over a texture up to passSize, every cell showing world.
+		 *
+		 * Requires an active GL context. Returns false (and logs) if the
+		 * texture or the pixel buffers cannot be created.
+		 */
+		[[nodiscard]] bool start(const sf::Vector2u& tileSize, const sf::Vector2u& passSize, const sf::FloatRect& world,
+			sf::Color background, sim::ThreadPool& pool, TileSink sink);
+
+		/**
+		 * @brief Draws image index into the next free cell; a full pass is read back at once.
+		 */
+		void add(std::uint64_t index, const DrawFn& draw);
+
+		/**
+		 * @brief Reads back the partial pass, waits for every image to reach the sink; safe to call twice.
+		 */
+		void finish();
+
+		[[nodiscard]] std::size_t tilesPerPass() const noexcept { return static_cast<std::size_t>(m_columns) * m_rows; }
+		[[nodiscard]] const BatchStats& stats() const noexcept { return m_stats; }
+
+	private:
+		void flushPass();
+		void collect(std::size_t buffer);
+
+		std::optional<sf::RenderTexture> m_texture;
+		sf::View m_view;
+		sf::Color m_background;
+		sf::Vector2u m_tileSize;
+		std::uint32_t m_columns = 0U;
+		std::uint32_t m_rows = 0U;
+
+		std::array<GLuint, 2> m_packBuffers{};
+		std::array<std::vector<std::uint64_t>, 2> m_passIndices; // cell i of the pass in each buffer shows image [i]
+		std::vector<std::uint64_t> m_cells;                       // cells drawn in the open pass
+		std::size_t m_nextBuffer = 0U;
+
+		std::vector<std::uint8_t> m_passPixels; // mapped pass, read by the cutting tasks
+		sim::ThreadPool* m_pool = nullptr;
+		sim::TaskGroup m_group;
+		TileSink m_sink;
+		BatchStats m_stats;
+	};
+
+} // namespace gfx
@@ -0,0 +1,288 @@
+#include "BayOccupancy.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CpuFeatures.hpp"
+#include "SimdIntrinsics.hpp"
+
+namespace sim {
+
+	namespace {
+		// Clamp before float->int conversion so far-away queries stay defined
+		constexpr float MAX_TILE_COORD = 1.0e6F;
+		constexpr std::uint32_t WORD_BITS = 64U;
+
+		[[nodiscard]] std::size_t countWordBits(std::uint64_t x) noexcept {
+			x = x - ((x >> 1U) & 0x5555555555555555ULL);
+			x = (x & 0x3333333333333333ULL) + ((x >> 2U) & 0x3333333333333333ULL);
+			x = (x + (x >> 4U)) & 0x0F0F0F0F0F0F0F0FULL;
+			return static_cast<std::size_t>((x * 0x0101010101010101ULL) >> 56U);
+		}
+
+		// Index of the lowest set bit of a non-zero word (de Bruijn multiply, no intrinsics)
+		[[nodiscard]] std::uint32_t lowestBit(std::uint64_t x) noexcept {
+			static constexpr std::uint8_t POSITIONS[64] = {
+				0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+				62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+				63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+				46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+			};
+			return POSITIONS[((x & (~x + 1U)) * 0x03F79D71B4CB0A89ULL) >> 58U];
+		}
+
+		// Words [first, count) one at a time: the tail of every SIMD kernel and the scalar level
+		[[nodiscard]] std::size_t countBitsScalar(const std::uint64_t* words, std::size_t first, std::size_t count) noexcept {
+			std::size_t bits = 0U;
+			for (std::size_t i = first; i < count; ++i) {
+				bits += countWordBits(words[i]);
+			}
+			return bits;
+		}
+
+		// Each kernel counts whole vectors of words, adds them to bits and returns how many words it did
+#if defined(OKPP_SIMD_X86)
+		OKPP_TARGET_SSE2 std::size_t countBitsSse2(const std::uint64_t* words, std::size_t count, std::size_t& bits) noexcept {
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i m1 = _mm_set1_epi8(0x55);
+			const __m128i m2 = _mm_set1_epi8(0x33);
+			const __m128i m4 = _mm_set1_epi8(0x0F);
+			__m128i total = zero;
+			std::size_t i = 0U;
+			for (; i + 2U <= count; i += 2U) {
+				// Bit counts per byte by bit slicing, then summed per half by the byte SAD
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+				x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi64(x, 1), m1));
+				x = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi64(x, 2), m2));
+				x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi64(x, 4)), m4);
+				total = _mm_add_epi64(total, _mm_sad_epu8(x, zero));
+			}
+			alignas(16) std::uint64_t lanes[2];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), total);
+			bits += static_cast<std::size_t>(lanes[0] + lanes[1]);
+			return i;
+		}
+
+		OKPP_TARGET_AVX2 std::size_t countBitsAvx2(const std::uint64_t* words, std::size_t count, std::size_t& bits) noexcept {
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i nibble = _mm256_set1_epi8(0x0F);
+			const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			__m256i total = zero;
+			std::size_t i = 0U;
+			for (; i + 4U <= count; i += 4U) {
+				// Bit counts per nibble from the table, both nibbles added, summed per quarter by the byte SAD
+				const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+				const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, nibble));
+				const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+				total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), zero));
+			}
+			alignas(32) std::uint64_t lanes[4];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+			bits += static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+			return i;
+		}
+#elif defined(OKPP_SIMD_NEON)
+		std::size_t countBitsNeon(const std::uint64_t* words, std::size_t count, std::size_t& bits) noexcept {
+			uint64x2_t total = vdupq_n_u64(0U);
+			std::size_t i = 0U;
+			for (; i + 2U <= count; i += 2U) {
+				const uint8x16_t perByte = vcntq_u8(vreinterpretq_u8_u64(vld1q_u64(words + i)));
+				total = vaddq_u64(total, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(perByte))));
+			}
+			bits += static_cast<std::size_t>(vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1));
+			return i;
+		}
+#endif
+	}
+
+	std::size_t countBits(const std::uint64_t* words, std::size_t count) noexcept {
+		std::size_t bits = 0U;
+		std::size_t done = 0U;
+		switch (simdLevel()) {
+#if defined(OKPP_SIMD_X86)
+		case SimdLevel::Avx512: // AVX-512F has no byte shuffle or popcount of its own; the AVX2 kernel runs
+		case SimdLevel::Avx2: done = countBitsAvx2(words, count, bits); break;
+		case SimdLevel::Sse2: done = countBitsSse2(words, count, bits); break;
+#elif defined(OKPP_SIMD_NEON)
+		case SimdLevel::Neon: done = countBitsNeon(words, count, bits); break;
+#endif
+		default: break;
+		}
+		return bits + countBitsScalar(words, done, count);
+	}
+
+	const char* countBitsKernelName() noexcept {
+		switch (simdLevel()) {
+		case SimdLevel::Avx512:
+		case SimdLevel::Avx2: return "avx2";
+		case SimdLevel::Sse2: return "sse2";
+		case SimdLevel::Neon: return "neon";
+		default: return "scalar";
+		}
+	}
+
+	std::uint64_t BayOccupancyIndex::tileKey(int tx, int ty) noexcept {
+		return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(tx)) << 32U)
+			| static_cast<std::uint64_t>(static_cast<std::uint32_t>(ty));
+	}
+
+	int BayOccupancyIndex::toTile(float coord) const noexcept {
+		return static_cast<int>(std::clamp(std::floor(coord * m_invTileSize), -MAX_TILE_COORD, MAX_TILE_COORD));
+	}
+
+	void BayOccupancyIndex::build(const std::vector<sf::FloatRect>& bays, float tileSize) {
+		if (tileSize <= 0.0F) {
+			tileSize = TILE_BAYS_ACROSS
+				* (bays.empty() ? 1.0F : std::max({ bays.front().size.x, bays.front().size.y, 1.0F }));
+		}
+		m_invTileSize = 1.0F / tileSize;
+
+		// Bucket the bays by the tile their center falls in
+		std::vector<std::vector<std::uint32_t>> tileBays;
+		m_tileCells.clear();
+		m_lowCell = {};
+		m_highCell = {};
+		for (std::size_t i = 0U; i < bays.size(); ++i) {
+			const sf::Vector2f center = bays[i].getCenter();
+			const sf::Vector2i cell{ toTile(center.x), toTile(center.y) };
+			const auto [it, added] = m_tileCells.try_emplace(tileKey(cell.x, cell.y),
+				static_cast<std::uint32_t>(tileBays.size()));
+			if (added) {
+				tileBays.emplace_back();
+				m_lowCell = (i == 0U) ? cell : sf::Vector2i{ std::min(m_lowCell.x, cell.x), std::min(m_lowCell.y, cell.y) };
+				m_highCell = (i == 0U) ? cell : sf::Vector2i{ std::max(m_highCell.x, cell.x), std::max(m_highCell.y, cell.y) };
+			}
+			tileBays[it->second].push_back(static_cast<std::uint32_t>(i));
+		}
+
+		// Consecutive slots per tile, each tile starting on a fresh word
+		m_tiles.clear();
+		m_tiles.reserve(tileBays.size());
+		std::uint32_t words = 0U;
+		for (const std::vector<std::uint32_t>& members : tileBays) {
+			const auto count = static_cast<std::uint32_t>(members.size());
+			m_tiles.push_back({ words, (count + WORD_BITS - 1U) / WORD_BITS, count });
+			words += m_tiles.back().words;
+		}
+		m_baySlot.assign(bays.size(), 0U);
+		m_slotBay.assign(static_cast<std::size_t>(words) * WORD_BITS, 0U);
+		m_slotCenter.assign(m_slotBay.size(), sf::Vector2f{});
+		m_valid.assign(words, 0U);
+		for (std::size_t t = 0U; t < tileBays.size(); ++t) {
+			std::uint32_t slot = m_tiles[t].firstWord * WORD_BITS;
+			for (const std::uint32_t bay : tileBays[t]) {
+				m_baySlot[bay] = slot;
+				m_slotBay[slot] = bay;
+				m_slotCenter[slot] = bays[bay].getCenter();
+				m_valid[slot / WORD_BITS] |= std::uint64_t{ 1U } << (slot % WORD_BITS);
+				++slot;
+			}
+		}
+	}
+
+	void BayOccupancyIndex::countFree(BayOccupancyFrame& frame) const noexcept {
+		frame.freeTotal = 0U;
+		for (std::size_t t = 0U; t < m_tiles.size(); ++t) {
+			const Tile& tile = m_tiles[t];
+			const auto occupied = static_cast<std::uint32_t>(countBits(frame.words.data() + tile.firstWord, tile.words));
+			frame.tileFree[t] = tile.bays - occupied;
+			frame.freeTotal += frame.tileFree[t];
+		}
+	}
+
+	std::uint32_t BayOccupancyIndex::nearestFree(const BayOccupancyFrame& frame, const sf::Vector2f& point, float radius,
+		std::size_t limit, std::vector<FreeBay>& out) const
+	{
+		out.clear();
+		if (m_tiles.empty() || !(radius >= 0.0F)) {
+			return 0U;
+		}
+		const float radiusSq = radius * radius;
+		const int lowX = std::max(toTile(point.x - radius), m_lowCell.x);
+		const int highX = std::min(toTile(point.x + radius), m_highCell.x);
+		const int lowY = std::max(toTile(point.y - radius), m_lowCell.y);
+		const int highY = std::min(toTile(point.y + radius), m_highCell.y);
+		for (int ty = lowY; ty <= highY; ++ty) {
+			for (int tx = lowX; tx <= highX; ++tx) {
+				const auto found = m_tileCells.find(tileKey(tx, ty));
+				if (found == m_tileCells.end() || frame.tileFree[found->second] == 0U) {
+					continue;
+				}
+				const Tile& tile = m_tiles[found->second];
+				for (std::uint32_t w = tile.firstWord; w < tile.firstWord + tile.words; ++w) {
+					for (std::uint64_t free = m_valid[w] & ~frame.words[w]; free != 0U; free &= free - 1U) {
+						const std::uint32_t slot = w * WORD_BITS + lowestBit(free);
+						const sf::Vector2f offset = m_slotCenter[slot] - point;
+						const float distanceSq = offset.dot(offset);
+						if (distanceSq <= radiusSq) {
+							out.push_back({ m_slotBay[slot], distanceSq }); // squared until the cut below
+						}
+					}
+				}
+			}
+		}
+
+		const auto total = static_cast<std::uint32_t>(out.size());
+		const auto nearer = [](const FreeBay& a, const FreeBay& b) {
+			return (a.distance < b.distance) || (a.distance == b.distance && a.bay < b.bay);
+		};
+		if (out.size() > limit) {
+			std::nth_element(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(limit), out.end(), nearer);
+			out.resize(limit);
+		}
+		std::sort(out.begin(), out.end(), nearer);
+		for (FreeBay& bay : out) {
+			bay.distance = std::sqrt(bay.distance);
+		}
+		return total;
+	}
+
+	void BayOccupancyBoard::reset(const BayOccupancyIndex& index) {
+		m_index = &index;
+		for (BayOccupancyFrame& frame : m_frames) {
+			frame.words.assign(index.wordCount(), 0U);
+			frame.tileFree.assign(index.tileCount(), 0U);
+			frame.version = 0U;
+			index.countFree(frame);
+		}
+		m_marks.assign(index.wordCount(), 0U);
+		m_back = 0U;
+		m_front = 1U;
+		m_middle.store(2U, std::memory_order_relaxed);
+		m_version = 0U;
+		m_dirty = false;
+	}
+
+	void BayOccupancyBoard::setOccupied(std::uint32_t bay, bool occupied) noexcept {
+		if (m_index == nullptr || bay >= m_index->bayCount()) {
+			return;
+		}
+		const std::uint32_t slot = m_index->slot(bay);
+		const std::uint64_t bit = std::uint64_t{ 1U } << (slot % WORD_BITS);
+		std::uint64_t& word = m_marks[slot / WORD_BITS];
+		word = occupied ? (word | bit) : (word & ~bit);
+		m_dirty = true;
+	}
+
+	void BayOccupancyBoard::publish() noexcept {
+		if (!m_dirty) {
+			return;
+		}
+		m_dirty = false;
+		BayOccupancyFrame& frame = m_frames[m_back];
+		std::copy(m_marks.begin(), m_marks.end(), frame.words.begin());
+		frame.version = ++m_version;
+		// Release: the reader that takes this buffer sees the words written above
+		m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	const BayOccupancyFrame& BayOccupancyBoard::acquire() noexcept {
+		if ((m_middle.load(std::memory_order_relaxed) & FRESH) != 0U) {
+			m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+			m_index->countFree(m_frames[m_front]);
+		}
+		return m_frames[m_front];
+	}
+
+} // namespace sim
@@ -0,0 +1,161 @@
+/*
+==============================================================================
+Bay Occupancy - lot-wide "which bays are free near (x, y)" from a bitset
+==============================================================================
+ - BayOccupancyIndex lays the bays out once: bays are bucketed by center
+   into square tiles of a spatial hash, and each tile's bays get
+   consecutive slots of one occupancy bitset, padded to whole 64-bit
+   words, so a tile is a contiguous run of words
+ - The free bays of a tile are its valid slots with a clear bit; a tile's
+   free count is its bay count minus one popcount over its words, so a
+   query skips every full tile without looking at a bay
+ - countBits() is the popcount kernel, picked per call from simdLevel()
+   (CpuFeatures): AVX2 nibble lookup (a 16x16 tile of bays is one vector),
+   SSE2 bit slicing, NEON byte counts, or a scalar SWAR count
+ - BayOccupancyBoard hands the bitset from the simulation thread to one
+   reader thread through three buffers: the writer flips bits in its own
+   copy and publish() swaps a finished frame in with one atomic exchange,
+   the reader takes the newest frame with another, and neither ever
+   waits for the other. The reader recounts the tiles of a frame it takes
+ - No SFML dependency beyond the vector and rect types
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sim {
+
+	/**
+	 * @brief Set bits in words[0, count), at the dispatched SIMD level.
+	 */
+	[[nodiscard]] std::size_t countBits(const std::uint64_t* words, std::size_t count) noexcept;
+
+	/**
+	 * @brief Name of the kernel countBits runs at the moment.
+	 */
+	[[nodiscard]] const char* countBitsKernelName() noexcept;
+
+	struct FreeBay {
+		std::uint32_t bay = 0U;
+		float distance = 0.0F; // from the query point to the bay's center
+	};
+
+	// One published state of the lot: a bit per slot, set = occupied
+	struct BayOccupancyFrame {
+		std::vector<std::uint64_t> words;
+		std::vector<std::uint32_t> tileFree; // free bays per tile, counted by the reader
+		std::uint32_t freeTotal = 0U;
+		std::uint32_t version = 0U; // publish() calls so far
+	};
+
+	class BayOccupancyIndex {
+	public:
+		// Default tile edge, in bays: 16 x 16 bays fill four words, one AVX2 vector
+		static constexpr float TILE_BAYS_ACROSS = 16.0F;
+
+		/**
+		 * @brief Lays out bays in tiles of tileSize world units.
+		 *
+		 * MISRA: tileSize must be strictly positive; non-positive values use
+		 *        TILE_BAYS_ACROSS times the larger side of the first bay.
+		 */
+		void build(const std::vector<sf::FloatRect>& bays, float tileSize);
+
+		[[nodiscard]] std::size_t bayCount() const noexcept { return m_baySlot.size(); }
+		[[nodiscard]] std::size_t tileCount() const noexcept { return m_tiles.size(); }
+		[[nodiscard]] std::size_t wordCount() const noexcept { return m_valid.size(); }
+		[[nodiscard]] std::uint32_t slot(std::uint32_t bay) const { return m_baySlot[bay]; }
+
+		/**
+		 * @brief Recounts frame's free bays per tile and in total.
+		 */
+		void countFree(BayOccupancyFrame& frame) const noexcept;
+
+		/**
+		 * @brief The free bays whose centers lie within radius of point, nearest first,
+		 *        at most limit of them in out; returns how many there are in all.
+		 *
+		 * Only the tiles covering the circle are visited, and of those only the
+		 * ones with a free bay. MISRA: no allocation once out has grown to limit.
+		 */
+		std::uint32_t nearestFree(const BayOccupancyFrame& frame, const sf::Vector2f& point, float radius,
+			std::size_t limit, std::vector<FreeBay>& out) const;
+
+	private:
+		struct Tile {
+			std::uint32_t firstWord = 0U;
+			std::uint32_t words = 0U;
+			std::uint32_t bays = 0U;
+		};
+
+		[[nodiscard]] static std::uint64_t tileKey(int tx, int ty) noexcept;
+		[[nodiscard]] int toTile(float coord) const noexcept;
+
+		std::vector<std::uint32_t> m_baySlot;    // bay -> bitset slot
+		std::vector<std::uint32_t> m_slotBay;    // slot -> bay (padding slots unused)
+		std::vector<sf::Vector2f> m_slotCenter;  // slot -> bay center
+		std::vector<std::uint64_t> m_valid;      // set for slots that hold a bay
+		std::vector<Tile> m_tiles;
+		std::unordered_map<std::uint64_t, std::uint32_t> m_tileCells; // tile cell -> tile
+		sf::Vector2i m_lowCell;  // tile cells actually used, so a huge radius visits no empty cells
+		sf::Vector2i m_highCell;
+		float m_invTileSize = 1.0F;
+	};
+
+	class BayOccupancyBoard {
+	public:
+		BayOccupancyBoard() = default;
+		BayOccupancyBoard(const BayOccupancyBoard&) = delete;
+		BayOccupancyBoard& operator=(const BayOccupancyBoard&) = delete;
+
+		/**
+		 * @brief Sizes every buffer for index, all bays free.
+		 *
+		 * MISRA: neither side may be running; index must outlive the board's use.
+		 */
+		void reset(const BayOccupancyIndex& index);
+
+		/**
+		 * @brief Writer side: marks bay occupied or free in the next frame.
+		 */
+		void setOccupied(std::uint32_t bay, bool occupied) noexcept;
+
+		/**
+		 * @brief Writer side: hands the marks over to the reader; a no-op if nothing changed.
+		 *
+		 * Copies the bitset once, never blocks, never allocates.
+		 */
+		void publish() noexcept;
+
+		/**
+		 * @brief Reader side: the newest published frame, its tiles counted.
+		 *
+		 * The reference stays valid, and the frame unchanged, until the next acquire().
+		 */
+		[[nodiscard]] const BayOccupancyFrame& acquire() noexcept;
+
+	private:
+		static constexpr std::uint32_t FRESH = 4U; // the middle buffer holds a frame the reader has not taken
+		static constexpr std::uint32_t INDEX_MASK = 3U;
+
+		const BayOccupancyIndex* m_index = nullptr;
+		std::array<BayOccupancyFrame, 3> m_frames;
+		std::vector<std::uint64_t> m_marks; // the writer's bitset
+		std::uint32_t m_back = 0U;          // writer's buffer
+		std::uint32_t m_front = 1U;         // reader's buffer
+		std::atomic<std::uint32_t> m_middle{ 2U };
+		std::uint32_t m_version = 0U;
+		bool m_dirty = false;
+	};
+
+} // namespace sim
@@ -0,0 +1,215 @@
+#include "BeepScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Trace.hpp"
+
+namespace audio {
+
+	namespace {
+		// Upper bound on how stale an interval can get before the worker reacts; one wheel tick
+		constexpr std::chrono::milliseconds POLL_PERIOD{ 2 };
+
+		// Wheel ticks between beeps, rounded up like a timer checked once per poll
+		[[nodiscard]] std::uint64_t pollTicks(float interval) noexcept {
+			const float ticks = std::ceil(interval / std::chrono::duration<float>(POLL_PERIOD).count());
+			return std::max<std::uint64_t>(1U, static_cast<std::uint64_t>(ticks));
+		}
+
+		// Car frame (x forward, y to the right) to OpenAL's (x right, y up, -z forward)
+		sf::Vector3f toListenerSpace(const sf::Vector2f& carFrame) noexcept {
+			return { carFrame.y, 0.0F, -carFrame.x };
+		}
+
+		[[nodiscard]] bool audible(const BeepFrame& frame) noexcept {
+			if (frame.probe) {
+				return true;
+			}
+			for (std::uint32_t i = 0U; i < frame.count; ++i) {
+				if (frame.emitters[i].interval > 0.0F) {
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+	BeepScheduler::BeepScheduler(const sf::SoundBuffer* sample, prof::StartupReport* startup, prof::LatencyProbe* latency)
+		: m_thread([this, sample, startup, latency]() { run(sample, startup, latency); })
+	{
+	}
+
+	BeepScheduler::~BeepScheduler() {
+		m_stop.store(true, std::memory_order_relaxed);
+		m_thread.join();
+	}
+
+	bool BeepScheduler::submit(const BeepFrame& frame) noexcept {
+		return m_frames.tryPush(frame);
+	}
+
+	std::chrono::steady_clock::duration BeepScheduler::untilNextBeep() const noexcept {
+		const std::int64_t next = m_nextBeep.load(std::memory_order_relaxed);
+		if (next == std::numeric_limits<std::int64_t>::max()) {
+			return std::chrono::steady_clock::duration::max();
+		}
+		const std::chrono::steady_clock::time_point due{ std::chrono::steady_clock::duration(next) };
+		return std::max(due - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero());
+	}
+
+	void BeepScheduler::publishNextBeep(const std::optional<BeepSynth>& synth, std::chrono::steady_clock::time_point now) noexcept {
+		std::chrono::steady_clock::time_point next = std::chrono::steady_clock::time_point::max();
+		if (synth) {
+			const float interval = synth->interval();
+			if (interval > 0.0F) {
+				next = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(interval));
+			}
+		}
+		else {
+			for (std::uint32_t i = 0U; i < MAX_BEEP_EMITTERS; ++i) {
+				if (m_intervals[i] > 0.0F) {
+					next = std::min<std::chrono::steady_clock::time_point>(next, m_start + m_wheel.due(i) * POLL_PERIOD);
+				}
+			}
+		}
+		m_nextBeep.store((next == std::chrono::steady_clock::time_point::max()) ? std::numeric_limits<std::int64_t>::max()
+			: static_cast<std::int64_t>(next.time_since_epoch().count()), std::memory_order_relaxed);
+	}
+
+	void BeepScheduler::updateSynth(BeepSynth& synth, const BeepFrame& frame) {
+		// One stream: it beeps at the most urgent sensor's cadence, from that sensor
+		const BeepEmitter* urgent = nullptr;
+		for (std::uint32_t i = 0U; i < frame.count; ++i) {
+			const BeepEmitter& emitter = frame.emitters[i];
+			if (emitter.interval > 0.0F && (urgent == nullptr || emitter.interval < urgent->interval)) {
+				urgent = &emitter;
+			}
+		}
+
+		if (urgent == nullptr) {
+			synth.setInterval(0.0F);
+		}
+		else {
+			synth.setPosition(toListenerSpace(urgent->offset));
+			synth.setInterval(urgent->interval);
+		}
+		m_played.store(synth.beepsStarted(), std::memory_order_relaxed);
+
+		const float queued = synth.queuedSeconds();
+		if (queued >= 0.0F) {
+			m_counters.recordFill(queued * 1000.0F);
+		}
+	}
+
+	void BeepScheduler::updateSample(VoicePool& voices, const sf::SoundBuffer& sample, const BeepFrame& frame,
+		std::chrono::steady_clock::time_point now)
+	{
+		// A sensor whose interval changed is due again counted from its last beep
+		for (std::uint32_t i = 0U; i < MAX_BEEP_EMITTERS; ++i) {
+			const float interval = (i < frame.count) ? std::max(frame.emitters[i].interval, 0.0F) : 0.0F;
+			if (interval == m_intervals[i]) {
+				continue;
+			}
+			m_intervals[i] = interval;
+			if (interval > 0.0F) {
+				m_wheel.schedule(i, m_lastBeepTick[i] + pollTicks(interval));
+			}
+			else {
+				m_wheel.cancel(i);
+			}
+		}
+
+		const auto target = static_cast<std::uint64_t>((now - m_start) / POLL_PERIOD);
+		while (m_tick < target) {
+			++m_tick;
+			// Due at the start of the tick; late by however long this poll woke after it
+			const std::chrono::steady_clock::time_point due = m_start + m_tick * POLL_PERIOD;
+			m_wheel.advance(m_tick, [this, &voices, &sample, &frame, due, now](std::uint32_t i) {
+				const BeepEmitter& emitter = frame.emitters[i];
+				(void)voices.play(sample, emitter.distance, toListenerSpace(emitter.offset));
+				m_counters.recordBeep(std::chrono::duration<float, std::milli>(now - due).count());
+				m_played.fetch_add(1U, std::memory_order_relaxed);
+				m_lastBeepTick[i] = m_tick;
+				m_wheel.schedule(i, m_tick + pollTicks(m_intervals[i]));
+			});
+		}
+		m_counters.setVoices(voices.steals(), voices.drops(), static_cast<std::uint32_t>(voices.playing()),
+			static_cast<std::uint32_t>(voices.size()));
+	}
+
+	void BeepScheduler::playProbe(std::optional<BeepSynth>& synth, std::optional<VoicePool>& voices,
+		const sf::SoundBuffer* sample, const BeepFrame& frame, prof::LatencyProbe& latency)
+	{
+		if (!latency.stamp(prof::LatencyStage::Play)) {
+			return; // an older frame of a probe that already beeped
+		}
+		const sf::Vector2f offset = (frame.count > 0U) ? frame.emitters[0].offset : frame.listener;
+		if (synth) {
+			synth->setPosition(toListenerSpace(offset));
+			synth->beepNow(&latency);
+		}
+		else if (voices) {
+			(void)voices->play(*sample, 0.0F, toListenerSpace(offset));
+			m_played.fetch_add(1U, std::memory_order_relaxed);
+			(void)latency.stamp(prof::LatencyStage::Buffer);
+		}
+	}
+
+	void BeepScheduler::run(const sf::SoundBuffer* sample, prof::StartupReport* startup, prof::LatencyProbe* latency) {
+		prof::setThreadName("audio");
+		m_start = std::chrono::steady_clock::now();
+		m_wheel.reset(MAX_BEEP_EMITTERS);
+
+		// The sound objects are created and driven on this thread only, from the first beep on
+		std::optional<BeepSynth> synth;
+		std::optional<VoicePool> voices;
+		bool open = false;
+
+		BeepFrame frame;
+		while (!m_stop.load(std::memory_order_relaxed)) {
+			{
+				OKPP_TRACE_SCOPE("beep update");
+				const bool fresh = m_frames.popLatest(frame);
+
+				if (!open && audible(frame)) {
+					const auto openStart = prof::StartupReport::Clock::now();
+					if (sample != nullptr) {
+						voices.emplace(*sample);
+					}
+					else {
+						synth.emplace();
+						synth->setAttenuation(0.0F); // panned only, like the pool's voices
+						synth->play();
+					}
+					// Listener faces the car's forward direction with y up
+					sf::Listener::setDirection({ 0.0F, 0.0F, -1.0F });
+					sf::Listener::setUpVector({ 0.0F, 1.0F, 0.0F });
+					sf::Listener::setPosition(toListenerSpace(frame.listener));
+					open = true;
+					if (startup != nullptr) {
+						startup->record(prof::StartupPhase::AudioOpen, openStart);
+					}
+				}
+				else if (open && fresh) {
+					sf::Listener::setPosition(toListenerSpace(frame.listener));
+				}
+
+				if (fresh && frame.probe && latency != nullptr) {
+					playProbe(synth, voices, sample, frame, *latency);
+				}
+				const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+				if (synth) {
+					updateSynth(*synth, frame);
+				}
+				else if (voices) {
+					updateSample(*voices, *sample, frame, now);
+				}
+				publishNextBeep(synth, now);
+			}
+
+			std::this_thread::sleep_for(POLL_PERIOD);
+		}
+	}
+
+} // namespace audio
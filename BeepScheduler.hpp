@@ -0,0 +1,143 @@
+/*
+==============================================================================
+Beep Scheduler - dedicated audio thread that turns distances into beeps
+==============================================================================
+ - The render thread only pushes the current beep interval (from the
+   warning profile) into an SPSC ring; it never touches the sound objects
+ - The worker owns the synth or the sample and times beeps on its own
+   steady clock, so frame hitches cannot delay or bunch up warning tones
+ - Sample beeps go through a VoicePool, so a beep rings out instead of
+   being restarted by the next one
+ - Beeps are positional: the render thread hands over the batched sensor
+   results with each sensor's mount in the car frame, and the audio thread
+   places the sounds there and sf::Listener at the driver seat, so OpenAL
+   pans each corner to where it is on the car (mono sounds only)
+ - With the synth (one stream) the tone follows the most urgent sensor;
+   with the sample every sensor beeps on its own cadence, kept in a
+   BeepWheel of POLL_PERIOD ticks: a sensor is rescheduled only when its
+   interval changes, and each poll plays just the beeps that are due
+ - beepsPlayed() counts the beeps started so far, for telemetry
+ - untilNextBeep() tells any thread how soon the worker will next sound,
+   so a loop that sleeps while nothing changes can wake in step with it
+ - counters() tracks timing health (AudioCounters): each sample beep's
+   lateness against its wheel tick, voice steals and drops, and the
+   synth stream's buffer fill and underruns, polled every POLL_PERIOD
+ - A frame marked as a latency probe's (LatencyProbe) plays one beep at
+   once from the first emitter, stamping the probe's Play stage at the
+   call and its Buffer stage when the samples are handed over: the
+   synth's next chunk, or the sample voice's play() returning, since
+   OpenAL takes a static buffer whole
+ - The audio device opens with the first sound object, so none is created
+   until a frame first asks for a beep; a silent drive never opens it
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Audio.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+
+#include "AudioCounters.hpp"
+#include "BeepSynth.hpp"
+#include "BeepWheel.hpp"
+#include "LatencyProbe.hpp"
+#include "SpscRing.hpp"
+#include "StartupReport.hpp"
+#include "VoicePool.hpp"
+
+namespace audio {
+
+	constexpr std::size_t MAX_BEEP_EMITTERS = 8U;
+
+	// One sensor's beep; offset is its mount in the car frame (x forward, y to the right)
+	struct BeepEmitter {
+		sf::Vector2f offset{ 0.0F, 0.0F };
+		float interval = 0.0F; // seconds between beeps, 0 = silent
+		float distance = 0.0F; // to the nearest obstacle, ranks the beep's voice
+	};
+
+	struct BeepFrame {
+		std::array<BeepEmitter, MAX_BEEP_EMITTERS> emitters{};
+		std::uint32_t count = 0U;
+		sf::Vector2f listener{ 0.0F, 0.0F }; // driver seat in the car frame
+		bool probe = false; // the frame a latency probe's key press reached: beep at once
+	};
+
+	class BeepScheduler {
+	public:
+		/**
+		 * @brief Starts the audio thread; the audio device is opened at the first beep.
+		 *
+		 * A null sample selects the procedural synth; otherwise the buffer is
+		 * replayed at the current interval (it must outlive the scheduler).
+		 * The device open is recorded in startup if given, probe beeps in latency
+		 * (both must outlive the scheduler too).
+		 */
+		explicit BeepScheduler(const sf::SoundBuffer* sample = nullptr, prof::StartupReport* startup = nullptr,
+			prof::LatencyProbe* latency = nullptr);
+		~BeepScheduler();
+
+		BeepScheduler(const BeepScheduler&) = delete;
+		BeepScheduler& operator=(const BeepScheduler&) = delete;
+
+		/**
+		 * @brief Render-thread side: publishes the latest per-sensor beeps.
+		 *
+		 * Never blocks; if the audio thread falls behind, the frame is dropped
+		 * (returns false) and the next one supersedes it.
+		 */
+		bool submit(const BeepFrame& frame) noexcept;
+
+		/**
+		 * @brief Beeps started so far, from any thread.
+		 */
+		[[nodiscard]] std::uint64_t beepsPlayed() const noexcept { return m_played.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Time until the next beep is due, from any thread; duration::max() while silent.
+		 *
+		 * Sample beeps are due at a wheel tick. The synth keeps its own
+		 * cadence, so for it this is an upper bound: one interval.
+		 */
+		[[nodiscard]] std::chrono::steady_clock::duration untilNextBeep() const noexcept;
+
+		/**
+		 * @brief Beep lateness, buffer fill and voice counters; readable from any thread.
+		 */
+		[[nodiscard]] const prof::AudioCounters& counters() const noexcept { return m_counters; }
+
+	private:
+		void run(const sf::SoundBuffer* sample, prof::StartupReport* startup, prof::LatencyProbe* latency);
+		void playProbe(std::optional<BeepSynth>& synth, std::optional<VoicePool>& voices, const sf::SoundBuffer* sample,
+			const BeepFrame& frame, prof::LatencyProbe& latency);
+		void updateSynth(BeepSynth& synth, const BeepFrame& frame);
+		void updateSample(VoicePool& voices, const sf::SoundBuffer& sample, const BeepFrame& frame,
+			std::chrono::steady_clock::time_point now);
+		void publishNextBeep(const std::optional<BeepSynth>& synth, std::chrono::steady_clock::time_point now) noexcept;
+
+		sim::SpscRing<BeepFrame, 64U> m_frames;
+		std::atomic<bool> m_stop{ false };
+		std::atomic<std::uint64_t> m_played{ 0U };
+		// steady_clock ticks since its epoch of the next due beep; max while silent
+		std::atomic<std::int64_t> m_nextBeep{ std::numeric_limits<std::int64_t>::max() };
+		prof::AudioCounters m_counters;
+
+		// Audio-thread state; the sample path's wheel ticks once per poll period since m_start
+		std::chrono::steady_clock::time_point m_start;
+		sim::BeepWheel m_wheel;
+		std::uint64_t m_tick = 0U;
+		std::array<float, MAX_BEEP_EMITTERS> m_intervals{}; // as scheduled, 0 = silent
+		std::array<std::uint64_t, MAX_BEEP_EMITTERS> m_lastBeepTick{};
+
+		std::thread m_thread;
+	};
+
+} // namespace audio
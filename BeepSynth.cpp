@@ -0,0 +1,115 @@
+#include "BeepSynth.hpp"
+
+#include <algorithm>
+
+namespace audio {
+
+	namespace {
+		// ~11.6 ms at 44.1 kHz: short enough for tight cadence, long enough to avoid underruns
+		constexpr std::size_t CHUNK_SAMPLES = 512U;
+
+		constexpr float FULL_SCALE = 32767.0F;
+
+		[[nodiscard]] std::uint32_t toSamples(float seconds, unsigned int sampleRate) {
+			return static_cast<std::uint32_t>(std::max(seconds, 0.0F) * static_cast<float>(sampleRate));
+		}
+	}
+
+	BeepSynth::BeepSynth(const BeepTone& tone, unsigned int sampleRate)
+		: m_tone(tone)
+		, m_sampleRate(sampleRate)
+		, m_beepSamples(toSamples(tone.lengthSeconds, sampleRate))
+		, m_attackSamples(std::max<std::uint32_t>(1U, toSamples(tone.attackSeconds, sampleRate)))
+		, m_releaseSamples(std::max<std::uint32_t>(1U, toSamples(tone.releaseSeconds, sampleRate)))
+		, m_buffer(CHUNK_SAMPLES)
+	{
+		// Start "long after" the last beep so the first interval fires immediately
+		m_sinceBeepStart = UINT64_MAX / 2U;
+		initialize(1U, sampleRate, { sf::SoundChannel::Mono });
+	}
+
+	void BeepSynth::setInterval(float seconds) noexcept {
+		m_interval.store(seconds, std::memory_order_relaxed);
+	}
+
+	float BeepSynth::interval() const noexcept {
+		return m_interval.load(std::memory_order_relaxed);
+	}
+
+	void BeepSynth::beepNow(prof::LatencyProbe* latency) noexcept {
+		m_latency.store(latency, std::memory_order_relaxed);
+		m_beepNow.store(true, std::memory_order_release);
+	}
+
+	float BeepSynth::queuedSeconds() const {
+		const std::uint64_t generated = m_generated.load(std::memory_order_acquire);
+		if (generated == 0U) {
+			return -1.0F;
+		}
+		return static_cast<float>(generated) / static_cast<float>(m_sampleRate) - getPlayingOffset().asSeconds();
+	}
+
+	float BeepSynth::envelope(std::uint32_t sampleInBeep) const noexcept {
+		if (sampleInBeep < m_attackSamples) {
+			return static_cast<float>(sampleInBeep) / static_cast<float>(m_attackSamples);
+		}
+		const std::uint32_t remaining = m_beepSamples - sampleInBeep;
+		if (remaining < m_releaseSamples) {
+			return static_cast<float>(remaining) / static_cast<float>(m_releaseSamples);
+		}
+		return 1.0F;
+	}
+
+	bool BeepSynth::onGetData(Chunk& data) {
+		const float intervalSeconds = interval();
+		const std::uint64_t intervalSamples = (intervalSeconds > 0.0F)
+			? std::max<std::uint64_t>(1U, toSamples(intervalSeconds, m_sampleRate))
+			: 0U;
+		const float phaseStep = m_tone.frequencyHz / static_cast<float>(m_sampleRate);
+		const float level = m_tone.amplitude * FULL_SCALE;
+
+		const bool forced = m_beepNow.exchange(false, std::memory_order_acquire);
+		if (forced) {
+			m_sinceBeepStart = 0U;
+			m_phase = 0.0F;
+			m_started.fetch_add(1U, std::memory_order_relaxed);
+		}
+
+		for (auto& sample : m_buffer) {
+			if (intervalSamples != 0U && m_sinceBeepStart >= intervalSamples) {
+				m_sinceBeepStart = 0U;
+				m_phase = 0.0F;
+				m_started.fetch_add(1U, std::memory_order_relaxed);
+			}
+
+			float value = 0.0F;
+			if (m_sinceBeepStart < m_beepSamples) {
+				const float square = (m_phase < m_tone.duty) ? 1.0F : -1.0F;
+				value = square * envelope(static_cast<std::uint32_t>(m_sinceBeepStart)) * level;
+				m_phase += phaseStep;
+				m_phase -= static_cast<float>(static_cast<int>(m_phase));
+			}
+
+			sample = static_cast<std::int16_t>(value);
+			++m_sinceBeepStart;
+		}
+
+		data.samples = m_buffer.data();
+		data.sampleCount = m_buffer.size();
+		m_generated.fetch_add(m_buffer.size(), std::memory_order_release);
+		prof::LatencyProbe* const latency = forced ? m_latency.load(std::memory_order_relaxed) : nullptr;
+		if (latency != nullptr) {
+			(void)latency->stamp(prof::LatencyStage::Buffer); // queued behind the stream's earlier buffers
+		}
+		return true; // endless stream
+	}
+
+	void BeepSynth::onSeek(sf::Time timeOffset) {
+		m_sinceBeepStart = UINT64_MAX / 2U;
+		m_phase = 0.0F;
+		// The playing offset restarts here, so the fill counts from it
+		m_generated.store(static_cast<std::uint64_t>(std::max(timeOffset.asSeconds(), 0.0F) * static_cast<float>(m_sampleRate)),
+			std::memory_order_release);
+	}
+
+} // namespace audio
@@ -0,0 +1,91 @@
+/*
+==============================================================================
+Beep Synth - procedural parking beep generated inside an sf::SoundStream
+==============================================================================
+ - The tone (frequency, duty cycle, attack/release envelope) is synthesized
+   directly into the stream buffers, so no MP3 is decoded at startup
+ - Beep starts are scheduled per sample from the current interval, so the
+   cadence does not depend on frame timing
+ - setInterval() may be called from any thread; the audio thread picks the
+   new value up at the next sample
+ - queuedSeconds() is how far the samples handed to the device run ahead
+   of what it has played: the stream's buffer fill
+ - beepNow() starts a beep at the next chunk whatever the interval; with a
+   LatencyProbe the chunk carrying it stamps the probe's Buffer stage
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Audio.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "LatencyProbe.hpp"
+
+namespace audio {
+
+	struct BeepTone {
+		float frequencyHz = 1800.0F;
+		float duty = 0.5F;          // fraction of each period spent high
+		float lengthSeconds = 0.07F;
+		float attackSeconds = 0.004F;
+		float releaseSeconds = 0.012F;
+		float amplitude = 0.35F;    // 0..1 of full scale
+	};
+
+	class BeepSynth : public sf::SoundStream {
+	public:
+		explicit BeepSynth(const BeepTone& tone = BeepTone{}, unsigned int sampleRate = 44100U);
+
+		/**
+		 * @brief Seconds between beep starts; 0 or less silences the synth.
+		 */
+		void setInterval(float seconds) noexcept;
+
+		[[nodiscard]] float interval() const noexcept;
+
+		/**
+		 * @brief Starts a beep at the start of the next chunk; may be called from any thread.
+		 *
+		 * latency, if given, is stamped when that chunk is handed to the device.
+		 */
+		void beepNow(prof::LatencyProbe* latency = nullptr) noexcept;
+
+		/**
+		 * @brief Beeps started so far; may be read from any thread.
+		 */
+		[[nodiscard]] std::uint64_t beepsStarted() const noexcept { return m_started.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Seconds of audio handed to the device but not played yet; negative before the first chunk.
+		 */
+		[[nodiscard]] float queuedSeconds() const;
+
+	private:
+		[[nodiscard]] bool onGetData(Chunk& data) override;
+		void onSeek(sf::Time timeOffset) override;
+
+		[[nodiscard]] float envelope(std::uint32_t sampleInBeep) const noexcept;
+
+		BeepTone m_tone;
+		unsigned int m_sampleRate;
+		std::uint32_t m_beepSamples;
+		std::uint32_t m_attackSamples;
+		std::uint32_t m_releaseSamples;
+
+		std::atomic<float> m_interval{ 0.0F };
+		std::atomic<std::uint64_t> m_started{ 0U };
+		std::atomic<std::uint64_t> m_generated{ 0U }; // samples handed to the device
+		std::atomic<bool> m_beepNow{ false };
+		std::atomic<prof::LatencyProbe*> m_latency{ nullptr };
+
+		// Audio-thread state
+		std::vector<std::int16_t> m_buffer;
+		std::uint64_t m_sinceBeepStart = 0U;
+		float m_phase = 0.0F; // 0..1 within one tone period
+	};
+
+} // namespace audio
@@ -0,0 +1,25 @@
+#include "BeepWheel.hpp"
+
+#include <algorithm>
+
+namespace sim {
+
+	void BeepWheel::reset(std::size_t count, std::uint64_t tick) {
+		for (std::vector<Entry>& slot : m_slots) {
+			slot.clear();
+		}
+		m_due.assign(count, NOT_SCHEDULED);
+		m_tick = tick;
+	}
+
+	void BeepWheel::schedule(std::uint32_t beeper, std::uint64_t dueTick) {
+		if (m_due[beeper] == dueTick) {
+			return; // already in its slot
+		}
+		m_due[beeper] = dueTick;
+		// Overdue beeps go in the next tick's slot; the entry keeps its due tick
+		const std::uint64_t slotTick = std::max(dueTick, m_tick + 1U);
+		m_slots[slotTick & (SLOTS - 1U)].push_back({ dueTick, beeper });
+	}
+
+} // namespace sim
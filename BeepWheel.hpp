@@ -0,0 +1,100 @@
+/*
+==============================================================================
+Beep Wheel - timer wheel that fires only the beeps that are due
+==============================================================================
+ - Each beeper (a fleet car, a sensor's voice) is scheduled at the tick its
+   next beep is due; advance() visits one slot per tick and fires what is
+   due there, so a tick costs the beeps it fires rather than a clock
+   comparison per beeper
+ - SLOTS ticks per revolution; an entry further out than that stays in its
+   slot and is skipped until its revolution comes round
+ - Rescheduling or cancelling is O(1): the beeper's due tick is the truth,
+   and an entry that no longer matches it is dropped when its slot is next
+   visited
+ - Slot storage keeps its capacity, so a steady schedule allocates nothing
+ - Not thread-safe: parallel users keep one wheel per range of beepers
+ - No SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sim {
+
+	class BeepWheel {
+	public:
+		// Power of two; covers a 0.5 s interval at 240 Hz in one revolution
+		static constexpr std::size_t SLOTS = 256U;
+		static constexpr std::uint64_t NOT_SCHEDULED = std::numeric_limits<std::uint64_t>::max();
+
+		/**
+		 * @brief Resizes to beepers [0, count), all unscheduled; the first
+		 *        advance() will be tick + 1.
+		 */
+		void reset(std::size_t count, std::uint64_t tick = 0U);
+
+		/**
+		 * @brief Fires beeper at dueTick, replacing any earlier schedule.
+		 *
+		 * A dueTick already passed fires at the next advance().
+		 */
+		void schedule(std::uint32_t beeper, std::uint64_t dueTick);
+
+		/**
+		 * @brief Drops beeper's schedule, if any.
+		 */
+		void cancel(std::uint32_t beeper) noexcept { m_due[beeper] = NOT_SCHEDULED; }
+
+		/**
+		 * @brief The tick beeper is due at, or NOT_SCHEDULED.
+		 */
+		[[nodiscard]] std::uint64_t due(std::uint32_t beeper) const noexcept { return m_due[beeper]; }
+
+		/**
+		 * @brief Runs tick: calls fire(beeper) once per beeper due at or before it.
+		 *
+		 * Ticks must be advanced one by one, in order. A fired beeper is
+		 * unscheduled before fire() runs, which may schedule it again.
+		 */
+		template <typename Fire>
+		void advance(std::uint64_t tick, Fire&& fire) {
+			m_tick = tick;
+			std::vector<Entry>& slot = m_slots[tick & (SLOTS - 1U)];
+			if (slot.empty()) {
+				return;
+			}
+			// fire() may schedule into this same slot, so walk a swapped-out copy
+			m_visiting.swap(slot);
+			for (const Entry& entry : m_visiting) {
+				if (m_due[entry.beeper] != entry.due) {
+					continue; // rescheduled or cancelled since
+				}
+				if (entry.due > tick) {
+					slot.push_back(entry); // a later revolution
+					continue;
+				}
+				m_due[entry.beeper] = NOT_SCHEDULED;
+				fire(entry.beeper);
+			}
+			m_visiting.clear();
+		}
+
+	private:
+		struct Entry {
+			std::uint64_t due;
+			std::uint32_t beeper;
+		};
+
+		std::array<std::vector<Entry>, SLOTS> m_slots;
+		std::vector<Entry> m_visiting;
+		std::vector<std::uint64_t> m_due; // per beeper
+		std::uint64_t m_tick = 0U;        // last tick advanced to
+	};
+
+} // namespace sim
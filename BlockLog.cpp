@@ -0,0 +1,403 @@
+#include "BlockLog.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include "AssetPack.hpp"
+
+namespace io {
+
+	namespace {
+		constexpr char BLOCK_LOG_MAGIC[8] = { 'O', 'K', 'B', 'L', 'K', '0', '0', '1' };
+		constexpr char BLOCK_INDEX_MAGIC[8] = { 'O', 'K', 'B', 'L', 'K', 'I', 'D', 'X' };
+
+		struct BlockLogHeader {
+			char magic[8];
+			std::uint32_t kind;
+			std::uint16_t fields;
+			std::uint16_t reserved;
+			std::uint32_t tag;
+			std::uint32_t reserved2;
+		};
+
+		struct BlockHeader {
+			std::uint32_t records;
+			std::uint32_t rawBytes;
+			std::uint32_t storedBytes;
+			std::uint32_t flags;
+		};
+
+		struct BlockLogFooter {
+			std::uint64_t records;
+			std::uint64_t indexOffset;
+			std::uint32_t blocks;
+			std::uint32_t reserved;
+			char magic[8];
+		};
+
+		static_assert(sizeof(BlockLogHeader) == 24U, "the header is written raw and must have no padding");
+		static_assert(sizeof(BlockHeader) == 16U, "block headers are written raw and must have no padding");
+		static_assert(sizeof(BlockLogFooter) == 32U, "the footer is written raw and must have no padding");
+
+		constexpr std::uint32_t BLOCK_LZ4 = 1U;
+		constexpr std::size_t INDEX_ENTRY_BYTES = 2U * sizeof(std::uint64_t);
+		constexpr std::size_t MAX_VARINT_BYTES = 5U;
+		constexpr std::uint16_t MAX_FIELDS = 256U;
+		constexpr std::uint32_t MAX_RECORDS_PER_BLOCK = 1U << 20U;
+
+		[[nodiscard]] std::uint32_t blockZigzag(std::uint32_t delta) noexcept {
+			const auto value = static_cast<std::int32_t>(delta);
+			return (delta << 1U) ^ static_cast<std::uint32_t>(value >> 31);
+		}
+
+		[[nodiscard]] std::uint32_t blockUnzigzag(std::uint32_t value) noexcept {
+			return (value >> 1U) ^ (0U - (value & 1U));
+		}
+
+		[[nodiscard]] unsigned char* putBlockVarint(unsigned char* out, std::uint32_t value) noexcept {
+			while (value >= 0x80U) {
+				*out++ = static_cast<unsigned char>((value & 0x7FU) | 0x80U);
+				value >>= 7U;
+			}
+			*out++ = static_cast<unsigned char>(value);
+			return out;
+		}
+
+		[[nodiscard]] bool getBlockVarint(const unsigned char*& in, const unsigned char* end, std::uint32_t& value) noexcept {
+			value = 0U;
+			for (unsigned shift = 0U; shift < 35U; shift += 7U) {
+				if (in == end) {
+					return false;
+				}
+				const unsigned char byte = *in++;
+				value |= static_cast<std::uint32_t>(byte & 0x7FU) << shift;
+				if ((byte & 0x80U) == 0U) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		[[nodiscard]] std::uint64_t fileSizeOf(std::ifstream& file) {
+			file.seekg(0, std::ios::end);
+			const std::streamoff size = file.tellg();
+			return (size > 0) ? static_cast<std::uint64_t>(size) : 0U;
+		}
+	}
+
+	// ---- Writer ----
+
+	BlockLogWriter::~BlockLogWriter() {
+		(void)close();
+	}
+
+	bool BlockLogWriter::open(const std::string& path, std::uint32_t kind, std::uint16_t fields, std::uint32_t tag,
+		std::uint32_t recordsPerBlock)
+	{
+		(void)close();
+		if (fields == 0U || fields > MAX_FIELDS || recordsPerBlock == 0U || recordsPerBlock > MAX_RECORDS_PER_BLOCK) {
+			std::cerr << "Error: bad block log layout for " << path << '\n';
+			return false;
+		}
+		m_file.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_file) {
+			std::cerr << "Error: Failed to create block log " << path << '\n';
+			return false;
+		}
+
+		BlockLogHeader header{};
+		std::memcpy(header.magic, BLOCK_LOG_MAGIC, sizeof(header.magic));
+		header.kind = kind;
+		header.fields = fields;
+		header.tag = tag;
+		m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		m_path = path;
+		m_fields = fields;
+		m_recordsPerBlock = recordsPerBlock;
+		m_pendingRecords = 0U;
+		m_offset = sizeof(header);
+		m_failed = !m_file;
+		m_stats = {};
+
+		// Every buffer at its largest now, so append() never allocates
+		const std::size_t words = static_cast<std::size_t>(recordsPerBlock) * fields;
+		m_pending.assign(words, 0U);
+		m_encoded.assign(words * MAX_VARINT_BYTES, 0U);
+		m_compressed.reserve(m_encoded.size() + m_encoded.size() / 255U + 16U);
+		assets::lz4Compress(nullptr, 0U, m_compressed, m_lz4Table); // sizes the match table
+		m_index.clear();
+		m_index.reserve(1024U);
+		return !m_failed;
+	}
+
+	void BlockLogWriter::append(const std::uint32_t* record) noexcept {
+		if (!m_file.is_open()) {
+			return;
+		}
+		std::memcpy(m_pending.data() + static_cast<std::size_t>(m_pendingRecords) * m_fields, record,
+			m_fields * sizeof(std::uint32_t));
+		++m_pendingRecords;
+		++m_stats.records;
+		if (m_pendingRecords == m_recordsPerBlock) {
+			writeBlock();
+		}
+	}
+
+	void BlockLogWriter::writeBlock() noexcept {
+		const std::uint32_t records = m_pendingRecords;
+		m_pendingRecords = 0U;
+		if (m_failed) {
+			m_stats.records -= records;
+			return;
+		}
+		if (records == 0U) {
+			return;
+		}
+
+		// Column by column: runs of one field sit together, which is what LZ4 then finds
+		unsigned char* out = m_encoded.data();
+		for (std::size_t field = 0U; field < m_fields; ++field) {
+			std::uint32_t previous = 0U;
+			for (std::size_t record = 0U; record < records; ++record) {
+				const std::uint32_t value = m_pending[record * m_fields + field];
+				out = putBlockVarint(out, blockZigzag(value - previous));
+				previous = value;
+			}
+		}
+		const auto rawBytes = static_cast<std::size_t>(out - m_encoded.data());
+
+		BlockHeader header{};
+		header.records = records;
+		header.rawBytes = static_cast<std::uint32_t>(rawBytes);
+		header.storedBytes = header.rawBytes;
+		const unsigned char* stored = m_encoded.data();
+		try {
+			assets::lz4Compress(m_encoded.data(), rawBytes, m_compressed, m_lz4Table);
+			if (m_compressed.size() + rawBytes / 8U <= rawBytes) {
+				header.flags = BLOCK_LZ4;
+				header.storedBytes = static_cast<std::uint32_t>(m_compressed.size());
+				stored = m_compressed.data();
+			}
+			if (m_index.size() == m_index.capacity()) {
+				m_index.reserve(m_index.capacity() * 2U); // once per thousand blocks
+			}
+			m_index.push_back({ m_offset, m_stats.records - records });
+		}
+		catch (const std::bad_alloc&) {
+			m_failed = true;
+		}
+
+		if (!m_failed) {
+			m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			m_file.write(reinterpret_cast<const char*>(stored), static_cast<std::streamsize>(header.storedBytes));
+			m_failed = !m_file;
+		}
+		if (m_failed) {
+			std::cerr << "Error: Failed to write block log " << m_path << ", later records are dropped\n";
+			m_stats.records -= records;
+			return;
+		}
+		m_offset += sizeof(header) + header.storedBytes;
+		m_stats.rawBytes += static_cast<std::uint64_t>(records) * m_fields * sizeof(std::uint32_t);
+		++m_stats.blocks;
+	}
+
+	bool BlockLogWriter::close() {
+		if (!m_file.is_open()) {
+			return false;
+		}
+		writeBlock();
+
+		const std::uint64_t indexOffset = m_offset;
+		for (const IndexEntry& entry : m_index) {
+			m_file.write(reinterpret_cast<const char*>(&entry.offset), sizeof(entry.offset));
+			m_file.write(reinterpret_cast<const char*>(&entry.firstRecord), sizeof(entry.firstRecord));
+		}
+		BlockLogFooter footer{};
+		footer.records = m_stats.records;
+		footer.indexOffset = indexOffset;
+		footer.blocks = static_cast<std::uint32_t>(m_index.size());
+		std::memcpy(footer.magic, BLOCK_INDEX_MAGIC, sizeof(footer.magic));
+		m_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+		m_stats.storedBytes = m_offset + m_index.size() * INDEX_ENTRY_BYTES + sizeof(footer);
+
+		const bool ok = !m_failed && static_cast<bool>(m_file);
+		m_file.close();
+		if (!ok && !m_failed) {
+			std::cerr << "Error: Failed to write block log " << m_path << '\n';
+		}
+		return ok;
+	}
+
+	// ---- Reader ----
+
+	bool BlockLogReader::open(const std::string& path, std::uint32_t kind) {
+		m_file.close();
+		m_file.clear();
+		m_path = path;
+		m_index.clear();
+		m_records = 0U;
+		m_cachedBlock = SIZE_MAX;
+		m_file.open(path, std::ios::binary);
+		if (!m_file) {
+			std::cerr << "Error: Failed to open block log " << path << '\n';
+			return false;
+		}
+
+		BlockLogHeader header{};
+		m_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!m_file || std::memcmp(header.magic, BLOCK_LOG_MAGIC, sizeof(header.magic)) != 0 || header.kind != kind
+			|| header.fields == 0U || header.fields > MAX_FIELDS) {
+			std::cerr << "Error: " << path << " is not a block log of this kind\n";
+			return false;
+		}
+		m_fields = header.fields;
+		m_tag = header.tag;
+
+		const std::uint64_t fileSize = fileSizeOf(m_file);
+		if (!readIndex(fileSize)) {
+			walkBlocks(fileSize);
+			std::cerr << "Warning: block log " << path << " has no index (its writer did not finish), recovered "
+				<< m_records << " records\n";
+		}
+		m_file.clear();
+		return true;
+	}
+
+	bool BlockLogReader::readIndex(std::uint64_t fileSize) {
+		if (fileSize < sizeof(BlockLogHeader) + sizeof(BlockLogFooter)) {
+			return false;
+		}
+		BlockLogFooter footer{};
+		m_file.seekg(static_cast<std::streamoff>(fileSize - sizeof(footer)));
+		m_file.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+		const std::uint64_t indexBytes = static_cast<std::uint64_t>(footer.blocks) * INDEX_ENTRY_BYTES;
+		if (!m_file || std::memcmp(footer.magic, BLOCK_INDEX_MAGIC, sizeof(footer.magic)) != 0
+			|| footer.indexOffset < sizeof(BlockLogHeader) || footer.indexOffset + indexBytes + sizeof(footer) != fileSize) {
+			m_file.clear();
+			return false;
+		}
+
+		m_file.seekg(static_cast<std::streamoff>(footer.indexOffset));
+		m_index.resize(footer.blocks);
+		for (std::size_t i = 0U; i < m_index.size(); ++i) {
+			Block& block = m_index[i];
+			m_file.read(reinterpret_cast<char*>(&block.offset), sizeof(block.offset));
+			m_file.read(reinterpret_cast<char*>(&block.firstRecord), sizeof(block.firstRecord));
+			// Blocks follow each other from record 0: anything else is a corrupt index
+			const bool ordered = (i == 0U) ? block.firstRecord == 0U
+				: block.firstRecord > m_index[i - 1U].firstRecord && block.offset > m_index[i - 1U].offset;
+			if (!ordered || block.offset < sizeof(BlockLogHeader) || block.offset >= footer.indexOffset) {
+				m_file.clear();
+				m_index.clear();
+				return false;
+			}
+		}
+		const bool counted = m_index.empty() ? footer.records == 0U : footer.records > m_index.back().firstRecord;
+		if (!m_file || !counted) {
+			m_file.clear();
+			m_index.clear();
+			return false;
+		}
+		m_records = footer.records;
+		return true;
+	}
+
+	void BlockLogReader::walkBlocks(std::uint64_t fileSize) {
+		m_file.clear();
+		m_index.clear();
+		std::uint64_t offset = sizeof(BlockLogHeader);
+		std::uint64_t records = 0U;
+		while (offset + sizeof(BlockHeader) <= fileSize) {
+			BlockHeader header{};
+			m_file.seekg(static_cast<std::streamoff>(offset));
+			m_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+			const std::uint64_t end = offset + sizeof(header) + header.storedBytes;
+			if (!m_file || header.records == 0U || header.records > MAX_RECORDS_PER_BLOCK || end > fileSize) {
+				break; // the block the writer was in the middle of
+			}
+			m_index.push_back({ offset, records });
+			records += header.records;
+			offset = end;
+		}
+		m_records = records;
+	}
+
+	bool BlockLogReader::loadBlock(std::size_t block) {
+		BlockHeader header{};
+		m_file.clear();
+		m_file.seekg(static_cast<std::streamoff>(m_index[block].offset));
+		m_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		const std::uint64_t nextFirst = (block + 1U < m_index.size()) ? m_index[block + 1U].firstRecord : m_records;
+		if (!m_file || header.records == 0U || header.records > MAX_RECORDS_PER_BLOCK
+			|| m_index[block].firstRecord + header.records != nextFirst
+			|| header.rawBytes > static_cast<std::uint64_t>(header.records) * m_fields * MAX_VARINT_BYTES) {
+			return false;
+		}
+
+		m_stored.resize(header.storedBytes);
+		m_file.read(reinterpret_cast<char*>(m_stored.data()), static_cast<std::streamsize>(m_stored.size()));
+		if (!m_file) {
+			return false;
+		}
+		const unsigned char* encoded = m_stored.data();
+		if ((header.flags & BLOCK_LZ4) != 0U) {
+			m_encoded.resize(header.rawBytes);
+			if (!assets::lz4Decompress(m_stored.data(), m_stored.size(), m_encoded.data(), m_encoded.size())) {
+				return false;
+			}
+			encoded = m_encoded.data();
+		}
+		else if (header.storedBytes != header.rawBytes) {
+			return false;
+		}
+
+		const unsigned char* in = encoded;
+		const unsigned char* const end = encoded + header.rawBytes;
+		m_decoded.resize(static_cast<std::size_t>(header.records) * m_fields);
+		for (std::size_t field = 0U; field < m_fields; ++field) {
+			std::uint32_t value = 0U;
+			for (std::size_t record = 0U; record < header.records; ++record) {
+				std::uint32_t delta = 0U;
+				if (!getBlockVarint(in, end, delta)) {
+					return false;
+				}
+				value += blockUnzigzag(delta);
+				m_decoded[record * m_fields + field] = value;
+			}
+		}
+		if (in != end) {
+			return false;
+		}
+
+		m_cachedBlock = block;
+		m_cachedFirst = m_index[block].firstRecord;
+		m_cachedRecords = header.records;
+		return true;
+	}
+
+	bool BlockLogReader::read(std::uint64_t index, std::uint32_t* out) {
+		if (index >= m_records) {
+			std::cerr << "Error: record " << index << " is past the end of block log " << m_path << '\n';
+			return false;
+		}
+		if (m_cachedBlock == SIZE_MAX || index < m_cachedFirst || index - m_cachedFirst >= m_cachedRecords) {
+			// Last block starting at or before index
+			const auto after = std::upper_bound(m_index.begin(), m_index.end(), index,
+				[](std::uint64_t record, const Block& block) { return record < block.firstRecord; });
+			const auto block = static_cast<std::size_t>(after - m_index.begin()) - 1U;
+			if (!loadBlock(block)) {
+				m_cachedBlock = SIZE_MAX;
+				std::cerr << "Error: corrupt block " << block << " in block log " << m_path << '\n';
+				return false;
+			}
+		}
+		std::memcpy(out, m_decoded.data() + static_cast<std::size_t>(index - m_cachedFirst) * m_fields,
+			m_fields * sizeof(std::uint32_t));
+		return true;
+	}
+
+} // namespace io
@@ -0,0 +1,159 @@
+/*
+==============================================================================
+Block Log - block-compressed, seekable container of fixed-width records
+==============================================================================
+ - The storage behind --record drives and --telemetry-log records: every
+   record is the same number of 32-bit fields (floats by their bit
+   pattern), so the container stays lossless and knows nothing of what it
+   stores
+ - Records are buffered into blocks of recordsPerBlock. A full block is
+   encoded column by column, each field as zigzag varints of its delta from
+   the record before; a frame time that repeats or a tick that counts up
+   costs one byte. The encoded block is stored as one LZ4 block (the
+   AssetPack codec) when that saves at least an eighth of it
+ - Writes stream: a block goes to the file as soon as it is full, and the
+   writer's buffers are sized once in open(), so appending never touches
+   the heap. Every block restarts its deltas from zero, so any block
+   decodes on its own
+ - close() writes a seek index (offset and first record of every block)
+   and a footer pointing at it. A reader maps a record to its block through
+   the index and decodes only that block; reads inside the cached block
+   cost a copy. A file whose writer died has no footer; the reader then
+   walks the block headers instead and keeps every complete block
+ - File format (little-endian):
+   header:  "OKBLK001" | kind u32 | fields u16 | reserved u16 | tag u32 | reserved u32
+   block:   records u32 | raw bytes u32 | stored bytes u32 | flags u32 | stored bytes
+   index:   per block: offset u64 | first record u64
+   footer:  records u64 | index offset u64 | blocks u32 | reserved u32 | "OKBLKIDX"
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace io {
+
+	// What a block log holds; a reader refuses a file of another kind
+	constexpr std::uint32_t BLOCK_LOG_DRIVE = 1U;     // InputRecording frames
+	constexpr std::uint32_t BLOCK_LOG_TELEMETRY = 2U; // TelemetryRecord fields
+
+	constexpr std::uint32_t DEFAULT_RECORDS_PER_BLOCK = 4096U;
+
+	struct BlockLogStats {
+		std::uint64_t records = 0U;
+		std::uint64_t blocks = 0U;
+		std::uint64_t rawBytes = 0U;    // records as fields, before encoding
+		std::uint64_t storedBytes = 0U; // in the file, headers, index and footer included
+	};
+
+	class BlockLogWriter {
+	public:
+		BlockLogWriter() = default;
+		~BlockLogWriter();
+
+		BlockLogWriter(const BlockLogWriter&) = delete;
+		BlockLogWriter& operator=(const BlockLogWriter&) = delete;
+
+		/**
+		 * @brief Creates the file and sizes every buffer; false (logged) if it cannot be written.
+		 *
+		 * tag is one word of the caller's own, returned by BlockLogReader::tag()
+		 * (a drive stores its tick rate there).
+		 */
+		[[nodiscard]] bool open(const std::string& path, std::uint32_t kind, std::uint16_t fields, std::uint32_t tag = 0U,
+			std::uint32_t recordsPerBlock = DEFAULT_RECORDS_PER_BLOCK);
+
+		/**
+		 * @brief Appends one record of fields() words; writes the block when it fills.
+		 *
+		 * MISRA: no allocation. After a write error the records are dropped (logged once).
+		 */
+		void append(const std::uint32_t* record) noexcept;
+
+		/**
+		 * @brief Writes the partial block, the index and the footer; false on I/O failure.
+		 *
+		 * Safe to call twice, and when open() failed.
+		 */
+		bool close();
+
+		[[nodiscard]] bool isOpen() const noexcept { return m_file.is_open(); }
+		[[nodiscard]] std::uint16_t fields() const noexcept { return m_fields; }
+		[[nodiscard]] const BlockLogStats& stats() const noexcept { return m_stats; }
+
+	private:
+		struct IndexEntry {
+			std::uint64_t offset;
+			std::uint64_t firstRecord;
+		};
+
+		void writeBlock() noexcept;
+
+		std::ofstream m_file;
+		std::string m_path;
+		std::uint16_t m_fields = 0U;
+		std::uint32_t m_recordsPerBlock = 0U;
+		std::uint32_t m_pendingRecords = 0U;
+		std::uint64_t m_offset = 0U; // bytes written so far
+		bool m_failed = false;
+		BlockLogStats m_stats;
+
+		std::vector<std::uint32_t> m_pending;    // record-major, one block
+		std::vector<unsigned char> m_encoded;    // varint columns, sized for the worst case
+		std::vector<unsigned char> m_compressed; // LZ4 output, reused
+		std::vector<std::uint32_t> m_lz4Table;
+		std::vector<IndexEntry> m_index;
+	};
+
+	class BlockLogReader {
+	public:
+		/**
+		 * @brief Opens a block log of kind and reads its index (or walks the
+		 *        blocks of an unfinished file); false (logged) on a bad file.
+		 */
+		[[nodiscard]] bool open(const std::string& path, std::uint32_t kind);
+
+		[[nodiscard]] std::uint64_t recordCount() const noexcept { return m_records; }
+		[[nodiscard]] std::uint16_t fields() const noexcept { return m_fields; }
+		[[nodiscard]] std::uint32_t tag() const noexcept { return m_tag; }
+		[[nodiscard]] std::size_t blockCount() const noexcept { return m_index.size(); }
+
+		/**
+		 * @brief Copies record index into out (fields() words), decoding its block if it is not the cached one.
+		 *
+		 * False (logged) past the end or for a block that does not decode.
+		 */
+		[[nodiscard]] bool read(std::uint64_t index, std::uint32_t* out);
+
+	private:
+		struct Block {
+			std::uint64_t offset = 0U;
+			std::uint64_t firstRecord = 0U;
+		};
+
+		[[nodiscard]] bool loadBlock(std::size_t block);
+		[[nodiscard]] bool readIndex(std::uint64_t fileSize);
+		void walkBlocks(std::uint64_t fileSize);
+
+		std::ifstream m_file;
+		std::string m_path;
+		std::uint16_t m_fields = 0U;
+		std::uint32_t m_tag = 0U;
+		std::uint64_t m_records = 0U;
+		std::vector<Block> m_index;
+
+		// The one decoded block
+		std::size_t m_cachedBlock = SIZE_MAX;
+		std::uint64_t m_cachedFirst = 0U;
+		std::uint32_t m_cachedRecords = 0U;
+		std::vector<std::uint32_t> m_decoded; // record-major
+		std::vector<unsigned char> m_stored;
+		std::vector<unsigned char> m_encoded;
+	};
+
+} // namespace io
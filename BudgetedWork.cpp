@@ -0,0 +1,90 @@
+#include "BudgetedWork.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "Trace.hpp"
+
+namespace sim {
+
+	BudgetedWork::~BudgetedWork() {
+		if (m_pool != nullptr) {
+			m_pool->wait(m_spilled);
+		}
+	}
+
+	void BudgetedWork::post(WorkAffinity affinity, Step step) {
+		m_jobs.push_back({ std::move(step), affinity, 0U });
+	}
+
+	std::size_t BudgetedWork::run(std::chrono::microseconds budget) {
+		if (m_jobs.empty()) {
+			return 0U;
+		}
+		OKPP_TRACE_SCOPE("budgeted work");
+		spill();
+
+		using Clock = std::chrono::steady_clock;
+		Clock::time_point now = Clock::now();
+		const Clock::time_point deadline = now + budget;
+		std::size_t steps = 0U;
+		while (!m_jobs.empty()) {
+			Job job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			++steps;
+			if (job.step()) {
+				++m_stats.finished;
+			}
+			else {
+				m_jobs.push_back(std::move(job)); // round-robin: the next job goes first
+			}
+			const Clock::time_point stepStart = now;
+			now = Clock::now();
+			m_stats.longestStep = std::max(m_stats.longestStep,
+				std::chrono::duration_cast<std::chrono::microseconds>(now - stepStart));
+			if (now >= deadline) {
+				break;
+			}
+		}
+		m_stats.steps += steps;
+		for (Job& job : m_jobs) {
+			++job.ticks;
+		}
+		return steps;
+	}
+
+	void BudgetedWork::finish() {
+		while (!m_jobs.empty()) {
+			Job job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			while (!job.step()) {
+				++m_stats.steps;
+			}
+			++m_stats.steps;
+			++m_stats.finished;
+		}
+		if (m_pool != nullptr) {
+			m_pool->wait(m_spilled);
+		}
+	}
+
+	void BudgetedWork::spill() {
+		if (m_pool == nullptr) {
+			return;
+		}
+		for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+			if (it->affinity != WorkAffinity::AnyThread || it->ticks < SPILL_TICKS) {
+				++it;
+				continue;
+			}
+			m_pool->submit(m_spilled, [step = std::move(it->step)]() {
+				OKPP_TRACE_SCOPE("spilled work");
+				while (!step()) {
+				}
+			});
+			++m_stats.spilled;
+			it = m_jobs.erase(it);
+		}
+	}
+
+} // namespace sim
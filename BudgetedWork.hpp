@@ -0,0 +1,110 @@
+/*
+==============================================================================
+Budgeted Work - lazy background jobs time-sliced into each tick (--work-budget)
+==============================================================================
+ - A job is a step function that does one small slice of its work and
+   returns true once the job is finished; run() steps the queued jobs in
+   turn until the tick's microsecond budget is spent, and what is left
+   carries over to the next tick
+ - The main loop calls run() right after display(), in the slack before the
+   next frame, so lazy work (minimap tiles and the like) never lengthens
+   the frame that asked for it
+ - Jobs are stepped round-robin, so one long job cannot starve the others;
+   at least one step runs per call, so a budget smaller than any step
+   still makes progress. A step that overruns what was left of the budget
+   is not cut short; stats() keeps the longest one, so a job whose steps
+   are too coarse for the budget shows up
+ - AnyThread jobs that are still queued SPILL_TICKS ticks after being posted
+   are handed to a thread pool, which steps them to the end on a worker;
+   MainThread jobs (GL objects, state the loop owns) never leave the
+   posting thread
+ - One thread posts and runs; spilled jobs must not touch what the
+   MainThread jobs or the loop touch
+ - No SFML dependency; timings come from std::chrono::steady_clock
+==============================================================================
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	enum class WorkAffinity : std::uint8_t {
+		MainThread, // stepped only by run()
+		AnyThread   // may finish on a pool worker once it has waited SPILL_TICKS ticks
+	};
+
+	struct BudgetedWorkStats {
+		std::uint64_t steps = 0U;    // stepped by run()
+		std::uint64_t finished = 0U; // jobs finished by run()
+		std::chrono::microseconds longestStep{ 0 };
+		std::uint64_t spilled = 0U;  // jobs handed to the pool
+	};
+
+	class BudgetedWork {
+	public:
+		using Step = std::function<bool()>; // one slice of a job; true once the job is finished
+
+		static constexpr std::uint32_t SPILL_TICKS = 8U;
+
+		/**
+		 * @brief Queue whose AnyThread jobs spill to pool (null: they stay on the running thread).
+		 */
+		explicit BudgetedWork(ThreadPool* pool = nullptr) noexcept : m_pool(pool) {}
+
+		/**
+		 * @brief Waits for the spilled jobs; queued jobs are dropped.
+		 */
+		~BudgetedWork();
+
+		BudgetedWork(const BudgetedWork&) = delete;
+		BudgetedWork& operator=(const BudgetedWork&) = delete;
+
+		/**
+		 * @brief Queues a job; its first step runs in a later run().
+		 */
+		void post(WorkAffinity affinity, Step step);
+
+		/**
+		 * @brief Steps queued jobs until budget has elapsed; returns the steps run.
+		 */
+		std::size_t run(std::chrono::microseconds budget);
+
+		/**
+		 * @brief Steps every queued job to its end on this thread and waits for the spilled ones.
+		 */
+		void finish();
+
+		[[nodiscard]] std::size_t queued() const noexcept { return m_jobs.size(); }
+
+		/**
+		 * @brief Nothing queued and no spilled job still running.
+		 */
+		[[nodiscard]] bool idle() const noexcept { return m_jobs.empty() && m_spilled.done(); }
+
+		[[nodiscard]] const BudgetedWorkStats& stats() const noexcept { return m_stats; }
+
+	private:
+		struct Job {
+			Step step;
+			WorkAffinity affinity = WorkAffinity::MainThread;
+			std::uint32_t ticks = 0U; // run() calls since it was posted
+		};
+
+		// Hands the AnyThread jobs that have waited long enough to the pool
+		void spill();
+
+		ThreadPool* m_pool = nullptr;
+		std::deque<Job> m_jobs;
+		TaskGroup m_spilled;
+		BudgetedWorkStats m_stats;
+	};
+
+} // namespace sim
@@ -0,0 +1,110 @@
+/*
+==============================================================================
+Cache Aligned - heap arrays that start on a cache line
+==============================================================================
+ - CacheAlignedVector<T> is a std::vector whose storage starts on a
+   CACHE_LINE_BYTES boundary (aligned operator new), so element i of
+   every such column sits at the same offset within its line
+ - Padding a column to whole lines (roundUpToLine) and splitting work at
+   multiples of perCacheLine<T>() elements gives each thread its own lines:
+   no false sharing between workers writing neighbouring ranges
+ - FirstTouchVector<T> is the same with resize() leaving new elements
+   uninitialized, so each page is first written, and placed on a memory
+   node, by whichever thread fills it
+ - No SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace sim {
+
+	constexpr std::size_t CACHE_LINE_BYTES = 64U;
+
+	/**
+	 * @brief Elements of T per cache line.
+	 */
+	template <typename T>
+	[[nodiscard]] constexpr std::size_t perCacheLine() noexcept {
+		static_assert(sizeof(T) <= CACHE_LINE_BYTES && CACHE_LINE_BYTES % sizeof(T) == 0U,
+			"T must tile a cache line");
+		return CACHE_LINE_BYTES / sizeof(T);
+	}
+
+	/**
+	 * @brief count rounded up to a whole number of lines of perLine elements.
+	 */
+	[[nodiscard]] constexpr std::size_t roundUpToLine(std::size_t count, std::size_t perLine) noexcept {
+		return ((count + perLine - 1U) / perLine) * perLine;
+	}
+
+	template <typename T>
+	class CacheAlignedAllocator {
+	public:
+		using value_type = T;
+
+		template <typename U>
+		struct rebind {
+			using other = CacheAlignedAllocator<U>;
+		};
+
+		CacheAlignedAllocator() noexcept = default;
+		template <typename U>
+		CacheAlignedAllocator(const CacheAlignedAllocator<U>&) noexcept {}
+
+		[[nodiscard]] T* allocate(std::size_t count) {
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ CACHE_LINE_BYTES }));
+		}
+
+		void deallocate(T* memory, std::size_t) noexcept {
+			::operator delete(memory, std::align_val_t{ CACHE_LINE_BYTES });
+		}
+
+		template <typename U>
+		[[nodiscard]] bool operator==(const CacheAlignedAllocator<U>&) const noexcept { return true; }
+		template <typename U>
+		[[nodiscard]] bool operator!=(const CacheAlignedAllocator<U>&) const noexcept { return false; }
+	};
+
+	template <typename T>
+	using CacheAlignedVector = std::vector<T, CacheAlignedAllocator<T>>;
+
+	// Default-initializes instead of value-initializing: no write until the owner's
+	template <typename T>
+	class FirstTouchAllocator : public CacheAlignedAllocator<T> {
+	public:
+		template <typename U>
+		struct rebind {
+			using other = FirstTouchAllocator<U>;
+		};
+
+		FirstTouchAllocator() noexcept = default;
+
+		template <typename U>
+		FirstTouchAllocator(const FirstTouchAllocator<U>&) noexcept {}
+
+		template <typename U>
+		void construct(U* element) {
+			::new (static_cast<void*>(element)) U;
+		}
+
+		template <typename U, typename... Args>
+		void construct(U* element, Args&&... args) {
+			::new (static_cast<void*>(element)) U(std::forward<Args>(args)...);
+		}
+	};
+
+	/**
+	 * @brief Cache-aligned column whose resize() does not touch the new elements.
+	 *
+	 * MISRA: only for trivial T, and every element must be written before it is read.
+	 */
+	template <typename T>
+	using FirstTouchVector = std::vector<T, FirstTouchAllocator<T>>;
+
+} // namespace sim
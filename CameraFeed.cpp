@@ -0,0 +1,255 @@
+#include "CameraFeed.hpp"
+
+#include <SFML/Window/Context.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr GLbitfield PERSISTENT_SLOT_WRITE = gl::MAP_WRITE_BIT | gl::MAP_PERSISTENT_BIT | gl::MAP_COHERENT_BIT;
+
+		// Eight bars, the classic test card order
+		constexpr std::array<std::uint32_t, 8> CARD_BARS = {
+			0xFFFFFFU, 0xFFFF00U, 0x00FFFFU, 0x00FF00U, 0xFF00FFU, 0xFF0000U, 0x0000FFU, 0x101010U
+		};
+
+		[[nodiscard]] gl::ProcAddress cameraLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+	}
+
+	CameraSource testCardSource() {
+		return [](std::uint8_t* rgba, const sf::Vector2u& size, std::uint64_t frame) {
+			const std::uint32_t barWidth = std::max(1U, size.x / static_cast<std::uint32_t>(CARD_BARS.size()));
+			const auto shift = static_cast<std::uint32_t>(frame % size.x);
+			const auto scanline = static_cast<std::uint32_t>(frame * 4U % size.y);
+			for (std::uint32_t y = 0U; y < size.y; ++y) {
+				for (std::uint32_t x = 0U; x < size.x; ++x) {
+					const std::uint32_t bar = CARD_BARS[((x + shift) % size.x) / barWidth % CARD_BARS.size()];
+					const std::uint32_t color = (y == scanline) ? 0xFFFFFFU : bar;
+					*rgba++ = static_cast<std::uint8_t>(color >> 16U);
+					*rgba++ = static_cast<std::uint8_t>(color >> 8U);
+					*rgba++ = static_cast<std::uint8_t>(color);
+					*rgba++ = 255U;
+				}
+			}
+			return true;
+		};
+	}
+
+	CameraFeed::~CameraFeed() {
+		stop();
+	}
+
+	bool CameraFeed::start(const sf::Vector2u& size, float fps, CameraSource source) {
+		if (m_thread.joinable() || size.x == 0U || size.y == 0U || fps <= 0.0F || !source) {
+			return false;
+		}
+		if (!gl::loaded() && !gl::load(&cameraLoader)) {
+			OKPP_LOG_ERROR("Error: pixel buffers are unavailable, --camera-feed is off");
+			return false;
+		}
+		for (sf::Texture& texture : m_textures) {
+			if (!texture.resize(size)) {
+				OKPP_LOG_ERROR("Error: cannot create %ux%u camera textures", size.x, size.y);
+				return false;
+			}
+			texture.setSmooth(true);
+		}
+
+		const gl::Api& api = gl::api();
+		m_frameBytes = prof::rgbaTextureBytes(size.x, size.y);
+		m_persistent = gl::storageLoaded() || gl::loadStorage(&cameraLoader);
+		if (m_persistent) {
+			const auto bytes = static_cast<gl::SizeiPtr>(SLOT_COUNT * m_frameBytes);
+			api.GenBuffers(1, &m_buffers[0]);
+			api.BindBuffer(gl::PIXEL_UNPACK_BUFFER, m_buffers[0]);
+			api.BufferStorage(gl::PIXEL_UNPACK_BUFFER, bytes, nullptr, PERSISTENT_SLOT_WRITE);
+			auto* mapped = static_cast<std::uint8_t*>(api.MapBufferRange(gl::PIXEL_UNPACK_BUFFER, 0, bytes, PERSISTENT_SLOT_WRITE));
+			for (std::size_t slot = 0U; slot < SLOT_COUNT; ++slot) {
+				m_slotPixels[slot] = (mapped != nullptr) ? mapped + slot * m_frameBytes : nullptr;
+			}
+		}
+		else {
+			api.GenBuffers(static_cast<GLsizei>(m_buffers.size()), m_buffers.data());
+			for (std::size_t slot = 0U; slot < SLOT_COUNT; ++slot) {
+				api.BindBuffer(gl::PIXEL_UNPACK_BUFFER, m_buffers[slot]);
+				api.BufferData(gl::PIXEL_UNPACK_BUFFER, static_cast<gl::SizeiPtr>(m_frameBytes), nullptr, gl::STREAM_DRAW);
+				m_slotPixels[slot] = static_cast<std::uint8_t*>(api.MapBuffer(gl::PIXEL_UNPACK_BUFFER, gl::WRITE_ONLY));
+			}
+		}
+		api.BindBuffer(gl::PIXEL_UNPACK_BUFFER, 0U);
+		if (std::find(m_slotPixels.begin(), m_slotPixels.end(), nullptr) != m_slotPixels.end()) {
+			OKPP_LOG_ERROR("Error: cannot map the camera frame buffers, --camera-feed is off");
+			api.DeleteBuffers(static_cast<GLsizei>(m_buffers.size()), m_buffers.data()); // also unmaps
+			m_buffers = {};
+			m_slotPixels = {};
+			return false;
+		}
+
+		for (std::uint32_t slot = 0U; slot < SLOT_COUNT; ++slot) {
+			(void)m_free.tryPush(slot);
+		}
+		m_videoCharge.set(m_textures.size() * m_frameBytes + SLOT_COUNT * m_frameBytes);
+		m_size = size;
+		m_source = std::move(source);
+		m_stop.store(false, std::memory_order_relaxed);
+		m_thread = std::thread([this, fps]() { run(fps); });
+		OKPP_LOG_INFO("Camera feed: %ux%u at %.0f fps through %s pixel buffers", size.x, size.y,
+			static_cast<double>(fps), m_persistent ? "persistently mapped" : "orphaned");
+		return true;
+	}
+
+	void CameraFeed::update() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("camera upload");
+		if (m_persistent) {
+			recycleUploaded();
+		}
+
+		// Only the newest frame is worth a transfer; the others are rewritten as they are
+		std::uint32_t slot = 0U;
+		std::uint32_t newest = 0U;
+		bool any = false;
+		while (m_filled.tryPop(slot)) {
+			if (any) {
+				(void)m_free.tryPush(newest); // never full: it holds at most every slot
+				m_skipped.fetch_add(1U, std::memory_order_relaxed);
+			}
+			newest = slot;
+			any = true;
+		}
+		if (any) {
+			upload(newest);
+		}
+	}
+
+	void CameraFeed::recycleUploaded() {
+		const gl::Api& api = gl::api();
+		for (std::uint32_t slot = 0U; slot < SLOT_COUNT; ++slot) {
+			gl::Sync& fence = m_fences[slot];
+			if (fence != nullptr && api.ClientWaitSync(fence, 0U, 0U) != gl::TIMEOUT_EXPIRED) {
+				api.DeleteSync(fence);
+				fence = nullptr;
+				(void)m_free.tryPush(slot);
+			}
+		}
+	}
+
+	void CameraFeed::upload(std::uint32_t slot) {
+		const gl::Api& api = gl::api();
+		const std::size_t target = (m_shown + 1U) % m_textures.size();
+		const std::size_t offset = m_persistent ? slot * m_frameBytes : 0U;
+		api.BindBuffer(gl::PIXEL_UNPACK_BUFFER, m_persistent ? m_buffers[0] : m_buffers[slot]);
+		if (!m_persistent) {
+			(void)api.UnmapBuffer(gl::PIXEL_UNPACK_BUFFER);
+		}
+
+		// With an unpack buffer bound the pixel pointer is an offset into it; restore
+		// the 2D binding afterwards so SFML's render-state cache stays valid
+		GLint previous = 0;
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+		glBindTexture(GL_TEXTURE_2D, m_textures[target].getNativeHandle());
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, static_cast<GLsizei>(m_size.x), static_cast<GLsizei>(m_size.y),
+			GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(offset));
+		glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous));
+
+		if (m_persistent) {
+			m_fences[slot] = api.FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0U);
+		}
+		else {
+			// Orphan: the transfer keeps the old storage, the capture thread gets new
+			api.BufferData(gl::PIXEL_UNPACK_BUFFER, static_cast<gl::SizeiPtr>(m_frameBytes), nullptr, gl::STREAM_DRAW);
+			m_slotPixels[slot] = static_cast<std::uint8_t*>(api.MapBuffer(gl::PIXEL_UNPACK_BUFFER, gl::WRITE_ONLY));
+			if (m_slotPixels[slot] != nullptr) {
+				(void)m_free.tryPush(slot);
+			}
+			else {
+				OKPP_LOG_WARNING("Warning: cannot map camera slot %u again, the feed runs on fewer slots", slot);
+			}
+		}
+		api.BindBuffer(gl::PIXEL_UNPACK_BUFFER, 0U);
+		m_shown = target;
+		m_uploaded.fetch_add(1U, std::memory_order_relaxed);
+	}
+
+	void CameraFeed::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		if (m_uploaded.load(std::memory_order_relaxed) == 0U || m_area.size.x <= 0.0F || m_area.size.y <= 0.0F) {
+			return;
+		}
+		const sf::Vector2f textureSize(m_size);
+		const float scale = std::min(m_area.size.x / textureSize.x, m_area.size.y / textureSize.y);
+		sf::Sprite sprite(m_textures[m_shown]);
+		sprite.setScale({ scale, scale });
+		sprite.setPosition(m_area.position + (m_area.size - textureSize * scale) / 2.0F);
+		target.draw(sprite, states);
+	}
+
+	void CameraFeed::stop() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		m_stop.store(true, std::memory_order_release);
+		m_thread.join();
+		{
+			// Buffers are shared between SFML contexts; the window's may already be gone
+			const sf::Context context;
+			const gl::Api& api = gl::api();
+			for (gl::Sync& fence : m_fences) {
+				if (fence != nullptr) {
+					api.DeleteSync(fence);
+					fence = nullptr;
+				}
+			}
+			api.DeleteBuffers(static_cast<GLsizei>(m_buffers.size()), m_buffers.data()); // also unmaps
+			m_buffers = {};
+			m_slotPixels = {};
+		}
+		std::uint32_t slot = 0U;
+		while (m_free.tryPop(slot) || m_filled.tryPop(slot)) {
+		}
+		m_videoCharge.set(0U);
+
+		const CameraFeedStats totals = stats();
+		OKPP_LOG_INFO("Camera feed: uploaded %llu frames, skipped %llu, dropped %llu",
+			static_cast<unsigned long long>(totals.uploaded), static_cast<unsigned long long>(totals.skipped),
+			static_cast<unsigned long long>(totals.dropped));
+	}
+
+	CameraFeedStats CameraFeed::stats() const noexcept {
+		return { m_uploaded.load(std::memory_order_relaxed), m_skipped.load(std::memory_order_relaxed),
+			m_dropped.load(std::memory_order_relaxed) };
+	}
+
+	void CameraFeed::run(float fps) {
+		prof::setThreadName("camera capture");
+		using Clock = std::chrono::steady_clock;
+		const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0F / fps));
+		Clock::time_point next = Clock::now();
+		std::uint64_t frame = 0U;
+		std::uint32_t slot = 0U;
+		while (!m_stop.load(std::memory_order_acquire)) {
+			next += period;
+			std::this_thread::sleep_until(next);
+			if (!m_free.tryPop(slot)) {
+				m_dropped.fetch_add(1U, std::memory_order_relaxed);
+				++frame;
+				continue;
+			}
+			OKPP_TRACE_SCOPE("camera frame");
+			if (!m_source(m_slotPixels[slot], m_size, frame++)) {
+				break; // the source has ended; the last frame uploaded stays on screen
+			}
+			(void)m_filled.tryPush(slot); // never full: it holds at most every slot
+		}
+	}
+
+} // namespace gfx
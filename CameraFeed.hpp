@@ -0,0 +1,129 @@
+/*
+==============================================================================
+Camera Feed - a rear-camera stream uploaded without copies (--camera-feed)
+==============================================================================
+ - A capture thread writes each frame straight into a pixel-unpack buffer
+   mapped for it; the render thread only starts a glTexSubImage2D from
+   that buffer, so frame data is never copied or touched by the CPU on the
+   render thread and sf::Texture::update is never called per frame
+ - With OpenGL 4.4 one buffer of SLOT_COUNT frame regions is mapped once
+   for good; a region goes back to the capture thread once the fence of
+   its upload has signalled
+ - Older drivers get one buffer per slot: after its upload the slot is
+   orphaned (glBufferData without data) and mapped again at once, so the
+   driver hands out fresh storage instead of waiting for the transfer
+ - Uploads alternate between two textures, so a frame never overwrites
+   the texture the GPU may still be drawing
+ - Only the newest captured frame is uploaded; older ones go straight back
+   to the capture thread, and frames captured while every slot is taken
+   are dropped and counted
+ - The source fills frames in place at the camera's pace; testCardSource()
+   stands in for a camera driver
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "GlFunctions.hpp"
+#include "MemoryAccounting.hpp"
+#include "SpscRing.hpp"
+
+namespace gfx {
+
+	/**
+	 * @brief Writes frame number frame as tightly packed RGBA rows, top row first.
+	 *
+	 * Runs on the capture thread; returns false once the source has ended.
+	 */
+	using CameraSource = std::function<bool(std::uint8_t* rgba, const sf::Vector2u& size, std::uint64_t frame)>;
+
+	/**
+	 * @brief Moving colour bars with a sweeping scanline, in place of a camera driver.
+	 */
+	[[nodiscard]] CameraSource testCardSource();
+
+	struct CameraFeedStats {
+		std::uint64_t uploaded = 0U;
+		std::uint64_t skipped = 0U; // captured, but a newer frame was uploaded instead
+		std::uint64_t dropped = 0U; // every slot was still taken when the camera delivered
+	};
+
+	class CameraFeed : public sf::Drawable {
+	public:
+		// Frames being written, waiting for upload and being uploaded
+		static constexpr std::size_t SLOT_COUNT = 3U;
+
+		CameraFeed() = default;
+		~CameraFeed() override;
+
+		CameraFeed(const CameraFeed&) = delete;
+		CameraFeed& operator=(const CameraFeed&) = delete;
+
+		/**
+		 * @brief Maps the slots and starts capturing size-pixel frames from source at fps.
+		 *
+		 * Requires the window's GL context to be active. Returns false (and
+		 * logs) if pixel buffers or the textures are unavailable.
+		 */
+		[[nodiscard]] bool start(const sf::Vector2u& size, float fps, CameraSource source);
+
+		/**
+		 * @brief Uploads the newest captured frame, if any; once per frame, on the thread that draws.
+		 */
+		void update();
+
+		/**
+		 * @brief Places the feed on screen, scaled to fit area with its aspect ratio.
+		 */
+		void setArea(const sf::FloatRect& area) noexcept { m_area = area; }
+
+		/**
+		 * @brief Stops the capture thread and releases the buffers; safe to call twice.
+		 *
+		 * Brings up a shared GL context of its own, so it may run after the window closed.
+		 */
+		void stop();
+
+		[[nodiscard]] bool running() const noexcept { return m_thread.joinable(); }
+
+		[[nodiscard]] CameraFeedStats stats() const noexcept;
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		void recycleUploaded();
+		void upload(std::uint32_t slot);
+		void run(float fps);
+
+		bool m_persistent = false; // one mapped buffer of SLOT_COUNT regions, else orphaned per-slot buffers
+		std::array<GLuint, SLOT_COUNT> m_buffers{};
+		std::array<gl::Sync, SLOT_COUNT> m_fences{}; // persistent: the upload from each region
+		std::array<std::uint8_t*, SLOT_COUNT> m_slotPixels{};
+		sim::SpscRing<std::uint32_t, 4> m_free;   // render -> capture: slots ready to be written
+		sim::SpscRing<std::uint32_t, 4> m_filled; // capture -> render: frames ready to upload
+
+		std::array<sf::Texture, 2> m_textures;
+		std::size_t m_shown = 0U;
+		sf::FloatRect m_area;
+
+		sf::Vector2u m_size;
+		std::size_t m_frameBytes = 0U;
+		CameraSource m_source;
+		std::atomic<bool> m_stop{ false };
+		std::atomic<std::uint64_t> m_dropped{ 0U };
+		std::atomic<std::uint64_t> m_uploaded{ 0U };
+		std::atomic<std::uint64_t> m_skipped{ 0U };
+		std::thread m_thread;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Video }; // textures and slots
+	};
+
+} // namespace gfx
@@ -0,0 +1,258 @@
+#include "CarHull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "FastTrig.hpp"
+
+namespace sim {
+
+	namespace {
+		[[nodiscard]] float hullCross(const sf::Vector2f& u, const sf::Vector2f& v) noexcept {
+			return u.x * v.y - u.y * v.x;
+		}
+
+		// Convex hull of points, positive signed area, collinear points dropped (Andrew's monotone chain)
+		[[nodiscard]] std::vector<sf::Vector2f> monotoneChain(std::vector<sf::Vector2f> points) {
+			std::sort(points.begin(), points.end(), [](const sf::Vector2f& a, const sf::Vector2f& b) {
+				return (a.x < b.x) || (a.x == b.x && a.y < b.y);
+			});
+			points.erase(std::unique(points.begin(), points.end()), points.end());
+			if (points.size() < 3U) {
+				return points;
+			}
+
+			std::vector<sf::Vector2f> hull(2U * points.size());
+			std::size_t k = 0U;
+			for (const sf::Vector2f& p : points) {
+				while (k >= 2U && hullCross(hull[k - 1U] - hull[k - 2U], p - hull[k - 2U]) <= 0.0F) {
+					--k;
+				}
+				hull[k++] = p;
+			}
+			const std::size_t lower = k + 1U;
+			for (std::size_t i = points.size() - 1U; i > 0U; --i) {
+				const sf::Vector2f& p = points[i - 1U];
+				while (k >= lower && hullCross(hull[k - 1U] - hull[k - 2U], p - hull[k - 2U]) <= 0.0F) {
+					--k;
+				}
+				hull[k++] = p;
+			}
+			hull.resize(k - 1U); // the last point repeats the first
+			return hull;
+		}
+
+		// Replaces the edge whose neighbours meet closest past it by that meeting point, until at most limit remain
+		void mergeEdges(std::vector<sf::Vector2f>& hull, std::size_t limit) {
+			while (hull.size() > limit) {
+				const std::size_t n = hull.size();
+				float bestArea = std::numeric_limits<float>::max();
+				std::size_t bestEdge = n;
+				sf::Vector2f bestPoint;
+				for (std::size_t i = 0U; i < n; ++i) {
+					const sf::Vector2f& a = hull[i];
+					const sf::Vector2f& b = hull[(i + 1U) % n];
+					const sf::Vector2f before = a - hull[(i + n - 1U) % n];
+					const sf::Vector2f after = hull[(i + 2U) % n] - b;
+					// The neighbours only meet past the edge if they turn by less than half a circle
+					const float turn = hullCross(before, after);
+					if (turn <= 0.0F) {
+						continue;
+					}
+					const sf::Vector2f meet = a + before * (hullCross(b - a, after) / turn);
+					const float area = 0.5F * std::fabs(hullCross(meet - a, b - a));
+					if (area < bestArea) {
+						bestArea = area;
+						bestEdge = i;
+						bestPoint = meet;
+					}
+				}
+				if (bestEdge == n) {
+					return; // a triangle or a degenerate outline: nothing left to merge
+				}
+				hull[bestEdge] = bestPoint;
+				hull.erase(hull.begin() + static_cast<std::ptrdiff_t>((bestEdge + 1U) % n));
+			}
+		}
+
+		// Copies outline (positive area, car frame) into hull with its edge normals and extents
+		[[nodiscard]] CarHull finishHull(const std::vector<sf::Vector2f>& outline, const sf::Vector2f& halfExtent) {
+			CarHull hull;
+			hull.halfExtent = halfExtent;
+			hull.count = static_cast<std::uint32_t>(std::min(outline.size(), CarHull::MAX_VERTICES));
+			if (hull.count < 3U) {
+				hull.count = 0U;
+				return hull;
+			}
+			std::copy(outline.begin(), outline.begin() + hull.count, hull.vertices.begin());
+			hull.low = hull.vertices[0];
+			hull.high = hull.low;
+			for (std::uint32_t i = 0U; i < hull.count; ++i) {
+				const sf::Vector2f& v = hull.vertices[i];
+				hull.low = { std::min(hull.low.x, v.x), std::min(hull.low.y, v.y) };
+				hull.high = { std::max(hull.high.x, v.x), std::max(hull.high.y, v.y) };
+
+				const sf::Vector2f edge = hull.vertices[(i + 1U) % hull.count] - v;
+				const float length = std::sqrt(edge.dot(edge));
+				hull.normals[i] = (length > 0.0F) ? sf::Vector2f{ edge.y / length, -edge.x / length } : sf::Vector2f{};
+				hull.outer[i] = v.dot(hull.normals[i]);
+				hull.inner[i] = hull.outer[i];
+				for (std::uint32_t j = 0U; j < hull.count; ++j) {
+					hull.inner[i] = std::min(hull.inner[i], hull.vertices[j].dot(hull.normals[i]));
+				}
+			}
+			return hull;
+		}
+
+		// Squared distance from p to the segment a -> b
+		[[nodiscard]] float segmentDistanceSq(const sf::Vector2f& p, const sf::Vector2f& a, const sf::Vector2f& b) noexcept {
+			const sf::Vector2f ab = b - a;
+			const float lengthSq = ab.dot(ab);
+			const float t = (lengthSq > 0.0F) ? std::clamp((p - a).dot(ab) / lengthSq, 0.0F, 1.0F) : 0.0F;
+			const sf::Vector2f gap = p - (a + ab * t);
+			return gap.dot(gap);
+		}
+	}
+
+	CarHull alphaHull(const std::uint8_t* rgba, const sf::Vector2u& size, const sf::Vector2f& halfExtent,
+		std::uint8_t minAlpha)
+	{
+		// The corners of the first and last opaque pixel of every row, in pixels
+		std::vector<sf::Vector2f> corners;
+		for (std::uint32_t y = 0U; y < size.y; ++y) {
+			const std::uint8_t* row = rgba + static_cast<std::size_t>(y) * size.x * 4U;
+			std::uint32_t first = size.x;
+			std::uint32_t last = 0U;
+			for (std::uint32_t x = 0U; x < size.x; ++x) {
+				if (row[4U * x + 3U] >= minAlpha) {
+					first = std::min(first, x);
+					last = x;
+				}
+			}
+			if (first <= last) {
+				const auto top = static_cast<float>(y);
+				corners.insert(corners.end(), { { static_cast<float>(first), top }, { static_cast<float>(last + 1U), top },
+					{ static_cast<float>(first), top + 1.0F }, { static_cast<float>(last + 1U), top + 1.0F } });
+			}
+		}
+
+		std::vector<sf::Vector2f> outline = monotoneChain(std::move(corners));
+		if (outline.size() < 3U) {
+			return boxHull(halfExtent);
+		}
+		mergeEdges(outline, CarHull::MAX_VERTICES);
+
+		// Pixels to the car frame: the image covers the rectangle of halfExtent, centered
+		const sf::Vector2f scale{ 2.0F * halfExtent.x / static_cast<float>(size.x),
+			2.0F * halfExtent.y / static_cast<float>(size.y) };
+		for (sf::Vector2f& vertex : outline) {
+			vertex = vertex.componentWiseMul(scale) - halfExtent;
+		}
+		return finishHull(outline, halfExtent);
+	}
+
+	CarHull boxHull(const sf::Vector2f& halfExtent) {
+		return finishHull({ { -halfExtent.x, -halfExtent.y }, { halfExtent.x, -halfExtent.y },
+			{ halfExtent.x, halfExtent.y }, { -halfExtent.x, halfExtent.y } }, halfExtent);
+	}
+
+	float hullArea(const CarHull& hull) noexcept {
+		float twiceArea = 0.0F;
+		for (std::uint32_t i = 0U; i < hull.count; ++i) {
+			twiceArea += hullCross(hull.vertices[i], hull.vertices[(i + 1U) % hull.count]);
+		}
+		return 0.5F * twiceArea;
+	}
+
+	bool hullHitsCircle(const CarHull& hull, const sf::Vector2f& center, float radius) noexcept {
+		// Separated along an edge normal, or inside every edge
+		float farthest = -std::numeric_limits<float>::max();
+		for (std::uint32_t i = 0U; i < hull.count; ++i) {
+			farthest = std::max(farthest, center.dot(hull.normals[i]) - hull.outer[i]);
+		}
+		if (farthest >= radius) {
+			return false;
+		}
+		if (farthest <= 0.0F) {
+			return true;
+		}
+		// Outside but near: the nearest edge decides (covers the vertex regions the normals miss)
+		for (std::uint32_t i = 0U; i < hull.count; ++i) {
+			if (segmentDistanceSq(center, hull.vertices[i], hull.vertices[(i + 1U) % hull.count]) < radius * radius) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool hullHitsBox(const CarHull& hull, const sf::Vector2f& center, const sf::Vector2f& axisX,
+		const sf::Vector2f& axisY, const sf::Vector2f& half) noexcept
+	{
+		// The hull's edge normals
+		for (std::uint32_t i = 0U; i < hull.count; ++i) {
+			const sf::Vector2f& n = hull.normals[i];
+			const float mid = center.dot(n);
+			const float reach = std::fabs(axisX.dot(n)) * half.x + std::fabs(axisY.dot(n)) * half.y;
+			if (mid - reach >= hull.outer[i] || mid + reach <= hull.inner[i]) {
+				return false;
+			}
+		}
+
+		// The box's own axes
+		const std::array<sf::Vector2f, 2> axes{ axisX, axisY };
+		const std::array<float, 2> halves{ half.x, half.y };
+		for (std::size_t a = 0U; a < axes.size(); ++a) {
+			float low = std::numeric_limits<float>::max();
+			float high = -std::numeric_limits<float>::max();
+			for (std::uint32_t i = 0U; i < hull.count; ++i) {
+				const float along = hull.vertices[i].dot(axes[a]);
+				low = std::min(low, along);
+				high = std::max(high, along);
+			}
+			const float mid = center.dot(axes[a]);
+			if (mid - halves[a] >= high || mid + halves[a] <= low) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	sf::Vector2f hullBoundary(const CarHull& hull, const sf::Vector2f& direction) noexcept {
+		float exit = std::numeric_limits<float>::max();
+		for (std::uint32_t i = 0U; i < hull.count; ++i) {
+			if (hull.outer[i] < 0.0F) {
+				return direction; // the center is outside this edge
+			}
+			const float toward = direction.dot(hull.normals[i]);
+			if (toward > 0.0F) {
+				exit = std::min(exit, hull.outer[i] / toward);
+			}
+		}
+		return (exit < std::numeric_limits<float>::max()) ? direction * exit : direction;
+	}
+
+	sf::FloatRect hullBounds(const CarHull& hull, const sf::Transform& transform) {
+		sf::Vector2f low = transform.transformPoint(hull.vertices[0]);
+		sf::Vector2f high = low;
+		for (std::uint32_t i = 1U; i < hull.count; ++i) {
+			const sf::Vector2f p = transform.transformPoint(hull.vertices[i]);
+			low = { std::min(low.x, p.x), std::min(low.y, p.y) };
+			high = { std::max(high.x, p.x), std::max(high.y, p.y) };
+		}
+		return { low, high - low };
+	}
+
+	OrientedRect hullFootprint(const CarState& pose, const CarHull& hull) {
+		if (hull.empty()) {
+			return carFootprint(pose, hull.halfExtent);
+		}
+		const SinCos heading = sinCosDeg(pose.headingDeg);
+		const sf::Vector2f axis{ heading.cos, heading.sin };
+		const sf::Vector2f middle = (hull.low + hull.high) * 0.5F;
+		const sf::Vector2f offset = axis * middle.x + sf::Vector2f{ -axis.y, axis.x } * middle.y;
+		return { pose.position + offset, axis, (hull.high - hull.low) * 0.5F };
+	}
+
+} // namespace sim
@@ -0,0 +1,102 @@
+/*
+==============================================================================
+Car Hull - the car's convex outline taken from its sprite's alpha
+==============================================================================
+ - The car sprite has transparent margins, so its rectangle is much larger
+   than the car; the hull is the convex outline of the pixels with alpha
+   of at least MIN_ALPHA, extracted once when the sprite is decoded and
+   kept with the car's shape from then on
+ - Extraction takes the first and last opaque pixel of every row, builds
+   the convex hull of their corners (monotone chain) and then merges edges
+   until at most MAX_VERTICES remain. A merge extends the two neighbouring
+   edges to where they meet, so the outline only grows and a collision
+   test against it never misses the sprite's opaque pixels
+ - Stored in the car frame (x along the heading, origin at the sprite
+   center) with each edge's outward normal and the hull's extent along
+   it, so the separating-axis tests against a pillar or a box are a few
+   dot products per edge and need no per-test setup
+ - An empty hull (count 0) means "no sprite yet": every user falls back to
+   the rectangle of the car's half extent
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "CarModel.hpp"
+#include "Parking.hpp"
+
+namespace sim {
+
+	struct CarHull {
+		static constexpr std::size_t MAX_VERTICES = 16U;
+		static constexpr std::uint8_t MIN_ALPHA = 128U; // half-covered edge pixels count as the car
+
+		// Car frame, in the order of a positive signed area (clockwise on the y-down screen)
+		std::array<sf::Vector2f, MAX_VERTICES> vertices{};
+		std::array<sf::Vector2f, MAX_VERTICES> normals{}; // outward unit normal of edge i -> i + 1
+		std::array<float, MAX_VERTICES> outer{};          // vertices[i] on normals[i]: the hull's far side
+		std::array<float, MAX_VERTICES> inner{};          // lowest vertex on normals[i]: its near side
+		std::uint32_t count = 0U;
+		sf::Vector2f low{ 0.0F, 0.0F };  // bounds in the car frame
+		sf::Vector2f high{ 0.0F, 0.0F };
+		sf::Vector2f halfExtent{ 0.0F, 0.0F }; // the sprite rectangle the hull was taken from
+
+		[[nodiscard]] bool empty() const noexcept { return count == 0U; }
+	};
+
+	/**
+	 * @brief The hull of the pixels of an RGBA8 image with alpha >= minAlpha, the
+	 *        image stretched over the rectangle of halfExtent.
+	 *
+	 * An image without such a pixel gives the rectangle itself.
+	 */
+	[[nodiscard]] CarHull alphaHull(const std::uint8_t* rgba, const sf::Vector2u& size, const sf::Vector2f& halfExtent,
+		std::uint8_t minAlpha = CarHull::MIN_ALPHA);
+
+	/**
+	 * @brief The rectangle of halfExtent as a hull.
+	 */
+	[[nodiscard]] CarHull boxHull(const sf::Vector2f& halfExtent);
+
+	/**
+	 * @brief Area of the hull, for reports against the rectangle's.
+	 */
+	[[nodiscard]] float hullArea(const CarHull& hull) noexcept;
+
+	/**
+	 * @brief True if the circle (center in the car frame) overlaps the hull; touching is not a hit.
+	 */
+	[[nodiscard]] bool hullHitsCircle(const CarHull& hull, const sf::Vector2f& center, float radius) noexcept;
+
+	/**
+	 * @brief True if the box (center, unit axes and half size in the car frame) overlaps the hull; touching is not a hit.
+	 */
+	[[nodiscard]] bool hullHitsBox(const CarHull& hull, const sf::Vector2f& center, const sf::Vector2f& axisX,
+		const sf::Vector2f& axisY, const sf::Vector2f& half) noexcept;
+
+	/**
+	 * @brief Where the ray from the car's center along direction leaves the hull.
+	 *
+	 * direction itself if the center lies outside the hull.
+	 */
+	[[nodiscard]] sf::Vector2f hullBoundary(const CarHull& hull, const sf::Vector2f& direction) noexcept;
+
+	/**
+	 * @brief Axis-aligned world bounds of the hull placed by transform.
+	 */
+	[[nodiscard]] sf::FloatRect hullBounds(const CarHull& hull, const sf::Transform& transform);
+
+	/**
+	 * @brief The hull's own box at pose, for the oriented bay tests (carFootprint() for an empty hull).
+	 */
+	[[nodiscard]] OrientedRect hullFootprint(const CarState& pose, const CarHull& hull);
+
+} // namespace sim
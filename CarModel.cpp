@@ -0,0 +1,69 @@
+#include "CarModel.hpp"
+
+#include <cmath>
+
+#include "FastTrig.hpp"
+
+namespace sim {
+
+	namespace {
+		[[nodiscard]] bool has(CarInput input, std::uint8_t bit) {
+			return (input & bit) != 0U;
+		}
+	}
+
+	void stepCar(CarState& car, CarInput input, const CarParams& params, float dt) {
+		const SinCos heading = sinCosDeg(car.headingDeg);
+		const sf::Vector2f forward{ heading.cos, heading.sin };
+
+		float throttle = 0.0F;
+		if (has(input, input::FORWARD)) { throttle += 1.0F; }
+		if (has(input, input::BACKWARD)) { throttle -= 1.0F; }
+
+		float steer = 0.0F;
+		if (has(input, input::LEFT)) { steer -= 1.0F; }
+		if (has(input, input::RIGHT)) { steer += 1.0F; }
+
+		car.position += forward * (throttle * params.speed * dt);
+		car.headingDeg = std::fmod(car.headingDeg + steer * params.turnRate * dt, 360.0F);
+	}
+
+	float pathCurvature(CarInput input, const CarParams& params) noexcept {
+		float steer = 0.0F;
+		if (has(input, input::LEFT)) { steer -= 1.0F; }
+		if (has(input, input::RIGHT)) { steer += 1.0F; }
+		const float direction = (has(input, input::FORWARD) && !has(input, input::BACKWARD)) ? 1.0F : -1.0F;
+		return (params.speed > 0.0F) ? direction * steer * params.turnRate * constants::DEG_TO_RAD / params.speed : 0.0F;
+	}
+
+	CarState interpolate(const CarState& from, const CarState& to, float alpha) {
+		float deltaDeg = std::fmod(to.headingDeg - from.headingDeg, 360.0F);
+		if (deltaDeg > 180.0F) { deltaDeg -= 360.0F; }
+		if (deltaDeg < -180.0F) { deltaDeg += 360.0F; }
+
+		CarState blended;
+		blended.position = from.position + (to.position - from.position) * alpha;
+		blended.headingDeg = from.headingDeg + deltaDeg * alpha;
+		return blended;
+	}
+
+	sf::Transform carTransform(const CarState& car) {
+		const SinCos heading = sinCosDeg(car.headingDeg);
+		const float c = heading.cos;
+		const float s = heading.sin;
+
+		return { c, -s, car.position.x,
+			s, c, car.position.y,
+			0.0F, 0.0F, 1.0F };
+	}
+
+	sf::FloatRect carBounds(const CarState& car, const sf::Vector2f& halfExtent) {
+		const SinCos heading = sinCosDeg(car.headingDeg);
+		const float c = std::fabs(heading.cos);
+		const float s = std::fabs(heading.sin);
+
+		const sf::Vector2f half{ c * halfExtent.x + s * halfExtent.y, s * halfExtent.x + c * halfExtent.y };
+		return { car.position - half, half * 2.0F };
+	}
+
+} // namespace sim
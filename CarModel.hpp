@@ -0,0 +1,76 @@
+/*
+==============================================================================
+Car Model - fixed-step car kinematics, independent of rendering
+==============================================================================
+ - CarState is the simulated pose; the sprite only mirrors it for drawing
+ - stepCar advances by one fixed tick, so results do not depend on frame rate
+ - interpolate blends the last two ticks for smooth rendering between them
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+
+namespace sim {
+
+	// Driver input for one tick, one bit per control
+	namespace input {
+		constexpr std::uint8_t FORWARD = 1U << 0U;
+		constexpr std::uint8_t BACKWARD = 1U << 1U;
+		constexpr std::uint8_t LEFT = 1U << 2U;
+		constexpr std::uint8_t RIGHT = 1U << 3U;
+	}
+
+	using CarInput = std::uint8_t;
+
+	struct CarState {
+		sf::Vector2f position{ 0.0F, 0.0F }; // center of the car
+		float headingDeg = 0.0F;             // 0 = facing +X, clockwise positive
+	};
+
+	struct CarParams {
+		float speed = 500.0F;    // pixels per second
+		float turnRate = 150.0F; // degrees per second
+	};
+
+	/**
+	 * @brief Advances the car by one fixed tick of dt seconds.
+	 */
+	void stepCar(CarState& car, CarInput input, const CarParams& params, float dt);
+
+	/**
+	 * @brief Heading change (radians, clockwise positive) per pixel the car's center moves
+	 *        along its heading, while input is held; negative distance is reversing.
+	 *
+	 * The arcade car turns at the same rate whichever way it moves, so backing
+	 * up flips the curve; without throttle it is taken as reversing.
+	 */
+	[[nodiscard]] float pathCurvature(CarInput input, const CarParams& params) noexcept;
+
+	/**
+	 * @brief Blends two ticks; alpha 0 gives from, alpha 1 gives to.
+	 *
+	 * Heading is blended along the shortest arc.
+	 */
+	[[nodiscard]] CarState interpolate(const CarState& from, const CarState& to, float alpha);
+
+	/**
+	 * @brief Local-to-world transform of the car (rotation about its center, then translation).
+	 *
+	 * Same matrix sf::Transformable builds for a sprite whose origin is its center.
+	 */
+	[[nodiscard]] sf::Transform carTransform(const CarState& car);
+
+	/**
+	 * @brief Axis-aligned bounds of the car rectangle at its current heading.
+	 *
+	 * Matches sf::Sprite::getGlobalBounds() for a sprite whose origin is its center.
+	 */
+	[[nodiscard]] sf::FloatRect carBounds(const CarState& car, const sf::Vector2f& halfExtent);
+
+} // namespace sim
@@ -0,0 +1,307 @@
+#include "ChunkedWorld.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+#include "Trace.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr char WORLD_MAGIC[8] = { 'O', 'K', 'W', 'L', 'D', '0', '0', '1' };
+
+		// Followed by the spawns, the tile index (row-major) and the tile-sorted obstacle and bay arrays
+		struct WorldHeader {
+			char magic[8];
+			float tileSize;
+			float originX;
+			float originY;
+			std::uint32_t tilesX;
+			std::uint32_t tilesY;
+			std::uint32_t spawnCount;
+			std::uint32_t obstacleCount;
+			std::uint32_t bayCount;
+		};
+
+		static_assert(sizeof(WorldHeader) == 40U, "WorldHeader layout is part of the file format");
+
+		// Tiles stay addressable with 32-bit indices
+		constexpr std::uint64_t MAX_TILES = 1U << 24U;
+
+		[[nodiscard]] std::uint32_t tileCoord(float value, float origin, float tileSize, std::uint32_t tiles) {
+			const float cell = std::floor((value - origin) / tileSize);
+			return static_cast<std::uint32_t>(std::clamp(cell, 0.0F, static_cast<float>(tiles - 1U)));
+		}
+
+		template <typename T>
+		void writeTileArray(std::ofstream& file, const std::vector<T>& values) {
+			file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+		}
+	}
+
+	bool saveChunkedWorld(const std::string& path, const Scene& scene, float tileSize) {
+		if (!(tileSize > 0.0F)) {
+			std::cerr << "Error: world tile size must be positive\n";
+			return false;
+		}
+
+		// Bounds of everything placed in the world
+		sf::Vector2f low{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		sf::Vector2f high{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+		const auto extend = [&](const sf::Vector2f& point) {
+			low = { std::min(low.x, point.x), std::min(low.y, point.y) };
+			high = { std::max(high.x, point.x), std::max(high.y, point.y) };
+		};
+		for (const auto& obstacle : scene.obstacles) {
+			extend(obstacle.center);
+		}
+		for (const auto& bay : scene.parkBays) {
+			extend(bay.getCenter());
+		}
+		for (const auto& spawn : scene.spawns) {
+			extend(spawn.position);
+		}
+		if (low.x > high.x) {
+			low = high = { 0.0F, 0.0F };
+		}
+
+		WorldHeader header{};
+		std::memcpy(header.magic, WORLD_MAGIC, sizeof(WORLD_MAGIC));
+		header.tileSize = tileSize;
+		header.originX = low.x;
+		header.originY = low.y;
+		const double tilesX = std::floor(static_cast<double>(high.x - low.x) / tileSize) + 1.0;
+		const double tilesY = std::floor(static_cast<double>(high.y - low.y) / tileSize) + 1.0;
+		if (tilesX * tilesY > static_cast<double>(MAX_TILES)) {
+			std::cerr << "Error: world of " << tilesX << 'x' << tilesY << " tiles is too large; use larger tiles\n";
+			return false;
+		}
+		header.tilesX = static_cast<std::uint32_t>(tilesX);
+		header.tilesY = static_cast<std::uint32_t>(tilesY);
+		header.spawnCount = static_cast<std::uint32_t>(scene.spawns.size());
+		header.obstacleCount = static_cast<std::uint32_t>(scene.obstacles.size());
+		header.bayCount = static_cast<std::uint32_t>(scene.parkBays.size());
+
+		const auto tileOf = [&](const sf::Vector2f& point) {
+			return tileCoord(point.y, low.y, tileSize, header.tilesY) * header.tilesX
+				+ tileCoord(point.x, low.x, tileSize, header.tilesX);
+		};
+
+		// Counting sort by tile keeps each tile's records contiguous
+		const std::size_t tileCount = static_cast<std::size_t>(header.tilesX) * header.tilesY;
+		std::vector<std::uint32_t> obstacleTiles(scene.obstacles.size());
+		std::vector<std::uint32_t> bayTiles(scene.parkBays.size());
+		std::vector<std::uint32_t> obstacleCounts(tileCount, 0U);
+		std::vector<std::uint32_t> bayCounts(tileCount, 0U);
+		for (std::size_t i = 0U; i < scene.obstacles.size(); ++i) {
+			obstacleTiles[i] = tileOf(scene.obstacles[i].center);
+			++obstacleCounts[obstacleTiles[i]];
+		}
+		for (std::size_t i = 0U; i < scene.parkBays.size(); ++i) {
+			bayTiles[i] = tileOf(scene.parkBays[i].getCenter());
+			++bayCounts[bayTiles[i]];
+		}
+
+		std::vector<std::uint32_t> tiles(tileCount * 4U);
+		std::uint32_t nextObstacle = 0U;
+		std::uint32_t nextBay = 0U;
+		for (std::size_t t = 0U; t < tileCount; ++t) {
+			tiles[t * 4U + 0U] = nextObstacle;
+			tiles[t * 4U + 1U] = obstacleCounts[t];
+			tiles[t * 4U + 2U] = nextBay;
+			tiles[t * 4U + 3U] = bayCounts[t];
+			nextObstacle += obstacleCounts[t];
+			nextBay += bayCounts[t];
+		}
+
+		std::vector<Obstacle> obstacles(scene.obstacles.size());
+		std::vector<sf::FloatRect> bays(scene.parkBays.size());
+		for (std::size_t i = 0U; i < scene.obstacles.size(); ++i) {
+			std::uint32_t& cursor = tiles[obstacleTiles[i] * 4U + 0U];
+			obstacles[cursor++] = scene.obstacles[i];
+		}
+		for (std::size_t i = 0U; i < scene.parkBays.size(); ++i) {
+			std::uint32_t& cursor = tiles[bayTiles[i] * 4U + 2U];
+			bays[cursor++] = scene.parkBays[i];
+		}
+		for (std::size_t t = 0U; t < tileCount; ++t) { // cursors now point one past each tile
+			tiles[t * 4U + 0U] -= obstacleCounts[t];
+			tiles[t * 4U + 2U] -= bayCounts[t];
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: Failed to create world " << path << '\n';
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		writeTileArray(file, scene.spawns);
+		writeTileArray(file, tiles);
+		writeTileArray(file, obstacles);
+		writeTileArray(file, bays);
+		if (!file) {
+			std::cerr << "Error: Failed to write world " << path << '\n';
+			return false;
+		}
+		return true;
+	}
+
+	ChunkedWorld::~ChunkedWorld() {
+		wait();
+	}
+
+	bool ChunkedWorld::open(const std::string& path, float loadRadius, float evictRadius) {
+		wait();
+		m_pending.clear();
+		m_resident.clear();
+		m_obstacles.clear();
+		m_bays.clear();
+		if (!m_file.open(path)) {
+			return false;
+		}
+
+		WorldHeader header{};
+		if (m_file.size() >= sizeof(header)) {
+			std::memcpy(&header, m_file.data(), sizeof(header));
+		}
+		const std::uint64_t tileCount = static_cast<std::uint64_t>(header.tilesX) * header.tilesY;
+		const std::uint64_t expected = sizeof(header)
+			+ static_cast<std::uint64_t>(header.spawnCount) * sizeof(CarState)
+			+ tileCount * sizeof(TileEntry)
+			+ static_cast<std::uint64_t>(header.obstacleCount) * sizeof(Obstacle)
+			+ static_cast<std::uint64_t>(header.bayCount) * sizeof(sf::FloatRect);
+		if (std::memcmp(header.magic, WORLD_MAGIC, sizeof(WORLD_MAGIC)) != 0 || !(header.tileSize > 0.0F)
+			|| tileCount == 0U || tileCount > MAX_TILES || header.spawnCount == 0U || expected != m_file.size()) {
+			std::cerr << "Error: " << path << " is not a valid world file\n";
+			m_file.close();
+			return false;
+		}
+
+		const unsigned char* in = m_file.data() + sizeof(header);
+		m_spawns.resize(header.spawnCount);
+		std::memcpy(m_spawns.data(), in, m_spawns.size() * sizeof(CarState));
+		in += m_spawns.size() * sizeof(CarState);
+		m_tiles.resize(static_cast<std::size_t>(tileCount));
+		std::memcpy(m_tiles.data(), in, m_tiles.size() * sizeof(TileEntry));
+		in += m_tiles.size() * sizeof(TileEntry);
+		m_fileObstacles = in;
+		m_fileBays = in + static_cast<std::size_t>(header.obstacleCount) * sizeof(Obstacle);
+
+		// A corrupt index must not send a worker outside the mapping
+		for (const auto& tile : m_tiles) {
+			if (static_cast<std::uint64_t>(tile.firstObstacle) + tile.obstacleCount > header.obstacleCount
+				|| static_cast<std::uint64_t>(tile.firstBay) + tile.bayCount > header.bayCount) {
+				std::cerr << "Error: " << path << " has a corrupt tile index\n";
+				m_file.close();
+				m_tiles.clear();
+				return false;
+			}
+		}
+
+		m_origin = { header.originX, header.originY };
+		m_tileSize = header.tileSize;
+		m_tilesX = header.tilesX;
+		m_tilesY = header.tilesY;
+		m_loadRadius = loadRadius;
+		m_evictRadius = std::max(evictRadius, loadRadius);
+		return true;
+	}
+
+	float ChunkedWorld::distanceToTile(std::uint32_t tile, const sf::Vector2f& point) const {
+		const sf::Vector2f low = m_origin
+			+ sf::Vector2f{ static_cast<float>(tile % m_tilesX), static_cast<float>(tile / m_tilesX) } * m_tileSize;
+		const float dx = std::max({ low.x - point.x, 0.0F, point.x - (low.x + m_tileSize) });
+		const float dy = std::max({ low.y - point.y, 0.0F, point.y - (low.y + m_tileSize) });
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	ChunkedWorld::TileData ChunkedWorld::loadTile(std::uint32_t tile) const {
+		OKPP_TRACE_SCOPE("load world tile");
+		const TileEntry& entry = m_tiles[tile];
+		TileData data;
+		data.obstacles.resize(entry.obstacleCount);
+		data.bays.resize(entry.bayCount);
+		if (entry.obstacleCount > 0U) {
+			std::memcpy(data.obstacles.data(), m_fileObstacles + static_cast<std::size_t>(entry.firstObstacle) * sizeof(Obstacle),
+				data.obstacles.size() * sizeof(Obstacle));
+		}
+		if (entry.bayCount > 0U) {
+			std::memcpy(data.bays.data(), m_fileBays + static_cast<std::size_t>(entry.firstBay) * sizeof(sf::FloatRect),
+				data.bays.size() * sizeof(sf::FloatRect));
+		}
+		return data;
+	}
+
+	bool ChunkedWorld::update(const sf::Vector2f& focus) {
+		if (m_tiles.empty()) {
+			return false;
+		}
+		bool changed = false;
+
+		for (auto it = m_pending.begin(); it != m_pending.end();) {
+			if (!it->second->group.done()) {
+				++it;
+				continue;
+			}
+			m_resident[it->first] = std::move(it->second->data);
+			it = m_pending.erase(it);
+			changed = true;
+		}
+
+		for (auto it = m_resident.begin(); it != m_resident.end();) {
+			if (distanceToTile(it->first, focus) > m_evictRadius) {
+				it = m_resident.erase(it);
+				changed = true;
+			}
+			else {
+				++it;
+			}
+		}
+
+		// Only the tiles in the square around the load circle are visited
+		const std::uint32_t x0 = tileCoord(focus.x - m_loadRadius, m_origin.x, m_tileSize, m_tilesX);
+		const std::uint32_t x1 = tileCoord(focus.x + m_loadRadius, m_origin.x, m_tileSize, m_tilesX);
+		const std::uint32_t y0 = tileCoord(focus.y - m_loadRadius, m_origin.y, m_tileSize, m_tilesY);
+		const std::uint32_t y1 = tileCoord(focus.y + m_loadRadius, m_origin.y, m_tileSize, m_tilesY);
+		for (std::uint32_t y = y0; y <= y1; ++y) {
+			for (std::uint32_t x = x0; x <= x1; ++x) {
+				const std::uint32_t tile = y * m_tilesX + x;
+				if (m_resident.count(tile) != 0U || m_pending.count(tile) != 0U
+					|| distanceToTile(tile, focus) > m_loadRadius) {
+					continue;
+				}
+				auto pending = std::make_unique<PendingTile>();
+				PendingTile* load = pending.get();
+				m_pending.emplace(tile, std::move(pending));
+				sharedPool().submit(load->group, [this, load, tile]() { load->data = loadTile(tile); });
+			}
+		}
+
+		if (changed) {
+			rebuildResident();
+		}
+		return changed;
+	}
+
+	void ChunkedWorld::wait() {
+		for (auto& pending : m_pending) {
+			sharedPool().wait(pending.second->group);
+		}
+	}
+
+	void ChunkedWorld::rebuildResident() {
+		OKPP_TRACE_SCOPE("rebuild resident world");
+		m_obstacles.clear();
+		m_bays.clear();
+		for (const auto& tile : m_resident) {
+			m_obstacles.insert(m_obstacles.end(), tile.second.obstacles.begin(), tile.second.obstacles.end());
+			m_bays.insert(m_bays.end(), tile.second.bays.begin(), tile.second.bays.end());
+		}
+	}
+
+} // namespace sim
@@ -0,0 +1,124 @@
+/*
+==============================================================================
+Chunked World - very large lots streamed in tiles around the car (--world)
+==============================================================================
+ - World file (.okwld): obstacles and bays grouped by the square tile that
+   holds their center, plus a tile index; written by --compile-world from
+   any scenario
+ - The file is memory-mapped; a tile near the car is copied out of the
+   mapping by a shared-pool task, so page faults and copies never land on
+   the frame. Tiles beyond the evict radius are dropped again
+ - Only resident tiles are handed to the sensors, the parking lot and the
+   renderers, so their cost is bounded by the load radius, not the world
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "MappedFile.hpp"
+#include "Scene.hpp"
+#include "SimTypes.hpp"
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief Writes the scene's obstacles, bays and spawns as a tiled world file.
+	 *
+	 * MISRA: tileSize must be strictly positive; returns false (and logs) otherwise.
+	 */
+	[[nodiscard]] bool saveChunkedWorld(const std::string& path, const Scene& scene, float tileSize);
+
+	class ChunkedWorld {
+	public:
+		ChunkedWorld() = default;
+		~ChunkedWorld(); // waits for tile loads still reading the mapping
+		ChunkedWorld(const ChunkedWorld&) = delete;
+		ChunkedWorld& operator=(const ChunkedWorld&) = delete;
+
+		/**
+		 * @brief Maps a world file and reads its tile index; no tile is loaded yet.
+		 */
+		[[nodiscard]] bool open(const std::string& path, float loadRadius, float evictRadius);
+
+		/**
+		 * @brief Collects finished tile loads, requests the tiles within the
+		 *        load radius of focus and evicts those beyond the evict radius.
+		 *
+		 * Never blocks. Returns true if the resident set changed, i.e. the
+		 * obstacles() and bays() arrays were rebuilt.
+		 */
+		[[nodiscard]] bool update(const sf::Vector2f& focus);
+
+		/**
+		 * @brief Blocks until every requested tile has been loaded.
+		 */
+		void wait();
+
+		[[nodiscard]] const std::vector<Obstacle>& obstacles() const noexcept { return m_obstacles; }
+		[[nodiscard]] const std::vector<sf::FloatRect>& bays() const noexcept { return m_bays; }
+		[[nodiscard]] const std::vector<CarState>& spawns() const noexcept { return m_spawns; }
+		[[nodiscard]] std::size_t residentTileCount() const noexcept { return m_resident.size(); }
+		[[nodiscard]] std::size_t pendingTileCount() const noexcept { return m_pending.size(); }
+		[[nodiscard]] std::size_t tileCount() const noexcept { return m_tiles.size(); }
+
+		/**
+		 * @brief Area covered by the tile grid, resident or not.
+		 */
+		[[nodiscard]] sf::FloatRect bounds() const {
+			return { m_origin, sf::Vector2f{ static_cast<float>(m_tilesX), static_cast<float>(m_tilesY) } * m_tileSize };
+		}
+
+	private:
+		struct TileEntry {
+			std::uint32_t firstObstacle;
+			std::uint32_t obstacleCount;
+			std::uint32_t firstBay;
+			std::uint32_t bayCount;
+		};
+
+		struct TileData {
+			std::vector<Obstacle> obstacles;
+			std::vector<sf::FloatRect> bays;
+		};
+
+		// Filled by a pool task; on the heap so the map can rebalance under it
+		struct PendingTile {
+			TaskGroup group;
+			TileData data;
+		};
+
+		[[nodiscard]] float distanceToTile(std::uint32_t tile, const sf::Vector2f& point) const;
+		[[nodiscard]] TileData loadTile(std::uint32_t tile) const;
+		void rebuildResident();
+
+		assets::MappedFile m_file;
+		const unsigned char* m_fileObstacles = nullptr; // arrays inside the mapping
+		const unsigned char* m_fileBays = nullptr;
+		std::vector<TileEntry> m_tiles;
+		sf::Vector2f m_origin;
+		float m_tileSize = 1.0F;
+		std::uint32_t m_tilesX = 0U;
+		std::uint32_t m_tilesY = 0U;
+		float m_loadRadius = 0.0F;
+		float m_evictRadius = 0.0F;
+
+		std::vector<CarState> m_spawns;
+		std::map<std::uint32_t, TileData> m_resident; // ordered, so rebuilds are deterministic
+		std::map<std::uint32_t, std::unique_ptr<PendingTile>> m_pending;
+		std::vector<Obstacle> m_obstacles;            // all resident tiles, in tile order
+		std::vector<sf::FloatRect> m_bays;
+	};
+
+} // namespace sim
@@ -0,0 +1,363 @@
+#include "Collision.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "FastTrig.hpp"
+
+namespace sim {
+
+	namespace {
+
+		// Upper bound on cells per shape, as in ObstacleGrid
+		constexpr std::size_t MAX_CELLS_PER_SHAPE = 4U;
+
+		// Sub-steps per move are capped so a teleport cannot stall the tick;
+		// bisection then narrows the contact to 1/256 of a sub-step
+		constexpr std::uint32_t MAX_SUB_STEPS = 256U;
+		constexpr std::uint32_t BISECTION_STEPS = 8U;
+
+		// Car rectangle in world space: center, unit axes and half extent
+		struct CarBox {
+			sf::Vector2f center;
+			sf::Vector2f axisX;
+			sf::Vector2f axisY;
+			sf::Vector2f half;
+		};
+
+		[[nodiscard]] CarBox makeCarBox(const CarState& pose, const sf::Vector2f& halfExtent) {
+			const SinCos heading = sinCosDeg(pose.headingDeg);
+			return { pose.position, { heading.cos, heading.sin }, { -heading.sin, heading.cos }, halfExtent };
+		}
+
+		[[nodiscard]] bool hitsCircle(const CarBox& car, const Obstacle& circle) {
+			const sf::Vector2f d = circle.center - car.center;
+			const sf::Vector2f local{ d.dot(car.axisX), d.dot(car.axisY) };
+			const sf::Vector2f closest{ std::clamp(local.x, -car.half.x, car.half.x),
+				std::clamp(local.y, -car.half.y, car.half.y) };
+			const sf::Vector2f gap = local - closest;
+			return gap.dot(gap) < circle.radius * circle.radius;
+		}
+
+		// Separating axes: the two world axes and the two car axes
+		[[nodiscard]] bool hitsBox(const CarBox& car, const sf::FloatRect& box) {
+			const sf::Vector2f boxHalf = box.size / 2.0F;
+			const sf::Vector2f d = box.position + boxHalf - car.center;
+
+			const float carOnX = std::fabs(car.axisX.x) * car.half.x + std::fabs(car.axisY.x) * car.half.y;
+			const float carOnY = std::fabs(car.axisX.y) * car.half.x + std::fabs(car.axisY.y) * car.half.y;
+			if (std::fabs(d.x) >= boxHalf.x + carOnX || std::fabs(d.y) >= boxHalf.y + carOnY) {
+				return false;
+			}
+
+			const float boxOnAxisX = std::fabs(car.axisX.x) * boxHalf.x + std::fabs(car.axisX.y) * boxHalf.y;
+			const float boxOnAxisY = std::fabs(car.axisY.x) * boxHalf.x + std::fabs(car.axisY.y) * boxHalf.y;
+			return std::fabs(d.dot(car.axisX)) < car.half.x + boxOnAxisX
+				&& std::fabs(d.dot(car.axisY)) < car.half.y + boxOnAxisY;
+		}
+
+		// The same tests in the car frame against the hull
+		[[nodiscard]] bool hullHitsWorldCircle(const CarBox& car, const CarHull& hull, const Obstacle& circle) noexcept {
+			const sf::Vector2f d = circle.center - car.center;
+			return hullHitsCircle(hull, { d.dot(car.axisX), d.dot(car.axisY) }, circle.radius);
+		}
+
+		[[nodiscard]] bool hullHitsWorldBox(const CarBox& car, const CarHull& hull, const sf::FloatRect& box) noexcept {
+			const sf::Vector2f boxHalf = box.size / 2.0F;
+			const sf::Vector2f d = box.position + boxHalf - car.center;
+			return hullHitsBox(hull, { d.dot(car.axisX), d.dot(car.axisY) }, { car.axisX.x, car.axisY.x },
+				{ car.axisX.y, car.axisY.y }, boxHalf);
+		}
+
+		// Half extent of a box around the car frame's origin holding the hull: merged
+		// hull edges may reach slightly past the sprite rectangle
+		[[nodiscard]] sf::Vector2f reachExtent(const sf::Vector2f& halfExtent, const CarHull* hull) noexcept {
+			if (hull == nullptr || hull->empty()) {
+				return halfExtent;
+			}
+			return { std::max({ halfExtent.x, -hull->low.x, hull->high.x }),
+				std::max({ halfExtent.y, -hull->low.y, hull->high.y }) };
+		}
+
+		[[nodiscard]] sf::FloatRect circleBounds(const Obstacle& circle) {
+			const sf::Vector2f half{ circle.radius, circle.radius };
+			return { circle.center - half, half * 2.0F };
+		}
+
+		[[nodiscard]] float shortestArcDeg(float fromDeg, float toDeg) {
+			float deltaDeg = std::fmod(toDeg - fromDeg, 360.0F);
+			if (deltaDeg > 180.0F) { deltaDeg -= 360.0F; }
+			if (deltaDeg < -180.0F) { deltaDeg += 360.0F; }
+			return deltaDeg;
+		}
+	}
+
+	void CollisionWorld::build(const std::vector<Obstacle>& circles, const std::vector<sf::FloatRect>& boxes, float cellSize) {
+		m_circles = circles;
+		m_boxes = boxes;
+		m_cellStart.clear();
+		m_cellShapes.clear();
+		m_loose.clear();
+		m_cols = 0;
+		m_rows = 0;
+
+		std::vector<sf::FloatRect> bounds;
+		bounds.reserve(circles.size() + boxes.size());
+		m_smallestFeature = std::numeric_limits<float>::max();
+		for (const auto& circle : circles) {
+			bounds.push_back(circleBounds(circle));
+			m_smallestFeature = std::min(m_smallestFeature, circle.radius);
+		}
+		for (const auto& box : boxes) {
+			bounds.push_back(box);
+			m_smallestFeature = std::min({ m_smallestFeature, box.size.x / 2.0F, box.size.y / 2.0F });
+		}
+
+		if (bounds.empty()) {
+			return;
+		}
+
+		sf::Vector2f minP = bounds.front().position;
+		sf::Vector2f maxP = bounds.front().position + bounds.front().size;
+		for (const auto& b : bounds) {
+			minP.x = std::min(minP.x, b.position.x);
+			minP.y = std::min(minP.y, b.position.y);
+			maxP.x = std::max(maxP.x, b.position.x + b.size.x);
+			maxP.y = std::max(maxP.y, b.position.y + b.size.y);
+		}
+
+		const float extent = std::max({ maxP.x - minP.x, maxP.y - minP.y, 1.0F });
+		m_cellSize = (cellSize > 0.0F) ? cellSize : extent;
+
+		const std::size_t maxCells = bounds.size() * MAX_CELLS_PER_SHAPE;
+		for (;;) {
+			m_cols = static_cast<int>((maxP.x - minP.x) / m_cellSize) + 1;
+			m_rows = static_cast<int>((maxP.y - minP.y) / m_cellSize) + 1;
+			if (static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows) <= maxCells) {
+				break;
+			}
+			m_cellSize *= 2.0F;
+		}
+		m_origin = minP;
+
+		// Two-pass counting sort: count shapes per cell, then scatter the references
+		const std::size_t cellCount = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+		m_cellStart.assign(cellCount + 1U, 0U);
+		const auto cellRange = [&](const sf::FloatRect& b, int& x0, int& y0, int& x1, int& y1) {
+			x0 = std::clamp(static_cast<int>((b.position.x - m_origin.x) / m_cellSize), 0, m_cols - 1);
+			y0 = std::clamp(static_cast<int>((b.position.y - m_origin.y) / m_cellSize), 0, m_rows - 1);
+			x1 = std::clamp(static_cast<int>((b.position.x + b.size.x - m_origin.x) / m_cellSize), 0, m_cols - 1);
+			y1 = std::clamp(static_cast<int>((b.position.y + b.size.y - m_origin.y) / m_cellSize), 0, m_rows - 1);
+		};
+		int x0 = 0;
+		int y0 = 0;
+		int x1 = 0;
+		int y1 = 0;
+		for (const auto& b : bounds) {
+			cellRange(b, x0, y0, x1, y1);
+			for (int y = y0; y <= y1; ++y) {
+				for (int x = x0; x <= x1; ++x) {
+					++m_cellStart[static_cast<std::size_t>(y * m_cols + x) + 1U];
+				}
+			}
+		}
+		for (std::size_t c = 0U; c < cellCount; ++c) {
+			m_cellStart[c + 1U] += m_cellStart[c];
+		}
+
+		std::vector<std::uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+		m_cellShapes.resize(m_cellStart.back());
+		for (std::size_t i = 0U; i < bounds.size(); ++i) {
+			const std::uint32_t shape = (i < circles.size())
+				? static_cast<std::uint32_t>(i)
+				: (static_cast<std::uint32_t>(i - circles.size()) | BOX_BIT);
+			cellRange(bounds[i], x0, y0, x1, y1);
+			for (int y = y0; y <= y1; ++y) {
+				for (int x = x0; x <= x1; ++x) {
+					m_cellShapes[cursor[static_cast<std::size_t>(y * m_cols + x)]++] = shape;
+				}
+			}
+		}
+	}
+
+	bool CollisionWorld::setCircle(std::uint32_t index, const Obstacle& circle) {
+		if (m_cellStart.empty() || index > m_circles.size()
+			|| (m_loose.size() >= MAX_LOOSE_CIRCLES && std::find(m_loose.begin(), m_loose.end(), index) == m_loose.end()))
+		{
+			return false;
+		}
+		if (index == m_circles.size()) {
+			m_circles.push_back(circle);
+		}
+		else {
+			m_circles[index] = circle;
+		}
+		if (std::find(m_loose.begin(), m_loose.end(), index) == m_loose.end()) {
+			m_loose.push_back(index);
+		}
+		m_smallestFeature = std::min(m_smallestFeature, circle.radius);
+		return true;
+	}
+
+	ArenaSpan<std::uint32_t> CollisionWorld::gatherCandidates(const sf::FloatRect& area, FrameArena& scratch) const {
+		if (m_cellStart.empty()) {
+			return {};
+		}
+
+		// Clamp in float first so far-away areas cannot overflow the int conversion
+		const auto toCell = [this](float offset, int count) {
+			const float cell = std::floor(offset / m_cellSize);
+			return static_cast<int>(std::clamp(cell, -1.0F, static_cast<float>(count)));
+		};
+		const int x0 = std::max(toCell(area.position.x - m_origin.x, m_cols), 0);
+		const int y0 = std::max(toCell(area.position.y - m_origin.y, m_rows), 0);
+		const int x1 = std::min(toCell(area.position.x + area.size.x - m_origin.x, m_cols), m_cols - 1);
+		const int y1 = std::min(toCell(area.position.y + area.size.y - m_origin.y, m_rows), m_rows - 1);
+
+		// Sized by a first pass over the cell ranges, then filled with no growth
+		const auto cellIndex = [this](int x, int y) {
+			return static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(x);
+		};
+		std::size_t count = 0U;
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				const std::size_t cell = cellIndex(x, y);
+				count += m_cellStart[cell + 1U] - m_cellStart[cell];
+			}
+		}
+
+		ArenaSpan<std::uint32_t> candidates = scratch.allocate<std::uint32_t>(count + m_loose.size());
+		std::uint32_t* out = candidates.data;
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				const std::size_t cell = cellIndex(x, y);
+				out = std::copy(m_cellShapes.begin() + m_cellStart[cell], m_cellShapes.begin() + m_cellStart[cell + 1U], out);
+			}
+		}
+		// Edited circles wherever they are now; the cells may name them too
+		for (const std::uint32_t circle : m_loose) {
+			if (circleBounds(m_circles[circle]).findIntersection(area)) {
+				*out++ = circle;
+			}
+		}
+		candidates.size = static_cast<std::size_t>(out - candidates.data);
+
+		// Shapes spanning several cells are listed once
+		std::sort(candidates.begin(), candidates.end());
+		candidates.size = static_cast<std::size_t>(std::unique(candidates.begin(), candidates.end()) - candidates.begin());
+		return candidates;
+	}
+
+	bool CollisionWorld::overlapsAny(const CarState& pose, const sf::Vector2f& halfExtent,
+		const ArenaSpan<std::uint32_t>& candidates, const CarHull* hull) const
+	{
+		const CarBox car = makeCarBox(pose, halfExtent);
+		if (hull != nullptr && !hull->empty()) {
+			for (const std::uint32_t shape : candidates) {
+				const bool hit = ((shape & BOX_BIT) != 0U)
+					? hullHitsWorldBox(car, *hull, m_boxes[shape & ~BOX_BIT])
+					: hullHitsWorldCircle(car, *hull, m_circles[shape]);
+				if (hit) {
+					return true;
+				}
+			}
+			return false;
+		}
+		for (const std::uint32_t shape : candidates) {
+			const bool hit = ((shape & BOX_BIT) != 0U)
+				? hitsBox(car, m_boxes[shape & ~BOX_BIT])
+				: hitsCircle(car, m_circles[shape]);
+			if (hit) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool CollisionWorld::overlaps(const CarState& pose, const sf::Vector2f& halfExtent, FrameArena& scratch,
+		const CarHull* hull) const
+	{
+		const ArenaMark mark(scratch);
+		return overlapsAny(pose, halfExtent, gatherCandidates(carBounds(pose, reachExtent(halfExtent, hull)), scratch), hull);
+	}
+
+	CarState CollisionWorld::sweep(const CarState& from, const CarState& to, const sf::Vector2f& halfExtent,
+		FrameArena& scratch, const CarHull* hull) const
+	{
+		if (empty()) {
+			return to;
+		}
+
+		// Every pose along the move lies within the car's circumradius of the
+		// straight path between the two centers
+		const sf::Vector2f extent = reachExtent(halfExtent, hull);
+		const float reach = std::sqrt(extent.dot(extent));
+		const sf::Vector2f lo{ std::min(from.position.x, to.position.x) - reach, std::min(from.position.y, to.position.y) - reach };
+		const sf::Vector2f hi{ std::max(from.position.x, to.position.x) + reach, std::max(from.position.y, to.position.y) + reach };
+
+		const ArenaMark mark(scratch);
+		const ArenaSpan<std::uint32_t> candidates = gatherCandidates({ lo, hi - lo }, scratch);
+		if (candidates.empty() || overlapsAny(from, halfExtent, candidates, hull)) {
+			return to;
+		}
+
+		// Longest distance any point of the car travels: translation plus the
+		// corner's arc; sub-steps stay below the thinnest thing it could skip
+		const sf::Vector2f travel = to.position - from.position;
+		const float turnRad = std::fabs(shortestArcDeg(from.headingDeg, to.headingDeg)) * constants::DEG_TO_RAD;
+		const float motion = std::sqrt(travel.dot(travel)) + turnRad * reach;
+		const sf::Vector2f thinnest = (hull != nullptr && !hull->empty()) ? (hull->high - hull->low) * 0.5F : halfExtent;
+		const float maxStep = std::max(std::min({ m_smallestFeature, thinnest.x, thinnest.y }), 1.0F);
+		const auto subSteps = static_cast<std::uint32_t>(std::clamp(std::ceil(motion / maxStep), 1.0F,
+			static_cast<float>(MAX_SUB_STEPS)));
+
+		float freeT = 0.0F;
+		for (std::uint32_t i = 1U; i <= subSteps; ++i) {
+			const float t = static_cast<float>(i) / static_cast<float>(subSteps);
+			if (!overlapsAny(interpolate(from, to, t), halfExtent, candidates, hull)) {
+				freeT = t;
+				continue;
+			}
+
+			// Contact between freeT and t: narrow it down, keeping the free side
+			float hitT = t;
+			for (std::uint32_t b = 0U; b < BISECTION_STEPS; ++b) {
+				const float mid = (freeT + hitT) / 2.0F;
+				if (overlapsAny(interpolate(from, to, mid), halfExtent, candidates, hull)) {
+					hitT = mid;
+				}
+				else {
+					freeT = mid;
+				}
+			}
+			return interpolate(from, to, freeT);
+		}
+		return to;
+	}
+
+	bool stepCarWithCollisions(CarState& car, CarInput input, const CarParams& params, float dt,
+		const CollisionWorld& world, const sf::Vector2f& halfExtent, FrameArena& scratch, const CarHull* hull)
+	{
+		const CarState from = car;
+		CarState to = car;
+		stepCar(to, input, params, dt);
+		car = world.sweep(from, to, halfExtent, scratch, hull);
+		return car.position != to.position || car.headingDeg != to.headingDeg;
+	}
+
+	bool stepBicycleWithCollisions(BicycleState& state, CarInput input, const BicycleParams& params, float dt,
+		const CollisionWorld& world, const sf::Vector2f& halfExtent, FrameArena& scratch, const CarHull* hull)
+	{
+		const CarState from = state.pose;
+		stepBicycle(state, input, params, dt);
+		const CarState to = state.pose;
+		state.pose = world.sweep(from, to, halfExtent, scratch, hull);
+		if (state.pose.position != to.position || state.pose.headingDeg != to.headingDeg) {
+			state.speed = 0.0F;
+			return true;
+		}
+		return false;
+	}
+
+} // namespace sim
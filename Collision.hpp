@@ -0,0 +1,116 @@
+/*
+==============================================================================
+Collision - oriented car box against static circles and boxes
+==============================================================================
+ - Broad phase: a uniform grid over the shape bounds (CSR layout, as in the
+   ray caster); a move only tests the shapes in the cells its swept bounds
+   touch, so the cost does not grow with the size of the lot
+ - Narrow phase: exact oriented box vs circle (closest point in the car
+   frame) and oriented box vs axis-aligned box (separating axes); given
+   the car's alpha hull (CarHull.hpp) the shapes are moved into the car
+   frame and tested against the hull instead, so the sprite's transparent
+   margins no longer collide
+ - Continuous: a move is checked at sub-steps no longer than the smallest
+   feature it could skip over, then the contact is refined by bisection, so
+   a fast car or a long tick cannot tunnel through a pillar
+ - A blocked car stops at its last free pose along the move; a car that
+   starts overlapping (e.g. spawned inside a pillar) is let out freely
+ - An edited circle (setCircle()) is kept on a short loose list that every
+   query tests beside its cells, until the next build(); the cells it left
+   still name it, which only adds a candidate that misses
+ - Queries only read the world, so fleet threads can share one instance;
+   their candidate lists go to the caller's FrameArena and are rewound
+   before the query returns
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "CarHull.hpp"
+#include "CarModel.hpp"
+#include "FrameArena.hpp"
+#include "SimTypes.hpp"
+#include "VehicleDynamics.hpp"
+
+namespace sim {
+
+	class CollisionWorld {
+	public:
+		/**
+		 * @brief Rebuilds the broad-phase grid from static circles and boxes.
+		 *
+		 * MISRA: cellSize must be strictly positive; non-positive values fall
+		 *        back to a single cell covering all shapes.
+		 */
+		void build(const std::vector<Obstacle>& circles, const std::vector<sf::FloatRect>& boxes, float cellSize);
+
+		/**
+		 * @brief Replaces circle index, or adds one if index is the circle count, without a rebuild.
+		 *
+		 * Returns false and changes nothing if the world has no cells yet or
+		 * MAX_LOOSE_CIRCLES were edited since build(); the caller rebuilds then.
+		 */
+		bool setCircle(std::uint32_t index, const Obstacle& circle);
+
+		/**
+		 * @brief True if the car rectangle (or hull, if given and not empty) at pose overlaps any shape (touching is not a hit).
+		 */
+		[[nodiscard]] bool overlaps(const CarState& pose, const sf::Vector2f& halfExtent, FrameArena& scratch,
+			const CarHull* hull = nullptr) const;
+
+		/**
+		 * @brief Moves the car from one pose towards another, stopping at the first contact.
+		 *
+		 * Returns to if the way is clear, otherwise the last pose along the
+		 * move (position and heading blended together) that is still free.
+		 */
+		[[nodiscard]] CarState sweep(const CarState& from, const CarState& to, const sf::Vector2f& halfExtent,
+			FrameArena& scratch, const CarHull* hull = nullptr) const;
+
+		[[nodiscard]] bool empty() const noexcept { return m_circles.empty() && m_boxes.empty(); }
+
+	private:
+		// Shape reference stored per cell: top bit set for boxes
+		static constexpr std::uint32_t BOX_BIT = 0x80000000U;
+		static constexpr std::size_t MAX_LOOSE_CIRCLES = 64U;
+
+		// Shape references in the cells area touches, each listed once
+		[[nodiscard]] ArenaSpan<std::uint32_t> gatherCandidates(const sf::FloatRect& area, FrameArena& scratch) const;
+		[[nodiscard]] bool overlapsAny(const CarState& pose, const sf::Vector2f& halfExtent,
+			const ArenaSpan<std::uint32_t>& candidates, const CarHull* hull) const;
+
+		std::vector<Obstacle> m_circles;
+		std::vector<sf::FloatRect> m_boxes;
+		float m_smallestFeature = 0.0F; // smallest circle radius or box half side
+
+		sf::Vector2f m_origin{ 0.0F, 0.0F };
+		float m_cellSize = 1.0F;
+		int m_cols = 0;
+		int m_rows = 0;
+
+		std::vector<std::uint32_t> m_cellStart; // m_cols * m_rows + 1 offsets into m_cellShapes
+		std::vector<std::uint32_t> m_cellShapes;
+		std::vector<std::uint32_t> m_loose; // circles edited since build(), in no cell of their own
+	};
+
+	/**
+	 * @brief stepCar() followed by a sweep from the old pose to the new one.
+	 *
+	 * Returns true if an obstacle stopped the car short of where it was going.
+	 */
+	bool stepCarWithCollisions(CarState& car, CarInput input, const CarParams& params, float dt,
+		const CollisionWorld& world, const sf::Vector2f& halfExtent, FrameArena& scratch, const CarHull* hull = nullptr);
+
+	/**
+	 * @brief stepBicycle() followed by the same sweep; a blocked car loses its speed.
+	 */
+	bool stepBicycleWithCollisions(BicycleState& state, CarInput input, const BicycleParams& params, float dt,
+		const CollisionWorld& world, const sf::Vector2f& halfExtent, FrameArena& scratch, const CarHull* hull = nullptr);
+
+} // namespace sim
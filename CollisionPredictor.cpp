@@ -0,0 +1,172 @@
+#include "CollisionPredictor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CarModel.hpp"
+#include "DeterministicMath.hpp"
+#include "FastTrig.hpp"
+#include "ObstacleGrid.hpp"
+#include "SimTypes.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	namespace {
+		[[nodiscard]] sf::Vector2f rotateBy(const sf::Vector2f& v, const SinCos& sc) noexcept {
+			return { v.x * sc.cos - v.y * sc.sin, v.x * sc.sin + v.y * sc.cos };
+		}
+
+		[[nodiscard]] float wrapDegrees(float deg) noexcept {
+			deg = std::fmod(deg, 360.0F);
+			if (deg > 180.0F) { deg -= 360.0F; }
+			if (deg < -180.0F) { deg += 360.0F; }
+			return deg;
+		}
+
+		// Fraction of the step a -> b at which the point enters the circle, or a value > 1 if it stays out
+		[[nodiscard]] float sweptPointCircle(const sf::Vector2f& a, const sf::Vector2f& b, const Obstacle& obstacle) noexcept {
+			const sf::Vector2f f = a - obstacle.center;
+			const float c = f.x * f.x + f.y * f.y - obstacle.radius * obstacle.radius;
+			if (c <= 0.0F) {
+				return 0.0F;
+			}
+			const sf::Vector2f e = b - a;
+			const float qa = e.x * e.x + e.y * e.y;
+			const float qb = f.x * e.x + f.y * e.y;
+			if (qa <= 0.0F || qb >= 0.0F) { // standing still or moving away
+				return 2.0F;
+			}
+			const float disc = qb * qb - qa * c;
+			if (disc < 0.0F) {
+				return 2.0F;
+			}
+			return (-qb - std::sqrt(disc)) / qa;
+		}
+	}
+
+	CollisionPredictor::CollisionPredictor(const CollisionPredictorConfig& config)
+		: m_config(config)
+	{
+		m_config.steps = std::max(m_config.steps, 1U);
+		m_config.horizon = std::max(m_config.horizon, 0.0F);
+	}
+
+	void CollisionPredictor::gather(const sf::Vector2f& center, float reach, const std::vector<Obstacle>& obstacles,
+		const ObstacleGrid& grid)
+	{
+		if (m_stale) {
+			m_maxRadius = 0.0F;
+			for (const auto& obstacle : obstacles) {
+				m_maxRadius = std::max(m_maxRadius, obstacle.radius);
+			}
+			m_stale = false;
+		}
+
+		// The grid indexes centres, so the circle also covers the widest obstacle
+		m_gatherCenter = center;
+		m_gatherRadius = reach + m_config.gatherSlack;
+		m_candidates.clear();
+		grid.gather(center, m_gatherRadius + m_maxRadius, m_candidates);
+	}
+
+	void CollisionPredictor::predict(const CarState& previous, const CarState& current, float dt,
+		const std::vector<SensorMount>& mounts, const std::vector<Obstacle>& obstacles, const ObstacleGrid& grid,
+		std::vector<float>& timeToCollision)
+	{
+		timeToCollision.assign(mounts.size(), NO_COLLISION);
+		if (!(dt > 0.0F) || mounts.empty()) {
+			return;
+		}
+
+		// The arcade step moves along the heading it starts from, then turns
+		const sf::Vector2f displacement = current.position - previous.position;
+		const sf::Vector2f velocity = rotateBy(displacement, sinCosDeg(-previous.headingDeg)) / dt; // body frame
+		const float yawRate = wrapDegrees(current.headingDeg - previous.headingDeg) / dt;
+		const float speed = dmath::hypot(velocity.x, velocity.y);
+		if (speed < m_config.standingSpeed && std::fabs(yawRate) < m_config.standingSpeed) {
+			return;
+		}
+
+		float mountReach = 0.0F;
+		for (const auto& mount : mounts) {
+			mountReach = std::max(mountReach, dmath::hypot(mount.offset.x, mount.offset.y));
+		}
+		const float reach = mountReach + speed * m_config.horizon;
+
+		const sf::Vector2f drift = current.position - m_gatherCenter;
+		if (m_stale || dmath::hypot(drift.x, drift.y) + reach > m_gatherRadius) {
+			gather(current.position, reach, obstacles, grid);
+		}
+		if (m_candidates.empty()) {
+			return;
+		}
+
+		// Car poses along the arc, each step advanced along its mid-step heading
+		const std::uint32_t steps = m_config.steps;
+		const float stepDt = m_config.horizon / static_cast<float>(steps);
+		m_path.resize(steps + 1U);
+		m_turns.resize(steps + 1U);
+		m_path[0] = current.position;
+		m_turns[0] = sinCosDeg(current.headingDeg);
+		for (std::uint32_t k = 0U; k < steps; ++k) {
+			const float startDeg = current.headingDeg + yawRate * stepDt * static_cast<float>(k);
+			m_path[k + 1U] = m_path[k] + rotateBy(velocity, sinCosDeg(startDeg + yawRate * stepDt * 0.5F)) * stepDt;
+			m_turns[k + 1U] = sinCosDeg(startDeg + yawRate * stepDt);
+		}
+
+		// Only candidates that reach the box around every predicted sensor point are swept
+		sf::Vector2f low = m_path[0];
+		sf::Vector2f high = m_path[0];
+		for (std::uint32_t k = 0U; k <= steps; ++k) {
+			low.x = std::min(low.x, m_path[k].x);
+			low.y = std::min(low.y, m_path[k].y);
+			high.x = std::max(high.x, m_path[k].x);
+			high.y = std::max(high.y, m_path[k].y);
+		}
+		const sf::Vector2f pad{ mountReach + m_maxRadius, mountReach + m_maxRadius };
+		low -= pad;
+		high += pad;
+		m_nearby.clear();
+		for (const std::uint32_t candidate : m_candidates) {
+			const sf::Vector2f& center = obstacles[candidate].center;
+			if (center.x >= low.x && center.x <= high.x && center.y >= low.y && center.y <= high.y) {
+				m_nearby.push_back(candidate);
+			}
+		}
+		if (m_nearby.empty()) {
+			return;
+		}
+
+		for (std::size_t i = 0U; i < mounts.size(); ++i) {
+			sf::Vector2f from = m_path[0] + rotateBy(mounts[i].offset, m_turns[0]);
+			for (std::uint32_t k = 0U; k < steps; ++k) {
+				const sf::Vector2f to = m_path[k + 1U] + rotateBy(mounts[i].offset, m_turns[k + 1U]);
+				float first = 2.0F;
+				for (const std::uint32_t candidate : m_nearby) {
+					first = std::min(first, sweptPointCircle(from, to, obstacles[candidate]));
+				}
+				if (first <= 1.0F) {
+					timeToCollision[i] = (static_cast<float>(k) + first) * stepDt;
+					break;
+				}
+				from = to;
+			}
+		}
+	}
+
+	float ttcInterval(const std::vector<TtcBand>& bands, float timeToCollision) noexcept {
+		float interval = 0.0F;
+		for (const auto& band : bands) {
+			if (timeToCollision <= band.maxSeconds) {
+				interval = moreUrgent(interval, band.interval);
+			}
+		}
+		return interval;
+	}
+
+	std::vector<TtcBand> defaultTtcBands() {
+		return { { 0.5F, 0.1F }, { 1.0F, 0.25F }, { 2.0F, 0.5F } };
+	}
+
+} // namespace sim
@@ -0,0 +1,100 @@
+/*
+==============================================================================
+Collision Predictor - time to collision of every sensor from the car motion
+==============================================================================
+ - The last tick's displacement and turn give a body-frame velocity and a
+   yaw rate; held constant, they extrapolate the car along an arc over a
+   short horizon, split into a few straight steps
+ - Each sensor anchor sweeps along its own path; every step is a swept-point
+   vs. obstacle-circle test solved in closed form, and the first step that
+   hits ends the search, so TTC costs a handful of quadratics per candidate
+ - Candidates are gathered from the obstacle grid into a circle around the
+   car with some slack; they are reused until the car or its reach leaves
+   that circle, and a standing car skips the pass altogether. Each tick only
+   the candidates inside the box around the predicted path are swept
+ - Beep urgency follows TTC bands (seconds instead of distance), combined
+   with the distance profile through moreUrgent()
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "FastTrig.hpp"
+#include "SimFwd.hpp"
+
+namespace sim {
+
+	// Time to collision of a sensor that is not heading into anything
+	constexpr float NO_COLLISION = std::numeric_limits<float>::max();
+
+	struct CollisionPredictorConfig {
+		float horizon = 2.0F;         // seconds looked ahead
+		std::uint32_t steps = 8U;     // straight steps the predicted arc is split into
+		float gatherSlack = 96.0F;    // px the car may move before candidates are gathered again
+		float standingSpeed = 1.0F;   // px/s (and deg/s) below which the car counts as standing
+	};
+
+	// Beep every interval seconds once a collision is predicted within maxSeconds
+	struct TtcBand {
+		float maxSeconds = 0.0F;
+		float interval = 0.0F;
+	};
+
+	class CollisionPredictor {
+	public:
+		explicit CollisionPredictor(const CollisionPredictorConfig& config = {});
+
+		/**
+		 * @brief Time to collision per mount, extrapolating the tick from previous to current.
+		 *
+		 * grid must be built from the centres of obstacles (same order).
+		 * Sensors that stay clear over the horizon get NO_COLLISION, one
+		 * already inside an obstacle gets 0.
+		 * MISRA: dt must be strictly positive; otherwise every sensor gets NO_COLLISION.
+		 */
+		void predict(const CarState& previous, const CarState& current, float dt,
+			const std::vector<SensorMount>& mounts, const std::vector<Obstacle>& obstacles, const ObstacleGrid& grid,
+			std::vector<float>& timeToCollision);
+
+		/**
+		 * @brief Drops the gathered candidates (call whenever the obstacles are rebuilt).
+		 */
+		void invalidate() noexcept { m_stale = true; }
+
+		[[nodiscard]] const CollisionPredictorConfig& config() const noexcept { return m_config; }
+		[[nodiscard]] std::size_t candidateCount() const noexcept { return m_candidates.size(); }
+
+	private:
+		void gather(const sf::Vector2f& center, float reach, const std::vector<Obstacle>& obstacles,
+			const ObstacleGrid& grid);
+
+		CollisionPredictorConfig m_config;
+
+		bool m_stale = true;
+		float m_maxRadius = 0.0F;            // largest obstacle radius, refreshed after invalidate()
+		sf::Vector2f m_gatherCenter{ 0.0F, 0.0F };
+		float m_gatherRadius = 0.0F;
+		std::vector<std::uint32_t> m_candidates;
+		std::vector<std::uint32_t> m_nearby; // candidates near this tick's predicted path
+		std::vector<sf::Vector2f> m_path;    // steps + 1 predicted car positions
+		std::vector<SinCos> m_turns;         // and their headings
+	};
+
+	/**
+	 * @brief Beep interval for a time to collision (0 = silent); bands in any order.
+	 */
+	[[nodiscard]] float ttcInterval(const std::vector<TtcBand>& bands, float timeToCollision) noexcept;
+
+	/**
+	 * @brief 0.1 s within half a second of impact, 0.25 s within one and 0.5 s within two.
+	 */
+	[[nodiscard]] std::vector<TtcBand> defaultTtcBands();
+
+} // namespace sim
@@ -0,0 +1,289 @@
+#include "CompressedTexture.hpp"
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/OpenGL.hpp>
+#include <SFML/System/FileInputStream.hpp>
+#include <SFML/System/MemoryInputStream.hpp>
+#include <SFML/Window/Context.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace gfx {
+
+	namespace {
+		// Bumped whenever the file layout changes
+		constexpr char FILE_MAGIC[8] = { 'O', 'K', 'T', 'X', '0', '0', '0', '1' };
+		constexpr std::uint32_t MAX_LEVELS = 16U;
+		constexpr std::uint32_t MAX_DIMENSION = 16384U;
+
+		// S3TC enumerants (EXT_texture_compression_s3tc), not in the 1.1 headers
+		constexpr GLenum COMPRESSED_RGB_S3TC_DXT1 = 0x83F0U;
+		constexpr GLenum COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3U;
+		constexpr GLenum TEXTURE_MAX_LEVEL = 0x813DU; // OpenGL 1.2
+
+		// GL 1.3 entry point; resolved on its own so the sprite path does not
+		// depend on the shader/instancing functions in GlFunctions.hpp
+		using CompressedTexImage2DFn = void (APIENTRY*)(GLenum target, GLint level, GLenum internalFormat,
+			GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data);
+
+		using Rgba = std::array<std::uint8_t, 4>;
+
+		[[nodiscard]] Rgba unpack565(std::uint16_t color) {
+			const auto r = static_cast<std::uint8_t>((color >> 11U) & 0x1FU);
+			const auto g = static_cast<std::uint8_t>((color >> 5U) & 0x3FU);
+			const auto b = static_cast<std::uint8_t>(color & 0x1FU);
+			return { static_cast<std::uint8_t>((r << 3U) | (r >> 2U)),
+				static_cast<std::uint8_t>((g << 2U) | (g >> 4U)),
+				static_cast<std::uint8_t>((b << 3U) | (b >> 2U)), 255U };
+		}
+
+		[[nodiscard]] std::uint8_t mix(std::uint8_t a, std::uint8_t b, unsigned wa, unsigned wb, unsigned total) {
+			return static_cast<std::uint8_t>((a * wa + b * wb) / total);
+		}
+
+		// Colors of one BC1 block; BC3 color blocks always use the four-color mode
+		void decodeColorBlock(const std::uint8_t* block, bool allowPunchThrough, Rgba* out) {
+			const auto c0 = static_cast<std::uint16_t>(block[0] | (block[1] << 8U));
+			const auto c1 = static_cast<std::uint16_t>(block[2] | (block[3] << 8U));
+			std::array<Rgba, 4> palette{ unpack565(c0), unpack565(c1), Rgba{}, Rgba{} };
+			const bool fourColor = !allowPunchThrough || c0 > c1;
+			for (std::size_t ch = 0U; ch < 3U; ++ch) {
+				if (fourColor) {
+					palette[2][ch] = mix(palette[0][ch], palette[1][ch], 2U, 1U, 3U);
+					palette[3][ch] = mix(palette[0][ch], palette[1][ch], 1U, 2U, 3U);
+				}
+				else {
+					palette[2][ch] = mix(palette[0][ch], palette[1][ch], 1U, 1U, 2U);
+				}
+			}
+			palette[2][3] = 255U;
+			palette[3][3] = fourColor ? 255U : 0U; // three-color mode: index 3 is transparent black
+
+			for (std::size_t i = 0U; i < 16U; ++i) {
+				const unsigned index = (block[4U + i / 4U] >> (2U * (i % 4U))) & 0x3U;
+				out[i] = palette[index];
+			}
+		}
+
+		void decodeAlphaBlock(const std::uint8_t* block, Rgba* out) {
+			const unsigned a0 = block[0];
+			const unsigned a1 = block[1];
+			std::array<std::uint8_t, 8> palette{ static_cast<std::uint8_t>(a0), static_cast<std::uint8_t>(a1) };
+			if (a0 > a1) {
+				for (unsigned i = 2U; i < 8U; ++i) {
+					palette[i] = static_cast<std::uint8_t>(((8U - i) * a0 + (i - 1U) * a1) / 7U);
+				}
+			}
+			else {
+				for (unsigned i = 2U; i < 6U; ++i) {
+					palette[i] = static_cast<std::uint8_t>(((6U - i) * a0 + (i - 1U) * a1) / 5U);
+				}
+				palette[6] = 0U;
+				palette[7] = 255U;
+			}
+
+			std::uint64_t bits = 0U;
+			for (std::size_t i = 0U; i < 6U; ++i) {
+				bits |= static_cast<std::uint64_t>(block[2U + i]) << (8U * i);
+			}
+			for (std::size_t i = 0U; i < 16U; ++i) {
+				out[i][3] = palette[(bits >> (3U * i)) & 0x7U];
+			}
+		}
+
+		[[nodiscard]] sf::Vector2u blockCount(const sf::Vector2u& size) {
+			return { std::max(1U, (size.x + 3U) / 4U), std::max(1U, (size.y + 3U) / 4U) };
+		}
+
+		// Restores the 2D texture binding so SFML's render-state cache stays valid
+		class TextureBindingGuard {
+		public:
+			TextureBindingGuard() { glGetIntegerv(GL_TEXTURE_BINDING_2D, &m_previous); }
+			~TextureBindingGuard() { glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(m_previous)); }
+
+			TextureBindingGuard(const TextureBindingGuard&) = delete;
+			TextureBindingGuard& operator=(const TextureBindingGuard&) = delete;
+
+		private:
+			GLint m_previous = 0;
+		};
+
+		[[nodiscard]] bool readExact(sf::InputStream& stream, void* data, std::size_t size) {
+			return stream.read(data, size) == size;
+		}
+
+		// Files and pack entries share the parser; name only labels the errors
+		[[nodiscard]] bool readContainer(sf::InputStream& stream, const std::string& name, CompressedTexture& texture) {
+			char magic[sizeof(FILE_MAGIC)] = {};
+			std::uint32_t format = 0U;
+			std::uint32_t levelCount = 0U;
+			if (!readExact(stream, magic, sizeof(magic)) || !readExact(stream, &format, sizeof(format))
+				|| !readExact(stream, &levelCount, sizeof(levelCount))
+				|| std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0
+				|| (format != static_cast<std::uint32_t>(BlockFormat::Bc1) && format != static_cast<std::uint32_t>(BlockFormat::Bc3))
+				|| levelCount == 0U || levelCount > MAX_LEVELS) {
+				std::cerr << "Error: " << name << " is not a supported compressed texture\n";
+				return false;
+			}
+
+			CompressedTexture loaded;
+			loaded.format = static_cast<BlockFormat>(format);
+			loaded.levels.resize(levelCount);
+			for (auto& level : loaded.levels) {
+				if (!readExact(stream, &level.size.x, sizeof(level.size.x)) || !readExact(stream, &level.size.y, sizeof(level.size.y))
+					|| level.size.x == 0U || level.size.y == 0U
+					|| level.size.x > MAX_DIMENSION || level.size.y > MAX_DIMENSION) {
+					std::cerr << "Error: " << name << " has a corrupt level header\n";
+					return false;
+				}
+				level.blocks.resize(levelBytes(loaded.format, level.size));
+				if (!readExact(stream, level.blocks.data(), level.blocks.size())) {
+					std::cerr << "Error: " << name << " is truncated\n";
+					return false;
+				}
+			}
+
+			texture = std::move(loaded);
+			return true;
+		}
+
+		[[nodiscard]] bool uploadDecoded(const CompressedTexture& texture, sf::Texture& target) {
+			const std::vector<std::uint8_t> pixels = decodeLevel(texture, 0U);
+			if (!target.resize(texture.size())) {
+				return false;
+			}
+			target.update(pixels.data());
+			target.setSmooth(true);
+			(void)target.generateMipmap();
+			return true;
+		}
+	}
+
+	std::size_t blockBytes(BlockFormat format) noexcept {
+		return (format == BlockFormat::Bc1) ? 8U : 16U;
+	}
+
+	std::size_t levelBytes(BlockFormat format, const sf::Vector2u& size) noexcept {
+		const sf::Vector2u blocks = blockCount(size);
+		return static_cast<std::size_t>(blocks.x) * blocks.y * blockBytes(format);
+	}
+
+	std::size_t textureBytes(const CompressedTexture& texture) noexcept {
+		std::size_t bytes = 0U;
+		for (const CompressedLevel& level : texture.levels) {
+			bytes += levelBytes(texture.format, level.size);
+		}
+		return bytes;
+	}
+
+	bool saveCompressedTexture(const std::string& path, const CompressedTexture& texture) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+
+		const auto format = static_cast<std::uint32_t>(texture.format);
+		const auto levelCount = static_cast<std::uint32_t>(texture.levels.size());
+		file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+		file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+		file.write(reinterpret_cast<const char*>(&levelCount), sizeof(levelCount));
+		for (const auto& level : texture.levels) {
+			file.write(reinterpret_cast<const char*>(&level.size.x), sizeof(level.size.x));
+			file.write(reinterpret_cast<const char*>(&level.size.y), sizeof(level.size.y));
+			file.write(reinterpret_cast<const char*>(level.blocks.data()), static_cast<std::streamsize>(level.blocks.size()));
+		}
+		return static_cast<bool>(file);
+	}
+
+	bool loadCompressedTexture(const std::string& path, CompressedTexture& texture) {
+		sf::FileInputStream file;
+		if (!file.open(path)) {
+			std::cerr << "Error: Failed to open compressed texture " << path << '\n';
+			return false;
+		}
+		return readContainer(file, path, texture);
+	}
+
+	bool loadCompressedTexture(const void* data, std::size_t size, const std::string& name, CompressedTexture& texture) {
+		sf::MemoryInputStream stream(data, size);
+		return readContainer(stream, name, texture);
+	}
+
+	std::vector<std::uint8_t> decodeLevel(const CompressedTexture& texture, std::size_t level) {
+		if (level >= texture.levels.size()) {
+			return {};
+		}
+		const CompressedLevel& source = texture.levels[level];
+		const sf::Vector2u blocks = blockCount(source.size);
+		const std::size_t stride = blockBytes(texture.format);
+
+		std::vector<std::uint8_t> pixels(static_cast<std::size_t>(source.size.x) * source.size.y * 4U);
+		std::array<Rgba, 16> texels{};
+		for (unsigned by = 0U; by < blocks.y; ++by) {
+			for (unsigned bx = 0U; bx < blocks.x; ++bx) {
+				const std::uint8_t* block = &source.blocks[(static_cast<std::size_t>(by) * blocks.x + bx) * stride];
+				if (texture.format == BlockFormat::Bc3) {
+					decodeColorBlock(block + 8, false, texels.data());
+					decodeAlphaBlock(block, texels.data());
+				}
+				else {
+					decodeColorBlock(block, true, texels.data());
+				}
+
+				// Padding texels of partial edge blocks are dropped
+				for (unsigned i = 0U; i < 16U; ++i) {
+					const unsigned x = bx * 4U + i % 4U;
+					const unsigned y = by * 4U + i / 4U;
+					if (x < source.size.x && y < source.size.y) {
+						std::memcpy(&pixels[(static_cast<std::size_t>(y) * source.size.x + x) * 4U], texels[i].data(), 4U);
+					}
+				}
+			}
+		}
+		return pixels;
+	}
+
+	bool uploadCompressedTexture(const CompressedTexture& texture, sf::Texture& target) {
+		if (texture.empty()) {
+			return false;
+		}
+
+		const auto compressedTexImage2D = reinterpret_cast<CompressedTexImage2DFn>(
+			sf::Context::getFunction("glCompressedTexImage2D"));
+		if (compressedTexImage2D == nullptr || !sf::Context::isExtensionAvailable("GL_EXT_texture_compression_s3tc")) {
+			std::cerr << "Warning: S3TC textures unsupported, decoding on the CPU\n";
+			return uploadDecoded(texture, target);
+		}
+
+		// resize() gives the sf::Texture its GL name and size; the storage is then
+		// replaced level by level with the cooked blocks
+		if (!target.resize(texture.size())) {
+			return false;
+		}
+
+		const TextureBindingGuard guard;
+		(void)glGetError(); // only report errors raised by this upload
+		glBindTexture(GL_TEXTURE_2D, target.getNativeHandle());
+		const GLenum internalFormat = (texture.format == BlockFormat::Bc1) ? COMPRESSED_RGB_S3TC_DXT1 : COMPRESSED_RGBA_S3TC_DXT5;
+		for (std::size_t i = 0U; i < texture.levels.size(); ++i) {
+			const CompressedLevel& level = texture.levels[i];
+			compressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), internalFormat,
+				static_cast<GLsizei>(level.size.x), static_cast<GLsizei>(level.size.y), 0,
+				static_cast<GLsizei>(level.blocks.size()), level.blocks.data());
+		}
+		glTexParameteri(GL_TEXTURE_2D, TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.levels.size() - 1U));
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		if (glGetError() != GL_NO_ERROR) {
+			std::cerr << "Warning: compressed texture upload failed, decoding on the CPU\n";
+			return uploadDecoded(texture, target);
+		}
+		return true;
+	}
+
+} // namespace gfx
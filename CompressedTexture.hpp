@@ -0,0 +1,89 @@
+/*
+==============================================================================
+Compressed Texture - cooked, mipmapped, block-compressed sprite textures
+==============================================================================
+ - Container written by the texture cooker (--cook-texture) and loaded at
+   start-up instead of the PNG: no decode, and a quarter (BC3) or an eighth
+   (BC1) of the RGBA memory on the GPU
+ - Levels are stored from full size down to 1x1 in S3TC/BCn block layout
+ - Upload goes straight to the GPU when the driver supports S3TC; otherwise
+   the blocks are decoded on the CPU and uploaded as plain RGBA
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sf {
+	class Texture;
+}
+
+namespace gfx {
+
+	enum class BlockFormat : std::uint32_t {
+		Bc1 = 1U, // RGB, 8 bytes per 4x4 block (opaque sprites)
+		Bc3 = 3U  // RGBA, 16 bytes per 4x4 block (interpolated alpha)
+	};
+
+	struct CompressedLevel {
+		sf::Vector2u size;
+		std::vector<std::uint8_t> blocks; // row-major 4x4 blocks, edge blocks padded
+	};
+
+	struct CompressedTexture {
+		BlockFormat format = BlockFormat::Bc3;
+		std::vector<CompressedLevel> levels; // levels[0] is the full-size image
+
+		[[nodiscard]] bool empty() const noexcept { return levels.empty(); }
+		[[nodiscard]] sf::Vector2u size() const noexcept { return levels.empty() ? sf::Vector2u{} : levels.front().size; }
+	};
+
+	[[nodiscard]] std::size_t blockBytes(BlockFormat format) noexcept;
+
+	/**
+	 * @brief Byte size of one level's blocks (a partial edge block counts as a full one).
+	 */
+	[[nodiscard]] std::size_t levelBytes(BlockFormat format, const sf::Vector2u& size) noexcept;
+
+	/**
+	 * @brief Byte size of every level's blocks: what an S3TC upload occupies on the GPU.
+	 */
+	[[nodiscard]] std::size_t textureBytes(const CompressedTexture& texture) noexcept;
+
+	/**
+	 * @brief Writes the container; returns false on I/O failure.
+	 */
+	[[nodiscard]] bool saveCompressedTexture(const std::string& path, const CompressedTexture& texture);
+
+	/**
+	 * @brief Reads and validates the container; logs and returns false on failure.
+	 *
+	 * CPU only, so it may run on a loader thread.
+	 */
+	[[nodiscard]] bool loadCompressedTexture(const std::string& path, CompressedTexture& texture);
+
+	/**
+	 * @brief As above, for a container already in memory (an asset pack entry); name labels errors.
+	 */
+	[[nodiscard]] bool loadCompressedTexture(const void* data, std::size_t size, const std::string& name, CompressedTexture& texture);
+
+	/**
+	 * @brief Decodes one level back to tightly packed RGBA8.
+	 */
+	[[nodiscard]] std::vector<std::uint8_t> decodeLevel(const CompressedTexture& texture, std::size_t level);
+
+	/**
+	 * @brief Replaces the contents of target with every level of texture.
+	 *
+	 * Needs a current GL context. Without S3TC support the top level is
+	 * decoded on the CPU and uploaded as RGBA instead (with generated mipmaps).
+	 */
+	[[nodiscard]] bool uploadCompressedTexture(const CompressedTexture& texture, sf::Texture& target);
+
+} // namespace gfx
@@ -0,0 +1,96 @@
+/*
+==============================================================================
+Simulation Constants - tuning values shared by every front-end
+==============================================================================
+ - No SFML graphics or audio types here, so the headless runner can use it
+ - Front-end specific values (window size, colors) stay in main.cpp
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace constants {
+	// Angles (float literals, so no double round trip in the hot paths)
+	constexpr float PI = 3.14159265358979323846F;
+	constexpr float DEG_TO_RAD = PI / 180.0F;
+	constexpr float RAD_TO_DEG = 180.0F / PI;
+
+	// Parking sensor rectangle dimensions
+	constexpr float SENSOR_WIDTH = 30.0F;
+	constexpr float SENSOR_HEIGHT = 100.0F;
+
+	// Camera indicator footprint (rig sensors of kind camera)
+	constexpr float CAMERA_SENSOR_WIDTH = 24.0F;
+	constexpr float CAMERA_SENSOR_HEIGHT = 24.0F;
+
+	// World extent (the default scene fills one 1920x1080 window)
+	constexpr float WORLD_WIDTH = 1920.0F;
+	constexpr float WORLD_HEIGHT = 1080.0F;
+
+	// Parking bay in the top-right corner of the world
+	constexpr float PARK_WIDTH = 200.0F;
+	constexpr float PARK_HEIGHT = 350.0F;
+	constexpr float PARK_MARGIN = 10.0F;
+
+	// A parked car stays parked until it is this far outside its bay (anti-flicker)
+	constexpr float PARK_HYSTERESIS = 8.0F;
+
+	// Pillar (obstacle) radius
+	constexpr float OBSTACLE_RADIUS = 25.0F;
+
+	// Simulation and layout
+	constexpr float CAR_SPEED = 500.0F; // pixels per second
+	constexpr float CAR_TURN_RATE = 150.0F; // degrees per second (2.5 deg per frame at 60 FPS)
+
+	// Car sprite footprint: 960x480 texture drawn at 30% scale
+	constexpr float CAR_HALF_WIDTH = 144.0F;
+	constexpr float CAR_HALF_HEIGHT = 72.0F;
+
+	// Driver seat in the car frame: ahead of the center, on the left side (beep listener)
+	constexpr float DRIVER_SEAT_FORWARD = 24.0F;
+	constexpr float DRIVER_SEAT_LEFT = 32.0F;
+
+	// Fixed-step simulation: default tick rate and the longest frame we catch up on
+	constexpr float SIM_TICK_HZ = 240.0F;
+	constexpr float MAX_FRAME_TIME = 0.25F;
+
+	// Thresholds for colors
+	constexpr float WARNING_THRESHOLD = 60.0F;
+	constexpr float DANGER_THRESHOLD = 30.0F;
+
+	// Obstacle spatial index: cell edge and the outermost beep band searched
+	constexpr float OBSTACLE_CELL_SIZE = 128.0F;
+	constexpr float BEEP_MAX_RANGE = 300.0F;
+
+	// Ray-cast sensing: fan of rays each sensor casts along its facing
+	constexpr float SENSOR_CONE_HALF_ANGLE = 30.0F; // degrees
+	constexpr std::uint32_t SENSOR_CONE_RAYS = 8U;
+
+	// Sensor-built occupancy map (--mapping): cell edge in pixels and the window of
+	// 8x8-cell tiles kept around the car (16 tiles = 1024 px, past the beep range)
+	constexpr float OCCUPANCY_CELL_SIZE = 8.0F;
+	constexpr int OCCUPANCY_TILES = 16;
+
+	// Moving obstacles (--movers): speeds in px per second, body radii, and the
+	// cell edge of the loose grid that indexes them
+	constexpr float PEDESTRIAN_SPEED = 60.0F;
+	constexpr float PEDESTRIAN_RADIUS = 12.0F;
+	constexpr float MOVER_CAR_SPEED = 180.0F;
+	constexpr float MOVER_CAR_RADIUS = 40.0F;
+	constexpr float MOVER_CELL_SIZE = 128.0F;
+
+	// Baked distance field: sample spacing in pixels
+	constexpr float SDF_CELL_SIZE = 4.0F;
+
+	// Streamed worlds (--world): tile edge, and how far from the car tiles are
+	// loaded and evicted (the gap keeps a tile on a boundary from thrashing)
+	constexpr float WORLD_TILE_SIZE = 1024.0F;
+	constexpr float STREAM_LOAD_RADIUS = 1600.0F;
+	constexpr float STREAM_EVICT_RADIUS = 2600.0F;
+
+	// Visualization server (--serve): world deltas sent to viewers per second
+	constexpr float SERVE_BROADCAST_HZ = 30.0F;
+}
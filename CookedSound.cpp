@@ -0,0 +1,153 @@
+#include "CookedSound.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "MappedFile.hpp"
+
+namespace audio {
+
+	namespace {
+		// Bumped whenever the file layout changes
+		constexpr char PCM_MAGIC[8] = { 'O', 'K', 'P', 'C', '0', '0', '0', '1' };
+		constexpr std::uint32_t MAX_PCM_CHANNELS = 2U; // mono or stereo, the layouts the loader maps
+		constexpr std::uint32_t MAX_PCM_RATE = 384000U;
+
+		// Zero crossings of the sinc on each side of a resampled point
+		constexpr double SINC_HALF_TAPS = 16.0;
+		constexpr double PCM_PI = 3.14159265358979323846;
+
+		struct PcmHeader {
+			char magic[8];
+			std::uint32_t sampleRate;
+			std::uint32_t channelCount;
+			std::uint64_t frameCount;
+		};
+		static_assert(sizeof(PcmHeader) == 24U, "the header is written raw and must have no padding");
+
+		[[nodiscard]] double sinc(double x) noexcept {
+			return (x == 0.0) ? 1.0 : std::sin(PCM_PI * x) / (PCM_PI * x);
+		}
+	}
+
+	std::vector<std::int16_t> resamplePcm(const std::int16_t* samples, std::size_t count,
+		std::uint32_t sourceRate, std::uint32_t targetRate) {
+		if (count == 0U || sourceRate == 0U || targetRate == 0U) {
+			return {};
+		}
+		if (sourceRate == targetRate) {
+			return std::vector<std::int16_t>(samples, samples + count);
+		}
+
+		// Cut off at the lower Nyquist frequency, as a fraction of the source's
+		const double cutoff = std::min(1.0, static_cast<double>(targetRate) / static_cast<double>(sourceRate));
+		const double halfWidth = SINC_HALF_TAPS / cutoff; // in source samples
+		const auto outCount = static_cast<std::size_t>(
+			(static_cast<std::uint64_t>(count) * targetRate + sourceRate - 1U) / sourceRate);
+
+		std::vector<std::int16_t> out(outCount);
+		for (std::size_t n = 0U; n < outCount; ++n) {
+			const double center = static_cast<double>(static_cast<std::uint64_t>(n) * sourceRate) / static_cast<double>(targetRate);
+			const auto first = static_cast<std::ptrdiff_t>(std::ceil(center - halfWidth));
+			const auto last = static_cast<std::ptrdiff_t>(std::floor(center + halfWidth));
+			double sum = 0.0;
+			double weights = 0.0;
+			for (std::ptrdiff_t i = std::max<std::ptrdiff_t>(first, 0); i <= last && i < static_cast<std::ptrdiff_t>(count); ++i) {
+				const double x = static_cast<double>(i) - center;
+				const double window = 0.5 + 0.5 * std::cos(PCM_PI * x / halfWidth); // Hann
+				const double weight = sinc(cutoff * x) * window;
+				sum += weight * samples[i];
+				weights += weight;
+			}
+			// Normalized, so DC passes at unit gain next to the clip ends too
+			const double value = (weights != 0.0) ? sum / weights : 0.0;
+			out[n] = static_cast<std::int16_t>(std::clamp(std::lround(value), -32768L, 32767L));
+		}
+		return out;
+	}
+
+	CookedSound cookSound(const std::int16_t* samples, std::size_t sampleCount,
+		std::uint32_t channelCount, std::uint32_t sampleRate, std::uint32_t targetRate) {
+		CookedSound cooked;
+		if (channelCount == 0U || sampleRate == 0U || targetRate == 0U) {
+			return cooked;
+		}
+
+		const std::size_t frames = sampleCount / channelCount;
+		std::vector<std::int16_t> mono(frames);
+		for (std::size_t f = 0U; f < frames; ++f) {
+			std::int32_t sum = 0;
+			for (std::uint32_t c = 0U; c < channelCount; ++c) {
+				sum += samples[f * channelCount + c];
+			}
+			mono[f] = static_cast<std::int16_t>(sum / static_cast<std::int32_t>(channelCount));
+		}
+
+		cooked.sampleRate = targetRate;
+		cooked.channelCount = 1U;
+		cooked.samples = resamplePcm(mono.data(), mono.size(), sampleRate, targetRate);
+		return cooked;
+	}
+
+	bool saveCookedSound(const std::string& path, const CookedSound& sound) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+
+		PcmHeader header{};
+		std::memcpy(header.magic, PCM_MAGIC, sizeof(PCM_MAGIC));
+		header.sampleRate = sound.sampleRate;
+		header.channelCount = sound.channelCount;
+		header.frameCount = (sound.channelCount != 0U) ? sound.samples.size() / sound.channelCount : 0U;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(sound.samples.data()),
+			static_cast<std::streamsize>(header.frameCount * sound.channelCount * sizeof(std::int16_t)));
+		return static_cast<bool>(file);
+	}
+
+	bool loadCookedSound(const std::string& path, CookedSound& sound) {
+		assets::MappedFile file;
+		if (!file.open(path)) {
+			return false;
+		}
+		return loadCookedSound(file.data(), file.size(), path, sound);
+	}
+
+	bool loadCookedSound(const void* data, std::size_t size, const std::string& name, CookedSound& sound) {
+		PcmHeader header{};
+		if (size < sizeof(header)) {
+			std::cerr << "Error: " << name << " is not a cooked sound\n";
+			return false;
+		}
+		std::memcpy(&header, data, sizeof(header));
+		if (std::memcmp(header.magic, PCM_MAGIC, sizeof(PCM_MAGIC)) != 0
+			|| header.channelCount == 0U || header.channelCount > MAX_PCM_CHANNELS
+			|| header.sampleRate == 0U || header.sampleRate > MAX_PCM_RATE) {
+			std::cerr << "Error: " << name << " is not a supported cooked sound\n";
+			return false;
+		}
+
+		// Checked by dividing, so a corrupt frame count cannot overflow the product
+		const std::size_t payload = size - sizeof(header);
+		const std::size_t frameBytes = header.channelCount * sizeof(std::int16_t);
+		if (header.frameCount != payload / frameBytes || payload % frameBytes != 0U) {
+			std::cerr << "Error: " << name << " is truncated\n";
+			return false;
+		}
+
+		CookedSound loaded;
+		loaded.sampleRate = header.sampleRate;
+		loaded.channelCount = header.channelCount;
+		loaded.samples.resize(payload / sizeof(std::int16_t));
+		if (payload != 0U) {
+			std::memcpy(loaded.samples.data(), static_cast<const unsigned char*>(data) + sizeof(header), payload);
+		}
+		sound = std::move(loaded);
+		return true;
+	}
+
+} // namespace audio
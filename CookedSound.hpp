@@ -0,0 +1,65 @@
+/*
+==============================================================================
+Cooked Sound - PCM baked offline at the output rate
+==============================================================================
+ - Written by the sound cooker (--cook-sound) and loaded at start-up
+   instead of the MP3: no decoder runs and the device does not resample
+ - Cooking downmixes to mono, since beeps are placed per sensor and only
+   mono sounds are positional, then resamples to the output rate with a
+   windowed-sinc filter; the cost is paid once per asset, never per start
+ - The container is a header and the 16-bit samples, so loading is one
+   copy straight into sf::SoundBuffer::loadFromSamples()
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace audio {
+
+	struct CookedSound {
+		std::uint32_t sampleRate = 0U;
+		std::uint32_t channelCount = 1U;
+		std::vector<std::int16_t> samples; // interleaved frames
+
+		[[nodiscard]] bool empty() const noexcept { return samples.empty(); }
+	};
+
+	/**
+	 * @brief Resamples one channel of 16-bit PCM from sourceRate to targetRate.
+	 *
+	 * Band-limited to the lower of the two Nyquist frequencies, so
+	 * downsampling does not alias.
+	 */
+	[[nodiscard]] std::vector<std::int16_t> resamplePcm(const std::int16_t* samples, std::size_t count,
+		std::uint32_t sourceRate, std::uint32_t targetRate);
+
+	/**
+	 * @brief Downmixes interleaved PCM to mono and resamples it to targetRate.
+	 *
+	 * MISRA: channelCount, sampleRate and targetRate must be non-zero;
+	 *        otherwise the result is empty.
+	 */
+	[[nodiscard]] CookedSound cookSound(const std::int16_t* samples, std::size_t sampleCount,
+		std::uint32_t channelCount, std::uint32_t sampleRate, std::uint32_t targetRate);
+
+	/**
+	 * @brief Writes the container; returns false on I/O failure.
+	 */
+	[[nodiscard]] bool saveCookedSound(const std::string& path, const CookedSound& sound);
+
+	/**
+	 * @brief Reads and validates the container; logs and returns false on failure.
+	 */
+	[[nodiscard]] bool loadCookedSound(const std::string& path, CookedSound& sound);
+
+	/**
+	 * @brief As above, for a container already in memory (an asset pack entry); name labels errors.
+	 */
+	[[nodiscard]] bool loadCookedSound(const void* data, std::size_t size, const std::string& name, CookedSound& sound);
+
+} // namespace audio
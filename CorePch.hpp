@@ -0,0 +1,35 @@
+/*
+==============================================================================
+Core Precompiled Header - okpp_core, the headless runner and the benchmarks
+==============================================================================
+ - Standard headers most core translation units include, plus the SFML
+   vector, rect and transform headers the simulation records use
+ - Only stable third-party and standard headers: a project header here
+   would rebuild every translation unit whenever it changes
+ - Never included by name; the build injects it (CMake target_precompile_headers)
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
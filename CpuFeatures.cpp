@@ -0,0 +1,145 @@
+#include "CpuFeatures.hpp"
+
+#include <atomic>
+
+#if defined(OKPP_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace sim {
+
+	namespace {
+#if defined(OKPP_SIMD_X86)
+		struct CpuidRegisters {
+			unsigned int eax = 0U;
+			unsigned int ebx = 0U;
+			unsigned int ecx = 0U;
+			unsigned int edx = 0U;
+		};
+
+		[[nodiscard]] CpuidRegisters readCpuid(unsigned int leaf, unsigned int subleaf) noexcept {
+			CpuidRegisters r;
+#if defined(_MSC_VER) && !defined(__clang__)
+			int regs[4] = {};
+			__cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+			r = { static_cast<unsigned int>(regs[0]), static_cast<unsigned int>(regs[1]),
+				static_cast<unsigned int>(regs[2]), static_cast<unsigned int>(regs[3]) };
+#else
+			if (__get_cpuid_max(0U, nullptr) >= leaf) {
+				__cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+			}
+#endif
+			return r;
+		}
+
+		// Register state the OS saves on a context switch (XCR0)
+		[[nodiscard]] std::uint64_t readXcr0() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+			return _xgetbv(0);
+#else
+			unsigned int lo = 0U;
+			unsigned int hi = 0U;
+			__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+			return (static_cast<std::uint64_t>(hi) << 32U) | lo;
+#endif
+		}
+
+		[[nodiscard]] CpuFeatures detectCpuFeatures() noexcept {
+			constexpr std::uint64_t XCR0_AVX = 0x6U;     // SSE and YMM state
+			constexpr std::uint64_t XCR0_AVX512 = 0xE6U; // also opmask and both ZMM halves
+
+			CpuFeatures features;
+			const CpuidRegisters leaf1 = readCpuid(1U, 0U);
+			features.sse2 = (leaf1.edx & (1U << 26U)) != 0U;
+			const bool osxsave = (leaf1.ecx & (1U << 27U)) != 0U;
+			const bool avx = (leaf1.ecx & (1U << 28U)) != 0U;
+			if (!osxsave || !avx) {
+				return features;
+			}
+			const std::uint64_t xcr0 = readXcr0();
+			const CpuidRegisters leaf7 = readCpuid(7U, 0U);
+			features.avx2 = (xcr0 & XCR0_AVX) == XCR0_AVX && (leaf7.ebx & (1U << 5U)) != 0U;
+			features.avx512f = features.avx2 && (xcr0 & XCR0_AVX512) == XCR0_AVX512 && (leaf7.ebx & (1U << 16U)) != 0U;
+			return features;
+		}
+#else
+		[[nodiscard]] CpuFeatures detectCpuFeatures() noexcept {
+			CpuFeatures features;
+#if defined(OKPP_SIMD_NEON)
+			features.neon = true;
+#endif
+			return features;
+		}
+#endif
+
+		[[nodiscard]] SimdLevel widestSimdLevel() noexcept {
+			for (const SimdLevel level : { SimdLevel::Avx512, SimdLevel::Avx2, SimdLevel::Sse2, SimdLevel::Neon }) {
+				if (simdLevelSupported(level)) {
+					return level;
+				}
+			}
+			return SimdLevel::Scalar;
+		}
+
+		// Initialized on first use, so kernels running during static initialization see it too
+		[[nodiscard]] std::atomic<SimdLevel>& activeSimdLevel() noexcept {
+			static std::atomic<SimdLevel> level{ widestSimdLevel() };
+			return level;
+		}
+	}
+
+	const CpuFeatures& cpuFeatures() noexcept {
+		static const CpuFeatures features = detectCpuFeatures();
+		return features;
+	}
+
+	bool simdLevelSupported(SimdLevel level) noexcept {
+		const CpuFeatures& features = cpuFeatures();
+		switch (level) {
+		case SimdLevel::Scalar: return true;
+		case SimdLevel::Sse2: return features.sse2;
+		case SimdLevel::Avx2: return features.avx2;
+		case SimdLevel::Avx512: return features.avx512f;
+		case SimdLevel::Neon: return features.neon;
+		default: return false;
+		}
+	}
+
+	SimdLevel simdLevel() noexcept {
+		return activeSimdLevel().load(std::memory_order_relaxed);
+	}
+
+	bool setSimdLevel(SimdLevel level) noexcept {
+		if (!simdLevelSupported(level)) {
+			return false;
+		}
+		activeSimdLevel().store(level, std::memory_order_relaxed);
+		return true;
+	}
+
+	const char* simdLevelName(SimdLevel level) noexcept {
+		switch (level) {
+		case SimdLevel::Scalar: return "scalar";
+		case SimdLevel::Sse2: return "sse2";
+		case SimdLevel::Avx2: return "avx2";
+		case SimdLevel::Avx512: return "avx512";
+		case SimdLevel::Neon: return "neon";
+		default: return "?";
+		}
+	}
+
+	bool parseSimdLevel(std::string_view name, SimdLevel& level) noexcept {
+		for (const SimdLevel known : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512, SimdLevel::Neon }) {
+			if (name == simdLevelName(known)) {
+				level = known;
+				return true;
+			}
+		}
+		return false;
+	}
+
+} // namespace sim
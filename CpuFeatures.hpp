@@ -0,0 +1,96 @@
+/*
+==============================================================================
+CPU Features - runtime detection and the SIMD level the kernels dispatch on
+==============================================================================
+ - On x86 the CPU is asked once (CPUID, and XGETBV for whether the OS saves
+   the wide registers): SSE2, AVX2 and AVX-512F. Kernels for every level
+   are compiled into the same binary, the wider ones with function-level
+   target attributes (OKPP_TARGET_AVX2 / OKPP_TARGET_AVX512), so one x86
+   build takes the widest path each server has
+ - On ARM the level is NEON whenever the compiler targets it; it is part of
+   the AArch64 baseline, so head-unit builds need no detection. x86 and ARM
+   are still separate binaries: no one executable runs on both
+ - The distance (ObstacleStore), containment (BayColumns), integration
+   (stepVehiclesSimd) and golden image diff (GoldenImage) kernels look
+   simdLevel() up on every call; every level returns the same bits, wider
+   ones just take fewer steps
+ - setSimdLevel() pins a lower level for comparison (--simd in the bench
+   and the headless runner); a level the CPU or the build lacks is refused
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define OKPP_SIMD_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+// MSVC accepts every intrinsic in any function; the CPU check is the guard
+#define OKPP_TARGET_SSE2
+#define OKPP_TARGET_AVX2
+#define OKPP_TARGET_AVX512
+#elif defined(__clang__)
+// Clang contracts a * b + c only within one expression, never across intrinsic calls
+#define OKPP_TARGET_SSE2 __attribute__((target("sse2"))) // baseline on x86-64, not on 32-bit x86
+#define OKPP_TARGET_AVX2 __attribute__((target("avx2")))
+#define OKPP_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+// GCC fuses multiplies and adds across intrinsics wherever the target has FMA (AVX-512F
+// implies it); fused results round differently, so contraction is off in every kernel
+#define OKPP_TARGET_SSE2 __attribute__((target("sse2"), optimize("fp-contract=off"))) // baseline on x86-64, not on 32-bit x86
+#define OKPP_TARGET_AVX2 __attribute__((target("avx2"), optimize("fp-contract=off")))
+#define OKPP_TARGET_AVX512 __attribute__((target("avx512f"), optimize("fp-contract=off")))
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define OKPP_SIMD_NEON 1
+#endif
+
+namespace sim {
+
+	enum class SimdLevel : std::uint8_t {
+		Scalar,
+		Sse2,
+		Avx2,
+		Avx512,
+		Neon
+	};
+
+	struct CpuFeatures {
+		bool sse2 = false;
+		bool avx2 = false;    // and the OS saves the YMM registers
+		bool avx512f = false; // and the OS saves the ZMM and mask registers
+		bool neon = false;
+	};
+
+	/**
+	 * @brief What this CPU supports, detected on the first call.
+	 */
+	[[nodiscard]] const CpuFeatures& cpuFeatures() noexcept;
+
+	/**
+	 * @brief True if this build has kernels for level and this CPU can run them.
+	 */
+	[[nodiscard]] bool simdLevelSupported(SimdLevel level) noexcept;
+
+	/**
+	 * @brief The level the kernels run at: the widest supported one unless setSimdLevel() pinned another.
+	 */
+	[[nodiscard]] SimdLevel simdLevel() noexcept;
+
+	/**
+	 * @brief Pins the kernels to level; false (and unchanged) if it is not supported.
+	 *
+	 * MISRA: call before worker threads start; kernels already running finish at the old level.
+	 */
+	bool setSimdLevel(SimdLevel level) noexcept;
+
+	[[nodiscard]] const char* simdLevelName(SimdLevel level) noexcept;
+
+	/**
+	 * @brief Level named name ("scalar", "sse2", "avx2", "avx512", "neon"); false if unknown.
+	 */
+	[[nodiscard]] bool parseSimdLevel(std::string_view name, SimdLevel& level) noexcept;
+
+} // namespace sim
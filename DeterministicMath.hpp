@@ -0,0 +1,128 @@
+/*
+==============================================================================
+Deterministic Math - the simulation's transcendental functions, bit-exact
+==============================================================================
+ - Built with OKPP_DETERMINISTIC_MATH (CMake option of the same name), the
+   tangent, arctangent, logarithm and hypotenuse the simulation core uses
+   come from the polynomials below instead of the platform's libm, whose
+   last bits differ between MSVC, glibc and Apple; replays, lockstep peers
+   and regression baselines then match bit for bit
+ - The mode also turns off floating-point contraction (-ffp-contract=off,
+   /fp:precise), so no compiler fuses a multiply and an add into an FMA on
+   one platform and not on another; every expression below, and the rest
+   of the core, rounds after each operation in source order
+ - Heading sine and cosine are always polynomial (FastTrig); sqrt, fmod,
+   floor and the basic operators are correctly rounded by IEEE 754 on
+   every target, so they need no replacement
+ - Without the mode each function forwards to libm, as before
+ - Polynomials are branch-light straight-line code, so the loops that call
+   them still vectorize; accuracy is within a few float ulps
+==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "Constants.hpp"
+#include "FastTrig.hpp"
+
+#ifndef OKPP_DETERMINISTIC_MATH
+#define OKPP_DETERMINISTIC_MATH 0
+#endif
+
+namespace sim {
+
+	// True when the simulation was built for bit-identical results across platforms
+	inline constexpr bool DETERMINISTIC_MATH = OKPP_DETERMINISTIC_MATH != 0;
+
+	namespace dmath {
+
+		/**
+		 * @brief Tangent of an angle in degrees; the angle stays away from odd multiples of 90.
+		 */
+		[[nodiscard]] inline float tanDeg(float deg) noexcept {
+#if OKPP_DETERMINISTIC_MATH
+			const SinCos angle = sinCosDeg(deg);
+			return angle.sin / angle.cos;
+#else
+			return std::tan(deg * constants::DEG_TO_RAD);
+#endif
+		}
+
+		/**
+		 * @brief Angle of (x, y) in degrees, in [-180, 180]; 0 for the zero vector.
+		 */
+		[[nodiscard]] inline float atan2Deg(float y, float x) noexcept {
+#if OKPP_DETERMINISTIC_MATH
+			// atan of the smaller over the larger magnitude, in [0, 1]; above
+			// tan(pi/8) it is taken about 1, where the series converges faster
+			const float ax = std::fabs(x);
+			const float ay = std::fabs(y);
+			const float big = (ax > ay) ? ax : ay;
+			if (big == 0.0F) {
+				return 0.0F;
+			}
+			float t = ((ax > ay) ? ay : ax) / big;
+			float base = 0.0F;
+			if (t > 0.41421356F) {
+				t = (t - 1.0F) / (t + 1.0F);
+				base = 45.0F;
+			}
+			// Cephes atanf coefficients for |t| <= tan(pi/8)
+			const float z = t * t;
+			const float poly = ((((8.05374449538E-2F * z) - 1.38776856032E-1F) * z + 1.99777106478E-1F) * z
+				- 3.33329491539E-1F) * z * t + t;
+			float deg = base + poly * constants::RAD_TO_DEG;
+			deg = (ay > ax) ? 90.0F - deg : deg;
+			deg = (x < 0.0F) ? 180.0F - deg : deg;
+			return (y < 0.0F) ? -deg : deg;
+#else
+			return std::atan2(y, x) * constants::RAD_TO_DEG;
+#endif
+		}
+
+		/**
+		 * @brief Natural logarithm of a positive, finite x.
+		 */
+		[[nodiscard]] inline float log(float x) noexcept {
+#if OKPP_DETERMINISTIC_MATH
+			// x = m * 2^e with m in [sqrt(1/2), sqrt(2)); frexp is exact
+			int exponent = 0;
+			float m = std::frexp(x, &exponent);
+			if (m < 0.70710678F) {
+				m = m + m - 1.0F;
+				--exponent;
+			}
+			else {
+				m = m - 1.0F;
+			}
+			// Cephes logf coefficients; ln 2 is split so e * ln 2 stays exact
+			const float z = m * m;
+			float y = ((((((((7.0376836292E-2F * m - 1.1514610310E-1F) * m + 1.1676998740E-1F) * m
+				- 1.2420140846E-1F) * m + 1.4249322787E-1F) * m - 1.6668057665E-1F) * m
+				+ 2.0000714765E-1F) * m - 2.4999993993E-1F) * m + 3.3333331174E-1F) * m * z;
+			const auto e = static_cast<float>(exponent);
+			y += -2.12194440E-4F * e;
+			y += -0.5F * z;
+			return m + y + 0.693359375F * e;
+#else
+			return std::log(x);
+#endif
+		}
+
+		/**
+		 * @brief Length of (x, y); without the overflow guard of std::hypot, which simulation lengths never need.
+		 */
+		[[nodiscard]] inline float hypot(float x, float y) noexcept {
+#if OKPP_DETERMINISTIC_MATH
+			return std::sqrt(x * x + y * y);
+#else
+			return std::hypot(x, y);
+#endif
+		}
+
+	} // namespace dmath
+
+} // namespace sim
@@ -0,0 +1,240 @@
+#include "DistanceField.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include "ObstacleGrid.hpp"
+#include "Sensors.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr float NOT_FOUND = std::numeric_limits<float>::max();
+
+		// Bumped whenever the file layout or the bake itself changes
+		constexpr char CACHE_MAGIC[8] = { 'O', 'K', 'S', 'D', 'F', '0', '0', '1' };
+
+		// FNV-1a over the raw bytes of the bake inputs
+		class InputHash {
+		public:
+			void add(const void* data, std::size_t size) {
+				const auto* bytes = static_cast<const unsigned char*>(data);
+				for (std::size_t i = 0U; i < size; ++i) {
+					m_value = (m_value ^ bytes[i]) * 0x100000001B3ULL;
+				}
+			}
+			void add(float value) { add(&value, sizeof(value)); }
+
+			[[nodiscard]] std::uint64_t value() const noexcept { return m_value; }
+
+		private:
+			std::uint64_t m_value = 0xCBF29CE484222325ULL;
+		};
+
+		// sf::Vector2f::length() lives in sfml-system; the core stays header-only
+		[[nodiscard]] float length(const sf::Vector2f& v) {
+			return std::sqrt(v.dot(v));
+		}
+
+		[[nodiscard]] std::uint64_t bakeKey(const std::vector<Obstacle>& obstacles,
+			const sf::FloatRect& bounds, float cellSize)
+		{
+			InputHash hash;
+			hash.add(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+			hash.add(bounds.position.x);
+			hash.add(bounds.position.y);
+			hash.add(bounds.size.x);
+			hash.add(bounds.size.y);
+			hash.add(cellSize);
+			for (const auto& obstacle : obstacles) {
+				hash.add(obstacle.center.x);
+				hash.add(obstacle.center.y);
+				hash.add(obstacle.radius);
+			}
+			return hash.value();
+		}
+	}
+
+	void DistanceField::bake(const std::vector<Obstacle>& obstacles, const sf::FloatRect& bounds, float cellSize) {
+		m_values.clear();
+		m_cols = 0;
+		m_rows = 0;
+		m_key = bakeKey(obstacles, bounds, cellSize);
+		if (cellSize <= 0.0F || obstacles.empty()) {
+			return;
+		}
+
+		m_bounds = bounds;
+		m_cellSize = cellSize;
+		// Samples sit on cell corners, including the far edge of the bounds
+		m_cols = static_cast<int>(bounds.size.x / cellSize) + 2;
+		m_rows = static_cast<int>(bounds.size.y / cellSize) + 2;
+		m_values.resize(static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows));
+
+		// Rows are independent; they are baked in parallel on the shared pool
+		sharedPool().parallelFor(static_cast<std::size_t>(m_rows), 0U, [&](std::size_t firstRow, std::size_t endRow) {
+			OKPP_TRACE_SCOPE("bake distance field rows");
+			for (int y = static_cast<int>(firstRow); y < static_cast<int>(endRow); ++y) {
+				for (int x = 0; x < m_cols; ++x) {
+					const sf::Vector2f p{
+						bounds.position.x + static_cast<float>(x) * cellSize,
+						bounds.position.y + static_cast<float>(y) * cellSize
+					};
+					float best = NOT_FOUND;
+					for (const auto& obstacle : obstacles) {
+						best = std::min(best, length(p - obstacle.center) - obstacle.radius);
+					}
+					m_values[static_cast<std::size_t>(y * m_cols + x)] = best;
+				}
+			}
+		});
+	}
+
+	bool DistanceField::loadOrBake(const std::vector<Obstacle>& obstacles, const sf::FloatRect& bounds,
+		float cellSize, const std::string& cachePath)
+	{
+		m_bounds = bounds;
+		m_cellSize = cellSize;
+		m_cols = (cellSize > 0.0F) ? static_cast<int>(bounds.size.x / cellSize) + 2 : 0;
+		m_rows = (cellSize > 0.0F) ? static_cast<int>(bounds.size.y / cellSize) + 2 : 0;
+		if (!obstacles.empty() && load(cachePath, bakeKey(obstacles, bounds, cellSize))) {
+			return true;
+		}
+
+		bake(obstacles, bounds, cellSize);
+		if (!m_values.empty() && !save(cachePath)) {
+			std::cerr << "Warning: Failed to write distance field cache " << cachePath << '\n';
+		}
+		return false;
+	}
+
+	bool DistanceField::rebake(const std::vector<Obstacle>& obstacles, const ObstacleGrid& centers,
+		const sf::FloatRect& changed, float range, float maxRadius)
+	{
+		if (m_values.empty()) {
+			return false;
+		}
+		OKPP_TRACE_SCOPE("rebake distance field");
+
+		// Past range of the changed circles a sample's reading cannot have
+		// changed; two more cells keep the interpolated values in step
+		const float grow = range + 2.0F * m_cellSize;
+		const auto toSample = [this](float offset, int count) {
+			return static_cast<int>(std::clamp(std::floor(offset / m_cellSize), 0.0F, static_cast<float>(count - 1)));
+		};
+		const int x0 = toSample(changed.position.x - grow - m_bounds.position.x, m_cols);
+		const int x1 = toSample(changed.position.x + changed.size.x + grow - m_bounds.position.x + m_cellSize, m_cols);
+		const int y0 = toSample(changed.position.y - grow - m_bounds.position.y, m_rows);
+		const int y1 = toSample(changed.position.y + changed.size.y + grow - m_bounds.position.y + m_cellSize, m_rows);
+
+		// Any surface within range has its center within range + maxRadius
+		std::vector<std::uint32_t> near;
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				const sf::Vector2f p{
+					m_bounds.position.x + static_cast<float>(x) * m_cellSize,
+					m_bounds.position.y + static_cast<float>(y) * m_cellSize
+				};
+				near.clear();
+				centers.gather(p, range + maxRadius, near);
+				float best = range;
+				for (const std::uint32_t i : near) {
+					best = std::min(best, length(p - obstacles[i].center) - obstacles[i].radius);
+				}
+				m_values[static_cast<std::size_t>(y * m_cols + x)] = best;
+			}
+		}
+		return true;
+	}
+
+	bool DistanceField::load(const std::string& path, std::uint64_t key) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false; // no cache yet
+		}
+
+		char magic[sizeof(CACHE_MAGIC)] = {};
+		std::uint64_t fileKey = 0U;
+		std::int32_t cols = 0;
+		std::int32_t rows = 0;
+		file.read(magic, sizeof(magic));
+		file.read(reinterpret_cast<char*>(&fileKey), sizeof(fileKey));
+		file.read(reinterpret_cast<char*>(&cols), sizeof(cols));
+		file.read(reinterpret_cast<char*>(&rows), sizeof(rows));
+		if (!file || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0
+			|| fileKey != key || cols != m_cols || rows != m_rows) {
+			return false; // stale or foreign file: rebake
+		}
+
+		std::vector<float> values(static_cast<std::size_t>(cols) * static_cast<std::size_t>(rows));
+		file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(float)));
+		if (!file) {
+			return false;
+		}
+
+		m_key = key;
+		m_values = std::move(values);
+		return true;
+	}
+
+	bool DistanceField::save(const std::string& path) const {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+
+		const std::int32_t cols = m_cols;
+		const std::int32_t rows = m_rows;
+		file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		file.write(reinterpret_cast<const char*>(&m_key), sizeof(m_key));
+		file.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
+		file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+		file.write(reinterpret_cast<const char*>(m_values.data()), static_cast<std::streamsize>(m_values.size() * sizeof(float)));
+		return static_cast<bool>(file);
+	}
+
+	float DistanceField::sample(const sf::Vector2f& point) const {
+		if (m_values.empty()) {
+			return NOT_FOUND;
+		}
+
+		const float maxX = static_cast<float>(m_cols - 1);
+		const float maxY = static_cast<float>(m_rows - 1);
+		const float gx = std::clamp((point.x - m_bounds.position.x) / m_cellSize, 0.0F, maxX);
+		const float gy = std::clamp((point.y - m_bounds.position.y) / m_cellSize, 0.0F, maxY);
+
+		const int x0 = std::min(static_cast<int>(gx), m_cols - 2);
+		const int y0 = std::min(static_cast<int>(gy), m_rows - 2);
+		const float fx = gx - static_cast<float>(x0);
+		const float fy = gy - static_cast<float>(y0);
+
+		const float* row0 = &m_values[static_cast<std::size_t>(y0 * m_cols + x0)];
+		const float* row1 = row0 + m_cols;
+		const float top = row0[0] + (row0[1] - row0[0]) * fx;
+		const float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+		const float inside = top + (bottom - top) * fy;
+
+		// Points past the bounds pay their distance back to the clamped sample
+		const sf::Vector2f clamped{ m_bounds.position.x + gx * m_cellSize, m_bounds.position.y + gy * m_cellSize };
+		return inside + length(point - clamped);
+	}
+
+	void readSensors(const std::vector<SensorPose>& sensors, const DistanceField& field, float maxRange,
+		const ObstacleGrid& walls, std::vector<SensorReading>& readings)
+	{
+		readings.resize(sensors.size());
+		for (std::size_t i = 0U; i < sensors.size(); ++i) {
+			const float distance = std::max(field.sample(sensors[i].position), 0.0F);
+			readings[i].obstacle = NO_OBSTACLE;
+			readings[i].distanceSq = (distance <= maxRange) ? distance * distance : NOT_FOUND;
+			readings[i].wallDistance = walls.nearestWall(sensors[i].position, maxRange);
+		}
+	}
+
+} // namespace sim
@@ -0,0 +1,98 @@
+/*
+==============================================================================
+Distance Field - baked signed distance to the static obstacles
+==============================================================================
+ - Sampled on a regular grid once at load time (rows in parallel on the
+   shared pool); queries are one bilinear lookup, independent of how many
+   obstacles the scene has
+ - Negative inside an obstacle, zero on its outline, positive outside
+ - The bake is cached on disk and reused while the scene it was baked
+   from (obstacles, bounds, cell size) stays the same
+ - An edit rebakes only the samples around the changed pillars, from the
+   pillars the obstacle grid finds near each; readings within the range
+   given match a full bake, farther samples may read less than they would
+   but never less than that range (the disk cache is not rewritten)
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SimFwd.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	class DistanceField {
+	public:
+		/**
+		 * @brief Samples the field over bounds at cellSize spacing.
+		 *
+		 * MISRA: cellSize must be strictly positive; non-positive values
+		 *        leave the field empty.
+		 */
+		void bake(const std::vector<Obstacle>& obstacles, const sf::FloatRect& bounds, float cellSize);
+
+		/**
+		 * @brief Loads the field from cachePath if it was baked from the same
+		 *        inputs, otherwise bakes it and writes the cache.
+		 *
+		 * Returns true if the cache was used. A cache that cannot be written
+		 * is reported and the freshly baked field is kept.
+		 */
+		bool loadOrBake(const std::vector<Obstacle>& obstacles, const sf::FloatRect& bounds,
+			float cellSize, const std::string& cachePath);
+
+		/**
+		 * @brief Resamples the field around changed (the old and new bounds of edited obstacles).
+		 *
+		 * centers indexes obstacles as they are now; maxRadius bounds every
+		 * radius. Samples within range plus two cells of changed are redone;
+		 * a sample with no obstacle surface within range reads range. Returns
+		 * false if the field is empty; the caller bakes it then.
+		 */
+		bool rebake(const std::vector<Obstacle>& obstacles, const ObstacleGrid& centers, const sf::FloatRect& changed,
+			float range, float maxRadius);
+
+		/**
+		 * @brief Bilinearly interpolated signed distance at point.
+		 *
+		 * Outside the baked bounds the edge value plus the distance to the
+		 * bounds is returned (never closer than the true distance). Returns
+		 * std::numeric_limits<float>::max() if the field is empty.
+		 */
+		[[nodiscard]] float sample(const sf::Vector2f& point) const;
+
+		[[nodiscard]] bool empty() const noexcept { return m_values.empty(); }
+		[[nodiscard]] float cellSize() const noexcept { return m_cellSize; }
+
+	private:
+		[[nodiscard]] bool load(const std::string& path, std::uint64_t key);
+		[[nodiscard]] bool save(const std::string& path) const;
+
+		sf::FloatRect m_bounds;
+		float m_cellSize = 1.0F;
+		int m_cols = 0; // samples per row
+		int m_rows = 0;
+		std::uint64_t m_key = 0U; // hash of the bake inputs
+		std::vector<float> m_values;
+	};
+
+	/**
+	 * @brief Batched sensor pass: one field sample per sensor.
+	 *
+	 * The field does not know which pillar is closest, so readings carry
+	 * NO_OBSTACLE; distances past maxRange read as nothing in range, and a
+	 * sensor inside a pillar reads 0. Wall distances come from the wall
+	 * segments of walls.
+	 */
+	void readSensors(const std::vector<SensorPose>& sensors, const DistanceField& field, float maxRange,
+		const ObstacleGrid& walls, std::vector<SensorReading>& readings);
+
+} // namespace sim
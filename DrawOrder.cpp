@@ -0,0 +1,83 @@
+#include "DrawOrder.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace gfx {
+
+	namespace {
+		constexpr std::uint64_t SHADER_LIMIT = (1ULL << 12U) - 1U;
+		constexpr std::uint64_t TEXTURE_LIMIT = (1ULL << 16U) - 1U;
+		constexpr std::size_t RADIX_BUCKETS = 256U;
+	}
+
+	std::uint64_t DrawOrder::resourceId(std::vector<DrawResource>& table, DrawResource resource, std::uint64_t limit) {
+		if (resource == 0U) {
+			return 0U;
+		}
+		const auto found = std::find(table.begin(), table.end(), resource);
+		if (found != table.end()) {
+			return static_cast<std::uint64_t>(found - table.begin()) + 1U;
+		}
+		// Past the limit, new resources share the last id: still drawn, just not grouped
+		if (table.size() < limit) {
+			table.push_back(resource);
+		}
+		return std::min<std::uint64_t>(table.size(), limit);
+	}
+
+	std::uint32_t DrawOrder::push(std::uint8_t layer, DrawResource texture, DrawResource shader, std::uint32_t depth) {
+		const std::uint64_t key = (static_cast<std::uint64_t>(layer) << LAYER_SHIFT)
+			| (resourceId(m_shaders, shader, SHADER_LIMIT) << SHADER_SHIFT)
+			| (resourceId(m_textures, texture, TEXTURE_LIMIT) << TEXTURE_SHIFT)
+			| std::min(depth, MAX_DEPTH);
+		const auto draw = static_cast<std::uint32_t>(m_entries.size());
+		m_entries.push_back({ key, draw });
+		return draw;
+	}
+
+	const std::vector<DrawOrder::Entry>& DrawOrder::sort() {
+		m_stateRuns = m_entries.empty() ? 0U : 1U;
+		if (m_entries.size() < 2U) {
+			return m_entries;
+		}
+		// Bytes where every key agrees cannot reorder anything; skip their passes
+		std::uint64_t differing = 0U;
+		for (const Entry& entry : m_entries) {
+			differing |= entry.key ^ m_entries.front().key;
+		}
+
+		m_scratch.resize(m_entries.size());
+		for (unsigned shift = 0U; shift < 64U; shift += 8U) {
+			if (((differing >> shift) & 0xFFU) == 0U) {
+				continue;
+			}
+			std::array<std::size_t, RADIX_BUCKETS> offsets{};
+			for (const Entry& entry : m_entries) {
+				++offsets[(entry.key >> shift) & 0xFFU];
+			}
+			std::size_t total = 0U;
+			for (std::size_t& offset : offsets) {
+				const std::size_t count = offset;
+				offset = total;
+				total += count;
+			}
+			for (const Entry& entry : m_entries) {
+				m_scratch[offsets[(entry.key >> shift) & 0xFFU]++] = entry;
+			}
+			m_entries.swap(m_scratch);
+		}
+
+		for (std::size_t i = 1U; i < m_entries.size(); ++i) {
+			m_stateRuns += stateChanges(m_entries[i - 1U].key, m_entries[i].key) ? 1U : 0U;
+		}
+		return m_entries;
+	}
+
+	void DrawOrder::clear() noexcept {
+		m_entries.clear();
+		m_textures.clear();
+		m_shaders.clear();
+	}
+
+} // namespace gfx
@@ -0,0 +1,87 @@
+/*
+==============================================================================
+Draw Order - sort keys for a frame's draws, shared by every front-end
+==============================================================================
+ - Every draw carries a 64-bit sort key: layer (8 bits), shader (12 bits),
+   texture (16 bits), depth (28 bits), most significant first
+ - Layers keep the picture's back-to-front order; inside a layer, draws on
+   the same shader and texture end up next to each other, so the GPU
+   state changes once per run instead of once per draw
+ - Keys are sorted with a stable LSD radix sort over the key bytes that
+   differ, so equal keys keep their push order and no comparisons are made
+ - Knows nothing about what is drawn: shaders and textures are opaque
+   handles (a pointer under SFML, a GL name under GLUT) and each draw is
+   its push index. The SFML RenderQueue and the GLUT QuadQueue both sort
+   with it, so batching changes land in both front-ends at once
+ - No SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gfx {
+
+	// Opaque GPU resource handle for sorting; 0 = none
+	using DrawResource = std::uintptr_t;
+
+	class DrawOrder {
+	public:
+		static constexpr std::size_t LAYER_COUNT = 256U;
+		static constexpr std::uint32_t MAX_DEPTH = (1U << 28U) - 1U;
+
+		struct Entry {
+			std::uint64_t key = 0U;
+			std::uint32_t draw = 0U; // push index
+		};
+
+		/**
+		 * @brief Queues a draw in layer and returns its push index.
+		 *
+		 * texture and shader are the GPU state the draw binds. Deeper draws of
+		 * the same state sort later. MISRA: depth is clamped to MAX_DEPTH.
+		 */
+		std::uint32_t push(std::uint8_t layer, DrawResource texture = 0U, DrawResource shader = 0U,
+			std::uint32_t depth = 0U);
+
+		/**
+		 * @brief Sorts the queued draws by key, stable, and counts their state runs.
+		 */
+		[[nodiscard]] const std::vector<Entry>& sort();
+
+		/**
+		 * @brief Empties the queue and forgets the resource handles.
+		 */
+		void clear() noexcept;
+
+		[[nodiscard]] static std::uint8_t layerOf(std::uint64_t key) noexcept { return static_cast<std::uint8_t>(key >> LAYER_SHIFT); }
+
+		/**
+		 * @brief True if a draw with key b needs other shader or texture state than one with key a.
+		 */
+		[[nodiscard]] static bool stateChanges(std::uint64_t a, std::uint64_t b) noexcept {
+			return ((a ^ b) & STATE_MASK) != 0U;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+		[[nodiscard]] std::size_t stateRuns() const noexcept { return m_stateRuns; } // last sort
+
+	private:
+		static constexpr unsigned LAYER_SHIFT = 56U;
+		static constexpr unsigned SHADER_SHIFT = 44U;
+		static constexpr unsigned TEXTURE_SHIFT = 28U;
+		static constexpr std::uint64_t STATE_MASK = ~((1ULL << TEXTURE_SHIFT) - 1U); // layer, shader and texture
+
+		[[nodiscard]] static std::uint64_t resourceId(std::vector<DrawResource>& table, DrawResource resource, std::uint64_t limit);
+
+		std::vector<Entry> m_entries;
+		std::vector<Entry> m_scratch; // radix sort ping-pong buffer
+		std::vector<DrawResource> m_textures; // id = index + 1, 0 = none
+		std::vector<DrawResource> m_shaders;
+		std::size_t m_stateRuns = 0U;
+	};
+
+} // namespace gfx
@@ -0,0 +1,151 @@
+/*
+==============================================================================
+Drive Coroutine - C++20 coroutines that drive one car tick by tick
+==============================================================================
+ - A drive script is a coroutine returning DriveTask; it holds an input for
+   a while with co_await driveForward(2s), reverse(1s), pause(500ms) or
+   turn(90.0F), and loops or returns
+ - Each co_await stores the held input and the tick the script runs again
+   in the car's DriveSlot, then suspends; the fixed-step scheduler
+   (DriveScripts) resumes it once that tick comes, so a waiting script
+   costs one compare per tick and no thread or hand-written state machine
+ - Durations are rounded to whole fixed ticks, at least one; turns last
+   as long as the arcade car needs at its turn rate
+ - The coroutine frame is the script's state, allocated once at start; a
+   script that returns leaves its car standing
+ - C++20 translation units only: C++17 code reaches the scripts through
+   DriveScripts (DriveScript.hpp)
+==============================================================================
+*/
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "DriveCoroutine.hpp needs C++20 coroutines; include DriveScript.hpp from C++17 code"
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#include "CarModel.hpp"
+
+namespace sim::script {
+
+	using Seconds = std::chrono::duration<float>;
+
+	// What the scheduler and a script share about one car
+	struct DriveSlot {
+		std::uint64_t now = 0U;        // the tick being resumed for
+		std::uint64_t resumeTick = 0U; // the script runs again at the first tick >= this
+		float tickDt = 0.0F;
+		float turnRate = 0.0F;         // degrees per second, for turn()
+		CarInput held = 0U;            // input applied every tick until then
+	};
+
+	class DriveTask {
+	public:
+		struct promise_type {
+			DriveSlot* slot = nullptr;
+
+			DriveTask get_return_object() noexcept {
+				return DriveTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+			std::suspend_always initial_suspend() noexcept { return {}; } // runs from the first resume()
+			std::suspend_always final_suspend() noexcept { return {}; }   // the task destroys the frame
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept { std::terminate(); }
+		};
+
+		DriveTask() = default;
+		DriveTask(DriveTask&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+		DriveTask& operator=(DriveTask&& other) noexcept {
+			if (this != &other) {
+				reset();
+				m_handle = std::exchange(other.m_handle, {});
+			}
+			return *this;
+		}
+		~DriveTask() { reset(); }
+
+		DriveTask(const DriveTask&) = delete;
+		DriveTask& operator=(const DriveTask&) = delete;
+
+		/**
+		 * @brief Points the script at its car's slot; must precede the first resume().
+		 */
+		void bind(DriveSlot& slot) noexcept { m_handle.promise().slot = &slot; }
+
+		/**
+		 * @brief Runs the script up to its next co_await; false once it has returned.
+		 */
+		bool resume() {
+			if (!m_handle || m_handle.done()) {
+				return false;
+			}
+			m_handle.resume();
+			return !m_handle.done();
+		}
+
+	private:
+		explicit DriveTask(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+		void reset() noexcept {
+			if (m_handle) {
+				m_handle.destroy();
+				m_handle = {};
+			}
+		}
+
+		std::coroutine_handle<promise_type> m_handle;
+	};
+
+	// co_await: hold input for seconds, or for the time the car needs to turn degrees
+	class Hold {
+	public:
+		Hold(CarInput input, Seconds duration, float turnDegrees = 0.0F) noexcept
+			: m_input(input), m_seconds(duration.count()), m_turnDegrees(turnDegrees) {
+		}
+
+		[[nodiscard]] bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<DriveTask::promise_type> handle) const noexcept {
+			DriveSlot& slot = *handle.promise().slot;
+			const float seconds = (m_turnDegrees != 0.0F && slot.turnRate > 0.0F)
+				? std::abs(m_turnDegrees) / slot.turnRate
+				: m_seconds;
+			const float ticks = (slot.tickDt > 0.0F) ? seconds / slot.tickDt + 0.5F : 1.0F;
+			slot.held = m_input;
+			slot.resumeTick = slot.now + ((ticks >= 1.0F) ? static_cast<std::uint64_t>(ticks) : 1U);
+		}
+		void await_resume() const noexcept {}
+
+	private:
+		CarInput m_input;
+		float m_seconds;
+		float m_turnDegrees;
+	};
+
+	[[nodiscard]] inline Hold driveForward(Seconds duration) noexcept { return Hold(input::FORWARD, duration); }
+	[[nodiscard]] inline Hold reverse(Seconds duration) noexcept { return Hold(input::BACKWARD, duration); }
+	[[nodiscard]] inline Hold pause(Seconds duration) noexcept { return Hold(0U, duration); }
+
+	/**
+	 * @brief Turns by degrees while rolling forward: positive is clockwise (right), like headings.
+	 */
+	[[nodiscard]] inline Hold turn(float degrees) noexcept {
+		const CarInput steer = (degrees >= 0.0F) ? input::RIGHT : input::LEFT;
+		return Hold(static_cast<CarInput>(input::FORWARD | steer), Seconds(0.0F), degrees);
+	}
+
+	/**
+	 * @brief turn() while backing up.
+	 */
+	[[nodiscard]] inline Hold turnReversing(float degrees) noexcept {
+		const CarInput steer = (degrees >= 0.0F) ? input::RIGHT : input::LEFT;
+		return Hold(static_cast<CarInput>(input::BACKWARD | steer), Seconds(0.0F), degrees);
+	}
+
+} // namespace sim::script
@@ -0,0 +1,141 @@
+// Built as C++20 (see CMakeLists.txt): the only core file that uses coroutines
+
+#include "DriveScript.hpp"
+
+#include <array>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "DriveCoroutine.hpp"
+
+namespace sim {
+
+	namespace {
+		using namespace std::chrono_literals;
+		using script::DriveTask;
+		using script::Seconds;
+
+		constexpr std::uint64_t FINISHED = std::numeric_limits<std::uint64_t>::max();
+
+		// Car i waits a little longer before its first move, so rows of cars spread out
+		[[nodiscard]] Seconds stagger(std::uint32_t car) noexcept {
+			return Seconds(0.05F * static_cast<float>(car % 40U));
+		}
+
+		// Squares of slightly different sizes around the spawn rows
+		DriveTask lap(std::uint32_t car) {
+			co_await script::pause(stagger(car));
+			const Seconds side = 1.0s + Seconds(0.1F * static_cast<float>(car % 5U));
+			for (;;) {
+				co_await script::driveForward(side);
+				co_await script::turn(90.0F);
+			}
+		}
+
+		// Up and back again, like the built-in trace
+		DriveTask shuttle(std::uint32_t car) {
+			co_await script::pause(stagger(car));
+			for (;;) {
+				co_await script::driveForward(2s);
+				co_await script::pause(500ms);
+				co_await script::reverse(2s);
+				co_await script::pause(500ms);
+			}
+		}
+
+		// Weaving left and right, alternating the first side by car
+		DriveTask slalom(std::uint32_t car) {
+			co_await script::pause(stagger(car));
+			const float side = ((car % 2U) == 0U) ? 1.0F : -1.0F;
+			co_await script::turn(side * 30.0F);
+			for (;;) {
+				co_await script::driveForward(400ms);
+				co_await script::turn(side * -60.0F);
+				co_await script::driveForward(400ms);
+				co_await script::turn(side * 60.0F);
+			}
+		}
+
+		struct NamedScript {
+			const char* name;
+			DriveTask (*start)(std::uint32_t car);
+		};
+
+		constexpr std::array<NamedScript, 3> SCRIPTS = { {
+			{ "lap", &lap },
+			{ "shuttle", &shuttle },
+			{ "slalom", &slalom },
+		} };
+
+		[[nodiscard]] const NamedScript* findScript(const std::string& name) noexcept {
+			for (const NamedScript& script : SCRIPTS) {
+				if (name == script.name) {
+					return &script;
+				}
+			}
+			return nullptr;
+		}
+	}
+
+	struct DriveScripts::Scripts {
+		std::vector<DriveTask> tasks;
+		std::vector<script::DriveSlot> slots; // never resized once bound: tasks point into it
+	};
+
+	bool driveScriptExists(const std::string& name) {
+		return findScript(name) != nullptr;
+	}
+
+	std::string driveScriptNames() {
+		std::string names;
+		for (const NamedScript& script : SCRIPTS) {
+			names += names.empty() ? "" : ", ";
+			names += script.name;
+		}
+		return names;
+	}
+
+	DriveScripts::DriveScripts() = default;
+	DriveScripts::~DriveScripts() = default;
+
+	bool DriveScripts::start(const std::string& name, std::size_t carCount, float tickDt, const CarParams& params) {
+		const NamedScript* named = findScript(name);
+		if (named == nullptr) {
+			std::cerr << "Error: no drive script named " << name << " (" << driveScriptNames() << ")\n";
+			return false;
+		}
+
+		auto scripts = std::make_unique<Scripts>();
+		scripts->slots.resize(carCount);
+		scripts->tasks.reserve(carCount);
+		for (std::size_t car = 0U; car < carCount; ++car) {
+			script::DriveSlot& slot = scripts->slots[car];
+			slot.tickDt = tickDt;
+			slot.turnRate = params.turnRate;
+			scripts->tasks.push_back(named->start(static_cast<std::uint32_t>(car)));
+			scripts->tasks.back().bind(slot);
+		}
+		m_scripts = std::move(scripts);
+		return true;
+	}
+
+	void DriveScripts::resume(std::size_t begin, std::size_t end, std::uint64_t tick, CarInput* inputs) {
+		for (std::size_t car = begin; car < end; ++car) {
+			script::DriveSlot& slot = m_scripts->slots[car];
+			if (tick >= slot.resumeTick) {
+				slot.now = tick;
+				if (!m_scripts->tasks[car].resume()) {
+					slot.held = 0U;
+					slot.resumeTick = FINISHED;
+				}
+			}
+			inputs[car] = slot.held;
+		}
+	}
+
+	std::size_t DriveScripts::carCount() const noexcept {
+		return m_scripts ? m_scripts->slots.size() : 0U;
+	}
+
+} // namespace sim
@@ -0,0 +1,65 @@
+/*
+==============================================================================
+Drive Script - fleet cars driven by coroutine scripts instead of the trace
+==============================================================================
+ - The built-in scripts ("lap", "shuttle", "slalom") are C++20 coroutines
+   (DriveCoroutine.hpp); each car runs its own, started with its car index
+   so the fleet does not move in lockstep
+ - DriveScripts owns one script and one DriveSlot per car; the fleet calls
+   resume() once per fixed tick for a car range, so the workers of its
+   chunks never share a car and scripts need no locking
+ - Only a script whose wait is over is resumed; every other car keeps the
+   input it holds
+ - This header stays C++17 for the rest of the core: only DriveScript.cpp
+   is built as C++20
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "CarModel.hpp"
+
+namespace sim {
+
+	[[nodiscard]] bool driveScriptExists(const std::string& name);
+
+	/**
+	 * @brief The built-in script names, comma-separated, for messages.
+	 */
+	[[nodiscard]] std::string driveScriptNames();
+
+	class DriveScripts {
+	public:
+		DriveScripts();
+		~DriveScripts();
+
+		DriveScripts(const DriveScripts&) = delete;
+		DriveScripts& operator=(const DriveScripts&) = delete;
+
+		/**
+		 * @brief Starts script name for carCount cars; turns follow params.turnRate.
+		 *
+		 * MISRA: an unknown name starts nothing and returns false (logged).
+		 */
+		[[nodiscard]] bool start(const std::string& name, std::size_t carCount, float tickDt, const CarParams& params);
+
+		/**
+		 * @brief Resumes the scripts of cars [begin, end) due at tick, then writes each car's input.
+		 *
+		 * Ticks must not go backwards; ranges may run on different threads.
+		 */
+		void resume(std::size_t begin, std::size_t end, std::uint64_t tick, CarInput* inputs);
+
+		[[nodiscard]] std::size_t carCount() const noexcept;
+
+	private:
+		struct Scripts; // coroutine handles: C++20 types, kept out of this header
+		std::unique_ptr<Scripts> m_scripts;
+	};
+
+} // namespace sim
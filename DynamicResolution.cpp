@@ -0,0 +1,63 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gfx {
+
+	namespace {
+		// Weight of the newest frame in the average; about a dozen frames of memory
+		constexpr float RESOLUTION_SMOOTHING = 0.15F;
+	}
+
+	DynamicResolution::DynamicResolution(const ResolutionSettings& settings, float initialScale)
+		: m_settings(settings) {
+		m_settings.step = std::max(m_settings.step, 0.01F);
+		m_settings.minScale = std::clamp(m_settings.minScale, m_settings.step, 1.0F);
+		m_settings.maxScale = std::clamp(m_settings.maxScale, m_settings.minScale, 1.0F);
+		m_scale = quantize(initialScale);
+	}
+
+	float DynamicResolution::quantize(float scale) const noexcept {
+		const float steps = std::floor(scale / m_settings.step + 0.5F);
+		return std::clamp(steps * m_settings.step, m_settings.minScale, m_settings.maxScale);
+	}
+
+	bool DynamicResolution::update(float gpuMs) noexcept {
+		if (!std::isfinite(gpuMs) || gpuMs < 0.0F) {
+			return false;
+		}
+		if (m_settle > 0U) {
+			--m_settle;
+			return false;
+		}
+		m_averageMs = m_primed ? m_averageMs + RESOLUTION_SMOOTHING * (gpuMs - m_averageMs) : gpuMs;
+		m_primed = true;
+
+		float next = m_scale;
+		if (m_averageMs > m_settings.targetMs) {
+			// Fill cost follows the pixel count, the square of the scale; round down so one drop suffices
+			const float wanted = m_scale * std::sqrt(m_settings.targetMs / m_averageMs);
+			next = std::clamp(std::floor(wanted / m_settings.step) * m_settings.step, m_settings.minScale, m_settings.maxScale);
+			m_underFrames = 0U;
+		}
+		else if (m_averageMs < m_settings.targetMs * m_settings.headroom) {
+			if (++m_underFrames >= m_settings.climbFrames) {
+				next = quantize(m_scale + m_settings.step);
+				m_underFrames = 0U;
+			}
+		}
+		else {
+			m_underFrames = 0U;
+		}
+
+		if (std::fabs(next - m_scale) < m_settings.step * 0.5F) {
+			return false;
+		}
+		m_scale = next;
+		m_primed = false; // the old size's timings say little about the new one
+		m_settle = m_settings.settleFrames;
+		return true;
+	}
+
+} // namespace gfx
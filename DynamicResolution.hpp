@@ -0,0 +1,60 @@
+/*
+==============================================================================
+Dynamic Resolution - render scale steered by the measured GPU frame time
+==============================================================================
+ - Fed one GPU frame time per frame; keeps a smoothed average and picks
+   the internal render scale (per axis, so the pixel count goes with its
+   square) that brings the average under the target
+ - Over budget it drops at once to the scale the square-root rule
+   predicts; under budget by the headroom for a while it climbs back one
+   step, so it settles instead of oscillating around the target
+ - Scales are whole multiples of the step: every change costs a render
+   texture resize, so only real changes are reported
+ - After a change it waits a few frames for timings of the new size
+ - No SFML or GL dependency; the front-end measures and resizes
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace gfx {
+
+	struct ResolutionSettings {
+		float targetMs = 12.0F; // GPU time per frame to stay under
+		float minScale = 0.5F;
+		float maxScale = 1.0F;
+		float step = 0.05F;     // scales are multiples of this
+		float headroom = 0.8F;  // climb only while under targetMs * headroom
+		std::uint32_t climbFrames = 30U; // consecutive frames under headroom before a step up
+		std::uint32_t settleFrames = 8U; // frames ignored after a change
+	};
+
+	class DynamicResolution {
+	public:
+		explicit DynamicResolution(const ResolutionSettings& settings = {}, float initialScale = 1.0F);
+
+		/**
+		 * @brief One frame's GPU time; returns true if scale() changed.
+		 *
+		 * MISRA: negative or non-finite times are ignored.
+		 */
+		bool update(float gpuMs) noexcept;
+
+		[[nodiscard]] float scale() const noexcept { return m_scale; }
+		[[nodiscard]] float averageMs() const noexcept { return m_averageMs; }
+		[[nodiscard]] const ResolutionSettings& settings() const noexcept { return m_settings; }
+
+	private:
+		[[nodiscard]] float quantize(float scale) const noexcept;
+
+		ResolutionSettings m_settings;
+		float m_scale = 1.0F;
+		float m_averageMs = 0.0F;
+		bool m_primed = false;          // the average holds at least one sample of this scale
+		std::uint32_t m_underFrames = 0U;
+		std::uint32_t m_settle = 0U;
+	};
+
+} // namespace gfx
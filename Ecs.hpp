@@ -0,0 +1,159 @@
+/*
+==============================================================================
+ECS - entities as handles, components in sparse sets
+==============================================================================
+ - An entity is only a handle (slot + generation, as in EntityPool); the
+   registry recycles slots and bumps the generation, so stale handles
+   are recognized
+ - Each component type lives in its own ComponentStore: the values are
+   packed in one array that systems walk front to back, a sparse array
+   maps an entity's slot to its position there
+ - Removing a component moves the last one into the hole, so stores stay
+   dense; positions are only stable while nothing is removed
+ - Any module can own extra stores for its own components, keyed by the
+   same entities, without touching the shared world
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "EntityPool.hpp"
+
+namespace sim {
+
+	using Entity = EntityHandle;
+
+	class EntityRegistry {
+	public:
+		[[nodiscard]] Entity create() {
+			++m_live;
+			if (!m_free.empty()) {
+				const std::uint32_t slot = m_free.back();
+				m_free.pop_back();
+				return { slot, m_generations[slot] };
+			}
+			m_generations.push_back(0U);
+			return { static_cast<std::uint32_t>(m_generations.size() - 1U), 0U };
+		}
+
+		/**
+		 * @brief Retires the handle; false for a stale one. Components are not touched.
+		 */
+		bool destroy(const Entity& entity) {
+			if (!alive(entity)) {
+				return false;
+			}
+			++m_generations[entity.slot];
+			m_free.push_back(entity.slot);
+			--m_live;
+			return true;
+		}
+
+		[[nodiscard]] bool alive(const Entity& entity) const noexcept {
+			return entity.slot < m_generations.size() && m_generations[entity.slot] == entity.generation;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_live; }
+
+	private:
+		std::vector<std::uint32_t> m_generations; // current generation of each slot
+		std::vector<std::uint32_t> m_free;
+		std::size_t m_live = 0U;
+	};
+
+	template <typename T>
+	class ComponentStore {
+	public:
+		static constexpr std::uint32_t NONE = EntityHandle::NONE;
+
+		void reserve(std::size_t count) {
+			m_dense.reserve(count);
+			m_entities.reserve(count);
+		}
+
+		/**
+		 * @brief Attaches value to entity, replacing the component it already has.
+		 */
+		T& add(const Entity& entity, T value) {
+			const std::uint32_t existing = indexOf(entity);
+			if (existing != NONE) {
+				m_dense[existing] = std::move(value);
+				return m_dense[existing];
+			}
+			if (entity.slot >= m_sparse.size()) {
+				m_sparse.resize(static_cast<std::size_t>(entity.slot) + 1U, NONE);
+			}
+			m_sparse[entity.slot] = static_cast<std::uint32_t>(m_dense.size());
+			m_dense.push_back(std::move(value));
+			m_entities.push_back(entity);
+			return m_dense.back();
+		}
+
+		/**
+		 * @brief Detaches the entity's component; false if it had none.
+		 */
+		bool remove(const Entity& entity) {
+			const std::uint32_t index = indexOf(entity);
+			if (index == NONE) {
+				return false;
+			}
+			const std::size_t last = m_dense.size() - 1U;
+			if (index != last) {
+				m_dense[index] = std::move(m_dense[last]);
+				m_entities[index] = m_entities[last];
+				m_sparse[m_entities[index].slot] = index;
+			}
+			m_dense.pop_back();
+			m_entities.pop_back();
+			m_sparse[entity.slot] = NONE;
+			return true;
+		}
+
+		/**
+		 * @brief Position of the entity's component in the dense array, NONE if it has none.
+		 */
+		[[nodiscard]] std::uint32_t indexOf(const Entity& entity) const noexcept {
+			if (entity.slot >= m_sparse.size()) {
+				return NONE;
+			}
+			const std::uint32_t index = m_sparse[entity.slot];
+			return (index != NONE && m_entities[index] == entity) ? index : NONE;
+		}
+
+		[[nodiscard]] bool has(const Entity& entity) const noexcept { return indexOf(entity) != NONE; }
+
+		[[nodiscard]] T* get(const Entity& entity) noexcept {
+			const std::uint32_t index = indexOf(entity);
+			return (index != NONE) ? &m_dense[index] : nullptr;
+		}
+		[[nodiscard]] const T* get(const Entity& entity) const noexcept {
+			const std::uint32_t index = indexOf(entity);
+			return (index != NONE) ? &m_dense[index] : nullptr;
+		}
+
+		// Dense access: i < size(), in no particular entity order
+		[[nodiscard]] T& operator[](std::size_t i) noexcept { return m_dense[i]; }
+		[[nodiscard]] const T& operator[](std::size_t i) const noexcept { return m_dense[i]; }
+		[[nodiscard]] const Entity& entityAt(std::size_t i) const noexcept { return m_entities[i]; }
+
+		[[nodiscard]] T* begin() noexcept { return m_dense.data(); }
+		[[nodiscard]] T* end() noexcept { return m_dense.data() + m_dense.size(); }
+		[[nodiscard]] const T* begin() const noexcept { return m_dense.data(); }
+		[[nodiscard]] const T* end() const noexcept { return m_dense.data() + m_dense.size(); }
+		[[nodiscard]] const std::vector<T>& values() const noexcept { return m_dense; }
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_dense.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_dense.empty(); }
+
+	private:
+		std::vector<std::uint32_t> m_sparse; // entity slot -> dense index, NONE without a component
+		std::vector<T> m_dense;
+		std::vector<Entity> m_entities;      // owner of each dense value
+	};
+
+} // namespace sim
@@ -0,0 +1,314 @@
+#include "EmbeddedCore.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Constants.hpp"
+#include "FastTrig.hpp"
+
+namespace sim {
+
+	namespace {
+		// Cell of coordinate value on an axis starting at origin, clamped into [0, count)
+		[[nodiscard]] int embeddedCell(float value, float origin, float invCellSize, int count) noexcept {
+			const float cell = (value - origin) * invCellSize;
+			if (!(cell > 0.0F)) { // also NaN
+				return 0;
+			}
+			return (cell >= static_cast<float>(count)) ? count - 1 : static_cast<int>(cell);
+		}
+
+		// parkOccupied() with the bay grown by margin on every side
+		[[nodiscard]] bool embeddedInside(const sf::FloatRect& car, const sf::FloatRect& bay, float margin) noexcept {
+			return car.position.x >= bay.position.x - margin
+				&& car.position.x + car.size.x <= bay.position.x + bay.size.x + margin
+				&& car.position.y >= bay.position.y - margin
+				&& car.position.y + car.size.y <= bay.position.y + bay.size.y + margin;
+		}
+	}
+
+	const char* embeddedStatusName(EmbeddedStatus status) noexcept {
+		switch (status) {
+		case EmbeddedStatus::Ok: return "ok";
+		case EmbeddedStatus::TooManySensors: return "more sensors than OKPP_EMBEDDED_MAX_SENSORS";
+		case EmbeddedStatus::TooManyObstacles: return "more pillars than OKPP_EMBEDDED_MAX_OBSTACLES";
+		case EmbeddedStatus::TooManyWalls: return "more walls than OKPP_EMBEDDED_MAX_WALLS";
+		case EmbeddedStatus::TooManyBays: return "more bays than OKPP_EMBEDDED_MAX_BAYS";
+		case EmbeddedStatus::TooManyBands: return "more warning bands in a zone than EMBEDDED_MAX_BANDS";
+		case EmbeddedStatus::NoRange: return "no warning band in any zone";
+		default: return "?";
+		}
+	}
+
+	EmbeddedStatus EmbeddedCore::init(const EmbeddedConfig& config) noexcept {
+		m_ready = false;
+		m_output = EmbeddedOutput{};
+		m_untilBeep = 0.0F;
+
+		if (config.mountCount > EMBEDDED_MAX_SENSORS) {
+			return EmbeddedStatus::TooManySensors;
+		}
+		if (config.obstacleCount > EMBEDDED_MAX_OBSTACLES) {
+			return EmbeddedStatus::TooManyObstacles;
+		}
+		if (config.wallCount > EMBEDDED_MAX_WALLS) {
+			return EmbeddedStatus::TooManyWalls;
+		}
+		if (config.bayCount > EMBEDDED_MAX_BAYS) {
+			return EmbeddedStatus::TooManyBays;
+		}
+
+		// Bands nearest first, so the first one a distance falls within is its interval
+		std::array<std::array<WarningBand, EMBEDDED_MAX_BANDS>, SENSOR_ZONE_COUNT> sorted{};
+		m_range = 0.0F;
+		for (std::size_t zone = 0U; zone < SENSOR_ZONE_COUNT; ++zone) {
+			const std::size_t count = config.bandCounts[zone];
+			if (count > EMBEDDED_MAX_BANDS) {
+				return EmbeddedStatus::TooManyBands;
+			}
+			std::copy_n(config.bands[zone], count, sorted[zone].begin());
+			std::sort(sorted[zone].begin(), sorted[zone].begin() + count, [](const WarningBand& a, const WarningBand& b) {
+				return a.maxDistance < b.maxDistance;
+			});
+			if (count > 0U) {
+				m_range = std::max(m_range, sorted[zone][count - 1U].maxDistance);
+			}
+		}
+		if (!(m_range > 0.0F)) {
+			return EmbeddedStatus::NoRange;
+		}
+
+		// As WarningProfile::compile(): the last slot starts exactly at range^2
+		const float rangeSq = m_range * m_range;
+		const float stepSq = rangeSq / static_cast<float>(EMBEDDED_TABLE_SIZE - 1U);
+		m_slotsPerSq = 1.0F / stepSq;
+		for (std::size_t slot = 0U; slot < EMBEDDED_TABLE_SIZE; ++slot) {
+			const float nearEdgeSq = static_cast<float>(slot) * stepSq;
+			for (std::size_t zone = 0U; zone < SENSOR_ZONE_COUNT; ++zone) {
+				float interval = 0.0F;
+				for (std::size_t band = 0U; band < config.bandCounts[zone]; ++band) {
+					const float maxDistance = sorted[zone][band].maxDistance;
+					if (nearEdgeSq <= maxDistance * maxDistance) {
+						interval = sorted[zone][band].interval;
+						break;
+					}
+				}
+				m_table[zone * EMBEDDED_TABLE_SIZE + slot] = interval;
+			}
+		}
+
+		m_mounts.clear();
+		for (std::size_t i = 0U; i < config.mountCount; ++i) {
+			(void)m_mounts.push_back(config.mounts[i]);
+		}
+		m_walls.clear();
+		for (std::size_t i = 0U; i < config.wallCount; ++i) {
+			const WallSegment& wall = config.walls[i];
+			const sf::Vector2f along = wall.to - wall.from;
+			const float lengthSq = along.x * along.x + along.y * along.y;
+			(void)m_walls.push_back({ wall.from, along, (lengthSq > 0.0F) ? 1.0F / lengthSq : 0.0F, wall.oneSided });
+		}
+		m_bays.clear();
+		for (std::size_t i = 0U; i < config.bayCount; ++i) {
+			(void)m_bays.push_back(config.bays[i]);
+		}
+		m_carHalfExtent = config.carHalfExtent;
+
+		const EmbeddedStatus grid = buildGrid(config.obstacles, config.obstacleCount);
+		if (grid != EmbeddedStatus::Ok) {
+			return grid;
+		}
+
+		// Sized once: step() only overwrites
+		(void)m_output.poses.resize(m_mounts.size());
+		(void)m_output.readings.resize(m_mounts.size());
+		m_ready = true;
+		return EmbeddedStatus::Ok;
+	}
+
+	EmbeddedStatus EmbeddedCore::buildGrid(const Obstacle* obstacles, std::size_t count) noexcept {
+		m_arena.reset();
+		m_pointCount = 0U;
+		m_cols = 0;
+		m_rows = 0;
+		if (count == 0U) {
+			return EmbeddedStatus::Ok;
+		}
+
+		sf::Vector2f low = obstacles[0].center;
+		sf::Vector2f high = obstacles[0].center;
+		for (std::size_t i = 1U; i < count; ++i) {
+			low = { std::min(low.x, obstacles[i].center.x), std::min(low.y, obstacles[i].center.y) };
+			high = { std::max(high.x, obstacles[i].center.x), std::max(high.y, obstacles[i].center.y) };
+		}
+
+		// Cells one beep range wide, so a search looks at no more than 3 x 3 of them;
+		// doubled until the lot fits EMBEDDED_MAX_CELLS
+		float cellSize = m_range;
+		const auto cellsAlong = [&cellSize](float extent) {
+			return static_cast<std::size_t>(std::max(extent, 0.0F) / cellSize) + 1U;
+		};
+		while (cellsAlong(high.x - low.x) * cellsAlong(high.y - low.y) > EMBEDDED_MAX_CELLS) {
+			cellSize *= 2.0F;
+		}
+		m_origin = low;
+		m_invCellSize = 1.0F / cellSize;
+		m_cols = static_cast<int>(cellsAlong(high.x - low.x));
+		m_rows = static_cast<int>(cellsAlong(high.y - low.y));
+		const std::size_t cells = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+
+		std::uint32_t* const start = m_arena.allocate<std::uint32_t>(cells + 1U);
+		sf::Vector2f* const points = m_arena.allocate<sf::Vector2f>(count);
+		std::uint32_t* const ids = m_arena.allocate<std::uint32_t>(count);
+		if (start == nullptr || points == nullptr || ids == nullptr) {
+			return EmbeddedStatus::TooManyObstacles;
+		}
+
+		// Counting sort by cell: counts, prefix sums, then each start advanced past its cell's entries
+		const auto cellOf = [this](const sf::Vector2f& center) {
+			return static_cast<std::size_t>(embeddedCell(center.y, m_origin.y, m_invCellSize, m_rows))
+				* static_cast<std::size_t>(m_cols)
+				+ static_cast<std::size_t>(embeddedCell(center.x, m_origin.x, m_invCellSize, m_cols));
+		};
+		std::fill_n(start, cells + 1U, 0U);
+		for (std::size_t i = 0U; i < count; ++i) {
+			++start[cellOf(obstacles[i].center) + 1U];
+		}
+		for (std::size_t c = 0U; c < cells; ++c) {
+			start[c + 1U] += start[c];
+		}
+		for (std::size_t i = 0U; i < count; ++i) {
+			const std::uint32_t slot = start[cellOf(obstacles[i].center)]++;
+			points[slot] = obstacles[i].center;
+			ids[slot] = static_cast<std::uint32_t>(i);
+		}
+		for (std::size_t c = cells; c > 0U; --c) {
+			start[c] = start[c - 1U];
+		}
+		start[0] = 0U;
+
+		m_cellStart = start;
+		m_points = points;
+		m_ids = ids;
+		m_pointCount = count;
+		return EmbeddedStatus::Ok;
+	}
+
+	SensorReading EmbeddedCore::read(const sf::Vector2f& position) const noexcept {
+		const float limitSq = m_range * m_range;
+		SensorReading reading;
+
+		if (m_pointCount > 0U) {
+			float bestSq = limitSq;
+			const int x0 = embeddedCell(position.x - m_range, m_origin.x, m_invCellSize, m_cols);
+			const int x1 = embeddedCell(position.x + m_range, m_origin.x, m_invCellSize, m_cols);
+			const int y0 = embeddedCell(position.y - m_range, m_origin.y, m_invCellSize, m_rows);
+			const int y1 = embeddedCell(position.y + m_range, m_origin.y, m_invCellSize, m_rows);
+			for (int y = y0; y <= y1; ++y) {
+				for (int x = x0; x <= x1; ++x) {
+					const std::size_t cell = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cols)
+						+ static_cast<std::size_t>(x);
+					for (std::uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1U]; ++i) {
+						const float dx = m_points[i].x - position.x;
+						const float dy = m_points[i].y - position.y;
+						const float distanceSq = dx * dx + dy * dy;
+						if (distanceSq < bestSq) {
+							bestSq = distanceSq;
+							reading.obstacle = m_ids[i];
+						}
+					}
+				}
+			}
+			if (bestSq < limitSq) {
+				reading.distanceSq = bestSq;
+			}
+		}
+
+		// ObstacleGrid::nearerWall() over every wall; a head unit's lot has few
+		float wallSq = limitSq;
+		for (const EmbeddedWall& wall : m_walls) {
+			const sf::Vector2f offset = position - wall.from;
+			const float t = (offset.x * wall.along.x + offset.y * wall.along.y) * wall.invLengthSq;
+			const float clamped = std::clamp(t, 0.0F, 1.0F);
+			const float dx = offset.x - clamped * wall.along.x;
+			const float dy = offset.y - clamped * wall.along.y;
+			const float distanceSq = dx * dx + dy * dy;
+			if (distanceSq >= limitSq) {
+				continue;
+			}
+			const bool behind = wall.oneSided != 0U && t == clamped
+				&& wall.along.x * offset.y - wall.along.y * offset.x <= 0.0F;
+			wallSq = behind ? 0.0F : std::min(wallSq, distanceSq);
+		}
+		if (wallSq < limitSq) {
+			reading.wallDistance = std::sqrt(wallSq);
+		}
+		return reading;
+	}
+
+	std::uint32_t EmbeddedCore::findBay(const CarState& car) const noexcept {
+		// carBounds(): the axis-aligned box around the car at its heading
+		const SinCos heading = sinCosDeg(car.headingDeg);
+		const float c = std::fabs(heading.cos);
+		const float s = std::fabs(heading.sin);
+		const sf::Vector2f half{ c * m_carHalfExtent.x + s * m_carHalfExtent.y, s * m_carHalfExtent.x + c * m_carHalfExtent.y };
+		const sf::FloatRect bounds{ car.position - half, half * 2.0F };
+
+		// A parked car keeps its bay until it is PARK_HYSTERESIS outside it
+		const std::uint32_t parked = m_output.parkedBay;
+		if (parked < m_bays.size() && embeddedInside(bounds, m_bays[parked], constants::PARK_HYSTERESIS)) {
+			return parked;
+		}
+		for (std::size_t bay = 0U; bay < m_bays.size(); ++bay) {
+			if (embeddedInside(bounds, m_bays[bay], 0.0F)) {
+				return static_cast<std::uint32_t>(bay);
+			}
+		}
+		return NO_BAY;
+	}
+
+	const EmbeddedOutput& EmbeddedCore::step(const CarState& car, float dt) noexcept {
+		if (!m_ready) {
+			return m_output;
+		}
+
+		// placeSensors() under carTransform(): the same products in the same order
+		const SinCos heading = sinCosDeg(car.headingDeg);
+		float interval = 0.0F;
+		for (std::size_t i = 0U; i < m_mounts.size(); ++i) {
+			const SensorMount& mount = m_mounts[i];
+			SensorPose& pose = m_output.poses[i];
+			pose.position = { heading.cos * mount.offset.x + -heading.sin * mount.offset.y + car.position.x,
+				heading.sin * mount.offset.x + heading.cos * mount.offset.y + car.position.y };
+			pose.rotationDeg = mount.rotationDeg + car.headingDeg;
+
+			const SensorReading reading = read(pose.position);
+			m_output.readings[i] = reading;
+			const float slot = reading.distanceSq * m_slotsPerSq;
+			if (slot < static_cast<float>(EMBEDDED_TABLE_SIZE)) {
+				interval = moreUrgent(interval,
+					m_table[static_cast<std::size_t>(mount.zone) * EMBEDDED_TABLE_SIZE + static_cast<std::size_t>(slot)]);
+			}
+		}
+
+		// First beep as soon as something is in range, then one per interval; a
+		// shorter interval takes over from the next beep on
+		m_output.interval = interval;
+		m_output.beep = false;
+		if (interval > 0.0F) {
+			m_untilBeep -= dt;
+			if (m_untilBeep <= 0.0F) {
+				m_output.beep = true;
+				m_untilBeep = std::max(m_untilBeep + interval, 0.0F);
+			}
+		}
+		else {
+			m_untilBeep = 0.0F;
+		}
+
+		m_output.parkedBay = findBay(car);
+		return m_output;
+	}
+
+} // namespace sim
@@ -0,0 +1,179 @@
+/*
+==============================================================================
+Embedded Core - the sensor, beep and parking pipeline for small head units
+==============================================================================
+ - The warning logic of the simulation on its own, for an ARM head unit:
+   built as okpp_embedded without exceptions and without RTTI, and with
+   OKPP_EMBEDDED_ONLY as the only target besides its allocation gate
+ - All storage is fixed at compile time: sensors, readings, walls and bays
+   in FixedVector, the pillars and their grid in a StaticArena, the beep
+   table in std::array. init() copies the lot in once; step() never
+   allocates, which OKPP_LV1_embedded checks on every build
+ - Capacities default to a large parking garage and can be overridden with
+   the OKPP_EMBEDDED_MAX_* definitions; a lot that does not fit is refused
+   by init() with a status, never truncated
+ - step() is the core's tick in one call: places the sensors from their
+   mounts (FastTrig, no libm), reads the nearest pillar and wall of each
+   (same squared distances to pillar centers as ObstacleGrid), looks the
+   beep interval up per zone, times the beeps and judges parking with the
+   axis-aligned parkOccupied() test, a parked car keeping its bay within
+   PARK_HYSTERESIS
+ - The beep table is compiled like WarningProfile's, at EMBEDDED_TABLE_SIZE
+   slots per zone instead of 1024; slots still resolve at their near edge
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "CarModel.hpp"
+#include "FixedVector.hpp"
+#include "SimTypes.hpp"
+#include "StaticArena.hpp"
+#include "WarningProfile.hpp"
+
+#ifndef OKPP_EMBEDDED_MAX_SENSORS
+#define OKPP_EMBEDDED_MAX_SENSORS 16
+#endif
+#ifndef OKPP_EMBEDDED_MAX_OBSTACLES
+#define OKPP_EMBEDDED_MAX_OBSTACLES 1024
+#endif
+#ifndef OKPP_EMBEDDED_MAX_WALLS
+#define OKPP_EMBEDDED_MAX_WALLS 64
+#endif
+#ifndef OKPP_EMBEDDED_MAX_BAYS
+#define OKPP_EMBEDDED_MAX_BAYS 64
+#endif
+
+namespace sim {
+
+	constexpr std::size_t EMBEDDED_MAX_SENSORS = OKPP_EMBEDDED_MAX_SENSORS;
+	constexpr std::size_t EMBEDDED_MAX_OBSTACLES = OKPP_EMBEDDED_MAX_OBSTACLES;
+	constexpr std::size_t EMBEDDED_MAX_WALLS = OKPP_EMBEDDED_MAX_WALLS;
+	constexpr std::size_t EMBEDDED_MAX_BAYS = OKPP_EMBEDDED_MAX_BAYS;
+	constexpr std::size_t EMBEDDED_MAX_BANDS = 8U;   // warning bands per zone
+	constexpr std::size_t EMBEDDED_MAX_CELLS = 1024U; // pillar grid cells; a larger lot gets larger cells
+	constexpr std::size_t EMBEDDED_TABLE_SIZE = 256U; // beep table slots per zone
+
+	// Index marking "not parked in any bay"
+	constexpr std::uint32_t NO_BAY = 0xFFFFFFFFU;
+
+	enum class EmbeddedStatus : std::uint8_t {
+		Ok,
+		TooManySensors,
+		TooManyObstacles,
+		TooManyWalls,
+		TooManyBays,
+		TooManyBands,
+		NoRange // no zone has a band, so nothing could ever beep
+	};
+
+	/**
+	 * @brief Lower-case description of a status, for logs.
+	 */
+	[[nodiscard]] const char* embeddedStatusName(EmbeddedStatus status) noexcept;
+
+	// The lot and the vehicle, as plain arrays; only read during init()
+	struct EmbeddedConfig {
+		const SensorMount* mounts = nullptr;
+		std::size_t mountCount = 0U;
+		const Obstacle* obstacles = nullptr;
+		std::size_t obstacleCount = 0U;
+		const WallSegment* walls = nullptr;
+		std::size_t wallCount = 0U;
+		const sf::FloatRect* bays = nullptr;
+		std::size_t bayCount = 0U;
+		std::array<const WarningBand*, SENSOR_ZONE_COUNT> bands{}; // per zone, in any order
+		std::array<std::size_t, SENSOR_ZONE_COUNT> bandCounts{};
+		sf::Vector2f carHalfExtent{ 0.0F, 0.0F };
+	};
+
+	// What one step() produced; valid until the next step()
+	struct EmbeddedOutput {
+		FixedVector<SensorPose, EMBEDDED_MAX_SENSORS> poses;
+		FixedVector<SensorReading, EMBEDDED_MAX_SENSORS> readings;
+		float interval = 0.0F;          // most urgent beep interval, 0 = silent
+		bool beep = false;              // a beep is due this step
+		std::uint32_t parkedBay = NO_BAY;
+	};
+
+	class EmbeddedCore {
+	public:
+		EmbeddedCore() = default;
+
+		EmbeddedCore(const EmbeddedCore&) = delete;
+		EmbeddedCore& operator=(const EmbeddedCore&) = delete;
+
+		/**
+		 * @brief Copies the lot and compiles the beep table; the only call that fills storage.
+		 *
+		 * MISRA: anything other than Ok leaves the core silent (step() reports
+		 *        nothing) until an init() succeeds.
+		 */
+		[[nodiscard]] EmbeddedStatus init(const EmbeddedConfig& config) noexcept;
+
+		/**
+		 * @brief One tick of dt seconds with the car at pose.
+		 */
+		const EmbeddedOutput& step(const CarState& car, float dt) noexcept;
+
+		[[nodiscard]] const EmbeddedOutput& output() const noexcept { return m_output; }
+		[[nodiscard]] bool ready() const noexcept { return m_ready; }
+
+		/**
+		 * @brief Farthest distance any zone beeps at; sensors search no farther.
+		 */
+		[[nodiscard]] float range() const noexcept { return m_range; }
+
+		/**
+		 * @brief Arena bytes the pillars and their grid took, of EMBEDDED_ARENA_BYTES.
+		 */
+		[[nodiscard]] std::size_t arenaUsed() const noexcept { return m_arena.used(); }
+
+		// Pillar centers, their ids by cell and the cell starts, at their largest
+		static constexpr std::size_t EMBEDDED_ARENA_BYTES = EMBEDDED_MAX_OBSTACLES * (sizeof(sf::Vector2f) + sizeof(std::uint32_t))
+			+ (EMBEDDED_MAX_CELLS + 1U) * sizeof(std::uint32_t) + 2U * alignof(std::max_align_t);
+
+	private:
+		// A wall prepared for the distance test, as ObstacleGrid keeps it
+		struct EmbeddedWall {
+			sf::Vector2f from{ 0.0F, 0.0F };
+			sf::Vector2f along{ 0.0F, 0.0F };
+			float invLengthSq = 0.0F;
+			std::uint32_t oneSided = 0U;
+		};
+
+		[[nodiscard]] EmbeddedStatus buildGrid(const Obstacle* obstacles, std::size_t count) noexcept;
+		[[nodiscard]] SensorReading read(const sf::Vector2f& position) const noexcept;
+		[[nodiscard]] std::uint32_t findBay(const CarState& car) const noexcept;
+
+		FixedVector<SensorMount, EMBEDDED_MAX_SENSORS> m_mounts;
+		FixedVector<EmbeddedWall, EMBEDDED_MAX_WALLS> m_walls;
+		FixedVector<sf::FloatRect, EMBEDDED_MAX_BAYS> m_bays;
+		std::array<float, SENSOR_ZONE_COUNT * EMBEDDED_TABLE_SIZE> m_table{};
+		float m_slotsPerSq = 0.0F;
+		float m_range = 0.0F;
+		sf::Vector2f m_carHalfExtent{ 0.0F, 0.0F };
+
+		StaticArena<EMBEDDED_ARENA_BYTES> m_arena;
+		const sf::Vector2f* m_points = nullptr;   // pillar centers, grouped by cell
+		const std::uint32_t* m_ids = nullptr;     // scene index of each grouped center
+		const std::uint32_t* m_cellStart = nullptr; // cells + 1 offsets into m_points
+		std::size_t m_pointCount = 0U;
+		sf::Vector2f m_origin{ 0.0F, 0.0F };
+		float m_invCellSize = 0.0F;
+		int m_cols = 0;
+		int m_rows = 0;
+
+		float m_untilBeep = 0.0F; // seconds to the next beep while an interval is set
+		EmbeddedOutput m_output;
+		bool m_ready = false;
+	};
+
+} // namespace sim
@@ -0,0 +1,159 @@
+/*
+==============================================================================
+Entity Pool - O(1) spawn and despawn behind stable, generation-checked handles
+==============================================================================
+ - Live values are packed in one array, so iterating them touches no holes
+   and no dead entries; despawn moves the last value into the hole
+ - A handle names a slot, not an array position: the slot records where
+   its value currently sits, so handles survive other despawns
+ - Freed slots go on a free list and are reused by the next spawn; each
+   reuse bumps the slot's generation, so a handle kept past its despawn
+   is detected instead of silently naming the new occupant
+ - Storage only grows (geometrically, or once with reserve()), so a scene
+   that spawns and despawns at a steady rate stops allocating
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace sim {
+
+	struct EntityHandle {
+		static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+		std::uint32_t slot = NONE;
+		std::uint32_t generation = 0U;
+
+		[[nodiscard]] bool valid() const noexcept { return slot != NONE; }
+		[[nodiscard]] bool operator==(const EntityHandle& other) const noexcept {
+			return slot == other.slot && generation == other.generation;
+		}
+		[[nodiscard]] bool operator!=(const EntityHandle& other) const noexcept { return !(*this == other); }
+	};
+
+	template <typename T>
+	class EntityPool {
+	public:
+		/**
+		 * @brief Makes room for count live entities without further allocation.
+		 */
+		void reserve(std::size_t count) {
+			m_values.reserve(count);
+			m_owners.reserve(count);
+			m_slots.reserve(count);
+		}
+
+		/**
+		 * @brief Adds a value; reuses a freed slot if there is one.
+		 */
+		template <typename... Args>
+		[[nodiscard]] EntityHandle spawn(Args&&... args) {
+			std::uint32_t slot = m_freeHead;
+			if (slot != EntityHandle::NONE) {
+				m_freeHead = m_slots[slot].dense;
+			}
+			else {
+				slot = static_cast<std::uint32_t>(m_slots.size());
+				m_slots.push_back({});
+			}
+
+			m_slots[slot].dense = static_cast<std::uint32_t>(m_values.size());
+			m_values.emplace_back(std::forward<Args>(args)...);
+			m_owners.push_back(slot);
+			return { slot, m_slots[slot].generation };
+		}
+
+		/**
+		 * @brief Removes the entity; false (nothing changes) for a stale or empty handle.
+		 *
+		 * The last live value moves into the freed position, so dense order
+		 * is not preserved.
+		 */
+		bool despawn(const EntityHandle& handle) {
+			if (!alive(handle)) {
+				return false;
+			}
+
+			const std::uint32_t dense = m_slots[handle.slot].dense;
+			const std::uint32_t last = static_cast<std::uint32_t>(m_values.size() - 1U);
+			if (dense != last) {
+				m_values[dense] = std::move(m_values[last]);
+				m_owners[dense] = m_owners[last];
+				m_slots[m_owners[dense]].dense = dense;
+			}
+			m_values.pop_back();
+			m_owners.pop_back();
+
+			Slot& slot = m_slots[handle.slot];
+			++slot.generation;
+			slot.dense = m_freeHead;
+			m_freeHead = handle.slot;
+			return true;
+		}
+
+		[[nodiscard]] bool alive(const EntityHandle& handle) const noexcept {
+			return handle.slot < m_slots.size() && m_slots[handle.slot].generation == handle.generation
+				&& isLive(handle.slot);
+		}
+
+		/**
+		 * @brief The entity's value, or null for a stale handle. Valid until the next spawn or despawn.
+		 */
+		[[nodiscard]] T* get(const EntityHandle& handle) noexcept {
+			return alive(handle) ? &m_values[m_slots[handle.slot].dense] : nullptr;
+		}
+		[[nodiscard]] const T* get(const EntityHandle& handle) const noexcept {
+			return alive(handle) ? &m_values[m_slots[handle.slot].dense] : nullptr;
+		}
+
+		/**
+		 * @brief Handle of the live value at dense position i (i < size()).
+		 */
+		[[nodiscard]] EntityHandle handleAt(std::size_t i) const noexcept {
+			const std::uint32_t slot = m_owners[i];
+			return { slot, m_slots[slot].generation };
+		}
+
+		/**
+		 * @brief Despawns everything; handles given out so far all go stale.
+		 */
+		void clear() {
+			for (std::size_t i = m_values.size(); i-- > 0U;) {
+				(void)despawn(handleAt(i));
+			}
+		}
+
+		// Dense iteration over the live values only
+		[[nodiscard]] T* begin() noexcept { return m_values.data(); }
+		[[nodiscard]] T* end() noexcept { return m_values.data() + m_values.size(); }
+		[[nodiscard]] const T* begin() const noexcept { return m_values.data(); }
+		[[nodiscard]] const T* end() const noexcept { return m_values.data() + m_values.size(); }
+		[[nodiscard]] const std::vector<T>& values() const noexcept { return m_values; }
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_values.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_values.empty(); }
+
+	private:
+		struct Slot {
+			std::uint32_t dense = 0U;      // position in m_values while live, next free slot otherwise
+			std::uint32_t generation = 0U; // bumped on every despawn
+		};
+
+		[[nodiscard]] bool isLive(std::uint32_t slot) const noexcept {
+			const std::uint32_t dense = m_slots[slot].dense;
+			return dense < m_owners.size() && m_owners[dense] == slot;
+		}
+
+		std::vector<T> m_values;
+		std::vector<std::uint32_t> m_owners; // slot of each live value
+		std::vector<Slot> m_slots;
+		std::uint32_t m_freeHead = EntityHandle::NONE;
+	};
+
+} // namespace sim
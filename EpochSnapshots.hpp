@@ -0,0 +1,201 @@
+/*
+==============================================================================
+Epoch Snapshots - immutable world snapshots shared with readers, no locks
+==============================================================================
+ - One writer fills a snapshot it alone can see (next()) and publish()
+   swaps it in as the current one with an atomic pointer exchange; readers
+   take the current pointer and read it in place, so a snapshot is filled
+   once however many readers there are, and nobody copies it again
+ - Reclamation by epochs: a reader pins the global epoch in its own slot
+   before it loads the pointer and clears the slot when it is done
+   (ReadGuard); the writer stamps every snapshot it replaces with the epoch
+   it was retired in, then advances the epoch. A retired snapshot is free
+   again once every pinned slot is past its stamp: no reader that could
+   still hold it is left
+ - Freed snapshots go back to the writer's free list and are refilled by a
+   later next(), so a steady writer allocates nothing once there are as
+   many snapshots as readers keep alive at once; a reader that stays pinned
+   only holds back the snapshots retired since it pinned
+ - Reader slots are claimed once (addReader()) and sit on cache lines of
+   their own; a slot serves one thread and one guard at a time
+ - Exactly one writer thread; readers on any threads; no SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "CacheAligned.hpp"
+
+namespace sim {
+
+	template <typename T, std::size_t MaxReaders = 8U>
+	class EpochSnapshots {
+		struct alignas(CACHE_LINE_BYTES) ReaderSlot {
+			std::atomic<std::uint64_t> epoch{ IDLE };
+			std::atomic<bool> claimed{ false };
+		};
+
+	public:
+		static constexpr std::uint64_t IDLE = std::numeric_limits<std::uint64_t>::max(); // slot pins nothing
+
+		// A pinned snapshot; the slot is released when the guard goes
+		class ReadGuard {
+		public:
+			ReadGuard() = default;
+			ReadGuard(ReadGuard&& other) noexcept
+				: m_slot(std::exchange(other.m_slot, nullptr)), m_snapshot(std::exchange(other.m_snapshot, nullptr)) {}
+			ReadGuard& operator=(ReadGuard&& other) noexcept {
+				if (this != &other) {
+					release();
+					m_slot = std::exchange(other.m_slot, nullptr);
+					m_snapshot = std::exchange(other.m_snapshot, nullptr);
+				}
+				return *this;
+			}
+			ReadGuard(const ReadGuard&) = delete;
+			ReadGuard& operator=(const ReadGuard&) = delete;
+			~ReadGuard() { release(); }
+
+			// Null until the writer's first publish()
+			[[nodiscard]] const T* get() const noexcept { return m_snapshot; }
+			[[nodiscard]] const T& operator*() const noexcept { return *m_snapshot; }
+			[[nodiscard]] const T* operator->() const noexcept { return m_snapshot; }
+			[[nodiscard]] explicit operator bool() const noexcept { return m_snapshot != nullptr; }
+
+		private:
+			friend class EpochSnapshots;
+
+			ReadGuard(ReaderSlot& slot, const T* snapshot) noexcept : m_slot(&slot), m_snapshot(snapshot) {}
+
+			void release() noexcept {
+				if (m_slot != nullptr) {
+					m_slot->epoch.store(IDLE, std::memory_order_release);
+					m_slot = nullptr;
+				}
+				m_snapshot = nullptr;
+			}
+
+			ReaderSlot* m_slot = nullptr;
+			const T* m_snapshot = nullptr;
+		};
+
+		EpochSnapshots() = default;
+		EpochSnapshots(const EpochSnapshots&) = delete;
+		EpochSnapshots& operator=(const EpochSnapshots&) = delete;
+
+		/**
+		 * @brief Claims a reader slot; nullopt if all MaxReaders are taken.
+		 */
+		[[nodiscard]] std::optional<std::size_t> addReader() noexcept {
+			for (std::size_t i = 0U; i < MaxReaders; ++i) {
+				bool expected = false;
+				if (m_readers[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+					return i;
+				}
+			}
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief Gives a slot back. MISRA: no guard of it may be alive.
+		 */
+		void removeReader(std::size_t reader) noexcept {
+			m_readers[reader].epoch.store(IDLE, std::memory_order_release);
+			m_readers[reader].claimed.store(false, std::memory_order_release);
+		}
+
+		/**
+		 * @brief Reader side: pins the current snapshot until the guard is destroyed.
+		 *
+		 * Wait-free. MISRA: one live guard per reader slot.
+		 */
+		[[nodiscard]] ReadGuard pin(std::size_t reader) noexcept {
+			ReaderSlot& slot = m_readers[reader];
+			// The slot is published before the pointer is read (both sequentially consistent), so
+			// a writer that sees the slot idle has already swapped out whatever it then frees
+			slot.epoch.store(m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+			return ReadGuard(slot, m_current.load(std::memory_order_seq_cst));
+		}
+
+		/**
+		 * @brief Writer side: the snapshot the next publish() makes current.
+		 *
+		 * A reclaimed one when there is one, so it holds an old state: fill all of it.
+		 * Repeated calls before publish() return the same snapshot.
+		 */
+		[[nodiscard]] T& next() {
+			if (m_next == nullptr) {
+				reclaim();
+				if (m_free.empty()) {
+					m_owned.push_back(std::make_unique<T>());
+					m_free.push_back(m_owned.back().get());
+				}
+				m_next = m_free.back();
+				m_free.pop_back();
+			}
+			return *m_next;
+		}
+
+		/**
+		 * @brief Writer side: makes the snapshot from next() current and retires the previous one.
+		 *
+		 * Never blocks; a no-op without a next() since the last publish().
+		 */
+		void publish() {
+			if (m_next == nullptr) {
+				return;
+			}
+			T* const previous = m_current.exchange(m_next, std::memory_order_seq_cst);
+			m_next = nullptr;
+			if (previous != nullptr) {
+				m_retired.push_back({ previous, m_epoch.load(std::memory_order_relaxed) });
+			}
+			m_epoch.fetch_add(1U, std::memory_order_seq_cst);
+			reclaim();
+		}
+
+		// Writer side: snapshots ever made, and those retired but still possibly read
+		[[nodiscard]] std::size_t allocated() const noexcept { return m_owned.size(); }
+		[[nodiscard]] std::size_t retired() const noexcept { return m_retired.size(); }
+
+	private:
+		// Frees the retired snapshots every pinned reader is past
+		void reclaim() {
+			std::uint64_t oldest = IDLE;
+			for (const ReaderSlot& slot : m_readers) {
+				const std::uint64_t pinned = slot.epoch.load(std::memory_order_seq_cst);
+				oldest = (pinned < oldest) ? pinned : oldest;
+			}
+			std::size_t kept = 0U;
+			for (const std::pair<T*, std::uint64_t>& entry : m_retired) {
+				if (entry.second < oldest) {
+					m_free.push_back(entry.first);
+				}
+				else {
+					m_retired[kept++] = entry;
+				}
+			}
+			m_retired.resize(kept);
+		}
+
+		ReaderSlot m_readers[MaxReaders];
+		alignas(CACHE_LINE_BYTES) std::atomic<T*> m_current{ nullptr };
+		std::atomic<std::uint64_t> m_epoch{ 0U };
+
+		// Writer only
+		std::vector<std::unique_ptr<T>> m_owned;
+		std::vector<T*> m_free;
+		std::vector<std::pair<T*, std::uint64_t>> m_retired; // snapshot, epoch it was retired in
+		T* m_next = nullptr;
+	};
+
+} // namespace sim
@@ -0,0 +1,249 @@
+#include "EventLog.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sim {
+
+	namespace detail {
+		std::atomic<bool> g_eventLogging{ false };
+	}
+
+	namespace {
+		constexpr char EVENT_MAGIC[8] = { 'O', 'K', 'E', 'V', 'T', '0', '0', '1' };
+
+		// 21 bytes per row: about 340 KiB per block, a few blocks per thread in flight
+		constexpr std::size_t BLOCK_ROWS = std::size_t{ 1 } << 14U;
+		constexpr std::size_t MAX_QUEUED_BLOCKS = 32U;
+
+		static_assert(sizeof(EventKind) == 1U, "event kinds are stored as one byte");
+
+		struct Registry {
+			std::mutex mutex;
+			std::condition_variable ready; // writer: a block was queued, or stop
+			std::condition_variable space; // producers: the queue has room again
+			std::vector<std::unique_ptr<EventColumns>> buffers; // one per thread, outlive their threads
+			std::deque<EventColumns> queue;
+			std::vector<EventColumns> spare; // written blocks, capacity kept
+			std::ofstream file;
+			std::thread writer;
+			bool stopping = false;
+			bool failed = false;
+			EventLogStats stats;
+		};
+
+		Registry& registry() {
+			static Registry instance;
+			return instance;
+		}
+
+		void reserveRows(EventColumns& block) {
+			block.tick.reserve(BLOCK_ROWS);
+			block.car.reserve(BLOCK_ROWS);
+			block.kind.reserve(BLOCK_ROWS);
+			block.bay.reserve(BLOCK_ROWS);
+			block.value.reserve(BLOCK_ROWS);
+		}
+
+		void clearRows(EventColumns& block) {
+			block.tick.clear();
+			block.car.clear();
+			block.kind.clear();
+			block.bay.clear();
+			block.value.clear();
+		}
+
+		EventColumns& localBlock() {
+			thread_local EventColumns* block = nullptr;
+			if (block == nullptr) {
+				Registry& reg = registry();
+				const std::lock_guard<std::mutex> lock(reg.mutex);
+				reg.buffers.push_back(std::make_unique<EventColumns>());
+				block = reg.buffers.back().get();
+				reserveRows(*block);
+			}
+			return *block;
+		}
+
+		template <typename T>
+		void writeColumn(std::ofstream& file, const std::vector<T>& column) {
+			file.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+		}
+
+		template <typename T>
+		[[nodiscard]] bool readColumn(std::ifstream& file, std::uint32_t rows, std::vector<T>& column) {
+			const std::size_t offset = column.size();
+			column.resize(offset + rows);
+			file.read(reinterpret_cast<char*>(column.data() + offset), static_cast<std::streamsize>(rows * sizeof(T)));
+			return static_cast<bool>(file);
+		}
+
+		void writeBlock(std::ofstream& file, const EventColumns& block) {
+			const auto rows = static_cast<std::uint32_t>(block.size());
+			file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+			writeColumn(file, block.tick);
+			writeColumn(file, block.car);
+			writeColumn(file, block.kind);
+			writeColumn(file, block.bay);
+			writeColumn(file, block.value);
+		}
+
+		// Caller holds the registry lock; the block leaves with its rows and comes back empty
+		void enqueue(Registry& reg, EventColumns& block) {
+			reg.queue.push_back(std::move(block));
+			if (reg.spare.empty()) {
+				block = EventColumns{};
+				reserveRows(block);
+			}
+			else {
+				block = std::move(reg.spare.back());
+				reg.spare.pop_back();
+			}
+			reg.ready.notify_one();
+		}
+
+		void writerLoop() {
+			Registry& reg = registry();
+			std::unique_lock<std::mutex> lock(reg.mutex);
+			for (;;) {
+				reg.ready.wait(lock, [&reg]() { return !reg.queue.empty() || reg.stopping; });
+				if (reg.queue.empty()) {
+					return; // stopping, and every block is written
+				}
+				EventColumns block = std::move(reg.queue.front());
+				reg.queue.pop_front();
+				reg.space.notify_all();
+
+				lock.unlock();
+				writeBlock(reg.file, block);
+				const bool written = static_cast<bool>(reg.file);
+				lock.lock();
+
+				reg.failed = reg.failed || !written;
+				++reg.stats.blocks;
+				reg.stats.events += block.size();
+				clearRows(block);
+				reg.spare.push_back(std::move(block));
+			}
+		}
+	}
+
+	namespace detail {
+		void recordEvent(EventKind kind, std::uint64_t tick, std::uint32_t car, std::uint32_t bay, float value) {
+			EventColumns& block = localBlock();
+			block.tick.push_back(tick);
+			block.car.push_back(car);
+			block.kind.push_back(kind);
+			block.bay.push_back(bay);
+			block.value.push_back(value);
+			if (block.size() < BLOCK_ROWS) {
+				return;
+			}
+
+			Registry& reg = registry();
+			std::unique_lock<std::mutex> lock(reg.mutex);
+			if (reg.queue.size() >= MAX_QUEUED_BLOCKS) {
+				++reg.stats.stalls;
+				reg.space.wait(lock, [&reg]() { return reg.queue.size() < MAX_QUEUED_BLOCKS; });
+			}
+			enqueue(reg, block);
+		}
+	}
+
+	bool startEventLog(const std::string& path) {
+		Registry& reg = registry();
+		if (reg.writer.joinable()) {
+			return false;
+		}
+
+		reg.file.open(path, std::ios::binary | std::ios::trunc);
+		if (!reg.file) {
+			std::cerr << "Error: Failed to write event log " << path << '\n';
+			return false;
+		}
+		reg.file.write(EVENT_MAGIC, sizeof(EVENT_MAGIC));
+
+		{
+			const std::lock_guard<std::mutex> lock(reg.mutex);
+			for (auto& buffer : reg.buffers) {
+				clearRows(*buffer);
+			}
+			reg.stopping = false;
+			reg.failed = false;
+			reg.stats = {};
+		}
+		reg.writer = std::thread(writerLoop);
+		detail::g_eventLogging.store(true, std::memory_order_release);
+		return true;
+	}
+
+	bool stopEventLog(EventLogStats* stats) {
+		if (!detail::g_eventLogging.exchange(false, std::memory_order_acq_rel)) {
+			return true;
+		}
+
+		Registry& reg = registry();
+		{
+			const std::lock_guard<std::mutex> lock(reg.mutex);
+			for (auto& buffer : reg.buffers) {
+				if (buffer->size() > 0U) {
+					enqueue(reg, *buffer);
+				}
+			}
+			reg.stopping = true;
+		}
+		reg.ready.notify_one();
+		reg.writer.join();
+
+		reg.file.close();
+		const bool ok = !reg.failed && static_cast<bool>(reg.file);
+		if (!ok) {
+			std::cerr << "Error: Failed to write the event log\n";
+		}
+		if (stats != nullptr) {
+			*stats = reg.stats;
+		}
+		return ok;
+	}
+
+	bool loadEventLog(const std::string& path, EventColumns& events) {
+		std::ifstream file(path, std::ios::binary);
+		char magic[sizeof(EVENT_MAGIC)] = {};
+		if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, EVENT_MAGIC, sizeof(magic)) != 0) {
+			std::cerr << "Error: " << path << " is not an event log\n";
+			return false;
+		}
+
+		events = EventColumns{};
+		std::uint32_t rows = 0U;
+		while (file.read(reinterpret_cast<char*>(&rows), sizeof(rows))) {
+			// Blocks never exceed BLOCK_ROWS; anything larger is a corrupt count
+			const bool read = rows <= BLOCK_ROWS
+				&& readColumn(file, rows, events.tick)
+				&& readColumn(file, rows, events.car)
+				&& readColumn(file, rows, events.kind)
+				&& readColumn(file, rows, events.bay)
+				&& readColumn(file, rows, events.value);
+			if (!read) {
+				std::cerr << "Error: truncated event log " << path << '\n';
+				return false;
+			}
+		}
+
+		const bool validKinds = std::all_of(events.kind.begin(), events.kind.end(),
+			[](EventKind kind) { return static_cast<std::uint8_t>(kind) <= static_cast<std::uint8_t>(EventKind::Beep); });
+		if (!validKinds) {
+			std::cerr << "Error: unknown event kind in " << path << '\n';
+			return false;
+		}
+		return true;
+	}
+
+} // namespace sim
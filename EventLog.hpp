@@ -0,0 +1,98 @@
+/*
+==============================================================================
+Event Log - fleet and evaluation events as a column-chunked binary file
+==============================================================================
+ - Bay entries and exits, near misses, contacts and beeps are appended to
+   the calling thread's own block of columns; the owner is the only
+   writer, so recording takes no locks (registration locks once per thread)
+ - A full block is handed to a writer thread and the producer carries on
+   with a recycled one; the writer appends blocks to the file as they come,
+   so a run of millions of events never holds them all in memory
+ - No event is dropped: when the writer falls MAX_QUEUED_BLOCKS behind,
+   producers wait for it. Disabled at runtime, an event costs one relaxed
+   atomic load
+ - Blocks from different threads interleave in the file; rows within a
+   block are in recording order. Sort by (tick, car) for a global order
+ - File format (little-endian): "OKEVT001", then blocks of
+   rows u32 | tick u64 x rows | car u32 x rows | kind u8 x rows |
+   bay u32 x rows | value f32 x rows
+   Each column is one contiguous run, so a reader loads just the columns
+   it needs straight into arrays (loadEventLog() reads them all)
+==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+	enum class EventKind : std::uint8_t {
+		Entry = 0,    // car now lies fully inside the bay
+		Exit = 1,     // and no longer does
+		NearMiss = 2, // nearest obstacle came within DANGER_THRESHOLD; value = its distance
+		Contact = 3,  // an obstacle stopped the car (first tick of a contact)
+		Beep = 4      // value = the beep interval in seconds
+	};
+
+	constexpr std::uint32_t NO_EVENT_BAY = std::numeric_limits<std::uint32_t>::max();
+
+	// A whole event file, one vector per column
+	struct EventColumns {
+		std::vector<std::uint64_t> tick; // fleet tick, or tick within the trial
+		std::vector<std::uint32_t> car;  // fleet car, or trial index
+		std::vector<EventKind> kind;
+		std::vector<std::uint32_t> bay;  // NO_EVENT_BAY unless an entry or exit
+		std::vector<float> value;        // see EventKind, 0 otherwise
+
+		[[nodiscard]] std::size_t size() const noexcept { return tick.size(); }
+	};
+
+	struct EventLogStats {
+		std::uint64_t events = 0U;
+		std::uint64_t blocks = 0U;
+		std::uint64_t stalls = 0U; // times a producer waited for the writer
+	};
+
+	namespace detail {
+		extern std::atomic<bool> g_eventLogging;
+
+		void recordEvent(EventKind kind, std::uint64_t tick, std::uint32_t car, std::uint32_t bay, float value);
+	}
+
+	/**
+	 * @brief Creates the file and starts the writer thread; false (logged) if it cannot be written.
+	 */
+	[[nodiscard]] bool startEventLog(const std::string& path);
+
+	/**
+	 * @brief Writes every thread's partial block, joins the writer and closes
+	 *        the file; false on I/O failure.
+	 *
+	 * Call once the producers are done. Safe to call when logging never started.
+	 */
+	bool stopEventLog(EventLogStats* stats = nullptr);
+
+	[[nodiscard]] inline bool eventLogging() noexcept {
+		return detail::g_eventLogging.load(std::memory_order_relaxed);
+	}
+
+	inline void logEvent(EventKind kind, std::uint64_t tick, std::uint32_t car, std::uint32_t bay = NO_EVENT_BAY,
+		float value = 0.0F)
+	{
+		if (eventLogging()) {
+			detail::recordEvent(kind, tick, car, bay, value);
+		}
+	}
+
+	/**
+	 * @brief Reads an event file written by stopEventLog(); false (logged) on a bad file.
+	 */
+	[[nodiscard]] bool loadEventLog(const std::string& path, EventColumns& events);
+
+} // namespace sim
@@ -0,0 +1,77 @@
+/*
+==============================================================================
+Fixed Vector - vector interface over in-place storage of a fixed capacity
+==============================================================================
+ - Elements live inside the object: no allocation ever, so it can sit in
+   static storage or on the stack of a target without a heap
+ - Growing past Capacity is refused, not thrown: push_back() and resize()
+   return false and leave the contents as they were
+ - Trivially copyable element types only, like the simulation records it
+   holds; nothing is constructed or destroyed element by element
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace sim {
+
+	template <typename T, std::size_t Capacity>
+	class FixedVector {
+		static_assert(std::is_trivially_copyable_v<T>, "FixedVector holds plain records only");
+		static_assert(Capacity > 0U, "FixedVector needs room for at least one element");
+
+	public:
+		static constexpr std::size_t CAPACITY = Capacity;
+
+		/**
+		 * @brief Appends value; false (and unchanged) when full.
+		 */
+		[[nodiscard]] bool push_back(const T& value) noexcept {
+			if (m_size == Capacity) {
+				return false;
+			}
+			m_items[m_size++] = value;
+			return true;
+		}
+
+		/**
+		 * @brief Grows with value-initialized elements or shrinks to count; false (and unchanged) past Capacity.
+		 */
+		[[nodiscard]] bool resize(std::size_t count) noexcept {
+			if (count > Capacity) {
+				return false;
+			}
+			for (std::size_t i = m_size; i < count; ++i) {
+				m_items[i] = T{};
+			}
+			m_size = count;
+			return true;
+		}
+
+		void clear() noexcept { m_size = 0U; }
+
+		[[nodiscard]] T& operator[](std::size_t i) noexcept { return m_items[i]; }
+		[[nodiscard]] const T& operator[](std::size_t i) const noexcept { return m_items[i]; }
+
+		[[nodiscard]] T* data() noexcept { return m_items.data(); }
+		[[nodiscard]] const T* data() const noexcept { return m_items.data(); }
+		[[nodiscard]] T* begin() noexcept { return m_items.data(); }
+		[[nodiscard]] T* end() noexcept { return m_items.data() + m_size; }
+		[[nodiscard]] const T* begin() const noexcept { return m_items.data(); }
+		[[nodiscard]] const T* end() const noexcept { return m_items.data() + m_size; }
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_size; }
+		[[nodiscard]] bool empty() const noexcept { return m_size == 0U; }
+		[[nodiscard]] bool full() const noexcept { return m_size == Capacity; }
+		[[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+	private:
+		std::array<T, Capacity> m_items{};
+		std::size_t m_size = 0U;
+	};
+
+} // namespace sim
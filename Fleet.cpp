@@ -0,0 +1,579 @@
+#include "Fleet.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include "Constants.hpp"
+#include "EventLog.hpp"
+#include "Parking.hpp"
+#include "SensorQuery.hpp"
+#include "Sensors.hpp"
+#include "Trace.hpp"
+
+namespace sim {
+
+	namespace {
+		// Spawn layout: cars in rows, spaced a little wider than one car
+		constexpr std::size_t CARS_PER_ROW = 32U;
+		constexpr float SPAWN_SPACING_X = 320.0F;
+		constexpr float SPAWN_SPACING_Y = 180.0F;
+
+		// Phase offset between consecutive cars, in ticks (prime to spread well)
+		constexpr std::size_t PHASE_STEP = 97U;
+
+		// Collision scratch of one range task; a sweep only needs its candidate list
+		constexpr std::size_t SCRATCH_BYTES = 4096U;
+
+		// Range tasks per pool thread, before rounding to whole cache lines
+		constexpr std::size_t CHUNKS_PER_THREAD = 4U;
+
+		// stepCar()'s speed for an input: forward, reverse or standing
+		[[nodiscard]] float arcadeSpeed(CarInput input, const CarParams& params) noexcept {
+			float throttle = 0.0F;
+			if ((input & input::FORWARD) != 0U) { throttle += 1.0F; }
+			if ((input & input::BACKWARD) != 0U) { throttle -= 1.0F; }
+			return throttle * params.speed;
+		}
+
+		// FleetState::eventFlags bits
+		constexpr std::uint8_t PARKED_FLAG = 1U;
+		constexpr std::uint8_t CONTACT_FLAG = 2U;
+		constexpr std::uint8_t NEAR_MISS_FLAG = 4U;
+
+		// Sets or clears flag; true if that changed it, so a state logs once per edge
+		[[nodiscard]] bool flipFlag(std::uint8_t& flags, std::uint8_t flag, bool set) noexcept {
+			const bool was = (flags & flag) != 0U;
+			flags = set ? static_cast<std::uint8_t>(flags | flag) : static_cast<std::uint8_t>(flags & ~flag);
+			return was != set;
+		}
+	}
+
+	CarState fleetSpawnPose(const Scene& scene, std::size_t car) {
+		// Cars are dealt round-robin to the spawns, each spawn growing its own rows
+		const std::size_t slot = car / scene.spawns.size();
+		CarState pose = scene.spawns[car % scene.spawns.size()];
+		pose.position.x += static_cast<float>(slot % CARS_PER_ROW) * SPAWN_SPACING_X;
+		pose.position.y += static_cast<float>(slot / CARS_PER_ROW) * SPAWN_SPACING_Y;
+		return pose;
+	}
+
+	std::uint32_t fleetTracePhase(std::size_t car, std::size_t inputCount) noexcept {
+		return static_cast<std::uint32_t>((car * PHASE_STEP) % inputCount);
+	}
+
+	std::uint32_t fleetBeepTicks(float interval, float dt) noexcept {
+		std::uint32_t ticks = 0U;
+		float elapsed = 0.0F;
+		do {
+			elapsed += dt;
+			++ticks;
+		} while (elapsed < interval);
+		return ticks;
+	}
+
+	void FleetState::resize(std::size_t cars) {
+		count = cars;
+		const std::size_t padded = roundUpToLine(cars, ROW_ALIGNMENT);
+		for (FirstTouchVector<float>* column : { &x, &y, &headingDeg, &speed, &steerDeg, &beepInterval }) {
+			column->resize(padded, 0.0F);
+		}
+		for (FirstTouchVector<std::uint32_t>* column : { &beepTicks, &beeps, &traceCursor, &occupiedTicks, &contactTicks }) {
+			column->resize(padded, 0U);
+		}
+		lastBeepTick.resize(padded, 0U);
+		tickInput.resize(padded, 0U);
+		eventFlags.resize(padded, 0U);
+	}
+
+	namespace {
+		// fn(column of to, same column of from) for every FleetState column
+		template <typename Fn>
+		void forEachColumn(FleetState& to, const FleetState& from, Fn&& fn) {
+			fn(to.x, from.x);
+			fn(to.y, from.y);
+			fn(to.headingDeg, from.headingDeg);
+			fn(to.speed, from.speed);
+			fn(to.steerDeg, from.steerDeg);
+			fn(to.beepInterval, from.beepInterval);
+			fn(to.lastBeepTick, from.lastBeepTick);
+			fn(to.beepTicks, from.beepTicks);
+			fn(to.beeps, from.beeps);
+			fn(to.traceCursor, from.traceCursor);
+			fn(to.occupiedTicks, from.occupiedTicks);
+			fn(to.contactTicks, from.contactTicks);
+			fn(to.tickInput, from.tickInput);
+			fn(to.eventFlags, from.eventFlags);
+		}
+	}
+
+	void FleetState::placeOnNodes(ThreadPool& pool, std::size_t chunk) {
+		FleetState placed;
+		placed.count = count;
+		const std::size_t padded = x.size();
+		forEachColumn(placed, *this, [padded](auto& column, const auto&) { column.resize(padded); }); // not yet written
+		pool.parallelForByNode(padded, chunk, [&placed, this](std::size_t begin, std::size_t end) {
+			forEachColumn(placed, *this, [begin, end](auto& column, const auto& source) {
+				std::copy(source.begin() + begin, source.begin() + end, column.begin() + begin);
+			});
+		});
+		*this = std::move(placed);
+	}
+
+	FleetSimulation::FleetSimulation(const Scene& scene, std::vector<TraceSegment> trace,
+		std::size_t carCount, float tickHz, const WarningProfile& profile, VehicleModel model,
+		const SensorNoiseConfig& noise)
+		: m_scene(scene)
+		, m_profile(profile)
+		, m_tickDt(1.0F / tickHz)
+		, m_model(model)
+		, m_carParams{ constants::CAR_SPEED, constants::CAR_TURN_RATE }
+	{
+		spawnScene(m_world, scene);
+		m_obstacles.grid.build(obstacleCenters(m_world.obstacles.values()), constants::OBSTACLE_CELL_SIZE,
+			sceneWalls(scene, sceneBounds(scene)), scene.polygons);
+		m_obstacles.collisionWorld.build(m_world.obstacles.values(), {}, constants::OBSTACLE_CELL_SIZE);
+		m_sensorsPerCar = createSensorMounts(scene.carHalfExtent, profile.rig()).size();
+
+		for (const auto& segment : trace) {
+			m_inputs.insert(m_inputs.end(), segment.ticks, segment.input);
+		}
+		if (m_inputs.empty()) {
+			m_inputs.push_back(0U);
+		}
+
+		m_world.transforms.reserve(carCount);
+		m_world.bodies.reserve(carCount);
+		m_world.beepTimers.reserve(carCount);
+		m_world.sensors.reserve(carCount * m_sensorsPerCar);
+		m_state.resize(carCount);
+		m_lot.setBays(scene.parkBays, 0.0F);
+		for (std::size_t i = 0U; i < carCount; ++i) {
+			const CarState pose = fleetSpawnPose(scene, i);
+			(void)spawnCar(m_world, pose, scene.carHalfExtent, m_lot.addCar(), profile.rig());
+			m_state.setPose(i, pose);
+			m_state.traceCursor[i] = fleetTracePhase(i, m_inputs.size());
+		}
+
+		if (m_model == VehicleModel::Bicycle) {
+			m_vehicles.resize(carCount);
+			for (std::size_t i = 0U; i < carCount; ++i) {
+				m_vehicles.set(i, BicycleState{ m_state.pose(i), 0.0F, 0.0F });
+			}
+		}
+
+		m_noise.configure(noise, m_world.sensors.size());
+	}
+
+	bool FleetSimulation::setScript(const std::string& name) {
+		return m_scripts.start(name, m_state.size(), m_tickDt, m_carParams);
+	}
+
+	bool FleetSimulation::setQuantized() {
+		if (!m_scene.polygons.empty()) {
+			std::cerr << "Warning: quantized pillars do not cover polygons, the fleet keeps the float grid\n";
+			return false;
+		}
+		if (m_profile.range() >= QuantizedObstacleTiles::TILE_SIZE) {
+			std::cerr << "Warning: a warning range of " << m_profile.range() << " px is beyond quantized tiles of "
+				<< QuantizedObstacleTiles::TILE_SIZE << " px, the fleet keeps the float grid\n";
+			return false;
+		}
+		if (!m_obstacles.quantizedPillars.build(obstacleCenters(m_world.obstacles.values()))) {
+			return false;
+		}
+		// The grid is left with the walls, for the wall distances
+		m_obstacles.grid.build({}, constants::OBSTACLE_CELL_SIZE, sceneWalls(m_scene, sceneBounds(m_scene)));
+		m_quantized = true;
+		m_nodeObstacles.clear(); // stale copies; the shared set serves every node from here on
+		return true;
+	}
+
+	sf::FloatRect FleetSimulation::carArea(float margin) const {
+		sf::FloatRect area = sceneBounds(m_scene);
+		sf::Vector2f low = area.position;
+		sf::Vector2f high = area.position + area.size;
+		for (std::size_t i = 0U; i < m_state.size(); ++i) {
+			low.x = std::min(low.x, m_state.x[i]);
+			low.y = std::min(low.y, m_state.y[i]);
+			high.x = std::max(high.x, m_state.x[i]);
+			high.y = std::max(high.y, m_state.y[i]);
+		}
+		return { { low.x - margin, low.y - margin }, { high.x - low.x + 2.0F * margin, high.y - low.y + 2.0F * margin } };
+	}
+
+	void FleetSimulation::setCarSensing() {
+		// The lot and every spawn row, grown so a car just outside either is still found exactly
+		const sf::FloatRect area = carArea(m_profile.range() + constants::MOVER_CELL_SIZE);
+		m_carGrid.reset(area, constants::MOVER_CELL_SIZE);
+		for (std::size_t i = 0U; i < m_state.size(); ++i) {
+			m_carGrid.insert(static_cast<std::uint32_t>(i), { m_state.x[i], m_state.y[i] });
+		}
+		m_carSensing = true;
+	}
+
+	void FleetSimulation::setRouting() {
+		// Over the lot and the spawn rows, so every car starts on the graph
+		m_aisles.build(m_scene, carArea(2.0F * std::max(m_scene.carHalfExtent.x, m_scene.carHalfExtent.y)));
+		m_router.reset(m_aisles);
+		for (std::uint32_t bay = 0U; bay < m_lot.bayCount(); ++bay) {
+			m_router.setOccupied(bay, m_lot.occupied(bay));
+		}
+		m_aisleQueues.assign(m_aisles.aisleCount(), 0U);
+		m_carNodes.assign(m_state.size(), AisleGraph::NONE);
+		m_routing = true;
+	}
+
+	void FleetSimulation::stepRange(std::size_t begin, std::size_t end, std::uint32_t ticks,
+		const NodeObstacles& obstacles, FrameArena& scratch)
+	{
+		const bool scripted = m_scripts.carCount() > 0U;
+		for (std::uint32_t t = 0U; t < ticks; ++t) {
+			if (scripted) {
+				m_scripts.resume(begin, end, m_tick + t, m_state.tickInput.data());
+			}
+			for (std::size_t i = begin; i < end; ++i) {
+				CarState pose = m_state.pose(i);
+				const CarInput input = scripted ? m_state.tickInput[i] : m_inputs[m_state.traceCursor[i]];
+				const bool blocked = stepCarWithCollisions(pose, input, m_carParams, m_tickDt, obstacles.collisionWorld,
+					m_scene.carHalfExtent, scratch);
+				noteContact(i, m_tick + t, blocked);
+				m_state.setPose(i, pose);
+				m_state.speed[i] = blocked ? 0.0F : arcadeSpeed(input, m_carParams);
+				m_state.traceCursor[i] = static_cast<std::uint32_t>((m_state.traceCursor[i] + 1U) % m_inputs.size());
+				countOccupied(i, m_tick + t);
+			}
+			senseRange(begin, end, m_tick + t, obstacles);
+		}
+	}
+
+	void FleetSimulation::stepBicycleRange(std::size_t begin, std::size_t end, std::uint32_t ticks,
+		const NodeObstacles& obstacles, FrameArena& scratch)
+	{
+		const bool scripted = m_scripts.carCount() > 0U;
+		for (std::uint32_t t = 0U; t < ticks; ++t) {
+			if (scripted) {
+				m_scripts.resume(begin, end, m_tick + t, m_state.tickInput.data());
+			}
+			else {
+				for (std::size_t i = begin; i < end; ++i) {
+					m_state.tickInput[i] = m_inputs[m_state.traceCursor[i]];
+					m_state.traceCursor[i] = static_cast<std::uint32_t>((m_state.traceCursor[i] + 1U) % m_inputs.size());
+				}
+			}
+
+			// Whole range in one vector pass, then contacts against the old poses
+			stepVehiclesSimd(m_vehicles, m_state.tickInput.data(), m_bicycleParams, m_tickDt, begin, end);
+
+			for (std::size_t i = begin; i < end; ++i) {
+				const CarState to = m_vehicles.pose(i);
+				const CarState resolved = obstacles.collisionWorld.sweep(m_state.pose(i), to, m_scene.carHalfExtent, scratch);
+				const bool blocked = resolved.position != to.position || resolved.headingDeg != to.headingDeg;
+				if (blocked) {
+					m_vehicles.set(i, BicycleState{ resolved, 0.0F, m_vehicles.steerDeg(i) });
+				}
+				noteContact(i, m_tick + t, blocked);
+				m_state.setPose(i, resolved);
+				m_state.speed[i] = m_vehicles.speed(i);
+				m_state.steerDeg[i] = m_vehicles.steerDeg(i);
+				countOccupied(i, m_tick + t);
+			}
+			senseRange(begin, end, m_tick + t, obstacles);
+		}
+	}
+
+	void FleetSimulation::senseRange(std::size_t begin, std::size_t end, std::uint64_t tick,
+		const NodeObstacles& obstacles)
+	{
+		const std::size_t sensorBegin = begin * m_sensorsPerCar;
+		const std::size_t sensorEnd = end * m_sensorsPerCar;
+
+		// updateSensorPoses() over car i's sensors [i * S, (i + 1) * S), with the pose from the fleet state
+		for (std::size_t car = begin; car < end; ++car) {
+			const CarState pose = m_state.pose(car);
+			const sf::Transform transform = carTransform(pose);
+			for (std::size_t i = car * m_sensorsPerCar; i < (car + 1U) * m_sensorsPerCar; ++i) {
+				MountedSensor& sensor = m_world.sensors[i];
+				sensor.pose.position = transform.transformPoint(sensor.mount.offset);
+				sensor.pose.rotationDeg = sensor.mount.rotationDeg + pose.headingDeg;
+			}
+		}
+
+		// Inline: this range is already one chunk of the tick's parallel pass
+		MountedSensor* const sensors = m_world.sensors.begin() + sensorBegin;
+		querySensors(SensorSource{ &obstacles.grid, m_quantized ? &obstacles.quantizedPillars : nullptr,
+			m_profile.range() },
+			sensorEnd - sensorBegin,
+			[sensors](std::size_t i) -> const SensorPose& { return sensors[i].pose; },
+			[sensors](std::size_t i) -> SensorReading& { return sensors[i].reading; });
+		if (m_carSensing) {
+			// The other cars' slots as filed after the previous tick; a car is not an obstacle index
+			for (std::size_t car = begin; car < end; ++car) {
+				for (std::size_t i = car * m_sensorsPerCar; i < (car + 1U) * m_sensorsPerCar; ++i) {
+					MountedSensor& sensor = m_world.sensors[i];
+					const NearestObstacle other = m_carGrid.nearest(sensor.pose.position, m_profile.range(),
+						static_cast<std::uint32_t>(car));
+					if (other.distanceSq < sensor.reading.distanceSq) {
+						sensor.reading.obstacle = NO_OBSTACLE;
+						sensor.reading.distanceSq = other.distanceSq;
+					}
+				}
+			}
+		}
+		m_noise.apply(tick, sensorBegin, sensorEnd - sensorBegin,
+			[this](std::size_t i) -> SensorReading& { return m_world.sensors[i].reading; });
+
+		// accumulateBeepIntervals(); a car whose band changed moves in its chunk's wheel
+		const std::uint64_t now = tick + 1U; // fleet ticks run once this one is done
+		const bool events = eventLogging();
+		for (std::size_t car = begin; car < end; ++car) {
+			float interval = 0.0F;
+			float nearestSq = std::numeric_limits<float>::max();
+			for (std::size_t i = car * m_sensorsPerCar; i < (car + 1U) * m_sensorsPerCar; ++i) {
+				const MountedSensor& sensor = m_world.sensors[i];
+				interval = moreUrgent(interval, m_profile.interval(sensor.mount.zone, sensor.reading.distanceSq));
+				nearestSq = std::min(nearestSq, sensor.reading.distanceSq);
+			}
+			const bool nearMiss = nearestSq < constants::DANGER_THRESHOLD * constants::DANGER_THRESHOLD;
+			if (events && flipFlag(m_state.eventFlags[car], NEAR_MISS_FLAG, nearMiss) && nearMiss) {
+				logEvent(EventKind::NearMiss, tick, static_cast<std::uint32_t>(car), NO_EVENT_BAY, std::sqrt(nearestSq));
+			}
+			if (interval == m_state.beepInterval[car]) {
+				continue;
+			}
+
+			m_state.beepInterval[car] = interval;
+			BeepWheel& wheel = m_beepWheels[car / m_chunk];
+			const auto beeper = static_cast<std::uint32_t>(car % m_chunk);
+			if (interval > 0.0F) {
+				m_state.beepTicks[car] = fleetBeepTicks(interval, m_tickDt);
+				wheel.schedule(beeper, m_state.lastBeepTick[car] + m_state.beepTicks[car]);
+			}
+			else {
+				wheel.cancel(beeper);
+			}
+		}
+
+		// updateBeepTimers(), but only for the cars due this tick (ranges start on a chunk)
+		for (std::size_t chunkBegin = begin; chunkBegin < end; chunkBegin += m_chunk) {
+			BeepWheel& wheel = m_beepWheels[chunkBegin / m_chunk];
+			wheel.advance(now, [this, &wheel, chunkBegin, now](std::uint32_t beeper) {
+				const std::size_t car = chunkBegin + beeper;
+				++m_state.beeps[car];
+				m_state.lastBeepTick[car] = now;
+				logEvent(EventKind::Beep, now - 1U, static_cast<std::uint32_t>(car), NO_EVENT_BAY, m_state.beepInterval[car]);
+				wheel.schedule(beeper, now + m_state.beepTicks[car]);
+			});
+		}
+	}
+
+	void FleetSimulation::countOccupied(std::size_t car, std::uint64_t tick) {
+		const sf::FloatRect bounds = carBounds(m_state.pose(car), m_scene.carHalfExtent);
+		const bool parked = parkOccupied(bounds, m_world.bays[0U].rect);
+		if (parked) {
+			++m_state.occupiedTicks[car];
+		}
+		if (eventLogging() && flipFlag(m_state.eventFlags[car], PARKED_FLAG, parked)) {
+			logEvent(parked ? EventKind::Entry : EventKind::Exit, tick, static_cast<std::uint32_t>(car), 0U);
+		}
+	}
+
+	void FleetSimulation::noteContact(std::size_t car, std::uint64_t tick, bool blocked) {
+		if (blocked) {
+			++m_state.contactTicks[car];
+		}
+		if (eventLogging() && flipFlag(m_state.eventFlags[car], CONTACT_FLAG, blocked) && blocked) {
+			logEvent(EventKind::Contact, tick, static_cast<std::uint32_t>(car));
+		}
+	}
+
+	void FleetSimulation::step(ThreadPool& pool, std::uint32_t ticks) {
+		OKPP_TRACE_SCOPE("fleet step");
+		// The pool's usual split, rounded up so every chunk starts on a line of every column
+		const std::size_t cars = m_state.size();
+		if (m_chunk == 0U) {
+			// Fixed from here on: each chunk keeps its own beep wheel
+			m_chunk = roundUpToLine(std::max<std::size_t>(1U, cars / (pool.threadCount() * CHUNKS_PER_THREAD)),
+				FleetState::ROW_ALIGNMENT);
+			m_beepWheels.resize((cars + m_chunk - 1U) / m_chunk);
+			if (pool.nodeCount() > 1U) {
+				placeOnNodes(pool);
+			}
+			else {
+				for (std::size_t k = 0U; k < m_beepWheels.size(); ++k) {
+					m_beepWheels[k].reset(std::min(m_chunk, cars - k * m_chunk), m_tick);
+				}
+			}
+		}
+		const auto stepAll = [this, cars, &pool](std::uint32_t batch) {
+			pool.parallelForByNode(cars, m_chunk, [this, batch, &pool](std::size_t begin, std::size_t end) {
+				FrameArena scratch(SCRATCH_BYTES);
+				const NodeObstacles& obstacles = nodeObstacles(pool.currentNode());
+				if (m_model == VehicleModel::Bicycle) {
+					stepBicycleRange(begin, end, batch, obstacles, scratch);
+				}
+				else {
+					stepRange(begin, end, batch, obstacles, scratch);
+				}
+			});
+			m_tick += batch;
+		};
+		if (m_carSensing || m_routing) {
+			// One tick per pass: the car grid is read by every worker and moved between passes,
+			// and every car is routed from where each tick left it
+			for (std::uint32_t t = 0U; t < ticks; ++t) {
+				stepAll(1U);
+				if (m_carSensing) {
+					refileCars();
+				}
+				if (m_routing) {
+					syncWorld();
+					updateLot();
+					routeCars();
+				}
+			}
+		}
+		else {
+			stepAll(ticks);
+		}
+		syncWorld();
+		updateLot();
+	}
+
+	void FleetSimulation::placeOnNodes(ThreadPool& pool) {
+		OKPP_TRACE_SCOPE("fleet node placement");
+		m_state.placeOnNodes(pool, m_chunk);
+
+		// Wheels allocated by their chunk's task, obstacle copies by the first chunk of each node
+		const std::size_t chunks = m_beepWheels.size();
+		const std::size_t nodes = pool.nodeCount();
+		m_nodeObstacles.resize(nodes);
+		pool.parallelForByNode(m_state.size(), m_chunk, [this, chunks, nodes](std::size_t begin, std::size_t end) {
+			const std::size_t k = begin / m_chunk;
+			m_beepWheels[k].reset(end - begin, m_tick);
+			const std::size_t node = k * nodes / chunks;
+			if (k == 0U || (k - 1U) * nodes / chunks != node) {
+				m_nodeObstacles[node] = m_obstacles;
+			}
+		});
+	}
+
+	void FleetSimulation::refileCars() {
+		OKPP_TRACE_SCOPE("car grid update");
+		for (std::size_t i = 0U; i < m_state.size(); ++i) {
+			(void)m_carGrid.move(static_cast<std::uint32_t>(i), { m_state.x[i], m_state.y[i] });
+		}
+	}
+
+	void FleetSimulation::syncWorld() {
+		for (std::size_t i = 0U; i < m_state.size(); ++i) {
+			m_world.transforms[i].pose = m_state.pose(i);
+			BeepTimer& timer = m_world.beepTimers[i];
+			timer.sinceLastBeep = static_cast<float>(m_tick - m_state.lastBeepTick[i]) * m_tickDt;
+			timer.interval = m_state.beepInterval[i];
+			timer.beeps = m_state.beeps[i];
+		}
+	}
+
+	void FleetSimulation::updateLot() {
+		OKPP_TRACE_SCOPE("lot update");
+		updateParking(m_world, m_lot);
+		if (m_routing) {
+			for (const std::uint32_t bay : m_lot.changedBays()) {
+				m_router.setOccupied(bay, m_lot.occupied(bay));
+			}
+		}
+		m_lot.clearChanged();
+	}
+
+	void FleetSimulation::routeCars() {
+		OKPP_TRACE_SCOPE("fleet routing");
+		// Queues: the cars in each aisle, and those bound for a bay entered from it
+		std::fill(m_aisleQueues.begin(), m_aisleQueues.end(), 0U);
+		for (std::size_t i = 0U; i < m_state.size(); ++i) {
+			const std::uint32_t node = m_aisles.nodeAt({ m_state.x[i], m_state.y[i] });
+			m_carNodes[i] = node;
+			if (node == AisleGraph::NONE) {
+				continue;
+			}
+			++m_aisleQueues[m_aisles.aisleOf(node)];
+			const std::uint32_t bay = m_router.nearestFreeBay(node);
+			if (bay != AisleGraph::NONE) {
+				++m_aisleQueues[m_aisles.aisleOf(m_aisles.bayEntry(bay))];
+			}
+		}
+		m_router.setQueues(m_aisleQueues);
+
+		// Every car not at its bay yet asks for the way there; most are answered from the cache
+		for (std::size_t i = 0U; i < m_state.size(); ++i) {
+			const std::uint32_t node = m_carNodes[i];
+			const std::uint32_t bay = m_router.nearestFreeBay(node);
+			AisleRoute route;
+			if (bay != AisleGraph::NONE && node != m_aisles.bayEntry(bay) && m_router.route(node, bay, route)) {
+				m_routeLength += route.cost;
+			}
+		}
+	}
+
+	FleetStats FleetSimulation::stats() const {
+		FleetStats stats;
+		for (std::size_t i = 0U; i < m_state.size(); ++i) {
+			stats.beeps += m_state.beeps[i];
+			stats.occupiedTicks += m_state.occupiedTicks[i];
+			stats.contactTicks += m_state.contactTicks[i];
+		}
+		stats.occupiedBays = m_lot.occupiedCount();
+		stats.carGridReinsertions = m_carGrid.reinsertions();
+		stats.routes = m_router.stats().routes;
+		stats.routeCacheHits = m_router.stats().cacheHits;
+		stats.routeExpansions = m_router.stats().expansions;
+		stats.congestedAisles = m_router.congestedAisles();
+		stats.meanRouteLength = (stats.routes > 0U) ? m_routeLength / static_cast<double>(stats.routes) : 0.0;
+		return stats;
+	}
+
+	FleetCar FleetSimulation::car(std::size_t index) const {
+		FleetCar car;
+		car.pose = m_state.pose(index);
+		car.speed = m_state.speed[index];
+		car.steerDeg = m_state.steerDeg[index];
+		car.sinceLastBeep = static_cast<float>(m_tick - m_state.lastBeepTick[index]) * m_tickDt;
+		car.beeps = m_state.beeps[index];
+		car.traceCursor = m_state.traceCursor[index];
+		car.occupiedTicks = m_state.occupiedTicks[index];
+		car.contactTicks = m_state.contactTicks[index];
+		return car;
+	}
+
+	FleetStats runFleet(const Scene& scene, const std::vector<TraceSegment>& trace,
+		float tickHz, std::size_t carCount, std::uint32_t ticks, ThreadPool& pool, const WarningProfile& profile,
+		VehicleModel model, const SensorNoiseConfig& noise, const std::string& script, bool quantized,
+		bool carSensing, bool routing)
+	{
+		FleetSimulation fleet(scene, trace, carCount, tickHz, profile, model, noise);
+		if (!script.empty()) {
+			(void)fleet.setScript(script); // checked by the caller; an unknown name is logged and keeps the trace
+		}
+		if (quantized) {
+			(void)fleet.setQuantized(); // a refusal is logged and keeps the grid
+		}
+		if (carSensing) {
+			fleet.setCarSensing();
+		}
+		if (routing) {
+			fleet.setRouting();
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		fleet.step(pool, ticks);
+		const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		FleetStats stats = fleet.stats();
+		stats.carTicks = static_cast<std::uint64_t>(carCount) * ticks;
+		stats.wallSeconds = wallSeconds;
+		return stats;
+	}
+
+} // namespace sim
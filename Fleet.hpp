@@ -0,0 +1,303 @@
+/*
+==============================================================================
+Fleet - many independent cars against one shared obstacle set
+==============================================================================
+ - Cars, their sensors, the obstacles and the bays live in a World; what
+   changes every tick (pose, speed, steering, beep timer, trace cursor and
+   counters) lives in a FleetState instead: one cache-line-aligned column
+   per field, padded to whole lines
+ - Cars are spawned once and never destroyed, so car i is dense entry i of
+   every car store, row i of the fleet state and lane i of the vehicle
+   batch, and its sensors are dense entries [i * S, (i + 1) * S) of the
+   sensor store
+ - step() splits the cars over a thread pool in chunks that are whole
+   cache lines of every state column; per tick each worker moves its
+   range, then runs the sensor and beep systems over the matching sensor
+   range, so workers never share a car, nor a line of car state, and no
+   locking is needed
+ - Beeps are scheduled rather than polled: a car goes into its chunk's
+   BeepWheel at the tick its next beep is due, and is only rescheduled
+   when its warning band changes; per tick a chunk fires just the cars
+   that are due. Silent cars are not scheduled and never beep
+ - With the bicycle model each worker integrates its whole range per tick
+   with the SoA vector kernel, then resolves contacts per car
+ - The World's Transform and BeepTimer components are an AoS view of the
+   fleet state, refreshed after each step() for rendering, streaming and
+   debugging; car() reads one row the same way
+ - Lot occupancy is then updated serially and incrementally, car by car
+ - Optional sensor noise is keyed by fleet tick and global sensor index, so
+   a run draws the same noise however the cars are split over workers
+ - setScript() drives every car from a coroutine drive script (DriveScript)
+   instead of the trace: each worker resumes the scripts of its range at
+   the start of each tick and the cars read the inputs they hold
+ - setQuantized() switches the sensor pass to pillars stored as 16-bit
+   fixed point in tiles (QuantizedObstacles): half the position bytes per
+   lookup and integer distances that match on every platform; the grid
+   then keeps only the walls
+ - With the event log on (EventLog), bay entries and exits, near misses,
+   contacts and beeps go to the worker's own event block; per-car edge
+   flags make each entry, near miss or contact one event, not one per tick
+ - setCarSensing() lets sensors see the other cars as well: every car has
+   a slot in a loose grid (LooseGrid) that is only re-filed when the car
+   crosses into another cell. step() then runs tick by tick and moves the
+   cars' slots serially between ticks, so a sensor sees the other cars
+   where they stood at the end of the previous tick, however the cars are
+   split over workers; cars are measured to their centres, like movers
+ - setRouting() routes the fleet through the lot's aisles (AisleGraph):
+   between ticks every car is counted into its aisle's queue and asks for
+   the way to its nearest free bay, serially, against the bays as that tick
+   left them; congested aisles cost more, so routes spread out
+ - On a pool spanning several memory nodes, chunks go to nodes in fixed
+   contiguous blocks (ThreadPool::parallelForByNode), and the first step()
+   re-homes the fleet: every chunk's FleetState rows and beep wheel are
+   rewritten by a worker of its node, so their pages are first touched
+   there, and each node gets its own copy of the obstacle grid, quantized
+   tiles and collision world; a worker reads its own node's copy, and
+   only steals another node's chunks once its node has none left
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AisleGraph.hpp"
+#include "BeepWheel.hpp"
+#include "CacheAligned.hpp"
+#include "CarModel.hpp"
+#include "Collision.hpp"
+#include "DriveScript.hpp"
+#include "FrameArena.hpp"
+#include "Headless.hpp"
+#include "MovingObstacles.hpp"
+#include "ObstacleGrid.hpp"
+#include "ParkingLot.hpp"
+#include "QuantizedObstacles.hpp"
+#include "Scene.hpp"
+#include "SensorNoise.hpp"
+#include "SimTypes.hpp"
+#include "ThreadPool.hpp"
+#include "VehicleDynamics.hpp"
+#include "WarningProfile.hpp"
+#include "World.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief Per-tick car state of a fleet in structure-of-arrays form.
+	 *
+	 * Every column starts on a cache line and is padded to ROW_ALIGNMENT rows,
+	 * so car ranges that start on a multiple of ROW_ALIGNMENT own their lines.
+	 */
+	struct FleetState {
+		// Rows per line of the narrowest column: a whole number of lines of every column
+		static constexpr std::size_t ROW_ALIGNMENT = perCacheLine<CarInput>();
+
+		/**
+		 * @brief Resizes every column to count cars (padded); new rows are zero.
+		 */
+		void resize(std::size_t count);
+
+		/**
+		 * @brief Moves every column to fresh storage whose rows are first written
+		 *        by the node that parallelForByNode(size(), chunk) deals them to.
+		 */
+		void placeOnNodes(ThreadPool& pool, std::size_t chunk);
+
+		[[nodiscard]] std::size_t size() const noexcept { return count; }
+		[[nodiscard]] CarState pose(std::size_t car) const noexcept { return { { x[car], y[car] }, headingDeg[car] }; }
+		void setPose(std::size_t car, const CarState& pose) noexcept {
+			x[car] = pose.position.x;
+			y[car] = pose.position.y;
+			headingDeg[car] = pose.headingDeg;
+		}
+
+		FirstTouchVector<float> x;
+		FirstTouchVector<float> y;
+		FirstTouchVector<float> headingDeg;
+		FirstTouchVector<float> speed;    // pixels per second along the heading (0 while blocked)
+		FirstTouchVector<float> steerDeg; // front wheel angle (bicycle model; 0 for arcade cars)
+		FirstTouchVector<float> beepInterval; // most urgent sensor interval, as last scheduled (0 = silent)
+		FirstTouchVector<std::uint64_t> lastBeepTick; // fleet ticks run at the car's last beep (0 = none yet)
+		FirstTouchVector<std::uint32_t> beepTicks;    // ticks between beeps at beepInterval
+		FirstTouchVector<std::uint32_t> beeps;
+		FirstTouchVector<std::uint32_t> traceCursor; // tick index into the looped trace
+		FirstTouchVector<std::uint32_t> occupiedTicks;
+		FirstTouchVector<std::uint32_t> contactTicks;
+		FirstTouchVector<CarInput> tickInput; // this tick's input (bicycle model)
+		FirstTouchVector<std::uint8_t> eventFlags; // parked, contact and near-miss state as last logged (event log only)
+		std::size_t count = 0U;
+	};
+
+	// One fleet car as a plain struct: debugging and tooling, not the hot loop
+	struct FleetCar {
+		CarState pose;
+		float speed = 0.0F;
+		float steerDeg = 0.0F;
+		float sinceLastBeep = 0.0F;
+		std::uint32_t beeps = 0U;
+		std::uint32_t traceCursor = 0U;
+		std::uint32_t occupiedTicks = 0U;
+		std::uint32_t contactTicks = 0U;
+	};
+
+	struct FleetStats {
+		std::uint64_t carTicks = 0U;
+		std::uint64_t beeps = 0U;
+		std::uint64_t occupiedTicks = 0U;
+		std::uint64_t contactTicks = 0U; // car ticks stopped by an obstacle
+		std::size_t occupiedBays = 0U; // bays holding a car after the last step
+		std::uint64_t carGridReinsertions = 0U; // car slots re-filed into another cell (car sensing only)
+		std::uint64_t routes = 0U;          // routing only: routes to the nearest free bay asked for
+		std::uint64_t routeCacheHits = 0U;  // of those, answered from the route cache
+		std::uint64_t routeExpansions = 0U; // nodes A* expanded for the rest
+		std::size_t congestedAisles = 0U;   // aisles at or over capacity after the last tick
+		double meanRouteLength = 0.0;       // congested cost of the routes found, in px
+		double wallSeconds = 0.0;
+	};
+
+	class FleetSimulation {
+	public:
+		/**
+		 * @brief Spawns carCount cars in rows around the scene spawn point.
+		 *
+		 * Each car replays the trace from a different phase so the fleet
+		 * does not move in lockstep. scene and profile must outlive the fleet.
+		 * noise perturbs every sensor pass before the beep system reads it.
+		 */
+		FleetSimulation(const Scene& scene, std::vector<TraceSegment> trace, std::size_t carCount, float tickHz,
+			const WarningProfile& profile, VehicleModel model, const SensorNoiseConfig& noise = {});
+
+		/**
+		 * @brief Drives every car from the named drive script from the next step() on.
+		 *
+		 * MISRA: an unknown name keeps the trace and returns false (logged).
+		 */
+		[[nodiscard]] bool setScript(const std::string& name);
+
+		/**
+		 * @brief Senses pillars through quantized tiles instead of the float grid from the next step().
+		 *
+		 * MISRA: scenes with polygons, a warning range of TILE_SIZE or more and
+		 *        very sparse pillars keep the grid and return false (logged).
+		 */
+		[[nodiscard]] bool setQuantized();
+
+		/**
+		 * @brief Sensors see the other cars too, as of the previous tick, from the next step() on.
+		 *
+		 * The car grid is exact within the lot and spawn rows grown by the
+		 * warning range; farther out cars are filed in its border cells.
+		 */
+		void setCarSensing();
+
+		/**
+		 * @brief Every tick from the next step() on, routes each car to its nearest free bay
+		 *        through the lot's aisles (AisleGraph), with per-aisle queues as congestion.
+		 *
+		 * The cars keep driving their trace or script; routing load and
+		 * congestion show in stats().
+		 */
+		void setRouting();
+
+		/**
+		 * @brief Advances every car by ticks fixed steps on the pool.
+		 */
+		void step(ThreadPool& pool, std::uint32_t ticks);
+
+		[[nodiscard]] FleetStats stats() const;
+		[[nodiscard]] std::size_t carCount() const noexcept { return m_state.size(); }
+		[[nodiscard]] FleetCar car(std::size_t index) const;
+		[[nodiscard]] const FleetState& state() const noexcept { return m_state; }
+		[[nodiscard]] const World& world() const noexcept { return m_world; } // Transform and BeepTimer as of the last step()
+		[[nodiscard]] const ParkingLot& lot() const noexcept { return m_lot; }
+
+	private:
+		// What the cars collide with and sense; one copy per memory node on NUMA machines
+		struct NodeObstacles {
+			ObstacleGrid grid;     // pillars, and the scene's walls and bounds for the wall distances
+			QuantizedObstacleTiles quantizedPillars; // replaces the grid's pillars once setQuantized() succeeds
+			CollisionWorld collisionWorld; // pillars only; cars do not collide with each other
+		};
+
+		void stepRange(std::size_t begin, std::size_t end, std::uint32_t ticks, const NodeObstacles& obstacles,
+			FrameArena& scratch);
+		void stepBicycleRange(std::size_t begin, std::size_t end, std::uint32_t ticks, const NodeObstacles& obstacles,
+			FrameArena& scratch);
+		// sensor and beep systems for cars [begin, end)
+		void senseRange(std::size_t begin, std::size_t end, std::uint64_t tick, const NodeObstacles& obstacles);
+		void placeOnNodes(ThreadPool& pool); // first step() on several nodes: state, wheels and obstacle copies
+		[[nodiscard]] const NodeObstacles& nodeObstacles(std::size_t node) const noexcept {
+			return (node < m_nodeObstacles.size()) ? m_nodeObstacles[node] : m_obstacles;
+		}
+		void countOccupied(std::size_t car, std::uint64_t tick);
+		void noteContact(std::size_t car, std::uint64_t tick, bool blocked); // contact count and event
+		void syncWorld(); // copies the fleet state into the World's Transform and BeepTimer view
+		void updateLot();
+		void refileCars(); // car sensing: moves every car's slot in m_carGrid to its pose
+		void routeCars();  // routing: queues from the car poses, then a route per car
+		[[nodiscard]] sf::FloatRect carArea(float margin) const; // the lot and every car, grown by margin
+
+		const Scene& m_scene;
+		const WarningProfile& m_profile; // same bands for the whole fleet
+		float m_tickDt;
+		VehicleModel m_model;
+		CarParams m_carParams;
+		BicycleParams m_bicycleParams;
+		VehicleBatch m_vehicles;         // bicycle integrator state, car i is lane i
+		NodeObstacles m_obstacles;
+		std::vector<NodeObstacles> m_nodeObstacles; // copy per node, made by placeOnNodes(); empty on one node
+		bool m_quantized = false;
+		bool m_carSensing = false;
+		LooseGrid m_carGrid; // car i has id i; filled by setCarSensing()
+		bool m_routing = false;
+		AisleGraph m_aisles;  // built by setRouting()
+		AisleRouter m_router;
+		std::vector<std::uint32_t> m_aisleQueues; // cars per aisle this tick
+		std::vector<std::uint32_t> m_carNodes;    // graph node of car i this tick
+		double m_routeLength = 0.0;
+		std::size_t m_sensorsPerCar = 0U;
+		std::vector<CarInput> m_inputs; // trace expanded to one input per tick
+		DriveScripts m_scripts;         // no cars: the trace drives them
+		std::size_t m_chunk = 0U;            // cars per range task, fixed by the first step()
+		std::vector<BeepWheel> m_beepWheels; // chunk k schedules cars [k * m_chunk, (k + 1) * m_chunk)
+		World m_world;
+		FleetState m_state;
+		ParkingLot m_lot; // car i is lot car i
+		SensorNoise m_noise;
+		std::uint64_t m_tick = 0U; // fleet ticks run so far, the noise counter
+	};
+
+	/**
+	 * @brief Spawn pose of fleet car car: dealt round-robin to the scene spawns, each spawn growing its own rows.
+	 */
+	[[nodiscard]] CarState fleetSpawnPose(const Scene& scene, std::size_t car);
+
+	/**
+	 * @brief Trace tick fleet car car starts from, so the fleet does not move in lockstep. MISRA: inputCount > 0.
+	 */
+	[[nodiscard]] std::uint32_t fleetTracePhase(std::size_t car, std::size_t inputCount) noexcept;
+
+	/**
+	 * @brief Ticks until a timer reset at a beep reaches interval, accumulated in
+	 *        float tick by tick as the per-tick beep timers do, so the counts match.
+	 */
+	[[nodiscard]] std::uint32_t fleetBeepTicks(float interval, float dt) noexcept;
+
+	/**
+	 * @brief Runs a fleet for ticks steps on the pool and reports throughput.
+	 *
+	 * A non-empty script drives the cars instead of the trace; it must exist (driveScriptExists()).
+	 * quantized senses through setQuantized(), keeping the grid if that is refused.
+	 * carSensing lets the cars sense each other (setCarSensing()).
+	 * routing routes every car to a free bay each tick (setRouting()).
+	 */
+	[[nodiscard]] FleetStats runFleet(const Scene& scene, const std::vector<TraceSegment>& trace,
+		float tickHz, std::size_t carCount, std::uint32_t ticks, ThreadPool& pool, const WarningProfile& profile,
+		VehicleModel model, const SensorNoiseConfig& noise = {}, const std::string& script = {}, bool quantized = false,
+		bool carSensing = false, bool routing = false);
+
+} // namespace sim
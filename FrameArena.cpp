@@ -0,0 +1,60 @@
+#include "FrameArena.hpp"
+
+#include <algorithm>
+
+namespace sim {
+
+	FrameArena::FrameArena(std::size_t capacity) {
+		const std::size_t size = std::max<std::size_t>(capacity, alignof(std::max_align_t));
+		m_blocks.push_back({ std::make_unique<unsigned char[]>(size), size });
+		m_charge.set(size);
+	}
+
+	void* FrameArena::allocateBytes(std::size_t bytes, std::size_t alignment) {
+		for (;;) {
+			Block& block = m_blocks[m_block];
+			const std::size_t start = (m_offset + alignment - 1U) & ~(alignment - 1U);
+			if (start + bytes <= block.size) {
+				m_offset = start + bytes;
+				return block.memory.get() + start;
+			}
+
+			// Spill: the next block left by an earlier rewind, or a new one twice as big
+			if (m_block + 1U == m_blocks.size()) {
+				const std::size_t size = std::max(bytes, m_blocks.back().size * 2U);
+				m_blocks.push_back({ std::make_unique<unsigned char[]>(size), size });
+				m_charge.set(capacity());
+			}
+			++m_block;
+			m_offset = 0U;
+		}
+	}
+
+	void FrameArena::reset() {
+		if (m_blocks.size() > 1U) {
+			const std::size_t size = capacity();
+			m_blocks.clear();
+			m_blocks.push_back({ std::make_unique<unsigned char[]>(size), size });
+			m_charge.set(size);
+		}
+		m_block = 0U;
+		m_offset = 0U;
+	}
+
+	std::size_t FrameArena::used() const noexcept {
+		std::size_t bytes = m_offset;
+		for (std::size_t i = 0U; i < m_block; ++i) {
+			bytes += m_blocks[i].size;
+		}
+		return bytes;
+	}
+
+	std::size_t FrameArena::capacity() const noexcept {
+		std::size_t bytes = 0U;
+		for (const auto& block : m_blocks) {
+			bytes += block.size;
+		}
+		return bytes;
+	}
+
+} // namespace sim
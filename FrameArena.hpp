@@ -0,0 +1,111 @@
+/*
+==============================================================================
+Frame Arena - linear scratch memory for data that lives one frame
+==============================================================================
+ - allocate() bumps an offset in one block; reset() at the top of the frame
+   releases everything at once, so per-frame lists cost no heap traffic
+ - A frame that outgrows the block spills into extra blocks; the next
+   reset() merges them into one block big enough for that frame, so the
+   steady state allocates nothing
+ - ArenaMark rewinds to a saved point, for scratch that only lives inside
+   one call (e.g. the candidate list of a collision sweep)
+ - Trivially destructible types only: nothing is ever destroyed. An arena
+   belongs to one thread at a time; it is not synchronized
+ - The blocks held are charged to the frame-arena memory subsystem
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief Array handed out by a FrameArena; valid until the arena is reset
+	 *        or rewound past it.
+	 */
+	template <typename T>
+	struct ArenaSpan {
+		T* data = nullptr;
+		std::size_t size = 0U;
+
+		[[nodiscard]] T* begin() const noexcept { return data; }
+		[[nodiscard]] T* end() const noexcept { return data + size; }
+		[[nodiscard]] bool empty() const noexcept { return size == 0U; }
+		[[nodiscard]] T& operator[](std::size_t i) const noexcept { return data[i]; }
+	};
+
+	class FrameArena {
+	public:
+		static constexpr std::size_t DEFAULT_CAPACITY = 64U * 1024U; // bytes
+
+		explicit FrameArena(std::size_t capacity = DEFAULT_CAPACITY);
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		/**
+		 * @brief Uninitialized room for count values of T.
+		 */
+		template <typename T>
+		[[nodiscard]] ArenaSpan<T> allocate(std::size_t count) {
+			static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+			static_assert(alignof(T) <= alignof(std::max_align_t), "FrameArena blocks are max_align_t aligned");
+			return { static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T))), count };
+		}
+
+		/**
+		 * @brief Releases everything allocated since the last reset.
+		 */
+		void reset();
+
+		[[nodiscard]] std::size_t used() const noexcept;     // bytes handed out since the last reset
+		[[nodiscard]] std::size_t capacity() const noexcept; // bytes held across all blocks
+
+	private:
+		friend class ArenaMark;
+
+		struct Block {
+			std::unique_ptr<unsigned char[]> memory;
+			std::size_t size = 0U;
+		};
+
+		[[nodiscard]] void* allocateBytes(std::size_t bytes, std::size_t alignment);
+
+		std::vector<Block> m_blocks; // [0] is the main block, the others spilled this frame
+		std::size_t m_block = 0U;    // block being filled
+		std::size_t m_offset = 0U;   // first free byte in it
+		prof::MemoryCharge m_charge{ prof::MemorySubsystem::FrameArenas, prof::MemoryKind::Heap }; // capacity()
+	};
+
+	/**
+	 * @brief Rewinds the arena to where it stood at construction.
+	 *
+	 * Nested marks must end in reverse order, like the scopes holding them.
+	 */
+	class ArenaMark {
+	public:
+		explicit ArenaMark(FrameArena& arena) noexcept
+			: m_arena(arena), m_block(arena.m_block), m_offset(arena.m_offset) {
+		}
+		~ArenaMark() {
+			m_arena.m_block = m_block;
+			m_arena.m_offset = m_offset;
+		}
+
+		ArenaMark(const ArenaMark&) = delete;
+		ArenaMark& operator=(const ArenaMark&) = delete;
+
+	private:
+		FrameArena& m_arena;
+		std::size_t m_block;
+		std::size_t m_offset;
+	};
+
+} // namespace sim
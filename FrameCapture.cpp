@@ -0,0 +1,164 @@
+#include "FrameCapture.hpp"
+
+#include <SFML/Window/Context.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr std::chrono::milliseconds ENCODER_IDLE_SLEEP{ 2 };
+
+		[[nodiscard]] gl::ProcAddress captureLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+	}
+
+	FrameCapture::~FrameCapture() {
+		stop();
+	}
+
+	bool FrameCapture::start(const std::string& directory, const std::string& extension, const sf::Vector2u& size) {
+		if (m_thread.joinable() || size.x == 0U || size.y == 0U) {
+			return false;
+		}
+		if (!gl::loaded() && !gl::load(&captureLoader)) {
+			OKPP_LOG_ERROR("Error: pixel buffers are unavailable, --capture is off");
+			return false;
+		}
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error) {
+			OKPP_LOG_ERROR("Error: cannot create capture directory %s", directory.c_str());
+			return false;
+		}
+
+		const gl::Api& api = gl::api();
+		const auto bytes = static_cast<gl::SizeiPtr>(size.x) * static_cast<gl::SizeiPtr>(size.y) * 4;
+		api.GenBuffers(static_cast<GLsizei>(m_packBuffers.size()), m_packBuffers.data());
+		for (const GLuint buffer : m_packBuffers) {
+			api.BindBuffer(gl::PIXEL_PACK_BUFFER, buffer);
+			api.BufferData(gl::PIXEL_PACK_BUFFER, bytes, nullptr, gl::STREAM_READ);
+		}
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, 0U);
+
+		for (std::uint32_t slot = 0U; slot < SLOT_COUNT; ++slot) {
+			m_slots[slot].resize(static_cast<std::size_t>(bytes));
+			(void)m_free.tryPush(slot);
+		}
+		m_inFlight = {};
+		m_nextBuffer = 0U;
+		m_frame = 0U;
+		m_size = size;
+		m_directory = directory;
+		m_extension = extension;
+		m_stop.store(false, std::memory_order_relaxed);
+		m_thread = std::thread([this]() { run(); });
+		return true;
+	}
+
+	void FrameCapture::capture() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("capture readback");
+		const gl::Api& api = gl::api();
+
+		// This frame's transfer starts now; the previous one has had a whole frame to finish
+		const std::size_t current = m_nextBuffer;
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, m_packBuffers[current]);
+		glReadPixels(0, 0, static_cast<GLsizei>(m_size.x), static_cast<GLsizei>(m_size.y), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		m_inFlight[current] = true;
+		m_inFlightFrame[current] = m_frame++;
+
+		m_nextBuffer = current ^ 1U;
+		collect(m_nextBuffer);
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, 0U);
+	}
+
+	void FrameCapture::collect(std::size_t buffer) {
+		if (!m_inFlight[buffer]) {
+			return;
+		}
+		m_inFlight[buffer] = false;
+
+		const gl::Api& api = gl::api();
+		api.BindBuffer(gl::PIXEL_PACK_BUFFER, m_packBuffers[buffer]);
+		const void* pixels = api.MapBuffer(gl::PIXEL_PACK_BUFFER, gl::READ_ONLY);
+		std::uint32_t slot = 0U;
+		if (pixels != nullptr && m_free.tryPop(slot)) {
+			std::memcpy(m_slots[slot].data(), pixels, m_slots[slot].size());
+			m_slotFrame[slot] = m_inFlightFrame[buffer];
+			(void)m_encode.tryPush(slot); // never full: it holds at most every slot
+		}
+		else {
+			m_dropped.fetch_add(1U, std::memory_order_relaxed);
+		}
+		if (pixels != nullptr) {
+			(void)api.UnmapBuffer(gl::PIXEL_PACK_BUFFER);
+		}
+	}
+
+	void FrameCapture::stop() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		{
+			// Buffers are shared between SFML contexts; the window's may already be gone
+			const sf::Context context;
+			collect(m_nextBuffer ^ 1U);
+			gl::api().BindBuffer(gl::PIXEL_PACK_BUFFER, 0U);
+			gl::api().DeleteBuffers(static_cast<GLsizei>(m_packBuffers.size()), m_packBuffers.data());
+			m_packBuffers = {};
+		}
+		m_stop.store(true, std::memory_order_release);
+		m_thread.join();
+
+		const CaptureStats totals = stats();
+		OKPP_LOG_INFO("Capture: wrote %llu frames to %s, dropped %llu", static_cast<unsigned long long>(totals.written),
+			m_directory.c_str(), static_cast<unsigned long long>(totals.dropped));
+	}
+
+	CaptureStats FrameCapture::stats() const noexcept {
+		return { m_written.load(std::memory_order_relaxed), m_dropped.load(std::memory_order_relaxed) };
+	}
+
+	void FrameCapture::run() {
+		prof::setThreadName("capture encoder");
+		char name[32];
+		std::uint32_t slot = 0U;
+		for (;;) {
+			const bool stopping = m_stop.load(std::memory_order_acquire);
+			bool any = false;
+			while (m_encode.tryPop(slot)) {
+				any = true;
+				OKPP_TRACE_SCOPE("capture encode");
+				// glReadPixels rows run bottom-up
+				sf::Image image(m_size, m_slots[slot].data());
+				image.flipVertically();
+				std::snprintf(name, sizeof(name), "frame_%06u.", static_cast<unsigned>(m_slotFrame[slot]));
+				if (image.saveToFile(std::filesystem::path(m_directory) / (name + m_extension))) {
+					m_written.fetch_add(1U, std::memory_order_relaxed);
+				}
+				else {
+					m_dropped.fetch_add(1U, std::memory_order_relaxed);
+				}
+				(void)m_free.tryPush(slot);
+			}
+			if (stopping && !any) {
+				break;
+			}
+			if (!any) {
+				std::this_thread::sleep_for(ENCODER_IDLE_SLEEP);
+			}
+		}
+	}
+
+} // namespace gfx
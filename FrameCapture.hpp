@@ -0,0 +1,97 @@
+/*
+==============================================================================
+Frame Capture - numbered image files of every rendered frame (--capture)
+==============================================================================
+ - glReadPixels goes into one of two pixel-pack buffers and returns at
+   once; the frame read one call earlier is mapped from the other buffer,
+   by which time its transfer has finished, so the render loop never
+   waits on the GPU
+ - Mapped pixels are copied into one of a fixed set of slots and handed
+   to an encoder thread through an SPSC ring; the encoder flips, encodes
+   and writes the image, then hands the slot back through a second ring
+ - When every slot is still waiting for the encoder the frame is dropped
+   and counted, so a slow disk cannot stall rendering either
+ - With --replay the frames follow the recorded frame times, so a capture
+   is the same drive at the same pacing on every run
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GlFunctions.hpp"
+#include "SpscRing.hpp"
+
+namespace gfx {
+
+	struct CaptureStats {
+		std::uint64_t written = 0U;
+		std::uint64_t dropped = 0U; // no free slot, or the buffer could not be mapped or saved
+	};
+
+	class FrameCapture {
+	public:
+		FrameCapture() = default;
+		~FrameCapture();
+
+		FrameCapture(const FrameCapture&) = delete;
+		FrameCapture& operator=(const FrameCapture&) = delete;
+
+		/**
+		 * @brief Starts capturing size-pixel frames as directory/frame_NNNNNN.extension.
+		 *
+		 * Requires the window's GL context to be active. Returns false (and
+		 * logs) if the directory cannot be created or pixel buffers are missing.
+		 */
+		[[nodiscard]] bool start(const std::string& directory, const std::string& extension, const sf::Vector2u& size);
+
+		/**
+		 * @brief Queues the back buffer of the active context; call after drawing, before display().
+		 */
+		void capture();
+
+		/**
+		 * @brief Writes the frame still in flight, drains the encoder and stops; safe to call twice.
+		 *
+		 * Brings up a shared GL context of its own, so it may run after the window closed.
+		 */
+		void stop();
+
+		[[nodiscard]] CaptureStats stats() const noexcept;
+
+	private:
+		static constexpr std::size_t SLOT_COUNT = 8U;
+
+		void collect(std::size_t buffer);
+		void run();
+
+		std::array<GLuint, 2> m_packBuffers{};
+		std::array<bool, 2> m_inFlight{};
+		std::array<std::uint32_t, 2> m_inFlightFrame{};
+		std::size_t m_nextBuffer = 0U;
+		std::uint32_t m_frame = 0U;
+
+		std::array<std::vector<std::uint8_t>, SLOT_COUNT> m_slots;
+		std::array<std::uint32_t, SLOT_COUNT> m_slotFrame{};
+		sim::SpscRing<std::uint32_t, SLOT_COUNT> m_encode; // render -> encoder: filled slots
+		sim::SpscRing<std::uint32_t, SLOT_COUNT> m_free;   // encoder -> render: written slots
+
+		sf::Vector2u m_size;
+		std::string m_directory;
+		std::string m_extension;
+		std::atomic<bool> m_stop{ false };
+		std::atomic<std::uint64_t> m_written{ 0U };
+		std::atomic<std::uint64_t> m_dropped{ 0U };
+		std::thread m_thread;
+	};
+
+} // namespace gfx
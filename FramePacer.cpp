@@ -0,0 +1,165 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002 // Windows 10 1803 and later; older SDKs lack the name
+#endif
+#elif defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#endif
+
+#include "Log.hpp"
+
+namespace prof {
+
+	namespace {
+		constexpr double PACER_MIN_RATE_HZ = 1.0;
+		constexpr double PACER_MAX_RATE_HZ = 1000.0;
+	}
+
+	FramePacer::FramePacer(const FramePacerSettings& settings)
+		: m_settings(settings) {
+		m_settings.rateHz = std::clamp(m_settings.rateHz, PACER_MIN_RATE_HZ, PACER_MAX_RATE_HZ);
+		m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_settings.rateHz));
+		m_settings.spin = std::clamp(m_settings.spin, std::chrono::microseconds{ 0 },
+			std::chrono::duration_cast<std::chrono::microseconds>(m_period));
+#ifdef _WIN32
+		m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		m_highResolution = m_timer != nullptr;
+		if (m_timer == nullptr) {
+			// Before Windows 10 1803: a plain timer still beats Sleep(), and the spin covers its tick
+			m_timer = CreateWaitableTimerW(nullptr, TRUE, nullptr);
+		}
+#elif defined(__linux__)
+		m_highResolution = true;
+#endif
+	}
+
+	FramePacer::~FramePacer() {
+#ifdef _WIN32
+		if (m_timer != nullptr) {
+			CloseHandle(m_timer);
+		}
+#endif
+	}
+
+	void FramePacer::sleepUntil(Clock::time_point wake) {
+		const Clock::duration left = wake - Clock::now();
+		if (left <= Clock::duration::zero()) {
+			return;
+		}
+#ifdef _WIN32
+		if (m_timer != nullptr) {
+			LARGE_INTEGER due{};
+			due.QuadPart = -static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(left).count() / 100);
+			if (SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE) != 0) {
+				WaitForSingleObject(m_timer, INFINITE);
+				return;
+			}
+		}
+		std::this_thread::sleep_until(wake);
+#elif defined(__linux__)
+		// An absolute time: an interrupted sleep resumes towards the same instant
+		timespec now{};
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count()
+			+ static_cast<long long>(now.tv_nsec);
+		timespec until{};
+		until.tv_sec = now.tv_sec + static_cast<time_t>(ns / 1'000'000'000LL);
+		until.tv_nsec = static_cast<long>(ns % 1'000'000'000LL);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) == EINTR) {
+		}
+#else
+		std::this_thread::sleep_until(wake);
+#endif
+	}
+
+	void FramePacer::wait() {
+		const Clock::time_point now = Clock::now();
+		if (!m_started) {
+			m_started = true;
+			m_deadline = now + m_period;
+			m_lastWake = now;
+			return;
+		}
+
+		if (now >= m_deadline) {
+			++m_missed;
+			if (now - m_deadline > m_period) {
+				m_deadline = now; // a stall: start over rather than rush the next frames
+			}
+		}
+		else {
+			sleepUntil(m_deadline - m_settings.spin);
+			while (Clock::now() < m_deadline) {
+				std::this_thread::yield();
+			}
+		}
+
+		const Clock::time_point wake = Clock::now();
+		m_intervalsMs[m_recorded % HISTORY] = std::chrono::duration<float, std::milli>(wake - m_lastWake).count();
+		++m_recorded;
+		m_lastWake = wake;
+		m_deadline += m_period;
+	}
+
+	void FramePacer::presented() noexcept {
+		if (m_settings.alignToPresent && m_started) {
+			// Presentation returned at a refresh: let the next frame go a spin before the one after it,
+			// so it is handed over in time and the blocking present absorbs the rest
+			m_deadline = Clock::now() + m_period - std::chrono::duration_cast<Clock::duration>(m_settings.spin);
+		}
+	}
+
+	FramePacerReport FramePacer::report() const {
+		FramePacerReport report;
+		report.periodMs = std::chrono::duration<float, std::milli>(m_period).count();
+		report.missed = m_missed;
+		report.frames = static_cast<std::size_t>(std::min<std::uint64_t>(m_recorded, HISTORY));
+		if (report.frames == 0U) {
+			return report;
+		}
+
+		double sum = 0.0;
+		std::vector<float> errors(report.frames);
+		for (std::size_t i = 0U; i < report.frames; ++i) {
+			sum += static_cast<double>(m_intervalsMs[i]);
+			errors[i] = std::fabs(m_intervalsMs[i] - report.periodMs);
+		}
+		const double mean = sum / static_cast<double>(report.frames);
+		double squares = 0.0;
+		for (std::size_t i = 0U; i < report.frames; ++i) {
+			const double deviation = static_cast<double>(m_intervalsMs[i]) - mean;
+			squares += deviation * deviation;
+		}
+		std::sort(errors.begin(), errors.end());
+		report.meanMs = static_cast<float>(mean);
+		report.jitterMs = static_cast<float>(std::sqrt(squares / static_cast<double>(report.frames)));
+		report.p99ErrorMs = errors[static_cast<std::size_t>(0.99F * static_cast<float>(report.frames - 1U) + 0.5F)];
+		report.maxErrorMs = errors.back();
+		return report;
+	}
+
+	void FramePacer::logReport() const {
+		const FramePacerReport pacing = report();
+		if (pacing.frames == 0U) {
+			OKPP_LOG_WARNING("Warning: no paced frame to report");
+			return;
+		}
+		OKPP_LOG_INFO("Frame pacing over %zu frames at %.2f ms (%s timer): mean %.3f ms, jitter %.3f ms, "
+			"error p99 %.3f / max %.3f ms, %llu deadlines missed", pacing.frames, static_cast<double>(pacing.periodMs),
+			m_highResolution ? "high-resolution" : "generic", static_cast<double>(pacing.meanMs),
+			static_cast<double>(pacing.jitterMs), static_cast<double>(pacing.p99ErrorMs),
+			static_cast<double>(pacing.maxErrorMs), static_cast<unsigned long long>(pacing.missed));
+	}
+
+} // namespace prof
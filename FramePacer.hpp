@@ -0,0 +1,100 @@
+/*
+==============================================================================
+Frame Pacer - sleep-free frame limiter with jitter statistics (--pacer)
+==============================================================================
+ - Replaces setFramerateLimit(), whose sf::sleep() rounds to the OS timer
+   tick (1-15 ms on Windows) and makes frame times uneven
+ - wait() blocks until the next deadline on a high-resolution timer:
+   a waitable timer with CREATE_WAITABLE_TIMER_HIGH_RESOLUTION on Windows,
+   clock_nanosleep() on an absolute CLOCK_MONOTONIC time on Linux, and
+   sleep_until() elsewhere; the timer is set SPIN earlier and the rest is
+   spun on steady_clock, so timer slack never makes a frame late
+ - Deadlines sit on a fixed grid, deadline += period, so rounding does not
+   accumulate; a frame more than a period late restarts the grid from now
+   instead of rushing the following frames to catch up
+ - Vsync alignment: with alignToPresent the grid is re-anchored to the
+   time each presentation returned, so the pacer follows the display's
+   real refresh instead of drifting against it
+ - Every wait records the interval since the previous one; report() gives
+   mean, standard deviation, p99 and worst error against the period and
+   the deadlines missed over the last HISTORY frames
+ - No SFML dependency; timings come from std::chrono::steady_clock
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace prof {
+
+	struct FramePacerSettings {
+		double rateHz = 60.0;            // frames per second to pace to
+		std::chrono::microseconds spin{ 1500 }; // spun on the clock before each deadline
+		bool alignToPresent = false;     // re-anchor the grid at every presented()
+	};
+
+	struct FramePacerReport {
+		std::size_t frames = 0U;   // intervals the statistics cover
+		float periodMs = 0.0F;     // the interval aimed for
+		float meanMs = 0.0F;
+		float jitterMs = 0.0F;     // standard deviation of the intervals
+		float p99ErrorMs = 0.0F;   // 99th percentile of |interval - period|
+		float maxErrorMs = 0.0F;
+		std::uint64_t missed = 0U; // deadlines already past when wait() was called
+	};
+
+	class FramePacer {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr std::size_t HISTORY = 1024U;
+
+		explicit FramePacer(const FramePacerSettings& settings = {});
+		~FramePacer();
+
+		FramePacer(const FramePacer&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+
+		/**
+		 * @brief Blocks until the next frame deadline, then moves the deadline one period on.
+		 */
+		void wait();
+
+		/**
+		 * @brief Call once the frame has been presented; re-anchors the grid under alignToPresent.
+		 */
+		void presented() noexcept;
+
+		[[nodiscard]] FramePacerReport report() const;
+
+		/**
+		 * @brief Logs report(); a warning when no interval has been recorded.
+		 */
+		void logReport() const;
+
+		/**
+		 * @brief True when wait() sleeps on a high-resolution OS timer, false on the generic fallback.
+		 */
+		[[nodiscard]] bool highResolution() const noexcept { return m_highResolution; }
+
+	private:
+		void sleepUntil(Clock::time_point wake);
+
+		FramePacerSettings m_settings;
+		Clock::duration m_period{};
+		Clock::time_point m_deadline{};
+		Clock::time_point m_lastWake{};
+		bool m_started = false;
+		bool m_highResolution = false;
+		void* m_timer = nullptr; // HANDLE of the waitable timer (Windows only)
+
+		std::array<float, HISTORY> m_intervalsMs{};
+		std::uint64_t m_recorded = 0U;
+		std::uint64_t m_missed = 0U;
+	};
+
+} // namespace prof
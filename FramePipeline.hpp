@@ -0,0 +1,90 @@
+/*
+==============================================================================
+Frame Pipeline - simulate the next frame while the current one is drawn
+==============================================================================
+ - Two snapshots of everything the renderer reads: the front one is drawn
+   while a pool task writes the next frame into the back one, so draw and
+   display (vsync included) no longer wait for the simulation
+ - The caller fills the back snapshot's inputs with next(), then launch()
+   hands it to the simulation; front() only changes inside sync()
+ - Without a pool every frame is simulated inline and shown right away,
+   so both modes run the same code in the same order
+ - Between sync() and launch() nothing runs in the background: that is
+   where the main thread may touch state the simulation reads
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	template <typename Snapshot>
+	class FramePipeline {
+	public:
+		using Simulate = std::function<void(Snapshot& snapshot)>;
+
+		/**
+		 * @brief pool null simulates inline; otherwise one frame is kept in flight.
+		 */
+		FramePipeline(ThreadPool* pool, Simulate simulate)
+			: m_pool(pool), m_simulate(std::move(simulate)) {
+		}
+
+		~FramePipeline() { sync(); }
+
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline& operator=(const FramePipeline&) = delete;
+
+		/**
+		 * @brief Waits for the frame in flight, if any, and makes it the front.
+		 */
+		void sync() {
+			if (m_inFlight) {
+				m_pool->wait(m_group);
+				m_inFlight = false;
+				m_front ^= 1U;
+			}
+		}
+
+		/**
+		 * @brief Snapshot the next launch() simulates into; syncs first.
+		 */
+		[[nodiscard]] Snapshot& next() {
+			sync();
+			return m_buffers[m_front ^ 1U];
+		}
+
+		/**
+		 * @brief Simulates next(): inline (it becomes the front at once) or on the pool.
+		 */
+		void launch() {
+			Snapshot& back = next();
+			if (m_pool == nullptr) {
+				m_simulate(back);
+				m_front ^= 1U;
+				return;
+			}
+			m_inFlight = true;
+			m_pool->submit(m_group, [this, &back]() { m_simulate(back); });
+		}
+
+		[[nodiscard]] const Snapshot& front() const noexcept { return m_buffers[m_front]; }
+		[[nodiscard]] bool pipelined() const noexcept { return m_pool != nullptr; }
+
+	private:
+		ThreadPool* m_pool;
+		Simulate m_simulate;
+		TaskGroup m_group;
+		std::array<Snapshot, 2> m_buffers{};
+		std::size_t m_front = 0U;
+		bool m_inFlight = false;
+	};
+
+} // namespace sim
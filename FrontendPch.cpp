@@ -0,0 +1,2 @@
+// Compiled with /Yc: builds the precompiled header the other translation units use
+#include "FrontendPch.hpp"
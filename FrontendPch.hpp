@@ -0,0 +1,20 @@
+/*
+==============================================================================
+Front-end Precompiled Header - the SFML front-end
+==============================================================================
+ - The full <SFML/Graphics.hpp>, <SFML/Audio.hpp> and <SFML/Network.hpp>
+   are parsed once per build instead of once per translation unit
+ - Builds on CorePch.hpp, so core headers included by front-end code find
+   their dependencies already compiled
+ - Never included by name; the build injects it (CMake
+   target_precompile_headers, /FI with /Yu in the Visual Studio project)
+==============================================================================
+*/
+
+#pragma once
+
+#include "CorePch.hpp"
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
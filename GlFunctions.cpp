@@ -0,0 +1,191 @@
+#include "GlFunctions.hpp"
+
+#include <iostream>
+#include <string>
+
+namespace gl {
+
+	namespace {
+		Api g_api;
+		bool g_loaded = false;
+		bool g_computeLoaded = false;
+		bool g_storageLoaded = false;
+		bool g_timerLoaded = false;
+
+		[[nodiscard]] std::string infoLog(GLuint object, bool isProgram) {
+			GLint length = 0;
+			if (isProgram) {
+				g_api.GetProgramiv(object, INFO_LOG_LENGTH, &length);
+			}
+			else {
+				g_api.GetShaderiv(object, INFO_LOG_LENGTH, &length);
+			}
+
+			std::string log(static_cast<std::size_t>(length > 0 ? length : 1), '\0');
+			if (isProgram) {
+				g_api.GetProgramInfoLog(object, static_cast<GLsizei>(log.size()), nullptr, log.data());
+			}
+			else {
+				g_api.GetShaderInfoLog(object, static_cast<GLsizei>(log.size()), nullptr, log.data());
+			}
+			return log;
+		}
+
+		[[nodiscard]] GLuint compileShader(GLenum type, const char* source) {
+			const GLuint shader = g_api.CreateShader(type);
+			g_api.ShaderSource(shader, 1, &source, nullptr);
+			g_api.CompileShader(shader);
+
+			GLint ok = GL_FALSE;
+			g_api.GetShaderiv(shader, COMPILE_STATUS, &ok);
+			if (ok != GL_TRUE) {
+				std::cerr << "Error: GL shader compilation failed:\n" << infoLog(shader, false) << '\n';
+				g_api.DeleteShader(shader);
+				return 0U;
+			}
+			return shader;
+		}
+	}
+
+	bool load(ProcLoader loader) {
+		g_loaded = false;
+		if (loader == nullptr) {
+			return false;
+		}
+
+#define OKPP_GL_RESOLVE(ret, name, params) \
+		g_api.name = reinterpret_cast<ret (APIENTRY*) params>(loader("gl" #name)); \
+		if (g_api.name == nullptr) { \
+			std::cerr << "Error: OpenGL function gl" #name " is not available\n"; \
+			return false; \
+		}
+		OKPP_GL_FUNCTIONS(OKPP_GL_RESOLVE)
+#undef OKPP_GL_RESOLVE
+
+		g_loaded = true;
+		return true;
+	}
+
+	bool loaded() noexcept {
+		return g_loaded;
+	}
+
+	// Optional tables warn instead of failing hard: callers fall back to older paths
+#define OKPP_GL_RESOLVE_OPTIONAL(ret, name, params) \
+		g_api.name = reinterpret_cast<ret (APIENTRY*) params>(loader("gl" #name)); \
+		if (g_api.name == nullptr) { \
+			std::cerr << "Warning: OpenGL function gl" #name " is not available\n"; \
+			return false; \
+		}
+
+	bool loadCompute(ProcLoader loader) {
+		g_computeLoaded = false;
+		if (!g_loaded || loader == nullptr) {
+			return false;
+		}
+		OKPP_GL_COMPUTE_FUNCTIONS(OKPP_GL_RESOLVE_OPTIONAL)
+		g_computeLoaded = true;
+		return true;
+	}
+
+	bool loadStorage(ProcLoader loader) {
+		g_storageLoaded = false;
+		if (!g_computeLoaded && !loadCompute(loader)) {
+			return false;
+		}
+		OKPP_GL_STORAGE_FUNCTIONS(OKPP_GL_RESOLVE_OPTIONAL)
+		g_storageLoaded = true;
+		return true;
+	}
+
+	bool loadTimer(ProcLoader loader) {
+		g_timerLoaded = false;
+		if (!g_loaded || loader == nullptr) {
+			return false;
+		}
+		OKPP_GL_TIMER_FUNCTIONS(OKPP_GL_RESOLVE_OPTIONAL)
+		g_timerLoaded = true;
+		return true;
+	}
+
+#undef OKPP_GL_RESOLVE_OPTIONAL
+
+	bool computeLoaded() noexcept {
+		return g_computeLoaded;
+	}
+
+	bool storageLoaded() noexcept {
+		return g_storageLoaded;
+	}
+
+	bool timerLoaded() noexcept {
+		return g_timerLoaded;
+	}
+
+	const Api& api() noexcept {
+		return g_api;
+	}
+
+	GLuint buildProgram(const char* vertexSource, const char* fragmentSource,
+		const char* const* attributeNames, std::size_t attributeCount)
+	{
+		if (!g_loaded) {
+			return 0U;
+		}
+
+		const GLuint vs = compileShader(VERTEX_SHADER, vertexSource);
+		const GLuint fs = compileShader(FRAGMENT_SHADER, fragmentSource);
+		if (vs == 0U || fs == 0U) {
+			if (vs != 0U) { g_api.DeleteShader(vs); }
+			if (fs != 0U) { g_api.DeleteShader(fs); }
+			return 0U;
+		}
+
+		const GLuint program = g_api.CreateProgram();
+		g_api.AttachShader(program, vs);
+		g_api.AttachShader(program, fs);
+		for (std::size_t i = 0U; i < attributeCount; ++i) {
+			g_api.BindAttribLocation(program, static_cast<GLuint>(i), attributeNames[i]);
+		}
+		g_api.LinkProgram(program);
+
+		// Shaders are owned by the program once linked
+		g_api.DeleteShader(vs);
+		g_api.DeleteShader(fs);
+
+		GLint ok = GL_FALSE;
+		g_api.GetProgramiv(program, LINK_STATUS, &ok);
+		if (ok != GL_TRUE) {
+			std::cerr << "Error: GL program link failed:\n" << infoLog(program, true) << '\n';
+			g_api.DeleteProgram(program);
+			return 0U;
+		}
+		return program;
+	}
+
+	GLuint buildComputeProgram(const char* computeSource) {
+		if (!g_computeLoaded) {
+			return 0U;
+		}
+
+		const GLuint cs = compileShader(COMPUTE_SHADER, computeSource);
+		if (cs == 0U) {
+			return 0U;
+		}
+
+		const GLuint program = g_api.CreateProgram();
+		g_api.AttachShader(program, cs);
+		g_api.LinkProgram(program);
+		g_api.DeleteShader(cs);
+
+		GLint ok = GL_FALSE;
+		g_api.GetProgramiv(program, LINK_STATUS, &ok);
+		if (ok != GL_TRUE) {
+			std::cerr << "Error: GL compute program link failed:\n" << infoLog(program, true) << '\n';
+			g_api.DeleteProgram(program);
+			return 0U;
+		}
+		return program;
+	}
+
+} // namespace gl
@@ -0,0 +1,224 @@
+/*
+==============================================================================
+GL Functions - minimal loader for the post-1.1 OpenGL entry points we use
+==============================================================================
+ - The system gl.h only guarantees OpenGL 1.1; buffer, shader and instancing
+   functions have to be fetched from the driver at runtime
+ - Works with any loader callback: sf::Context::getFunction for the SFML
+   front-end, glutGetProcAddress for the GLUT variant
+ - The GL 4.3 compute entry points, the GL 4.4 persistent-buffer ones and
+   the GL 3.3 timer queries are separate, optional tables so the renderers
+   keep working on older drivers
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/OpenGL.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gl {
+
+	using ProcAddress = void (*)();
+	using ProcLoader = ProcAddress(*)(const char* name);
+
+	using SizeiPtr = std::ptrdiff_t;
+	using IntPtr = std::ptrdiff_t;
+	using Sync = void*; // GLsync, opaque to us
+
+	// Enumerants that are not part of the OpenGL 1.1 headers
+	constexpr GLenum ARRAY_BUFFER = 0x8892U;
+	constexpr GLenum STREAM_DRAW = 0x88E0U;
+	constexpr GLenum STATIC_DRAW = 0x88E4U;
+	constexpr GLenum DYNAMIC_DRAW = 0x88E8U;
+	constexpr GLenum MULTISAMPLE = 0x809DU;
+	constexpr GLenum FRAGMENT_SHADER = 0x8B30U;
+	constexpr GLenum VERTEX_SHADER = 0x8B31U;
+	constexpr GLenum COMPILE_STATUS = 0x8B81U;
+	constexpr GLenum LINK_STATUS = 0x8B82U;
+	constexpr GLenum INFO_LOG_LENGTH = 0x8B84U;
+	constexpr GLenum RGBA16F = 0x881AU;
+	constexpr GLenum PIXEL_PACK_BUFFER = 0x88EBU;
+	constexpr GLenum PIXEL_UNPACK_BUFFER = 0x88ECU;
+	constexpr GLenum STREAM_READ = 0x88E1U;
+	constexpr GLenum READ_ONLY = 0x88B8U;
+	constexpr GLenum WRITE_ONLY = 0x88B9U;
+	constexpr GLenum DYNAMIC_READ = 0x88E9U;
+	constexpr GLenum SHADER_STORAGE_BUFFER = 0x90D2U;
+	constexpr GLenum COMPUTE_SHADER = 0x91B9U;
+	constexpr GLenum SYNC_GPU_COMMANDS_COMPLETE = 0x9117U;
+	constexpr GLenum ALREADY_SIGNALED = 0x911AU;
+	constexpr GLenum TIMEOUT_EXPIRED = 0x911BU;
+	constexpr GLenum CONDITION_SATISFIED = 0x911CU;
+	constexpr GLenum WAIT_FAILED = 0x911DU;
+	constexpr GLbitfield SYNC_FLUSH_COMMANDS_BIT = 0x1U;
+	constexpr GLbitfield MAP_READ_BIT = 0x1U;
+	constexpr GLbitfield BUFFER_UPDATE_BARRIER_BIT = 0x200U;
+	constexpr GLbitfield SHADER_STORAGE_BARRIER_BIT = 0x2000U;
+	constexpr GLenum DRAW_INDIRECT_BUFFER = 0x8F3FU;
+	constexpr GLbitfield MAP_WRITE_BIT = 0x2U;
+	constexpr GLbitfield MAP_PERSISTENT_BIT = 0x40U;
+	constexpr GLbitfield MAP_COHERENT_BIT = 0x80U;
+	constexpr GLenum TIME_ELAPSED = 0x88BFU;
+	constexpr GLenum QUERY_RESULT = 0x8866U;
+	constexpr GLenum QUERY_RESULT_AVAILABLE = 0x8867U;
+
+// X-macro table: return type, name, parameter list
+#define OKPP_GL_FUNCTIONS(X) \
+	X(void, GenBuffers, (GLsizei n, GLuint* buffers)) \
+	X(void, DeleteBuffers, (GLsizei n, const GLuint* buffers)) \
+	X(void, BindBuffer, (GLenum target, GLuint buffer)) \
+	X(void, BufferData, (GLenum target, SizeiPtr size, const void* data, GLenum usage)) \
+	X(void, BufferSubData, (GLenum target, IntPtr offset, SizeiPtr size, const void* data)) \
+	X(void*, MapBuffer, (GLenum target, GLenum access)) \
+	X(GLboolean, UnmapBuffer, (GLenum target)) \
+	X(GLuint, CreateShader, (GLenum type)) \
+	X(void, ShaderSource, (GLuint shader, GLsizei count, const char* const* source, const GLint* length)) \
+	X(void, CompileShader, (GLuint shader)) \
+	X(void, GetShaderiv, (GLuint shader, GLenum pname, GLint* params)) \
+	X(void, GetShaderInfoLog, (GLuint shader, GLsizei bufSize, GLsizei* length, char* infoLog)) \
+	X(void, DeleteShader, (GLuint shader)) \
+	X(GLuint, CreateProgram, ()) \
+	X(void, AttachShader, (GLuint program, GLuint shader)) \
+	X(void, BindAttribLocation, (GLuint program, GLuint index, const char* name)) \
+	X(void, LinkProgram, (GLuint program)) \
+	X(void, GetProgramiv, (GLuint program, GLenum pname, GLint* params)) \
+	X(void, GetProgramInfoLog, (GLuint program, GLsizei bufSize, GLsizei* length, char* infoLog)) \
+	X(void, DeleteProgram, (GLuint program)) \
+	X(void, UseProgram, (GLuint program)) \
+	X(GLint, GetUniformLocation, (GLuint program, const char* name)) \
+	X(void, Uniform1i, (GLint location, GLint v0)) \
+	X(void, Uniform1f, (GLint location, GLfloat v0)) \
+	X(void, Uniform4fv, (GLint location, GLsizei count, const GLfloat* value)) \
+	X(void, UniformMatrix4fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)) \
+	X(void, EnableVertexAttribArray, (GLuint index)) \
+	X(void, DisableVertexAttribArray, (GLuint index)) \
+	X(void, VertexAttribPointer, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)) \
+	X(void, VertexAttribDivisor, (GLuint index, GLuint divisor)) \
+	X(void, DrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)) \
+	X(void, GenVertexArrays, (GLsizei n, GLuint* arrays)) \
+	X(void, BindVertexArray, (GLuint array)) \
+	X(void, DeleteVertexArrays, (GLsizei n, const GLuint* arrays))
+
+// Compute shaders, storage buffers and fences (OpenGL 4.3), resolved by loadCompute()
+#define OKPP_GL_COMPUTE_FUNCTIONS(X) \
+	X(void, DispatchCompute, (GLuint groupsX, GLuint groupsY, GLuint groupsZ)) \
+	X(void, BindBufferBase, (GLenum target, GLuint index, GLuint buffer)) \
+	X(void, MemoryBarrier, (GLbitfield barriers)) \
+	X(void*, MapBufferRange, (GLenum target, IntPtr offset, SizeiPtr length, GLbitfield access)) \
+	X(Sync, FenceSync, (GLenum condition, GLbitfield flags)) \
+	X(GLenum, ClientWaitSync, (Sync sync, GLbitfield flags, std::uint64_t timeout)) \
+	X(void, DeleteSync, (Sync sync)) \
+	X(void, Uniform1ui, (GLint location, GLuint v0)) \
+	X(void, Uniform2f, (GLint location, GLfloat v0, GLfloat v1)) \
+	X(void, Uniform2i, (GLint location, GLint v0, GLint v1)) \
+	X(void, Uniform4f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3))
+
+// Immutable, persistently mapped buffers and indirect draws (OpenGL 4.4), resolved by loadStorage()
+#define OKPP_GL_STORAGE_FUNCTIONS(X) \
+	X(void, BufferStorage, (GLenum target, SizeiPtr size, const void* data, GLbitfield flags)) \
+	X(void, MultiDrawArraysIndirect, (GLenum mode, const void* indirect, GLsizei drawCount, GLsizei stride)) \
+	X(void, DrawArraysInstancedBaseInstance, (GLenum mode, GLint first, GLsizei count, GLsizei instanceCount, GLuint baseInstance))
+
+// Timer queries (OpenGL 3.3), resolved by loadTimer()
+#define OKPP_GL_TIMER_FUNCTIONS(X) \
+	X(void, GenQueries, (GLsizei n, GLuint* ids)) \
+	X(void, DeleteQueries, (GLsizei n, const GLuint* ids)) \
+	X(void, BeginQuery, (GLenum target, GLuint id)) \
+	X(void, EndQuery, (GLenum target)) \
+	X(void, GetQueryObjectiv, (GLuint id, GLenum pname, GLint* params)) \
+	X(void, GetQueryObjectui64v, (GLuint id, GLenum pname, std::uint64_t* params))
+
+	// One record of an indirect draw buffer, as the driver reads it
+	struct DrawArraysCommand {
+		GLuint count = 0U;
+		GLuint instanceCount = 0U;
+		GLuint first = 0U;
+		GLuint baseInstance = 0U;
+	};
+
+	struct Api {
+#define OKPP_GL_DECLARE(ret, name, params) ret (APIENTRY* name) params = nullptr;
+		OKPP_GL_FUNCTIONS(OKPP_GL_DECLARE)
+		OKPP_GL_COMPUTE_FUNCTIONS(OKPP_GL_DECLARE)
+		OKPP_GL_STORAGE_FUNCTIONS(OKPP_GL_DECLARE)
+		OKPP_GL_TIMER_FUNCTIONS(OKPP_GL_DECLARE)
+#undef OKPP_GL_DECLARE
+	};
+
+	/**
+	 * @brief Resolves every entry point through the given loader.
+	 *
+	 * Requires a current GL context. Returns false (and logs the first missing
+	 * name) if any function is unavailable; the table is then left unusable.
+	 */
+	[[nodiscard]] bool load(ProcLoader loader);
+
+	/**
+	 * @brief True once load() has succeeded.
+	 */
+	[[nodiscard]] bool loaded() noexcept;
+
+	/**
+	 * @brief Resolves the compute entry points; load() must have succeeded.
+	 *
+	 * Returns false (and logs the first missing name) on drivers below
+	 * OpenGL 4.3; the core table stays usable either way.
+	 */
+	[[nodiscard]] bool loadCompute(ProcLoader loader);
+
+	/**
+	 * @brief True once loadCompute() has succeeded.
+	 */
+	[[nodiscard]] bool computeLoaded() noexcept;
+
+	/**
+	 * @brief Resolves the persistent-buffer entry points, and the compute
+	 *        table for its fences; load() must have succeeded.
+	 *
+	 * Returns false (and logs the first missing name) below OpenGL 4.4.
+	 */
+	[[nodiscard]] bool loadStorage(ProcLoader loader);
+
+	/**
+	 * @brief True once loadStorage() has succeeded.
+	 */
+	[[nodiscard]] bool storageLoaded() noexcept;
+
+	/**
+	 * @brief Resolves the timer-query entry points; load() must have succeeded.
+	 *
+	 * Returns false (and logs the first missing name) below OpenGL 3.3.
+	 */
+	[[nodiscard]] bool loadTimer(ProcLoader loader);
+
+	/**
+	 * @brief True once loadTimer() has succeeded.
+	 */
+	[[nodiscard]] bool timerLoaded() noexcept;
+
+	/**
+	 * @brief The process-wide function table filled by the load functions.
+	 */
+	[[nodiscard]] const Api& api() noexcept;
+
+	/**
+	 * @brief Compiles and links a vertex/fragment program.
+	 *
+	 * Attribute names are bound to locations 0..attributeCount-1 before linking.
+	 * Returns 0 and logs the driver message on failure.
+	 */
+	[[nodiscard]] GLuint buildProgram(const char* vertexSource, const char* fragmentSource,
+		const char* const* attributeNames, std::size_t attributeCount);
+
+	/**
+	 * @brief Compiles and links a compute program.
+	 *
+	 * Returns 0 and logs the driver message on failure, or if loadCompute()
+	 * has not succeeded.
+	 */
+	[[nodiscard]] GLuint buildComputeProgram(const char* computeSource);
+
+} // namespace gl
@@ -0,0 +1,219 @@
+#include "GoldenImage.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "AssetPack.hpp"
+#include "SimdIntrinsics.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr char GOLDEN_MAGIC[8] = { 'O', 'K', 'G', 'L', 'D', '0', '0', '1' };
+
+		struct GoldenHeader {
+			char magic[8];
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint32_t storedBytes;
+		};
+
+		static_assert(sizeof(GoldenHeader) == 20U, "the header is written raw and must have no padding");
+
+		// Larger than any screenshot; a corrupt header cannot ask for more
+		constexpr std::uint64_t MAX_GOLDEN_BYTES = std::uint64_t{ 1 } << 28U;
+
+		// Set bits of a 4-bit lane mask
+		constexpr std::uint8_t NIBBLE_BITS[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+		[[nodiscard]] std::uint8_t pixelDelta(const std::uint8_t* a, const std::uint8_t* b) noexcept {
+			std::uint8_t delta = 0U;
+			for (std::size_t channel = 0U; channel < 4U; ++channel) {
+				const int d = static_cast<int>(a[channel]) - static_cast<int>(b[channel]);
+				delta = std::max(delta, static_cast<std::uint8_t>((d < 0) ? -d : d));
+			}
+			return delta;
+		}
+
+		// Pixels [first, count) one at a time: the tail of every SIMD kernel and the scalar level
+		void diffPixelsScalar(const std::uint8_t* a, const std::uint8_t* b, std::size_t first, std::size_t count,
+			std::uint8_t tolerance, ImageDiff& diff) noexcept
+		{
+			for (std::size_t i = first; i < count; ++i) {
+				const std::uint8_t delta = pixelDelta(a + 4U * i, b + 4U * i);
+				diff.maxDelta = std::max(diff.maxDelta, delta);
+				diff.differing += (delta > tolerance) ? 1U : 0U;
+			}
+		}
+
+		// Each kernel handles whole vectors of pixels and returns how many it did
+#if defined(OKPP_SIMD_X86)
+		OKPP_TARGET_SSE2 std::size_t diffPixelsSse2(const std::uint8_t* a, const std::uint8_t* b, std::size_t count,
+			std::uint8_t tolerance, ImageDiff& diff) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i limit = _mm_set1_epi8(static_cast<char>(tolerance));
+			__m128i maxDelta = zero;
+			std::uint64_t differing = 0U;
+			std::size_t i = 0U;
+			for (; i + 4U <= count; i += 4U) {
+				const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 4U * i));
+				const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 4U * i));
+				const __m128i delta = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+				maxDelta = _mm_max_epu8(maxDelta, delta);
+				// A pixel is within tolerance when all four of its channels are
+				const __m128i within = _mm_cmpeq_epi32(_mm_subs_epu8(delta, limit), zero);
+				differing += 4U - NIBBLE_BITS[_mm_movemask_ps(_mm_castsi128_ps(within))];
+			}
+
+			alignas(16) std::uint8_t lanes[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), maxDelta);
+			diff.maxDelta = std::max(diff.maxDelta, *std::max_element(lanes, lanes + 16));
+			diff.differing += differing;
+			return i;
+		}
+
+		OKPP_TARGET_AVX2 std::size_t diffPixelsAvx2(const std::uint8_t* a, const std::uint8_t* b, std::size_t count,
+			std::uint8_t tolerance, ImageDiff& diff) noexcept
+		{
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i limit = _mm256_set1_epi8(static_cast<char>(tolerance));
+			__m256i maxDelta = zero;
+			std::uint64_t differing = 0U;
+			std::size_t i = 0U;
+			for (; i + 8U <= count; i += 8U) {
+				const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 4U * i));
+				const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 4U * i));
+				const __m256i delta = _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va));
+				maxDelta = _mm256_max_epu8(maxDelta, delta);
+				const __m256i within = _mm256_cmpeq_epi32(_mm256_subs_epu8(delta, limit), zero);
+				const auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(within)));
+				differing += 8U - NIBBLE_BITS[mask & 0xFU] - NIBBLE_BITS[mask >> 4U];
+			}
+
+			alignas(32) std::uint8_t lanes[32];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), maxDelta);
+			diff.maxDelta = std::max(diff.maxDelta, *std::max_element(lanes, lanes + 32));
+			diff.differing += differing;
+			return i;
+		}
+#elif defined(OKPP_SIMD_NEON)
+		std::size_t diffPixelsNeon(const std::uint8_t* a, const std::uint8_t* b, std::size_t count,
+			std::uint8_t tolerance, ImageDiff& diff) noexcept
+		{
+			const uint8x16_t limit = vdupq_n_u8(tolerance);
+			uint8x16_t maxDelta = vdupq_n_u8(0U);
+			uint32x4_t differing = vdupq_n_u32(0U);
+			std::size_t i = 0U;
+			for (; i + 4U <= count; i += 4U) {
+				const uint8x16_t delta = vabdq_u8(vld1q_u8(a + 4U * i), vld1q_u8(b + 4U * i));
+				maxDelta = vmaxq_u8(maxDelta, delta);
+				const uint32x4_t over = vreinterpretq_u32_u8(vqsubq_u8(delta, limit));
+				differing = vaddq_u32(differing, vshrq_n_u32(vtstq_u32(over, over), 31));
+			}
+
+			std::uint8_t lanes[16];
+			vst1q_u8(lanes, maxDelta);
+			diff.maxDelta = std::max(diff.maxDelta, *std::max_element(lanes, lanes + 16));
+			diff.differing += static_cast<std::uint64_t>(vgetq_lane_u32(differing, 0)) + vgetq_lane_u32(differing, 1)
+				+ vgetq_lane_u32(differing, 2) + vgetq_lane_u32(differing, 3);
+			return i;
+		}
+#endif
+	}
+
+	bool saveGoldenImage(const std::string& path, const SoftImage& image) {
+		const std::vector<unsigned char> block = assets::lz4Compress(image.pixels.data(), image.pixels.size());
+		GoldenHeader header{};
+		std::memcpy(header.magic, GOLDEN_MAGIC, sizeof(header.magic));
+		header.width = image.width;
+		header.height = image.height;
+		header.storedBytes = static_cast<std::uint32_t>(block.size());
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+		if (!file) {
+			std::cerr << "Error: Failed to write golden image " << path << '\n';
+			return false;
+		}
+		return true;
+	}
+
+	bool loadGoldenImage(const std::string& path, SoftImage& image) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		GoldenHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		const std::uint64_t bytes = static_cast<std::uint64_t>(header.width) * header.height * 4U;
+		if (!file || std::memcmp(header.magic, GOLDEN_MAGIC, sizeof(header.magic)) != 0 || bytes > MAX_GOLDEN_BYTES) {
+			std::cerr << "Error: " << path << " is not a golden image\n";
+			return false;
+		}
+
+		std::vector<unsigned char> block(header.storedBytes);
+		file.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size()));
+		image.width = header.width;
+		image.height = header.height;
+		image.pixels.resize(static_cast<std::size_t>(bytes));
+		if (!file || !assets::lz4Decompress(block.data(), block.size(), image.pixels.data(), image.pixels.size())) {
+			std::cerr << "Error: golden image " << path << " is corrupt\n";
+			return false;
+		}
+		return true;
+	}
+
+	ImageDiff diffImages(const SoftImage& actual, const SoftImage& golden, std::uint8_t tolerance) noexcept {
+		ImageDiff diff;
+		if (actual.width != golden.width || actual.height != golden.height || actual.pixels.size() != golden.pixels.size()) {
+			diff.sizeMismatch = true;
+			return diff;
+		}
+
+		const std::uint8_t* a = actual.pixels.data();
+		const std::uint8_t* b = golden.pixels.data();
+		const std::size_t count = actual.pixels.size() / 4U;
+		std::size_t done = 0U;
+		switch (sim::simdLevel()) {
+#if defined(OKPP_SIMD_X86)
+		case sim::SimdLevel::Avx512: // every AVX-512 CPU has AVX2; a byte diff gains nothing wider
+		case sim::SimdLevel::Avx2: done = diffPixelsAvx2(a, b, count, tolerance, diff); break;
+		case sim::SimdLevel::Sse2: done = diffPixelsSse2(a, b, count, tolerance, diff); break;
+#elif defined(OKPP_SIMD_NEON)
+		case sim::SimdLevel::Neon: done = diffPixelsNeon(a, b, count, tolerance, diff); break;
+#endif
+		default: break;
+		}
+		diffPixelsScalar(a, b, done, count, tolerance, diff);
+		diff.pixels = count;
+		return diff;
+	}
+
+	void writeDiffMask(const SoftImage& actual, const SoftImage& golden, std::uint8_t tolerance, SoftImage& mask) {
+		mask.width = golden.width;
+		mask.height = golden.height;
+		mask.pixels.resize(golden.pixels.size());
+		const std::size_t count = std::min(actual.pixels.size(), golden.pixels.size()) / 4U;
+		for (std::size_t i = 0U; i < count; ++i) {
+			const std::uint8_t* g = golden.pixels.data() + 4U * i;
+			std::uint8_t* out = mask.pixels.data() + 4U * i;
+			if (pixelDelta(actual.pixels.data() + 4U * i, g) > tolerance) {
+				out[0] = 255U;
+				out[1] = 0U;
+				out[2] = 0U;
+			}
+			else {
+				out[0] = static_cast<std::uint8_t>(g[0] / 3U);
+				out[1] = static_cast<std::uint8_t>(g[1] / 3U);
+				out[2] = static_cast<std::uint8_t>(g[2] / 3U);
+			}
+			out[3] = 255U;
+		}
+	}
+
+} // namespace gfx
@@ -0,0 +1,62 @@
+/*
+==============================================================================
+Golden Image - stored reference frames and a SIMD image diff against them
+==============================================================================
+ - Headless checkpoint frames (SoftRasterizer) are compared against golden
+   images of an earlier, accepted run; the rasterizer is bit-identical
+   across runs and machines, so any differing pixel is a rendering change
+ - Golden files keep the raw RGBA8 pixels as one LZ4 block (the AssetPack
+   codec): loading one is a single read and a decode, with no image
+   library and no PNG inflate on the comparison path
+ - diffImages() counts the pixels whose largest channel difference exceeds
+   the tolerance and the largest difference seen, 4 (SSE2, NEON) or 8
+   (AVX2) pixels per step at the dispatched SIMD level (CpuFeatures); every
+   level counts the same pixels
+ - writeDiffMask() paints the differing pixels for a human, only for the
+   frames that failed
+ - File format (little-endian): "OKGLD001" | width u32 | height u32 |
+   stored bytes u32 | LZ4 block of width * height * 4 bytes
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "SoftRasterizer.hpp"
+
+namespace gfx {
+
+	struct ImageDiff {
+		std::uint64_t pixels = 0U;    // compared
+		std::uint64_t differing = 0U; // some channel differs by more than the tolerance
+		std::uint8_t maxDelta = 0U;   // largest channel difference anywhere
+		bool sizeMismatch = false;    // nothing compared
+
+		[[nodiscard]] bool matches() const noexcept { return !sizeMismatch && differing == 0U; }
+	};
+
+	/**
+	 * @brief Writes image as a golden file; false (logged) if it cannot be written.
+	 */
+	[[nodiscard]] bool saveGoldenImage(const std::string& path, const SoftImage& image);
+
+	/**
+	 * @brief Reads a golden file written by saveGoldenImage(); false if it is missing, logged if it is corrupt.
+	 */
+	[[nodiscard]] bool loadGoldenImage(const std::string& path, SoftImage& image);
+
+	/**
+	 * @brief Compares actual against golden channel by channel.
+	 */
+	[[nodiscard]] ImageDiff diffImages(const SoftImage& actual, const SoftImage& golden, std::uint8_t tolerance) noexcept;
+
+	/**
+	 * @brief diffImages() as a picture: differing pixels in red over a dimmed copy of golden.
+	 *
+	 * MISRA: the images must have the same size.
+	 */
+	void writeDiffMask(const SoftImage& actual, const SoftImage& golden, std::uint8_t tolerance, SoftImage& mask);
+
+} // namespace gfx
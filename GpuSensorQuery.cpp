@@ -0,0 +1,391 @@
+#include "GpuSensorQuery.hpp"
+
+#include <SFML/Window/Context.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr GLuint WORKGROUP_SIZE = 64U; // matches local_size_x below
+
+		// Binding points shared with the shader
+		constexpr GLuint OBSTACLE_BINDING = 0U;
+		constexpr GLuint CELL_START_BINDING = 1U;
+		constexpr GLuint CELL_ENTRY_BINDING = 2U;
+		constexpr GLuint SENSOR_BINDING = 3U;
+		constexpr GLuint READING_BINDING = 4U;
+
+		// Same cap as the CPU grid, so sparse lots do not upload mostly empty cells
+		constexpr std::size_t GPU_CELLS_PER_OBSTACLE = 4U;
+
+		// The sensor rectangle's long axis, relative to its rotation
+		constexpr float GPU_FACING_OFFSET_DEG = 90.0F;
+
+		// GL refuses zero-sized storage blocks; empty sets upload this much
+		constexpr gl::SizeiPtr MIN_BUFFER_BYTES = 16;
+
+		constexpr std::uint64_t WAIT_TIMEOUT_NS = 1000000000U;
+
+		// One std430 Reading is uint, float, float: the SensorReading layout
+		static_assert(sizeof(sim::SensorReading) == 12U, "SensorReading is copied straight from the read-back buffer");
+
+		constexpr const char* QUERY_SHADER = R"(
+#version 430
+layout(local_size_x = 64) in;
+
+struct Reading {
+	uint obstacle;
+	float distanceSq;
+	float wallDistance;
+};
+
+layout(std430, binding = 0) readonly buffer Obstacles { vec4 b_obstacles[]; };
+layout(std430, binding = 1) readonly buffer CellStart { uint b_cellStart[]; };
+layout(std430, binding = 2) readonly buffer CellEntries { uint b_cellEntries[]; };
+layout(std430, binding = 3) readonly buffer Sensors { vec4 b_sensors[]; };
+layout(std430, binding = 4) writeonly buffer Readings { Reading b_readings[]; };
+
+uniform uint u_sensorCount;
+uniform vec2 u_gridOrigin;
+uniform ivec2 u_gridSize;
+uniform float u_cellSize;
+uniform float u_maxRange;
+uniform vec4 u_walls;     // left, top, width, height
+uniform uint u_rays;      // 0: nearest center
+uniform float u_halfAngle; // degrees
+uniform float u_maxRadius; // widest obstacle, binned by its center
+
+const uint NO_OBSTACLE = 0xFFFFFFFFu;
+const float FAR = 3.402823466e38;
+
+float hitCircle(vec4 circle, vec2 origin, vec2 direction) {
+	vec2 m = origin - circle.xy;
+	float b = dot(m, direction);
+	float c = dot(m, m) - circle.z * circle.z;
+	if (c > 0.0 && b > 0.0) {
+		return FAR;
+	}
+	float discriminant = b * b - c;
+	if (discriminant < 0.0) {
+		return FAR;
+	}
+	return max(-b - sqrt(discriminant), 0.0);
+}
+
+void main() {
+	uint sensor = gl_GlobalInvocationID.x;
+	if (sensor >= u_sensorCount) {
+		return;
+	}
+	vec2 origin = b_sensors[sensor].xy;
+	float facing = radians(b_sensors[sensor].z);
+
+	// A ray can hit a circle filed up to its radius outside the range
+	float reach = u_maxRange + ((u_rays > 0u) ? u_maxRadius : 0.0);
+	vec2 limit = vec2(u_gridSize);
+	ivec2 lo = max(ivec2(clamp(floor((origin - reach - u_gridOrigin) / u_cellSize), vec2(-1.0), limit)), ivec2(0));
+	ivec2 hi = min(ivec2(clamp(floor((origin + reach - u_gridOrigin) / u_cellSize), vec2(-1.0), limit)), u_gridSize - 1);
+
+	uint best = NO_OBSTACLE;
+	float bestValue = (u_rays > 0u) ? u_maxRange : u_maxRange * u_maxRange;
+	uint rays = max(u_rays, 1u);
+	float halfAngle = radians(u_halfAngle);
+	float first = (rays > 1u) ? facing - halfAngle : facing;
+	float stepAngle = (rays > 1u) ? (2.0 * halfAngle) / float(rays - 1u) : 0.0;
+
+	for (int cy = lo.y; cy <= hi.y; ++cy) {
+		for (int cx = lo.x; cx <= hi.x; ++cx) {
+			uint cell = uint(cy * u_gridSize.x + cx);
+			for (uint e = b_cellStart[cell]; e < b_cellStart[cell + 1u]; ++e) {
+				uint index = b_cellEntries[e];
+				vec4 circle = b_obstacles[index];
+				if (u_rays == 0u) {
+					vec2 d = circle.xy - origin;
+					float distanceSq = dot(d, d);
+					if (distanceSq < bestValue) {
+						bestValue = distanceSq;
+						best = index;
+					}
+					continue;
+				}
+				for (uint r = 0u; r < rays; ++r) {
+					float angle = first + float(r) * stepAngle;
+					float t = hitCircle(circle, origin, vec2(cos(angle), sin(angle)));
+					if (t < bestValue) {
+						bestValue = t;
+						best = index;
+					}
+				}
+			}
+		}
+	}
+
+	Reading reading;
+	reading.obstacle = best;
+	if (best == NO_OBSTACLE) {
+		reading.distanceSq = FAR;
+	}
+	else {
+		reading.distanceSq = (u_rays > 0u) ? bestValue * bestValue : bestValue;
+	}
+	vec2 corner = u_walls.xy + u_walls.zw;
+	float wall = min(min(origin.x - u_walls.x, origin.y - u_walls.y), min(corner.x - origin.x, corner.y - origin.y));
+	reading.wallDistance = max(wall, 0.0);
+	b_readings[sensor] = reading;
+}
+)";
+
+		[[nodiscard]] gl::ProcAddress computeLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+
+		void uploadStorage(GLuint buffer, const void* data, std::size_t bytes, GLenum usage) {
+			const gl::Api& api = gl::api();
+			api.BindBuffer(gl::SHADER_STORAGE_BUFFER, buffer);
+			api.BufferData(gl::SHADER_STORAGE_BUFFER, std::max(static_cast<gl::SizeiPtr>(bytes), MIN_BUFFER_BYTES),
+				nullptr, usage);
+			if (bytes > 0U) {
+				api.BufferSubData(gl::SHADER_STORAGE_BUFFER, 0, static_cast<gl::SizeiPtr>(bytes), data);
+			}
+		}
+	}
+
+	GpuSensorQuery::~GpuSensorQuery() {
+		if (!gl::computeLoaded()) {
+			return;
+		}
+		const gl::Api& api = gl::api();
+		for (Slot& slot : m_slots) {
+			release(slot);
+			if (slot.readings != 0U) { api.DeleteBuffers(1, &slot.readings); }
+		}
+		const GLuint buffers[] = { m_obstacleBuffer, m_cellStartBuffer, m_cellEntryBuffer, m_sensorBuffer };
+		for (const GLuint buffer : buffers) {
+			if (buffer != 0U) { api.DeleteBuffers(1, &buffer); }
+		}
+		if (m_program != 0U) { api.DeleteProgram(m_program); }
+	}
+
+	bool GpuSensorQuery::create() {
+		if (!gl::loaded() && !gl::load(&computeLoader)) {
+			return false;
+		}
+		if (!gl::computeLoaded() && !gl::loadCompute(&computeLoader)) {
+			return false;
+		}
+
+		m_program = gl::buildComputeProgram(QUERY_SHADER);
+		if (m_program == 0U) {
+			return false;
+		}
+
+		const gl::Api& api = gl::api();
+		m_uniforms.sensorCount = api.GetUniformLocation(m_program, "u_sensorCount");
+		m_uniforms.gridOrigin = api.GetUniformLocation(m_program, "u_gridOrigin");
+		m_uniforms.gridSize = api.GetUniformLocation(m_program, "u_gridSize");
+		m_uniforms.cellSize = api.GetUniformLocation(m_program, "u_cellSize");
+		m_uniforms.maxRange = api.GetUniformLocation(m_program, "u_maxRange");
+		m_uniforms.walls = api.GetUniformLocation(m_program, "u_walls");
+		m_uniforms.rays = api.GetUniformLocation(m_program, "u_rays");
+		m_uniforms.halfAngle = api.GetUniformLocation(m_program, "u_halfAngle");
+		m_uniforms.maxRadius = api.GetUniformLocation(m_program, "u_maxRadius");
+
+		GLuint buffers[4] = {};
+		api.GenBuffers(4, buffers);
+		m_obstacleBuffer = buffers[0];
+		m_cellStartBuffer = buffers[1];
+		m_cellEntryBuffer = buffers[2];
+		m_sensorBuffer = buffers[3];
+		for (Slot& slot : m_slots) {
+			api.GenBuffers(1, &slot.readings);
+		}
+
+		setObstacles({}, 1.0F);
+		return true;
+	}
+
+	void GpuSensorQuery::setObstacles(const std::vector<sim::Obstacle>& obstacles, float cellSize) {
+		if (m_program == 0U) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("gpu sensor obstacles");
+
+		m_cols = 0;
+		m_rows = 0;
+		m_maxRadius = 0.0F;
+		std::vector<std::uint32_t> cellStart(1U, 0U);
+		std::vector<std::uint32_t> entries;
+		m_upload.clear();
+
+		if (!obstacles.empty()) {
+			sf::Vector2f minP = obstacles.front().center;
+			sf::Vector2f maxP = minP;
+			for (const auto& obstacle : obstacles) {
+				minP.x = std::min(minP.x, obstacle.center.x);
+				minP.y = std::min(minP.y, obstacle.center.y);
+				maxP.x = std::max(maxP.x, obstacle.center.x);
+				maxP.y = std::max(maxP.y, obstacle.center.y);
+				m_maxRadius = std::max(m_maxRadius, obstacle.radius);
+			}
+
+			const float extent = std::max({ maxP.x - minP.x, maxP.y - minP.y, 1.0F });
+			m_cellSize = (cellSize > 0.0F) ? cellSize : extent;
+			const std::size_t maxCells = obstacles.size() * GPU_CELLS_PER_OBSTACLE;
+			for (;;) {
+				m_cols = static_cast<int>((maxP.x - minP.x) / m_cellSize) + 1;
+				m_rows = static_cast<int>((maxP.y - minP.y) / m_cellSize) + 1;
+				if (static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows) <= maxCells) {
+					break;
+				}
+				m_cellSize *= 2.0F;
+			}
+			m_gridOrigin = minP;
+
+			// Counting sort of the centers into their cells
+			const std::size_t cellCount = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+			std::vector<std::uint32_t> cellOf(obstacles.size());
+			cellStart.assign(cellCount + 1U, 0U);
+			for (std::size_t i = 0U; i < obstacles.size(); ++i) {
+				const sf::Vector2f offset = obstacles[i].center - m_gridOrigin;
+				const int cx = std::min(static_cast<int>(offset.x / m_cellSize), m_cols - 1);
+				const int cy = std::min(static_cast<int>(offset.y / m_cellSize), m_rows - 1);
+				cellOf[i] = static_cast<std::uint32_t>(cy * m_cols + cx);
+				++cellStart[cellOf[i] + 1U];
+			}
+			for (std::size_t c = 0U; c < cellCount; ++c) {
+				cellStart[c + 1U] += cellStart[c];
+			}
+			entries.resize(obstacles.size());
+			std::vector<std::uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+			for (std::size_t i = 0U; i < obstacles.size(); ++i) {
+				entries[fill[cellOf[i]]++] = static_cast<std::uint32_t>(i);
+			}
+
+			m_upload.reserve(obstacles.size() * 4U);
+			for (const auto& obstacle : obstacles) {
+				m_upload.insert(m_upload.end(), { obstacle.center.x, obstacle.center.y, obstacle.radius, 0.0F });
+			}
+		}
+
+		uploadStorage(m_obstacleBuffer, m_upload.data(), m_upload.size() * sizeof(float), gl::STATIC_DRAW);
+		uploadStorage(m_cellStartBuffer, cellStart.data(), cellStart.size() * sizeof(std::uint32_t), gl::STATIC_DRAW);
+		uploadStorage(m_cellEntryBuffer, entries.data(), entries.size() * sizeof(std::uint32_t), gl::STATIC_DRAW);
+		gl::api().BindBuffer(gl::SHADER_STORAGE_BUFFER, 0U);
+	}
+
+	void GpuSensorQuery::submit(const std::vector<sim::SensorPose>& sensors, const GpuSensorPass& pass) {
+		if (m_program == 0U) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("gpu sensor submit");
+		const gl::Api& api = gl::api();
+
+		// Both buffers busy: the older pass is never collected
+		Slot& slot = m_slots[m_nextSlot];
+		release(slot);
+
+		m_upload.clear();
+		m_upload.reserve(sensors.size() * 4U);
+		for (const auto& sensor : sensors) {
+			m_upload.insert(m_upload.end(),
+				{ sensor.position.x, sensor.position.y, sensor.rotationDeg + GPU_FACING_OFFSET_DEG, 0.0F });
+		}
+		uploadStorage(m_sensorBuffer, m_upload.data(), m_upload.size() * sizeof(float), gl::STREAM_DRAW);
+
+		if (slot.capacity < sensors.size() || slot.capacity == 0U) {
+			slot.capacity = std::max<std::size_t>(sensors.size(), 1U);
+			api.BindBuffer(gl::SHADER_STORAGE_BUFFER, slot.readings);
+			api.BufferData(gl::SHADER_STORAGE_BUFFER,
+				static_cast<gl::SizeiPtr>(slot.capacity * sizeof(sim::SensorReading)), nullptr, gl::DYNAMIC_READ);
+		}
+		api.BindBuffer(gl::SHADER_STORAGE_BUFFER, 0U);
+
+		api.BindBufferBase(gl::SHADER_STORAGE_BUFFER, OBSTACLE_BINDING, m_obstacleBuffer);
+		api.BindBufferBase(gl::SHADER_STORAGE_BUFFER, CELL_START_BINDING, m_cellStartBuffer);
+		api.BindBufferBase(gl::SHADER_STORAGE_BUFFER, CELL_ENTRY_BINDING, m_cellEntryBuffer);
+		api.BindBufferBase(gl::SHADER_STORAGE_BUFFER, SENSOR_BINDING, m_sensorBuffer);
+		api.BindBufferBase(gl::SHADER_STORAGE_BUFFER, READING_BINDING, slot.readings);
+
+		api.UseProgram(m_program);
+		api.Uniform1ui(m_uniforms.sensorCount, static_cast<GLuint>(sensors.size()));
+		api.Uniform2f(m_uniforms.gridOrigin, m_gridOrigin.x, m_gridOrigin.y);
+		api.Uniform2i(m_uniforms.gridSize, m_cols, m_rows);
+		api.Uniform1f(m_uniforms.cellSize, m_cellSize);
+		api.Uniform1f(m_uniforms.maxRange, pass.maxRange);
+		api.Uniform4f(m_uniforms.walls, pass.walls.position.x, pass.walls.position.y, pass.walls.size.x, pass.walls.size.y);
+		api.Uniform1ui(m_uniforms.rays, pass.rays);
+		api.Uniform1f(m_uniforms.halfAngle, pass.coneHalfAngleDeg);
+		api.Uniform1f(m_uniforms.maxRadius, m_maxRadius);
+
+		const auto groups = static_cast<GLuint>((sensors.size() + WORKGROUP_SIZE - 1U) / WORKGROUP_SIZE);
+		if (groups > 0U) {
+			api.DispatchCompute(groups, 1U, 1U);
+		}
+		api.UseProgram(0U);
+
+		// Shader writes must land before the buffer is mapped
+		api.MemoryBarrier(gl::BUFFER_UPDATE_BARRIER_BIT);
+		slot.fence = api.FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0U);
+		slot.count = sensors.size();
+		slot.pass = m_passes++;
+		m_nextSlot = (m_nextSlot + 1U) % m_slots.size();
+	}
+
+	bool GpuSensorQuery::collect(std::vector<sim::SensorReading>& readings, bool wait) {
+		Slot* oldest = nullptr;
+		for (Slot& slot : m_slots) {
+			if (slot.fence != nullptr && (oldest == nullptr || slot.pass < oldest->pass)) {
+				oldest = &slot;
+			}
+		}
+		if (oldest == nullptr) {
+			return false;
+		}
+
+		const gl::Api& api = gl::api();
+		const GLenum status = api.ClientWaitSync(oldest->fence, gl::SYNC_FLUSH_COMMANDS_BIT, wait ? WAIT_TIMEOUT_NS : 0U);
+		if (status == gl::TIMEOUT_EXPIRED) {
+			return false;
+		}
+		if (status == gl::WAIT_FAILED) {
+			OKPP_LOG_WARNING("Warning: GPU sensor pass failed, it is dropped");
+			release(*oldest);
+			return false;
+		}
+
+		OKPP_TRACE_SCOPE("gpu sensor collect");
+		bool copied = false;
+		const std::size_t bytes = oldest->count * sizeof(sim::SensorReading);
+		api.BindBuffer(gl::SHADER_STORAGE_BUFFER, oldest->readings);
+		const void* mapped = (bytes > 0U)
+			? api.MapBufferRange(gl::SHADER_STORAGE_BUFFER, 0, static_cast<gl::SizeiPtr>(bytes), gl::MAP_READ_BIT)
+			: nullptr;
+		if (mapped != nullptr) {
+			readings.resize(oldest->count);
+			std::memcpy(readings.data(), mapped, bytes);
+			(void)api.UnmapBuffer(gl::SHADER_STORAGE_BUFFER);
+			copied = true;
+		}
+		else if (bytes == 0U) {
+			readings.clear();
+			copied = true;
+		}
+		api.BindBuffer(gl::SHADER_STORAGE_BUFFER, 0U);
+		release(*oldest);
+		return copied;
+	}
+
+	void GpuSensorQuery::release(Slot& slot) {
+		if (slot.fence != nullptr) {
+			gl::api().DeleteSync(slot.fence);
+			slot.fence = nullptr;
+		}
+		slot.count = 0U;
+	}
+
+} // namespace gfx
@@ -0,0 +1,126 @@
+/*
+==============================================================================
+GPU Sensor Query - bulk nearest-obstacle and cone queries in a compute shader
+==============================================================================
+ - An alternative engine behind the same sensor pass as the obstacle grid
+   and the ray caster: sensor poses in, one SensorReading per sensor out
+ - Obstacles are binned by center into a uniform grid (CSR, like
+   ObstacleGrid) and uploaded once per obstacle set, as three SSBOs
+ - Each pass uploads the sensor poses and dispatches one invocation per
+   sensor; it either scans the cells around the sensor for the nearest
+   center, or casts the sensor's fan of rays against the circles nearby
+ - Results land in one of two read-back buffers behind a fence; collect()
+   polls the fence and maps the older buffer, so the CPU does not wait on
+   the GPU and readings arrive one pass after their poses were submitted
+ - Needs OpenGL 4.3 and the calling thread's context current
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlFunctions.hpp"
+#include "SimTypes.hpp"
+
+namespace gfx {
+
+	// One pass of queries; rays 0 asks for the nearest obstacle center
+	struct GpuSensorPass {
+		float maxRange = 0.0F;
+		sf::FloatRect walls;
+		float coneHalfAngleDeg = 0.0F;
+		std::uint32_t rays = 0U;
+	};
+
+	class GpuSensorQuery {
+	public:
+		GpuSensorQuery() = default;
+		~GpuSensorQuery();
+
+		GpuSensorQuery(const GpuSensorQuery&) = delete;
+		GpuSensorQuery& operator=(const GpuSensorQuery&) = delete;
+
+		/**
+		 * @brief Loads the compute entry points and builds the query program.
+		 *
+		 * Requires the window's context to be active. Returns false (and logs)
+		 * below OpenGL 4.3; callers keep the CPU sensor pass.
+		 */
+		[[nodiscard]] bool create();
+
+		/**
+		 * @brief Bins the obstacles into a grid of cellSize cells and uploads them.
+		 *
+		 * Passes already in flight still read the previous set.
+		 * MISRA: cellSize must be strictly positive; non-positive values fall
+		 *        back to a single cell covering all obstacles.
+		 */
+		void setObstacles(const std::vector<sim::Obstacle>& obstacles, float cellSize);
+
+		/**
+		 * @brief Queues one query per sensor; the results are read by a later collect().
+		 *
+		 * With both read-back buffers still in flight the oldest pass is dropped.
+		 */
+		void submit(const std::vector<sim::SensorPose>& sensors, const GpuSensorPass& pass);
+
+		/**
+		 * @brief Copies the oldest finished pass into readings (one per submitted sensor).
+		 *
+		 * Returns false, leaving readings alone, when no pass has finished yet;
+		 * with wait set it blocks until the oldest pass is done instead.
+		 */
+		[[nodiscard]] bool collect(std::vector<sim::SensorReading>& readings, bool wait = false);
+
+		[[nodiscard]] bool ready() const noexcept { return m_program != 0U; }
+
+	private:
+		// One read-back buffer and the fence guarding it
+		struct Slot {
+			GLuint readings = 0U;
+			std::size_t capacity = 0U; // sensors the buffer can hold
+			std::size_t count = 0U;    // sensors of the pass in flight
+			gl::Sync fence = nullptr;  // null when nothing is in flight
+			std::uint64_t pass = 0U;   // submit order, to collect the oldest first
+		};
+
+		void release(Slot& slot);
+
+		GLuint m_program = 0U;
+		GLuint m_obstacleBuffer = 0U;  // vec4 per obstacle: center, radius
+		GLuint m_cellStartBuffer = 0U; // cols * rows + 1 offsets into the entries
+		GLuint m_cellEntryBuffer = 0U; // obstacle indices, cell by cell
+		GLuint m_sensorBuffer = 0U;    // vec4 per sensor: position, facing
+
+		std::array<Slot, 2> m_slots{};
+		std::size_t m_nextSlot = 0U;
+		std::uint64_t m_passes = 0U;
+
+		sf::Vector2f m_gridOrigin{ 0.0F, 0.0F };
+		float m_cellSize = 1.0F;
+		int m_cols = 0;
+		int m_rows = 0;
+		float m_maxRadius = 0.0F;
+
+		std::vector<float> m_upload; // staging for obstacles and poses
+
+		struct Uniforms {
+			GLint sensorCount = -1;
+			GLint gridOrigin = -1;
+			GLint gridSize = -1;
+			GLint cellSize = -1;
+			GLint maxRange = -1;
+			GLint walls = -1;
+			GLint rays = -1;
+			GLint halfAngle = -1;
+			GLint maxRadius = -1;
+		} m_uniforms;
+	};
+
+} // namespace gfx
@@ -0,0 +1,161 @@
+#include "GpuTextures.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace gfx {
+
+	GpuTextures::~GpuTextures() {
+		for (Slot& slot : m_slots) {
+			finish(slot);
+		}
+		if (!gl::loaded()) {
+			return; // never drawn: no context, so no names were created
+		}
+		for (const Slot& slot : m_slots) {
+			if (slot.live && slot.name != 0U) {
+				glDeleteTextures(1, &slot.name);
+			}
+		}
+		for (const Retired& retired : m_retired) {
+			glDeleteTextures(1, &retired.name);
+		}
+	}
+
+	TextureHandle GpuTextures::request(TextureSource source) {
+		if (source.width <= 0 || source.height <= 0 || source.bytesPerPixel == 0U || source.pixels == nullptr) {
+			std::cerr << "Error: texture upload of " << source.width << "x" << source.height << " without pixels refused\n";
+			if (source.done) {
+				source.done();
+			}
+			return {};
+		}
+
+		std::uint32_t index = 0U;
+		if (!m_freeSlots.empty()) {
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else {
+			index = static_cast<std::uint32_t>(m_slots.size());
+			m_slots.emplace_back();
+		}
+		Slot& slot = m_slots[index];
+		slot.name = 0U;
+		slot.live = true;
+		slot.ready = false;
+		slot.uploadedRows = 0;
+		slot.source = std::move(source);
+		m_queue.push_back(index);
+		return { index, slot.generation };
+	}
+
+	bool GpuTextures::release(const TextureHandle& handle) {
+		Slot* const slot = find(handle);
+		if (slot == nullptr) {
+			return false;
+		}
+		const auto index = static_cast<std::uint32_t>(slot - m_slots.data());
+		if (!slot->ready) {
+			m_queue.erase(std::find(m_queue.begin(), m_queue.end(), index));
+			finish(*slot);
+		}
+		if (slot->name != 0U) {
+			m_retired.push_back({ slot->name, m_frame + RETIRE_FRAMES });
+		}
+		slot->name = 0U;
+		slot->live = false;
+		slot->ready = false;
+		++slot->generation;
+		m_freeSlots.push_back(index);
+		return true;
+	}
+
+	void GpuTextures::beginFrame(std::size_t uploadBudgetBytes) {
+		++m_frame;
+		while (!m_retired.empty() && m_retired.front().deleteAtFrame <= m_frame) {
+			glDeleteTextures(1, &m_retired.front().name);
+			m_retired.pop_front();
+			++m_deleted;
+		}
+
+		std::size_t spent = 0U;
+		while (!m_queue.empty()) {
+			Slot& slot = m_slots[m_queue.front()];
+			const TextureSource& source = slot.source;
+			const std::size_t rowBytes = static_cast<std::size_t>(source.width) * source.bytesPerPixel;
+			const std::size_t left = (uploadBudgetBytes > spent) ? uploadBudgetBytes - spent : 0U;
+			if (spent > 0U && left < rowBytes) {
+				break; // the next row waits for the next frame
+			}
+
+			if (slot.name == 0U) {
+				// Storage first, rows later: the texture is complete before any band lands
+				glGenTextures(1, &slot.name);
+				glBindTexture(GL_TEXTURE_2D, slot.name);
+				glTexImage2D(GL_TEXTURE_2D, 0, source.internalFormat, source.width, source.height, 0, source.format,
+					GL_UNSIGNED_BYTE, nullptr);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, source.filter);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, source.filter);
+			}
+			else {
+				glBindTexture(GL_TEXTURE_2D, slot.name);
+			}
+
+			const GLsizei rows = std::min(source.height - slot.uploadedRows,
+				static_cast<GLsizei>(std::max<std::size_t>(1U, left / rowBytes)));
+			const auto* const pixels = static_cast<const unsigned char*>(source.pixels)
+				+ static_cast<std::size_t>(slot.uploadedRows) * rowBytes;
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows are tightly packed
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, slot.uploadedRows, source.width, rows, source.format, GL_UNSIGNED_BYTE,
+				pixels);
+			slot.uploadedRows += rows;
+			spent += static_cast<std::size_t>(rows) * rowBytes;
+			m_uploadedBytes += static_cast<std::size_t>(rows) * rowBytes;
+
+			if (slot.uploadedRows < source.height) {
+				break; // budget used up mid-texture
+			}
+			slot.ready = true;
+			finish(slot);
+			m_queue.pop_front();
+		}
+	}
+
+	GLuint GpuTextures::texture(const TextureHandle& handle) const noexcept {
+		if (handle.slot >= m_slots.size()) {
+			return 0U;
+		}
+		const Slot& slot = m_slots[handle.slot];
+		return (slot.live && slot.ready && slot.generation == handle.generation) ? slot.name : 0U;
+	}
+
+	GpuTextureStats GpuTextures::stats() const noexcept {
+		GpuTextureStats stats;
+		stats.live = m_slots.size() - m_freeSlots.size();
+		stats.queued = m_queue.size();
+		stats.retiring = m_retired.size();
+		stats.uploadedBytes = m_uploadedBytes;
+		stats.deleted = m_deleted;
+		return stats;
+	}
+
+	GpuTextures::Slot* GpuTextures::find(const TextureHandle& handle) noexcept {
+		if (handle.slot >= m_slots.size()) {
+			return nullptr;
+		}
+		Slot& slot = m_slots[handle.slot];
+		return (slot.live && slot.generation == handle.generation) ? &slot : nullptr;
+	}
+
+	void GpuTextures::finish(Slot& slot) {
+		if (slot.source.done) {
+			const std::function<void()> done = std::move(slot.source.done);
+			slot.source.done = nullptr;
+			done();
+		}
+		slot.source.pixels = nullptr;
+	}
+
+} // namespace gfx
@@ -0,0 +1,129 @@
+/*
+==============================================================================
+GPU Textures - handle-based textures with streamed uploads and late deletion
+==============================================================================
+ - request() only queues a texture: nothing touches GL until the render
+   loop calls beginFrame(), so assets can be asked for before the context
+   exists and from load code that does not know about frames
+ - beginFrame() uploads queued texture rows up to a byte budget per frame
+   (at least one row, so any texture makes progress): a large image is
+   allocated once and filled in bands over several frames instead of
+   stalling one; texture() is 0 until the last band is in, which the quad
+   renderer draws untextured
+ - Handles are slot plus generation, as EntityPool's, so a handle kept
+   past its release() reads as 0 instead of naming a reused texture
+ - release() does not delete: the GL name is retired and deleted
+   RETIRE_FRAMES frames later, once no queued draw can still bind it.
+   The destructor deletes whatever is left, so no texture outlives the
+   manager in driver memory
+ - Source pixels are borrowed, not copied: each request carries a done
+   callback, run once its last row is uploaded or the request is dropped,
+   which frees them (unmaps the file, for the PPM loader)
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "EntityPool.hpp"
+#include "GlFunctions.hpp"
+
+namespace gfx {
+
+	using TextureHandle = sim::EntityHandle;
+
+	// Frames a released texture stays alive, for draws queued before the release
+	constexpr std::uint32_t RETIRE_FRAMES = 2U;
+
+	// Upload budget per frame: about a 512 x 512 RGBA image
+	constexpr std::size_t DEFAULT_UPLOAD_BUDGET_BYTES = 1024U * 1024U;
+
+	// A tightly packed image to upload; pixels must stay valid until done runs
+	struct TextureSource {
+		GLsizei width = 0;
+		GLsizei height = 0;
+		GLint internalFormat = GL_RGBA8;
+		GLenum format = GL_RGBA;      // of pixels, GL_UNSIGNED_BYTE per channel
+		std::size_t bytesPerPixel = 4U;
+		const void* pixels = nullptr;
+		GLint filter = GL_LINEAR;     // min and mag
+		std::function<void()> done;   // frees pixels; may be empty
+	};
+
+	struct GpuTextureStats {
+		std::size_t live = 0U;          // uploaded or uploading
+		std::size_t queued = 0U;        // requests not finished yet
+		std::size_t retiring = 0U;      // released, deletion pending
+		std::uint64_t uploadedBytes = 0U; // since construction
+		std::uint64_t deleted = 0U;       // GL names deleted since construction
+	};
+
+	class GpuTextures {
+	public:
+		GpuTextures() = default;
+		~GpuTextures();
+
+		GpuTextures(const GpuTextures&) = delete;
+		GpuTextures& operator=(const GpuTextures&) = delete;
+
+		/**
+		 * @brief Queues source for upload by the coming beginFrame() calls.
+		 *
+		 * MISRA: an empty image or null pixels are refused with an invalid
+		 *        handle (logged); done still runs.
+		 */
+		[[nodiscard]] TextureHandle request(TextureSource source);
+
+		/**
+		 * @brief Drops the texture; its GL name is deleted RETIRE_FRAMES frames later.
+		 *
+		 * An upload still queued is cancelled and its done callback runs.
+		 * False for a stale or invalid handle.
+		 */
+		bool release(const TextureHandle& handle);
+
+		/**
+		 * @brief Deletes the textures retired long enough, then uploads queued rows
+		 *        up to uploadBudgetBytes. Requires the current context.
+		 */
+		void beginFrame(std::size_t uploadBudgetBytes = DEFAULT_UPLOAD_BUDGET_BYTES);
+
+		/**
+		 * @brief GL name of a fully uploaded texture; 0 while uploading or for a stale handle.
+		 */
+		[[nodiscard]] GLuint texture(const TextureHandle& handle) const noexcept;
+
+		[[nodiscard]] GpuTextureStats stats() const noexcept;
+
+	private:
+		struct Slot {
+			GLuint name = 0U;       // created by the first upload
+			std::uint32_t generation = 0U;
+			bool live = false;
+			bool ready = false;
+			GLsizei uploadedRows = 0;
+			TextureSource source;   // pixels and done until ready
+		};
+		struct Retired {
+			GLuint name = 0U;
+			std::uint64_t deleteAtFrame = 0U;
+		};
+
+		[[nodiscard]] Slot* find(const TextureHandle& handle) noexcept;
+		void finish(Slot& slot); // runs done and forgets the pixels
+
+		std::vector<Slot> m_slots;
+		std::vector<std::uint32_t> m_freeSlots;
+		std::deque<std::uint32_t> m_queue; // slots to upload, oldest first
+		std::deque<Retired> m_retired;     // in release order, so by deleteAtFrame
+		std::uint64_t m_frame = 0U;
+		std::uint64_t m_uploadedBytes = 0U;
+		std::uint64_t m_deleted = 0U;
+	};
+
+} // namespace gfx
@@ -0,0 +1,107 @@
+#include "GuideLines.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "FastTrig.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr std::size_t VERTICES_PER_QUAD = 6U;
+
+		// Below this curvature (1 / px) the arc is drawn as a straight line: the
+		// closed form divides by it
+		constexpr float STRAIGHT_CURVATURE = 1.0e-5F;
+	}
+
+	GuideLines::GuideLines(const GuideLineStyle& style)
+		: m_style(style)
+	{
+		m_style.segments = std::max(m_style.segments, 1U);
+		m_vertices.resize((2U * m_style.segments + m_style.bars) * VERTICES_PER_QUAD);
+		m_left.resize(m_style.segments + 1U);
+		m_right.resize(m_style.segments + 1U);
+	}
+
+	void GuideLines::create() {
+		m_useBuffers = sf::VertexBuffer::isAvailable();
+		if (m_useBuffers && !m_buffer.create(m_vertices.size())) {
+			std::cerr << "Warning: guide line vertex buffer unavailable, drawing from client memory\n";
+			m_useBuffers = false;
+		}
+		m_bufferCharge.set(m_buffer.getVertexCount() * sizeof(sf::Vertex));
+	}
+
+	void GuideLines::update(const sim::CarState& pose, const sf::Vector2f& halfExtent, float curvature, float direction) {
+		const sim::SinCos start = sim::sinCosDeg(pose.headingDeg);
+		const float bumper = (direction < 0.0F) ? -halfExtent.x : halfExtent.x;
+		const float end = (direction < 0.0F) ? -m_style.length : m_style.length;
+		const bool straight = std::fabs(curvature) < STRAIGHT_CURVATURE;
+
+		// The center's arc, closed form: heading turns by curvature * s over s pixels
+		for (std::uint32_t i = 0U; i <= m_style.segments; ++i) {
+			const float s = end * static_cast<float>(i) / static_cast<float>(m_style.segments);
+			const sim::SinCos heading = straight ? start
+				: sim::sinCosDeg(pose.headingDeg + curvature * s * constants::RAD_TO_DEG);
+			const sf::Vector2f center = straight
+				? pose.position + sf::Vector2f{ start.cos, start.sin } * s
+				: pose.position + sf::Vector2f{ heading.sin - start.sin, start.cos - heading.cos } / curvature;
+			const sf::Vector2f axis{ heading.cos, heading.sin };
+			const sf::Vector2f side{ -heading.sin, heading.cos }; // towards the car's right
+			m_left[i] = center + axis * bumper - side * halfExtent.y;
+			m_right[i] = center + axis * bumper + side * halfExtent.y;
+		}
+
+		m_vertexCount = 0U;
+		for (std::uint32_t i = 0U; i < m_style.segments; ++i) {
+			const sf::Color color = bandColor((static_cast<float>(i) + 0.5F) / static_cast<float>(m_style.segments));
+			addSegment(m_left[i], m_left[i + 1U], color);
+			addSegment(m_right[i], m_right[i + 1U], color);
+		}
+		for (std::uint32_t k = 1U; k <= m_style.bars; ++k) {
+			const std::uint32_t sample = k * m_style.segments / m_style.bars;
+			addSegment(m_left[sample], m_right[sample],
+				bandColor((static_cast<float>(k) - 0.5F) / static_cast<float>(m_style.bars)));
+		}
+
+		if (m_useBuffers && !m_buffer.update(m_vertices.data(), m_vertexCount, 0U)) {
+			std::cerr << "Warning: guide line upload failed, drawing from client memory\n";
+			m_useBuffers = false;
+		}
+	}
+
+	void GuideLines::addSegment(const sf::Vector2f& a, const sf::Vector2f& b, sf::Color color) noexcept {
+		const sf::Vector2f along = b - a;
+		const float length = std::sqrt(along.dot(along));
+		if (length <= 0.0F) {
+			return;
+		}
+		const sf::Vector2f offset = sf::Vector2f{ -along.y, along.x } * (0.5F * m_style.width / length);
+		const sf::Vector2f corners[4] = { a - offset, b - offset, b + offset, a + offset };
+		for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+			m_vertices[m_vertexCount++] = sf::Vertex{ corners[corner], color };
+		}
+	}
+
+	sf::Color GuideLines::bandColor(float fraction) const noexcept {
+		if (fraction < 1.0F / 3.0F) {
+			return m_style.nearColor;
+		}
+		return (fraction < 2.0F / 3.0F) ? m_style.middleColor : m_style.farColor;
+	}
+
+	void GuideLines::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		if (m_vertexCount == 0U) {
+			return;
+		}
+		if (m_useBuffers) {
+			target.draw(m_buffer, 0U, m_vertexCount, states);
+		}
+		else {
+			target.draw(m_vertices.data(), m_vertexCount, sf::PrimitiveType::Triangles, states);
+		}
+	}
+
+} // namespace gfx
@@ -0,0 +1,85 @@
+/*
+==============================================================================
+Guide Lines - reversing guides along the car's predicted path
+==============================================================================
+ - The path comes from the steering state through the vehicle model: held
+   at its current curvature (sim::pathCurvature), the car's center follows
+   a circular arc, closed form per sample, so a frame costs one sine and
+   cosine per sample and no integration
+ - Two lines trace where the rear corners go, with distance bars across
+   them at even steps; segments and bars are coloured by band, nearest
+   red, then yellow, then green, like a reversing camera's overlay
+ - Tessellated into a triangle list of fixed capacity: the vertex buffer
+   (Usage::Stream) and its client copy are sized once in create() and
+   rewritten in place every update(), never reallocated
+ - Drawn in one call; falls back to the client-side array (still one draw
+   call) where vertex buffers are missing
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "MemoryAccounting.hpp"
+
+namespace gfx {
+
+	struct GuideLineStyle {
+		float length = 360.0F;          // pixels of path shown past the bumper
+		std::uint32_t segments = 24U;   // samples along each line
+		std::uint32_t bars = 3U;        // distance bars, one at the end of each band
+		float width = 3.0F;             // line and bar thickness in pixels
+		sf::Color nearColor{ 230, 40, 40, 200 };
+		sf::Color middleColor{ 240, 200, 40, 200 };
+		sf::Color farColor{ 60, 200, 80, 200 };
+	};
+
+	class GuideLines : public sf::Drawable {
+	public:
+		explicit GuideLines(const GuideLineStyle& style = {});
+
+		/**
+		 * @brief Sizes the vertex buffer for the style's geometry.
+		 *
+		 * Requires an active GL context. Without vertex buffers the lines are
+		 * drawn from client memory.
+		 */
+		void create();
+
+		/**
+		 * @brief Rewrites the lines for a car at pose driving a path of the given curvature.
+		 *
+		 * direction is +1 to look ahead of the front bumper and -1 behind the rear
+		 * one. MISRA: no allocation.
+		 */
+		void update(const sim::CarState& pose, const sf::Vector2f& halfExtent, float curvature, float direction);
+
+		void hide() noexcept { m_vertexCount = 0U; }
+		[[nodiscard]] bool visible() const noexcept { return m_vertexCount > 0U; }
+		[[nodiscard]] std::size_t capacity() const noexcept { return m_vertices.size(); }
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		// Appends the quad of width m_style.width from a to b
+		void addSegment(const sf::Vector2f& a, const sf::Vector2f& b, sf::Color color) noexcept;
+
+		[[nodiscard]] sf::Color bandColor(float fraction) const noexcept;
+
+		GuideLineStyle m_style;
+		sf::VertexBuffer m_buffer{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Stream };
+		std::vector<sf::Vertex> m_vertices; // the buffer's contents, sized once
+		std::vector<sf::Vector2f> m_left;   // corner paths, style.segments + 1 samples
+		std::vector<sf::Vector2f> m_right;
+		std::size_t m_vertexCount = 0U;
+		bool m_useBuffers = false;
+		prof::MemoryCharge m_bufferCharge{ prof::MemorySubsystem::RenderBuffers, prof::MemoryKind::Video };
+	};
+
+} // namespace gfx
@@ -0,0 +1,234 @@
+#include "HardwareCounters.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+
+#include "Log.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace prof {
+
+	namespace detail {
+		std::atomic<bool> g_hwCounters{ false };
+	}
+
+	namespace {
+		struct HwScopeSlot {
+			std::atomic<const char*> name{ nullptr };
+			std::atomic<std::uint64_t> calls{ 0U };
+			std::array<std::atomic<std::uint64_t>, HW_COUNTER_COUNT> counts{};
+		};
+
+		HwScopeSlot g_hwScopes[MAX_HW_SCOPES];
+		std::atomic<std::size_t> g_hwScopeCount{ 0U };
+		std::mutex g_hwScopeMutex; // registration only
+
+#if defined(__linux__)
+		constexpr std::uint64_t PERF_EVENTS[HW_COUNTER_COUNT] = {
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_MISSES,
+			PERF_COUNT_HW_BRANCH_MISSES
+		};
+
+		// One perf_event group per thread; counters the CPU or VM lacks stay closed
+		struct ThreadCounters {
+			int leader = -1;
+			std::array<int, HW_COUNTER_COUNT> fds{ -1, -1, -1, -1 };
+			std::array<std::size_t, HW_COUNTER_COUNT> groupIndex{}; // position in the group read
+			std::size_t opened = 0U;
+			bool tried = false;
+			int error = 0;
+
+			~ThreadCounters() {
+				for (const int fd : fds) {
+					if (fd >= 0) {
+						close(fd);
+					}
+				}
+			}
+
+			bool open() {
+				tried = true;
+				for (std::size_t i = 0U; i < HW_COUNTER_COUNT; ++i) {
+					perf_event_attr attr{};
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.size = sizeof(attr);
+					attr.config = PERF_EVENTS[i];
+					attr.disabled = (leader < 0) ? 1U : 0U;
+					attr.exclude_kernel = 1U;
+					attr.exclude_hv = 1U;
+					attr.read_format = PERF_FORMAT_GROUP;
+					const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+					if (fd < 0) {
+						error = errno;
+						continue;
+					}
+					fds[i] = static_cast<int>(fd);
+					groupIndex[i] = opened++;
+					if (leader < 0) {
+						leader = fds[i];
+					}
+				}
+				if (leader < 0) {
+					return false;
+				}
+				ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+				ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+				return true;
+			}
+
+			bool read(std::array<std::uint64_t, HW_COUNTER_COUNT>& values) const noexcept {
+				std::uint64_t buffer[1U + HW_COUNTER_COUNT]; // PERF_FORMAT_GROUP: nr, then one value per event
+				if (leader < 0 || ::read(leader, buffer, sizeof(buffer)) <= 0) {
+					return false;
+				}
+				for (std::size_t i = 0U; i < HW_COUNTER_COUNT; ++i) {
+					values[i] = (fds[i] >= 0) ? buffer[1U + groupIndex[i]] : 0U;
+				}
+				return true;
+			}
+		};
+
+		ThreadCounters& threadCounters() {
+			thread_local ThreadCounters counters;
+			if (!counters.tried) {
+				(void)counters.open();
+			}
+			return counters;
+		}
+#endif
+	}
+
+	namespace detail {
+		bool readHwCounters(std::array<std::uint64_t, HW_COUNTER_COUNT>& values) noexcept {
+#if defined(__linux__)
+			return threadCounters().read(values);
+#elif defined(_WIN32)
+			ULONG64 cycles = 0U;
+			if (QueryThreadCycleTime(GetCurrentThread(), &cycles) == FALSE) {
+				return false;
+			}
+			values = {};
+			values[static_cast<std::size_t>(HwCounter::Cycles)] = cycles;
+			return true;
+#else
+			(void)values;
+			return false;
+#endif
+		}
+
+		void addHwCounts(std::size_t slot, const std::array<std::uint64_t, HW_COUNTER_COUNT>& begin,
+			const std::array<std::uint64_t, HW_COUNTER_COUNT>& end) noexcept
+		{
+			HwScopeSlot& scope = g_hwScopes[slot];
+			scope.calls.fetch_add(1U, std::memory_order_relaxed);
+			for (std::size_t i = 0U; i < HW_COUNTER_COUNT; ++i) {
+				scope.counts[i].fetch_add(end[i] - begin[i], std::memory_order_relaxed);
+			}
+		}
+	}
+
+	const char* hwCounterName(HwCounter counter) {
+		switch (counter) {
+		case HwCounter::Cycles: return "CYCLES";
+		case HwCounter::Instructions: return "INSTR";
+		case HwCounter::CacheMisses: return "CACHE-MISS";
+		case HwCounter::BranchMisses: return "BR-MISS";
+		default: return "?";
+		}
+	}
+
+	bool startHwCounters() {
+#if defined(__linux__)
+		const ThreadCounters& counters = threadCounters();
+		if (counters.leader < 0) {
+			OKPP_LOG_WARNING("Warning: hardware counters unavailable (perf_event_open: %s); "
+				"check /proc/sys/kernel/perf_event_paranoid", std::strerror(counters.error));
+			return false;
+		}
+		if (counters.opened < HW_COUNTER_COUNT) {
+			OKPP_LOG_WARNING("Warning: only %zu of %zu hardware counters available", counters.opened, HW_COUNTER_COUNT);
+		}
+#elif defined(_WIN32)
+		OKPP_LOG_INFO("Hardware counters: cycles only (QueryThreadCycleTime)");
+#else
+		OKPP_LOG_WARNING("Warning: hardware counters are not supported on this platform");
+		return false;
+#endif
+		detail::g_hwCounters.store(true, std::memory_order_relaxed);
+		return true;
+	}
+
+	void stopHwCounters() noexcept {
+		detail::g_hwCounters.store(false, std::memory_order_relaxed);
+	}
+
+	std::size_t registerHwScope(const char* name) {
+		const std::lock_guard<std::mutex> lock(g_hwScopeMutex);
+		const std::size_t count = g_hwScopeCount.load(std::memory_order_relaxed);
+		for (std::size_t i = 0U; i < count; ++i) {
+			if (std::strcmp(g_hwScopes[i].name.load(std::memory_order_relaxed), name) == 0) {
+				return i;
+			}
+		}
+		if (count == MAX_HW_SCOPES) {
+			return MAX_HW_SCOPES - 1U;
+		}
+		g_hwScopes[count].name.store(name, std::memory_order_relaxed);
+		g_hwScopeCount.store(count + 1U, std::memory_order_release);
+		return count;
+	}
+
+	HwCounterReport hwCounterReport() noexcept {
+		HwCounterReport report;
+#if defined(__linux__)
+		if (hwCountersEnabled()) {
+			const ThreadCounters& counters = threadCounters();
+			for (std::size_t i = 0U; i < HW_COUNTER_COUNT; ++i) {
+				report.available[i] = counters.fds[i] >= 0;
+			}
+		}
+#elif defined(_WIN32)
+		report.available[static_cast<std::size_t>(HwCounter::Cycles)] = true;
+#endif
+		report.count = g_hwScopeCount.load(std::memory_order_acquire);
+		for (std::size_t i = 0U; i < report.count; ++i) {
+			HwScopeTotals& totals = report.scopes[i];
+			totals.name = g_hwScopes[i].name.load(std::memory_order_relaxed);
+			totals.calls = g_hwScopes[i].calls.load(std::memory_order_relaxed);
+			for (std::size_t c = 0U; c < HW_COUNTER_COUNT; ++c) {
+				totals.counts[c] = g_hwScopes[i].counts[c].load(std::memory_order_relaxed);
+			}
+		}
+		return report;
+	}
+
+	void logHwCounterReport() {
+		const HwCounterReport report = hwCounterReport();
+		for (std::size_t i = 0U; i < report.count; ++i) {
+			const HwScopeTotals& scope = report.scopes[i];
+			if (scope.calls == 0U) {
+				continue;
+			}
+			const double cycles = scope.perCall(HwCounter::Cycles);
+			const double instructions = scope.perCall(HwCounter::Instructions);
+			OKPP_LOG_INFO("HW counters: %s %llu calls, per call %.0f cycles, %.0f instructions (IPC %.2f), "
+				"%.2f cache misses, %.2f branch misses", scope.name, static_cast<unsigned long long>(scope.calls),
+				cycles, instructions, (cycles > 0.0) ? instructions / cycles : 0.0, scope.perCall(HwCounter::CacheMisses),
+				scope.perCall(HwCounter::BranchMisses));
+		}
+	}
+
+} // namespace prof
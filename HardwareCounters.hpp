@@ -0,0 +1,136 @@
+/*
+==============================================================================
+Hardware Counters - CPU performance counters around named hot scopes
+==============================================================================
+ - OKPP_HW_COUNTER_SCOPE(name) adds the cycles, instructions, cache misses
+   and branch mispredicts of the enclosing scope to the totals of name;
+   scopes sharing a name share one row
+ - Off until startHwCounters() (--hw-counters); off, a scope costs one
+   relaxed atomic load. On, it reads the counters twice per call, so keep
+   it to investigations rather than the shipped configuration
+ - Linux: one perf_event group per thread, user-space only, opened on the
+   thread's first counted scope; needs perf_event_paranoid <= 2
+ - Windows: QueryThreadCycleTime supplies cycles; the other counters need
+   a kernel-mode ETW/PMC session and read as unavailable
+ - hwCounterReport() is a snapshot for the F3 overlay, the log and the
+   headless output; the totals are relaxed atomics, safe from any thread
+ - No SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace prof {
+
+	enum class HwCounter : std::uint8_t {
+		Cycles,
+		Instructions,
+		CacheMisses,  // last-level cache misses
+		BranchMisses, // mispredicted branches
+		Count
+	};
+
+	constexpr std::size_t HW_COUNTER_COUNT = static_cast<std::size_t>(HwCounter::Count);
+	constexpr std::size_t MAX_HW_SCOPES = 16U; // later names share the last row
+
+	/**
+	 * @brief Upper-case label of a counter (used by the overlay).
+	 */
+	[[nodiscard]] const char* hwCounterName(HwCounter counter);
+
+	struct HwScopeTotals {
+		const char* name = nullptr;
+		std::uint64_t calls = 0U;
+		std::array<std::uint64_t, HW_COUNTER_COUNT> counts{};
+
+		/**
+		 * @brief Average of one counter per call, 0 before the first call.
+		 */
+		[[nodiscard]] double perCall(HwCounter counter) const noexcept {
+			return (calls > 0U) ? static_cast<double>(counts[static_cast<std::size_t>(counter)]) / static_cast<double>(calls)
+				: 0.0;
+		}
+	};
+
+	// Every named scope at one moment
+	struct HwCounterReport {
+		std::array<bool, HW_COUNTER_COUNT> available{}; // counters this platform reads
+		std::array<HwScopeTotals, MAX_HW_SCOPES> scopes{};
+		std::size_t count = 0U;
+	};
+
+	namespace detail {
+		extern std::atomic<bool> g_hwCounters;
+
+		// Raw counter values of the calling thread; false if it has none
+		[[nodiscard]] bool readHwCounters(std::array<std::uint64_t, HW_COUNTER_COUNT>& values) noexcept;
+		void addHwCounts(std::size_t slot, const std::array<std::uint64_t, HW_COUNTER_COUNT>& begin,
+			const std::array<std::uint64_t, HW_COUNTER_COUNT>& end) noexcept;
+	}
+
+	/**
+	 * @brief Opens the counters for the calling thread and turns counting on.
+	 *
+	 * Returns false (logged) when the platform or its permissions provide none.
+	 */
+	[[nodiscard]] bool startHwCounters();
+
+	/**
+	 * @brief Turns counting off; the totals stay readable.
+	 */
+	void stopHwCounters() noexcept;
+
+	[[nodiscard]] inline bool hwCountersEnabled() noexcept {
+		return detail::g_hwCounters.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Slot of the named scope, registered on first use; name must outlive the program.
+	 */
+	[[nodiscard]] std::size_t registerHwScope(const char* name);
+
+	/**
+	 * @brief Snapshot of every registered scope, in registration order.
+	 */
+	[[nodiscard]] HwCounterReport hwCounterReport() noexcept;
+
+	/**
+	 * @brief Logs one line per scope with calls and per-call averages (nothing if none ran).
+	 */
+	void logHwCounterReport();
+
+	class HwCounterScope {
+	public:
+		explicit HwCounterScope(std::size_t slot) noexcept
+			: m_slot(slot), m_counting(hwCountersEnabled() && detail::readHwCounters(m_begin)) {
+		}
+		~HwCounterScope() {
+			std::array<std::uint64_t, HW_COUNTER_COUNT> end;
+			if (m_counting && detail::readHwCounters(end)) {
+				detail::addHwCounts(m_slot, m_begin, end);
+			}
+		}
+
+		HwCounterScope(const HwCounterScope&) = delete;
+		HwCounterScope& operator=(const HwCounterScope&) = delete;
+
+	private:
+		std::size_t m_slot;
+		std::array<std::uint64_t, HW_COUNTER_COUNT> m_begin;
+		bool m_counting; // last: initialized after m_begin has been read into
+	};
+
+} // namespace prof
+
+#define OKPP_HW_COUNTER_CONCAT_INNER(a, b) a##b
+#define OKPP_HW_COUNTER_CONCAT(a, b) OKPP_HW_COUNTER_CONCAT_INNER(a, b)
+
+// Counts the rest of the enclosing scope under name (a string literal)
+#define OKPP_HW_COUNTER_SCOPE(name) \
+	static const std::size_t OKPP_HW_COUNTER_CONCAT(okppHwSlot_, __LINE__) = ::prof::registerHwScope(name); \
+	const ::prof::HwCounterScope OKPP_HW_COUNTER_CONCAT(okppHwScope_, __LINE__)(OKPP_HW_COUNTER_CONCAT(okppHwSlot_, __LINE__))
@@ -0,0 +1,235 @@
+#include "Headless.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Collision.hpp"
+#include "Constants.hpp"
+#include "FrameArena.hpp"
+#include "HardwareCounters.hpp"
+#include "MemoryAccounting.hpp"
+#include "ObstacleClusters.hpp"
+#include "ObstacleGrid.hpp"
+#include "Parking.hpp"
+#include "Scene.hpp"
+#include "SensorRig.hpp"
+#include "Sensors.hpp"
+#include "Trace.hpp"
+#include "VehicleDynamics.hpp"
+#include "VehiclePose.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	namespace {
+		[[nodiscard]] bool parseKeys(const std::string& keys, CarInput& input) {
+			input = 0U;
+			for (const char key : keys) {
+				switch (key) {
+				case 'F': input |= input::FORWARD; break;
+				case 'B': input |= input::BACKWARD; break;
+				case 'L': input |= input::LEFT; break;
+				case 'R': input |= input::RIGHT; break;
+				case '-': break;
+				default: return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	bool loadInputTrace(const std::string& path, std::vector<TraceSegment>& trace) {
+		std::ifstream file(path);
+		if (!file) {
+			std::cerr << "Error: Failed to open input trace " << path << '\n';
+			return false;
+		}
+
+		trace.clear();
+		std::string line;
+		std::size_t lineNumber = 0U;
+		while (std::getline(file, line)) {
+			++lineNumber;
+			if (line.empty() || line[0] == '#') {
+				continue;
+			}
+
+			std::istringstream fields(line);
+			TraceSegment segment;
+			std::string keys;
+			if (!(fields >> segment.ticks >> keys) || !parseKeys(keys, segment.input)) {
+				std::cerr << "Error: " << path << ':' << lineNumber << ": expected \"<ticks> <keys>\"\n";
+				return false;
+			}
+			trace.push_back(segment);
+		}
+		return true;
+	}
+
+	std::vector<TraceSegment> defaultInputTrace(float tickHz) {
+		const auto ticks = [tickHz](float seconds) { return static_cast<std::uint32_t>(seconds * tickHz); };
+
+		// Drive right, swing around towards the bay and creep in
+		return {
+			{ ticks(1.5F), input::FORWARD },
+			{ ticks(0.6F), input::FORWARD | input::LEFT },
+			{ ticks(1.0F), input::FORWARD },
+			{ ticks(0.5F), 0U },
+			{ ticks(1.0F), input::BACKWARD | input::RIGHT },
+			{ ticks(1.0F), input::FORWARD }
+		};
+	}
+
+	HeadlessStats runHeadless(const Scene& scene, const std::vector<TraceSegment>& trace,
+		float tickHz, std::uint32_t repeat, const WarningProfile& profile, VehicleModel model,
+		const SensorNoiseConfig& noise, TickProbe* probe, const CheckpointFn& checkpoint)
+	{
+		OKPP_TRACE_SCOPE("runHeadless");
+		const float tickDt = 1.0F / tickHz;
+		const CarParams carParams{ constants::CAR_SPEED, constants::CAR_TURN_RATE };
+		const BicycleParams bicycleParams;
+
+		const std::vector<WallSegment> walls = sceneWalls(scene, sceneBounds(scene));
+		ObstacleGrid obstacleGrid;
+		obstacleGrid.build(obstacleCenters(scene.obstacles), constants::OBSTACLE_CELL_SIZE, walls, scene.polygons);
+		// Clears the sensor pass at once while the car is far from every obstacle
+		ObstacleClusters obstacleClusters;
+		obstacleClusters.build(scene.obstacles, walls, scene.polygons);
+		CollisionWorld collisionWorld;
+		collisionWorld.build(scene.obstacles, {}, constants::OBSTACLE_CELL_SIZE);
+
+		// The built-in rig on the default car runs the unrolled compile-time rig; the pose then only tracks bounds
+		const bool cornerRig = profile.rig().empty() && scene.carHalfExtent == CornerRigLayout::HALF_EXTENT;
+		VehiclePose vehiclePose = cornerRig ? VehiclePose(scene.carHalfExtent, {}, {})
+			: VehiclePose(scene.carHalfExtent, createSensorMounts(scene.carHalfExtent, profile.rig()),
+				createSensorPoses(profile.rig()));
+		std::vector<SensorReading> readings;
+		CornerSensorRig::Poses cornerPoses{};
+		if (cornerRig) {
+			// place() moves the poses only; their extents are taken from the rig once, for checkpoints
+			const std::vector<SensorPose> rigPoses = createSensorPoses(CornerSensorRig::rig());
+			std::copy(rigPoses.begin(), rigPoses.end(), cornerPoses.begin());
+		}
+		CornerSensorRig::Readings cornerReadings{};
+		SensorNoise sensorNoise;
+		sensorNoise.configure(noise, cornerRig ? CornerSensorRig::SIZE : vehiclePose.sensors().size());
+		FrameArena scratch; // collision candidate lists, rewound by every sweep
+		CarState car = scene.spawns.front();
+		BicycleState bicycle;
+		float timeSinceLastBeep = 0.0F;
+
+		if (probe != nullptr) {
+			std::uint64_t totalTicks = 0U;
+			for (const auto& segment : trace) {
+				totalTicks += segment.ticks;
+			}
+			probe->tickNanoseconds.clear();
+			probe->tickNanoseconds.reserve(static_cast<std::size_t>(totalTicks * repeat));
+			probe->allocations = 0U;
+		}
+
+		HeadlessStats stats;
+		std::chrono::steady_clock::duration checkpointTime{};
+		const auto start = std::chrono::steady_clock::now();
+
+		for (std::uint32_t pass = 0U; pass < repeat; ++pass) {
+			car = scene.spawns.front();
+			bicycle = BicycleState{ car, 0.0F, 0.0F };
+			for (std::size_t segmentIndex = 0U; segmentIndex < trace.size(); ++segmentIndex) {
+				const TraceSegment& segment = trace[segmentIndex];
+				for (std::uint32_t t = 0U; t < segment.ticks; ++t) {
+					const std::uint64_t allocationsBefore = (probe != nullptr) ? prof::allocationCount() : 0U;
+					const auto tickStart = (probe != nullptr) ? std::chrono::steady_clock::now()
+						: std::chrono::steady_clock::time_point{};
+
+					bool blocked = false;
+					if (model == VehicleModel::Bicycle) {
+						blocked = stepBicycleWithCollisions(bicycle, segment.input, bicycleParams, tickDt,
+							collisionWorld, scene.carHalfExtent, scratch);
+						car = bicycle.pose;
+					}
+					else {
+						blocked = stepCarWithCollisions(car, segment.input, carParams, tickDt, collisionWorld, scene.carHalfExtent,
+							scratch);
+					}
+					if (blocked) {
+						++stats.contactTicks;
+					}
+
+					vehiclePose.setPose(car);
+
+					// Same decision as playBeepIfNear, on simulated time
+					{
+						OKPP_HW_COUNTER_SCOPE("playBeepIfNear");
+						timeSinceLastBeep += tickDt;
+						float interval = 0.0F;
+						if (cornerRig) {
+							{
+								OKPP_HW_COUNTER_SCOPE("updateSensorPositions");
+								CornerSensorRig::place(vehiclePose.transform(), car.headingDeg, cornerPoses);
+							}
+							if (obstacleClusters.anyNear(cornerPoses.data(), cornerPoses.size(), profile.range())) {
+								CornerSensorRig::read(cornerPoses, obstacleGrid, profile.range(), cornerReadings);
+							}
+							else {
+								cornerReadings.fill(SensorReading{});
+							}
+							sensorNoise.apply(stats.ticks, 0U, CornerSensorRig::SIZE,
+								[&cornerReadings](std::size_t i) -> SensorReading& { return cornerReadings[i]; });
+							interval = CornerSensorRig::warningInterval(cornerReadings, profile);
+						}
+						else {
+							if (obstacleClusters.anyNear(vehiclePose.sensors(), profile.range())) {
+								readSensors(vehiclePose.sensors(), obstacleGrid, profile.range(), readings);
+							}
+							else {
+								readings.assign(vehiclePose.sensors().size(), SensorReading{});
+							}
+							sensorNoise.apply(stats.ticks, readings);
+							interval = warningInterval(readings, vehiclePose.mounts(), profile);
+						}
+						if (interval > 0.0F && timeSinceLastBeep >= interval) {
+							++stats.beeps;
+							timeSinceLastBeep = 0.0F;
+						}
+					}
+
+					if (parkOccupied(vehiclePose.bounds(), scene.parkBays.front())) {
+						++stats.occupiedTicks;
+					}
+					++stats.ticks;
+
+					if (probe != nullptr) {
+						const auto tickNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+							std::chrono::steady_clock::now() - tickStart).count();
+						probe->allocations += prof::allocationCount() - allocationsBefore;
+						probe->tickNanoseconds.push_back(static_cast<std::uint32_t>(tickNs));
+					}
+				}
+
+				if (checkpoint && segment.ticks > 0U) {
+					const auto checkpointStart = std::chrono::steady_clock::now();
+					HeadlessCheckpoint frame;
+					frame.pass = pass;
+					frame.segment = static_cast<std::uint32_t>(segmentIndex);
+					frame.tick = stats.ticks;
+					frame.car = car;
+					frame.sensors = cornerRig ? cornerPoses.data() : vehiclePose.sensors().data();
+					frame.readings = cornerRig ? cornerReadings.data() : readings.data();
+					frame.sensorCount = cornerRig ? CornerSensorRig::SIZE : readings.size();
+					frame.occupied = parkOccupied(vehiclePose.bounds(), scene.parkBays.front());
+					checkpoint(frame);
+					checkpointTime += std::chrono::steady_clock::now() - checkpointStart;
+				}
+			}
+		}
+
+		stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start - checkpointTime).count();
+		stats.finalCar = car;
+		return stats;
+	}
+
+} // namespace sim
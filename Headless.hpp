@@ -0,0 +1,87 @@
+/*
+==============================================================================
+Headless Runner - batch simulation without a window or audio device
+==============================================================================
+ - Replays a scripted input trace through the same car, sensor, beep and
+   parking logic as the interactive front-end
+ - Runs as fast as the CPU allows; no frame limiter, no rendering
+ - The end of every trace segment is a replay checkpoint; a checkpoint
+   callback sees the car, its sensors and their readings there (the
+   headless screenshots draw one frame per checkpoint)
+ - Trace format (text): one segment per line, "<ticks> <keys>", where keys
+   is any combination of F (forward), B (backward), L (left), R (right),
+   or '-' for no input. Lines starting with '#' are comments.
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "SensorNoise.hpp"
+#include "SimFwd.hpp"
+
+namespace sim {
+
+	struct TraceSegment {
+		std::uint32_t ticks = 0U;
+		CarInput input = 0U;
+	};
+
+	struct HeadlessStats {
+		std::uint64_t ticks = 0U;
+		std::uint64_t beeps = 0U;
+		std::uint64_t occupiedTicks = 0U; // ticks spent inside the first bay
+		std::uint64_t contactTicks = 0U;  // ticks the car was stopped by an obstacle
+		double wallSeconds = 0.0;
+		CarState finalCar;
+	};
+
+	// Per-tick cost of a run, filled when handed to runHeadless (the perf gate)
+	struct TickProbe {
+		std::vector<std::uint32_t> tickNanoseconds; // one per tick, in order; reserved up front
+		std::uint64_t allocations = 0U;             // heap allocations made inside ticks (prof::allocationCount)
+	};
+
+	// The state at the end of a trace segment; the pointers are valid during the callback only
+	struct HeadlessCheckpoint {
+		std::uint32_t pass = 0U;
+		std::uint32_t segment = 0U;
+		std::uint64_t tick = 0U; // ticks run so far
+		CarState car;
+		const SensorPose* sensors = nullptr;
+		const SensorReading* readings = nullptr;
+		std::size_t sensorCount = 0U;
+		bool occupied = false;   // inside the first bay
+	};
+
+	using CheckpointFn = std::function<void(const HeadlessCheckpoint&)>;
+
+	/**
+	 * @brief Parses a text input trace; returns false and logs on errors.
+	 */
+	[[nodiscard]] bool loadInputTrace(const std::string& path, std::vector<TraceSegment>& trace);
+
+	/**
+	 * @brief A short built-in drive used when no trace file is given.
+	 */
+	[[nodiscard]] std::vector<TraceSegment> defaultInputTrace(float tickHz);
+
+	/**
+	 * @brief Runs the trace repeat times over the scene at a fixed tick rate,
+	 *        driving with the given model and beeping by the given warning profile.
+	 *
+	 * noise perturbs each sensor pass before the beep decision; its counter is the tick index.
+	 * With a probe every tick is timed and its allocations counted; set-up before the first tick is not.
+	 * checkpoint, if set, is called after every segment of at least one tick; its time is not in wallSeconds.
+	 */
+	[[nodiscard]] HeadlessStats runHeadless(const Scene& scene, const std::vector<TraceSegment>& trace,
+		float tickHz, std::uint32_t repeat, const WarningProfile& profile, VehicleModel model,
+		const SensorNoiseConfig& noise = {}, TickProbe* probe = nullptr, const CheckpointFn& checkpoint = {});
+
+} // namespace sim
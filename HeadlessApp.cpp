@@ -0,0 +1,659 @@
+#include "HeadlessApp.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "DriveScript.hpp"
+#include "EventLog.hpp"
+#include "FastTrig.hpp"
+#include "CpuFeatures.hpp"
+#include "Fleet.hpp"
+#include "GoldenImage.hpp"
+#include "Headless.hpp"
+#include "ManeuverEvaluator.hpp"
+#include "PngWriter.hpp"
+#include "RegionFleet.hpp"
+#include "RigOptimizer.hpp"
+#include "Scenario.hpp"
+#include "Scene.hpp"
+#include "SensorDataset.hpp"
+#include "SoftRasterizer.hpp"
+#include "StressScenes.hpp"
+#include "ThreadPool.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	bool loadScene(const std::string& scenarioPath, Scene& scene, const std::string& stressScene) {
+		scene = makeDefaultScene();
+		if (!stressScene.empty()) {
+			if (!scenarioPath.empty()) {
+				std::cerr << "Error: a stress scene and a scenario both replace the lot; give one of them\n";
+				return false;
+			}
+			return makeStressScene(stressScene, scene);
+		}
+		return scenarioPath.empty() || loadScenario(scenarioPath, scene);
+	}
+
+	bool loadWarningProfile(const std::string& profilesPath, const std::string& vehicle, WarningProfile& profile) {
+		std::vector<WarningProfile> profiles{ defaultWarningProfile() };
+		if (!profilesPath.empty() && !loadWarningProfiles(profilesPath, profiles)) {
+			return false;
+		}
+		const WarningProfile* found = vehicle.empty() ? &profiles.front() : findWarningProfile(profiles, vehicle);
+		if (found == nullptr) {
+			std::cerr << "Error: no warning profile named " << vehicle << '\n';
+			return false;
+		}
+		profile = *found;
+		return true;
+	}
+
+	namespace {
+		// --optimize-rig: a pose every this many ticks of the drive, about 15 per second at 60 Hz
+		constexpr std::uint32_t RIG_SAMPLE_TICKS = 4U;
+
+		// Searches rigs over the loaded scene and every --rig-scenario; the exit code
+		[[nodiscard]] int runRigSearch(const HeadlessOptions& options, const std::vector<TraceSegment>& trace,
+			const Scene& scene, const WarningProfile& profile, ThreadPool& pool)
+		{
+			std::vector<Scene> extra(options.rigScenarios.size());
+			for (std::size_t i = 0U; i < extra.size(); ++i) {
+				if (!loadScene(options.rigScenarios[i], extra[i])) {
+					return 1;
+				}
+			}
+			std::vector<RigScenario> scenarios(1U + extra.size());
+			scenarios[0].scene = &scene;
+			for (std::size_t i = 0U; i < extra.size(); ++i) {
+				scenarios[i + 1U].scene = &extra[i];
+			}
+			pool.parallelFor(scenarios.size(), 1U, [&](std::size_t begin, std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					scenarios[i].poses = sampleDrivePoses(*scenarios[i].scene, trace, options.tickHz, profile, options.model,
+						RIG_SAMPLE_TICKS);
+				}
+			});
+
+			RigSearchConfig config;
+			config.candidates = options.rigCandidates;
+			config.generations = options.rigGenerations;
+			config.seed = options.seed;
+			const RigSearchResult result = optimizeSensorRig(scenarios, profile.rig(), profile, config, pool);
+			const double rigsPerSecond = (result.wallSeconds > 0.0) ? static_cast<double>(result.evaluated) / result.wallSeconds : 0.0;
+			std::cout << "rig search: " << result.evaluated << " rigs over " << scenarios.size() << " scenes, "
+				<< result.poses << " poses"
+				<< "\nhazard poses: " << result.base.hazardPoses << " (" << result.base.hazards << " pillars in range)"
+				<< "\nbase rig: coverage " << result.base.coverage * 100.0F << " %, blind spots "
+				<< result.base.blindSpots * 100.0F << " %, score " << result.base.score
+				<< "\nbest rig: coverage " << result.best.coverage * 100.0F << " %, blind spots "
+				<< result.best.blindSpots * 100.0F << " %, score " << result.best.score << '\n';
+			for (const RigSensor& sensor : result.bestRig) {
+				std::cout << formatRigSensor(sensor) << '\n';
+			}
+			std::cout << "wall time: " << result.wallSeconds << " s"
+				<< "\nrigs/s: " << rigsPerSecond << '\n';
+			return 0;
+		}
+
+		// Closes the event log and reports its size; the exit code of a run that wrote one
+		[[nodiscard]] int finishEventLog(const HeadlessOptions& options) {
+			if (options.eventsPath.empty()) {
+				return 0;
+			}
+			EventLogStats events;
+			if (!stopEventLog(&events)) {
+				return 1;
+			}
+			std::cout << "events: " << events.events << " in " << events.blocks << " blocks"
+				<< " (" << events.stalls << " writer stalls) -> " << options.eventsPath << '\n';
+			return 0;
+		}
+
+		// Screenshot width in pixels; the height follows the lot
+		constexpr std::uint32_t SCREENSHOT_WIDTH = 960U;
+		// Walls, curbs and bay outlines, in world units
+		constexpr float SCREENSHOT_LINE_WIDTH = 2.0F;
+		// Car sprite size in texels; its front is at +x
+		constexpr std::uint32_t CAR_SPRITE_LENGTH = 32U;
+		constexpr std::uint32_t CAR_SPRITE_WIDTH = 16U;
+
+		// The front-end's colors
+		const sf::Color SCREENSHOT_BACKGROUND(30, 30, 30);
+		const sf::Color SCREENSHOT_BAY_COLORS[] = { sf::Color(0, 255, 0, 100), sf::Color(255, 0, 0, 100) }; // free, taken
+		const sf::Color SCREENSHOT_SENSOR_COLORS[] = { sf::Color::Green, sf::Color::Yellow, sf::Color::Red }; // clear, warning, danger
+		const sf::Color SCREENSHOT_CAR_BODY(60, 120, 220);
+		const sf::Color SCREENSHOT_CAR_GLASS(20, 30, 50);
+		const sf::Color SCREENSHOT_CAR_LIGHTS(200, 30, 30);
+
+		// A segment from a to b drawn as a quad width wide
+		[[nodiscard]] std::array<sf::Vector2f, 4U> lineQuad(sf::Vector2f a, sf::Vector2f b, float width) {
+			const sf::Vector2f along = b - a;
+			const float length = std::sqrt(along.x * along.x + along.y * along.y);
+			const sf::Vector2f side = (length > 0.0F)
+				? sf::Vector2f{ -along.y, along.x } * (0.5F * width / length) : sf::Vector2f{};
+			return { a + side, b + side, b - side, a - side };
+		}
+
+		// A plain car seen from above: body, windshield towards the front, tail lights at the back
+		[[nodiscard]] gfx::SoftImage makeCarImage() {
+			gfx::SoftImage image;
+			image.width = CAR_SPRITE_LENGTH;
+			image.height = CAR_SPRITE_WIDTH;
+			image.pixels.resize(static_cast<std::size_t>(image.width) * image.height * 4U);
+			for (std::uint32_t y = 0U; y < image.height; ++y) {
+				for (std::uint32_t x = 0U; x < image.width; ++x) {
+					const bool inside = y > 0U && y + 1U < image.height;
+					sf::Color color = SCREENSHOT_CAR_BODY;
+					if (x < 2U && (y < 4U || y + 4U >= image.height)) {
+						color = SCREENSHOT_CAR_LIGHTS;
+					}
+					else if (inside && x >= image.width * 5U / 8U && x < image.width * 13U / 16U) {
+						color = SCREENSHOT_CAR_GLASS;
+					}
+					std::uint8_t* pixel = image.pixels.data() + (static_cast<std::size_t>(y) * image.width + x) * 4U;
+					pixel[0] = color.r;
+					pixel[1] = color.g;
+					pixel[2] = color.b;
+					pixel[3] = color.a;
+				}
+			}
+			return image;
+		}
+
+		// Indicator color of a sensor, by the front-end's rule
+		[[nodiscard]] sf::Color sensorColor(const SensorReading& reading) {
+			constexpr float DANGER_SQ = constants::DANGER_THRESHOLD * constants::DANGER_THRESHOLD;
+			constexpr float WARNING_SQ = constants::WARNING_THRESHOLD * constants::WARNING_THRESHOLD;
+			if (reading.wallDistance <= 0.0F || reading.distanceSq <= DANGER_SQ) {
+				return SCREENSHOT_SENSOR_COLORS[2];
+			}
+			if (reading.wallDistance <= constants::WARNING_THRESHOLD || reading.distanceSq <= WARNING_SQ) {
+				return SCREENSHOT_SENSOR_COLORS[1];
+			}
+			return SCREENSHOT_SENSOR_COLORS[0];
+		}
+
+		// Draws the lot, the car and its sensors of a checkpoint with the CPU rasterizer
+		class CheckpointPainter {
+		public:
+			CheckpointPainter(const Scene& scene, ThreadPool& pool)
+				: m_scene(scene)
+				, m_pool(pool)
+				, m_bounds(sceneBounds(scene))
+				, m_walls(sceneWalls(scene, m_bounds))
+				, m_carImage(makeCarImage())
+			{
+				const float height = std::round(static_cast<float>(SCREENSHOT_WIDTH) * m_bounds.size.y / m_bounds.size.x);
+				m_rasterizer.resize(SCREENSHOT_WIDTH, static_cast<std::uint32_t>(std::max(height, 1.0F)));
+				m_rasterizer.setView(m_bounds);
+				m_rasterizer.clear(SCREENSHOT_BACKGROUND);
+			}
+
+			[[nodiscard]] const gfx::SoftImage& paint(const HeadlessCheckpoint& checkpoint) {
+				drawLot(checkpoint.occupied);
+				drawCar(checkpoint);
+				m_rasterizer.render(m_pool);
+				return m_rasterizer.image();
+			}
+
+		private:
+			void drawLot(bool occupied) {
+				for (std::size_t bay = 0U; bay < m_scene.parkBays.size(); ++bay) {
+					const sf::FloatRect& rect = m_scene.parkBays[bay];
+					m_rasterizer.fillRect(rect, SCREENSHOT_BAY_COLORS[(bay == 0U && occupied) ? 1U : 0U]);
+					const sf::Vector2f end = rect.position + rect.size;
+					m_rasterizer.fillRect({ rect.position, { rect.size.x, SCREENSHOT_LINE_WIDTH } }, sf::Color::White);
+					m_rasterizer.fillRect({ { rect.position.x, end.y - SCREENSHOT_LINE_WIDTH }, { rect.size.x, SCREENSHOT_LINE_WIDTH } },
+						sf::Color::White);
+					m_rasterizer.fillRect({ rect.position, { SCREENSHOT_LINE_WIDTH, rect.size.y } }, sf::Color::White);
+					m_rasterizer.fillRect({ { end.x - SCREENSHOT_LINE_WIDTH, rect.position.y }, { SCREENSHOT_LINE_WIDTH, rect.size.y } },
+						sf::Color::White);
+				}
+				for (const WallSegment& wall : m_walls) {
+					m_rasterizer.fillQuad(lineQuad(wall.from, wall.to, SCREENSHOT_LINE_WIDTH), sf::Color::White);
+				}
+				const PolygonSet& polygons = m_scene.polygons;
+				for (std::size_t polygon = 0U; polygon + 1U < polygons.starts.size(); ++polygon) {
+					const std::uint32_t first = polygons.starts[polygon];
+					const std::uint32_t last = polygons.starts[polygon + 1U];
+					for (std::uint32_t v = first; v < last; ++v) {
+						const sf::Vector2f to = polygons.vertices[(v + 1U < last) ? v + 1U : first];
+						m_rasterizer.fillQuad(lineQuad(polygons.vertices[v], to, SCREENSHOT_LINE_WIDTH), sf::Color::White);
+					}
+				}
+				for (const Obstacle& obstacle : m_scene.obstacles) {
+					m_rasterizer.fillCircle(obstacle.center, obstacle.radius, sf::Color::White);
+				}
+			}
+
+			void drawCar(const HeadlessCheckpoint& checkpoint) {
+				const sf::Vector2f half = m_scene.carHalfExtent;
+				const sf::Transform spriteToCar(2.0F * half.x / static_cast<float>(m_carImage.width), 0.0F, -half.x,
+					0.0F, 2.0F * half.y / static_cast<float>(m_carImage.height), -half.y,
+					0.0F, 0.0F, 1.0F);
+				m_rasterizer.drawSprite(m_carImage, carTransform(checkpoint.car) * spriteToCar);
+
+				// Sensor rectangles extend from their anchor along their rotated +x and +y axes
+				for (std::size_t i = 0U; i < checkpoint.sensorCount; ++i) {
+					const SensorPose& sensor = checkpoint.sensors[i];
+					const SinCos rotation = sinCosDeg(sensor.rotationDeg);
+					const sf::Vector2f across = sf::Vector2f{ rotation.cos, rotation.sin } * sensor.extent.x;
+					const sf::Vector2f along = sf::Vector2f{ -rotation.sin, rotation.cos } * sensor.extent.y;
+					m_rasterizer.fillQuad({ sensor.position, sensor.position + across, sensor.position + across + along,
+						sensor.position + along }, sensorColor(checkpoint.readings[i]));
+				}
+			}
+
+			const Scene& m_scene;
+			ThreadPool& m_pool;
+			sf::FloatRect m_bounds;
+			std::vector<WallSegment> m_walls;
+			gfx::SoftImage m_carImage;
+			gfx::SoftRasterizer m_rasterizer;
+		};
+
+		[[nodiscard]] std::string checkpointName(std::size_t frame, const char* extension) {
+			char name[40];
+			std::snprintf(name, sizeof(name), "checkpoint_%04zu%s", frame, extension);
+			return name;
+		}
+
+		// Saves the painted checkpoints as numbered PNGs
+		class CheckpointScreenshots {
+		public:
+			CheckpointScreenshots(const Scene& scene, std::string directory, ThreadPool& pool)
+				: m_painter(scene, pool), m_directory(std::move(directory)) {
+			}
+
+			void capture(const HeadlessCheckpoint& checkpoint) {
+				const auto start = std::chrono::steady_clock::now();
+				const gfx::SoftImage& image = m_painter.paint(checkpoint);
+				if (!gfx::writePng((std::filesystem::path(m_directory) / checkpointName(m_frames, ".png")).string(), image)) {
+					m_failed = true;
+				}
+				++m_frames;
+				m_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			}
+
+			[[nodiscard]] std::size_t frames() const noexcept { return m_frames; }
+			[[nodiscard]] double seconds() const noexcept { return m_seconds; }
+			[[nodiscard]] bool failed() const noexcept { return m_failed; }
+
+		private:
+			CheckpointPainter m_painter;
+			std::string m_directory;
+			std::size_t m_frames = 0U;
+			double m_seconds = 0.0;
+			bool m_failed = false;
+		};
+
+		// Render cost above the golden run's by this factor is reported as a regression
+		constexpr double GOLDEN_SLOWDOWN_LIMIT = 1.5;
+		constexpr const char* GOLDEN_TIMING_FILE = "timing.txt";
+
+		// One replay of a golden run: its checkpoints painted and held against the stored frames
+		struct GoldenReplay {
+			std::string name; // the trace's file stem, its directory under the golden root
+			std::vector<TraceSegment> trace;
+			std::size_t checkpoints = 0U;
+			std::size_t mismatches = 0U;
+			std::size_t missing = 0U;    // no golden frame to compare with
+			gfx::ImageDiff worst;        // the mismatch with the most differing pixels
+			double paintSeconds = 0.0;
+			double diffSeconds = 0.0;   // golden frame load and diff
+			double goldenPaintMs = 0.0;  // per checkpoint, from the golden run's timing file (0 = none)
+			bool failed = false;         // I/O error
+		};
+
+		void runGoldenReplay(GoldenReplay& replay, const HeadlessOptions& options, const Scene& scene,
+			const WarningProfile& profile, const SensorNoiseConfig& noise, ThreadPool& pool)
+		{
+			const std::filesystem::path directory = std::filesystem::path(options.goldenDir) / replay.name;
+			std::error_code error;
+			std::filesystem::create_directories(directory, error);
+			if (error) {
+				std::cerr << "Error: Failed to create golden directory " << directory.string() << ": " << error.message() << '\n';
+				replay.failed = true;
+				return;
+			}
+
+			// Each replay paints into its own rasterizer; its tiles still spread over the pool
+			CheckpointPainter painter(scene, pool);
+			gfx::SoftImage golden;
+			gfx::SoftImage mask;
+			const CheckpointFn checkpoint = [&](const HeadlessCheckpoint& frame) {
+				const auto paintStart = std::chrono::steady_clock::now();
+				const gfx::SoftImage& image = painter.paint(frame);
+				const auto diffStart = std::chrono::steady_clock::now();
+				replay.paintSeconds += std::chrono::duration<double>(diffStart - paintStart).count();
+
+				const std::size_t index = replay.checkpoints++;
+				const std::string goldenPath = (directory / checkpointName(index, ".okgld")).string();
+				if (options.updateGolden) {
+					replay.failed = !gfx::saveGoldenImage(goldenPath, image) || replay.failed;
+					return;
+				}
+				if (!gfx::loadGoldenImage(goldenPath, golden)) {
+					++replay.missing;
+					return;
+				}
+				const gfx::ImageDiff diff = gfx::diffImages(image, golden, options.goldenTolerance);
+				replay.diffSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - diffStart).count();
+				if (diff.matches()) {
+					return;
+				}
+				++replay.mismatches;
+				if (diff.sizeMismatch || diff.differing > replay.worst.differing) {
+					replay.worst = diff;
+				}
+				// What was drawn and where it differs, next to the golden frame
+				bool written = gfx::writePng((directory / checkpointName(index, ".actual.png")).string(), image);
+				if (!diff.sizeMismatch) {
+					gfx::writeDiffMask(image, golden, options.goldenTolerance, mask);
+					written = gfx::writePng((directory / checkpointName(index, ".diff.png")).string(), mask) && written;
+				}
+				replay.failed = !written || replay.failed;
+			};
+			(void)runHeadless(scene, replay.trace, options.tickHz, options.repeat, profile, options.model, noise, nullptr,
+				checkpoint);
+
+			const double paintMs = (replay.checkpoints > 0U)
+				? replay.paintSeconds * 1000.0 / static_cast<double>(replay.checkpoints) : 0.0;
+			const std::filesystem::path timingPath = directory / GOLDEN_TIMING_FILE;
+			if (options.updateGolden) {
+				std::ofstream timing(timingPath);
+				timing << paintMs << '\n';
+				replay.failed = !timing || replay.failed;
+			}
+			else {
+				std::ifstream timing(timingPath);
+				timing >> replay.goldenPaintMs;
+			}
+		}
+
+		// Paints the checkpoints of every replay concurrently and compares them with the golden frames
+		[[nodiscard]] int runGoldenReplays(const HeadlessOptions& options, const Scene& scene, const WarningProfile& profile,
+			const SensorNoiseConfig& noise, ThreadPool& pool)
+		{
+			std::vector<std::string> paths = options.goldenTraces;
+			if (!options.tracePath.empty()) {
+				paths.insert(paths.begin(), options.tracePath);
+			}
+			std::vector<GoldenReplay> replays(std::max<std::size_t>(paths.size(), 1U));
+			if (paths.empty()) {
+				replays.front().name = "builtin";
+				replays.front().trace = defaultInputTrace(options.tickHz);
+			}
+			for (std::size_t i = 0U; i < paths.size(); ++i) {
+				replays[i].name = std::filesystem::path(paths[i]).stem().string();
+				if (!loadInputTrace(paths[i], replays[i].trace)) {
+					return 1;
+				}
+				for (std::size_t j = 0U; j < i; ++j) {
+					if (replays[j].name == replays[i].name) {
+						std::cerr << "Error: two golden replays are named " << replays[i].name << '\n';
+						return 1;
+					}
+				}
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			TaskGroup group;
+			for (GoldenReplay& replay : replays) {
+				pool.submit(group, [&replay, &options, &scene, &profile, &noise, &pool]() {
+					runGoldenReplay(replay, options, scene, profile, noise, pool);
+				});
+			}
+			pool.wait(group);
+			const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			int result = 0;
+			std::size_t checkpoints = 0U;
+			for (const GoldenReplay& replay : replays) {
+				checkpoints += replay.checkpoints;
+				const double count = static_cast<double>(std::max<std::size_t>(replay.checkpoints, 1U));
+				const double paintMs = replay.paintSeconds * 1000.0 / count;
+				std::cout << "replay " << replay.name << ": " << replay.checkpoints << " checkpoints, paint " << paintMs
+					<< " ms";
+				if (options.updateGolden) {
+					std::cout << " -> golden updated\n";
+				}
+				else {
+					std::cout << ", compare " << replay.diffSeconds * 1000.0 / count << " ms (" << simdLevelName(simdLevel())
+						<< "), " << replay.mismatches << " mismatched, " << replay.missing << " without a golden frame\n";
+				}
+				if (replay.mismatches > 0U) {
+					std::cout << "  worst: " << (replay.worst.sizeMismatch ? std::string("size differs")
+						: std::to_string(replay.worst.differing) + " of " + std::to_string(replay.worst.pixels)
+						+ " pixels, max delta " + std::to_string(replay.worst.maxDelta)) << '\n';
+				}
+				if (replay.goldenPaintMs > 0.0 && paintMs > replay.goldenPaintMs * GOLDEN_SLOWDOWN_LIMIT) {
+					std::cout << "  perf regression: paint " << paintMs << " ms against " << replay.goldenPaintMs
+						<< " ms in the golden run\n";
+				}
+				if (replay.failed || replay.mismatches > 0U || replay.missing > 0U) {
+					result = 1;
+				}
+			}
+			std::cout << "golden checkpoints: " << checkpoints << " in " << replays.size() << " replays"
+				<< "\nwall time: " << wallSeconds << " s\n";
+			return result;
+		}
+	}
+
+	int runHeadlessApp(const HeadlessOptions& options, ThreadPool& pool) {
+		std::vector<TraceSegment> trace;
+		if (options.tracePath.empty()) {
+			trace = defaultInputTrace(options.tickHz);
+		}
+		else if (!loadInputTrace(options.tracePath, trace)) {
+			return 1;
+		}
+
+		Scene scene;
+		WarningProfile profile;
+		const auto sceneStart = std::chrono::steady_clock::now();
+		if (!loadScene(options.scenarioPath, scene, options.stressScene)
+			|| !loadWarningProfile(options.profilesPath, options.vehicle, profile))
+		{
+			return 1;
+		}
+		if (!options.stressScene.empty()) {
+			const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sceneStart).count();
+			std::cout << "stress scene: " << options.stressScene
+				<< "\npillars: " << scene.obstacles.size()
+				<< "\nwalls: " << scene.walls.size()
+				<< "\nbays: " << scene.parkBays.size()
+				<< "\nscene build: " << buildMs << " ms\n";
+		}
+		if (!options.script.empty()) {
+			if (options.fleetSize == 0U) {
+				std::cerr << "Warning: drive scripts run in fleet mode only, driving the trace\n";
+			}
+			else if (!driveScriptExists(options.script)) {
+				std::cerr << "Error: no drive script named " << options.script << " (" << driveScriptNames() << ")\n";
+				return 1;
+			}
+		}
+
+		if (!options.datasetPath.empty()) {
+			DatasetConfig config;
+			config.samples = options.datasetSamples;
+			config.seed = options.seed;
+			config.lot = sceneBounds(scene);
+			config.carHalfExtent = scene.carHalfExtent;
+			config.rig = profile.rig();
+			config.cone = { constants::SENSOR_CONE_HALF_ANGLE, constants::SENSOR_CONE_RAYS, profile.range() };
+			DatasetStats stats;
+			if (!generateSensorDataset(options.datasetPath, config, pool, stats)) {
+				return 1;
+			}
+			const double samplesPerSecond = (stats.wallSeconds > 0.0) ? static_cast<double>(stats.samples) / stats.wallSeconds : 0.0;
+			std::cout << "samples: " << stats.samples << " in " << stats.lots << " lots -> " << options.datasetPath
+				<< "\nwall time: " << stats.wallSeconds << " s"
+				<< "\nsamples/s: " << samplesPerSecond << '\n';
+			return 0;
+		}
+		if (options.rigCandidates > 0U) {
+			return runRigSearch(options, trace, scene, profile, pool);
+		}
+
+		SensorNoiseConfig noise = options.noise;
+		noise.seed = options.seed;
+
+		const bool logsEvents = options.evaluateTrials > 0U || options.fleetSize > 0U;
+		if (logsEvents && !options.screenshotDir.empty()) {
+			std::cerr << "Warning: screenshots are taken by single-car runs only\n";
+		}
+		if (logsEvents && !options.eventsPath.empty() && !startEventLog(options.eventsPath)) {
+			return 1;
+		}
+
+		if (options.evaluateTrials > 0U) {
+			EvaluationConfig config;
+			config.trials = options.evaluateTrials;
+			config.seed = options.seed;
+			config.tickHz = options.tickHz;
+			config.model = options.model;
+			config.forkAt = options.forkAt;
+
+			const EvaluationResult result = evaluateParking(scene, trace, config, pool);
+			const double trialsPerSecond = (result.wallSeconds > 0.0) ? static_cast<double>(result.trials) / result.wallSeconds : 0.0;
+			std::cout << "trials: " << result.trials
+				<< "\nwall time: " << result.wallSeconds << " s"
+				<< "\ntrials/s: " << trialsPerSecond
+				<< "\nparked: " << result.parked << " (" << result.successRate() * 100.0 << " %)"
+				<< "\nblocked by a pillar: " << result.blocked << '\n';
+			if (result.parked > 0U) {
+				std::cout << "time to park: fastest " << result.fastestPark
+					<< " s, median " << result.parkSecondsQuantile(0.5F)
+					<< " s, p90 " << result.parkSecondsQuantile(0.9F)
+					<< " s, slowest " << result.slowestPark
+					<< " s, mean " << result.meanParkSeconds() << " s\n";
+			}
+			return finishEventLog(options);
+		}
+
+		if (options.fleetSize > 0U) {
+			std::uint32_t traceTicks = 0U;
+			for (const auto& segment : trace) {
+				traceTicks += segment.ticks;
+			}
+
+			if (options.regions > 1U) {
+				if (options.model != VehicleModel::Arcade || !options.script.empty() || options.quantized
+					|| options.noise.enabled() || !options.eventsPath.empty() || options.carSensing || options.routing)
+				{
+					std::cerr << "Error: --regions runs trace-driven arcade cars without noise, scripts, "
+						"quantized pillars, car sensing, routing or an event log\n";
+					return 1;
+				}
+				RegionStats regions;
+				if (!runRegionFleet(scene, trace, options.tickHz, options.fleetSize, traceTicks * options.repeat,
+					profile, options.regions, regions))
+				{
+					return 1;
+				}
+				const double carTicksPerSecond = (regions.wallSeconds > 0.0) ? static_cast<double>(regions.carTicks) / regions.wallSeconds : 0.0;
+				std::cout << "cars: " << options.fleetSize
+					<< "\nregions: " << options.regions
+					<< "\ncar ticks: " << regions.carTicks
+					<< "\nwall time: " << regions.wallSeconds << " s"
+					<< "\ncar ticks/s: " << carTicksPerSecond
+					<< "\nbeeps: " << regions.beeps
+					<< "\noccupied ticks: " << regions.occupiedTicks
+					<< "\ncontact ticks: " << regions.contactTicks
+					<< "\nhand-offs: " << regions.handoffs
+					<< "\nhalo pillars: " << regions.haloPillars
+					<< "\nmessages: " << regions.messages << " (" << regions.messageBytes << " bytes)\n";
+				return 0;
+			}
+
+			const FleetStats fleet = runFleet(scene, trace, options.tickHz, options.fleetSize,
+				traceTicks * options.repeat, pool, profile, options.model, noise, options.script,
+				options.quantized, options.carSensing, options.routing);
+			const double carTicksPerSecond = (fleet.wallSeconds > 0.0) ? static_cast<double>(fleet.carTicks) / fleet.wallSeconds : 0.0;
+			std::cout << "cars: " << options.fleetSize
+				<< "\ncar ticks: " << fleet.carTicks
+				<< "\nwall time: " << fleet.wallSeconds << " s"
+				<< "\ncar ticks/s: " << carTicksPerSecond
+				<< "\nbeeps: " << fleet.beeps
+				<< "\noccupied ticks: " << fleet.occupiedTicks
+				<< "\ncontact ticks: " << fleet.contactTicks
+				<< "\noccupied bays: " << fleet.occupiedBays << '\n';
+			if (options.carSensing) {
+				std::cout << "car grid re-filings: " << fleet.carGridReinsertions << '\n';
+			}
+			if (options.routing) {
+				const double hitRate = (fleet.routes > 0U)
+					? 100.0 * static_cast<double>(fleet.routeCacheHits) / static_cast<double>(fleet.routes) : 0.0;
+				std::cout << "routes: " << fleet.routes << " (" << hitRate << "% cached, "
+					<< fleet.routeExpansions << " nodes expanded)"
+					<< "\nmean route length: " << fleet.meanRouteLength << " px"
+					<< "\ncongested aisles: " << fleet.congestedAisles << '\n';
+			}
+			const std::uint64_t fleetTicks = static_cast<std::uint64_t>(traceTicks) * options.repeat;
+			if (!options.stressScene.empty() && fleetTicks > 0U) {
+				std::cout << "simulation per tick: " << fleet.wallSeconds * 1.0e6 / static_cast<double>(fleetTicks)
+					<< " us (all cars)\n";
+			}
+			return finishEventLog(options);
+		}
+
+		if (!options.eventsPath.empty()) {
+			std::cerr << "Warning: the event log is written by fleet and evaluation runs only\n";
+		}
+		if (!options.goldenDir.empty()) {
+			return runGoldenReplays(options, scene, profile, noise, pool);
+		}
+		std::optional<CheckpointScreenshots> screenshots;
+		CheckpointFn checkpoint;
+		if (!options.screenshotDir.empty()) {
+			std::error_code error;
+			std::filesystem::create_directories(options.screenshotDir, error);
+			if (error) {
+				std::cerr << "Error: Failed to create screenshot directory " << options.screenshotDir << ": " << error.message() << '\n';
+				return 1;
+			}
+			screenshots.emplace(scene, options.screenshotDir, pool);
+			checkpoint = [&screenshots](const HeadlessCheckpoint& frame) { screenshots->capture(frame); };
+		}
+		const HeadlessStats stats = runHeadless(scene, trace, options.tickHz, options.repeat, profile, options.model,
+			noise, nullptr, checkpoint);
+
+		const double ticksPerSecond = (stats.wallSeconds > 0.0) ? static_cast<double>(stats.ticks) / stats.wallSeconds : 0.0;
+		std::cout << "ticks: " << stats.ticks
+			<< "\nwall time: " << stats.wallSeconds << " s"
+			<< "\nticks/s: " << ticksPerSecond
+			<< "\nbeeps: " << stats.beeps
+			<< "\noccupied ticks: " << stats.occupiedTicks
+			<< "\ncontact ticks: " << stats.contactTicks
+			<< "\nfinal pose: (" << stats.finalCar.position.x << ", " << stats.finalCar.position.y
+			<< ") heading " << stats.finalCar.headingDeg << " deg\n";
+		if (!options.stressScene.empty() && stats.ticks > 0U) {
+			// Sustained cost of one simulated frame at the tick rate, for comparing runs across scenes
+			std::cout << "simulation per tick: " << stats.wallSeconds * 1.0e6 / static_cast<double>(stats.ticks) << " us\n";
+		}
+		if (screenshots) {
+			const double msPerFrame = (screenshots->frames() > 0U)
+				? screenshots->seconds() * 1000.0 / static_cast<double>(screenshots->frames()) : 0.0;
+			std::cout << "screenshots: " << screenshots->frames() << " (" << msPerFrame << " ms per frame) -> "
+				<< options.screenshotDir << '\n';
+			return screenshots->failed() ? 1 : 0;
+		}
+		return 0;
+	}
+
+} // namespace sim
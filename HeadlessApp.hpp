@@ -0,0 +1,91 @@
+/*
+==============================================================================
+Headless App - the batch modes shared by the front-end and OKPP_LV1_headless
+==============================================================================
+ - Scene and warning profile loading from the command-line paths
+ - One entry point for the single-car run, the fleet run and the Monte-
+   Carlo evaluation; results go to stdout in the same key: value form
+ - With an events path, the fleet and evaluation runs also write their
+   entries, exits, near misses, contacts and beeps to a column-chunked
+   event file (EventLog) while they run
+ - With a screenshot directory, the single-car run draws a frame at
+   every replay checkpoint with the CPU rasterizer (SoftRasterizer) and
+   saves it as a PNG, so CI nodes without a GPU produce golden images
+ - With a golden directory, the checkpoints of every given replay are
+   painted concurrently, one replay per pool task, and compared with the
+   golden frames of an accepted run (GoldenImage); failing frames are
+   saved with a diff mask, and paint time per checkpoint is compared with
+   the golden run's, so one pass catches rendering and speed regressions
+ - With a dataset path, samples random lots and poses instead and writes
+   the ray-cast sensor records for model training (SensorDataset)
+ - With rig candidates, searches sensor mount angles and offsets for the
+   best coverage along the trace through a set of scenes (RigOptimizer)
+ - Depends on the simulation core only, so the headless runner links
+   without a window, audio or an OpenGL context
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Constants.hpp"
+#include "SensorNoise.hpp"
+#include "SimFwd.hpp"
+#include "VehicleDynamics.hpp"
+
+namespace sim {
+
+	struct HeadlessOptions {
+		float tickHz = constants::SIM_TICK_HZ;
+		std::string tracePath;            // built-in drive if empty
+		std::uint32_t repeat = 1U;        // trace passes
+		std::size_t fleetSize = 0U;       // 0 = single car
+		std::size_t evaluateTrials = 0U;  // > 0: Monte-Carlo evaluation instead of a drive
+		std::uint64_t seed = 1U;
+		float forkAt = 0.0F;              // evaluation trials fork this far into the script
+		VehicleModel model = VehicleModel::Arcade;
+		std::string scenarioPath;         // built-in scene if empty
+		std::string profilesPath;         // built-in warning profile if empty
+		std::string vehicle;              // profile name (first one if empty)
+		SensorNoiseConfig noise;          // drive and fleet runs; its seed is taken from seed
+		std::string eventsPath;           // fleet and evaluation event log (off if empty)
+		std::string script;               // fleet cars follow this drive script instead of the trace (DriveScript)
+		bool quantized = false;           // fleet sensors find pillars in 16-bit fixed-point tiles (QuantizedObstacles)
+		std::string screenshotDir;        // single-car runs: a PNG per trace segment end (off if empty)
+		std::string datasetPath;          // sensor training records instead of a drive (off if empty)
+		std::uint64_t datasetSamples = 0U;
+		std::size_t rigCandidates = 0U;   // > 0: sensor rig search instead of a drive, this many rigs per generation
+		std::uint32_t rigGenerations = 8U;
+		std::vector<std::string> rigScenarios; // scenes searched beside the loaded one
+		std::size_t regions = 0U;         // > 1: the fleet split into spatial regions that exchange messages (RegionFleet)
+		bool carSensing = false;          // fleet sensors see the other cars through a loose car grid
+		bool routing = false;             // fleet cars routed to free bays through the aisles every tick (AisleGraph)
+		std::string stressScene;          // built-in synthetic lot "name[:size[:spacing]]" (StressScenes; off if empty)
+		std::string goldenDir;            // golden frames of every replay checkpoint (off if empty)
+		bool updateGolden = false;        // write the golden frames instead of comparing with them
+		std::vector<std::string> goldenTraces; // further replays of a golden run, beside tracePath
+		std::uint8_t goldenTolerance = 0U;     // largest channel difference still counted as equal
+	};
+
+	/**
+	 * @brief The built-in scene, with the scenario or stress layout (StressScenes) in place of its own if one is given.
+	 *
+	 * MISRA: a scenario path and a stress spec together are refused (logged).
+	 */
+	[[nodiscard]] bool loadScene(const std::string& scenarioPath, Scene& scene, const std::string& stressScene = {});
+
+	/**
+	 * @brief The named warning profile from profilesPath, or the built-in default; false (logged) if it is missing.
+	 */
+	[[nodiscard]] bool loadWarningProfile(const std::string& profilesPath, const std::string& vehicle, WarningProfile& profile);
+
+	/**
+	 * @brief Runs the simulation without window or audio and prints throughput; returns the exit code.
+	 */
+	[[nodiscard]] int runHeadlessApp(const HeadlessOptions& options, ThreadPool& pool);
+
+} // namespace sim
@@ -0,0 +1,215 @@
+/*
+==============================================================================
+Headless runner - OKPP_LV1_headless
+==============================================================================
+ Usage: OKPP_LV1_headless [trace] [--repeat n] [--fleet n] [--threads t]
+        [--evaluate n] [--seed s] [--fork-at s] [--tick-hz n] [--bicycle]
+        [--noise px] [--dropout p] [--latency n]
+        [--scenario file] [--profiles file] [--vehicle name] [--chrome-trace [file]]
+        [--hw-counters] [--events file] [--script name] [--quantized]
+        [--screenshots dir] [--dataset file n] [--regions n] [--car-sensing] [--routing]
+        [--stress name[:size[:spacing]]] [--simd level]
+        [--golden dir] [--update-golden] [--golden-trace file] [--golden-tolerance n]
+        [--optimize-rig n] [--rig-generations n] [--rig-scenario file]
+ - The batch modes of the front-end's --headless, --fleet and --evaluate,
+   built on the simulation core alone: no window, audio or OpenGL context
+ - --events writes the fleet or evaluation events (entries, exits, near
+   misses, contacts, beeps) to a column-chunked binary file (EventLog)
+ - --script drives every fleet car from a coroutine drive script (lap,
+   shuttle, slalom) instead of the trace (DriveScript)
+ - --quantized has fleet sensors find pillars among 16-bit fixed-point
+   tile offsets with integer SIMD distances (QuantizedObstacles)
+ - --screenshots saves a PNG of the lot, car and sensors at the end of
+   every trace segment, drawn by a tiled CPU rasterizer (SoftRasterizer)
+ - --golden paints the checkpoints of the trace and of every --golden-trace
+   concurrently and compares them with the golden frames under dir (exit 1
+   on a difference); --update-golden writes those frames instead
+ - --dataset writes n ray-cast sensor records over random lots and poses
+   for training sensor models, in a column-blocked binary file (SensorDataset)
+ - --optimize-rig scores n candidate sensor rigs per generation (turned
+   and pushed out around the profile's) by cone coverage and blind spots
+   along the trace through the scene and every --rig-scenario, and prints
+   the best as profile "sensor" lines (RigOptimizer)
+ - --regions splits the fleet's lot into n strips, each simulated on its
+   own with car hand-offs and halo pillars passed as messages (RegionFleet)
+ - --car-sensing lets fleet sensors see the other cars, each filed in a
+   loose grid that is only updated when it crosses a cell (LooseGrid)
+ - --routing routes every fleet car to its nearest free bay each tick over
+   an aisle graph with per-aisle congestion and a route cache (AisleGraph)
+ - --stress replaces the lot with a built-in synthetic stress scene
+   (pillar-grid, random, corridors, dense-bays) and reports its size and
+   the sustained simulation cost per tick (StressScenes)
+ - --hw-counters logs cache misses and branch mispredicts of the sensor
+   and beep scopes after the run (HardwareCounters)
+ - --simd pins the dispatched kernels to scalar, sse2, avx2, avx512 or neon
+   instead of the widest the CPU runs (CpuFeatures); results are the same
+==============================================================================
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "CpuFeatures.hpp"
+#include "HardwareCounters.hpp"
+#include "HeadlessApp.hpp"
+#include "Log.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+int main(int argc, char* argv[]) {
+	sim::HeadlessOptions options;
+	std::size_t threads = 0U;
+	std::string chromeTracePath;
+	bool hwCounters = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg(argv[i]);
+		if (arg == "--repeat" && (i + 1) < argc) {
+			const unsigned long repeat = std::strtoul(argv[++i], nullptr, 10);
+			options.repeat = (repeat > 0UL) ? static_cast<std::uint32_t>(repeat) : 1U;
+		}
+		else if (arg == "--fleet" && (i + 1) < argc) {
+			options.fleetSize = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--threads" && (i + 1) < argc) {
+			threads = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--evaluate" && (i + 1) < argc) {
+			options.evaluateTrials = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--seed" && (i + 1) < argc) {
+			options.seed = static_cast<std::uint64_t>(std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--noise" && (i + 1) < argc) {
+			options.noise.sigma = std::max(std::strtof(argv[++i], nullptr), 0.0F);
+		}
+		else if (arg == "--dropout" && (i + 1) < argc) {
+			options.noise.dropout = std::clamp(std::strtof(argv[++i], nullptr), 0.0F, 1.0F);
+		}
+		else if (arg == "--latency" && (i + 1) < argc) {
+			options.noise.latency = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--fork-at" && (i + 1) < argc) {
+			options.forkAt = std::max(std::strtof(argv[++i], nullptr), 0.0F);
+		}
+		else if (arg == "--tick-hz" && (i + 1) < argc) {
+			const float hz = std::strtof(argv[++i], nullptr);
+			if (hz > 0.0F) {
+				options.tickHz = hz;
+			}
+			else {
+				std::cerr << "Warning: invalid --tick-hz value, keeping " << options.tickHz << '\n';
+			}
+		}
+		else if (arg == "--bicycle") {
+			options.model = sim::VehicleModel::Bicycle;
+		}
+		else if (arg == "--scenario" && (i + 1) < argc) {
+			options.scenarioPath = argv[++i];
+		}
+		else if (arg == "--profiles" && (i + 1) < argc) {
+			options.profilesPath = argv[++i];
+		}
+		else if (arg == "--vehicle" && (i + 1) < argc) {
+			options.vehicle = argv[++i];
+		}
+		else if (arg == "--chrome-trace") {
+			chromeTracePath = "trace.json";
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				chromeTracePath = argv[++i];
+			}
+		}
+		else if (arg == "--hw-counters") {
+			hwCounters = true;
+		}
+		else if (arg == "--events" && (i + 1) < argc) {
+			options.eventsPath = argv[++i];
+		}
+		else if (arg == "--script" && (i + 1) < argc) {
+			options.script = argv[++i];
+		}
+		else if (arg == "--quantized") {
+			options.quantized = true;
+		}
+		else if (arg == "--screenshots" && (i + 1) < argc) {
+			options.screenshotDir = argv[++i];
+		}
+		else if (arg == "--dataset" && (i + 2) < argc) {
+			options.datasetPath = argv[++i];
+			options.datasetSamples = static_cast<std::uint64_t>(std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--optimize-rig" && (i + 1) < argc) {
+			options.rigCandidates = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--rig-generations" && (i + 1) < argc) {
+			options.rigGenerations = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--rig-scenario" && (i + 1) < argc) {
+			options.rigScenarios.emplace_back(argv[++i]);
+		}
+		else if (arg == "--regions" && (i + 1) < argc) {
+			options.regions = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--stress" && (i + 1) < argc) {
+			options.stressScene = argv[++i];
+		}
+		else if (arg == "--golden" && (i + 1) < argc) {
+			options.goldenDir = argv[++i];
+		}
+		else if (arg == "--update-golden") {
+			options.updateGolden = true;
+		}
+		else if (arg == "--golden-trace" && (i + 1) < argc) {
+			options.goldenTraces.emplace_back(argv[++i]);
+		}
+		else if (arg == "--golden-tolerance" && (i + 1) < argc) {
+			options.goldenTolerance = static_cast<std::uint8_t>(std::min(std::strtoul(argv[++i], nullptr, 10), 255UL));
+		}
+		else if (arg == "--car-sensing") {
+			options.carSensing = true;
+		}
+		else if (arg == "--routing") {
+			options.routing = true;
+		}
+		else if (arg == "--simd" && (i + 1) < argc) {
+			sim::SimdLevel level = sim::SimdLevel::Scalar;
+			const std::string_view name(argv[++i]);
+			if (!sim::parseSimdLevel(name, level) || !sim::setSimdLevel(level)) {
+				std::cerr << "Error: SIMD level " << name << " is unknown or not supported here\n";
+				return 1;
+			}
+		}
+		else if (arg == "--headless") {
+			// Accepted for command lines copied from the front-end
+		}
+		else if (arg.rfind("--", 0) != 0U && options.tracePath.empty()) {
+			options.tracePath = std::string(arg);
+		}
+		else {
+			std::cerr << "Warning: ignoring unknown argument " << arg << '\n';
+		}
+	}
+
+	sim::setSharedPoolThreads(threads);
+	if (!chromeTracePath.empty()) {
+		prof::startTracing(chromeTracePath);
+		prof::setThreadName("main");
+	}
+	logging::startLogging();
+	hwCounters = hwCounters && prof::startHwCounters();
+
+	const int result = sim::runHeadlessApp(options, sim::sharedPool());
+
+	if (hwCounters) {
+		prof::logHwCounterReport();
+	}
+	logging::stopLogging();
+	if (!chromeTracePath.empty()) {
+		(void)prof::stopTracing();
+	}
+	return result;
+}
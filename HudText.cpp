@@ -0,0 +1,134 @@
+#include "HudText.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iostream>
+
+#include "PixelFont.hpp"
+
+namespace gfx {
+
+	namespace {
+		// Atlas cells leave a blank column and row after each glyph, so nearest
+		// sampling at a quad edge never picks up the neighbour
+		constexpr unsigned GLYPH_CELL_WIDTH = PIXEL_GLYPH_WIDTH + 1;
+		constexpr unsigned GLYPH_CELL_HEIGHT = PIXEL_GLYPH_HEIGHT + 1;
+		constexpr std::size_t VERTICES_PER_GLYPH = 6U;
+	}
+
+	LabelText& LabelText::operator<<(std::string_view text) noexcept {
+		const std::size_t count = std::min(text.size(), CAPACITY - m_length);
+		std::copy_n(text.data(), count, m_chars.data() + m_length);
+		m_length += count;
+		return *this;
+	}
+
+	LabelText& LabelText::operator<<(long value) noexcept {
+		char* const begin = m_chars.data() + m_length;
+		const std::to_chars_result result = std::to_chars(begin, m_chars.data() + CAPACITY, value);
+		if (result.ec == std::errc{}) {
+			m_length = static_cast<std::size_t>(result.ptr - m_chars.data());
+		}
+		return *this;
+	}
+
+	bool HudText::create(float pixelSize) {
+		const std::size_t glyphs = pixelGlyphCount();
+		sf::Image image({ GLYPH_CELL_WIDTH * static_cast<unsigned>(glyphs), GLYPH_CELL_HEIGHT }, sf::Color::Transparent);
+		m_glyphOf.fill(-1);
+		for (std::size_t i = 0U; i < glyphs; ++i) {
+			const PixelGlyph& glyph = pixelGlyph(i);
+			for (int p = 0; p < PIXEL_GLYPH_WIDTH * PIXEL_GLYPH_HEIGHT; ++p) {
+				if (glyph.rows[p] == '1') {
+					image.setPixel({ static_cast<unsigned>(i) * GLYPH_CELL_WIDTH + static_cast<unsigned>(p % PIXEL_GLYPH_WIDTH),
+						static_cast<unsigned>(p / PIXEL_GLYPH_WIDTH) }, sf::Color::White);
+				}
+			}
+			m_glyphOf[static_cast<unsigned char>(glyph.c) & 0x7FU] = static_cast<std::int16_t>(i);
+		}
+		if (!m_atlas.loadFromImage(image)) {
+			std::cerr << "Error: Failed to create the HUD glyph atlas\n";
+			return false;
+		}
+		m_atlas.setSmooth(false);
+		m_atlasCharge.set(prof::rgbaTextureBytes(m_atlas.getSize().x, m_atlas.getSize().y));
+		m_pixelSize = pixelSize;
+		m_useBuffers = sf::VertexBuffer::isAvailable();
+		return true;
+	}
+
+	std::size_t HudText::addLabel(sf::Color color) {
+		Label& label = m_labels.emplace_back();
+		label.color = color;
+		label.vertices.resize(MAX_LABEL_CHARS * VERTICES_PER_GLYPH);
+		if (m_useBuffers && !label.buffer.create(label.vertices.size())) {
+			std::cerr << "Warning: HUD label vertex buffer unavailable, drawing from client memory\n";
+			m_useBuffers = false;
+		}
+		m_bufferCharge.set(m_bufferCharge.bytes() + label.buffer.getVertexCount() * sizeof(sf::Vertex));
+		return m_labels.size() - 1U;
+	}
+
+	void HudText::setText(std::size_t label, std::string_view text) {
+		Label& target = m_labels[label];
+		text = text.substr(0U, MAX_LABEL_CHARS);
+		if (std::string_view(target.text.data(), target.length) == text) {
+			return;
+		}
+		std::copy(text.begin(), text.end(), target.text.begin());
+		target.length = text.size();
+		rebuild(target);
+	}
+
+	void HudText::setPosition(std::size_t label, const sf::Vector2f& position) {
+		m_labels[label].transform = sf::Transform::Identity;
+		m_labels[label].transform.translate(position);
+	}
+
+	void HudText::rebuild(Label& label) {
+		const sf::Vector2f quad{ static_cast<float>(PIXEL_GLYPH_WIDTH) * m_pixelSize,
+			static_cast<float>(PIXEL_GLYPH_HEIGHT) * m_pixelSize };
+		const float advance = static_cast<float>(GLYPH_CELL_WIDTH) * m_pixelSize;
+
+		label.vertexCount = 0U;
+		for (std::size_t i = 0U; i < label.length; ++i) {
+			const auto c = static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(label.text[i])));
+			const std::int16_t cell = m_glyphOf[c & 0x7FU];
+			if (cell < 0) {
+				continue; // blank
+			}
+			const sf::Vector2f pen{ static_cast<float>(i) * advance, 0.0F };
+			const sf::Vector2f tex{ static_cast<float>(static_cast<unsigned>(cell) * GLYPH_CELL_WIDTH), 0.0F };
+			const sf::Vector2f texSize{ static_cast<float>(PIXEL_GLYPH_WIDTH), static_cast<float>(PIXEL_GLYPH_HEIGHT) };
+			const sf::Vector2f corners[4] = { pen, pen + sf::Vector2f{ quad.x, 0.0F }, pen + quad, pen + sf::Vector2f{ 0.0F, quad.y } };
+			const sf::Vector2f texCorners[4] = { tex, tex + sf::Vector2f{ texSize.x, 0.0F }, tex + texSize, tex + sf::Vector2f{ 0.0F, texSize.y } };
+			for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+				label.vertices[label.vertexCount++] = sf::Vertex{ corners[corner], label.color, texCorners[corner] };
+			}
+		}
+		if (m_useBuffers && label.vertexCount > 0U && !label.buffer.update(label.vertices.data(), label.vertexCount, 0U)) {
+			std::cerr << "Warning: HUD label upload failed, drawing from client memory\n";
+			m_useBuffers = false;
+		}
+		++m_rebuilds;
+	}
+
+	void HudText::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		states.texture = &m_atlas;
+		const sf::Transform parent = states.transform;
+		for (const Label& label : m_labels) {
+			if (label.vertexCount == 0U) {
+				continue;
+			}
+			states.transform = parent * label.transform;
+			if (m_useBuffers) {
+				target.draw(label.buffer, 0U, label.vertexCount, states);
+			}
+			else {
+				target.draw(label.vertices.data(), label.vertexCount, sf::PrimitiveType::Triangles, states);
+			}
+		}
+	}
+
+} // namespace gfx
@@ -0,0 +1,105 @@
+/*
+==============================================================================
+HUD Text - labels from a cached glyph atlas in persistent vertex buffers
+==============================================================================
+ - The 3x5 pixel font is rasterized once into a small glyph atlas texture;
+   every glyph is then one textured quad, not one quad per lit pixel
+ - Each label owns a vertex buffer sized for MAX_LABEL_CHARS glyphs; its
+   geometry is rebuilt only when the string changes, and moving a label
+   only changes its transform
+ - LabelText formats numbers with std::to_chars into a fixed buffer, so
+   refreshing a label every frame never touches the heap
+ - Falls back to client-side vertex arrays where vertex buffers are missing
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+
+namespace gfx {
+
+	/**
+	 * @brief A label string built in place: text pieces and integers, truncated at capacity.
+	 */
+	class LabelText {
+	public:
+		static constexpr std::size_t CAPACITY = 24U;
+
+		LabelText& operator<<(std::string_view text) noexcept;
+		LabelText& operator<<(long value) noexcept;
+
+		[[nodiscard]] std::string_view view() const noexcept { return { m_chars.data(), m_length }; }
+		void clear() noexcept { m_length = 0U; }
+
+	private:
+		std::array<char, CAPACITY> m_chars{};
+		std::size_t m_length = 0U;
+	};
+
+	class HudText : public sf::Drawable {
+	public:
+		static constexpr std::size_t MAX_LABEL_CHARS = LabelText::CAPACITY;
+
+		/**
+		 * @brief Builds the glyph atlas; glyphs are drawn pixelSize units per font pixel.
+		 *
+		 * Requires an active GL context. Returns false (and logs) if the atlas
+		 * texture cannot be created.
+		 */
+		[[nodiscard]] bool create(float pixelSize);
+
+		/**
+		 * @brief Adds an empty label and returns its index.
+		 */
+		[[nodiscard]] std::size_t addLabel(sf::Color color);
+
+		/**
+		 * @brief Sets a label's string; the geometry is rebuilt only if it differs.
+		 *
+		 * Characters past MAX_LABEL_CHARS are dropped; lower case is shown as upper case.
+		 */
+		void setText(std::size_t label, std::string_view text);
+
+		/**
+		 * @brief Moves a label's top-left corner; its geometry is kept.
+		 */
+		void setPosition(std::size_t label, const sf::Vector2f& position);
+
+		[[nodiscard]] std::size_t labelCount() const noexcept { return m_labels.size(); }
+		[[nodiscard]] std::uint64_t rebuilds() const noexcept { return m_rebuilds; }
+
+	private:
+		struct Label {
+			std::array<char, MAX_LABEL_CHARS> text{};
+			std::size_t length = 0U;
+			sf::Color color;
+			sf::Transform transform;
+			sf::VertexBuffer buffer{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Dynamic };
+			std::vector<sf::Vertex> vertices; // the buffer's contents, drawn directly without buffers
+			std::size_t vertexCount = 0U;
+		};
+
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+		void rebuild(Label& label);
+
+		sf::Texture m_atlas;
+		prof::MemoryCharge m_atlasCharge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Video };
+		prof::MemoryCharge m_bufferCharge{ prof::MemorySubsystem::RenderBuffers, prof::MemoryKind::Video }; // all labels
+		std::array<std::int16_t, 128> m_glyphOf{}; // atlas cell per ASCII character, -1 if blank
+		float m_pixelSize = 1.0F;
+		bool m_useBuffers = false;
+		std::deque<Label> m_labels; // stable, labels own GL buffers
+		std::uint64_t m_rebuilds = 0U;
+	};
+
+} // namespace gfx
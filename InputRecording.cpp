@@ -0,0 +1,154 @@
+#include "InputRecording.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace sim {
+
+	namespace {
+		constexpr char RECORDING_MAGIC[8] = { 'O', 'K', 'R', 'E', 'C', '0', '0', '1' };
+		constexpr std::size_t FRAME_BYTES = sizeof(float) + sizeof(CarInput);
+		constexpr std::uint16_t FRAME_FIELDS = 2U; // dt bits, input
+
+		[[nodiscard]] bool isBlockLogFile(const std::string& path) {
+			std::ifstream file(path, std::ios::binary);
+			char magic[sizeof(RECORDING_MAGIC)] = {};
+			file.read(magic, sizeof(magic));
+			return file && std::memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0;
+		}
+	}
+
+	bool saveInputRecording(const std::string& path, const InputRecording& recording) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: Failed to create input recording " << path << '\n';
+			return false;
+		}
+
+		// Frames are packed without struct padding: 5 bytes each
+		std::vector<char> frames(recording.frames.size() * FRAME_BYTES);
+		char* out = frames.data();
+		for (const auto& frame : recording.frames) {
+			std::memcpy(out, &frame.dt, sizeof(frame.dt));
+			std::memcpy(out + sizeof(frame.dt), &frame.input, sizeof(frame.input));
+			out += FRAME_BYTES;
+		}
+
+		const auto frameCount = static_cast<std::uint32_t>(recording.frames.size());
+		file.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+		file.write(reinterpret_cast<const char*>(&recording.tickHz), sizeof(recording.tickHz));
+		file.write(reinterpret_cast<const char*>(&frameCount), sizeof(frameCount));
+		file.write(frames.data(), static_cast<std::streamsize>(frames.size()));
+		if (!file) {
+			std::cerr << "Error: Failed to write input recording " << path << '\n';
+			return false;
+		}
+		return true;
+	}
+
+	bool loadInputRecording(const std::string& path, InputRecording& recording) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			std::cerr << "Error: Failed to open input recording " << path << '\n';
+			return false;
+		}
+
+		char magic[sizeof(RECORDING_MAGIC)] = {};
+		float tickHz = 0.0F;
+		std::uint32_t frameCount = 0U;
+		file.read(magic, sizeof(magic));
+		file.read(reinterpret_cast<char*>(&tickHz), sizeof(tickHz));
+		file.read(reinterpret_cast<char*>(&frameCount), sizeof(frameCount));
+		if (!file || std::memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0 || !(tickHz > 0.0F)) {
+			std::cerr << "Error: " << path << " is not an input recording\n";
+			return false;
+		}
+
+		// Check the size before allocating, so a corrupt count cannot ask for gigabytes
+		const std::streampos start = file.tellg();
+		file.seekg(0, std::ios::end);
+		const std::streamoff available = file.tellg() - start;
+		file.seekg(start);
+		std::vector<char> frames;
+		if (available >= static_cast<std::streamoff>(static_cast<std::uint64_t>(frameCount) * FRAME_BYTES)) {
+			frames.resize(static_cast<std::size_t>(frameCount) * FRAME_BYTES);
+			file.read(frames.data(), static_cast<std::streamsize>(frames.size()));
+		}
+		if (!file || frames.size() != static_cast<std::size_t>(frameCount) * FRAME_BYTES) {
+			std::cerr << "Error: input recording " << path << " is truncated\n";
+			return false;
+		}
+
+		recording.tickHz = tickHz;
+		recording.frames.resize(frameCount);
+		const char* in = frames.data();
+		for (auto& frame : recording.frames) {
+			std::memcpy(&frame.dt, in, sizeof(frame.dt));
+			std::memcpy(&frame.input, in + sizeof(frame.dt), sizeof(frame.input));
+			in += FRAME_BYTES;
+		}
+		return true;
+	}
+
+	bool InputRecordingWriter::open(const std::string& path, float tickHz) {
+		std::uint32_t tag = 0U;
+		std::memcpy(&tag, &tickHz, sizeof(tag));
+		return m_log.open(path, io::BLOCK_LOG_DRIVE, FRAME_FIELDS, tag);
+	}
+
+	void InputRecordingWriter::append(const RecordedFrame& frame) noexcept {
+		std::uint32_t fields[FRAME_FIELDS] = { 0U, frame.input };
+		std::memcpy(&fields[0], &frame.dt, sizeof(frame.dt));
+		m_log.append(fields);
+	}
+
+	bool InputRecordingWriter::close() {
+		return m_log.close();
+	}
+
+	bool InputRecordingReader::open(const std::string& path) {
+		m_blockLog = isBlockLogFile(path);
+		if (!m_blockLog) {
+			if (!loadInputRecording(path, m_whole)) {
+				return false;
+			}
+			m_tickHz = m_whole.tickHz;
+			return true;
+		}
+
+		if (!m_log.open(path, io::BLOCK_LOG_DRIVE)) {
+			return false;
+		}
+		const std::uint32_t tag = m_log.tag();
+		std::memcpy(&m_tickHz, &tag, sizeof(m_tickHz));
+		if (m_log.fields() != FRAME_FIELDS || !(m_tickHz > 0.0F)) {
+			std::cerr << "Error: " << path << " is not an input recording\n";
+			return false;
+		}
+		return true;
+	}
+
+	std::uint64_t InputRecordingReader::frameCount() const noexcept {
+		return m_blockLog ? m_log.recordCount() : m_whole.frames.size();
+	}
+
+	bool InputRecordingReader::frame(std::uint64_t index, RecordedFrame& frame) {
+		if (!m_blockLog) {
+			if (index >= m_whole.frames.size()) {
+				return false;
+			}
+			frame = m_whole.frames[static_cast<std::size_t>(index)];
+			return true;
+		}
+
+		std::uint32_t fields[FRAME_FIELDS] = {};
+		if (!m_log.read(index, fields)) {
+			return false;
+		}
+		std::memcpy(&frame.dt, &fields[0], sizeof(frame.dt));
+		frame.input = static_cast<CarInput>(fields[1]);
+		return true;
+	}
+
+} // namespace sim
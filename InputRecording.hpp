@@ -0,0 +1,104 @@
+/*
+==============================================================================
+Input Recording - per-frame driver input and frame time of an interactive run
+==============================================================================
+ - --record <file> captures what the main loop fed the simulation each
+   frame: the clamped frame time and the driving input bitmask
+ - --replay <file> feeds the recording back instead of the clock and the
+   keyboard, so the same drive runs tick for tick on every build and can be
+   benchmarked and profiled against earlier ones
+ - Binary format (little-endian): "OKREC001", float tick rate, uint32 frame
+   count, then 5 bytes per frame (float seconds, uint8 input bits)
+ - --record streams into a block log instead (BlockLog.hpp, kind
+   BLOCK_LOG_DRIVE, the tick rate as its tag, two fields per frame: the
+   frame time's bits and the input): a repeated frame time and input cost
+   next to nothing, and nothing of the drive is held in memory.
+   InputRecordingReader replays either format, the block log one block at
+   a time
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BlockLog.hpp"
+#include "CarModel.hpp"
+
+namespace sim {
+
+	struct RecordedFrame {
+		float dt = 0.0F;    // clamped frame time added to the tick accumulator
+		CarInput input = 0U;
+	};
+
+	struct InputRecording {
+		float tickHz = 0.0F; // simulation rate the drive was recorded at
+		std::vector<RecordedFrame> frames;
+	};
+
+	/**
+	 * @brief Writes the recording; returns false and logs on I/O errors.
+	 */
+	[[nodiscard]] bool saveInputRecording(const std::string& path, const InputRecording& recording);
+
+	/**
+	 * @brief Reads a recording written by saveInputRecording(); returns false and logs on errors.
+	 */
+	[[nodiscard]] bool loadInputRecording(const std::string& path, InputRecording& recording);
+
+	/**
+	 * @brief Streams a drive into a block log as it is driven.
+	 */
+	class InputRecordingWriter {
+	public:
+		/**
+		 * @brief Creates the file; false (logged) if it cannot be written.
+		 */
+		[[nodiscard]] bool open(const std::string& path, float tickHz);
+
+		/**
+		 * @brief MISRA: no allocation; a full block is written on the way.
+		 */
+		void append(const RecordedFrame& frame) noexcept;
+
+		/**
+		 * @brief Writes what is buffered and the seek index; false on I/O failure.
+		 */
+		bool close();
+
+		[[nodiscard]] std::uint64_t frameCount() const noexcept { return m_log.stats().records; }
+		[[nodiscard]] const io::BlockLogStats& stats() const noexcept { return m_log.stats(); }
+
+	private:
+		io::BlockLogWriter m_log;
+	};
+
+	/**
+	 * @brief Random access to the frames of a recording in either format.
+	 */
+	class InputRecordingReader {
+	public:
+		/**
+		 * @brief Opens a block log recording, or loads an "OKREC001" one whole; false (logged) on errors.
+		 */
+		[[nodiscard]] bool open(const std::string& path);
+
+		[[nodiscard]] float tickHz() const noexcept { return m_tickHz; }
+		[[nodiscard]] std::uint64_t frameCount() const noexcept;
+
+		/**
+		 * @brief Frame index; false (logged) past the end or in a block that does not decode.
+		 */
+		[[nodiscard]] bool frame(std::uint64_t index, RecordedFrame& frame);
+
+	private:
+		float m_tickHz = 0.0F;
+		bool m_blockLog = false;
+		io::BlockLogReader m_log;
+		InputRecording m_whole; // the "OKREC001" format
+	};
+
+} // namespace sim
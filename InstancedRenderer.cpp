@@ -0,0 +1,210 @@
+#include "InstancedRenderer.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+namespace gfx {
+
+	namespace {
+		constexpr float PI = 3.14159265358979323846F;
+		constexpr float DEG_TO_RAD = PI / 180.0F;
+
+		constexpr const char* VERTEX_SHADER = R"(
+#version 130
+in vec2 a_corner;
+in vec3 a_circle;
+in vec2 a_arc;
+in vec4 a_color;
+uniform mat4 u_viewProj;
+out vec2 v_local;
+out vec2 v_arc;
+out vec4 v_color;
+void main() {
+	v_local = a_corner;
+	v_arc = a_arc;
+	v_color = a_color;
+	vec2 world = a_circle.xy + a_corner * a_circle.z;
+	gl_Position = u_viewProj * vec4(world, 0.0, 1.0);
+}
+)";
+
+		constexpr const char* FRAGMENT_SHADER = R"(
+#version 130
+in vec2 v_local;
+in vec2 v_arc;
+in vec4 v_color;
+void main() {
+	if (dot(v_local, v_local) > 1.0) {
+		discard;
+	}
+	if (v_arc.y < 3.14159265) {
+		float a = atan(v_local.y, v_local.x) - v_arc.x;
+		a = mod(a + 3.14159265, 6.28318531) - 3.14159265;
+		if (abs(a) > v_arc.y) {
+			discard;
+		}
+	}
+	gl_FragColor = v_color;
+}
+)";
+
+		constexpr const char* ATTRIBUTES[] = { "a_corner", "a_circle", "a_arc", "a_color" };
+
+		[[nodiscard]] gl::ProcAddress sfmlLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+
+		void setColor(CircleInstance& instance, sf::Color color) {
+			instance.color[0] = color.r;
+			instance.color[1] = color.g;
+			instance.color[2] = color.b;
+			instance.color[3] = color.a;
+		}
+	}
+
+	CircleInstance makeObstacleInstance(const sim::Obstacle& obstacle, sf::Color color) {
+		CircleInstance instance;
+		instance.center = obstacle.center;
+		instance.radius = obstacle.radius;
+		setColor(instance, color);
+		return instance;
+	}
+
+	CircleInstance makeSensorInstance(const sim::SensorPose& sensor, sf::Color color) {
+		// A rotated sensor rectangle extends along its local +Y axis
+		CircleInstance instance;
+		instance.center = sensor.position;
+		instance.radius = sensor.extent.y;
+		instance.headingRad = (sensor.rotationDeg + 90.0F) * DEG_TO_RAD;
+		instance.halfAngleRad = std::atan2(sensor.extent.x * 0.5F, sensor.extent.y);
+		setColor(instance, color);
+		return instance;
+	}
+
+	GLuint buildCircleProgram() {
+		if (!gl::loaded() && !gl::load(&sfmlLoader)) {
+			return 0U;
+		}
+		return gl::buildProgram(VERTEX_SHADER, FRAGMENT_SHADER, ATTRIBUTES, std::size(ATTRIBUTES));
+	}
+
+	GLuint createCircleQuad() {
+		constexpr GLfloat QUAD[] = { -1.0F, -1.0F, 1.0F, -1.0F, -1.0F, 1.0F, 1.0F, 1.0F };
+
+		const gl::Api& api = gl::api();
+		GLuint buffer = 0U;
+		api.GenBuffers(1, &buffer);
+		api.BindBuffer(gl::ARRAY_BUFFER, buffer);
+		api.BufferData(gl::ARRAY_BUFFER, sizeof(QUAD), QUAD, gl::STATIC_DRAW);
+		api.BindBuffer(gl::ARRAY_BUFFER, 0U);
+		return buffer;
+	}
+
+	void bindCircleAttributes(GLuint quadBuffer, GLuint instanceBuffer) {
+		const gl::Api& api = gl::api();
+		api.BindBuffer(gl::ARRAY_BUFFER, quadBuffer);
+		api.EnableVertexAttribArray(0U);
+		api.VertexAttribPointer(0U, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+		api.BindBuffer(gl::ARRAY_BUFFER, instanceBuffer);
+
+		constexpr GLsizei STRIDE = sizeof(CircleInstance);
+		const auto offset = [](std::size_t bytes) { return reinterpret_cast<const void*>(bytes); };
+
+		api.EnableVertexAttribArray(1U);
+		api.VertexAttribPointer(1U, 3, GL_FLOAT, GL_FALSE, STRIDE, offset(offsetof(CircleInstance, center)));
+		api.VertexAttribDivisor(1U, 1U);
+
+		api.EnableVertexAttribArray(2U);
+		api.VertexAttribPointer(2U, 2, GL_FLOAT, GL_FALSE, STRIDE, offset(offsetof(CircleInstance, headingRad)));
+		api.VertexAttribDivisor(2U, 1U);
+
+		api.EnableVertexAttribArray(3U);
+		api.VertexAttribPointer(3U, 4, GL_UNSIGNED_BYTE, GL_TRUE, STRIDE, offset(offsetof(CircleInstance, color)));
+		api.VertexAttribDivisor(3U, 1U);
+
+		api.BindBuffer(gl::ARRAY_BUFFER, 0U);
+	}
+
+	InstancedRenderer::~InstancedRenderer() {
+		if (!gl::loaded()) {
+			return;
+		}
+		const gl::Api& api = gl::api();
+		if (m_instanceBuffer != 0U) { api.DeleteBuffers(1, &m_instanceBuffer); }
+		if (m_quadBuffer != 0U) { api.DeleteBuffers(1, &m_quadBuffer); }
+		if (m_vao != 0U) { api.DeleteVertexArrays(1, &m_vao); }
+		if (m_program != 0U) { api.DeleteProgram(m_program); }
+	}
+
+	bool InstancedRenderer::init() {
+		m_program = buildCircleProgram();
+		if (m_program == 0U) {
+			return false;
+		}
+
+		const gl::Api& api = gl::api();
+		m_viewProjLocation = api.GetUniformLocation(m_program, "u_viewProj");
+
+		api.GenVertexArrays(1, &m_vao);
+		api.BindVertexArray(m_vao);
+		m_quadBuffer = createCircleQuad();
+		api.GenBuffers(1, &m_instanceBuffer);
+		bindCircleAttributes(m_quadBuffer, m_instanceBuffer);
+		api.BindVertexArray(0U);
+		return true;
+	}
+
+	void InstancedRenderer::upload(const std::vector<CircleInstance>& instances) {
+		if (m_program == 0U) {
+			return;
+		}
+
+		const gl::Api& api = gl::api();
+		api.BindBuffer(gl::ARRAY_BUFFER, m_instanceBuffer);
+		// Orphan first so the driver never stalls on a buffer still in flight
+		api.BufferData(gl::ARRAY_BUFFER, static_cast<gl::SizeiPtr>(instances.size() * sizeof(CircleInstance)),
+			nullptr, gl::DYNAMIC_DRAW);
+		api.BufferSubData(gl::ARRAY_BUFFER, 0, static_cast<gl::SizeiPtr>(instances.size() * sizeof(CircleInstance)),
+			instances.data());
+		api.BindBuffer(gl::ARRAY_BUFFER, 0U);
+		m_count = instances.size();
+		m_videoCharge.set(m_count * sizeof(CircleInstance));
+	}
+
+	void InstancedRenderer::updateRange(std::size_t first, const CircleInstance* data, std::size_t count) {
+		if (m_program == 0U || count == 0U || first + count > m_count) {
+			return;
+		}
+
+		const gl::Api& api = gl::api();
+		api.BindBuffer(gl::ARRAY_BUFFER, m_instanceBuffer);
+		api.BufferSubData(gl::ARRAY_BUFFER, static_cast<gl::IntPtr>(first * sizeof(CircleInstance)),
+			static_cast<gl::SizeiPtr>(count * sizeof(CircleInstance)), data);
+		api.BindBuffer(gl::ARRAY_BUFFER, 0U);
+	}
+
+	void InstancedRenderer::draw(sf::RenderTarget& target) {
+		if (m_program == 0U || m_count == 0U) {
+			return;
+		}
+		if (!target.setActive(true)) {
+			return;
+		}
+
+		const gl::Api& api = gl::api();
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		api.UseProgram(m_program);
+		api.UniformMatrix4fv(m_viewProjLocation, 1, GL_FALSE, target.getView().getTransform().getMatrix());
+		api.BindVertexArray(m_vao);
+		api.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_count));
+		api.BindVertexArray(0U);
+		api.UseProgram(0U);
+
+		target.resetGLStates();
+	}
+
+} // namespace gfx
@@ -0,0 +1,106 @@
+/*
+==============================================================================
+Instanced Renderer - OpenGL instanced circles and sensor wedges
+==============================================================================
+ - One static unit quad, one per-instance buffer (center, radius, arc, color)
+ - Every instance is drawn by a single glDrawArraysInstanced call, so CPU
+   cost per frame does not grow with the instance count
+ - Circles are shaded analytically in the fragment shader; an arc narrower
+   than PI turns a circle into a sensor wedge
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlFunctions.hpp"
+#include "MemoryAccounting.hpp"
+#include "SimTypes.hpp"
+
+namespace gfx {
+
+	// Per-instance record, uploaded to the GPU as-is
+	struct CircleInstance {
+		sf::Vector2f center{ 0.0F, 0.0F };
+		float radius = 0.0F;
+		float headingRad = 0.0F;   // wedge direction
+		float halfAngleRad = 4.0F; // >= PI draws a full circle
+		std::uint8_t color[4] = { 255U, 255U, 255U, 255U };
+	};
+
+	static_assert(sizeof(CircleInstance) == 24U, "CircleInstance layout is shared with the vertex shader");
+
+	[[nodiscard]] CircleInstance makeObstacleInstance(const sim::Obstacle& obstacle, sf::Color color);
+	[[nodiscard]] CircleInstance makeSensorInstance(const sim::SensorPose& sensor, sf::Color color);
+
+	/**
+	 * @brief Builds the circle and wedge program shared by the instanced renderers.
+	 *
+	 * Loads the GL entry points first if needed. Returns 0 on failure.
+	 */
+	[[nodiscard]] GLuint buildCircleProgram();
+
+	/**
+	 * @brief Creates the static unit quad every circle instance is drawn from.
+	 */
+	[[nodiscard]] GLuint createCircleQuad();
+
+	/**
+	 * @brief Points the bound vertex array at the unit quad (attribute 0) and
+	 *        at the CircleInstance records of instanceBuffer (attributes 1-3).
+	 */
+	void bindCircleAttributes(GLuint quadBuffer, GLuint instanceBuffer);
+
+	class InstancedRenderer {
+	public:
+		InstancedRenderer() = default;
+		~InstancedRenderer();
+
+		InstancedRenderer(const InstancedRenderer&) = delete;
+		InstancedRenderer& operator=(const InstancedRenderer&) = delete;
+
+		/**
+		 * @brief Loads the GL entry points and builds the shader program.
+		 *
+		 * Requires the target window's context to be active. Returns false if
+		 * the driver lacks instancing; callers fall back to the SFML renderer.
+		 */
+		[[nodiscard]] bool init();
+
+		/**
+		 * @brief Replaces all instances (buffer is orphaned and refilled).
+		 */
+		void upload(const std::vector<CircleInstance>& instances);
+
+		/**
+		 * @brief Overwrites instances [first, first + count) in place.
+		 *
+		 * The range must lie inside the last upload().
+		 */
+		void updateRange(std::size_t first, const CircleInstance* data, std::size_t count);
+
+		/**
+		 * @brief Draws every instance with the target's current view.
+		 *
+		 * SFML's cached GL state is reset afterwards, so regular draws may follow.
+		 */
+		void draw(sf::RenderTarget& target);
+
+		[[nodiscard]] std::size_t instanceCount() const noexcept { return m_count; }
+
+	private:
+		GLuint m_program = 0U;
+		GLuint m_vao = 0U;
+		GLuint m_quadBuffer = 0U;
+		GLuint m_instanceBuffer = 0U;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::RenderBuffers, prof::MemoryKind::Video }; // instances
+		GLint m_viewProjLocation = -1;
+		std::size_t m_count = 0U;
+	};
+
+} // namespace gfx
@@ -0,0 +1,105 @@
+#include "LatencyProbe.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "Log.hpp"
+
+namespace prof {
+
+	namespace {
+		[[nodiscard]] float elapsedMs(LatencyProbe::Clock::time_point from, LatencyProbe::Clock::time_point to) noexcept {
+			return std::chrono::duration<float, std::milli>(to - from).count();
+		}
+
+		// Nearest-rank percentile of sorted values
+		[[nodiscard]] float rankedMs(const std::vector<float>& sorted, float p) {
+			const float rank = p / 100.0F * static_cast<float>(sorted.size() - 1U);
+			return sorted[static_cast<std::size_t>(rank + 0.5F)];
+		}
+	}
+
+	const char* latencyStageName(LatencyStage stage) {
+		switch (stage) {
+		case LatencyStage::KeyEvent: return "key event";
+		case LatencyStage::Tick: return "tick";
+		case LatencyStage::Play: return "play";
+		case LatencyStage::Buffer: return "buffer";
+		default: return "?";
+		}
+	}
+
+	bool LatencyProbe::begin() noexcept {
+		const Clock::time_point now = Clock::now();
+		const std::lock_guard<std::mutex> lock(m_mutex);
+		const std::uint8_t reached = m_reached.load(std::memory_order_relaxed);
+		if (reached > 0U && reached < LATENCY_STAGE_COUNT) {
+			if (now - m_stamps[0] < PROBE_TIMEOUT) {
+				return false;
+			}
+			++m_lost;
+		}
+		m_stamps[0] = now;
+		m_reached.store(1U, std::memory_order_release);
+		return true;
+	}
+
+	bool LatencyProbe::stamp(LatencyStage stage) noexcept {
+		if (!awaiting(stage)) {
+			return false;
+		}
+		const Clock::time_point now = Clock::now();
+		const auto index = static_cast<std::uint8_t>(stage);
+		const std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_reached.load(std::memory_order_relaxed) != index) {
+			return false; // a new probe started in between
+		}
+		m_stamps[index] = now;
+		m_reached.store(static_cast<std::uint8_t>(index + 1U), std::memory_order_release);
+
+		if (index + 1U == LATENCY_STAGE_COUNT) {
+			Sample& sample = m_history[m_completed % HISTORY];
+			for (std::size_t leg = 0U; leg + 1U < LATENCY_STAGE_COUNT; ++leg) {
+				sample[leg] = elapsedMs(m_stamps[leg], m_stamps[leg + 1U]);
+			}
+			sample[LATENCY_STAGE_COUNT - 1U] = elapsedMs(m_stamps[0], now);
+			++m_completed;
+		}
+		return true;
+	}
+
+	std::uint64_t LatencyProbe::completed() const noexcept {
+		const std::lock_guard<std::mutex> lock(m_mutex);
+		return m_completed;
+	}
+
+	void LatencyProbe::logReport() const {
+		const std::lock_guard<std::mutex> lock(m_mutex);
+		const auto kept = static_cast<std::size_t>(std::min<std::uint64_t>(m_completed, HISTORY));
+		if (kept == 0U) {
+			OKPP_LOG_WARNING("Warning: no input-to-beep latency probe finished (%llu lost)",
+				static_cast<unsigned long long>(m_lost));
+			return;
+		}
+
+		OKPP_LOG_INFO("Input-to-beep latency over %zu probes (%llu lost), ms p50/p90/p99/max:", kept,
+			static_cast<unsigned long long>(m_lost));
+		std::vector<float> values(kept);
+		for (std::size_t leg = 0U; leg < LATENCY_STAGE_COUNT; ++leg) {
+			for (std::size_t i = 0U; i < kept; ++i) {
+				values[i] = m_history[i][leg];
+			}
+			std::sort(values.begin(), values.end());
+			const float p50 = rankedMs(values, 50.0F);
+			const float p90 = rankedMs(values, 90.0F);
+			const float p99 = rankedMs(values, 99.0F);
+			const bool total = leg + 1U == LATENCY_STAGE_COUNT;
+			OKPP_LOG_INFO("  %s -> %s: %.2f / %.2f / %.2f / %.2f",
+				latencyStageName(static_cast<LatencyStage>(total ? 0U : leg)),
+				latencyStageName(static_cast<LatencyStage>(total ? leg : leg + 1U)),
+				static_cast<double>(p50), static_cast<double>(p90), static_cast<double>(p99),
+				static_cast<double>(values.back()));
+		}
+	}
+
+} // namespace prof
@@ -0,0 +1,101 @@
+/*
+==============================================================================
+Latency Probe - input-to-beep latency, stage by stage (--latency-probe)
+==============================================================================
+ - A probe starts when a driving key press comes out of the event queue;
+   it is then stamped when the first fixed tick consumes that input, when
+   the audio thread calls play() for the probe's beep and when the beep's
+   samples are handed to the audio device
+ - The simulation marks the frame that consumed the key, so the audio
+   thread plays the probe's beep at once, whatever the distances; the
+   probe measures the pipeline, not the warning bands
+ - One probe is in flight at a time; presses while it is (key repeat
+   included) are ignored, and a probe that has not finished within
+   PROBE_TIMEOUT (no audio device, a dropped frame) is counted as lost
+ - Stages are stamped from the main thread, a pool worker (--pipelined)
+   and the audio thread: a stage is taken only by the probe that has
+   reached the stage before it, so late stamps of a lost probe are ignored
+ - The last HISTORY probes are kept; logReport() prints percentiles of
+   every leg and of the whole chain
+ - No SFML dependency; timings come from std::chrono::steady_clock
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace prof {
+
+	enum class LatencyStage : std::uint8_t {
+		KeyEvent, // the key press came out of the event queue
+		Tick,     // the first fixed tick ran with its input
+		Play,     // the audio thread called play() for the probe's beep
+		Buffer,   // the beep's samples went to the audio device
+		Count
+	};
+
+	constexpr std::size_t LATENCY_STAGE_COUNT = static_cast<std::size_t>(LatencyStage::Count);
+
+	/**
+	 * @brief Lower-case label of a stage, as it appears in the report.
+	 */
+	[[nodiscard]] const char* latencyStageName(LatencyStage stage);
+
+	class LatencyProbe {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr std::chrono::milliseconds PROBE_TIMEOUT{ 1000 };
+		static constexpr std::size_t HISTORY = 1024U;
+
+		LatencyProbe() = default;
+
+		LatencyProbe(const LatencyProbe&) = delete;
+		LatencyProbe& operator=(const LatencyProbe&) = delete;
+
+		/**
+		 * @brief Starts a probe at a key press; false while another one is still in flight.
+		 */
+		bool begin() noexcept;
+
+		/**
+		 * @brief True while the probe in flight has reached the stage just before stage.
+		 *
+		 * Lock-free; cheap enough for every tick and every audio poll.
+		 */
+		[[nodiscard]] bool awaiting(LatencyStage stage) const noexcept {
+			const auto index = static_cast<std::uint8_t>(stage);
+			return index > 0U && m_reached.load(std::memory_order_acquire) == index;
+		}
+
+		/**
+		 * @brief Stamps stage now if the probe in flight is awaiting it; the last stage completes the probe.
+		 */
+		bool stamp(LatencyStage stage) noexcept;
+
+		[[nodiscard]] std::uint64_t completed() const noexcept;
+
+		/**
+		 * @brief Logs p50, p90, p99 and max of every leg over the kept probes, and the probes lost.
+		 */
+		void logReport() const;
+
+	private:
+		// Milliseconds of each leg of one probe; the last entry is the whole chain
+		using Sample = std::array<float, LATENCY_STAGE_COUNT>;
+
+		mutable std::mutex m_mutex; // stamps and history; awaiting() only reads m_reached
+		std::array<Clock::time_point, LATENCY_STAGE_COUNT> m_stamps{};
+		std::atomic<std::uint8_t> m_reached{ 0U }; // stages stamped by the probe in flight (0 or COUNT = none in flight)
+		std::array<Sample, HISTORY> m_history{};
+		std::uint64_t m_completed = 0U;
+		std::uint64_t m_lost = 0U;
+	};
+
+} // namespace prof
@@ -0,0 +1,368 @@
+#include "LockstepLink.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#include "Log.hpp"
+
+namespace io {
+
+	namespace {
+		constexpr std::uint8_t LINK_HELLO = 1U;
+		constexpr std::uint8_t LINK_START = 2U;
+		constexpr std::uint8_t LINK_INPUTS = 3U;
+		constexpr std::uint8_t LINK_LEFT = 4U;
+
+		constexpr std::size_t MAX_RUNS_PER_PACKET = 255U;
+		constexpr std::uint8_t MAX_RUN_TICKS = 255U;
+
+		// Sends the queue head first; false once the socket is gone
+		[[nodiscard]] bool sendQueued(sf::TcpSocket& socket, std::deque<sf::Packet>& pending, std::uint64_t& bytesSent) {
+			while (!pending.empty()) {
+				sf::Packet& packet = pending.front();
+				switch (socket.send(packet)) {
+				case sf::Socket::Status::Done:
+					bytesSent += packet.getDataSize() + sizeof(std::uint32_t); // plus the size prefix
+					pending.pop_front();
+					break;
+				case sf::Socket::Status::Partial:
+				case sf::Socket::Status::NotReady:
+					return true; // resume this packet next time
+				default:
+					return false;
+				}
+			}
+			return true;
+		}
+
+		[[nodiscard]] std::string remoteName(const sf::TcpSocket& socket) {
+			const std::optional<sf::IpAddress> address = socket.getRemoteAddress();
+			return address ? address->toString() : std::string("?");
+		}
+	}
+
+	bool LockstepRelay::listen(unsigned short port, std::size_t players) {
+		if (m_listener.listen(port) != sf::Socket::Status::Done) {
+			OKPP_LOG_ERROR("Error: cannot listen for lockstep players on port %u", static_cast<unsigned>(port));
+			return false;
+		}
+		m_listener.setBlocking(false);
+		m_expected = std::clamp<std::size_t>(players, 1U, sim::MAX_LOCKSTEP_PLAYERS);
+		m_players.clear();
+		m_started = false;
+		return true;
+	}
+
+	bool LockstepRelay::poll() {
+		accept();
+		for (std::size_t slot = 0U; slot < m_players.size();) {
+			if (m_players[slot].gone || receive(slot)) {
+				++slot;
+				continue;
+			}
+			if (m_started) {
+				leave(slot);
+				++slot;
+			}
+			else {
+				// No slot has been handed out yet; the next player takes this one
+				OKPP_LOG_INFO("Player %s left before the start", remoteName(*m_players[slot].socket).c_str());
+				m_players.erase(m_players.begin() + static_cast<std::ptrdiff_t>(slot));
+			}
+		}
+
+		if (!m_started && m_players.size() == m_expected
+			&& std::all_of(m_players.begin(), m_players.end(), [](const Player& player) { return player.greeted; }))
+		{
+			start();
+		}
+
+		bool anyone = !m_started;
+		for (std::size_t slot = 0U; slot < m_players.size(); ++slot) {
+			Player& player = m_players[slot];
+			if (player.gone) {
+				continue;
+			}
+			if (player.pending.size() > MAX_LAGGING_PACKETS || !flush(player)) {
+				OKPP_LOG_WARNING("Player %zu dropped (%zu packets behind)", slot, player.pending.size());
+				leave(slot);
+				continue;
+			}
+			anyone = true;
+		}
+		return anyone;
+	}
+
+	void LockstepRelay::close() {
+		m_players.clear();
+		m_listener.close();
+	}
+
+	void LockstepRelay::accept() {
+		for (;;) {
+			auto socket = std::make_unique<sf::TcpSocket>();
+			if (m_listener.accept(*socket) != sf::Socket::Status::Done) {
+				return;
+			}
+			if (m_started || m_players.size() >= m_expected) {
+				OKPP_LOG_WARNING("Player %s turned away: the session is full", remoteName(*socket).c_str());
+				continue; // the socket closes here
+			}
+			socket->setBlocking(false);
+			OKPP_LOG_INFO("Player %s connected", remoteName(*socket).c_str());
+			Player player;
+			player.socket = std::move(socket);
+			m_players.push_back(std::move(player));
+		}
+	}
+
+	void LockstepRelay::start() {
+		for (std::size_t slot = 0U; slot < m_players.size(); ++slot) {
+			sf::Packet packet;
+			packet << LINK_START << static_cast<std::uint8_t>(m_players.size()) << static_cast<std::uint8_t>(slot);
+			queue(slot, packet);
+		}
+		m_started = true;
+		OKPP_LOG_INFO("Lockstep session of %zu players started", m_players.size());
+	}
+
+	bool LockstepRelay::receive(std::size_t slot) {
+		Player& player = m_players[slot];
+		for (;;) {
+			switch (player.socket->receive(player.incoming)) {
+			case sf::Socket::Status::Done:
+				break;
+			case sf::Socket::Status::Partial:
+			case sf::Socket::Status::NotReady:
+				return true;
+			default:
+				return false;
+			}
+
+			std::uint8_t kind = 0U;
+			if (!(player.incoming >> kind)) {
+				return false;
+			}
+			if (!player.greeted) {
+				std::uint32_t protocol = 0U;
+				if (kind != LINK_HELLO || !(player.incoming >> protocol >> player.fingerprint)
+					|| protocol != LOCKSTEP_PROTOCOL)
+				{
+					OKPP_LOG_WARNING("Player %s turned away: not a lockstep peer of this version",
+						remoteName(*player.socket).c_str());
+					return false;
+				}
+				const auto first = std::find_if(m_players.begin(), m_players.end(),
+					[](const Player& other) { return other.greeted; });
+				if (first != m_players.end() && first->fingerprint != player.fingerprint) {
+					OKPP_LOG_WARNING("Player %s turned away: different scene, tick rate or vehicle model",
+						remoteName(*player.socket).c_str());
+					return false;
+				}
+				player.greeted = true;
+			}
+			else if (!m_started || kind != LINK_INPUTS || !relayInputs(slot, player.incoming)) {
+				OKPP_LOG_WARNING("Player %zu sent a malformed packet", slot);
+				return false;
+			}
+			player.incoming.clear();
+		}
+	}
+
+	bool LockstepRelay::relayInputs(std::size_t slot, sf::Packet& packet) {
+		Player& player = m_players[slot];
+		std::uint32_t firstTick = 0U;
+		std::uint8_t runs = 0U;
+		if (!(packet >> firstTick >> runs) || firstTick != player.nextTick) {
+			return false;
+		}
+
+		sf::Packet relayed;
+		relayed << LINK_INPUTS << static_cast<std::uint8_t>(slot) << firstTick << runs;
+		std::uint32_t ticks = 0U;
+		for (std::uint8_t run = 0U; run < runs; ++run) {
+			std::uint8_t count = 0U;
+			std::uint8_t input = 0U;
+			if (!(packet >> count >> input)) {
+				return false;
+			}
+			relayed << count << input;
+			ticks += count;
+		}
+		player.nextTick += ticks;
+
+		for (std::size_t other = 0U; other < m_players.size(); ++other) {
+			if (other != slot && !m_players[other].gone) {
+				queue(other, relayed);
+			}
+		}
+		return true;
+	}
+
+	void LockstepRelay::leave(std::size_t slot) {
+		Player& player = m_players[slot];
+		player.gone = true;
+		player.pending.clear();
+		player.socket->disconnect();
+		OKPP_LOG_INFO("Player %zu left at tick %u", slot, player.nextTick);
+
+		sf::Packet packet;
+		packet << LINK_LEFT << static_cast<std::uint8_t>(slot) << player.nextTick;
+		for (std::size_t other = 0U; other < m_players.size(); ++other) {
+			if (!m_players[other].gone) {
+				queue(other, packet);
+			}
+		}
+	}
+
+	void LockstepRelay::queue(std::size_t slot, const sf::Packet& packet) {
+		m_players[slot].pending.push_back(packet);
+	}
+
+	bool LockstepRelay::flush(Player& player) {
+		return sendQueued(*player.socket, player.pending, m_bytesSent);
+	}
+
+	bool LockstepPeer::connect(const std::string& host, unsigned short port, std::uint64_t fingerprint, sf::Time timeout) {
+		const std::optional<sf::IpAddress> address = sf::IpAddress::resolve(host);
+		if (!address) {
+			OKPP_LOG_ERROR("Error: cannot resolve relay %s", host.c_str());
+			return false;
+		}
+		if (m_socket.connect(*address, port, timeout) != sf::Socket::Status::Done) {
+			OKPP_LOG_ERROR("Error: cannot connect to %s:%u", host.c_str(), static_cast<unsigned>(port));
+			return false;
+		}
+		m_socket.setBlocking(false);
+		m_started = false;
+		m_remote.clear();
+		m_runs.clear();
+
+		m_pending.emplace_back();
+		m_pending.back() << LINK_HELLO << LOCKSTEP_PROTOCOL << fingerprint;
+		return true;
+	}
+
+	bool LockstepPeer::poll() {
+		sendRuns();
+		if (!sendQueued(m_socket, m_pending, m_bytesSent)) {
+			return false;
+		}
+		for (;;) {
+			switch (m_socket.receive(m_incoming)) {
+			case sf::Socket::Status::Done:
+				break;
+			case sf::Socket::Status::Partial:
+			case sf::Socket::Status::NotReady:
+				return true;
+			default:
+				return false;
+			}
+
+			m_bytesReceived += m_incoming.getDataSize() + sizeof(std::uint32_t);
+			const bool wasStarted = m_started;
+			if (!read(m_incoming)) {
+				OKPP_LOG_ERROR("Error: malformed lockstep packet from the relay");
+				return false;
+			}
+			m_incoming.clear();
+			if (m_started && !wasStarted) {
+				return true; // the caller builds its session before any input is read
+			}
+		}
+	}
+
+	void LockstepPeer::queueInput(std::uint32_t tick, sim::CarInput input) {
+		if (m_runs.empty()) {
+			m_firstTick = tick;
+		}
+		const std::size_t size = m_runs.size();
+		if (size > 0U && m_runs[size - 1U] == input && m_runs[size - 2U] < MAX_RUN_TICKS) {
+			++m_runs[size - 2U];
+			return;
+		}
+		m_runs.push_back(1U);
+		m_runs.push_back(input);
+	}
+
+	void LockstepPeer::apply(sim::LockstepSession& session) {
+		for (std::size_t slot = 0U; slot < m_remote.size(); ++slot) {
+			std::deque<RemoteInput>& inputs = m_remote[slot];
+			while (!inputs.empty()) {
+				const RemoteInput& next = inputs.front();
+				if (next.left) {
+					session.retire(slot, next.tick);
+				}
+				else if (!session.addInput(slot, next.tick, next.input)) {
+					break; // beyond the window: kept until the session catches up
+				}
+				inputs.pop_front();
+			}
+		}
+	}
+
+	bool LockstepPeer::read(sf::Packet& packet) {
+		std::uint8_t kind = 0U;
+		std::uint8_t slot = 0U;
+		if (!(packet >> kind)) {
+			return false;
+		}
+		if (!m_started) {
+			std::uint8_t players = 0U;
+			if (kind != LINK_START || !(packet >> players >> slot) || players == 0U
+				|| players > sim::MAX_LOCKSTEP_PLAYERS || slot >= players)
+			{
+				return false;
+			}
+			m_players = players;
+			m_slot = slot;
+			m_remote.assign(players, {});
+			m_started = true;
+			return true;
+		}
+
+		std::uint32_t tick = 0U;
+		if (!(packet >> slot >> tick) || slot >= m_players || slot == m_slot) {
+			return false;
+		}
+		std::deque<RemoteInput>& inputs = m_remote[slot];
+		if (kind == LINK_LEFT) {
+			inputs.push_back(RemoteInput{ tick, 0U, true });
+			return true;
+		}
+		std::uint8_t runs = 0U;
+		if (kind != LINK_INPUTS || !(packet >> runs)) {
+			return false;
+		}
+		for (std::uint8_t run = 0U; run < runs; ++run) {
+			std::uint8_t count = 0U;
+			std::uint8_t input = 0U;
+			if (!(packet >> count >> input)) {
+				return false;
+			}
+			for (std::uint8_t i = 0U; i < count; ++i) {
+				inputs.push_back(RemoteInput{ tick++, input, false });
+			}
+		}
+		return true;
+	}
+
+	void LockstepPeer::sendRuns() {
+		std::size_t begin = 0U;
+		while (begin < m_runs.size()) {
+			const std::size_t runs = std::min((m_runs.size() - begin) / 2U, MAX_RUNS_PER_PACKET);
+			m_pending.emplace_back();
+			sf::Packet& packet = m_pending.back();
+			packet << LINK_INPUTS << m_firstTick << static_cast<std::uint8_t>(runs);
+			for (std::size_t run = 0U; run < runs; ++run) {
+				const std::uint8_t count = m_runs[begin + 2U * run];
+				packet << count << m_runs[begin + 2U * run + 1U];
+				m_firstTick += count;
+			}
+			begin += 2U * runs;
+		}
+		m_runs.clear();
+	}
+
+} // namespace io
@@ -0,0 +1,148 @@
+/*
+==============================================================================
+Lockstep Link - driver inputs relayed between the peers of a LockstepSession
+==============================================================================
+ - The relay admits the expected number of players, starts them together
+   and then only forwards input packets; it never simulates, so it costs
+   the same for any lot and any number of ticks
+ - A peer sends a hello with the lockstep fingerprint of its scene, tick
+   rate and vehicle model; the relay turns away peers whose fingerprint
+   differs from the first one's, since they could never agree
+ - Inputs travel as runs: the first tick, then (ticks, input bits) pairs,
+   one packet per peer per frame. A held key costs one pair however many
+   ticks it spans, so a driver uses a few hundred bytes a second
+ - A player that leaves is announced with the tick after its last relayed
+   input; every peer retires it there, so they stay in step
+ - Sockets are non-blocking and sends never stall the frame, as in the
+   visualization link; a peer that falls MAX_LAGGING_PACKETS behind is
+   dropped like a peer that left
+ - Wire format (sf::Packet): kind u8 | hello: protocol u32, fingerprint
+   u64 | start: players u8, slot u8 | inputs: [relayed: slot u8] first
+   tick u32, runs u8, per run: ticks u8, input u8 | left: slot u8, tick u32
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Network.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "LockstepSession.hpp"
+
+namespace io {
+
+	constexpr std::uint32_t LOCKSTEP_PROTOCOL = 1U;
+	constexpr std::size_t MAX_LAGGING_PACKETS = 256U;
+
+	class LockstepRelay {
+	public:
+		/**
+		 * @brief Starts listening on port for players; false (logged) if it is taken.
+		 *
+		 * MISRA: players is clamped to [1, sim::MAX_LOCKSTEP_PLAYERS].
+		 */
+		bool listen(unsigned short port, std::size_t players);
+
+		/**
+		 * @brief Admits players until all have said hello, starts them, then
+		 *        forwards everything received; false once every player has left.
+		 */
+		[[nodiscard]] bool poll();
+
+		void close();
+
+		[[nodiscard]] bool started() const noexcept { return m_started; }
+		[[nodiscard]] std::uint64_t bytesSent() const noexcept { return m_bytesSent; }
+
+	private:
+		struct Player {
+			std::unique_ptr<sf::TcpSocket> socket;
+			std::deque<sf::Packet> pending; // head may be partly sent
+			sf::Packet incoming;            // a partly received packet stays in it
+			std::uint64_t fingerprint = 0U;
+			bool greeted = false;
+			bool gone = false;
+			std::uint32_t nextTick = 0U;    // after its last relayed input
+		};
+
+		void accept();
+		void start();
+		[[nodiscard]] bool receive(std::size_t slot); // false once the player is gone or misbehaved
+		[[nodiscard]] bool relayInputs(std::size_t slot, sf::Packet& packet);
+		void leave(std::size_t slot);
+		void queue(std::size_t slot, const sf::Packet& packet);
+		[[nodiscard]] bool flush(Player& player);
+
+		sf::TcpListener m_listener;
+		std::vector<Player> m_players;
+		std::size_t m_expected = 1U;
+		bool m_started = false;
+		std::uint64_t m_bytesSent = 0U;
+	};
+
+	class LockstepPeer {
+	public:
+		/**
+		 * @brief Connects to a relay and says hello; false (logged) if it cannot.
+		 */
+		bool connect(const std::string& host, unsigned short port, std::uint64_t fingerprint,
+			sf::Time timeout = sf::seconds(3.0F));
+
+		/**
+		 * @brief Sends queued inputs and receives everything that has arrived;
+		 *        false once the relay has gone or sent something malformed.
+		 *
+		 * Returns right after the start packet, so the session can be built
+		 * before any remote input is read.
+		 */
+		[[nodiscard]] bool poll();
+
+		/**
+		 * @brief This peer's input for tick, sent with the next poll(); ticks must follow each other.
+		 */
+		void queueInput(std::uint32_t tick, sim::CarInput input);
+
+		/**
+		 * @brief Feeds the remote inputs and departures received so far to session;
+		 *        inputs too far ahead of it wait for a later call.
+		 */
+		void apply(sim::LockstepSession& session);
+
+		[[nodiscard]] bool started() const noexcept { return m_started; }
+		[[nodiscard]] std::size_t slot() const noexcept { return m_slot; }
+		[[nodiscard]] std::size_t playerCount() const noexcept { return m_players; }
+		[[nodiscard]] std::uint64_t bytesSent() const noexcept { return m_bytesSent; }
+		[[nodiscard]] std::uint64_t bytesReceived() const noexcept { return m_bytesReceived; }
+
+	private:
+		// One input, or the departure of the player at tick
+		struct RemoteInput {
+			std::uint32_t tick = 0U;
+			sim::CarInput input = 0U;
+			bool left = false;
+		};
+
+		[[nodiscard]] bool read(sf::Packet& packet);
+		void sendRuns();
+
+		sf::TcpSocket m_socket;
+		sf::Packet m_incoming;
+		std::deque<sf::Packet> m_pending;
+		std::vector<std::deque<RemoteInput>> m_remote; // per slot, in tick order
+		std::uint32_t m_firstTick = 0U;                // of the runs not sent yet
+		std::vector<std::uint8_t> m_runs;              // ticks, input pairs
+		bool m_started = false;
+		std::size_t m_slot = 0U;
+		std::size_t m_players = 0U;
+		std::uint64_t m_bytesSent = 0U;
+		std::uint64_t m_bytesReceived = 0U;
+	};
+
+} // namespace io
@@ -0,0 +1,165 @@
+#include "LockstepSession.hpp"
+
+#include <algorithm>
+
+#include "Constants.hpp"
+#include "FastTrig.hpp"
+#include "Parking.hpp"
+#include "Scene.hpp"
+
+namespace sim {
+
+	namespace {
+		// Collision scratch of the session; one sweep's candidate list at a time
+		constexpr std::size_t LOCKSTEP_SCRATCH_BYTES = 4096U;
+
+		// FNV-1a over raw bytes
+		constexpr std::uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+		constexpr std::uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+		template <typename T>
+		[[nodiscard]] std::uint64_t hashRaw(std::uint64_t hash, const T* values, std::size_t count) {
+			const auto* bytes = reinterpret_cast<const unsigned char*>(values);
+			for (std::size_t i = 0U; i < count * sizeof(T); ++i) {
+				hash = (hash ^ bytes[i]) * FNV_PRIME;
+			}
+			return hash;
+		}
+	}
+
+	std::uint64_t lockstepFingerprint(const Scene& scene, float tickHz, VehicleModel model) {
+		static_assert(sizeof(Obstacle) == 12U && sizeof(sf::FloatRect) == 16U && sizeof(CarState) == 12U,
+			"scene arrays are hashed raw and must have no padding");
+		std::uint64_t hash = FNV_OFFSET;
+		hash = hashRaw(hash, scene.obstacles.data(), scene.obstacles.size());
+		hash = hashRaw(hash, scene.parkBays.data(), scene.parkBays.size());
+		hash = hashRaw(hash, scene.spawns.data(), scene.spawns.size());
+		hash = hashRaw(hash, &scene.carHalfExtent, 1U);
+		hash = hashRaw(hash, &tickHz, 1U);
+		return hashRaw(hash, &model, 1U);
+	}
+
+	LockstepSession::LockstepSession(const Scene& scene, std::size_t players, float tickHz, VehicleModel model)
+		: m_scene(scene)
+		, m_carParams{ constants::CAR_SPEED, constants::CAR_TURN_RATE }
+		, m_model(model)
+		, m_tickDt(1.0F / tickHz)
+		, m_players(std::clamp<std::size_t>(players, 1U, MAX_LOCKSTEP_PLAYERS))
+		, m_scratch(LOCKSTEP_SCRATCH_BYTES)
+		, m_history(static_cast<std::size_t>(LOCKSTEP_WINDOW) * m_players)
+		, m_inputs(INPUT_RING, TickInputs{})
+		, m_used(LOCKSTEP_WINDOW, TickInputs{})
+	{
+		m_collisionWorld.build(scene.obstacles, {}, constants::OBSTACLE_CELL_SIZE);
+		m_retiredAt.fill(NEVER);
+
+		const std::size_t spawnCount = std::max<std::size_t>(scene.spawns.size(), 1U);
+		for (std::size_t player = 0U; player < m_players; ++player) {
+			CarState pose = scene.spawns.empty() ? CarState{} : scene.spawns[player % spawnCount];
+			// Later rounds line up beside the spawn, three half widths apart
+			const SinCos heading = sinCosDeg(pose.headingDeg);
+			const float side = static_cast<float>(player / spawnCount) * 3.0F * scene.carHalfExtent.y;
+			pose.position += sf::Vector2f{ -heading.sin, heading.cos } * side;
+			m_cars[player].vehicle = BicycleState{ pose, 0.0F, 0.0F };
+		}
+	}
+
+	bool LockstepSession::addInput(std::size_t player, std::uint32_t tick, CarInput input) {
+		if (player >= m_players || m_retiredAt[player] != NEVER || tick != m_nextInput[player]
+			|| tick >= m_tick + LOCKSTEP_WINDOW)
+		{
+			return false;
+		}
+		m_inputs[tick % INPUT_RING][player] = input;
+		m_lastInput[player] = input;
+		m_nextInput[player] = tick + 1U;
+		// A tick already simulated with another guess is re-simulated
+		if (tick < m_tick && m_used[tick % LOCKSTEP_WINDOW][player] != input) {
+			m_rollbackTo = std::min(m_rollbackTo, tick);
+		}
+		return true;
+	}
+
+	void LockstepSession::retire(std::size_t player, std::uint32_t tick) {
+		if (player >= m_players || m_retiredAt[player] != NEVER) {
+			return;
+		}
+		tick = std::max(tick, m_nextInput[player]);
+		m_retiredAt[player] = tick;
+		// Ticks from the retirement on were guessed with the last input instead of none
+		const std::uint32_t oldest = (m_tick > LOCKSTEP_WINDOW) ? m_tick - LOCKSTEP_WINDOW : 0U;
+		for (std::uint32_t t = std::max(tick, oldest); t < m_tick; ++t) {
+			if (m_used[t % LOCKSTEP_WINDOW][player] != 0U) {
+				m_rollbackTo = std::min(m_rollbackTo, t);
+				break;
+			}
+		}
+	}
+
+	bool LockstepSession::canAdvance() const noexcept {
+		const std::uint32_t confirmed = confirmedTick();
+		return m_tick < confirmed || m_tick - confirmed < LOCKSTEP_WINDOW;
+	}
+
+	std::uint32_t LockstepSession::confirmedTick() const noexcept {
+		std::uint32_t confirmed = NEVER;
+		for (std::size_t player = 0U; player < m_players; ++player) {
+			if (m_retiredAt[player] == NEVER) {
+				confirmed = std::min(confirmed, m_nextInput[player]);
+			}
+		}
+		return confirmed;
+	}
+
+	void LockstepSession::advance() {
+		if (m_rollbackTo < m_tick) {
+			const std::uint32_t now = m_tick;
+			const std::size_t slot = (m_rollbackTo % LOCKSTEP_WINDOW) * m_players;
+			std::copy_n(m_history.begin() + static_cast<std::ptrdiff_t>(slot), m_players, m_cars.begin());
+			m_tick = m_rollbackTo;
+			++m_rollbacks;
+			m_resimulated += now - m_tick;
+			while (m_tick < now) {
+				step();
+			}
+		}
+		m_rollbackTo = NEVER;
+		step();
+	}
+
+	CarInput LockstepSession::inputFor(std::size_t player, std::uint32_t tick) const noexcept {
+		if (tick >= m_retiredAt[player]) {
+			return 0U;
+		}
+		// Not arrived yet: the player is guessed to hold its last input
+		return (tick < m_nextInput[player]) ? m_inputs[tick % INPUT_RING][player] : m_lastInput[player];
+	}
+
+	void LockstepSession::step() {
+		const std::size_t slot = m_tick % LOCKSTEP_WINDOW;
+		std::copy_n(m_cars.begin(), m_players, m_history.begin() + static_cast<std::ptrdiff_t>(slot * m_players));
+
+		const sf::Vector2f& halfExtent = m_scene.carHalfExtent;
+		for (std::size_t player = 0U; player < m_players; ++player) {
+			const CarInput input = inputFor(player, m_tick);
+			m_used[slot][player] = input;
+
+			SimSnapshot& car = m_cars[player];
+			bool blocked = false;
+			if (m_model == VehicleModel::Bicycle) {
+				blocked = stepBicycleWithCollisions(car.vehicle, input, m_bicycleParams, m_tickDt,
+					m_collisionWorld, halfExtent, m_scratch);
+			}
+			else {
+				blocked = stepCarWithCollisions(car.vehicle.pose, input, m_carParams, m_tickDt,
+					m_collisionWorld, halfExtent, m_scratch);
+			}
+			++car.tick;
+			car.blocked |= blocked ? 1U : 0U;
+			car.occupied = (!m_scene.parkBays.empty()
+				&& parkOccupied(carBounds(car.vehicle.pose, halfExtent), m_scene.parkBays.front())) ? 1U : 0U;
+		}
+		++m_tick;
+	}
+
+} // namespace sim
@@ -0,0 +1,130 @@
+/*
+==============================================================================
+Lockstep Session - several drivers in one lot, rolled back on late inputs
+==============================================================================
+ - Every peer runs the same deterministic simulation of all cars and only
+   driver inputs (CarInput bits per fixed tick) travel between them; no
+   peer, and no server, is authoritative
+ - A player whose input for a tick has not arrived yet is predicted to
+   hold the last input it sent. When the real input arrives and differs,
+   the cars are restored from the SimSnapshot taken before that tick and
+   the ticks since are simulated again with what is now known
+ - One snapshot per car per tick is kept for LOCKSTEP_WINDOW ticks; a peer
+   that would run further ahead of the slowest player's inputs than that
+   stalls (canAdvance()) until they arrive
+ - Inputs of a player arrive in tick order (the link is a stream), so each
+   player's confirmed inputs are a prefix; a player that leaves is retired
+   at a tick every peer agrees on and drives no input from then on
+ - Cars collide with the scene's pillars, not with each other; built with
+   OKPP_DETERMINISTIC_MATH the peers may run on different platforms
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "Collision.hpp"
+#include "FrameArena.hpp"
+#include "SimFwd.hpp"
+#include "SimSnapshot.hpp"
+#include "VehicleDynamics.hpp"
+
+namespace sim {
+
+	constexpr std::uint32_t LOCKSTEP_WINDOW = 64U;    // ticks a late input can still be rolled back to
+	constexpr std::size_t MAX_LOCKSTEP_PLAYERS = 8U;
+
+	/**
+	 * @brief Hash of everything peers must share to stay in step: the scene, the tick rate and the vehicle model.
+	 */
+	[[nodiscard]] std::uint64_t lockstepFingerprint(const Scene& scene, float tickHz, VehicleModel model);
+
+	class LockstepSession {
+	public:
+		static constexpr std::uint32_t NEVER = std::numeric_limits<std::uint32_t>::max();
+
+		/**
+		 * @brief Places players cars at the scene's spawns, taken in turn; when
+		 *        there are more cars than spawns, later rounds park beside them.
+		 *
+		 * MISRA: players is clamped to [1, MAX_LOCKSTEP_PLAYERS].
+		 */
+		LockstepSession(const Scene& scene, std::size_t players, float tickHz, VehicleModel model);
+
+		/**
+		 * @brief Records player's input for tick, local or received.
+		 *
+		 * MISRA: returns false (nothing recorded) unless tick is the player's
+		 *        next one and within LOCKSTEP_WINDOW of the simulation.
+		 */
+		[[nodiscard]] bool addInput(std::size_t player, std::uint32_t tick, CarInput input);
+
+		/**
+		 * @brief The player drives no input from tick on; ticks before it it has
+		 *        not sent are predicted for good. Every peer must pass the same tick.
+		 */
+		void retire(std::size_t player, std::uint32_t tick);
+
+		/**
+		 * @brief False while a tick more would outrun the rollback window.
+		 */
+		[[nodiscard]] bool canAdvance() const noexcept;
+
+		/**
+		 * @brief Rolls back to the oldest mispredicted tick and re-simulates up to
+		 *        now, then simulates one more tick. Call only while canAdvance().
+		 */
+		void advance();
+
+		[[nodiscard]] std::uint32_t tick() const noexcept { return m_tick; } // ticks simulated
+		[[nodiscard]] std::uint32_t confirmedTick() const noexcept;        // ticks whose inputs are all known
+		[[nodiscard]] std::size_t playerCount() const noexcept { return m_players; }
+		[[nodiscard]] std::uint32_t nextInputTick(std::size_t player) const noexcept { return m_nextInput[player]; }
+
+		/**
+		 * @brief Car of player after the last simulated tick (predicted past confirmedTick()).
+		 */
+		[[nodiscard]] const SimSnapshot& car(std::size_t player) const noexcept { return m_cars[player]; }
+
+		[[nodiscard]] std::uint64_t rollbacks() const noexcept { return m_rollbacks; }
+		[[nodiscard]] std::uint64_t resimulatedTicks() const noexcept { return m_resimulated; }
+
+	private:
+		// Inputs are kept for the window behind the simulation and the window ahead of it
+		static constexpr std::uint32_t INPUT_RING = 2U * LOCKSTEP_WINDOW;
+
+		using TickInputs = std::array<CarInput, MAX_LOCKSTEP_PLAYERS>;
+
+		[[nodiscard]] CarInput inputFor(std::size_t player, std::uint32_t tick) const noexcept;
+		void step(); // simulates m_tick, saving the cars before it
+
+		const Scene& m_scene;
+		CollisionWorld m_collisionWorld;
+		CarParams m_carParams;
+		BicycleParams m_bicycleParams;
+		VehicleModel m_model;
+		float m_tickDt;
+		std::size_t m_players;
+		FrameArena m_scratch;
+
+		std::uint32_t m_tick = 0U;
+		std::uint32_t m_rollbackTo = NEVER; // oldest simulated tick whose prediction was wrong
+		std::array<SimSnapshot, MAX_LOCKSTEP_PLAYERS> m_cars{};
+		std::vector<SimSnapshot> m_history;  // LOCKSTEP_WINDOW ticks x players, cars before each tick
+		std::vector<TickInputs> m_inputs;    // INPUT_RING ticks, confirmed inputs
+		std::vector<TickInputs> m_used;      // LOCKSTEP_WINDOW ticks, what each tick was simulated with
+		std::array<std::uint32_t, MAX_LOCKSTEP_PLAYERS> m_nextInput{}; // first tick without a confirmed input
+		std::array<std::uint32_t, MAX_LOCKSTEP_PLAYERS> m_retiredAt{};
+		std::array<CarInput, MAX_LOCKSTEP_PLAYERS> m_lastInput{};      // input of m_nextInput - 1
+
+		std::uint64_t m_rollbacks = 0U;
+		std::uint64_t m_resimulated = 0U;
+	};
+
+} // namespace sim
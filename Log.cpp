@@ -0,0 +1,194 @@
+#include "Log.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace logging {
+
+	namespace {
+		// 256 KiB of records; a burst larger than that before the writer wakes is dropped
+		constexpr std::size_t RECORD_BYTES = 248U;
+		constexpr std::size_t QUEUE_CAPACITY = 1024U; // power of two
+		constexpr std::chrono::milliseconds WRITER_PERIOD{ 5 };
+		constexpr std::size_t CACHE_LINE = 64U;
+
+		struct Record {
+			std::atomic<std::size_t> sequence{ 0U }; // Vyukov slot turn
+			Level level = Level::Info;
+			std::uint16_t length = 0U;
+			std::array<char, RECORD_BYTES> text{};
+		};
+
+		/**
+		 * @brief Bounded MPSC queue: producers claim a slot with one CAS on the
+		 *        tail and publish it through the slot's sequence number.
+		 */
+		class RecordQueue {
+		public:
+			RecordQueue() {
+				for (std::size_t i = 0U; i < QUEUE_CAPACITY; ++i) {
+					m_slots[i].sequence.store(i, std::memory_order_relaxed);
+				}
+			}
+
+			// Producer side: a slot to fill and then publish(), or null when full
+			[[nodiscard]] Record* claim(std::size_t& position) noexcept {
+				std::size_t tail = m_tail.load(std::memory_order_relaxed);
+				for (;;) {
+					Record& slot = m_slots[tail & MASK];
+					const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+					if (sequence == tail) {
+						if (m_tail.compare_exchange_weak(tail, tail + 1U, std::memory_order_relaxed)) {
+							position = tail;
+							return &slot;
+						}
+					}
+					else if (sequence < tail) {
+						return nullptr; // full: the writer has not freed this slot yet
+					}
+					else {
+						tail = m_tail.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			static void publish(Record& record, std::size_t position) noexcept {
+				record.sequence.store(position + 1U, std::memory_order_release);
+			}
+
+			// Consumer side: the next published record, or null
+			[[nodiscard]] Record* front() noexcept {
+				Record& slot = m_slots[m_head & MASK];
+				return (slot.sequence.load(std::memory_order_acquire) == m_head + 1U) ? &slot : nullptr;
+			}
+
+			void pop(Record& record) noexcept {
+				record.sequence.store(m_head + QUEUE_CAPACITY, std::memory_order_release);
+				++m_head;
+			}
+
+		private:
+			static constexpr std::size_t MASK = QUEUE_CAPACITY - 1U;
+
+			std::array<Record, QUEUE_CAPACITY> m_slots;
+			alignas(CACHE_LINE) std::atomic<std::size_t> m_tail{ 0U };
+			alignas(CACHE_LINE) std::size_t m_head = 0U; // writer thread only
+		};
+
+		struct Logger {
+			RecordQueue queue;
+			std::atomic<bool> running{ false };
+			std::atomic<bool> stop{ false };
+			std::atomic<std::size_t> dropped{ 0U };
+			std::mutex lifecycle; // start/stop only, never taken by write()
+			std::thread writer;
+		};
+
+		Logger& logger() {
+			static Logger instance;
+			return instance;
+		}
+
+		std::FILE* streamFor(Level level) noexcept {
+			return (level >= Level::Warning) ? stderr : stdout;
+		}
+
+		void emit(Level level, const char* text, std::size_t length) noexcept {
+			(void)std::fwrite(text, 1U, length, streamFor(level));
+			(void)std::fputc('\n', streamFor(level));
+		}
+
+		std::size_t formatRecord(char* out, std::size_t capacity, const char* format, std::va_list args) noexcept {
+			const int written = std::vsnprintf(out, capacity, format, args);
+			if (written < 0) {
+				return 0U;
+			}
+			return (static_cast<std::size_t>(written) < capacity) ? static_cast<std::size_t>(written) : capacity - 1U;
+		}
+
+		// Drains everything published so far; true if anything was written
+		bool drain(Logger& log) {
+			bool any = false;
+			while (Record* record = log.queue.front()) {
+				emit(record->level, record->text.data(), record->length);
+				log.queue.pop(*record);
+				any = true;
+			}
+
+			const std::size_t dropped = log.dropped.exchange(0U, std::memory_order_relaxed);
+			if (dropped != 0U) {
+				std::fprintf(stderr, "Warning: log queue full, %zu records dropped\n", dropped);
+				any = true;
+			}
+			if (any) {
+				(void)std::fflush(stdout);
+				(void)std::fflush(stderr);
+			}
+			return any;
+		}
+	}
+
+	void startLogging() {
+		Logger& log = logger();
+		const std::lock_guard<std::mutex> lock(log.lifecycle);
+		if (log.writer.joinable()) {
+			return;
+		}
+		log.stop.store(false, std::memory_order_relaxed);
+		log.writer = std::thread([&log]() {
+			while (!log.stop.load(std::memory_order_acquire)) {
+				if (!drain(log)) {
+					std::this_thread::sleep_for(WRITER_PERIOD);
+				}
+			}
+			(void)drain(log);
+		});
+		log.running.store(true, std::memory_order_release);
+	}
+
+	void stopLogging() {
+		Logger& log = logger();
+		const std::lock_guard<std::mutex> lock(log.lifecycle);
+		if (!log.writer.joinable()) {
+			return;
+		}
+		// Later records go straight to the console; the writer still drains the queued ones
+		log.running.store(false, std::memory_order_release);
+		log.stop.store(true, std::memory_order_release);
+		log.writer.join();
+	}
+
+	void write(Level level, const char* format, ...) noexcept {
+		Logger& log = logger();
+		std::va_list args;
+		va_start(args, format);
+
+		if (!log.running.load(std::memory_order_acquire)) {
+			std::array<char, RECORD_BYTES> text{};
+			const std::size_t length = formatRecord(text.data(), text.size(), format, args);
+			va_end(args);
+			emit(level, text.data(), length);
+			(void)std::fflush(streamFor(level));
+			return;
+		}
+
+		std::size_t position = 0U;
+		Record* record = log.queue.claim(position);
+		if (record == nullptr) {
+			va_end(args);
+			log.dropped.fetch_add(1U, std::memory_order_relaxed);
+			return;
+		}
+		record->level = level;
+		record->length = static_cast<std::uint16_t>(formatRecord(record->text.data(), record->text.size(), format, args));
+		va_end(args);
+		RecordQueue::publish(*record, position);
+	}
+
+} // namespace logging
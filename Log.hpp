@@ -0,0 +1,69 @@
+/*
+==============================================================================
+Log - asynchronous, leveled console logging
+==============================================================================
+ - The calling thread only formats the message into a fixed-size record
+   and pushes it into a bounded lock-free queue (many producers, one
+   consumer); it never touches the console
+ - A background writer drains the queue to stdout (debug, info) or stderr
+   (warning, error); when the queue is full, records are counted as
+   dropped and reported by the writer
+ - Levels below OKPP_LOG_MIN_LEVEL are elided at compile time, arguments
+   included: the macros expand to a discarded if constexpr branch
+ - Before startLogging() and once stopLogging() has begun, records are
+   written synchronously, so startup and shutdown messages still appear
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// 0 = debug, 1 = info, 2 = warning, 3 = error
+#ifndef OKPP_LOG_MIN_LEVEL
+#define OKPP_LOG_MIN_LEVEL 1
+#endif
+
+namespace logging {
+
+	enum class Level : std::uint8_t {
+		Debug = 0,
+		Info = 1,
+		Warning = 2,
+		Error = 3
+	};
+
+	/**
+	 * @brief Starts the background writer; stopLogging() flushes and joins it.
+	 */
+	void startLogging();
+	void stopLogging();
+
+	/**
+	 * @brief Formats a printf-style message into a record and queues it.
+	 *
+	 * Long messages are truncated to one record. Use the OKPP_LOG_* macros,
+	 * which drop disabled levels at compile time.
+	 */
+#if defined(__GNUC__)
+	__attribute__((format(printf, 2, 3)))
+#endif
+	void write(Level level, const char* format, ...) noexcept;
+
+	[[nodiscard]] constexpr bool enabled(Level level) noexcept {
+		return static_cast<int>(level) >= OKPP_LOG_MIN_LEVEL;
+	}
+
+} // namespace logging
+
+#define OKPP_LOG(level, ...) \
+	do { \
+		if constexpr (::logging::enabled(level)) { \
+			::logging::write(level, __VA_ARGS__); \
+		} \
+	} while (false)
+
+#define OKPP_LOG_DEBUG(...) OKPP_LOG(::logging::Level::Debug, __VA_ARGS__)
+#define OKPP_LOG_INFO(...) OKPP_LOG(::logging::Level::Info, __VA_ARGS__)
+#define OKPP_LOG_WARNING(...) OKPP_LOG(::logging::Level::Warning, __VA_ARGS__)
+#define OKPP_LOG_ERROR(...) OKPP_LOG(::logging::Level::Error, __VA_ARGS__)
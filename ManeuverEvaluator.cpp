@@ -0,0 +1,241 @@
+#include "ManeuverEvaluator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "Collision.hpp"
+#include "Constants.hpp"
+#include "EventLog.hpp"
+#include "FastTrig.hpp"
+#include "FrameArena.hpp"
+#include "Headless.hpp"
+#include "Parking.hpp"
+#include "Scene.hpp"
+#include "SimSnapshot.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace sim {
+
+	namespace {
+		// Trials per pool task: enough to amortize the task, small enough to steal
+		constexpr std::size_t TRIALS_PER_TASK = 32U;
+
+		// Collision scratch of one task; a sweep only needs its candidate list
+		constexpr std::size_t TRIAL_SCRATCH_BYTES = 4096U;
+
+		// SplitMix64 finalizer: decorrelates the per-block seeds
+		[[nodiscard]] std::uint64_t mixSeed(std::uint64_t value) {
+			value += 0x9E3779B97F4A7C15ULL;
+			value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+			value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+			return value ^ (value >> 31U);
+		}
+
+		// Read-only state shared by every trial
+		struct TrialWorld {
+			const Scene& scene;
+			const std::vector<TraceSegment>& script;
+			const EvaluationConfig& config;
+			CollisionWorld collisionWorld;
+			CarParams carParams;
+			BicycleParams bicycleParams;
+			float tickDt;
+			std::uint32_t tickLimit;
+		};
+
+		// One block's results, on cache lines of its own
+		struct alignas(64) BlockResult {
+			EvaluationResult result;
+		};
+
+		// Script input of the next tick; a segment gets its length (times stretch())
+		// when it starts. False once the script is over.
+		template <typename Stretch>
+		[[nodiscard]] bool nextInput(const TrialWorld& world, SimSnapshot& state, Stretch&& stretch, CarInput& input) {
+			while (state.segmentLeft == 0U && state.segment < world.script.size()) {
+				state.segmentLeft = static_cast<std::uint32_t>(
+					std::lround(static_cast<float>(world.script[state.segment].ticks) * std::max(stretch(), 0.0F)));
+				++state.segment;
+			}
+			const bool scripted = state.segmentLeft > 0U;
+			input = scripted ? world.script[state.segment - 1U].input : CarInput{ 0U };
+			return scripted;
+		}
+
+		// One fixed tick of the trial's car; true if a pillar stopped it
+		bool stepTrial(const TrialWorld& world, SimSnapshot& state, CarInput input, FrameArena& scratch) {
+			const sf::Vector2f& halfExtent = world.scene.carHalfExtent;
+			bool blocked = false;
+			if (world.config.model == VehicleModel::Bicycle) {
+				blocked = stepBicycleWithCollisions(state.vehicle, input, world.bicycleParams, world.tickDt,
+					world.collisionWorld, halfExtent, scratch);
+			}
+			else {
+				blocked = stepCarWithCollisions(state.vehicle.pose, input, world.carParams, world.tickDt,
+					world.collisionWorld, halfExtent, scratch);
+			}
+			++state.tick;
+			state.blocked |= blocked ? 1U : 0U;
+			state.occupied = parkOccupied(carBounds(state.vehicle.pose, halfExtent), world.scene.parkBays.front()) ? 1U : 0U;
+			return blocked;
+		}
+
+		// The un-jittered script up to forkTicks, or until the car parks first
+		[[nodiscard]] SimSnapshot driveApproach(const TrialWorld& world, std::uint32_t forkTicks, FrameArena& scratch) {
+			SimSnapshot state;
+			state.vehicle = BicycleState{ world.scene.spawns.front(), 0.0F, 0.0F };
+			const auto nominal = []() { return 1.0F; };
+			while (state.tick < forkTicks && state.occupied == 0U) {
+				CarInput input = 0U;
+				const bool scripted = nextInput(world, state, nominal, input);
+				(void)stepTrial(world, state, input, scratch);
+				if (scripted) {
+					--state.segmentLeft;
+				}
+			}
+			return state;
+		}
+
+		void runTrial(const TrialWorld& world, const SimSnapshot& fork, std::uint32_t trial, std::mt19937_64& rng,
+			FrameArena& scratch, EvaluationResult& result)
+		{
+			const EvaluationConfig& config = world.config;
+			std::uniform_real_distribution<float> unit(0.0F, 1.0F);
+			std::uniform_real_distribution<float> spread(-1.0F, 1.0F);
+
+			// Restoring the shared state is one copy; the approach is not driven again
+			SimSnapshot state = fork;
+
+			// Uniform over the disc: radius by the square root of a uniform sample
+			const SinCos direction = sinCosDeg(360.0F * unit(rng));
+			const float radius = config.startJitter * std::sqrt(unit(rng));
+			state.vehicle.pose.position += sf::Vector2f{ direction.cos, direction.sin } * radius;
+			state.vehicle.pose.headingDeg += config.headingJitter * spread(rng);
+
+			const auto stretch = [&]() { return 1.0F + config.scriptJitter * spread(rng); };
+			if (state.segmentLeft > 0U) {
+				// Forked inside a segment: what is left of it is stretched as well
+				state.segmentLeft = static_cast<std::uint32_t>(
+					std::lround(static_cast<float>(state.segmentLeft) * std::max(stretch(), 0.0F)));
+			}
+
+			bool wasBlocked = false;
+			while (state.tick < world.tickLimit) {
+				CarInput input = 0U;
+				const bool scripted = nextInput(world, state, stretch, input);
+				const bool blocked = stepTrial(world, state, input, scratch);
+				if (blocked && !wasBlocked) {
+					logEvent(EventKind::Contact, state.tick, trial);
+				}
+				wasBlocked = blocked;
+
+				if (state.occupied != 0U) {
+					logEvent(EventKind::Entry, state.tick, trial, 0U);
+					const float seconds = static_cast<float>(state.tick) * world.tickDt;
+					++result.parked;
+					result.parkSecondsSum += seconds;
+					result.fastestPark = std::min(result.fastestPark, seconds);
+					result.slowestPark = std::max(result.slowestPark, seconds);
+					const auto bin = static_cast<std::size_t>(seconds / result.binSeconds);
+					++result.parkTimes[std::min(bin, EvaluationResult::TIME_BINS - 1U)];
+					break;
+				}
+
+				if (scripted) {
+					--state.segmentLeft;
+				}
+				else if (config.model == VehicleModel::Arcade || state.vehicle.speed == 0.0F) {
+					break; // script over and the car has come to rest: nothing changes any more
+				}
+			}
+
+			++result.trials;
+			if (state.blocked != 0U) {
+				++result.blocked;
+			}
+		}
+	}
+
+	void EvaluationResult::merge(const EvaluationResult& other) {
+		trials += other.trials;
+		parked += other.parked;
+		blocked += other.blocked;
+		parkSecondsSum += other.parkSecondsSum;
+		fastestPark = std::min(fastestPark, other.fastestPark);
+		slowestPark = std::max(slowestPark, other.slowestPark);
+		for (std::size_t i = 0U; i < TIME_BINS; ++i) {
+			parkTimes[i] += other.parkTimes[i];
+		}
+	}
+
+	double EvaluationResult::successRate() const noexcept {
+		return (trials > 0U) ? static_cast<double>(parked) / static_cast<double>(trials) : 0.0;
+	}
+
+	double EvaluationResult::meanParkSeconds() const noexcept {
+		return (parked > 0U) ? parkSecondsSum / static_cast<double>(parked) : 0.0;
+	}
+
+	float EvaluationResult::parkSecondsQuantile(float fraction) const noexcept {
+		const double target = static_cast<double>(parked) * static_cast<double>(std::clamp(fraction, 0.0F, 1.0F));
+		std::uint64_t seen = 0U;
+		for (std::size_t i = 0U; i < TIME_BINS; ++i) {
+			seen += parkTimes[i];
+			if (seen > 0U && static_cast<double>(seen) >= target) {
+				return static_cast<float>(i + 1U) * binSeconds;
+			}
+		}
+		return 0.0F;
+	}
+
+	EvaluationResult evaluateParking(const Scene& scene, const std::vector<TraceSegment>& script,
+		const EvaluationConfig& config, ThreadPool& pool)
+	{
+		OKPP_TRACE_SCOPE("evaluateParking");
+		const auto start = std::chrono::steady_clock::now();
+
+		TrialWorld world{ scene, script, config, CollisionWorld{},
+			CarParams{ constants::CAR_SPEED, constants::CAR_TURN_RATE }, BicycleParams{},
+			1.0F / config.tickHz, static_cast<std::uint32_t>(config.timeLimit * config.tickHz) };
+		world.collisionWorld.build(scene.obstacles, {}, constants::OBSTACLE_CELL_SIZE);
+
+		EvaluationResult total;
+		total.binSeconds = config.timeLimit / static_cast<float>(EvaluationResult::TIME_BINS);
+		if (scene.spawns.empty() || scene.parkBays.empty()) {
+			return total;
+		}
+
+		// All trials fork from one state: the spawn, or the end of the shared approach
+		FrameArena approachScratch(TRIAL_SCRATCH_BYTES);
+		const SimSnapshot fork = driveApproach(world,
+			std::min(static_cast<std::uint32_t>(std::max(config.forkAt, 0.0F) * config.tickHz), world.tickLimit), approachScratch);
+
+		const std::size_t blocks = (config.trials + TRIALS_PER_TASK - 1U) / TRIALS_PER_TASK;
+		std::vector<BlockResult> partials(blocks, BlockResult{ total });
+
+		TaskGroup group;
+		for (std::size_t block = 0U; block < blocks; ++block) {
+			pool.submit(group, [&world, &fork, &partials, &config, block]() {
+				OKPP_TRACE_SCOPE("trial block");
+				std::mt19937_64 rng(mixSeed(config.seed ^ mixSeed(block)));
+				FrameArena scratch(TRIAL_SCRATCH_BYTES);
+				EvaluationResult& result = partials[block].result;
+				const std::size_t end = std::min(config.trials, (block + 1U) * TRIALS_PER_TASK);
+				for (std::size_t trial = block * TRIALS_PER_TASK; trial < end; ++trial) {
+					runTrial(world, fork, static_cast<std::uint32_t>(trial), rng, scratch, result);
+				}
+			});
+		}
+		pool.wait(group);
+
+		for (const auto& partial : partials) {
+			total.merge(partial.result);
+		}
+		total.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return total;
+	}
+
+} // namespace sim
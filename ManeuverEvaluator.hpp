@@ -0,0 +1,82 @@
+/*
+==============================================================================
+Maneuver Evaluator - Monte-Carlo success rate of a parking maneuver
+==============================================================================
+ - Each trial starts from a random pose around the scene spawn and drives
+   a randomly stretched copy of the steering script, until the car sits
+   in the first bay (the parking indicator turns green) or time runs out
+ - Trials run headless on all cores as pool tasks; idle workers steal
+   blocks of trials from busy ones
+ - Every block of trials owns its random stream and its result buffer,
+   so the hot path shares nothing and takes no lock; blocks are merged
+   once at the end. Streams depend only on the seed and the block, so a
+   seed gives the same result for any thread count.
+ - With forkAt set, the un-jittered approach is simulated once up to that
+   time and every trial restores its SimSnapshot instead of re-driving
+   it; the jitter is then applied to the forked pose and the rest of the
+   script
+ - With the event log on (EventLog), each trial logs the first tick of every
+   contact with a pillar and its bay entry, with the trial index as the car
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "SimFwd.hpp"
+#include "VehicleDynamics.hpp"
+
+namespace sim {
+
+	struct EvaluationConfig {
+		std::size_t trials = 1000U;
+		std::uint64_t seed = 1U;
+		float tickHz = 60.0F;
+		float timeLimit = 30.0F;      // seconds; a trial that has not parked by then fails
+		float startJitter = 30.0F;    // pixels, start positions fill a disc around the spawn
+		float headingJitter = 3.0F;   // degrees either way from the spawn heading
+		float scriptJitter = 0.05F;   // every script segment is stretched by 1 +- this
+		float forkAt = 0.0F;          // seconds of shared approach the trials fork from (0 = the spawn)
+		VehicleModel model = VehicleModel::Arcade;
+	};
+
+	struct EvaluationResult {
+		static constexpr std::size_t TIME_BINS = 240U; // time-to-park histogram over the time limit
+
+		std::uint64_t trials = 0U;
+		std::uint64_t parked = 0U;
+		std::uint64_t blocked = 0U;  // trials stopped by a pillar at least once
+		double parkSecondsSum = 0.0; // over the parked trials
+		float fastestPark = std::numeric_limits<float>::max();
+		float slowestPark = 0.0F;
+		float binSeconds = 0.0F;
+		std::array<std::uint32_t, TIME_BINS> parkTimes{};
+		double wallSeconds = 0.0;
+
+		void merge(const EvaluationResult& other);
+
+		[[nodiscard]] double successRate() const noexcept;
+		[[nodiscard]] double meanParkSeconds() const noexcept;
+
+		/**
+		 * @brief Time by which the given fraction (0..1) of the parked trials
+		 *        had parked, to histogram bin resolution.
+		 */
+		[[nodiscard]] float parkSecondsQuantile(float fraction) const noexcept;
+	};
+
+	/**
+	 * @brief Runs config.trials randomized trials of script over scene on the pool.
+	 *
+	 * An empty script is treated as "no input" (the car never parks unless
+	 * it spawns in the bay).
+	 */
+	[[nodiscard]] EvaluationResult evaluateParking(const Scene& scene, const std::vector<TraceSegment>& script,
+		const EvaluationConfig& config, ThreadPool& pool);
+
+} // namespace sim
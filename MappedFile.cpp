@@ -0,0 +1,110 @@
+#include "MappedFile.hpp"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace assets {
+
+#ifdef _WIN32
+	bool MappedFile::open(const std::string& path) {
+		close();
+
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			std::cerr << "Error: Failed to open " << path << '\n';
+			return false;
+		}
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size)) {
+			std::cerr << "Error: Failed to query the size of " << path << '\n';
+			CloseHandle(file);
+			return false;
+		}
+		m_file = file;
+		if (size.QuadPart == 0) {
+			return true; // an empty file cannot be mapped, but is still valid
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* view = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view == nullptr) {
+			std::cerr << "Error: Failed to map " << path << '\n';
+			if (mapping != nullptr) {
+				CloseHandle(mapping);
+			}
+			close();
+			return false;
+		}
+		m_mapping = mapping;
+		m_data = static_cast<const unsigned char*>(view);
+		m_size = static_cast<std::size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::close() {
+		if (m_data != nullptr) {
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping != nullptr) {
+			CloseHandle(m_mapping);
+		}
+		if (m_file != nullptr) {
+			CloseHandle(m_file);
+		}
+		m_data = nullptr;
+		m_size = 0U;
+		m_mapping = nullptr;
+		m_file = nullptr;
+	}
+#else
+	bool MappedFile::open(const std::string& path) {
+		close();
+
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			std::cerr << "Error: Failed to open " << path << '\n';
+			return false;
+		}
+		struct stat info {};
+		if (fstat(fd, &info) != 0) {
+			std::cerr << "Error: Failed to query the size of " << path << '\n';
+			::close(fd);
+			return false;
+		}
+		if (info.st_size == 0) {
+			::close(fd);
+			return true; // an empty file cannot be mapped, but is still valid
+		}
+
+		void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); // the mapping keeps its own reference to the file
+		if (view == MAP_FAILED) {
+			std::cerr << "Error: Failed to map " << path << '\n';
+			return false;
+		}
+		m_data = static_cast<const unsigned char*>(view);
+		m_size = static_cast<std::size_t>(info.st_size);
+		return true;
+	}
+
+	void MappedFile::close() {
+		if (m_data != nullptr) {
+			munmap(const_cast<unsigned char*>(m_data), m_size);
+		}
+		m_data = nullptr;
+		m_size = 0U;
+	}
+#endif
+
+} // namespace assets
@@ -0,0 +1,47 @@
+/*
+==============================================================================
+Mapped File - read-only memory mapping of a whole file
+==============================================================================
+ - The OS pages the file in on demand: no read() copy into a buffer and no
+   allocation proportional to the file size
+ - Win32 file mapping on Windows, mmap() everywhere else
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace assets {
+
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile() { close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * @brief Maps path read-only, replacing any previous mapping.
+		 *
+		 * Returns false (and logs) if the file cannot be opened or mapped.
+		 * An empty file maps successfully with size() == 0.
+		 */
+		[[nodiscard]] bool open(const std::string& path);
+		void close();
+
+		[[nodiscard]] const unsigned char* data() const noexcept { return m_data; }
+		[[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+	private:
+		const unsigned char* m_data = nullptr;
+		std::size_t m_size = 0U;
+#ifdef _WIN32
+		void* m_file = nullptr;    // HANDLE of the open file
+		void* m_mapping = nullptr; // HANDLE of the file mapping object
+#endif
+	};
+
+} // namespace assets
@@ -0,0 +1,48 @@
+#include "MemoryAccounting.hpp"
+
+#include <atomic>
+
+namespace prof {
+
+	namespace {
+		// [subsystem][kind]; namespace-scope atomics are zero-initialized before any allocation
+		std::atomic<std::int64_t> g_memoryCounters[MEMORY_SUBSYSTEM_COUNT][2];
+		std::atomic<std::uint64_t> g_allocations{ 0U };
+	}
+
+	const char* memorySubsystemName(MemorySubsystem subsystem) {
+		switch (subsystem) {
+		case MemorySubsystem::Textures: return "TEXTURES";
+		case MemorySubsystem::AudioBuffers: return "AUDIO";
+		case MemorySubsystem::Obstacles: return "OBSTACLES";
+		case MemorySubsystem::RenderBuffers: return "BUFFERS";
+		case MemorySubsystem::FrameArenas: return "ARENAS";
+		default: return "?";
+		}
+	}
+
+	void trackMemory(MemorySubsystem subsystem, MemoryKind kind, std::int64_t bytes) noexcept {
+		if (bytes != 0) {
+			g_memoryCounters[static_cast<std::size_t>(subsystem)][static_cast<std::size_t>(kind)].fetch_add(bytes,
+				std::memory_order_relaxed);
+		}
+	}
+
+	MemoryUsage memoryUsage() noexcept {
+		MemoryUsage usage;
+		for (std::size_t i = 0U; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+			usage.heap[i] = g_memoryCounters[i][static_cast<std::size_t>(MemoryKind::Heap)].load(std::memory_order_relaxed);
+			usage.video[i] = g_memoryCounters[i][static_cast<std::size_t>(MemoryKind::Video)].load(std::memory_order_relaxed);
+		}
+		return usage;
+	}
+
+	void countAllocation() noexcept {
+		g_allocations.fetch_add(1U, std::memory_order_relaxed);
+	}
+
+	std::uint64_t allocationCount() noexcept {
+		return g_allocations.load(std::memory_order_relaxed);
+	}
+
+} // namespace prof
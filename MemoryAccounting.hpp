@@ -0,0 +1,168 @@
+/*
+==============================================================================
+Memory Accounting - heap and VRAM usage attributed to subsystems
+==============================================================================
+ - One pair of counters (heap, video) per subsystem: textures, audio
+   buffers, obstacle indices, render buffers and per-frame arenas; RSS
+   growth on large lots can be traced to whichever one grows
+ - TrackingAllocator counts a container's heap bytes against its
+   subsystem; TrackedVector is the std::vector spelling of it
+ - MemoryCharge holds a byte count against a subsystem for as long as it
+   lives, for memory no allocator sees (GL textures and buffers, SFML's
+   own sample and vertex storage); set() moves it to a new size
+ - The counters are relaxed atomics: safe from any thread, and a read is
+   a snapshot that may be a moment out of date
+ - allocationCount() counts every heap allocation in binaries whose
+   replacement operator new calls countAllocation() (the perf gate); it
+   stays 0 elsewhere
+ - No SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace prof {
+
+	enum class MemorySubsystem : std::uint8_t {
+		Textures,      // sprite atlas pages, cached layers and the minimap, heatmap and glyph atlases
+		AudioBuffers,  // decoded beep samples
+		Obstacles,     // obstacle grid and store arrays
+		RenderBuffers, // vertex, instance and tile buffers
+		FrameArenas,   // per-frame scratch blocks
+		Count
+	};
+
+	enum class MemoryKind : std::uint8_t {
+		Heap,
+		Video
+	};
+
+	constexpr std::size_t MEMORY_SUBSYSTEM_COUNT = static_cast<std::size_t>(MemorySubsystem::Count);
+
+	/**
+	 * @brief Upper-case label of a subsystem (used by the overlay).
+	 */
+	[[nodiscard]] const char* memorySubsystemName(MemorySubsystem subsystem);
+
+	// Bytes per subsystem at one moment
+	struct MemoryUsage {
+		std::array<std::int64_t, MEMORY_SUBSYSTEM_COUNT> heap{};
+		std::array<std::int64_t, MEMORY_SUBSYSTEM_COUNT> video{};
+	};
+
+	/**
+	 * @brief GPU bytes of an uncompressed RGBA8 texture without mipmaps.
+	 */
+	[[nodiscard]] constexpr std::size_t rgbaTextureBytes(std::size_t width, std::size_t height) noexcept {
+		return width * height * 4U;
+	}
+
+	/**
+	 * @brief Adds bytes (negative to release) to a subsystem's counter.
+	 */
+	void trackMemory(MemorySubsystem subsystem, MemoryKind kind, std::int64_t bytes) noexcept;
+
+	/**
+	 * @brief Snapshot of every counter.
+	 */
+	[[nodiscard]] MemoryUsage memoryUsage() noexcept;
+
+	/**
+	 * @brief Counts one heap allocation; called from a binary's replacement operator new.
+	 */
+	void countAllocation() noexcept;
+
+	/**
+	 * @brief Heap allocations counted so far (0 unless the binary counts them).
+	 */
+	[[nodiscard]] std::uint64_t allocationCount() noexcept;
+
+	/**
+	 * @brief std::allocator that counts what it hands out against Subsystem's heap.
+	 */
+	template <typename T, MemorySubsystem Subsystem>
+	class TrackingAllocator {
+	public:
+		using value_type = T;
+
+		template <typename U>
+		struct rebind {
+			using other = TrackingAllocator<U, Subsystem>;
+		};
+
+		TrackingAllocator() noexcept = default;
+		template <typename U>
+		TrackingAllocator(const TrackingAllocator<U, Subsystem>&) noexcept {}
+
+		[[nodiscard]] T* allocate(std::size_t count) {
+			T* const memory = std::allocator<T>{}.allocate(count);
+			trackMemory(Subsystem, MemoryKind::Heap, static_cast<std::int64_t>(count * sizeof(T)));
+			return memory;
+		}
+
+		void deallocate(T* memory, std::size_t count) noexcept {
+			trackMemory(Subsystem, MemoryKind::Heap, -static_cast<std::int64_t>(count * sizeof(T)));
+			std::allocator<T>{}.deallocate(memory, count);
+		}
+
+		template <typename U>
+		[[nodiscard]] bool operator==(const TrackingAllocator<U, Subsystem>&) const noexcept { return true; }
+		template <typename U>
+		[[nodiscard]] bool operator!=(const TrackingAllocator<U, Subsystem>&) const noexcept { return false; }
+	};
+
+	template <typename T, MemorySubsystem Subsystem>
+	using TrackedVector = std::vector<T, TrackingAllocator<T, Subsystem>>;
+
+	/**
+	 * @brief Bytes held against a subsystem while the charge lives.
+	 *
+	 * Move-only; the moved-from charge holds nothing.
+	 */
+	class MemoryCharge {
+	public:
+		MemoryCharge(MemorySubsystem subsystem, MemoryKind kind) noexcept
+			: m_subsystem(subsystem), m_kind(kind) {
+		}
+		~MemoryCharge() { set(0U); }
+
+		MemoryCharge(MemoryCharge&& other) noexcept
+			: m_subsystem(other.m_subsystem), m_kind(other.m_kind), m_bytes(other.m_bytes) {
+			other.m_bytes = 0U;
+		}
+		MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+			if (this != &other) {
+				set(0U);
+				m_subsystem = other.m_subsystem;
+				m_kind = other.m_kind;
+				m_bytes = other.m_bytes;
+				other.m_bytes = 0U;
+			}
+			return *this;
+		}
+		MemoryCharge(const MemoryCharge&) = delete;
+		MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+		/**
+		 * @brief Charges bytes from now on in place of the previous amount.
+		 */
+		void set(std::size_t bytes) noexcept {
+			trackMemory(m_subsystem, m_kind, static_cast<std::int64_t>(bytes) - static_cast<std::int64_t>(m_bytes));
+			m_bytes = bytes;
+		}
+
+		[[nodiscard]] std::size_t bytes() const noexcept { return m_bytes; }
+
+	private:
+		MemorySubsystem m_subsystem;
+		MemoryKind m_kind;
+		std::size_t m_bytes = 0U;
+	};
+
+} // namespace prof
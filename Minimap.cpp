@@ -0,0 +1,372 @@
+#include "Minimap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "ObstacleRenderer.hpp"
+#include "Trace.hpp"
+
+namespace gfx {
+
+	namespace {
+		// Atlas of ATLAS_SLOTS_PER_ROW^2 tile images, TILE_PIXELS square each
+		constexpr unsigned TILE_PIXELS = 256U;
+		constexpr unsigned ATLAS_SLOTS_PER_ROW = 8U;
+
+		// Tiles rendered per frame at most, so a rebuild is spread over a few frames
+		constexpr std::size_t TILES_PER_FRAME = 4U;
+
+		// The whole lot fits a box this large in the window's top-right corner
+		constexpr float MAP_PIXELS = 256.0F;
+		constexpr float MAP_MARGIN = 12.0F;
+		constexpr float ZOOM_STEP = 1.25F;
+
+		constexpr float CAR_DOT_PIXELS = 3.0F;
+		constexpr std::size_t MAX_PILLAR_POINTS = 30U;
+
+		const sf::Color MAP_BACKGROUND(30, 30, 30);
+		const sf::Color MAP_FRAME(200, 200, 200);
+		const sf::Color MAP_PILLAR = sf::Color::White;
+		const sf::Color MAP_BAY_FREE(0, 255, 0, 100);
+		const sf::Color MAP_BAY_TAKEN(255, 0, 0, 100);
+		const sf::Color MAP_CAR(255, 220, 0);
+
+		// FNV-1a over the bytes of one value
+		template <typename T>
+		void hashInto(std::uint64_t& hash, const T& value) {
+			unsigned char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+			for (const unsigned char byte : bytes) {
+				hash = (hash ^ byte) * 0x100000001B3ULL;
+			}
+		}
+
+		void appendRect(sf::VertexArray& out, const sf::Vector2f& low, const sf::Vector2f& high, sf::Color color) {
+			const sf::Vector2f corners[4] = { low, { high.x, low.y }, high, { low.x, high.y } };
+			for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+				out.append(sf::Vertex{ corners[corner], color });
+			}
+		}
+
+		void appendOutline(sf::VertexArray& out, const sf::FloatRect& rect, float thickness, sf::Color color) {
+			const sf::Vector2f low = rect.position;
+			const sf::Vector2f high = rect.position + rect.size;
+			appendRect(out, low, { high.x, low.y + thickness }, color);
+			appendRect(out, { low.x, high.y - thickness }, high, color);
+			appendRect(out, low, { low.x + thickness, high.y }, color);
+			appendRect(out, { high.x - thickness, low.y }, high, color);
+		}
+	}
+
+	bool Minimap::create(const sf::FloatRect& lot, float tileSize) {
+		m_atlas.reset();
+		m_videoCharge.set(0U);
+		m_tiles.clear();
+		m_shownLow = {};
+		m_shownHigh = { -1, -1 };
+		if (!(tileSize > 0.0F) || lot.size.x <= 0.0F || lot.size.y <= 0.0F) {
+			std::cerr << "Error: minimap needs a positive tile size and a non-empty lot\n";
+			return false;
+		}
+
+		sf::RenderTexture atlas;
+		const unsigned side = TILE_PIXELS * ATLAS_SLOTS_PER_ROW;
+		if (!atlas.resize({ side, side })) {
+			std::cerr << "Error: Failed to create a " << side << 'x' << side << " minimap atlas, the minimap is off\n";
+			return false;
+		}
+		atlas.setSmooth(true);
+		m_atlas.emplace(std::move(atlas));
+		m_videoCharge.set(prof::rgbaTextureBytes(side, side));
+		m_slotsPerRow = ATLAS_SLOTS_PER_ROW;
+		m_slotOwner.assign(static_cast<std::size_t>(m_slotsPerRow) * m_slotsPerRow, -1);
+
+		m_lot = lot;
+		m_tileSize = tileSize;
+		m_cols = static_cast<int>(std::ceil(lot.size.x / tileSize));
+		m_rows = static_cast<int>(std::ceil(lot.size.y / tileSize));
+		m_tiles.resize(static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows));
+		for (int y = 0; y < m_rows; ++y) {
+			for (int x = 0; x < m_cols; ++x) {
+				Tile& tile = m_tiles[static_cast<std::size_t>(y * m_cols + x)];
+				tile.area = { lot.position + sf::Vector2f{ static_cast<float>(x), static_cast<float>(y) } * tileSize,
+					{ tileSize, tileSize } };
+			}
+		}
+		setScene({}, {});
+		return true;
+	}
+
+	void Minimap::setScene(const std::vector<sim::Obstacle>& obstacles, const std::vector<sf::FloatRect>& bays) {
+		if (m_tiles.empty()) {
+			return;
+		}
+		m_obstacles = obstacles;
+		m_bays = bays;
+		m_occupied.assign(bays.size(), 0U);
+		for (Tile& tile : m_tiles) {
+			tile.obstacles.clear();
+			tile.bays.clear();
+		}
+
+		// Every shape goes to each tile it overlaps, so nothing is clipped at a tile edge
+		const auto forTiles = [this](const sf::FloatRect& rect, auto&& fn) {
+			const auto toCell = [this](float offset, int cells) {
+				return static_cast<int>(std::clamp(std::floor(offset / m_tileSize), 0.0F, static_cast<float>(cells - 1)));
+			};
+			const int x0 = toCell(rect.position.x - m_lot.position.x, m_cols);
+			const int x1 = toCell(rect.position.x + rect.size.x - m_lot.position.x, m_cols);
+			const int y0 = toCell(rect.position.y - m_lot.position.y, m_rows);
+			const int y1 = toCell(rect.position.y + rect.size.y - m_lot.position.y, m_rows);
+			for (int y = y0; y <= y1; ++y) {
+				for (int x = x0; x <= x1; ++x) {
+					fn(m_tiles[static_cast<std::size_t>(y * m_cols + x)]);
+				}
+			}
+		};
+		for (std::size_t i = 0U; i < m_obstacles.size(); ++i) {
+			const sim::Obstacle& obstacle = m_obstacles[i];
+			const sf::Vector2f half{ obstacle.radius, obstacle.radius };
+			forTiles({ obstacle.center - half, half * 2.0F },
+				[i](Tile& tile) { tile.obstacles.push_back(static_cast<std::uint32_t>(i)); });
+		}
+		for (std::size_t i = 0U; i < m_bays.size(); ++i) {
+			forTiles(m_bays[i], [i](Tile& tile) { tile.bays.push_back(static_cast<std::uint32_t>(i)); });
+		}
+
+		for (Tile& tile : m_tiles) {
+			tile.signature = signatureOf(tile);
+		}
+	}
+
+	void Minimap::setOccupied(const std::vector<std::uint8_t>& occupied) {
+		bool changed = false;
+		for (std::size_t bay = 0U; bay < m_occupied.size(); ++bay) {
+			const std::uint8_t value = (bay < occupied.size() && occupied[bay] != 0U) ? 1U : 0U;
+			changed = changed || value != m_occupied[bay];
+			m_occupied[bay] = value;
+		}
+		if (!changed) {
+			return;
+		}
+		// Only tiles holding a bay can change; the rest keep their signature
+		for (Tile& tile : m_tiles) {
+			if (!tile.bays.empty()) {
+				tile.signature = signatureOf(tile);
+			}
+		}
+	}
+
+	std::uint64_t Minimap::signatureOf(const Tile& tile) const {
+		std::uint64_t hash = 0xCBF29CE484222325ULL;
+		hashInto(hash, tile.obstacles.size());
+		for (const std::uint32_t i : tile.obstacles) {
+			hashInto(hash, m_obstacles[i].center.x);
+			hashInto(hash, m_obstacles[i].center.y);
+			hashInto(hash, m_obstacles[i].radius);
+		}
+		hashInto(hash, tile.bays.size());
+		for (const std::uint32_t i : tile.bays) {
+			hashInto(hash, m_bays[i].position.x);
+			hashInto(hash, m_bays[i].position.y);
+			hashInto(hash, m_bays[i].size.x);
+			hashInto(hash, m_bays[i].size.y);
+			hashInto(hash, m_occupied[i]);
+		}
+		return hash;
+	}
+
+	void Minimap::zoom(float steps) {
+		m_zoom = std::clamp(m_zoom * std::pow(ZOOM_STEP, steps), 1.0F, MAX_ZOOM);
+	}
+
+	bool Minimap::renderStale(std::size_t maxTiles) {
+		if (!m_atlas || m_tiles.empty()) {
+			return true;
+		}
+		std::size_t renders = 0U;
+		m_pending = false;
+		for (int y = m_shownLow.y; y <= m_shownHigh.y; ++y) {
+			for (int x = m_shownLow.x; x <= m_shownHigh.x; ++x) {
+				const auto index = static_cast<std::size_t>(y * m_cols + x);
+				const Tile& tile = m_tiles[index];
+				if (tile.slot >= 0 && tile.rendered == tile.signature) {
+					continue;
+				}
+				if (renders == maxTiles) {
+					m_pending = true;
+					continue;
+				}
+				render(index);
+				++renders;
+			}
+		}
+		if (renders > 0U) {
+			m_atlas->display();
+		}
+		return !m_pending;
+	}
+
+	int Minimap::acquireSlot(std::size_t tile) {
+		int slot = -1;
+		std::uint64_t oldest = m_frame;
+		for (std::size_t s = 0U; s < m_slotOwner.size(); ++s) {
+			const int owner = m_slotOwner[s];
+			if (owner < 0) {
+				slot = static_cast<int>(s);
+				break;
+			}
+			// Tiles shown this frame keep their slot
+			const std::uint64_t shown = m_tiles[static_cast<std::size_t>(owner)].lastShown;
+			if (shown < oldest) {
+				oldest = shown;
+				slot = static_cast<int>(s);
+			}
+		}
+		if (slot < 0) {
+			return -1;
+		}
+		const int previous = m_slotOwner[static_cast<std::size_t>(slot)];
+		if (previous >= 0) {
+			m_tiles[static_cast<std::size_t>(previous)].slot = -1;
+		}
+		m_slotOwner[static_cast<std::size_t>(slot)] = static_cast<int>(tile);
+		return slot;
+	}
+
+	void Minimap::render(std::size_t index) {
+		Tile& tile = m_tiles[index];
+		if (tile.slot < 0) {
+			tile.slot = acquireSlot(index);
+			if (tile.slot < 0) {
+				return;
+			}
+		}
+
+		const auto slot = static_cast<unsigned>(tile.slot);
+		const float atlasSide = static_cast<float>(m_slotsPerRow);
+		sf::View view(tile.area);
+		view.setViewport({ { static_cast<float>(slot % m_slotsPerRow) / atlasSide,
+			static_cast<float>(slot / m_slotsPerRow) / atlasSide }, { 1.0F / atlasSide, 1.0F / atlasSide } });
+		m_atlas->setView(view);
+
+		const float unitPixels = static_cast<float>(TILE_PIXELS) / m_tileSize;
+		m_shapes.clear();
+		appendRect(m_shapes, tile.area.position, tile.area.position + tile.area.size, MAP_BACKGROUND);
+		for (const std::uint32_t i : tile.bays) {
+			const sf::FloatRect& bay = m_bays[i];
+			appendRect(m_shapes, bay.position, bay.position + bay.size, (m_occupied[i] != 0U) ? MAP_BAY_TAKEN : MAP_BAY_FREE);
+			appendOutline(m_shapes, bay, 1.0F / unitPixels, sf::Color::White);
+		}
+		for (const std::uint32_t i : tile.obstacles) {
+			const sim::Obstacle& obstacle = m_obstacles[i];
+			const std::size_t points = circlePointCount(obstacle.radius * unitPixels, MAX_PILLAR_POINTS);
+			constexpr float TWO_PI = 6.28318530717958647692F;
+			for (std::size_t p = 0U; p < points; ++p) {
+				const float a0 = TWO_PI * static_cast<float>(p) / static_cast<float>(points);
+				const float a1 = TWO_PI * static_cast<float>(p + 1U) / static_cast<float>(points);
+				m_shapes.append(sf::Vertex{ obstacle.center, MAP_PILLAR });
+				m_shapes.append(sf::Vertex{ obstacle.center + sf::Vector2f{ std::cos(a0), std::sin(a0) } * obstacle.radius, MAP_PILLAR });
+				m_shapes.append(sf::Vertex{ obstacle.center + sf::Vector2f{ std::cos(a1), std::sin(a1) } * obstacle.radius, MAP_PILLAR });
+			}
+		}
+		m_atlas->draw(m_shapes);
+
+		tile.rendered = tile.signature;
+		++m_renderedTiles;
+	}
+
+	void Minimap::draw(sf::RenderTarget& target, const sf::Vector2f& focus, const sf::View& camera) {
+		if (!m_atlas || m_tiles.empty()) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("minimap");
+		++m_frame;
+
+		// Screen box of the whole lot, and the part of the lot the zoom shows in it
+		const float scale = std::min(MAP_PIXELS / m_lot.size.x, MAP_PIXELS / m_lot.size.y);
+		const sf::Vector2f box = m_lot.size * scale;
+		const sf::Vector2f shownSize = m_lot.size / m_zoom;
+		const sf::Vector2f lotHigh = m_lot.position + m_lot.size - shownSize / 2.0F;
+		const sf::Vector2f lotLow = m_lot.position + shownSize / 2.0F;
+		const sf::Vector2f center{ std::clamp(focus.x, lotLow.x, std::max(lotLow.x, lotHigh.x)),
+			std::clamp(focus.y, lotLow.y, std::max(lotLow.y, lotHigh.y)) };
+		const sf::FloatRect shown{ center - shownSize / 2.0F, shownSize };
+
+		const int x0 = std::max(static_cast<int>((shown.position.x - m_lot.position.x) / m_tileSize), 0);
+		const int y0 = std::max(static_cast<int>((shown.position.y - m_lot.position.y) / m_tileSize), 0);
+		const int x1 = std::min(static_cast<int>((shown.position.x + shown.size.x - m_lot.position.x) / m_tileSize), m_cols - 1);
+		const int y1 = std::min(static_cast<int>((shown.position.y + shown.size.y - m_lot.position.y) / m_tileSize), m_rows - 1);
+
+		// Visible tiles claim their slots first, then the stale ones are re-rendered
+		m_shownLow = { x0, y0 };
+		m_shownHigh = { x1, y1 };
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				m_tiles[static_cast<std::size_t>(y * m_cols + x)].lastShown = m_frame;
+			}
+		}
+		(void)renderStale(m_deferred ? 0U : TILES_PER_FRAME);
+
+		// One textured quad per visible tile that has an image, stale or not
+		const float texSide = static_cast<float>(TILE_PIXELS);
+		m_batch.clear();
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				const Tile& tile = m_tiles[static_cast<std::size_t>(y * m_cols + x)];
+				if (tile.slot < 0) {
+					continue;
+				}
+				const auto slot = static_cast<unsigned>(tile.slot);
+				const sf::Vector2f tex{ static_cast<float>(slot % m_slotsPerRow) * texSide,
+					static_cast<float>(slot / m_slotsPerRow) * texSide };
+				const sf::Vector2f low = tile.area.position;
+				const sf::Vector2f high = tile.area.position + tile.area.size;
+				const sf::Vector2f corners[4] = { low, { high.x, low.y }, high, { low.x, high.y } };
+				const sf::Vector2f texCorners[4] = { tex, tex + sf::Vector2f{ texSide, 0.0F },
+					tex + sf::Vector2f{ texSide, texSide }, tex + sf::Vector2f{ 0.0F, texSide } };
+				for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+					m_batch.append(sf::Vertex{ corners[corner], sf::Color::White, texCorners[corner] });
+				}
+			}
+		}
+
+		const sf::View saved = target.getView();
+		const sf::Vector2f targetSize(target.getSize());
+
+		// Frame in window pixels
+		target.setView(sf::View(sf::FloatRect{ { 0.0F, 0.0F }, targetSize }));
+		sf::RectangleShape frame(box);
+		frame.setPosition({ targetSize.x - MAP_MARGIN - box.x, MAP_MARGIN });
+		frame.setFillColor(MAP_BACKGROUND);
+		frame.setOutlineThickness(1.0F);
+		frame.setOutlineColor(MAP_FRAME);
+		target.draw(frame);
+
+		// Tiles, car and camera outline in world units, clipped to the frame
+		sf::View mapView(shown);
+		mapView.setViewport({ { frame.getPosition().x / targetSize.x, frame.getPosition().y / targetSize.y },
+			{ box.x / targetSize.x, box.y / targetSize.y } });
+		target.setView(mapView);
+		target.draw(m_batch, sf::RenderStates(&m_atlas->getTexture()));
+
+		const float worldPerPixel = shown.size.x / box.x;
+		sf::RectangleShape outline(camera.getSize());
+		outline.setPosition(camera.getCenter() - camera.getSize() / 2.0F);
+		outline.setFillColor(sf::Color::Transparent);
+		outline.setOutlineThickness(worldPerPixel);
+		outline.setOutlineColor(MAP_FRAME);
+		target.draw(outline);
+
+		sf::CircleShape car(CAR_DOT_PIXELS * worldPerPixel, 8U);
+		car.setOrigin({ car.getRadius(), car.getRadius() });
+		car.setPosition(focus);
+		car.setFillColor(MAP_CAR);
+		target.draw(car);
+
+		target.setView(saved);
+	}
+
+} // namespace gfx
@@ -0,0 +1,128 @@
+/*
+==============================================================================
+Minimap - zoomable overview of the whole lot from cached tile images (M)
+==============================================================================
+ - The lot is cut into square tiles; each tile is drawn once into a slot of
+   one atlas render texture and then reused frame after frame, so the map
+   costs one textured batch, not a redraw of every pillar and bay
+ - Every tile keeps a signature of what it shows (pillars, bays and their
+   occupancy); a rebuild or a bay flip only re-renders the tiles whose
+   signature changed
+ - Tiles are rendered lazily, only once visible in the map and at most a
+   few per frame; when the atlas is full the least recently shown tile
+   gives up its slot. Deferred, draw() renders none and leaves them to
+   renderStale(), which the main loop runs as budgeted work after display
+ - The map follows the car, zoomed between the whole lot and a few tiles
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+#include "SimTypes.hpp"
+
+namespace gfx {
+
+	class Minimap {
+	public:
+		/**
+		 * @brief Covers lot with tiles of tileSize world units.
+		 *
+		 * Requires an active GL context. Returns false (and logs) if the atlas
+		 * cannot be created; the map then stays hidden.
+		 * MISRA: tileSize must be strictly positive; returns false otherwise.
+		 */
+		[[nodiscard]] bool create(const sf::FloatRect& lot, float tileSize);
+
+		/**
+		 * @brief Replaces the pillars and bays; only tiles whose content changed are re-rendered.
+		 *
+		 * Bay occupancy is reset to free.
+		 */
+		void setScene(const std::vector<sim::Obstacle>& obstacles, const std::vector<sf::FloatRect>& bays);
+
+		/**
+		 * @brief Sets which bays are occupied (one byte per bay); tiles of flipped bays are re-rendered.
+		 */
+		void setOccupied(const std::vector<std::uint8_t>& occupied);
+
+		/**
+		 * @brief Zooms in (steps > 0) or out, between the whole lot and MAX_ZOOM.
+		 */
+		void zoom(float steps);
+
+		/**
+		 * @brief Renders the visible dirty tiles, then draws the map in target's corner.
+		 *
+		 * camera is outlined on the map. The target's view is restored afterwards.
+		 */
+		void draw(sf::RenderTarget& target, const sf::Vector2f& focus, const sf::View& camera);
+
+		/**
+		 * @brief With deferred set, draw() shows what the tiles hold and renders no stale tile itself.
+		 */
+		void setDeferred(bool deferred) noexcept { m_deferred = deferred; }
+
+		/**
+		 * @brief Re-renders up to maxTiles stale tiles of those the last draw() showed;
+		 *        true once none of them is stale.
+		 */
+		bool renderStale(std::size_t maxTiles);
+
+		[[nodiscard]] bool ready() const noexcept { return m_atlas.has_value(); }
+		[[nodiscard]] std::size_t tileCount() const noexcept { return m_tiles.size(); }
+		[[nodiscard]] std::uint64_t renderedTiles() const noexcept { return m_renderedTiles; }
+		// Visible tiles were left stale by the last draw; another frame is needed
+		[[nodiscard]] bool pending() const noexcept { return m_pending; }
+
+	private:
+		static constexpr float MAX_ZOOM = 8.0F;
+
+		struct Tile {
+			sf::FloatRect area;
+			std::vector<std::uint32_t> obstacles; // every pillar overlapping the tile
+			std::vector<std::uint32_t> bays;
+			std::uint64_t signature = 0U; // of the content currently wanted
+			std::uint64_t rendered = 0U;  // of the content in the slot
+			int slot = -1;                // atlas slot, -1 if none
+			std::uint64_t lastShown = 0U;
+		};
+
+		[[nodiscard]] std::uint64_t signatureOf(const Tile& tile) const;
+		[[nodiscard]] int acquireSlot(std::size_t tile);
+		void render(std::size_t tile);
+
+		std::optional<sf::RenderTexture> m_atlas;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Video };
+		unsigned m_slotsPerRow = 0U;
+		std::vector<int> m_slotOwner; // tile in each slot, -1 if free
+
+		sf::FloatRect m_lot;
+		float m_tileSize = 1.0F;
+		int m_cols = 0;
+		int m_rows = 0;
+		std::vector<Tile> m_tiles;
+
+		std::vector<sim::Obstacle> m_obstacles;
+		std::vector<sf::FloatRect> m_bays;
+		std::vector<std::uint8_t> m_occupied;
+
+		float m_zoom = 1.0F;
+		std::uint64_t m_frame = 0U;
+		std::uint64_t m_renderedTiles = 0U;
+		bool m_pending = false;
+		bool m_deferred = false;
+		sf::Vector2i m_shownLow;  // tile range the last draw() showed
+		sf::Vector2i m_shownHigh{ -1, -1 };
+		sf::VertexArray m_batch{ sf::PrimitiveType::Triangles };
+		sf::VertexArray m_shapes{ sf::PrimitiveType::Triangles }; // scratch for one tile render
+	};
+
+} // namespace gfx
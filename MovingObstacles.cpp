@@ -0,0 +1,304 @@
+#include "MovingObstacles.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "DeterministicMath.hpp"
+
+namespace sim {
+
+	namespace {
+		// Keeps the grid bounded when the area is huge compared to the cell edge
+		constexpr float LOOSE_MAX_CELLS_PER_AXIS = 4096.0F;
+
+		// Clamp before float->int conversion so far-away queries stay defined
+		constexpr float LOOSE_MAX_CELL_COORD = 1.0e6F;
+
+		[[nodiscard]] int looseCellCoord(float offset, float invCellSize) {
+			const float c = std::floor(offset * invCellSize);
+			return static_cast<int>(std::clamp(c, -LOOSE_MAX_CELL_COORD, LOOSE_MAX_CELL_COORD));
+		}
+	}
+
+	void LooseGrid::reset(const sf::FloatRect& area, float cellSize) {
+		const float extent = std::max({ area.size.x, area.size.y, 1.0F });
+		m_cellSize = (cellSize > 0.0F) ? std::max(cellSize, extent / LOOSE_MAX_CELLS_PER_AXIS) : extent;
+		m_invCellSize = 1.0F / m_cellSize;
+		m_origin = area.position;
+		m_cols = static_cast<int>(std::max(area.size.x, 0.0F) * m_invCellSize) + 1;
+		m_rows = static_cast<int>(std::max(area.size.y, 0.0F) * m_invCellSize) + 1;
+		m_cells.assign(static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows), {});
+		m_locations.clear();
+		m_positions.clear();
+		m_size = 0U;
+		m_reinsertions = 0U;
+	}
+
+	std::uint32_t LooseGrid::cellOf(const sf::Vector2f& position) const noexcept {
+		// Clamped to the grid first, so truncation agrees with floor and no libm call is needed
+		const float fx = std::clamp((position.x - m_origin.x) * m_invCellSize, 0.0F, static_cast<float>(m_cols - 1));
+		const float fy = std::clamp((position.y - m_origin.y) * m_invCellSize, 0.0F, static_cast<float>(m_rows - 1));
+		return static_cast<std::uint32_t>(static_cast<int>(fy) * m_cols + static_cast<int>(fx));
+	}
+
+	void LooseGrid::link(std::uint32_t id, std::uint32_t cell, const sf::Vector2f& position) {
+		std::vector<std::uint32_t>& ids = m_cells[cell];
+		m_locations[id] = { cell, static_cast<std::uint32_t>(ids.size()) };
+		m_positions[id] = position;
+		ids.push_back(id);
+	}
+
+	void LooseGrid::unlink(std::uint32_t id) {
+		const Location location = m_locations[id];
+		std::vector<std::uint32_t>& ids = m_cells[location.cell];
+		if (location.slot + 1U != ids.size()) {
+			ids[location.slot] = ids.back();
+			m_locations[ids[location.slot]].slot = location.slot;
+		}
+		ids.pop_back();
+		m_locations[id].cell = EntityHandle::NONE;
+	}
+
+	void LooseGrid::insert(std::uint32_t id, const sf::Vector2f& position) {
+		if (m_cells.empty()) {
+			return;
+		}
+		if (id < m_locations.size() && m_locations[id].cell != EntityHandle::NONE) {
+			(void)move(id, position);
+			return;
+		}
+		if (id >= m_locations.size()) {
+			m_locations.resize(static_cast<std::size_t>(id) + 1U);
+			m_positions.resize(static_cast<std::size_t>(id) + 1U);
+		}
+		link(id, cellOf(position), position);
+		++m_size;
+	}
+
+	bool LooseGrid::move(std::uint32_t id, const sf::Vector2f& position) {
+		if (id >= m_locations.size() || m_locations[id].cell == EntityHandle::NONE) {
+			return false;
+		}
+		const std::uint32_t cell = cellOf(position);
+		if (cell == m_locations[id].cell) {
+			m_positions[id] = position;
+			return true;
+		}
+		unlink(id);
+		link(id, cell, position);
+		++m_reinsertions;
+		return true;
+	}
+
+	bool LooseGrid::remove(std::uint32_t id) {
+		if (id >= m_locations.size() || m_locations[id].cell == EntityHandle::NONE) {
+			return false;
+		}
+		unlink(id);
+		--m_size;
+		return true;
+	}
+
+	void LooseGrid::scanCell(int cx, int cy, const sf::Vector2f& query, std::uint32_t skip, NearestObstacle& best) const {
+		if (cx < 0 || cy < 0 || cx >= m_cols || cy >= m_rows) {
+			return;
+		}
+		const std::size_t cell = static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols)
+			+ static_cast<std::size_t>(cx);
+		for (const std::uint32_t id : m_cells[cell]) {
+			if (id == skip) {
+				continue;
+			}
+			const float dx = m_positions[id].x - query.x;
+			const float dy = m_positions[id].y - query.y;
+			const float distanceSq = dx * dx + dy * dy;
+			if (distanceSq < best.distanceSq) {
+				best.distanceSq = distanceSq;
+				best.index = id;
+			}
+		}
+	}
+
+	NearestObstacle LooseGrid::nearest(const sf::Vector2f& query, float maxDistance, std::uint32_t skip) const {
+		if (m_size == 0U) {
+			return {};
+		}
+
+		const int qx = looseCellCoord(query.x - m_origin.x, m_invCellSize);
+		const int qy = looseCellCoord(query.y - m_origin.y, m_invCellSize);
+
+		// Chebyshev ring range that can intersect the grid at all
+		const int ringMin = std::max({ 0, -qx, qx - (m_cols - 1), -qy, qy - (m_rows - 1) });
+		const int ringMax = std::max({ qx, (m_cols - 1) - qx, qy, (m_rows - 1) - qy });
+
+		const float limitSq = maxDistance * maxDistance;
+		NearestObstacle best;
+		best.distanceSq = limitSq;
+
+		for (int r = ringMin; r <= ringMax; ++r) {
+			// Every centre in ring r is at least (r - 1) whole cells away
+			if (r > 0) {
+				const float lowerBound = static_cast<float>(r - 1) * m_cellSize;
+				if (lowerBound * lowerBound >= best.distanceSq) {
+					break;
+				}
+			}
+
+			if (r == 0) {
+				scanCell(qx, qy, query, skip, best);
+				continue;
+			}
+
+			const int xBegin = std::max(qx - r, 0);
+			const int xEnd = std::min(qx + r, m_cols - 1);
+			for (int x = xBegin; x <= xEnd; ++x) {
+				scanCell(x, qy - r, query, skip, best);
+				scanCell(x, qy + r, query, skip, best);
+			}
+
+			const int yBegin = std::max(qy - r + 1, 0);
+			const int yEnd = std::min(qy + r - 1, m_rows - 1);
+			for (int y = yBegin; y <= yEnd; ++y) {
+				scanCell(qx - r, y, query, skip, best);
+				scanCell(qx + r, y, query, skip, best);
+			}
+		}
+
+		return (best.distanceSq < limitSq) ? best : NearestObstacle{};
+	}
+
+	void LooseGrid::gather(const sf::Vector2f& query, float radius, std::vector<std::uint32_t>& out) const {
+		if (m_size == 0U || !(radius >= 0.0F)) {
+			return;
+		}
+
+		const int xBegin = std::max(looseCellCoord(query.x - radius - m_origin.x, m_invCellSize), 0);
+		const int xEnd = std::min(looseCellCoord(query.x + radius - m_origin.x, m_invCellSize), m_cols - 1);
+		const int yBegin = std::max(looseCellCoord(query.y - radius - m_origin.y, m_invCellSize), 0);
+		const int yEnd = std::min(looseCellCoord(query.y + radius - m_origin.y, m_invCellSize), m_rows - 1);
+
+		const float radiusSq = radius * radius;
+		for (int y = yBegin; y <= yEnd; ++y) {
+			for (int x = xBegin; x <= xEnd; ++x) {
+				const std::size_t cell = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cols)
+					+ static_cast<std::size_t>(x);
+				for (const std::uint32_t id : m_cells[cell]) {
+					const float dx = m_positions[id].x - query.x;
+					const float dy = m_positions[id].y - query.y;
+					if (dx * dx + dy * dy <= radiusSq) {
+						out.push_back(id);
+					}
+				}
+			}
+		}
+	}
+
+	void MovingObstacles::reset(const sf::FloatRect& area, float cellSize) {
+		m_movers.clear();
+		m_routes.clear();
+		m_grid.reset(area, cellSize);
+		m_maxRadius = 0.0F;
+	}
+
+	EntityHandle MovingObstacles::spawn(const MoverRoute& route) {
+		if (route.waypoints.size() < 2U || !(route.speed > 0.0F)) {
+			return {};
+		}
+
+		Route stored;
+		stored.waypoints = route.waypoints;
+		stored.speed = route.speed;
+		stored.legLengths.reserve(route.waypoints.size());
+		float total = 0.0F;
+		for (std::size_t i = 0U; i < route.waypoints.size(); ++i) {
+			const sf::Vector2f leg = route.waypoints[(i + 1U) % route.waypoints.size()] - route.waypoints[i];
+			stored.legLengths.push_back(dmath::hypot(leg.x, leg.y));
+			total += stored.legLengths.back();
+		}
+		if (!(total > 0.0F)) {
+			return {};
+		}
+
+		Mover mover;
+		mover.body = { route.waypoints.front(), route.radius };
+		mover.kind = route.kind;
+		mover.route = static_cast<std::uint32_t>(m_routes.size());
+		mover.speed = route.speed;
+		m_routes.push_back(std::move(stored));
+		enterLeg(mover);
+
+		const EntityHandle handle = m_movers.spawn(mover);
+		m_grid.insert(handle.slot, mover.body.center);
+		m_maxRadius = std::max(m_maxRadius, route.radius);
+		return handle;
+	}
+
+	void MovingObstacles::spawnScene(const Scene& scene) {
+		m_movers.reserve(m_movers.size() + scene.movers.size());
+		for (const auto& route : scene.movers) {
+			(void)spawn(route);
+		}
+	}
+
+	bool MovingObstacles::despawn(const EntityHandle& handle) {
+		if (!m_movers.despawn(handle)) {
+			return false;
+		}
+		(void)m_grid.remove(handle.slot);
+		return true;
+	}
+
+	void MovingObstacles::enterLeg(Mover& mover) const {
+		const Route& route = m_routes[mover.route];
+		const std::size_t next = (static_cast<std::size_t>(mover.leg) + 1U) % route.waypoints.size();
+		mover.legStart = route.waypoints[mover.leg];
+		mover.legLength = route.legLengths[mover.leg];
+		mover.legDirection = (mover.legLength > 0.0F)
+			? (route.waypoints[next] - mover.legStart) / mover.legLength
+			: sf::Vector2f{ 0.0F, 0.0F };
+	}
+
+	void MovingObstacles::step(float dt) {
+		if (!(dt > 0.0F)) {
+			return;
+		}
+
+		Mover* const movers = m_movers.begin();
+		for (std::size_t i = 0U; i < m_movers.size(); ++i) {
+			Mover& mover = movers[i];
+			mover.along += mover.speed * dt;
+
+			// Zero-length legs (repeated waypoints) are skipped by the loop as well
+			while (mover.along >= mover.legLength) {
+				mover.along -= mover.legLength;
+				mover.leg = (mover.leg + 1U) % static_cast<std::uint32_t>(m_routes[mover.route].waypoints.size());
+				enterLeg(mover);
+			}
+
+			mover.body.center = mover.legStart + mover.legDirection * mover.along;
+			(void)m_grid.move(m_movers.handleAt(i).slot, mover.body.center);
+		}
+	}
+
+	void readMovingObstacles(const std::vector<SensorPose>& sensors, const MovingObstacles& movers, float maxRange,
+		std::vector<SensorReading>& readings)
+	{
+		if (movers.empty()) {
+			return;
+		}
+
+		const std::size_t count = std::min(sensors.size(), readings.size());
+		for (std::size_t i = 0U; i < count; ++i) {
+			// Only a mover closer than the static reading matters, so it bounds the search
+			const float current = readings[i].distanceSq;
+			const float limit = (current < maxRange * maxRange) ? std::sqrt(current) : maxRange;
+			const NearestObstacle nearest = movers.nearest(sensors[i].position, limit);
+			if (nearest.distanceSq < current) {
+				readings[i].obstacle = NO_OBSTACLE;
+				readings[i].distanceSq = nearest.distanceSq;
+			}
+		}
+	}
+
+} // namespace sim
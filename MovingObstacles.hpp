@@ -0,0 +1,185 @@
+/*
+==============================================================================
+Moving Obstacles - pedestrians and cars on routes, in a loose grid
+==============================================================================
+ - Movers live in an EntityPool (stable handles, dense iteration) and walk
+   or drive closed waypoint loops at constant speed
+ - The broad phase is a loose grid: an entry is filed under the cell of
+   its centre only and re-inserted only when the centre crosses into
+   another cell, so a tick never rebuilds the index. Positions live in a
+   separate array by id, so a move within the cell is one sequential write
+   and the cell lists are only touched on a crossing
+ - Bodies may reach into neighbour cells; that looseness is paid by the
+   queries, which grow their search by the largest body radius when they
+   need overlap rather than centre distance
+ - Nearest lookups use the same ring scan as the static obstacle grid and
+   measure to centres, so a mover reads exactly like a pillar
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EntityPool.hpp"
+#include "ObstacleGrid.hpp"
+#include "Scene.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	class LooseGrid {
+	public:
+		/**
+		 * @brief Empties the grid and covers area with cells of cellSize.
+		 *
+		 * Entries outside area are filed in its border cells, so nearest
+		 * lookups are exact only for queries inside area.
+		 * MISRA: cellSize must be strictly positive; other values give one cell over area.
+		 */
+		void reset(const sf::FloatRect& area, float cellSize);
+
+		/**
+		 * @brief Files id at position; an id already in the grid is moved instead.
+		 */
+		void insert(std::uint32_t id, const sf::Vector2f& position);
+
+		/**
+		 * @brief Updates id's position, re-filing it only if it changed cell; false for an unknown id.
+		 */
+		bool move(std::uint32_t id, const sf::Vector2f& position);
+
+		/**
+		 * @brief Takes id out of the grid; false for an unknown id.
+		 */
+		bool remove(std::uint32_t id);
+
+		/**
+		 * @brief Nearest entry within maxDistance (index = its id), as ObstacleGrid::nearest().
+		 *
+		 * skip is passed over, so an entry can look for its nearest neighbour.
+		 */
+		[[nodiscard]] NearestObstacle nearest(const sf::Vector2f& query, float maxDistance,
+			std::uint32_t skip = NO_OBSTACLE) const;
+
+		/**
+		 * @brief Appends the id of every entry whose position is within radius of query.
+		 */
+		void gather(const sf::Vector2f& query, float radius, std::vector<std::uint32_t>& out) const;
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+		// Entries re-filed into another cell since reset(), for the profiler and benchmarks
+		[[nodiscard]] std::uint64_t reinsertions() const noexcept { return m_reinsertions; }
+
+	private:
+		struct Location {
+			std::uint32_t cell = EntityHandle::NONE; // NONE while the id is not in the grid
+			std::uint32_t slot = 0U;                 // position inside the cell's entries
+		};
+
+		[[nodiscard]] std::uint32_t cellOf(const sf::Vector2f& position) const noexcept;
+		void scanCell(int cx, int cy, const sf::Vector2f& query, std::uint32_t skip, NearestObstacle& best) const;
+		void unlink(std::uint32_t id);
+		void link(std::uint32_t id, std::uint32_t cell, const sf::Vector2f& position);
+
+		sf::Vector2f m_origin{ 0.0F, 0.0F };
+		float m_cellSize = 1.0F;
+		float m_invCellSize = 1.0F;
+		int m_cols = 0;
+		int m_rows = 0;
+		std::size_t m_size = 0U;
+		std::uint64_t m_reinsertions = 0U;
+
+		std::vector<std::vector<std::uint32_t>> m_cells; // ids per cell, m_cols * m_rows; each keeps its capacity
+		std::vector<Location> m_locations;              // by id
+		std::vector<sf::Vector2f> m_positions;          // by id
+	};
+
+	// One moving obstacle: its body and where it is on its route. The current
+	// leg is cached here, so a tick only reads the route when a leg ends.
+	struct Mover {
+		Obstacle body;
+		MoverKind kind = MoverKind::Pedestrian;
+		std::uint32_t route = 0U;
+		std::uint32_t leg = 0U;                    // heading from waypoint leg to leg + 1
+		float along = 0.0F;                        // px travelled on that leg
+		float legLength = 0.0F;
+		float speed = 0.0F;                        // px per second
+		sf::Vector2f legStart{ 0.0F, 0.0F };
+		sf::Vector2f legDirection{ 0.0F, 0.0F };   // unit length (zero on an empty leg)
+	};
+
+	class MovingObstacles {
+	public:
+		/**
+		 * @brief Drops every mover and route and indexes area with cells of cellSize.
+		 */
+		void reset(const sf::FloatRect& area, float cellSize);
+
+		/**
+		 * @brief Registers a route and spawns one mover at its first waypoint.
+		 *
+		 * MISRA: a route needs two distinct waypoints and a positive speed;
+		 *        others are rejected with an invalid handle.
+		 */
+		[[nodiscard]] EntityHandle spawn(const MoverRoute& route);
+
+		/**
+		 * @brief Spawns one mover per route of the scene.
+		 */
+		void spawnScene(const Scene& scene);
+
+		/**
+		 * @brief Removes a mover; false for a stale handle. Its route stays registered.
+		 */
+		bool despawn(const EntityHandle& handle);
+
+		/**
+		 * @brief Advances every mover along its route by dt seconds and updates the grid.
+		 */
+		void step(float dt);
+
+		/**
+		 * @brief Nearest mover centre within maxDistance; index is the mover's handle slot.
+		 */
+		[[nodiscard]] NearestObstacle nearest(const sf::Vector2f& query, float maxDistance) const {
+			return m_grid.nearest(query, maxDistance);
+		}
+
+		[[nodiscard]] const EntityPool<Mover>& movers() const noexcept { return m_movers; }
+		[[nodiscard]] const LooseGrid& grid() const noexcept { return m_grid; }
+		[[nodiscard]] float maxRadius() const noexcept { return m_maxRadius; }
+		[[nodiscard]] bool empty() const noexcept { return m_movers.empty(); }
+
+	private:
+		void enterLeg(Mover& mover) const;
+
+		struct Route {
+			std::vector<sf::Vector2f> waypoints;
+			std::vector<float> legLengths; // waypoint i to i + 1, the last one back to 0
+			float speed = 0.0F;
+		};
+
+		EntityPool<Mover> m_movers;
+		std::vector<Route> m_routes;
+		LooseGrid m_grid;
+		float m_maxRadius = 0.0F;
+	};
+
+	/**
+	 * @brief Folds the movers into a finished sensor pass: a mover closer than
+	 *        a sensor's reading replaces it.
+	 *
+	 * The reading's obstacle becomes NO_OBSTACLE (it indexes the static
+	 * obstacles only); wall distances are left as they are.
+	 */
+	void readMovingObstacles(const std::vector<SensorPose>& sensors, const MovingObstacles& movers, float maxRange,
+		std::vector<SensorReading>& readings);
+
+} // namespace sim
@@ -0,0 +1,182 @@
+#include "NearestBackends.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "DistanceField.hpp"
+#include "ObstacleGrid.hpp"
+#include "Sensors.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr float NEAREST_NONE = std::numeric_limits<float>::max();
+
+		constexpr NearestBackend ALL_NEAREST_BACKENDS[NEAREST_BACKEND_COUNT] = {
+			NearestBackend::BruteForce, NearestBackend::Simd, NearestBackend::Grid,
+			NearestBackend::Bvh, NearestBackend::Field, NearestBackend::Gpu
+		};
+
+		// A reading's distance for comparison: nothing in range reads as the range
+		[[nodiscard]] float clampedDistance(float distanceSq, float maxRange) noexcept {
+			return (distanceSq < maxRange * maxRange) ? std::sqrt(std::max(distanceSq, 0.0F)) : maxRange;
+		}
+	}
+
+	const char* nearestBackendName(NearestBackend backend) noexcept {
+		switch (backend) {
+		case NearestBackend::BruteForce: return "brute";
+		case NearestBackend::Simd: return "simd";
+		case NearestBackend::Grid: return "grid";
+		case NearestBackend::Bvh: return "bvh";
+		case NearestBackend::Field: return "sdf";
+		case NearestBackend::Gpu: return "gpu";
+		default: return "?";
+		}
+	}
+
+	bool parseNearestBackend(std::string_view name, NearestBackend& backend) noexcept {
+		for (const NearestBackend known : ALL_NEAREST_BACKENDS) {
+			if (name == nearestBackendName(known)) {
+				backend = known;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void NearestEngines::build(const std::vector<Obstacle>& obstacles) {
+		m_centers.clear();
+		m_centers.reserve(obstacles.size());
+		for (const Obstacle& obstacle : obstacles) {
+			m_centers.push_back(obstacle.center);
+		}
+		m_store.assign(m_centers);
+		m_bvh.build(m_centers);
+		m_built = true;
+	}
+
+	bool NearestEngines::available(NearestBackend backend) const noexcept {
+		switch (backend) {
+		case NearestBackend::BruteForce:
+		case NearestBackend::Simd:
+		case NearestBackend::Bvh:
+			return m_built;
+		case NearestBackend::Grid:
+			return m_grid != nullptr;
+		case NearestBackend::Field:
+			return m_field != nullptr && !m_field->empty() && m_grid != nullptr;
+		default:
+			return false;
+		}
+	}
+
+	void NearestEngines::query(NearestBackend backend, const std::vector<SensorPose>& sensors, float maxRange,
+		std::vector<SensorReading>& readings) const
+	{
+		if (backend == NearestBackend::Grid) {
+			readSensors(sensors, *m_grid, maxRange, readings);
+			return;
+		}
+		if (backend == NearestBackend::Field) {
+			readSensors(sensors, *m_field, maxRange, *m_grid, readings);
+			return;
+		}
+
+		const float limitSq = maxRange * maxRange;
+		readings.resize(sensors.size());
+		for (std::size_t i = 0U; i < sensors.size(); ++i) {
+			const sf::Vector2f& position = sensors[i].position;
+			SensorReading reading;
+			if (backend == NearestBackend::BruteForce) {
+				// Every center in turn, as playBeepIfNear did
+				float best = limitSq;
+				for (std::size_t o = 0U; o < m_centers.size(); ++o) {
+					const float dx = m_centers[o].x - position.x;
+					const float dy = m_centers[o].y - position.y;
+					const float distanceSq = dx * dx + dy * dy;
+					if (distanceSq < best) {
+						best = distanceSq;
+						reading.obstacle = static_cast<std::uint32_t>(o);
+					}
+				}
+				reading.distanceSq = (reading.obstacle != NO_OBSTACLE) ? best : NEAREST_NONE;
+			}
+			else if (backend == NearestBackend::Simd) {
+				const float distanceSq = nearestDistanceSqSimd(m_store, position);
+				reading.distanceSq = (distanceSq < limitSq) ? distanceSq : NEAREST_NONE;
+			}
+			else {
+				const ObstacleHit hit = m_bvh.nearest(position, maxRange);
+				reading.obstacle = hit.index;
+				reading.distanceSq = hit.distanceSq;
+			}
+			if (m_grid != nullptr) {
+				reading.wallDistance = m_grid->nearestWall(position, maxRange);
+			}
+			readings[i] = reading;
+		}
+	}
+
+	void NearestComparison::begin(const std::vector<Obstacle>& obstacles, const std::vector<SensorPose>& sensors,
+		float maxRange)
+	{
+		m_maxRange = maxRange;
+		m_centerDistances.assign(sensors.size(), maxRange);
+		m_surfaceDistances.assign(sensors.size(), maxRange);
+		for (std::size_t i = 0U; i < sensors.size(); ++i) {
+			float centerSq = NEAREST_NONE;
+			float surface = NEAREST_NONE;
+			for (const Obstacle& obstacle : obstacles) {
+				const sf::Vector2f offset = obstacle.center - sensors[i].position;
+				const float distanceSq = offset.dot(offset);
+				centerSq = std::min(centerSq, distanceSq);
+				surface = std::min(surface, std::sqrt(distanceSq) - obstacle.radius);
+			}
+			m_centerDistances[i] = clampedDistance(centerSq, maxRange);
+			m_surfaceDistances[i] = std::min(std::max(surface, 0.0F), maxRange);
+		}
+	}
+
+	void NearestComparison::record(NearestBackend backend, const std::vector<SensorReading>& readings, double seconds,
+		float tolerance)
+	{
+		if (readings.size() != m_centerDistances.size()) {
+			return;
+		}
+		const std::vector<float>& reference = (backend == NearestBackend::Field) ? m_surfaceDistances : m_centerDistances;
+		NearestTally& tally = m_tallies[static_cast<std::size_t>(backend)];
+		++tally.passes;
+		tally.seconds += seconds;
+		for (std::size_t i = 0U; i < readings.size(); ++i) {
+			const float error = std::fabs(clampedDistance(readings[i].distanceSq, m_maxRange) - reference[i]);
+			tally.maxError = std::max(tally.maxError, error);
+			tally.agreed += (error <= tolerance) ? 1U : 0U;
+		}
+		tally.readings += readings.size();
+	}
+
+	float nearestTolerance(NearestBackend backend, const DistanceField* field) noexcept {
+		return (backend == NearestBackend::Field && field != nullptr) ? field->cellSize() : NearestComparison::AGREE_TOLERANCE;
+	}
+
+	void compareNearestBackends(const NearestEngines& engines, const std::vector<Obstacle>& obstacles,
+		const std::vector<SensorPose>& sensors, float maxRange, NearestComparison& comparison,
+		std::vector<SensorReading>& readings)
+	{
+		using Clock = std::chrono::steady_clock;
+		comparison.begin(obstacles, sensors, maxRange);
+		for (const NearestBackend backend : ALL_NEAREST_BACKENDS) {
+			if (!engines.available(backend)) {
+				continue;
+			}
+			const auto start = Clock::now();
+			engines.query(backend, sensors, maxRange, readings);
+			const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			comparison.record(backend, readings, seconds, nearestTolerance(backend, engines.field()));
+		}
+	}
+
+} // namespace sim
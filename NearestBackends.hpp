@@ -0,0 +1,164 @@
+/*
+==============================================================================
+Nearest Backends - one nearest-obstacle pass, several engines to answer it
+==============================================================================
+ - A NearestBackend names how a sensor's nearest pillar is found: every
+   center in turn (the original playBeepIfNear search), the SIMD store
+   kernel, the obstacle grid, a BVH over the centers, the baked distance
+   field, or the GPU compute pass (front end only, see GpuSensorQuery)
+ - NearestEngines holds the CPU engines built over one obstacle set and
+   answers a sensor pass through whichever is asked; the store and the BVH
+   are its own, the grid and the field are attached from their owners
+ - Every engine reads the pillars only; walls come from the attached
+   grid. The grid also reports polygon surfaces, so near an island it
+   answers a distance the others cannot see
+ - NearestComparison judges engines against the brute-force reference on
+   the same poses: cost per pass, the share of readings that agree, and
+   the largest disagreement. Distances are compared clamped to the range
+   (nothing in range reads as the range), within AGREE_TOLERANCE for the
+   center engines and one field cell for the field, which measures to the
+   pillar outlines and is compared against the outline distance
+ - SIMD and field readings carry no pillar index; agreement is on distance
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "ObstacleBvh.hpp"
+#include "ObstacleStore.hpp"
+#include "SimFwd.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	enum class NearestBackend : std::uint8_t { BruteForce, Simd, Grid, Bvh, Field, Gpu };
+
+	constexpr std::size_t NEAREST_BACKEND_COUNT = 6U;
+
+	// "brute", "simd", "grid", "bvh", "sdf", "gpu"
+	[[nodiscard]] const char* nearestBackendName(NearestBackend backend) noexcept;
+
+	/**
+	 * @brief Backend named name (see nearestBackendName()); false if unknown.
+	 */
+	[[nodiscard]] bool parseNearestBackend(std::string_view name, NearestBackend& backend) noexcept;
+
+	class NearestEngines {
+	public:
+		/**
+		 * @brief Rebuilds the store and the BVH over the obstacle centers.
+		 */
+		void build(const std::vector<Obstacle>& obstacles);
+
+		/**
+		 * @brief Marks the store and the BVH stale (the obstacles changed); build() again before use.
+		 */
+		void invalidate() noexcept { m_built = false; }
+
+		[[nodiscard]] bool built() const noexcept { return m_built; }
+
+		/**
+		 * @brief The grid answering Grid and measuring the walls for every engine; null detaches it.
+		 */
+		void setGrid(const ObstacleGrid* grid) noexcept { m_grid = grid; }
+
+		/**
+		 * @brief The baked field answering Field; null detaches it.
+		 */
+		void setField(const DistanceField* field) noexcept { m_field = field; }
+
+		[[nodiscard]] const DistanceField* field() const noexcept { return m_field; }
+
+		/**
+		 * @brief True if query() can answer through backend now; never for Gpu.
+		 */
+		[[nodiscard]] bool available(NearestBackend backend) const noexcept;
+
+		/**
+		 * @brief Nearest pillar and wall per sensor within maxRange, through backend.
+		 *
+		 * Readings are as from the grid pass (Sensors.hpp): squared distance
+		 * to the center, or to the outline for Field. Walls are left at max
+		 * without a grid. MISRA: backend must be available().
+		 */
+		void query(NearestBackend backend, const std::vector<SensorPose>& sensors, float maxRange,
+			std::vector<SensorReading>& readings) const;
+
+	private:
+		std::vector<sf::Vector2f> m_centers;
+		ObstacleStore m_store;
+		ObstacleBvh m_bvh;
+		const ObstacleGrid* m_grid = nullptr;
+		const DistanceField* m_field = nullptr;
+		bool m_built = false;
+	};
+
+	// One backend's record in a comparison
+	struct NearestTally {
+		std::uint64_t passes = 0U;
+		std::uint64_t readings = 0U;
+		std::uint64_t agreed = 0U;     // within the tolerance of the reference
+		double seconds = 0.0;          // spent in the measured passes
+		float maxError = 0.0F;         // largest distance off the reference
+
+		[[nodiscard]] double microsPerPass() const noexcept {
+			return (passes > 0U) ? seconds * 1.0e6 / static_cast<double>(passes) : 0.0;
+		}
+		[[nodiscard]] double agreement() const noexcept {
+			return (readings > 0U) ? static_cast<double>(agreed) / static_cast<double>(readings) : 0.0;
+		}
+	};
+
+	class NearestComparison {
+	public:
+		// Distance a center engine may read off the brute-force reference and still agree
+		static constexpr float AGREE_TOLERANCE = 0.01F;
+
+		/**
+		 * @brief Starts a pass: the brute-force reference for sensors over obstacles.
+		 */
+		void begin(const std::vector<Obstacle>& obstacles, const std::vector<SensorPose>& sensors, float maxRange);
+
+		/**
+		 * @brief Tallies backend's readings of the pass begun last, which took seconds.
+		 *
+		 * tolerance is the distance off the reference that still agrees.
+		 * Readings of another sensor count are dropped.
+		 */
+		void record(NearestBackend backend, const std::vector<SensorReading>& readings, double seconds, float tolerance);
+
+		[[nodiscard]] const NearestTally& tally(NearestBackend backend) const noexcept {
+			return m_tallies[static_cast<std::size_t>(backend)];
+		}
+
+		void reset() noexcept { m_tallies = {}; }
+
+	private:
+		std::vector<float> m_centerDistances;  // to the nearest center, clamped to the range
+		std::vector<float> m_surfaceDistances; // to the nearest outline (0 inside), clamped likewise
+		float m_maxRange = 0.0F;
+		std::array<NearestTally, NEAREST_BACKEND_COUNT> m_tallies{};
+	};
+
+	/**
+	 * @brief One comparison pass: every available CPU engine over sensors, timed.
+	 *
+	 * Begins the pass on comparison from obstacles (the set engines was
+	 * built from); readings is scratch. The caller records the GPU pass.
+	 */
+	void compareNearestBackends(const NearestEngines& engines, const std::vector<Obstacle>& obstacles,
+		const std::vector<SensorPose>& sensors, float maxRange, NearestComparison& comparison,
+		std::vector<SensorReading>& readings);
+
+	/**
+	 * @brief The tolerance compareNearestBackends() records backend with.
+	 */
+	[[nodiscard]] float nearestTolerance(NearestBackend backend, const DistanceField* field) noexcept;
+
+} // namespace sim
@@ -0,0 +1,120 @@
+#include "NumaTopology.hpp"
+
+#include <exception>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace sim {
+
+#if defined(__linux__)
+	namespace {
+		// A sysfs list such as "0-15,32-47"; empty if the file cannot be read
+		[[nodiscard]] std::vector<unsigned> readIdList(const std::string& path) {
+			std::vector<unsigned> ids;
+			std::ifstream file(path);
+			std::string list;
+			if (!file || !std::getline(file, list)) {
+				return ids;
+			}
+			std::size_t at = 0U;
+			while (at < list.size()) {
+				std::size_t end = list.find(',', at);
+				if (end == std::string::npos) {
+					end = list.size();
+				}
+				const std::string range = list.substr(at, end - at);
+				const std::size_t dash = range.find('-');
+				try {
+					const unsigned first = static_cast<unsigned>(std::stoul(range.substr(0U, dash)));
+					const unsigned last = (dash == std::string::npos)
+						? first
+						: static_cast<unsigned>(std::stoul(range.substr(dash + 1U)));
+					for (unsigned id = first; id <= last; ++id) {
+						ids.push_back(id);
+					}
+				}
+				catch (const std::exception&) {
+					return {};
+				}
+				at = end + 1U;
+			}
+			return ids;
+		}
+	}
+
+	NumaTopology detectNumaTopology() {
+		NumaTopology topology;
+		for (const unsigned node : readIdList("/sys/devices/system/node/online")) {
+			std::vector<unsigned> cpus = readIdList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+			if (!cpus.empty()) {
+				topology.nodeCpus.push_back(std::move(cpus));
+			}
+		}
+		return topology;
+	}
+
+	bool pinCurrentThread(const std::vector<unsigned>& cpus) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (const unsigned cpu : cpus) {
+			if (cpu < CPU_SETSIZE) {
+				CPU_SET(cpu, &set);
+			}
+		}
+		return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+	}
+
+#elif defined(_WIN32)
+	NumaTopology detectNumaTopology() {
+		NumaTopology topology;
+		ULONG highest = 0U;
+		if (GetNumaHighestNodeNumber(&highest) == FALSE) {
+			return topology;
+		}
+		for (ULONG node = 0U; node <= highest; ++node) {
+			ULONGLONG mask = 0U;
+			if (GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask) == FALSE || mask == 0U) {
+				continue;
+			}
+			std::vector<unsigned> cpus;
+			for (unsigned cpu = 0U; cpu < 64U; ++cpu) {
+				if ((mask >> cpu) & 1U) {
+					cpus.push_back(cpu);
+				}
+			}
+			topology.nodeCpus.push_back(std::move(cpus));
+		}
+		return topology;
+	}
+
+	bool pinCurrentThread(const std::vector<unsigned>& cpus) {
+		DWORD_PTR mask = 0U;
+		for (const unsigned cpu : cpus) {
+			if (cpu < sizeof(DWORD_PTR) * 8U) {
+				mask |= static_cast<DWORD_PTR>(1U) << cpu;
+			}
+		}
+		return mask != 0U && SetThreadAffinityMask(GetCurrentThread(), mask) != 0U;
+	}
+
+#else
+	NumaTopology detectNumaTopology() {
+		return {};
+	}
+
+	bool pinCurrentThread(const std::vector<unsigned>&) {
+		return false;
+	}
+#endif
+
+} // namespace sim
@@ -0,0 +1,39 @@
+/*
+==============================================================================
+NUMA Topology - which CPUs share a memory node
+==============================================================================
+ - detectNumaTopology() lists the nodes that have CPUs and each node's
+   CPU ids: from /sys/devices/system/node on Linux, from the processor
+   masks of the first processor group on Windows; elsewhere, or when
+   nothing can be read, the machine is one node holding every CPU
+ - pinCurrentThread() restricts the calling thread to one node's CPUs so
+   the pages it first touches are placed on that node and stay near it
+ - Nothing here allocates per-node memory itself: placement is by first
+   touch, which the pool and the fleet arrange (ThreadPool, Fleet)
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+	struct NumaTopology {
+		std::vector<std::vector<unsigned>> nodeCpus; // CPU ids per node with CPUs; empty = unknown, one node
+
+		[[nodiscard]] std::size_t nodeCount() const noexcept { return nodeCpus.empty() ? 1U : nodeCpus.size(); }
+	};
+
+	/**
+	 * @brief The machine's memory nodes and their CPUs.
+	 */
+	[[nodiscard]] NumaTopology detectNumaTopology();
+
+	/**
+	 * @brief Keeps the calling thread on cpus; false if the platform refuses (the thread then runs anywhere).
+	 */
+	bool pinCurrentThread(const std::vector<unsigned>& cpus);
+
+} // namespace sim
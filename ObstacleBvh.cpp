@@ -0,0 +1,128 @@
+#include "ObstacleBvh.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace sim {
+
+	namespace {
+		// Median splits halve the points per level, so this covers any scene that fits in memory
+		constexpr std::size_t CENTER_BVH_MAX_DEPTH = 64U;
+
+		// Squared distance from query to the box, 0 inside it
+		[[nodiscard]] float centerBoxDistanceSq(const sf::Vector2f& low, const sf::Vector2f& high,
+			const sf::Vector2f& query) noexcept
+		{
+			const float dx = std::max(std::max(low.x - query.x, query.x - high.x), 0.0F);
+			const float dy = std::max(std::max(low.y - query.y, query.y - high.y), 0.0F);
+			return dx * dx + dy * dy;
+		}
+
+		// Traversal stack entry: a node and its box distance (squared)
+		struct CenterBvhEntry {
+			std::uint32_t node;
+			float distanceSq;
+		};
+	}
+
+	void ObstacleBvh::build(const std::vector<sf::Vector2f>& points) {
+		m_points.clear();
+		m_ids.clear();
+		m_nodes.clear();
+		if (points.empty()) {
+			return;
+		}
+
+		std::vector<std::uint32_t> order(points.size());
+		for (std::size_t i = 0U; i < order.size(); ++i) {
+			order[i] = static_cast<std::uint32_t>(i);
+		}
+		m_nodes.reserve(2U * (points.size() / LEAF_POINTS + 1U));
+		(void)buildNode(order, points, 0U, static_cast<std::uint32_t>(order.size()));
+		m_points.reserve(order.size());
+		m_ids.assign(order.begin(), order.end());
+		for (const std::uint32_t id : order) {
+			m_points.push_back(points[id]);
+		}
+	}
+
+	std::uint32_t ObstacleBvh::buildNode(std::vector<std::uint32_t>& order, const std::vector<sf::Vector2f>& points,
+		std::uint32_t first, std::uint32_t last)
+	{
+		Node node{ points[order[first]], points[order[first]], first, last - first };
+		for (std::uint32_t i = first; i < last; ++i) {
+			const sf::Vector2f& p = points[order[i]];
+			node.low = { std::min(node.low.x, p.x), std::min(node.low.y, p.y) };
+			node.high = { std::max(node.high.x, p.x), std::max(node.high.y, p.y) };
+		}
+
+		const std::uint32_t index = static_cast<std::uint32_t>(m_nodes.size());
+		m_nodes.push_back(node);
+		if (node.count <= LEAF_POINTS) {
+			return index;
+		}
+
+		// Median split along the longer axis of the box
+		const bool splitX = (node.high.x - node.low.x) >= (node.high.y - node.low.y);
+		const std::uint32_t middle = first + (last - first) / 2U;
+		std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + last,
+			[&points, splitX](std::uint32_t l, std::uint32_t r) {
+				return splitX ? points[l].x < points[r].x : points[l].y < points[r].y;
+			});
+		(void)buildNode(order, points, first, middle); // lands at index + 1
+		const std::uint32_t right = buildNode(order, points, middle, last);
+		m_nodes[index].first = right;
+		m_nodes[index].count = 0U;
+		return index;
+	}
+
+	ObstacleHit ObstacleBvh::nearest(const sf::Vector2f& query, float maxDistance) const {
+		if (m_nodes.empty()) {
+			return {};
+		}
+		const float limitSq = maxDistance * maxDistance;
+		ObstacleHit best;
+		best.distanceSq = limitSq;
+
+		// Each entry keeps its box distance, so a node popped after the bound tightened is dropped untouched
+		std::array<CenterBvhEntry, CENTER_BVH_MAX_DEPTH> stack;
+		std::size_t top = 0U;
+		stack[top++] = { 0U, centerBoxDistanceSq(m_nodes[0].low, m_nodes[0].high, query) };
+		while (top > 0U) {
+			const CenterBvhEntry entry = stack[--top];
+			if (entry.distanceSq >= best.distanceSq) {
+				continue;
+			}
+			const Node& node = m_nodes[entry.node];
+			if (node.count > 0U) {
+				for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+					const float dx = m_points[i].x - query.x;
+					const float dy = m_points[i].y - query.y;
+					const float distanceSq = dx * dx + dy * dy;
+					if (distanceSq < best.distanceSq) {
+						best.distanceSq = distanceSq;
+						best.index = m_ids[i];
+					}
+				}
+				continue;
+			}
+
+			// The nearer child goes on top, so it is searched first and tightens the bound for the other
+			const Node& left = m_nodes[entry.node + 1U];
+			const Node& right = m_nodes[node.first];
+			const CenterBvhEntry leftEntry{ entry.node + 1U, centerBoxDistanceSq(left.low, left.high, query) };
+			const CenterBvhEntry rightEntry{ node.first, centerBoxDistanceSq(right.low, right.high, query) };
+			const bool leftFirst = leftEntry.distanceSq <= rightEntry.distanceSq;
+			const CenterBvhEntry& nearer = leftFirst ? leftEntry : rightEntry;
+			const CenterBvhEntry& farther = leftFirst ? rightEntry : leftEntry;
+			if (farther.distanceSq < best.distanceSq) {
+				stack[top++] = farther;
+			}
+			if (nearer.distanceSq < best.distanceSq) {
+				stack[top++] = nearer;
+			}
+		}
+		return (best.index != NO_OBSTACLE) ? best : ObstacleHit{};
+	}
+
+} // namespace sim
@@ -0,0 +1,70 @@
+/*
+==============================================================================
+Obstacle BVH - nearest pillar center through a bounding volume hierarchy
+==============================================================================
+ - The hierarchy engine among the nearest-obstacle backends (see
+   NearestBackends.hpp): pillar centers in a tree of boxes, median split
+   on the longer axis, at most LEAF_POINTS per leaf, nodes flattened depth
+   first like PolygonBvh so a query walks one array
+ - nearest() descends nearer child first and drops every box farther than
+   the best center so far; answers match the obstacle grid's pillar
+   lookup, without a cell size to tune for the scene's spread
+ - Pillars only: walls and polygons stay with the obstacle grid
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+#include "ObstacleGrid.hpp"
+
+namespace sim {
+
+	class ObstacleBvh {
+	public:
+		static constexpr std::size_t LEAF_POINTS = 8U;
+
+		/**
+		 * @brief Rebuilds the hierarchy over points; hits index into points.
+		 */
+		void build(const std::vector<sf::Vector2f>& points);
+
+		/**
+		 * @brief Nearest point to query within maxDistance.
+		 *
+		 * Returns a default ObstacleHit (index NO_OBSTACLE) if none is in range.
+		 */
+		[[nodiscard]] ObstacleHit nearest(const sf::Vector2f& query, float maxDistance) const;
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_points.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_points.empty(); }
+
+	private:
+		// count == 0: inner node whose children are this + 1 and first; otherwise a leaf of points [first, first + count)
+		struct Node {
+			sf::Vector2f low;
+			sf::Vector2f high;
+			std::uint32_t first;
+			std::uint32_t count;
+		};
+
+		// Splits points [first, last) under a new node; returns its index
+		std::uint32_t buildNode(std::vector<std::uint32_t>& order, const std::vector<sf::Vector2f>& points,
+			std::uint32_t first, std::uint32_t last);
+
+		// Counted against the obstacle subsystem's heap
+		template <typename T>
+		using Array = prof::TrackedVector<T, prof::MemorySubsystem::Obstacles>;
+
+		Array<sf::Vector2f> m_points; // leaf order
+		Array<std::uint32_t> m_ids;   // index given to build() of each point in leaf order
+		Array<Node> m_nodes;          // depth first, root at 0
+	};
+
+} // namespace sim
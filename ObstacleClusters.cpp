@@ -0,0 +1,180 @@
+#include "ObstacleClusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+	namespace {
+		// Widens every test so rounding in the merged bounds never clears an obstacle that is in range
+		constexpr float CLUSTER_SLACK = 1.0F;
+
+		[[nodiscard]] float lengthOf(const sf::Vector2f& v) noexcept {
+			return std::sqrt(v.x * v.x + v.y * v.y);
+		}
+
+		[[nodiscard]] bool circleWithin(const sf::Vector2f& center, float radius, const sf::Vector2f& query,
+			float reach) noexcept
+		{
+			const sf::Vector2f d = center - query;
+			const float limit = radius + reach;
+			return d.x * d.x + d.y * d.y <= limit * limit;
+		}
+	}
+
+	void ObstacleClusters::build(const std::vector<Obstacle>& obstacles, const std::vector<WallSegment>& walls,
+		const PolygonSet& polygons)
+	{
+		m_items.clear();
+		m_nodes.clear();
+		m_extra.clear();
+		m_uncovered = false;
+
+		std::vector<Circle> items;
+		items.reserve(obstacles.size() + walls.size() + polygons.size());
+		for (const Obstacle& obstacle : obstacles) {
+			items.push_back({ obstacle.center, obstacle.radius });
+		}
+		for (const WallSegment& wall : walls) {
+			const sf::Vector2f along = wall.to - wall.from;
+			const auto pieces = static_cast<std::uint32_t>(std::max(std::ceil(lengthOf(along) / WALL_PIECE), 1.0F));
+			const sf::Vector2f step = along / static_cast<float>(pieces);
+			const float radius = 0.5F * lengthOf(step);
+			for (std::uint32_t i = 0U; i < pieces; ++i) {
+				items.push_back({ wall.from + step * (static_cast<float>(i) + 0.5F), radius });
+			}
+		}
+		for (std::size_t p = 0U; p < polygons.size(); ++p) {
+			sf::Vector2f low = polygons.vertices[polygons.starts[p]];
+			sf::Vector2f high = low;
+			for (std::uint32_t v = polygons.starts[p]; v < polygons.starts[p + 1U]; ++v) {
+				const sf::Vector2f& vertex = polygons.vertices[v];
+				low = { std::min(low.x, vertex.x), std::min(low.y, vertex.y) };
+				high = { std::max(high.x, vertex.x), std::max(high.y, vertex.y) };
+			}
+			const sf::Vector2f center = (low + high) * 0.5F;
+			float radius = 0.0F;
+			for (std::uint32_t v = polygons.starts[p]; v < polygons.starts[p + 1U]; ++v) {
+				radius = std::max(radius, lengthOf(polygons.vertices[v] - center));
+			}
+			items.push_back({ center, radius });
+		}
+		if (items.empty()) {
+			return;
+		}
+		if (items.size() > MAX_ITEMS) {
+			m_uncovered = true;
+			return;
+		}
+
+		m_nodes.reserve(2U * (items.size() / LEAF_ITEMS + 1U));
+		(void)buildNode(items, 0U, static_cast<std::uint32_t>(items.size()));
+		m_items.assign(items.begin(), items.end());
+	}
+
+	ObstacleClusters::Circle ObstacleClusters::buildNode(std::vector<Circle>& items, std::uint32_t first,
+		std::uint32_t last)
+	{
+		const std::uint32_t index = static_cast<std::uint32_t>(m_nodes.size());
+		m_nodes.push_back({ {}, first, last - first, 0U });
+
+		sf::Vector2f low = items[first].center;
+		sf::Vector2f high = low;
+		for (std::uint32_t i = first; i < last; ++i) {
+			low = { std::min(low.x, items[i].center.x), std::min(low.y, items[i].center.y) };
+			high = { std::max(high.x, items[i].center.x), std::max(high.y, items[i].center.y) };
+		}
+
+		// Around the middle of the centers, just reaching the farthest item
+		Circle bound{ (low + high) * 0.5F, 0.0F };
+		for (std::uint32_t i = first; i < last; ++i) {
+			bound.radius = std::max(bound.radius, lengthOf(items[i].center - bound.center) + items[i].radius);
+		}
+		if (last - first > LEAF_ITEMS) {
+			// Median split of the centers along the longer axis
+			const bool splitX = (high.x - low.x) >= (high.y - low.y);
+			const std::uint32_t middle = first + (last - first) / 2U;
+			std::nth_element(items.begin() + first, items.begin() + middle, items.begin() + last,
+				[splitX](const Circle& l, const Circle& r) {
+					return splitX ? l.center.x < r.center.x : l.center.y < r.center.y;
+				});
+			const Circle left = buildNode(items, first, middle); // lands at index + 1
+			const Circle right = buildNode(items, middle, last);
+
+			// The circle around both halves where it is the tighter one
+			const sf::Vector2f between = right.center - left.center;
+			const float distance = lengthOf(between);
+			Circle merged = (left.radius >= right.radius) ? left : right;
+			if (distance + std::min(left.radius, right.radius) > merged.radius) {
+				merged.radius = 0.5F * (distance + left.radius + right.radius);
+				merged.center = left.center + between * ((merged.radius - left.radius) / distance);
+			}
+			if (merged.radius < bound.radius) {
+				bound = merged;
+			}
+			m_nodes[index].count = 0U;
+		}
+		m_nodes[index].bound = bound;
+		m_nodes[index].skip = static_cast<std::uint32_t>(m_nodes.size());
+		return bound;
+	}
+
+	bool ObstacleClusters::anyWithin(const sf::Vector2f& center, float radius, float distance) const noexcept {
+		const float reach = radius + distance + CLUSTER_SLACK;
+		std::uint32_t index = 0U;
+		const auto end = static_cast<std::uint32_t>(m_nodes.size());
+		if (m_uncovered) {
+			return true;
+		}
+		while (index < end) {
+			const Node& node = m_nodes[index];
+			if (!circleWithin(node.bound.center, node.bound.radius, center, reach)) {
+				index = node.skip;
+				continue;
+			}
+			if (node.count == 0U) {
+				++index;
+				continue;
+			}
+			for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+				if (circleWithin(m_items[i].center, m_items[i].radius, center, reach)) {
+					return true;
+				}
+			}
+			index = node.skip;
+		}
+		for (const Circle& extra : m_extra) {
+			if (circleWithin(extra.center, extra.radius, center, reach)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ObstacleClusters::cover(const Obstacle& obstacle) {
+		if (m_uncovered) {
+			return true; // every query is "near" already
+		}
+		if (m_extra.size() >= MAX_EXTRA) {
+			return false;
+		}
+		m_extra.push_back({ obstacle.center, obstacle.radius });
+		return true;
+	}
+
+	bool ObstacleClusters::anyNear(const SensorPose* sensors, std::size_t count, float range) const noexcept {
+		if (count == 0U) {
+			return false;
+		}
+		sf::Vector2f low = sensors[0].position;
+		sf::Vector2f high = low;
+		for (std::size_t i = 1U; i < count; ++i) {
+			const sf::Vector2f& position = sensors[i].position;
+			low = { std::min(low.x, position.x), std::min(low.y, position.y) };
+			high = { std::max(high.x, position.x), std::max(high.y, position.y) };
+		}
+		const sf::Vector2f center = (low + high) * 0.5F;
+		return anyWithin(center, 0.5F * lengthOf(high - low), range);
+	}
+
+} // namespace sim
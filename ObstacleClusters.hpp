@@ -0,0 +1,113 @@
+/*
+==============================================================================
+Obstacle Clusters - bounding-circle hierarchy for coarse "nothing near" tests
+==============================================================================
+ - Every static obstacle the sensors can read is one bounding circle: a
+   pillar with its radius, a polygon around its outline, a wall cut into
+   pieces of at most WALL_PIECE so the lot boundary does not swell the
+   clusters it sits in
+ - Circles are grouped top-down (median split of the centers on the longer
+   axis, at most LEAF_ITEMS per leaf); each group is bounded by the tighter
+   of a circle around its items and one around its two halves. Nodes are
+   flattened depth first with the index past their subtree, so a query
+   walks one array without a stack and stops at the first item in reach
+ - anyWithin() answers whether any obstacle comes within a distance of a
+   circle: a car far from everything is cleared after a few cluster
+   bounds, and only a cluster inside the outermost beep band sends the
+   sensors on to the exact per-obstacle lookups
+ - A query walks the levels above its own position whatever the answer,
+   so the walk grows with the lot while a grid lookup does not: past
+   MAX_ITEMS bounds nothing is built and every query answers "near"
+ - Conservative: a false answer guarantees every sensor engine would read
+   nothing in range, so skipping them changes no reading
+ - An edited pillar is covered by one extra circle checked beside the
+   hierarchy (cover()); the bound it left behind stays, which only makes
+   the answer more often "near", so edits need no rebuild until
+   MAX_EXTRA of them pile up
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+#include "PolygonBvh.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	class ObstacleClusters {
+	public:
+		static constexpr std::size_t LEAF_ITEMS = 8U;
+		static constexpr float WALL_PIECE = 256.0F; // longest wall piece bounded by one circle
+		static constexpr std::size_t MAX_ITEMS = 2048U; // larger lots are left to the exact lookups
+		static constexpr std::size_t MAX_EXTRA = 64U;   // cover() circles before a rebuild is due
+
+		/**
+		 * @brief Rebuilds the hierarchy from the pillars, wall segments and polygons the sensors read.
+		 */
+		void build(const std::vector<Obstacle>& obstacles, const std::vector<WallSegment>& walls = {},
+			const PolygonSet& polygons = {});
+
+		/**
+		 * @brief True if some obstacle's bound comes within distance of the circle (center, radius).
+		 *
+		 * Always true for a lot of more than MAX_ITEMS bounds; false for an empty one.
+		 * MISRA: no allocation.
+		 */
+		[[nodiscard]] bool anyWithin(const sf::Vector2f& center, float radius, float distance) const noexcept;
+
+		/**
+		 * @brief Also reports obstacle from now on (a pillar placed or moved since build()).
+		 *
+		 * Returns false and changes nothing once MAX_EXTRA circles were added;
+		 * the caller rebuilds then.
+		 */
+		bool cover(const Obstacle& obstacle);
+
+		/**
+		 * @brief anyWithin() for the circle around every sensor position: false means no sensor has anything within range.
+		 */
+		[[nodiscard]] bool anyNear(const SensorPose* sensors, std::size_t count, float range) const noexcept;
+
+		[[nodiscard]] bool anyNear(const std::vector<SensorPose>& sensors, float range) const noexcept {
+			return anyNear(sensors.data(), sensors.size(), range);
+		}
+
+		[[nodiscard]] bool empty() const noexcept { return m_nodes.empty() && m_extra.empty() && !m_uncovered; }
+		[[nodiscard]] std::size_t itemCount() const noexcept { return m_items.size(); }
+		[[nodiscard]] std::size_t nodeCount() const noexcept { return m_nodes.size(); }
+
+	private:
+		struct Circle {
+			sf::Vector2f center;
+			float radius;
+		};
+
+		// count == 0: inner node whose subtree is [this + 1, skip); otherwise a leaf of items [first, first + count)
+		struct Node {
+			Circle bound;
+			std::uint32_t first;
+			std::uint32_t count;
+			std::uint32_t skip; // next node once this subtree is done
+		};
+
+		// Splits items [first, last) under a new node; returns its bound
+		Circle buildNode(std::vector<Circle>& items, std::uint32_t first, std::uint32_t last);
+
+		// Counted against the obstacle subsystem's heap
+		template <typename T>
+		using Array = prof::TrackedVector<T, prof::MemorySubsystem::Obstacles>;
+
+		Array<Circle> m_items; // leaf order
+		Array<Node> m_nodes;   // depth first, root at 0
+		Array<Circle> m_extra; // cover() circles, tested after the hierarchy
+		bool m_uncovered = false; // more than MAX_ITEMS: no hierarchy, every query is "near"
+	};
+
+} // namespace sim
@@ -0,0 +1,450 @@
+#include "ObstacleGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	namespace {
+		// Upper bound on cells per obstacle; keeps sparse, wide lots from
+		// allocating mostly empty cell tables.
+		constexpr std::size_t MAX_CELLS_PER_POINT = 4U;
+
+		// Up to this many walls a direct scan beats walking their cells.
+		constexpr std::size_t MAX_SCANNED_WALLS = 16U;
+
+		// Clamp before float->int conversion so far-away queries stay defined.
+		constexpr float MAX_CELL_COORD = 1.0e6F;
+
+		// From this many points build() bins them on the shared pool, in chunks of PARALLEL_BUILD_CHUNK.
+		constexpr std::size_t PARALLEL_BUILD_POINTS = 100000U;
+		constexpr std::size_t PARALLEL_BUILD_CHUNK = 32768U;
+
+		[[nodiscard]] int toCell(float offset, float invCellSize) {
+			const float c = std::floor(offset * invCellSize);
+			return static_cast<int>(std::clamp(c, -MAX_CELL_COORD, MAX_CELL_COORD));
+		}
+	}
+
+	ObstacleGrid::CellLayout ObstacleGrid::fitCells(const sf::Vector2f& minP, const sf::Vector2f& maxP, float cellSize,
+		std::size_t maxCells)
+	{
+		CellLayout cells;
+		const float extent = std::max({ maxP.x - minP.x, maxP.y - minP.y, 1.0F });
+		cells.cellSize = (cellSize > 0.0F) ? cellSize : extent;
+		for (;;) {
+			cells.cols = static_cast<int>((maxP.x - minP.x) / cells.cellSize) + 1;
+			cells.rows = static_cast<int>((maxP.y - minP.y) / cells.cellSize) + 1;
+			if (static_cast<std::size_t>(cells.cols) * static_cast<std::size_t>(cells.rows) <= maxCells) {
+				break;
+			}
+			cells.cellSize *= 2.0F;
+		}
+		cells.origin = minP;
+		cells.invCellSize = 1.0F / cells.cellSize;
+		return cells;
+	}
+
+	void ObstacleGrid::build(const std::vector<sf::Vector2f>& points, float cellSize,
+		const std::vector<WallSegment>& walls, const PolygonSet& polygons)
+	{
+		m_points.clear();
+		m_ids.clear();
+		m_cellStart.clear();
+		m_walls.clear();
+		m_wallStart.clear();
+		m_wallIds.clear();
+		m_oneSidedWalls = false;
+		m_cells = {};
+		m_wallCells = {};
+		m_polygons.build(polygons);
+
+		if (!points.empty()) {
+			// Bounds and cell indices are per-point work, spread over the pool for large
+			// lots; the counting sort below stays sequential so ids keep their order
+			const std::size_t chunk = (points.size() >= PARALLEL_BUILD_POINTS) ? PARALLEL_BUILD_CHUNK : points.size();
+			const std::size_t chunkCount = (points.size() + chunk - 1U) / chunk;
+			std::vector<sf::Vector2f> chunkMin(chunkCount, points.front());
+			std::vector<sf::Vector2f> chunkMax(chunkCount, points.front());
+			sharedPool().parallelFor(points.size(), chunk, [&](std::size_t begin, std::size_t end) {
+				sf::Vector2f& minP = chunkMin[begin / chunk];
+				sf::Vector2f& maxP = chunkMax[begin / chunk];
+				for (std::size_t i = begin; i < end; ++i) {
+					minP.x = std::min(minP.x, points[i].x);
+					minP.y = std::min(minP.y, points[i].y);
+					maxP.x = std::max(maxP.x, points[i].x);
+					maxP.y = std::max(maxP.y, points[i].y);
+				}
+			});
+			sf::Vector2f minP = chunkMin.front();
+			sf::Vector2f maxP = chunkMax.front();
+			for (std::size_t c = 1U; c < chunkCount; ++c) {
+				minP = { std::min(minP.x, chunkMin[c].x), std::min(minP.y, chunkMin[c].y) };
+				maxP = { std::max(maxP.x, chunkMax[c].x), std::max(maxP.y, chunkMax[c].y) };
+			}
+			m_cells = fitCells(minP, maxP, cellSize, points.size() * MAX_CELLS_PER_POINT);
+
+			// Counting sort of the points into their cells
+			const std::size_t cellCount = static_cast<std::size_t>(m_cells.cols) * static_cast<std::size_t>(m_cells.rows);
+			std::vector<std::uint32_t> cellOf(points.size());
+			m_cellStart.assign(cellCount + 1U, 0U);
+
+			sharedPool().parallelFor(points.size(), chunk, [&](std::size_t begin, std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					const int cx = std::min(toCell(points[i].x - m_cells.origin.x, m_cells.invCellSize), m_cells.cols - 1);
+					const int cy = std::min(toCell(points[i].y - m_cells.origin.y, m_cells.invCellSize), m_cells.rows - 1);
+					cellOf[i] = static_cast<std::uint32_t>(cy * m_cells.cols + cx);
+				}
+			});
+			for (const std::uint32_t cell : cellOf) {
+				++m_cellStart[cell + 1U];
+			}
+			for (std::size_t c = 0U; c < cellCount; ++c) {
+				m_cellStart[c + 1U] += m_cellStart[c];
+			}
+
+			std::vector<std::uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+			m_points.resize(points.size());
+			m_ids.resize(points.size());
+			for (std::size_t i = 0U; i < points.size(); ++i) {
+				const std::uint32_t slot = cursor[cellOf[i]]++;
+				m_points[slot] = points[i];
+				m_ids[slot] = static_cast<std::uint32_t>(i);
+			}
+		}
+
+		if (walls.empty()) {
+			return;
+		}
+
+		sf::Vector2f minW = walls.front().from;
+		sf::Vector2f maxW = minW;
+		m_walls.reserve(walls.size());
+		for (const auto& wall : walls) {
+			minW = { std::min({ minW.x, wall.from.x, wall.to.x }), std::min({ minW.y, wall.from.y, wall.to.y }) };
+			maxW = { std::max({ maxW.x, wall.from.x, wall.to.x }), std::max({ maxW.y, wall.from.y, wall.to.y }) };
+			const sf::Vector2f along = wall.to - wall.from;
+			const float lengthSq = along.x * along.x + along.y * along.y;
+			m_walls.push_back({ wall.from, along, (lengthSq > 0.0F) ? 1.0F / lengthSq : 0.0F, wall.oneSided });
+			m_oneSidedWalls = m_oneSidedWalls || wall.oneSided != 0U;
+		}
+		if (walls.size() <= MAX_SCANNED_WALLS) {
+			return;
+		}
+		m_wallCells = fitCells(minW, maxW, cellSize, walls.size() * MAX_CELLS_PER_POINT);
+
+		// Walls go into every cell of their bounding box: a count pass, then a fill pass
+		const CellLayout& cells = m_wallCells;
+		const std::size_t cellCount = static_cast<std::size_t>(cells.cols) * static_cast<std::size_t>(cells.rows);
+		m_wallStart.assign(cellCount + 1U, 0U);
+		const auto forEachCell = [&cells](const WallSegment& wall, auto&& visit) {
+			const sf::Vector2f low = sf::Vector2f{ std::min(wall.from.x, wall.to.x), std::min(wall.from.y, wall.to.y) } - cells.origin;
+			const sf::Vector2f high = sf::Vector2f{ std::max(wall.from.x, wall.to.x), std::max(wall.from.y, wall.to.y) } - cells.origin;
+			const int xBegin = std::min(toCell(low.x, cells.invCellSize), cells.cols - 1);
+			const int xEnd = std::min(toCell(high.x, cells.invCellSize), cells.cols - 1);
+			const int yBegin = std::min(toCell(low.y, cells.invCellSize), cells.rows - 1);
+			const int yEnd = std::min(toCell(high.y, cells.invCellSize), cells.rows - 1);
+			for (int y = yBegin; y <= yEnd; ++y) {
+				for (int x = xBegin; x <= xEnd; ++x) {
+					visit(static_cast<std::size_t>(y) * static_cast<std::size_t>(cells.cols) + static_cast<std::size_t>(x));
+				}
+			}
+		};
+		for (const auto& wall : walls) {
+			forEachCell(wall, [this](std::size_t cell) { ++m_wallStart[cell + 1U]; });
+		}
+		for (std::size_t c = 0U; c < cellCount; ++c) {
+			m_wallStart[c + 1U] += m_wallStart[c];
+		}
+		std::vector<std::uint32_t> cursor(m_wallStart.begin(), m_wallStart.end() - 1);
+		m_wallIds.resize(m_wallStart.back());
+		for (std::size_t i = 0U; i < walls.size(); ++i) {
+			forEachCell(walls[i], [this, &cursor, i](std::size_t cell) {
+				m_wallIds[cursor[cell]++] = static_cast<std::uint32_t>(i);
+			});
+		}
+	}
+
+	void ObstacleGrid::nearerWall(const GridWall& wall, const sf::Vector2f& query, float limitSq, float& wallSq) noexcept {
+		const sf::Vector2f offset = query - wall.from;
+		const float t = (offset.x * wall.along.x + offset.y * wall.along.y) * wall.invLengthSq;
+		const float clamped = std::clamp(t, 0.0F, 1.0F);
+		const float dx = offset.x - clamped * wall.along.x;
+		const float dy = offset.y - clamped * wall.along.y;
+		const float distanceSq = dx * dx + dy * dy;
+		if (distanceSq >= limitSq) {
+			return;
+		}
+		// Within the span, on the solid side of a one-sided wall
+		const bool behind = wall.oneSided != 0U && t == clamped
+			&& wall.along.x * offset.y - wall.along.y * offset.x <= 0.0F;
+		wallSq = behind ? 0.0F : std::min(wallSq, distanceSq);
+	}
+
+	template <typename Scan>
+	void ObstacleGrid::ringSearch(const CellLayout& cells, const sf::Vector2f& query, const float& boundSq, Scan&& scan) {
+		const int qx = toCell(query.x - cells.origin.x, cells.invCellSize);
+		const int qy = toCell(query.y - cells.origin.y, cells.invCellSize);
+
+		// Chebyshev ring range that can intersect the grid at all
+		const int ringMin = std::max({ 0, -qx, qx - (cells.cols - 1), -qy, qy - (cells.rows - 1) });
+		const int ringMax = std::max({ qx, (cells.cols - 1) - qx, qy, (cells.rows - 1) - qy });
+
+		const auto visit = [&cells, &scan](int cx, int cy) {
+			if (cx >= 0 && cy >= 0 && cx < cells.cols && cy < cells.rows) {
+				scan(static_cast<std::size_t>(cy) * static_cast<std::size_t>(cells.cols) + static_cast<std::size_t>(cx));
+			}
+		};
+
+		for (int r = ringMin; r <= ringMax; ++r) {
+			// Everything first listed in ring r is at least (r - 1) whole cells away
+			if (r > 0) {
+				const float lowerBound = static_cast<float>(r - 1) * cells.cellSize;
+				if (lowerBound * lowerBound >= boundSq) {
+					break;
+				}
+			}
+
+			if (r == 0) {
+				visit(qx, qy);
+				continue;
+			}
+
+			const int xBegin = std::max(qx - r, 0);
+			const int xEnd = std::min(qx + r, cells.cols - 1);
+			for (int x = xBegin; x <= xEnd; ++x) {
+				visit(x, qy - r);
+				visit(x, qy + r);
+			}
+
+			const int yBegin = std::max(qy - r + 1, 0);
+			const int yEnd = std::min(qy + r - 1, cells.rows - 1);
+			for (int y = yBegin; y <= yEnd; ++y) {
+				visit(qx - r, y);
+				visit(qx + r, y);
+			}
+		}
+	}
+
+	float ObstacleGrid::nearestDistance(const sf::Vector2f& query, float maxDistance) const {
+		const float bestSq = nearestDistanceSq(query, maxDistance);
+		return (bestSq < std::numeric_limits<float>::max()) ? std::sqrt(bestSq) : bestSq;
+	}
+
+	float ObstacleGrid::nearestDistanceSq(const sf::Vector2f& query, float maxDistance) const {
+		return nearest(query, maxDistance).distanceSq;
+	}
+
+	NearestObstacle ObstacleGrid::nearest(const sf::Vector2f& query, float maxDistance) const {
+		return search(query, maxDistance, true);
+	}
+
+	float ObstacleGrid::nearestWall(const sf::Vector2f& query, float maxDistance) const {
+		return search(query, maxDistance, false).wallDistance;
+	}
+
+	NearestObstacle ObstacleGrid::search(const sf::Vector2f& query, float maxDistance, bool points) const {
+		const float limitSq = maxDistance * maxDistance;
+		NearestObstacle best;
+		best.distanceSq = limitSq;
+
+		if (points && !m_points.empty()) {
+			ringSearch(m_cells, query, best.distanceSq, [this, &query, &best](std::size_t cell) {
+				for (std::uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1U]; ++i) {
+					const float dx = m_points[i].x - query.x;
+					const float dy = m_points[i].y - query.y;
+					const float distanceSq = dx * dx + dy * dy;
+					if (distanceSq < best.distanceSq) {
+						best.distanceSq = distanceSq;
+						best.index = m_ids[i];
+					}
+				}
+			});
+		}
+		if (points && !m_polygons.empty()) {
+			const float polygonSq = m_polygons.nearestSq(query, best.distanceSq);
+			if (polygonSq < best.distanceSq) {
+				best.distanceSq = polygonSq;
+				best.index = NO_OBSTACLE;
+			}
+		}
+
+		float wallSq = limitSq;
+		if (m_wallStart.empty()) {
+			for (const GridWall& wall : m_walls) {
+				nearerWall(wall, query, limitSq, wallSq);
+			}
+		}
+		else {
+			// Past the nearest wall, the query may still be behind a one-sided one
+			const float* boundSq = m_oneSidedWalls ? &limitSq : &wallSq;
+			ringSearch(m_wallCells, query, *boundSq, [this, &query, limitSq, &wallSq](std::size_t cell) {
+				for (std::uint32_t i = m_wallStart[cell]; i < m_wallStart[cell + 1U]; ++i) {
+					nearerWall(m_walls[m_wallIds[i]], query, limitSq, wallSq);
+				}
+			});
+		}
+
+		NearestObstacle found = (best.distanceSq < limitSq) ? best : NearestObstacle{};
+		if (wallSq < limitSq) {
+			found.wallDistance = std::sqrt(wallSq);
+		}
+		return found;
+	}
+
+	void ObstacleGrid::gather(const sf::Vector2f& query, float radius, std::vector<std::uint32_t>& out) const {
+		if (m_points.empty() || !(radius >= 0.0F)) {
+			return;
+		}
+
+		const int xBegin = std::max(toCell(query.x - radius - m_cells.origin.x, m_cells.invCellSize), 0);
+		const int xEnd = std::min(toCell(query.x + radius - m_cells.origin.x, m_cells.invCellSize), m_cells.cols - 1);
+		const int yBegin = std::max(toCell(query.y - radius - m_cells.origin.y, m_cells.invCellSize), 0);
+		const int yEnd = std::min(toCell(query.y + radius - m_cells.origin.y, m_cells.invCellSize), m_cells.rows - 1);
+
+		const float radiusSq = radius * radius;
+		for (int y = yBegin; y <= yEnd; ++y) {
+			const std::size_t row = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cells.cols);
+			for (int x = xBegin; x <= xEnd; ++x) {
+				const std::size_t cell = row + static_cast<std::size_t>(x);
+				for (std::uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1U]; ++i) {
+					const float dx = m_points[i].x - query.x;
+					const float dy = m_points[i].y - query.y;
+					if (dx * dx + dy * dy <= radiusSq) {
+						out.push_back(m_ids[i]);
+					}
+				}
+			}
+		}
+	}
+
+	std::size_t ObstacleGrid::within(const sf::Vector2f& query, float radius, ObstacleHit* out, std::size_t capacity) const {
+		if (m_points.empty() || !(radius >= 0.0F)) {
+			return 0U;
+		}
+
+		const int xBegin = std::max(toCell(query.x - radius - m_cells.origin.x, m_cells.invCellSize), 0);
+		const int xEnd = std::min(toCell(query.x + radius - m_cells.origin.x, m_cells.invCellSize), m_cells.cols - 1);
+		const int yBegin = std::max(toCell(query.y - radius - m_cells.origin.y, m_cells.invCellSize), 0);
+		const int yEnd = std::min(toCell(query.y + radius - m_cells.origin.y, m_cells.invCellSize), m_cells.rows - 1);
+
+		const float radiusSq = radius * radius;
+		std::size_t count = 0U;
+		for (int y = yBegin; y <= yEnd; ++y) {
+			const std::size_t row = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cells.cols);
+			for (int x = xBegin; x <= xEnd; ++x) {
+				const std::size_t cell = row + static_cast<std::size_t>(x);
+				for (std::uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1U]; ++i) {
+					const float dx = m_points[i].x - query.x;
+					const float dy = m_points[i].y - query.y;
+					const float distanceSq = dx * dx + dy * dy;
+					if (distanceSq <= radiusSq) {
+						if (count < capacity) {
+							out[count] = { distanceSq, m_ids[i] };
+						}
+						++count;
+					}
+				}
+			}
+		}
+		return count;
+	}
+
+	std::size_t ObstacleGrid::nearestK(const sf::Vector2f& query, float maxDistance, ObstacleHit* out, std::size_t k) const {
+		if (m_points.empty() || k == 0U || !(maxDistance >= 0.0F)) {
+			return 0U;
+		}
+
+		// out stays sorted; once full, the ring walk stops at its farthest entry
+		const float limitSq = maxDistance * maxDistance;
+		float boundSq = limitSq;
+		std::size_t count = 0U;
+		ringSearch(m_cells, query, boundSq, [this, &query, out, k, limitSq, &boundSq, &count](std::size_t cell) {
+			for (std::uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1U]; ++i) {
+				const float dx = m_points[i].x - query.x;
+				const float dy = m_points[i].y - query.y;
+				const float distanceSq = dx * dx + dy * dy;
+				if (distanceSq >= boundSq) {
+					continue;
+				}
+				std::size_t slot = (count < k) ? count++ : k - 1U;
+				while (slot > 0U && out[slot - 1U].distanceSq > distanceSq) {
+					out[slot] = out[slot - 1U];
+					--slot;
+				}
+				out[slot] = { distanceSq, m_ids[i] };
+				boundSq = (count == k) ? out[k - 1U].distanceSq : limitSq;
+			}
+		});
+		return count;
+	}
+
+	bool ObstacleGrid::cellOf(const sf::Vector2f& point, std::size_t& cell) const noexcept {
+		const int cx = toCell(point.x - m_cells.origin.x, m_cells.invCellSize);
+		const int cy = toCell(point.y - m_cells.origin.y, m_cells.invCellSize);
+		if (cx < 0 || cy < 0 || cx >= m_cells.cols || cy >= m_cells.rows) {
+			return false;
+		}
+		cell = static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cells.cols) + static_cast<std::size_t>(cx);
+		return true;
+	}
+
+	std::uint32_t ObstacleGrid::carry(std::uint32_t slot, std::size_t from, std::size_t to) {
+		const auto swapSlots = [this](std::uint32_t a, std::uint32_t b) {
+			std::swap(m_points[a], m_points[b]);
+			std::swap(m_ids[a], m_ids[b]);
+		};
+		// Forwards: the entry becomes the last of its cell, whose end then moves
+		// down past it, handing the slot to the next cell (empty cells included)
+		while (from < to) {
+			const std::uint32_t last = m_cellStart[from + 1U] - 1U;
+			swapSlots(slot, last);
+			slot = last;
+			--m_cellStart[from + 1U];
+			++from;
+		}
+		// Backwards: the first of its cell, handed to the cell before
+		while (from > to) {
+			const std::uint32_t first = m_cellStart[from];
+			swapSlots(slot, first);
+			slot = first;
+			++m_cellStart[from];
+			--from;
+		}
+		return slot;
+	}
+
+	bool ObstacleGrid::insertObstacle(const sf::Vector2f& point) {
+		std::size_t cell = 0U;
+		if (m_points.empty() || !cellOf(point, cell)) {
+			return false;
+		}
+		// Appended to the last cell, then carried back to its own
+		const auto slot = static_cast<std::uint32_t>(m_points.size());
+		m_points.push_back(point);
+		m_ids.push_back(slot);
+		++m_cellStart.back();
+		(void)carry(slot, m_cellStart.size() - 2U, cell);
+		return true;
+	}
+
+	bool ObstacleGrid::moveObstacle(std::uint32_t index, const sf::Vector2f& from, const sf::Vector2f& to) {
+		std::size_t source = 0U;
+		std::size_t target = 0U;
+		if (m_points.empty() || !cellOf(from, source) || !cellOf(to, target)) {
+			return false;
+		}
+		for (std::uint32_t i = m_cellStart[source]; i < m_cellStart[source + 1U]; ++i) {
+			if (m_ids[i] == index) {
+				m_points[i] = to;
+				(void)carry(i, source, target);
+				return true;
+			}
+		}
+		return false;
+	}
+
+} // namespace sim
@@ -0,0 +1,199 @@
+/*
+==============================================================================
+Obstacle Grid - uniform spatial index over static obstacle positions
+==============================================================================
+ - Built once from the obstacle positions (CSR layout: one index range per cell)
+ - Wall segments (walls, curbs, the lot boundary) are indexed alongside:
+   one nearest() finds the nearest pillar and the nearest wall. A handful
+   of walls is scanned directly; larger sets get a cell table of their own
+   extent, each wall listed in every cell its bounding box overlaps, so the
+   lot boundary never coarsens the pillar cells
+ - Polygon obstacles (islands, irregular curbs) sit in a PolygonBvh the
+   grid owns; nearest() reports whichever of pillar center and polygon
+   surface is nearer, a polygon with index NO_OBSTACLE
+ - Nearest-obstacle lookups scan rings of cells around the query point and
+   stop as soon as no unvisited ring can hold a closer obstacle
+ - Range queries visit only the cells overlapping the query circle
+ - within() and nearestK() write obstacle hits into caller buffers, for
+   "everything inside the outermost beep band" and k nearest per sensor
+   without allocating
+ - Editing (insertObstacle(), moveObstacle()) carries one entry across the
+   cell boundaries between its old and new cell, swapping it with the end
+   entry of each cell on the way, so a dragged pillar costs the cells it
+   passes rather than a rebuild of the whole lot
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+#include "PolygonBvh.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	// Nearest obstacle and wall found by a lookup; the floats come first so
+	// the x86-64 ABI returns them in one vector register and index in another
+	struct NearestObstacle {
+		float distanceSq = std::numeric_limits<float>::max();
+		float wallDistance = std::numeric_limits<float>::max(); // to the nearest wall, 0 on or past a one-sided one
+		std::uint32_t index = NO_OBSTACLE;                      // position in the array given to build(); NO_OBSTACLE for a polygon
+	};
+
+	// One obstacle found by within() or nearestK()
+	struct ObstacleHit {
+		float distanceSq = std::numeric_limits<float>::max();
+		std::uint32_t index = NO_OBSTACLE; // position in the array given to build()
+	};
+
+	class ObstacleGrid {
+	public:
+		/**
+		 * @brief Rebuilds the grid from a set of obstacle positions, wall segments and polygons.
+		 *
+		 * MISRA: cellSize must be strictly positive; non-positive values fall
+		 *        back to a single cell covering all points and walls.
+		 */
+		void build(const std::vector<sf::Vector2f>& points, float cellSize, const std::vector<WallSegment>& walls = {},
+			const PolygonSet& polygons = {});
+
+		/**
+		 * @brief Distance from query to the nearest obstacle.
+		 *
+		 * Obstacles farther than maxDistance are not searched for; if none is
+		 * within range, std::numeric_limits<float>::max() is returned.
+		 */
+		[[nodiscard]] float nearestDistance(const sf::Vector2f& query, float maxDistance) const;
+
+		/**
+		 * @brief Squared distance from query to the nearest obstacle, without the sqrt.
+		 *
+		 * Same search as nearestDistance(); std::numeric_limits<float>::max()
+		 * if none is within maxDistance.
+		 */
+		[[nodiscard]] float nearestDistanceSq(const sf::Vector2f& query, float maxDistance) const;
+
+		/**
+		 * @brief Nearest obstacle and wall within maxDistance: the obstacle's build()
+		 *        index and squared distance, and the wall's distance.
+		 *
+		 * A polygon nearer than every obstacle reports its squared surface
+		 * distance (0 inside) with index NO_OBSTACLE. If nothing is in range,
+		 * index is NO_OBSTACLE and distanceSq is std::numeric_limits<float>::max();
+		 * likewise wallDistance for walls.
+		 */
+		[[nodiscard]] NearestObstacle nearest(const sf::Vector2f& query, float maxDistance) const;
+
+		/**
+		 * @brief Distance to the nearest wall within maxDistance (max if none),
+		 *        for sensing engines that find obstacles their own way.
+		 */
+		[[nodiscard]] float nearestWall(const sf::Vector2f& query, float maxDistance) const;
+
+		/**
+		 * @brief Appends the build() index of every obstacle within radius of query (polygons are not gathered).
+		 *
+		 * out is not cleared; indices come in cell order, not by distance.
+		 */
+		void gather(const sf::Vector2f& query, float radius, std::vector<std::uint32_t>& out) const;
+
+		/**
+		 * @brief Obstacles within radius of query, in cell order, into out[0..capacity).
+		 *
+		 * Returns how many are within radius, which may exceed capacity: only
+		 * the first capacity are written then. Polygons are not reported.
+		 */
+		std::size_t within(const sf::Vector2f& query, float radius, ObstacleHit* out, std::size_t capacity) const;
+
+		/**
+		 * @brief The k obstacles nearest to query within maxDistance, nearest first, into out[0..k).
+		 *
+		 * Returns how many were found (at most k). Equally distant obstacles
+		 * keep their grid order. Polygons are not reported.
+		 */
+		std::size_t nearestK(const sf::Vector2f& query, float maxDistance, ObstacleHit* out, std::size_t k) const;
+
+		/**
+		 * @brief Adds an obstacle at point as the next build() index (size() before the call).
+		 *
+		 * Lookups then match a rebuild, up to the order of equally distant
+		 * obstacles. Returns false and changes nothing if the grid holds no
+		 * points or point lies outside its cells; the caller rebuilds then.
+		 */
+		bool insertObstacle(const sf::Vector2f& point);
+
+		/**
+		 * @brief Moves obstacle index from from to to, as insertObstacle() adds one.
+		 *
+		 * Returns false and changes nothing if either position lies outside
+		 * the cells or index is not found at from.
+		 */
+		bool moveObstacle(std::uint32_t index, const sf::Vector2f& from, const sf::Vector2f& to);
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_points.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_points.empty(); }
+		[[nodiscard]] std::size_t wallCount() const noexcept { return m_walls.size(); }
+
+	private:
+		// Cell geometry of one table; the points and the walls each span their own extent
+		struct CellLayout {
+			sf::Vector2f origin{ 0.0F, 0.0F };
+			float cellSize = 1.0F;
+			float invCellSize = 1.0F;
+			int cols = 0;
+			int rows = 0;
+		};
+
+		// A WallSegment with what the distance test needs precomputed
+		struct GridWall {
+			sf::Vector2f from;
+			sf::Vector2f along;      // to - from
+			float invLengthSq;       // 0 for a zero-length wall
+			std::uint32_t oneSided;
+		};
+
+		// Lowers wallSq to the wall's squared distance if nearer, or to 0 behind a one-sided wall within limitSq
+		static void nearerWall(const GridWall& wall, const sf::Vector2f& query, float limitSq, float& wallSq) noexcept;
+
+		// Cells of at least cellSize over [minP, maxP], doubled until at most maxCells
+		[[nodiscard]] static CellLayout fitCells(const sf::Vector2f& minP, const sf::Vector2f& maxP, float cellSize,
+			std::size_t maxCells);
+
+		// Calls scan(cell) ring by ring around query until no unvisited ring can be nearer than boundSq
+		template <typename Scan>
+		static void ringSearch(const CellLayout& cells, const sf::Vector2f& query, const float& boundSq, Scan&& scan);
+
+		// Cell of point in m_cells; false outside them
+		[[nodiscard]] bool cellOf(const sf::Vector2f& point, std::size_t& cell) const noexcept;
+
+		// Carries the entry at slot from cell from to cell to, one cell boundary at a time; returns its slot there
+		std::uint32_t carry(std::uint32_t slot, std::size_t from, std::size_t to);
+
+		// nearest() and nearestWall(): points on request, then walls
+		[[nodiscard]] NearestObstacle search(const sf::Vector2f& query, float maxDistance, bool points) const;
+
+		CellLayout m_cells;
+		CellLayout m_wallCells;
+
+		// Counted against the obstacle subsystem's heap
+		template <typename T>
+		using Array = prof::TrackedVector<T, prof::MemorySubsystem::Obstacles>;
+
+		Array<std::uint32_t> m_cellStart; // m_cells.cols * m_cells.rows + 1 offsets into m_points
+		Array<sf::Vector2f> m_points;     // obstacle positions, sorted by cell
+		Array<std::uint32_t> m_ids;       // build() index of each sorted point
+		Array<GridWall> m_walls;
+		Array<std::uint32_t> m_wallStart; // per wall cell + 1 offsets into m_wallIds; empty if scanned directly
+		Array<std::uint32_t> m_wallIds;   // walls overlapping each cell, by cell
+		bool m_oneSidedWalls = false;     // then the cell walk cannot stop at the nearest wall
+		PolygonBvh m_polygons;            // searched after the points, within the nearest point's distance
+	};
+
+} // namespace sim
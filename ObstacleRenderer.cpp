@@ -0,0 +1,384 @@
+#include "ObstacleRenderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace gfx {
+
+	namespace {
+		constexpr float PI = 3.14159265358979323846F;
+		constexpr float TWO_PI = 6.28318530717958647692F;
+		constexpr std::size_t MIN_SEGMENTS = 3U;
+
+		// Coarser polygon levels, never finer than the configured segment count
+		constexpr std::size_t MEDIUM_SEGMENTS = 12U;
+		constexpr std::size_t COARSE_SEGMENTS = 6U;
+		constexpr std::size_t QUAD_VERTICES = 6U; // impostors and clusters: two triangles
+
+		// A rim may stray this far inside the true circle before the facets show
+		constexpr float MAX_RIM_ERROR_PIXELS = 0.5F;
+		// Below this radius a pillar is a quad of the same area
+		constexpr float IMPOSTOR_RADIUS_PIXELS = 2.0F;
+		// Cull cells smaller than this on screen collapse into one quad each
+		constexpr float CLUSTER_CELL_PIXELS = 16.0F;
+
+		// Cull cells: coarse enough that a window spans only a few rows,
+		// and never more than MAX_CULL_CELLS per axis on huge lots
+		constexpr float CULL_CELL_SIZE = 512.0F;
+		constexpr int MAX_CULL_CELLS = 1024;
+
+		// Sagitta of one rim segment: how far the chord cuts inside the circle
+		[[nodiscard]] float rimError(float radiusPixels, std::size_t segments) {
+			return radiusPixels * (1.0F - std::cos(PI / static_cast<float>(segments)));
+		}
+
+		void appendQuad(std::vector<sf::Vertex>& vertices, const sf::Vector2f& low, const sf::Vector2f& high, sf::Color color) {
+			const sf::Vector2f corners[4] = { low, { high.x, low.y }, high, { low.x, high.y } };
+			for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+				vertices.push_back({ corners[corner], color });
+			}
+		}
+
+		// A triangle fan of segments around obstacle, into out[0, 3 * segments)
+		void writeFan(sf::Vertex* out, const sim::Obstacle& obstacle, std::size_t segments, sf::Color color) {
+			for (std::size_t i = 0U; i < segments; ++i) {
+				const float from = TWO_PI * static_cast<float>(i) / static_cast<float>(segments);
+				const float to = TWO_PI * static_cast<float>(i + 1U) / static_cast<float>(segments);
+				*out++ = { obstacle.center, color };
+				*out++ = { obstacle.center + sf::Vector2f{ std::cos(from), std::sin(from) } * obstacle.radius, color };
+				*out++ = { obstacle.center + sf::Vector2f{ std::cos(to), std::sin(to) } * obstacle.radius, color };
+			}
+		}
+
+		// Impostor half side per unit radius: the square has the circle's area
+		const float IMPOSTOR_HALF_SIDE = 0.5F * std::sqrt(PI);
+	}
+
+	float pixelsPerUnit(const sf::RenderTarget& target) {
+		const sf::View& view = target.getView();
+		const float width = std::abs(view.getSize().x);
+		if (width <= 0.0F) {
+			return 0.0F;
+		}
+		return static_cast<float>(target.getSize().x) * view.getViewport().size.x / width;
+	}
+
+	std::size_t circlePointCount(float radiusPixels, std::size_t maxPoints) {
+		const std::size_t cap = std::max(maxPoints, MIN_SEGMENTS);
+		if (radiusPixels <= MAX_RIM_ERROR_PIXELS) {
+			return MIN_SEGMENTS;
+		}
+		// Invert the sagitta: the fewest segments whose chords stay within the error
+		const float points = std::ceil(PI / std::acos(1.0F - MAX_RIM_ERROR_PIXELS / radiusPixels));
+		if (!(points < static_cast<float>(cap))) {
+			return cap;
+		}
+		return std::max(static_cast<std::size_t>(points), MIN_SEGMENTS);
+	}
+
+	ObstacleRenderer::ObstacleRenderer(std::size_t segmentsPerCircle)
+		: m_segments(std::max(segmentsPerCircle, MIN_SEGMENTS))
+		, m_lodSegments{ m_segments, std::min(m_segments, MEDIUM_SEGMENTS), std::min(m_segments, COARSE_SEGMENTS) }
+	{
+	}
+
+	void ObstacleRenderer::setObstacles(const std::vector<sim::Obstacle>& obstacles, sf::Color color) {
+		// Bounds of the obstacle centers; circles are bucketed by the cell of their center
+		sf::Vector2f low{ 0.0F, 0.0F };
+		sf::Vector2f high{ 0.0F, 0.0F };
+		m_maxRadius = 0.0F;
+		for (std::size_t i = 0U; i < obstacles.size(); ++i) {
+			const sf::Vector2f c = obstacles[i].center;
+			low = (i == 0U) ? c : sf::Vector2f{ std::min(low.x, c.x), std::min(low.y, c.y) };
+			high = (i == 0U) ? c : sf::Vector2f{ std::max(high.x, c.x), std::max(high.y, c.y) };
+			m_maxRadius = std::max(m_maxRadius, obstacles[i].radius);
+		}
+		m_origin = low;
+		m_cellSize = std::max({ CULL_CELL_SIZE, (high.x - low.x) / static_cast<float>(MAX_CULL_CELLS),
+			(high.y - low.y) / static_cast<float>(MAX_CULL_CELLS) });
+		m_cols = static_cast<int>((high.x - low.x) / m_cellSize) + 1;
+		m_rows = static_cast<int>((high.y - low.y) / m_cellSize) + 1;
+
+		const auto cellOf = [this](const sf::Vector2f& c) {
+			const int cx = std::min(static_cast<int>((c.x - m_origin.x) / m_cellSize), m_cols - 1);
+			const int cy = std::min(static_cast<int>((c.y - m_origin.y) / m_cellSize), m_rows - 1);
+			return static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(cx);
+		};
+
+		// Counting sort of the obstacles by cell
+		const std::size_t cellCount = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+		std::vector<std::size_t> firstObstacle(cellCount + 1U, 0U);
+		for (const auto& obstacle : obstacles) {
+			++firstObstacle[cellOf(obstacle.center) + 1U];
+		}
+		for (std::size_t i = 0U; i < cellCount; ++i) {
+			firstObstacle[i + 1U] += firstObstacle[i];
+		}
+		std::vector<const sim::Obstacle*> sorted(obstacles.size());
+		std::vector<std::size_t> cursor(firstObstacle.begin(), firstObstacle.end() - 1);
+		m_slots.resize(obstacles.size());
+		for (std::size_t i = 0U; i < obstacles.size(); ++i) {
+			const std::size_t slot = cursor[cellOf(obstacles[i].center)]++;
+			sorted[slot] = &obstacles[i];
+			m_slots[i] = static_cast<std::uint32_t>(slot);
+		}
+		m_loose.clear();
+		m_color = color;
+
+		m_vertices.clear();
+		m_vertices.reserve(obstacles.size() * ((m_lodSegments[0] + m_lodSegments[1] + m_lodSegments[2]) * 3U
+			+ 2U * QUAD_VERTICES));
+
+		// Polygon levels: a triangle fan per circle around a unit rim of that level
+		std::vector<sf::Vector2f> rim;
+		for (std::size_t level = 0U; level < m_lodSegments.size(); ++level) {
+			const std::size_t segments = m_lodSegments[level];
+			rim.resize(segments + 1U);
+			for (std::size_t i = 0U; i <= segments; ++i) {
+				const float angle = TWO_PI * static_cast<float>(i) / static_cast<float>(segments);
+				rim[i] = { std::cos(angle), std::sin(angle) };
+			}
+
+			const std::size_t base = m_vertices.size();
+			std::vector<std::size_t>& cellStart = m_cellStart[level];
+			cellStart.resize(cellCount + 1U);
+			for (std::size_t i = 0U; i <= cellCount; ++i) {
+				cellStart[i] = base + firstObstacle[i] * segments * 3U;
+			}
+			for (const sim::Obstacle* circle : sorted) {
+				const sim::Obstacle& obstacle = *circle;
+				for (std::size_t i = 0U; i < segments; ++i) {
+					m_vertices.push_back({ obstacle.center, color });
+					m_vertices.push_back({ obstacle.center + rim[i] * obstacle.radius, color });
+					m_vertices.push_back({ obstacle.center + rim[i + 1U] * obstacle.radius, color });
+				}
+			}
+		}
+
+		// Impostors: an axis-aligned square of the circle's area
+		{
+			const std::size_t base = m_vertices.size();
+			std::vector<std::size_t>& cellStart = m_cellStart[static_cast<std::size_t>(ObstacleLod::Impostor)];
+			cellStart.resize(cellCount + 1U);
+			for (std::size_t i = 0U; i <= cellCount; ++i) {
+				cellStart[i] = base + firstObstacle[i] * QUAD_VERTICES;
+			}
+			for (const sim::Obstacle* circle : sorted) {
+				const sf::Vector2f half{ circle->radius * IMPOSTOR_HALF_SIDE, circle->radius * IMPOSTOR_HALF_SIDE };
+				appendQuad(m_vertices, circle->center - half, circle->center + half, color);
+			}
+		}
+
+		// Clusters: one quad per occupied cell over its circles, as opaque as they are dense
+		{
+			std::vector<std::size_t>& cellStart = m_cellStart[static_cast<std::size_t>(ObstacleLod::Cluster)];
+			cellStart.resize(cellCount + 1U);
+			cellStart[0] = m_vertices.size();
+			for (std::size_t cell = 0U; cell < cellCount; ++cell) {
+				const std::size_t first = firstObstacle[cell];
+				const std::size_t last = firstObstacle[cell + 1U];
+				if (first != last) {
+					sf::Vector2f low = sorted[first]->center;
+					sf::Vector2f high = low;
+					float area = 0.0F;
+					for (std::size_t i = first; i < last; ++i) {
+						const sim::Obstacle& obstacle = *sorted[i];
+						const sf::Vector2f half{ obstacle.radius, obstacle.radius };
+						low = { std::min(low.x, obstacle.center.x - half.x), std::min(low.y, obstacle.center.y - half.y) };
+						high = { std::max(high.x, obstacle.center.x + half.x), std::max(high.y, obstacle.center.y + half.y) };
+						area += PI * obstacle.radius * obstacle.radius;
+					}
+					const float box = (high.x - low.x) * (high.y - low.y);
+					const float coverage = (box > 0.0F) ? std::min(area / box, 1.0F) : 1.0F;
+					sf::Color shade = color;
+					shade.a = static_cast<std::uint8_t>(static_cast<float>(color.a) * coverage);
+					appendQuad(m_vertices, low, high, shade);
+				}
+				cellStart[cell + 1U] = m_vertices.size();
+			}
+		}
+
+		m_heapCharge.set(m_vertices.capacity() * sizeof(sf::Vertex));
+		m_useBuffer = false;
+		if (m_vertices.empty() || !sf::VertexBuffer::isAvailable()) {
+			return;
+		}
+
+		if (m_buffer.getVertexCount() != m_vertices.size() && !m_buffer.create(m_vertices.size())) {
+			std::cerr << "Error: Failed to create obstacle vertex buffer, using client-side vertices\n";
+			return;
+		}
+		m_videoCharge.set(m_buffer.getVertexCount() * sizeof(sf::Vertex));
+		if (!m_buffer.update(m_vertices.data())) {
+			std::cerr << "Error: Failed to upload obstacle vertex buffer, using client-side vertices\n";
+			return;
+		}
+		m_useBuffer = true;
+	}
+
+	bool ObstacleRenderer::cellOf(const sf::Vector2f& center, std::size_t& cell) const noexcept {
+		const float fx = std::floor((center.x - m_origin.x) / m_cellSize);
+		const float fy = std::floor((center.y - m_origin.y) / m_cellSize);
+		if (!(fx >= 0.0F && fy >= 0.0F && fx < static_cast<float>(m_cols) && fy < static_cast<float>(m_rows))) {
+			return false;
+		}
+		cell = static_cast<std::size_t>(fy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(fx);
+		return true;
+	}
+
+	void ObstacleRenderer::writeSlot(std::uint32_t slot, const sim::Obstacle& obstacle) {
+		const auto upload = [this](std::size_t first, std::size_t count) {
+			if (m_useBuffer && !m_buffer.update(m_vertices.data() + first, count, static_cast<unsigned>(first))) {
+				std::cerr << "Error: Failed to update obstacle vertex buffer, using client-side vertices\n";
+				m_useBuffer = false;
+			}
+		};
+		for (std::size_t level = 0U; level < m_lodSegments.size(); ++level) {
+			const std::size_t segments = m_lodSegments[level];
+			const std::size_t first = m_cellStart[level][0] + static_cast<std::size_t>(slot) * segments * 3U;
+			writeFan(m_vertices.data() + first, obstacle, segments, m_color);
+			upload(first, segments * 3U);
+		}
+		const std::size_t first = m_cellStart[static_cast<std::size_t>(ObstacleLod::Impostor)][0]
+			+ static_cast<std::size_t>(slot) * QUAD_VERTICES;
+		std::vector<sf::Vertex> quad;
+		const sf::Vector2f half{ obstacle.radius * IMPOSTOR_HALF_SIDE, obstacle.radius * IMPOSTOR_HALF_SIDE };
+		appendQuad(quad, obstacle.center - half, obstacle.center + half, m_color);
+		std::copy(quad.begin(), quad.end(), m_vertices.begin() + static_cast<std::ptrdiff_t>(first));
+		upload(first, QUAD_VERTICES);
+	}
+
+	bool ObstacleRenderer::setObstacle(std::size_t index, const sim::Obstacle& obstacle) {
+		if (m_vertices.empty() || index > m_slots.size()) {
+			return false;
+		}
+		const auto loose = std::find_if(m_loose.begin(), m_loose.end(),
+			[index](const LooseCircle& circle) { return circle.index == index; });
+		if (loose != m_loose.end()) {
+			loose->obstacle = obstacle;
+			m_maxRadius = std::max(m_maxRadius, obstacle.radius);
+			return true;
+		}
+		if (index < m_slots.size()) {
+			// The fan's first vertex is the center the slot was written with
+			const std::uint32_t slot = m_slots[index];
+			const sf::Vector2f was = m_vertices[m_cellStart[0][0] + static_cast<std::size_t>(slot) * m_lodSegments[0] * 3U].position;
+			std::size_t wasCell = 0U;
+			std::size_t cell = 0U;
+			if (cellOf(was, wasCell) && cellOf(obstacle.center, cell) && cell == wasCell && obstacle.radius <= m_maxRadius) {
+				writeSlot(slot, obstacle);
+				return true;
+			}
+			if (m_loose.size() >= MAX_LOOSE) {
+				return false;
+			}
+			writeSlot(slot, { was, 0.0F }); // no area left where it was
+			m_slots[index] = NO_SLOT;
+		}
+		else if (m_loose.size() >= MAX_LOOSE) {
+			return false;
+		}
+		else {
+			m_slots.push_back(NO_SLOT);
+		}
+		m_loose.push_back({ index, obstacle });
+		m_maxRadius = std::max(m_maxRadius, obstacle.radius);
+		return true;
+	}
+
+	void ObstacleRenderer::drawRange(sf::RenderTarget& target, const sf::RenderStates& states,
+		std::size_t first, std::size_t count) const
+	{
+		m_drawnVertices += count;
+		if (m_useBuffer) {
+			target.draw(m_buffer, first, count, states);
+		}
+		else {
+			target.draw(m_vertices.data() + first, count, sf::PrimitiveType::Triangles, states);
+		}
+	}
+
+	ObstacleLod ObstacleRenderer::selectLod(float unitPixels) const noexcept {
+		if (m_cellSize * unitPixels < CLUSTER_CELL_PIXELS) {
+			return ObstacleLod::Cluster;
+		}
+		const float radius = m_maxRadius * unitPixels;
+		if (radius < IMPOSTOR_RADIUS_PIXELS) {
+			return ObstacleLod::Impostor;
+		}
+		std::size_t level = static_cast<std::size_t>(ObstacleLod::Full);
+		if (rimError(radius, m_lodSegments[2]) <= MAX_RIM_ERROR_PIXELS) {
+			level = static_cast<std::size_t>(ObstacleLod::Coarse);
+		}
+		else if (rimError(radius, m_lodSegments[1]) <= MAX_RIM_ERROR_PIXELS) {
+			level = static_cast<std::size_t>(ObstacleLod::Medium);
+		}
+		return static_cast<ObstacleLod>(std::min(level + m_lodBias, static_cast<std::size_t>(ObstacleLod::Impostor)));
+	}
+
+	void ObstacleRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		m_drawnVertices = 0U;
+		if (m_vertices.empty()) {
+			return;
+		}
+
+		// The largest pillar's size on screen decides the level for the whole frame
+		m_drawnLod = selectLod(pixelsPerUnit(target));
+		const std::vector<std::size_t>& cellStart = m_cellStart[static_cast<std::size_t>(m_drawnLod)];
+
+		// Visible world rectangle, in the obstacles' own space, grown by the largest radius
+		const sf::View& view = target.getView();
+		const sf::FloatRect viewRect = states.transform.getInverse().transformRect(
+			{ view.getCenter() - view.getSize() / 2.0F, view.getSize() });
+		const sf::Vector2f low = viewRect.position - sf::Vector2f{ m_maxRadius, m_maxRadius } - m_origin;
+		const sf::Vector2f high = viewRect.position + viewRect.size + sf::Vector2f{ m_maxRadius, m_maxRadius } - m_origin;
+		// Clamped in float first, so a view far outside the lot cannot overflow the conversion
+		const auto toCell = [this](float offset, int cells) {
+			return static_cast<int>(std::clamp(std::floor(offset / m_cellSize), -1.0F, static_cast<float>(cells)));
+		};
+		const int x0 = std::max(toCell(low.x, m_cols), 0);
+		const int y0 = std::max(toCell(low.y, m_rows), 0);
+		const int x1 = std::min(toCell(high.x, m_cols), m_cols - 1);
+		const int y1 = std::min(toCell(high.y, m_rows), m_rows - 1);
+
+		// Each row of visible cells is one contiguous vertex range; adjacent ranges merge
+		std::size_t first = 0U;
+		std::size_t end = 0U;
+		for (int y = y0; y <= y1 && x0 <= x1; ++y) {
+			const std::size_t row = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cols);
+			const std::size_t rowFirst = cellStart[row + static_cast<std::size_t>(x0)];
+			const std::size_t rowEnd = cellStart[row + static_cast<std::size_t>(x1) + 1U];
+			if (rowFirst != end) {
+				if (end > first) {
+					drawRange(target, states, first, end - first);
+				}
+				first = rowFirst;
+			}
+			end = rowEnd;
+		}
+		if (end > first) {
+			drawRange(target, states, first, end - first);
+		}
+
+		// Edited pillars outside their cells, at the frame's level (clusters as impostors)
+		if (!m_loose.empty()) {
+			m_looseVertices.clear();
+			for (const LooseCircle& circle : m_loose) {
+				if (m_drawnLod < ObstacleLod::Impostor) {
+					const std::size_t segments = m_lodSegments[static_cast<std::size_t>(m_drawnLod)];
+					m_looseVertices.resize(m_looseVertices.size() + segments * 3U);
+					writeFan(m_looseVertices.data() + m_looseVertices.size() - segments * 3U, circle.obstacle, segments, m_color);
+				}
+				else {
+					const float side = circle.obstacle.radius * IMPOSTOR_HALF_SIDE;
+					appendQuad(m_looseVertices, circle.obstacle.center - sf::Vector2f{ side, side },
+						circle.obstacle.center + sf::Vector2f{ side, side }, m_color);
+				}
+			}
+			m_drawnVertices += m_looseVertices.size();
+			target.draw(m_looseVertices.data(), m_looseVertices.size(), sf::PrimitiveType::Triangles, states);
+		}
+	}
+
+} // namespace gfx
@@ -0,0 +1,137 @@
+/*
+==============================================================================
+Obstacle Renderer - all static pillars in one vertex buffer, one draw call
+==============================================================================
+ - Circles are tessellated once into a triangle list
+ - Geometry lives in an sf::VertexBuffer (Usage::Static) and is re-uploaded
+   only when the obstacle set changes
+ - Falls back to a client-side vertex array (still one draw call) when
+   vertex buffers are not available
+ - Circles are stored grouped by coarse grid cell (CSR, like ObstacleGrid),
+   so draw() submits only the cells the target's view can see: one draw
+   call per visible row of cells, merged when rows are contiguous
+ - Level of detail: every circle is also tessellated coarser, as a single
+   impostor quad, and every cell as one cluster quad shaded by how much
+   of it the pillars cover; draw() picks the level from the on-screen
+   size of the largest pillar, so a whole-lot view stays bounded in vertices;
+   setLodBias() asks for coarser circles than that, down to impostors, when
+   the frame budget is short (QualityGovernor)
+ - Editing: setObstacle() rewrites a pillar that stays in its cull cell in
+   place (a few sub-range uploads); one that leaves its cell is collapsed
+   to nothing there and drawn from a short loose list after the cells,
+   tessellated at the frame's level. Cluster quads keep the shade they
+   were built with until the next setObstacles()
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+#include "SimTypes.hpp"
+
+namespace gfx {
+
+	// Obstacle detail levels, finest first
+	enum class ObstacleLod : std::uint8_t { Full, Medium, Coarse, Impostor, Cluster };
+
+	/**
+	 * @brief Screen pixels per world unit along x under the target's current view.
+	 */
+	[[nodiscard]] float pixelsPerUnit(const sf::RenderTarget& target);
+
+	/**
+	 * @brief Fewest rim points (at least 3, at most maxPoints) that keep a
+	 *        circle of radiusPixels within half a pixel of round.
+	 */
+	[[nodiscard]] std::size_t circlePointCount(float radiusPixels, std::size_t maxPoints);
+
+	class ObstacleRenderer : public sf::Drawable {
+	public:
+		explicit ObstacleRenderer(std::size_t segmentsPerCircle = 30U);
+
+		/**
+		 * @brief Re-tessellates and uploads the obstacle geometry.
+		 *
+		 * Call only when the obstacle set changes; requires an active GL context.
+		 */
+		void setObstacles(const std::vector<sim::Obstacle>& obstacles, sf::Color color = sf::Color::White);
+
+		/**
+		 * @brief Replaces obstacle index, or adds one if index is the obstacle count, without re-tessellating the rest.
+		 *
+		 * Returns false and changes nothing if there is no geometry yet or
+		 * MAX_LOOSE pillars have left their cells; the caller calls
+		 * setObstacles() then. Requires an active GL context.
+		 */
+		bool setObstacle(std::size_t index, const sim::Obstacle& obstacle);
+
+		[[nodiscard]] std::size_t vertexCount() const noexcept { return m_vertices.size(); }
+
+		/**
+		 * @brief Vertices submitted by the last draw() after view culling.
+		 */
+		[[nodiscard]] std::size_t drawnVertexCount() const noexcept { return m_drawnVertices; }
+
+		/**
+		 * @brief Detail level picked by the last draw().
+		 */
+		[[nodiscard]] ObstacleLod drawnLod() const noexcept { return m_drawnLod; }
+
+		/**
+		 * @brief Draws circles levels coarser than their on-screen size asks for; never turns them into clusters.
+		 */
+		void setLodBias(std::uint8_t levels) noexcept { m_lodBias = levels; }
+
+	private:
+		static constexpr std::size_t LOD_COUNT = 5U;
+		static constexpr std::size_t MAX_LOOSE = 256U;
+		static constexpr std::uint32_t NO_SLOT = 0xFFFFFFFFU;
+
+		// A pillar drawn outside the cells since it was edited
+		struct LooseCircle {
+			std::size_t index;
+			sim::Obstacle obstacle;
+		};
+
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+		void drawRange(sf::RenderTarget& target, const sf::RenderStates& states, std::size_t first, std::size_t count) const;
+		[[nodiscard]] ObstacleLod selectLod(float pixelsPerUnit) const noexcept;
+
+		// Cull cell of center; false outside the cells
+		[[nodiscard]] bool cellOf(const sf::Vector2f& center, std::size_t& cell) const noexcept;
+
+		// Rewrites the vertices of sorted slot at every polygon level and as an impostor, and uploads them
+		void writeSlot(std::uint32_t slot, const sim::Obstacle& obstacle);
+
+		std::size_t m_segments;
+		std::array<std::size_t, 3> m_lodSegments{}; // rim segments of Full, Medium and Coarse
+		std::vector<sf::Vertex> m_vertices; // every level back to back; staging copy, also used by the fallback path
+		sf::VertexBuffer m_buffer{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static };
+		prof::MemoryCharge m_heapCharge{ prof::MemorySubsystem::RenderBuffers, prof::MemoryKind::Heap };   // m_vertices
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::RenderBuffers, prof::MemoryKind::Video }; // m_buffer
+		bool m_useBuffer = false;
+
+		// Cull grid: at level l, vertices of cell i are [m_cellStart[l][i], m_cellStart[l][i + 1])
+		sf::Vector2f m_origin{ 0.0F, 0.0F };
+		float m_cellSize = 1.0F;
+		float m_maxRadius = 0.0F; // circles reach this far out of their cell
+		int m_cols = 0;
+		int m_rows = 0;
+		std::array<std::vector<std::size_t>, LOD_COUNT> m_cellStart;
+		std::vector<std::uint32_t> m_slots; // position of each obstacle in cell order; NO_SLOT once loose
+		std::vector<LooseCircle> m_loose;
+		mutable std::vector<sf::Vertex> m_looseVertices; // the loose circles at the last drawn level
+		sf::Color m_color = sf::Color::White;
+		mutable std::size_t m_drawnVertices = 0U;
+		mutable ObstacleLod m_drawnLod = ObstacleLod::Full;
+		std::uint8_t m_lodBias = 0U;
+	};
+
+} // namespace gfx
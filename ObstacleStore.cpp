@@ -0,0 +1,157 @@
+#include "ObstacleStore.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SimdIntrinsics.hpp"
+
+namespace sim {
+
+	namespace {
+		// Padding coordinate: far enough to never win, small enough that
+		// its square stays finite (1e18^2 = 1e36 < FLT_MAX)
+		constexpr float PAD_COORD = 1.0e18F;
+
+		constexpr float NO_NEAREST = std::numeric_limits<float>::max();
+
+		// Nearest squared distance over n padded coordinates; one kernel per SIMD level,
+		// all returning the same bits (a min of the same squares)
+#if defined(OKPP_SIMD_X86)
+		OKPP_TARGET_SSE2 float storeNearestSqSse2(const float* xs, const float* ys, std::size_t n, const sf::Vector2f& query) {
+			const __m128 qx = _mm_set1_ps(query.x);
+			const __m128 qy = _mm_set1_ps(query.y);
+			__m128 bestLo = _mm_set1_ps(NO_NEAREST);
+			__m128 bestHi = bestLo;
+
+			// Two 4-lane accumulators cover the 8-float stride
+			for (std::size_t i = 0U; i < n; i += ObstacleStore::LANES) {
+				const __m128 dx0 = _mm_sub_ps(_mm_loadu_ps(xs + i), qx);
+				const __m128 dy0 = _mm_sub_ps(_mm_loadu_ps(ys + i), qy);
+				const __m128 dx1 = _mm_sub_ps(_mm_loadu_ps(xs + i + 4U), qx);
+				const __m128 dy1 = _mm_sub_ps(_mm_loadu_ps(ys + i + 4U), qy);
+				bestLo = _mm_min_ps(bestLo, _mm_add_ps(_mm_mul_ps(dx0, dx0), _mm_mul_ps(dy0, dy0)));
+				bestHi = _mm_min_ps(bestHi, _mm_add_ps(_mm_mul_ps(dx1, dx1), _mm_mul_ps(dy1, dy1)));
+			}
+
+			__m128 m = _mm_min_ps(bestLo, bestHi);
+			m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+			m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 0x1));
+			return _mm_cvtss_f32(m);
+		}
+
+		OKPP_TARGET_AVX2 float storeNearestSqAvx2(const float* xs, const float* ys, std::size_t n, const sf::Vector2f& query) {
+			const __m256 qx = _mm256_set1_ps(query.x);
+			const __m256 qy = _mm256_set1_ps(query.y);
+			__m256 best = _mm256_set1_ps(NO_NEAREST);
+
+			for (std::size_t i = 0U; i < n; i += ObstacleStore::LANES) {
+				const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), qx);
+				const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), qy);
+				best = _mm256_min_ps(best, _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+			}
+
+			__m128 m = _mm_min_ps(_mm256_castps256_ps128(best), _mm256_extractf128_ps(best, 1));
+			m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+			m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 0x1));
+			return _mm_cvtss_f32(m);
+		}
+
+		OKPP_TARGET_AVX512 float storeNearestSqAvx512(const float* xs, const float* ys, std::size_t n, const sf::Vector2f& query) {
+			const __m512 qx = _mm512_set1_ps(query.x);
+			const __m512 qy = _mm512_set1_ps(query.y);
+			__m512 best = _mm512_set1_ps(NO_NEAREST);
+
+			// Two strides per step; an odd last stride goes through the low half only
+			std::size_t i = 0U;
+			for (; i + 2U * ObstacleStore::LANES <= n; i += 2U * ObstacleStore::LANES) {
+				const __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(xs + i), qx);
+				const __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(ys + i), qy);
+				best = _mm512_min_ps(best, _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)));
+			}
+			if (i < n) {
+				constexpr __mmask16 LOW_STRIDE = 0x00FFU;
+				const __m512 dx = _mm512_sub_ps(_mm512_maskz_loadu_ps(LOW_STRIDE, xs + i), qx);
+				const __m512 dy = _mm512_sub_ps(_mm512_maskz_loadu_ps(LOW_STRIDE, ys + i), qy);
+				best = _mm512_mask_min_ps(best, LOW_STRIDE, best, _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)));
+			}
+			return _mm512_reduce_min_ps(best);
+		}
+#elif defined(OKPP_SIMD_NEON)
+		float storeNearestSqNeon(const float* xs, const float* ys, std::size_t n, const sf::Vector2f& query) {
+			const float32x4_t qx = vdupq_n_f32(query.x);
+			const float32x4_t qy = vdupq_n_f32(query.y);
+			float32x4_t bestLo = vdupq_n_f32(NO_NEAREST);
+			float32x4_t bestHi = bestLo;
+
+			for (std::size_t i = 0U; i < n; i += ObstacleStore::LANES) {
+				const float32x4_t dx0 = vsubq_f32(vld1q_f32(xs + i), qx);
+				const float32x4_t dy0 = vsubq_f32(vld1q_f32(ys + i), qy);
+				const float32x4_t dx1 = vsubq_f32(vld1q_f32(xs + i + 4U), qx);
+				const float32x4_t dy1 = vsubq_f32(vld1q_f32(ys + i + 4U), qy);
+				bestLo = vminq_f32(bestLo, vmlaq_f32(vmulq_f32(dy0, dy0), dx0, dx0));
+				bestHi = vminq_f32(bestHi, vmlaq_f32(vmulq_f32(dy1, dy1), dx1, dx1));
+			}
+
+			const float32x4_t m = vminq_f32(bestLo, bestHi);
+			const float32x2_t h = vpmin_f32(vget_low_f32(m), vget_high_f32(m));
+			return vget_lane_f32(vpmin_f32(h, h), 0);
+		}
+#endif
+	}
+
+	void ObstacleStore::assign(const std::vector<sf::Vector2f>& points) {
+		m_count = points.size();
+		const std::size_t padded = ((m_count + LANES - 1U) / LANES) * LANES;
+
+		m_x.assign(padded, PAD_COORD);
+		m_y.assign(padded, PAD_COORD);
+		for (std::size_t i = 0U; i < m_count; ++i) {
+			m_x[i] = points[i].x;
+			m_y[i] = points[i].y;
+		}
+	}
+
+	float nearestDistanceSqScalar(const ObstacleStore& store, const sf::Vector2f& query) {
+		float bestSq = NO_NEAREST;
+		const float* xs = store.xs();
+		const float* ys = store.ys();
+
+		for (std::size_t i = 0U; i < store.size(); ++i) {
+			const float dx = xs[i] - query.x;
+			const float dy = ys[i] - query.y;
+			bestSq = std::min(bestSq, dx * dx + dy * dy);
+		}
+		return bestSq;
+	}
+
+	float nearestDistanceSqSimd(const ObstacleStore& store, const sf::Vector2f& query) {
+		if (store.empty()) {
+			return NO_NEAREST;
+		}
+
+		const float* xs = store.xs();
+		const float* ys = store.ys();
+		const std::size_t n = store.paddedSize();
+		switch (simdLevel()) {
+#if defined(OKPP_SIMD_X86)
+		case SimdLevel::Avx512: return storeNearestSqAvx512(xs, ys, n, query);
+		case SimdLevel::Avx2: return storeNearestSqAvx2(xs, ys, n, query);
+		case SimdLevel::Sse2: return storeNearestSqSse2(xs, ys, n, query);
+#elif defined(OKPP_SIMD_NEON)
+		case SimdLevel::Neon: return storeNearestSqNeon(xs, ys, n, query);
+#endif
+		default: return nearestDistanceSqScalar(store, query);
+		}
+	}
+
+	float nearestDistance(const ObstacleStore& store, const sf::Vector2f& query) {
+		const float bestSq = nearestDistanceSqSimd(store, query);
+		return (bestSq < NO_NEAREST) ? std::sqrt(bestSq) : NO_NEAREST;
+	}
+
+	const char* simdKernelName() noexcept {
+		return simdLevelName(simdLevel());
+	}
+
+} // namespace sim
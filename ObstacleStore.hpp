@@ -0,0 +1,74 @@
+/*
+==============================================================================
+Obstacle Store - structure-of-arrays obstacle positions with SIMD queries
+==============================================================================
+ - X and Y coordinates live in separate float arrays, padded to LANES
+ - Nearest-distance kernels work on squared distances, 8 lanes at a time,
+   and take a single sqrt after the final min reduction
+ - Kernel is picked per call from simdLevel() (CpuFeatures): AVX-512, AVX2
+   or SSE2 on x86, NEON on ARM, scalar otherwise
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+
+namespace sim {
+
+	class ObstacleStore {
+	public:
+		// Arrays are padded to a multiple of this many floats
+		static constexpr std::size_t LANES = 8U;
+
+		/**
+		 * @brief Replaces the stored obstacles.
+		 *
+		 * Padding lanes hold a far-away sentinel so kernels never need a tail loop.
+		 */
+		void assign(const std::vector<sf::Vector2f>& points);
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_count; }
+		[[nodiscard]] std::size_t paddedSize() const noexcept { return m_x.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_count == 0U; }
+
+		[[nodiscard]] const float* xs() const noexcept { return m_x.data(); }
+		[[nodiscard]] const float* ys() const noexcept { return m_y.data(); }
+
+	private:
+		// Counted against the obstacle subsystem's heap
+		prof::TrackedVector<float, prof::MemorySubsystem::Obstacles> m_x;
+		prof::TrackedVector<float, prof::MemorySubsystem::Obstacles> m_y;
+		std::size_t m_count = 0U;
+	};
+
+	/**
+	 * @brief Reference kernel: one squared distance per obstacle, no SIMD.
+	 *
+	 * Returns std::numeric_limits<float>::max() for an empty store.
+	 */
+	[[nodiscard]] float nearestDistanceSqScalar(const ObstacleStore& store, const sf::Vector2f& query);
+
+	/**
+	 * @brief Vectorized kernel: squared distances 8 lanes at a time, min-reduced.
+	 *
+	 * Returns std::numeric_limits<float>::max() for an empty store.
+	 */
+	[[nodiscard]] float nearestDistanceSqSimd(const ObstacleStore& store, const sf::Vector2f& query);
+
+	/**
+	 * @brief Nearest obstacle distance through the SIMD kernel (single sqrt).
+	 */
+	[[nodiscard]] float nearestDistance(const ObstacleStore& store, const sf::Vector2f& query);
+
+	/**
+	 * @brief Name of the kernel nearestDistanceSqSimd runs at the moment.
+	 */
+	[[nodiscard]] const char* simdKernelName() noexcept;
+
+} // namespace sim
@@ -0,0 +1,147 @@
+#include "OccupancyHeatmap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "GlFunctions.hpp"
+
+namespace gfx {
+
+	namespace {
+		// Passes the footprint weight (seconds) from texCoords.x to every covered texel
+		constexpr const char* SPLAT_VERTEX_SHADER = R"(
+#version 120
+varying float v_seconds;
+void main() {
+	v_seconds = gl_MultiTexCoord0.x;
+	gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+}
+)";
+
+		constexpr const char* SPLAT_FRAGMENT_SHADER = R"(
+#version 120
+varying float v_seconds;
+void main() {
+	gl_FragColor = vec4(v_seconds);
+}
+)";
+
+		// Seconds / full scale through a blue-cyan-green-yellow-red ramp; alpha fades in over the first few percent
+		constexpr const char* RAMP_FRAGMENT_SHADER = R"(
+#version 120
+uniform sampler2D u_heat;
+uniform float u_invFullScale;
+void main() {
+	float seconds = texture2D(u_heat, gl_TexCoord[0].xy).r;
+	if (seconds <= 0.0) {
+		discard;
+	}
+	float t = clamp(seconds * u_invFullScale, 0.0, 1.0);
+	vec3 color = clamp(vec3(1.5) - abs(vec3(4.0 * t) - vec3(3.0, 2.0, 1.0)), 0.0, 1.0);
+	gl_FragColor = vec4(color, 0.6 * smoothstep(0.0, 0.05, t) + 0.1);
+}
+)";
+
+		// dst += src, with no alpha weighting: the splat colour is the weight itself
+		const sf::BlendMode ACCUMULATE_BLEND(sf::BlendMode::Factor::One, sf::BlendMode::Factor::One);
+	}
+
+	bool OccupancyHeatmap::create(const sf::FloatRect& worldBounds, float texelSize, float fullScaleSeconds) {
+		m_accumulation.reset();
+		m_pending.clear();
+		if (!sf::Shader::isAvailable()) {
+			std::cerr << "Error: shaders are unavailable, the occupancy heatmap is off\n";
+			return false;
+		}
+		if (!m_splatShader.loadFromMemory(SPLAT_VERTEX_SHADER, SPLAT_FRAGMENT_SHADER)
+			|| !m_rampShader.loadFromMemory(RAMP_FRAGMENT_SHADER, sf::Shader::Type::Fragment)) {
+			return false; // SFML has logged the compiler output
+		}
+
+		const float maxTexels = static_cast<float>(std::min(sf::Texture::getMaximumSize(), 4096U));
+		const float texel = std::max({ texelSize, worldBounds.size.x / maxTexels, worldBounds.size.y / maxTexels });
+		const sf::Vector2u size{ std::max(1U, static_cast<unsigned>(std::ceil(worldBounds.size.x / texel))),
+			std::max(1U, static_cast<unsigned>(std::ceil(worldBounds.size.y / texel))) };
+
+		sf::RenderTexture texture;
+		if (!texture.resize(size) || !texture.setActive(true)) {
+			std::cerr << "Error: Failed to create a " << size.x << 'x' << size.y << " occupancy heatmap\n";
+			return false;
+		}
+
+		// SFML only allocates 8-bit targets, which cannot sum frame-sized weights;
+		// the texture the framebuffer renders into is re-allocated as half float
+		while (glGetError() != GL_NO_ERROR) {
+		}
+		sf::Texture::bind(&texture.getTexture());
+		glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(gl::RGBA16F), static_cast<GLsizei>(size.x),
+			static_cast<GLsizei>(size.y), 0, GL_RGBA, GL_FLOAT, nullptr);
+		const GLenum error = glGetError();
+		sf::Texture::bind(nullptr);
+		if (error != GL_NO_ERROR) {
+			std::cerr << "Error: half-float render targets are unavailable, the occupancy heatmap is off\n";
+			return false;
+		}
+
+		texture.setSmooth(true);
+		texture.setView(sf::View(worldBounds));
+		texture.clear(sf::Color::Transparent);
+		texture.display();
+		(void)texture.setActive(false);
+
+		m_accumulation.emplace(std::move(texture));
+		m_videoCharge.set(prof::rgbaTextureBytes(size.x, size.y) * 2U); // RGBA16F
+		m_bounds = worldBounds;
+		m_rampShader.setUniform("u_heat", sf::Shader::CurrentTexture);
+		m_rampShader.setUniform("u_invFullScale", 1.0F / std::max(fullScaleSeconds, 1.0e-3F));
+		return true;
+	}
+
+	void OccupancyHeatmap::splat(const sf::Transform& carTransform, const sf::Vector2f& halfExtent, float seconds) {
+		if (!m_accumulation || !(seconds > 0.0F)) {
+			return;
+		}
+		const sf::Vector2f corners[4] = {
+			carTransform.transformPoint({ -halfExtent.x, -halfExtent.y }),
+			carTransform.transformPoint({ halfExtent.x, -halfExtent.y }),
+			carTransform.transformPoint({ halfExtent.x, halfExtent.y }),
+			carTransform.transformPoint({ -halfExtent.x, halfExtent.y })
+		};
+		for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+			m_pending.append(sf::Vertex{ corners[corner], sf::Color::White, { seconds, 0.0F } });
+		}
+	}
+
+	void OccupancyHeatmap::flush() {
+		if (!m_accumulation || m_pending.getVertexCount() == 0U) {
+			return;
+		}
+		sf::RenderStates states(ACCUMULATE_BLEND);
+		states.shader = &m_splatShader;
+		m_accumulation->draw(m_pending, states);
+		m_accumulation->display();
+		m_pending.clear();
+	}
+
+	void OccupancyHeatmap::clear() {
+		m_pending.clear();
+		if (m_accumulation) {
+			m_accumulation->clear(sf::Color::Transparent);
+			m_accumulation->display();
+		}
+	}
+
+	void OccupancyHeatmap::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		if (!m_accumulation) {
+			return;
+		}
+		sf::Sprite sprite(m_accumulation->getTexture());
+		sprite.setPosition(m_bounds.position);
+		sprite.setScale({ m_bounds.size.x / static_cast<float>(m_accumulation->getSize().x),
+			m_bounds.size.y / static_cast<float>(m_accumulation->getSize().y) });
+		states.shader = &m_rampShader;
+		target.draw(sprite, states);
+	}
+
+} // namespace gfx
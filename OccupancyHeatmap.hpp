@@ -0,0 +1,64 @@
+/*
+==============================================================================
+Occupancy Heatmap - how long each part of the lot has held a car
+==============================================================================
+ - Car footprints are splatted as quads into a half-float render texture
+   with additive blending; each quad adds the seconds it stood there, so
+   the texture holds occupied time per texel with no CPU per-pixel work
+ - Splats are queued as geometry and accumulated by one draw in flush()
+ - Drawing maps the accumulated seconds through a colour ramp in a
+   fragment shader (blue = briefly, red = fullScaleSeconds or longer);
+   texels never covered stay transparent
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <optional>
+
+#include "MemoryAccounting.hpp"
+
+namespace gfx {
+
+	class OccupancyHeatmap : public sf::Drawable {
+	public:
+		/**
+		 * @brief Creates the accumulation texture over worldBounds, one texel per
+		 *        texelSize pixels (coarser if that exceeds the GPU texture limit).
+		 *
+		 * Requires an active GL context with shaders and half-float render
+		 * targets. Returns false (and logs) otherwise; the heatmap stays off.
+		 */
+		[[nodiscard]] bool create(const sf::FloatRect& worldBounds, float texelSize, float fullScaleSeconds);
+
+		[[nodiscard]] bool ready() const noexcept { return m_accumulation.has_value(); }
+
+		/**
+		 * @brief Queues one car footprint (the car-frame rectangle of halfExtent) held for seconds.
+		 */
+		void splat(const sf::Transform& carTransform, const sf::Vector2f& halfExtent, float seconds);
+
+		/**
+		 * @brief Adds every queued footprint to the texture in a single draw.
+		 */
+		void flush();
+
+		/**
+		 * @brief Forgets the accumulated time and any queued footprints.
+		 */
+		void clear();
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		std::optional<sf::RenderTexture> m_accumulation;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Video };
+		sf::Shader m_splatShader;
+		sf::Shader m_rampShader;
+		sf::VertexArray m_pending{ sf::PrimitiveType::Triangles }; // weight in texCoords.x
+		sf::FloatRect m_bounds;
+	};
+
+} // namespace gfx
@@ -0,0 +1,360 @@
+#include "OccupancyMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "FastTrig.hpp"
+#include "ObstacleGrid.hpp"
+#include "RayCast.hpp"
+#include "Sensors.hpp"
+#include "SimTypes.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIM_KERNEL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIM_KERNEL_NEON 1
+#endif
+
+namespace sim {
+
+	namespace {
+		// Sensor rectangles face along their long (local Y) axis, as in RayCast.cpp
+		constexpr float MAP_FACING_OFFSET_DEG = 90.0F;
+
+		// Samples per cell along a ray: two keeps diagonal rays from skipping cells
+		constexpr float MAP_SAMPLES_PER_CELL = 2.0F;
+
+		// Rays are marched in blocks of this many samples (one vector of cell indices)
+		constexpr std::size_t MAP_SAMPLE_BLOCK = 4U;
+
+		// Per-cell marks of the current tick; a hit outranks a pass-through
+		constexpr std::uint8_t MAP_MARK_NONE = 0U;
+		constexpr std::uint8_t MAP_MARK_FREE = 1U;
+		constexpr std::uint8_t MAP_MARK_HIT = 2U;
+
+		constexpr float MAP_NO_DISTANCE = std::numeric_limits<float>::max();
+
+		[[nodiscard]] int floorDivTile(int cell) noexcept {
+			return (cell >= 0) ? cell / OccupancyMap::TILE_CELLS
+				: -((-cell + OccupancyMap::TILE_CELLS - 1) / OccupancyMap::TILE_CELLS);
+		}
+
+		[[nodiscard]] int floorMod(int value, int divisor) noexcept {
+			const int mod = value % divisor;
+			return (mod < 0) ? mod + divisor : mod;
+		}
+
+		// Cell indices of MAP_SAMPLE_BLOCK consecutive samples origin + direction * (t0 + k * step)
+		void sampleCells(float originX, float originY, float dirX, float dirY, float t0, float step,
+			float invCellSize, int* cellX, int* cellY) noexcept
+		{
+#if defined(SIM_KERNEL_SSE2)
+			const __m128 t = _mm_add_ps(_mm_set1_ps(t0), _mm_mul_ps(_mm_set_ps(3.0F, 2.0F, 1.0F, 0.0F), _mm_set1_ps(step)));
+			const __m128 inv = _mm_set1_ps(invCellSize);
+			const __m128 x = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(originX), _mm_mul_ps(_mm_set1_ps(dirX), t)), inv);
+			const __m128 y = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(originY), _mm_mul_ps(_mm_set1_ps(dirY), t)), inv);
+
+			// SSE2 only truncates: step down by one where truncation rounded a negative up
+			const auto floorLanes = [](__m128 v) {
+				const __m128i truncated = _mm_cvttps_epi32(v);
+				const __m128 roundedUp = _mm_cmplt_ps(v, _mm_cvtepi32_ps(truncated));
+				return _mm_add_epi32(truncated, _mm_castps_si128(roundedUp)); // mask lanes are -1
+			};
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(cellX), floorLanes(x));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(cellY), floorLanes(y));
+#elif defined(SIM_KERNEL_NEON)
+			const float lanes[MAP_SAMPLE_BLOCK] = { 0.0F, 1.0F, 2.0F, 3.0F };
+			const float32x4_t t = vmlaq_f32(vdupq_n_f32(t0), vld1q_f32(lanes), vdupq_n_f32(step));
+			const float32x4_t inv = vdupq_n_f32(invCellSize);
+			const float32x4_t x = vmulq_f32(vmlaq_f32(vdupq_n_f32(originX), vdupq_n_f32(dirX), t), inv);
+			const float32x4_t y = vmulq_f32(vmlaq_f32(vdupq_n_f32(originY), vdupq_n_f32(dirY), t), inv);
+			vst1q_s32(cellX, vcvtmq_s32_f32(x));
+			vst1q_s32(cellY, vcvtmq_s32_f32(y));
+#else
+			for (std::size_t k = 0U; k < MAP_SAMPLE_BLOCK; ++k) {
+				const float t = t0 + static_cast<float>(k) * step;
+				cellX[k] = static_cast<int>(std::floor((originX + dirX * t) * invCellSize));
+				cellY[k] = static_cast<int>(std::floor((originY + dirY * t) * invCellSize));
+			}
+#endif
+		}
+
+		// Folds one tile's marks into its log-odds and clears them; returns the occupied cell count
+		[[nodiscard]] std::uint16_t updateTile(float* logOdds, std::uint8_t* marks) noexcept {
+			static_assert(OccupancyMap::CELLS_PER_TILE % 8U == 0U, "tile cells must fill whole vectors");
+			std::size_t i = 0U;
+			std::uint32_t occupied = 0U;
+
+#if defined(SIM_KERNEL_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128 freeMark = _mm_set1_ps(static_cast<float>(MAP_MARK_FREE));
+			const __m128 hitMark = _mm_set1_ps(static_cast<float>(MAP_MARK_HIT));
+			const __m128 freeDelta = _mm_set1_ps(OccupancyMap::LOG_ODDS_FREE);
+			const __m128 hitDelta = _mm_set1_ps(OccupancyMap::LOG_ODDS_HIT);
+			const __m128 lower = _mm_set1_ps(OccupancyMap::LOG_ODDS_MIN);
+			const __m128 upper = _mm_set1_ps(OccupancyMap::LOG_ODDS_MAX);
+			const __m128 threshold = _mm_set1_ps(OccupancyMap::LOG_ODDS_OCCUPIED);
+
+			for (; i + 4U <= OccupancyMap::CELLS_PER_TILE; i += 4U) {
+				std::int32_t packed = 0;
+				std::memcpy(&packed, marks + i, sizeof(packed));
+				const __m128i widened = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+				const __m128 mark = _mm_cvtepi32_ps(widened);
+
+				const __m128 delta = _mm_or_ps(_mm_and_ps(_mm_cmpeq_ps(mark, freeMark), freeDelta),
+					_mm_and_ps(_mm_cmpeq_ps(mark, hitMark), hitDelta));
+				const __m128 updated = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_loadu_ps(logOdds + i), delta), lower), upper);
+				_mm_storeu_ps(logOdds + i, updated);
+
+				const int mask = _mm_movemask_ps(_mm_cmpgt_ps(updated, threshold));
+				occupied += static_cast<std::uint32_t>((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1));
+			}
+#elif defined(SIM_KERNEL_NEON)
+			const float32x4_t freeDelta = vdupq_n_f32(OccupancyMap::LOG_ODDS_FREE);
+			const float32x4_t hitDelta = vdupq_n_f32(OccupancyMap::LOG_ODDS_HIT);
+			const float32x4_t lower = vdupq_n_f32(OccupancyMap::LOG_ODDS_MIN);
+			const float32x4_t upper = vdupq_n_f32(OccupancyMap::LOG_ODDS_MAX);
+			const float32x4_t threshold = vdupq_n_f32(OccupancyMap::LOG_ODDS_OCCUPIED);
+			uint32x4_t counts = vdupq_n_u32(0U);
+
+			for (; i + 8U <= OccupancyMap::CELLS_PER_TILE; i += 8U) {
+				const uint16x8_t widened = vmovl_u8(vld1_u8(marks + i));
+				const uint32x4_t halves[2] = { vmovl_u16(vget_low_u16(widened)), vmovl_u16(vget_high_u16(widened)) };
+				for (std::size_t h = 0U; h < 2U; ++h) {
+					const float32x4_t delta = vreinterpretq_f32_u32(vorrq_u32(
+						vandq_u32(vceqq_u32(halves[h], vdupq_n_u32(MAP_MARK_FREE)), vreinterpretq_u32_f32(freeDelta)),
+						vandq_u32(vceqq_u32(halves[h], vdupq_n_u32(MAP_MARK_HIT)), vreinterpretq_u32_f32(hitDelta))));
+					float* cells = logOdds + i + h * 4U;
+					const float32x4_t updated = vminq_f32(vmaxq_f32(vaddq_f32(vld1q_f32(cells), delta), lower), upper);
+					vst1q_f32(cells, updated);
+					counts = vaddq_u32(counts, vshrq_n_u32(vcgtq_f32(updated, threshold), 31));
+				}
+			}
+			occupied = vgetq_lane_u32(counts, 0) + vgetq_lane_u32(counts, 1) + vgetq_lane_u32(counts, 2) + vgetq_lane_u32(counts, 3);
+#else
+			// A tile is a whole number of vectors, so only the scalar build needs this loop
+			for (; i < OccupancyMap::CELLS_PER_TILE; ++i) {
+				const float delta = (marks[i] == MAP_MARK_HIT) ? OccupancyMap::LOG_ODDS_HIT
+					: ((marks[i] == MAP_MARK_FREE) ? OccupancyMap::LOG_ODDS_FREE : 0.0F);
+				logOdds[i] = std::min(std::max(logOdds[i] + delta, OccupancyMap::LOG_ODDS_MIN), OccupancyMap::LOG_ODDS_MAX);
+				occupied += (logOdds[i] > OccupancyMap::LOG_ODDS_OCCUPIED) ? 1U : 0U;
+			}
+#endif
+
+			std::memset(marks, 0, OccupancyMap::CELLS_PER_TILE);
+			return static_cast<std::uint16_t>(occupied);
+		}
+	}
+
+	OccupancyMap::OccupancyMap(float cellSize, int tilesPerSide)
+		: m_cellSize((cellSize > 0.0F) ? cellSize : 1.0F)
+		, m_invCellSize(1.0F / m_cellSize)
+		, m_tilesPerSide(std::max(tilesPerSide, 1))
+	{
+		const std::size_t slots = static_cast<std::size_t>(m_tilesPerSide) * static_cast<std::size_t>(m_tilesPerSide);
+		m_tileKeys.assign(slots, { NO_TILE, NO_TILE });
+		m_logOdds.assign(slots * CELLS_PER_TILE, 0.0F);
+		m_marks.assign(slots * CELLS_PER_TILE, MAP_MARK_NONE);
+		m_occupiedCells.assign(slots, 0U);
+		m_touchedFlag.assign(slots, 0U);
+		m_touched.reserve(slots);
+	}
+
+	void OccupancyMap::recenter(const sf::Vector2f& position) noexcept {
+		const float tileSize = m_cellSize * static_cast<float>(TILE_CELLS);
+		const int half = m_tilesPerSide / 2;
+		m_firstTile = {
+			static_cast<int>(std::floor(position.x / tileSize)) - half,
+			static_cast<int>(std::floor(position.y / tileSize)) - half
+		};
+	}
+
+	bool OccupancyMap::inWindow(int tileX, int tileY) const noexcept {
+		const int dx = tileX - m_firstTile.x;
+		const int dy = tileY - m_firstTile.y;
+		return dx >= 0 && dx < m_tilesPerSide && dy >= 0 && dy < m_tilesPerSide;
+	}
+
+	std::size_t OccupancyMap::slotOf(int tileX, int tileY) const noexcept {
+		return static_cast<std::size_t>(floorMod(tileY, m_tilesPerSide)) * static_cast<std::size_t>(m_tilesPerSide)
+			+ static_cast<std::size_t>(floorMod(tileX, m_tilesPerSide));
+	}
+
+	void OccupancyMap::mark(int cellX, int cellY, std::uint8_t value) {
+		const int tileX = floorDivTile(cellX);
+		const int tileY = floorDivTile(cellY);
+		if (!inWindow(tileX, tileY)) {
+			return;
+		}
+
+		const std::size_t slot = slotOf(tileX, tileY);
+		if (m_tileKeys[slot].x != tileX || m_tileKeys[slot].y != tileY) {
+			// The slot still holds a tile that scrolled out: start the new one unknown
+			m_tileKeys[slot] = { tileX, tileY };
+			std::fill_n(m_logOdds.begin() + static_cast<std::ptrdiff_t>(slot * CELLS_PER_TILE), CELLS_PER_TILE, 0.0F);
+			std::fill_n(m_marks.begin() + static_cast<std::ptrdiff_t>(slot * CELLS_PER_TILE), CELLS_PER_TILE, MAP_MARK_NONE);
+			m_occupiedCells[slot] = 0U;
+		}
+		if (m_touchedFlag[slot] == 0U) {
+			m_touchedFlag[slot] = 1U;
+			m_touched.push_back(static_cast<std::uint32_t>(slot));
+		}
+
+		// Cells inside a tile are row-major; the low bits of a cell index are its tile-local offset
+		const std::size_t local = static_cast<std::size_t>((cellY & (TILE_CELLS - 1)) * TILE_CELLS + (cellX & (TILE_CELLS - 1)));
+		std::uint8_t& cellMark = m_marks[slot * CELLS_PER_TILE + local];
+		cellMark = std::max(cellMark, value);
+	}
+
+	void OccupancyMap::addRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float distance, float maxRange) {
+		const bool hit = distance < maxRange;
+		const float freeLength = std::min(distance, maxRange);
+		const float step = m_cellSize / MAP_SAMPLES_PER_CELL;
+
+		int cellX[MAP_SAMPLE_BLOCK];
+		int cellY[MAP_SAMPLE_BLOCK];
+		int lastX = std::numeric_limits<int>::min();
+		int lastY = std::numeric_limits<int>::min();
+		const std::size_t samples = static_cast<std::size_t>(freeLength / step);
+
+		// Free cells up to (not including) the one the ray stops in
+		for (std::size_t first = 0U; first < samples; first += MAP_SAMPLE_BLOCK) {
+			sampleCells(origin.x, origin.y, direction.x, direction.y, static_cast<float>(first) * step, step,
+				m_invCellSize, cellX, cellY);
+			const std::size_t count = std::min(MAP_SAMPLE_BLOCK, samples - first);
+			for (std::size_t k = 0U; k < count; ++k) {
+				if (cellX[k] != lastX || cellY[k] != lastY) {
+					mark(cellX[k], cellY[k], MAP_MARK_FREE);
+					lastX = cellX[k];
+					lastY = cellY[k];
+				}
+			}
+		}
+
+		if (hit) {
+			const sf::Vector2f end = origin + direction * distance;
+			mark(static_cast<int>(std::floor(end.x * m_invCellSize)), static_cast<int>(std::floor(end.y * m_invCellSize)), MAP_MARK_HIT);
+		}
+	}
+
+	void OccupancyMap::commit() {
+		for (const std::uint32_t slot : m_touched) {
+			m_occupiedCells[slot] = updateTile(m_logOdds.data() + slot * CELLS_PER_TILE, m_marks.data() + slot * CELLS_PER_TILE);
+			m_touchedFlag[slot] = 0U;
+		}
+		m_touched.clear();
+	}
+
+	void OccupancyMap::clear() {
+		std::fill(m_tileKeys.begin(), m_tileKeys.end(), sf::Vector2i{ NO_TILE, NO_TILE });
+		std::fill(m_logOdds.begin(), m_logOdds.end(), 0.0F);
+		std::fill(m_marks.begin(), m_marks.end(), MAP_MARK_NONE);
+		std::fill(m_occupiedCells.begin(), m_occupiedCells.end(), std::uint16_t{ 0U });
+		std::fill(m_touchedFlag.begin(), m_touchedFlag.end(), std::uint8_t{ 0U });
+		m_touched.clear();
+	}
+
+	float OccupancyMap::logOdds(const sf::Vector2f& point) const noexcept {
+		const int cellX = static_cast<int>(std::floor(point.x * m_invCellSize));
+		const int cellY = static_cast<int>(std::floor(point.y * m_invCellSize));
+		const int tileX = floorDivTile(cellX);
+		const int tileY = floorDivTile(cellY);
+		if (!inWindow(tileX, tileY)) {
+			return 0.0F;
+		}
+
+		const std::size_t slot = slotOf(tileX, tileY);
+		if (m_tileKeys[slot].x != tileX || m_tileKeys[slot].y != tileY) {
+			return 0.0F;
+		}
+		const std::size_t local = static_cast<std::size_t>((cellY & (TILE_CELLS - 1)) * TILE_CELLS + (cellX & (TILE_CELLS - 1)));
+		return m_logOdds[slot * CELLS_PER_TILE + local];
+	}
+
+	float OccupancyMap::nearestOccupiedSq(const sf::Vector2f& point, float maxRange) const {
+		const float tileSize = m_cellSize * static_cast<float>(TILE_CELLS);
+		const int minTileX = std::max(static_cast<int>(std::floor((point.x - maxRange) / tileSize)), m_firstTile.x);
+		const int minTileY = std::max(static_cast<int>(std::floor((point.y - maxRange) / tileSize)), m_firstTile.y);
+		const int maxTileX = std::min(static_cast<int>(std::floor((point.x + maxRange) / tileSize)), m_firstTile.x + m_tilesPerSide - 1);
+		const int maxTileY = std::min(static_cast<int>(std::floor((point.y + maxRange) / tileSize)), m_firstTile.y + m_tilesPerSide - 1);
+
+		float bestSq = maxRange * maxRange;
+		bool found = false;
+		for (int tileY = minTileY; tileY <= maxTileY; ++tileY) {
+			for (int tileX = minTileX; tileX <= maxTileX; ++tileX) {
+				const std::size_t slot = slotOf(tileX, tileY);
+				if (m_occupiedCells[slot] == 0U || m_tileKeys[slot].x != tileX || m_tileKeys[slot].y != tileY) {
+					continue;
+				}
+
+				const float* cells = m_logOdds.data() + slot * CELLS_PER_TILE;
+				const float originX = static_cast<float>(tileX) * tileSize + 0.5F * m_cellSize - point.x;
+				const float originY = static_cast<float>(tileY) * tileSize + 0.5F * m_cellSize - point.y;
+				for (int row = 0; row < TILE_CELLS; ++row) {
+					const float dy = originY + static_cast<float>(row) * m_cellSize;
+					for (int col = 0; col < TILE_CELLS; ++col) {
+						if (cells[row * TILE_CELLS + col] <= LOG_ODDS_OCCUPIED) {
+							continue;
+						}
+						const float dx = originX + static_cast<float>(col) * m_cellSize;
+						const float distanceSq = dx * dx + dy * dy;
+						if (distanceSq <= bestSq) {
+							bestSq = distanceSq;
+							found = true;
+						}
+					}
+				}
+			}
+		}
+		return found ? bestSq : MAP_NO_DISTANCE;
+	}
+
+	sf::FloatRect OccupancyMap::bounds() const noexcept {
+		const float tileSize = m_cellSize * static_cast<float>(TILE_CELLS);
+		const float extent = tileSize * static_cast<float>(m_tilesPerSide);
+		return { { static_cast<float>(m_firstTile.x) * tileSize, static_cast<float>(m_firstTile.y) * tileSize }, { extent, extent } };
+	}
+
+	void mapSensors(const std::vector<SensorPose>& sensors, const RayCaster& caster, const RayCone& cone,
+		OccupancyMap& map, std::vector<float>* echoesSq)
+	{
+		const std::uint32_t rays = std::max<std::uint32_t>(cone.rayCount, 1U);
+		const float stepDeg = (rays > 1U) ? (2.0F * cone.halfAngleDeg) / static_cast<float>(rays - 1U) : 0.0F;
+
+		if (echoesSq != nullptr) {
+			echoesSq->assign(sensors.size(), std::numeric_limits<float>::max());
+		}
+		for (std::size_t s = 0U; s < sensors.size(); ++s) {
+			const SensorPose& sensor = sensors[s];
+			const float facingDeg = sensor.rotationDeg + MAP_FACING_OFFSET_DEG;
+			const float firstDeg = (rays > 1U) ? facingDeg - cone.halfAngleDeg : facingDeg;
+			float nearest = cone.maxDistance;
+			for (std::uint32_t i = 0U; i < rays; ++i) {
+				const SinCos angle = sinCosDeg(firstDeg + static_cast<float>(i) * stepDeg);
+				const sf::Vector2f direction{ angle.cos, angle.sin };
+				const float hit = caster.castRay(sensor.position, direction, cone.maxDistance);
+				map.addRay(sensor.position, direction, hit, cone.maxDistance);
+				nearest = std::min(nearest, hit);
+			}
+			if (echoesSq != nullptr && nearest < cone.maxDistance) {
+				(*echoesSq)[s] = nearest * nearest;
+			}
+		}
+		map.commit();
+	}
+
+	void readSensors(const std::vector<SensorPose>& sensors, const OccupancyMap& map, float maxRange,
+		const ObstacleGrid& walls, std::vector<SensorReading>& readings)
+	{
+		readings.resize(sensors.size());
+		for (std::size_t i = 0U; i < sensors.size(); ++i) {
+			readings[i].obstacle = NO_OBSTACLE;
+			readings[i].distanceSq = map.nearestOccupiedSq(sensors[i].position, maxRange);
+			readings[i].wallDistance = walls.nearestWall(sensors[i].position, maxRange);
+		}
+	}
+
+} // namespace sim
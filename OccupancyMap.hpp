@@ -0,0 +1,140 @@
+/*
+==============================================================================
+Occupancy Map - log-odds grid built from the car's own sensor rays
+==============================================================================
+ - The parking assist can sense what the rays have seen instead of the
+   ground-truth pillar list: free space along every ray, an obstacle at
+   every hit that falls inside the sensing range
+ - Cells are grouped in 8x8 tiles (one tile = 256 bytes of log-odds, four
+   cache lines); a fixed window of tiles follows the car and wraps
+   toroidally, so moving never copies cells, a tile that scrolls out is
+   simply cleared when the slot is reused
+ - Rays only mark cells for the tick; one SIMD pass over the tiles that were
+   touched applies the updates, clamps and recounts occupied cells
+ - Nearest-obstacle queries skip every tile without an occupied cell
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "SimFwd.hpp"
+
+namespace sim {
+
+	class OccupancyMap {
+	public:
+		static constexpr int TILE_CELLS = 8; // cells per tile edge
+		static constexpr std::size_t CELLS_PER_TILE = static_cast<std::size_t>(TILE_CELLS * TILE_CELLS);
+
+		// Log-odds increments per observation and the clamp that keeps the map responsive
+		static constexpr float LOG_ODDS_HIT = 0.85F;
+		static constexpr float LOG_ODDS_FREE = -0.4F;
+		static constexpr float LOG_ODDS_MIN = -2.0F;
+		static constexpr float LOG_ODDS_MAX = 3.5F;
+		static constexpr float LOG_ODDS_OCCUPIED = 0.7F; // a cell above this counts as an obstacle
+
+		/**
+		 * @brief Allocates a window of tilesPerSide x tilesPerSide tiles.
+		 *
+		 * MISRA: cellSize must be strictly positive and tilesPerSide at least 1;
+		 *        other values are clamped to those minimums.
+		 */
+		OccupancyMap(float cellSize, int tilesPerSide);
+
+		/**
+		 * @brief Centres the tile window on position (call before adding rays).
+		 *
+		 * Only the window origin moves; tiles left behind keep their cells until
+		 * their slot is reused by a tile that scrolls in.
+		 */
+		void recenter(const sf::Vector2f& position) noexcept;
+
+		/**
+		 * @brief Marks the cells along one ray for the current tick.
+		 *
+		 * direction has unit length. Cells up to the hit (or up to maxRange)
+		 * are marked free; a hit closer than maxRange marks its cell occupied.
+		 * Cells outside the window are ignored.
+		 */
+		void addRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float distance, float maxRange);
+
+		/**
+		 * @brief Applies the tick's marks to the log-odds of every touched tile.
+		 */
+		void commit();
+
+		/**
+		 * @brief Forgets every observation.
+		 */
+		void clear();
+
+		/**
+		 * @brief Log-odds of the cell under point (0 = unknown, also outside the window).
+		 */
+		[[nodiscard]] float logOdds(const sf::Vector2f& point) const noexcept;
+
+		/**
+		 * @brief Squared distance from point to the nearest occupied cell centre.
+		 *
+		 * Returns std::numeric_limits<float>::max() if none lies within maxRange.
+		 */
+		[[nodiscard]] float nearestOccupiedSq(const sf::Vector2f& point, float maxRange) const;
+
+		/**
+		 * @brief World area the window currently covers.
+		 */
+		[[nodiscard]] sf::FloatRect bounds() const noexcept;
+
+		[[nodiscard]] float cellSize() const noexcept { return m_cellSize; }
+
+	private:
+		static constexpr int NO_TILE = std::numeric_limits<int>::min();
+
+		[[nodiscard]] bool inWindow(int tileX, int tileY) const noexcept;
+		[[nodiscard]] std::size_t slotOf(int tileX, int tileY) const noexcept;
+		void mark(int cellX, int cellY, std::uint8_t value);
+
+		float m_cellSize;
+		float m_invCellSize;
+		int m_tilesPerSide;
+
+		sf::Vector2i m_firstTile{ 0, 0 }; // world tile at the window's top-left corner
+
+		// Per slot: the world tile it holds, its cells and the tick's marks
+		std::vector<sf::Vector2i> m_tileKeys;
+		std::vector<float> m_logOdds;        // CELLS_PER_TILE per slot, row-major inside the tile
+		std::vector<std::uint8_t> m_marks;   // CELLS_PER_TILE per slot, reset by commit()
+		std::vector<std::uint16_t> m_occupiedCells;
+		std::vector<std::uint8_t> m_touchedFlag;
+		std::vector<std::uint32_t> m_touched; // slots marked since the last commit()
+	};
+
+	/**
+	 * @brief Casts every sensor's cone and folds the rays into map.
+	 *
+	 * The caller recenters the map on the car first; commit() is called here.
+	 * If echoesSq is given it gets each sensor's nearest ray hit, squared
+	 * (max if every ray ran out), for fusing with the map's slower answer.
+	 */
+	void mapSensors(const std::vector<SensorPose>& sensors, const RayCaster& caster, const RayCone& cone,
+		OccupancyMap& map, std::vector<float>* echoesSq = nullptr);
+
+	/**
+	 * @brief Batched sensor pass against the mapped obstacles instead of the pillar list.
+	 *
+	 * The map does not know which pillar a cell belongs to, so every reading's
+	 * obstacle is NO_OBSTACLE; distanceSq is to the nearest occupied cell.
+	 * Wall distances come from the wall segments of walls.
+	 */
+	void readSensors(const std::vector<SensorPose>& sensors, const OccupancyMap& map, float maxRange,
+		const ObstacleGrid& walls, std::vector<SensorReading>& readings);
+
+} // namespace sim
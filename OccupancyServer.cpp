@@ -0,0 +1,126 @@
+#include "OccupancyServer.hpp"
+
+#include <SFML/Network.hpp>
+
+#include <algorithm>
+#include <optional>
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+namespace io {
+
+	namespace {
+		constexpr std::uint32_t QUERY_MAGIC = 0x4F4B5051U; // "OKPQ"
+		constexpr std::uint32_t REPLY_MAGIC = 0x4F4B5041U; // "OKPA"
+		constexpr std::uint16_t OCCUPANCY_VERSION = 1U;
+
+		// How long the thread waits for a query before the stop flag is checked again
+		constexpr int QUERY_TIMEOUT_MS = 100;
+	}
+
+	OccupancyServer::~OccupancyServer() {
+		stop();
+	}
+
+	bool OccupancyServer::start(unsigned short port, const std::vector<sf::FloatRect>& bays) {
+		if (m_thread.joinable()) {
+			return false;
+		}
+		auto socket = std::make_unique<sf::UdpSocket>();
+		if (socket->bind(port) != sf::Socket::Status::Done) {
+			OKPP_LOG_ERROR("Error: cannot bind UDP port %u for occupancy queries", static_cast<unsigned int>(port));
+			return false;
+		}
+		socket->setBlocking(false); // the selector waits; receive only drains what is there
+		m_socket = std::move(socket);
+		m_index.build(bays, 0.0F);
+		m_board.reset(m_index);
+		m_found.reserve(MAX_REPLY_BAYS);
+		launch();
+		return true;
+	}
+
+	void OccupancyServer::stop() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		halt();
+		m_socket.reset();
+		const OccupancyServerStats totals = stats();
+		OKPP_LOG_INFO("Occupancy queries: %llu answered, %llu rejected",
+			static_cast<unsigned long long>(totals.answered), static_cast<unsigned long long>(totals.rejected));
+	}
+
+	void OccupancyServer::setBays(const std::vector<sf::FloatRect>& bays) {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		halt();
+		m_index.build(bays, 0.0F);
+		m_board.reset(m_index);
+		launch();
+	}
+
+	OccupancyServerStats OccupancyServer::stats() const noexcept {
+		return { m_answered.load(std::memory_order_relaxed), m_rejected.load(std::memory_order_relaxed) };
+	}
+
+	void OccupancyServer::launch() {
+		m_stop.store(false, std::memory_order_relaxed);
+		m_thread = std::thread([this]() { serve(); });
+	}
+
+	void OccupancyServer::halt() {
+		m_stop.store(true, std::memory_order_relaxed);
+		m_thread.join();
+	}
+
+	void OccupancyServer::serve() {
+		prof::setThreadName("occupancy queries");
+		sf::SocketSelector selector;
+		selector.add(*m_socket);
+		sf::Packet query;
+		sf::Packet reply;
+		std::optional<sf::IpAddress> sender;
+		unsigned short senderPort = 0U;
+
+		while (!m_stop.load(std::memory_order_relaxed)) {
+			if (!selector.wait(sf::milliseconds(QUERY_TIMEOUT_MS))) {
+				continue;
+			}
+			while (m_socket->receive(query, sender, senderPort) == sf::Socket::Status::Done) {
+				OKPP_TRACE_SCOPE("occupancy query");
+				std::uint32_t magic = 0U;
+				std::uint16_t version = 0U;
+				std::uint32_t id = 0U;
+				float x = 0.0F;
+				float y = 0.0F;
+				float radius = 0.0F;
+				std::uint16_t limit = 0U;
+				if (!sender || !(query >> magic >> version >> id >> x >> y >> radius >> limit)
+					|| magic != QUERY_MAGIC || version != OCCUPANCY_VERSION)
+				{
+					m_rejected.fetch_add(1U, std::memory_order_relaxed);
+					continue;
+				}
+
+				// The newest frame the simulation published; taking it never waits on the writer
+				const sim::BayOccupancyFrame& frame = m_board.acquire();
+				const std::uint32_t within = m_index.nearestFree(frame, { x, y }, radius,
+					std::min(limit, MAX_REPLY_BAYS), m_found);
+
+				reply.clear();
+				reply << REPLY_MAGIC << OCCUPANCY_VERSION << id << frame.version << frame.freeTotal << within
+					<< static_cast<std::uint16_t>(m_found.size());
+				for (const sim::FreeBay& bay : m_found) {
+					reply << bay.bay << bay.distance;
+				}
+				// A reply the socket cannot take right away is dropped: the dispatcher asks again
+				(void)m_socket->send(reply, *sender, senderPort);
+				m_answered.fetch_add(1U, std::memory_order_relaxed);
+			}
+		}
+	}
+
+} // namespace io
@@ -0,0 +1,103 @@
+/*
+==============================================================================
+Occupancy Server - "which bays are free near (x, y)" over UDP (--occupancy-port)
+==============================================================================
+ - For the fleet dispatcher: any number of clients send query datagrams,
+   each answered by one reply datagram to its sender
+ - A background thread owns the socket and answers from the newest frame
+   of a BayOccupancyBoard (BayOccupancy.hpp); the simulation side only
+   marks the bays that flipped and publishes, so queries never wait on a
+   tick and a tick never waits on a query
+ - The thread drains every datagram that has arrived before it waits
+   again, and reuses one reply packet and one result list, so a steady
+   stream of queries allocates nothing
+ - Replacing the bays (setBays) pauses the thread for the rebuild; the
+   socket stays bound, queries that arrive meanwhile are answered after it
+ - Wire format (sf::Packet, network byte order):
+   query: magic u32 "OKPQ" | version u16 (1) | id u32 | x, y, radius f32 |
+          limit u16 (capped at MAX_REPLY_BAYS)
+   reply: magic u32 "OKPA" | version u16 (1) | id u32 | lot version u32 |
+          free bays in the lot u32 | free bays within radius u32 |
+          bays u16 | bays x (bay u32, distance f32), nearest first
+==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "BayOccupancy.hpp"
+
+namespace sf {
+	class UdpSocket;
+}
+
+namespace io {
+
+	// Bays per reply: 24 header bytes + 128 x 8 stays inside one 1472-byte datagram
+	constexpr std::uint16_t MAX_REPLY_BAYS = 128U;
+
+	struct OccupancyServerStats {
+		std::uint64_t answered = 0U;
+		std::uint64_t rejected = 0U; // malformed or foreign datagrams
+	};
+
+	class OccupancyServer {
+	public:
+		OccupancyServer() = default;
+		~OccupancyServer();
+
+		OccupancyServer(const OccupancyServer&) = delete;
+		OccupancyServer& operator=(const OccupancyServer&) = delete;
+
+		/**
+		 * @brief Binds the local UDP port and starts answering for bays (all free until marked).
+		 *
+		 * Returns false (logged) if the port cannot be bound.
+		 */
+		bool start(unsigned short port, const std::vector<sf::FloatRect>& bays);
+
+		/**
+		 * @brief Stops the thread and closes the socket; safe to call twice.
+		 */
+		void stop();
+
+		/**
+		 * @brief Simulation side: replaces the bays, all free until marked again.
+		 */
+		void setBays(const std::vector<sf::FloatRect>& bays);
+
+		/**
+		 * @brief Simulation side: marks bay for the next publish(); never blocks.
+		 */
+		void setOccupied(std::uint32_t bay, bool occupied) noexcept { m_board.setOccupied(bay, occupied); }
+
+		/**
+		 * @brief Simulation side: makes the marks visible to queries; never blocks.
+		 */
+		void publish() noexcept { m_board.publish(); }
+
+		[[nodiscard]] bool running() const noexcept { return m_thread.joinable(); }
+		[[nodiscard]] OccupancyServerStats stats() const noexcept;
+
+	private:
+		void launch();
+		void halt();
+		void serve();
+
+		sim::BayOccupancyIndex m_index;
+		sim::BayOccupancyBoard m_board;
+		std::unique_ptr<sf::UdpSocket> m_socket;
+		std::vector<sim::FreeBay> m_found; // the thread's result list, reused
+		std::atomic<bool> m_stop{ false };
+		std::atomic<std::uint64_t> m_answered{ 0U };
+		std::atomic<std::uint64_t> m_rejected{ 0U };
+		std::thread m_thread;
+	};
+
+} // namespace io
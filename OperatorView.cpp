@@ -0,0 +1,61 @@
+#include "OperatorView.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gfx {
+
+	namespace {
+		// A very tall lot still opens a window that fits on a screen
+		constexpr unsigned int MAX_OPERATOR_HEIGHT = 1200U;
+	}
+
+	bool OperatorView::open(const sf::FloatRect& lot, unsigned int width) {
+		if (lot.size.x <= 0.0F || lot.size.y <= 0.0F || width == 0U) {
+			return false;
+		}
+		m_lot = lot;
+		const auto height = static_cast<unsigned int>(std::lround(static_cast<float>(width) * lot.size.y / lot.size.x));
+		m_window.create(sf::VideoMode({ width, std::clamp(height, 1U, MAX_OPERATOR_HEIGHT) }),
+			"Car Parking Sensor Simulation - Operator View", sf::State::Windowed);
+		fitView();
+		return m_window.isOpen();
+	}
+
+	void OperatorView::handleEvents() {
+		while (const std::optional<sf::Event> event = m_window.pollEvent()) {
+			const auto* key = event->getIf<sf::Event::KeyPressed>();
+			if (event->is<sf::Event::Closed>() || (key != nullptr && key->code == sf::Keyboard::Key::Escape)) {
+				m_window.close();
+				return;
+			}
+			if (event->is<sf::Event::Resized>()) {
+				fitView();
+			}
+		}
+	}
+
+	void OperatorView::present(RenderQueue& queue, const sf::Color& background) {
+		m_window.clear(background);
+		queue.submit(m_window);
+		m_window.display();
+	}
+
+	void OperatorView::fitView() {
+		m_view = sf::View(m_lot);
+
+		// Letterbox: the lot fills the window along its tighter axis
+		const sf::Vector2f window(m_window.getSize());
+		const float lotAspect = m_lot.size.x / m_lot.size.y;
+		const float windowAspect = (window.y > 0.0F) ? window.x / window.y : lotAspect;
+		if (windowAspect > lotAspect) {
+			const float width = lotAspect / windowAspect;
+			m_view.setViewport({ { (1.0F - width) * 0.5F, 0.0F }, { width, 1.0F } });
+		}
+		else {
+			const float height = windowAspect / lotAspect;
+			m_view.setViewport({ { 0.0F, (1.0F - height) * 0.5F }, { 1.0F, height } });
+		}
+	}
+
+} // namespace gfx
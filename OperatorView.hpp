@@ -0,0 +1,68 @@
+/*
+==============================================================================
+Operator View - a second window showing the whole lot from above
+==============================================================================
+ - Opened next to the driver window (--operator-view); the driver window
+   keeps following the car, this one always frames the whole lot
+ - SFML creates every OpenGL context sharing objects with the others, so
+   the sprite atlas, the heatmap texture, the pillar vertex buffer and
+   shader programs made for the driver window draw here without being
+   uploaded again
+ - Container objects (vertex array objects, framebuffers) belong to one
+   context: the instanced and tiled renderers stay on the driver window
+   and this view draws the pillars from the shared vertex buffer instead
+ - Both windows draw the same FrameSnapshot, so the overhead view never
+   simulates anything of its own
+ - No frame limit or vsync here: the driver window already paces the
+   loop, and a second wait per frame would halve the frame rate
+ - Closing it, or Escape inside it, leaves the driver window running
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "RenderQueue.hpp"
+
+namespace gfx {
+
+	class OperatorView {
+	public:
+		/**
+		 * @brief Opens the window, width pixels wide with the lot's aspect ratio.
+		 *
+		 * MISRA: a lot without area or a zero width opens nothing and returns false.
+		 */
+		[[nodiscard]] bool open(const sf::FloatRect& lot, unsigned int width);
+
+		[[nodiscard]] bool isOpen() const { return m_window.isOpen(); }
+
+		/**
+		 * @brief Drains the window's events: close, Escape and resizes.
+		 */
+		void handleEvents();
+
+		/**
+		 * @brief The whole lot, letterboxed into the window; layers of the
+		 *        operator queue draw under it.
+		 */
+		[[nodiscard]] const sf::View& view() const noexcept { return m_view; }
+
+		/**
+		 * @brief Clears to background, submits queue and shows the frame.
+		 *
+		 * Leaves this window's context active: reactivate the driver window
+		 * before raw OpenGL work meant for it.
+		 */
+		void present(RenderQueue& queue, const sf::Color& background);
+
+	private:
+		void fitView(); // keeps the lot's aspect ratio whatever the window size
+
+		sf::RenderWindow m_window;
+		sf::FloatRect m_lot;
+		sf::View m_view;
+	};
+
+} // namespace gfx
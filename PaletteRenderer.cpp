@@ -0,0 +1,157 @@
+#include "PaletteRenderer.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace gfx {
+
+	namespace {
+		constexpr const char* PALETTE_VERTEX_SHADER = R"(
+#version 130
+in vec2 a_corner;
+in vec4 a_rect;
+in float a_state;
+uniform mat4 u_viewProj;
+uniform vec4 u_palette[16];
+out vec4 v_color;
+void main() {
+	v_color = u_palette[int(min(a_state, 15.0))];
+	gl_Position = u_viewProj * vec4(a_rect.xy + a_corner * a_rect.zw, 0.0, 1.0);
+}
+)";
+
+		constexpr const char* PALETTE_FRAGMENT_SHADER = R"(
+#version 130
+in vec4 v_color;
+void main() {
+	gl_FragColor = v_color;
+}
+)";
+
+		constexpr const char* PALETTE_ATTRIBUTES[] = { "a_corner", "a_rect", "a_state" };
+
+		[[nodiscard]] gl::ProcAddress paletteLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+	}
+
+	PaletteRectRenderer::~PaletteRectRenderer() {
+		if (!gl::loaded()) {
+			return;
+		}
+		const gl::Api& api = gl::api();
+		if (m_stateBuffer != 0U) { api.DeleteBuffers(1, &m_stateBuffer); }
+		if (m_rectBuffer != 0U) { api.DeleteBuffers(1, &m_rectBuffer); }
+		if (m_quadBuffer != 0U) { api.DeleteBuffers(1, &m_quadBuffer); }
+		if (m_vao != 0U) { api.DeleteVertexArrays(1, &m_vao); }
+		if (m_program != 0U) { api.DeleteProgram(m_program); }
+	}
+
+	bool PaletteRectRenderer::init() {
+		if (!gl::loaded() && !gl::load(&paletteLoader)) {
+			return false;
+		}
+		m_program = gl::buildProgram(PALETTE_VERTEX_SHADER, PALETTE_FRAGMENT_SHADER, PALETTE_ATTRIBUTES,
+			std::size(PALETTE_ATTRIBUTES));
+		if (m_program == 0U) {
+			return false;
+		}
+
+		const gl::Api& api = gl::api();
+		m_viewProjLocation = api.GetUniformLocation(m_program, "u_viewProj");
+		m_paletteLocation = api.GetUniformLocation(m_program, "u_palette");
+
+		constexpr GLfloat QUAD[] = { 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 1.0F, 1.0F, 1.0F };
+		api.GenVertexArrays(1, &m_vao);
+		api.BindVertexArray(m_vao);
+		api.GenBuffers(1, &m_quadBuffer);
+		api.BindBuffer(gl::ARRAY_BUFFER, m_quadBuffer);
+		api.BufferData(gl::ARRAY_BUFFER, sizeof(QUAD), QUAD, gl::STATIC_DRAW);
+		api.EnableVertexAttribArray(0U);
+		api.VertexAttribPointer(0U, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+		api.GenBuffers(1, &m_rectBuffer);
+		api.BindBuffer(gl::ARRAY_BUFFER, m_rectBuffer);
+		api.EnableVertexAttribArray(1U);
+		api.VertexAttribPointer(1U, 4, GL_FLOAT, GL_FALSE, sizeof(sf::FloatRect), nullptr);
+		api.VertexAttribDivisor(1U, 1U);
+
+		// Not normalized: the shader sees the byte's value as a float index
+		api.GenBuffers(1, &m_stateBuffer);
+		api.BindBuffer(gl::ARRAY_BUFFER, m_stateBuffer);
+		api.EnableVertexAttribArray(2U);
+		api.VertexAttribPointer(2U, 1, GL_UNSIGNED_BYTE, GL_FALSE, 1, nullptr);
+		api.VertexAttribDivisor(2U, 1U);
+
+		api.BindBuffer(gl::ARRAY_BUFFER, 0U);
+		api.BindVertexArray(0U);
+		return true;
+	}
+
+	void PaletteRectRenderer::setRects(const std::vector<sf::FloatRect>& rects) {
+		if (m_program == 0U) {
+			return;
+		}
+		static_assert(sizeof(sf::FloatRect) == 4U * sizeof(GLfloat), "rects are uploaded as vec4 position, size");
+
+		const gl::Api& api = gl::api();
+		const std::vector<std::uint8_t> cleared(rects.size(), 0U);
+		api.BindBuffer(gl::ARRAY_BUFFER, m_rectBuffer);
+		api.BufferData(gl::ARRAY_BUFFER, static_cast<gl::SizeiPtr>(rects.size() * sizeof(sf::FloatRect)),
+			rects.data(), gl::STATIC_DRAW);
+		api.BindBuffer(gl::ARRAY_BUFFER, m_stateBuffer);
+		api.BufferData(gl::ARRAY_BUFFER, static_cast<gl::SizeiPtr>(cleared.size()), cleared.data(), gl::DYNAMIC_DRAW);
+		api.BindBuffer(gl::ARRAY_BUFFER, 0U);
+		m_count = rects.size();
+		m_videoCharge.set(m_count * (sizeof(sf::FloatRect) + 1U));
+	}
+
+	void PaletteRectRenderer::setPalette(const sf::Color* colors, std::size_t count) {
+		for (std::size_t i = 0U; i < std::min(count, MAX_PALETTE); ++i) {
+			m_palette[4U * i] = static_cast<GLfloat>(colors[i].r) / 255.0F;
+			m_palette[4U * i + 1U] = static_cast<GLfloat>(colors[i].g) / 255.0F;
+			m_palette[4U * i + 2U] = static_cast<GLfloat>(colors[i].b) / 255.0F;
+			m_palette[4U * i + 3U] = static_cast<GLfloat>(colors[i].a) / 255.0F;
+		}
+		// States past the palette repeat its last color
+		for (std::size_t i = std::max<std::size_t>(std::min(count, MAX_PALETTE), 1U); i < MAX_PALETTE; ++i) {
+			std::copy_n(&m_palette[4U * (i - 1U)], 4U, &m_palette[4U * i]);
+		}
+	}
+
+	void PaletteRectRenderer::setStates(const std::uint8_t* states, std::size_t count) {
+		count = std::min(count, m_count);
+		if (m_program == 0U || count == 0U) {
+			return;
+		}
+
+		const gl::Api& api = gl::api();
+		api.BindBuffer(gl::ARRAY_BUFFER, m_stateBuffer);
+		api.BufferSubData(gl::ARRAY_BUFFER, 0, static_cast<gl::SizeiPtr>(count), states);
+		api.BindBuffer(gl::ARRAY_BUFFER, 0U);
+	}
+
+	void PaletteRectRenderer::draw(sf::RenderTarget& target) {
+		if (m_program == 0U || m_count == 0U) {
+			return;
+		}
+		if (!target.setActive(true)) {
+			return;
+		}
+
+		const gl::Api& api = gl::api();
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		api.UseProgram(m_program);
+		api.UniformMatrix4fv(m_viewProjLocation, 1, GL_FALSE, target.getView().getTransform().getMatrix());
+		api.Uniform4fv(m_paletteLocation, static_cast<GLsizei>(MAX_PALETTE), m_palette.data());
+		api.BindVertexArray(m_vao);
+		api.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_count));
+		api.BindVertexArray(0U);
+		api.UseProgram(0U);
+
+		target.resetGLStates();
+	}
+
+} // namespace gfx
@@ -0,0 +1,90 @@
+/*
+==============================================================================
+Palette Renderer - instanced rectangles colored by a state byte per instance
+==============================================================================
+ - Geometry and state live in separate instance buffers: the rectangles
+   (x, y, width, height) are uploaded once per scene, the states as one
+   byte per rectangle
+ - The vertex shader looks each byte up in a palette uniform of up to
+   MAX_PALETTE colors, so no color is stored per vertex or per instance;
+   flipping thousands of bays costs one upload of their state bytes
+ - Every rectangle is drawn by a single glDrawArraysInstanced call and
+   clipped by the GPU, so the CPU cost does not grow with the lot
+ - States past the palette show its last color
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlFunctions.hpp"
+#include "MemoryAccounting.hpp"
+
+namespace gfx {
+
+	class PaletteRectRenderer {
+	public:
+		static constexpr std::size_t MAX_PALETTE = 16U;
+
+		PaletteRectRenderer() = default;
+		~PaletteRectRenderer();
+
+		PaletteRectRenderer(const PaletteRectRenderer&) = delete;
+		PaletteRectRenderer& operator=(const PaletteRectRenderer&) = delete;
+
+		/**
+		 * @brief Loads the GL entry points and builds the shader program.
+		 *
+		 * Requires the target window's context to be active. Returns false if
+		 * the driver lacks instancing; callers fall back to the SFML renderer.
+		 */
+		[[nodiscard]] bool init();
+
+		/**
+		 * @brief Replaces the rectangles; every state is reset to 0.
+		 */
+		void setRects(const std::vector<sf::FloatRect>& rects);
+
+		/**
+		 * @brief Colors of states 0..count-1.
+		 *
+		 * MISRA: colors past MAX_PALETTE are ignored.
+		 */
+		void setPalette(const sf::Color* colors, std::size_t count);
+
+		/**
+		 * @brief Overwrites the states of rectangles [0, count) in one upload.
+		 *
+		 * MISRA: states past the last setRects() are ignored.
+		 */
+		void setStates(const std::uint8_t* states, std::size_t count);
+
+		/**
+		 * @brief Draws every rectangle with the target's current view.
+		 *
+		 * SFML's cached GL state is reset afterwards, so regular draws may follow.
+		 */
+		void draw(sf::RenderTarget& target);
+
+		[[nodiscard]] std::size_t rectCount() const noexcept { return m_count; }
+
+	private:
+		GLuint m_program = 0U;
+		GLuint m_vao = 0U;
+		GLuint m_quadBuffer = 0U;
+		GLuint m_rectBuffer = 0U;
+		GLuint m_stateBuffer = 0U;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::RenderBuffers, prof::MemoryKind::Video }; // rects and states
+		GLint m_viewProjLocation = -1;
+		GLint m_paletteLocation = -1;
+		std::array<GLfloat, 4U * MAX_PALETTE> m_palette{};
+		std::size_t m_count = 0U;
+	};
+
+} // namespace gfx
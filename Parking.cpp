@@ -0,0 +1,275 @@
+#include "Parking.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "FastTrig.hpp"
+#include "SimdIntrinsics.hpp"
+
+namespace sim {
+
+	namespace {
+		// Padding bay: starts after and ends before every car, so it never contains one
+		constexpr float EMPTY_BAY_START = std::numeric_limits<float>::max();
+		constexpr float EMPTY_BAY_END = -std::numeric_limits<float>::max();
+
+		// One 16-bay block of the columns and the car's edges, for the containment kernels
+		struct BayBlock {
+			const float* left;
+			const float* top;
+			const float* right;
+			const float* bottom;
+			float carLeft;
+			float carTop;
+			float carRight;
+			float carBottom;
+		};
+
+		constexpr std::size_t BAY_BLOCK_LANES = BayColumns::LANES;
+
+		[[nodiscard]] std::uint32_t bayMaskScalar(const BayBlock& block) noexcept {
+			std::uint32_t mask = 0U;
+			for (std::size_t i = 0U; i < BAY_BLOCK_LANES; ++i) {
+				const bool inside = block.carLeft >= block.left[i] && block.carRight <= block.right[i]
+					&& block.carTop >= block.top[i] && block.carBottom <= block.bottom[i];
+				mask |= (inside ? 1U : 0U) << i;
+			}
+			return mask;
+		}
+
+#if defined(OKPP_SIMD_X86)
+		OKPP_TARGET_SSE2 std::uint32_t bayMaskSse2(const BayBlock& block) noexcept {
+			const __m128 cl = _mm_set1_ps(block.carLeft);
+			const __m128 ct = _mm_set1_ps(block.carTop);
+			const __m128 cr = _mm_set1_ps(block.carRight);
+			const __m128 cb = _mm_set1_ps(block.carBottom);
+			std::uint32_t mask = 0U;
+			// Four 4-lane compares cover the 16-bay stride
+			for (std::size_t i = 0U; i < BAY_BLOCK_LANES; i += 4U) {
+				const __m128 inside = _mm_and_ps(
+					_mm_and_ps(_mm_cmpge_ps(cl, _mm_loadu_ps(block.left + i)), _mm_cmple_ps(cr, _mm_loadu_ps(block.right + i))),
+					_mm_and_ps(_mm_cmpge_ps(ct, _mm_loadu_ps(block.top + i)), _mm_cmple_ps(cb, _mm_loadu_ps(block.bottom + i))));
+				mask |= static_cast<std::uint32_t>(_mm_movemask_ps(inside)) << i;
+			}
+			return mask;
+		}
+
+		OKPP_TARGET_AVX2 std::uint32_t bayMaskAvx2(const BayBlock& block) noexcept {
+			const __m256 cl = _mm256_set1_ps(block.carLeft);
+			const __m256 ct = _mm256_set1_ps(block.carTop);
+			const __m256 cr = _mm256_set1_ps(block.carRight);
+			const __m256 cb = _mm256_set1_ps(block.carBottom);
+			std::uint32_t mask = 0U;
+			for (std::size_t i = 0U; i < BAY_BLOCK_LANES; i += 8U) {
+				const __m256 inside = _mm256_and_ps(
+					_mm256_and_ps(_mm256_cmp_ps(cl, _mm256_loadu_ps(block.left + i), _CMP_GE_OQ),
+						_mm256_cmp_ps(cr, _mm256_loadu_ps(block.right + i), _CMP_LE_OQ)),
+					_mm256_and_ps(_mm256_cmp_ps(ct, _mm256_loadu_ps(block.top + i), _CMP_GE_OQ),
+						_mm256_cmp_ps(cb, _mm256_loadu_ps(block.bottom + i), _CMP_LE_OQ)));
+				mask |= static_cast<std::uint32_t>(_mm256_movemask_ps(inside)) << i;
+			}
+			return mask;
+		}
+
+		// The whole block in one compare per edge; the mask registers are the answer
+		OKPP_TARGET_AVX512 std::uint32_t bayMaskAvx512(const BayBlock& block) noexcept {
+			const __mmask16 inside = static_cast<__mmask16>(
+				_mm512_cmp_ps_mask(_mm512_set1_ps(block.carLeft), _mm512_loadu_ps(block.left), _CMP_GE_OQ)
+				& _mm512_cmp_ps_mask(_mm512_set1_ps(block.carRight), _mm512_loadu_ps(block.right), _CMP_LE_OQ)
+				& _mm512_cmp_ps_mask(_mm512_set1_ps(block.carTop), _mm512_loadu_ps(block.top), _CMP_GE_OQ)
+				& _mm512_cmp_ps_mask(_mm512_set1_ps(block.carBottom), _mm512_loadu_ps(block.bottom), _CMP_LE_OQ));
+			return static_cast<std::uint32_t>(inside);
+		}
+#elif defined(OKPP_SIMD_NEON)
+		// One bit per lane of four all-ones/all-zeros compare results
+		[[nodiscard]] std::uint32_t neonLaneBits(uint32x4_t inside) noexcept {
+			static const std::uint32_t weights[4] = { 1U, 2U, 4U, 8U };
+			const uint32x4_t bits = vandq_u32(inside, vld1q_u32(weights));
+			uint32x2_t sum = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+			sum = vpadd_u32(sum, sum);
+			return vget_lane_u32(sum, 0);
+		}
+
+		[[nodiscard]] std::uint32_t bayMaskNeon(const BayBlock& block) noexcept {
+			const float32x4_t cl = vdupq_n_f32(block.carLeft);
+			const float32x4_t ct = vdupq_n_f32(block.carTop);
+			const float32x4_t cr = vdupq_n_f32(block.carRight);
+			const float32x4_t cb = vdupq_n_f32(block.carBottom);
+			std::uint32_t mask = 0U;
+			for (std::size_t i = 0U; i < BAY_BLOCK_LANES; i += 4U) {
+				const uint32x4_t inside = vandq_u32(
+					vandq_u32(vcgeq_f32(cl, vld1q_f32(block.left + i)), vcleq_f32(cr, vld1q_f32(block.right + i))),
+					vandq_u32(vcgeq_f32(ct, vld1q_f32(block.top + i)), vcleq_f32(cb, vld1q_f32(block.bottom + i))));
+				mask |= neonLaneBits(inside) << i;
+			}
+			return mask;
+		}
+#endif
+	}
+
+	bool parkOccupied(const sf::FloatRect& carBounds, const sf::FloatRect& parkBounds) {
+		const bool isLeftInside = carBounds.position.x >= parkBounds.position.x;
+
+		const bool isRightInside = (carBounds.position.x + carBounds.size.x)
+			<= (parkBounds.position.x + parkBounds.size.x);
+
+		const bool isTopInside = carBounds.position.y >= parkBounds.position.y;
+
+		const bool isBottomInside = (carBounds.position.y + carBounds.size.y)
+			<= (parkBounds.position.y + parkBounds.size.y);
+
+		return isLeftInside && isRightInside && isTopInside && isBottomInside;
+	}
+
+	void BayColumns::assign(const std::vector<sf::FloatRect>& bays) {
+		m_count = bays.size();
+		const std::size_t padded = ((m_count + LANES - 1U) / LANES) * LANES;
+
+		m_left.assign(padded, EMPTY_BAY_START);
+		m_top.assign(padded, EMPTY_BAY_START);
+		m_right.assign(padded, EMPTY_BAY_END);
+		m_bottom.assign(padded, EMPTY_BAY_END);
+		for (std::size_t i = 0U; i < m_count; ++i) {
+			m_left[i] = bays[i].position.x;
+			m_top[i] = bays[i].position.y;
+			m_right[i] = bays[i].position.x + bays[i].size.x;
+			m_bottom[i] = bays[i].position.y + bays[i].size.y;
+		}
+	}
+
+	std::uint32_t BayColumns::blockMask(std::size_t first, const sf::FloatRect& carBounds) const noexcept {
+		const BayBlock block{ m_left.data() + first, m_top.data() + first, m_right.data() + first, m_bottom.data() + first,
+			carBounds.position.x, carBounds.position.y,
+			carBounds.position.x + carBounds.size.x, carBounds.position.y + carBounds.size.y };
+
+		switch (simdLevel()) {
+#if defined(OKPP_SIMD_X86)
+		case SimdLevel::Avx512: return bayMaskAvx512(block);
+		case SimdLevel::Avx2: return bayMaskAvx2(block);
+		case SimdLevel::Sse2: return bayMaskSse2(block);
+#elif defined(OKPP_SIMD_NEON)
+		case SimdLevel::Neon: return bayMaskNeon(block);
+#endif
+		default: return bayMaskScalar(block);
+		}
+	}
+
+	std::size_t BayColumns::markOccupied(const sf::FloatRect& carBounds, std::uint8_t* occupied) const {
+		std::size_t count = 0U;
+		for (std::size_t first = 0U; first < paddedSize(); first += LANES) {
+			// Almost every block holds no bay the car is in; those cost one branch
+			std::uint32_t mask = blockMask(first, carBounds);
+			for (std::size_t lane = 0U; mask != 0U; ++lane, mask >>= 1U) {
+				if ((mask & 1U) != 0U) {
+					occupied[first + lane] = 1U;
+					++count;
+				}
+			}
+		}
+		return count;
+	}
+
+	std::size_t BayColumns::firstOccupied(const sf::FloatRect& carBounds) const noexcept {
+		for (std::size_t first = 0U; first < paddedSize(); first += LANES) {
+			std::uint32_t mask = blockMask(first, carBounds);
+			for (std::size_t lane = 0U; mask != 0U; ++lane, mask >>= 1U) {
+				if ((mask & 1U) != 0U) {
+					return first + lane;
+				}
+			}
+		}
+		return m_count;
+	}
+
+	float OrientedRect::radiusAlong(const sf::Vector2f& direction) const noexcept {
+		return halfExtent.x * std::fabs(axis.dot(direction)) + halfExtent.y * std::fabs(normal().dot(direction));
+	}
+
+	OrientedRect carFootprint(const CarState& pose, const sf::Vector2f& halfExtent) {
+		const SinCos heading = sinCosDeg(pose.headingDeg);
+		return { pose.position, { heading.cos, heading.sin }, halfExtent };
+	}
+
+	OrientedRect orientedRect(const sf::FloatRect& rect) {
+		const sf::Vector2f half = rect.size * 0.5F;
+		return { rect.position + half, { 1.0F, 0.0F }, half };
+	}
+
+	sf::FloatRect rectBounds(const OrientedRect& rect) {
+		const sf::Vector2f half{ rect.radiusAlong({ 1.0F, 0.0F }), rect.radiusAlong({ 0.0F, 1.0F }) };
+		return { rect.center - half, half * 2.0F };
+	}
+
+	SweptFootprint::SweptFootprint(const OrientedRect& from, const OrientedRect& to)
+		: m_from(from)
+		, m_to(to)
+	{
+		// Without a move the fifth axis just repeats the first
+		const sf::Vector2f move = to.center - from.center;
+		const float length = std::sqrt(move.dot(move));
+		const sf::Vector2f moveNormal = (length > 0.0F) ? sf::Vector2f{ -move.y, move.x } / length : from.axis;
+		m_axes = { from.axis, from.normal(), to.axis, to.normal(), moveNormal };
+		for (std::size_t i = 0U; i < AXES; ++i) {
+			const float fromCenter = from.center.dot(m_axes[i]);
+			const float toCenter = to.center.dot(m_axes[i]);
+			const float fromRadius = from.radiusAlong(m_axes[i]);
+			const float toRadius = to.radiusAlong(m_axes[i]);
+			m_low[i] = std::min(fromCenter - fromRadius, toCenter - toRadius);
+			m_high[i] = std::max(fromCenter + fromRadius, toCenter + toRadius);
+		}
+
+		const sf::FloatRect a = rectBounds(from);
+		const sf::FloatRect b = rectBounds(to);
+		const sf::Vector2f low{ std::min(a.position.x, b.position.x), std::min(a.position.y, b.position.y) };
+		const sf::Vector2f high{ std::max(a.position.x + a.size.x, b.position.x + b.size.x),
+			std::max(a.position.y + a.size.y, b.position.y + b.size.y) };
+		m_bounds = { low, high - low };
+	}
+
+	bool SweptFootprint::overlaps(const OrientedRect& rect) const noexcept {
+		for (std::size_t i = 0U; i < AXES; ++i) {
+			const float center = rect.center.dot(m_axes[i]);
+			const float radius = rect.radiusAlong(m_axes[i]);
+			if (center + radius <= m_low[i] || center - radius >= m_high[i]) {
+				return false;
+			}
+		}
+		// The rect's own axes: its shadow is its half extent, the sweep's spans both outlines
+		const std::array<sf::Vector2f, 2U> rectAxes{ rect.axis, rect.normal() };
+		const std::array<float, 2U> rectRadii{ rect.halfExtent.x, rect.halfExtent.y };
+		for (std::size_t i = 0U; i < rectAxes.size(); ++i) {
+			const float center = rect.center.dot(rectAxes[i]);
+			const float fromCenter = m_from.center.dot(rectAxes[i]);
+			const float toCenter = m_to.center.dot(rectAxes[i]);
+			const float fromRadius = m_from.radiusAlong(rectAxes[i]);
+			const float toRadius = m_to.radiusAlong(rectAxes[i]);
+			const float low = std::min(fromCenter - fromRadius, toCenter - toRadius);
+			const float high = std::max(fromCenter + fromRadius, toCenter + toRadius);
+			if (center + rectRadii[i] <= low || center - rectRadii[i] >= high) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	BayFootprint::BayFootprint(const OrientedRect& bay)
+		: m_rect(bay)
+		, m_normal(bay.normal())
+		, m_centerAlongAxis(bay.center.dot(bay.axis))
+		, m_centerAlongNormal(bay.center.dot(bay.normal()))
+	{
+	}
+
+	bool BayFootprint::contains(const OrientedRect& car) const noexcept {
+		return containsWithin(car, 0.0F);
+	}
+
+	bool BayFootprint::containsWithin(const OrientedRect& car, float margin) const noexcept {
+		// A convex outline lies inside the bay when its shadow does on both bay axes
+		const float alongAxis = std::fabs(car.center.dot(m_rect.axis) - m_centerAlongAxis) + car.radiusAlong(m_rect.axis);
+		const float alongNormal = std::fabs(car.center.dot(m_normal) - m_centerAlongNormal) + car.radiusAlong(m_normal);
+		return alongAxis <= m_rect.halfExtent.x + margin && alongNormal <= m_rect.halfExtent.y + margin;
+	}
+
+} // namespace sim
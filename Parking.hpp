@@ -0,0 +1,166 @@
+/*
+==============================================================================
+Parking - bay occupancy checks
+==============================================================================
+ - parkOccupied() is the axis-aligned test: car bounds inside an upright bay
+ - BayColumns keeps many upright bays as min/max columns (structure of
+   arrays, padded to LANES) and runs the same test against 16 bays per
+   step with SIMD compares and one mask; for lots of a few hundred bays,
+   where a spatial hash costs more than it saves
+ - Oriented checks work on OrientedRect (center, unit axis, half extents) for
+   both the car and the bay, so an angled bay or a car parked at an angle is
+   judged by its real outline rather than its bounding box
+ - BayFootprint precomputes a bay's two separating axes and its extent on
+   each; containment is then two interval tests per bay
+ - SweptFootprint covers the car's motion between two ticks (the convex
+   hull of the two outlines) and is projected once onto its own axes, so
+   testing it against each bay along the way is a handful of dot products
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CarModel.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief True when the car bounds lie entirely inside the bay.
+	 */
+	[[nodiscard]] bool parkOccupied(const sf::FloatRect& carBounds, const sf::FloatRect& parkBounds);
+
+	// Upright bays as left/top/right/bottom columns for the batched test
+	class BayColumns {
+	public:
+		// Columns are padded to a multiple of this many bays
+		static constexpr std::size_t LANES = 16U;
+
+		/**
+		 * @brief Replaces the stored bays.
+		 *
+		 * Padding lanes hold an inverted bay that contains nothing, so the
+		 * kernels never need a tail loop.
+		 */
+		void assign(const std::vector<sf::FloatRect>& bays);
+
+		/**
+		 * @brief Sets occupied[i] to 1 for every bay i the car bounds lie inside
+		 *        (others are left as they are); returns how many there were.
+		 *
+		 * Same answer as parkOccupied() per bay. MISRA: occupied must hold size() entries.
+		 */
+		std::size_t markOccupied(const sf::FloatRect& carBounds, std::uint8_t* occupied) const;
+
+		/**
+		 * @brief Lowest bay the car bounds lie inside, or size() if none.
+		 */
+		[[nodiscard]] std::size_t firstOccupied(const sf::FloatRect& carBounds) const noexcept;
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_count; }
+		[[nodiscard]] std::size_t paddedSize() const noexcept { return m_left.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_count == 0U; }
+
+	private:
+		// Bit i set when the car lies inside bay first + i
+		[[nodiscard]] std::uint32_t blockMask(std::size_t first, const sf::FloatRect& carBounds) const noexcept;
+
+		std::vector<float> m_left;
+		std::vector<float> m_top;
+		std::vector<float> m_right;  // position + size, as parkOccupied() adds them
+		std::vector<float> m_bottom;
+		std::size_t m_count = 0U;
+	};
+
+	// Rectangle at any angle: halfExtent.x runs along axis, halfExtent.y along its left normal
+	struct OrientedRect {
+		sf::Vector2f center{ 0.0F, 0.0F };
+		sf::Vector2f axis{ 1.0F, 0.0F }; // unit length
+		sf::Vector2f halfExtent{ 0.0F, 0.0F };
+
+		[[nodiscard]] sf::Vector2f normal() const noexcept { return { -axis.y, axis.x }; }
+
+		/**
+		 * @brief Half the width of the rectangle's shadow on a unit direction.
+		 */
+		[[nodiscard]] float radiusAlong(const sf::Vector2f& direction) const noexcept;
+
+		[[nodiscard]] bool operator==(const OrientedRect& other) const noexcept {
+			return center == other.center && axis == other.axis && halfExtent == other.halfExtent;
+		}
+	};
+
+	/**
+	 * @brief The car rectangle at pose (halfExtent.x along the heading).
+	 */
+	[[nodiscard]] OrientedRect carFootprint(const CarState& pose, const sf::Vector2f& halfExtent);
+
+	/**
+	 * @brief An upright rectangle as an OrientedRect.
+	 */
+	[[nodiscard]] OrientedRect orientedRect(const sf::FloatRect& rect);
+
+	/**
+	 * @brief Axis-aligned bounds of an oriented rectangle.
+	 */
+	[[nodiscard]] sf::FloatRect rectBounds(const OrientedRect& rect);
+
+	// Motion of the car between two ticks, projected onto the axes a bay test needs
+	class SweptFootprint {
+	public:
+		SweptFootprint(const OrientedRect& from, const OrientedRect& to);
+
+		/**
+		 * @brief True if rect overlaps the swept area (touching is not a hit).
+		 *
+		 * Separating axes: both car outlines' axes, the normal of the move and
+		 * the rect's own axes. Exact for a move without a turn; a turn within
+		 * one tick bulges past the hull by well under a pixel and is counted.
+		 */
+		[[nodiscard]] bool overlaps(const OrientedRect& rect) const noexcept;
+
+		[[nodiscard]] const sf::FloatRect& bounds() const noexcept { return m_bounds; }
+
+	private:
+		static constexpr std::size_t AXES = 5U;
+
+		OrientedRect m_from;
+		OrientedRect m_to;
+		std::array<sf::Vector2f, AXES> m_axes{};
+		std::array<float, AXES> m_low{};  // swept area's shadow on each axis
+		std::array<float, AXES> m_high{};
+		sf::FloatRect m_bounds;
+	};
+
+	// A bay with its separating axes and extents precomputed
+	class BayFootprint {
+	public:
+		explicit BayFootprint(const OrientedRect& bay);
+
+		/**
+		 * @brief True when the whole car outline lies inside the bay.
+		 */
+		[[nodiscard]] bool contains(const OrientedRect& car) const noexcept;
+
+		/**
+		 * @brief Same test against the bay grown by margin on every side.
+		 */
+		[[nodiscard]] bool containsWithin(const OrientedRect& car, float margin) const noexcept;
+
+		[[nodiscard]] const OrientedRect& rect() const noexcept { return m_rect; }
+
+	private:
+		OrientedRect m_rect;
+		sf::Vector2f m_normal;
+		float m_centerAlongAxis;   // center projected on axis
+		float m_centerAlongNormal; // and on its normal
+	};
+
+} // namespace sim
@@ -0,0 +1,246 @@
+#include "ParkingLot.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+	namespace {
+		// Clamp before float->int conversion so far-away cars stay defined
+		constexpr float MAX_BAY_CELL_COORD = 1.0e6F;
+	}
+
+	std::uint64_t ParkingLot::cellKey(int cx, int cy) {
+		return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32U)
+			| static_cast<std::uint64_t>(static_cast<std::uint32_t>(cy));
+	}
+
+	int ParkingLot::toCell(float coord) const {
+		return static_cast<int>(std::clamp(std::floor(coord * m_invCellSize), -MAX_BAY_CELL_COORD, MAX_BAY_CELL_COORD));
+	}
+
+	void ParkingLot::setBays(std::vector<sf::FloatRect> bays, float cellSize) {
+		m_bays = std::move(bays);
+		m_footprints.clear();
+		m_footprints.reserve(m_bays.size());
+		for (const sf::FloatRect& bay : m_bays) {
+			m_footprints.emplace_back(orientedRect(bay));
+		}
+		m_occupants.assign(m_bays.size(), 0U);
+		m_occupiedCount = 0U;
+		m_visited.assign(m_bays.size(), 0U);
+		m_visitStamp = 0U;
+		m_cells.clear();
+		m_cars.clear();
+		m_changed.clear();
+
+		if (cellSize <= 0.0F) {
+			cellSize = m_bays.empty() ? 1.0F : std::max({ m_bays.front().size.x, m_bays.front().size.y, 1.0F });
+		}
+		m_invCellSize = 1.0F / cellSize;
+
+		for (std::size_t i = 0U; i < m_bays.size(); ++i) {
+			indexBay(static_cast<std::uint32_t>(i));
+		}
+	}
+
+	void ParkingLot::indexBay(std::uint32_t bay) {
+		const sf::FloatRect& b = m_bays[bay];
+		for (int cy = toCell(b.position.y); cy <= toCell(b.position.y + b.size.y); ++cy) {
+			for (int cx = toCell(b.position.x); cx <= toCell(b.position.x + b.size.x); ++cx) {
+				std::vector<std::uint32_t>& cell = m_cells[cellKey(cx, cy)];
+				cell.insert(std::lower_bound(cell.begin(), cell.end(), bay), bay);
+			}
+		}
+	}
+
+	void ParkingLot::unindexBay(std::uint32_t bay) {
+		const sf::FloatRect& b = m_bays[bay];
+		for (int cy = toCell(b.position.y); cy <= toCell(b.position.y + b.size.y); ++cy) {
+			for (int cx = toCell(b.position.x); cx <= toCell(b.position.x + b.size.x); ++cx) {
+				const auto cell = m_cells.find(cellKey(cx, cy));
+				if (cell == m_cells.end()) {
+					continue;
+				}
+				const auto found = std::lower_bound(cell->second.begin(), cell->second.end(), bay);
+				if (found != cell->second.end() && *found == bay) {
+					cell->second.erase(found);
+				}
+				if (cell->second.empty()) {
+					m_cells.erase(cell);
+				}
+			}
+		}
+	}
+
+	void ParkingLot::requeueCars() {
+		for (CarEntry& entry : m_cars) {
+			entry.placed = false; // the next update re-tests every bay around the car
+		}
+	}
+
+	std::uint32_t ParkingLot::addBay(const sf::FloatRect& rect) {
+		const auto bay = static_cast<std::uint32_t>(m_bays.size());
+		m_bays.push_back(rect);
+		m_footprints.emplace_back(orientedRect(rect));
+		m_occupants.push_back(0U);
+		m_visited.push_back(0U);
+		indexBay(bay);
+		requeueCars();
+		return bay;
+	}
+
+	void ParkingLot::moveBay(std::uint32_t bay, const sf::FloatRect& rect) {
+		for (CarEntry& entry : m_cars) {
+			if (std::find(entry.parkedIn.begin(), entry.parkedIn.end(), bay) != entry.parkedIn.end()) {
+				setParked(entry, bay, false);
+				entry.pathClear = entry.pathClear || entry.parkedIn.empty();
+			}
+		}
+		unindexBay(bay);
+		m_bays[bay] = rect;
+		m_footprints[bay] = BayFootprint(orientedRect(rect));
+		indexBay(bay);
+		requeueCars();
+	}
+
+	std::uint32_t ParkingLot::addCar() {
+		m_cars.emplace_back();
+		return static_cast<std::uint32_t>(m_cars.size() - 1U);
+	}
+
+	void ParkingLot::setParked(CarEntry& entry, std::uint32_t bay, bool parked) {
+		const bool wasOccupied = m_occupants[bay] != 0U;
+		if (parked) {
+			entry.parkedIn.push_back(bay);
+			++m_occupants[bay];
+		}
+		else {
+			const auto found = std::find(entry.parkedIn.begin(), entry.parkedIn.end(), bay);
+			*found = entry.parkedIn.back();
+			entry.parkedIn.pop_back();
+			--m_occupants[bay];
+		}
+
+		const bool isOccupied = m_occupants[bay] != 0U;
+		if (wasOccupied != isOccupied) {
+			m_occupiedCount = isOccupied ? m_occupiedCount + 1U : m_occupiedCount - 1U;
+			m_changed.push_back(bay);
+		}
+	}
+
+	void ParkingLot::updateCar(std::uint32_t car, const OrientedRect& footprint) {
+		CarEntry& entry = m_cars[car];
+		if (entry.placed && entry.footprint == footprint) {
+			return; // parked or idle cars cost nothing
+		}
+		// A first placement has no motion to sweep
+		const SweptFootprint sweep(entry.placed ? entry.footprint : footprint, footprint);
+		entry.footprint = footprint;
+		entry.placed = true;
+
+		if (++m_visitStamp == 0U) {
+			std::fill(m_visited.begin(), m_visited.end(), 0U);
+			m_visitStamp = 1U;
+		}
+
+		// Bays the car may have left (past the hysteresis margin); backwards, since setParked() swap-removes
+		const bool wasParked = !entry.parkedIn.empty();
+		for (std::size_t i = entry.parkedIn.size(); i-- > 0U;) {
+			const std::uint32_t bay = entry.parkedIn[i];
+			m_visited[bay] = m_visitStamp;
+			if (!m_footprints[bay].containsWithin(footprint, m_hysteresis)) {
+				setParked(entry, bay, false);
+			}
+		}
+		if (wasParked && entry.parkedIn.empty()) {
+			entry.pathClear = true;
+		}
+
+		// Bays the car may have entered or swept across: only those sharing a
+		// cell with the sweep, which covers the new footprint
+		const sf::FloatRect& area = sweep.bounds();
+		for (int cy = toCell(area.position.y); cy <= toCell(area.position.y + area.size.y); ++cy) {
+			for (int cx = toCell(area.position.x); cx <= toCell(area.position.x + area.size.x); ++cx) {
+				const auto cell = m_cells.find(cellKey(cx, cy));
+				if (cell == m_cells.end()) {
+					continue;
+				}
+				for (const std::uint32_t bay : cell->second) {
+					if (m_visited[bay] == m_visitStamp) {
+						continue; // already parked in, or reached through another cell
+					}
+					m_visited[bay] = m_visitStamp;
+					// Not parked in this bay, so any occupant is another car
+					if (m_occupants[bay] != 0U && entry.pathClear && sweep.overlaps(m_footprints[bay].rect())) {
+						entry.pathClear = false;
+					}
+					if (m_footprints[bay].contains(footprint)) {
+						setParked(entry, bay, true);
+					}
+				}
+			}
+		}
+	}
+
+	ArenaSpan<std::uint32_t> ParkingLot::queryBays(const sf::FloatRect& area, FrameArena& arena) const {
+		const int cx0 = toCell(area.position.x);
+		const int cx1 = toCell(area.position.x + area.size.x);
+		const int cy0 = toCell(area.position.y);
+		const int cy1 = toCell(area.position.y + area.size.y);
+
+		// Upper bound first, so the list is allocated once at its final size
+		std::size_t bound = 0U;
+		for (int cy = cy0; cy <= cy1; ++cy) {
+			for (int cx = cx0; cx <= cx1; ++cx) {
+				const auto cell = m_cells.find(cellKey(cx, cy));
+				if (cell != m_cells.end()) {
+					bound += cell->second.size();
+				}
+			}
+		}
+
+		ArenaSpan<std::uint32_t> bays = arena.allocate<std::uint32_t>(bound);
+		std::size_t count = 0U;
+		for (int cy = cy0; cy <= cy1; ++cy) {
+			for (int cx = cx0; cx <= cx1; ++cx) {
+				const auto cell = m_cells.find(cellKey(cx, cy));
+				if (cell == m_cells.end()) {
+					continue;
+				}
+				for (const std::uint32_t bay : cell->second) {
+					if (m_bays[bay].findIntersection(area)) {
+						bays[count++] = bay;
+					}
+				}
+			}
+		}
+		bays.size = count;
+
+		// Sorting gives a stable draw order while the view moves; bays reached
+		// through several cells end up side by side and are dropped. The visit
+		// stamps are left to updateCar(), which may be running on another thread.
+		std::sort(bays.begin(), bays.end());
+		bays.size = static_cast<std::size_t>(std::unique(bays.begin(), bays.end()) - bays.begin());
+		return bays;
+	}
+
+	std::vector<sf::FloatRect> layoutBays(const sf::Vector2f& origin, const sf::Vector2f& baySize,
+		std::uint32_t columns, std::uint32_t rows, float gap)
+	{
+		std::vector<sf::FloatRect> bays;
+		bays.reserve(static_cast<std::size_t>(columns) * rows);
+
+		for (std::uint32_t r = 0U; r < rows; ++r) {
+			for (std::uint32_t c = 0U; c < columns; ++c) {
+				bays.push_back({
+					{ origin.x + static_cast<float>(c) * (baySize.x + gap),
+					  origin.y + static_cast<float>(r) * (baySize.y + gap) },
+					baySize
+				});
+			}
+		}
+		return bays;
+	}
+
+} // namespace sim
@@ -0,0 +1,146 @@
+/*
+==============================================================================
+Parking Lot - many bays, many cars, incremental occupancy
+==============================================================================
+ - Bays are registered in a spatial hash of fixed-size cells
+ - A car update only re-evaluates the bays in the cells its bounds cover
+   plus the bays it was parked in, so per-update cost depends on the local
+   bay density, not on the size of the lot
+ - Cars are oriented footprints and bays keep their precomputed separating
+   axes (BayFootprint), so a car at an angle is judged by its outline
+ - Cars whose footprint did not change since the last update cost nothing
+ - Optional hysteresis: a parked car only leaves once it is outside the bay
+   grown by a margin, so a car on the edge does not flicker in and out
+ - Each update also sweeps the car from its last footprint to the new one;
+   a sweep across a bay another car is parked in marks the car's path as
+   not clear until it next leaves a bay, so a car cannot tunnel through a
+   parked neighbour between ticks and still count as cleanly parked
+ - queryBays() only reads the bays and cells, so views can be queried while
+   another thread updates the cars (never while setBays() runs); the bay
+   list lives in the caller's frame arena
+ - Editing: addBay() and moveBay() touch only the cells of the bay's old
+   and new rectangle and keep every car; cars are judged again at their
+   next update, even one that did not move
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "FrameArena.hpp"
+#include "Parking.hpp"
+
+namespace sim {
+
+	class ParkingLot {
+	public:
+		/**
+		 * @brief Replaces the bays and clears all cars.
+		 *
+		 * MISRA: cellSize must be strictly positive; non-positive values use
+		 *        the size of the first bay.
+		 */
+		void setBays(std::vector<sf::FloatRect> bays, float cellSize);
+
+		/**
+		 * @brief Adds a bay, not occupied until a car's next update; returns its id (the old bayCount()).
+		 */
+		std::uint32_t addBay(const sf::FloatRect& rect);
+
+		/**
+		 * @brief Moves a bay to rect; the cars parked in it leave it (a flip in changedBays())
+		 *        and may park again at their next update.
+		 */
+		void moveBay(std::uint32_t bay, const sf::FloatRect& rect);
+
+		/**
+		 * @brief A car parked in a bay stays parked until it leaves the bay grown
+		 *        by margin on every side (0 = leave as soon as it crosses the edge).
+		 */
+		void setHysteresis(float margin) noexcept { m_hysteresis = margin; }
+
+		/**
+		 * @brief Registers a car that is not parked anywhere yet; returns its id.
+		 */
+		[[nodiscard]] std::uint32_t addCar();
+
+		/**
+		 * @brief Moves a car and updates the occupancy of the bays it affects.
+		 */
+		void updateCar(std::uint32_t car, const OrientedRect& footprint);
+
+		/**
+		 * @brief False once the car swept across a bay another car was parked
+		 *        in, since it last left a bay.
+		 */
+		[[nodiscard]] bool pathClear(std::uint32_t car) const { return m_cars[car].pathClear; }
+
+		[[nodiscard]] bool occupied(std::uint32_t bay) const { return m_occupants[bay] != 0U; }
+		[[nodiscard]] std::size_t occupiedCount() const noexcept { return m_occupiedCount; }
+		[[nodiscard]] std::size_t bayCount() const noexcept { return m_bays.size(); }
+		[[nodiscard]] const sf::FloatRect& bay(std::uint32_t bay) const { return m_bays[bay]; }
+
+		/**
+		 * @brief Bays that intersect area (e.g. the visible view), ascending,
+		 *        allocated from arena.
+		 *
+		 * Only the cells covering area are visited, so the cost does not grow
+		 * with the size of the lot.
+		 */
+		[[nodiscard]] ArenaSpan<std::uint32_t> queryBays(const sf::FloatRect& area, FrameArena& arena) const;
+
+		/**
+		 * @brief Bays whose occupied state flipped since the last clearChanged().
+		 */
+		[[nodiscard]] const std::vector<std::uint32_t>& changedBays() const noexcept { return m_changed; }
+		void clearChanged() { m_changed.clear(); }
+
+	private:
+		struct CarEntry {
+			OrientedRect footprint;
+			bool placed = false;
+			bool pathClear = true;
+			std::vector<std::uint32_t> parkedIn; // bays this car lies fully inside
+		};
+
+		[[nodiscard]] static std::uint64_t cellKey(int cx, int cy);
+		[[nodiscard]] int toCell(float coord) const;
+		void setParked(CarEntry& entry, std::uint32_t bay, bool parked);
+
+		// Lists the bay in (or removes it from) the cells its rectangle covers, ascending per cell
+		void indexBay(std::uint32_t bay);
+		void unindexBay(std::uint32_t bay);
+
+		// Every car is judged again at its next update, moved or not
+		void requeueCars();
+
+		std::vector<sf::FloatRect> m_bays;
+		std::vector<BayFootprint> m_footprints; // one per bay
+		std::vector<std::uint16_t> m_occupants; // cars fully inside each bay
+		std::size_t m_occupiedCount = 0U;
+
+		float m_invCellSize = 1.0F;
+		float m_hysteresis = 0.0F;
+		std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells;
+
+		std::vector<CarEntry> m_cars;
+		std::vector<std::uint32_t> m_changed;
+
+		// Per-update dedup of bays reached through several cells
+		std::vector<std::uint32_t> m_visited;
+		std::uint32_t m_visitStamp = 0U;
+	};
+
+	/**
+	 * @brief Grid of equally sized bays, row-major from origin, gap pixels apart.
+	 */
+	[[nodiscard]] std::vector<sf::FloatRect> layoutBays(const sf::Vector2f& origin, const sf::Vector2f& baySize,
+		std::uint32_t columns, std::uint32_t rows, float gap);
+
+} // namespace sim
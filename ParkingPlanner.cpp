@@ -0,0 +1,484 @@
+#include "ParkingPlanner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Collision.hpp"
+#include "FastTrig.hpp"
+#include "Parking.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr float PLAN_UNREACHED = std::numeric_limits<float>::max();
+
+		// Largest lattice (cells x heading bins) a query may allocate: 8M entries = 64 MB
+		constexpr std::size_t MAX_LATTICE_ENTRIES = 8U * 1024U * 1024U;
+
+		// Holonomic grid cells: not yet tested, clear of obstacles, touching one
+		constexpr std::uint8_t CELL_UNKNOWN = 0U;
+		constexpr std::uint8_t CELL_FREE = 1U;
+		constexpr std::uint8_t CELL_BLOCKED = 2U;
+
+		constexpr float SQRT2 = 1.41421356F;
+
+		[[nodiscard]] float wrapDeg(float deg) noexcept {
+			const float wrapped = std::fmod(deg, 360.0F);
+			return (wrapped < 0.0F) ? wrapped + 360.0F : wrapped;
+		}
+
+		[[nodiscard]] float headingErrorDeg(float a, float b) noexcept {
+			const float delta = wrapDeg(a - b);
+			return std::min(delta, 360.0F - delta);
+		}
+
+		[[nodiscard]] bool reverses(CarInput input) noexcept {
+			return (input & input::BACKWARD) != 0U;
+		}
+
+		// Min-heap on f for std::push_heap / std::pop_heap
+		template <typename Entry>
+		[[nodiscard]] bool laterEntry(const Entry& a, const Entry& b) noexcept {
+			return a.f > b.f;
+		}
+	}
+
+	ParkingPlanner::ParkingPlanner(const PlannerConfig& config)
+		: m_config(config)
+	{
+		m_config.headingBins = std::max(m_config.headingBins, 1U);
+		m_config.cellSize = (m_config.cellSize > 0.0F) ? m_config.cellSize : 1.0F;
+		m_config.checkTicks = std::max(m_config.checkTicks, 1U);
+
+		// Forward and reverse, straight or steering; short steering bursts line up the heading
+		for (const CarInput direction : { input::FORWARD, input::BACKWARD }) {
+			m_primitives.push_back({ direction, m_config.primitiveTicks });
+			for (const CarInput steer : { input::LEFT, input::RIGHT }) {
+				m_primitives.push_back({ static_cast<CarInput>(direction | steer), m_config.primitiveTicks });
+				if (m_config.fineTicks > 0U && m_config.fineTicks < m_config.primitiveTicks) {
+					m_primitives.push_back({ static_cast<CarInput>(direction | steer), m_config.fineTicks });
+				}
+			}
+		}
+	}
+
+	float ParkingPlanner::primitiveCost(CarInput input, CarInput parentInput, std::uint32_t ticks) const {
+		float cost = m_config.car.speed * m_config.tickDt * static_cast<float>(ticks);
+		if (reverses(input)) {
+			cost *= m_config.reversePenalty;
+		}
+		if ((input & (input::LEFT | input::RIGHT)) != 0U) {
+			cost *= m_config.steerPenalty;
+		}
+		if (parentInput != 0U && reverses(parentInput) != reverses(input)) {
+			cost += m_config.switchPenalty;
+		}
+		return cost;
+	}
+
+	void ParkingPlanner::buildHeuristicTable() {
+		const float cell = m_config.cellSize;
+		const int half = static_cast<int>(std::ceil(m_config.tableRadius / cell));
+		m_tableCells = 2 * half + 1;
+		const std::size_t bins = m_config.headingBins;
+		m_table.assign(static_cast<std::size_t>(m_tableCells) * static_cast<std::size_t>(m_tableCells) * bins, PLAN_UNREACHED);
+
+		// Every primitive from the origin once; the arcade model turns the same at any pose
+		struct Delta {
+			float x;
+			float y;
+			float headingDeg;
+			float cost;
+		};
+		std::vector<Delta> deltas;
+		for (const Primitive& primitive : m_primitives) {
+			CarState pose;
+			for (std::uint32_t t = 0U; t < primitive.ticks; ++t) {
+				stepCar(pose, primitive.input, m_config.car, m_config.tickDt);
+			}
+			deltas.push_back({ pose.position.x, pose.position.y, pose.headingDeg,
+				primitiveCost(primitive.input, 0U, primitive.ticks) });
+		}
+
+		const auto tableKey = [&](float x, float y, float headingDeg, std::size_t& key) {
+			const int cx = static_cast<int>(std::lround(x / cell)) + half;
+			const int cy = static_cast<int>(std::lround(y / cell)) + half;
+			if (cx < 0 || cy < 0 || cx >= m_tableCells || cy >= m_tableCells) {
+				return false;
+			}
+			const std::size_t bin = static_cast<std::size_t>(wrapDeg(headingDeg) * static_cast<float>(bins) / 360.0F) % bins;
+			key = (static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_tableCells) + static_cast<std::size_t>(cx)) * bins + bin;
+			return true;
+		};
+
+		// Dijkstra from the origin over continuous poses, keyed by the table entry they fall in
+		struct TableNode {
+			float x;
+			float y;
+			float headingDeg;
+		};
+		std::vector<TableNode> nodes{ { 0.0F, 0.0F, 0.0F } };
+		std::vector<OpenEntry> open{ { 0.0F, 0U } };
+		std::size_t key = 0U;
+		(void)tableKey(0.0F, 0.0F, 0.0F, key);
+		m_table[key] = 0.0F;
+
+		while (!open.empty()) {
+			std::pop_heap(open.begin(), open.end(), laterEntry<OpenEntry>);
+			const OpenEntry entry = open.back();
+			open.pop_back();
+			const TableNode node = nodes[entry.node];
+			if (!tableKey(node.x, node.y, node.headingDeg, key) || entry.f > m_table[key]) {
+				continue; // a cheaper pose has claimed the entry since
+			}
+
+			const SinCos heading = sinCosDeg(node.headingDeg);
+			for (const Delta& delta : deltas) {
+				const TableNode next{
+					node.x + heading.cos * delta.x - heading.sin * delta.y,
+					node.y + heading.sin * delta.x + heading.cos * delta.y,
+					node.headingDeg + delta.headingDeg
+				};
+				const float cost = entry.f + delta.cost;
+				std::size_t nextKey = 0U;
+				if (!tableKey(next.x, next.y, next.headingDeg, nextKey) || cost >= m_table[nextKey]) {
+					continue;
+				}
+				m_table[nextKey] = cost;
+				nodes.push_back(next);
+				open.push_back({ cost, static_cast<std::uint32_t>(nodes.size() - 1U) });
+				std::push_heap(open.begin(), open.end(), laterEntry<OpenEntry>);
+			}
+		}
+	}
+
+	void ParkingPlanner::buildGoalDistances(const CarState& goal, const CollisionWorld& world) {
+		const std::size_t cells = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+		m_goalDistance.assign(cells, PLAN_UNREACHED);
+		m_cellState.assign(cells, CELL_UNKNOWN);
+		m_gridOpen.clear();
+
+		const float cell = m_config.cellSize;
+		const sf::Vector2f cellHalf{ cell * 0.5F, cell * 0.5F };
+		const auto blocked = [&](int cx, int cy) {
+			std::uint8_t& state = m_cellState[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(cx)];
+			if (state == CELL_UNKNOWN) {
+				const CarState probe{ m_area.position + sf::Vector2f{ (static_cast<float>(cx) + 0.5F) * cell,
+					(static_cast<float>(cy) + 0.5F) * cell }, 0.0F };
+				state = world.overlaps(probe, cellHalf, m_scratch) ? CELL_BLOCKED : CELL_FREE;
+			}
+			return state == CELL_BLOCKED;
+		};
+
+		const int goalX = std::clamp(static_cast<int>((goal.position.x - m_area.position.x) / cell), 0, m_cols - 1);
+		const int goalY = std::clamp(static_cast<int>((goal.position.y - m_area.position.y) / cell), 0, m_rows - 1);
+		const std::uint32_t goalCell = static_cast<std::uint32_t>(goalY * m_cols + goalX);
+		m_goalDistance[goalCell] = 0.0F;
+		m_gridOpen.push_back({ 0.0F, goalCell });
+
+		constexpr int NEIGHBOURS[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+		while (!m_gridOpen.empty()) {
+			std::pop_heap(m_gridOpen.begin(), m_gridOpen.end(), laterEntry<OpenEntry>);
+			const OpenEntry entry = m_gridOpen.back();
+			m_gridOpen.pop_back();
+			if (entry.f > m_goalDistance[entry.node]) {
+				continue;
+			}
+
+			const int cx = static_cast<int>(entry.node) % m_cols;
+			const int cy = static_cast<int>(entry.node) / m_cols;
+			for (std::size_t n = 0U; n < 8U; ++n) {
+				const int nx = cx + NEIGHBOURS[n][0];
+				const int ny = cy + NEIGHBOURS[n][1];
+				if (nx < 0 || ny < 0 || nx >= m_cols || ny >= m_rows || blocked(nx, ny)) {
+					continue;
+				}
+				const float distance = entry.f + ((n < 4U) ? cell : cell * SQRT2);
+				const std::uint32_t next = static_cast<std::uint32_t>(ny * m_cols + nx);
+				if (distance < m_goalDistance[next]) {
+					m_goalDistance[next] = distance;
+					m_gridOpen.push_back({ distance, next });
+					std::push_heap(m_gridOpen.begin(), m_gridOpen.end(), laterEntry<OpenEntry>);
+				}
+			}
+		}
+	}
+
+	float ParkingPlanner::heuristic(const CarState& pose, const CarState& goal) const {
+		const sf::Vector2f offset = goal.position - pose.position;
+		float estimate = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+
+		// Obstacle-free cost of the same primitives, with the goal seen from the pose
+		const SinCos heading = sinCosDeg(pose.headingDeg);
+		const float localX = heading.cos * offset.x + heading.sin * offset.y;
+		const float localY = -heading.sin * offset.x + heading.cos * offset.y;
+		const int half = m_tableCells / 2;
+		const int tx = static_cast<int>(std::lround(localX / m_config.cellSize)) + half;
+		const int ty = static_cast<int>(std::lround(localY / m_config.cellSize)) + half;
+		if (tx >= 0 && ty >= 0 && tx < m_tableCells && ty < m_tableCells) {
+			const std::size_t bins = m_config.headingBins;
+			const std::size_t bin = static_cast<std::size_t>(wrapDeg(goal.headingDeg - pose.headingDeg)
+				* static_cast<float>(bins) / 360.0F) % bins;
+			const float table = m_table[(static_cast<std::size_t>(ty) * static_cast<std::size_t>(m_tableCells) + static_cast<std::size_t>(tx)) * bins + bin];
+			if (table < PLAN_UNREACHED) {
+				estimate = std::max(estimate, table);
+			}
+		}
+
+		// Distance around the obstacles; one cell diagonal of slack for the grid's coarseness
+		const int cx = static_cast<int>((pose.position.x - m_area.position.x) / m_config.cellSize);
+		const int cy = static_cast<int>((pose.position.y - m_area.position.y) / m_config.cellSize);
+		if (cx >= 0 && cy >= 0 && cx < m_cols && cy < m_rows) {
+			const float around = m_goalDistance[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(cx)];
+			if (around < PLAN_UNREACHED) {
+				estimate = std::max(estimate, around - m_config.cellSize * SQRT2);
+			}
+		}
+		return estimate;
+	}
+
+	bool ParkingPlanner::latticeKey(const CarState& pose, std::size_t& key) const {
+		const int cx = static_cast<int>(std::floor((pose.position.x - m_area.position.x) / m_config.cellSize));
+		const int cy = static_cast<int>(std::floor((pose.position.y - m_area.position.y) / m_config.cellSize));
+		if (cx < 0 || cy < 0 || cx >= m_cols || cy >= m_rows) {
+			return false;
+		}
+		const std::size_t bins = m_config.headingBins;
+		const std::size_t bin = static_cast<std::size_t>(wrapDeg(pose.headingDeg) * static_cast<float>(bins) / 360.0F) % bins;
+		key = (static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols) + static_cast<std::size_t>(cx)) * bins + bin;
+		return true;
+	}
+
+	bool ParkingPlanner::drive(CarState& pose, CarInput input, std::uint32_t ticks, const CollisionWorld& world) {
+		const sf::Vector2f areaEnd = m_area.position + m_area.size;
+		for (std::uint32_t t = 1U; t <= ticks; ++t) {
+			stepCar(pose, input, m_config.car, m_config.tickDt);
+			if ((t % m_config.checkTicks) != 0U && t != ticks) {
+				continue;
+			}
+
+			const sf::FloatRect bounds = carBounds(pose, m_halfExtent);
+			const sf::Vector2f boundsEnd = bounds.position + bounds.size;
+			if (bounds.position.x < m_area.position.x || bounds.position.y < m_area.position.y
+				|| boundsEnd.x > areaEnd.x || boundsEnd.y > areaEnd.y
+				|| world.overlaps(pose, m_halfExtent, m_scratch)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool ParkingPlanner::reachedGoal(const CarState& pose, const ParkingGoal& goal) const {
+		return headingErrorDeg(pose.headingDeg, goal.pose.headingDeg) <= m_config.headingToleranceDeg
+			&& parkOccupied(carBounds(pose, m_halfExtent), goal.bay);
+	}
+
+	bool ParkingPlanner::straightApproach(std::uint32_t from, const ParkingGoal& goal, const CollisionWorld& world) {
+		const Node node = m_nodes[from];
+		if (headingErrorDeg(node.pose.headingDeg, goal.pose.headingDeg) > m_config.headingToleranceDeg) {
+			return false;
+		}
+
+		// The goal must lie close to the line the car drives along
+		const sf::Vector2f offset = goal.pose.position - node.pose.position;
+		const SinCos heading = sinCosDeg(node.pose.headingDeg);
+		const float along = heading.cos * offset.x + heading.sin * offset.y;
+		const float across = -heading.sin * offset.x + heading.cos * offset.y;
+		if (std::fabs(across) > m_config.approachTolerance) {
+			return false;
+		}
+
+		const float step = m_config.car.speed * m_config.tickDt;
+		const std::uint32_t ticks = static_cast<std::uint32_t>(std::lround(std::fabs(along) / step));
+		const CarInput input = (along >= 0.0F) ? input::FORWARD : input::BACKWARD;
+		CarState pose = node.pose;
+		if (ticks == 0U || !drive(pose, input, ticks, world) || !reachedGoal(pose, goal)) {
+			return false;
+		}
+
+		m_nodes.push_back({ pose, node.g + primitiveCost(input, node.input, ticks), from, input, ticks });
+		return true;
+	}
+
+	void ParkingPlanner::addNode(const Node& node, float h) {
+		m_nodes.push_back(node);
+		m_open.push_back({ node.g + m_config.heuristicWeight * h, static_cast<std::uint32_t>(m_nodes.size() - 1U) });
+		std::push_heap(m_open.begin(), m_open.end(), laterEntry<OpenEntry>);
+	}
+
+	void ParkingPlanner::extractPath(std::uint32_t last, PlannedPath& path) const {
+		std::uint32_t count = 0U;
+		for (std::uint32_t i = last; i != 0U; i = m_nodes[i].parent) {
+			++count;
+		}
+		path.poses.resize(count);
+		std::size_t ticks = 0U;
+		for (std::uint32_t i = last; i != 0U; i = m_nodes[i].parent) {
+			path.poses[--count] = m_nodes[i].pose;
+			ticks += m_nodes[i].ticks;
+		}
+
+		// Inputs in driving order: walk the chain again, filling from the back
+		path.inputs.resize(ticks);
+		for (std::uint32_t i = last; i != 0U; i = m_nodes[i].parent) {
+			ticks -= m_nodes[i].ticks;
+			std::fill_n(path.inputs.begin() + static_cast<std::ptrdiff_t>(ticks), m_nodes[i].ticks, m_nodes[i].input);
+		}
+		path.cost = m_nodes[last].g;
+		path.found = true;
+	}
+
+	bool ParkingPlanner::plan(const CarState& start, const ParkingGoal& goal, const sf::Vector2f& halfExtent,
+		const CollisionWorld& world, const sf::FloatRect& area, PlannedPath& path, const std::atomic<bool>* cancel)
+	{
+		path.start = start;
+		path.inputs.clear();
+		path.poses.clear();
+		path.found = false;
+		path.expansions = 0U;
+		path.cost = 0.0F;
+
+		if (m_table.empty()) {
+			buildHeuristicTable();
+		}
+
+		m_area = area;
+		m_halfExtent = halfExtent;
+		m_cols = static_cast<int>(std::ceil(area.size.x / m_config.cellSize));
+		m_rows = static_cast<int>(std::ceil(area.size.y / m_config.cellSize));
+		if (m_cols <= 0 || m_rows <= 0) {
+			return false;
+		}
+		const std::size_t entries = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows) * m_config.headingBins;
+		if (entries > MAX_LATTICE_ENTRIES) {
+			return false;
+		}
+
+		// Reuse the lattice: entries from older queries carry an older generation
+		if (m_stamp.size() < entries) {
+			m_stamp.assign(entries, 0U);
+			m_bestG.resize(entries);
+		}
+		if (++m_generation == 0U) {
+			std::fill(m_stamp.begin(), m_stamp.end(), 0U);
+			m_generation = 1U;
+		}
+
+		CarState goalPose = goal.pose;
+		if (!drive(goalPose, 0U, 1U, world)) {
+			return false; // no room for the car at the goal
+		}
+		buildGoalDistances(goal.pose, world);
+
+		m_nodes.clear();
+		m_open.clear();
+		std::size_t key = 0U;
+		if (!latticeKey(start, key)) {
+			return false;
+		}
+		m_stamp[key] = m_generation;
+		m_bestG[key] = 0.0F;
+		addNode({ start, 0.0F, 0U, 0U, 0U }, heuristic(start, goal.pose));
+
+		while (!m_open.empty() && path.expansions < m_config.maxExpansions) {
+			if (cancel != nullptr && cancel->load(std::memory_order_relaxed)) {
+				return false;
+			}
+
+			std::pop_heap(m_open.begin(), m_open.end(), laterEntry<OpenEntry>);
+			const std::uint32_t current = m_open.back().node;
+			m_open.pop_back();
+			const Node node = m_nodes[current];
+			(void)latticeKey(node.pose, key);
+			if (m_bestG[key] < node.g) {
+				continue; // expanded already, or a cheaper pose reached the entry since
+			}
+			m_bestG[key] = -1.0F;
+			++path.expansions;
+
+			if (reachedGoal(node.pose, goal)) {
+				extractPath(current, path);
+				return true;
+			}
+			if (straightApproach(current, goal, world)) {
+				extractPath(static_cast<std::uint32_t>(m_nodes.size() - 1U), path);
+				return true;
+			}
+
+			for (const Primitive& primitive : m_primitives) {
+				CarState pose = node.pose;
+				if (!drive(pose, primitive.input, primitive.ticks, world)) {
+					continue;
+				}
+				std::size_t nextKey = 0U;
+				if (!latticeKey(pose, nextKey)) {
+					continue;
+				}
+				const float g = node.g + primitiveCost(primitive.input, node.input, primitive.ticks);
+				if (m_stamp[nextKey] == m_generation && (m_bestG[nextKey] < 0.0F || m_bestG[nextKey] <= g)) {
+					continue;
+				}
+				m_stamp[nextKey] = m_generation;
+				m_bestG[nextKey] = g;
+				addNode({ pose, g, current, primitive.input, primitive.ticks }, heuristic(pose, goal.pose));
+			}
+		}
+		return false;
+	}
+
+	ParkingGoal bayGoal(const sf::FloatRect& bay, float headingDeg) {
+		ParkingGoal goal;
+		goal.bay = bay;
+		goal.pose.position = bay.position + bay.size * 0.5F;
+
+		// The car's long axis is its local X: lie along the bay's longer side
+		const float along = (bay.size.y > bay.size.x) ? 90.0F : 0.0F;
+		goal.pose.headingDeg = (headingErrorDeg(headingDeg, along) <= 90.0F) ? along : along + 180.0F;
+		return goal;
+	}
+
+	AsyncParkingPlanner::AsyncParkingPlanner(ThreadPool& pool, const PlannerConfig& config)
+		: m_pool(pool)
+		, m_planner(config)
+	{
+	}
+
+	AsyncParkingPlanner::~AsyncParkingPlanner() {
+		cancel();
+	}
+
+	bool AsyncParkingPlanner::request(const CarState& start, const ParkingGoal& goal, const sf::Vector2f& halfExtent,
+		const CollisionWorld& world, const sf::FloatRect& area)
+	{
+		if (m_pending) {
+			return false;
+		}
+		m_pending = true;
+		m_cancel.store(false, std::memory_order_relaxed);
+		m_pool.submit(m_group, [this, start, goal, halfExtent, &world, area]() {
+			(void)m_planner.plan(start, goal, halfExtent, world, area, m_result, &m_cancel);
+		});
+		return true;
+	}
+
+	bool AsyncParkingPlanner::poll(PlannedPath& path) {
+		// done() acquires the task's writes to the result
+		if (!m_pending || !m_group.done()) {
+			return false;
+		}
+		m_pending = false;
+		std::swap(path, m_result); // both keep their buffers for the next query
+		return true;
+	}
+
+	void AsyncParkingPlanner::cancel() {
+		if (!m_pending) {
+			return;
+		}
+		m_cancel.store(true, std::memory_order_relaxed);
+		m_pool.wait(m_group);
+		m_pending = false;
+	}
+
+} // namespace sim
@@ -0,0 +1,193 @@
+/*
+==============================================================================
+Parking Planner - hybrid A* search for a drivable path into a bay
+==============================================================================
+ - Motion primitives are short bursts of the car's own controls (forward or
+   reverse, straight or steering), integrated with stepCar() tick by tick,
+   so the planned input sequence replays exactly as the simulation drives it
+ - States are continuous; a lattice of position cells x heading bins only
+   prunes duplicates. Every primitive is swept against the collision world
+   and must keep the car footprint inside the drivable area
+ - Heuristic: the larger of a precomputed obstacle-free table (cost of the
+   same primitives from the origin to every nearby relative pose, looked up
+   in the frame of the state) and a per-query grid distance to the goal
+   around the obstacles; a straight final approach is tried analytically
+ - Buffers (nodes, open list, lattice stamps, heuristic grids) are kept
+   between queries; the lattice is reset by bumping a generation counter
+ - AsyncParkingPlanner runs queries on the shared job system and is polled
+   from the frame loop, so planning never blocks a frame
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "FrameArena.hpp"
+#include "SimFwd.hpp"
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	struct PlannerConfig {
+		CarParams car;                      // arcade model the plan is driven with
+		float tickDt = 1.0F / 240.0F;       // must match the simulation's fixed tick
+		std::uint32_t primitiveTicks = 24U; // ticks per motion primitive
+		std::uint32_t fineTicks = 8U;       // short steering primitives that line up the heading
+		std::uint32_t checkTicks = 4U;      // collision check spacing inside a primitive
+		float cellSize = 16.0F;             // lattice position cell edge
+		std::uint32_t headingBins = 72U;    // lattice heading bins (5 degrees)
+		std::uint32_t maxExpansions = 100000U;
+		float reversePenalty = 1.5F;        // cost factor of driving backwards
+		float steerPenalty = 1.05F;         // cost factor of steering
+		float switchPenalty = 120.0F;       // added on every change between forward and reverse
+		float heuristicWeight = 1.5F;       // > 1 trades path optimality for fewer expansions
+		float headingToleranceDeg = 8.0F;   // heading error allowed at the goal
+		float approachTolerance = 24.0F;    // sideways offset a straight final approach may start from
+		float tableRadius = 512.0F;         // extent of the obstacle-free heuristic table
+	};
+
+	// Where the car should end up: the pose steers the search, the bay decides arrival
+	struct ParkingGoal {
+		CarState pose;
+		sf::FloatRect bay; // the car bounds must lie inside it (as parkOccupied() checks)
+	};
+
+	// Result of one query; inputs replay the path one fixed tick each
+	struct PlannedPath {
+		CarState start;
+		std::vector<CarInput> inputs;
+		std::vector<CarState> poses; // pose at the end of every primitive, start excluded
+		bool found = false;
+		std::uint32_t expansions = 0U;
+		float cost = 0.0F;
+	};
+
+	class ParkingPlanner {
+	public:
+		explicit ParkingPlanner(const PlannerConfig& config = {});
+
+		/**
+		 * @brief Searches for a collision-free path from start into the goal bay.
+		 *
+		 * The car rectangle (halfExtent) must stay inside area the whole way
+		 * and end inside goal.bay, within the heading tolerance of goal.pose.
+		 * Returns false with path.found unset if the goal is blocked, the area
+		 * is too large for the lattice, the expansion budget runs out or cancel
+		 * is raised. The first call also builds the heuristic table.
+		 */
+		bool plan(const CarState& start, const ParkingGoal& goal, const sf::Vector2f& halfExtent,
+			const CollisionWorld& world, const sf::FloatRect& area, PlannedPath& path,
+			const std::atomic<bool>* cancel = nullptr);
+
+		[[nodiscard]] const PlannerConfig& config() const noexcept { return m_config; }
+
+	private:
+		struct Node {
+			CarState pose;
+			float g = 0.0F;
+			std::uint32_t parent = 0U;
+			CarInput input = 0U;
+			std::uint32_t ticks = 0U;
+		};
+
+		struct OpenEntry {
+			float f = 0.0F;
+			std::uint32_t node = 0U;
+		};
+
+		struct Primitive {
+			CarInput input = 0U;
+			std::uint32_t ticks = 0U;
+		};
+
+		void buildHeuristicTable();
+		void buildGoalDistances(const CarState& goal, const CollisionWorld& world);
+		[[nodiscard]] float heuristic(const CarState& pose, const CarState& goal) const;
+		[[nodiscard]] bool latticeKey(const CarState& pose, std::size_t& key) const;
+		[[nodiscard]] bool drive(CarState& pose, CarInput input, std::uint32_t ticks, const CollisionWorld& world);
+		[[nodiscard]] bool reachedGoal(const CarState& pose, const ParkingGoal& goal) const;
+		[[nodiscard]] float primitiveCost(CarInput input, CarInput parentInput, std::uint32_t ticks) const;
+		[[nodiscard]] bool straightApproach(std::uint32_t from, const ParkingGoal& goal, const CollisionWorld& world);
+		void addNode(const Node& node, float h);
+		void extractPath(std::uint32_t last, PlannedPath& path) const;
+
+		PlannerConfig m_config;
+		std::vector<Primitive> m_primitives;
+
+		// Obstacle-free cost from the origin to relative poses: tableCells^2 x headingBins
+		std::vector<float> m_table;
+		int m_tableCells = 0;
+
+		// Per-query lattice over the drivable area
+		sf::FloatRect m_area;
+		sf::Vector2f m_halfExtent;
+		int m_cols = 0;
+		int m_rows = 0;
+		std::uint32_t m_generation = 0U;
+		std::vector<std::uint32_t> m_stamp; // m_generation marks entries valid for this query
+		std::vector<float> m_bestG;         // best cost seen per entry, negative once expanded
+
+		std::vector<float> m_goalDistance;     // grid distance to the goal around obstacles, per cell
+		std::vector<std::uint8_t> m_cellState; // per cell: unknown, free or blocked
+		std::vector<OpenEntry> m_gridOpen;
+
+		std::vector<Node> m_nodes;
+		std::vector<OpenEntry> m_open;
+		FrameArena m_scratch;
+	};
+
+	/**
+	 * @brief Goal pose centred in bay, lengthwise, facing the end closest to heading.
+	 */
+	[[nodiscard]] ParkingGoal bayGoal(const sf::FloatRect& bay, float headingDeg);
+
+	/**
+	 * @brief One planner behind the job system: at most one query in flight.
+	 *
+	 * The collision world handed to request() must stay unchanged until the
+	 * query is polled or cancel() returns.
+	 */
+	class AsyncParkingPlanner {
+	public:
+		AsyncParkingPlanner(ThreadPool& pool, const PlannerConfig& config = {});
+		~AsyncParkingPlanner();
+
+		AsyncParkingPlanner(const AsyncParkingPlanner&) = delete;
+		AsyncParkingPlanner& operator=(const AsyncParkingPlanner&) = delete;
+
+		/**
+		 * @brief Queues a query; false if one is still running.
+		 */
+		bool request(const CarState& start, const ParkingGoal& goal, const sf::Vector2f& halfExtent,
+			const CollisionWorld& world, const sf::FloatRect& area);
+
+		/**
+		 * @brief Hands over a finished query once; false while running or idle.
+		 */
+		bool poll(PlannedPath& path);
+
+		/**
+		 * @brief Stops a running query early and waits for it (the result is dropped).
+		 */
+		void cancel();
+
+		[[nodiscard]] bool busy() const noexcept { return m_pending; }
+
+	private:
+		ThreadPool& m_pool;
+		TaskGroup m_group;
+		ParkingPlanner m_planner;
+		PlannedPath m_result;
+		std::atomic<bool> m_cancel{ false };
+		bool m_pending = false;
+	};
+
+} // namespace sim
@@ -0,0 +1,42 @@
+/*
+==============================================================================
+Pixel Font - the built-in 3x5 bitmap font shared by the overlays
+==============================================================================
+ - Digits, upper-case letters and a little punctuation, so no font asset
+   has to ship with the sample
+ - Each glyph is PIXEL_GLYPH_WIDTH x PIXEL_GLYPH_HEIGHT lit/unlit pixels,
+   rows top to bottom
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace gfx {
+
+	constexpr int PIXEL_GLYPH_WIDTH = 3;
+	constexpr int PIXEL_GLYPH_HEIGHT = 5;
+
+	struct PixelGlyph {
+		char c;
+		const char* rows; // PIXEL_GLYPH_WIDTH * PIXEL_GLYPH_HEIGHT chars, '1' = lit pixel
+	};
+
+	/**
+	 * @brief Number of glyphs in the font.
+	 */
+	[[nodiscard]] std::size_t pixelGlyphCount() noexcept;
+
+	/**
+	 * @brief Glyph by index, in font order.
+	 * MISRA: index must be below pixelGlyphCount().
+	 */
+	[[nodiscard]] const PixelGlyph& pixelGlyph(std::size_t index) noexcept;
+
+	/**
+	 * @brief Rows of c, or nullptr for space and characters the font lacks.
+	 */
+	[[nodiscard]] const char* pixelGlyphRows(char c) noexcept;
+
+} // namespace gfx
@@ -0,0 +1,234 @@
+#include "PngWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+
+#include "SoftRasterizer.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr std::uint8_t PNG_SIGNATURE[] = { 0x89U, 'P', 'N', 'G', '\r', '\n', 0x1AU, '\n' };
+
+		// Deflate limits: matches of 3..258 bytes reaching at most 32 KiB back
+		constexpr std::size_t MIN_MATCH = 3U;
+		constexpr std::size_t MAX_MATCH = 258U;
+		constexpr std::size_t MAX_DISTANCE = 32768U;
+
+		// Length codes 257..285 and distance codes 0..29 (RFC 1951, 3.2.5)
+		constexpr std::uint16_t LENGTH_BASE[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		constexpr std::uint8_t LENGTH_EXTRA[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		constexpr std::uint16_t DISTANCE_BASE[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		constexpr std::uint8_t DISTANCE_EXTRA[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+			7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		// Index of the last base not above value
+		template <std::size_t N>
+		[[nodiscard]] std::size_t baseIndex(const std::uint16_t (&bases)[N], std::size_t value) noexcept {
+			std::size_t index = N - 1U;
+			while (bases[index] > value) {
+				--index;
+			}
+			return index;
+		}
+
+		// Deflate bit order: values LSB first, Huffman codes MSB first
+		class BitWriter {
+		public:
+			explicit BitWriter(std::vector<std::uint8_t>& out) : m_out(out) {}
+
+			void put(std::uint32_t value, std::uint32_t bits) {
+				m_bits |= static_cast<std::uint64_t>(value) << m_count;
+				m_count += bits;
+				while (m_count >= 8U) {
+					m_out.push_back(static_cast<std::uint8_t>(m_bits));
+					m_bits >>= 8U;
+					m_count -= 8U;
+				}
+			}
+
+			void putCode(std::uint32_t code, std::uint32_t bits) {
+				std::uint32_t reversed = 0U;
+				for (std::uint32_t i = 0U; i < bits; ++i) {
+					reversed = (reversed << 1U) | ((code >> i) & 1U);
+				}
+				put(reversed, bits);
+			}
+
+			// Fixed Huffman code of a literal/length symbol
+			void putSymbol(std::uint32_t symbol) {
+				if (symbol < 144U) {
+					putCode(0x30U + symbol, 8U);
+				}
+				else if (symbol < 256U) {
+					putCode(0x190U + symbol - 144U, 9U);
+				}
+				else if (symbol < 280U) {
+					putCode(symbol - 256U, 7U);
+				}
+				else {
+					putCode(0xC0U + symbol - 280U, 8U);
+				}
+			}
+
+			void flush() {
+				if (m_count > 0U) {
+					m_out.push_back(static_cast<std::uint8_t>(m_bits));
+				}
+				m_bits = 0U;
+				m_count = 0U;
+			}
+
+		private:
+			std::vector<std::uint8_t>& m_out;
+			std::uint64_t m_bits = 0U;
+			std::uint32_t m_count = 0U;
+		};
+
+		void deflateFixed(const std::vector<std::uint8_t>& data, std::size_t rowBytes, std::vector<std::uint8_t>& out) {
+			BitWriter writer(out);
+			writer.put(1U, 1U); // final block
+			writer.put(1U, 2U); // fixed Huffman codes
+
+			// One pixel back, and one row back while it is within reach
+			std::array<std::size_t, 2U> distances{ 4U, rowBytes };
+			const std::size_t candidates = (rowBytes <= MAX_DISTANCE) ? 2U : 1U;
+			std::array<std::size_t, 2U> distanceCodes{};
+			for (std::size_t c = 0U; c < candidates; ++c) {
+				distanceCodes[c] = baseIndex(DISTANCE_BASE, distances[c]);
+			}
+
+			const std::size_t size = data.size();
+			std::size_t i = 0U;
+			while (i < size) {
+				std::size_t bestLength = 0U;
+				std::size_t best = 0U;
+				const std::size_t limit = std::min(MAX_MATCH, size - i);
+				for (std::size_t c = 0U; c < candidates && bestLength < limit; ++c) {
+					const std::size_t distance = distances[c];
+					if (distance > i) {
+						continue;
+					}
+					std::size_t length = 0U;
+					while (length < limit && data[i + length] == data[i + length - distance]) {
+						++length;
+					}
+					if (length > bestLength) {
+						bestLength = length;
+						best = c;
+					}
+				}
+
+				if (bestLength < MIN_MATCH) {
+					writer.putSymbol(data[i]);
+					++i;
+					continue;
+				}
+				const std::size_t lengthCode = baseIndex(LENGTH_BASE, bestLength);
+				writer.putSymbol(257U + static_cast<std::uint32_t>(lengthCode));
+				writer.put(static_cast<std::uint32_t>(bestLength - LENGTH_BASE[lengthCode]), LENGTH_EXTRA[lengthCode]);
+				const std::size_t distanceCode = distanceCodes[best];
+				writer.putCode(static_cast<std::uint32_t>(distanceCode), 5U);
+				writer.put(static_cast<std::uint32_t>(distances[best] - DISTANCE_BASE[distanceCode]), DISTANCE_EXTRA[distanceCode]);
+				i += bestLength;
+			}
+			writer.putSymbol(256U); // end of block
+			writer.flush();
+		}
+
+		[[nodiscard]] std::uint32_t crc32(const std::uint8_t* data, std::size_t size) noexcept {
+			static const std::array<std::uint32_t, 256U> table = [] {
+				std::array<std::uint32_t, 256U> entries{};
+				for (std::uint32_t n = 0U; n < 256U; ++n) {
+					std::uint32_t c = n;
+					for (int k = 0; k < 8; ++k) {
+						c = ((c & 1U) != 0U) ? 0xEDB88320U ^ (c >> 1U) : c >> 1U;
+					}
+					entries[n] = c;
+				}
+				return entries;
+			}();
+			std::uint32_t crc = 0xFFFFFFFFU;
+			for (std::size_t i = 0U; i < size; ++i) {
+				crc = table[(crc ^ data[i]) & 0xFFU] ^ (crc >> 8U);
+			}
+			return crc ^ 0xFFFFFFFFU;
+		}
+
+		[[nodiscard]] std::uint32_t adler32(const std::vector<std::uint8_t>& data) noexcept {
+			constexpr std::uint32_t MOD_ADLER = 65521U;
+			constexpr std::size_t ADLER_RUN = 5552U; // bytes summed before the sums could overflow
+			std::uint32_t a = 1U;
+			std::uint32_t b = 0U;
+			for (std::size_t begin = 0U; begin < data.size(); begin += ADLER_RUN) {
+				const std::size_t end = std::min(begin + ADLER_RUN, data.size());
+				for (std::size_t i = begin; i < end; ++i) {
+					a += data[i];
+					b += a;
+				}
+				a %= MOD_ADLER;
+				b %= MOD_ADLER;
+			}
+			return (b << 16U) | a;
+		}
+
+		void putBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value) {
+			out.push_back(static_cast<std::uint8_t>(value >> 24U));
+			out.push_back(static_cast<std::uint8_t>(value >> 16U));
+			out.push_back(static_cast<std::uint8_t>(value >> 8U));
+			out.push_back(static_cast<std::uint8_t>(value));
+		}
+
+		// Length, type, data and the CRC of type and data
+		void appendChunk(std::vector<std::uint8_t>& out, const char (&type)[5], const std::vector<std::uint8_t>& data) {
+			putBigEndian(out, static_cast<std::uint32_t>(data.size()));
+			const std::size_t typeAt = out.size();
+			out.insert(out.end(), type, type + 4);
+			out.insert(out.end(), data.begin(), data.end());
+			putBigEndian(out, crc32(out.data() + typeAt, out.size() - typeAt));
+		}
+	}
+
+	std::vector<std::uint8_t> encodePng(const SoftImage& image) {
+		std::vector<std::uint8_t> header;
+		putBigEndian(header, image.width);
+		putBigEndian(header, image.height);
+		header.insert(header.end(), { 8U, 6U, 0U, 0U, 0U }); // 8 bits per channel, RGBA, deflate, no filter set, no interlace
+
+		// Each row is prefixed with its filter type, 0 (None)
+		const std::size_t stride = static_cast<std::size_t>(image.width) * 4U;
+		std::vector<std::uint8_t> rows;
+		rows.reserve((stride + 1U) * image.height);
+		for (std::uint32_t y = 0U; y < image.height; ++y) {
+			rows.push_back(0U);
+			const auto row = image.pixels.begin() + static_cast<std::ptrdiff_t>(y * stride);
+			rows.insert(rows.end(), row, row + static_cast<std::ptrdiff_t>(stride));
+		}
+
+		std::vector<std::uint8_t> compressed{ 0x78U, 0x01U }; // deflate, 32 KiB window
+		deflateFixed(rows, stride + 1U, compressed);
+		putBigEndian(compressed, adler32(rows));
+
+		std::vector<std::uint8_t> png(std::begin(PNG_SIGNATURE), std::end(PNG_SIGNATURE));
+		appendChunk(png, "IHDR", header);
+		appendChunk(png, "IDAT", compressed);
+		appendChunk(png, "IEND", {});
+		return png;
+	}
+
+	bool writePng(const std::string& path, const SoftImage& image) {
+		const std::vector<std::uint8_t> png = encodePng(image);
+		std::ofstream file(path, std::ios::binary);
+		if (!file || !file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()))) {
+			std::cerr << "Error: Failed to write PNG " << path << '\n';
+			return false;
+		}
+		return true;
+	}
+
+} // namespace gfx
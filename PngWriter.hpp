@@ -0,0 +1,35 @@
+/*
+==============================================================================
+PNG Writer - RGBA8 images to PNG files without an image library
+==============================================================================
+ - Writes 8-bit RGBA, non-interlaced, every row with filter type None
+ - The zlib stream is one fixed-Huffman deflate block. Matches are only
+   looked for one pixel back and one row back, which is where the flat
+   fills of a rasterized scene repeat, so encoding is a single pass with
+   no hash chains and a lot frame shrinks to a few percent of its size
+ - Output depends on the pixels alone, so equal images give equal files
+   and golden images can be compared byte for byte
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gfx {
+
+	struct SoftImage;
+
+	/**
+	 * @brief The PNG file of image, in memory.
+	 */
+	[[nodiscard]] std::vector<std::uint8_t> encodePng(const SoftImage& image);
+
+	/**
+	 * @brief Writes image to path as a PNG; false (logged) if the file cannot be written.
+	 */
+	[[nodiscard]] bool writePng(const std::string& path, const SoftImage& image);
+
+} // namespace gfx
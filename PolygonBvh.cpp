@@ -0,0 +1,302 @@
+#include "PolygonBvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace sim {
+
+	namespace {
+		constexpr float NO_POLYGON_HIT = std::numeric_limits<float>::max();
+
+		// Median splits halve the edges per level, so this covers any scene that fits in memory
+		constexpr std::size_t MAX_BVH_DEPTH = 64U;
+
+		// Slack on the deepest interior point, so a query exactly that deep still finds its edge
+		constexpr float DEPTH_SLACK = 1.0F;
+
+		[[nodiscard]] float cross(const sf::Vector2f& u, const sf::Vector2f& v) noexcept {
+			return u.x * v.y - u.y * v.x;
+		}
+
+		// Squared distance from query to the box, 0 inside it
+		[[nodiscard]] float boxDistanceSq(const sf::Vector2f& low, const sf::Vector2f& high, const sf::Vector2f& query) noexcept {
+			const float dx = std::max(std::max(low.x - query.x, query.x - high.x), 0.0F);
+			const float dy = std::max(std::max(low.y - query.y, query.y - high.y), 0.0F);
+			return dx * dx + dy * dy;
+		}
+
+		// Ray parameter where the ray enters the box, or NO_POLYGON_HIT if it misses within maxT
+		[[nodiscard]] float boxEntry(const sf::Vector2f& low, const sf::Vector2f& high, const sf::Vector2f& origin,
+			const sf::Vector2f& invDirection, float maxT) noexcept
+		{
+			const float x0 = (low.x - origin.x) * invDirection.x;
+			const float x1 = (high.x - origin.x) * invDirection.x;
+			const float y0 = (low.y - origin.y) * invDirection.y;
+			const float y1 = (high.y - origin.y) * invDirection.y;
+			// A 0 * inf NaN (origin on a flat box's plane) compares false and leaves the bound open
+			const float tMin = std::max({ 0.0F, std::min(x0, x1), std::min(y0, y1) });
+			const float tMax = std::min({ maxT, std::max(x0, x1), std::max(y0, y1) });
+			return (tMin <= tMax) ? tMin : NO_POLYGON_HIT;
+		}
+
+		// Pushes the children within bound, the nearer on top so it is searched first and tightens the bound for the other
+		template <typename Entry, std::size_t N>
+		void pushNearerLast(std::array<Entry, N>& stack, std::size_t& top, const Entry& left, const Entry& right,
+			float bound) noexcept
+		{
+			const bool leftFirst = left.key <= right.key;
+			const Entry& nearer = leftFirst ? left : right;
+			const Entry& farther = leftFirst ? right : left;
+			if (farther.key < bound) {
+				stack[top++] = farther;
+			}
+			if (nearer.key < bound) {
+				stack[top++] = nearer;
+			}
+		}
+	}
+
+	void PolygonSet::add(const std::vector<sf::Vector2f>& outline) {
+		if (outline.size() < 3U) {
+			return;
+		}
+		if (starts.empty()) {
+			starts.push_back(static_cast<std::uint32_t>(vertices.size()));
+		}
+		vertices.insert(vertices.end(), outline.begin(), outline.end());
+		starts.push_back(static_cast<std::uint32_t>(vertices.size()));
+	}
+
+	void PolygonBvh::build(const PolygonSet& polygons) {
+		m_edges.clear();
+		m_nodes.clear();
+		m_depthBoundSq = 0.0F;
+
+		std::vector<Edge> edges;
+		std::vector<sf::Vector2f> outline;
+		float maxDepth = 0.0F;
+		for (std::size_t p = 0U; p < polygons.size(); ++p) {
+			// Drop repeated vertices (a closing copy of the first included) so every edge has a length
+			outline.clear();
+			for (std::uint32_t v = polygons.starts[p]; v < polygons.starts[p + 1U]; ++v) {
+				if (outline.empty() || polygons.vertices[v] != outline.back()) {
+					outline.push_back(polygons.vertices[v]);
+				}
+			}
+			while (outline.size() > 1U && outline.back() == outline.front()) {
+				outline.pop_back();
+			}
+			if (outline.size() < 3U) {
+				continue;
+			}
+
+			float twiceArea = 0.0F;
+			sf::Vector2f low = outline.front();
+			sf::Vector2f high = low;
+			for (std::size_t v = 0U; v < outline.size(); ++v) {
+				twiceArea += cross(outline[v], outline[(v + 1U) % outline.size()]);
+				low = { std::min(low.x, outline[v].x), std::min(low.y, outline[v].y) };
+				high = { std::max(high.x, outline[v].x), std::max(high.y, outline[v].y) };
+			}
+			if (twiceArea == 0.0F) {
+				continue;
+			}
+			// Wind every outline so its inside is to the left of each edge
+			if (twiceArea < 0.0F) {
+				std::reverse(outline.begin(), outline.end());
+			}
+			// The inscribed circle fits in the bounding box
+			maxDepth = std::max(maxDepth, 0.5F * std::min(high.x - low.x, high.y - low.y));
+
+			const std::size_t n = outline.size();
+			for (std::size_t v = 0U; v < n; ++v) {
+				const sf::Vector2f& a = outline[v];
+				const sf::Vector2f along = outline[(v + 1U) % n] - a;
+				edges.push_back({ a, along, 1.0F / along.dot(along), static_cast<std::uint32_t>(p),
+					outline[(v + n - 1U) % n], outline[(v + 2U) % n] });
+			}
+		}
+		if (edges.empty()) {
+			return;
+		}
+
+		m_depthBoundSq = (maxDepth + DEPTH_SLACK) * (maxDepth + DEPTH_SLACK);
+		m_nodes.reserve(2U * (edges.size() / LEAF_EDGES + 1U));
+		(void)buildNode(edges, 0U, static_cast<std::uint32_t>(edges.size()));
+		m_edges.assign(edges.begin(), edges.end());
+	}
+
+	std::uint32_t PolygonBvh::buildNode(std::vector<Edge>& edges, std::uint32_t first, std::uint32_t last) {
+		Node node{ edges[first].a, edges[first].a, first, last - first };
+		sf::Vector2f centerLow = edges[first].a + edges[first].along * 0.5F;
+		sf::Vector2f centerHigh = centerLow;
+		for (std::uint32_t i = first; i < last; ++i) {
+			const sf::Vector2f b = edges[i].a + edges[i].along;
+			node.low = { std::min({ node.low.x, edges[i].a.x, b.x }), std::min({ node.low.y, edges[i].a.y, b.y }) };
+			node.high = { std::max({ node.high.x, edges[i].a.x, b.x }), std::max({ node.high.y, edges[i].a.y, b.y }) };
+			const sf::Vector2f center = edges[i].a + edges[i].along * 0.5F;
+			centerLow = { std::min(centerLow.x, center.x), std::min(centerLow.y, center.y) };
+			centerHigh = { std::max(centerHigh.x, center.x), std::max(centerHigh.y, center.y) };
+		}
+
+		const std::uint32_t index = static_cast<std::uint32_t>(m_nodes.size());
+		m_nodes.push_back(node);
+		if (node.count <= LEAF_EDGES) {
+			return index;
+		}
+
+		// Median split of the edge midpoints along the longer axis
+		const bool splitX = (centerHigh.x - centerLow.x) >= (centerHigh.y - centerLow.y);
+		const std::uint32_t middle = first + (last - first) / 2U;
+		std::nth_element(edges.begin() + first, edges.begin() + middle, edges.begin() + last,
+			[splitX](const Edge& l, const Edge& r) {
+				return splitX ? (2.0F * l.a.x + l.along.x) < (2.0F * r.a.x + r.along.x)
+					: (2.0F * l.a.y + l.along.y) < (2.0F * r.a.y + r.along.y);
+			});
+		(void)buildNode(edges, first, middle); // lands at index + 1
+		const std::uint32_t right = buildNode(edges, middle, last);
+		m_nodes[index].first = right;
+		m_nodes[index].count = 0U;
+		return index;
+	}
+
+	PolygonBvh::NearestEdge PolygonBvh::nearestEdge(const sf::Vector2f& query, float boundSq) const {
+		NearestEdge best;
+		best.distanceSq = boundSq;
+		float bestT = 0.0F;
+
+		// Each entry keeps its box distance, so a node popped after the bound tightened is dropped untouched
+		std::array<StackEntry, MAX_BVH_DEPTH> stack;
+		std::size_t top = 0U;
+		stack[top++] = { 0U, boxDistanceSq(m_nodes[0].low, m_nodes[0].high, query) };
+		while (top > 0U) {
+			const StackEntry entry = stack[--top];
+			if (entry.key >= best.distanceSq) {
+				continue;
+			}
+			const Node& node = m_nodes[entry.node];
+			if (node.count > 0U) {
+				for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+					const Edge& edge = m_edges[i];
+					const sf::Vector2f offset = query - edge.a;
+					const float t = std::clamp(offset.dot(edge.along) * edge.invLengthSq, 0.0F, 1.0F);
+					const sf::Vector2f gap = offset - edge.along * t;
+					const float distanceSq = gap.dot(gap);
+					if (distanceSq < best.distanceSq) {
+						best.distanceSq = distanceSq;
+						best.edge = i;
+						bestT = t;
+					}
+				}
+				continue;
+			}
+			const Node& left = m_nodes[entry.node + 1U];
+			const Node& right = m_nodes[node.first];
+			pushNearerLast(stack, top, { entry.node + 1U, boxDistanceSq(left.low, left.high, query) },
+				{ node.first, boxDistanceSq(right.low, right.high, query) }, best.distanceSq);
+		}
+
+		if (best.edge == NO_OBSTACLE) {
+			return best;
+		}
+
+		// Inside is to the left of every edge; at a corner, of both edges if convex, of either if reflex
+		const Edge& edge = m_edges[best.edge];
+		const sf::Vector2f b = edge.a + edge.along;
+		const bool leftOfEdge = cross(edge.along, query - edge.a) > 0.0F;
+		if (bestT <= 0.0F) {
+			const sf::Vector2f incoming = edge.a - edge.before;
+			const bool leftOfIncoming = cross(incoming, query - edge.before) > 0.0F;
+			best.inside = (cross(incoming, edge.along) > 0.0F) ? (leftOfIncoming && leftOfEdge)
+				: (leftOfIncoming || leftOfEdge);
+		}
+		else if (bestT >= 1.0F) {
+			const sf::Vector2f outgoing = edge.after - b;
+			const bool leftOfOutgoing = cross(outgoing, query - b) > 0.0F;
+			best.inside = (cross(edge.along, outgoing) > 0.0F) ? (leftOfEdge && leftOfOutgoing)
+				: (leftOfEdge || leftOfOutgoing);
+		}
+		else {
+			best.inside = leftOfEdge;
+		}
+		return best;
+	}
+
+	float PolygonBvh::nearestSq(const sf::Vector2f& query, float limitSq) const {
+		if (m_nodes.empty()) {
+			return NO_POLYGON_HIT;
+		}
+		// Searching at least m_depthBoundSq out finds the outline of a polygon the query is deep inside
+		const NearestEdge nearest = nearestEdge(query, std::max(limitSq, m_depthBoundSq));
+		if (nearest.inside) {
+			return 0.0F;
+		}
+		return (nearest.distanceSq < limitSq) ? nearest.distanceSq : NO_POLYGON_HIT;
+	}
+
+	bool PolygonBvh::contains(const sf::Vector2f& point) const {
+		if (m_nodes.empty()) {
+			return false;
+		}
+		const NearestEdge nearest = nearestEdge(point, m_depthBoundSq);
+		return nearest.inside || (nearest.edge != NO_OBSTACLE && nearest.distanceSq == 0.0F);
+	}
+
+	PolygonHit PolygonBvh::castRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const {
+		if (m_nodes.empty()) {
+			return {};
+		}
+		const NearestEdge start = nearestEdge(origin, m_depthBoundSq);
+		if (start.inside || (start.edge != NO_OBSTACLE && start.distanceSq == 0.0F)) {
+			return { 0.0F, m_edges[start.edge].polygon };
+		}
+		return firstCrossing(origin, direction, maxDistance);
+	}
+
+	PolygonHit PolygonBvh::firstCrossing(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const {
+		if (m_nodes.empty()) {
+			return {};
+		}
+		const sf::Vector2f invDirection{ 1.0F / direction.x, 1.0F / direction.y };
+		PolygonHit best;
+		best.distance = maxDistance;
+
+		// Entries keep their entry distance, as in nearestEdge()
+		std::array<StackEntry, MAX_BVH_DEPTH> stack;
+		std::size_t top = 0U;
+		stack[top++] = { 0U, boxEntry(m_nodes[0].low, m_nodes[0].high, origin, invDirection, best.distance) };
+		while (top > 0U) {
+			const StackEntry entry = stack[--top];
+			if (entry.key >= best.distance) {
+				continue;
+			}
+			const Node& node = m_nodes[entry.node];
+			if (node.count > 0U) {
+				for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+					// origin + t * direction = a + u * along, with t >= 0 and u in [0, 1]
+					const Edge& edge = m_edges[i];
+					const float denominator = cross(direction, edge.along);
+					if (denominator == 0.0F) {
+						continue; // parallel: a grazing ray meets the neighbouring edges instead
+					}
+					const sf::Vector2f offset = edge.a - origin;
+					const float t = cross(offset, edge.along) / denominator;
+					const float u = cross(offset, direction) / denominator;
+					if (t >= 0.0F && t < best.distance && u >= 0.0F && u <= 1.0F) {
+						best.distance = t;
+						best.polygon = edge.polygon;
+					}
+				}
+				continue;
+			}
+			const Node& left = m_nodes[entry.node + 1U];
+			const Node& right = m_nodes[node.first];
+			pushNearerLast(stack, top, { entry.node + 1U, boxEntry(left.low, left.high, origin, invDirection, best.distance) },
+				{ node.first, boxEntry(right.low, right.high, origin, invDirection, best.distance) }, best.distance);
+		}
+
+		return (best.distance < maxDistance) ? best : PolygonHit{};
+	}
+
+} // namespace sim
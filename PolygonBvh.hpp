@@ -0,0 +1,140 @@
+/*
+==============================================================================
+Polygon BVH - distance and ray queries against polygonal obstacles
+==============================================================================
+ - Curbs, islands and other irregular obstacles are simple polygons; at
+   build() each outline is decomposed into its edges, wound the same way,
+   and the edges are stored in a bounding volume hierarchy (median split on
+   the longer axis, at most LEAF_EDGES per leaf, nodes flattened depth
+   first so a query walks one array)
+ - nearestSq() is the squared distance to the nearest polygon surface, 0
+   inside one: inside or out follows from the nearest edge or vertex, so
+   no separate point-in-polygon pass runs
+ - castRay() is the first edge crossed along a ray, 0 from inside
+ - Polygons must not overlap one another or themselves
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	// Polygon outlines back to back; polygon i is vertices [starts[i], starts[i + 1])
+	struct PolygonSet {
+		std::vector<sf::Vector2f> vertices;
+		std::vector<std::uint32_t> starts; // one more than the polygon count, or empty
+
+		/**
+		 * @brief Appends one outline; fewer than three vertices are ignored.
+		 */
+		void add(const std::vector<sf::Vector2f>& outline);
+
+		[[nodiscard]] std::size_t size() const noexcept { return starts.empty() ? 0U : starts.size() - 1U; }
+		[[nodiscard]] bool empty() const noexcept { return size() == 0U; }
+	};
+
+	// First polygon hit by a ray
+	struct PolygonHit {
+		float distance = std::numeric_limits<float>::max(); // max if nothing was hit
+		std::uint32_t polygon = NO_OBSTACLE;                 // index into the PolygonSet
+	};
+
+	class PolygonBvh {
+	public:
+		static constexpr std::size_t LEAF_EDGES = 4U;
+
+		/**
+		 * @brief Rebuilds the hierarchy from a set of polygons.
+		 *
+		 * MISRA: outlines with fewer than three vertices or no area are skipped.
+		 */
+		void build(const PolygonSet& polygons);
+
+		/**
+		 * @brief Squared distance from query to the nearest polygon, 0 inside one.
+		 *
+		 * Returns std::numeric_limits<float>::max() if no polygon is nearer
+		 * than sqrt(limitSq).
+		 */
+		[[nodiscard]] float nearestSq(const sf::Vector2f& query, float limitSq) const;
+
+		/**
+		 * @brief True if point lies inside (or on the outline of) a polygon.
+		 */
+		[[nodiscard]] bool contains(const sf::Vector2f& point) const;
+
+		/**
+		 * @brief Distance along direction (unit length) to the first polygon edge hit.
+		 *
+		 * An origin inside a polygon hits it at 0. Returns a default PolygonHit
+		 * if nothing is hit within maxDistance.
+		 */
+		[[nodiscard]] PolygonHit castRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const;
+
+		/**
+		 * @brief castRay() without the inside test, for callers that already
+		 *        know origin is outside every polygon (one contains() per cone).
+		 */
+		[[nodiscard]] PolygonHit firstCrossing(const sf::Vector2f& origin, const sf::Vector2f& direction,
+			float maxDistance) const;
+
+		[[nodiscard]] std::size_t edgeCount() const noexcept { return m_edges.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_edges.empty(); }
+
+	private:
+		// One outline edge from a to a + along, with the corners it shares with its neighbours
+		struct Edge {
+			sf::Vector2f a;
+			sf::Vector2f along;
+			float invLengthSq;  // 0 for a zero-length edge
+			std::uint32_t polygon;
+			sf::Vector2f before; // vertex preceding a
+			sf::Vector2f after;  // vertex following a + along
+		};
+
+		// count == 0: inner node whose children are this + 1 and first; otherwise a leaf of edges [first, first + count)
+		struct Node {
+			sf::Vector2f low;
+			sf::Vector2f high;
+			std::uint32_t first;
+			std::uint32_t count;
+		};
+
+		// Traversal stack entry: a node and its box distance (squared) or ray entry distance
+		struct StackEntry {
+			std::uint32_t node;
+			float key;
+		};
+
+		struct NearestEdge {
+			float distanceSq = std::numeric_limits<float>::max();
+			std::uint32_t edge = NO_OBSTACLE;
+			bool inside = false;
+		};
+
+		// Splits edges [first, last) under a new node; returns its index
+		std::uint32_t buildNode(std::vector<Edge>& edges, std::uint32_t first, std::uint32_t last);
+
+		// Nearest edge within boundSq and whether query is inside its polygon
+		[[nodiscard]] NearestEdge nearestEdge(const sf::Vector2f& query, float boundSq) const;
+
+		// Counted against the obstacle subsystem's heap
+		template <typename T>
+		using Array = prof::TrackedVector<T, prof::MemorySubsystem::Obstacles>;
+
+		Array<Edge> m_edges; // leaf order
+		Array<Node> m_nodes; // depth first, root at 0
+		float m_depthBoundSq = 0.0F; // no point lies deeper than this inside a polygon
+	};
+
+} // namespace sim
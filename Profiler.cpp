@@ -0,0 +1,104 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace prof {
+
+	namespace {
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+	}
+
+	const char* phaseName(Phase phase) {
+		switch (phase) {
+		case Phase::Events: return "EVENTS";
+		case Phase::Input: return "INPUT";
+		case Phase::Simulation: return "SIM";
+		case Phase::Beep: return "BEEP";
+		case Phase::Parking: return "PARKING";
+		case Phase::Wait: return "WAIT";
+		case Phase::Draw: return "DRAW";
+		case Phase::Display: return "DISPLAY";
+		default: return "?";
+		}
+	}
+
+	void FrameProfiler::beginFrame() {
+		m_current = Frame{};
+		m_frameStart = Clock::now();
+	}
+
+	void FrameProfiler::endFrame() {
+		m_current.totalMs = Milliseconds(Clock::now() - m_frameStart).count();
+		m_frames[m_next] = m_current;
+		m_next = (m_next + 1U) % HISTORY;
+		m_count = std::min(m_count + 1U, HISTORY);
+	}
+
+	void FrameProfiler::add(Phase phase, Clock::duration elapsed) noexcept {
+		m_current.phaseMs[static_cast<std::size_t>(phase)] += Milliseconds(elapsed).count();
+	}
+
+	void FrameProfiler::add(const PhaseTimes& times) noexcept {
+		for (std::size_t p = 0U; p < PHASE_COUNT; ++p) {
+			m_current.phaseMs[p] += Milliseconds(times.elapsed[p]).count();
+		}
+	}
+
+	const FrameProfiler::Frame& FrameProfiler::frame(std::size_t i) const {
+		const std::size_t oldest = (m_next + HISTORY - m_count) % HISTORY;
+		return m_frames[(oldest + i) % HISTORY];
+	}
+
+	template <typename Get>
+	float FrameProfiler::percentileOf(float p, Get get) const {
+		if (m_count == 0U) {
+			return 0.0F;
+		}
+
+		std::array<float, HISTORY> values{};
+		for (std::size_t i = 0U; i < m_count; ++i) {
+			values[i] = get(frame(i));
+		}
+
+		const float rank = std::clamp(p, 0.0F, 100.0F) / 100.0F * static_cast<float>(m_count - 1U);
+		const auto nth = values.begin() + static_cast<std::ptrdiff_t>(rank + 0.5F);
+		std::nth_element(values.begin(), nth, values.begin() + static_cast<std::ptrdiff_t>(m_count));
+		return *nth;
+	}
+
+	float FrameProfiler::percentile(Phase phase, float p) const {
+		const std::size_t index = static_cast<std::size_t>(phase);
+		return percentileOf(p, [index](const Frame& f) { return f.phaseMs[index]; });
+	}
+
+	float FrameProfiler::framePercentile(float p) const {
+		return percentileOf(p, [](const Frame& f) { return f.totalMs; });
+	}
+
+	bool FrameProfiler::dumpCsv(const std::string& path) const {
+		std::ofstream file(path, std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: Failed to write profile " << path << '\n';
+			return false;
+		}
+
+		file << "frame";
+		for (std::size_t p = 0U; p < PHASE_COUNT; ++p) {
+			file << ',' << phaseName(static_cast<Phase>(p));
+		}
+		file << ",TOTAL\n";
+
+		for (std::size_t i = 0U; i < m_count; ++i) {
+			const Frame& f = frame(i);
+			file << i;
+			for (const float ms : f.phaseMs) {
+				file << ',' << ms;
+			}
+			file << ',' << f.totalMs << '\n';
+		}
+		return static_cast<bool>(file);
+	}
+
+} // namespace prof
@@ -0,0 +1,141 @@
+/*
+==============================================================================
+Profiler - scoped per-phase frame timers with a rolling history
+==============================================================================
+ - ScopedPhase adds the time spent in its scope to the current frame;
+   a phase entered several times per frame (e.g. fixed ticks) accumulates
+ - The last HISTORY frames are kept in a ring buffer for graphs,
+   percentiles and CSV export
+ - No SFML dependency; timings come from std::chrono::steady_clock
+ - While tracing is on, every phase is also recorded as a trace event
+ - Phases timed on another thread go into a PhaseTimes first and are
+   added to the frame that shows their result
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Trace.hpp"
+
+namespace prof {
+
+	// Main-loop phases, in frame order
+	enum class Phase : std::uint8_t {
+		Events,
+		Input,
+		Simulation,
+		Beep,
+		Parking,
+		Wait, // main thread blocked on the simulation running in the background
+		Draw,
+		Display,
+		Count
+	};
+
+	constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(Phase::Count);
+
+	/**
+	 * @brief Short upper-case label of a phase (used by the overlay and CSV header).
+	 */
+	[[nodiscard]] const char* phaseName(Phase phase);
+
+	/**
+	 * @brief Phase times measured away from the profiler, e.g. on a worker thread.
+	 */
+	struct PhaseTimes {
+		std::array<std::chrono::steady_clock::duration, PHASE_COUNT> elapsed{};
+	};
+
+	class FrameProfiler {
+	public:
+		static constexpr std::size_t HISTORY = 240U; // frames kept (4 s at 60 FPS)
+
+		using Clock = std::chrono::steady_clock;
+
+		struct Frame {
+			std::array<float, PHASE_COUNT> phaseMs{};
+			float totalMs = 0.0F; // wall time from beginFrame to endFrame
+		};
+
+		/**
+		 * @brief Starts a new frame; all phase times of the frame start at zero.
+		 */
+		void beginFrame();
+
+		/**
+		 * @brief Closes the current frame and commits it to the history.
+		 */
+		void endFrame();
+
+		void add(Phase phase, Clock::duration elapsed) noexcept;
+		void add(const PhaseTimes& times) noexcept;
+
+		/**
+		 * @brief Percentile (0..100) of one phase over the recorded history, in ms.
+		 */
+		[[nodiscard]] float percentile(Phase phase, float p) const;
+
+		/**
+		 * @brief Percentile (0..100) of whole-frame times over the history, in ms.
+		 */
+		[[nodiscard]] float framePercentile(float p) const;
+
+		/**
+		 * @brief Frame i of the history, 0 = oldest; i < size().
+		 */
+		[[nodiscard]] const Frame& frame(std::size_t i) const;
+		[[nodiscard]] std::size_t size() const noexcept { return m_count; }
+
+		/**
+		 * @brief Writes the history as CSV (one row per frame, one column per phase).
+		 */
+		[[nodiscard]] bool dumpCsv(const std::string& path) const;
+
+	private:
+		template <typename Get>
+		[[nodiscard]] float percentileOf(float p, Get get) const;
+
+		std::array<Frame, HISTORY> m_frames{};
+		std::size_t m_next = 0U;  // slot the next committed frame goes to
+		std::size_t m_count = 0U;
+
+		Frame m_current;
+		Clock::time_point m_frameStart{};
+	};
+
+	class ScopedPhase {
+	public:
+		ScopedPhase(FrameProfiler& profiler, Phase phase)
+			: m_trace(phaseName(phase)), m_profiler(&profiler), m_phase(phase), m_start(FrameProfiler::Clock::now()) {
+		}
+		ScopedPhase(PhaseTimes& times, Phase phase)
+			: m_trace(phaseName(phase)), m_times(&times), m_phase(phase), m_start(FrameProfiler::Clock::now()) {
+		}
+		~ScopedPhase() {
+			const FrameProfiler::Clock::duration elapsed = FrameProfiler::Clock::now() - m_start;
+			if (m_profiler != nullptr) {
+				m_profiler->add(m_phase, elapsed);
+			}
+			else {
+				m_times->elapsed[static_cast<std::size_t>(m_phase)] += elapsed;
+			}
+		}
+
+		ScopedPhase(const ScopedPhase&) = delete;
+		ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+	private:
+		TraceScope m_trace; // first member: its end event is recorded after the timer stops
+		FrameProfiler* m_profiler = nullptr; // exactly one of the two is set
+		PhaseTimes* m_times = nullptr;
+		Phase m_phase;
+		FrameProfiler::Clock::time_point m_start;
+	};
+
+} // namespace prof
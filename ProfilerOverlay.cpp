@@ -0,0 +1,232 @@
+#include "ProfilerOverlay.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "PixelFont.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr float PANEL_WIDTH = 400.0F;
+		constexpr float GRAPH_HEIGHT = 100.0F;
+		constexpr float GRAPH_MAX_MS = 33.3F;     // two 60 FPS frames fill the graph
+		constexpr float FRAME_BUDGET_MS = 16.7F;  // reference line
+		constexpr float PANEL_PADDING = 6.0F;
+
+		constexpr float PIXEL = 2.0F;             // screen pixels per font pixel
+		constexpr float GLYPH_ADVANCE = 4.0F * PIXEL;
+		constexpr float LINE_HEIGHT = 7.0F * PIXEL;
+
+		constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+
+		const sf::Color PANEL_COLOR(0, 0, 0, 170);
+		const sf::Color BUDGET_COLOR(255, 255, 255, 90);
+		const sf::Color TEXT_COLOR(230, 230, 230);
+		const sf::Color ACTIVE_COLOR(255, 220, 80);
+
+		const sf::Color PHASE_COLORS[prof::PHASE_COUNT] = {
+			sf::Color(120, 120, 255), // events
+			sf::Color(80, 200, 255),  // input
+			sf::Color(80, 220, 120),  // simulation
+			sf::Color(255, 220, 80),  // beep
+			sf::Color(255, 150, 60),  // parking
+			sf::Color(150, 150, 150), // wait
+			sf::Color(230, 80, 80),   // draw
+			sf::Color(200, 100, 220)  // display
+		};
+	}
+
+	ProfilerOverlay::ProfilerOverlay(const sf::Vector2f& position)
+		: m_position(position)
+	{
+	}
+
+	void ProfilerOverlay::addRect(const sf::Vector2f& position, const sf::Vector2f& size, sf::Color color) {
+		const sf::Vector2f a = position;
+		const sf::Vector2f b{ position.x + size.x, position.y };
+		const sf::Vector2f c = position + size;
+		const sf::Vector2f d{ position.x, position.y + size.y };
+		for (const sf::Vector2f& p : { a, b, c, a, c, d }) {
+			m_vertices.append(sf::Vertex{ p, color });
+		}
+	}
+
+	void ProfilerOverlay::addText(const sf::Vector2f& position, const char* text, sf::Color color) {
+		sf::Vector2f pen = position;
+		for (; *text != '\0'; ++text) {
+			if (const char* rows = pixelGlyphRows(*text)) {
+				for (int i = 0; i < 15; ++i) {
+					if (rows[i] == '1') {
+						addRect({ pen.x + static_cast<float>(i % 3) * PIXEL, pen.y + static_cast<float>(i / 3) * PIXEL },
+							{ PIXEL, PIXEL }, color);
+					}
+				}
+			}
+			pen.x += GLYPH_ADVANCE;
+		}
+	}
+
+	void ProfilerOverlay::update(const prof::FrameProfiler& profiler, const prof::MemoryUsage& memory,
+		const prof::AudioReport& audio, const prof::HwCounterReport& counters, const sim::NearestComparison* nearest,
+		sim::NearestBackend active)
+	{
+		m_vertices.clear();
+
+		// Phase rows with header and frame total, subsystem rows with header and total, audio rows,
+		// compared engines with header, then counted scopes
+		constexpr std::size_t AUDIO_ROWS = 4U;
+		std::size_t nearestRows = (nearest != nullptr) ? 1U : 0U;
+		for (std::size_t b = 0U; nearest != nullptr && b < sim::NEAREST_BACKEND_COUNT; ++b) {
+			nearestRows += (nearest->tally(static_cast<sim::NearestBackend>(b)).passes > 0U) ? 1U : 0U;
+		}
+		const std::size_t counterRows = prof::hwCountersEnabled() ? counters.count + 1U : 0U;
+		const float tableHeight = LINE_HEIGHT * static_cast<float>(prof::PHASE_COUNT + 2U
+			+ prof::MEMORY_SUBSYSTEM_COUNT + 2U + AUDIO_ROWS + nearestRows + counterRows);
+		addRect(m_position, { PANEL_WIDTH, GRAPH_HEIGHT + tableHeight + PANEL_PADDING * 3.0F }, PANEL_COLOR);
+
+		// Rolling stacked graph, newest frame on the right
+		const sf::Vector2f graphOrigin{ m_position.x + PANEL_PADDING, m_position.y + PANEL_PADDING };
+		const float graphWidth = PANEL_WIDTH - PANEL_PADDING * 2.0F;
+		const float columnWidth = graphWidth / static_cast<float>(prof::FrameProfiler::HISTORY);
+		const float pixelsPerMs = GRAPH_HEIGHT / GRAPH_MAX_MS;
+		const float firstColumn = static_cast<float>(prof::FrameProfiler::HISTORY - profiler.size());
+
+		for (std::size_t i = 0U; i < profiler.size(); ++i) {
+			const prof::FrameProfiler::Frame& frame = profiler.frame(i);
+			const float x = graphOrigin.x + (firstColumn + static_cast<float>(i)) * columnWidth;
+			float stacked = 0.0F;
+			for (std::size_t p = 0U; p < prof::PHASE_COUNT && stacked < GRAPH_HEIGHT; ++p) {
+				const float height = std::min(frame.phaseMs[p] * pixelsPerMs, GRAPH_HEIGHT - stacked);
+				stacked += height;
+				addRect({ x, graphOrigin.y + GRAPH_HEIGHT - stacked }, { columnWidth, height }, PHASE_COLORS[p]);
+			}
+		}
+		addRect({ graphOrigin.x, graphOrigin.y + GRAPH_HEIGHT - FRAME_BUDGET_MS * pixelsPerMs },
+			{ graphWidth, 1.0F }, BUDGET_COLOR);
+
+		// Percentile table
+		sf::Vector2f row{ graphOrigin.x, graphOrigin.y + GRAPH_HEIGHT + PANEL_PADDING };
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, "PHASE        P50     P99  MS", TEXT_COLOR);
+
+		char line[48];
+		for (std::size_t p = 0U; p < prof::PHASE_COUNT; ++p) {
+			const auto phase = static_cast<prof::Phase>(p);
+			row.y += LINE_HEIGHT;
+			addRect(row, { 5.0F * PIXEL, 5.0F * PIXEL }, PHASE_COLORS[p]);
+			std::snprintf(line, sizeof(line), "%-8s %6.2f  %6.2f", prof::phaseName(phase),
+				profiler.percentile(phase, 50.0F), profiler.percentile(phase, 99.0F));
+			addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+		}
+
+		row.y += LINE_HEIGHT;
+		std::snprintf(line, sizeof(line), "FRAME    %6.2f  %6.2f",
+			profiler.framePercentile(50.0F), profiler.framePercentile(99.0F));
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+
+		// Memory table
+		row.y += LINE_HEIGHT;
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, "MEMORY       HEAP    VRAM  MIB", TEXT_COLOR);
+		std::int64_t heapTotal = 0;
+		std::int64_t videoTotal = 0;
+		for (std::size_t s = 0U; s < prof::MEMORY_SUBSYSTEM_COUNT; ++s) {
+			row.y += LINE_HEIGHT;
+			const auto subsystem = static_cast<prof::MemorySubsystem>(s);
+			std::snprintf(line, sizeof(line), "%-9s %7.1f %7.1f", prof::memorySubsystemName(subsystem),
+				static_cast<double>(memory.heap[s]) / BYTES_PER_MIB, static_cast<double>(memory.video[s]) / BYTES_PER_MIB);
+			addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+			heapTotal += memory.heap[s];
+			videoTotal += memory.video[s];
+		}
+		row.y += LINE_HEIGHT;
+		std::snprintf(line, sizeof(line), "TOTAL     %7.1f %7.1f", static_cast<double>(heapTotal) / BYTES_PER_MIB,
+			static_cast<double>(videoTotal) / BYTES_PER_MIB);
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+
+		// Audio timing: lateness of sample beeps, then the synth's buffer and the voice pool
+		row.y += LINE_HEIGHT;
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, "AUDIO        P50     P99     MAX  MS", TEXT_COLOR);
+		row.y += LINE_HEIGHT;
+		std::snprintf(line, sizeof(line), "BEEP LATE %6.2f  %6.2f  %6.2f", static_cast<double>(audio.lateP50Ms),
+			static_cast<double>(audio.lateP99Ms), static_cast<double>(audio.lateMaxMs));
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+		row.y += LINE_HEIGHT;
+		std::snprintf(line, sizeof(line), "UNDERRUNS %5llu  FILL %6.1f  MIN %6.1f",
+			static_cast<unsigned long long>(audio.underruns), static_cast<double>(audio.fillMs),
+			static_cast<double>(audio.fillMinMs));
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+		row.y += LINE_HEIGHT;
+		std::snprintf(line, sizeof(line), "VOICES %2u OF %2u  STOLEN %5llu  DROPPED %5llu", audio.voicesBusy,
+			audio.voiceCount, static_cast<unsigned long long>(audio.voiceSteals),
+			static_cast<unsigned long long>(audio.voiceDrops));
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+
+		// Nearest engines since comparing started: cost of one sensor pass, share within tolerance of brute force
+		if (nearest != nullptr) {
+			row.y += LINE_HEIGHT;
+			addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, "NEAREST   US PASS   AGREE  MAX ERR", TEXT_COLOR);
+		}
+		for (std::size_t b = 0U; nearest != nullptr && b < sim::NEAREST_BACKEND_COUNT; ++b) {
+			const auto backend = static_cast<sim::NearestBackend>(b);
+			const sim::NearestTally& tally = nearest->tally(backend);
+			if (tally.passes == 0U) {
+				continue;
+			}
+			row.y += LINE_HEIGHT;
+			char name[8];
+			std::size_t n = 0U;
+			for (const char* c = sim::nearestBackendName(backend); n + 1U < sizeof(name) && *c != '\0'; ++c) {
+				name[n++] = static_cast<char>(std::toupper(static_cast<unsigned char>(*c)));
+			}
+			name[n] = '\0';
+			std::snprintf(line, sizeof(line), "%-8s %8.1f %7.2f %8.3f", name, tally.microsPerPass(),
+				100.0 * tally.agreement(), static_cast<double>(tally.maxError));
+			addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, (backend == active) ? ACTIVE_COLOR : TEXT_COLOR);
+		}
+
+		// Hardware counter table, per call since counting started; '-' where the platform reads none
+		if (counterRows == 0U) {
+			return;
+		}
+		row.y += LINE_HEIGHT;
+		addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, "HW PER CALL            CYCLES  CMISS  BMISS", TEXT_COLOR);
+		char cells[3][12];
+		const auto cell = [&counters](char (&out)[12], const prof::HwScopeTotals& scope, prof::HwCounter counter,
+			int decimals)
+		{
+			if (counters.available[static_cast<std::size_t>(counter)]) {
+				std::snprintf(out, sizeof(out), "%.*f", decimals, scope.perCall(counter));
+			}
+			else {
+				std::snprintf(out, sizeof(out), "-");
+			}
+		};
+		for (std::size_t s = 0U; s < counters.count; ++s) {
+			row.y += LINE_HEIGHT;
+			const prof::HwScopeTotals& scope = counters.scopes[s];
+			char name[22];
+			std::size_t n = 0U;
+			for (; n + 1U < sizeof(name) && scope.name[n] != '\0'; ++n) {
+				name[n] = static_cast<char>(std::toupper(static_cast<unsigned char>(scope.name[n])));
+			}
+			name[n] = '\0';
+			cell(cells[0], scope, prof::HwCounter::Cycles, 0);
+			cell(cells[1], scope, prof::HwCounter::CacheMisses, 2);
+			cell(cells[2], scope, prof::HwCounter::BranchMisses, 2);
+			std::snprintf(line, sizeof(line), "%-21s %7s %6s %6s", name, cells[0], cells[1], cells[2]);
+			addText({ row.x + GLYPH_ADVANCE * 1.5F, row.y }, line, TEXT_COLOR);
+		}
+	}
+
+	void ProfilerOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		// Screen-space panel regardless of the window's current view
+		const sf::View previous = target.getView();
+		target.setView(target.getDefaultView());
+		target.draw(m_vertices, states);
+		target.setView(previous);
+	}
+
+} // namespace gfx
@@ -0,0 +1,56 @@
+/*
+==============================================================================
+Profiler Overlay - on-screen frame-time graph and per-phase percentiles
+==============================================================================
+ - Rolling stacked graph: one column per recorded frame, one colour per phase
+ - p50/p99 table drawn with the built-in 3x5 pixel font (PixelFont), so no font asset
+   has to ship with the sample
+ - Heap and VRAM per memory subsystem (MemoryAccounting) under the table
+ - Beep lateness percentiles, underruns, buffer fill and voice steals
+   (AudioCounters) under that
+ - While the nearest engines are compared (B), each engine's cost per
+   sensor pass, agreement with brute force and largest error under that,
+   the engine in use highlighted
+ - With --hw-counters, per-call cycles, cache misses and branch misses of
+   each counted scope (HardwareCounters) at the bottom
+ - update() rebuilds one triangle array; draw() is a single draw call
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "AudioCounters.hpp"
+#include "HardwareCounters.hpp"
+#include "MemoryAccounting.hpp"
+#include "NearestBackends.hpp"
+#include "Profiler.hpp"
+
+namespace gfx {
+
+	class ProfilerOverlay : public sf::Drawable {
+	public:
+		explicit ProfilerOverlay(const sf::Vector2f& position = { 10.0F, 10.0F });
+
+		/**
+		 * @brief Rebuilds the graph and the percentile table from the profiler history,
+		 *        the memory table from memory, the audio rows from audio, the
+		 *        counter table from counters and, if given, the engine table
+		 *        from nearest with active highlighted.
+		 */
+		void update(const prof::FrameProfiler& profiler, const prof::MemoryUsage& memory,
+			const prof::AudioReport& audio, const prof::HwCounterReport& counters,
+			const sim::NearestComparison* nearest = nullptr, sim::NearestBackend active = sim::NearestBackend::Grid);
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		void addRect(const sf::Vector2f& position, const sf::Vector2f& size, sf::Color color);
+		void addText(const sf::Vector2f& position, const char* text, sf::Color color);
+
+		sf::Vector2f m_position;
+		sf::VertexArray m_vertices{ sf::PrimitiveType::Triangles };
+	};
+
+} // namespace gfx
@@ -0,0 +1,162 @@
+#include "QuadRenderer.hpp"
+
+#include <iterator>
+
+namespace gfx {
+
+	namespace {
+		constexpr const char* VERTEX_SHADER = R"(
+#version 330 core
+in vec2 a_position;
+in vec2 a_uv;
+in vec3 a_color;
+uniform mat4 u_projection;
+out vec2 v_uv;
+out vec3 v_color;
+void main() {
+	v_uv = a_uv;
+	v_color = a_color;
+	gl_Position = u_projection * vec4(a_position, 0.0, 1.0);
+}
+)";
+
+		constexpr const char* FRAGMENT_SHADER = R"(
+#version 330 core
+in vec2 v_uv;
+in vec3 v_color;
+uniform sampler2D u_texture;
+uniform bool u_textured;
+out vec4 o_color;
+void main() {
+	vec4 color = vec4(v_color, 1.0);
+	o_color = u_textured ? texture(u_texture, v_uv) * color : color;
+}
+)";
+
+		constexpr const char* ATTRIBUTES[] = { "a_position", "a_uv", "a_color" };
+	}
+
+	void appendQuad(std::vector<QuadVertex>& triangles, const QuadVertex& a, const QuadVertex& b,
+		const QuadVertex& c, const QuadVertex& d)
+	{
+		triangles.insert(triangles.end(), { a, b, c, a, c, d });
+	}
+
+	QuadRenderer::~QuadRenderer() {
+		if (!gl::loaded()) {
+			return;
+		}
+		const gl::Api& api = gl::api();
+		if (m_buffer != 0U) { api.DeleteBuffers(1, &m_buffer); }
+		if (m_vao != 0U) { api.DeleteVertexArrays(1, &m_vao); }
+		if (m_program != 0U) { api.DeleteProgram(m_program); }
+	}
+
+	bool QuadRenderer::init(gl::ProcLoader loader) {
+		if (!gl::loaded() && !gl::load(loader)) {
+			return false;
+		}
+
+		m_program = gl::buildProgram(VERTEX_SHADER, FRAGMENT_SHADER, ATTRIBUTES, std::size(ATTRIBUTES));
+		if (m_program == 0U) {
+			return false;
+		}
+
+		const gl::Api& api = gl::api();
+		m_projectionLocation = api.GetUniformLocation(m_program, "u_projection");
+		m_texturedLocation = api.GetUniformLocation(m_program, "u_textured");
+		api.UseProgram(m_program);
+		api.Uniform1i(api.GetUniformLocation(m_program, "u_texture"), 0);
+		setOrtho(-1.0F, 1.0F, -1.0F, 1.0F);
+
+		api.GenVertexArrays(1, &m_vao);
+		api.BindVertexArray(m_vao);
+		api.GenBuffers(1, &m_buffer);
+		api.BindBuffer(gl::ARRAY_BUFFER, m_buffer);
+
+		constexpr GLsizei STRIDE = sizeof(QuadVertex);
+		const auto offset = [](std::size_t bytes) { return reinterpret_cast<const void*>(bytes); };
+		api.EnableVertexAttribArray(0U);
+		api.VertexAttribPointer(0U, 2, GL_FLOAT, GL_FALSE, STRIDE, offset(offsetof(QuadVertex, x)));
+		api.EnableVertexAttribArray(1U);
+		api.VertexAttribPointer(1U, 2, GL_FLOAT, GL_FALSE, STRIDE, offset(offsetof(QuadVertex, u)));
+		api.EnableVertexAttribArray(2U);
+		api.VertexAttribPointer(2U, 3, GL_FLOAT, GL_FALSE, STRIDE, offset(offsetof(QuadVertex, r)));
+		return true;
+	}
+
+	void QuadRenderer::upload(const std::vector<QuadVertex>& triangles) {
+		if (m_program == 0U) {
+			return;
+		}
+		const gl::Api& api = gl::api();
+		api.BindBuffer(gl::ARRAY_BUFFER, m_buffer);
+		api.BufferData(gl::ARRAY_BUFFER, static_cast<gl::SizeiPtr>(triangles.size() * sizeof(QuadVertex)),
+			triangles.data(), gl::STATIC_DRAW);
+		m_vertexCount = triangles.size();
+	}
+
+	void QuadRenderer::setOrtho(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top) {
+		if (m_program == 0U) {
+			return;
+		}
+		// Column-major; z passes through unchanged
+		const GLfloat projection[16] = {
+			2.0F / (right - left), 0.0F, 0.0F, 0.0F,
+			0.0F, 2.0F / (top - bottom), 0.0F, 0.0F,
+			0.0F, 0.0F, 1.0F, 0.0F,
+			-(right + left) / (right - left), -(top + bottom) / (top - bottom), 0.0F, 1.0F
+		};
+		const gl::Api& api = gl::api();
+		api.UseProgram(m_program);
+		api.UniformMatrix4fv(m_projectionLocation, 1, GL_FALSE, projection);
+	}
+
+	void QuadRenderer::draw(GLint first, GLsizei count, bool textured) const {
+		if (m_program == 0U || count <= 0) {
+			return;
+		}
+		const gl::Api& api = gl::api();
+		api.UseProgram(m_program);
+		api.Uniform1i(m_texturedLocation, textured ? 1 : 0);
+		if (textured) {
+			glBindTexture(GL_TEXTURE_2D, m_texture);
+		}
+		api.BindVertexArray(m_vao);
+		glDrawArrays(GL_TRIANGLES, first, count);
+	}
+
+	void QuadQueue::push(std::uint8_t layer, const QuadRange& range, std::uint32_t depth) {
+		if (range.count <= 0) {
+			return;
+		}
+		(void)m_order.push(layer, static_cast<DrawResource>(range.texture), 0U, depth);
+		m_ranges.push_back(range);
+	}
+
+	void QuadQueue::submit(QuadRenderer& renderer) {
+		m_drawCalls = 0U;
+		QuadRange pending;
+		const auto flush = [&]() {
+			if (pending.count > 0) {
+				renderer.setTexture(pending.texture);
+				renderer.draw(pending.first, pending.count, pending.texture != 0U);
+				++m_drawCalls;
+			}
+		};
+		for (const DrawOrder::Entry& entry : m_order.sort()) {
+			const QuadRange& range = m_ranges[entry.draw];
+			if (pending.count > 0 && range.texture == pending.texture && range.first == pending.first + pending.count) {
+				pending.count += range.count;
+				continue;
+			}
+			flush();
+			pending = range;
+		}
+		flush();
+
+		m_order.clear();
+		m_ranges.clear();
+	}
+
+} // namespace gfx
@@ -0,0 +1,117 @@
+/*
+==============================================================================
+Quad Renderer - core-profile textured and colored quads (GLUT variant)
+==============================================================================
+ - One tiny shader pair: the fragment color is the vertex color, times the
+   bound texture for textured ranges; no fixed-function state is used, so
+   it runs in an OpenGL 3.3 core context
+ - Geometry is uploaded once into one static VBO as triangles; a frame only
+   draws ranges of it, so changing what is shown costs no upload
+ - Edges are smoothed by the context's MSAA, not by polygon smoothing
+ - A frame's ranges go through a QuadQueue: sorted with the same DrawOrder
+   keys as the SFML RenderQueue, then neighbouring ranges of one state are
+   merged into a single draw call
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DrawOrder.hpp"
+#include "GlFunctions.hpp"
+
+namespace gfx {
+
+	struct QuadVertex {
+		GLfloat x, y;
+		GLfloat u, v;
+		GLfloat r, g, b;
+	};
+
+	// Vertices per quad once triangulated
+	constexpr GLsizei QUAD_TRIANGLE_VERTICES = 6;
+
+	/**
+	 * @brief Appends the quad a-b-c-d (in winding order) as two triangles.
+	 */
+	void appendQuad(std::vector<QuadVertex>& triangles, const QuadVertex& a, const QuadVertex& b,
+		const QuadVertex& c, const QuadVertex& d);
+
+	class QuadRenderer {
+	public:
+		QuadRenderer() = default;
+		~QuadRenderer();
+
+		QuadRenderer(const QuadRenderer&) = delete;
+		QuadRenderer& operator=(const QuadRenderer&) = delete;
+
+		/**
+		 * @brief Loads the GL entry points and builds the shader program.
+		 *
+		 * Requires a current context. Returns false (logged) if the driver
+		 * cannot run it.
+		 */
+		[[nodiscard]] bool init(gl::ProcLoader loader);
+
+		/**
+		 * @brief Replaces the vertex buffer with triangles (static; call rarely).
+		 */
+		void upload(const std::vector<QuadVertex>& triangles);
+
+		/**
+		 * @brief Orthographic projection of the box [left, right] x [bottom, top].
+		 */
+		void setOrtho(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top);
+
+		void setTexture(GLuint texture) noexcept { m_texture = texture; }
+
+		/**
+		 * @brief Draws vertices [first, first + count) of the last upload().
+		 */
+		void draw(GLint first, GLsizei count, bool textured) const;
+
+		[[nodiscard]] std::size_t vertexCount() const noexcept { return m_vertexCount; }
+
+	private:
+		GLuint m_program = 0U;
+		GLuint m_vao = 0U;
+		GLuint m_buffer = 0U;
+		GLuint m_texture = 0U;
+		GLint m_projectionLocation = -1;
+		GLint m_texturedLocation = -1;
+		std::size_t m_vertexCount = 0U;
+	};
+
+	// Vertices [first, first + count) of the uploaded buffer, textured unless texture is 0
+	struct QuadRange {
+		GLint first = 0;
+		GLsizei count = 0;
+		GLuint texture = 0U;
+	};
+
+	class QuadQueue {
+	public:
+		/**
+		 * @brief Queues range in layer; deeper ranges of the same texture draw later.
+		 */
+		void push(std::uint8_t layer, const QuadRange& range, std::uint32_t depth = 0U);
+
+		/**
+		 * @brief Draws the queued ranges in key order with renderer and empties the queue.
+		 *
+		 * Consecutive ranges on one texture that touch in the buffer become one draw call.
+		 */
+		void submit(QuadRenderer& renderer);
+
+		[[nodiscard]] std::size_t drawCalls() const noexcept { return m_drawCalls; } // last submit
+
+	private:
+		DrawOrder m_order;
+		std::vector<QuadRange> m_ranges; // by push index
+		std::size_t m_drawCalls = 0U;
+	};
+
+} // namespace gfx
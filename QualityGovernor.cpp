@@ -0,0 +1,68 @@
+#include "QualityGovernor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gfx {
+
+	namespace {
+		// Weight of the newest frame in the average; about a dozen frames of memory
+		constexpr float QUALITY_SMOOTHING = 0.15F;
+	}
+
+	QualityGovernor::QualityGovernor(const QualitySettings& settings)
+		: m_settings(settings) {
+		m_settings.headroom = std::clamp(m_settings.headroom, 0.1F, 1.0F);
+		m_settings.climbFrames = std::max(m_settings.climbFrames, 1U);
+		m_settings.fullConeRays = std::max(m_settings.fullConeRays, 1U);
+	}
+
+	QualityKnobs QualityGovernor::knobsAt(std::uint32_t level) const noexcept {
+		level = std::min(level, LEVEL_COUNT - 1U);
+		// Cheapest to lose first: label text and heatmap splats are only looked at,
+		// pillar detail is seen, and cone rays change what the sensors report
+		QualityKnobs knobs;
+		knobs.labelsEvery = (level >= 1U) ? 4U : 1U;
+		knobs.heatmapEvery = (level >= 2U) ? 4U : 1U;
+		knobs.lodBias = (level >= 3U) ? static_cast<std::uint8_t>(level - 2U) : 0U;
+		const std::uint32_t rayHalvings = (level >= 4U) ? level - 3U : 0U;
+		knobs.coneRays = std::max(m_settings.fullConeRays >> rayHalvings, 1U);
+		return knobs;
+	}
+
+	bool QualityGovernor::update(float workMs) noexcept {
+		if (!std::isfinite(workMs) || workMs < 0.0F) {
+			return false;
+		}
+		if (m_settle > 0U) {
+			--m_settle;
+			return false;
+		}
+		m_averageMs = m_primed ? m_averageMs + QUALITY_SMOOTHING * (workMs - m_averageMs) : workMs;
+		m_primed = true;
+
+		std::uint32_t next = m_level;
+		if (m_averageMs > m_settings.targetMs) {
+			next = std::min(m_level + 1U, LEVEL_COUNT - 1U);
+			m_underFrames = 0U;
+		}
+		else if (std::max(workMs, m_averageMs) < m_settings.targetMs * m_settings.headroom) {
+			if (++m_underFrames >= m_settings.climbFrames) {
+				next = (m_level > 0U) ? m_level - 1U : 0U;
+				m_underFrames = 0U;
+			}
+		}
+		else {
+			m_underFrames = 0U; // a spike restarts the run of quiet frames
+		}
+
+		if (next == m_level) {
+			return false;
+		}
+		m_level = next;
+		m_primed = false; // the old level's timings say little about the new one
+		m_settle = m_settings.settleFrames;
+		return true;
+	}
+
+} // namespace gfx
@@ -0,0 +1,72 @@
+/*
+==============================================================================
+Quality Governor - optional work shed and restored to hold a frame budget
+==============================================================================
+ - Fed the CPU work of every frame (frame time less presentation, which
+   the limiter or vsync pads) and keeps a smoothed average
+ - Quality is a ladder of levels, 0 = everything on; each level lowers
+   one more knob: HUD label refresh, heatmap splats, pillar detail, then
+   rays per sensor cone, halving them again on the lowest levels
+ - Over budget on average it goes down one level; it climbs one level
+   only after a run of frames that each left the headroom, so a single
+   spike restarts the run and it does not oscillate
+ - After a change it waits a few frames for timings of the new level
+ - No SFML or GL dependency; the front-end measures and applies the knobs
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace gfx {
+
+	// What one quality level allows; level 0 is full quality
+	struct QualityKnobs {
+		std::uint32_t coneRays = 0U;       // rays per ray-cast sensor cone
+		std::uint8_t lodBias = 0U;         // pillar detail levels coarser than the on-screen size asks for
+		std::uint32_t heatmapEvery = 1U;   // frames per heatmap splat and upload
+		std::uint32_t labelsEvery = 1U;    // frames per HUD sensor label refresh
+	};
+
+	struct QualitySettings {
+		float targetMs = 16.6F;  // CPU work per frame to stay under
+		float headroom = 0.75F;  // climb only while every frame is under targetMs * headroom
+		std::uint32_t climbFrames = 60U; // consecutive frames with headroom before a level up
+		std::uint32_t settleFrames = 10U; // frames ignored after a change
+		std::uint32_t fullConeRays = 8U;  // cone rays at level 0
+	};
+
+	class QualityGovernor {
+	public:
+		static constexpr std::uint32_t LEVEL_COUNT = 6U;
+
+		explicit QualityGovernor(const QualitySettings& settings = {});
+
+		/**
+		 * @brief One frame's CPU work; returns true if level() changed.
+		 *
+		 * MISRA: negative or non-finite times are ignored.
+		 */
+		bool update(float workMs) noexcept;
+
+		[[nodiscard]] std::uint32_t level() const noexcept { return m_level; }
+		[[nodiscard]] QualityKnobs knobs() const noexcept { return knobsAt(m_level); }
+		[[nodiscard]] float averageMs() const noexcept { return m_averageMs; }
+		[[nodiscard]] const QualitySettings& settings() const noexcept { return m_settings; }
+
+		/**
+		 * @brief Knobs of level (clamped to the lowest).
+		 */
+		[[nodiscard]] QualityKnobs knobsAt(std::uint32_t level) const noexcept;
+
+	private:
+		QualitySettings m_settings;
+		std::uint32_t m_level = 0U;
+		float m_averageMs = 0.0F;
+		bool m_primed = false;    // the average holds at least one sample of this level
+		std::uint32_t m_underFrames = 0U;
+		std::uint32_t m_settle = 0U;
+	};
+
+} // namespace gfx
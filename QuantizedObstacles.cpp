@@ -0,0 +1,278 @@
+#include "QuantizedObstacles.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIM_QUANTIZED_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIM_QUANTIZED_NEON 1
+#endif
+
+namespace sim {
+
+	namespace {
+		// Steps along one tile side; tile offsets are [0, TILE_STEPS)
+		constexpr std::int64_t TILE_STEPS = static_cast<std::int64_t>(QuantizedObstacleTiles::TILE_SIZE)
+			* QuantizedObstacleTiles::STEPS_PER_PIXEL;
+
+		// Finest cell side, in steps; cells double up to a whole tile as pillars thin out
+		constexpr std::int64_t MIN_CELL_STEPS = static_cast<std::int64_t>(QuantizedObstacleTiles::MIN_CELL_SIZE)
+			* QuantizedObstacleTiles::STEPS_PER_PIXEL;
+
+		// Largest search radius, in steps: a pillar found is always under TILE_SIZE from the
+		// query, so an int16 difference that saturates can only belong to one out of range
+		constexpr float MAX_SEARCH_STEPS = static_cast<float>(TILE_STEPS - 1);
+
+		// Cells are coarsened until there are at most this many per pillar (plus a floor);
+		// a table of whole tiles above MAX_CELLS is refused
+		constexpr std::size_t MAX_CELLS_PER_PILLAR = 4U;
+		constexpr std::size_t MIN_CELL_BUDGET = 16U;
+		constexpr std::uint64_t MAX_CELLS = std::uint64_t{ 1 } << 24U;
+
+		// Clamp before float->int conversion so far-away queries stay defined
+		constexpr float MAX_GLOBAL_STEPS = 1.0e9F;
+
+		// The pillar found so far, as exact integers
+		struct TileHit {
+			std::int32_t distanceSq = std::numeric_limits<std::int32_t>::max();
+			std::int32_t position = -1; // in cell storage order
+		};
+
+		[[nodiscard]] std::int64_t toSteps(float offset) noexcept {
+			const float steps = offset * static_cast<float>(QuantizedObstacleTiles::STEPS_PER_PIXEL);
+			return static_cast<std::int64_t>(std::lround(std::clamp(steps, -MAX_GLOBAL_STEPS, MAX_GLOBAL_STEPS)));
+		}
+
+		[[nodiscard]] std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) noexcept {
+			const std::int64_t quotient = value / divisor;
+			return (value % divisor < 0) ? quotient - 1 : quotient;
+		}
+
+		[[nodiscard]] std::int16_t saturate16(std::int64_t value) noexcept {
+			return static_cast<std::int16_t>(std::clamp<std::int64_t>(value,
+				std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max()));
+		}
+
+		// Nearer, or as near and stored earlier
+		void keepNearer(TileHit& best, std::int32_t distanceSq, std::int32_t position) noexcept {
+			if (distanceSq < best.distanceSq || (distanceSq == best.distanceSq && position < best.position)) {
+				best = { distanceSq, position };
+			}
+		}
+
+		// Pillars [begin, end) of one cell against the query offset (qx, qy) from its tile's corner.
+		// Differences saturate to int16 as the vector instructions do, so every path agrees
+		void scanCellRun(const std::int16_t* xy, std::int32_t begin, std::int32_t end, std::int16_t qx, std::int16_t qy,
+			TileHit& best)
+		{
+			std::int32_t i = begin;
+#if defined(SIM_QUANTIZED_SSE2) || defined(SIM_QUANTIZED_NEON)
+			if (end - begin >= 4) {
+				const auto packed = static_cast<std::int32_t>((static_cast<std::uint32_t>(static_cast<std::uint16_t>(qy)) << 16U)
+					| static_cast<std::uint16_t>(qx));
+				alignas(16) std::int32_t laneDistance[4];
+				alignas(16) std::int32_t lanePosition[4];
+#if defined(SIM_QUANTIZED_SSE2)
+				const __m128i query = _mm_set1_epi32(packed);
+				const __m128i laneStep = _mm_setr_epi32(0, 1, 2, 3);
+				__m128i bestDistance = _mm_set1_epi32(best.distanceSq + 1); // ties reach keepNearer
+				__m128i bestPosition = _mm_set1_epi32(-1);
+				for (; i + 4 <= end; i += 4) {
+					const __m128i pillars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(xy + 2 * i));
+					const __m128i d = _mm_subs_epi16(pillars, query);
+					const __m128i distance = _mm_madd_epi16(d, d); // dx * dx + dy * dy per pillar
+					const __m128i nearer = _mm_cmplt_epi32(distance, bestDistance);
+					const __m128i position = _mm_add_epi32(_mm_set1_epi32(i), laneStep);
+					bestDistance = _mm_or_si128(_mm_and_si128(nearer, distance), _mm_andnot_si128(nearer, bestDistance));
+					bestPosition = _mm_or_si128(_mm_and_si128(nearer, position), _mm_andnot_si128(nearer, bestPosition));
+				}
+				_mm_store_si128(reinterpret_cast<__m128i*>(laneDistance), bestDistance);
+				_mm_store_si128(reinterpret_cast<__m128i*>(lanePosition), bestPosition);
+#else
+				const int16x8_t query = vreinterpretq_s16_s32(vdupq_n_s32(packed));
+				const int32x4_t laneStep = { 0, 1, 2, 3 };
+				int32x4_t bestDistance = vdupq_n_s32(best.distanceSq + 1); // ties reach keepNearer
+				int32x4_t bestPosition = vdupq_n_s32(-1);
+				for (; i + 4 <= end; i += 4) {
+					const int16x8_t d = vqsubq_s16(vld1q_s16(xy + 2 * i), query);
+					const int32x4_t squares0 = vmull_s16(vget_low_s16(d), vget_low_s16(d));
+					const int32x4_t squares1 = vmull_s16(vget_high_s16(d), vget_high_s16(d));
+					const int32x4_t distance = vpaddq_s32(squares0, squares1); // dx * dx + dy * dy per pillar
+					const uint32x4_t nearer = vcltq_s32(distance, bestDistance);
+					const int32x4_t position = vaddq_s32(vdupq_n_s32(i), laneStep);
+					bestDistance = vbslq_s32(nearer, distance, bestDistance);
+					bestPosition = vbslq_s32(nearer, position, bestPosition);
+				}
+				vst1q_s32(laneDistance, bestDistance);
+				vst1q_s32(lanePosition, bestPosition);
+#endif
+				for (std::size_t lane = 0U; lane < 4U; ++lane) {
+					if (lanePosition[lane] >= 0) {
+						keepNearer(best, laneDistance[lane], lanePosition[lane]);
+					}
+				}
+			}
+#endif
+			for (; i < end; ++i) {
+				const std::int32_t dx = saturate16(static_cast<std::int64_t>(xy[2 * i]) - qx);
+				const std::int32_t dy = saturate16(static_cast<std::int64_t>(xy[2 * i + 1]) - qy);
+				keepNearer(best, dx * dx + dy * dy, i);
+			}
+		}
+	}
+
+	bool QuantizedObstacleTiles::build(const std::vector<sf::Vector2f>& points) {
+		m_cols = 0;
+		m_rows = 0;
+		m_cellStart.clear();
+		m_xy.clear();
+		m_ids.clear();
+		if (points.empty()) {
+			return true;
+		}
+
+		sf::Vector2f minP = points.front();
+		for (const auto& p : points) {
+			minP = { std::min(minP.x, p.x), std::min(minP.y, p.y) };
+		}
+		m_origin = { std::floor(minP.x), std::floor(minP.y) };
+
+		// Cell and tile offset both come from the pillar's whole-map step, like a query's
+		std::vector<std::int64_t> stepX(points.size());
+		std::vector<std::int64_t> stepY(points.size());
+		std::int64_t maxX = 0;
+		std::int64_t maxY = 0;
+		for (std::size_t i = 0U; i < points.size(); ++i) {
+			stepX[i] = std::max<std::int64_t>(toSteps(points[i].x - m_origin.x), 0);
+			stepY[i] = std::max<std::int64_t>(toSteps(points[i].y - m_origin.y), 0);
+			maxX = std::max(maxX, stepX[i]);
+			maxY = std::max(maxY, stepY[i]);
+		}
+		const std::uint64_t budget = std::max(points.size() * MAX_CELLS_PER_PILLAR, MIN_CELL_BUDGET);
+		std::int64_t cellSteps = MIN_CELL_STEPS;
+		const auto cellsAt = [maxX, maxY](std::int64_t steps) {
+			return static_cast<std::uint64_t>(maxX / steps + 1) * static_cast<std::uint64_t>(maxY / steps + 1);
+		};
+		while (cellSteps < TILE_STEPS && cellsAt(cellSteps) > budget) {
+			cellSteps *= 2;
+		}
+		if (cellsAt(cellSteps) > MAX_CELLS) {
+			std::cerr << "Error: pillars spread over " << (maxX / TILE_STEPS + 1) << 'x' << (maxY / TILE_STEPS + 1)
+				<< " tiles of " << TILE_SIZE << " px, too sparse for quantized storage\n";
+			return false;
+		}
+		const std::int64_t cols = maxX / cellSteps + 1;
+		const std::int64_t rows = maxY / cellSteps + 1;
+		m_cellSteps = cellSteps;
+		m_cols = static_cast<int>(cols);
+		m_rows = static_cast<int>(rows);
+
+		// Counting sort into cells; pillars of a cell keep their input order
+		const std::size_t cellCount = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+		std::vector<std::uint32_t> cellOf(points.size());
+		m_cellStart.assign(cellCount + 1U, 0U);
+		for (std::size_t i = 0U; i < points.size(); ++i) {
+			cellOf[i] = static_cast<std::uint32_t>((stepY[i] / cellSteps) * cols + stepX[i] / cellSteps);
+			++m_cellStart[cellOf[i] + 1U];
+		}
+		for (std::size_t c = 0U; c < cellCount; ++c) {
+			m_cellStart[c + 1U] += m_cellStart[c];
+		}
+		std::vector<std::uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+		m_xy.resize(points.size() * 2U);
+		m_ids.resize(points.size());
+		for (std::size_t i = 0U; i < points.size(); ++i) {
+			const std::uint32_t slot = cursor[cellOf[i]]++;
+			m_xy[2U * slot] = static_cast<std::int16_t>(stepX[i] % TILE_STEPS);
+			m_xy[2U * slot + 1U] = static_cast<std::int16_t>(stepY[i] % TILE_STEPS);
+			m_ids[slot] = static_cast<std::uint32_t>(i);
+		}
+		return true;
+	}
+
+	NearestObstacle QuantizedObstacleTiles::nearest(const sf::Vector2f& query, float maxDistance) const {
+		NearestObstacle result;
+		if (m_ids.empty() || !(maxDistance >= 0.0F)) {
+			return result;
+		}
+		const float searchSteps = std::min(maxDistance * static_cast<float>(STEPS_PER_PIXEL), MAX_SEARCH_STEPS);
+		const auto limitSq = static_cast<std::int64_t>(std::floor(static_cast<double>(searchSteps) * searchSteps));
+		const std::int64_t qx = toSteps(query.x - m_origin.x);
+		const std::int64_t qy = toSteps(query.y - m_origin.y);
+		// Nothing to find if the table itself is out of reach
+		const std::int64_t cellSteps = m_cellSteps;
+		const std::int64_t cellsPerTile = TILE_STEPS / cellSteps;
+		const std::int64_t outsideX = std::max<std::int64_t>({ -qx, qx - m_cols * cellSteps, 0 });
+		const std::int64_t outsideY = std::max<std::int64_t>({ -qy, qy - m_rows * cellSteps, 0 });
+		if (outsideX > limitSq || outsideY > limitSq || outsideX * outsideX + outsideY * outsideY > limitSq) {
+			return result;
+		}
+		const std::int64_t cx = floorDiv(qx, cellSteps);
+		const std::int64_t cy = floorDiv(qy, cellSteps);
+		const std::int64_t maxRing = static_cast<std::int64_t>(std::ceil(searchSteps / static_cast<float>(cellSteps))) + 1;
+
+		// Skips cells whose nearest point is already farther than the best pillar
+		const auto scanCell = [&](std::int64_t x, std::int64_t y, TileHit& best) {
+			const std::int64_t dx = std::max<std::int64_t>({ x * cellSteps - qx, qx - (x + 1) * cellSteps, 0 });
+			const std::int64_t dy = std::max<std::int64_t>({ y * cellSteps - qy, qy - (y + 1) * cellSteps, 0 });
+			if (dx * dx + dy * dy > best.distanceSq) {
+				return;
+			}
+			const std::size_t cell = static_cast<std::size_t>(y * m_cols + x);
+			scanCellRun(m_xy.data(), static_cast<std::int32_t>(m_cellStart[cell]), static_cast<std::int32_t>(m_cellStart[cell + 1U]),
+				saturate16(qx - (x / cellsPerTile) * TILE_STEPS), saturate16(qy - (y / cellsPerTile) * TILE_STEPS), best);
+		};
+
+		// Rings of cells around the query's cell, clipped to the table; ring r is at least r - 1
+		// cells plus the query's distance to its own cell's nearest side away. The nearest is taken
+		// by (distance, storage position), so the visiting order cannot decide ties
+		const std::int64_t inset = std::min({ qx - cx * cellSteps, (cx + 1) * cellSteps - qx,
+			qy - cy * cellSteps, (cy + 1) * cellSteps - qy });
+		TileHit best{ static_cast<std::int32_t>(limitSq + 1), -1 };
+		for (std::int64_t ring = 0; ring <= maxRing; ++ring) {
+			const std::int64_t gap = (ring > 0) ? (ring - 1) * cellSteps + inset : 0;
+			const std::int64_t left = cx - ring;
+			const std::int64_t right = cx + ring;
+			const std::int64_t top = cy - ring;
+			const std::int64_t bottom = cy + ring;
+			if (gap * gap > best.distanceSq || (left < 0 && top < 0 && right >= m_cols && bottom >= m_rows && ring > 0)) {
+				break;
+			}
+			const std::int64_t x0 = std::max<std::int64_t>(left, 0);
+			const std::int64_t x1 = std::min<std::int64_t>(right, m_cols - 1);
+			const std::int64_t y0 = std::max<std::int64_t>(top + 1, 0);
+			const std::int64_t y1 = std::min<std::int64_t>(bottom - 1, m_rows - 1);
+			for (std::int64_t x = x0; x <= x1; ++x) {
+				if (top >= 0 && top < m_rows) {
+					scanCell(x, top, best);
+				}
+				if (ring > 0 && bottom >= 0 && bottom < m_rows) {
+					scanCell(x, bottom, best);
+				}
+			}
+			for (std::int64_t y = y0; y <= y1; ++y) {
+				if (left >= 0 && left < m_cols) {
+					scanCell(left, y, best);
+				}
+				if (right >= 0 && right < m_cols) {
+					scanCell(right, y, best);
+				}
+			}
+		}
+		if (best.position >= 0) {
+			constexpr float STEP_SQ = 1.0F / static_cast<float>(STEPS_PER_PIXEL * STEPS_PER_PIXEL);
+			result.distanceSq = static_cast<float>(best.distanceSq) * STEP_SQ;
+			result.index = m_ids[static_cast<std::size_t>(best.position)];
+		}
+		return result;
+	}
+
+} // namespace sim
+
+#undef SIM_QUANTIZED_SSE2
+#undef SIM_QUANTIZED_NEON
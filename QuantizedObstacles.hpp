@@ -0,0 +1,73 @@
+/*
+==============================================================================
+Quantized Obstacles - pillar centers as 16-bit fixed point in tiles
+==============================================================================
+ - Pillars are binned into square tiles of TILE_SIZE px; each is stored
+   as an int16 (x, y) offset from its tile's corner in 1/STEPS_PER_PIXEL
+   px, so a pillar costs 4 bytes of positions instead of 8, and a tile's
+   pillars are one contiguous run
+ - Within a tile pillars are binned into cells of MIN_CELL_SIZE, doubled
+   up to a whole tile for sparse lots, each cell one contiguous run;
+   lookups walk rings of cells around the query and stop once no
+   unvisited ring can hold a nearer pillar
+ - Squared distances are compared in integers: SSE2 or NEON subtract with
+   saturation and multiply-add 4 pillars at a time, a scalar loop that
+   saturates the same way covers the rest of a cell
+ - Integer distances are exact, so the pillar found and its distance are
+   bit-identical on every platform and with or without SIMD; ties go to
+   the pillar stored first
+ - The search radius is limited to below TILE_SIZE, so a difference that
+   saturates int16 always belongs to a pillar out of range; distances
+   differ from the float grid's by at most the quantization step
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+#include "ObstacleGrid.hpp"
+
+namespace sim {
+
+	class QuantizedObstacleTiles {
+	public:
+		static constexpr float TILE_SIZE = 512.0F;
+		static constexpr float MIN_CELL_SIZE = 64.0F; // TILE_SIZE / a power of two
+		static constexpr std::int32_t STEPS_PER_PIXEL = 32;
+
+		/**
+		 * @brief Replaces the stored pillars; ids are positions in points, as with ObstacleGrid::build().
+		 *
+		 * MISRA: returns false (logged, nothing stored) if the pillars spread
+		 *        over far more tiles than there are pillars.
+		 */
+		[[nodiscard]] bool build(const std::vector<sf::Vector2f>& points);
+
+		/**
+		 * @brief Nearest pillar within maxDistance: its build() index and squared distance.
+		 *
+		 * wallDistance is left at max; walls and polygons are not stored here.
+		 * MISRA: maxDistance is limited to just below TILE_SIZE.
+		 */
+		[[nodiscard]] NearestObstacle nearest(const sf::Vector2f& query, float maxDistance) const;
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_ids.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_ids.empty(); }
+
+	private:
+		sf::Vector2f m_origin{ 0.0F, 0.0F }; // corner of tile and cell (0, 0), whole pixels
+		std::int64_t m_cellSteps = 0;        // cell side in steps, divides a tile's
+		int m_cols = 0; // cells
+		int m_rows = 0;
+		std::vector<std::uint32_t> m_cellStart; // cell c holds pillars [m_cellStart[c], m_cellStart[c + 1])
+		prof::TrackedVector<std::int16_t, prof::MemorySubsystem::Obstacles> m_xy; // x, y per pillar from its tile's corner, cell by cell
+		prof::TrackedVector<std::uint32_t, prof::MemorySubsystem::Obstacles> m_ids;
+	};
+
+} // namespace sim
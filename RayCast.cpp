@@ -0,0 +1,283 @@
+#include "RayCast.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "FastTrig.hpp"
+#include "ObstacleGrid.hpp"
+#include "Sensors.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr float NO_HIT = std::numeric_limits<float>::max();
+
+		// Upper bound on cells per shape, as in ObstacleGrid
+		constexpr std::size_t MAX_CELLS_PER_CIRCLE = 4U;
+
+		// A sensor's facing is the long axis of its rectangle (local +Y)
+		constexpr float SENSOR_FACING_OFFSET_DEG = 90.0F;
+
+		[[nodiscard]] sf::FloatRect circleRect(const Obstacle& circle) {
+			const sf::Vector2f half{ circle.radius, circle.radius };
+			return { circle.center - half, half * 2.0F };
+		}
+
+		[[nodiscard]] float hitCircle(const Obstacle& circle, const sf::Vector2f& origin, const sf::Vector2f& direction) {
+			const sf::Vector2f m = origin - circle.center;
+			const float b = m.dot(direction);
+			const float c = m.dot(m) - circle.radius * circle.radius;
+			if (c > 0.0F && b > 0.0F) {
+				return NO_HIT; // outside and pointing away
+			}
+			const float discriminant = b * b - c;
+			if (discriminant < 0.0F) {
+				return NO_HIT;
+			}
+			return std::max(-b - std::sqrt(discriminant), 0.0F);
+		}
+
+		// Slab test on one axis; narrows [tMin, tMax] or reports a miss
+		[[nodiscard]] bool clipSlab(float origin, float direction, float lo, float hi, float& tMin, float& tMax) {
+			if (direction == 0.0F) {
+				return origin >= lo && origin <= hi;
+			}
+			const float inv = 1.0F / direction;
+			float t0 = (lo - origin) * inv;
+			float t1 = (hi - origin) * inv;
+			if (t0 > t1) {
+				std::swap(t0, t1);
+			}
+			tMin = std::max(tMin, t0);
+			tMax = std::min(tMax, t1);
+			return tMin <= tMax;
+		}
+
+		[[nodiscard]] float hitBox(const sf::FloatRect& box, const sf::Vector2f& origin, const sf::Vector2f& direction) {
+			float tMin = 0.0F;
+			float tMax = NO_HIT;
+			if (!clipSlab(origin.x, direction.x, box.position.x, box.position.x + box.size.x, tMin, tMax)
+				|| !clipSlab(origin.y, direction.y, box.position.y, box.position.y + box.size.y, tMin, tMax)) {
+				return NO_HIT;
+			}
+			return tMin;
+		}
+	}
+
+	void RayCaster::build(const std::vector<Obstacle>& circles, const std::vector<sf::FloatRect>& boxes, float cellSize,
+		const PolygonSet& polygons)
+	{
+		m_polygons.build(polygons);
+		m_circles = circles;
+		m_boxes = boxes;
+		m_cellStart.clear();
+		m_cellShapes.clear();
+		m_cols = 0;
+		m_rows = 0;
+
+		std::vector<sf::FloatRect> bounds;
+		bounds.reserve(circles.size() + boxes.size());
+		for (const auto& circle : circles) {
+			bounds.push_back(circleRect(circle));
+		}
+		bounds.insert(bounds.end(), boxes.begin(), boxes.end());
+
+		if (bounds.empty()) {
+			return;
+		}
+
+		sf::Vector2f minP = bounds.front().position;
+		sf::Vector2f maxP = bounds.front().position + bounds.front().size;
+		for (const auto& b : bounds) {
+			minP.x = std::min(minP.x, b.position.x);
+			minP.y = std::min(minP.y, b.position.y);
+			maxP.x = std::max(maxP.x, b.position.x + b.size.x);
+			maxP.y = std::max(maxP.y, b.position.y + b.size.y);
+		}
+
+		const float extent = std::max({ maxP.x - minP.x, maxP.y - minP.y, 1.0F });
+		m_cellSize = (cellSize > 0.0F) ? cellSize : extent;
+
+		const std::size_t maxCells = bounds.size() * MAX_CELLS_PER_CIRCLE;
+		for (;;) {
+			m_cols = static_cast<int>((maxP.x - minP.x) / m_cellSize) + 1;
+			m_rows = static_cast<int>((maxP.y - minP.y) / m_cellSize) + 1;
+			if (static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows) <= maxCells) {
+				break;
+			}
+			m_cellSize *= 2.0F;
+		}
+		m_origin = minP;
+
+		const auto cellRange = [&](const sf::FloatRect& b, int& x0, int& y0, int& x1, int& y1) {
+			x0 = std::clamp(static_cast<int>((b.position.x - m_origin.x) / m_cellSize), 0, m_cols - 1);
+			y0 = std::clamp(static_cast<int>((b.position.y - m_origin.y) / m_cellSize), 0, m_rows - 1);
+			x1 = std::clamp(static_cast<int>((b.position.x + b.size.x - m_origin.x) / m_cellSize), 0, m_cols - 1);
+			y1 = std::clamp(static_cast<int>((b.position.y + b.size.y - m_origin.y) / m_cellSize), 0, m_rows - 1);
+		};
+
+		// Two-pass counting sort: count shapes per cell, then scatter the references
+		const std::size_t cellCount = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+		m_cellStart.assign(cellCount + 1U, 0U);
+		int x0 = 0;
+		int y0 = 0;
+		int x1 = 0;
+		int y1 = 0;
+		for (const auto& b : bounds) {
+			cellRange(b, x0, y0, x1, y1);
+			for (int y = y0; y <= y1; ++y) {
+				for (int x = x0; x <= x1; ++x) {
+					++m_cellStart[static_cast<std::size_t>(y * m_cols + x) + 1U];
+				}
+			}
+		}
+		for (std::size_t c = 0U; c < cellCount; ++c) {
+			m_cellStart[c + 1U] += m_cellStart[c];
+		}
+
+		std::vector<std::uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+		m_cellShapes.resize(m_cellStart.back());
+		for (std::size_t i = 0U; i < bounds.size(); ++i) {
+			const std::uint32_t shape = (i < circles.size())
+				? static_cast<std::uint32_t>(i)
+				: (static_cast<std::uint32_t>(i - circles.size()) | BOX_BIT);
+			cellRange(bounds[i], x0, y0, x1, y1);
+			for (int y = y0; y <= y1; ++y) {
+				for (int x = x0; x <= x1; ++x) {
+					m_cellShapes[cursor[static_cast<std::size_t>(y * m_cols + x)]++] = shape;
+				}
+			}
+		}
+	}
+
+	void RayCaster::hitShape(std::uint32_t shape, const sf::Vector2f& origin,
+		const sf::Vector2f& direction, RayHit& best) const
+	{
+		const bool box = (shape & BOX_BIT) != 0U;
+		const float t = box
+			? hitBox(m_boxes[shape & ~BOX_BIT], origin, direction)
+			: hitCircle(m_circles[shape], origin, direction);
+		if (t < best.distance) {
+			best.distance = t;
+			best.circle = box ? NO_OBSTACLE : shape;
+		}
+	}
+
+	RayHit RayCaster::castRayHit(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const {
+		if (m_polygons.contains(origin)) {
+			return { 0.0F, NO_OBSTACLE };
+		}
+		return castOutside(origin, direction, maxDistance);
+	}
+
+	RayHit RayCaster::castOutside(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const {
+		RayHit best = castGrid(origin, direction, maxDistance);
+		if (!m_polygons.empty()) {
+			const PolygonHit hit = m_polygons.firstCrossing(origin, direction, std::min(best.distance, maxDistance));
+			if (hit.distance < best.distance) {
+				best = { hit.distance, NO_OBSTACLE };
+			}
+		}
+		return best;
+	}
+
+	RayHit RayCaster::castGrid(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const {
+		if (m_cellStart.empty()) {
+			return {};
+		}
+
+		// Clip the ray to the grid so traversal starts at the first covered cell
+		const float gridW = static_cast<float>(m_cols) * m_cellSize;
+		const float gridH = static_cast<float>(m_rows) * m_cellSize;
+		float tEnter = 0.0F;
+		float tExit = maxDistance;
+		if (!clipSlab(origin.x, direction.x, m_origin.x, m_origin.x + gridW, tEnter, tExit)
+			|| !clipSlab(origin.y, direction.y, m_origin.y, m_origin.y + gridH, tEnter, tExit)) {
+			return {};
+		}
+
+		const sf::Vector2f start = origin + direction * tEnter - m_origin;
+		int cx = std::clamp(static_cast<int>(start.x / m_cellSize), 0, m_cols - 1);
+		int cy = std::clamp(static_cast<int>(start.y / m_cellSize), 0, m_rows - 1);
+
+		// DDA set-up: ray parameter at the next vertical / horizontal cell boundary
+		const int stepX = (direction.x > 0.0F) ? 1 : -1;
+		const int stepY = (direction.y > 0.0F) ? 1 : -1;
+		const float deltaX = (direction.x != 0.0F) ? m_cellSize / std::fabs(direction.x) : NO_HIT;
+		const float deltaY = (direction.y != 0.0F) ? m_cellSize / std::fabs(direction.y) : NO_HIT;
+		const auto boundaryT = [&](int cell, int step, float o, float gridOrigin, float d) {
+			if (d == 0.0F) {
+				return NO_HIT;
+			}
+			const float edge = gridOrigin + static_cast<float>(cell + ((step > 0) ? 1 : 0)) * m_cellSize;
+			return (edge - o) / d;
+		};
+		float nextX = boundaryT(cx, stepX, origin.x, m_origin.x, direction.x);
+		float nextY = boundaryT(cy, stepY, origin.y, m_origin.y, direction.y);
+
+		RayHit best;
+		best.distance = maxDistance;
+		for (;;) {
+			const std::size_t cell = static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_cols)
+				+ static_cast<std::size_t>(cx);
+			for (std::uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1U]; ++i) {
+				hitShape(m_cellShapes[i], origin, direction, best);
+			}
+
+			// A hit before this cell's exit cannot be beaten by any later cell
+			const float cellExit = std::min(nextX, nextY);
+			if (best.distance <= cellExit || cellExit >= tExit) {
+				break;
+			}
+
+			if (nextX < nextY) {
+				cx += stepX;
+				nextX += deltaX;
+			}
+			else {
+				cy += stepY;
+				nextY += deltaY;
+			}
+			if (cx < 0 || cy < 0 || cx >= m_cols || cy >= m_rows) {
+				break;
+			}
+		}
+
+		return (best.distance < maxDistance) ? best : RayHit{};
+	}
+
+	RayHit RayCaster::castConeHit(const sf::Vector2f& origin, float facingDeg, const RayCone& cone) const {
+		const std::uint32_t rays = std::max<std::uint32_t>(cone.rayCount, 1U);
+		const float firstDeg = (rays > 1U) ? facingDeg - cone.halfAngleDeg : facingDeg;
+		const float stepDeg = (rays > 1U) ? (2.0F * cone.halfAngleDeg) / static_cast<float>(rays - 1U) : 0.0F;
+
+		// Every ray starts at origin, so one inside test covers the cone
+		if (m_polygons.contains(origin)) {
+			return { 0.0F, NO_OBSTACLE };
+		}
+		RayHit closest;
+		for (std::uint32_t i = 0U; i < rays; ++i) {
+			const SinCos angle = sinCosDeg(firstDeg + static_cast<float>(i) * stepDeg);
+			const sf::Vector2f direction{ angle.cos, angle.sin };
+			const RayHit hit = castOutside(origin, direction, cone.maxDistance);
+			if (hit.distance < closest.distance) {
+				closest = hit;
+			}
+		}
+		return closest;
+	}
+
+	void readSensors(const std::vector<SensorPose>& sensors, const RayCaster& caster, const RayCone& cone,
+		const ObstacleGrid& walls, std::vector<SensorReading>& readings)
+	{
+		readings.resize(sensors.size());
+		for (std::size_t i = 0U; i < sensors.size(); ++i) {
+			const RayHit hit = caster.castConeHit(sensors[i].position, sensors[i].rotationDeg + SENSOR_FACING_OFFSET_DEG, cone);
+			readings[i].obstacle = hit.circle;
+			readings[i].distanceSq = (hit.distance < NO_HIT) ? hit.distance * hit.distance : NO_HIT;
+			readings[i].wallDistance = walls.nearestWall(sensors[i].position, cone.maxDistance);
+		}
+	}
+
+} // namespace sim
@@ -0,0 +1,453 @@
+#include "RegionFleet.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "CarModel.hpp"
+#include "Collision.hpp"
+#include "Constants.hpp"
+#include "Fleet.hpp"
+#include "FrameArena.hpp"
+#include "ObstacleGrid.hpp"
+#include "Parking.hpp"
+#include "Scene.hpp"
+#include "SensorQuery.hpp"
+#include "Sensors.hpp"
+#include "Trace.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr std::uint8_t REGION_HALO_MESSAGE = 1U;
+		constexpr std::uint8_t REGION_HANDOFF_MESSAGE = 2U;
+
+		// Collision scratch of one region; a sweep only needs its candidate list
+		constexpr std::size_t REGION_SCRATCH_BYTES = 4096U;
+
+		constexpr std::uint64_t REGION_NOT_DUE = std::numeric_limits<std::uint64_t>::max();
+
+		// One car as it travels between regions
+		struct RegionCar {
+			std::uint32_t id = 0U;
+			CarState pose;
+			std::uint32_t traceCursor = 0U;
+			float interval = 0.0F;       // most urgent sensor interval, as last scheduled (0 = silent)
+			std::uint32_t beepTicks = 0U;
+			std::uint64_t lastBeepTick = 0U;
+			std::uint64_t due = REGION_NOT_DUE; // tick the next beep fires, as a BeepWheel would
+			std::uint32_t beeps = 0U;
+			std::uint32_t occupiedTicks = 0U;
+			std::uint32_t contactTicks = 0U;
+		};
+
+		template <typename T>
+		void putRegionField(RegionMessage& message, const T& value) {
+			const std::size_t at = message.size();
+			message.resize(at + sizeof(T));
+			std::memcpy(message.data() + at, &value, sizeof(T));
+		}
+
+		template <typename T>
+		[[nodiscard]] bool takeRegionField(const RegionMessage& message, std::size_t& at, T& value) {
+			if (message.size() - at < sizeof(T)) {
+				return false;
+			}
+			std::memcpy(&value, message.data() + at, sizeof(T));
+			at += sizeof(T);
+			return true;
+		}
+
+		[[nodiscard]] RegionMessage regionHeader(std::uint8_t kind, std::size_t from, std::size_t count) {
+			RegionMessage message;
+			putRegionField(message, kind);
+			putRegionField(message, static_cast<std::uint32_t>(from));
+			putRegionField(message, static_cast<std::uint32_t>(count));
+			return message;
+		}
+
+		// Reads a header; false if it is short or not kind from from
+		[[nodiscard]] bool takeRegionHeader(const RegionMessage& message, std::uint8_t kind, std::size_t from,
+			std::size_t& at, std::uint32_t& count)
+		{
+			std::uint8_t gotKind = 0U;
+			std::uint32_t gotFrom = 0U;
+			return takeRegionField(message, at, gotKind) && takeRegionField(message, at, gotFrom)
+				&& takeRegionField(message, at, count) && gotKind == kind && gotFrom == from;
+		}
+
+		void putRegionCar(RegionMessage& message, const RegionCar& car) {
+			putRegionField(message, car.id);
+			putRegionField(message, car.pose.position.x);
+			putRegionField(message, car.pose.position.y);
+			putRegionField(message, car.pose.headingDeg);
+			putRegionField(message, car.traceCursor);
+			putRegionField(message, car.interval);
+			putRegionField(message, car.beepTicks);
+			putRegionField(message, car.lastBeepTick);
+			putRegionField(message, car.due);
+			putRegionField(message, car.beeps);
+			putRegionField(message, car.occupiedTicks);
+			putRegionField(message, car.contactTicks);
+		}
+
+		[[nodiscard]] bool takeRegionCar(const RegionMessage& message, std::size_t& at, RegionCar& car) {
+			return takeRegionField(message, at, car.id)
+				&& takeRegionField(message, at, car.pose.position.x)
+				&& takeRegionField(message, at, car.pose.position.y)
+				&& takeRegionField(message, at, car.pose.headingDeg)
+				&& takeRegionField(message, at, car.traceCursor)
+				&& takeRegionField(message, at, car.interval)
+				&& takeRegionField(message, at, car.beepTicks)
+				&& takeRegionField(message, at, car.lastBeepTick)
+				&& takeRegionField(message, at, car.due)
+				&& takeRegionField(message, at, car.beeps)
+				&& takeRegionField(message, at, car.occupiedTicks)
+				&& takeRegionField(message, at, car.contactTicks);
+		}
+
+		// Equal-width vertical strips over the scene bounds; the outer two reach to infinity
+		class RegionStrips {
+		public:
+			RegionStrips(const sf::FloatRect& bounds, std::size_t regions)
+				: m_left(bounds.position.x)
+				, m_width(bounds.size.x / static_cast<float>(regions))
+				, m_regions(regions)
+			{
+			}
+
+			[[nodiscard]] std::size_t owner(float x) const noexcept {
+				const float strip = std::floor((x - m_left) / m_width);
+				if (!(strip > 0.0F)) {
+					return 0U;
+				}
+				return std::min(static_cast<std::size_t>(strip), m_regions - 1U);
+			}
+
+			// Horizontal distance from x to region's strip (0 inside it)
+			[[nodiscard]] float distance(float x, std::size_t region) const noexcept {
+				const float left = m_left + static_cast<float>(region) * m_width;
+				const float right = left + m_width;
+				if (region > 0U && x < left) {
+					return left - x;
+				}
+				if (region + 1U < m_regions && x >= right) {
+					return x - right;
+				}
+				return 0.0F;
+			}
+
+		private:
+			float m_left;
+			float m_width;
+			std::size_t m_regions;
+		};
+
+		// Message queues between every ordered pair of regions in one process
+		class LocalRegionMailboxes {
+		public:
+			explicit LocalRegionMailboxes(std::size_t count) : m_count(count), m_queues(count * count) {}
+
+			void send(std::size_t from, std::size_t to, RegionMessage message) {
+				{
+					const std::lock_guard<std::mutex> lock(m_mutex);
+					m_queues[to * m_count + from].push_back(std::move(message));
+				}
+				m_arrived.notify_all();
+			}
+
+			[[nodiscard]] bool receive(std::size_t to, std::size_t from, RegionMessage& message) {
+				std::unique_lock<std::mutex> lock(m_mutex);
+				std::deque<RegionMessage>& queue = m_queues[to * m_count + from];
+				m_arrived.wait(lock, [&queue]() { return !queue.empty(); });
+				message = std::move(queue.front());
+				queue.pop_front();
+				return true;
+			}
+
+		private:
+			std::size_t m_count;
+			std::mutex m_mutex;
+			std::condition_variable m_arrived;
+			std::vector<std::deque<RegionMessage>> m_queues; // [to * count + from]
+		};
+
+		void sendRegionMessage(const RegionLink& link, std::size_t to, RegionMessage message, RegionStats& stats) {
+			++stats.messages;
+			stats.messageBytes += message.size();
+			link.send(to, std::move(message));
+		}
+	}
+
+	void RegionStats::merge(const RegionStats& other) {
+		carTicks += other.carTicks;
+		beeps += other.beeps;
+		occupiedTicks += other.occupiedTicks;
+		contactTicks += other.contactTicks;
+		handoffs += other.handoffs;
+		haloPillars += other.haloPillars;
+		messages += other.messages;
+		messageBytes += other.messageBytes;
+		wallSeconds = std::max(wallSeconds, other.wallSeconds);
+	}
+
+	std::vector<RegionLink> localRegionLinks(std::size_t count) {
+		const auto mailboxes = std::make_shared<LocalRegionMailboxes>(count);
+		std::vector<RegionLink> links(count);
+		for (std::size_t region = 0U; region < count; ++region) {
+			links[region].send = [mailboxes, region](std::size_t to, RegionMessage message) {
+				mailboxes->send(region, to, std::move(message));
+			};
+			links[region].receive = [mailboxes, region](std::size_t from, RegionMessage& message) {
+				return mailboxes->receive(region, from, message);
+			};
+		}
+		return links;
+	}
+
+	bool runFleetRegion(const Scene& scene, const std::vector<TraceSegment>& trace, float tickHz,
+		std::size_t carCount, std::uint32_t ticks, const WarningProfile& profile, std::size_t region,
+		std::size_t regions, const RegionLink& link, RegionStats& stats)
+	{
+		OKPP_TRACE_SCOPE("fleet region");
+		const auto start = std::chrono::steady_clock::now();
+		stats = {};
+		const float dt = 1.0F / tickHz;
+		const CarParams carParams{ constants::CAR_SPEED, constants::CAR_TURN_RATE };
+		const RegionStrips strips(sceneBounds(scene), regions);
+
+		std::vector<CarInput> inputs;
+		for (const auto& segment : trace) {
+			inputs.insert(inputs.end(), segment.ticks, segment.input);
+		}
+		if (inputs.empty()) {
+			inputs.push_back(0U);
+		}
+
+		// Farther than this from a strip, a pillar cannot touch or be sensed from any car
+		// the strip holds before the next hand-off
+		float largestRadius = 0.0F;
+		for (const Obstacle& obstacle : scene.obstacles) {
+			largestRadius = std::max(largestRadius, obstacle.radius);
+		}
+		const float carReach = std::hypot(scene.carHalfExtent.x, scene.carHalfExtent.y);
+		const float haloWidth = static_cast<float>(REGION_EXCHANGE_TICKS) * carParams.speed * dt + 2.0F * carReach
+			+ profile.range() + largestRadius + 1.0F;
+
+		// Own pillars, then each peer's halo of its own
+		std::vector<Obstacle> pillars;
+		for (const Obstacle& obstacle : scene.obstacles) {
+			if (strips.owner(obstacle.center.x) == region) {
+				pillars.push_back(obstacle);
+			}
+		}
+		const std::size_t ownPillars = pillars.size();
+		for (std::size_t peer = 0U; peer < regions; ++peer) {
+			if (peer == region) {
+				continue;
+			}
+			std::vector<const Obstacle*> halo;
+			for (std::size_t i = 0U; i < ownPillars; ++i) {
+				if (strips.distance(pillars[i].center.x, peer) <= haloWidth + pillars[i].radius) {
+					halo.push_back(&pillars[i]);
+				}
+			}
+			RegionMessage message = regionHeader(REGION_HALO_MESSAGE, region, halo.size());
+			for (const Obstacle* obstacle : halo) {
+				putRegionField(message, obstacle->center.x);
+				putRegionField(message, obstacle->center.y);
+				putRegionField(message, obstacle->radius);
+			}
+			sendRegionMessage(link, peer, std::move(message), stats);
+		}
+		for (std::size_t peer = 0U; peer < regions; ++peer) {
+			if (peer == region) {
+				continue;
+			}
+			RegionMessage message;
+			std::size_t at = 0U;
+			std::uint32_t count = 0U;
+			if (!link.receive(peer, message) || !takeRegionHeader(message, REGION_HALO_MESSAGE, peer, at, count)) {
+				std::cerr << "Error: region " << region << " got no halo from region " << peer << '\n';
+				return false;
+			}
+			for (std::uint32_t i = 0U; i < count; ++i) {
+				Obstacle obstacle;
+				if (!takeRegionField(message, at, obstacle.center.x) || !takeRegionField(message, at, obstacle.center.y)
+					|| !takeRegionField(message, at, obstacle.radius))
+				{
+					std::cerr << "Error: region " << region << " got a truncated halo from region " << peer << '\n';
+					return false;
+				}
+				pillars.push_back(obstacle);
+			}
+			stats.haloPillars += count;
+		}
+
+		ObstacleGrid grid;
+		grid.build(obstacleCenters(pillars), constants::OBSTACLE_CELL_SIZE, sceneWalls(scene, sceneBounds(scene)),
+			scene.polygons);
+		CollisionWorld collisionWorld;
+		collisionWorld.build(pillars, {}, constants::OBSTACLE_CELL_SIZE);
+
+		// Every region spawns the fleet the same way and keeps the cars in its strip
+		std::vector<RegionCar> cars;
+		for (std::size_t i = 0U; i < carCount; ++i) {
+			RegionCar car;
+			car.id = static_cast<std::uint32_t>(i);
+			car.pose = fleetSpawnPose(scene, i);
+			car.traceCursor = fleetTracePhase(i, inputs.size());
+			if (strips.owner(car.pose.position.x) == region) {
+				cars.push_back(car);
+			}
+		}
+
+		const std::vector<SensorMount> mounts = createSensorMounts(scene.carHalfExtent, profile.rig());
+		std::vector<SensorPose> poses(mounts.size());
+		std::vector<SensorReading> readings(mounts.size());
+		const SensorSource sensors{ &grid, nullptr, profile.range() };
+		const bool hasBay = !scene.parkBays.empty();
+		FrameArena scratch(REGION_SCRATCH_BYTES);
+
+		std::vector<std::vector<RegionCar>> leaving(regions);
+		for (std::uint64_t tick = 0U; tick < ticks;) {
+			const std::uint64_t roundEnd = std::min<std::uint64_t>(tick + REGION_EXCHANGE_TICKS, ticks);
+			for (RegionCar& car : cars) {
+				// FleetSimulation::stepRange() and senseRange() for one car, its wheel replaced by the due tick
+				for (std::uint64_t t = tick; t < roundEnd; ++t) {
+					const CarInput input = inputs[car.traceCursor];
+					if (stepCarWithCollisions(car.pose, input, carParams, dt, collisionWorld, scene.carHalfExtent, scratch)) {
+						++car.contactTicks;
+					}
+					car.traceCursor = static_cast<std::uint32_t>((car.traceCursor + 1U) % inputs.size());
+					if (hasBay && parkOccupied(carBounds(car.pose, scene.carHalfExtent), scene.parkBays.front())) {
+						++car.occupiedTicks;
+					}
+
+					placeSensors(carTransform(car.pose), car.pose.headingDeg, mounts.data(), mounts.size(), poses.data());
+					querySensors(sensors, poses.data(), poses.size(), readings.data());
+					float interval = 0.0F;
+					for (std::size_t i = 0U; i < mounts.size(); ++i) {
+						interval = moreUrgent(interval, profile.interval(mounts[i].zone, readings[i].distanceSq));
+					}
+					if (interval != car.interval) {
+						car.interval = interval;
+						if (interval > 0.0F) {
+							car.beepTicks = fleetBeepTicks(interval, dt);
+							car.due = car.lastBeepTick + car.beepTicks;
+						}
+						else {
+							car.due = REGION_NOT_DUE;
+						}
+					}
+					const std::uint64_t now = t + 1U;
+					if (car.due <= now) {
+						++car.beeps;
+						car.lastBeepTick = now;
+						car.due = now + car.beepTicks;
+					}
+				}
+			}
+			stats.carTicks += static_cast<std::uint64_t>(cars.size()) * (roundEnd - tick);
+			tick = roundEnd;
+			if (tick == ticks) {
+				break;
+			}
+
+			// Hand off the cars that left the strip, one message per peer
+			std::vector<RegionCar> staying;
+			staying.reserve(cars.size());
+			for (const RegionCar& car : cars) {
+				const std::size_t owner = strips.owner(car.pose.position.x);
+				(owner == region ? staying : leaving[owner]).push_back(car);
+			}
+			for (std::size_t peer = 0U; peer < regions; ++peer) {
+				if (peer == region) {
+					continue;
+				}
+				RegionMessage message = regionHeader(REGION_HANDOFF_MESSAGE, region, leaving[peer].size());
+				for (const RegionCar& car : leaving[peer]) {
+					putRegionCar(message, car);
+				}
+				leaving[peer].clear();
+				sendRegionMessage(link, peer, std::move(message), stats);
+			}
+			for (std::size_t peer = 0U; peer < regions; ++peer) {
+				if (peer == region) {
+					continue;
+				}
+				RegionMessage message;
+				std::size_t at = 0U;
+				std::uint32_t count = 0U;
+				if (!link.receive(peer, message) || !takeRegionHeader(message, REGION_HANDOFF_MESSAGE, peer, at, count)) {
+					std::cerr << "Error: region " << region << " lost the hand-off from region " << peer << '\n';
+					return false;
+				}
+				for (std::uint32_t i = 0U; i < count; ++i) {
+					RegionCar car;
+					if (!takeRegionCar(message, at, car)) {
+						std::cerr << "Error: region " << region << " got a truncated hand-off from region " << peer << '\n';
+						return false;
+					}
+					staying.push_back(car);
+				}
+				stats.handoffs += count;
+			}
+			// Spawn order, whoever sent them
+			std::sort(staying.begin(), staying.end(),
+				[](const RegionCar& a, const RegionCar& b) { return a.id < b.id; });
+			cars.swap(staying);
+		}
+
+		for (const RegionCar& car : cars) {
+			stats.beeps += car.beeps;
+			stats.occupiedTicks += car.occupiedTicks;
+			stats.contactTicks += car.contactTicks;
+		}
+		stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return true;
+	}
+
+	bool runRegionFleet(const Scene& scene, const std::vector<TraceSegment>& trace, float tickHz,
+		std::size_t carCount, std::uint32_t ticks, const WarningProfile& profile, std::size_t regions,
+		RegionStats& stats)
+	{
+		regions = std::max<std::size_t>(1U, regions);
+		const std::vector<RegionLink> links = localRegionLinks(regions);
+		std::vector<RegionStats> shares(regions);
+		std::vector<char> succeeded(regions, 0);
+
+		// A thread per region stands in for a process: regions block on each other's messages
+		std::vector<std::thread> threads;
+		threads.reserve(regions);
+		for (std::size_t region = 0U; region < regions; ++region) {
+			threads.emplace_back([&, region]() {
+				prof::setThreadName("fleet region");
+				succeeded[region] = runFleetRegion(scene, trace, tickHz, carCount, ticks, profile, region, regions,
+					links[region], shares[region]) ? 1 : 0;
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+
+		stats = {};
+		bool ok = true;
+		for (std::size_t region = 0U; region < regions; ++region) {
+			stats.merge(shares[region]);
+			ok = ok && succeeded[region] != 0;
+		}
+		return ok;
+	}
+
+} // namespace sim
@@ -0,0 +1,96 @@
+/*
+==============================================================================
+Region Fleet - a fleet split into spatial regions that exchange messages
+==============================================================================
+ - The lot is cut into vertical strips of equal width, one per region;
+   the outer strips reach to infinity. A region owns the pillars whose
+   centers and the cars whose positions lie in its strip, and nothing
+   else: it could be another process, or another machine
+ - At start every region sends each other region one batched halo
+   message with its pillars near that region's strip: closer than the
+   warning range plus the car's reach plus how far a car can drive
+   between two exchanges. A region's grid and collision world hold its
+   own pillars and the halos, so its cars sense and collide exactly as
+   they would against the whole lot
+ - Regions run EXCHANGE_TICKS ticks on their own, then hand every car
+   that has left their strip to the region now holding it, in one
+   message per peer per exchange (empty ones included, so a receiver
+   knows the round is complete)
+ - Cars are stepped in spawn order whatever region holds them, with the
+   fleet's spawn layout, trace phases, sensor pass and beep timing, so
+   arcade runs give the same beeps, occupied ticks and contacts as a
+   FleetSimulation of the same cars
+ - Messages are bytes (little-endian, fixed-width fields) behind a
+   RegionLink of send and receive functions; localRegionLinks() connects
+   regions in one process, a socket transport plugs in the same way
+ - Wire format: kind u8 | from u32 | count u32 | records; halo record:
+   x f32, y f32, radius f32; car record: id u32, x f32, y f32, heading
+   f32, trace cursor u32, interval f32, beep ticks u32, last beep u64,
+   due u64, beeps u32, occupied ticks u32, contact ticks u32
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Headless.hpp"
+#include "SimFwd.hpp"
+
+namespace sim {
+
+	// Ticks each region runs between two hand-offs
+	constexpr std::uint32_t REGION_EXCHANGE_TICKS = 8U;
+
+	using RegionMessage = std::vector<std::uint8_t>;
+
+	// One region's end of the transport
+	struct RegionLink {
+		std::function<void(std::size_t to, RegionMessage message)> send;
+		// Blocks until the next message from region from; false if the peer is gone
+		std::function<bool(std::size_t from, RegionMessage& message)> receive;
+	};
+
+	/**
+	 * @brief Links for count regions in one process, message queues between every pair.
+	 *
+	 * The queues live as long as any returned link.
+	 */
+	[[nodiscard]] std::vector<RegionLink> localRegionLinks(std::size_t count);
+
+	struct RegionStats {
+		std::uint64_t carTicks = 0U;
+		std::uint64_t beeps = 0U;
+		std::uint64_t occupiedTicks = 0U;
+		std::uint64_t contactTicks = 0U;
+		std::uint64_t handoffs = 0U;     // cars received from another region
+		std::uint64_t haloPillars = 0U;  // pillars received as halo
+		std::uint64_t messages = 0U;     // sent
+		std::uint64_t messageBytes = 0U; // sent
+		double wallSeconds = 0.0;
+
+		void merge(const RegionStats& other);
+	};
+
+	/**
+	 * @brief Runs region region of regions for ticks steps of carCount fleet cars (arcade model).
+	 *
+	 * Every region must be started with the same scene, trace, tick rate,
+	 * car count, ticks and profile; each reports its own share.
+	 * MISRA: returns false (logged) if a peer drops out or sends a bad message.
+	 */
+	[[nodiscard]] bool runFleetRegion(const Scene& scene, const std::vector<TraceSegment>& trace, float tickHz,
+		std::size_t carCount, std::uint32_t ticks, const WarningProfile& profile, std::size_t region,
+		std::size_t regions, const RegionLink& link, RegionStats& stats);
+
+	/**
+	 * @brief All regions of a fleet run in this process, one thread each, over localRegionLinks().
+	 */
+	[[nodiscard]] bool runRegionFleet(const Scene& scene, const std::vector<TraceSegment>& trace, float tickHz,
+		std::size_t carCount, std::uint32_t ticks, const WarningProfile& profile, std::size_t regions,
+		RegionStats& stats);
+
+} // namespace sim
@@ -0,0 +1,29 @@
+#include "RenderQueue.hpp"
+
+namespace gfx {
+
+	void RenderQueue::push(std::uint8_t layer, const sf::Drawable& drawable, const sf::Texture* texture,
+		const sf::Shader* shader, std::uint32_t depth)
+	{
+		(void)m_order.push(layer, reinterpret_cast<DrawResource>(texture), reinterpret_cast<DrawResource>(shader), depth);
+		m_drawables.push_back(&drawable);
+	}
+
+	void RenderQueue::submit(sf::RenderTarget& target) {
+		const sf::View saved = target.getView();
+		const sf::View* currentView = nullptr;
+		for (const DrawOrder::Entry& entry : m_order.sort()) {
+			const sf::View* view = m_views[DrawOrder::layerOf(entry.key)];
+			if (view != nullptr && view != currentView) {
+				target.setView(*view);
+				currentView = view;
+			}
+			target.draw(*m_drawables[entry.draw]);
+		}
+		target.setView(saved);
+
+		m_order.clear();
+		m_drawables.clear();
+	}
+
+} // namespace gfx
@@ -0,0 +1,81 @@
+/*
+==============================================================================
+Render Queue - a frame's draws collected, sorted by key, then submitted
+==============================================================================
+ - The SFML side of DrawOrder: items are sorted by layer, shader, texture
+   and depth with the same keys and the same stable radix sort as the
+   GLUT variant's QuadQueue
+ - Each layer may carry its own view (world layers the camera, screen
+   layers the default view); submit() switches views only between layers
+ - Items point at drawables owned by the caller; those must outlive submit()
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "DrawOrder.hpp"
+
+namespace gfx {
+
+	/**
+	 * @brief Adapts a draw routine that is not an sf::Drawable (or needs extra arguments) to the queue.
+	 *
+	 * Build it once, outside the frame loop; the routine's captures are read at submit time.
+	 */
+	class DrawCallback : public sf::Drawable {
+	public:
+		explicit DrawCallback(std::function<void(sf::RenderTarget&)> routine) : m_routine(std::move(routine)) {}
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates /*states*/) const override { m_routine(target); }
+
+		std::function<void(sf::RenderTarget&)> m_routine;
+	};
+
+	class RenderQueue {
+	public:
+		static constexpr std::size_t LAYER_COUNT = DrawOrder::LAYER_COUNT;
+		static constexpr std::uint32_t MAX_DEPTH = DrawOrder::MAX_DEPTH;
+
+		/**
+		 * @brief Items of layer are drawn under view (nullptr keeps the target's view).
+		 *
+		 * view must outlive submit().
+		 */
+		void setLayerView(std::uint8_t layer, const sf::View* view) noexcept { m_views[layer] = view; }
+
+		/**
+		 * @brief Queues drawable in layer.
+		 *
+		 * texture and shader are the GPU state the drawable binds (for sorting only;
+		 * the drawable still binds them itself). Deeper items of the same state draw later.
+		 * MISRA: depth is clamped to MAX_DEPTH.
+		 */
+		void push(std::uint8_t layer, const sf::Drawable& drawable, const sf::Texture* texture = nullptr,
+			const sf::Shader* shader = nullptr, std::uint32_t depth = 0U);
+
+		/**
+		 * @brief Sorts the queued items, draws them in key order and empties the queue.
+		 *
+		 * The target's view is restored afterwards.
+		 */
+		void submit(sf::RenderTarget& target);
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_order.size(); }
+		[[nodiscard]] std::size_t stateChanges() const noexcept { return m_order.stateRuns(); } // last submit
+
+	private:
+		DrawOrder m_order;
+		std::vector<const sf::Drawable*> m_drawables; // by push index
+		std::array<const sf::View*, LAYER_COUNT> m_views{};
+	};
+
+} // namespace gfx
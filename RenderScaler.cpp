@@ -0,0 +1,179 @@
+#include "RenderScaler.hpp"
+
+#include <SFML/Window/Context.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace gfx {
+
+	namespace {
+		// At scale s the sharpening weight is SHARPEN_STRENGTH * (1/s - 1), up to SHARPEN_LIMIT:
+		// nothing at native size, the most where the upscale blurs the most
+		constexpr float SHARPEN_STRENGTH = 0.5F;
+		constexpr float SHARPEN_LIMIT = 0.6F;
+		constexpr float MIN_RENDER_SCALE = 0.25F;
+		constexpr double NANOSECONDS_PER_MS = 1.0e6;
+
+		// Unsharp mask over the four axis neighbours; the bilinear upscale has already happened in the sampler
+		constexpr const char* SHARPEN_FRAGMENT_SHADER = R"(
+#version 120
+uniform sampler2D texture;
+uniform vec2 u_texel;
+uniform float u_amount;
+void main() {
+	vec2 uv = gl_TexCoord[0].xy;
+	vec3 center = texture2D(texture, uv).rgb;
+	vec3 around = texture2D(texture, uv + vec2(u_texel.x, 0.0)).rgb
+		+ texture2D(texture, uv - vec2(u_texel.x, 0.0)).rgb
+		+ texture2D(texture, uv + vec2(0.0, u_texel.y)).rgb
+		+ texture2D(texture, uv - vec2(0.0, u_texel.y)).rgb;
+	gl_FragColor = vec4(clamp(center + u_amount * (center - 0.25 * around), 0.0, 1.0), 1.0);
+}
+)";
+
+		[[nodiscard]] gl::ProcAddress timerLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+
+		[[nodiscard]] sf::Vector2u scaledSize(const sf::Vector2u& windowSize, float scale) noexcept {
+			return { std::max(1U, static_cast<unsigned>(std::lround(static_cast<float>(windowSize.x) * scale))),
+				std::max(1U, static_cast<unsigned>(std::lround(static_cast<float>(windowSize.y) * scale))) };
+		}
+	}
+
+	bool RenderScaler::create(const sf::Vector2u& windowSize, float scale) {
+		m_windowSize = windowSize;
+		m_sharpenReady = sf::Shader::isAvailable()
+			&& m_sharpen.loadFromMemory(SHARPEN_FRAGMENT_SHADER, sf::Shader::Type::Fragment);
+		if (!m_sharpenReady) {
+			std::cerr << "Warning: no sharpening shader, the scaled scene is upscaled without it\n";
+		}
+		m_scale = std::clamp(scale, MIN_RENDER_SCALE, 1.0F);
+		return resize(scaledSize(windowSize, m_scale));
+	}
+
+	bool RenderScaler::setScale(float scale) {
+		if (!m_texture) {
+			return false;
+		}
+		m_scale = std::clamp(scale, MIN_RENDER_SCALE, 1.0F);
+		const sf::Vector2u size = scaledSize(m_windowSize, m_scale);
+		return size != m_texture->getSize() && resize(size);
+	}
+
+	bool RenderScaler::resize(const sf::Vector2u& size) {
+		sf::RenderTexture texture;
+		if (!texture.resize(size)) {
+			std::cerr << "Error: Failed to create a " << size.x << 'x' << size.y
+				<< " scene texture, drawing at window resolution\n";
+			m_texture.reset();
+			m_videoCharge.set(0U);
+			m_scale = 1.0F;
+			return false;
+		}
+		texture.setSmooth(true);
+		m_texture.emplace(std::move(texture));
+		m_videoCharge.set(prof::rgbaTextureBytes(size.x, size.y));
+		m_sharpenAmount = std::min(SHARPEN_STRENGTH * (1.0F / m_scale - 1.0F), SHARPEN_LIMIT);
+		if (m_sharpenReady) {
+			m_sharpen.setUniform("texture", sf::Shader::CurrentTexture);
+			m_sharpen.setUniform("u_texel", sf::Vector2f(1.0F / static_cast<float>(size.x), 1.0F / static_cast<float>(size.y)));
+			m_sharpen.setUniform("u_amount", m_sharpenAmount);
+		}
+		return true;
+	}
+
+	sf::RenderTarget& RenderScaler::target(sf::RenderWindow& window) noexcept {
+		if (m_texture) {
+			return *m_texture;
+		}
+		return window;
+	}
+
+	void RenderScaler::present(sf::RenderWindow& window, sf::Shader* post) {
+		if (!m_texture) {
+			return;
+		}
+		m_texture->display();
+
+		sf::Sprite frame(m_texture->getTexture());
+		const sf::Vector2f textureSize(m_texture->getSize());
+		const sf::Vector2f windowSize(window.getSize());
+		frame.setScale({ windowSize.x / textureSize.x, windowSize.y / textureSize.y });
+
+		const sf::View saved = window.getView();
+		window.setView(window.getDefaultView());
+		sf::RenderStates states(sf::BlendNone);
+		// Native size needs no sharpening; the plain copy is cheaper
+		const bool native = m_texture->getSize() == m_windowSize;
+		if (post != nullptr) {
+			post->setUniform("u_texel", sf::Vector2f(1.0F / textureSize.x, 1.0F / textureSize.y));
+			post->setUniform("u_amount", native ? 0.0F : m_sharpenAmount);
+			post->setUniform("u_resolution", windowSize);
+			states.shader = post;
+		}
+		else if (m_sharpenReady && !native) {
+			states.shader = &m_sharpen;
+		}
+		window.draw(frame, states);
+		window.setView(saved);
+	}
+
+	GpuFrameTimer::~GpuFrameTimer() {
+		// Queries are not shared between contexts; with none current the driver frees them with the window's
+		if (m_ready && sf::Context::getActiveContextId() != 0U) {
+			gl::api().DeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+		}
+	}
+
+	bool GpuFrameTimer::create() {
+		if ((!gl::loaded() && !gl::load(&timerLoader)) || (!gl::timerLoaded() && !gl::loadTimer(&timerLoader))) {
+			std::cerr << "Warning: timer queries are unavailable, the render scale stays fixed\n";
+			return false;
+		}
+		gl::api().GenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+		m_ready = true;
+		return true;
+	}
+
+	void GpuFrameTimer::begin() {
+		// All queries still in flight: the GPU is three frames behind, leave this one untimed
+		if (!m_ready || m_inFlight[m_next]) {
+			return;
+		}
+		gl::api().BeginQuery(gl::TIME_ELAPSED, m_queries[m_next]);
+		m_timing = true;
+	}
+
+	void GpuFrameTimer::end() {
+		if (!m_timing) {
+			return;
+		}
+		gl::api().EndQuery(gl::TIME_ELAPSED);
+		m_inFlight[m_next] = true;
+		m_next = (m_next + 1U) % QUERY_COUNT;
+		m_timing = false;
+	}
+
+	std::optional<float> GpuFrameTimer::collect() {
+		std::optional<float> newest;
+		const gl::Api& api = gl::api();
+		// Queries finish in the order they were issued; stop at the first one still running
+		while (m_ready && m_inFlight[m_oldest]) {
+			GLint available = 0;
+			api.GetQueryObjectiv(m_queries[m_oldest], gl::QUERY_RESULT_AVAILABLE, &available);
+			if (available == 0) {
+				break;
+			}
+			std::uint64_t elapsed = 0U;
+			api.GetQueryObjectui64v(m_queries[m_oldest], gl::QUERY_RESULT, &elapsed);
+			newest = static_cast<float>(static_cast<double>(elapsed) / NANOSECONDS_PER_MS);
+			m_inFlight[m_oldest] = false;
+			m_oldest = (m_oldest + 1U) % QUERY_COUNT;
+		}
+		return newest;
+	}
+
+} // namespace gfx
@@ -0,0 +1,116 @@
+/*
+==============================================================================
+Render Scaler - the scene drawn at a reduced internal resolution (--render-scale)
+==============================================================================
+ - The world layers draw into an off-screen texture of scale times the
+   window size; present() stretches it over the window in one quad with a
+   five-tap sharpening shader that restores the edges the bilinear upscale
+   softens, then the screen layer (minimap, HUD) draws at full resolution
+ - The texture is reallocated only when the scale changes its pixel size;
+   without shaders the upscale is a plain bilinear sprite
+ - present() can take a post-process shader in place of the sharpening
+   one (SceneEffects); it is handed the same texel and sharpening uniforms,
+   so effects ride on the upscale instead of a target of their own
+ - GpuFrameTimer measures each frame on the GPU with a ring of timer
+   queries read back frames later, never waiting on the driver; its
+   result steers the DynamicResolution controller (--dynamic-resolution)
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "GlFunctions.hpp"
+#include "MemoryAccounting.hpp"
+
+namespace gfx {
+
+	class RenderScaler {
+	public:
+		/**
+		 * @brief Starts drawing at scale of windowSize; scale 1 keeps the texture (for a dynamic scale).
+		 *
+		 * Requires an active GL context. Returns false (and logs) if the
+		 * render texture cannot be created; target() is then the window.
+		 */
+		[[nodiscard]] bool create(const sf::Vector2u& windowSize, float scale);
+
+		/**
+		 * @brief Changes the internal scale; reallocates only if the pixel size changes.
+		 */
+		bool setScale(float scale);
+
+		/**
+		 * @brief Where the scene draws this frame: the scaled texture, or window when inactive.
+		 */
+		[[nodiscard]] sf::RenderTarget& target(sf::RenderWindow& window) noexcept;
+
+		/**
+		 * @brief Upscales the frame drawn into target() over the whole window; no-op when inactive.
+		 *
+		 * A post shader replaces the sharpening pass; it gets texture, u_texel,
+		 * u_amount (the sharpening weight) and u_resolution (window pixels).
+		 */
+		void present(sf::RenderWindow& window, sf::Shader* post = nullptr);
+
+		[[nodiscard]] bool active() const noexcept { return m_texture.has_value(); }
+		[[nodiscard]] float scale() const noexcept { return m_scale; }
+		[[nodiscard]] sf::Vector2u size() const noexcept { return m_texture ? m_texture->getSize() : m_windowSize; }
+
+	private:
+		[[nodiscard]] bool resize(const sf::Vector2u& size);
+
+		std::optional<sf::RenderTexture> m_texture;
+		sf::Shader m_sharpen;
+		bool m_sharpenReady = false;
+		float m_sharpenAmount = 0.0F;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Video };
+		sf::Vector2u m_windowSize;
+		float m_scale = 1.0F;
+	};
+
+	class GpuFrameTimer {
+	public:
+		GpuFrameTimer() = default;
+		~GpuFrameTimer();
+
+		GpuFrameTimer(const GpuFrameTimer&) = delete;
+		GpuFrameTimer& operator=(const GpuFrameTimer&) = delete;
+
+		/**
+		 * @brief Creates the queries; requires the context that will be timed to be active.
+		 *
+		 * Returns false (and logs) below OpenGL 3.3; the caller then keeps a fixed scale.
+		 */
+		[[nodiscard]] bool create();
+
+		/**
+		 * @brief Brackets one frame's GL work; a frame whose query is still in flight goes untimed.
+		 */
+		void begin();
+		void end();
+
+		/**
+		 * @brief The newest finished frame's GPU milliseconds, or nothing if none finished since the last call.
+		 */
+		[[nodiscard]] std::optional<float> collect();
+
+		[[nodiscard]] bool ready() const noexcept { return m_ready; }
+
+	private:
+		static constexpr std::size_t QUERY_COUNT = 3U; // a frame finishes within two presents on every driver we ship
+
+		std::array<GLuint, QUERY_COUNT> m_queries{};
+		std::array<bool, QUERY_COUNT> m_inFlight{};
+		std::size_t m_next = 0U;    // slot of the next frame
+		std::size_t m_oldest = 0U;  // slot read back next
+		bool m_timing = false;      // a query is open between begin() and end()
+		bool m_ready = false;
+	};
+
+} // namespace gfx
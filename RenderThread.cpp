@@ -0,0 +1,97 @@
+#include "RenderThread.hpp"
+
+#include <iostream>
+#include <utility>
+
+#include "Trace.hpp"
+
+namespace gfx {
+
+	RenderThread::~RenderThread() {
+		stop();
+	}
+
+	bool RenderThread::start(sf::Window& window) {
+		if (m_thread.joinable()) {
+			return false;
+		}
+		if (!window.setActive(false)) {
+			std::cerr << "Error: Failed to release the window's context for the render thread\n";
+			return false;
+		}
+		m_window = &window;
+		m_stopping = false;
+		m_acquired = false;
+		m_thread = std::thread([this]() { run(); });
+		return true;
+	}
+
+	void RenderThread::submit(Job job) {
+		wait();
+		if (m_acquired) {
+			m_acquired = false;
+			(void)m_window->setActive(false);
+		}
+		{
+			const std::lock_guard<std::mutex> lock(m_mutex);
+			m_job = std::move(job);
+			m_busy = true;
+		}
+		m_wake.notify_one();
+	}
+
+	void RenderThread::wait() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return !m_busy; });
+	}
+
+	void RenderThread::acquire() {
+		wait();
+		if (!m_acquired && m_window != nullptr) {
+			m_acquired = m_window->setActive(true);
+		}
+	}
+
+	void RenderThread::stop() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		wait();
+		{
+			const std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_one();
+		m_thread.join();
+		if (!m_acquired) {
+			(void)m_window->setActive(true);
+		}
+		m_acquired = false;
+	}
+
+	void RenderThread::run() {
+		prof::setThreadName("render");
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;) {
+			m_wake.wait(lock, [this]() { return m_busy || m_stopping; });
+			if (!m_busy) {
+				return; // stopping with nothing left to draw
+			}
+			Job job = std::move(m_job);
+			lock.unlock();
+
+			if (m_window->setActive(true)) {
+				job();
+				(void)m_window->setActive(false);
+			}
+			else {
+				std::cerr << "Error: The render thread could not activate the window's context\n";
+			}
+
+			lock.lock();
+			m_busy = false;
+			m_done.notify_all();
+		}
+	}
+
+} // namespace gfx
@@ -0,0 +1,87 @@
+/*
+==============================================================================
+Render Thread - draws and displays frames away from the event loop
+==============================================================================
+ - One dedicated thread owns the window's OpenGL context while it draws:
+   a frame job activates the context, draws, displays (vsync wait
+   included) and releases it again
+ - Meanwhile the main thread keeps polling OS events, sampling input and
+   simulating the next frame, so a display() blocked on vsync no longer
+   delays input
+ - One job in flight at a time: submit() waits for the previous frame, so
+   the main thread never runs more than one frame ahead of the screen
+ - acquire() is the fence for anything else: it waits for the frame being
+   drawn and makes the context current on the caller, so toggles that
+   create GL objects, texture uploads and scene rebuilds stay on the main
+   thread; the next submit() hands the context back
+ - A dedicated thread rather than a pool worker: a context is current on
+   one thread at a time, and jobs must not migrate
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Window/Window.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace gfx {
+
+	class RenderThread {
+	public:
+		using Job = std::function<void()>;
+
+		RenderThread() = default;
+		~RenderThread();
+
+		RenderThread(const RenderThread&) = delete;
+		RenderThread& operator=(const RenderThread&) = delete;
+
+		/**
+		 * @brief Starts the thread; window's context moves to it from the caller.
+		 *
+		 * window must outlive the thread (stop() or the destructor).
+		 * MISRA: returns false if the context cannot be released by the caller.
+		 */
+		[[nodiscard]] bool start(sf::Window& window);
+
+		/**
+		 * @brief Waits for the frame in flight, then hands job and the context to the thread.
+		 */
+		void submit(Job job);
+
+		/**
+		 * @brief Blocks until the frame in flight, if any, has been displayed.
+		 */
+		void wait();
+
+		/**
+		 * @brief Waits, then makes the window's context current on the caller until the next submit().
+		 */
+		void acquire();
+
+		/**
+		 * @brief Finishes the frame in flight, joins the thread and gives the context back to the caller.
+		 */
+		void stop();
+
+		[[nodiscard]] bool running() const noexcept { return m_thread.joinable(); }
+
+	private:
+		void run();
+
+		sf::Window* m_window = nullptr;
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_wake; // thread: a job arrived, or stop
+		std::condition_variable m_done; // caller: the job finished
+		Job m_job;
+		bool m_busy = false;
+		bool m_stopping = false;
+		bool m_acquired = false; // the context is current on the caller (main thread only)
+	};
+
+} // namespace gfx
@@ -0,0 +1,290 @@
+#include "RigOptimizer.hpp"
+
+#include <SFML/Graphics/Transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "Headless.hpp"
+#include "ObstacleGrid.hpp"
+#include "Scene.hpp"
+#include "SensorNoise.hpp"
+#include "SensorQuery.hpp"
+#include "Sensors.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	namespace {
+		// A sensor faces along its rectangle's long axis, as in readSensors()
+		constexpr float RIG_FACING_OFFSET_DEG = 90.0F;
+		constexpr float RIG_DEG_TO_RAD = 3.14159265358979F / 180.0F;
+		constexpr float RIG_WORD_UNIT = 1.0F / 4294967296.0F;
+
+		// Uniform draws from Philox counters (generation, candidate, 0, n), four words per call
+		class RigRandom {
+		public:
+			RigRandom(PhiloxKey key, std::uint32_t generation, std::uint32_t candidate) noexcept
+				: m_key(key), m_counter{ generation, candidate, 0U, 0U } {}
+
+			[[nodiscard]] float range(float low, float high) noexcept {
+				if (m_used == m_words.size()) {
+					m_words = philox4x32(m_counter, m_key);
+					++m_counter[3];
+					m_used = 0U;
+				}
+				return low + (high - low) * static_cast<float>(m_words[m_used++]) * RIG_WORD_UNIT;
+			}
+
+		private:
+			PhiloxKey m_key;
+			PhiloxCounter m_counter;
+			PhiloxCounter m_words{};
+			std::size_t m_used = 4U;
+		};
+
+		// A scenario with what every candidate needs precomputed: the grid and each pose's hazard pillars
+		struct PreparedScenario {
+			const RigScenario* source = nullptr;
+			ObstacleGrid grid;
+			std::vector<std::uint32_t> hazardStart; // pose count + 1 offsets into hazards
+			std::vector<std::uint32_t> hazards;
+		};
+
+		// Distance from point to the car rectangle; 0 inside it
+		[[nodiscard]] float bodyDistance(const CarState& car, const sf::Vector2f& halfExtent, const sf::Vector2f& point) {
+			const float radians = car.headingDeg * RIG_DEG_TO_RAD;
+			const float c = std::cos(radians);
+			const float s = std::sin(radians);
+			const sf::Vector2f d = point - car.position;
+			const float x = std::max(std::abs(d.x * c + d.y * s) - halfExtent.x, 0.0F);
+			const float y = std::max(std::abs(-d.x * s + d.y * c) - halfExtent.y, 0.0F);
+			return std::sqrt(x * x + y * y);
+		}
+
+		void prepareScenario(const RigScenario& scenario, float range, PreparedScenario& prepared) {
+			const Scene& scene = *scenario.scene;
+			prepared.source = &scenario;
+			prepared.grid.build(obstacleCenters(scene.obstacles), constants::OBSTACLE_CELL_SIZE,
+				sceneWalls(scene, sceneBounds(scene)), scene.polygons);
+			const float reach = std::sqrt(scene.carHalfExtent.x * scene.carHalfExtent.x
+				+ scene.carHalfExtent.y * scene.carHalfExtent.y) + range;
+			std::vector<std::uint32_t> near;
+			prepared.hazardStart.assign(1U, 0U);
+			for (const CarState& car : scenario.poses) {
+				near.clear();
+				prepared.grid.gather(car.position, reach, near);
+				std::sort(near.begin(), near.end());
+				for (const std::uint32_t obstacle : near) {
+					if (bodyDistance(car, scene.carHalfExtent, scene.obstacles[obstacle].center) <= range) {
+						prepared.hazards.push_back(obstacle);
+					}
+				}
+				prepared.hazardStart.push_back(static_cast<std::uint32_t>(prepared.hazards.size()));
+			}
+		}
+
+		// True if target is within range of the sensor and inside its cone
+		[[nodiscard]] bool inCone(const SensorPose& sensor, const sf::Vector2f& target, float range, float cosHalfAngle) {
+			const sf::Vector2f d = target - sensor.position;
+			const float lengthSq = d.x * d.x + d.y * d.y;
+			if (lengthSq > range * range) {
+				return false;
+			}
+			const float facing = (sensor.rotationDeg + RIG_FACING_OFFSET_DEG) * RIG_DEG_TO_RAD;
+			return d.x * std::cos(facing) + d.y * std::sin(facing) >= std::sqrt(lengthSq) * cosHalfAngle;
+		}
+
+		[[nodiscard]] RigScore scorePrepared(const std::vector<PreparedScenario>& scenarios, const std::vector<RigSensor>& rig,
+			const WarningProfile& profile, const RigSearchConfig& config)
+		{
+			const float range = profile.range();
+			const float cosHalfAngle = std::cos(config.halfAngleDeg * RIG_DEG_TO_RAD);
+			std::uint64_t covered = 0U;
+			std::uint64_t blind = 0U;
+			RigScore score;
+			std::vector<SensorPose> poses;
+			std::vector<SensorReading> readings;
+			for (const PreparedScenario& prepared : scenarios) {
+				const Scene& scene = *prepared.source->scene;
+				const std::vector<CarState>& cars = prepared.source->poses;
+				const std::vector<SensorMount> mounts = createSensorMounts(scene.carHalfExtent, rig);
+				const std::size_t sensors = mounts.size();
+				poses.assign(cars.size() * sensors, SensorPose{});
+				readings.resize(poses.size());
+				for (std::size_t p = 0U; p < cars.size(); ++p) {
+					placeSensors(carTransform(cars[p]), cars[p].headingDeg, mounts.data(), sensors, poses.data() + p * sensors);
+				}
+				// One batch for every pose; this already runs inside a pool task, so inline
+				querySensors(SensorSource{ &prepared.grid, nullptr, range }, poses.data(), poses.size(), readings.data());
+
+				for (std::size_t p = 0U; p < cars.size(); ++p) {
+					const std::uint32_t first = prepared.hazardStart[p];
+					const std::uint32_t last = prepared.hazardStart[p + 1U];
+					if (first == last) {
+						continue;
+					}
+					++score.hazardPoses;
+					const SensorPose* pose = poses.data() + p * sensors;
+					const SensorReading* reading = readings.data() + p * sensors;
+					for (std::uint32_t h = first; h < last; ++h) {
+						const sf::Vector2f center = scene.obstacles[prepared.hazards[h]].center;
+						for (std::size_t s = 0U; s < sensors; ++s) {
+							if (inCone(pose[s], center, range, cosHalfAngle)) {
+								++covered;
+								break;
+							}
+						}
+					}
+					score.hazards += last - first;
+
+					bool beeps = false;
+					for (std::size_t s = 0U; s < sensors && !beeps; ++s) {
+						// A polygon has no single point to aim at; its reading counts as seen
+						const bool seen = (reading[s].obstacle == NO_OBSTACLE)
+							? reading[s].distanceSq < std::numeric_limits<float>::max()
+							: inCone(pose[s], scene.obstacles[reading[s].obstacle].center, range, cosHalfAngle);
+						beeps = seen && profile.interval(mounts[s].zone, reading[s].distanceSq) > 0.0F;
+					}
+					blind += beeps ? 0U : 1U;
+				}
+			}
+			score.coverage = (score.hazards > 0U) ? static_cast<float>(covered) / static_cast<float>(score.hazards) : 1.0F;
+			score.blindSpots = (score.hazardPoses > 0U) ? static_cast<float>(blind) / static_cast<float>(score.hazardPoses) : 0.0F;
+			score.score = score.coverage - config.blindSpotWeight * score.blindSpots;
+			return score;
+		}
+
+		// params holds a rotation (deg) and an outset (px) per sensor, in that order
+		[[nodiscard]] std::vector<RigSensor> applyRigParams(const std::vector<RigSensor>& base, const std::vector<float>& params) {
+			std::vector<RigSensor> rig = base;
+			for (std::size_t i = 0U; i < rig.size(); ++i) {
+				RigSensor& sensor = rig[i];
+				const float rotation = std::fmod(sensor.rotationDeg + params[2U * i], 360.0F);
+				sensor.rotationDeg = (rotation < 0.0F) ? rotation + 360.0F : rotation;
+				const float outset = params[2U * i + 1U];
+				sensor.offset.x += (sensor.anchor.x > 0.0F) ? outset : ((sensor.anchor.x < 0.0F) ? -outset : 0.0F);
+				sensor.offset.y += (sensor.anchor.y > 0.0F) ? outset : ((sensor.anchor.y < 0.0F) ? -outset : 0.0F);
+			}
+			return rig;
+		}
+
+		[[nodiscard]] const char* rigZoneName(SensorZone zone) noexcept {
+			switch (zone) {
+			case SensorZone::Front:
+				return "front";
+			case SensorZone::Rear:
+				return "rear";
+			default:
+				return "corner";
+			}
+		}
+	}
+
+	std::vector<CarState> sampleDrivePoses(const Scene& scene, const std::vector<TraceSegment>& trace,
+		float tickHz, const WarningProfile& profile, VehicleModel model, std::uint32_t sampleTicks)
+	{
+		const std::uint32_t step = std::max(sampleTicks, 1U);
+		std::vector<TraceSegment> cut;
+		for (const TraceSegment& segment : trace) {
+			for (std::uint32_t done = 0U; done < segment.ticks; done += step) {
+				cut.push_back({ std::min(step, segment.ticks - done), segment.input });
+			}
+		}
+		std::vector<CarState> poses;
+		(void)runHeadless(scene, cut, tickHz, 1U, profile, model, {}, nullptr,
+			[&poses](const HeadlessCheckpoint& checkpoint) { poses.push_back(checkpoint.car); });
+		return poses;
+	}
+
+	RigScore scoreSensorRig(const std::vector<RigScenario>& scenarios, const std::vector<RigSensor>& rig,
+		const WarningProfile& profile, const RigSearchConfig& config)
+	{
+		std::vector<PreparedScenario> prepared(scenarios.size());
+		for (std::size_t i = 0U; i < scenarios.size(); ++i) {
+			prepareScenario(scenarios[i], profile.range(), prepared[i]);
+		}
+		return scorePrepared(prepared, rig.empty() ? defaultSensorRig() : rig, profile, config);
+	}
+
+	RigSearchResult optimizeSensorRig(const std::vector<RigScenario>& scenarios,
+		const std::vector<RigSensor>& baseRig, const WarningProfile& profile, const RigSearchConfig& config,
+		ThreadPool& pool)
+	{
+		OKPP_TRACE_SCOPE("optimizeSensorRig");
+		const auto start = std::chrono::steady_clock::now();
+		RigSearchResult result;
+		result.baseRig = baseRig.empty() ? defaultSensorRig() : baseRig;
+
+		std::vector<PreparedScenario> prepared(scenarios.size());
+		pool.parallelFor(scenarios.size(), 1U, [&](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				prepareScenario(scenarios[i], profile.range(), prepared[i]);
+			}
+		});
+		for (const RigScenario& scenario : scenarios) {
+			result.poses += scenario.poses.size();
+		}
+
+		const std::size_t paramCount = 2U * result.baseRig.size();
+		std::vector<float> bestParams(paramCount, 0.0F);
+		result.base = scorePrepared(prepared, result.baseRig, profile, config);
+		result.best = result.base;
+		result.evaluated = 1U;
+
+		const PhiloxKey key{ static_cast<std::uint32_t>(config.seed), static_cast<std::uint32_t>(config.seed >> 32U) };
+		const std::size_t drawn = (config.candidates > 1U) ? config.candidates - 1U : 0U;
+		std::vector<std::vector<float>> params(drawn, std::vector<float>(paramCount, 0.0F));
+		std::vector<RigScore> scores(drawn);
+		float span = 1.0F;
+		for (std::uint32_t generation = 0U; generation < config.generations && drawn > 0U; ++generation) {
+			// The first generation spans the whole outset range; later ones are centred on the best so far
+			const float rotationSpan = config.rotationSpanDeg * span;
+			const float outsetSpan = 0.5F * (config.maxOutset - config.minOutset) * span;
+			for (std::size_t i = 0U; i < drawn; ++i) {
+				RigRandom random(key, generation, static_cast<std::uint32_t>(i));
+				for (std::size_t p = 0U; p < paramCount; p += 2U) {
+					params[i][p] = bestParams[p] + random.range(-rotationSpan, rotationSpan);
+					params[i][p + 1U] = (generation == 0U) ? random.range(config.minOutset, config.maxOutset)
+						: std::clamp(bestParams[p + 1U] + random.range(-outsetSpan, outsetSpan), config.minOutset, config.maxOutset);
+				}
+			}
+			pool.parallelFor(drawn, 1U, [&](std::size_t begin, std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					scores[i] = scorePrepared(prepared, applyRigParams(result.baseRig, params[i]), profile, config);
+				}
+			});
+			for (std::size_t i = 0U; i < drawn; ++i) {
+				if (scores[i].score > result.best.score) {
+					result.best = scores[i];
+					bestParams = params[i];
+				}
+			}
+			result.evaluated += drawn;
+			span *= config.shrink;
+		}
+
+		result.bestRig = applyRigParams(result.baseRig, bestParams);
+		result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	std::string formatRigSensor(const RigSensor& sensor) {
+		std::ostringstream line;
+		line << "sensor " << rigZoneName(sensor.zone) << ' '
+			<< ((sensor.kind == SensorKind::Camera) ? "camera" : "ultrasonic") << ' '
+			<< sensor.anchor.x << ' ' << sensor.anchor.y << ' ' << sensor.offset.x << ' ' << sensor.offset.y << ' '
+			<< sensor.rotationDeg;
+		if (sensor.extent.x > 0.0F && sensor.extent.y > 0.0F) {
+			line << ' ' << sensor.extent.x << ' ' << sensor.extent.y;
+		}
+		return line.str();
+	}
+
+} // namespace sim
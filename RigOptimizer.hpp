@@ -0,0 +1,105 @@
+/*
+==============================================================================
+Rig Optimizer - searching sensor mount angles and offsets (--optimize-rig)
+==============================================================================
+ - A candidate rig is the base rig (the profile's, or the built-in corner
+   units) with every sensor turned by its own angle and pushed outwards by
+   its own distance along its anchor's diagonal: the knobs the corner rig
+   spells as 45/315/135/225 degrees and DIAGONAL_OFFSET
+ - Poses come from the headless runner: the trace is driven through every
+   scenario of the set, cut into short segments so a checkpoint fires every
+   few ticks, and the car states there are the poses every rig is judged at
+ - A pose is a hazard when a pillar is within the profile's range of the
+   car body. Coverage is the share of those pillars inside some sensor's
+   cone and range; a blind spot is a hazard pose where no sensor beeps,
+   its batched reading (querySensors) counting only if the pillar it found
+   is inside its cone. Walls do not beep, as in warningInterval()
+ - The search keeps the best rig so far and draws a generation of
+   candidates around it, each span a fraction of the last; a generation is
+   scored in parallel, one candidate per pool task, each reading its own
+   sensors inline
+ - Every draw is Philox of (generation, candidate), and ties keep the
+   earlier candidate, so the result is the same for any thread count
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "Constants.hpp"
+#include "SimFwd.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	struct RigSearchConfig {
+		std::size_t candidates = 64U;    // per generation, the best so far included
+		std::uint32_t generations = 8U;
+		std::uint64_t seed = 1U;
+		float rotationSpanDeg = 180.0F;  // first generation: each sensor turned within +-this (any facing)
+		float minOutset = -10.0F;        // px along the anchor diagonal, relative to the base rig
+		float maxOutset = 30.0F;
+		float shrink = 0.6F;             // span of each generation relative to the one before
+		float halfAngleDeg = constants::SENSOR_CONE_HALF_ANGLE;
+		float blindSpotWeight = 2.0F;    // score = coverage - weight * blind-spot share
+	};
+
+	// One scenario of the set: the scene and the car poses sampled from a drive through it
+	struct RigScenario {
+		const Scene* scene = nullptr;
+		std::vector<CarState> poses;
+	};
+
+	struct RigScore {
+		float coverage = 0.0F;      // hazard pillars inside a sensor cone, 0..1
+		float blindSpots = 0.0F;    // hazard poses without a beep, 0..1
+		float score = 0.0F;
+		std::uint64_t hazards = 0U;     // (pose, pillar) pairs within range of the body
+		std::uint64_t hazardPoses = 0U;
+	};
+
+	struct RigSearchResult {
+		std::vector<RigSensor> baseRig;
+		std::vector<RigSensor> bestRig;
+		RigScore base;
+		RigScore best;
+		std::uint64_t poses = 0U;
+		std::size_t evaluated = 0U; // candidate rigs scored
+		double wallSeconds = 0.0;
+	};
+
+	/**
+	 * @brief Car poses every sampleTicks ticks of the trace through scene, from runHeadless().
+	 *
+	 * The trace is re-cut into segments of at most sampleTicks ticks, which
+	 * drives exactly as the original; checkpoints then give the poses.
+	 */
+	[[nodiscard]] std::vector<CarState> sampleDrivePoses(const Scene& scene, const std::vector<TraceSegment>& trace,
+		float tickHz, const WarningProfile& profile, VehicleModel model, std::uint32_t sampleTicks);
+
+	/**
+	 * @brief Coverage, blind spots and score of rig over the scenarios.
+	 */
+	[[nodiscard]] RigScore scoreSensorRig(const std::vector<RigScenario>& scenarios, const std::vector<RigSensor>& rig,
+		const WarningProfile& profile, const RigSearchConfig& config);
+
+	/**
+	 * @brief Searches rigs around baseRig (empty = defaultSensorRig()) for the best score over the scenarios.
+	 *
+	 * MISRA: the base rig is candidate 0 and is only replaced by a strictly better one.
+	 */
+	[[nodiscard]] RigSearchResult optimizeSensorRig(const std::vector<RigScenario>& scenarios,
+		const std::vector<RigSensor>& baseRig, const WarningProfile& profile, const RigSearchConfig& config,
+		ThreadPool& pool);
+
+	/**
+	 * @brief sensor as a vehicle profile "sensor" line (see WarningProfile.hpp).
+	 */
+	[[nodiscard]] std::string formatRigSensor(const RigSensor& sensor);
+
+} // namespace sim
@@ -0,0 +1,351 @@
+#include "Scenario.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "MappedFile.hpp"
+#include "Scene.hpp"
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr char SCENARIO_MAGIC[8] = { 'O', 'K', 'S', 'C', 'N', '0', '0', '2' };
+		constexpr char SCENARIO_MAGIC_001[8] = { 'O', 'K', 'S', 'C', 'N', '0', '0', '1' };
+
+		// Everything after the magic is little-endian; arrays follow in header order
+		struct ScenarioHeader {
+			char magic[8];
+			std::uint32_t obstacleCount;
+			std::uint32_t bayCount;
+			std::uint32_t spawnCount;
+			std::uint32_t wallCount; // reserved (0) in files written before walls
+			// 002 onwards: polygonStartCount offsets (polygon count + 1, or 0), then polygonVertexCount vertices
+			std::uint32_t polygonStartCount;
+			std::uint32_t polygonVertexCount;
+		};
+
+		// 001 headers end before the polygon counts
+		constexpr std::size_t HEADER_001_SIZE = 24U;
+
+		static_assert(sizeof(ScenarioHeader) == 32U, "ScenarioHeader layout is part of the file format");
+		static_assert(sizeof(Obstacle) == 12U && std::is_trivially_copyable_v<Obstacle>, "Obstacle is stored raw");
+		static_assert(sizeof(sf::FloatRect) == 16U && std::is_trivially_copyable_v<sf::FloatRect>, "bays are stored raw");
+		static_assert(sizeof(CarState) == 12U && std::is_trivially_copyable_v<CarState>, "spawns are stored raw");
+		static_assert(sizeof(WallSegment) == 20U && std::is_trivially_copyable_v<WallSegment>, "walls are stored raw");
+		static_assert(sizeof(sf::Vector2f) == 8U && std::is_trivially_copyable_v<sf::Vector2f>, "polygon vertices are stored raw");
+
+		template <typename T>
+		const unsigned char* copyArray(const unsigned char* in, std::uint32_t count, std::vector<T>& out) {
+			out.resize(count);
+			if (count > 0U) {
+				std::memcpy(out.data(), in, static_cast<std::size_t>(count) * sizeof(T));
+			}
+			return in + static_cast<std::size_t>(count) * sizeof(T);
+		}
+
+		template <typename T>
+		void writeArray(std::ofstream& file, const std::vector<T>& values) {
+			file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+		}
+
+		// Offsets must run from 0 to the vertex count without going back
+		[[nodiscard]] bool validPolygonStarts(const PolygonSet& polygons) {
+			if (polygons.starts.empty()) {
+				return polygons.vertices.empty();
+			}
+			if (polygons.starts.size() < 2U || polygons.starts.front() != 0U
+				|| polygons.starts.back() != polygons.vertices.size()) {
+				return false;
+			}
+			for (std::size_t i = 1U; i < polygons.starts.size(); ++i) {
+				if (polygons.starts[i] < polygons.starts[i - 1U]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		[[nodiscard]] bool loadBinary(const std::string& path, const assets::MappedFile& mapping, std::size_t headerSize,
+			Scene& scene)
+		{
+			ScenarioHeader header{};
+			std::memcpy(&header, mapping.data(), headerSize);
+			const std::uint64_t expected = headerSize
+				+ static_cast<std::uint64_t>(header.obstacleCount) * sizeof(Obstacle)
+				+ static_cast<std::uint64_t>(header.bayCount) * sizeof(sf::FloatRect)
+				+ static_cast<std::uint64_t>(header.spawnCount) * sizeof(CarState)
+				+ static_cast<std::uint64_t>(header.wallCount) * sizeof(WallSegment)
+				+ static_cast<std::uint64_t>(header.polygonStartCount) * sizeof(std::uint32_t)
+				+ static_cast<std::uint64_t>(header.polygonVertexCount) * sizeof(sf::Vector2f);
+			if (expected != mapping.size()) {
+				std::cerr << "Error: scenario " << path << " is truncated or corrupt\n";
+				return false;
+			}
+
+			Scene loaded = scene;
+			const unsigned char* in = mapping.data() + headerSize;
+			in = copyArray(in, header.obstacleCount, loaded.obstacles);
+			in = copyArray(in, header.bayCount, loaded.parkBays);
+			in = copyArray(in, header.spawnCount, loaded.spawns);
+			in = copyArray(in, header.wallCount, loaded.walls);
+			in = copyArray(in, header.polygonStartCount, loaded.polygons.starts);
+			(void)copyArray(in, header.polygonVertexCount, loaded.polygons.vertices);
+			if (!validPolygonStarts(loaded.polygons)) {
+				std::cerr << "Error: scenario " << path << " has corrupt polygon offsets\n";
+				return false;
+			}
+			scene = std::move(loaded);
+			return true;
+		}
+
+		// Text lots are parsed in chunks of about this many bytes, cut at line ends
+		constexpr std::size_t TEXT_CHUNK_BYTES = std::size_t{ 1 } << 20U;
+
+		// The records of one chunk of lines; chunks are merged in file order
+		struct TextChunk {
+			const char* begin = nullptr;
+			const char* end = nullptr;
+			std::size_t lines = 0U;
+			std::size_t badLine = 0U; // first malformed line, 1-based within the chunk (0 = none)
+			std::vector<Obstacle> obstacles;
+			std::vector<sf::FloatRect> parkBays;
+			std::vector<CarState> spawns;
+			std::vector<WallSegment> walls;
+			PolygonSet polygons;
+		};
+
+		[[nodiscard]] bool isBlank(char c) noexcept {
+			return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+		}
+
+		void skipBlanks(const char*& cursor, const char* end) noexcept {
+			while (cursor != end && isBlank(*cursor)) {
+				++cursor;
+			}
+		}
+
+		// Like istream >> float: leading blanks and a '+' sign are accepted, the number may end anywhere
+		[[nodiscard]] bool parseFloat(const char*& cursor, const char* end, float& value) noexcept {
+			skipBlanks(cursor, end);
+			if (cursor != end && *cursor == '+') {
+				++cursor;
+			}
+			const std::from_chars_result parsed = std::from_chars(cursor, end, value);
+			if (parsed.ec != std::errc{}) {
+				return false;
+			}
+			cursor = parsed.ptr;
+			return true;
+		}
+
+		// One record line; false if malformed (blank and comment lines are fine)
+		[[nodiscard]] bool parseLine(const char* cursor, const char* end, TextChunk& chunk, std::vector<sf::Vector2f>& outline) {
+			skipBlanks(cursor, end);
+			const char* const kindBegin = cursor;
+			while (cursor != end && !isBlank(*cursor)) {
+				++cursor;
+			}
+			const std::string_view kind(kindBegin, static_cast<std::size_t>(cursor - kindBegin));
+			if (kind.empty() || kind[0] == '#') {
+				return true;
+			}
+
+			if (kind == "obstacle") {
+				Obstacle obstacle;
+				const bool ok = parseFloat(cursor, end, obstacle.center.x) && parseFloat(cursor, end, obstacle.center.y)
+					&& parseFloat(cursor, end, obstacle.radius);
+				chunk.obstacles.push_back(obstacle);
+				return ok;
+			}
+			if (kind == "bay") {
+				sf::FloatRect bay;
+				const bool ok = parseFloat(cursor, end, bay.position.x) && parseFloat(cursor, end, bay.position.y)
+					&& parseFloat(cursor, end, bay.size.x) && parseFloat(cursor, end, bay.size.y);
+				chunk.parkBays.push_back(bay);
+				return ok;
+			}
+			if (kind == "spawn") {
+				CarState spawn;
+				const bool ok = parseFloat(cursor, end, spawn.position.x) && parseFloat(cursor, end, spawn.position.y);
+				if (ok && !parseFloat(cursor, end, spawn.headingDeg)) {
+					spawn.headingDeg = 0.0F;
+				}
+				chunk.spawns.push_back(spawn);
+				return ok;
+			}
+			if (kind == "wall") {
+				WallSegment wall;
+				const bool ok = parseFloat(cursor, end, wall.from.x) && parseFloat(cursor, end, wall.from.y)
+					&& parseFloat(cursor, end, wall.to.x) && parseFloat(cursor, end, wall.to.y);
+				chunk.walls.push_back(wall);
+				return ok;
+			}
+			if (kind == "polygon") {
+				// Coordinate pairs up to the end of the line, nothing else
+				outline.clear();
+				sf::Vector2f vertex;
+				while (parseFloat(cursor, end, vertex.x)) {
+					if (!parseFloat(cursor, end, vertex.y)) {
+						return false;
+					}
+					outline.push_back(vertex);
+				}
+				skipBlanks(cursor, end);
+				if (cursor != end || outline.size() < 3U) {
+					return false;
+				}
+				chunk.polygons.add(outline);
+				return true;
+			}
+			return false;
+		}
+
+		void parseChunk(TextChunk& chunk) {
+			std::vector<sf::Vector2f> outline;
+			const char* line = chunk.begin;
+			while (line != chunk.end) {
+				const void* newline = std::memchr(line, '\n', static_cast<std::size_t>(chunk.end - line));
+				const char* const lineEnd = (newline != nullptr) ? static_cast<const char*>(newline) : chunk.end;
+				++chunk.lines;
+				if (!parseLine(line, lineEnd, chunk, outline)) {
+					chunk.badLine = chunk.lines;
+					return;
+				}
+				line = (lineEnd != chunk.end) ? lineEnd + 1 : chunk.end;
+			}
+		}
+
+		template <typename T>
+		void append(std::vector<T>& to, const std::vector<T>& from) {
+			to.insert(to.end(), from.begin(), from.end());
+		}
+
+		void appendPolygons(PolygonSet& to, const PolygonSet& from) {
+			if (from.empty()) {
+				return;
+			}
+			const auto base = static_cast<std::uint32_t>(to.vertices.size());
+			if (to.starts.empty()) {
+				to.starts.push_back(0U);
+			}
+			for (std::size_t i = 1U; i < from.starts.size(); ++i) {
+				to.starts.push_back(base + from.starts[i]);
+			}
+			append(to.vertices, from.vertices);
+		}
+
+		[[nodiscard]] bool loadText(const std::string& path, const assets::MappedFile& mapping, Scene& scene) {
+			// Chunks end after a newline, so no line is split; each is parsed on the shared pool
+			const char* const text = reinterpret_cast<const char*>(mapping.data());
+			const char* const textEnd = text + mapping.size();
+			std::vector<TextChunk> chunks;
+			for (const char* begin = text; begin != textEnd;) {
+				const char* end = begin + std::min<std::size_t>(TEXT_CHUNK_BYTES, static_cast<std::size_t>(textEnd - begin));
+				const void* newline = (end != textEnd) ? std::memchr(end, '\n', static_cast<std::size_t>(textEnd - end)) : nullptr;
+				end = (newline != nullptr) ? static_cast<const char*>(newline) + 1 : textEnd;
+				chunks.emplace_back();
+				chunks.back().begin = begin;
+				chunks.back().end = end;
+				begin = end;
+			}
+			sharedPool().parallelFor(chunks.size(), 1U, [&chunks](std::size_t begin, std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					parseChunk(chunks[i]);
+				}
+			});
+
+			Scene loaded = scene;
+			loaded.obstacles.clear();
+			loaded.parkBays.clear();
+			loaded.spawns.clear();
+			loaded.walls.clear();
+			loaded.polygons = {};
+
+			std::size_t obstacleCount = 0U;
+			std::size_t linesBefore = 0U;
+			for (const TextChunk& chunk : chunks) {
+				if (chunk.badLine != 0U) {
+					std::cerr << "Error: " << path << ':' << (linesBefore + chunk.badLine) << ": expected \"obstacle <x> <y> <r>\", "
+						"\"bay <left> <top> <width> <height>\", \"spawn <x> <y> [heading]\", \"wall <x0> <y0> <x1> <y1>\" "
+						"or \"polygon <x0> <y0> <x1> <y1> <x2> <y2> ...\"\n";
+					return false;
+				}
+				linesBefore += chunk.lines;
+				obstacleCount += chunk.obstacles.size();
+			}
+			loaded.obstacles.reserve(obstacleCount);
+			for (const TextChunk& chunk : chunks) {
+				append(loaded.obstacles, chunk.obstacles);
+				append(loaded.parkBays, chunk.parkBays);
+				append(loaded.spawns, chunk.spawns);
+				append(loaded.walls, chunk.walls);
+				appendPolygons(loaded.polygons, chunk.polygons);
+			}
+			scene = std::move(loaded);
+			return true;
+		}
+	}
+
+	bool loadScenario(const std::string& path, Scene& scene) {
+		assets::MappedFile mapping;
+		if (!mapping.open(path)) {
+			return false;
+		}
+
+		Scene loaded = scene;
+		const auto hasMagic = [&mapping](const char (&magic)[8], std::size_t headerSize) {
+			return mapping.size() >= headerSize && std::memcmp(mapping.data(), magic, sizeof(magic)) == 0;
+		};
+		const std::size_t headerSize = hasMagic(SCENARIO_MAGIC, sizeof(ScenarioHeader)) ? sizeof(ScenarioHeader)
+			: hasMagic(SCENARIO_MAGIC_001, HEADER_001_SIZE) ? HEADER_001_SIZE
+			: 0U;
+		if (!((headerSize > 0U) ? loadBinary(path, mapping, headerSize, loaded) : loadText(path, mapping, loaded))) {
+			return false;
+		}
+		if (loaded.parkBays.empty() || loaded.spawns.empty()) {
+			std::cerr << "Error: scenario " << path << " needs at least one bay and one spawn\n";
+			return false;
+		}
+		sortObstaclesAlongZCurve(loaded.obstacles);
+		scene = std::move(loaded);
+		return true;
+	}
+
+	bool saveScenario(const std::string& path, const Scene& scene) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: Failed to create scenario " << path << '\n';
+			return false;
+		}
+
+		ScenarioHeader header{};
+		std::memcpy(header.magic, SCENARIO_MAGIC, sizeof(SCENARIO_MAGIC));
+		header.obstacleCount = static_cast<std::uint32_t>(scene.obstacles.size());
+		header.bayCount = static_cast<std::uint32_t>(scene.parkBays.size());
+		header.spawnCount = static_cast<std::uint32_t>(scene.spawns.size());
+		header.wallCount = static_cast<std::uint32_t>(scene.walls.size());
+		header.polygonStartCount = static_cast<std::uint32_t>(scene.polygons.starts.size());
+		header.polygonVertexCount = static_cast<std::uint32_t>(scene.polygons.vertices.size());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		writeArray(file, scene.obstacles);
+		writeArray(file, scene.parkBays);
+		writeArray(file, scene.spawns);
+		writeArray(file, scene.walls);
+		writeArray(file, scene.polygons.starts);
+		writeArray(file, scene.polygons.vertices);
+		if (!file) {
+			std::cerr << "Error: Failed to write scenario " << path << '\n';
+			return false;
+		}
+		return true;
+	}
+
+} // namespace sim
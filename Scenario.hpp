@@ -0,0 +1,49 @@
+/*
+==============================================================================
+Scenario - obstacle, bay and spawn layouts loaded from disk (--scenario)
+==============================================================================
+ - Binary form (.okscn): a fixed header followed by the raw obstacle, bay,
+   spawn, wall and polygon arrays. It is memory-mapped and the arrays are bulk-copied
+   into the scene, with no parsing per element, so a lot with a million
+   pillars loads in milliseconds
+ - Text form for authoring, one record per line ('#' starts a comment):
+       obstacle <centerX> <centerY> <radius>
+       bay <left> <top> <width> <height>
+       spawn <x> <y> [headingDeg]
+       wall <x0> <y0> <x1> <y1>      (a two-sided curb or wall line)
+       polygon <x0> <y0> <x1> <y1> <x2> <y2> ...
+                                     (an island or irregular curb, three
+                                     or more vertices in either winding)
+   Text is parsed in 1 MiB chunks of whole lines on the shared thread
+   pool and the chunks are merged in file order
+   --compile-scenario <in> <out> turns either form into the binary one
+ - Obstacles are stored in Z-order (sortObstaclesAlongZCurve) once
+   loaded, whatever order the file lists them in
+ - Version 001 binaries (no polygons) still load; saving writes 002
+ - A scenario needs at least one bay and one spawn; the single-car
+   front-ends watch the first bay and start at the first spawn
+==============================================================================
+*/
+
+#pragma once
+
+#include <string>
+
+#include "SimFwd.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief Loads a binary or text scenario into scene (obstacles, bays, spawns, walls, polygons).
+	 *
+	 * The form is detected from the file header. Returns false and logs on
+	 * errors; scene is left unchanged then.
+	 */
+	[[nodiscard]] bool loadScenario(const std::string& path, Scene& scene);
+
+	/**
+	 * @brief Writes the scene's obstacles, bays, spawns, walls and polygons in the binary form.
+	 */
+	[[nodiscard]] bool saveScenario(const std::string& path, const Scene& scene);
+
+} // namespace sim
@@ -0,0 +1,147 @@
+#include "ScenarioEditor.hpp"
+
+#include <algorithm>
+
+namespace gfx {
+
+	namespace {
+		constexpr float EDITOR_MARK_THICKNESS = 3.0F;
+		const sf::Color EDITOR_MARK_COLOR{ 255, 200, 0 };
+	}
+
+	ScenarioEditor::ScenarioEditor(float pillarRadius, const sf::Vector2f& baySize)
+		: m_pillarRadius(pillarRadius)
+		, m_baySize(baySize)
+	{
+		m_pillarMark.setFillColor(sf::Color::Transparent);
+		m_pillarMark.setOutlineColor(EDITOR_MARK_COLOR);
+		m_pillarMark.setOutlineThickness(EDITOR_MARK_THICKNESS);
+		m_bayMark.setFillColor(sf::Color::Transparent);
+		m_bayMark.setOutlineColor(EDITOR_MARK_COLOR);
+		m_bayMark.setOutlineThickness(EDITOR_MARK_THICKNESS);
+	}
+
+	void ScenarioEditor::setActive(bool active) {
+		m_active = active;
+		m_held = Held::None;
+	}
+
+	void ScenarioEditor::record(const SceneEdit& edit) {
+		// A later move of the item a pending edit already moves or adds replaces its "after"
+		for (SceneEdit& pending : m_edits) {
+			const bool pillar = pending.kind == SceneEdit::Kind::MovePillar || pending.kind == SceneEdit::Kind::AddPillar;
+			if (pending.index == edit.index && pillar == (edit.kind == SceneEdit::Kind::MovePillar)) {
+				pending.pillarAfter = edit.pillarAfter;
+				pending.bayAfter = edit.bayAfter;
+				return;
+			}
+		}
+		m_edits.push_back(edit);
+	}
+
+	bool ScenarioEditor::handle(const sf::Event& event, const sf::RenderWindow& window, const sf::View& camera,
+		const sim::Scene& scene, const sim::ObstacleGrid& grid, const sim::ParkingLot& lot, sim::FrameArena& arena)
+	{
+		if (!m_active) {
+			return false;
+		}
+
+		if (const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>()) {
+			const sf::Vector2f point = window.mapPixelToCoords(pressed->position, camera);
+			SceneEdit edit;
+			if (pressed->button == sf::Mouse::Button::Right) {
+				edit.kind = SceneEdit::Kind::AddBay;
+				edit.index = static_cast<std::uint32_t>(scene.parkBays.size());
+				edit.bayAfter = { point - m_baySize / 2.0F, m_baySize };
+				m_edits.push_back(edit);
+				return true;
+			}
+			if (pressed->button != sf::Mouse::Button::Left) {
+				return false;
+			}
+
+			// A pillar under the pointer, then a bay, else new ground
+			const sim::NearestObstacle nearest = grid.nearest(point, m_pillarRadius * 4.0F);
+			if (nearest.index != sim::NO_OBSTACLE && nearest.index < scene.obstacles.size()) {
+				const sim::Obstacle& pillar = scene.obstacles[nearest.index];
+				const sf::Vector2f offset = point - pillar.center;
+				if (offset.dot(offset) <= pillar.radius * pillar.radius) {
+					m_held = Held::Pillar;
+					m_index = nearest.index;
+					m_pillar = pillar;
+					m_grab = offset;
+					return true;
+				}
+			}
+			const sim::ArenaMark mark(arena);
+			for (const std::uint32_t bay : lot.queryBays({ point - sf::Vector2f{ 1.0F, 1.0F }, { 2.0F, 2.0F } }, arena)) {
+				if (lot.bay(bay).contains(point)) {
+					m_held = Held::Bay;
+					m_index = bay;
+					m_bay = lot.bay(bay);
+					m_grab = point - m_bay.position;
+					return true;
+				}
+			}
+			edit.kind = SceneEdit::Kind::AddPillar;
+			edit.index = static_cast<std::uint32_t>(scene.obstacles.size());
+			edit.pillarAfter = { point, m_pillarRadius };
+			m_edits.push_back(edit);
+			return true;
+		}
+
+		if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+			if (m_held == Held::None) {
+				return false;
+			}
+			const sf::Vector2f point = window.mapPixelToCoords(moved->position, camera);
+			SceneEdit edit;
+			edit.index = m_index;
+			if (m_held == Held::Pillar) {
+				edit.kind = SceneEdit::Kind::MovePillar;
+				edit.pillarBefore = m_pillar;
+				m_pillar.center = point - m_grab;
+				edit.pillarAfter = m_pillar;
+			}
+			else {
+				edit.kind = SceneEdit::Kind::MoveBay;
+				edit.bayBefore = m_bay;
+				m_bay.position = point - m_grab;
+				edit.bayAfter = m_bay;
+			}
+			record(edit);
+			return true;
+		}
+
+		if (const auto* released = event.getIf<sf::Event::MouseButtonReleased>()) {
+			if (released->button == sf::Mouse::Button::Left && m_held != Held::None) {
+				m_held = Held::None;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::vector<SceneEdit> ScenarioEditor::takeEdits() {
+		std::vector<SceneEdit> edits;
+		edits.swap(m_edits);
+		return edits;
+	}
+
+	void ScenarioEditor::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		if (m_held == Held::Pillar) {
+			sf::CircleShape mark = m_pillarMark;
+			mark.setRadius(m_pillar.radius);
+			mark.setOrigin({ m_pillar.radius, m_pillar.radius });
+			mark.setPosition(m_pillar.center);
+			target.draw(mark, states);
+		}
+		else if (m_held == Held::Bay) {
+			sf::RectangleShape mark = m_bayMark;
+			mark.setSize(m_bay.size);
+			mark.setPosition(m_bay.position);
+			target.draw(mark, states);
+		}
+	}
+
+} // namespace gfx
@@ -0,0 +1,101 @@
+/*
+==============================================================================
+Scenario Editor - placing and dragging pillars and bays in the running lot
+==============================================================================
+ - E turns editing on and off (not with --world, whose tiles come and go);
+   while it is on the mouse edits the scene and the car keeps driving
+ - Left button: grabs the pillar or bay under the pointer and drags it,
+   or places a new pillar on empty ground; right button places a bay
+   centered on the pointer. F5 writes the scene (--edit-save)
+ - The editor only picks and records: each change comes out as a
+   SceneEdit with the item's index and its shape before and after, and
+   the caller updates the indexes, the distance field and the static
+   layer for just that area (see the scene edit in main.cpp)
+ - Several moves of one item within a frame come out as one edit, from
+   where the frame found it to where the pointer left it
+ - The picked item is outlined on top of the scene while it is held
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "ObstacleGrid.hpp"
+#include "ParkingLot.hpp"
+#include "Scene.hpp"
+
+namespace gfx {
+
+	// One change to the scene; index is the item's position in scene.obstacles or scene.parkBays
+	struct SceneEdit {
+		enum class Kind : std::uint8_t { MovePillar, AddPillar, MoveBay, AddBay };
+
+		Kind kind = Kind::MovePillar;
+		std::uint32_t index = 0U;
+		sim::Obstacle pillarBefore{};  // Move: where it was
+		sim::Obstacle pillarAfter{};
+		sf::FloatRect bayBefore;       // Move: where it was
+		sf::FloatRect bayAfter;
+	};
+
+	class ScenarioEditor : public sf::Drawable {
+	public:
+		/**
+		 * @brief New pillars get pillarRadius, new bays baySize.
+		 */
+		ScenarioEditor(float pillarRadius, const sf::Vector2f& baySize);
+
+		[[nodiscard]] bool active() const noexcept { return m_active; }
+
+		/**
+		 * @brief Turns editing on or off; off drops any held item.
+		 */
+		void setActive(bool active);
+
+		/**
+		 * @brief Handles the mouse while active; returns true if the event was an edit gesture.
+		 *
+		 * Pointer positions are mapped into the world through camera. The
+		 * scene, grid and lot are only read, to pick what is under the pointer.
+		 */
+		bool handle(const sf::Event& event, const sf::RenderWindow& window, const sf::View& camera,
+			const sim::Scene& scene, const sim::ObstacleGrid& grid, const sim::ParkingLot& lot, sim::FrameArena& arena);
+
+		/**
+		 * @brief Edits since the last call, in the order they were made; the caller applies them to the scene.
+		 */
+		[[nodiscard]] std::vector<SceneEdit> takeEdits();
+
+		/**
+		 * @brief True while an item is held: the caller may defer whole-scene refreshes until it is let go.
+		 */
+		[[nodiscard]] bool dragging() const noexcept { return m_held != Held::None; }
+
+	private:
+		enum class Held : std::uint8_t { None, Pillar, Bay };
+
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		// Records where the held item is now, merged with an edit of it still pending
+		void record(const SceneEdit& edit);
+
+		float m_pillarRadius;
+		sf::Vector2f m_baySize;
+		bool m_active = false;
+
+		Held m_held = Held::None;
+		std::uint32_t m_index = 0U;
+		sf::Vector2f m_grab{ 0.0F, 0.0F };   // pointer offset from the item's center or corner
+		sim::Obstacle m_pillar{};           // the held pillar as it is now
+		sf::FloatRect m_bay;                // the held bay as it is now
+
+		std::vector<SceneEdit> m_edits;
+		sf::CircleShape m_pillarMark;
+		sf::RectangleShape m_bayMark;
+	};
+
+} // namespace gfx
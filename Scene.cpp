@@ -0,0 +1,190 @@
+#include "Scene.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "Constants.hpp"
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	namespace {
+		// Each axis is quantized to this many bits of the Z-order key
+		constexpr std::uint32_t MORTON_AXIS_MAX = 0xFFFFU;
+
+		// Obstacles per pool task when computing keys
+		constexpr std::size_t MORTON_KEYS_PER_TASK = 32768U;
+
+		// Spreads the low 16 bits of v to the even bit positions
+		[[nodiscard]] std::uint32_t spreadBits(std::uint32_t v) noexcept {
+			v &= 0x0000FFFFU;
+			v = (v | (v << 8U)) & 0x00FF00FFU;
+			v = (v | (v << 4U)) & 0x0F0F0F0FU;
+			v = (v | (v << 2U)) & 0x33333333U;
+			v = (v | (v << 1U)) & 0x55555555U;
+			return v;
+		}
+
+		[[nodiscard]] std::uint32_t quantizeAxis(float value, float origin, float scale) noexcept {
+			// max first: a NaN coordinate lands on 0 instead of an undefined conversion
+			const float t = std::min(std::max(0.0F, (value - origin) * scale), static_cast<float>(MORTON_AXIS_MAX));
+			return static_cast<std::uint32_t>(t);
+		}
+	}
+
+	Scene makeDefaultScene() {
+		const std::vector<sf::Vector2f> pozicije = {
+			{800.f, 500.f},
+			{1550.f, 800.f},
+			{1810.f, 800.f}
+		};
+
+		Scene scene;
+		scene.obstacles = createObstacles(pozicije, constants::OBSTACLE_RADIUS);
+		scene.parkBays.push_back({
+			{ constants::WORLD_WIDTH - constants::PARK_WIDTH - constants::PARK_MARGIN, constants::PARK_MARGIN },
+			{ constants::PARK_WIDTH, constants::PARK_HEIGHT }
+		});
+		scene.spawns.push_back({ { 250.0F, 250.0F }, 0.0F });
+		scene.movers = {
+			{ MoverKind::Pedestrian, { { 500.0F, 300.0F }, { 1200.0F, 300.0F }, { 1200.0F, 650.0F }, { 500.0F, 650.0F } },
+				constants::PEDESTRIAN_SPEED, constants::PEDESTRIAN_RADIUS },
+			{ MoverKind::Pedestrian, { { 1000.0F, 150.0F }, { 1000.0F, 950.0F } },
+				constants::PEDESTRIAN_SPEED, constants::PEDESTRIAN_RADIUS },
+			{ MoverKind::Car, { { 200.0F, 1000.0F }, { 1700.0F, 1000.0F } },
+				constants::MOVER_CAR_SPEED, constants::MOVER_CAR_RADIUS }
+		};
+		scene.carHalfExtent = { constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT };
+		return scene;
+	}
+
+	sf::FloatRect sceneBounds(const Scene& scene) {
+		sf::Vector2f low{ 0.0F, 0.0F };
+		sf::Vector2f high{ constants::WORLD_WIDTH, constants::WORLD_HEIGHT };
+		const auto extend = [&](const sf::Vector2f& a, const sf::Vector2f& b) {
+			low = { std::min(low.x, a.x), std::min(low.y, a.y) };
+			high = { std::max(high.x, b.x), std::max(high.y, b.y) };
+		};
+		for (const auto& obstacle : scene.obstacles) {
+			const sf::Vector2f reach{ obstacle.radius, obstacle.radius };
+			extend(obstacle.center - reach, obstacle.center + reach);
+		}
+		for (const auto& wall : scene.walls) {
+			extend({ std::min(wall.from.x, wall.to.x), std::min(wall.from.y, wall.to.y) },
+				{ std::max(wall.from.x, wall.to.x), std::max(wall.from.y, wall.to.y) });
+		}
+		for (const auto& vertex : scene.polygons.vertices) {
+			extend(vertex, vertex);
+		}
+		for (const auto& bay : scene.parkBays) {
+			extend(bay.position, bay.position + bay.size);
+		}
+		for (const auto& spawn : scene.spawns) {
+			extend(spawn.position, spawn.position);
+		}
+		for (const auto& route : scene.movers) {
+			const sf::Vector2f reach{ route.radius, route.radius };
+			for (const auto& waypoint : route.waypoints) {
+				extend(waypoint - reach, waypoint + reach);
+			}
+		}
+		return { low, high - low };
+	}
+
+	std::vector<WallSegment> boundaryWalls(const sf::FloatRect& bounds) {
+		// Clockwise on screen, so the lot is on the right of every side and the outside on the left
+		const sf::Vector2f topLeft = bounds.position;
+		const sf::Vector2f topRight{ bounds.position.x + bounds.size.x, bounds.position.y };
+		const sf::Vector2f bottomRight = bounds.position + bounds.size;
+		const sf::Vector2f bottomLeft{ bounds.position.x, bounds.position.y + bounds.size.y };
+		return {
+			{ topLeft, topRight, 1U },
+			{ topRight, bottomRight, 1U },
+			{ bottomRight, bottomLeft, 1U },
+			{ bottomLeft, topLeft, 1U }
+		};
+	}
+
+	std::vector<WallSegment> sceneWalls(const Scene& scene, const sf::FloatRect& bounds) {
+		std::vector<WallSegment> walls = scene.walls;
+		const std::vector<WallSegment> boundary = boundaryWalls(bounds);
+		walls.insert(walls.end(), boundary.begin(), boundary.end());
+		return walls;
+	}
+
+	std::vector<Obstacle> createObstacles(const std::vector<sf::Vector2f>& positions, float radius) {
+		std::vector<Obstacle> obstacles;
+		obstacles.reserve(positions.size());
+
+		for (const auto& pos : positions) {
+			obstacles.push_back({ { pos.x + radius, pos.y + radius }, radius });
+		}
+
+		return obstacles;
+	}
+
+	std::vector<sf::Vector2f> obstacleCenters(const std::vector<Obstacle>& obstacles) {
+		std::vector<sf::Vector2f> centers;
+		centers.reserve(obstacles.size());
+
+		for (const auto& obstacle : obstacles) {
+			centers.push_back(obstacle.center);
+		}
+
+		return centers;
+	}
+
+	void sortObstaclesAlongZCurve(std::vector<Obstacle>& obstacles) {
+		if (obstacles.size() < 2U) {
+			return;
+		}
+		sf::Vector2f minP = obstacles.front().center;
+		sf::Vector2f maxP = minP;
+		for (const Obstacle& obstacle : obstacles) {
+			minP = { std::min(minP.x, obstacle.center.x), std::min(minP.y, obstacle.center.y) };
+			maxP = { std::max(maxP.x, obstacle.center.x), std::max(maxP.y, obstacle.center.y) };
+		}
+		// One scale for both axes, so the curve's cells stay square
+		const float extent = std::max({ maxP.x - minP.x, maxP.y - minP.y, 1.0F });
+		const float scale = static_cast<float>(MORTON_AXIS_MAX) / extent;
+
+		const std::size_t count = obstacles.size();
+		std::vector<std::uint32_t> keys(count);
+		sharedPool().parallelFor(count, MORTON_KEYS_PER_TASK, [&](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				const sf::Vector2f& c = obstacles[i].center;
+				keys[i] = spreadBits(quantizeAxis(c.x, minP.x, scale))
+					| (spreadBits(quantizeAxis(c.y, minP.y, scale)) << 1U);
+			}
+		});
+
+		// LSD radix sort on the key, a byte per pass; stable, so equal keys keep file order
+		std::vector<std::uint32_t> order(count);
+		std::vector<std::uint32_t> scratch(count);
+		for (std::size_t i = 0U; i < count; ++i) {
+			order[i] = static_cast<std::uint32_t>(i);
+		}
+		for (std::uint32_t shift = 0U; shift < 32U; shift += 8U) {
+			std::array<std::uint32_t, 257> start{};
+			for (const std::uint32_t index : order) {
+				++start[((keys[index] >> shift) & 0xFFU) + 1U];
+			}
+			for (std::size_t b = 0U; b < 256U; ++b) {
+				start[b + 1U] += start[b];
+			}
+			for (const std::uint32_t index : order) {
+				scratch[start[(keys[index] >> shift) & 0xFFU]++] = index;
+			}
+			order.swap(scratch);
+		}
+
+		std::vector<Obstacle> sorted;
+		sorted.reserve(count);
+		for (const std::uint32_t index : order) {
+			sorted.push_back(obstacles[index]);
+		}
+		obstacles = std::move(sorted);
+	}
+
+} // namespace sim
@@ -0,0 +1,89 @@
+/*
+==============================================================================
+Scene - obstacle, bay and spawn layout shared by all front-ends
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "PolygonBvh.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	enum class MoverKind : std::uint8_t {
+		Pedestrian = 0,
+		Car = 1
+	};
+
+	// A closed loop of waypoints a moving obstacle walks or drives at constant speed;
+	// two waypoints make it go back and forth
+	struct MoverRoute {
+		MoverKind kind = MoverKind::Pedestrian;
+		std::vector<sf::Vector2f> waypoints;
+		float speed = 0.0F;  // px per second
+		float radius = 0.0F; // body circle
+	};
+
+	struct Scene {
+		std::vector<Obstacle> obstacles;
+		std::vector<WallSegment> walls;      // curbs and interior walls; the lot boundary is added by sceneWalls()
+		PolygonSet polygons;                 // islands and irregular curbs
+		std::vector<sf::FloatRect> parkBays; // the single-car front-ends watch the first one
+		std::vector<CarState> spawns;        // the single-car front-ends start at the first one
+		std::vector<MoverRoute> movers;      // one moving obstacle per route (--movers)
+		sf::Vector2f carHalfExtent{ 0.0F, 0.0F };
+	};
+
+	/**
+	 * @brief The built-in lot: three pillars and one bay in the top-right corner,
+	 *        two pedestrians and a car doing laps of the aisles.
+	 *
+	 * Layouts from disk (--scenario) replace its obstacles, bays and spawns
+	 * and have no movers.
+	 */
+	[[nodiscard]] Scene makeDefaultScene();
+
+	/**
+	 * @brief Area spanned by the scene: the default world rectangle grown to
+	 *        cover every obstacle, wall, polygon, bay, spawn and mover route.
+	 */
+	[[nodiscard]] sf::FloatRect sceneBounds(const Scene& scene);
+
+	/**
+	 * @brief The four sides of bounds as one-sided walls, solid outside.
+	 */
+	[[nodiscard]] std::vector<WallSegment> boundaryWalls(const sf::FloatRect& bounds);
+
+	/**
+	 * @brief Every wall the sensors see: the scene's walls and the sides of bounds.
+	 */
+	[[nodiscard]] std::vector<WallSegment> sceneWalls(const Scene& scene, const sf::FloatRect& bounds);
+
+	/**
+	 * @brief Creates obstacle records from the top-left positions of their circles.
+	 */
+	[[nodiscard]] std::vector<Obstacle> createObstacles(const std::vector<sf::Vector2f>& positions, float radius);
+
+	/**
+	 * @brief Centers of a set of obstacles, used to build the spatial index.
+	 */
+	[[nodiscard]] std::vector<sf::Vector2f> obstacleCenters(const std::vector<Obstacle>& obstacles);
+
+	/**
+	 * @brief Reorders obstacles along a Z-order (Morton) curve over their centers.
+	 *
+	 * Neighbours on the map become neighbours in memory, so a grid cell or a
+	 * BVH leaf covers a near-contiguous index range and queries stream through
+	 * the obstacle arrays. Obstacle indices change; ties keep their order.
+	 */
+	void sortObstaclesAlongZCurve(std::vector<Obstacle>& obstacles);
+
+} // namespace sim
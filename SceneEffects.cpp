@@ -0,0 +1,190 @@
+#include "SceneEffects.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "FastTrig.hpp"
+
+namespace gfx {
+
+	namespace {
+		// Headlights reach this many car half-lengths ahead, in a cone of this half angle
+		constexpr float HEADLIGHT_REACH = 6.0F;
+		constexpr float HEADLIGHT_CONE_COS = 0.866F; // 30 degrees
+		constexpr float TAIL_LIGHT_REACH = 0.8F;
+
+		// The streak clock wraps so the shader's time keeps its float precision;
+		// the wrap is a one-frame jump in the rain
+		constexpr float EFFECT_TIME_WRAP = 1000.0F;
+
+		// RenderScaler's unsharp mask, then rain and lighting on the same pixel.
+		// RAIN_LAYERS, MAX_LIGHTS and REFRACTION come from the tier's budget
+		constexpr const char* EFFECTS_FRAGMENT_SHADER = R"(
+uniform sampler2D texture;
+uniform vec2 u_texel;
+uniform float u_amount;
+uniform vec2 u_resolution;
+uniform float u_time;
+uniform float u_rain;
+uniform float u_night;
+uniform int u_lightCount;
+uniform vec4 u_lights[MAX_LIGHTS];
+uniform vec4 u_tints[MAX_LIGHTS];
+
+float effectHash(vec2 p) {
+	return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
+}
+
+// One layer of slanted streaks: a column of cells per cell width, at most one drop per cell
+float rainLayer(vec2 pixel, float cell, float speed, float seed) {
+	vec2 uv = pixel / cell;
+	uv.y = uv.y * 0.25 - u_time * speed;
+	uv.x += uv.y * 0.6;
+	vec2 id = floor(uv);
+	vec2 local = fract(uv);
+	float h = effectHash(id + seed);
+	float dense = step(1.0 - 0.6 * u_rain, effectHash(id.yx + seed * 3.1));
+	float across = 1.0 - smoothstep(0.0, 0.08, abs(local.x - (0.2 + 0.6 * h)));
+	float along = smoothstep(0.0, 0.6, local.y) * (1.0 - smoothstep(0.6, 0.95, local.y));
+	return dense * across * along;
+}
+
+void main() {
+	vec2 uv = gl_TexCoord[0].xy;
+	vec2 pixel = vec2(gl_FragCoord.x, u_resolution.y - gl_FragCoord.y);
+
+	float drops = 0.0;
+#if RAIN_LAYERS > 0
+	if (u_rain > 0.0) {
+		drops += rainLayer(pixel, 14.0, 3.0, 0.0);
+#if RAIN_LAYERS > 1
+		drops += 0.7 * rainLayer(pixel, 9.0, 2.2, 17.0);
+#endif
+#if RAIN_LAYERS > 2
+		drops += 0.5 * rainLayer(pixel, 6.0, 1.6, 41.0);
+#endif
+	}
+#endif
+#if REFRACTION
+	uv.x += drops * 3.0 * u_texel.x;
+#endif
+
+	vec3 center = texture2D(texture, uv).rgb;
+	vec3 around = texture2D(texture, uv + vec2(u_texel.x, 0.0)).rgb
+		+ texture2D(texture, uv - vec2(u_texel.x, 0.0)).rgb
+		+ texture2D(texture, uv + vec2(0.0, u_texel.y)).rgb
+		+ texture2D(texture, uv - vec2(0.0, u_texel.y)).rgb;
+	vec3 color = clamp(center + u_amount * (center - 0.25 * around), 0.0, 1.0);
+	color = mix(color, color * vec3(0.8, 0.85, 0.95), u_rain);
+
+	vec3 light = vec3(1.0 - u_night);
+	for (int i = 0; i < MAX_LIGHTS; ++i) {
+		if (i >= u_lightCount) {
+			break;
+		}
+		vec2 to = pixel - u_lights[i].xy;
+		float d = length(to);
+		float falloff = clamp(1.0 - d / u_lights[i].z, 0.0, 1.0);
+		float facing = dot(to / max(d, 0.001), vec2(cos(u_tints[i].w), sin(u_tints[i].w)));
+		float cone = (u_lights[i].w > -1.0) ? smoothstep(u_lights[i].w, mix(u_lights[i].w, 1.0, 0.3), facing) : 1.0;
+		light += u_night * u_tints[i].rgb * (falloff * falloff * cone);
+	}
+	color = color * light + drops * 0.35 * (1.0 - 0.5 * u_night);
+	gl_FragColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
+)";
+
+		// World point to window pixels (y down) through view
+		[[nodiscard]] sf::Vector2f toWindow(const sf::View& view, const sf::Vector2f& point, const sf::Vector2f& windowSize) {
+			const sf::Vector2f ndc = view.getTransform().transformPoint(point);
+			return { (ndc.x + 1.0F) * 0.5F * windowSize.x, (1.0F - ndc.y) * 0.5F * windowSize.y };
+		}
+	}
+
+	EffectBudget effectBudget(EffectTier tier) noexcept {
+		switch (tier) {
+		case EffectTier::Low: return { 1U, 2U, false };
+		case EffectTier::Medium: return { 2U, 4U, true };
+		default: return { 3U, SceneEffects::MAX_LIGHTS, true };
+		}
+	}
+
+	std::optional<EffectTier> parseEffectTier(std::string_view name) noexcept {
+		if (name == "low") { return EffectTier::Low; }
+		if (name == "medium") { return EffectTier::Medium; }
+		if (name == "high") { return EffectTier::High; }
+		return std::nullopt;
+	}
+
+	bool SceneEffects::create(const EffectSettings& settings) {
+		m_ready = false;
+		if (!settings.enabled()) {
+			return false;
+		}
+		if (!sf::Shader::isAvailable()) {
+			std::cerr << "Error: shaders are unavailable, rain and night effects are off\n";
+			return false;
+		}
+		m_budget = effectBudget(settings.tier);
+		const std::string fragment = "#version 120\n#define RAIN_LAYERS " + std::to_string(m_budget.rainLayers)
+			+ "\n#define MAX_LIGHTS " + std::to_string(m_budget.maxLights)
+			+ "\n#define REFRACTION " + (m_budget.refraction ? "1" : "0") + "\n" + EFFECTS_FRAGMENT_SHADER;
+		if (!m_shader.loadFromMemory(fragment, sf::Shader::Type::Fragment)) {
+			return false; // SFML has logged the compiler output
+		}
+		m_shader.setUniform("texture", sf::Shader::CurrentTexture);
+		m_shader.setUniform("u_rain", std::clamp(settings.rain, 0.0F, 1.0F));
+		m_shader.setUniform("u_night", std::clamp(settings.night, 0.0F, 1.0F));
+		m_shader.setUniform("u_lightCount", 0);
+		m_ready = true;
+		return true;
+	}
+
+	void SceneEffects::update(float dt, const SceneLight* lights, std::size_t count, const sf::View& view,
+		const sf::Vector2u& windowSize)
+	{
+		if (!m_ready) {
+			return;
+		}
+		m_time = std::fmod(m_time + dt, EFFECT_TIME_WRAP);
+		m_shader.setUniform("u_time", m_time);
+
+		const sf::Vector2f window(windowSize);
+		const float pixelsPerUnit = window.x / std::max(view.getSize().x, 1.0F);
+		count = std::min(count, static_cast<std::size_t>(m_budget.maxLights));
+		for (std::size_t i = 0U; i < count; ++i) {
+			const SceneLight& light = lights[i];
+			const sf::Vector2f at = toWindow(view, light.position, window);
+			const sf::Vector2f ahead = toWindow(view, light.position + light.direction, window) - at;
+			m_lights[i] = { at.x, at.y, light.radius * pixelsPerUnit, light.coneCos };
+			m_tints[i] = { static_cast<float>(light.color.r) / 255.0F, static_cast<float>(light.color.g) / 255.0F,
+				static_cast<float>(light.color.b) / 255.0F, std::atan2(ahead.y, ahead.x) };
+		}
+		if (count > 0U) {
+			m_shader.setUniformArray("u_lights", m_lights.data(), count);
+			m_shader.setUniformArray("u_tints", m_tints.data(), count);
+		}
+		m_shader.setUniform("u_lightCount", static_cast<int>(count));
+	}
+
+	std::array<SceneLight, 4> carLights(const sf::Vector2f& position, float headingDeg, const sf::Vector2f& halfExtent) {
+		const sim::SinCos heading = sim::sinCosDeg(headingDeg);
+		const sf::Vector2f axis{ heading.cos, heading.sin };
+		const sf::Vector2f side{ -heading.sin, heading.cos };
+		const sf::Color headlight{ 255, 244, 214 };
+		const sf::Color tailLight{ 255, 40, 30 };
+		return { {
+			{ position + axis * halfExtent.x - side * (0.6F * halfExtent.y), axis, HEADLIGHT_REACH * halfExtent.x,
+				HEADLIGHT_CONE_COS, headlight },
+			{ position + axis * halfExtent.x + side * (0.6F * halfExtent.y), axis, HEADLIGHT_REACH * halfExtent.x,
+				HEADLIGHT_CONE_COS, headlight },
+			{ position - axis * halfExtent.x - side * (0.7F * halfExtent.y), {}, TAIL_LIGHT_REACH * halfExtent.x, -1.0F,
+				tailLight },
+			{ position - axis * halfExtent.x + side * (0.7F * halfExtent.y), {}, TAIL_LIGHT_REACH * halfExtent.x, -1.0F,
+				tailLight }
+		} };
+	}
+
+} // namespace gfx
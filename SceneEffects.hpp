@@ -0,0 +1,113 @@
+/*
+==============================================================================
+Scene Effects - rain and night lighting as one post-process pass (--rain, --night)
+==============================================================================
+ - Applied while the scene texture (RenderScaler) is copied to the window:
+   the same full-screen quad that upscales and sharpens also draws the rain
+   and the lighting, so the effects add no render target and no pass of
+   their own. With both effects off nothing is compiled, and the scene
+   texture is only made when --render-scale asks for it
+ - Rain: procedural streaks in up to three parallax layers falling across
+   the screen, with a wet tint; on the higher tiers each streak bends the
+   scene behind it (one offset tap)
+ - Night: the scene darkened to an ambient level, with light added back by
+   point and cone lights (the car's headlights and tail lights) in window
+   pixels, falling off with the square of the distance
+ - Cost is bounded per quality tier at compile time: the tier's budget
+   (rain layers, lights, refraction) is baked into the shader as #defines,
+   so a pixel never runs more than its tier's loop, whatever is handed in
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace gfx {
+
+	enum class EffectTier : std::uint8_t { Low, Medium, High };
+
+	// What one tier may spend per pixel
+	struct EffectBudget {
+		std::uint32_t rainLayers = 0U; // parallax streak layers
+		std::uint32_t maxLights = 0U;  // night lights evaluated
+		bool refraction = false;       // streaks offset the scene sample
+	};
+
+	/**
+	 * @brief The budget of tier.
+	 */
+	[[nodiscard]] EffectBudget effectBudget(EffectTier tier) noexcept;
+
+	/**
+	 * @brief Tier named low, medium or high.
+	 */
+	[[nodiscard]] std::optional<EffectTier> parseEffectTier(std::string_view name) noexcept;
+
+	struct EffectSettings {
+		float rain = 0.0F;   // 0 = dry, 1 = downpour
+		float night = 0.0F;  // 0 = day, 1 = lit only by the lights
+		EffectTier tier = EffectTier::High;
+
+		[[nodiscard]] bool enabled() const noexcept { return rain > 0.0F || night > 0.0F; }
+	};
+
+	// A light in world units; a zero direction makes it a point light
+	struct SceneLight {
+		sf::Vector2f position;
+		sf::Vector2f direction;
+		float radius = 0.0F;
+		float coneCos = -1.0F; // cosine of the half angle for a cone light
+		sf::Color color = sf::Color::White;
+	};
+
+	class SceneEffects {
+	public:
+		static constexpr std::size_t MAX_LIGHTS = 8U; // the High tier's budget
+
+		/**
+		 * @brief Compiles the pass for settings' tier; false with both effects off.
+		 *
+		 * Requires an active GL context with shaders. Returns false (and logs)
+		 * if they are missing; the scene is then presented without effects.
+		 */
+		[[nodiscard]] bool create(const EffectSettings& settings);
+
+		[[nodiscard]] bool ready() const noexcept { return m_ready; }
+		[[nodiscard]] const EffectBudget& budget() const noexcept { return m_budget; }
+
+		/**
+		 * @brief Advances the rain by dt seconds and sets the lights (those past the tier's budget are dropped).
+		 *
+		 * Lights are mapped through view onto a window of windowSize pixels.
+		 */
+		void update(float dt, const SceneLight* lights, std::size_t count, const sf::View& view,
+			const sf::Vector2u& windowSize);
+
+		/**
+		 * @brief The pass, for RenderScaler::present(); null until create() succeeded.
+		 */
+		[[nodiscard]] sf::Shader* shader() noexcept { return m_ready ? &m_shader : nullptr; }
+
+	private:
+		sf::Shader m_shader;
+		EffectBudget m_budget;
+		std::array<sf::Glsl::Vec4, MAX_LIGHTS> m_lights{}; // x, y (window pixels), radius, cone cosine
+		std::array<sf::Glsl::Vec4, MAX_LIGHTS> m_tints{};  // r, g, b, facing (radians)
+		float m_time = 0.0F;
+		bool m_ready = false;
+	};
+
+	/**
+	 * @brief The car's two headlight cones and two tail-light glows at pose.
+	 */
+	[[nodiscard]] std::array<SceneLight, 4> carLights(const sf::Vector2f& position, float headingDeg,
+		const sf::Vector2f& halfExtent);
+
+} // namespace gfx
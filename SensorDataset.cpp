@@ -0,0 +1,286 @@
+#include "SensorDataset.hpp"
+
+#include <SFML/Graphics/Transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include "CarModel.hpp"
+#include "SensorNoise.hpp"
+#include "Sensors.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr char DATASET_MAGIC[8] = { 'O', 'K', 'S', 'D', 'S', '0', '0', '1' };
+
+		// Poses cast in one lot: the grid build is paid once per this many samples
+		constexpr std::uint32_t DATASET_LOT_POSES = 1024U;
+		constexpr std::uint32_t DATASET_MIN_PILLARS = 8U;
+		constexpr std::uint32_t DATASET_MAX_PILLARS = 48U;
+		constexpr float DATASET_MIN_RADIUS = 15.0F;
+		constexpr float DATASET_MAX_RADIUS = 35.0F;
+		constexpr std::uint32_t DATASET_MAX_BOXES = 8U;
+		constexpr float DATASET_CELL_SIZE = 64.0F;
+		// Tries to place the car clear of the pillars before it is left where the last one fell
+		constexpr std::uint32_t DATASET_POSE_TRIES = 8U;
+		// A sensor faces along its rectangle's long axis, as in readSensors()
+		constexpr float DATASET_FACING_OFFSET_DEG = 90.0F;
+
+		// Philox stream ids within a lot
+		constexpr std::uint32_t DATASET_LOT_STREAM = 0U;
+		constexpr std::uint32_t DATASET_POSE_STREAM = 1U;
+
+		constexpr float DATASET_WORD_UNIT = 1.0F / 4294967296.0F;
+
+		// Uniform draws from Philox counters (lot, pose, stream, n), four words per call
+		class DatasetRandom {
+		public:
+			DatasetRandom(PhiloxKey key, std::uint32_t lot, std::uint32_t pose, std::uint32_t stream) noexcept
+				: m_key(key), m_counter{ lot, pose, stream, 0U } {}
+
+			[[nodiscard]] float unit() noexcept {
+				if (m_used == m_words.size()) {
+					m_words = philox4x32(m_counter, m_key);
+					++m_counter[3];
+					m_used = 0U;
+				}
+				return static_cast<float>(m_words[m_used++]) * DATASET_WORD_UNIT;
+			}
+
+			[[nodiscard]] float range(float low, float high) noexcept { return low + (high - low) * unit(); }
+
+			[[nodiscard]] std::uint32_t count(std::uint32_t low, std::uint32_t high) noexcept {
+				return std::min(high, low + static_cast<std::uint32_t>(unit() * static_cast<float>(high - low + 1U)));
+			}
+
+		private:
+			PhiloxKey m_key;
+			PhiloxCounter m_counter;
+			PhiloxCounter m_words{};
+			std::size_t m_used = 4U;
+		};
+
+		struct DatasetLot {
+			std::vector<Obstacle> pillars;
+			std::vector<sf::FloatRect> boxes;
+			RayCaster caster;
+		};
+
+		// Exact distance from point to the nearest pillar or box surface; 0 inside one
+		[[nodiscard]] float nearestDatasetSurface(const DatasetLot& lot, sf::Vector2f point) noexcept {
+			float best = std::numeric_limits<float>::max();
+			for (const Obstacle& pillar : lot.pillars) {
+				const sf::Vector2f d = point - pillar.center;
+				best = std::min(best, std::sqrt(d.x * d.x + d.y * d.y) - pillar.radius);
+			}
+			for (const sf::FloatRect& box : lot.boxes) {
+				const float dx = std::max({ box.position.x - point.x, 0.0F, point.x - (box.position.x + box.size.x) });
+				const float dy = std::max({ box.position.y - point.y, 0.0F, point.y - (box.position.y + box.size.y) });
+				best = std::min(best, std::sqrt(dx * dx + dy * dy));
+			}
+			return std::max(best, 0.0F);
+		}
+
+		void buildDatasetLot(const DatasetConfig& config, PhiloxKey key, std::uint32_t lotIndex, DatasetLot& lot) {
+			DatasetRandom random(key, lotIndex, 0U, DATASET_LOT_STREAM);
+			const sf::FloatRect& area = config.lot;
+			lot.pillars.resize(random.count(DATASET_MIN_PILLARS, DATASET_MAX_PILLARS));
+			for (Obstacle& pillar : lot.pillars) {
+				pillar = Obstacle{};
+				pillar.radius = random.range(DATASET_MIN_RADIUS, DATASET_MAX_RADIUS);
+				pillar.center = { random.range(area.position.x, area.position.x + area.size.x),
+					random.range(area.position.y, area.position.y + area.size.y) };
+			}
+			// Parked cars: the car's footprint, lengthwise or crosswise
+			lot.boxes.resize(random.count(0U, DATASET_MAX_BOXES));
+			for (sf::FloatRect& box : lot.boxes) {
+				const sf::Vector2f size = (random.unit() < 0.5F) ? config.carHalfExtent * 2.0F
+					: sf::Vector2f{ config.carHalfExtent.y, config.carHalfExtent.x } * 2.0F;
+				box = { { random.range(area.position.x, area.position.x + area.size.x - size.x),
+					random.range(area.position.y, area.position.y + area.size.y - size.y) }, size };
+			}
+			lot.caster.build(lot.pillars, lot.boxes, DATASET_CELL_SIZE);
+		}
+
+		// One lot's rows; the arrays keep their capacity from wave to wave
+		struct DatasetBlock {
+			std::uint32_t rows = 0U;
+			std::vector<float> x;
+			std::vector<float> y;
+			std::vector<float> heading;
+			std::vector<float> measured;
+			std::vector<float> nearest;
+		};
+
+		void castDatasetLot(const DatasetConfig& config, const std::vector<SensorMount>& mounts, PhiloxKey key,
+			std::uint32_t lotIndex, std::uint32_t rows, DatasetLot& lot, std::vector<SensorPose>& poses, DatasetBlock& block)
+		{
+			OKPP_TRACE_SCOPE("dataset lot");
+			buildDatasetLot(config, key, lotIndex, lot);
+			const std::size_t sensors = mounts.size();
+			block.rows = rows;
+			block.x.resize(rows);
+			block.y.resize(rows);
+			block.heading.resize(rows);
+			block.measured.resize(static_cast<std::size_t>(rows) * sensors);
+			block.nearest.resize(static_cast<std::size_t>(rows) * sensors);
+			poses.resize(sensors);
+
+			const sf::FloatRect& area = config.lot;
+			const float clearance = std::min(config.carHalfExtent.x, config.carHalfExtent.y);
+			for (std::uint32_t row = 0U; row < rows; ++row) {
+				DatasetRandom random(key, lotIndex, row, DATASET_POSE_STREAM);
+				CarState car;
+				for (std::uint32_t attempt = 0U; attempt < DATASET_POSE_TRIES; ++attempt) {
+					car.position = { random.range(area.position.x, area.position.x + area.size.x),
+						random.range(area.position.y, area.position.y + area.size.y) };
+					if (nearestDatasetSurface(lot, car.position) > clearance) {
+						break;
+					}
+				}
+				car.headingDeg = random.range(0.0F, 360.0F);
+				block.x[row] = car.position.x;
+				block.y[row] = car.position.y;
+				block.heading[row] = car.headingDeg;
+
+				placeSensors(carTransform(car), car.headingDeg, mounts.data(), sensors, poses.data());
+				const std::size_t first = static_cast<std::size_t>(row) * sensors;
+				for (std::size_t i = 0U; i < sensors; ++i) {
+					const RayHit hit = lot.caster.castConeHit(poses[i].position, poses[i].rotationDeg + DATASET_FACING_OFFSET_DEG,
+						config.cone);
+					block.measured[first + i] = hit.distance;
+					block.nearest[first + i] = nearestDatasetSurface(lot, poses[i].position);
+				}
+			}
+		}
+
+		template <typename T>
+		void writeDatasetColumn(std::ofstream& file, const std::vector<T>& column) {
+			file.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+		}
+
+		template <typename T>
+		[[nodiscard]] bool readDatasetColumn(std::ifstream& file, std::size_t count, std::vector<T>& column) {
+			const std::size_t offset = column.size();
+			column.resize(offset + count);
+			file.read(reinterpret_cast<char*>(column.data() + offset), static_cast<std::streamsize>(count * sizeof(T)));
+			return static_cast<bool>(file);
+		}
+
+		void writeDatasetBlock(std::ofstream& file, const DatasetBlock& block) {
+			file.write(reinterpret_cast<const char*>(&block.rows), sizeof(block.rows));
+			writeDatasetColumn(file, block.x);
+			writeDatasetColumn(file, block.y);
+			writeDatasetColumn(file, block.heading);
+			writeDatasetColumn(file, block.measured);
+			writeDatasetColumn(file, block.nearest);
+		}
+	}
+
+	bool generateSensorDataset(const std::string& path, const DatasetConfig& config, ThreadPool& pool, DatasetStats& stats) {
+		stats = {};
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: cannot write dataset " << path << '\n';
+			return false;
+		}
+		const std::vector<SensorMount> mounts = createSensorMounts(config.carHalfExtent, config.rig);
+		const auto sensorCount = static_cast<std::uint32_t>(mounts.size());
+		file.write(DATASET_MAGIC, sizeof(DATASET_MAGIC));
+		file.write(reinterpret_cast<const char*>(&sensorCount), sizeof(sensorCount));
+
+		const auto start = std::chrono::steady_clock::now();
+		const PhiloxKey key{ static_cast<std::uint32_t>(config.seed), static_cast<std::uint32_t>(config.seed >> 32U) };
+		const std::uint64_t lotCount = (config.samples + DATASET_LOT_POSES - 1U) / DATASET_LOT_POSES;
+		// Two waves in flight: the pool casts one while this thread writes the other
+		const std::size_t waveLots = std::max<std::size_t>(2U, pool.threadCount() * 2U);
+		std::array<std::vector<DatasetBlock>, 2> waves;
+		std::array<std::size_t, 2> waveSizes{};
+		struct Scratch {
+			DatasetLot lot;
+			std::vector<SensorPose> poses;
+		};
+		std::array<std::vector<Scratch>, 2> scratch;
+
+		std::uint64_t nextLot = 0U;
+		for (std::size_t wave = 0U; ; wave ^= 1U) {
+			const std::size_t lots = static_cast<std::size_t>(std::min<std::uint64_t>(waveLots, lotCount - nextLot));
+			waveSizes[wave] = lots;
+			waves[wave].resize(std::max(waves[wave].size(), lots));
+			scratch[wave].resize(std::max(scratch[wave].size(), lots));
+			TaskGroup group;
+			for (std::size_t i = 0U; i < lots; ++i) {
+				const std::uint64_t lotIndex = nextLot + i;
+				const auto rows = static_cast<std::uint32_t>(
+					std::min<std::uint64_t>(DATASET_LOT_POSES, config.samples - lotIndex * DATASET_LOT_POSES));
+				DatasetBlock& block = waves[wave][i];
+				Scratch& own = scratch[wave][i];
+				pool.submit(group, [&config, &mounts, key, lotIndex, rows, &block, &own]() {
+					castDatasetLot(config, mounts, key, static_cast<std::uint32_t>(lotIndex), rows, own.lot, own.poses, block);
+				});
+			}
+			nextLot += lots;
+
+			// The other wave finished last time round; write it while this one is cast
+			const std::size_t previous = wave ^ 1U;
+			for (std::size_t i = 0U; i < waveSizes[previous]; ++i) {
+				writeDatasetBlock(file, waves[previous][i]);
+				stats.samples += waves[previous][i].rows;
+			}
+			stats.lots += waveSizes[previous];
+			waveSizes[previous] = 0U;
+
+			pool.wait(group);
+			if (lots == 0U) {
+				break;
+			}
+		}
+
+		file.flush();
+		stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (!file) {
+			std::cerr << "Error: failed writing dataset " << path << '\n';
+			return false;
+		}
+		return true;
+	}
+
+	bool loadSensorDataset(const std::string& path, SensorSamples& samples) {
+		std::ifstream file(path, std::ios::binary);
+		char magic[sizeof(DATASET_MAGIC)] = {};
+		samples = SensorSamples{};
+		if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, DATASET_MAGIC, sizeof(magic)) != 0
+			|| !file.read(reinterpret_cast<char*>(&samples.sensorCount), sizeof(samples.sensorCount)))
+		{
+			std::cerr << "Error: " << path << " is not a sensor dataset\n";
+			return false;
+		}
+
+		std::uint32_t rows = 0U;
+		while (file.read(reinterpret_cast<char*>(&rows), sizeof(rows))) {
+			// Blocks never exceed one lot; anything larger is a corrupt count
+			const std::size_t values = static_cast<std::size_t>(rows) * samples.sensorCount;
+			const bool read = rows <= DATASET_LOT_POSES
+				&& readDatasetColumn(file, rows, samples.x)
+				&& readDatasetColumn(file, rows, samples.y)
+				&& readDatasetColumn(file, rows, samples.heading)
+				&& readDatasetColumn(file, values, samples.measured)
+				&& readDatasetColumn(file, values, samples.nearest);
+			if (!read) {
+				std::cerr << "Error: truncated sensor dataset " << path << '\n';
+				return false;
+			}
+		}
+		return true;
+	}
+
+} // namespace sim
@@ -0,0 +1,77 @@
+/*
+==============================================================================
+Sensor Dataset - synthetic training records for sensor models (--dataset)
+==============================================================================
+ - Samples random lots (pillars and parked-car boxes over the scene's
+   area) and random car poses in them, casts every sensor's ray cone with
+   the RayCaster and records what it measured next to the exact distance
+   to the nearest shape, so a model learns the cone's blind spots as well
+   as its hits
+ - Every lot and pose is a pure function of (seed, lot, pose) through
+   Philox, so the file is byte-identical for any thread count
+ - Lots are generated and cast on the job system a wave at a time; while
+   one wave runs the calling thread writes the previous one, in lot order,
+   so memory stays at two waves however many samples are asked for
+ - File format (little-endian): "OKSDS001", sensors u32, then one block
+   per lot: rows u32 | x f32 x rows | y f32 x rows | heading f32 x rows |
+   measured f32 x rows*sensors | nearest f32 x rows*sensors
+   Sensor values are sample-major (a sample's sensors are adjacent);
+   measured is FLT_MAX where the cone hit nothing within its range
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RayCast.hpp"
+#include "SimFwd.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	struct DatasetConfig {
+		std::uint64_t samples = 0U;
+		std::uint64_t seed = 1U;
+		sf::FloatRect lot;                // area pillars, boxes and poses are drawn from
+		sf::Vector2f carHalfExtent{ 0.0F, 0.0F };
+		std::vector<RigSensor> rig;       // built-in layout if empty
+		RayCone cone;
+	};
+
+	// A whole dataset file, one vector per column
+	struct SensorSamples {
+		std::uint32_t sensorCount = 0U;
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> heading;  // degrees
+		std::vector<float> measured; // sensorCount per sample
+		std::vector<float> nearest;  // sensorCount per sample
+
+		[[nodiscard]] std::size_t size() const noexcept { return x.size(); }
+	};
+
+	struct DatasetStats {
+		std::uint64_t samples = 0U;
+		std::uint64_t lots = 0U;
+		double wallSeconds = 0.0;
+	};
+
+	/**
+	 * @brief Writes config.samples records to path on pool; false (logged) if the file cannot be written.
+	 */
+	[[nodiscard]] bool generateSensorDataset(const std::string& path, const DatasetConfig& config, ThreadPool& pool,
+		DatasetStats& stats);
+
+	/**
+	 * @brief Reads a file written by generateSensorDataset(); false (logged) on a bad file.
+	 */
+	[[nodiscard]] bool loadSensorDataset(const std::string& path, SensorSamples& samples);
+
+} // namespace sim
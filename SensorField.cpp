@@ -0,0 +1,133 @@
+#include "SensorField.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace gfx {
+
+	namespace {
+		// A sensor's facing is the long axis of its rectangle (local +Y), as in the ray caster
+		constexpr float FIELD_FACING_OFFSET_DEG = 90.0F;
+		constexpr float FIELD_DEG_TO_RAD = 3.14159265358979323846F / 180.0F;
+
+		// World units of the rim drawn at a measured distance
+		constexpr float FIELD_RIM_WIDTH = 2.0F;
+
+		constexpr const char* FIELD_VERTEX_SHADER = R"(
+#version 120
+varying vec2 v_world;
+void main() {
+	v_world = gl_Vertex.xy;
+	gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+}
+)";
+
+		// MAX_SENSORS is prepended as a #define; the most opaque cone over a pixel wins
+		constexpr const char* FIELD_FRAGMENT_SHADER = R"(
+uniform vec4 u_sensors[MAX_SENSORS];
+uniform float u_reach[MAX_SENSORS];
+uniform int u_count;
+uniform float u_range;
+uniform float u_danger;
+uniform float u_warning;
+uniform float u_rim;
+varying vec2 v_world;
+void main() {
+	float alpha = 0.0;
+	vec3 color = vec3(0.0);
+	for (int i = 0; i < MAX_SENSORS; ++i) {
+		if (i >= u_count) {
+			break;
+		}
+		vec2 d = v_world - u_sensors[i].xy;
+		float r = length(d);
+		float reach = u_reach[i];
+		if (r > reach || dot(d, vec2(cos(u_sensors[i].z), sin(u_sensors[i].z))) < r * u_sensors[i].w) {
+			continue;
+		}
+		vec3 graded = (r <= u_danger) ? vec3(1.0, 0.0, 0.0)
+			: mix(vec3(1.0, 1.0, 0.0), vec3(0.0, 1.0, 0.0), step(u_warning, r));
+		float a = 0.35 * (1.0 - r / u_range) + 0.1;
+		if (reach < u_range && reach - r < u_rim) {
+			a = 0.8;
+		}
+		if (a > alpha) {
+			alpha = a;
+			color = graded;
+		}
+	}
+	if (alpha <= 0.0) {
+		discard;
+	}
+	gl_FragColor = vec4(color, alpha);
+}
+)";
+	}
+
+	bool SensorField::create(float danger, float warning) {
+		m_ready = false;
+		if (!sf::Shader::isAvailable()) {
+			std::cerr << "Error: shaders are unavailable, the sensor field overlay is off\n";
+			return false;
+		}
+		const std::string fragment = "#version 120\n#define MAX_SENSORS " + std::to_string(MAX_SENSORS) + "\n"
+			+ FIELD_FRAGMENT_SHADER;
+		if (!m_shader.loadFromMemory(FIELD_VERTEX_SHADER, fragment)) {
+			return false; // SFML has logged the compiler output
+		}
+		m_shader.setUniform("u_rim", FIELD_RIM_WIDTH);
+		m_ready = true;
+		setThresholds(danger, warning);
+		return true;
+	}
+
+	void SensorField::setThresholds(float danger, float warning) {
+		if (m_ready) {
+			m_shader.setUniform("u_danger", danger);
+			m_shader.setUniform("u_warning", warning);
+		}
+	}
+
+	void SensorField::update(const std::vector<sim::SensorPose>& poses, const std::vector<sim::SensorReading>& readings,
+		float range, float halfAngleDeg)
+	{
+		m_count = std::min({ poses.size(), readings.size(), MAX_SENSORS });
+		if (!m_ready || m_count == 0U) {
+			return;
+		}
+
+		const float cosHalfAngle = std::cos(halfAngleDeg * FIELD_DEG_TO_RAD);
+		sf::Vector2f low{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		sf::Vector2f high{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+		for (std::size_t i = 0U; i < m_count; ++i) {
+			const sf::Vector2f position = poses[i].position;
+			m_sensors[i] = { position.x, position.y, (poses[i].rotationDeg + FIELD_FACING_OFFSET_DEG) * FIELD_DEG_TO_RAD,
+				cosHalfAngle };
+			m_reach[i] = std::min({ std::sqrt(readings[i].distanceSq), readings[i].wallDistance, range });
+			low = { std::min(low.x, position.x - range), std::min(low.y, position.y - range) };
+			high = { std::max(high.x, position.x + range), std::max(high.y, position.y + range) };
+		}
+		const sf::Vector2f corners[4] = { low, { high.x, low.y }, high, { low.x, high.y } };
+		std::size_t vertex = 0U;
+		for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+			m_quad[vertex++] = sf::Vertex{ corners[corner], sf::Color::White };
+		}
+
+		m_shader.setUniformArray("u_sensors", m_sensors.data(), m_count);
+		m_shader.setUniformArray("u_reach", m_reach.data(), m_count);
+		m_shader.setUniform("u_count", static_cast<int>(m_count));
+		m_shader.setUniform("u_range", std::max(range, 1.0e-3F));
+	}
+
+	void SensorField::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		if (!m_ready || m_count == 0U) {
+			return;
+		}
+		states.shader = &m_shader;
+		target.draw(m_quad.data(), m_quad.size(), sf::PrimitiveType::Triangles, states);
+	}
+
+} // namespace gfx
@@ -0,0 +1,65 @@
+/*
+==============================================================================
+Sensor Field - every sensor cone of the rig in one fragment-shader pass
+==============================================================================
+ - One quad covers all cones; the fragment shader tests each pixel against
+   every sensor's cone and colours it by distance (red within the danger
+   threshold, yellow within the warning threshold, green beyond)
+ - Each cone reaches as far as its sensor's batched reading: the nearest
+   obstacle or wall, or the full range when nothing is in reach; a bright
+   rim marks the measured distance
+ - Sensor poses and readings are handed over as uniform arrays once per
+   frame, so the whole rig is one draw instead of one shape per sensor
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "SimTypes.hpp"
+
+namespace gfx {
+
+	class SensorField : public sf::Drawable {
+	public:
+		// Sensors past this many are not drawn (the shader's uniform arrays are fixed)
+		static constexpr std::size_t MAX_SENSORS = 32U;
+
+		/**
+		 * @brief Compiles the cone shader; distances are graded at danger and warning.
+		 *
+		 * Requires an active GL context with shaders. Returns false (and logs)
+		 * otherwise; the overlay stays off.
+		 */
+		[[nodiscard]] bool create(float danger, float warning);
+
+		[[nodiscard]] bool ready() const noexcept { return m_ready; }
+
+		/**
+		 * @brief Regrades the cones: red within danger, yellow within warning, green beyond.
+		 */
+		void setThresholds(float danger, float warning);
+
+		/**
+		 * @brief Takes this frame's sensor poses and readings; cones are range long and 2 * halfAngleDeg wide.
+		 */
+		void update(const std::vector<sim::SensorPose>& poses, const std::vector<sim::SensorReading>& readings,
+			float range, float halfAngleDeg);
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		sf::Shader m_shader;
+		std::array<sf::Vertex, 6> m_quad{}; // bounding box of every cone
+		std::array<sf::Glsl::Vec4, MAX_SENSORS> m_sensors{}; // x, y, facing (rad), cos(half angle)
+		std::array<float, MAX_SENSORS> m_reach{};            // where each cone ends
+		std::size_t m_count = 0U;
+		bool m_ready = false;
+	};
+
+} // namespace gfx
@@ -0,0 +1,132 @@
+#include "SensorFusion.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIM_KERNEL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIM_KERNEL_NEON 1
+#endif
+
+namespace sim {
+
+	namespace {
+		constexpr std::size_t FUSION_LANES = 4U;
+
+		// Squared thresholds and TTC limits as the kernel compares them
+		struct FusionLimits {
+			float dangerSq;
+			float warningSq;
+			float warning;
+			float ttcDanger;
+			float ttcWarning;
+		};
+
+		// Levels of the first lanes sensors (a multiple of FUSION_LANES); fused gets the nearer distance
+		void fuseLevels(const float* readingSq, const float* echoSq, const float* wall, const float* ttc,
+			const FusionLimits& limits, std::size_t lanes, float* fused, std::int32_t* levels) noexcept {
+#if defined(SIM_KERNEL_SSE2)
+			const __m128 dangerSq = _mm_set1_ps(limits.dangerSq);
+			const __m128 warningSq = _mm_set1_ps(limits.warningSq);
+			const __m128 warning = _mm_set1_ps(limits.warning);
+			const __m128 ttcDanger = _mm_set1_ps(limits.ttcDanger);
+			const __m128 ttcWarning = _mm_set1_ps(limits.ttcWarning);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128i dangerLevel = _mm_set1_epi32(WARNING_LEVEL_DANGER);
+			const __m128i cautionLevel = _mm_set1_epi32(WARNING_LEVEL_CAUTION);
+			for (std::size_t i = 0U; i < lanes; i += FUSION_LANES) {
+				const __m128 d = _mm_min_ps(_mm_loadu_ps(readingSq + i), _mm_loadu_ps(echoSq + i));
+				const __m128 w = _mm_loadu_ps(wall + i);
+				const __m128 t = _mm_loadu_ps(ttc + i);
+				const __m128i danger = _mm_castps_si128(_mm_or_ps(_mm_or_ps(_mm_cmple_ps(w, zero), _mm_cmple_ps(d, dangerSq)),
+					_mm_cmple_ps(t, ttcDanger)));
+				const __m128i caution = _mm_castps_si128(_mm_or_ps(_mm_or_ps(_mm_cmple_ps(w, warning), _mm_cmple_ps(d, warningSq)),
+					_mm_cmple_ps(t, ttcWarning)));
+				const __m128i level = _mm_or_si128(_mm_and_si128(danger, dangerLevel),
+					_mm_andnot_si128(danger, _mm_and_si128(caution, cautionLevel)));
+				_mm_storeu_ps(fused + i, d);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(levels + i), level);
+			}
+#elif defined(SIM_KERNEL_NEON)
+			const float32x4_t dangerSq = vdupq_n_f32(limits.dangerSq);
+			const float32x4_t warningSq = vdupq_n_f32(limits.warningSq);
+			const float32x4_t warning = vdupq_n_f32(limits.warning);
+			const float32x4_t ttcDanger = vdupq_n_f32(limits.ttcDanger);
+			const float32x4_t ttcWarning = vdupq_n_f32(limits.ttcWarning);
+			const float32x4_t zero = vdupq_n_f32(0.0F);
+			const uint32x4_t dangerLevel = vdupq_n_u32(WARNING_LEVEL_DANGER);
+			const uint32x4_t cautionLevel = vdupq_n_u32(WARNING_LEVEL_CAUTION);
+			for (std::size_t i = 0U; i < lanes; i += FUSION_LANES) {
+				const float32x4_t d = vminq_f32(vld1q_f32(readingSq + i), vld1q_f32(echoSq + i));
+				const float32x4_t w = vld1q_f32(wall + i);
+				const float32x4_t t = vld1q_f32(ttc + i);
+				const uint32x4_t danger = vorrq_u32(vorrq_u32(vcleq_f32(w, zero), vcleq_f32(d, dangerSq)), vcleq_f32(t, ttcDanger));
+				const uint32x4_t caution = vorrq_u32(vorrq_u32(vcleq_f32(w, warning), vcleq_f32(d, warningSq)), vcleq_f32(t, ttcWarning));
+				const uint32x4_t level = vorrq_u32(vandq_u32(danger, dangerLevel),
+					vbicq_u32(vandq_u32(caution, cautionLevel), danger));
+				vst1q_f32(fused + i, d);
+				vst1q_s32(levels + i, vreinterpretq_s32_u32(level));
+			}
+#else
+			for (std::size_t i = 0U; i < lanes; ++i) {
+				const float d = std::min(readingSq[i], echoSq[i]);
+				const bool danger = wall[i] <= 0.0F || d <= limits.dangerSq || ttc[i] <= limits.ttcDanger;
+				const bool caution = wall[i] <= limits.warning || d <= limits.warningSq || ttc[i] <= limits.ttcWarning;
+				fused[i] = d;
+				levels[i] = danger ? WARNING_LEVEL_DANGER : (caution ? WARNING_LEVEL_CAUTION : WARNING_LEVEL_CLEAR);
+			}
+#endif
+		}
+	}
+
+	void SensorFusion::fuse(const FusionInputs& inputs, const std::vector<SensorMount>& mounts, const WarningProfile& profile,
+		const std::vector<TtcBand>& ttcBands, FusedWarnings& out)
+	{
+		const std::size_t count = (inputs.readings != nullptr) ? std::min(inputs.readings->size(), mounts.size()) : 0U;
+		const std::size_t lanes = (count + FUSION_LANES - 1U) / FUSION_LANES * FUSION_LANES;
+		constexpr float CLEAR = std::numeric_limits<float>::max();
+
+		// Structure of arrays; the reading, echo and fused distance rows share one buffer
+		m_distanceSq.assign(lanes * 3U, CLEAR);
+		m_wall.assign(lanes, CLEAR);
+		m_ttc.assign(lanes, NO_COLLISION);
+		m_levels.resize(lanes);
+		float* const readingSq = m_distanceSq.data();
+		float* const echoSq = readingSq + lanes;
+		float* const fused = echoSq + lanes;
+		for (std::size_t i = 0U; i < count; ++i) {
+			readingSq[i] = (*inputs.readings)[i].distanceSq;
+			m_wall[i] = (*inputs.readings)[i].wallDistance;
+		}
+		if (inputs.echoesSq != nullptr) {
+			std::copy_n(inputs.echoesSq->begin(), std::min(count, inputs.echoesSq->size()), echoSq);
+		}
+		if (inputs.timeToCollision != nullptr) {
+			std::copy_n(inputs.timeToCollision->begin(), std::min(count, inputs.timeToCollision->size()), m_ttc.begin());
+		}
+
+		const FusionLimits limits{ m_thresholds.danger * m_thresholds.danger, m_thresholds.warning * m_thresholds.warning,
+			m_thresholds.warning, m_thresholds.ttcDanger, m_thresholds.ttcWarning };
+		fuseLevels(readingSq, echoSq, m_wall.data(), m_ttc.data(), limits, lanes, fused, m_levels.data());
+
+		out.distanceSq.assign(fused, fused + count);
+		out.levels.resize(count);
+		out.intervals.resize(count);
+		out.zoneLevels.fill(WARNING_LEVEL_CLEAR);
+		const bool ttc = inputs.timeToCollision != nullptr;
+		for (std::size_t i = 0U; i < count; ++i) {
+			const auto level = static_cast<std::uint8_t>(m_levels[i]);
+			const auto zone = static_cast<std::size_t>(mounts[i].zone);
+			out.levels[i] = level;
+			out.zoneLevels[zone] = std::max(out.zoneLevels[zone], level);
+			out.intervals[i] = profile.interval(mounts[i].zone, fused[i]);
+			if (ttc) {
+				out.intervals[i] = moreUrgent(out.intervals[i], ttcInterval(ttcBands, m_ttc[i]));
+			}
+		}
+	}
+
+} // namespace sim
@@ -0,0 +1,91 @@
+/*
+==============================================================================
+Sensor Fusion - one warning state per sensor and zone from every source
+==============================================================================
+ - Merges the tick's sensor pass (nearest obstacle and wall), the raw cone
+   echoes when that pass reads the occupancy map (--mapping) and the time
+   to collision (--ttc) into one fused distance, one warning level and one
+   beep interval per sensor, plus the highest level of each zone
+ - The map needs several hits before a cell counts as occupied, while an
+   echo forgets an obstacle the moment it leaves the cone; the fused
+   distance is the nearer of the two, so neither lag nor forgetting
+   shortens a warning
+ - Levels are one vector pass over structure-of-arrays lanes (SSE2 or
+   NEON, scalar fallback), padded to whole vectors: the same compares and
+   masks every tick, with no branch on the data. Intervals are one table
+   load per sensor (WarningProfile), combined with the TTC bands
+ - The beep scheduler, the indicator colors and the sensor labels all read
+   the fused result, so none of them derives a state of its own; the GL
+   variant fuses its streamed channels the same way for its beep level
+   and warning bars
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CollisionPredictor.hpp"
+#include "SimTypes.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	// Warning levels, one byte per sensor; higher is more urgent
+	constexpr std::uint8_t WARNING_LEVEL_CLEAR = 0U;
+	constexpr std::uint8_t WARNING_LEVEL_CAUTION = 1U;
+	constexpr std::uint8_t WARNING_LEVEL_DANGER = 2U;
+
+	// Distances in the readings' unit (px in the simulation, metres from real sensors)
+	struct FusionThresholds {
+		float danger = 30.0F;          // danger within, or on a wall
+		float warning = 60.0F;         // caution within, obstacle or wall
+		float ttcDanger = 0.5F;        // s: danger if a collision is predicted this soon
+		float ttcWarning = 1.0F;       // s: caution if predicted this soon
+	};
+
+	// What one tick measured; echoesSq and timeToCollision are optional (null = source off)
+	struct FusionInputs {
+		const std::vector<SensorReading>* readings = nullptr;
+		const std::vector<float>* echoesSq = nullptr;        // nearest raw cone hit per sensor, squared
+		const std::vector<float>* timeToCollision = nullptr; // per sensor, NO_COLLISION = clear
+	};
+
+	struct FusedWarnings {
+		std::vector<float> distanceSq;      // fused, per sensor (max = nothing in range)
+		std::vector<std::uint8_t> levels;   // WARNING_LEVEL_* per sensor
+		std::vector<float> intervals;       // seconds between beeps per sensor (0 = silent)
+		std::array<std::uint8_t, SENSOR_ZONE_COUNT> zoneLevels{}; // highest level per zone
+	};
+
+	class SensorFusion {
+	public:
+		explicit SensorFusion(const FusionThresholds& thresholds = {}) : m_thresholds(thresholds) {}
+
+		void setThresholds(const FusionThresholds& thresholds) noexcept { m_thresholds = thresholds; }
+		[[nodiscard]] const FusionThresholds& thresholds() const noexcept { return m_thresholds; }
+
+		/**
+		 * @brief Fuses one tick's inputs for the sensors of mounts into out.
+		 *
+		 * Sensors past the end of an optional input count as clear for it.
+		 * Each sensor's interval is the more urgent of its zone's distance
+		 * band and its TTC band.
+		 */
+		void fuse(const FusionInputs& inputs, const std::vector<SensorMount>& mounts, const WarningProfile& profile,
+			const std::vector<TtcBand>& ttcBands, FusedWarnings& out);
+
+	private:
+		FusionThresholds m_thresholds;
+
+		// Lanes padded to whole vectors; padding lanes hold clear inputs
+		std::vector<float> m_distanceSq;
+		std::vector<float> m_wall;
+		std::vector<float> m_ttc;
+		std::vector<std::int32_t> m_levels;
+	};
+
+} // namespace sim
@@ -0,0 +1,224 @@
+#include "SensorIngest.hpp"
+
+#include <SFML/Network.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#define OKPP_HAS_SERIAL 1
+#endif
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+namespace io {
+
+	namespace {
+		constexpr std::uint8_t SYNC_0 = 0xA5U;
+		constexpr std::uint8_t SYNC_1 = 0x5AU;
+		constexpr std::size_t HEADER_BYTES = 5U; // sync, count, sequence
+
+		// How long a blocked read may wait before the stop flag is checked again
+		constexpr int READ_TIMEOUT_MS = 100;
+
+		[[nodiscard]] std::size_t frameBytes(std::uint8_t count) noexcept {
+			return HEADER_BYTES + 2U * count + 1U;
+		}
+	}
+
+	float SensorSample::nearestMeters() const noexcept {
+		float nearest = -1.0F;
+		for (std::size_t i = 0U; i < count; ++i) {
+			if (distanceMm[i] != NO_ECHO_MM) {
+				const float meters = static_cast<float>(distanceMm[i]) * 0.001F;
+				nearest = (nearest < 0.0F) ? meters : std::min(nearest, meters);
+			}
+		}
+		return nearest;
+	}
+
+	bool SensorFrameParser::push(std::uint8_t byte) noexcept {
+		// Hunting for the sync word
+		if (m_length == 0U) {
+			if (byte == SYNC_0) {
+				m_frame[m_length++] = byte;
+			}
+			return false;
+		}
+		if (m_length == 1U) {
+			if (byte == SYNC_1) {
+				m_frame[m_length++] = byte;
+			}
+			else {
+				m_length = (byte == SYNC_0) ? 1U : 0U;
+			}
+			return false;
+		}
+		if (m_length == 2U && (byte == 0U || byte > MAX_SENSOR_CHANNELS)) {
+			++m_rejected;
+			m_length = (byte == SYNC_0) ? 1U : 0U;
+			return false;
+		}
+
+		m_frame[m_length++] = byte;
+		const std::uint8_t count = m_frame[2];
+		if (m_length < frameBytes(count)) {
+			return false;
+		}
+
+		m_length = 0U;
+		std::uint8_t checksum = 0U;
+		for (std::size_t i = 2U; i + 1U < frameBytes(count); ++i) {
+			checksum = static_cast<std::uint8_t>(checksum ^ m_frame[i]);
+		}
+		if (checksum != byte) {
+			++m_rejected;
+			return false;
+		}
+
+		m_sample.count = count;
+		m_sample.sequence = static_cast<std::uint16_t>(m_frame[3] | (m_frame[4] << 8U));
+		for (std::size_t i = 0U; i < count; ++i) {
+			const std::size_t at = HEADER_BYTES + 2U * i;
+			m_sample.distanceMm[i] = static_cast<std::uint16_t>(m_frame[at] | (m_frame[at + 1U] << 8U));
+		}
+		std::fill(m_sample.distanceMm.begin() + count, m_sample.distanceMm.end(), NO_ECHO_MM);
+		return true;
+	}
+
+	SensorIngest::~SensorIngest() {
+		close();
+	}
+
+	void SensorIngest::close() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		m_stop.store(true, std::memory_order_relaxed);
+		m_thread.join();
+	}
+
+	void SensorIngest::publish(const SensorSample& sample) noexcept {
+		// A full ring means the consumer is behind; it only wants the newest sample anyway
+		(void)m_samples.tryPush(sample);
+	}
+
+	bool SensorIngest::openUdp(unsigned short port) {
+		if (m_thread.joinable()) {
+			return false;
+		}
+		m_stop.store(false, std::memory_order_relaxed);
+		// Bound here so a bad port is reported to the caller, then handed to the thread
+		auto socket = std::make_unique<sf::UdpSocket>();
+		if (socket->bind(port) != sf::Socket::Status::Done) {
+			OKPP_LOG_ERROR("Error: cannot bind UDP port %u for sensor input", static_cast<unsigned int>(port));
+			return false;
+		}
+		m_thread = std::thread([this, socket = std::move(socket)]() { readUdp(*socket); });
+		return true;
+	}
+
+	bool SensorIngest::openSerial(const std::string& device, unsigned int baud) {
+		if (m_thread.joinable()) {
+			return false;
+		}
+#if defined(OKPP_HAS_SERIAL)
+		const int fd = ::open(device.c_str(), O_RDONLY | O_NOCTTY);
+		if (fd < 0) {
+			OKPP_LOG_ERROR("Error: cannot open serial device %s: %s", device.c_str(), std::strerror(errno));
+			return false;
+		}
+
+		termios tty{};
+		speed_t speed = B115200;
+		switch (baud) {
+		case 9600U: speed = B9600; break;
+		case 19200U: speed = B19200; break;
+		case 38400U: speed = B38400; break;
+		case 57600U: speed = B57600; break;
+		default: break;
+		}
+		if (tcgetattr(fd, &tty) != 0) {
+			OKPP_LOG_ERROR("Error: %s is not a serial device", device.c_str());
+			(void)::close(fd);
+			return false;
+		}
+		cfmakeraw(&tty);
+		(void)cfsetispeed(&tty, speed);
+		tty.c_cflag |= CLOCAL | CREAD;
+		tty.c_cc[VMIN] = 0;                                // return what is there...
+		tty.c_cc[VTIME] = READ_TIMEOUT_MS / 100;           // ...or after this many deciseconds
+		if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+			OKPP_LOG_ERROR("Error: cannot configure serial device %s", device.c_str());
+			(void)::close(fd);
+			return false;
+		}
+
+		m_stop.store(false, std::memory_order_relaxed);
+		m_thread = std::thread([this, fd]() { readSerial(fd); });
+		return true;
+#else
+		(void)baud;
+		OKPP_LOG_ERROR("Error: serial sensor input (%s) is not supported on this platform", device.c_str());
+		return false;
+#endif
+	}
+
+	void SensorIngest::readUdp(sf::UdpSocket& socket) {
+		prof::setThreadName("sensor ingest");
+		sf::SocketSelector selector;
+		selector.add(socket);
+		SensorFrameParser parser;
+		std::vector<std::uint8_t> datagram(sf::UdpSocket::MaxDatagramSize);
+
+		while (!m_stop.load(std::memory_order_relaxed)) {
+			if (!selector.wait(sf::milliseconds(READ_TIMEOUT_MS))) {
+				continue;
+			}
+			std::size_t received = 0U;
+			std::optional<sf::IpAddress> sender;
+			unsigned short senderPort = 0U;
+			if (socket.receive(datagram.data(), datagram.size(), received, sender, senderPort) != sf::Socket::Status::Done) {
+				continue;
+			}
+			OKPP_TRACE_SCOPE("sensor datagram");
+			for (std::size_t i = 0U; i < received; ++i) {
+				if (parser.push(datagram[i])) {
+					publish(parser.sample());
+				}
+			}
+		}
+	}
+
+	void SensorIngest::readSerial(int fd) {
+#if defined(OKPP_HAS_SERIAL)
+		prof::setThreadName("sensor ingest");
+		SensorFrameParser parser;
+		std::array<std::uint8_t, 256U> chunk{};
+		while (!m_stop.load(std::memory_order_relaxed)) {
+			const ssize_t count = ::read(fd, chunk.data(), chunk.size());
+			if (count < 0 && errno != EINTR && errno != EAGAIN) {
+				OKPP_LOG_WARNING("Warning: serial sensor input stopped: %s", std::strerror(errno));
+				break;
+			}
+			for (ssize_t i = 0; i < count; ++i) {
+				if (parser.push(chunk[static_cast<std::size_t>(i)])) {
+					publish(parser.sample());
+				}
+			}
+		}
+		(void)::close(fd);
+#else
+		(void)fd;
+#endif
+	}
+
+} // namespace io
@@ -0,0 +1,114 @@
+/*
+==============================================================================
+Sensor Ingest - real ultrasonic readings from a UDP or serial frame stream
+==============================================================================
+ - A background reader thread owns the socket or serial port, parses the
+   binary frames and pushes complete samples into a lock-free SPSC ring;
+   nothing on the consumer side ever blocks on I/O
+ - The consumer takes only the newest sample (latest()), at its own rate
+ - Frame (little-endian): A5 5A | count u8 | sequence u16 |
+   count x distance u16 in millimetres (FFFF = no echo) | xor u8
+   The checksum is the XOR of every byte after the sync word; the parser
+   resynchronizes on the sync word, so a serial stream may start mid-frame
+ - Serial ports are opened raw on POSIX systems only
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "SpscRing.hpp"
+
+namespace sf {
+	class UdpSocket;
+}
+
+namespace io {
+
+	constexpr std::size_t MAX_SENSOR_CHANNELS = 8U;
+	constexpr std::uint16_t NO_ECHO_MM = 0xFFFFU;
+
+	struct SensorSample {
+		std::uint16_t sequence = 0U;
+		std::uint8_t count = 0U;
+		std::array<std::uint16_t, MAX_SENSOR_CHANNELS> distanceMm{};
+
+		/**
+		 * @brief Shortest valid distance in metres; negative if no channel has an echo.
+		 */
+		[[nodiscard]] float nearestMeters() const noexcept;
+	};
+
+	/**
+	 * @brief Incremental frame parser for a byte stream (or one datagram at a time).
+	 */
+	class SensorFrameParser {
+	public:
+		/**
+		 * @brief Consumes one byte; true when it completed a valid frame (see sample()).
+		 */
+		bool push(std::uint8_t byte) noexcept;
+
+		[[nodiscard]] const SensorSample& sample() const noexcept { return m_sample; }
+		[[nodiscard]] std::uint64_t rejected() const noexcept { return m_rejected; }
+
+	private:
+		static constexpr std::size_t MAX_FRAME_BYTES = 6U + 2U * MAX_SENSOR_CHANNELS;
+
+		std::array<std::uint8_t, MAX_FRAME_BYTES> m_frame{};
+		std::size_t m_length = 0U;
+		SensorSample m_sample;
+		std::uint64_t m_rejected = 0U; // bad counts and checksums
+	};
+
+	class SensorIngest {
+	public:
+		SensorIngest() = default;
+		~SensorIngest();
+
+		SensorIngest(const SensorIngest&) = delete;
+		SensorIngest& operator=(const SensorIngest&) = delete;
+
+		/**
+		 * @brief Starts reading datagrams sent to the local UDP port.
+		 *
+		 * Returns false (logged) if the port cannot be bound.
+		 */
+		bool openUdp(unsigned short port);
+
+		/**
+		 * @brief Starts reading a serial device (raw, 8N1, at baud).
+		 *
+		 * Returns false (logged) if it cannot be opened or configured.
+		 */
+		bool openSerial(const std::string& device, unsigned int baud = 115200U);
+
+		/**
+		 * @brief Stops the reader thread; safe to call twice.
+		 */
+		void close();
+
+		/**
+		 * @brief Consumer side: the newest sample since the last call, if any.
+		 */
+		[[nodiscard]] bool latest(SensorSample& sample) noexcept { return m_samples.popLatest(sample); }
+
+		[[nodiscard]] bool running() const noexcept { return m_thread.joinable(); }
+
+	private:
+		void readUdp(sf::UdpSocket& socket);
+		void readSerial(int fd);
+		void publish(const SensorSample& sample) noexcept;
+
+		sim::SpscRing<SensorSample, 64U> m_samples;
+		std::atomic<bool> m_stop{ false };
+		std::thread m_thread;
+	};
+
+} // namespace io
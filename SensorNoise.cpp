@@ -0,0 +1,230 @@
+#include "SensorNoise.hpp"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "DeterministicMath.hpp"
+#include "FastTrig.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIM_KERNEL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIM_KERNEL_NEON 1
+#endif
+
+namespace sim {
+
+	namespace {
+		// Philox4x32 multipliers and Weyl key increments (Salmon et al., SC'11)
+		constexpr std::uint32_t PHILOX_M0 = 0xD2511F53U;
+		constexpr std::uint32_t PHILOX_M1 = 0xCD9E8D57U;
+		constexpr std::uint32_t PHILOX_W0 = 0x9E3779B9U;
+		constexpr std::uint32_t PHILOX_W1 = 0xBB67AE85U;
+		constexpr int PHILOX_ROUNDS = 10;
+
+		// 24 random bits per float, so every value is exact
+		constexpr float NOISE_UNIT = 1.0F / 16777216.0F;
+
+		constexpr float NOISE_FAR = std::numeric_limits<float>::max();
+
+		[[nodiscard]] PhiloxKey keyOf(std::uint64_t seed) noexcept {
+			return { static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32U) };
+		}
+
+		// Uniform in (0, 1]: never 0, so it can go through log()
+		[[nodiscard]] float openUnit(std::uint32_t word) noexcept {
+			return static_cast<float>((word >> 8U) + 1U) * NOISE_UNIT;
+		}
+
+		// Uniform in [0, 1)
+		[[nodiscard]] float halfOpenUnit(std::uint32_t word) noexcept {
+			return static_cast<float>(word >> 8U) * NOISE_UNIT;
+		}
+#if defined(SIM_KERNEL_SSE2)
+		// 32x32 -> 64 bit products of all four lanes: even lanes directly, odd
+		// lanes shifted down, then the low and high halves gathered back in order
+		inline void mulHiLo(__m128i a, __m128i m, __m128i& hi, __m128i& lo) noexcept {
+			const __m128i even = _mm_mul_epu32(a, m);
+			const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+			lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+				_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+			hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)),
+				_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+		}
+
+		// Sensors [sensor, sensor + 4 * V) into words[.][out...]; with V > 1 the
+		// independent vectors overlap one another's multiplies and shuffles
+		template <std::size_t V>
+		void philoxSse2(PhiloxKey key, std::uint32_t passLow, std::uint32_t passHigh, std::uint32_t sensor,
+			std::uint32_t* const words[4], std::size_t out) noexcept
+		{
+			const __m128i m0 = _mm_set1_epi32(static_cast<int>(PHILOX_M0));
+			const __m128i m1 = _mm_set1_epi32(static_cast<int>(PHILOX_M1));
+			__m128i c0[V];
+			__m128i c1[V];
+			__m128i c2[V];
+			__m128i c3[V];
+			for (std::size_t v = 0U; v < V; ++v) {
+				const std::uint32_t base = sensor + static_cast<std::uint32_t>(4U * v);
+				c0[v] = _mm_set1_epi32(static_cast<int>(passLow));
+				c1[v] = _mm_set1_epi32(static_cast<int>(passHigh));
+				c2[v] = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(base)), _mm_set_epi32(3, 2, 1, 0));
+				c3[v] = _mm_setzero_si128();
+			}
+			for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+				const __m128i key0 = _mm_set1_epi32(static_cast<int>(key[0]));
+				const __m128i key1 = _mm_set1_epi32(static_cast<int>(key[1]));
+				for (std::size_t v = 0U; v < V; ++v) {
+					__m128i hi0;
+					__m128i lo0;
+					__m128i hi1;
+					__m128i lo1;
+					mulHiLo(c0[v], m0, hi0, lo0);
+					mulHiLo(c2[v], m1, hi1, lo1);
+					c0[v] = _mm_xor_si128(_mm_xor_si128(hi1, c1[v]), key0);
+					c1[v] = lo1;
+					c2[v] = _mm_xor_si128(_mm_xor_si128(hi0, c3[v]), key1);
+					c3[v] = lo0;
+				}
+				key[0] += PHILOX_W0;
+				key[1] += PHILOX_W1;
+			}
+			for (std::size_t v = 0U; v < V; ++v) {
+				const std::size_t at = out + 4U * v;
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(words[0] + at), c0[v]);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(words[1] + at), c1[v]);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(words[2] + at), c2[v]);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(words[3] + at), c3[v]);
+			}
+		}
+#endif
+	}
+
+	PhiloxCounter philox4x32(PhiloxCounter c, PhiloxKey key) noexcept {
+		for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+			const std::uint64_t p0 = static_cast<std::uint64_t>(PHILOX_M0) * c[0];
+			const std::uint64_t p1 = static_cast<std::uint64_t>(PHILOX_M1) * c[2];
+			c = {
+				static_cast<std::uint32_t>(p1 >> 32U) ^ c[1] ^ key[0],
+				static_cast<std::uint32_t>(p1),
+				static_cast<std::uint32_t>(p0 >> 32U) ^ c[3] ^ key[1],
+				static_cast<std::uint32_t>(p0)
+			};
+			key[0] += PHILOX_W0;
+			key[1] += PHILOX_W1;
+		}
+		return c;
+	}
+
+	void philoxSensors(PhiloxKey key, std::uint64_t pass, std::uint32_t first, std::size_t count,
+		std::uint32_t* const words[4]) noexcept
+	{
+		const std::uint32_t passLow = static_cast<std::uint32_t>(pass);
+		const std::uint32_t passHigh = static_cast<std::uint32_t>(pass >> 32U);
+		std::size_t i = 0U;
+
+#if defined(SIM_KERNEL_SSE2)
+		for (; i + 8U <= count; i += 8U) {
+			philoxSse2<2>(key, passLow, passHigh, first + static_cast<std::uint32_t>(i), words, i);
+		}
+		for (; i + 4U <= count; i += 4U) {
+			philoxSse2<1>(key, passLow, passHigh, first + static_cast<std::uint32_t>(i), words, i);
+		}
+#elif defined(SIM_KERNEL_NEON)
+		const auto mulHiLo = [](uint32x4_t a, uint32_t m, uint32x4_t& hi, uint32x4_t& lo) {
+			const uint32x2_t mm = vdup_n_u32(m);
+			const uint64x2_t low = vmull_u32(vget_low_u32(a), mm);
+			const uint64x2_t high = vmull_u32(vget_high_u32(a), mm);
+			lo = vcombine_u32(vmovn_u64(low), vmovn_u64(high));
+			hi = vcombine_u32(vshrn_n_u64(low, 32), vshrn_n_u64(high, 32));
+		};
+
+		const uint32_t laneOffsets[4] = { 0U, 1U, 2U, 3U };
+		const uint32x4_t lanes = vld1q_u32(laneOffsets);
+		for (; i + 4U <= count; i += 4U) {
+			const std::uint32_t sensor = first + static_cast<std::uint32_t>(i);
+			uint32x4_t c0 = vdupq_n_u32(passLow);
+			uint32x4_t c1 = vdupq_n_u32(passHigh);
+			uint32x4_t c2 = vaddq_u32(vdupq_n_u32(sensor), lanes);
+			uint32x4_t c3 = vdupq_n_u32(0U);
+			std::uint32_t k0 = key[0];
+			std::uint32_t k1 = key[1];
+			for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+				uint32x4_t hi0;
+				uint32x4_t lo0;
+				uint32x4_t hi1;
+				uint32x4_t lo1;
+				mulHiLo(c0, PHILOX_M0, hi0, lo0);
+				mulHiLo(c2, PHILOX_M1, hi1, lo1);
+				c0 = veorq_u32(veorq_u32(hi1, c1), vdupq_n_u32(k0));
+				c1 = lo1;
+				c2 = veorq_u32(veorq_u32(hi0, c3), vdupq_n_u32(k1));
+				c3 = lo0;
+				k0 += PHILOX_W0;
+				k1 += PHILOX_W1;
+			}
+			vst1q_u32(words[0] + i, c0);
+			vst1q_u32(words[1] + i, c1);
+			vst1q_u32(words[2] + i, c2);
+			vst1q_u32(words[3] + i, c3);
+		}
+#endif
+
+		for (; i < count; ++i) {
+			const PhiloxCounter out = philox4x32({ passLow, passHigh, first + static_cast<std::uint32_t>(i), 0U }, key);
+			for (std::size_t w = 0U; w < 4U; ++w) {
+				words[w][i] = out[w];
+			}
+		}
+	}
+
+	void SensorNoise::configure(const SensorNoiseConfig& config, std::size_t sensorCount) {
+		m_config = config;
+		m_config.sigma = std::max(m_config.sigma, 0.0F);
+		m_config.dropout = std::clamp(m_config.dropout, 0.0F, 1.0F);
+		m_key = keyOf(m_config.seed);
+		m_sensorCount = sensorCount;
+		m_history.assign(static_cast<std::size_t>(m_config.latency) * sensorCount, SensorReading{});
+	}
+
+	void SensorNoise::generate(std::uint64_t pass, std::size_t first, std::size_t count, Block& block) const noexcept {
+		std::array<std::array<std::uint32_t, BLOCK>, 4> words;
+		std::uint32_t* const rows[4] = { words[0].data(), words[1].data(), words[2].data(), words[3].data() };
+		philoxSensors(m_key, pass, static_cast<std::uint32_t>(first), count, rows);
+
+		// Box-Muller: a radius from the first word and an angle from the second
+		for (std::size_t i = 0U; i < count; ++i) {
+			const float radius = std::sqrt(-2.0F * dmath::log(openUnit(words[0][i])));
+			const SinCos angle = sinCosDeg(360.0F * halfOpenUnit(words[1][i]));
+			block.gaussian0[i] = radius * angle.cos;
+			block.gaussian1[i] = radius * angle.sin;
+			block.uniform[i] = halfOpenUnit(words[2][i]);
+		}
+	}
+
+	void SensorNoise::deliver(std::uint64_t pass, std::size_t sensor, const Block& block, std::size_t lane,
+		SensorReading& reading)
+	{
+		if (block.uniform[lane] < m_config.dropout) {
+			reading = SensorReading{};
+		}
+		else if (m_config.sigma > 0.0F) {
+			if (reading.distanceSq < NOISE_FAR) {
+				const float distance = std::max(std::sqrt(reading.distanceSq) + m_config.sigma * block.gaussian0[lane], 0.0F);
+				reading.distanceSq = distance * distance;
+			}
+			if (reading.wallDistance < NOISE_FAR) {
+				reading.wallDistance = std::max(reading.wallDistance + m_config.sigma * block.gaussian1[lane], 0.0F);
+			}
+		}
+
+		if (m_config.latency > 0U) {
+			const std::size_t slot = static_cast<std::size_t>(pass % m_config.latency);
+			std::swap(reading, m_history[slot * m_sensorCount + sensor]);
+		}
+	}
+
+} // namespace sim
@@ -0,0 +1,119 @@
+/*
+==============================================================================
+Sensor Noise - Gaussian error, dropouts and latency on top of the sensor pass
+==============================================================================
+ - Random numbers come from Philox4x32-10, a counter-based generator: the
+   bits for a sensor are a pure function of (seed, pass, sensor index), so
+   a fleet split over any number of workers, in any order, draws exactly
+   the same noise
+ - Bits are generated for blocks of sensors at once, four sensors per
+   vector (SSE2 or NEON, scalar fallback); one Philox call yields the two
+   uniforms of a Box-Muller pair plus the dropout draw
+ - A dropped reading sees nothing: no obstacle and no wall in range; others
+   get zero-mean Gaussian error on both distances, clamped at 0
+ - Latency delays every sensor by a fixed number of passes through a ring
+   of past readings; the first passes report nothing in range
+ - Concurrent apply() calls are safe on disjoint sensor ranges
+==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	struct SensorNoiseConfig {
+		float sigma = 0.0F;            // px, standard deviation of the distance error
+		float dropout = 0.0F;          // probability that a pass reads nothing
+		std::uint32_t latency = 0U;    // passes between a measurement and its delivery
+		std::uint64_t seed = 1U;
+
+		[[nodiscard]] bool enabled() const noexcept { return sigma > 0.0F || dropout > 0.0F || latency > 0U; }
+	};
+
+	using PhiloxCounter = std::array<std::uint32_t, 4>;
+	using PhiloxKey = std::array<std::uint32_t, 2>;
+
+	/**
+	 * @brief Philox4x32-10: four random words for one counter under key.
+	 */
+	[[nodiscard]] PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key) noexcept;
+
+	/**
+	 * @brief philox4x32() for count consecutive sensors, vectorized across sensors.
+	 *
+	 * Sensor first + i uses the counter (pass low, pass high, first + i, 0);
+	 * its four words land in words[0..3][i]. Each array holds at least count entries.
+	 */
+	void philoxSensors(PhiloxKey key, std::uint64_t pass, std::uint32_t first, std::size_t count,
+		std::uint32_t* const words[4]) noexcept;
+
+	class SensorNoise {
+	public:
+		// Sensors whose random words are generated together
+		static constexpr std::size_t BLOCK = 16U;
+
+		/**
+		 * @brief Sets the model for sensorCount sensors and clears the latency ring.
+		 *
+		 * MISRA: sigma below 0 counts as 0 and dropout is clamped to [0, 1].
+		 */
+		void configure(const SensorNoiseConfig& config, std::size_t sensorCount);
+
+		[[nodiscard]] const SensorNoiseConfig& config() const noexcept { return m_config; }
+		[[nodiscard]] bool enabled() const noexcept { return m_config.enabled(); }
+
+		/**
+		 * @brief Perturbs the readings of sensors [first, first + count) measured in pass.
+		 *
+		 * readingAt(i) returns the reading of sensor i (absolute index); it is
+		 * replaced by the noisy reading delivered this pass. Sensors at or past
+		 * the configured count are left alone.
+		 */
+		template <typename ReadingAt>
+		void apply(std::uint64_t pass, std::size_t first, std::size_t count, ReadingAt&& readingAt) {
+			if (!enabled()) {
+				return;
+			}
+			const std::size_t end = std::min(first + count, m_sensorCount);
+			Block block;
+			for (std::size_t base = first; base < end; base += BLOCK) {
+				const std::size_t n = std::min(BLOCK, end - base);
+				generate(pass, base, n, block);
+				for (std::size_t k = 0U; k < n; ++k) {
+					deliver(pass, base + k, block, k, readingAt(base + k));
+				}
+			}
+		}
+
+		/**
+		 * @brief apply() over a whole pass held in one vector (sensor i = readings[i]).
+		 */
+		void apply(std::uint64_t pass, std::vector<SensorReading>& readings) {
+			apply(pass, 0U, readings.size(), [&readings](std::size_t i) -> SensorReading& { return readings[i]; });
+		}
+
+	private:
+		struct Block {
+			std::array<float, BLOCK> gaussian0; // obstacle distance error, unit variance
+			std::array<float, BLOCK> gaussian1; // wall distance error
+			std::array<float, BLOCK> uniform;   // dropout draw in [0, 1)
+		};
+
+		void generate(std::uint64_t pass, std::size_t first, std::size_t count, Block& block) const noexcept;
+		void deliver(std::uint64_t pass, std::size_t sensor, const Block& block, std::size_t lane, SensorReading& reading);
+
+		SensorNoiseConfig m_config;
+		PhiloxKey m_key{};
+		std::size_t m_sensorCount = 0U;
+		std::vector<SensorReading> m_history; // latency x sensorCount, slot pass % latency
+	};
+
+} // namespace sim
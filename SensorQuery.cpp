@@ -0,0 +1,14 @@
+#include "SensorQuery.hpp"
+
+namespace sim {
+
+	void querySensors(const SensorSource& source, const SensorPose* poses, std::size_t count, SensorReading* readings,
+		ThreadPool* pool)
+	{
+		querySensors(source, count,
+			[poses](std::size_t i) -> const SensorPose& { return poses[i]; },
+			[readings](std::size_t i) -> SensorReading& { return readings[i]; },
+			pool);
+	}
+
+} // namespace sim
@@ -0,0 +1,95 @@
+/*
+==============================================================================
+Sensor Query - one batch entry point for nearest-obstacle sensor reads
+==============================================================================
+ - querySensors() fills a reading for every pose of a batch; the live
+   car, the headless runner and fleet mode all read through it, so a
+   faster path lands everywhere at once
+ - A SensorSource names what is read: the float grid (pillars and walls
+   in one lookup), or the quantized SIMD tiles for pillars with the grid
+   for walls. Both give exact, platform-independent results, so the
+   choice stays with the caller; switching silently would change readings
+ - Batch size picks the execution: up to PARALLEL_MIN_SENSORS poses run
+   inline on the calling thread, larger batches are cut into chunks of
+   QUERY_CHUNK sensors (poses and readings of a chunk fit in L1) and fanned
+   out over the job system; readings are per-sensor, so any split gives
+   the same bytes
+ - Poses and readings are reached through accessors, so an array of
+   MountedSensor records is read in place without gathering
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "ObstacleGrid.hpp"
+#include "QuantizedObstacles.hpp"
+#include "SimTypes.hpp"
+#include "ThreadPool.hpp"
+
+namespace sim {
+
+	struct SensorSource {
+		const ObstacleGrid* grid = nullptr;                // walls, and pillars unless quantized is set
+		const QuantizedObstacleTiles* quantized = nullptr; // pillars from the integer SIMD tiles
+		float maxRange = 0.0F;
+
+		/**
+		 * @brief The reading of one sensor at position.
+		 *
+		 * MISRA: grid must be set.
+		 */
+		[[nodiscard]] SensorReading read(const sf::Vector2f& position) const {
+			SensorReading reading;
+			if (quantized != nullptr) {
+				const NearestObstacle nearest = quantized->nearest(position, maxRange);
+				reading.obstacle = nearest.index;
+				reading.distanceSq = nearest.distanceSq;
+				reading.wallDistance = grid->nearestWall(position, maxRange);
+				return reading;
+			}
+			const NearestObstacle nearest = grid->nearest(position, maxRange);
+			reading.obstacle = nearest.index;
+			reading.distanceSq = nearest.distanceSq;
+			reading.wallDistance = nearest.wallDistance;
+			return reading;
+		}
+	};
+
+	// Sensors per fanned-out chunk: 1024 poses and readings are about 32 KiB
+	constexpr std::size_t QUERY_CHUNK = 1024U;
+	// Batches up to this size run inline; below it the hand-off costs more than it saves
+	constexpr std::size_t PARALLEL_MIN_SENSORS = 4U * QUERY_CHUNK;
+
+	/**
+	 * @brief readingAt(i) = source.read(poseAt(i).position) for every i in [0, count).
+	 *
+	 * poseAt(i) returns a const SensorPose&, readingAt(i) a SensorReading&.
+	 * Large batches fan out over pool when it has more than one thread;
+	 * a null pool always runs inline (e.g. inside a task that is already
+	 * one chunk of a parallel pass).
+	 */
+	template <typename PoseAt, typename ReadingAt>
+	void querySensors(const SensorSource& source, std::size_t count, PoseAt&& poseAt, ReadingAt&& readingAt,
+		ThreadPool* pool = nullptr)
+	{
+		const auto readRange = [&source, &poseAt, &readingAt](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				readingAt(i) = source.read(poseAt(i).position);
+			}
+		};
+		if (pool == nullptr || pool->threadCount() < 2U || count <= PARALLEL_MIN_SENSORS) {
+			readRange(0U, count);
+			return;
+		}
+		pool->parallelFor(count, QUERY_CHUNK, readRange);
+	}
+
+	/**
+	 * @brief querySensors() over contiguous arrays: readings[i] for poses[i].
+	 */
+	void querySensors(const SensorSource& source, const SensorPose* poses, std::size_t count, SensorReading* readings,
+		ThreadPool* pool = nullptr);
+
+} // namespace sim
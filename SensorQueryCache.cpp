@@ -0,0 +1,62 @@
+#include "SensorQueryCache.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace sim {
+
+	void SensorQueryCache::setTolerance(float units) noexcept {
+		m_tolerance = std::max(units, 0.0F);
+		m_toleranceSq = m_tolerance * m_tolerance;
+		invalidate();
+	}
+
+	void SensorQueryCache::invalidate() noexcept {
+		for (Entry& entry : m_entries) {
+			entry.valid = false;
+		}
+	}
+
+	void SensorQueryCache::read(const std::vector<SensorPose>& sensors, const ObstacleGrid& grid,
+		const std::vector<Obstacle>& obstacles, float maxRange, std::vector<SensorReading>& readings)
+	{
+		if (m_entries.size() != sensors.size()) {
+			m_entries.assign(sensors.size(), Entry{});
+		}
+		readings.resize(sensors.size());
+		const float maxRangeSq = maxRange * maxRange;
+
+		for (std::size_t i = 0U; i < sensors.size(); ++i) {
+			const sf::Vector2f position = sensors[i].position;
+			Entry& entry = m_entries[i];
+			const sf::Vector2f moved = position - entry.origin;
+			if (entry.valid && moved.x * moved.x + moved.y * moved.y <= m_toleranceSq) {
+				SensorReading reading = entry.reading;
+				if (reading.obstacle != NO_OBSTACLE && reading.obstacle < obstacles.size()) {
+					const sf::Vector2f offset = position - obstacles[reading.obstacle].center;
+					const float distanceSq = offset.x * offset.x + offset.y * offset.y;
+					if (distanceSq <= maxRangeSq) {
+						reading.distanceSq = distanceSq;
+					}
+					else {
+						reading.obstacle = NO_OBSTACLE; // drifted out of range
+						reading.distanceSq = std::numeric_limits<float>::max();
+					}
+				}
+				readings[i] = reading;
+				++m_reused;
+				continue;
+			}
+
+			const NearestObstacle nearest = grid.nearest(position, maxRange);
+			readings[i].obstacle = nearest.index;
+			readings[i].distanceSq = nearest.distanceSq;
+			readings[i].wallDistance = nearest.wallDistance;
+			entry.origin = position;
+			entry.reading = readings[i];
+			entry.valid = m_toleranceSq > 0.0F;
+			++m_lookups;
+		}
+	}
+
+} // namespace sim
@@ -0,0 +1,77 @@
+/*
+==============================================================================
+Sensor Query Cache - grid readings reused while a sensor barely moves
+==============================================================================
+ - Remembers, per sensor, where its last full grid lookup was made and
+   what it found; a sensor within the tolerance of that spot skips the
+   grid (--sensor-cache <units>)
+ - Triangle inequality: a sensor that moved d from the lookup is at most
+   d nearer or farther from every obstacle and wall, so a reused reading
+   is off by no more than the tolerance
+ - A reused pillar reading is refined at once: the distance to the pillar
+   found last is recomputed exactly, which is the true reading whenever
+   the nearest pillar has not changed, and otherwise at most twice the
+   tolerance above it
+ - Drift is measured from the lookup, not from the previous pass, so slow
+   creeping cannot accumulate past the bound: it triggers a full lookup
+ - invalidate() after the grid is rebuilt; a different sensor count
+   invalidates by itself
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "ObstacleGrid.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	class SensorQueryCache {
+	public:
+		/**
+		 * @brief World units a sensor may move before its reading is looked up again.
+		 *
+		 * MISRA: negative values are treated as 0 (every pass looks up, like no cache).
+		 */
+		void setTolerance(float units) noexcept;
+
+		[[nodiscard]] float tolerance() const noexcept { return m_tolerance; }
+
+		/**
+		 * @brief Forgets every reading; call whenever the grid or the obstacles change.
+		 */
+		void invalidate() noexcept;
+
+		/**
+		 * @brief sim::readSensors() over grid, through the cache.
+		 *
+		 * obstacles are the records whose centers built grid, for the exact
+		 * refinement of reused readings.
+		 */
+		void read(const std::vector<SensorPose>& sensors, const ObstacleGrid& grid, const std::vector<Obstacle>& obstacles,
+			float maxRange, std::vector<SensorReading>& readings);
+
+		[[nodiscard]] std::uint64_t lookups() const noexcept { return m_lookups; }
+		[[nodiscard]] std::uint64_t reused() const noexcept { return m_reused; }
+
+	private:
+		// The last full lookup of one sensor
+		struct Entry {
+			sf::Vector2f origin{ 0.0F, 0.0F };
+			SensorReading reading;
+			bool valid = false;
+		};
+
+		std::vector<Entry> m_entries;
+		float m_tolerance = 0.0F;
+		float m_toleranceSq = 0.0F;
+		std::uint64_t m_lookups = 0U;
+		std::uint64_t m_reused = 0U;
+	};
+
+} // namespace sim
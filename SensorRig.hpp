@@ -0,0 +1,147 @@
+/*
+==============================================================================
+Sensor Rig - compile-time specialized sensor rigs
+==============================================================================
+ - A Layout type lists a rig's sensors as constexpr data; SensorRig<N, Layout>
+   folds them into constexpr mounts and keeps poses and readings in
+   std::array, so the per-sensor transform, grid query and beep lookup are
+   unrolled with every mount offset a constant
+ - Results match the runtime path (createSensorMounts, placeSensors,
+   readSensors, warningInterval) bit for bit; it is a faster spelling of the
+   same rig, not a different one
+ - The runtime, vector-based rig stays for tooling and profile-loaded
+   layouts of any size; rig() hands a fixed layout over to it
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Constants.hpp"
+#include "ObstacleGrid.hpp"
+#include "Sensors.hpp"
+#include "SimTypes.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief The built-in four corner units on the default car; defaultSensorRig() is this layout.
+	 *
+	 * The car drives along +X, so the right-hand pair watches the front.
+	 */
+	struct CornerRigLayout {
+		static constexpr float SENSOR_HALF_WIDTH = constants::SENSOR_WIDTH / 2.0F;
+		static constexpr float SENSOR_LENGTH = constants::SENSOR_HEIGHT;
+		static constexpr float DIAGONAL_OFFSET = 10.0F;
+		static constexpr float OUT = SENSOR_HALF_WIDTH + DIAGONAL_OFFSET;
+
+		static constexpr sf::Vector2f HALF_EXTENT{ constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT };
+		static constexpr std::array<RigSensor, 4U> SENSORS{ {
+			{ SensorZone::Rear, SensorKind::Ultrasonic, { -1.0F, -1.0F },
+				{ -OUT, -SENSOR_LENGTH + SENSOR_HALF_WIDTH - DIAGONAL_OFFSET }, 45.0F, {} },
+			{ SensorZone::Front, SensorKind::Ultrasonic, { 1.0F, -1.0F }, { OUT, -OUT }, 315.0F, {} },
+			{ SensorZone::Rear, SensorKind::Ultrasonic, { -1.0F, 1.0F }, { -OUT, OUT }, 135.0F, {} },
+			{ SensorZone::Front, SensorKind::Ultrasonic, { 1.0F, 1.0F }, { OUT, OUT }, 225.0F, {} }
+		} };
+	};
+
+	/**
+	 * @brief Layout's mounts for its HALF_EXTENT, as createSensorMounts() computes them.
+	 */
+	template <typename Layout, std::size_t... I>
+	[[nodiscard]] constexpr std::array<SensorMount, sizeof...(I)> layoutMounts(std::index_sequence<I...>) noexcept {
+		return { {
+			SensorMount{ { Layout::SENSORS[I].anchor.x * Layout::HALF_EXTENT.x + Layout::SENSORS[I].offset.x,
+				Layout::SENSORS[I].anchor.y * Layout::HALF_EXTENT.y + Layout::SENSORS[I].offset.y },
+				Layout::SENSORS[I].rotationDeg, Layout::SENSORS[I].zone }...
+		} };
+	}
+
+	template <std::size_t N, typename Layout>
+	class SensorRig {
+		static_assert(N > 0U && Layout::SENSORS.size() == N, "Layout must list exactly N sensors");
+
+	public:
+		using Poses = std::array<SensorPose, N>;
+		using Readings = std::array<SensorReading, N>;
+
+		static constexpr std::size_t SIZE = N;
+		static constexpr std::array<SensorMount, N> MOUNTS = layoutMounts<Layout>(std::make_index_sequence<N>{});
+
+		/**
+		 * @brief placeSensors() over the fixed mounts: poses[i] = MOUNTS[i] under the car transform.
+		 */
+		static void place(const sf::Transform& transform, float headingDeg, Poses& poses) noexcept {
+			const float* const m = transform.getMatrix();
+			placeEach(m[0], m[4], m[12], m[1], m[5], m[13], headingDeg, poses, std::make_index_sequence<N>{});
+		}
+
+		/**
+		 * @brief readSensors() over the fixed rig: one grid lookup per sensor, no farther than maxRange.
+		 */
+		static void read(const Poses& poses, const ObstacleGrid& obstacleGrid, float maxRange, Readings& readings) {
+			readEach(poses, obstacleGrid, maxRange, readings, std::make_index_sequence<N>{});
+		}
+
+		/**
+		 * @brief warningInterval() over the fixed rig: the most urgent beep interval (0 = silent).
+		 */
+		[[nodiscard]] static float warningInterval(const Readings& readings, const WarningProfile& profile) noexcept {
+			return intervalOf(readings, profile, std::make_index_sequence<N>{});
+		}
+
+		/**
+		 * @brief The layout as a runtime rig, for tooling and the vector-based path.
+		 */
+		[[nodiscard]] static std::vector<RigSensor> rig() {
+			return { Layout::SENSORS.begin(), Layout::SENSORS.end() };
+		}
+
+	private:
+		template <std::size_t... I>
+		static void placeEach(float a00, float a01, float a02, float a10, float a11, float a12, float headingDeg,
+			Poses& poses, std::index_sequence<I...>) noexcept
+		{
+			((poses[I].position = { a00 * MOUNTS[I].offset.x + a01 * MOUNTS[I].offset.y + a02,
+				a10 * MOUNTS[I].offset.x + a11 * MOUNTS[I].offset.y + a12 },
+				poses[I].rotationDeg = MOUNTS[I].rotationDeg + headingDeg), ...);
+		}
+
+		template <std::size_t... I>
+		static void readEach(const Poses& poses, const ObstacleGrid& obstacleGrid, float maxRange,
+			Readings& readings, std::index_sequence<I...>)
+		{
+			(readOne(poses[I].position, obstacleGrid, maxRange, readings[I]), ...);
+		}
+
+		static void readOne(const sf::Vector2f& position, const ObstacleGrid& obstacleGrid, float maxRange,
+			SensorReading& reading)
+		{
+			const NearestObstacle nearest = obstacleGrid.nearest(position, maxRange);
+			reading.obstacle = nearest.index;
+			reading.distanceSq = nearest.distanceSq;
+			reading.wallDistance = nearest.wallDistance;
+		}
+
+		template <std::size_t... I>
+		[[nodiscard]] static float intervalOf(const Readings& readings, const WarningProfile& profile,
+			std::index_sequence<I...>) noexcept
+		{
+			float interval = 0.0F;
+			((interval = moreUrgent(interval, profile.interval(MOUNTS[I].zone, readings[I].distanceSq))), ...);
+			return interval;
+		}
+	};
+
+	// The built-in rig with every mount a compile-time constant
+	using CornerSensorRig = SensorRig<4U, CornerRigLayout>;
+
+} // namespace sim
@@ -0,0 +1,118 @@
+#include "Sensors.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "CarHull.hpp"
+#include "Constants.hpp"
+#include "HardwareCounters.hpp"
+#include "SensorQuery.hpp"
+#include "SensorRig.hpp"
+
+namespace sim {
+
+	namespace {
+		[[nodiscard]] sf::Vector2f rigExtent(const RigSensor& sensor) noexcept {
+			if (sensor.extent.x > 0.0F && sensor.extent.y > 0.0F) {
+				return sensor.extent;
+			}
+			return (sensor.kind == SensorKind::Camera)
+				? sf::Vector2f{ constants::CAMERA_SENSOR_WIDTH, constants::CAMERA_SENSOR_HEIGHT }
+				: sf::Vector2f{ constants::SENSOR_WIDTH, constants::SENSOR_HEIGHT };
+		}
+	}
+
+	std::vector<RigSensor> defaultSensorRig() {
+		return CornerSensorRig::rig();
+	}
+
+	std::vector<SensorPose> createSensorPoses(const std::vector<RigSensor>& rig) {
+		const std::vector<RigSensor> layout = rig.empty() ? defaultSensorRig() : rig;
+		std::vector<SensorPose> sensors;
+		sensors.reserve(layout.size()); // Avoid dynamic reallocations
+
+		constexpr float START_X = 800.0F;
+		constexpr float START_Y = 200.0F;
+		constexpr float SPACING = 100.0F;
+
+		for (std::size_t i = 0U; i < layout.size(); ++i) {
+			SensorPose sensor;
+			sensor.position = { START_X + (static_cast<float>(i) * SPACING), START_Y };
+			sensor.extent = rigExtent(layout[i]);
+			sensors.push_back(sensor);
+		}
+
+		return sensors; // Return by value (NRVO applies)
+	}
+
+	std::vector<SensorMount> createSensorMounts(const sf::Vector2f& carHalfExtent, const std::vector<RigSensor>& rig) {
+		const std::vector<RigSensor> layout = rig.empty() ? defaultSensorRig() : rig;
+		std::vector<SensorMount> mounts;
+		mounts.reserve(layout.size());
+		for (const auto& sensor : layout) {
+			const sf::Vector2f offset{ sensor.anchor.x * carHalfExtent.x + sensor.offset.x,
+				sensor.anchor.y * carHalfExtent.y + sensor.offset.y };
+			mounts.push_back({ offset, sensor.rotationDeg, sensor.zone });
+		}
+		return mounts;
+	}
+
+	std::vector<SensorMount> createSensorMounts(const CarHull& hull, const std::vector<RigSensor>& rig) {
+		const std::vector<RigSensor> layout = rig.empty() ? defaultSensorRig() : rig;
+		std::vector<SensorMount> mounts;
+		mounts.reserve(layout.size());
+		for (const auto& sensor : layout) {
+			const sf::Vector2f anchor = hullBoundary(hull, sensor.anchor.componentWiseMul(hull.halfExtent));
+			mounts.push_back({ anchor + sensor.offset, sensor.rotationDeg, sensor.zone });
+		}
+		return mounts;
+	}
+
+	void placeSensors(const sf::Transform& transform, float headingDeg, const SensorMount* mounts, std::size_t count,
+		SensorPose* poses) noexcept
+	{
+		// Column-major 4x4: the 2D affine terms, in transformPoint()'s order
+		const float* const m = transform.getMatrix();
+		const float a00 = m[0];
+		const float a01 = m[4];
+		const float a02 = m[12];
+		const float a10 = m[1];
+		const float a11 = m[5];
+		const float a12 = m[13];
+
+		for (std::size_t i = 0U; i < count; ++i) {
+			const sf::Vector2f offset = mounts[i].offset;
+			poses[i].position = { a00 * offset.x + a01 * offset.y + a02, a10 * offset.x + a11 * offset.y + a12 };
+			poses[i].rotationDeg = mounts[i].rotationDeg + headingDeg;
+		}
+	}
+
+	void updateSensorPositions(std::vector<SensorPose>& sensors,
+		const std::vector<SensorMount>& mounts, const CarState& car)
+	{
+		OKPP_HW_COUNTER_SCOPE("updateSensorPositions");
+		placeSensors(carTransform(car), car.headingDeg, mounts.data(), std::min(sensors.size(), mounts.size()),
+			sensors.data());
+	}
+
+	void readSensors(const std::vector<SensorPose>& sensors, const ObstacleGrid& obstacleGrid, float maxRange,
+		std::vector<SensorReading>& readings)
+	{
+		readings.resize(sensors.size());
+		querySensors(SensorSource{ &obstacleGrid, nullptr, maxRange }, sensors.data(), sensors.size(), readings.data());
+	}
+
+	float warningInterval(const std::vector<SensorReading>& readings,
+		const std::vector<SensorMount>& mounts, const WarningProfile& profile)
+	{
+		const std::size_t count = std::min(readings.size(), mounts.size());
+		float interval = 0.0F;
+
+		for (std::size_t i = 0U; i < count; ++i) {
+			interval = moreUrgent(interval, profile.interval(mounts[i].zone, readings[i].distanceSq));
+		}
+
+		return interval;
+	}
+
+} // namespace sim
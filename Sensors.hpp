@@ -0,0 +1,100 @@
+/*
+==============================================================================
+Sensors - parking sensor placement and nearest-obstacle queries
+==============================================================================
+ - Works on packed SensorPose records only (no drawables)
+ - Shared by the SFML front-end and the headless runner
+ - The layout is data: a rig of any size (a vehicle profile's "sensor"
+   records, or the built-in four corner units) becomes mounts once per car
+   size, and every pass loops over whatever the rig holds
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "ObstacleGrid.hpp"
+#include "SimTypes.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	struct CarHull;
+
+	/**
+	 * @brief The built-in rig: one ultrasonic unit at each corner, rear pair
+	 *        and front pair watching diagonally outwards.
+	 */
+	[[nodiscard]] std::vector<RigSensor> defaultSensorRig();
+
+	/**
+	 * @brief Creates the parking sensor poses (simulation records), one per
+	 *        sensor of rig; an empty rig means defaultSensorRig().
+	 *
+	 * MISRA: Functions should have single responsibility.
+	 *        Avoid global mutable data.
+	 */
+	[[nodiscard]] std::vector<SensorPose> createSensorPoses(const std::vector<RigSensor>& rig = {});
+
+	/**
+	 * @brief Sensor mounts of rig for a car of the given half extent, one per pose.
+	 *
+	 * The mounts are computed once per car size and reused every tick; an
+	 * empty rig means defaultSensorRig().
+	 */
+	[[nodiscard]] std::vector<SensorMount> createSensorMounts(const sf::Vector2f& carHalfExtent,
+		const std::vector<RigSensor>& rig = {});
+
+	/**
+	 * @brief Mounts on the car's alpha hull: each anchor slides along its ray from the
+	 *        center to where the ray leaves the hull, so a sensor sits on the bodywork
+	 *        rather than on the sprite's transparent margin. An empty hull gives the
+	 *        rectangle's mounts.
+	 */
+	[[nodiscard]] std::vector<SensorMount> createSensorMounts(const CarHull& hull, const std::vector<RigSensor>& rig = {});
+
+	/**
+	 * @brief Batched mount transform: poses[i] = mounts[i] under the car transform.
+	 *
+	 * The matrix terms are read once for the whole batch; positions match
+	 * transform.transformPoint() bit for bit.
+	 */
+	void placeSensors(const sf::Transform& transform, float headingDeg, const SensorMount* mounts, std::size_t count,
+		SensorPose* poses) noexcept;
+
+	/**
+	 * @brief Places the sensor poses from their mounts and the car pose.
+	 *
+	 * One car transform is built per call and applied to every mount, so the
+	 * sensors follow the car's real heading instead of its swollen AABB.
+	 */
+	void updateSensorPositions(std::vector<SensorPose>& sensors,
+		const std::vector<SensorMount>& mounts, const CarState& car);
+
+	/**
+	 * @brief Batched sensor pass: nearest obstacle and wall for every sensor.
+	 *
+	 * One grid lookup per sensor finds both, searching no farther than
+	 * maxRange. The readings are then shared by the beep decision, the
+	 * indicator colors and the wall checks, so none of them scans again.
+	 */
+	void readSensors(const std::vector<SensorPose>& sensors, const ObstacleGrid& obstacleGrid, float maxRange,
+		std::vector<SensorReading>& readings);
+
+	/**
+	 * @brief Most urgent beep interval over all readings (0 = silent).
+	 *
+	 * Each reading's squared distance indexes the table of its mount's zone
+	 * directly.
+	 */
+	[[nodiscard]] float warningInterval(const std::vector<SensorReading>& readings,
+		const std::vector<SensorMount>& mounts, const WarningProfile& profile);
+
+} // namespace sim
@@ -0,0 +1,99 @@
+/*
+==============================================================================
+Seq Lock - one writer publishes a small state block, readers never block
+==============================================================================
+ - The sequence counter is odd while a write is in progress; a reader
+   copies the block between two reads of the counter and retries if they
+   differ or were odd, so it always ends up with one whole write
+ - The block is kept as relaxed atomic words, so a reader racing a write
+   reads stale or torn words (then retries) instead of a data race
+ - version() counts completed writes: a consumer that remembers the last
+   version it acted on skips the copy and the work when nothing changed
+ - For small trivially copyable T; exactly one writer thread
+ - No SFML dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace sim {
+
+	template <typename T>
+	class SeqLock {
+		static_assert(std::is_trivially_copyable_v<T>, "the block is copied word by word");
+
+	public:
+		explicit SeqLock(const T& initial = T{}) noexcept { writeWords(initial); }
+
+		SeqLock(const SeqLock&) = delete;
+		SeqLock& operator=(const SeqLock&) = delete;
+
+		/**
+		 * @brief Publishes value; writer thread only.
+		 */
+		void store(const T& value) noexcept {
+			const std::uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+			m_sequence.store(sequence + 1U, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			writeWords(value);
+			m_sequence.store(sequence + 2U, std::memory_order_release);
+		}
+
+		/**
+		 * @brief A consistent copy of the last published value; any thread, never blocks the writer.
+		 */
+		[[nodiscard]] T load() const noexcept {
+			T value;
+			(void)load(value);
+			return value;
+		}
+
+		/**
+		 * @brief Copies the last published value into value and returns its version.
+		 */
+		std::uint32_t load(T& value) const noexcept {
+			for (;;) {
+				const std::uint32_t before = m_sequence.load(std::memory_order_acquire);
+				if ((before & 1U) != 0U) {
+					continue; // the writer is mid-store
+				}
+				std::array<std::uint32_t, WORDS> words;
+				for (std::size_t i = 0U; i < WORDS; ++i) {
+					words[i] = m_words[i].load(std::memory_order_relaxed);
+				}
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (m_sequence.load(std::memory_order_relaxed) == before) {
+					std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+					return before / 2U;
+				}
+			}
+		}
+
+		/**
+		 * @brief Completed stores so far (wraps); cheap enough to poll every tick.
+		 */
+		[[nodiscard]] std::uint32_t version() const noexcept { return m_sequence.load(std::memory_order_acquire) / 2U; }
+
+	private:
+		static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint32_t) - 1U) / sizeof(std::uint32_t);
+
+		void writeWords(const T& value) noexcept {
+			std::array<std::uint32_t, WORDS> words{};
+			std::memcpy(words.data(), &value, sizeof(T));
+			for (std::size_t i = 0U; i < WORDS; ++i) {
+				m_words[i].store(words[i], std::memory_order_relaxed);
+			}
+		}
+
+		std::atomic<std::uint32_t> m_sequence{ 0U };
+		std::array<std::atomic<std::uint32_t>, WORDS> m_words{};
+	};
+
+} // namespace sim
@@ -0,0 +1,64 @@
+/*
+==============================================================================
+Simulation Forward Declarations - names without their definitions
+==============================================================================
+ - For headers that only pass core types by reference or pointer, so they
+   need not pull in the full record, container and SFML headers behind them
+ - Enums are declared with their underlying type; any header that needs an
+   enumerator or a member still includes the defining header
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace sim {
+
+	// SimTypes.hpp
+	struct Obstacle;
+	struct WallSegment;
+	struct SensorPose;
+	struct SensorMount;
+	struct SensorReading;
+	enum class SensorZone : std::uint8_t;
+
+	// CarModel.hpp, VehicleDynamics.hpp
+	struct CarState;
+	struct CarParams;
+	struct BicycleParams;
+	struct BicycleState;
+	class VehicleBatch;
+	enum class VehicleModel : std::uint8_t;
+
+	// Scene.hpp, WarningProfile.hpp, CollisionPredictor.hpp, World.hpp
+	struct Scene;
+	struct WarningBand;
+	class WarningProfile;
+	struct TtcBand;
+	class CollisionPredictor;
+	struct World;
+
+	// Spatial indices
+	class ObstacleGrid;
+	class ParkingLot;
+	class CollisionWorld;
+	class RayCaster;
+	struct RayCone;
+	class OccupancyMap;
+	class DistanceField;
+
+	// Batch runs
+	struct TraceSegment;
+	struct HeadlessStats;
+	struct FleetStats;
+	class FleetSimulation;
+	struct EvaluationConfig;
+	struct EvaluationResult;
+
+	// Threads and per-frame memory
+	class ThreadPool;
+	class TaskGroup;
+	class FrameArena;
+
+} // namespace sim
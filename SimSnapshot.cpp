@@ -0,0 +1,92 @@
+#include "SimSnapshot.hpp"
+
+#include <cstring>
+#include <utility>
+
+#include "Log.hpp"
+
+namespace sim {
+
+	namespace {
+		constexpr char SNAPSHOT_MAGIC[8] = { 'O', 'K', 'S', 'N', 'P', '0', '0', '1' };
+
+		struct SnapshotHeader {
+			char magic[8];
+			std::uint32_t snapshotBytes; // sizeof(SimSnapshot) of the writer
+			std::uint32_t obstacleCount;
+			std::uint32_t bayCount;
+			std::uint32_t spawnCount;
+			sf::Vector2f carHalfExtent;
+		};
+
+		static_assert(sizeof(SnapshotHeader) == 32U, "SnapshotHeader layout is part of the buffer format");
+		static_assert(std::is_trivially_copyable_v<Obstacle> && std::is_trivially_copyable_v<sf::FloatRect>
+			&& std::is_trivially_copyable_v<CarState>, "scene arrays are stored raw");
+
+		template <typename T>
+		void appendRaw(std::vector<unsigned char>& out, const T* values, std::size_t count) {
+			const auto* bytes = reinterpret_cast<const unsigned char*>(values);
+			out.insert(out.end(), bytes, bytes + count * sizeof(T));
+		}
+
+		template <typename T>
+		const unsigned char* readArray(const unsigned char* in, std::uint32_t count, std::vector<T>& out) {
+			out.resize(count);
+			if (count > 0U) {
+				std::memcpy(out.data(), in, static_cast<std::size_t>(count) * sizeof(T));
+			}
+			return in + static_cast<std::size_t>(count) * sizeof(T);
+		}
+	}
+
+	void serializeSnapshot(const SimSnapshot& snapshot, const Scene& scene, std::vector<unsigned char>& out) {
+		SnapshotHeader header{};
+		std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+		header.snapshotBytes = static_cast<std::uint32_t>(sizeof(SimSnapshot));
+		header.obstacleCount = static_cast<std::uint32_t>(scene.obstacles.size());
+		header.bayCount = static_cast<std::uint32_t>(scene.parkBays.size());
+		header.spawnCount = static_cast<std::uint32_t>(scene.spawns.size());
+		header.carHalfExtent = scene.carHalfExtent;
+
+		out.reserve(out.size() + sizeof(header) + sizeof(snapshot) + scene.obstacles.size() * sizeof(Obstacle)
+			+ scene.parkBays.size() * sizeof(sf::FloatRect) + scene.spawns.size() * sizeof(CarState));
+		appendRaw(out, &header, 1U);
+		appendRaw(out, &snapshot, 1U);
+		appendRaw(out, scene.obstacles.data(), scene.obstacles.size());
+		appendRaw(out, scene.parkBays.data(), scene.parkBays.size());
+		appendRaw(out, scene.spawns.data(), scene.spawns.size());
+	}
+
+	bool deserializeSnapshot(const unsigned char* data, std::size_t size, SimSnapshot& snapshot, Scene& scene) {
+		SnapshotHeader header{};
+		if (size < sizeof(header)) {
+			OKPP_LOG_ERROR("Error: snapshot is truncated");
+			return false;
+		}
+		std::memcpy(&header, data, sizeof(header));
+		if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.snapshotBytes != sizeof(SimSnapshot)) {
+			OKPP_LOG_ERROR("Error: snapshot is from another format or build");
+			return false;
+		}
+		const std::uint64_t expected = sizeof(header) + sizeof(SimSnapshot)
+			+ static_cast<std::uint64_t>(header.obstacleCount) * sizeof(Obstacle)
+			+ static_cast<std::uint64_t>(header.bayCount) * sizeof(sf::FloatRect)
+			+ static_cast<std::uint64_t>(header.spawnCount) * sizeof(CarState);
+		if (expected != size) {
+			OKPP_LOG_ERROR("Error: snapshot is truncated or corrupt");
+			return false;
+		}
+
+		Scene loaded;
+		loaded.carHalfExtent = header.carHalfExtent;
+		const unsigned char* in = data + sizeof(header);
+		std::memcpy(&snapshot, in, sizeof(SimSnapshot));
+		in += sizeof(SimSnapshot);
+		in = readArray(in, header.obstacleCount, loaded.obstacles);
+		in = readArray(in, header.bayCount, loaded.parkBays);
+		(void)readArray(in, header.spawnCount, loaded.spawns);
+		scene = std::move(loaded);
+		return true;
+	}
+
+} // namespace sim
@@ -0,0 +1,59 @@
+/*
+==============================================================================
+Sim Snapshot - the whole state of one simulated drive, restorable by memcpy
+==============================================================================
+ - SimSnapshot is a fixed-size POD: vehicle state, script position, the
+   beep clock phase, the sensor poses and readings, and the contact and
+   occupancy flags. Taking or restoring one is a plain copy, so many Monte-
+   Carlo trials can fork from one shared mid-maneuver state
+ - The scene (obstacles, bays, spawns, car size) does not change while a
+   drive runs; serializeSnapshot() appends it raw after the snapshot so a
+   buffer restores a drive with no other input
+ - Buffer layout (little-endian): "OKSNP001", snapshot size, obstacle, bay
+   and spawn counts u32, car half extent, SimSnapshot, then the arrays raw
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Scene.hpp"
+#include "SimTypes.hpp"
+#include "VehicleDynamics.hpp"
+
+namespace sim {
+
+	constexpr std::size_t MAX_SNAPSHOT_SENSORS = 8U;
+
+	struct SimSnapshot {
+		std::uint32_t tick = 0U;        // fixed ticks since the drive started
+		std::uint32_t segment = 0U;     // script segments started so far
+		std::uint32_t segmentLeft = 0U; // ticks left of the current one
+		BicycleState vehicle;           // the arcade model only uses the pose
+		float sinceLastBeep = 0.0F;     // beep clock phase
+		std::uint32_t sensorCount = 0U;
+		std::array<SensorPose, MAX_SNAPSHOT_SENSORS> sensorPoses{};
+		std::array<SensorReading, MAX_SNAPSHOT_SENSORS> readings{};
+		std::uint8_t blocked = 0U;  // a pillar stopped the car at some tick
+		std::uint8_t occupied = 0U; // the car sits in the first bay
+	};
+
+	static_assert(std::is_trivially_copyable_v<SimSnapshot>, "SimSnapshot must stay memcpy-able");
+
+	/**
+	 * @brief Appends the snapshot and the scene it runs in to out.
+	 */
+	void serializeSnapshot(const SimSnapshot& snapshot, const Scene& scene, std::vector<unsigned char>& out);
+
+	/**
+	 * @brief Restores a buffer written by serializeSnapshot(); false (logged,
+	 *        nothing changed) if it is truncated or from another build layout.
+	 */
+	[[nodiscard]] bool deserializeSnapshot(const unsigned char* data, std::size_t size, SimSnapshot& snapshot, Scene& scene);
+
+} // namespace sim
@@ -0,0 +1,96 @@
+/*
+==============================================================================
+Simulation Records - plain data shared by the simulation passes
+==============================================================================
+ - Tightly packed POD records, no drawables, no virtual calls
+ - Rendering shapes are derived from these records, never the reverse
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace sim {
+
+	// Static circular obstacle (pillar)
+	struct Obstacle {
+		sf::Vector2f center{ 0.0F, 0.0F };
+		float radius = 0.0F;
+	};
+
+	// Static line-segment obstacle: a wall, a curb or a side of the lot boundary.
+	// A one-sided wall is solid to the left of from -> to on screen (y down): a
+	// point there, within the segment's span and sensing range, is on or past
+	// it and reads 0
+	struct WallSegment {
+		sf::Vector2f from{ 0.0F, 0.0F };
+		sf::Vector2f to{ 0.0F, 0.0F };
+		std::uint32_t oneSided = 0U; // 0 = sensed from both sides
+	};
+
+	// Parking sensor pose: anchor point, heading and rectangle extent
+	struct SensorPose {
+		sf::Vector2f position{ 0.0F, 0.0F };
+		float rotationDeg = 0.0F;
+		sf::Vector2f extent{ 0.0F, 0.0F };
+	};
+
+	// Which end of the car a sensor watches; each zone has its own warning bands
+	enum class SensorZone : std::uint8_t {
+		Front,
+		Rear,
+		Corner
+	};
+	constexpr std::size_t SENSOR_ZONE_COUNT = 3U;
+
+	// Where a sensor sits on the car: offset from the car center and heading,
+	// both in the car's local frame (heading 0)
+	struct SensorMount {
+		sf::Vector2f offset{ 0.0F, 0.0F };
+		float rotationDeg = 0.0F;
+		SensorZone zone = SensorZone::Corner;
+	};
+
+	// What a sensor is; the query pass treats every kind alike, the kind only
+	// picks its default footprint
+	enum class SensorKind : std::uint8_t {
+		Ultrasonic,
+		Camera
+	};
+
+	// One sensor of a vehicle's rig, independent of the car size: the mount
+	// sits at anchor * car half extent + offset px, in the car's local frame
+	struct RigSensor {
+		SensorZone zone = SensorZone::Corner;
+		SensorKind kind = SensorKind::Ultrasonic;
+		sf::Vector2f anchor{ 0.0F, 0.0F }; // -1..1 across the body, +x = front
+		sf::Vector2f offset{ 0.0F, 0.0F }; // px beyond the anchor
+		float rotationDeg = 0.0F;
+		sf::Vector2f extent{ 0.0F, 0.0F }; // indicator size, 0 = the kind's default
+	};
+
+	// Index marking "no obstacle" (none in range, or the sensing mode cannot tell)
+	constexpr std::uint32_t NO_OBSTACLE = 0xFFFFFFFFU;
+
+	// What one sensor sees in the batched query pass; every consumer (beeps,
+	// indicator colors, wall checks) reads these instead of scanning again
+	struct SensorReading {
+		std::uint32_t obstacle = NO_OBSTACLE;                    // index into the scene obstacles
+		float distanceSq = std::numeric_limits<float>::max();   // squared distance to it (max if none in range)
+		float wallDistance = std::numeric_limits<float>::max(); // to the nearest wall segment, 0 on or past it
+	};
+
+	static_assert(std::is_trivially_copyable_v<Obstacle>, "Obstacle must stay POD");
+	static_assert(std::is_trivially_copyable_v<WallSegment>, "WallSegment must stay POD");
+	static_assert(std::is_trivially_copyable_v<SensorPose>, "SensorPose must stay POD");
+	static_assert(std::is_trivially_copyable_v<SensorMount>, "SensorMount must stay POD");
+	static_assert(std::is_trivially_copyable_v<RigSensor>, "RigSensor must stay POD");
+	static_assert(std::is_trivially_copyable_v<SensorReading>, "SensorReading must stay POD");
+
+} // namespace sim
@@ -0,0 +1,29 @@
+/*
+==============================================================================
+SIMD Intrinsics - the intrinsic headers for the runtime-dispatched kernels
+==============================================================================
+ - Every x86 level's intrinsics from <immintrin.h> (the kernels enable the
+   wider ones per function with OKPP_TARGET_*), <arm_neon.h> on ARM
+ - GCC 12's AVX-512 header seeds results with a self-initialised vector,
+   which -Wuninitialized reports in every kernel inlining it (fixed in
+   GCC 13); the warning is silenced for the header's lines only
+==============================================================================
+*/
+
+#pragma once
+
+#include "CpuFeatures.hpp"
+
+#if defined(OKPP_SIMD_X86)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#include <immintrin.h>
+#endif
+#elif defined(OKPP_SIMD_NEON)
+#include <arm_neon.h>
+#endif
@@ -0,0 +1,134 @@
+#include "SndfileBeep.hpp"
+
+#include <alsa/asoundlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sndfile.hh>
+
+#include <algorithm>
+#include "Log.hpp"
+#include "Trace.hpp"
+
+namespace audio {
+
+	namespace {
+		// Seconds between beep starts per warning level (index 0 = silent)
+		constexpr float LEVEL_INTERVALS[] = { 0.0F, 0.12F, 0.30F, 0.60F };
+		constexpr int LEVEL_COUNT = static_cast<int>(sizeof(LEVEL_INTERVALS) / sizeof(LEVEL_INTERVALS[0]));
+
+		// Whole device buffer, in microseconds: a few periods
+		constexpr unsigned int DEVICE_LATENCY_US = 10000U;
+	}
+
+	SndfileBeepPlayer::~SndfileBeepPlayer() {
+		stop();
+	}
+
+	bool SndfileBeepPlayer::load(const char* path) {
+		SndfileHandle file(path);
+		if (file.error() != 0 || file.frames() <= 0 || file.channels() <= 0) {
+			OKPP_LOG_WARNING("Warning: could not decode beep %s: %s", path, file.strError());
+			return false;
+		}
+
+		m_channels = static_cast<unsigned int>(file.channels());
+		m_sampleRate = static_cast<unsigned int>(file.samplerate());
+		m_sample.resize(static_cast<std::size_t>(file.frames()) * m_channels);
+		const sf_count_t frames = file.readf(m_sample.data(), file.frames());
+		m_sample.resize(static_cast<std::size_t>(std::max<sf_count_t>(frames, 0)) * m_channels);
+		m_playhead = m_sample.size() / m_channels; // idle until the first beep
+		return !m_sample.empty();
+	}
+
+	bool SndfileBeepPlayer::start(const WarningStateBlock& state) {
+		if (m_sample.empty() || m_thread.joinable()) {
+			return false;
+		}
+
+		int rc = snd_pcm_open(&m_pcm, "default", SND_PCM_STREAM_PLAYBACK, 0);
+		if (rc >= 0) {
+			rc = snd_pcm_set_params(m_pcm, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED,
+				m_channels, m_sampleRate, 1, DEVICE_LATENCY_US);
+		}
+		if (rc < 0) {
+			OKPP_LOG_WARNING("Warning: could not open the audio device: %s", snd_strerror(rc));
+			if (m_pcm != nullptr) {
+				(void)snd_pcm_close(m_pcm);
+				m_pcm = nullptr;
+			}
+			return false;
+		}
+
+		m_stop.store(false, std::memory_order_relaxed);
+		m_thread = std::thread([this, &state]() { run(state); });
+		return true;
+	}
+
+	void SndfileBeepPlayer::stop() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		m_stop.store(true, std::memory_order_relaxed);
+		m_thread.join();
+		(void)snd_pcm_drop(m_pcm);
+		(void)snd_pcm_close(m_pcm);
+		m_pcm = nullptr;
+	}
+
+	void SndfileBeepPlayer::fillPeriod(int level, std::int16_t* out) {
+		const std::size_t sampleFrames = m_sample.size() / m_channels;
+		const float intervalSeconds = (level > 0 && level < LEVEL_COUNT) ? LEVEL_INTERVALS[level] : 0.0F;
+		const std::uint64_t intervalFrames = static_cast<std::uint64_t>(intervalSeconds * static_cast<float>(m_sampleRate));
+
+		for (std::size_t frame = 0U; frame < PERIOD_FRAMES; ++frame) {
+			if (intervalFrames != 0U && m_sinceBeepStart >= intervalFrames) {
+				m_playhead = 0U;
+				m_sinceBeepStart = 0U;
+			}
+			++m_sinceBeepStart;
+
+			std::int16_t* dst = out + frame * m_channels;
+			if (m_playhead < sampleFrames) {
+				std::copy_n(m_sample.data() + m_playhead * m_channels, m_channels, dst);
+				++m_playhead;
+			}
+			else {
+				std::fill_n(dst, m_channels, static_cast<std::int16_t>(0));
+			}
+		}
+	}
+
+	void SndfileBeepPlayer::run(const WarningStateBlock& state) {
+		prof::setThreadName("audio");
+
+		// Real-time priority if the user may have it; the period size keeps us safe without
+		sched_param param{};
+		param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+		(void)pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+		// Start "long after" the last beep so the first level fires immediately
+		m_sinceBeepStart = UINT64_MAX / 2U;
+
+		std::vector<std::int16_t> period(PERIOD_FRAMES * m_channels);
+		WarningState current;
+		std::uint32_t seen = state.load(current);
+		while (!m_stop.load(std::memory_order_relaxed)) {
+			// The block is only copied after a publish
+			if (state.version() != seen) {
+				seen = state.load(current);
+			}
+			fillPeriod(current.level, period.data());
+
+			// Blocks until the device has room, which paces this thread
+			snd_pcm_sframes_t written = snd_pcm_writei(m_pcm, period.data(), PERIOD_FRAMES);
+			if (written < 0) {
+				written = snd_pcm_recover(m_pcm, static_cast<int>(written), 1); // underrun: resync and go on
+			}
+			if (written < 0) {
+				OKPP_LOG_WARNING("Warning: audio output stopped: %s", snd_strerror(static_cast<int>(written)));
+				break;
+			}
+		}
+	}
+
+} // namespace audio
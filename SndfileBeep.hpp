@@ -0,0 +1,81 @@
+/*
+==============================================================================
+Sndfile Beep - low-latency beep output for the GLUT variant (Linux, ALSA)
+==============================================================================
+ - The beep is decoded once with SndfileHandle into 16-bit PCM in memory
+ - A real-time writer thread feeds ALSA fixed periods of PERIOD_FRAMES and
+   checks the dashboard's WarningState block once per period, without a
+   lock, so a key press is heard within a few milliseconds
+ - The cadence is counted in samples here, not derived from frame timing:
+   level 1 beeps fastest, 3 slowest, 0 is silent
+==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "SeqLock.hpp"
+
+typedef struct _snd_pcm snd_pcm_t;
+
+namespace audio {
+
+	// Frames per ALSA write; small for latency, large enough not to underrun
+	constexpr std::size_t PERIOD_FRAMES = 128U;
+
+	// What the GL dashboard shows and sounds, published as one block
+	struct WarningState {
+		std::int32_t level = 0; // beep level 0..3: 1 nearest, 0 silent
+		std::int32_t bars = 0;  // warning bars drawn, 0..3
+	};
+	using WarningStateBlock = sim::SeqLock<WarningState>;
+
+	class SndfileBeepPlayer {
+	public:
+		SndfileBeepPlayer() = default;
+		~SndfileBeepPlayer();
+
+		SndfileBeepPlayer(const SndfileBeepPlayer&) = delete;
+		SndfileBeepPlayer& operator=(const SndfileBeepPlayer&) = delete;
+
+		/**
+		 * @brief Decodes path into memory; false (logged) if it cannot be read.
+		 */
+		bool load(const char* path);
+
+		/**
+		 * @brief Opens the default ALSA device and starts the writer thread.
+		 *
+		 * state is read on the writer thread and must outlive the player.
+		 * Requires a successful load(); false (logged) if the device fails.
+		 */
+		bool start(const WarningStateBlock& state);
+
+		/**
+		 * @brief Stops the writer thread and closes the device; safe to call twice.
+		 */
+		void stop();
+
+	private:
+		void run(const WarningStateBlock& state);
+		void fillPeriod(int level, std::int16_t* out);
+
+		std::vector<std::int16_t> m_sample; // interleaved
+		unsigned int m_channels = 0U;
+		unsigned int m_sampleRate = 0U;
+
+		snd_pcm_t* m_pcm = nullptr;
+		std::atomic<bool> m_stop{ false };
+		std::thread m_thread;
+
+		// Writer-thread state, in frames
+		std::size_t m_playhead = 0U;        // next frame of the beep, past the end when idle
+		std::uint64_t m_sinceBeepStart = 0U;
+	};
+
+} // namespace audio
@@ -0,0 +1,327 @@
+#include "SoftRasterizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GFX_RASTER_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define GFX_RASTER_NEON 1
+#endif
+
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace gfx {
+
+	namespace {
+		// A tile is a few microseconds of work; several go to each task
+		constexpr std::size_t RASTER_TILES_PER_TASK = 4U;
+
+		// Pixel coordinates beyond this are clamped before conversion
+		constexpr float MAX_PIXEL_COORD = 1048576.0F;
+
+		// Source terms of "color over dst" per channel: c * a + 128, alpha taken as 255.
+		// A channel then blends as t = term + dst * (255 - a), (t + (t >> 8)) >> 8,
+		// which is round(t / 255) for every t in reach; all paths compute exactly this
+		using BlendTerms = std::array<std::uint16_t, 4U>;
+
+		[[nodiscard]] BlendTerms blendTerms(sf::Color color) noexcept {
+			const std::uint32_t a = color.a;
+			return { static_cast<std::uint16_t>(color.r * a + 128U), static_cast<std::uint16_t>(color.g * a + 128U),
+				static_cast<std::uint16_t>(color.b * a + 128U), static_cast<std::uint16_t>(255U * a + 128U) };
+		}
+
+		void blendPixel(std::uint8_t* dst, const BlendTerms& terms, std::uint32_t inverse) noexcept {
+			for (std::size_t c = 0U; c < 4U; ++c) {
+				const std::uint32_t t = terms[c] + dst[c] * inverse;
+				dst[c] = static_cast<std::uint8_t>((t + (t >> 8U)) >> 8U);
+			}
+		}
+
+		// Overwrites count pixels with color, alpha included
+		void storeSpan(std::uint8_t* dst, std::size_t count, sf::Color color) noexcept {
+			const std::uint8_t bytes[4] = { color.r, color.g, color.b, color.a };
+			std::uint32_t packed = 0U;
+			std::memcpy(&packed, bytes, sizeof(packed));
+			std::size_t i = 0U;
+#if defined(GFX_RASTER_SSE2)
+			const __m128i quad = _mm_set1_epi32(static_cast<int>(packed));
+			for (; i + 4U <= count; i += 4U) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4U * i), quad);
+			}
+#elif defined(GFX_RASTER_NEON)
+			const uint32x4_t quad = vdupq_n_u32(packed);
+			for (; i + 4U <= count; i += 4U) {
+				vst1q_u8(dst + 4U * i, vreinterpretq_u8_u32(quad));
+			}
+#endif
+			for (; i < count; ++i) {
+				std::memcpy(dst + 4U * i, &packed, sizeof(packed));
+			}
+		}
+
+		// Blends a translucent color over count pixels
+		void blendSpan(std::uint8_t* dst, std::size_t count, sf::Color color) noexcept {
+			const BlendTerms terms = blendTerms(color);
+			const std::uint32_t inverse = 255U - color.a;
+			std::size_t i = 0U;
+#if defined(GFX_RASTER_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i inverses = _mm_set1_epi16(static_cast<short>(inverse));
+			const auto lane = [&terms](std::size_t c) { return static_cast<short>(terms[c]); }; // wraps: the lanes are unsigned
+			const __m128i source = _mm_setr_epi16(lane(0U), lane(1U), lane(2U), lane(3U), lane(0U), lane(1U), lane(2U), lane(3U));
+			for (; i + 4U <= count; i += 4U) {
+				__m128i* const pixels = reinterpret_cast<__m128i*>(dst + 4U * i);
+				const __m128i loaded = _mm_loadu_si128(pixels);
+				__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(loaded, zero), inverses), source);
+				__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(loaded, zero), inverses), source);
+				low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+				high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+				_mm_storeu_si128(pixels, _mm_packus_epi16(low, high));
+			}
+#elif defined(GFX_RASTER_NEON)
+			const uint16x8_t inverses = vdupq_n_u16(static_cast<std::uint16_t>(inverse));
+			const std::uint16_t lanes[8] = { terms[0], terms[1], terms[2], terms[3], terms[0], terms[1], terms[2], terms[3] };
+			const uint16x8_t source = vld1q_u16(lanes);
+			for (; i + 4U <= count; i += 4U) {
+				std::uint8_t* const pixels = dst + 4U * i;
+				const uint8x16_t loaded = vld1q_u8(pixels);
+				uint16x8_t low = vmlaq_u16(source, vmovl_u8(vget_low_u8(loaded)), inverses);
+				uint16x8_t high = vmlaq_u16(source, vmovl_u8(vget_high_u8(loaded)), inverses);
+				low = vshrq_n_u16(vaddq_u16(low, vshrq_n_u16(low, 8)), 8);
+				high = vshrq_n_u16(vaddq_u16(high, vshrq_n_u16(high, 8)), 8);
+				vst1q_u8(pixels, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+			}
+#endif
+			for (; i < count; ++i) {
+				blendPixel(dst + 4U * i, terms, inverse);
+			}
+		}
+
+		void fillSpan(std::uint8_t* dst, std::size_t count, sf::Color color) noexcept {
+			if (color.a == 255U) {
+				storeSpan(dst, count, color);
+			}
+			else if (color.a > 0U) {
+				blendSpan(dst, count, color);
+			}
+		}
+
+		// First pixel whose center is at or right of x (or below, for rows)
+		[[nodiscard]] std::int32_t firstPixelAt(float x) noexcept {
+			return static_cast<std::int32_t>(std::ceil(std::clamp(x - 0.5F, -MAX_PIXEL_COORD, MAX_PIXEL_COORD)));
+		}
+
+		// Pixels [left, right) of the row at centerY whose centers lie inside a convex quad; false if none
+		[[nodiscard]] bool quadSpan(const std::array<sf::Vector2f, 4U>& corners, float centerY,
+			std::int32_t& left, std::int32_t& right) noexcept
+		{
+			float minX = std::numeric_limits<float>::max();
+			float maxX = std::numeric_limits<float>::lowest();
+			for (std::size_t i = 0U; i < 4U; ++i) {
+				const sf::Vector2f& a = corners[i];
+				const sf::Vector2f& b = corners[(i + 1U) % 4U];
+				if ((a.y <= centerY) != (b.y <= centerY)) {
+					const float x = a.x + (centerY - a.y) * (b.x - a.x) / (b.y - a.y);
+					minX = std::min(minX, x);
+					maxX = std::max(maxX, x);
+				}
+			}
+			if (minX > maxX) {
+				return false;
+			}
+			left = firstPixelAt(minX);
+			right = firstPixelAt(maxX);
+			return left < right;
+		}
+	}
+
+	void SoftRasterizer::resize(std::uint32_t width, std::uint32_t height) {
+		m_image.width = width;
+		m_image.height = height;
+		m_image.pixels.resize(static_cast<std::size_t>(width) * height * 4U);
+		m_tilesX = (width + TILE_SIZE - 1U) / TILE_SIZE;
+		m_tilesY = (height + TILE_SIZE - 1U) / TILE_SIZE;
+		m_bins.resize(static_cast<std::size_t>(m_tilesX) * m_tilesY);
+	}
+
+	void SoftRasterizer::setView(const sf::FloatRect& world) {
+		if (world.size.x <= 0.0F || world.size.y <= 0.0F) {
+			return;
+		}
+		const sf::Vector2f imageSize{ static_cast<float>(m_image.width), static_cast<float>(m_image.height) };
+		m_scale = std::min(imageSize.x / world.size.x, imageSize.y / world.size.y);
+		const sf::Vector2f offset = (imageSize - world.size * m_scale) * 0.5F - world.position * m_scale;
+		m_pixelFromWorld = sf::Transform(m_scale, 0.0F, offset.x,
+			0.0F, m_scale, offset.y,
+			0.0F, 0.0F, 1.0F);
+	}
+
+	void SoftRasterizer::fillRect(const sf::FloatRect& rect, sf::Color color) {
+		const sf::Vector2f min = m_pixelFromWorld.transformPoint(rect.position);
+		const sf::Vector2f max = m_pixelFromWorld.transformPoint(rect.position + rect.size);
+		Primitive primitive;
+		primitive.shape = Shape::Rect;
+		primitive.color = color;
+		push(primitive, std::min(min.x, max.x), std::min(min.y, max.y), std::max(min.x, max.x), std::max(min.y, max.y));
+	}
+
+	void SoftRasterizer::fillCircle(sf::Vector2f center, float radius, sf::Color color) {
+		const sf::Vector2f pixelCenter = m_pixelFromWorld.transformPoint(center);
+		const float pixelRadius = radius * m_scale;
+		Primitive primitive;
+		primitive.shape = Shape::Circle;
+		primitive.color = color;
+		primitive.points[0] = pixelCenter;
+		primitive.points[1] = { pixelRadius, 0.0F };
+		push(primitive, pixelCenter.x - pixelRadius, pixelCenter.y - pixelRadius,
+			pixelCenter.x + pixelRadius, pixelCenter.y + pixelRadius);
+	}
+
+	void SoftRasterizer::fillQuad(const std::array<sf::Vector2f, 4U>& corners, sf::Color color) {
+		pushQuad(Shape::Quad, corners, color, nullptr, sf::Transform::Identity);
+	}
+
+	void SoftRasterizer::drawSprite(const SoftImage& image, const sf::Transform& transform) {
+		if (image.width == 0U || image.height == 0U) {
+			return;
+		}
+		const float width = static_cast<float>(image.width);
+		const float height = static_cast<float>(image.height);
+		const sf::Transform pixelFromTexel = m_pixelFromWorld * transform;
+		const std::array<sf::Vector2f, 4U> corners{ transform.transformPoint({ 0.0F, 0.0F }),
+			transform.transformPoint({ width, 0.0F }), transform.transformPoint({ width, height }),
+			transform.transformPoint({ 0.0F, height }) };
+		pushQuad(Shape::Sprite, corners, sf::Color::White, &image, pixelFromTexel.getInverse());
+	}
+
+	void SoftRasterizer::pushQuad(Shape shape, const std::array<sf::Vector2f, 4U>& corners, sf::Color color,
+		const SoftImage* image, const sf::Transform& texelFromPixel)
+	{
+		Primitive primitive;
+		primitive.shape = shape;
+		primitive.color = color;
+		primitive.image = image;
+		primitive.texelFromPixel = texelFromPixel;
+		sf::Vector2f min{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		sf::Vector2f max{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+		for (std::size_t i = 0U; i < 4U; ++i) {
+			const sf::Vector2f corner = m_pixelFromWorld.transformPoint(corners[i]);
+			primitive.points[i] = corner;
+			min = { std::min(min.x, corner.x), std::min(min.y, corner.y) };
+			max = { std::max(max.x, corner.x), std::max(max.y, corner.y) };
+		}
+		push(primitive, min.x, min.y, max.x, max.y);
+	}
+
+	void SoftRasterizer::push(Primitive& primitive, float minX, float minY, float maxX, float maxY) {
+		const auto width = static_cast<std::int32_t>(m_image.width);
+		const auto height = static_cast<std::int32_t>(m_image.height);
+		primitive.minX = std::clamp(firstPixelAt(minX), 0, width);
+		primitive.minY = std::clamp(firstPixelAt(minY), 0, height);
+		primitive.maxX = std::clamp(firstPixelAt(maxX), 0, width);
+		primitive.maxY = std::clamp(firstPixelAt(maxY), 0, height);
+		if (primitive.minX < primitive.maxX && primitive.minY < primitive.maxY) {
+			m_primitives.push_back(primitive);
+		}
+	}
+
+	void SoftRasterizer::render(sim::ThreadPool& pool) {
+		OKPP_TRACE_SCOPE("SoftRasterizer::render");
+		for (auto& bin : m_bins) {
+			bin.clear();
+		}
+		for (std::size_t index = 0U; index < m_primitives.size(); ++index) {
+			const Primitive& primitive = m_primitives[index];
+			const auto tileMaxX = static_cast<std::uint32_t>(primitive.maxX - 1) / TILE_SIZE;
+			const auto tileMaxY = static_cast<std::uint32_t>(primitive.maxY - 1) / TILE_SIZE;
+			for (auto ty = static_cast<std::uint32_t>(primitive.minY) / TILE_SIZE; ty <= tileMaxY; ++ty) {
+				for (auto tx = static_cast<std::uint32_t>(primitive.minX) / TILE_SIZE; tx <= tileMaxX; ++tx) {
+					m_bins[static_cast<std::size_t>(ty) * m_tilesX + tx].push_back(static_cast<std::uint32_t>(index));
+				}
+			}
+		}
+
+		pool.parallelFor(m_bins.size(), RASTER_TILES_PER_TASK, [this](std::size_t begin, std::size_t end) {
+			for (std::size_t tile = begin; tile < end; ++tile) {
+				rasterizeTile(tile);
+			}
+		});
+		m_primitives.clear();
+	}
+
+	void SoftRasterizer::rasterizeTile(std::size_t tile) {
+		const auto x0 = static_cast<std::int32_t>((tile % m_tilesX) * TILE_SIZE);
+		const auto y0 = static_cast<std::int32_t>((tile / m_tilesX) * TILE_SIZE);
+		const std::int32_t x1 = std::min(x0 + static_cast<std::int32_t>(TILE_SIZE), static_cast<std::int32_t>(m_image.width));
+		const std::int32_t y1 = std::min(y0 + static_cast<std::int32_t>(TILE_SIZE), static_cast<std::int32_t>(m_image.height));
+		const std::size_t stride = static_cast<std::size_t>(m_image.width) * 4U;
+		std::uint8_t* const pixels = m_image.pixels.data(); // tiles write disjoint pixels
+		const auto at = [pixels, stride](std::int32_t x, std::int32_t y) {
+			return pixels + static_cast<std::size_t>(y) * stride + static_cast<std::size_t>(x) * 4U;
+		};
+
+		for (std::int32_t y = y0; y < y1; ++y) {
+			storeSpan(at(x0, y), static_cast<std::size_t>(x1 - x0), m_clearColor);
+		}
+
+		for (const std::uint32_t index : m_bins[tile]) {
+			const Primitive& primitive = m_primitives[index];
+			const std::int32_t minX = std::max(primitive.minX, x0);
+			const std::int32_t maxX = std::min(primitive.maxX, x1);
+			const std::int32_t maxY = std::min(primitive.maxY, y1);
+			for (std::int32_t y = std::max(primitive.minY, y0); y < maxY; ++y) {
+				const float centerY = static_cast<float>(y) + 0.5F;
+				std::int32_t left = minX;
+				std::int32_t right = maxX;
+				if (primitive.shape == Shape::Circle) {
+					const sf::Vector2f center = primitive.points[0];
+					const float radius = primitive.points[1].x;
+					const float dy = centerY - center.y;
+					const float halfSq = radius * radius - dy * dy;
+					if (halfSq < 0.0F) {
+						continue;
+					}
+					const float half = std::sqrt(halfSq);
+					left = firstPixelAt(center.x - half);
+					right = firstPixelAt(center.x + half);
+				}
+				else if (primitive.shape != Shape::Rect && !quadSpan(primitive.points, centerY, left, right)) {
+					continue;
+				}
+				left = std::max(left, minX);
+				right = std::min(right, maxX);
+				if (left >= right) {
+					continue;
+				}
+
+				if (primitive.shape != Shape::Sprite) {
+					fillSpan(at(left, y), static_cast<std::size_t>(right - left), primitive.color);
+					continue;
+				}
+				const SoftImage& image = *primitive.image;
+				for (std::int32_t x = left; x < right; ++x) {
+					const sf::Vector2f texel = primitive.texelFromPixel.transformPoint({ static_cast<float>(x) + 0.5F, centerY });
+					const auto u = static_cast<std::int64_t>(std::floor(texel.x));
+					const auto v = static_cast<std::int64_t>(std::floor(texel.y));
+					if (u < 0 || v < 0 || u >= static_cast<std::int64_t>(image.width) || v >= static_cast<std::int64_t>(image.height)) {
+						continue;
+					}
+					const std::uint8_t* source = image.pixels.data() + (static_cast<std::size_t>(v) * image.width
+						+ static_cast<std::size_t>(u)) * 4U;
+					const sf::Color color(source[0], source[1], source[2], source[3]);
+					fillSpan(at(x, y), 1U, color);
+				}
+			}
+		}
+	}
+
+} // namespace gfx
+
+#undef GFX_RASTER_SSE2
+#undef GFX_RASTER_NEON
@@ -0,0 +1,126 @@
+/*
+==============================================================================
+Soft Rasterizer - CPU rendering of scene primitives for headless screenshots
+==============================================================================
+ - Rectangles, circles, convex quads and sprites (RGBA images under an
+   affine transform) are queued in world coordinates and rasterized into
+   an RGBA8 image by render(); no window, GPU or OpenGL context is needed,
+   so CI nodes can produce golden images of a replay
+ - The image is cut into TILE_SIZE square tiles. render() bins every
+   primitive into the tiles its bounds touch, then the job system
+   rasterizes the tiles in parallel, each one painting its own primitives
+   in submission order; the result is the same for any thread count
+ - Coverage is sampled once at each pixel center (no anti-aliasing), so
+   an image is bit-identical from run to run and machine to machine
+ - Solid spans are filled and alpha-blended four pixels at a time with
+   SSE2 or NEON, with a scalar fallback computing the same bits
+ - Depends on the simulation core only; writePng (PngWriter) saves the
+   image
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SimFwd.hpp"
+
+namespace gfx {
+
+	// Row-major RGBA8 pixels, four bytes per pixel in R, G, B, A order (as sf::Image)
+	struct SoftImage {
+		std::uint32_t width = 0U;
+		std::uint32_t height = 0U;
+		std::vector<std::uint8_t> pixels;
+	};
+
+	class SoftRasterizer {
+	public:
+		static constexpr std::uint32_t TILE_SIZE = 64U;
+
+		/**
+		 * @brief Resizes the image; its contents are undefined until the next render().
+		 */
+		void resize(std::uint32_t width, std::uint32_t height);
+
+		/**
+		 * @brief Maps world onto the image: scaled uniformly to fit, centered,
+		 *        the uncovered margin left to the clear color.
+		 */
+		void setView(const sf::FloatRect& world);
+
+		/**
+		 * @brief Color the next render() starts from.
+		 */
+		void clear(sf::Color color) noexcept { m_clearColor = color; }
+
+		void fillRect(const sf::FloatRect& rect, sf::Color color);
+		void fillCircle(sf::Vector2f center, float radius, sf::Color color);
+
+		/**
+		 * @brief A convex quad, its corners in order around it (either direction).
+		 */
+		void fillQuad(const std::array<sf::Vector2f, 4U>& corners, sf::Color color);
+
+		/**
+		 * @brief Draws image through transform, which maps its pixel coordinates to the world.
+		 *
+		 * The image is sampled nearest-texel and blended by its own alpha.
+		 * MISRA: only the address is kept; image must outlive the next render().
+		 */
+		void drawSprite(const SoftImage& image, const sf::Transform& transform);
+
+		/**
+		 * @brief Clears the image, rasterizes the queued primitives on pool and empties the queue.
+		 */
+		void render(sim::ThreadPool& pool);
+
+		[[nodiscard]] const SoftImage& image() const noexcept { return m_image; }
+		[[nodiscard]] std::size_t queuedCount() const noexcept { return m_primitives.size(); }
+
+	private:
+		enum class Shape : std::uint8_t {
+			Rect,
+			Circle,
+			Quad,
+			Sprite
+		};
+
+		// In image pixels; bounds are clipped to the image, max exclusive
+		struct Primitive {
+			Shape shape = Shape::Rect;
+			sf::Color color;
+			std::int32_t minX = 0;
+			std::int32_t minY = 0;
+			std::int32_t maxX = 0;
+			std::int32_t maxY = 0;
+			std::array<sf::Vector2f, 4U> points{}; // circle: center, (radius, 0); quad and sprite: corners
+			sf::Transform texelFromPixel;          // sprite only
+			const SoftImage* image = nullptr;      // sprite only
+		};
+
+		// Queues primitive if its bounds cover a pixel center of the image
+		void push(Primitive& primitive, float minX, float minY, float maxX, float maxY);
+		void pushQuad(Shape shape, const std::array<sf::Vector2f, 4U>& corners, sf::Color color, const SoftImage* image,
+			const sf::Transform& texelFromPixel);
+		void rasterizeTile(std::size_t tile);
+
+		SoftImage m_image;
+		std::uint32_t m_tilesX = 0U;
+		std::uint32_t m_tilesY = 0U;
+		sf::Transform m_pixelFromWorld;
+		float m_scale = 1.0F; // image pixels per world unit
+		sf::Color m_clearColor = sf::Color::Black;
+		std::vector<Primitive> m_primitives;
+		std::vector<std::vector<std::uint32_t>> m_bins; // per tile, primitive indices in submission order
+	};
+
+} // namespace gfx
@@ -0,0 +1,87 @@
+#include "SpriteBatch.hpp"
+
+namespace gfx {
+
+	void SpriteBatch::clear() {
+		m_vertices.clear();
+		m_runs.clear();
+	}
+
+	void SpriteBatch::addQuad(std::size_t page, const sf::Vector2f (&corners)[4], const sf::FloatRect& texRect, sf::Color color) {
+		if (m_runs.empty() || m_runs.back().page != page) {
+			m_runs.push_back({ page, m_vertices.size(), 0U });
+		}
+		m_runs.back().count += 6U;
+
+		const sf::Vector2f t0 = texRect.position;
+		const sf::Vector2f t1 = texRect.position + sf::Vector2f{ texRect.size.x, 0.0F };
+		const sf::Vector2f t2 = texRect.position + texRect.size;
+		const sf::Vector2f t3 = texRect.position + sf::Vector2f{ 0.0F, texRect.size.y };
+
+		m_vertices.push_back({ corners[0], color, t0 });
+		m_vertices.push_back({ corners[1], color, t1 });
+		m_vertices.push_back({ corners[2], color, t2 });
+		m_vertices.push_back({ corners[0], color, t0 });
+		m_vertices.push_back({ corners[2], color, t2 });
+		m_vertices.push_back({ corners[3], color, t3 });
+	}
+
+	void SpriteBatch::addSprite(const AtlasRegion& region, const sf::Transform& transform, sf::Color color) {
+		const sf::Vector2f size(region.rect.size);
+		const sf::Vector2f corners[4] = {
+			transform.transformPoint({ 0.0F, 0.0F }),
+			transform.transformPoint({ size.x, 0.0F }),
+			transform.transformPoint(size),
+			transform.transformPoint({ 0.0F, size.y })
+		};
+		addQuad(region.page, corners, sf::FloatRect(region.rect), color);
+	}
+
+	void SpriteBatch::addRect(const sf::FloatRect& rect, sf::Color color) {
+		const AtlasRegion* white = m_atlas.region(WHITE_REGION);
+		if (white == nullptr) {
+			return;
+		}
+		const sf::Vector2f corners[4] = {
+			rect.position,
+			rect.position + sf::Vector2f{ rect.size.x, 0.0F },
+			rect.position + rect.size,
+			rect.position + sf::Vector2f{ 0.0F, rect.size.y }
+		};
+		addQuad(white->page, corners, sf::FloatRect(white->rect), color);
+	}
+
+	void SpriteBatch::addBox(const sf::Transform& transform, const sf::Vector2f& halfExtent, sf::Color color) {
+		const AtlasRegion* white = m_atlas.region(WHITE_REGION);
+		if (white == nullptr) {
+			return;
+		}
+		const sf::Vector2f corners[4] = {
+			transform.transformPoint(-halfExtent),
+			transform.transformPoint({ halfExtent.x, -halfExtent.y }),
+			transform.transformPoint(halfExtent),
+			transform.transformPoint({ -halfExtent.x, halfExtent.y })
+		};
+		addQuad(white->page, corners, sf::FloatRect(white->rect), color);
+	}
+
+	void SpriteBatch::addOutline(const sf::FloatRect& rect, float thickness, sf::Color color) {
+		const sf::Vector2f outer = rect.position - sf::Vector2f{ thickness, thickness };
+		const float outerWidth = rect.size.x + 2.0F * thickness;
+		addRect({ outer, { outerWidth, thickness } }, color);                                       // top
+		addRect({ { outer.x, rect.position.y + rect.size.y }, { outerWidth, thickness } }, color); // bottom
+		addRect({ { outer.x, rect.position.y }, { thickness, rect.size.y } }, color);               // left
+		addRect({ { rect.position.x + rect.size.x, rect.position.y }, { thickness, rect.size.y } }, color); // right
+	}
+
+	void SpriteBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		for (const Run& run : m_runs) {
+			if (run.page >= m_atlas.pageCount()) {
+				continue;
+			}
+			states.texture = &m_atlas.page(run.page);
+			target.draw(&m_vertices[run.first], run.count, sf::PrimitiveType::Triangles, states);
+		}
+	}
+
+} // namespace gfx
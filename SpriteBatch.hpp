@@ -0,0 +1,80 @@
+/*
+==============================================================================
+Sprite Batch - a frame's atlas quads in as few draw calls as possible
+==============================================================================
+ - Sprites and solid shapes are appended as textured quads in draw order;
+   consecutive quads on the same atlas page share one draw call, so a scene
+   packed into one page costs a single draw
+ - Solid rectangles and outlines sample the atlas white region, so they do
+   not break the batch of the sprites on that page
+ - Rebuilt every frame on the CPU; a handful of quads is far cheaper than
+   one texture switch and draw call per sprite
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "TextureAtlas.hpp"
+
+namespace gfx {
+
+	class SpriteBatch : public sf::Drawable {
+	public:
+		explicit SpriteBatch(const TextureAtlas& atlas) : m_atlas(atlas) {}
+
+		/**
+		 * @brief Drops the quads of the previous frame.
+		 */
+		void clear();
+
+		/**
+		 * @brief Adds a sprite of the region's size, placed by transform like an sf::Sprite.
+		 */
+		void addSprite(const AtlasRegion& region, const sf::Transform& transform, sf::Color color = sf::Color::White);
+
+		/**
+		 * @brief Adds a solid rectangle in world space (needs the atlas white region).
+		 */
+		void addRect(const sf::FloatRect& rect, sf::Color color);
+
+		/**
+		 * @brief Adds a solid box of halfExtent around the local origin, placed by transform
+		 *        (a towed trailer body; needs the atlas white region).
+		 */
+		void addBox(const sf::Transform& transform, const sf::Vector2f& halfExtent, sf::Color color);
+
+		/**
+		 * @brief Adds a frame of the given thickness drawn just outside rect,
+		 *        like the outline of an sf::RectangleShape.
+		 */
+		void addOutline(const sf::FloatRect& rect, float thickness, sf::Color color);
+
+		[[nodiscard]] std::size_t quadCount() const noexcept { return m_vertices.size() / 6U; }
+
+		/**
+		 * @brief Draw calls the batch will issue (one per run of same-page quads).
+		 */
+		[[nodiscard]] std::size_t drawCount() const noexcept { return m_runs.size(); }
+
+	private:
+		void addQuad(std::size_t page, const sf::Vector2f (&corners)[4], const sf::FloatRect& texRect, sf::Color color);
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		// Consecutive vertices that sample the same page
+		struct Run {
+			std::size_t page;
+			std::size_t first;
+			std::size_t count;
+		};
+
+		const TextureAtlas& m_atlas;
+		std::vector<sf::Vertex> m_vertices; // triangle list in draw order
+		std::vector<Run> m_runs;
+	};
+
+} // namespace gfx
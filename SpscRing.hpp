@@ -0,0 +1,73 @@
+/*
+==============================================================================
+SPSC Ring - bounded lock-free queue for one producer and one consumer thread
+==============================================================================
+ - Fixed capacity (power of two), no allocation after construction
+ - Head and tail live on separate cache lines so the two threads do not
+   invalidate each other's index on every push/pop
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace sim {
+
+	template <typename T, std::size_t Capacity>
+	class SpscRing {
+		static_assert(Capacity >= 2U && (Capacity & (Capacity - 1U)) == 0U,
+			"SpscRing capacity must be a power of two");
+		static_assert(std::is_trivially_copyable_v<T>, "SpscRing stores trivially copyable values");
+
+	public:
+		/**
+		 * @brief Producer side; returns false (value dropped) if the ring is full.
+		 */
+		[[nodiscard]] bool tryPush(const T& value) noexcept {
+			const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+			if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+				return false;
+			}
+			m_slots[tail & MASK] = value;
+			m_tail.store(tail + 1U, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Consumer side; returns false if the ring is empty.
+		 */
+		[[nodiscard]] bool tryPop(T& value) noexcept {
+			const std::size_t head = m_head.load(std::memory_order_relaxed);
+			if (head == m_tail.load(std::memory_order_acquire)) {
+				return false;
+			}
+			value = m_slots[head & MASK];
+			m_head.store(head + 1U, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Consumer side; pops everything queued and keeps only the newest value.
+		 */
+		[[nodiscard]] bool popLatest(T& value) noexcept {
+			bool any = false;
+			while (tryPop(value)) {
+				any = true;
+			}
+			return any;
+		}
+
+	private:
+		static constexpr std::size_t MASK = Capacity - 1U;
+		static constexpr std::size_t CACHE_LINE = 64U;
+
+		alignas(CACHE_LINE) std::atomic<std::size_t> m_head{ 0U }; // written by the consumer
+		alignas(CACHE_LINE) std::atomic<std::size_t> m_tail{ 0U }; // written by the producer
+		alignas(CACHE_LINE) std::array<T, Capacity> m_slots{};
+	};
+
+} // namespace sim
@@ -0,0 +1,85 @@
+#include "StartupReport.hpp"
+
+#include <cstdio>
+
+#include "Log.hpp"
+
+namespace prof {
+
+	namespace {
+		[[nodiscard]] double nsToMs(std::int64_t ns) noexcept {
+			return static_cast<double>(ns) / 1.0e6;
+		}
+	}
+
+	const char* startupPhaseName(StartupPhase phase) {
+		switch (phase) {
+		case StartupPhase::Scene: return "scene";
+		case StartupPhase::Window: return "window";
+		case StartupPhase::ObstacleSetup: return "obstacle setup";
+		case StartupPhase::FirstFrame: return "first frame";
+		case StartupPhase::TextureDecode: return "texture decode";
+		case StartupPhase::AudioOpen: return "audio device open";
+		default: return "?";
+		}
+	}
+
+	StartupReport::StartupReport() noexcept
+		: m_origin(Clock::now())
+	{
+		for (std::atomic<std::int64_t>& duration : m_durationNs) {
+			duration.store(UNRECORDED, std::memory_order_relaxed);
+		}
+	}
+
+	void StartupReport::record(StartupPhase phase, Clock::time_point start) noexcept {
+		const Clock::time_point now = Clock::now();
+		const std::size_t i = static_cast<std::size_t>(phase);
+		const std::int64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_origin).count();
+		const std::int64_t durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+
+		m_startNs[i].store(startNs);
+		std::int64_t expected = UNRECORDED;
+		if (!m_durationNs[i].compare_exchange_strong(expected, durationNs)) {
+			return;
+		}
+		// Missed the first-frame line: report it alone
+		if (m_reported.load()) {
+			OKPP_LOG_INFO("Startup: %s %.1f ms (done at %.1f ms)", startupPhaseName(phase), nsToMs(durationNs),
+				nsToMs(startNs + durationNs));
+		}
+	}
+
+	void StartupReport::firstFrameShown() noexcept {
+		if (m_reported.load(std::memory_order_relaxed)) {
+			return;
+		}
+		record(StartupPhase::FirstFrame, m_origin);
+		if (m_reported.exchange(true)) {
+			return;
+		}
+
+		char line[256];
+		int length = std::snprintf(line, sizeof(line), "Startup:");
+		for (std::size_t i = 0U; i < STARTUP_PHASE_COUNT; ++i) {
+			const std::int64_t durationNs = m_durationNs[i].load();
+			const auto phase = static_cast<StartupPhase>(i);
+			if (durationNs == UNRECORDED || phase == StartupPhase::FirstFrame
+				|| length < 0 || static_cast<std::size_t>(length) >= sizeof(line))
+			{
+				continue;
+			}
+			length += std::snprintf(line + length, sizeof(line) - static_cast<std::size_t>(length), " %s %.1f ms,",
+				startupPhaseName(phase), nsToMs(durationNs));
+		}
+		const double firstFrameMs = nsToMs(m_durationNs[static_cast<std::size_t>(StartupPhase::FirstFrame)].load());
+		OKPP_LOG_INFO("%s first frame at %.1f ms", line, firstFrameMs);
+
+		const double budgetMs = static_cast<double>(FIRST_FRAME_BUDGET.count());
+		if (firstFrameMs > budgetMs) {
+			OKPP_LOG_WARNING("Warning: the first frame took %.1f ms, over the %.0f ms start-up budget", firstFrameMs,
+				budgetMs);
+		}
+	}
+
+} // namespace prof
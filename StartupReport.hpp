@@ -0,0 +1,80 @@
+/*
+==============================================================================
+Startup Report - how long each start-up phase took before the first frame
+==============================================================================
+ - The report's origin is taken at the top of main(); each phase records
+   when it started and the report stores its start offset and duration
+ - Phases done by the first frame are logged as one line once it has been
+   shown, with a warning when it missed FIRST_FRAME_BUDGET
+ - Phases that finish later (texture decodes still arriving, the audio
+   device opened at the first beep) are logged on their own as they end
+ - record() is lock-free and safe from any thread; each phase counts once
+ - No SFML dependency; timings come from std::chrono::steady_clock
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace prof {
+
+	enum class StartupPhase : std::uint8_t {
+		Scene,         // scenario, profiles and the first streamed tiles
+		Window,        // window and GL context creation
+		ObstacleSetup, // grids, collision world, renderers and baked fields
+		FirstFrame,    // from the origin until the first frame was displayed
+		TextureDecode, // sprite decode and atlas upload
+		AudioOpen,     // audio device and beep voices, at the first beep
+		Count
+	};
+
+	constexpr std::size_t STARTUP_PHASE_COUNT = static_cast<std::size_t>(StartupPhase::Count);
+
+	/**
+	 * @brief Lower-case label of a start-up phase, as it appears in the report.
+	 */
+	[[nodiscard]] const char* startupPhaseName(StartupPhase phase);
+
+	class StartupReport {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// Kiosk units must show the first frame within this
+		static constexpr std::chrono::milliseconds FIRST_FRAME_BUDGET{ 200 };
+
+		StartupReport() noexcept;
+
+		StartupReport(const StartupReport&) = delete;
+		StartupReport& operator=(const StartupReport&) = delete;
+
+		[[nodiscard]] Clock::time_point origin() const noexcept { return m_origin; }
+
+		/**
+		 * @brief Records phase as running from start until now; later records of it are ignored.
+		 *
+		 * After the first frame has been reported the phase is logged on its own.
+		 */
+		void record(StartupPhase phase, Clock::time_point start) noexcept;
+
+		/**
+		 * @brief Records FirstFrame and logs every phase so far; only the first call does anything.
+		 *
+		 * Cheap enough to call after every display().
+		 */
+		void firstFrameShown() noexcept;
+
+	private:
+		static constexpr std::int64_t UNRECORDED = -1;
+
+		Clock::time_point m_origin;
+		std::array<std::atomic<std::int64_t>, STARTUP_PHASE_COUNT> m_startNs{}; // offset from m_origin
+		std::array<std::atomic<std::int64_t>, STARTUP_PHASE_COUNT> m_durationNs{}; // UNRECORDED until recorded
+		std::atomic<bool> m_reported{ false };
+	};
+
+} // namespace prof
@@ -0,0 +1,62 @@
+/*
+==============================================================================
+Static Arena - bump allocation out of a block of fixed size inside the object
+==============================================================================
+ - The FrameArena counterpart for targets without a heap: the block is a
+   member array, so an arena in static storage is sized at link time and
+   never grows
+ - allocate() returns null when the block is used up, instead of spilling
+   into the heap; callers size the block for their worst case and treat
+   null as a configuration error
+ - reset() releases everything at once; nothing is ever destroyed, so only
+   trivially destructible types are handed out
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace sim {
+
+	template <std::size_t Bytes>
+	class StaticArena {
+		static_assert(Bytes > 0U, "StaticArena needs a block");
+
+	public:
+		static constexpr std::size_t CAPACITY = Bytes;
+
+		StaticArena() = default;
+
+		StaticArena(const StaticArena&) = delete;
+		StaticArena& operator=(const StaticArena&) = delete;
+
+		/**
+		 * @brief Uninitialized room for count values of T, or null when the block cannot hold them.
+		 */
+		template <typename T>
+		[[nodiscard]] T* allocate(std::size_t count) noexcept {
+			static_assert(std::is_trivially_destructible_v<T>, "StaticArena never runs destructors");
+			static_assert(alignof(T) <= alignof(std::max_align_t), "StaticArena blocks are max_align_t aligned");
+			const std::size_t start = (m_used + alignof(T) - 1U) & ~(alignof(T) - 1U);
+			if (start > Bytes || count > (Bytes - start) / sizeof(T)) {
+				return nullptr;
+			}
+			m_used = start + count * sizeof(T);
+			return reinterpret_cast<T*>(m_block + start);
+		}
+
+		/**
+		 * @brief Releases everything allocated so far.
+		 */
+		void reset() noexcept { m_used = 0U; }
+
+		[[nodiscard]] std::size_t used() const noexcept { return m_used; }
+
+	private:
+		alignas(std::max_align_t) unsigned char m_block[Bytes];
+		std::size_t m_used = 0U;
+	};
+
+} // namespace sim
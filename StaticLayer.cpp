@@ -0,0 +1,90 @@
+#include "StaticLayer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace gfx {
+
+	bool StaticLayer::create(const sf::Vector2u& viewSize, unsigned margin) {
+		const sf::Vector2u size{ viewSize.x + 2U * margin, viewSize.y + 2U * margin };
+		sf::RenderTexture texture;
+		if (!texture.resize(size)) {
+			std::cerr << "Error: Failed to create a " << size.x << 'x' << size.y
+				<< " static layer, drawing the scene directly\n";
+			m_texture.reset();
+			m_videoCharge.set(0U);
+			return false;
+		}
+		m_texture.emplace(std::move(texture));
+		m_videoCharge.set(prof::rgbaTextureBytes(size.x, size.y));
+		m_margin = static_cast<float>(margin);
+		m_dirty = true;
+		return true;
+	}
+
+	void StaticLayer::invalidate(const sf::FloatRect& area) {
+		if (!m_dirtyArea) {
+			m_dirtyArea = area;
+			return;
+		}
+		const sf::Vector2f low{ std::min(m_dirtyArea->position.x, area.position.x), std::min(m_dirtyArea->position.y, area.position.y) };
+		const sf::Vector2f high{ std::max(m_dirtyArea->position.x + m_dirtyArea->size.x, area.position.x + area.size.x),
+			std::max(m_dirtyArea->position.y + m_dirtyArea->size.y, area.position.y + area.size.y) };
+		m_dirtyArea = sf::FloatRect{ low, high - low };
+	}
+
+	bool StaticLayer::update(const sf::View& view, const DrawFn& drawStatic) {
+		if (!m_texture) {
+			return false;
+		}
+
+		const sf::FloatRect visible{ view.getCenter() - view.getSize() / 2.0F, view.getSize() };
+		const bool covered = visible.position.x >= m_region.position.x
+			&& visible.position.y >= m_region.position.y
+			&& visible.position.x + visible.size.x <= m_region.position.x + m_region.size.x
+			&& visible.position.y + visible.size.y <= m_region.position.y + m_region.size.y;
+		const sf::Vector2f textureSize(m_texture->getSize());
+		if (!m_dirty && covered) {
+			const std::optional<sf::FloatRect> stale = m_dirtyArea ? m_dirtyArea->findIntersection(m_region) : std::nullopt;
+			m_dirtyArea.reset();
+			if (!stale) {
+				return false;
+			}
+			// Whole texels around the stale part, as a share of the texture
+			const sf::Vector2f low{ std::floor(stale->position.x - m_region.position.x),
+				std::floor(stale->position.y - m_region.position.y) };
+			const sf::Vector2f high{ std::ceil(stale->position.x + stale->size.x - m_region.position.x),
+				std::ceil(stale->position.y + stale->size.y - m_region.position.y) };
+			sf::View partial(m_region);
+			partial.setScissor({ { low.x / textureSize.x, low.y / textureSize.y },
+				{ (high.x - low.x) / textureSize.x, (high.y - low.y) / textureSize.y } });
+			m_texture->setView(partial);
+			drawStatic(*m_texture);
+			m_texture->display();
+			++m_redraws;
+			return true;
+		}
+
+		// Whole-pixel origin, so the cached pixels map 1:1 onto the window
+		m_region = { { std::floor(visible.position.x - m_margin), std::floor(visible.position.y - m_margin) }, textureSize };
+		m_texture->setView(sf::View(m_region));
+		drawStatic(*m_texture);
+		m_texture->display();
+
+		m_dirty = false;
+		m_dirtyArea.reset();
+		++m_redraws;
+		return true;
+	}
+
+	void StaticLayer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+		if (!m_texture) {
+			return;
+		}
+		sf::Sprite sprite(m_texture->getTexture());
+		sprite.setPosition(m_region.position);
+		target.draw(sprite, states);
+	}
+
+} // namespace gfx
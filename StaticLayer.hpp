@@ -0,0 +1,73 @@
+/*
+==============================================================================
+Static Layer - the unchanging part of the scene cached in a render texture
+==============================================================================
+ - Background, pillars and bay outlines are drawn into an off-screen
+   texture that covers the camera view plus a margin on every side
+ - Each frame then costs one textured quad for all of it; only the dynamic
+   items (car, sensors, indicator colours) are drawn on top
+ - The cache is redrawn when invalidate() marks the static content dirty
+   (obstacles or bays changed) or when the camera leaves the cached region
+ - An edit marks just the area it touched; only that part of the texture
+   is cleared and drawn again, under a scissor, so dragging a pillar does
+   not redraw the whole view
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+#include "MemoryAccounting.hpp"
+
+namespace gfx {
+
+	class StaticLayer : public sf::Drawable {
+	public:
+		using DrawFn = std::function<void(sf::RenderTarget& target)>;
+
+		/**
+		 * @brief Creates the cache for views of viewSize with margin pixels around them.
+		 *
+		 * Requires an active GL context. Returns false (and logs) if the
+		 * render texture cannot be created; the caller then draws directly.
+		 */
+		[[nodiscard]] bool create(const sf::Vector2u& viewSize, unsigned margin);
+
+		/**
+		 * @brief Marks the cached content as stale (the obstacles or bays changed).
+		 */
+		void invalidate() noexcept { m_dirty = true; }
+
+		/**
+		 * @brief Marks only area (world coordinates) as stale; marked areas add up until the next update().
+		 */
+		void invalidate(const sf::FloatRect& area);
+
+		/**
+		 * @brief Redraws the cache through drawStatic if it is dirty or no longer
+		 *        covers view; returns true if it was redrawn.
+		 *
+		 * drawStatic draws in world coordinates; the layer sets up the view.
+		 */
+		bool update(const sf::View& view, const DrawFn& drawStatic);
+
+		[[nodiscard]] std::size_t redrawCount() const noexcept { return m_redraws; }
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+		std::optional<sf::RenderTexture> m_texture;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Video };
+		sf::FloatRect m_region;   // world area held by the texture
+		float m_margin = 0.0F;
+		bool m_dirty = true;
+		std::optional<sf::FloatRect> m_dirtyArea; // stale part when not all of it is dirty
+		std::size_t m_redraws = 0U;
+	};
+
+} // namespace gfx
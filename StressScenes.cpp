@@ -0,0 +1,225 @@
+#include "StressScenes.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "Constants.hpp"
+#include "Scene.hpp"
+
+namespace sim {
+
+	namespace {
+		// Beyond this a layout no longer fits the 32-bit obstacle indices comfortably
+		constexpr std::size_t STRESS_MAX_PILLARS = 10'000'000U;
+		constexpr float STRESS_CORRIDOR_LENGTH = 10.0F * constants::WORLD_WIDTH;
+		constexpr std::uint64_t STRESS_RANDOM_SEED = 0x5EED5CE7E5ULL;
+		// The car starts here, heading along +x, with every pillar at least this far from it
+		constexpr float STRESS_SPAWN_X = 250.0F;
+		constexpr float STRESS_LOT_START = 700.0F; // first pillar or bay column
+
+		struct StressLayout {
+			const char* name;
+			unsigned long size;
+			float spacing;
+			bool passage; // spacing is a gap the car drives through, not just a density
+		};
+
+		constexpr StressLayout STRESS_LAYOUTS[] = {
+			{ "pillar-grid", 10U, 300.0F, true },
+			{ "random", 100000U, 60.0F, false },
+			{ "corridors", 8U, 400.0F, true },
+			{ "dense-bays", 10U, 420.0F, true },
+		};
+
+		// splitmix64: small, fast and identical on every platform
+		class StressRandom {
+		public:
+			explicit StressRandom(std::uint64_t seed) noexcept : m_state(seed) {}
+
+			[[nodiscard]] float unit() noexcept {
+				m_state += 0x9E3779B97F4A7C15ULL;
+				std::uint64_t z = m_state;
+				z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+				z ^= z >> 31U;
+				return static_cast<float>(z >> 40U) * (1.0F / 16777216.0F); // 24 bits: exact in float
+			}
+
+		private:
+			std::uint64_t m_state;
+		};
+
+		[[nodiscard]] sf::FloatRect bayAt(float left, float top) {
+			return { { left, top }, { constants::PARK_WIDTH, constants::PARK_HEIGHT } };
+		}
+
+		// center lies inside rect grown by margin on every side
+		[[nodiscard]] bool nearRect(const sf::Vector2f& center, const sf::FloatRect& rect, float margin) {
+			return center.x > rect.position.x - margin && center.x < rect.position.x + rect.size.x + margin
+				&& center.y > rect.position.y - margin && center.y < rect.position.y + rect.size.y + margin;
+		}
+
+		void buildPillarGrid(Scene& scene, unsigned long size, float spacing) {
+			const float top = spacing * 0.5F;
+			scene.spawns.push_back({ { STRESS_SPAWN_X, top }, 0.0F });
+			scene.obstacles.reserve(size * size);
+			for (unsigned long row = 0U; row < size; ++row) {
+				for (unsigned long column = 0U; column < size; ++column) {
+					scene.obstacles.push_back({ { STRESS_LOT_START + static_cast<float>(column) * spacing,
+						top + static_cast<float>(row) * spacing }, constants::OBSTACLE_RADIUS });
+				}
+			}
+			scene.parkBays.push_back(bayAt(STRESS_LOT_START + static_cast<float>(size) * spacing, constants::PARK_MARGIN));
+		}
+
+		void buildRandom(Scene& scene, unsigned long size, float spacing) {
+			// One pillar per spacing^2 on average, over a square lot
+			const float side = std::max(std::sqrt(static_cast<float>(size)) * spacing, 2.0F * STRESS_LOT_START);
+			const sf::Vector2f spawn{ STRESS_SPAWN_X, STRESS_SPAWN_X };
+			scene.spawns.push_back({ spawn, 0.0F });
+			scene.parkBays.push_back(bayAt(side - constants::PARK_WIDTH - constants::PARK_MARGIN, constants::PARK_MARGIN));
+			const sf::FloatRect clear{ spawn - scene.carHalfExtent * 2.0F, scene.carHalfExtent * 4.0F };
+
+			StressRandom random(STRESS_RANDOM_SEED);
+			scene.obstacles.reserve(size);
+			while (scene.obstacles.size() < size) {
+				const sf::Vector2f center{ random.unit() * side, random.unit() * side };
+				if (nearRect(center, clear, constants::OBSTACLE_RADIUS)
+					|| nearRect(center, scene.parkBays.front(), constants::OBSTACLE_RADIUS))
+				{
+					continue; // redrawn: the spawn and the bay stay free
+				}
+				scene.obstacles.push_back({ center, constants::OBSTACLE_RADIUS });
+			}
+		}
+
+		void buildCorridors(Scene& scene, unsigned long size, float spacing) {
+			for (unsigned long wall = 0U; wall <= size; ++wall) {
+				const float y = static_cast<float>(wall) * spacing;
+				scene.walls.push_back({ { 0.0F, y }, { STRESS_CORRIDOR_LENGTH, y }, 0U });
+			}
+			// A pillar on alternate sides every few car lengths, so the sensors see more than walls
+			const float pitch = 8.0F * scene.carHalfExtent.x;
+			const float offset = spacing * 0.5F - constants::OBSTACLE_RADIUS; // touching the wall
+			for (unsigned long corridor = 0U; corridor < size; ++corridor) {
+				const float middle = (static_cast<float>(corridor) + 0.5F) * spacing;
+				bool above = (corridor % 2U) == 0U;
+				for (float x = STRESS_LOT_START + pitch; x < STRESS_CORRIDOR_LENGTH - pitch; x += pitch) {
+					scene.obstacles.push_back({ { x, above ? middle - offset : middle + offset }, constants::OBSTACLE_RADIUS });
+					above = !above;
+				}
+			}
+			scene.spawns.push_back({ { STRESS_SPAWN_X, spacing * 0.5F }, 0.0F });
+			scene.parkBays.push_back(bayAt(STRESS_CORRIDOR_LENGTH - constants::PARK_WIDTH - constants::PARK_MARGIN,
+				(spacing - constants::PARK_HEIGHT) * 0.5F));
+		}
+
+		void buildDenseBays(Scene& scene, unsigned long size, float spacing) {
+			// Bays side by side, a pillar in each gap at mid depth; an aisle above every row
+			const float gap = 2.0F * (constants::OBSTACLE_RADIUS + constants::PARK_MARGIN);
+			const float pitch = constants::PARK_WIDTH + gap;
+			const unsigned long perRow = 2U * size;
+			scene.spawns.push_back({ { STRESS_SPAWN_X, spacing * 0.5F }, 0.0F });
+			for (unsigned long row = 0U; row < size; ++row) {
+				const float top = spacing + static_cast<float>(row) * (constants::PARK_HEIGHT + spacing);
+				for (unsigned long bay = 0U; bay < perRow; ++bay) {
+					const float left = STRESS_LOT_START + static_cast<float>(bay) * pitch;
+					scene.parkBays.push_back(bayAt(left, top));
+					if (bay + 1U < perRow) {
+						scene.obstacles.push_back({ { left + constants::PARK_WIDTH + gap * 0.5F,
+							top + constants::PARK_HEIGHT * 0.5F }, constants::OBSTACLE_RADIUS });
+					}
+				}
+			}
+		}
+
+		// "12" or "12.5" with nothing after it
+		template <typename T, typename Parse>
+		[[nodiscard]] bool parseField(const std::string& text, Parse parse, T& value) {
+			char* end = nullptr;
+			const T parsed = static_cast<T>(parse(text.c_str(), &end));
+			if (text.empty() || end != text.c_str() + text.size()) {
+				return false;
+			}
+			value = parsed;
+			return true;
+		}
+	}
+
+	bool makeStressScene(const std::string& spec, Scene& scene) {
+		const std::size_t first = spec.find(':');
+		const std::size_t second = (first == std::string::npos) ? first : spec.find(':', first + 1U);
+		const std::string name = spec.substr(0U, first);
+
+		const StressLayout* layout = nullptr;
+		for (const StressLayout& known : STRESS_LAYOUTS) {
+			if (name == known.name) {
+				layout = &known;
+			}
+		}
+		if (layout == nullptr) {
+			std::cerr << "Error: no stress scene named " << name << " (" << stressSceneNames() << ")\n";
+			return false;
+		}
+
+		unsigned long size = layout->size;
+		float spacing = layout->spacing;
+		const auto parseSize = [](const char* text, char** end) { return std::strtoul(text, end, 10); };
+		const auto parseSpacing = [](const char* text, char** end) { return std::strtof(text, end); };
+		if ((first != std::string::npos && !parseField(spec.substr(first + 1U, second - first - 1U), parseSize, size))
+			|| (second != std::string::npos && !parseField(spec.substr(second + 1U), parseSpacing, spacing)))
+		{
+			std::cerr << "Error: stress scene " << spec << " is not name[:size[:spacing]]\n";
+			return false;
+		}
+
+		// The car has to fit between two walls or two rows of pillars; random pillars only must not all overlap
+		const float minSpacing = layout->passage ? 2.0F * (scene.carHalfExtent.y + constants::OBSTACLE_RADIUS)
+			: 2.0F * constants::OBSTACLE_RADIUS;
+		const double count = (name == "pillar-grid") ? static_cast<double>(size) * static_cast<double>(size)
+			: (name == "dense-bays") ? 2.0 * static_cast<double>(size) * static_cast<double>(size)
+			: static_cast<double>(size);
+		if (size == 0U || count > static_cast<double>(STRESS_MAX_PILLARS) || !(spacing >= minSpacing) || !std::isfinite(spacing)) {
+			std::cerr << "Error: stress scene " << spec << " needs a size of 1 to " << STRESS_MAX_PILLARS
+				<< " pillars and a spacing of at least " << minSpacing << " px\n";
+			return false;
+		}
+
+		Scene stress;
+		stress.carHalfExtent = scene.carHalfExtent;
+		if (name == "pillar-grid") {
+			buildPillarGrid(stress, size, spacing);
+		}
+		else if (name == "random") {
+			buildRandom(stress, size, spacing);
+		}
+		else if (name == "corridors") {
+			buildCorridors(stress, size, spacing);
+		}
+		else {
+			buildDenseBays(stress, size, spacing);
+		}
+		sortObstaclesAlongZCurve(stress.obstacles);
+		scene = std::move(stress);
+		return true;
+	}
+
+	std::string stressSceneNames() {
+		std::string names;
+		for (const StressLayout& layout : STRESS_LAYOUTS) {
+			names += names.empty() ? "" : ", ";
+			names += layout.name;
+		}
+		return names;
+	}
+
+} // namespace sim
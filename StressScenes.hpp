@@ -0,0 +1,42 @@
+/*
+==============================================================================
+Stress Scenes - built-in synthetic lots for comparing performance work
+==============================================================================
+ - Selected by spec, "name[:size[:spacing]]", with --stress in both
+   front-ends; size and spacing (px) default per scene:
+       pillar-grid   size x size pillars spacing apart (10, 300)
+       random        size pillars at random, one per spacing^2 of lot (100000, 60)
+       corridors     size corridors of long walls, spacing wide (8, 400)
+       dense-bays    size rows of 2 * size bays with pillars between
+                     them, aisles spacing wide (10, 420)
+ - A stress scene replaces the built-in scene's obstacles, bays, spawns,
+   walls and polygons and has no movers, as a scenario file would; its
+   pillars are stored in Z-order like loaded ones
+ - Layouts are fixed: random pillars come from a fixed seed, so a spec
+   names the same lot on every machine and every run
+ - Every scene keeps the car's spawn clear and has at least one bay
+==============================================================================
+*/
+
+#pragma once
+
+#include <string>
+
+#include "SimFwd.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief Replaces scene's layout with the stress scene named by spec.
+	 *
+	 * MISRA: an unknown name or a bad size or spacing leaves scene unchanged
+	 *        and returns false (logged with the known names).
+	 */
+	[[nodiscard]] bool makeStressScene(const std::string& spec, Scene& scene);
+
+	/**
+	 * @brief Known stress scene names, comma separated, for usage and error messages.
+	 */
+	[[nodiscard]] std::string stressSceneNames();
+
+} // namespace sim
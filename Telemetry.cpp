@@ -0,0 +1,212 @@
+#include "Telemetry.hpp"
+
+#include <SFML/Network.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include "Log.hpp"
+#include "MemoryAccounting.hpp"
+#include "Trace.hpp"
+
+namespace io {
+
+	namespace {
+		constexpr std::uint32_t MAGIC = 0x4F4B5054U; // "OKPT"
+		constexpr std::uint16_t VERSION = 4U;
+
+		// IPv4 + UDP headers leave 1472 bytes of a 1500-byte Ethernet MTU
+		constexpr std::size_t DATAGRAM_BYTES = 1472U;
+		constexpr std::size_t HEADER_BYTES = 12U + 1U + prof::MEMORY_SUBSYSTEM_COUNT * 8U;
+		constexpr std::size_t RECORD_BYTES = 4U + 3U * 4U + 2U + 1U + MAX_TELEMETRY_SENSORS * 4U + 4U + 3U * 4U + 2U * 4U;
+		constexpr std::uint16_t RECORDS_PER_DATAGRAM = (DATAGRAM_BYTES - HEADER_BYTES) / RECORD_BYTES;
+
+		constexpr std::chrono::milliseconds FLUSH_PERIOD{ 50 };
+		constexpr std::chrono::milliseconds IDLE_SLEEP{ 2 };
+
+		void appendRecord(sf::Packet& packet, const TelemetryRecord& record) {
+			packet << record.tick << record.x << record.y << record.headingDeg
+				<< record.occupiedBays << record.sensorCount;
+			for (const float distance : record.distances) {
+				packet << distance;
+			}
+			packet << record.beeps << record.lateBeeps << record.underruns << record.voiceSteals
+				<< record.lateP99Ms << record.fillMs;
+		}
+
+		[[nodiscard]] std::uint32_t toKib(std::int64_t bytes) noexcept {
+			return static_cast<std::uint32_t>(std::max<std::int64_t>(bytes, 0) / 1024);
+		}
+
+		void appendMemory(sf::Packet& packet, const prof::MemoryUsage& memory) {
+			packet << static_cast<std::uint8_t>(prof::MEMORY_SUBSYSTEM_COUNT);
+			for (std::size_t i = 0U; i < prof::MEMORY_SUBSYSTEM_COUNT; ++i) {
+				packet << toKib(memory.heap[i]) << toKib(memory.video[i]);
+			}
+		}
+	}
+
+	namespace {
+		[[nodiscard]] std::uint32_t telemetryBits(float value) noexcept {
+			std::uint32_t bits = 0U;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		[[nodiscard]] float telemetryFloat(std::uint32_t bits) noexcept {
+			float value = 0.0F;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+	}
+
+	void appendTelemetry(BlockLogWriter& log, const TelemetryRecord& record) noexcept {
+		std::uint32_t fields[TELEMETRY_LOG_FIELDS] = {};
+		std::uint32_t* out = fields;
+		*out++ = record.tick;
+		*out++ = telemetryBits(record.x);
+		*out++ = telemetryBits(record.y);
+		*out++ = telemetryBits(record.headingDeg);
+		*out++ = record.occupiedBays;
+		*out++ = record.sensorCount;
+		for (const float distance : record.distances) {
+			*out++ = telemetryBits(distance);
+		}
+		*out++ = record.beeps;
+		*out++ = record.lateBeeps;
+		*out++ = record.underruns;
+		*out++ = record.voiceSteals;
+		*out++ = telemetryBits(record.lateP99Ms);
+		*out = telemetryBits(record.fillMs);
+		log.append(fields);
+	}
+
+	bool readTelemetry(BlockLogReader& log, std::uint64_t index, TelemetryRecord& record) {
+		std::uint32_t fields[TELEMETRY_LOG_FIELDS] = {};
+		if (log.fields() != TELEMETRY_LOG_FIELDS || !log.read(index, fields)) {
+			return false;
+		}
+		const std::uint32_t* in = fields;
+		record.tick = *in++;
+		record.x = telemetryFloat(*in++);
+		record.y = telemetryFloat(*in++);
+		record.headingDeg = telemetryFloat(*in++);
+		record.occupiedBays = static_cast<std::uint16_t>(*in++);
+		record.sensorCount = static_cast<std::uint8_t>(*in++);
+		for (float& distance : record.distances) {
+			distance = telemetryFloat(*in++);
+		}
+		record.beeps = *in++;
+		record.lateBeeps = *in++;
+		record.underruns = *in++;
+		record.voiceSteals = *in++;
+		record.lateP99Ms = telemetryFloat(*in++);
+		record.fillMs = telemetryFloat(*in);
+		return true;
+	}
+
+	TelemetryPublisher::~TelemetryPublisher() {
+		stop();
+	}
+
+	bool TelemetryPublisher::start(const std::string& host, unsigned short port) {
+		if (m_thread.joinable()) {
+			return false;
+		}
+		const std::optional<sf::IpAddress> address = sf::IpAddress::resolve(host);
+		if (!address) {
+			OKPP_LOG_ERROR("Error: cannot resolve telemetry host %s", host.c_str());
+			return false;
+		}
+		m_stop.store(false, std::memory_order_relaxed);
+		m_thread = std::thread([this, target = *address, port]() { run(target, port); });
+		return true;
+	}
+
+	void TelemetryPublisher::stop() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		m_stop.store(true, std::memory_order_release);
+		m_thread.join();
+
+		const TelemetryStats totals = stats();
+		if (totals.dropped > 0U) {
+			OKPP_LOG_WARNING("Telemetry: sent %llu records in %llu datagrams, dropped %llu",
+				static_cast<unsigned long long>(totals.records), static_cast<unsigned long long>(totals.datagrams),
+				static_cast<unsigned long long>(totals.dropped));
+		}
+	}
+
+	void TelemetryPublisher::publish(const TelemetryRecord& record) noexcept {
+		if (!m_records.tryPush(record)) {
+			m_dropped.fetch_add(1U, std::memory_order_relaxed);
+		}
+	}
+
+	TelemetryStats TelemetryPublisher::stats() const noexcept {
+		return { m_sent.load(std::memory_order_relaxed), m_datagrams.load(std::memory_order_relaxed),
+			m_dropped.load(std::memory_order_relaxed) };
+	}
+
+	void TelemetryPublisher::run(sf::IpAddress address, unsigned short port) {
+		prof::setThreadName("telemetry");
+		sf::UdpSocket socket;
+		socket.setBlocking(false);
+
+		sf::Packet packet;
+		std::uint16_t batched = 0U;
+		std::uint32_t sequence = 0U;
+		auto batchStart = std::chrono::steady_clock::now();
+
+		const auto flush = [&]() {
+			if (batched == 0U) {
+				return;
+			}
+			OKPP_TRACE_SCOPE("telemetry send");
+			// The header goes in front of the records now that their count is known
+			sf::Packet datagram;
+			datagram << MAGIC << VERSION << batched << sequence++;
+			appendMemory(datagram, prof::memoryUsage());
+			datagram.append(packet.getData(), packet.getDataSize());
+			if (socket.send(datagram, address, port) == sf::Socket::Status::Done) {
+				m_sent.fetch_add(batched, std::memory_order_relaxed);
+				m_datagrams.fetch_add(1U, std::memory_order_relaxed);
+			}
+			else {
+				m_dropped.fetch_add(batched, std::memory_order_relaxed); // busy or unreachable: never wait
+			}
+			packet.clear();
+			batched = 0U;
+		};
+
+		TelemetryRecord record;
+		for (;;) {
+			const bool stopping = m_stop.load(std::memory_order_acquire);
+			bool any = false;
+			while (m_records.tryPop(record)) {
+				if (batched == 0U) {
+					batchStart = std::chrono::steady_clock::now();
+				}
+				appendRecord(packet, record);
+				any = true;
+				if (++batched == RECORDS_PER_DATAGRAM) {
+					flush();
+				}
+			}
+			if (stopping || std::chrono::steady_clock::now() - batchStart >= FLUSH_PERIOD) {
+				flush();
+			}
+			if (stopping) {
+				break;
+			}
+			if (!any) {
+				std::this_thread::sleep_for(IDLE_SLEEP);
+			}
+		}
+	}
+
+} // namespace io
@@ -0,0 +1,117 @@
+/*
+==============================================================================
+Telemetry - batched UDP export of sensor distances, car pose and occupancy
+==============================================================================
+ - The simulation thread only copies a fixed-size record into an SPSC
+   ring; a full ring drops the record, so the loop never waits on the
+   network
+ - A background sender packs records into sf::Packet datagrams that fit
+   one Ethernet MTU and sends them on a non-blocking socket; a datagram
+   the socket cannot take right away is dropped and counted
+ - Partially filled datagrams go out after FLUSH_PERIOD, so a slow loop
+   still streams at a steady latency
+ - Every datagram carries the memory counters (MemoryAccounting) as they
+   stood when it was packed, so a receiver can chart them next to the drive
+ - --telemetry-log keeps the same records in a block log (BlockLog.hpp,
+   kind BLOCK_LOG_TELEMETRY, TELEMETRY_LOG_FIELDS words per record, floats
+   by their bits), written on the simulation side as they are made
+ - Wire format (sf::Packet, network byte order):
+   datagram: magic u32 "OKPT" | version u16 (4) | records u16 | sequence u32 |
+             subsystems u8 | subsystems x (heap KiB u32, VRAM KiB u32)
+   record:   tick u32 | x, y, heading f32 | occupied bays u16 |
+             sensors u8 | MAX_TELEMETRY_SENSORS x distance f32 (-1 = none) |
+             beeps u32 (started since launch) | late beeps u32 | underruns u32 |
+             voice steals u32 | beep lateness p99 f32 (ms) | buffer fill f32 (ms)
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Network/IpAddress.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "BlockLog.hpp"
+#include "SpscRing.hpp"
+
+namespace io {
+
+	constexpr std::size_t MAX_TELEMETRY_SENSORS = 8U;
+
+	struct TelemetryRecord {
+		std::uint32_t tick = 0U;
+		float x = 0.0F;
+		float y = 0.0F;
+		float headingDeg = 0.0F;
+		std::uint16_t occupiedBays = 0U;
+		std::uint8_t sensorCount = 0U;
+		std::array<float, MAX_TELEMETRY_SENSORS> distances{}; // to the nearest obstacle, -1 = none in range
+		std::uint32_t beeps = 0U; // started by the beep scheduler so far
+		std::uint32_t lateBeeps = 0U;  // audio counters (AudioCounters) as of this record
+		std::uint32_t underruns = 0U;
+		std::uint32_t voiceSteals = 0U;
+		float lateP99Ms = 0.0F;
+		float fillMs = 0.0F;
+	};
+
+	// tick, pose, bays, sensor count | distances | beeps, audio counters
+	constexpr std::uint16_t TELEMETRY_LOG_FIELDS = 6U + MAX_TELEMETRY_SENSORS + 6U;
+
+	/**
+	 * @brief Appends record to a block log opened with BLOCK_LOG_TELEMETRY and TELEMETRY_LOG_FIELDS.
+	 */
+	void appendTelemetry(BlockLogWriter& log, const TelemetryRecord& record) noexcept;
+
+	/**
+	 * @brief Reads record index of a telemetry block log; false for a log of other records, or as BlockLogReader::read().
+	 */
+	[[nodiscard]] bool readTelemetry(BlockLogReader& log, std::uint64_t index, TelemetryRecord& record);
+
+	struct TelemetryStats {
+		std::uint64_t records = 0U;   // sent
+		std::uint64_t datagrams = 0U;
+		std::uint64_t dropped = 0U;   // records lost to a full ring or a busy socket
+	};
+
+	class TelemetryPublisher {
+	public:
+		TelemetryPublisher() = default;
+		~TelemetryPublisher();
+
+		TelemetryPublisher(const TelemetryPublisher&) = delete;
+		TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+		/**
+		 * @brief Starts the sender thread for host:port; false (logged) on a bad address.
+		 */
+		bool start(const std::string& host, unsigned short port);
+
+		/**
+		 * @brief Sends what is queued and stops the sender; safe to call twice.
+		 */
+		void stop();
+
+		/**
+		 * @brief Simulation side: queues one record, never blocks.
+		 */
+		void publish(const TelemetryRecord& record) noexcept;
+
+		[[nodiscard]] TelemetryStats stats() const noexcept;
+
+	private:
+		void run(sf::IpAddress address, unsigned short port);
+
+		sim::SpscRing<TelemetryRecord, 4096U> m_records;
+		std::atomic<bool> m_stop{ false };
+		std::atomic<std::uint64_t> m_sent{ 0U };
+		std::atomic<std::uint64_t> m_datagrams{ 0U };
+		std::atomic<std::uint64_t> m_dropped{ 0U };
+		std::thread m_thread;
+	};
+
+} // namespace io
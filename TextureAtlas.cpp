@@ -0,0 +1,210 @@
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+
+namespace gfx {
+
+	namespace {
+		constexpr unsigned PADDING = 2U;
+		constexpr unsigned MIP_PADDING = 8U; // still a texel apart three mip levels down
+		constexpr unsigned WHITE_SIZE = 4U; // sampled at its center, so filtering stays white
+
+		// Half the size (odd edges dropped, at least 1), each texel the alpha-weighted mean of a 2x2 block
+		[[nodiscard]] sf::Image halveImage(const sf::Image& source) {
+			const sf::Vector2u size = source.getSize();
+			const sf::Vector2u half{ std::max(size.x / 2U, 1U), std::max(size.y / 2U, 1U) };
+			std::vector<std::uint8_t> pixels(static_cast<std::size_t>(half.x) * half.y * 4U);
+			const std::uint8_t* src = source.getPixelsPtr();
+			for (unsigned y = 0U; y < half.y; ++y) {
+				for (unsigned x = 0U; x < half.x; ++x) {
+					std::uint32_t alpha = 0U;
+					std::array<std::uint32_t, 3> color{};
+					for (unsigned dy = 0U; dy < 2U; ++dy) {
+						for (unsigned dx = 0U; dx < 2U; ++dx) {
+							const unsigned sx = std::min(2U * x + dx, size.x - 1U);
+							const unsigned sy = std::min(2U * y + dy, size.y - 1U);
+							const std::uint8_t* texel = src + (static_cast<std::size_t>(sy) * size.x + sx) * 4U;
+							alpha += texel[3];
+							for (std::size_t c = 0U; c < 3U; ++c) {
+								color[c] += static_cast<std::uint32_t>(texel[c]) * texel[3];
+							}
+						}
+					}
+					// Weighted by alpha, so transparent texels do not darken the edges
+					std::uint8_t* dst = pixels.data() + (static_cast<std::size_t>(y) * half.x + x) * 4U;
+					for (std::size_t c = 0U; c < 3U; ++c) {
+						dst[c] = static_cast<std::uint8_t>((alpha != 0U) ? (color[c] + alpha / 2U) / alpha : 0U);
+					}
+					dst[3] = static_cast<std::uint8_t>((alpha + 2U) / 4U);
+				}
+			}
+			return sf::Image(half, pixels.data());
+		}
+	}
+
+	std::vector<AtlasPlacement> packShelves(const std::vector<sf::Vector2u>& sizes, unsigned pageSize, unsigned padding) {
+		std::vector<std::size_t> order(sizes.size());
+		std::iota(order.begin(), order.end(), 0U);
+		std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+			return sizes[a].y > sizes[b].y;
+		});
+
+		std::vector<AtlasPlacement> placements(sizes.size());
+		std::size_t page = 0U;
+		unsigned x = padding;
+		unsigned y = padding;
+		unsigned shelfHeight = 0U;
+		bool pageUsed = false;
+		std::vector<std::size_t> oversized; // placed on pages of their own after the shared ones
+
+		for (const std::size_t index : order) {
+			const sf::Vector2u size = sizes[index];
+			if (size.x + 2U * padding > pageSize || size.y + 2U * padding > pageSize) {
+				oversized.push_back(index);
+				continue;
+			}
+			if (x > padding && x + size.x + padding > pageSize) { // next shelf
+				x = padding;
+				y += shelfHeight + padding;
+				shelfHeight = 0U;
+			}
+			if (pageUsed && y + size.y + padding > pageSize) { // next page
+				++page;
+				x = padding;
+				y = padding;
+				shelfHeight = 0U;
+			}
+
+			placements[index] = { page, { x, y } };
+			pageUsed = true;
+			x += size.x + padding;
+			shelfHeight = std::max(shelfHeight, size.y);
+		}
+
+		for (const std::size_t index : oversized) {
+			page += pageUsed ? 1U : 0U;
+			placements[index] = { page, { padding, padding } };
+			pageUsed = true;
+		}
+		return placements;
+	}
+
+	bool TextureAtlas::build(const std::vector<Image>& images, const TextureOptions& options, unsigned pageSize) {
+		m_pages.clear();
+		m_regions.clear();
+		m_videoCharge.set(0U);
+		const unsigned padding = options.mipmap ? MIP_PADDING : PADDING;
+
+		// Minified images are packed at the level just above their display size
+		std::vector<const sf::Image*> packed;
+		std::vector<sf::Vector2f> scales;
+		std::vector<std::unique_ptr<sf::Image>> levels;
+		for (const auto& entry : images) {
+			const sf::Image* image = entry.image;
+			if (image == nullptr || image->getSize().x == 0U || image->getSize().y == 0U) {
+				continue;
+			}
+			const sf::Vector2u sourceSize = image->getSize();
+			float levelScale = 1.0F;
+			while (levelScale * 0.5F >= entry.displayScale && (image->getSize().x > 1U || image->getSize().y > 1U)) {
+				levels.push_back(std::make_unique<sf::Image>(halveImage(*image)));
+				image = levels.back().get();
+				levelScale *= 0.5F;
+			}
+			packed.push_back(image);
+			scales.push_back({ static_cast<float>(image->getSize().x) / static_cast<float>(sourceSize.x),
+				static_cast<float>(image->getSize().y) / static_cast<float>(sourceSize.y) });
+		}
+
+		std::vector<std::string> names{ WHITE_REGION };
+		std::vector<sf::Vector2u> sizes{ { WHITE_SIZE, WHITE_SIZE } };
+		for (std::size_t i = 0U, next = 0U; i < images.size(); ++i) {
+			const sf::Image* image = images[i].image;
+			if (image != nullptr && image->getSize().x > 0U && image->getSize().y > 0U) {
+				names.push_back(images[i].name);
+				sizes.push_back(packed[next++]->getSize());
+			}
+		}
+
+		const std::vector<AtlasPlacement> placements = packShelves(sizes, pageSize, padding);
+
+		// Pages are only as large as their content
+		std::vector<sf::Vector2u> extents;
+		for (std::size_t i = 0U; i < placements.size(); ++i) {
+			const AtlasPlacement& placement = placements[i];
+			if (placement.page >= extents.size()) {
+				extents.resize(placement.page + 1U, { 1U, 1U });
+			}
+			sf::Vector2u& extent = extents[placement.page];
+			extent.x = std::max(extent.x, placement.position.x + sizes[i].x + padding);
+			extent.y = std::max(extent.y, placement.position.y + sizes[i].y + padding);
+		}
+
+		std::vector<sf::Image> pageImages;
+		for (const auto& extent : extents) {
+			pageImages.emplace_back(extent, sf::Color::Transparent);
+		}
+
+		(void)pageImages[placements[0].page].copy(sf::Image({ WHITE_SIZE, WHITE_SIZE }, sf::Color::White),
+			placements[0].position);
+		for (std::size_t i = 0U; i < packed.size(); ++i) {
+			const AtlasPlacement& placement = placements[i + 1U];
+			if (!pageImages[placement.page].copy(*packed[i], placement.position)) {
+				std::cerr << "Warning: atlas image " << names[i + 1U] << " does not fit its page\n";
+			}
+		}
+
+		for (std::size_t i = 0U; i < placements.size(); ++i) {
+			m_regions[names[i]] = { placements[i].page,
+				sf::IntRect{ sf::Vector2i(placements[i].position), sf::Vector2i(sizes[i]) },
+				(i == 0U) ? sf::Vector2f{ 1.0F, 1.0F } : scales[i - 1U] };
+		}
+		// The rest of the white block is padding against bilinear bleed
+		AtlasRegion& white = m_regions[WHITE_REGION];
+		white.rect = { white.rect.position + sf::Vector2i{ 1, 1 }, { 2, 2 } };
+
+		std::size_t videoBytes = 0U;
+		for (const auto& image : pageImages) {
+			auto texture = std::make_unique<sf::Texture>();
+			if (!texture->loadFromImage(image, options.srgb)) {
+				std::cerr << "Error: Failed to upload a " << image.getSize().x << 'x' << image.getSize().y
+					<< " atlas page\n";
+				m_pages.clear();
+				m_regions.clear();
+				return false;
+			}
+			texture->setSmooth(options.smooth);
+			std::size_t bytes = prof::rgbaTextureBytes(image.getSize().x, image.getSize().y);
+			if (options.mipmap) {
+				if (texture->generateMipmap()) {
+					bytes += bytes / 3U; // the chain adds a third
+				}
+				else {
+					std::cerr << "Warning: no mipmaps for a " << image.getSize().x << 'x' << image.getSize().y
+						<< " atlas page\n";
+				}
+			}
+			videoBytes += bytes;
+			m_pages.push_back(std::move(texture));
+		}
+		m_videoCharge.set(videoBytes);
+		return true;
+	}
+
+	void TextureAtlas::addTexturePage(const std::string& name, sf::Texture&& texture, std::size_t videoBytes) {
+		const sf::Vector2i size(texture.getSize());
+		m_pages.push_back(std::make_unique<sf::Texture>(std::move(texture)));
+		m_videoCharge.set(m_videoCharge.bytes() + videoBytes);
+		m_regions[name] = { m_pages.size() - 1U, sf::IntRect{ { 0, 0 }, size } };
+	}
+
+	const AtlasRegion* TextureAtlas::region(const std::string& name) const {
+		const auto found = m_regions.find(name);
+		return (found != m_regions.end()) ? &found->second : nullptr;
+	}
+
+} // namespace gfx
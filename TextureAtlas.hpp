@@ -0,0 +1,103 @@
+/*
+==============================================================================
+Texture Atlas - sprite images packed into a few shared texture pages
+==============================================================================
+ - Shelf packer: images sorted by height fill rows left to right, a new
+   page is opened when one is full
+ - The atlas also packs a small white region, so untextured shapes
+   (indicators, outlines) batch with the sprites on its page
+ - Textures that already exist on the GPU (cooked, block-compressed ones)
+   join as a page of their own
+ - An image drawn minified is packed at the power-of-two level just above
+   its display size (2x2 box halvings on the CPU), so it costs no page space
+   or bandwidth for texels that are never seen; with TextureOptions::mipmap
+   the GPU then filters the rest of the way down from its own mip chain
+ - The pages' GPU memory is charged to the texture memory subsystem
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+
+namespace gfx {
+
+	// Name of the white region packed by TextureAtlas::build()
+	constexpr const char* WHITE_REGION = "white";
+
+	struct AtlasRegion {
+		std::size_t page = 0U;
+		sf::IntRect rect;              // pixels within the page
+		sf::Vector2f scale{ 1.0F, 1.0F }; // region pixels per source image pixel (< 1 when packed pre-scaled)
+	};
+
+	struct TextureOptions {
+		bool smooth = true;  // bilinear filtering
+		bool mipmap = false; // build a mip chain, so minified draws sample a right-sized level
+		bool srgb = false;   // texels are sRGB; needs an sRGB-capable window to look right
+	};
+
+	struct AtlasPlacement {
+		std::size_t page = 0U;
+		sf::Vector2u position;
+	};
+
+	/**
+	 * @brief Places rectangles of the given sizes on as few pageSize pages as possible.
+	 *
+	 * padding pixels are kept free around each rectangle against filtering
+	 * bleed. A size that cannot fit on an empty page gets a page of its own
+	 * sized to it (the caller may reject it).
+	 */
+	[[nodiscard]] std::vector<AtlasPlacement> packShelves(const std::vector<sf::Vector2u>& sizes,
+		unsigned pageSize, unsigned padding);
+
+	class TextureAtlas {
+	public:
+		struct Image {
+			std::string name;
+			const sf::Image* image = nullptr;
+			float displayScale = 1.0F; // scale the image is drawn at; below 0.5 it is packed pre-halved
+		};
+
+		/**
+		 * @brief Packs images into new pages, replacing the previous content.
+		 *
+		 * Requires an active GL context. Returns false (and logs) if a page
+		 * cannot be uploaded; the atlas is then left empty. A region's scale
+		 * tells the caller how much of its display scale was applied already.
+		 */
+		[[nodiscard]] bool build(const std::vector<Image>& images, const TextureOptions& options = {},
+			unsigned pageSize = 2048U);
+
+		/**
+		 * @brief Adds an uploaded texture as its own page with one full-size region.
+		 *
+		 * Used for cooked textures that are already on the GPU; videoBytes is
+		 * what the upload occupies there.
+		 */
+		void addTexturePage(const std::string& name, sf::Texture&& texture, std::size_t videoBytes);
+
+		/**
+		 * @brief Region registered under name, or null if the atlas does not hold it.
+		 */
+		[[nodiscard]] const AtlasRegion* region(const std::string& name) const;
+
+		[[nodiscard]] std::size_t pageCount() const noexcept { return m_pages.size(); }
+		[[nodiscard]] const sf::Texture& page(std::size_t index) const { return *m_pages[index]; }
+
+	private:
+		std::vector<std::unique_ptr<sf::Texture>> m_pages; // stable addresses for render states
+		std::unordered_map<std::string, AtlasRegion> m_regions;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::Textures, prof::MemoryKind::Video }; // all pages
+	};
+
+} // namespace gfx
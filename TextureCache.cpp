@@ -0,0 +1,121 @@
+#include "TextureCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace assets {
+
+	namespace {
+		// Bumped whenever the entry layout changes
+		constexpr char CACHE_MAGIC[8] = { 'O', 'K', 'R', 'G', 'B', 'A', '0', '1' };
+		constexpr std::size_t CACHE_HEADER_BYTES = sizeof(CACHE_MAGIC) + sizeof(std::uint64_t) + 2U * sizeof(std::uint32_t);
+		constexpr std::uint32_t CACHE_MAX_DIMENSION = 16384U;
+
+		constexpr std::uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+		constexpr std::uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+		[[nodiscard]] std::uint64_t readU64(const unsigned char* bytes) noexcept {
+			std::uint64_t value = 0U;
+			std::memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+
+		[[nodiscard]] std::uint32_t readU32(const unsigned char* bytes) noexcept {
+			std::uint32_t value = 0U;
+			std::memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+	}
+
+	std::uint64_t assetHash(const unsigned char* data, std::size_t size) noexcept {
+		std::uint64_t hash = FNV_OFFSET;
+		for (std::size_t i = 0U; i < size; ++i) {
+			hash = (hash ^ data[i]) * FNV_PRIME;
+		}
+		return hash;
+	}
+
+	std::string TextureCache::entryPath(std::uint64_t key) const {
+		char name[24];
+		(void)std::snprintf(name, sizeof(name), "%016llx.okrgba", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(m_directory) / name).string();
+	}
+
+	bool TextureCache::load(std::uint64_t key, CachedTexture& out) const {
+		if (!enabled()) {
+			return false;
+		}
+		const std::string path = entryPath(key);
+		std::error_code error;
+		if (!std::filesystem::is_regular_file(path, error) || !out.file.open(path)) {
+			m_misses.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+
+		const unsigned char* bytes = out.file.data();
+		const std::size_t size = out.file.size();
+		bool valid = size >= CACHE_HEADER_BYTES && std::memcmp(bytes, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0
+			&& readU64(bytes + sizeof(CACHE_MAGIC)) == key;
+		const std::uint32_t width = valid ? readU32(bytes + sizeof(CACHE_MAGIC) + sizeof(std::uint64_t)) : 0U;
+		const std::uint32_t height = valid ? readU32(bytes + sizeof(CACHE_MAGIC) + sizeof(std::uint64_t) + sizeof(std::uint32_t)) : 0U;
+		valid = valid && width > 0U && height > 0U && width <= CACHE_MAX_DIMENSION && height <= CACHE_MAX_DIMENSION
+			&& size == CACHE_HEADER_BYTES + static_cast<std::size_t>(width) * height * 4U;
+		if (!valid) {
+			std::cerr << "Warning: ignoring damaged texture cache entry " << path << '\n';
+			out.file.close();
+			m_misses.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+		out.size = { width, height };
+		out.pixels = bytes + CACHE_HEADER_BYTES;
+		m_hits.fetch_add(1U, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool TextureCache::store(std::uint64_t key, const sf::Vector2u& size, const std::uint8_t* pixels) const {
+		if (!enabled() || pixels == nullptr || size.x == 0U || size.y == 0U) {
+			return false;
+		}
+		std::error_code error;
+		std::filesystem::create_directories(m_directory, error);
+		const std::string path = entryPath(key);
+		// A name of this thread's own: two launches caching the same asset never write one file
+		const std::string temporary = path + '.' + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			const std::uint32_t width = size.x;
+			const std::uint32_t height = size.y;
+			file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+			file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+			file.write(reinterpret_cast<const char*>(&width), sizeof(width));
+			file.write(reinterpret_cast<const char*>(&height), sizeof(height));
+			file.write(reinterpret_cast<const char*>(pixels), static_cast<std::streamsize>(static_cast<std::size_t>(width) * height * 4U));
+			if (!file) {
+				std::cerr << "Warning: cannot write texture cache entry " << temporary << '\n';
+				file.close();
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+		}
+		std::filesystem::rename(temporary, path, error);
+		if (error) {
+			std::cerr << "Warning: cannot write texture cache entry " << path << ": " << error.message() << '\n';
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		m_stored.fetch_add(1U, std::memory_order_relaxed);
+		return true;
+	}
+
+	TextureCacheStats TextureCache::stats() const noexcept {
+		return { m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed),
+			m_stored.load(std::memory_order_relaxed) };
+	}
+
+} // namespace assets
@@ -0,0 +1,85 @@
+/*
+==============================================================================
+Texture Cache - decoded sprite pixels kept on disk between launches
+==============================================================================
+ - A PNG is decoded once: its RGBA8 pixels are written to the cache
+   directory under the hash of the PNG's bytes, and later launches map that
+   file and hand the pixels over, with no inflate and no unfiltering
+ - Keyed by content, not by path or time stamp: an edited asset gets an
+   entry of its own and the old one is simply never read again, so the
+   directory can be deleted at any time
+ - An entry is written to a temporary name and renamed into place, so a
+   reader never sees half a file, even with several launches at once
+ - Layout: magic "OKRGBA01" | key u64 | width u32 | height u32 | RGBA8
+   pixels, rows top down, tightly packed, host byte order (the cache never
+   leaves the machine that wrote it)
+ - Loads and stores only touch their own entry, so pool workers decoding
+   different images share one cache; no SFML graphics dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.hpp"
+
+namespace assets {
+
+	/**
+	 * @brief 64-bit FNV-1a of an asset's bytes, the cache key.
+	 */
+	[[nodiscard]] std::uint64_t assetHash(const unsigned char* data, std::size_t size) noexcept;
+
+	// One entry as loaded: pixels point into the mapping, valid while this lives
+	struct CachedTexture {
+		MappedFile file;
+		sf::Vector2u size{ 0U, 0U };
+		const std::uint8_t* pixels = nullptr;
+	};
+
+	struct TextureCacheStats {
+		std::uint64_t hits = 0U;
+		std::uint64_t misses = 0U;
+		std::uint64_t stored = 0U;
+	};
+
+	class TextureCache {
+	public:
+		/**
+		 * @brief Cache under directory (created on the first store); empty turns it off.
+		 */
+		explicit TextureCache(std::string directory = {}) : m_directory(std::move(directory)) {}
+
+		TextureCache(const TextureCache&) = delete;
+		TextureCache& operator=(const TextureCache&) = delete;
+
+		[[nodiscard]] bool enabled() const noexcept { return !m_directory.empty(); }
+
+		/**
+		 * @brief Maps the entry for key; false if there is none or it is damaged (counted as a miss).
+		 */
+		[[nodiscard]] bool load(std::uint64_t key, CachedTexture& out) const;
+
+		/**
+		 * @brief Writes RGBA8 pixels as the entry for key; false (logged) if it cannot be written.
+		 */
+		bool store(std::uint64_t key, const sf::Vector2u& size, const std::uint8_t* pixels) const;
+
+		[[nodiscard]] TextureCacheStats stats() const noexcept;
+
+	private:
+		[[nodiscard]] std::string entryPath(std::uint64_t key) const;
+
+		std::string m_directory;
+		mutable std::atomic<std::uint64_t> m_hits{ 0U };
+		mutable std::atomic<std::uint64_t> m_misses{ 0U };
+		mutable std::atomic<std::uint64_t> m_stored{ 0U };
+	};
+
+} // namespace assets
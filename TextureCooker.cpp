@@ -0,0 +1,344 @@
+#include "TextureCooker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace gfx {
+
+	namespace {
+		using Color = std::array<float, 3>;
+
+		struct BlockTexels {
+			std::array<Color, 16> color{};
+			std::array<std::uint8_t, 16> alpha{};
+		};
+
+		// Edge blocks repeat the last row/column so padding does not skew the fit
+		[[nodiscard]] BlockTexels gatherBlock(const std::vector<std::uint8_t>& pixels, const sf::Vector2u& size,
+			unsigned bx, unsigned by)
+		{
+			BlockTexels block;
+			for (unsigned i = 0U; i < 16U; ++i) {
+				const unsigned x = std::min(bx * 4U + i % 4U, size.x - 1U);
+				const unsigned y = std::min(by * 4U + i / 4U, size.y - 1U);
+				const std::uint8_t* texel = &pixels[(static_cast<std::size_t>(y) * size.x + x) * 4U];
+				block.color[i] = { static_cast<float>(texel[0]), static_cast<float>(texel[1]), static_cast<float>(texel[2]) };
+				block.alpha[i] = texel[3];
+			}
+			return block;
+		}
+
+		[[nodiscard]] std::uint16_t pack565(const Color& color) {
+			const auto quantize = [](float value, float levels) {
+				return static_cast<unsigned>(std::lround(std::clamp(value, 0.0F, 255.0F) * levels / 255.0F));
+			};
+			return static_cast<std::uint16_t>((quantize(color[0], 31.0F) << 11U)
+				| (quantize(color[1], 63.0F) << 5U) | quantize(color[2], 31.0F));
+		}
+
+		[[nodiscard]] Color unpack565Float(std::uint16_t packed) {
+			const unsigned r = (packed >> 11U) & 0x1FU;
+			const unsigned g = (packed >> 5U) & 0x3FU;
+			const unsigned b = packed & 0x1FU;
+			return { static_cast<float>((r << 3U) | (r >> 2U)),
+				static_cast<float>((g << 2U) | (g >> 4U)),
+				static_cast<float>((b << 3U) | (b >> 2U)) };
+		}
+
+		[[nodiscard]] float distanceSq(const Color& a, const Color& b) {
+			const float dr = a[0] - b[0];
+			const float dg = a[1] - b[1];
+			const float db = a[2] - b[2];
+			return dr * dr + dg * dg + db * db;
+		}
+
+		/**
+		 * @brief Four-color BC1 block: endpoints at the extremes of the principal axis.
+		 *
+		 * Texels with zero alpha are invisible and left out of the fit.
+		 */
+		void encodeColorBlock(const BlockTexels& texels, std::uint8_t* out) {
+			std::array<bool, 16> used{};
+			std::size_t usedCount = 0U;
+			for (std::size_t i = 0U; i < 16U; ++i) {
+				used[i] = texels.alpha[i] != 0U;
+				usedCount += used[i] ? 1U : 0U;
+			}
+			if (usedCount == 0U) {
+				used.fill(true);
+				usedCount = 16U;
+			}
+
+			Color mean{};
+			for (std::size_t i = 0U; i < 16U; ++i) {
+				if (used[i]) {
+					for (std::size_t ch = 0U; ch < 3U; ++ch) {
+						mean[ch] += texels.color[i][ch] / static_cast<float>(usedCount);
+					}
+				}
+			}
+
+			// Principal axis of the covariance by power iteration
+			std::array<float, 6> cov{}; // rr, rg, rb, gg, gb, bb
+			for (std::size_t i = 0U; i < 16U; ++i) {
+				if (!used[i]) {
+					continue;
+				}
+				const float r = texels.color[i][0] - mean[0];
+				const float g = texels.color[i][1] - mean[1];
+				const float b = texels.color[i][2] - mean[2];
+				cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+				cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+			}
+			Color axis{ 1.0F, 1.0F, 1.0F };
+			for (int iteration = 0; iteration < 8; ++iteration) {
+				const Color next{ cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+					cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+					cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2] };
+				const float norm = std::max({ std::fabs(next[0]), std::fabs(next[1]), std::fabs(next[2]) });
+				if (norm <= 0.0F) {
+					break;
+				}
+				axis = { next[0] / norm, next[1] / norm, next[2] / norm };
+			}
+
+			float minProjection = std::numeric_limits<float>::max();
+			float maxProjection = std::numeric_limits<float>::lowest();
+			for (std::size_t i = 0U; i < 16U; ++i) {
+				if (used[i]) {
+					const float projection = (texels.color[i][0] - mean[0]) * axis[0]
+						+ (texels.color[i][1] - mean[1]) * axis[1] + (texels.color[i][2] - mean[2]) * axis[2];
+					minProjection = std::min(minProjection, projection);
+					maxProjection = std::max(maxProjection, projection);
+				}
+			}
+			const float axisSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+			const auto endpoint = [&](float projection) {
+				const float t = (axisSq > 0.0F) ? projection / axisSq : 0.0F;
+				return Color{ mean[0] + axis[0] * t, mean[1] + axis[1] * t, mean[2] + axis[2] * t };
+			};
+
+			std::uint16_t c0 = pack565(endpoint(maxProjection));
+			std::uint16_t c1 = pack565(endpoint(minProjection));
+			if (c0 < c1) {
+				std::swap(c0, c1);
+			}
+
+			std::array<Color, 4> palette{ unpack565Float(c0), unpack565Float(c1), Color{}, Color{} };
+			for (std::size_t ch = 0U; ch < 3U; ++ch) {
+				palette[2][ch] = (2.0F * palette[0][ch] + palette[1][ch]) / 3.0F;
+				palette[3][ch] = (palette[0][ch] + 2.0F * palette[1][ch]) / 3.0F;
+			}
+
+			out[0] = static_cast<std::uint8_t>(c0 & 0xFFU);
+			out[1] = static_cast<std::uint8_t>(c0 >> 8U);
+			out[2] = static_cast<std::uint8_t>(c1 & 0xFFU);
+			out[3] = static_cast<std::uint8_t>(c1 >> 8U);
+			for (std::size_t row = 0U; row < 4U; ++row) {
+				std::uint8_t bits = 0U;
+				for (std::size_t col = 0U; col < 4U; ++col) {
+					const Color& texel = texels.color[row * 4U + col];
+					unsigned best = 0U;
+					// Equal endpoints would select BC1's three-color mode; index 0 is valid in both
+					if (c0 != c1) {
+						float bestError = std::numeric_limits<float>::max();
+						for (unsigned p = 0U; p < 4U; ++p) {
+							const float error = distanceSq(texel, palette[p]);
+							if (error < bestError) {
+								bestError = error;
+								best = p;
+							}
+						}
+					}
+					bits = static_cast<std::uint8_t>(bits | (best << (2U * col)));
+				}
+				out[4U + row] = bits;
+			}
+		}
+
+		[[nodiscard]] std::array<int, 8> alphaPalette(int a0, int a1) {
+			std::array<int, 8> palette{ a0, a1 };
+			if (a0 > a1) {
+				for (int i = 2; i < 8; ++i) {
+					palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+				}
+			}
+			else {
+				for (int i = 2; i < 6; ++i) {
+					palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+				}
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+			return palette;
+		}
+
+		// Squared error of the block with (a0, a1); also returns the chosen indices when requested
+		int fitAlpha(const BlockTexels& texels, int a0, int a1, std::uint64_t* indices) {
+			const std::array<int, 8> palette = alphaPalette(a0, a1);
+			int total = 0;
+			std::uint64_t bits = 0U;
+			for (std::size_t i = 0U; i < 16U; ++i) {
+				int bestError = std::numeric_limits<int>::max();
+				unsigned best = 0U;
+				for (unsigned p = 0U; p < 8U; ++p) {
+					const int diff = palette[p] - static_cast<int>(texels.alpha[i]);
+					if (diff * diff < bestError) {
+						bestError = diff * diff;
+						best = p;
+					}
+				}
+				total += bestError;
+				bits |= static_cast<std::uint64_t>(best) << (3U * i);
+			}
+			if (indices != nullptr) {
+				*indices = bits;
+			}
+			return total;
+		}
+
+		/**
+		 * @brief BC3 alpha block: tries the 8-value ramp over the full range and the
+		 *        6-value ramp with exact 0/255, keeping whichever fits better.
+		 *
+		 * The second mode keeps sprite cut-outs crisp where a block mixes fully
+		 * transparent, fully opaque and anti-aliased texels.
+		 */
+		void encodeAlphaBlock(const BlockTexels& texels, std::uint8_t* out) {
+			int lo = 255;
+			int hi = 0;
+			int innerLo = 255;
+			int innerHi = 0;
+			for (const std::uint8_t alpha : texels.alpha) {
+				lo = std::min(lo, static_cast<int>(alpha));
+				hi = std::max(hi, static_cast<int>(alpha));
+				if (alpha != 0U && alpha != 255U) {
+					innerLo = std::min(innerLo, static_cast<int>(alpha));
+					innerHi = std::max(innerHi, static_cast<int>(alpha));
+				}
+			}
+			if (innerLo > innerHi) {
+				innerLo = 0;
+				innerHi = 255;
+			}
+
+			int a0 = hi;
+			int a1 = lo;
+			std::uint64_t indices = 0U;
+			const int rampError = fitAlpha(texels, a0, a1, &indices);
+			std::uint64_t innerIndices = 0U;
+			if (fitAlpha(texels, innerLo, innerHi, &innerIndices) < rampError) {
+				a0 = innerLo;
+				a1 = innerHi;
+				indices = innerIndices;
+			}
+
+			out[0] = static_cast<std::uint8_t>(a0);
+			out[1] = static_cast<std::uint8_t>(a1);
+			for (std::size_t i = 0U; i < 6U; ++i) {
+				out[2U + i] = static_cast<std::uint8_t>((indices >> (8U * i)) & 0xFFU);
+			}
+		}
+
+		[[nodiscard]] CompressedLevel encodeLevel(const std::vector<std::uint8_t>& pixels, const sf::Vector2u& size,
+			BlockFormat format)
+		{
+			CompressedLevel level;
+			level.size = size;
+			level.blocks.resize(levelBytes(format, size));
+
+			const unsigned blocksX = std::max(1U, (size.x + 3U) / 4U);
+			const unsigned blocksY = std::max(1U, (size.y + 3U) / 4U);
+			const std::size_t stride = blockBytes(format);
+			for (unsigned by = 0U; by < blocksY; ++by) {
+				for (unsigned bx = 0U; bx < blocksX; ++bx) {
+					const BlockTexels texels = gatherBlock(pixels, size, bx, by);
+					std::uint8_t* block = &level.blocks[(static_cast<std::size_t>(by) * blocksX + bx) * stride];
+					if (format == BlockFormat::Bc3) {
+						encodeAlphaBlock(texels, block);
+						encodeColorBlock(texels, block + 8);
+					}
+					else {
+						encodeColorBlock(texels, block);
+					}
+				}
+			}
+			return level;
+		}
+	}
+
+	std::vector<std::uint8_t> resampleRgba(const std::uint8_t* pixels, const sf::Vector2u& size,
+		const sf::Vector2u& targetSize)
+	{
+		std::vector<std::uint8_t> result(static_cast<std::size_t>(targetSize.x) * targetSize.y * 4U);
+		const float stepX = static_cast<float>(size.x) / static_cast<float>(targetSize.x);
+		const float stepY = static_cast<float>(size.y) / static_cast<float>(targetSize.y);
+
+		for (unsigned ty = 0U; ty < targetSize.y; ++ty) {
+			const float y0 = static_cast<float>(ty) * stepY;
+			const float y1 = y0 + stepY;
+			for (unsigned tx = 0U; tx < targetSize.x; ++tx) {
+				const float x0 = static_cast<float>(tx) * stepX;
+				const float x1 = x0 + stepX;
+
+				// Area-weighted sum; colors are weighted by alpha as well
+				float coverage = 0.0F;
+				float alphaSum = 0.0F;
+				std::array<float, 3> colorSum{};
+				for (auto sy = static_cast<unsigned>(y0); sy < size.y && static_cast<float>(sy) < y1; ++sy) {
+					const float wy = std::min(y1, static_cast<float>(sy + 1U)) - std::max(y0, static_cast<float>(sy));
+					for (auto sx = static_cast<unsigned>(x0); sx < size.x && static_cast<float>(sx) < x1; ++sx) {
+						const float wx = std::min(x1, static_cast<float>(sx + 1U)) - std::max(x0, static_cast<float>(sx));
+						const std::uint8_t* texel = &pixels[(static_cast<std::size_t>(sy) * size.x + sx) * 4U];
+						const float weight = wx * wy;
+						const float alphaWeight = weight * static_cast<float>(texel[3]);
+						coverage += weight;
+						alphaSum += alphaWeight;
+						for (std::size_t ch = 0U; ch < 3U; ++ch) {
+							colorSum[ch] += alphaWeight * static_cast<float>(texel[ch]);
+						}
+					}
+				}
+
+				std::uint8_t* out = &result[(static_cast<std::size_t>(ty) * targetSize.x + tx) * 4U];
+				for (std::size_t ch = 0U; ch < 3U; ++ch) {
+					out[ch] = (alphaSum > 0.0F) ? static_cast<std::uint8_t>(std::lround(colorSum[ch] / alphaSum)) : 0U;
+				}
+				out[3] = (coverage > 0.0F) ? static_cast<std::uint8_t>(std::lround(alphaSum / coverage)) : 0U;
+			}
+		}
+		return result;
+	}
+
+	CompressedTexture cookTexture(const std::uint8_t* pixels, const sf::Vector2u& size, float scale) {
+		CompressedTexture texture;
+		if (pixels == nullptr || size.x == 0U || size.y == 0U) {
+			return texture;
+		}
+
+		const float factor = (scale > 0.0F) ? scale : 1.0F;
+		sf::Vector2u levelSize{ std::max(1U, static_cast<unsigned>(std::lround(static_cast<float>(size.x) * factor))),
+			std::max(1U, static_cast<unsigned>(std::lround(static_cast<float>(size.y) * factor))) };
+		std::vector<std::uint8_t> level = resampleRgba(pixels, size, levelSize);
+
+		bool opaque = true;
+		for (std::size_t i = 3U; i < level.size(); i += 4U) {
+			opaque = opaque && level[i] == 255U;
+		}
+		texture.format = opaque ? BlockFormat::Bc1 : BlockFormat::Bc3;
+
+		for (;;) {
+			texture.levels.push_back(encodeLevel(level, levelSize, texture.format));
+			if (levelSize.x == 1U && levelSize.y == 1U) {
+				break;
+			}
+			const sf::Vector2u nextSize{ std::max(1U, levelSize.x / 2U), std::max(1U, levelSize.y / 2U) };
+			level = resampleRgba(level.data(), levelSize, nextSize);
+			levelSize = nextSize;
+		}
+		return texture;
+	}
+
+} // namespace gfx
@@ -0,0 +1,37 @@
+/*
+==============================================================================
+Texture Cooker - offline downscale, mip chain and BC1/BC3 encoding
+==============================================================================
+ - Runs once per asset (--cook-texture), never in the frame loop
+ - Downscaling and mip reduction are alpha-weighted area averages, so the
+   transparent surroundings of a sprite do not bleed into its edges
+ - Opaque images are encoded as BC1, anything with alpha as BC3
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "CompressedTexture.hpp"
+
+namespace gfx {
+
+	/**
+	 * @brief Alpha-weighted area resample of tightly packed RGBA8 pixels.
+	 */
+	[[nodiscard]] std::vector<std::uint8_t> resampleRgba(const std::uint8_t* pixels,
+		const sf::Vector2u& size, const sf::Vector2u& targetSize);
+
+	/**
+	 * @brief Scales RGBA8 pixels by scale, then builds and encodes the full mip chain.
+	 *
+	 * MISRA: scale must be strictly positive; non-positive values keep the
+	 *        original size.
+	 */
+	[[nodiscard]] CompressedTexture cookTexture(const std::uint8_t* pixels, const sf::Vector2u& size, float scale);
+
+} // namespace gfx
@@ -0,0 +1,268 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "Trace.hpp"
+
+namespace sim {
+
+	namespace {
+		// Chunks per thread when the caller lets the pool choose
+		constexpr std::size_t CHUNKS_PER_THREAD = 4U;
+
+		// Pool and slot of the current worker thread (null outside any pool)
+		thread_local const ThreadPool* t_pool = nullptr;
+		thread_local std::size_t t_slot = 0U;
+
+		std::atomic<std::size_t> g_sharedThreads{ 0U };
+	}
+
+	ThreadPool::ThreadPool(std::size_t threadCount)
+		: ThreadPool(threadCount, detectNumaTopology())
+	{
+	}
+
+	ThreadPool::ThreadPool(std::size_t threadCount, const NumaTopology& topology) {
+		if (threadCount == 0U) {
+			threadCount = std::max<std::size_t>(1U, std::thread::hardware_concurrency());
+		}
+
+		m_queues.reserve(threadCount);
+		for (std::size_t i = 0U; i < threadCount; ++i) {
+			m_queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		// Slot s on node s * nodes / threads: one contiguous run of slots per node
+		const std::size_t nodes = std::min(topology.nodeCount(), threadCount);
+		m_nodeSlots.resize(nodes);
+		m_slotNode.resize(threadCount);
+		for (std::size_t slot = 0U; slot < threadCount; ++slot) {
+			m_slotNode[slot] = slot * nodes / threadCount;
+			m_nodeSlots[m_slotNode[slot]].push_back(slot);
+		}
+		m_stealOrder.resize(threadCount);
+		for (std::size_t slot = 0U; slot < threadCount; ++slot) {
+			std::vector<std::size_t>& order = m_stealOrder[slot];
+			order.reserve(threadCount);
+			for (const bool local : { true, false }) {
+				for (std::size_t k = 0U; k < threadCount; ++k) {
+					const std::size_t other = (slot + k) % threadCount;
+					if ((m_slotNode[other] == m_slotNode[slot]) == local) {
+						order.push_back(other);
+					}
+				}
+			}
+		}
+
+		m_workers.reserve(threadCount - 1U);
+		for (std::size_t i = 1U; i < threadCount; ++i) {
+			const std::vector<unsigned>* cpus = (nodes > 1U) ? &topology.nodeCpus[m_slotNode[i]] : nullptr;
+			m_workers.emplace_back([this, i, cpus]() {
+				// Pinned before the first task, so everything the worker touches lands on its node
+				if (cpus != nullptr) {
+					(void)pinCurrentThread(*cpus);
+				}
+				workerLoop(i);
+			});
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			const std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (auto& worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	std::size_t ThreadPool::callerSlot() const noexcept {
+		return (t_pool == this) ? t_slot : 0U;
+	}
+
+	void ThreadPool::push(std::size_t slot, TaskGroup& group, Task task) {
+		group.m_pending.fetch_add(1U, std::memory_order_relaxed);
+		group.m_queued.fetch_add(1U);
+		{
+			WorkQueue& queue = *m_queues[slot];
+			const std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back({ std::move(task), &group });
+		}
+		m_queuedTotal.fetch_add(1U);
+
+		// Taking the lock orders the notify after a sleeper's predicate check
+		{
+			const std::lock_guard<std::mutex> lock(m_mutex);
+		}
+		m_wake.notify_one();
+		if (group.m_waiters.load() > 0U) {
+			m_done.notify_all();
+		}
+	}
+
+	void ThreadPool::submit(TaskGroup& group, Task task) {
+		const std::size_t slot = (t_pool == this)
+			? t_slot
+			: m_nextSlot.fetch_add(1U, std::memory_order_relaxed) % m_queues.size();
+		push(slot, group, std::move(task));
+	}
+
+	bool ThreadPool::take(std::size_t slot, const TaskGroup* group, Entry& entry) {
+		const std::vector<std::size_t>& order = m_stealOrder[slot];
+		for (std::size_t k = 0U; k < order.size(); ++k) {
+			WorkQueue& queue = *m_queues[order[k]];
+			const std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty()) {
+				continue;
+			}
+
+			// Own queue: newest first; stealing: oldest first
+			auto found = queue.tasks.end();
+			if (group == nullptr) {
+				found = (k == 0U) ? std::prev(queue.tasks.end()) : queue.tasks.begin();
+			}
+			else if (k == 0U) {
+				const auto newest = std::find_if(queue.tasks.rbegin(), queue.tasks.rend(),
+					[group](const Entry& e) { return e.group == group; });
+				found = (newest != queue.tasks.rend()) ? std::prev(newest.base()) : queue.tasks.end();
+			}
+			else {
+				found = std::find_if(queue.tasks.begin(), queue.tasks.end(),
+					[group](const Entry& e) { return e.group == group; });
+			}
+			if (found == queue.tasks.end()) {
+				continue;
+			}
+
+			entry = std::move(*found);
+			(void)queue.tasks.erase(found);
+			m_queuedTotal.fetch_sub(1U);
+			entry.group->m_queued.fetch_sub(1U);
+			return true;
+		}
+		return false;
+	}
+
+	void ThreadPool::run(Entry& entry) {
+		entry.task();
+		entry.task = nullptr; // release captures before the group can be released
+
+		// The group may be destroyed as soon as pending reaches 0; only the pool is touched after
+		if (entry.group->m_pending.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+			{
+				const std::lock_guard<std::mutex> lock(m_mutex);
+			}
+			m_done.notify_all();
+		}
+	}
+
+	void ThreadPool::workerLoop(std::size_t slot) {
+		prof::setThreadName("pool worker");
+		t_pool = this;
+		t_slot = slot;
+
+		for (;;) {
+			Entry entry;
+			if (take(slot, nullptr, entry)) {
+				run(entry);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&]() { return m_stop || m_queuedTotal.load() > 0U; });
+			if (m_stop) {
+				return;
+			}
+		}
+	}
+
+	void ThreadPool::wait(TaskGroup& group) {
+		const std::size_t slot = callerSlot();
+		group.m_waiters.fetch_add(1U);
+
+		while (!group.done()) {
+			Entry entry;
+			if (take(slot, &group, entry)) {
+				run(entry);
+				continue;
+			}
+
+			// Everything left is running elsewhere (or about to be queued)
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done.wait(lock, [&]() { return group.done() || group.m_queued.load() > 0U; });
+		}
+
+		group.m_waiters.fetch_sub(1U);
+	}
+
+	void ThreadPool::parallelFor(std::size_t count, std::size_t chunk, const RangeFn& fn) {
+		if (count == 0U) {
+			return;
+		}
+		if (chunk == 0U) {
+			chunk = std::max<std::size_t>(1U, count / (threadCount() * CHUNKS_PER_THREAD));
+		}
+		if (m_workers.empty() || count <= chunk) {
+			fn(0U, count);
+			return;
+		}
+
+		TaskGroup group;
+		const std::size_t first = callerSlot();
+		std::size_t index = 0U;
+		for (std::size_t begin = 0U; begin < count; begin += chunk, ++index) {
+			const std::size_t end = std::min(begin + chunk, count);
+			push((first + index) % m_queues.size(), group, [&fn, begin, end]() {
+				OKPP_TRACE_SCOPE("parallelFor chunk");
+				fn(begin, end);
+			});
+		}
+		wait(group);
+	}
+
+	void ThreadPool::parallelForByNode(std::size_t count, std::size_t chunk, const RangeFn& fn) {
+		if (count == 0U) {
+			return;
+		}
+		if (chunk == 0U) {
+			chunk = std::max<std::size_t>(1U, count / (threadCount() * CHUNKS_PER_THREAD));
+		}
+		if (m_workers.empty() || count <= chunk) {
+			fn(0U, count);
+			return;
+		}
+
+		TaskGroup group;
+		const std::size_t chunks = (count + chunk - 1U) / chunk;
+		std::vector<std::size_t> dealt(nodeCount(), 0U);
+		for (std::size_t k = 0U; k < chunks; ++k) {
+			const std::size_t node = k * nodeCount() / chunks;
+			const std::vector<std::size_t>& slots = m_nodeSlots[node];
+			const std::size_t begin = k * chunk;
+			const std::size_t end = std::min(begin + chunk, count);
+			push(slots[dealt[node]++ % slots.size()], group, [&fn, begin, end]() {
+				OKPP_TRACE_SCOPE("parallelFor chunk");
+				fn(begin, end);
+			});
+		}
+		wait(group);
+	}
+
+	void setSharedPoolThreads(std::size_t threadCount) {
+		g_sharedThreads.store(threadCount);
+	}
+
+	ThreadPool& sharedPool() {
+		static ThreadPool pool([]() {
+			const std::size_t requested = g_sharedThreads.load();
+			const std::size_t threads = (requested > 0U) ? requested : std::thread::hardware_concurrency();
+			return std::max<std::size_t>(threads, 2U);
+		}());
+		return pool;
+	}
+
+} // namespace sim
@@ -0,0 +1,179 @@
+/*
+==============================================================================
+Thread Pool - fixed worker threads with work-stealing task queues
+==============================================================================
+ - Every thread slot owns a task queue: the owner takes its newest task
+   (LIFO, still warm in cache), idle threads steal the oldest one (FIFO)
+   from the others, so uneven tasks balance without a central queue
+ - Tasks are submitted into a TaskGroup; wait() runs the group's queued
+   tasks on the calling thread until all of them have finished
+ - parallelFor splits [0, count) into chunks dealt round-robin over the
+   queues, then waits on them like any other group
+ - On a machine with several memory nodes (NumaTopology) the slots are
+   split into one contiguous run per node and each worker is pinned to its
+   node's CPUs; an idle thread steals from its own node's queues first and
+   crosses to another node only when those are empty
+ - parallelForByNode() deals chunks to nodes in contiguous blocks, the
+   same block every call, so a range keeps running on the node whose
+   workers first touched its memory
+ - sharedPool() is the one pool of the process: fleet and evaluation runs,
+   asset decoding, tile streaming, distance-field baking and spilled
+   budgeted work (BudgetedWork) all queue onto it instead of starting
+   threads of their own
+==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "NumaTopology.hpp"
+
+namespace sim {
+
+	/**
+	 * @brief Completion counter for a set of submitted tasks.
+	 *
+	 * Must outlive its tasks: wait() on it before it goes out of scope.
+	 */
+	class TaskGroup {
+	public:
+		TaskGroup() = default;
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		[[nodiscard]] bool done() const noexcept { return m_pending.load(std::memory_order_acquire) == 0U; }
+
+	private:
+		friend class ThreadPool;
+
+		std::atomic<std::size_t> m_pending{ 0U }; // submitted and not finished
+		std::atomic<std::size_t> m_queued{ 0U };  // submitted and not started
+		std::atomic<std::size_t> m_waiters{ 0U };
+	};
+
+	class ThreadPool {
+	public:
+		using Task = std::function<void()>;
+		using RangeFn = std::function<void(std::size_t begin, std::size_t end)>;
+
+		/**
+		 * @brief Starts threadCount - 1 workers (the caller is the last one).
+		 *
+		 * threadCount 0 uses std::thread::hardware_concurrency().
+		 */
+		explicit ThreadPool(std::size_t threadCount = 0U);
+
+		/**
+		 * @brief As above, with the slots split over the nodes of topology
+		 *        (at most one node per thread).
+		 */
+		ThreadPool(std::size_t threadCount, const NumaTopology& topology);
+
+		/**
+		 * @brief Stops and joins the workers; tasks still queued are dropped.
+		 */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * @brief Queues task on the calling worker's own queue.
+		 *
+		 * Tasks may submit further tasks, into their own group or another one.
+		 */
+		void submit(TaskGroup& group, Task task);
+
+		/**
+		 * @brief Returns once every task of group has finished, running its
+		 *        queued tasks on the calling thread meanwhile.
+		 *
+		 * Only tasks of group are picked up, so a short wait is never stuck
+		 * behind an unrelated long task.
+		 */
+		void wait(TaskGroup& group);
+
+		/**
+		 * @brief Calls fn on disjoint sub-ranges covering [0, count), in parallel.
+		 *
+		 * chunk 0 picks a size that gives each thread a few chunks to balance load.
+		 */
+		void parallelFor(std::size_t count, std::size_t chunk, const RangeFn& fn);
+
+		/**
+		 * @brief parallelFor() with chunk k of n queued on node k * nodeCount() / n.
+		 *
+		 * Calls with the same count and chunk place every range on the same
+		 * node; on one node this is parallelFor() dealt from the first slot.
+		 */
+		void parallelForByNode(std::size_t count, std::size_t chunk, const RangeFn& fn);
+
+		[[nodiscard]] std::size_t threadCount() const noexcept { return m_workers.size() + 1U; }
+		[[nodiscard]] std::size_t nodeCount() const noexcept { return m_nodeSlots.size(); }
+
+		/**
+		 * @brief Node of the calling thread's slot (0 outside this pool).
+		 */
+		[[nodiscard]] std::size_t currentNode() const noexcept { return m_slotNode[callerSlot()]; }
+
+	private:
+		struct Entry {
+			Task task;
+			TaskGroup* group = nullptr;
+		};
+
+		// One per thread slot (slot 0 is the calling thread's); threads outside
+		// the pool deal their submissions round-robin over all of them
+		struct WorkQueue {
+			std::mutex mutex;
+			std::deque<Entry> tasks;
+		};
+
+		void workerLoop(std::size_t slot);
+		void push(std::size_t slot, TaskGroup& group, Task task);
+
+		// Own queue from the back, then the others from the front; group null takes any task
+		[[nodiscard]] bool take(std::size_t slot, const TaskGroup* group, Entry& entry);
+		void run(Entry& entry);
+		[[nodiscard]] std::size_t callerSlot() const noexcept;
+
+		std::vector<std::thread> m_workers;
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::vector<std::size_t> m_slotNode;                // node of each slot
+		std::vector<std::vector<std::size_t>> m_nodeSlots;  // slots of each node, ascending
+		std::vector<std::vector<std::size_t>> m_stealOrder; // per slot: itself, its node's slots, then the other nodes'
+
+		std::mutex m_mutex; // guards sleeping only; queues have their own locks
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		std::atomic<std::size_t> m_queuedTotal{ 0U };
+		std::atomic<std::size_t> m_nextSlot{ 0U };
+		bool m_stop = false;
+	};
+
+	/**
+	 * @brief Sets the shared pool's thread count (0 = all cores).
+	 *
+	 * Only takes effect before the first sharedPool() call.
+	 */
+	void setSharedPoolThreads(std::size_t threadCount);
+
+	/**
+	 * @brief The process-wide pool, created on first use.
+	 *
+	 * It always has at least one worker, so background tasks that nobody
+	 * waits on (asset decodes, tile loads) still make progress.
+	 */
+	[[nodiscard]] ThreadPool& sharedPool();
+
+} // namespace sim
@@ -0,0 +1,298 @@
+#include "TileRenderer.hpp"
+
+#include <SFML/Window/Context.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "Log.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace gfx {
+
+	namespace {
+		constexpr GLbitfield PERSISTENT_WRITE = gl::MAP_WRITE_BIT | gl::MAP_PERSISTENT_BIT | gl::MAP_COHERENT_BIT;
+
+		constexpr std::uint64_t FRAME_WAIT_NS = 1000000000U;
+
+		// Culling a tile is a few compares; below this many tiles a task costs more than it saves
+		constexpr std::size_t TILES_PER_TASK = 256U;
+
+		constexpr GLuint QUAD_VERTICES = 4U;
+
+		[[nodiscard]] gl::ProcAddress tileLoader(const char* name) {
+			return sf::Context::getFunction(name);
+		}
+
+		void waitFence(gl::Sync& fence) {
+			if (fence == nullptr) {
+				return;
+			}
+			const gl::Api& api = gl::api();
+			while (api.ClientWaitSync(fence, gl::SYNC_FLUSH_COMMANDS_BIT, FRAME_WAIT_NS) == gl::TIMEOUT_EXPIRED) {
+			}
+			api.DeleteSync(fence);
+			fence = nullptr;
+		}
+
+		[[nodiscard]] sf::FloatRect circleBounds(const sim::Obstacle& obstacle) {
+			const sf::Vector2f half{ obstacle.radius, obstacle.radius };
+			return { obstacle.center - half, half * 2.0F };
+		}
+
+		[[nodiscard]] sf::FloatRect merge(const sf::FloatRect& a, const sf::FloatRect& b) {
+			const sf::Vector2f low{ std::min(a.position.x, b.position.x), std::min(a.position.y, b.position.y) };
+			const sf::Vector2f high{ std::max(a.position.x + a.size.x, b.position.x + b.size.x),
+				std::max(a.position.y + a.size.y, b.position.y + b.size.y) };
+			return { low, high - low };
+		}
+	}
+
+	TileRenderer::~TileRenderer() {
+		if (!gl::loaded()) {
+			return;
+		}
+		const gl::Api& api = gl::api();
+		if (gl::storageLoaded()) {
+			for (gl::Sync& fence : m_fences) {
+				if (fence != nullptr) {
+					api.DeleteSync(fence);
+				}
+			}
+		}
+		// Deleting a buffer also unmaps it
+		const GLuint buffers[] = { m_obstacleBuffer, m_sensorBuffer, m_commandBuffer, m_quadBuffer };
+		for (const GLuint buffer : buffers) {
+			if (buffer != 0U) { api.DeleteBuffers(1, &buffer); }
+		}
+		if (m_obstacleVao != 0U) { api.DeleteVertexArrays(1, &m_obstacleVao); }
+		if (m_sensorVao != 0U) { api.DeleteVertexArrays(1, &m_sensorVao); }
+		if (m_program != 0U) { api.DeleteProgram(m_program); }
+	}
+
+	bool TileRenderer::init(std::size_t sensorCapacity) {
+		const GLuint program = buildCircleProgram();
+		if (program == 0U) {
+			return false;
+		}
+		if (!gl::storageLoaded() && !gl::loadStorage(&tileLoader)) {
+			gl::api().DeleteProgram(program);
+			return false;
+		}
+
+		const gl::Api& api = gl::api();
+		m_program = program;
+		m_viewProjLocation = api.GetUniformLocation(m_program, "u_viewProj");
+		m_quadBuffer = createCircleQuad();
+
+		m_sensorCapacity = std::max<std::size_t>(sensorCapacity, 1U);
+		void* sensors = nullptr;
+		if (!mapStorage(m_sensorBuffer, gl::ARRAY_BUFFER, FRAMES_IN_FLIGHT * m_sensorCapacity * sizeof(CircleInstance),
+			sensors))
+		{
+			return false;
+		}
+		m_sensors = static_cast<CircleInstance*>(sensors);
+
+		api.GenVertexArrays(1, &m_sensorVao);
+		api.BindVertexArray(m_sensorVao);
+		bindCircleAttributes(m_quadBuffer, m_sensorBuffer);
+		api.GenVertexArrays(1, &m_obstacleVao);
+		api.BindVertexArray(0U);
+		chargeBuffers();
+		return true;
+	}
+
+	void TileRenderer::chargeBuffers() noexcept {
+		m_videoCharge.set((FRAMES_IN_FLIGHT * m_sensorCapacity + m_obstacleCapacity) * sizeof(CircleInstance)
+			+ FRAMES_IN_FLIGHT * m_commandCapacity * sizeof(gl::DrawArraysCommand));
+	}
+
+	bool TileRenderer::mapStorage(GLuint& buffer, GLenum target, std::size_t bytes, void*& mapped) {
+		const gl::Api& api = gl::api();
+		api.GenBuffers(1, &buffer);
+		api.BindBuffer(target, buffer);
+		api.BufferStorage(target, static_cast<gl::SizeiPtr>(bytes), nullptr, PERSISTENT_WRITE);
+		mapped = api.MapBufferRange(target, 0, static_cast<gl::SizeiPtr>(bytes), PERSISTENT_WRITE);
+		api.BindBuffer(target, 0U);
+		if (mapped == nullptr) {
+			OKPP_LOG_ERROR("Error: cannot map a %zu byte tile buffer", bytes);
+			api.DeleteBuffers(1, &buffer);
+			buffer = 0U;
+			return false;
+		}
+		return true;
+	}
+
+	void TileRenderer::setObstacles(const std::vector<sim::Obstacle>& obstacles, float tileSize, sf::Color color) {
+		if (m_program == 0U) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("tile instances");
+
+		// The GPU may still read the old instances and commands of the frames in flight
+		waitAllFrames();
+		m_tiles.clear();
+		m_visibleTiles = 0U;
+
+		// Tile key per obstacle, then the obstacles ordered tile by tile
+		const float inverse = (tileSize > 0.0F) ? 1.0F / tileSize : 0.0F;
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> order(obstacles.size());
+		for (std::size_t i = 0U; i < obstacles.size(); ++i) {
+			const auto tx = static_cast<std::int32_t>(std::floor(obstacles[i].center.x * inverse));
+			const auto ty = static_cast<std::int32_t>(std::floor(obstacles[i].center.y * inverse));
+			const std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(ty)) << 32U)
+				| static_cast<std::uint32_t>(tx);
+			order[i] = { key, static_cast<std::uint32_t>(i) };
+		}
+		std::sort(order.begin(), order.end());
+		for (std::size_t i = 0U; i < order.size(); ++i) {
+			if (i == 0U || order[i].first != order[i - 1U].first) {
+				m_tiles.push_back(Tile{ {}, static_cast<std::uint32_t>(i), 0U });
+			}
+			++m_tiles.back().count;
+		}
+
+		const gl::Api& api = gl::api();
+		if (obstacles.size() > m_obstacleCapacity) {
+			if (m_obstacleBuffer != 0U) {
+				api.DeleteBuffers(1, &m_obstacleBuffer);
+			}
+			void* mapped = nullptr;
+			m_obstacleCapacity = obstacles.size();
+			if (!mapStorage(m_obstacleBuffer, gl::ARRAY_BUFFER, m_obstacleCapacity * sizeof(CircleInstance), mapped)) {
+				m_obstacleCapacity = 0U;
+				m_obstacles = nullptr;
+				m_tiles.clear();
+				chargeBuffers();
+				return;
+			}
+			m_obstacles = static_cast<CircleInstance*>(mapped);
+			api.BindVertexArray(m_obstacleVao);
+			bindCircleAttributes(m_quadBuffer, m_obstacleBuffer);
+			api.BindVertexArray(0U);
+		}
+		if (m_tiles.size() > m_commandCapacity) {
+			if (m_commandBuffer != 0U) {
+				api.DeleteBuffers(1, &m_commandBuffer);
+			}
+			void* mapped = nullptr;
+			m_commandCapacity = m_tiles.size();
+			if (!mapStorage(m_commandBuffer, gl::DRAW_INDIRECT_BUFFER,
+				FRAMES_IN_FLIGHT * m_commandCapacity * sizeof(gl::DrawArraysCommand), mapped))
+			{
+				m_commandCapacity = 0U;
+				m_commands = nullptr;
+				m_tiles.clear();
+				chargeBuffers();
+				return;
+			}
+			m_commands = static_cast<gl::DrawArraysCommand*>(mapped);
+		}
+		chargeBuffers();
+
+		// Every tile owns a disjoint run of the mapping, so workers never share a record
+		sim::sharedPool().parallelFor(m_tiles.size(), 1U, [&](std::size_t begin, std::size_t end) {
+			for (std::size_t t = begin; t < end; ++t) {
+				Tile& tile = m_tiles[t];
+				tile.bounds = circleBounds(obstacles[order[tile.first].second]);
+				for (std::uint32_t k = tile.first; k < tile.first + tile.count; ++k) {
+					const sim::Obstacle& obstacle = obstacles[order[k].second];
+					m_obstacles[k] = makeObstacleInstance(obstacle, color);
+					tile.bounds = merge(tile.bounds, circleBounds(obstacle));
+				}
+			}
+		});
+	}
+
+	void TileRenderer::setSensors(const CircleInstance* data, std::size_t count) {
+		if (m_program == 0U) {
+			return;
+		}
+		acquireFrame();
+		m_sensorCount = std::min(count, m_sensorCapacity);
+		if (m_sensorCount > 0U) {
+			std::memcpy(m_sensors + m_frame * m_sensorCapacity, data, m_sensorCount * sizeof(CircleInstance));
+		}
+	}
+
+	void TileRenderer::draw(sf::RenderTarget& target) {
+		if (m_program == 0U) {
+			return;
+		}
+		if (!target.setActive(true)) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("tile draw");
+		acquireFrame();
+
+		// World rectangle under the view, rotation included
+		const sf::View& view = target.getView();
+		const sf::FloatRect visible = view.getInverseTransform().transformRect({ { -1.0F, -1.0F }, { 2.0F, 2.0F } });
+
+		// Culled tiles keep their command slot with no instances, so slots never move
+		gl::DrawArraysCommand* const commands = m_commands + m_frame * m_commandCapacity;
+		std::atomic<std::size_t> visibleTiles{ 0U };
+		sim::sharedPool().parallelFor(m_tiles.size(), TILES_PER_TASK, [&](std::size_t begin, std::size_t end) {
+			std::size_t shown = 0U;
+			for (std::size_t t = begin; t < end; ++t) {
+				const Tile& tile = m_tiles[t];
+				const bool inView = visible.findIntersection(tile.bounds).has_value();
+				commands[t] = gl::DrawArraysCommand{ QUAD_VERTICES, inView ? tile.count : 0U, 0U, tile.first };
+				shown += inView ? 1U : 0U;
+			}
+			visibleTiles.fetch_add(shown, std::memory_order_relaxed);
+		});
+		m_visibleTiles = visibleTiles.load(std::memory_order_relaxed);
+
+		const gl::Api& api = gl::api();
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		api.UseProgram(m_program);
+		api.UniformMatrix4fv(m_viewProjLocation, 1, GL_FALSE, view.getTransform().getMatrix());
+		if (m_visibleTiles > 0U) {
+			const std::size_t offset = m_frame * m_commandCapacity * sizeof(gl::DrawArraysCommand);
+			api.BindVertexArray(m_obstacleVao);
+			api.BindBuffer(gl::DRAW_INDIRECT_BUFFER, m_commandBuffer);
+			api.MultiDrawArraysIndirect(GL_TRIANGLE_STRIP, reinterpret_cast<const void*>(offset),
+				static_cast<GLsizei>(m_tiles.size()), 0);
+			api.BindBuffer(gl::DRAW_INDIRECT_BUFFER, 0U);
+		}
+		if (m_sensorCount > 0U) {
+			api.BindVertexArray(m_sensorVao);
+			api.DrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(QUAD_VERTICES),
+				static_cast<GLsizei>(m_sensorCount), static_cast<GLuint>(m_frame * m_sensorCapacity));
+		}
+		api.BindVertexArray(0U);
+		api.UseProgram(0U);
+
+		// This region is read by the commands just queued; the next frame writes the following one
+		m_fences[m_frame] = api.FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0U);
+		m_frame = (m_frame + 1U) % FRAMES_IN_FLIGHT;
+		m_acquired = false;
+		m_sensorCount = 0U;
+
+		target.resetGLStates();
+	}
+
+	void TileRenderer::acquireFrame() {
+		if (m_acquired) {
+			return;
+		}
+		OKPP_TRACE_SCOPE("tile frame wait");
+		waitFence(m_fences[m_frame]);
+		m_acquired = true;
+	}
+
+	void TileRenderer::waitAllFrames() {
+		for (gl::Sync& fence : m_fences) {
+			waitFence(fence);
+		}
+	}
+
+} // namespace gfx
@@ -0,0 +1,119 @@
+/*
+==============================================================================
+Tile Renderer - per-tile instanced circles from persistently mapped buffers
+==============================================================================
+ - For the largest lots (--tiled): obstacles are binned into square tiles,
+   each tile one contiguous run of CircleInstance records
+ - Instance, sensor and draw-command buffers are immutable and mapped once
+   for good (OpenGL 4.4 buffer storage), so writes need no glBufferSubData
+   and may come from any thread
+ - Tile instances are written by shared-pool workers, one tile per worker
+   at a time; each frame the workers cull the tiles against the view and
+   record one indirect draw command per tile, and the render thread
+   submits all of them with a single glMultiDrawArraysIndirect
+ - Sensor wedges and draw commands live in a ring of three per-frame
+   regions, each guarded by a fence, so the CPU only writes a region the
+   GPU has finished reading
+ - Same shader and instance layout as the InstancedRenderer
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlFunctions.hpp"
+#include "InstancedRenderer.hpp"
+#include "MemoryAccounting.hpp"
+#include "SimTypes.hpp"
+
+namespace gfx {
+
+	class TileRenderer {
+	public:
+		// Per-frame regions in the ring; the GPU may still read the two older ones
+		static constexpr std::size_t FRAMES_IN_FLIGHT = 3U;
+
+		TileRenderer() = default;
+		~TileRenderer();
+
+		TileRenderer(const TileRenderer&) = delete;
+		TileRenderer& operator=(const TileRenderer&) = delete;
+
+		/**
+		 * @brief Loads the GL 4.4 entry points and maps room for sensorCapacity wedges per frame.
+		 *
+		 * Requires the target window's context to be active. Returns false if
+		 * the driver lacks persistent buffers; callers fall back to another renderer.
+		 */
+		[[nodiscard]] bool init(std::size_t sensorCapacity);
+
+		/**
+		 * @brief Bins the obstacles into tileSize tiles and writes their instances.
+		 *
+		 * Waits for the frames in flight first, so call it on rebuilds only.
+		 * MISRA: tileSize must be strictly positive; non-positive values put
+		 *        every obstacle in one tile.
+		 */
+		void setObstacles(const std::vector<sim::Obstacle>& obstacles, float tileSize, sf::Color color);
+
+		/**
+		 * @brief Replaces this frame's sensor wedges; extra records past the capacity are dropped.
+		 */
+		void setSensors(const CircleInstance* data, std::size_t count);
+
+		/**
+		 * @brief Draws the tiles inside the target's view, then the sensor wedges.
+		 *
+		 * SFML's cached GL state is reset afterwards, so regular draws may follow.
+		 */
+		void draw(sf::RenderTarget& target);
+
+		[[nodiscard]] std::size_t tileCount() const noexcept { return m_tiles.size(); }
+		[[nodiscard]] std::size_t visibleTileCount() const noexcept { return m_visibleTiles; }
+
+	private:
+		struct Tile {
+			sf::FloatRect bounds;     // every circle of the tile, radii included
+			std::uint32_t first = 0U; // first instance of the tile
+			std::uint32_t count = 0U;
+		};
+
+		void acquireFrame();
+		void waitAllFrames();
+		[[nodiscard]] bool mapStorage(GLuint& buffer, GLenum target, std::size_t bytes, void*& mapped);
+		void chargeBuffers() noexcept; // charges what the three mapped buffers hold
+
+		GLuint m_program = 0U;
+		GLint m_viewProjLocation = -1;
+		GLuint m_quadBuffer = 0U;
+		GLuint m_obstacleVao = 0U;
+		GLuint m_sensorVao = 0U;
+		GLuint m_obstacleBuffer = 0U;
+		GLuint m_sensorBuffer = 0U;  // FRAMES_IN_FLIGHT regions of m_sensorCapacity instances
+		GLuint m_commandBuffer = 0U; // FRAMES_IN_FLIGHT regions of m_commandCapacity commands
+
+		CircleInstance* m_obstacles = nullptr; // persistent mappings
+		CircleInstance* m_sensors = nullptr;
+		gl::DrawArraysCommand* m_commands = nullptr;
+
+		std::size_t m_obstacleCapacity = 0U;
+		std::size_t m_sensorCapacity = 0U;
+		std::size_t m_commandCapacity = 0U;
+		std::size_t m_sensorCount = 0U;
+		prof::MemoryCharge m_videoCharge{ prof::MemorySubsystem::RenderBuffers, prof::MemoryKind::Video };
+
+		std::vector<Tile> m_tiles;
+		std::size_t m_visibleTiles = 0U;
+
+		std::array<gl::Sync, FRAMES_IN_FLIGHT> m_fences{};
+		std::size_t m_frame = 0U;
+		bool m_acquired = false; // the current region's fence has been waited on
+	};
+
+} // namespace gfx
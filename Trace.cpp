@@ -0,0 +1,168 @@
+#include "Trace.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace prof {
+
+	namespace detail {
+		std::atomic<bool> g_tracing{ false };
+	}
+
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		// 16 bytes per event: 1 MiB per thread; later events are counted as dropped
+		constexpr std::size_t EVENTS_PER_THREAD = std::size_t{ 1 } << 16U;
+
+		struct Event {
+			const char* name;
+			std::int64_t ns; // since startTracing()
+			char phase;      // 'B' or 'E'
+		};
+
+		struct ThreadBuffer {
+			std::uint32_t tid = 0U;
+			const char* name = nullptr;
+			std::unique_ptr<Event[]> events{ new Event[EVENTS_PER_THREAD] };
+			std::atomic<std::size_t> count{ 0U };   // published with release by the owner
+			std::atomic<std::size_t> dropped{ 0U };
+		};
+
+		struct Registry {
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> buffers; // outlive their threads
+			std::string path;
+			Clock::time_point start{};
+		};
+
+		Registry& registry() {
+			static Registry instance;
+			return instance;
+		}
+
+		ThreadBuffer& localBuffer() {
+			thread_local ThreadBuffer* buffer = nullptr;
+			if (buffer == nullptr) {
+				Registry& reg = registry();
+				const std::lock_guard<std::mutex> lock(reg.mutex);
+				reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+				buffer = reg.buffers.back().get();
+				buffer->tid = static_cast<std::uint32_t>(reg.buffers.size());
+			}
+			return *buffer;
+		}
+
+		void record(const char* name, char phase) {
+			ThreadBuffer& buffer = localBuffer();
+			const std::size_t n = buffer.count.load(std::memory_order_relaxed);
+			if (n >= EVENTS_PER_THREAD) {
+				buffer.dropped.fetch_add(1U, std::memory_order_relaxed);
+				return;
+			}
+			const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - registry().start).count();
+			buffer.events[n] = Event{ name, static_cast<std::int64_t>(ns), phase };
+			buffer.count.store(n + 1U, std::memory_order_release);
+		}
+
+		void writeString(std::ostream& out, const char* text) {
+			out << '"';
+			for (; *text != '\0'; ++text) {
+				if (*text == '"' || *text == '\\') {
+					out << '\\';
+				}
+				out << *text;
+			}
+			out << '"';
+		}
+	}
+
+	namespace detail {
+		void traceBegin(const char* name) { record(name, 'B'); }
+		void traceEnd(const char* name) { record(name, 'E'); }
+	}
+
+	void startTracing(const std::string& path) {
+		Registry& reg = registry();
+		{
+			const std::lock_guard<std::mutex> lock(reg.mutex);
+			reg.path = path;
+			reg.start = Clock::now();
+			for (auto& buffer : reg.buffers) {
+				buffer->count.store(0U, std::memory_order_relaxed);
+				buffer->dropped.store(0U, std::memory_order_relaxed);
+			}
+		}
+		detail::g_tracing.store(true, std::memory_order_release);
+	}
+
+	bool stopTracing() {
+		if (!detail::g_tracing.exchange(false, std::memory_order_acq_rel)) {
+			return true;
+		}
+
+		Registry& reg = registry();
+		const std::lock_guard<std::mutex> lock(reg.mutex);
+
+		std::ofstream file(reg.path, std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: Failed to write trace " << reg.path << '\n';
+			return false;
+		}
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		const auto separator = [&]() {
+			if (!first) {
+				file << ",\n";
+			}
+			first = false;
+		};
+
+		std::size_t dropped = 0U;
+		for (const auto& buffer : reg.buffers) {
+			if (buffer->name != nullptr) {
+				separator();
+				file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+					<< ",\"args\":{\"name\":";
+				writeString(file, buffer->name);
+				file << "}}";
+			}
+
+			const std::size_t count = buffer->count.load(std::memory_order_acquire);
+			for (std::size_t i = 0U; i < count; ++i) {
+				const Event& event = buffer->events[i];
+				separator();
+				file << "{\"name\":";
+				writeString(file, event.name);
+				file << ",\"ph\":\"" << event.phase << "\",\"ts\":" << (static_cast<double>(event.ns) / 1000.0)
+					<< ",\"pid\":1,\"tid\":" << buffer->tid << '}';
+			}
+			dropped += buffer->dropped.load(std::memory_order_relaxed);
+		}
+		file << "\n]}\n";
+
+		if (dropped > 0U) {
+			std::cerr << "Warning: trace buffers full, " << dropped << " events dropped\n";
+		}
+		return static_cast<bool>(file);
+	}
+
+	void setThreadName(const char* name) {
+		if (!tracing()) {
+			return; // keeps untraced runs from allocating a buffer per thread
+		}
+		ThreadBuffer& buffer = localBuffer();
+		const std::lock_guard<std::mutex> lock(registry().mutex);
+		buffer.name = name;
+	}
+
+} // namespace prof
@@ -0,0 +1,78 @@
+/*
+==============================================================================
+Trace - begin/end events exported as Chrome trace JSON
+==============================================================================
+ - Each thread appends to its own fixed-size buffer; the owner is the only
+   writer, so recording takes no locks (registration locks once per thread)
+ - Disabled at runtime, a scope costs one relaxed atomic load
+ - stopTracing() writes every buffer as a Chrome trace event file that
+   chrome://tracing and ui.perfetto.dev open directly
+ - Event names must be string literals (or otherwise outlive the trace)
+==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+namespace prof {
+
+	namespace detail {
+		extern std::atomic<bool> g_tracing;
+
+		void traceBegin(const char* name);
+		void traceEnd(const char* name);
+	}
+
+	/**
+	 * @brief Starts recording; the file is written by stopTracing().
+	 */
+	void startTracing(const std::string& path);
+
+	/**
+	 * @brief Stops recording and writes the trace; returns false on I/O failure.
+	 *
+	 * Safe to call when tracing never started (does nothing).
+	 */
+	bool stopTracing();
+
+	[[nodiscard]] inline bool tracing() noexcept {
+		return detail::g_tracing.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Names the calling thread in the exported trace.
+	 *
+	 * Ignored while tracing is off, so call it after startTracing().
+	 */
+	void setThreadName(const char* name);
+
+	class TraceScope {
+	public:
+		explicit TraceScope(const char* name) noexcept
+			: m_name(tracing() ? name : nullptr) {
+			if (m_name != nullptr) {
+				detail::traceBegin(m_name);
+			}
+		}
+		~TraceScope() {
+			if (m_name != nullptr) {
+				detail::traceEnd(m_name);
+			}
+		}
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+	private:
+		const char* m_name; // null when tracing was off at scope entry
+	};
+
+} // namespace prof
+
+#define OKPP_TRACE_CONCAT_INNER(a, b) a##b
+#define OKPP_TRACE_CONCAT(a, b) OKPP_TRACE_CONCAT_INNER(a, b)
+
+// Records a begin/end pair around the rest of the enclosing scope
+#define OKPP_TRACE_SCOPE(name) const ::prof::TraceScope OKPP_TRACE_CONCAT(okppTraceScope_, __LINE__)(name)
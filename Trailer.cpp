@@ -0,0 +1,72 @@
+#include "Trailer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "DeterministicMath.hpp"
+#include "FastTrig.hpp"
+#include "SensorRig.hpp"
+
+namespace sim {
+
+	namespace {
+		// Hitch to the trailer's axle (its center)
+		[[nodiscard]] float towLength(const TrailerParams& params) noexcept {
+			return params.drawbar + params.halfExtent.x;
+		}
+
+		[[nodiscard]] sf::Vector2f headingVector(float headingDeg) noexcept {
+			const SinCos heading = sinCosDeg(headingDeg);
+			return { heading.cos, heading.sin };
+		}
+	}
+
+	sf::Vector2f hitchPoint(const CarState& car, const sf::Vector2f& carHalfExtent, const TrailerParams& params) {
+		return car.position - headingVector(car.headingDeg) * (carHalfExtent.x + params.hitchBehind);
+	}
+
+	CarState trailerBehind(const CarState& car, const sf::Vector2f& carHalfExtent, const TrailerParams& params) {
+		CarState trailer;
+		trailer.headingDeg = car.headingDeg;
+		trailer.position = hitchPoint(car, carHalfExtent, params) - headingVector(car.headingDeg) * towLength(params);
+		return trailer;
+	}
+
+	void stepTrailer(CarState& trailer, const CarState& car, const sf::Vector2f& carHalfExtent, const TrailerParams& params) {
+		const sf::Vector2f hitch = hitchPoint(car, carHalfExtent, params);
+		const sf::Vector2f toHitch = hitch - trailer.position;
+		if (toHitch.x == 0.0F && toHitch.y == 0.0F) {
+			return; // degenerate: the axle under the hitch keeps its heading
+		}
+
+		// Face the hitch, measured from the car so the heading stays in the car's range
+		CarState facing;
+		facing.headingDeg = dmath::atan2Deg(toHitch.y, toHitch.x);
+		const float limit = params.maxArticulationDeg;
+		const float articulation = std::clamp(articulationDeg(car, facing), -limit, limit);
+		trailer.headingDeg = car.headingDeg - articulation;
+		trailer.position = hitch - headingVector(trailer.headingDeg) * towLength(params);
+	}
+
+	float articulationDeg(const CarState& car, const CarState& trailer) noexcept {
+		float delta = std::fmod(car.headingDeg - trailer.headingDeg, 360.0F);
+		if (delta > 180.0F) { delta -= 360.0F; }
+		if (delta <= -180.0F) { delta += 360.0F; }
+		return delta;
+	}
+
+	sf::Vector2f trailerRestOffset(const sf::Vector2f& carHalfExtent, const TrailerParams& params) noexcept {
+		return { -(carHalfExtent.x + params.hitchBehind + towLength(params)), 0.0F };
+	}
+
+	std::vector<RigSensor> defaultTrailerRig() {
+		std::vector<RigSensor> rig = CornerSensorRig::rig();
+		for (RigSensor& sensor : rig) {
+			if (sensor.zone == SensorZone::Front) {
+				sensor.zone = SensorZone::Corner; // nothing ahead of a trailer but the car
+			}
+		}
+		return rig;
+	}
+
+} // namespace sim
@@ -0,0 +1,73 @@
+/*
+==============================================================================
+Trailer - a towed body on a hitch behind the car
+==============================================================================
+ - The trailer is a CarState of its own (center and heading), so every
+   helper that places, bounds or draws the car places, bounds or draws the
+   trailer too; it has no inputs, only the hitch it hangs from
+ - The hitch sits on the car's center line, hitchBehind px past its rear
+   edge; the trailer's single axle is at its center, drawbar + half its
+   length behind the hitch
+ - stepTrailer() is the discrete tractrix of a towed axle: after each car
+   tick the trailer turns to face the hitch's new position and is pulled
+   (or pushed, reversing) to the drawbar's length from it. The articulation
+   is held within maxArticulationDeg, the jackknife stop
+ - The trailer has a sensor rig of its own (defaultTrailerRig(): the four
+   corner units, the front pair watching the sides as the trailer swings);
+   VehiclePose places it with the car's in one batch
+ - No rendering dependency
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <vector>
+
+#include "CarModel.hpp"
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	struct TrailerParams {
+		sf::Vector2f halfExtent{ 100.0F, 64.0F }; // trailer box, +x towards the hitch
+		float hitchBehind = 24.0F;               // hitch ball behind the car's rear edge, px
+		float drawbar = 40.0F;                   // hitch to the trailer's front edge, px
+		float maxArticulationDeg = 75.0F;        // jackknife stop either way
+	};
+
+	/**
+	 * @brief World position of the hitch for a car of carHalfExtent at car.
+	 */
+	[[nodiscard]] sf::Vector2f hitchPoint(const CarState& car, const sf::Vector2f& carHalfExtent, const TrailerParams& params);
+
+	/**
+	 * @brief Trailer pose straight behind the car (the spawn pose).
+	 */
+	[[nodiscard]] CarState trailerBehind(const CarState& car, const sf::Vector2f& carHalfExtent, const TrailerParams& params);
+
+	/**
+	 * @brief Drags the trailer after the car's tick to the car's new pose.
+	 */
+	void stepTrailer(CarState& trailer, const CarState& car, const sf::Vector2f& carHalfExtent, const TrailerParams& params);
+
+	/**
+	 * @brief Car heading minus trailer heading, in (-180, 180] degrees.
+	 */
+	[[nodiscard]] float articulationDeg(const CarState& car, const CarState& trailer) noexcept;
+
+	/**
+	 * @brief Where the trailer's body sits in the car's frame when towed straight.
+	 *
+	 * Trailer mounts shifted by this give the car-frame mounts consumers that
+	 * reason about the whole vehicle (beep panning, time to collision) use.
+	 */
+	[[nodiscard]] sf::Vector2f trailerRestOffset(const sf::Vector2f& carHalfExtent, const TrailerParams& params) noexcept;
+
+	/**
+	 * @brief The trailer's own sensor rig: corner units, the front pair in the corner zone.
+	 */
+	[[nodiscard]] std::vector<RigSensor> defaultTrailerRig();
+
+} // namespace sim
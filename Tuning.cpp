@@ -0,0 +1,152 @@
+#include "Tuning.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+#include "HeadlessApp.hpp"
+
+namespace sim {
+
+	namespace {
+		struct TuningKey {
+			const char* name;
+			float Tuning::* value;
+		};
+
+		constexpr TuningKey TUNING_KEYS[] = {
+			{ "car_speed", &Tuning::carSpeed },
+			{ "car_turn_rate", &Tuning::carTurnRate },
+			{ "warning_threshold", &Tuning::warningThreshold },
+			{ "danger_threshold", &Tuning::dangerThreshold }
+		};
+
+		// False while path is missing or being replaced
+		[[nodiscard]] bool writeTime(const std::string& path, std::filesystem::file_time_type& stamp) {
+			std::error_code error;
+			stamp = std::filesystem::last_write_time(path, error);
+			return !error;
+		}
+	}
+
+	bool loadTuning(const std::string& path, Tuning& tuning) {
+		std::ifstream file(path);
+		if (!file) {
+			std::cerr << "Error: Failed to open tuning file " << path << '\n';
+			return false;
+		}
+
+		Tuning parsed = tuning;
+		std::string line;
+		std::size_t lineNumber = 0U;
+		while (std::getline(file, line)) {
+			++lineNumber;
+			std::istringstream fields(line);
+			std::string key;
+			if (!(fields >> key) || key[0] == '#') {
+				continue;
+			}
+			const TuningKey* match = nullptr;
+			for (const TuningKey& candidate : TUNING_KEYS) {
+				if (key == candidate.name) {
+					match = &candidate;
+				}
+			}
+			float value = 0.0F;
+			if (match == nullptr || !(fields >> value) || !(value > 0.0F)) {
+				std::cerr << "Error: " << path << ':' << lineNumber << ": expected \"<car_speed|car_turn_rate|"
+					"warning_threshold|danger_threshold> <positive value>\"\n";
+				return false;
+			}
+			parsed.*(match->value) = value;
+		}
+		if (parsed.dangerThreshold > parsed.warningThreshold) {
+			std::cerr << "Error: " << path << ": danger_threshold is beyond warning_threshold\n";
+			return false;
+		}
+		tuning = parsed;
+		return true;
+	}
+
+	TuningWatcher::TuningWatcher(ThreadPool& pool, std::string tuningPath, std::string profilesPath, std::string vehicle)
+		: m_pool(pool)
+		, m_tuningPath(std::move(tuningPath))
+		, m_profilesPath(std::move(profilesPath))
+		, m_vehicle(std::move(vehicle))
+	{
+	}
+
+	TuningWatcher::~TuningWatcher() {
+		m_pool.wait(m_checks);
+	}
+
+	bool TuningWatcher::start() {
+		if (!loadTuning(m_tuningPath, m_tuning) || !loadWarningProfile(m_profilesPath, m_vehicle, m_profile)) {
+			return false;
+		}
+		(void)writeTime(m_tuningPath, m_tuningStamp);
+		if (!m_profilesPath.empty()) {
+			(void)writeTime(m_profilesPath, m_profilesStamp);
+		}
+		publish();
+		m_nextCheck = std::chrono::steady_clock::now() + POLL_INTERVAL;
+		return true;
+	}
+
+	void TuningWatcher::poll() {
+		const auto now = std::chrono::steady_clock::now();
+		if (now < m_nextCheck || !m_checks.done()) {
+			return;
+		}
+		m_nextCheck = now + POLL_INTERVAL;
+		m_pool.submit(m_checks, [this]() { (void)check(); });
+	}
+
+	void TuningWatcher::publish() {
+		auto snapshot = std::make_shared<TuningSnapshot>();
+		snapshot->tuning = m_tuning;
+		snapshot->profile = m_profile;
+		snapshot->version = ++m_version;
+		std::atomic_store(&m_latest, std::shared_ptr<const TuningSnapshot>(std::move(snapshot)));
+	}
+
+	bool TuningWatcher::check() {
+		bool changed = false;
+
+		// A file missing for a moment (an editor replacing it) is retried next time
+		std::filesystem::file_time_type stamp;
+		if (writeTime(m_tuningPath, stamp) && stamp != m_tuningStamp) {
+			m_tuningStamp = stamp;
+			Tuning tuning; // keys dropped from the file go back to their defaults
+			if (loadTuning(m_tuningPath, tuning)) {
+				m_tuning = tuning;
+				changed = true;
+			}
+			else {
+				std::cerr << "Warning: keeping the last good tuning values\n";
+			}
+		}
+
+		// The beep table is recompiled only when the profiles themselves changed
+		if (!m_profilesPath.empty() && writeTime(m_profilesPath, stamp) && stamp != m_profilesStamp) {
+			m_profilesStamp = stamp;
+			WarningProfile profile;
+			if (loadWarningProfile(m_profilesPath, m_vehicle, profile)) {
+				m_profile = std::move(profile);
+				changed = true;
+			}
+			else {
+				std::cerr << "Warning: keeping the last good warning profile\n";
+			}
+		}
+
+		if (!changed) {
+			return false;
+		}
+		publish();
+		return true;
+	}
+
+} // namespace sim
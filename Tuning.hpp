@@ -0,0 +1,113 @@
+/*
+==============================================================================
+Tuning - calibration values reloaded from a watched file while running
+==============================================================================
+ - The values calibration sessions keep changing (car speed and turn rate,
+   warning and danger thresholds) come from a text file (--tuning) instead
+   of the constants namespace, whose values stay the defaults
+ - A watcher stats the tuning file and the warning profiles on the shared
+   job system every POLL_INTERVAL; a changed file is parsed there, off the
+   frame loop, and the result published as one immutable snapshot through
+   an atomic shared pointer swap
+ - The squared-distance beep table is recompiled only when the profiles
+   file itself changed; a tuning-only edit reuses the compiled profile
+ - A file that fails to parse is reported and the last good values stay
+ - Text form, one value per line ('#' starts a comment):
+       car_speed <px/s>
+       car_turn_rate <deg/s>
+       warning_threshold <px>
+       danger_threshold <px>
+==============================================================================
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "Constants.hpp"
+#include "ThreadPool.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	struct Tuning {
+		float carSpeed = constants::CAR_SPEED;
+		float carTurnRate = constants::CAR_TURN_RATE;
+		float warningThreshold = constants::WARNING_THRESHOLD;
+		float dangerThreshold = constants::DANGER_THRESHOLD;
+	};
+
+	// One published state of the watched files; never modified once published
+	struct TuningSnapshot {
+		Tuning tuning;
+		WarningProfile profile;
+		std::uint64_t version = 0U; // increases with every publish
+	};
+
+	/**
+	 * @brief Parses a tuning file over tuning; keys the file omits keep their value.
+	 *
+	 * Returns false and logs on errors, leaving tuning unchanged.
+	 */
+	[[nodiscard]] bool loadTuning(const std::string& path, Tuning& tuning);
+
+	class TuningWatcher {
+	public:
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 500 };
+
+		/**
+		 * @brief Watches tuningPath and profilesPath (built-in profile if empty, then never reloaded).
+		 */
+		TuningWatcher(ThreadPool& pool, std::string tuningPath, std::string profilesPath, std::string vehicle);
+		~TuningWatcher(); // waits for a check in flight
+
+		TuningWatcher(const TuningWatcher&) = delete;
+		TuningWatcher& operator=(const TuningWatcher&) = delete;
+
+		/**
+		 * @brief Loads both files on the calling thread and publishes the first snapshot.
+		 *
+		 * Returns false (logged) if either fails, so a broken file fails fast at start-up.
+		 */
+		[[nodiscard]] bool start();
+
+		/**
+		 * @brief Queues a check of the files once POLL_INTERVAL has passed and the previous one finished.
+		 *
+		 * Cheap enough to call every frame; never blocks.
+		 */
+		void poll();
+
+		/**
+		 * @brief The newest published snapshot (null before start()); safe from any thread.
+		 */
+		[[nodiscard]] std::shared_ptr<const TuningSnapshot> latest() const { return std::atomic_load(&m_latest); }
+
+	private:
+		// Reloads whatever changed since the last check and publishes it; false if nothing was published
+		bool check();
+		void publish();
+
+		ThreadPool& m_pool;
+		TaskGroup m_checks;
+		std::chrono::steady_clock::time_point m_nextCheck;
+
+		const std::string m_tuningPath;
+		const std::string m_profilesPath;
+		const std::string m_vehicle;
+
+		// Only touched by the check in flight
+		std::filesystem::file_time_type m_tuningStamp{};
+		std::filesystem::file_time_type m_profilesStamp{};
+		Tuning m_tuning;
+		WarningProfile m_profile;
+		std::uint64_t m_version = 0U;
+
+		std::shared_ptr<const TuningSnapshot> m_latest; // swapped with std::atomic_store
+	};
+
+} // namespace sim
@@ -0,0 +1,481 @@
+#include "VehicleDynamics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "DeterministicMath.hpp"
+#include "FastTrig.hpp"
+#include "SimdIntrinsics.hpp"
+
+namespace sim {
+
+	namespace {
+		using constants::DEG_TO_RAD;
+		using constants::RAD_TO_DEG;
+
+		[[nodiscard]] bool hasInput(CarInput input, std::uint8_t bit) {
+			return (input & bit) != 0U;
+		}
+
+		[[nodiscard]] float throttleOf(CarInput input) {
+			float throttle = 0.0F;
+			if (hasInput(input, input::FORWARD)) { throttle += 1.0F; }
+			if (hasInput(input, input::BACKWARD)) { throttle -= 1.0F; }
+			return throttle;
+		}
+
+		[[nodiscard]] float steerOf(CarInput input) {
+			float steer = 0.0F;
+			if (hasInput(input, input::LEFT)) { steer -= 1.0F; }
+			if (hasInput(input, input::RIGHT)) { steer += 1.0F; }
+			return steer;
+		}
+
+		// Speed after one tick: drive (brake while opposing the motion) or coast towards 0
+		[[nodiscard]] float nextSpeed(float speed, float throttle, const BicycleParams& params, float dt) {
+			if (throttle == 0.0F) {
+				const float drag = std::min(params.coastDrag * dt, std::fabs(speed));
+				return (speed > 0.0F) ? speed - drag : speed + drag;
+			}
+			const float rate = (throttle * speed < 0.0F) ? params.braking : params.acceleration;
+			return std::clamp(speed + throttle * rate * dt, -params.maxReverse, params.maxSpeed);
+		}
+
+		// Per-tick constants shared by every lane
+		struct Coefficients {
+			float dt;
+			float accelDt;
+			float brakeDt;
+			float dragDt;
+			float steerStep; // radians per tick
+			float maxSpeed;
+			float maxReverse;
+			float dtOverWheelbase;
+		};
+
+		[[nodiscard]] Coefficients coefficients(const BicycleParams& params, float dt) {
+			return { dt, params.acceleration * dt, params.braking * dt, params.coastDrag * dt,
+				params.steerRate * DEG_TO_RAD * dt, params.maxSpeed, params.maxReverse,
+				dt / std::max(params.wheelbase, 1.0F) };
+		}
+
+		/*
+		 * Polynomials used by both kernels. Steer stays within 45 degrees, where
+		 * the tan series is within 0.05% at the default 35 degree lock (0.3% at
+		 * 45), and the yaw per tick stays within a few degrees, where the sin and
+		 * cos series are exact to float precision; the direction is brought
+		 * back to unit length with one Newton step each tick.
+		 */
+		[[nodiscard]] float tanSeries(float x) {
+			const float x2 = x * x;
+			return x * (1.0F + x2 * (1.0F / 3.0F + x2 * (2.0F / 15.0F + x2 * (17.0F / 315.0F))));
+		}
+
+		void stepLane(const Coefficients& k, float throttle, float target,
+			float& x, float& y, float& dirX, float& dirY, float& speed, float& steer)
+		{
+			// Branch-free form of nextSpeed(), so the vector kernel can match it lane for lane
+			const float rate = (throttle * speed < 0.0F) ? k.brakeDt : k.accelDt;
+			const float driven = std::min(std::max(speed + throttle * rate, -k.maxReverse), k.maxSpeed);
+			const float drag = std::min(k.dragDt, std::fabs(speed));
+			const float coasted = speed - std::copysign(drag, speed);
+			speed = (throttle == 0.0F) ? coasted : driven;
+
+			steer += std::min(std::max(target - steer, -k.steerStep), k.steerStep);
+
+			const float yaw = speed * tanSeries(steer) * k.dtOverWheelbase;
+			const float yaw2 = yaw * yaw;
+			const float c = 1.0F - yaw2 * (0.5F - yaw2 * (1.0F / 24.0F));
+			const float s = yaw * (1.0F - yaw2 * (1.0F / 6.0F - yaw2 * (1.0F / 120.0F)));
+
+			const float rx = dirX * c - dirY * s;
+			const float ry = dirX * s + dirY * c;
+			const float renorm = 1.5F - 0.5F * (rx * rx + ry * ry);
+			dirX = rx * renorm;
+			dirY = ry * renorm;
+
+			x += dirX * speed * k.dt;
+			y += dirY * speed * k.dt;
+		}
+
+		// The batch's columns, for the vector kernels
+		struct VehicleLanes {
+			float* x;
+			float* y;
+			float* dirX;
+			float* dirY;
+			float* speed;
+			float* steer;
+			const float* throttle;
+			const float* target;
+		};
+
+		/*
+		 * Vector kernels: stepLane() on 4, 8 or 16 lanes with the same operations
+		 * in the same order and no fused multiply-add, so every level gives the
+		 * same bits as the others and as the scalar tail. Each steps whole
+		 * vectors from i and returns where it stopped.
+		 */
+#if defined(OKPP_SIMD_X86)
+		// SSE2 has no blend: select(mask, a, b) = (mask & a) | (~mask & b)
+		OKPP_TARGET_SSE2 inline __m128 vehicleSelectSse2(__m128 mask, __m128 a, __m128 b) {
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		OKPP_TARGET_SSE2 inline __m128 vehiclePolySse2(__m128 x2, float c0, float c1, float c2) {
+			return _mm_add_ps(_mm_set1_ps(c0), _mm_mul_ps(x2, _mm_add_ps(_mm_set1_ps(c1), _mm_mul_ps(x2, _mm_set1_ps(c2)))));
+		}
+
+		OKPP_TARGET_SSE2 std::size_t vehicleStepSse2(const Coefficients& k, const VehicleLanes& lanes, std::size_t i, std::size_t end) {
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0F);
+			const __m128 signBit = _mm_set1_ps(-0.0F);
+			const __m128 vDt = _mm_set1_ps(k.dt);
+			const __m128 accelDt = _mm_set1_ps(k.accelDt);
+			const __m128 brakeDt = _mm_set1_ps(k.brakeDt);
+			const __m128 dragDt = _mm_set1_ps(k.dragDt);
+			const __m128 steerStep = _mm_set1_ps(k.steerStep);
+			const __m128 minSteerStep = _mm_set1_ps(-k.steerStep);
+			const __m128 maxSpeed = _mm_set1_ps(k.maxSpeed);
+			const __m128 minSpeed = _mm_set1_ps(-k.maxReverse);
+			const __m128 dtOverWheelbase = _mm_set1_ps(k.dtOverWheelbase);
+
+			for (; i + 4U <= end; i += 4U) {
+				const __m128 throttle = _mm_loadu_ps(lanes.throttle + i);
+				__m128 speed = _mm_loadu_ps(lanes.speed + i);
+				__m128 steer = _mm_loadu_ps(lanes.steer + i);
+
+				const __m128 opposing = _mm_cmplt_ps(_mm_mul_ps(throttle, speed), zero);
+				const __m128 rate = vehicleSelectSse2(opposing, brakeDt, accelDt);
+				const __m128 driven = _mm_min_ps(_mm_max_ps(_mm_add_ps(speed, _mm_mul_ps(throttle, rate)), minSpeed), maxSpeed);
+				const __m128 drag = _mm_min_ps(dragDt, _mm_andnot_ps(signBit, speed));
+				const __m128 coasted = _mm_sub_ps(speed, _mm_or_ps(drag, _mm_and_ps(signBit, speed)));
+				speed = vehicleSelectSse2(_mm_cmpeq_ps(throttle, zero), coasted, driven);
+
+				const __m128 steerDelta = _mm_sub_ps(_mm_loadu_ps(lanes.target + i), steer);
+				steer = _mm_add_ps(steer, _mm_min_ps(_mm_max_ps(steerDelta, minSteerStep), steerStep));
+
+				const __m128 steer2 = _mm_mul_ps(steer, steer);
+				const __m128 tanSteer = _mm_mul_ps(steer, _mm_add_ps(one, _mm_mul_ps(steer2,
+					vehiclePolySse2(steer2, 1.0F / 3.0F, 2.0F / 15.0F, 17.0F / 315.0F))));
+				const __m128 yaw = _mm_mul_ps(_mm_mul_ps(speed, tanSteer), dtOverWheelbase);
+				const __m128 yaw2 = _mm_mul_ps(yaw, yaw);
+				const __m128 c = _mm_sub_ps(one, _mm_mul_ps(yaw2, _mm_sub_ps(_mm_set1_ps(0.5F), _mm_mul_ps(yaw2, _mm_set1_ps(1.0F / 24.0F)))));
+				const __m128 s = _mm_mul_ps(yaw, _mm_sub_ps(one, _mm_mul_ps(yaw2, _mm_sub_ps(_mm_set1_ps(1.0F / 6.0F), _mm_mul_ps(yaw2, _mm_set1_ps(1.0F / 120.0F))))));
+
+				const __m128 dirX = _mm_loadu_ps(lanes.dirX + i);
+				const __m128 dirY = _mm_loadu_ps(lanes.dirY + i);
+				const __m128 rx = _mm_sub_ps(_mm_mul_ps(dirX, c), _mm_mul_ps(dirY, s));
+				const __m128 ry = _mm_add_ps(_mm_mul_ps(dirX, s), _mm_mul_ps(dirY, c));
+				const __m128 renorm = _mm_sub_ps(_mm_set1_ps(1.5F), _mm_mul_ps(_mm_set1_ps(0.5F), _mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry))));
+				const __m128 newDirX = _mm_mul_ps(rx, renorm);
+				const __m128 newDirY = _mm_mul_ps(ry, renorm);
+
+				const __m128 travel = _mm_mul_ps(speed, vDt);
+				_mm_storeu_ps(lanes.x + i, _mm_add_ps(_mm_loadu_ps(lanes.x + i), _mm_mul_ps(newDirX, travel)));
+				_mm_storeu_ps(lanes.y + i, _mm_add_ps(_mm_loadu_ps(lanes.y + i), _mm_mul_ps(newDirY, travel)));
+				_mm_storeu_ps(lanes.dirX + i, newDirX);
+				_mm_storeu_ps(lanes.dirY + i, newDirY);
+				_mm_storeu_ps(lanes.speed + i, speed);
+				_mm_storeu_ps(lanes.steer + i, steer);
+			}
+			return i;
+		}
+
+		OKPP_TARGET_AVX2 inline __m256 vehiclePolyAvx2(__m256 x2, float c0, float c1, float c2) {
+			return _mm256_add_ps(_mm256_set1_ps(c0), _mm256_mul_ps(x2, _mm256_add_ps(_mm256_set1_ps(c1), _mm256_mul_ps(x2, _mm256_set1_ps(c2)))));
+		}
+
+		OKPP_TARGET_AVX2 std::size_t vehicleStepAvx2(const Coefficients& k, const VehicleLanes& lanes, std::size_t i, std::size_t end) {
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 one = _mm256_set1_ps(1.0F);
+			const __m256 signBit = _mm256_set1_ps(-0.0F);
+			const __m256 vDt = _mm256_set1_ps(k.dt);
+			const __m256 accelDt = _mm256_set1_ps(k.accelDt);
+			const __m256 brakeDt = _mm256_set1_ps(k.brakeDt);
+			const __m256 dragDt = _mm256_set1_ps(k.dragDt);
+			const __m256 steerStep = _mm256_set1_ps(k.steerStep);
+			const __m256 minSteerStep = _mm256_set1_ps(-k.steerStep);
+			const __m256 maxSpeed = _mm256_set1_ps(k.maxSpeed);
+			const __m256 minSpeed = _mm256_set1_ps(-k.maxReverse);
+			const __m256 dtOverWheelbase = _mm256_set1_ps(k.dtOverWheelbase);
+
+			for (; i + 8U <= end; i += 8U) {
+				const __m256 throttle = _mm256_loadu_ps(lanes.throttle + i);
+				__m256 speed = _mm256_loadu_ps(lanes.speed + i);
+				__m256 steer = _mm256_loadu_ps(lanes.steer + i);
+
+				const __m256 opposing = _mm256_cmp_ps(_mm256_mul_ps(throttle, speed), zero, _CMP_LT_OQ);
+				const __m256 rate = _mm256_blendv_ps(accelDt, brakeDt, opposing);
+				const __m256 driven = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(speed, _mm256_mul_ps(throttle, rate)), minSpeed), maxSpeed);
+				const __m256 drag = _mm256_min_ps(dragDt, _mm256_andnot_ps(signBit, speed));
+				const __m256 coasted = _mm256_sub_ps(speed, _mm256_or_ps(drag, _mm256_and_ps(signBit, speed)));
+				speed = _mm256_blendv_ps(driven, coasted, _mm256_cmp_ps(throttle, zero, _CMP_EQ_OQ));
+
+				const __m256 steerDelta = _mm256_sub_ps(_mm256_loadu_ps(lanes.target + i), steer);
+				steer = _mm256_add_ps(steer, _mm256_min_ps(_mm256_max_ps(steerDelta, minSteerStep), steerStep));
+
+				const __m256 steer2 = _mm256_mul_ps(steer, steer);
+				const __m256 tanSteer = _mm256_mul_ps(steer, _mm256_add_ps(one, _mm256_mul_ps(steer2,
+					vehiclePolyAvx2(steer2, 1.0F / 3.0F, 2.0F / 15.0F, 17.0F / 315.0F))));
+				const __m256 yaw = _mm256_mul_ps(_mm256_mul_ps(speed, tanSteer), dtOverWheelbase);
+				const __m256 yaw2 = _mm256_mul_ps(yaw, yaw);
+				const __m256 c = _mm256_sub_ps(one, _mm256_mul_ps(yaw2, _mm256_sub_ps(_mm256_set1_ps(0.5F), _mm256_mul_ps(yaw2, _mm256_set1_ps(1.0F / 24.0F)))));
+				const __m256 s = _mm256_mul_ps(yaw, _mm256_sub_ps(one, _mm256_mul_ps(yaw2, _mm256_sub_ps(_mm256_set1_ps(1.0F / 6.0F), _mm256_mul_ps(yaw2, _mm256_set1_ps(1.0F / 120.0F))))));
+
+				const __m256 dirX = _mm256_loadu_ps(lanes.dirX + i);
+				const __m256 dirY = _mm256_loadu_ps(lanes.dirY + i);
+				const __m256 rx = _mm256_sub_ps(_mm256_mul_ps(dirX, c), _mm256_mul_ps(dirY, s));
+				const __m256 ry = _mm256_add_ps(_mm256_mul_ps(dirX, s), _mm256_mul_ps(dirY, c));
+				const __m256 renorm = _mm256_sub_ps(_mm256_set1_ps(1.5F), _mm256_mul_ps(_mm256_set1_ps(0.5F), _mm256_add_ps(_mm256_mul_ps(rx, rx), _mm256_mul_ps(ry, ry))));
+				const __m256 newDirX = _mm256_mul_ps(rx, renorm);
+				const __m256 newDirY = _mm256_mul_ps(ry, renorm);
+
+				const __m256 travel = _mm256_mul_ps(speed, vDt);
+				_mm256_storeu_ps(lanes.x + i, _mm256_add_ps(_mm256_loadu_ps(lanes.x + i), _mm256_mul_ps(newDirX, travel)));
+				_mm256_storeu_ps(lanes.y + i, _mm256_add_ps(_mm256_loadu_ps(lanes.y + i), _mm256_mul_ps(newDirY, travel)));
+				_mm256_storeu_ps(lanes.dirX + i, newDirX);
+				_mm256_storeu_ps(lanes.dirY + i, newDirY);
+				_mm256_storeu_ps(lanes.speed + i, speed);
+				_mm256_storeu_ps(lanes.steer + i, steer);
+			}
+			return i;
+		}
+
+		OKPP_TARGET_AVX512 inline __m512 vehiclePolyAvx512(__m512 x2, float c0, float c1, float c2) {
+			return _mm512_add_ps(_mm512_set1_ps(c0), _mm512_mul_ps(x2, _mm512_add_ps(_mm512_set1_ps(c1), _mm512_mul_ps(x2, _mm512_set1_ps(c2)))));
+		}
+
+		// AVX-512F has no float and/or; the sign bit is handled on the integer view
+		OKPP_TARGET_AVX512 std::size_t vehicleStepAvx512(const Coefficients& k, const VehicleLanes& lanes, std::size_t i, std::size_t end) {
+			const __m512 zero = _mm512_setzero_ps();
+			const __m512 one = _mm512_set1_ps(1.0F);
+			const __m512i signBit = _mm512_set1_epi32(static_cast<int>(0x80000000U));
+			const __m512 vDt = _mm512_set1_ps(k.dt);
+			const __m512 accelDt = _mm512_set1_ps(k.accelDt);
+			const __m512 brakeDt = _mm512_set1_ps(k.brakeDt);
+			const __m512 dragDt = _mm512_set1_ps(k.dragDt);
+			const __m512 steerStep = _mm512_set1_ps(k.steerStep);
+			const __m512 minSteerStep = _mm512_set1_ps(-k.steerStep);
+			const __m512 maxSpeed = _mm512_set1_ps(k.maxSpeed);
+			const __m512 minSpeed = _mm512_set1_ps(-k.maxReverse);
+			const __m512 dtOverWheelbase = _mm512_set1_ps(k.dtOverWheelbase);
+
+			for (; i + 16U <= end; i += 16U) {
+				const __m512 throttle = _mm512_loadu_ps(lanes.throttle + i);
+				__m512 speed = _mm512_loadu_ps(lanes.speed + i);
+				__m512 steer = _mm512_loadu_ps(lanes.steer + i);
+
+				const __mmask16 opposing = _mm512_cmp_ps_mask(_mm512_mul_ps(throttle, speed), zero, _CMP_LT_OQ);
+				const __m512 rate = _mm512_mask_blend_ps(opposing, accelDt, brakeDt);
+				const __m512 driven = _mm512_min_ps(_mm512_max_ps(_mm512_add_ps(speed, _mm512_mul_ps(throttle, rate)), minSpeed), maxSpeed);
+				const __m512i speedBits = _mm512_castps_si512(speed);
+				const __m512 drag = _mm512_min_ps(dragDt, _mm512_castsi512_ps(_mm512_andnot_epi32(signBit, speedBits)));
+				const __m512 signedDrag = _mm512_castsi512_ps(_mm512_or_epi32(_mm512_castps_si512(drag), _mm512_and_epi32(signBit, speedBits)));
+				speed = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(throttle, zero, _CMP_EQ_OQ), driven, _mm512_sub_ps(speed, signedDrag));
+
+				const __m512 steerDelta = _mm512_sub_ps(_mm512_loadu_ps(lanes.target + i), steer);
+				steer = _mm512_add_ps(steer, _mm512_min_ps(_mm512_max_ps(steerDelta, minSteerStep), steerStep));
+
+				const __m512 steer2 = _mm512_mul_ps(steer, steer);
+				const __m512 tanSteer = _mm512_mul_ps(steer, _mm512_add_ps(one, _mm512_mul_ps(steer2,
+					vehiclePolyAvx512(steer2, 1.0F / 3.0F, 2.0F / 15.0F, 17.0F / 315.0F))));
+				const __m512 yaw = _mm512_mul_ps(_mm512_mul_ps(speed, tanSteer), dtOverWheelbase);
+				const __m512 yaw2 = _mm512_mul_ps(yaw, yaw);
+				const __m512 c = _mm512_sub_ps(one, _mm512_mul_ps(yaw2, _mm512_sub_ps(_mm512_set1_ps(0.5F), _mm512_mul_ps(yaw2, _mm512_set1_ps(1.0F / 24.0F)))));
+				const __m512 s = _mm512_mul_ps(yaw, _mm512_sub_ps(one, _mm512_mul_ps(yaw2, _mm512_sub_ps(_mm512_set1_ps(1.0F / 6.0F), _mm512_mul_ps(yaw2, _mm512_set1_ps(1.0F / 120.0F))))));
+
+				const __m512 dirX = _mm512_loadu_ps(lanes.dirX + i);
+				const __m512 dirY = _mm512_loadu_ps(lanes.dirY + i);
+				const __m512 rx = _mm512_sub_ps(_mm512_mul_ps(dirX, c), _mm512_mul_ps(dirY, s));
+				const __m512 ry = _mm512_add_ps(_mm512_mul_ps(dirX, s), _mm512_mul_ps(dirY, c));
+				const __m512 renorm = _mm512_sub_ps(_mm512_set1_ps(1.5F), _mm512_mul_ps(_mm512_set1_ps(0.5F), _mm512_add_ps(_mm512_mul_ps(rx, rx), _mm512_mul_ps(ry, ry))));
+				const __m512 newDirX = _mm512_mul_ps(rx, renorm);
+				const __m512 newDirY = _mm512_mul_ps(ry, renorm);
+
+				const __m512 travel = _mm512_mul_ps(speed, vDt);
+				_mm512_storeu_ps(lanes.x + i, _mm512_add_ps(_mm512_loadu_ps(lanes.x + i), _mm512_mul_ps(newDirX, travel)));
+				_mm512_storeu_ps(lanes.y + i, _mm512_add_ps(_mm512_loadu_ps(lanes.y + i), _mm512_mul_ps(newDirY, travel)));
+				_mm512_storeu_ps(lanes.dirX + i, newDirX);
+				_mm512_storeu_ps(lanes.dirY + i, newDirY);
+				_mm512_storeu_ps(lanes.speed + i, speed);
+				_mm512_storeu_ps(lanes.steer + i, steer);
+			}
+			return i;
+		}
+#elif defined(OKPP_SIMD_NEON)
+		[[nodiscard]] float32x4_t vehiclePolyNeon(float32x4_t x2, float c0, float c1, float c2) {
+			return vmlaq_f32(vdupq_n_f32(c0), x2, vmlaq_f32(vdupq_n_f32(c1), x2, vdupq_n_f32(c2)));
+		}
+
+		std::size_t vehicleStepNeon(const Coefficients& k, const VehicleLanes& lanes, std::size_t i, std::size_t end) {
+			const float32x4_t zero = vdupq_n_f32(0.0F);
+			const float32x4_t one = vdupq_n_f32(1.0F);
+			const float32x4_t vDt = vdupq_n_f32(k.dt);
+			const float32x4_t accelDt = vdupq_n_f32(k.accelDt);
+			const float32x4_t brakeDt = vdupq_n_f32(k.brakeDt);
+			const float32x4_t dragDt = vdupq_n_f32(k.dragDt);
+			const float32x4_t steerStep = vdupq_n_f32(k.steerStep);
+			const float32x4_t minSteerStep = vdupq_n_f32(-k.steerStep);
+			const float32x4_t maxSpeed = vdupq_n_f32(k.maxSpeed);
+			const float32x4_t minSpeed = vdupq_n_f32(-k.maxReverse);
+			const float32x4_t dtOverWheelbase = vdupq_n_f32(k.dtOverWheelbase);
+			const uint32x4_t signBit = vdupq_n_u32(0x80000000U);
+
+			for (; i + 4U <= end; i += 4U) {
+				const float32x4_t throttle = vld1q_f32(lanes.throttle + i);
+				float32x4_t speed = vld1q_f32(lanes.speed + i);
+				float32x4_t steer = vld1q_f32(lanes.steer + i);
+
+				const uint32x4_t opposing = vcltq_f32(vmulq_f32(throttle, speed), zero);
+				const float32x4_t rate = vbslq_f32(opposing, brakeDt, accelDt);
+				const float32x4_t driven = vminq_f32(vmaxq_f32(vmlaq_f32(speed, throttle, rate), minSpeed), maxSpeed);
+				const float32x4_t drag = vminq_f32(dragDt, vabsq_f32(speed));
+				const float32x4_t signedDrag = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(drag),
+					vandq_u32(vreinterpretq_u32_f32(speed), signBit)));
+				speed = vbslq_f32(vceqq_f32(throttle, zero), vsubq_f32(speed, signedDrag), driven);
+
+				const float32x4_t steerDelta = vsubq_f32(vld1q_f32(lanes.target + i), steer);
+				steer = vaddq_f32(steer, vminq_f32(vmaxq_f32(steerDelta, minSteerStep), steerStep));
+
+				const float32x4_t steer2 = vmulq_f32(steer, steer);
+				const float32x4_t tanSteer = vmulq_f32(steer, vmlaq_f32(one, steer2,
+					vehiclePolyNeon(steer2, 1.0F / 3.0F, 2.0F / 15.0F, 17.0F / 315.0F)));
+				const float32x4_t yaw = vmulq_f32(vmulq_f32(speed, tanSteer), dtOverWheelbase);
+				const float32x4_t yaw2 = vmulq_f32(yaw, yaw);
+				const float32x4_t c = vmlsq_f32(one, yaw2, vmlsq_f32(vdupq_n_f32(0.5F), yaw2, vdupq_n_f32(1.0F / 24.0F)));
+				const float32x4_t s = vmulq_f32(yaw, vmlsq_f32(one, yaw2, vmlsq_f32(vdupq_n_f32(1.0F / 6.0F), yaw2, vdupq_n_f32(1.0F / 120.0F))));
+
+				const float32x4_t dirX = vld1q_f32(lanes.dirX + i);
+				const float32x4_t dirY = vld1q_f32(lanes.dirY + i);
+				const float32x4_t rx = vmlsq_f32(vmulq_f32(dirX, c), dirY, s);
+				const float32x4_t ry = vmlaq_f32(vmulq_f32(dirX, s), dirY, c);
+				const float32x4_t renorm = vmlsq_f32(vdupq_n_f32(1.5F), vdupq_n_f32(0.5F), vmlaq_f32(vmulq_f32(rx, rx), ry, ry));
+				const float32x4_t newDirX = vmulq_f32(rx, renorm);
+				const float32x4_t newDirY = vmulq_f32(ry, renorm);
+
+				const float32x4_t travel = vmulq_f32(speed, vDt);
+				vst1q_f32(lanes.x + i, vmlaq_f32(vld1q_f32(lanes.x + i), newDirX, travel));
+				vst1q_f32(lanes.y + i, vmlaq_f32(vld1q_f32(lanes.y + i), newDirY, travel));
+				vst1q_f32(lanes.dirX + i, newDirX);
+				vst1q_f32(lanes.dirY + i, newDirY);
+				vst1q_f32(lanes.speed + i, speed);
+				vst1q_f32(lanes.steer + i, steer);
+			}
+			return i;
+		}
+#endif
+	}
+
+	void stepBicycle(BicycleState& state, CarInput input, const BicycleParams& params, float dt) {
+		const float target = steerOf(input) * std::min(params.maxSteerDeg, 45.0F);
+		const float steerStep = params.steerRate * dt;
+		state.steerDeg += std::clamp(target - state.steerDeg, -steerStep, steerStep);
+		state.speed = nextSpeed(state.speed, throttleOf(input), params, dt);
+
+		const float yawDeg = state.speed * dmath::tanDeg(state.steerDeg)
+			/ std::max(params.wheelbase, 1.0F) * dt * RAD_TO_DEG;
+		state.pose.headingDeg = std::fmod(state.pose.headingDeg + yawDeg, 360.0F);
+
+		const SinCos heading = sinCosDeg(state.pose.headingDeg);
+		state.pose.position += sf::Vector2f{ heading.cos, heading.sin } * (state.speed * dt);
+	}
+
+	float pathCurvature(const BicycleState& state, const BicycleParams& params) noexcept {
+		return dmath::tanDeg(state.steerDeg) / std::max(params.wheelbase, 1.0F);
+	}
+
+	void VehicleBatch::resize(std::size_t count) {
+		m_count = count;
+		const std::size_t padded = roundUpToLine(count, LANES);
+
+		m_x.resize(padded, 0.0F);
+		m_y.resize(padded, 0.0F);
+		m_dirX.resize(padded, 1.0F);
+		m_dirY.resize(padded, 0.0F);
+		m_speed.resize(padded, 0.0F);
+		m_steer.resize(padded, 0.0F);
+		m_throttle.resize(padded, 0.0F);
+		m_steerTarget.resize(padded, 0.0F);
+	}
+
+	void VehicleBatch::set(std::size_t index, const BicycleState& state) {
+		const SinCos heading = sinCosDeg(state.pose.headingDeg);
+		m_x[index] = state.pose.position.x;
+		m_y[index] = state.pose.position.y;
+		m_dirX[index] = heading.cos;
+		m_dirY[index] = heading.sin;
+		m_speed[index] = state.speed;
+		m_steer[index] = state.steerDeg * DEG_TO_RAD;
+	}
+
+	BicycleState VehicleBatch::get(std::size_t index) const {
+		BicycleState state;
+		state.pose = pose(index);
+		state.speed = m_speed[index];
+		state.steerDeg = steerDeg(index);
+		return state;
+	}
+
+	CarState VehicleBatch::pose(std::size_t index) const {
+		CarState pose;
+		pose.position = { m_x[index], m_y[index] };
+		pose.headingDeg = dmath::atan2Deg(m_dirY[index], m_dirX[index]);
+		return pose;
+	}
+
+	float VehicleBatch::steerDeg(std::size_t index) const noexcept {
+		return m_steer[index] * RAD_TO_DEG;
+	}
+
+	void VehicleBatch::decodeInputs(const CarInput* inputs, const BicycleParams& params, std::size_t begin, std::size_t end) {
+		const float lock = std::min(params.maxSteerDeg, 45.0F) * DEG_TO_RAD;
+		for (std::size_t i = begin; i < end; ++i) {
+			m_throttle[i] = throttleOf(inputs[i]);
+			m_steerTarget[i] = steerOf(inputs[i]) * lock;
+		}
+	}
+
+	void stepVehiclesScalar(VehicleBatch& batch, const CarInput* inputs, const BicycleParams& params,
+		float dt, std::size_t begin, std::size_t end)
+	{
+		end = std::min(end, batch.size());
+		batch.decodeInputs(inputs, params, begin, end);
+
+		const Coefficients k = coefficients(params, dt);
+		for (std::size_t i = begin; i < end; ++i) {
+			stepLane(k, batch.m_throttle[i], batch.m_steerTarget[i],
+				batch.m_x[i], batch.m_y[i], batch.m_dirX[i], batch.m_dirY[i], batch.m_speed[i], batch.m_steer[i]);
+		}
+	}
+
+	void stepVehiclesSimd(VehicleBatch& batch, const CarInput* inputs, const BicycleParams& params,
+		float dt, std::size_t begin, std::size_t end)
+	{
+		end = std::min(end, batch.size());
+		batch.decodeInputs(inputs, params, begin, end);
+
+		const Coefficients k = coefficients(params, dt);
+		std::size_t i = begin;
+
+		const VehicleLanes lanes{ batch.m_x.data(), batch.m_y.data(), batch.m_dirX.data(), batch.m_dirY.data(),
+			batch.m_speed.data(), batch.m_steer.data(), batch.m_throttle.data(), batch.m_steerTarget.data() };
+		switch (simdLevel()) {
+#if defined(OKPP_SIMD_X86)
+		case SimdLevel::Avx512: i = vehicleStepAvx512(k, lanes, i, end); break;
+		case SimdLevel::Avx2: i = vehicleStepAvx2(k, lanes, i, end); break;
+		case SimdLevel::Sse2: i = vehicleStepSse2(k, lanes, i, end); break;
+#elif defined(OKPP_SIMD_NEON)
+		case SimdLevel::Neon: i = vehicleStepNeon(k, lanes, i, end); break;
+#endif
+		default: break;
+		}
+
+		// Tail (and the whole range without a vector unit)
+		for (; i < end; ++i) {
+			stepLane(k, lanes.throttle[i], lanes.target[i], lanes.x[i], lanes.y[i],
+				lanes.dirX[i], lanes.dirY[i], lanes.speed[i], lanes.steer[i]);
+		}
+	}
+
+} // namespace sim
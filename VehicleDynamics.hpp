@@ -0,0 +1,124 @@
+/*
+==============================================================================
+Vehicle Dynamics - kinematic bicycle model, single car and SoA batches
+==============================================================================
+ - The car turns about its rear axle: yaw rate = speed * tan(steer) / wheelbase,
+   so a parked car cannot spin on the spot and tighter locks turn sharper
+ - Throttle accelerates up to a forward or reverse top speed, brakes when
+   it opposes the motion and the car coasts to a stop without input; the
+   front wheel turns towards the driver's lock at a limited rate
+ - VehicleBatch keeps thousands of vehicles in structure-of-arrays form,
+   each column cache-line aligned and padded to whole lines (LANES floats),
+   so ranges split on LANES never share a line; the heading is a unit
+   direction vector rotated by a short polynomial each tick, so the kernel
+   has no libm calls and is branch-free across lanes
+ - Kernel is picked per call from simdLevel(): AVX-512 (16 lanes), AVX2
+   (8), SSE2 or NEON (4), or the scalar reference; all run the same
+   arithmetic in the same order, so the level never changes a result
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CacheAligned.hpp"
+#include "CarModel.hpp"
+
+namespace sim {
+
+	// Motion model the car is driven with
+	enum class VehicleModel : std::uint8_t {
+		Arcade, // stepCar(): constant speed, turns on the spot (the original controls)
+		Bicycle // stepBicycle(): wheelbase, steering lock and acceleration
+	};
+
+	struct BicycleParams {
+		float wheelbase = 175.0F;    // pixels between the axles
+		float maxSteerDeg = 35.0F;   // front wheel lock (at most 45)
+		float steerRate = 120.0F;    // degrees per second the wheel turns
+		float acceleration = 600.0F; // pixels/s^2 under throttle
+		float braking = 1500.0F;     // pixels/s^2 while the throttle opposes the motion
+		float coastDrag = 300.0F;    // pixels/s^2 without throttle
+		float maxSpeed = 500.0F;     // forward top speed, pixels per second
+		float maxReverse = 200.0F;   // reverse top speed, pixels per second
+	};
+
+	struct BicycleState {
+		CarState pose;
+		float speed = 0.0F;    // pixels per second along the heading, negative in reverse
+		float steerDeg = 0.0F; // front wheel angle, clockwise positive like the heading
+	};
+
+	/**
+	 * @brief Advances one car by one fixed tick of dt seconds (libm trig, reference path).
+	 */
+	void stepBicycle(BicycleState& state, CarInput input, const BicycleParams& params, float dt);
+
+	/**
+	 * @brief Heading change (radians, clockwise positive) per pixel travelled at the
+	 *        current wheel angle, the same either way the car moves.
+	 */
+	[[nodiscard]] float pathCurvature(const BicycleState& state, const BicycleParams& params) noexcept;
+
+	class VehicleBatch {
+	public:
+		// Arrays are padded to a multiple of this many floats: one cache line
+		static constexpr std::size_t LANES = perCacheLine<float>();
+
+		/**
+		 * @brief Resizes to count vehicles; new ones are parked at the origin facing +X.
+		 */
+		void resize(std::size_t count);
+
+		void set(std::size_t index, const BicycleState& state);
+		[[nodiscard]] BicycleState get(std::size_t index) const;
+
+		/**
+		 * @brief Pose of one vehicle (one atan2 for the heading).
+		 */
+		[[nodiscard]] CarState pose(std::size_t index) const;
+
+		[[nodiscard]] float speed(std::size_t index) const noexcept { return m_speed[index]; }
+		[[nodiscard]] float steerDeg(std::size_t index) const noexcept;
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_count; }
+		[[nodiscard]] std::size_t paddedSize() const noexcept { return m_x.size(); }
+
+	private:
+		friend void stepVehiclesScalar(VehicleBatch&, const CarInput*, const BicycleParams&, float, std::size_t, std::size_t);
+		friend void stepVehiclesSimd(VehicleBatch&, const CarInput*, const BicycleParams&, float, std::size_t, std::size_t);
+
+		void decodeInputs(const CarInput* inputs, const BicycleParams& params, std::size_t begin, std::size_t end);
+
+		CacheAlignedVector<float> m_x;
+		CacheAlignedVector<float> m_y;
+		CacheAlignedVector<float> m_dirX; // unit heading
+		CacheAlignedVector<float> m_dirY;
+		CacheAlignedVector<float> m_speed;
+		CacheAlignedVector<float> m_steer; // radians
+
+		// Per-tick input, decoded once per range before the kernel runs
+		CacheAlignedVector<float> m_throttle;    // -1, 0 or 1
+		CacheAlignedVector<float> m_steerTarget; // radians
+		std::size_t m_count = 0U;
+	};
+
+	/**
+	 * @brief Reference kernel: vehicles [begin, end) by one tick, one at a time.
+	 *
+	 * inputs holds one entry per vehicle of the batch, indexed like it.
+	 * Disjoint ranges may be stepped from different threads.
+	 */
+	void stepVehiclesScalar(VehicleBatch& batch, const CarInput* inputs, const BicycleParams& params,
+		float dt, std::size_t begin, std::size_t end);
+
+	/**
+	 * @brief Vectorized kernel: same arithmetic as the reference, 4 lanes at a time.
+	 */
+	void stepVehiclesSimd(VehicleBatch& batch, const CarInput* inputs, const BicycleParams& params,
+		float dt, std::size_t begin, std::size_t end);
+
+} // namespace sim
@@ -0,0 +1,127 @@
+#include "VehiclePose.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "HardwareCounters.hpp"
+#include "Sensors.hpp"
+
+namespace sim {
+
+	VehiclePose::VehiclePose(const sf::Vector2f& halfExtent, std::vector<SensorMount> mounts, std::vector<SensorPose> sensors)
+		: m_halfExtent(halfExtent), m_mounts(std::move(mounts)), m_carSensorCount(sensors.size()), m_sensors(std::move(sensors))
+	{
+		m_hull.halfExtent = halfExtent;
+	}
+
+	void VehiclePose::setShape(const sf::Vector2f& halfExtent, std::vector<SensorMount> mounts, const CarHull& hull) {
+		m_halfExtent = halfExtent;
+		m_hull = hull;
+		m_hull.halfExtent = halfExtent; // an empty hull's footprint is this rectangle
+		joinMounts(std::move(mounts));
+		m_stale = true;
+		++m_version;
+	}
+
+	void VehiclePose::setTrailer(const TrailerParams& params, std::vector<SensorMount> mounts, std::vector<SensorPose> sensors) {
+		std::vector<SensorMount> carMounts(m_mounts.begin(), m_mounts.begin()
+			+ static_cast<std::ptrdiff_t>(std::min(m_carSensorCount, m_mounts.size())));
+		m_sensors.resize(m_carSensorCount);
+		m_sensors.insert(m_sensors.end(), sensors.begin(), sensors.end());
+		m_hasTrailer = true;
+		m_trailer = params;
+		m_trailerMounts = std::move(mounts);
+		m_trailerPose = trailerBehind(m_pose, m_halfExtent, m_trailer);
+		joinMounts(std::move(carMounts));
+		m_stale = true;
+		++m_version;
+	}
+
+	void VehiclePose::setTrailerPose(const CarState& pose) noexcept {
+		if (pose.position != m_trailerPose.position || pose.headingDeg != m_trailerPose.headingDeg) {
+			m_trailerPose = pose;
+			m_stale = true;
+			++m_version;
+		}
+	}
+
+	void VehiclePose::joinMounts(std::vector<SensorMount> carMounts) {
+		m_mounts = std::move(carMounts);
+		m_mounts.resize(m_carSensorCount);
+		if (m_hasTrailer) {
+			const sf::Vector2f rest = trailerRestOffset(m_halfExtent, m_trailer);
+			for (SensorMount mount : m_trailerMounts) {
+				mount.offset += rest;
+				m_mounts.push_back(mount);
+			}
+		}
+	}
+
+	void VehiclePose::setPose(const CarState& pose) noexcept {
+		if (pose.position != m_pose.position || pose.headingDeg != m_pose.headingDeg) {
+			m_pose = pose;
+			m_stale = true;
+			++m_version;
+		}
+	}
+
+	const sf::Transform& VehiclePose::transform() const {
+		refresh();
+		return m_transform;
+	}
+
+	const sf::Transform& VehiclePose::trailerTransform() const {
+		refresh();
+		return m_trailerTransform;
+	}
+
+	const sf::FloatRect& VehiclePose::bounds() const {
+		refresh();
+		return m_bounds;
+	}
+
+	const std::array<sf::Vector2f, 4>& VehiclePose::corners() const {
+		refresh();
+		return m_corners;
+	}
+
+	const std::vector<SensorPose>& VehiclePose::sensors() const {
+		refresh();
+		return m_sensors;
+	}
+
+	void VehiclePose::refresh() const {
+		if (!m_stale) {
+			return;
+		}
+		m_stale = false;
+
+		// One matrix for the corners and the sensor anchors
+		m_transform = carTransform(m_pose);
+		const sf::Vector2f half = m_halfExtent;
+		m_corners = {
+			m_transform.transformPoint({ half.x, -half.y }),
+			m_transform.transformPoint({ half.x, half.y }),
+			m_transform.transformPoint({ -half.x, half.y }),
+			m_transform.transformPoint({ -half.x, -half.y })
+		};
+		// Bit-identical to the uncached path without a hull, so replays match
+		m_bounds = m_hull.empty() ? carBounds(m_pose, half) : hullBounds(m_hull, m_transform);
+
+		if (m_hasTrailer) {
+			m_trailerTransform = carTransform(m_trailerPose);
+		}
+		if (!m_sensors.empty()) {
+			OKPP_HW_COUNTER_SCOPE("updateSensorPositions"); // the front-end's sensor placement, counted with the free function
+			const std::size_t carCount = std::min(m_carSensorCount, m_mounts.size());
+			placeSensors(m_transform, m_pose.headingDeg, m_mounts.data(), std::min(m_sensors.size(), carCount),
+				m_sensors.data());
+			if (m_hasTrailer && m_sensors.size() > m_carSensorCount) {
+				placeSensors(m_trailerTransform, m_trailerPose.headingDeg, m_trailerMounts.data(),
+					std::min(m_sensors.size() - m_carSensorCount, m_trailerMounts.size()), m_sensors.data() + m_carSensorCount);
+			}
+		}
+	}
+
+} // namespace sim
@@ -0,0 +1,144 @@
+/*
+==============================================================================
+Vehicle Pose - per-pose derived geometry of the car, computed at most once
+==============================================================================
+ - Holds the car pose together with what every consumer of a frame derives
+   from it: the local-to-world transform, the axis-aligned bounds, the four
+   corners of the oriented box and the sensor anchors
+ - setPose() only marks the cache stale when the pose actually changed;
+   the derived values are rebuilt on the first read after that, so a
+   frame whose car did not move recomputes nothing, and one that did
+   builds the matrix once for all readers
+ - Given the car's alpha hull (CarHull.hpp), bounds() and footprint()
+   follow the hull instead of the sprite rectangle; corners() stays the
+   rectangle the sprite is drawn in
+ - version() counts the real pose and shape changes, so callers can keep
+   their own results per pose (the front-end's sensor pass of a parked car)
+ - A hitched trailer (Trailer.hpp) is a second body in the same cache: its
+   sensors follow the car's in sensors(), placed in the same refresh by the
+   same batched transform, so every query, fusion and draw pass over the
+   sensors covers both bodies without a second code path. mounts() carries
+   the trailer's mounts too, moved into the car's frame as if towed
+   straight, for the consumers that reason about the whole vehicle
+ - Not thread-safe: reads fill the cache, so one owner thread at a time
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "CarHull.hpp"
+#include "CarModel.hpp"
+#include "SimTypes.hpp"
+#include "Trailer.hpp"
+
+namespace sim {
+
+	class VehiclePose {
+	public:
+		/**
+		 * @brief Car rectangle and sensor layout; sensors gives each sensor's extent.
+		 */
+		VehiclePose(const sf::Vector2f& halfExtent, std::vector<SensorMount> mounts, std::vector<SensorPose> sensors);
+
+		/**
+		 * @brief New car rectangle and mounts (the sprite size became known), with the sprite's hull if it has one.
+		 */
+		void setShape(const sf::Vector2f& halfExtent, std::vector<SensorMount> mounts, const CarHull& hull = {});
+
+		/**
+		 * @brief Moves the car; a pose equal to the current one keeps the cache.
+		 */
+		void setPose(const CarState& pose) noexcept;
+
+		/**
+		 * @brief Hitches a trailer: mounts in its own frame, sensors giving each sensor's extent.
+		 *
+		 * The trailer starts straight behind the car; its sensors are appended after the car's.
+		 */
+		void setTrailer(const TrailerParams& params, std::vector<SensorMount> mounts, std::vector<SensorPose> sensors);
+
+		/**
+		 * @brief Moves the trailer; a pose equal to the current one keeps the cache.
+		 */
+		void setTrailerPose(const CarState& pose) noexcept;
+
+		[[nodiscard]] const CarState& pose() const noexcept { return m_pose; }
+		[[nodiscard]] const sf::Vector2f& halfExtent() const noexcept { return m_halfExtent; }
+		[[nodiscard]] const std::vector<SensorMount>& mounts() const noexcept { return m_mounts; }
+		[[nodiscard]] const CarHull& hull() const noexcept { return m_hull; }
+
+		[[nodiscard]] bool hasTrailer() const noexcept { return m_hasTrailer; }
+		[[nodiscard]] const TrailerParams& trailer() const noexcept { return m_trailer; }
+		[[nodiscard]] const CarState& trailerPose() const noexcept { return m_trailerPose; }
+
+		/**
+		 * @brief Sensors (and mounts) of the car itself; the trailer's follow them.
+		 */
+		[[nodiscard]] std::size_t carSensorCount() const noexcept { return m_carSensorCount; }
+
+		/**
+		 * @brief Bumped by every setShape() and every setPose() that moved the car.
+		 */
+		[[nodiscard]] std::uint64_t version() const noexcept { return m_version; }
+
+		[[nodiscard]] const sf::Transform& transform() const;
+
+		/**
+		 * @brief Local-to-world transform of the trailer (identity without one).
+		 */
+		[[nodiscard]] const sf::Transform& trailerTransform() const;
+
+		/**
+		 * @brief Same rectangle as carBounds(pose(), halfExtent()), or the bounds of the placed hull.
+		 */
+		[[nodiscard]] const sf::FloatRect& bounds() const;
+
+		/**
+		 * @brief hullFootprint(pose(), hull()): the rectangle's footprint until a hull is set.
+		 */
+		[[nodiscard]] OrientedRect footprint() const { return hullFootprint(m_pose, m_hull); }
+
+		/**
+		 * @brief Oriented box corners: front-left, front-right, rear-right, rear-left.
+		 */
+		[[nodiscard]] const std::array<sf::Vector2f, 4>& corners() const;
+
+		/**
+		 * @brief Sensor poses placed by their mounts, as updateSensorPositions() does; the trailer's last.
+		 */
+		[[nodiscard]] const std::vector<SensorPose>& sensors() const;
+
+	private:
+		void refresh() const;
+		void joinMounts(std::vector<SensorMount> carMounts);
+
+		CarState m_pose;
+		sf::Vector2f m_halfExtent;
+		CarHull m_hull; // empty: the rectangle of m_halfExtent
+		std::vector<SensorMount> m_mounts; // car's, then the trailer's in the car frame
+		std::size_t m_carSensorCount = 0U;
+		std::uint64_t m_version = 0U;
+
+		bool m_hasTrailer = false;
+		TrailerParams m_trailer;
+		CarState m_trailerPose;
+		std::vector<SensorMount> m_trailerMounts; // in the trailer's own frame
+
+		// Derived from the above on the first read after a change
+		mutable bool m_stale = true;
+		mutable sf::Transform m_transform;
+		mutable sf::Transform m_trailerTransform;
+		mutable sf::FloatRect m_bounds;
+		mutable std::array<sf::Vector2f, 4> m_corners{};
+		mutable std::vector<SensorPose> m_sensors;
+	};
+
+} // namespace sim
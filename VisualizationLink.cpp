@@ -0,0 +1,113 @@
+#include "VisualizationLink.hpp"
+
+#include <optional>
+#include <utility>
+
+#include "Log.hpp"
+
+namespace io {
+
+	bool VisualizationServer::listen(unsigned short port) {
+		if (m_listener.listen(port) != sf::Socket::Status::Done) {
+			OKPP_LOG_ERROR("Error: cannot listen for viewers on port %u", static_cast<unsigned>(port));
+			return false;
+		}
+		m_listener.setBlocking(false);
+		return true;
+	}
+
+	void VisualizationServer::broadcast(const WorldDeltaEncoder& encoder, const sf::Packet& delta) {
+		accept(encoder);
+		for (std::size_t i = 0U; i < m_viewers.size();) {
+			Viewer& viewer = m_viewers[i];
+			if (delta.getDataSize() > 0U) {
+				viewer.pending.push_back(delta);
+			}
+			if (viewer.pending.size() > MAX_PENDING_PACKETS || !flush(viewer)) {
+				const std::optional<sf::IpAddress> address = viewer.socket->getRemoteAddress();
+				OKPP_LOG_WARNING("Viewer %s dropped (%zu packets behind)",
+					address ? address->toString().c_str() : "?", viewer.pending.size());
+				m_viewers[i] = std::move(m_viewers.back());
+				m_viewers.pop_back();
+				continue;
+			}
+			++i;
+		}
+	}
+
+	void VisualizationServer::close() {
+		m_viewers.clear();
+		m_listener.close();
+	}
+
+	void VisualizationServer::accept(const WorldDeltaEncoder& encoder) {
+		for (;;) {
+			auto socket = std::make_unique<sf::TcpSocket>();
+			if (m_listener.accept(*socket) != sf::Socket::Status::Done) {
+				return;
+			}
+			socket->setBlocking(false);
+			Viewer viewer{ std::move(socket), {} };
+			viewer.pending.emplace_back();
+			encoder.keyframe(viewer.pending.back());
+
+			const std::optional<sf::IpAddress> address = viewer.socket->getRemoteAddress();
+			OKPP_LOG_INFO("Viewer %s connected", address ? address->toString().c_str() : "?");
+			m_viewers.push_back(std::move(viewer));
+		}
+	}
+
+	bool VisualizationServer::flush(Viewer& viewer) {
+		while (!viewer.pending.empty()) {
+			sf::Packet& packet = viewer.pending.front();
+			switch (viewer.socket->send(packet)) {
+			case sf::Socket::Status::Done:
+				m_bytesSent += packet.getDataSize() + sizeof(std::uint32_t); // plus the size prefix
+				viewer.pending.pop_front();
+				break;
+			case sf::Socket::Status::Partial:
+			case sf::Socket::Status::NotReady:
+				return true; // resume this packet next time
+			default:
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool VisualizationClient::connect(const std::string& host, unsigned short port, sf::Time timeout) {
+		const std::optional<sf::IpAddress> address = sf::IpAddress::resolve(host);
+		if (!address) {
+			OKPP_LOG_ERROR("Error: cannot resolve server %s", host.c_str());
+			return false;
+		}
+		if (m_socket.connect(*address, port, timeout) != sf::Socket::Status::Done) {
+			OKPP_LOG_ERROR("Error: cannot connect to %s:%u", host.c_str(), static_cast<unsigned>(port));
+			return false;
+		}
+		m_socket.setBlocking(false);
+		m_synced = false;
+		return true;
+	}
+
+	bool VisualizationClient::poll(WorldView& view) {
+		for (;;) {
+			switch (m_socket.receive(m_packet)) {
+			case sf::Socket::Status::Done:
+				if (!applyWorldDelta(m_packet, view)) {
+					OKPP_LOG_ERROR("Error: malformed world delta from the server");
+					return false;
+				}
+				m_synced = true;
+				m_packet.clear();
+				break;
+			case sf::Socket::Status::Partial:
+			case sf::Socket::Status::NotReady:
+				return true;
+			default:
+				return false;
+			}
+		}
+	}
+
+} // namespace io
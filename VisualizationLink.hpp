@@ -0,0 +1,88 @@
+/*
+==============================================================================
+Visualization Link - one simulation server, many thin viewers over TCP
+==============================================================================
+ - The server listens on a non-blocking sf::TcpListener; every broadcast
+   first admits waiting viewers with a keyframe of the encoder baseline,
+   then queues the shared delta for all of them
+ - Sends never block the simulation: a packet the socket only partly took
+   stays at the head of that viewer's queue and is resumed next time; a
+   viewer that falls MAX_PENDING_PACKETS behind is dropped (it can
+   reconnect and gets a fresh keyframe)
+ - Viewers poll a non-blocking socket once per frame and apply every
+   packet that has arrived in order; sf::Packet framing keeps packet
+   boundaries on the stream
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Network.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "WorldDelta.hpp"
+
+namespace io {
+
+	constexpr std::size_t MAX_PENDING_PACKETS = 64U;
+
+	class VisualizationServer {
+	public:
+		/**
+		 * @brief Starts listening on port; false (logged) if it is taken.
+		 */
+		bool listen(unsigned short port);
+
+		/**
+		 * @brief Admits waiting viewers with a keyframe of encoder's baseline,
+		 *        then queues delta (empty: none this time) for everyone.
+		 */
+		void broadcast(const WorldDeltaEncoder& encoder, const sf::Packet& delta);
+
+		void close();
+
+		[[nodiscard]] std::size_t viewerCount() const noexcept { return m_viewers.size(); }
+		[[nodiscard]] std::uint64_t bytesSent() const noexcept { return m_bytesSent; }
+
+	private:
+		struct Viewer {
+			std::unique_ptr<sf::TcpSocket> socket;
+			std::deque<sf::Packet> pending; // head may be partly sent
+		};
+
+		void accept(const WorldDeltaEncoder& encoder);
+		[[nodiscard]] bool flush(Viewer& viewer); // false once the viewer is gone
+
+		sf::TcpListener m_listener;
+		std::vector<Viewer> m_viewers;
+		std::uint64_t m_bytesSent = 0U;
+	};
+
+	class VisualizationClient {
+	public:
+		/**
+		 * @brief Connects to a server within timeout; false (logged) if it cannot.
+		 */
+		bool connect(const std::string& host, unsigned short port, sf::Time timeout = sf::seconds(3.0F));
+
+		/**
+		 * @brief Applies every packet received since the last call to view;
+		 *        false once the server has gone or sent something malformed.
+		 */
+		[[nodiscard]] bool poll(WorldView& view);
+
+		[[nodiscard]] bool synced() const noexcept { return m_synced; } // a keyframe has arrived
+
+	private:
+		sf::TcpSocket m_socket;
+		sf::Packet m_packet; // reused; a partly received packet stays in it
+		bool m_synced = false;
+	};
+
+} // namespace io
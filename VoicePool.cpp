@@ -0,0 +1,59 @@
+#include "VoicePool.hpp"
+
+#include <algorithm>
+
+namespace audio {
+
+	VoicePool::VoicePool(const sf::SoundBuffer& buffer, std::size_t voiceCount) {
+		const std::size_t count = std::max<std::size_t>(voiceCount, 1U);
+		m_voices.reserve(count);
+		for (std::size_t i = 0U; i < count; ++i) {
+			m_voices.push_back({ sf::Sound(buffer), 0.0F });
+			m_voices.back().sound.setAttenuation(0.0F);
+		}
+	}
+
+	bool VoicePool::play(const sf::SoundBuffer& buffer, float distance, const sf::Vector3f& position) {
+		Voice* chosen = nullptr;
+		for (auto& voice : m_voices) {
+			if (voice.sound.getStatus() == sf::Sound::Status::Stopped) {
+				chosen = &voice;
+				break;
+			}
+			if (chosen == nullptr || voice.distance > chosen->distance) {
+				chosen = &voice; // least urgent busy voice so far
+			}
+		}
+
+		const bool idle = chosen->sound.getStatus() == sf::Sound::Status::Stopped;
+		if (!idle && chosen->distance <= distance) {
+			++m_drops;
+			return false;
+		}
+		if (!idle) {
+			++m_steals;
+		}
+
+		chosen->sound.stop();
+		if (&chosen->sound.getBuffer() != &buffer) {
+			chosen->sound.setBuffer(buffer);
+		}
+		chosen->distance = distance;
+		chosen->sound.setPosition(position);
+		chosen->sound.play();
+		return true;
+	}
+
+	void VoicePool::stopAll() {
+		for (auto& voice : m_voices) {
+			voice.sound.stop();
+		}
+	}
+
+	std::size_t VoicePool::playing() const {
+		return static_cast<std::size_t>(std::count_if(m_voices.begin(), m_voices.end(), [](const Voice& voice) {
+			return voice.sound.getStatus() != sf::Sound::Status::Stopped;
+		}));
+	}
+
+} // namespace audio
@@ -0,0 +1,67 @@
+/*
+==============================================================================
+Voice Pool - a fixed set of sf::Sound voices shared by every beep source
+==============================================================================
+ - All voices are created up front; play() only rebinds an idle voice to
+   a shared sf::SoundBuffer, so no sound is allocated per beep
+ - A new beep never restarts one that is still ringing: it takes an idle
+   voice, and overlapping beeps from several cars can sound together
+ - When every voice is busy, the least urgent one (largest distance) is
+   stolen, if the new beep is more urgent; otherwise the new beep is dropped
+ - Voices are positional without distance attenuation: a beep is panned
+   to where it plays from, its loudness stays the same
+ - Steals and drops are counted for the audio counters (AudioCounters)
+ - Not thread-safe: create and drive it on the audio thread
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Audio.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace audio {
+
+	// Enough for a few cars beeping at their fastest cadence
+	constexpr std::size_t DEFAULT_VOICE_COUNT = 8U;
+
+	class VoicePool {
+	public:
+		/**
+		 * @brief Creates voiceCount voices bound to buffer (at least one).
+		 *
+		 * Every buffer later handed to play() must outlive the pool.
+		 */
+		explicit VoicePool(const sf::SoundBuffer& buffer, std::size_t voiceCount = DEFAULT_VOICE_COUNT);
+
+		/**
+		 * @brief Plays buffer from position on an idle voice, or steals the least
+		 *        urgent busy one.
+		 *
+		 * distance ranks the beep: the closer the obstacle, the more urgent.
+		 * Returns false if every voice is busy with a beep at least as close.
+		 */
+		bool play(const sf::SoundBuffer& buffer, float distance, const sf::Vector3f& position = {});
+
+		void stopAll();
+
+		[[nodiscard]] std::size_t playing() const;
+		[[nodiscard]] std::size_t size() const noexcept { return m_voices.size(); }
+		[[nodiscard]] std::uint64_t steals() const noexcept { return m_steals; }
+		[[nodiscard]] std::uint64_t drops() const noexcept { return m_drops; }
+
+	private:
+		struct Voice {
+			sf::Sound sound;
+			float distance = 0.0F; // of the beep the voice plays (or last played)
+		};
+
+		std::vector<Voice> m_voices;
+		std::uint64_t m_steals = 0U; // busy voices cut off for a closer beep
+		std::uint64_t m_drops = 0U;  // beeps refused because every voice was closer
+	};
+
+} // namespace audio
@@ -0,0 +1,52 @@
+#include "WarningArcs.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gfx {
+
+	WarningArcRange WarningArcLayout::range(std::size_t sensor, std::uint32_t bars) const noexcept {
+		if (sensor >= sensors) {
+			return {};
+		}
+		const std::uint32_t shown = std::min(bars, levels);
+		const std::size_t firstBand = sensor * levels + (levels - shown);
+		return { first + static_cast<GLint>(firstBand) * bandVertices, static_cast<GLsizei>(shown) * bandVertices };
+	}
+
+	WarningArcLayout appendWarningArcs(std::vector<QuadVertex>& triangles,
+		const std::vector<WarningArcSensor>& sensors, const WarningArcStyle& style)
+	{
+		WarningArcLayout layout;
+		layout.first = static_cast<GLint>(triangles.size());
+		layout.bandVertices = static_cast<GLsizei>(style.segments) * QUAD_TRIANGLE_VERTICES;
+		layout.levels = style.levels;
+		layout.sensors = sensors.size();
+		triangles.reserve(triangles.size() + sensors.size() * style.levels * static_cast<std::size_t>(layout.bandVertices));
+
+		const GLfloat step = (2.0F * style.halfAngleRad) / static_cast<GLfloat>(std::max(style.segments, 1U));
+		for (const auto& sensor : sensors) {
+			for (std::uint32_t level = 0U; level < style.levels; ++level) {
+				const GLfloat t = (style.levels > 1U) ? static_cast<GLfloat>(level) / static_cast<GLfloat>(style.levels - 1U) : 0.0F;
+				const GLfloat r = style.nearColor[0] + (style.farColor[0] - style.nearColor[0]) * t;
+				const GLfloat g = style.nearColor[1] + (style.farColor[1] - style.nearColor[1]) * t;
+				const GLfloat b = style.nearColor[2] + (style.farColor[2] - style.nearColor[2]) * t;
+
+				const GLfloat inner = style.innerRadius + static_cast<GLfloat>(level) * (style.bandWidth + style.gap);
+				const GLfloat outer = inner + style.bandWidth;
+				const auto vertex = [&](GLfloat radius, GLfloat angle) {
+					return QuadVertex{ sensor.x + radius * std::cos(angle), sensor.y + radius * std::sin(angle),
+						0.0F, 0.0F, r, g, b };
+				};
+
+				for (std::uint32_t segment = 0U; segment < style.segments; ++segment) {
+					const GLfloat a0 = sensor.headingRad - style.halfAngleRad + static_cast<GLfloat>(segment) * step;
+					const GLfloat a1 = a0 + step;
+					appendQuad(triangles, vertex(inner, a0), vertex(outer, a0), vertex(outer, a1), vertex(inner, a1));
+				}
+			}
+		}
+		return layout;
+	}
+
+} // namespace gfx
@@ -0,0 +1,66 @@
+/*
+==============================================================================
+Warning Arcs - parametric warning-bar geometry for sensor dashboards
+==============================================================================
+ - Each sensor gets `levels` concentric arc bands around its position,
+   facing its heading, nearest band first; colors blend from the near
+   color to the far color
+ - All bands of all sensors are generated once, as triangles, into the
+   caller's vertex list (one static buffer)
+ - Showing n bars of a sensor is one contiguous draw range: its n farthest
+   bands, since the near bands only light up as an obstacle closes in
+==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "QuadRenderer.hpp"
+
+namespace gfx {
+
+	struct WarningArcSensor {
+		GLfloat x = 0.0F;          // arc center
+		GLfloat y = 0.0F;
+		GLfloat headingRad = 0.0F; // direction the bands face
+	};
+
+	struct WarningArcStyle {
+		std::uint32_t levels = 3U;   // bands per sensor
+		std::uint32_t segments = 6U; // quads per band; more is rounder
+		GLfloat innerRadius = 0.17F; // of the nearest band
+		GLfloat bandWidth = 0.07F;
+		GLfloat gap = 0.035F;        // between bands
+		GLfloat halfAngleRad = 0.6F;
+		GLfloat nearColor[3] = { 1.0F, 0.0F, 0.0F };
+		GLfloat farColor[3] = { 1.0F, 0.5F, 0.5F };
+	};
+
+	struct WarningArcRange {
+		GLint first = 0;
+		GLsizei count = 0;
+	};
+
+	struct WarningArcLayout {
+		GLint first = 0;            // first vertex of sensor 0's nearest band
+		GLsizei bandVertices = 0;
+		std::uint32_t levels = 0U;
+		std::size_t sensors = 0U;
+
+		/**
+		 * @brief Draw range showing the bars farthest bands of one sensor
+		 *        (bars is clamped to 0..levels; 0 gives an empty range).
+		 */
+		[[nodiscard]] WarningArcRange range(std::size_t sensor, std::uint32_t bars) const noexcept;
+	};
+
+	/**
+	 * @brief Appends the bands of every sensor to triangles and returns where they went.
+	 */
+	WarningArcLayout appendWarningArcs(std::vector<QuadVertex>& triangles,
+		const std::vector<WarningArcSensor>& sensors, const WarningArcStyle& style);
+
+} // namespace gfx
@@ -0,0 +1,205 @@
+#include "WarningProfile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace sim {
+
+	namespace {
+		// Interval of the nearest band reaching distanceSq; bands sorted by distance
+		[[nodiscard]] float bandInterval(const std::vector<WarningBand>& bands, float distanceSq) {
+			for (const WarningBand& band : bands) {
+				if (distanceSq <= band.maxDistance * band.maxDistance) {
+					return band.interval;
+				}
+			}
+			return 0.0F;
+		}
+
+		[[nodiscard]] bool parseZone(const std::string& word, std::size_t& first, std::size_t& last) {
+			if (word == "front") {
+				first = static_cast<std::size_t>(SensorZone::Front);
+			}
+			else if (word == "rear") {
+				first = static_cast<std::size_t>(SensorZone::Rear);
+			}
+			else if (word == "corner") {
+				first = static_cast<std::size_t>(SensorZone::Corner);
+			}
+			else if (word == "all") {
+				first = 0U;
+				last = SENSOR_ZONE_COUNT;
+				return true;
+			}
+			else {
+				return false;
+			}
+			last = first + 1U;
+			return true;
+		}
+
+		// "sensor <zone> <kind> <ax> <ay> <dx> <dy> <rotationDeg> [<width> <height>]" after the keyword
+		[[nodiscard]] bool parseRigSensor(std::istringstream& fields, RigSensor& sensor) {
+			std::string zone;
+			std::string kind;
+			std::size_t first = 0U;
+			std::size_t last = 0U;
+			if (!(fields >> zone >> kind) || zone == "all" || !parseZone(zone, first, last)) {
+				return false;
+			}
+			sensor.zone = static_cast<SensorZone>(first);
+			if (kind == "ultrasonic") {
+				sensor.kind = SensorKind::Ultrasonic;
+			}
+			else if (kind == "camera") {
+				sensor.kind = SensorKind::Camera;
+			}
+			else {
+				return false;
+			}
+			if (!(fields >> sensor.anchor.x >> sensor.anchor.y >> sensor.offset.x >> sensor.offset.y >> sensor.rotationDeg)) {
+				return false;
+			}
+			sf::Vector2f extent;
+			if (fields >> extent.x) {
+				if (!(fields >> extent.y) || extent.x <= 0.0F || extent.y <= 0.0F) {
+					return false;
+				}
+				sensor.extent = extent;
+			}
+			return true;
+		}
+	}
+
+	WarningProfile WarningProfile::compile(std::string name, const ZoneBands& bands, std::vector<RigSensor> rig) {
+		WarningProfile profile;
+		profile.m_name = std::move(name);
+		profile.m_rig = std::move(rig);
+
+		ZoneBands sorted = bands;
+		for (auto& zone : sorted) {
+			std::sort(zone.begin(), zone.end(), [](const WarningBand& a, const WarningBand& b) {
+				return a.maxDistance < b.maxDistance;
+			});
+			if (!zone.empty()) {
+				profile.m_range = std::max(profile.m_range, zone.back().maxDistance);
+			}
+		}
+
+		profile.m_table.assign(SENSOR_ZONE_COUNT * TABLE_SIZE, 0.0F);
+		if (profile.m_range <= 0.0F) {
+			return profile;
+		}
+
+		// The last slot starts exactly at range^2, so a band edge at the range is inclusive
+		const float rangeSq = profile.m_range * profile.m_range;
+		const float stepSq = rangeSq / static_cast<float>(TABLE_SIZE - 1U);
+		profile.m_slotsPerSq = 1.0F / stepSq;
+
+		for (std::size_t slot = 0U; slot < TABLE_SIZE; ++slot) {
+			const float nearEdgeSq = static_cast<float>(slot) * stepSq;
+			for (std::size_t zone = 0U; zone < SENSOR_ZONE_COUNT; ++zone) {
+				profile.m_table[zone * TABLE_SIZE + slot] = bandInterval(sorted[zone], nearEdgeSq);
+			}
+		}
+		return profile;
+	}
+
+	WarningProfile defaultWarningProfile() {
+		const std::vector<WarningBand> bands{ { 80.0F, 0.1F }, { 180.0F, 0.25F }, { 300.0F, 0.5F } };
+		return WarningProfile::compile("default", { bands, bands, bands });
+	}
+
+	bool loadWarningProfiles(const std::string& path, std::vector<WarningProfile>& profiles) {
+		std::ifstream file(path);
+		if (!file) {
+			std::cerr << "Error: Failed to open warning profiles " << path << '\n';
+			return false;
+		}
+
+		std::vector<std::string> names;
+		std::vector<ZoneBands> bands;
+		std::vector<std::vector<RigSensor>> rigs;
+
+		std::string line;
+		std::size_t lineNumber = 0U;
+		while (std::getline(file, line)) {
+			++lineNumber;
+			std::istringstream fields(line);
+			std::string kind;
+			if (!(fields >> kind) || kind[0] == '#') {
+				continue;
+			}
+
+			if (kind == "profile") {
+				std::string name;
+				if (!(fields >> name)) {
+					std::cerr << "Error: " << path << ':' << lineNumber << ": expected \"profile <name>\"\n";
+					return false;
+				}
+				if (std::find(names.begin(), names.end(), name) != names.end()) {
+					std::cerr << "Error: " << path << ':' << lineNumber << ": profile " << name << " is defined twice\n";
+					return false;
+				}
+				names.push_back(name);
+				bands.emplace_back();
+				rigs.emplace_back();
+				continue;
+			}
+
+			if (kind == "sensor") {
+				RigSensor sensor;
+				if (!parseRigSensor(fields, sensor)) {
+					std::cerr << "Error: " << path << ':' << lineNumber << ": expected \"sensor <front|rear|corner> "
+						"<ultrasonic|camera> <anchorX> <anchorY> <offsetX> <offsetY> <rotationDeg> [<width> <height>]\"\n";
+					return false;
+				}
+				if (rigs.empty()) {
+					std::cerr << "Error: " << path << ':' << lineNumber << ": sensor before the first \"profile\" line\n";
+					return false;
+				}
+				rigs.back().push_back(sensor);
+				continue;
+			}
+
+			std::size_t first = 0U;
+			std::size_t last = 0U;
+			WarningBand band;
+			if (!parseZone(kind, first, last) || !(fields >> band.maxDistance >> band.interval)
+				|| band.maxDistance <= 0.0F || band.interval <= 0.0F)
+			{
+				std::cerr << "Error: " << path << ':' << lineNumber << ": expected \"profile <name>\" or "
+					"\"<front|rear|corner|all> <maxDistance> <intervalSeconds>\" with positive values\n";
+				return false;
+			}
+			if (bands.empty()) {
+				std::cerr << "Error: " << path << ':' << lineNumber << ": band before the first \"profile\" line\n";
+				return false;
+			}
+			for (std::size_t zone = first; zone < last; ++zone) {
+				bands.back()[zone].push_back(band);
+			}
+		}
+
+		if (names.empty()) {
+			std::cerr << "Error: warning profiles " << path << " define no profile\n";
+			return false;
+		}
+
+		profiles.clear();
+		for (std::size_t i = 0U; i < names.size(); ++i) {
+			profiles.push_back(WarningProfile::compile(names[i], bands[i], std::move(rigs[i])));
+		}
+		return true;
+	}
+
+	const WarningProfile* findWarningProfile(const std::vector<WarningProfile>& profiles, const std::string& name) {
+		const auto found = std::find_if(profiles.begin(), profiles.end(),
+			[&](const WarningProfile& profile) { return profile.name() == name; });
+		return (found != profiles.end()) ? &*found : nullptr;
+	}
+
+} // namespace sim
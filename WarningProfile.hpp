@@ -0,0 +1,122 @@
+/*
+==============================================================================
+Warning Profile - beep intervals per sensor zone as a squared-distance table
+==============================================================================
+ - A profile holds warning bands (max distance, beep interval) per sensor
+   zone (front, rear, corner); vehicles with a different body or driver
+   preference get profiles of their own
+ - Bands are compiled once into a lookup table indexed by squared distance,
+   so the per-tick lookup is one multiply and one load, with no sqrt and no
+   threshold chain
+ - Table slots are resolved at their near edge: quantization can only make
+   a beep start slightly early, never late
+ - A profile may also carry the vehicle's sensor rig; without one the
+   built-in four corner units are used
+ - Text form (--profiles), one record per line ('#' starts a comment):
+       profile <name>
+       <front|rear|corner|all> <maxDistance> <intervalSeconds>
+       sensor <front|rear|corner> <ultrasonic|camera> <anchorX> <anchorY>
+              <offsetX> <offsetY> <rotationDeg> [<width> <height>]
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "SimTypes.hpp"
+
+namespace sim {
+
+	// Beep every interval seconds once the nearest obstacle is within maxDistance
+	struct WarningBand {
+		float maxDistance = 0.0F;
+		float interval = 0.0F;
+	};
+
+	using ZoneBands = std::array<std::vector<WarningBand>, SENSOR_ZONE_COUNT>;
+
+	class WarningProfile {
+	public:
+		// Slots per zone; 1024 keeps the step under 0.6 px at the default 80 px band
+		static constexpr std::size_t TABLE_SIZE = 1024U;
+
+		/**
+		 * @brief A silent profile (every lookup returns 0).
+		 */
+		WarningProfile() = default;
+
+		/**
+		 * @brief Builds the lookup table from per-zone bands (in any order).
+		 *
+		 * The table spans the farthest band of any zone; a zone without bands
+		 * never beeps. An empty rig keeps the built-in sensor layout.
+		 */
+		[[nodiscard]] static WarningProfile compile(std::string name, const ZoneBands& bands,
+			std::vector<RigSensor> rig = {});
+
+		/**
+		 * @brief Seconds between beeps for a sensor in zone (0 = silent).
+		 */
+		[[nodiscard]] float interval(SensorZone zone, float distanceSq) const noexcept {
+			return lookup(static_cast<std::size_t>(zone), distanceSq);
+		}
+
+		/**
+		 * @brief Farthest distance at which any zone beeps; searches can stop there.
+		 */
+		[[nodiscard]] float range() const noexcept { return m_range; }
+		[[nodiscard]] const std::string& name() const noexcept { return m_name; }
+
+		/**
+		 * @brief The vehicle's sensors; empty for the built-in layout.
+		 */
+		[[nodiscard]] const std::vector<RigSensor>& rig() const noexcept { return m_rig; }
+
+	private:
+		[[nodiscard]] float lookup(std::size_t row, float distanceSq) const noexcept {
+			const float slot = distanceSq * m_slotsPerSq;
+			if (!(slot < static_cast<float>(TABLE_SIZE))) { // also rejects NaN
+				return 0.0F;
+			}
+			return m_table[row * TABLE_SIZE + static_cast<std::size_t>(slot)];
+		}
+
+		std::string m_name;
+		float m_range = 0.0F;
+		float m_slotsPerSq = 0.0F;  // table slots per px^2
+		std::vector<float> m_table = std::vector<float>(SENSOR_ZONE_COUNT * TABLE_SIZE, 0.0F); // one row of TABLE_SIZE slots per zone; silent until compiled
+		std::vector<RigSensor> m_rig;
+	};
+
+	/**
+	 * @brief The more urgent of two beep intervals, where 0 means silent.
+	 */
+	[[nodiscard]] constexpr float moreUrgent(float a, float b) noexcept {
+		if (a <= 0.0F) {
+			return b;
+		}
+		return (b > 0.0F && b < a) ? b : a;
+	}
+
+	/**
+	 * @brief The original thresholds for every zone: 0.1 s within 80 px,
+	 *        0.25 s within 180 px and 0.5 s within 300 px.
+	 */
+	[[nodiscard]] WarningProfile defaultWarningProfile();
+
+	/**
+	 * @brief Parses a text profile file; returns false and logs on errors.
+	 */
+	[[nodiscard]] bool loadWarningProfiles(const std::string& path, std::vector<WarningProfile>& profiles);
+
+	/**
+	 * @brief Profile registered under name, or null if there is none.
+	 */
+	[[nodiscard]] const WarningProfile* findWarningProfile(const std::vector<WarningProfile>& profiles,
+		const std::string& name);
+
+} // namespace sim
@@ -0,0 +1,124 @@
+#include "World.hpp"
+
+#include <SFML/Graphics/Transform.hpp>
+
+#include "SensorQuery.hpp"
+#include "Sensors.hpp"
+
+namespace sim {
+
+	void World::destroy(const Entity& entity) {
+		(void)transforms.remove(entity);
+		(void)bodies.remove(entity);
+		(void)sensors.remove(entity);
+		(void)beepTimers.remove(entity);
+		(void)obstacles.remove(entity);
+		(void)bays.remove(entity);
+		(void)entities.destroy(entity);
+	}
+
+	Entity spawnCar(World& world, const CarState& pose, const sf::Vector2f& halfExtent, std::uint32_t lotCar,
+		const std::vector<RigSensor>& rig)
+	{
+		const Entity car = world.entities.create();
+		(void)world.transforms.add(car, { pose });
+		(void)world.bodies.add(car, { halfExtent, lotCar });
+		(void)world.beepTimers.add(car, {});
+
+		for (const auto& mount : createSensorMounts(halfExtent, rig)) {
+			(void)world.sensors.add(world.entities.create(), { car, mount, {}, {} });
+		}
+		return car;
+	}
+
+	void spawnScene(World& world, const Scene& scene) {
+		world.obstacles.reserve(world.obstacles.size() + scene.obstacles.size());
+		for (const auto& obstacle : scene.obstacles) {
+			(void)world.obstacles.add(world.entities.create(), obstacle);
+		}
+		world.bays.reserve(world.bays.size() + scene.parkBays.size());
+		for (const auto& bay : scene.parkBays) {
+			(void)world.bays.add(world.entities.create(), { bay });
+		}
+	}
+
+	void updateSensorPoses(World& world, std::size_t begin, std::size_t end) {
+		// A car's sensors are spawned together, so the car transform is
+		// usually built once and reused for the following sensors
+		Entity lastCar;
+		const Transform* carTransformComponent = nullptr;
+		sf::Transform transform;
+
+		for (std::size_t i = begin; i < end; ++i) {
+			MountedSensor& sensor = world.sensors[i];
+			if (sensor.car != lastCar) {
+				lastCar = sensor.car;
+				carTransformComponent = world.transforms.get(sensor.car);
+				if (carTransformComponent != nullptr) {
+					transform = carTransform(carTransformComponent->pose);
+				}
+			}
+			if (carTransformComponent == nullptr) {
+				continue; // the car was destroyed
+			}
+			sensor.pose.position = transform.transformPoint(sensor.mount.offset);
+			sensor.pose.rotationDeg = sensor.mount.rotationDeg + carTransformComponent->pose.headingDeg;
+		}
+	}
+
+	void readMountedSensors(World& world, const ObstacleGrid& obstacleGrid, float maxRange,
+		std::size_t begin, std::size_t end)
+	{
+		MountedSensor* const sensors = world.sensors.begin() + begin;
+		querySensors(SensorSource{ &obstacleGrid, nullptr, maxRange }, end - begin,
+			[sensors](std::size_t i) -> const SensorPose& { return sensors[i].pose; },
+			[sensors](std::size_t i) -> SensorReading& { return sensors[i].reading; });
+	}
+
+	void accumulateBeepIntervals(World& world, const WarningProfile& profile, std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			const MountedSensor& sensor = world.sensors[i];
+			BeepTimer* timer = world.beepTimers.get(sensor.car);
+			if (timer != nullptr) {
+				timer->interval = moreUrgent(timer->interval,
+					profile.interval(sensor.mount.zone, sensor.reading.distanceSq));
+			}
+		}
+	}
+
+	void updateBeepTimers(World& world, float dt, std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			BeepTimer& timer = world.beepTimers[i];
+			timer.sinceLastBeep += dt;
+			if (timer.interval > 0.0F && timer.sinceLastBeep >= timer.interval) {
+				++timer.beeps;
+				timer.sinceLastBeep = 0.0F;
+			}
+			timer.interval = 0.0F;
+		}
+	}
+
+	void updateParking(const World& world, ParkingLot& lot) {
+		for (std::size_t i = 0U; i < world.bodies.size(); ++i) {
+			const Body& body = world.bodies[i];
+			const Transform* transform = world.transforms.get(world.bodies.entityAt(i));
+			if (transform != nullptr) {
+				lot.updateCar(body.lotCar, carFootprint(transform->pose, body.halfExtent));
+			}
+		}
+	}
+
+	void captureWorldFrame(const World& world, const ParkingLot& lot, std::uint32_t tick, WorldFrame& frame) {
+		frame.tick = tick;
+		frame.cars.resize(world.bodies.size());
+		for (std::size_t i = 0U; i < frame.cars.size(); ++i) {
+			const Transform* transform = world.transforms.get(world.bodies.entityAt(i));
+			frame.cars[i] = (transform != nullptr) ? transform->pose : CarState{};
+		}
+		frame.bayOccupied.resize(lot.bayCount());
+		for (std::uint32_t bay = 0U; bay < frame.bayOccupied.size(); ++bay) {
+			frame.bayOccupied[bay] = lot.occupied(bay) ? 1U : 0U;
+		}
+	}
+
+} // namespace sim
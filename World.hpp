@@ -0,0 +1,136 @@
+/*
+==============================================================================
+World - cars, sensors, obstacles and bays as ECS components
+==============================================================================
+ - Components: Transform (pose), Body (car rectangle and lot id), a
+   MountedSensor per sensor entity, BeepTimer, Obstacle and Bay
+ - Sensors are entities of their own that point at their car, so all
+   sensors of all cars sit in one packed array; a car spawns its sensors
+   right after itself, which keeps them next to each other
+ - Systems walk one store front to back and only look up the few
+   components they need from others; the per-sensor systems take a dense
+   range, so a pool can split them without any locking
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "Ecs.hpp"
+#include "ObstacleGrid.hpp"
+#include "ParkingLot.hpp"
+#include "Scene.hpp"
+#include "SimTypes.hpp"
+#include "WarningProfile.hpp"
+
+namespace sim {
+
+	struct Transform {
+		CarState pose;
+	};
+
+	struct Body {
+		sf::Vector2f halfExtent{ 0.0F, 0.0F };
+		std::uint32_t lotCar = 0U; // ParkingLot car id
+	};
+
+	struct MountedSensor {
+		Entity car;
+		SensorMount mount;
+		SensorPose pose;       // refreshed by updateSensorPoses()
+		SensorReading reading; // refreshed by readMountedSensors()
+	};
+
+	struct BeepTimer {
+		float sinceLastBeep = 0.0F;
+		float interval = 0.0F; // most urgent sensor interval this tick (0 = silent)
+		std::uint64_t beeps = 0U;
+	};
+
+	struct Bay {
+		sf::FloatRect rect;
+	};
+
+	struct World {
+		EntityRegistry entities;
+		ComponentStore<Transform> transforms;
+		ComponentStore<Body> bodies;
+		ComponentStore<MountedSensor> sensors;
+		ComponentStore<BeepTimer> beepTimers;
+		ComponentStore<Obstacle> obstacles;
+		ComponentStore<Bay> bays;
+
+		/**
+		 * @brief Removes the entity's world components and retires its handle.
+		 *
+		 * A car's sensors are entities of their own: destroying the car leaves
+		 * them pointing at a stale handle, and the systems skip them.
+		 */
+		void destroy(const Entity& entity);
+	};
+
+	/**
+	 * @brief Spawns a car with Transform, Body and BeepTimer, followed by one
+	 *        sensor entity per mount of createSensorMounts(halfExtent, rig).
+	 */
+	Entity spawnCar(World& world, const CarState& pose, const sf::Vector2f& halfExtent, std::uint32_t lotCar,
+		const std::vector<RigSensor>& rig = {});
+
+	/**
+	 * @brief Spawns one entity per scene obstacle and bay.
+	 */
+	void spawnScene(World& world, const Scene& scene);
+
+	/**
+	 * @brief Sensors in the dense range [begin, end) follow their car's transform.
+	 */
+	void updateSensorPoses(World& world, std::size_t begin, std::size_t end);
+
+	/**
+	 * @brief Batched sensor pass over the dense range [begin, end): nearest
+	 *        obstacle and wall distance of every sensor, in one grid lookup.
+	 */
+	void readMountedSensors(World& world, const ObstacleGrid& obstacleGrid, float maxRange,
+		std::size_t begin, std::size_t end);
+
+	/**
+	 * @brief Folds the beep interval of every sensor in the dense range
+	 *        [begin, end) into its car's BeepTimer.
+	 *
+	 * Writes the timers of the cars owning those sensors, so parallel
+	 * ranges must not share a car.
+	 */
+	void accumulateBeepIntervals(World& world, const WarningProfile& profile, std::size_t begin, std::size_t end);
+
+	/**
+	 * @brief Advances the beep timers in the dense range [begin, end) by dt and
+	 *        counts a beep where a non-silent folded interval has elapsed; the
+	 *        fold is then cleared for the next tick.
+	 */
+	void updateBeepTimers(World& world, float dt, std::size_t begin, std::size_t end);
+
+	/**
+	 * @brief Moves every car body in the lot index.
+	 */
+	void updateParking(const World& world, ParkingLot& lot);
+
+	// What viewers and exporters read of the world, copied out once per publish (EpochSnapshots)
+	struct WorldFrame {
+		std::uint32_t tick = 0U;
+		std::vector<CarState> cars;            // dense order of world.bodies; a car without a transform is at the origin
+		std::vector<std::uint8_t> bayOccupied; // one per lot bay
+	};
+
+	/**
+	 * @brief Fills frame with the car poses and bay occupancy at tick; reuses its storage.
+	 */
+	void captureWorldFrame(const World& world, const ParkingLot& lot, std::uint32_t tick, WorldFrame& frame);
+
+} // namespace sim
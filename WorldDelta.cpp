@@ -0,0 +1,224 @@
+#include "WorldDelta.hpp"
+
+#include <cmath>
+
+namespace io {
+
+	namespace {
+		constexpr float POSITION_STEPS_PER_PIXEL = 8.0F;
+		constexpr float HEADING_STEPS_PER_DEGREE = 65536.0F / 360.0F;
+
+		constexpr std::uint8_t KIND_KEYFRAME = 1U;
+		constexpr std::uint8_t KIND_DELTA = 2U;
+
+		void writeVarint(sf::Packet& packet, std::uint32_t value) {
+			while (value >= 0x80U) {
+				packet << static_cast<std::uint8_t>((value & 0x7FU) | 0x80U);
+				value >>= 7U;
+			}
+			packet << static_cast<std::uint8_t>(value);
+		}
+
+		[[nodiscard]] bool readVarint(sf::Packet& packet, std::uint32_t& value) {
+			value = 0U;
+			for (unsigned shift = 0U; shift < 35U; shift += 7U) {
+				std::uint8_t byte = 0U;
+				if (!(packet >> byte)) {
+					return false;
+				}
+				value |= static_cast<std::uint32_t>(byte & 0x7FU) << shift;
+				if ((byte & 0x80U) == 0U) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Small magnitudes of either sign become small varints
+		[[nodiscard]] std::uint32_t zigzag(std::int32_t value) noexcept {
+			return (static_cast<std::uint32_t>(value) << 1U) ^ static_cast<std::uint32_t>(value >> 31);
+		}
+		[[nodiscard]] std::int32_t unzigzag(std::uint32_t value) noexcept {
+			return static_cast<std::int32_t>(value >> 1U) ^ -static_cast<std::int32_t>(value & 1U);
+		}
+
+		void writePoseDelta(sf::Packet& packet, const QuantizedPose& from, const QuantizedPose& to) {
+			writeVarint(packet, zigzag(static_cast<std::int32_t>(static_cast<std::uint32_t>(to.x) - static_cast<std::uint32_t>(from.x))));
+			writeVarint(packet, zigzag(static_cast<std::int32_t>(static_cast<std::uint32_t>(to.y) - static_cast<std::uint32_t>(from.y))));
+			// The heading wraps, so the short way round always fits 16 bits
+			writeVarint(packet, zigzag(static_cast<std::int16_t>(static_cast<std::uint16_t>(to.heading - from.heading))));
+		}
+
+		// Ascending indices as gaps from the previous one
+		void writeIndices(sf::Packet& packet, const std::vector<std::uint32_t>& indices) {
+			writeVarint(packet, static_cast<std::uint32_t>(indices.size()));
+			std::uint32_t next = 0U;
+			for (const std::uint32_t index : indices) {
+				writeVarint(packet, index - next);
+				next = index + 1U;
+			}
+		}
+
+		void writeBody(sf::Packet& packet, const std::vector<std::uint32_t>& cars, const std::vector<QuantizedPose>& from,
+			const std::vector<QuantizedPose>& to, const std::vector<std::uint32_t>& bays)
+		{
+			writeVarint(packet, static_cast<std::uint32_t>(cars.size()));
+			std::uint32_t next = 0U;
+			for (const std::uint32_t car : cars) {
+				writeVarint(packet, car - next);
+				writePoseDelta(packet, from.empty() ? QuantizedPose{} : from[car], to[car]);
+				next = car + 1U;
+			}
+			writeIndices(packet, bays);
+		}
+	}
+
+	QuantizedPose quantizePose(const sim::CarState& pose) noexcept {
+		QuantizedPose quantized;
+		quantized.x = static_cast<std::int32_t>(std::lround(pose.position.x * POSITION_STEPS_PER_PIXEL));
+		quantized.y = static_cast<std::int32_t>(std::lround(pose.position.y * POSITION_STEPS_PER_PIXEL));
+		const float turns = pose.headingDeg * HEADING_STEPS_PER_DEGREE;
+		quantized.heading = static_cast<std::uint16_t>(static_cast<std::uint32_t>(static_cast<std::int32_t>(std::lround(turns))));
+		return quantized;
+	}
+
+	sim::CarState dequantizePose(const QuantizedPose& pose) noexcept {
+		sim::CarState state;
+		state.position = { static_cast<float>(pose.x) / POSITION_STEPS_PER_PIXEL, static_cast<float>(pose.y) / POSITION_STEPS_PER_PIXEL };
+		state.headingDeg = static_cast<float>(pose.heading) / HEADING_STEPS_PER_DEGREE;
+		return state;
+	}
+
+	bool WorldDeltaEncoder::encode(const sim::WorldFrame& frame, sf::Packet& packet) {
+		packet.clear();
+		m_baseline.tick = frame.tick;
+
+		const std::size_t carCount = frame.cars.size();
+		const std::size_t bayCount = frame.bayOccupied.size();
+		if (m_baseline.cars.size() != carCount || m_baseline.bayOccupied.size() != bayCount) {
+			m_baseline.cars.resize(carCount);
+			for (std::size_t i = 0U; i < carCount; ++i) {
+				m_baseline.cars[i] = quantizePose(frame.cars[i]);
+			}
+			m_baseline.bayOccupied = frame.bayOccupied;
+			keyframe(packet);
+			return true;
+		}
+
+		m_changedCars.clear();
+		m_flippedBays.clear();
+		for (std::size_t i = 0U; i < carCount; ++i) {
+			if (quantizePose(frame.cars[i]) != m_baseline.cars[i]) {
+				m_changedCars.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+		for (std::uint32_t bay = 0U; bay < bayCount; ++bay) {
+			if (frame.bayOccupied[bay] != m_baseline.bayOccupied[bay]) {
+				m_flippedBays.push_back(bay);
+			}
+		}
+		if (m_changedCars.empty() && m_flippedBays.empty()) {
+			return false;
+		}
+
+		packet << KIND_DELTA << frame.tick;
+		writeVarint(packet, static_cast<std::uint32_t>(m_changedCars.size()));
+		std::uint32_t next = 0U;
+		for (const std::uint32_t car : m_changedCars) {
+			const QuantizedPose pose = quantizePose(frame.cars[car]);
+			writeVarint(packet, car - next);
+			writePoseDelta(packet, m_baseline.cars[car], pose);
+			m_baseline.cars[car] = pose;
+			next = car + 1U;
+		}
+		writeIndices(packet, m_flippedBays);
+		for (const std::uint32_t bay : m_flippedBays) {
+			m_baseline.bayOccupied[bay] ^= 1U;
+		}
+		return true;
+	}
+
+	void WorldDeltaEncoder::keyframe(sf::Packet& packet) const {
+		packet.clear();
+		packet << KIND_KEYFRAME << m_baseline.tick;
+		writeVarint(packet, static_cast<std::uint32_t>(m_baseline.cars.size()));
+		writeVarint(packet, static_cast<std::uint32_t>(m_baseline.bayOccupied.size()));
+
+		std::vector<std::uint32_t> cars(m_baseline.cars.size());
+		for (std::uint32_t i = 0U; i < cars.size(); ++i) {
+			cars[i] = i;
+		}
+		std::vector<std::uint32_t> occupied;
+		for (std::uint32_t bay = 0U; bay < m_baseline.bayOccupied.size(); ++bay) {
+			if (m_baseline.bayOccupied[bay] != 0U) {
+				occupied.push_back(bay);
+			}
+		}
+		writeBody(packet, cars, {}, m_baseline.cars, occupied);
+	}
+
+	bool applyWorldDelta(sf::Packet& packet, WorldView& view) {
+		std::uint8_t kind = 0U;
+		std::uint32_t tick = 0U;
+		if (!(packet >> kind >> tick)) {
+			return false;
+		}
+		if (kind == KIND_KEYFRAME) {
+			std::uint32_t carCount = 0U;
+			std::uint32_t bayCount = 0U;
+			if (!readVarint(packet, carCount) || !readVarint(packet, bayCount)) {
+				return false;
+			}
+			view.cars.assign(carCount, QuantizedPose{});
+			view.bayOccupied.assign(bayCount, 0U);
+		}
+		else if (kind != KIND_DELTA) {
+			return false;
+		}
+		view.tick = tick;
+
+		std::uint32_t changed = 0U;
+		if (!readVarint(packet, changed)) {
+			return false;
+		}
+		std::uint32_t next = 0U;
+		for (std::uint32_t i = 0U; i < changed; ++i) {
+			std::uint32_t gap = 0U;
+			std::uint32_t dx = 0U;
+			std::uint32_t dy = 0U;
+			std::uint32_t dheading = 0U;
+			if (!readVarint(packet, gap) || !readVarint(packet, dx) || !readVarint(packet, dy) || !readVarint(packet, dheading)) {
+				return false;
+			}
+			const std::uint32_t car = next + gap;
+			if (car >= view.cars.size()) {
+				return false;
+			}
+			QuantizedPose& pose = view.cars[car];
+			pose.x = static_cast<std::int32_t>(static_cast<std::uint32_t>(pose.x) + static_cast<std::uint32_t>(unzigzag(dx)));
+			pose.y = static_cast<std::int32_t>(static_cast<std::uint32_t>(pose.y) + static_cast<std::uint32_t>(unzigzag(dy)));
+			pose.heading = static_cast<std::uint16_t>(pose.heading + static_cast<std::uint16_t>(unzigzag(dheading)));
+			next = car + 1U;
+		}
+
+		std::uint32_t flipped = 0U;
+		if (!readVarint(packet, flipped)) {
+			return false;
+		}
+		next = 0U;
+		for (std::uint32_t i = 0U; i < flipped; ++i) {
+			std::uint32_t gap = 0U;
+			if (!readVarint(packet, gap)) {
+				return false;
+			}
+			const std::uint32_t bay = next + gap;
+			if (bay >= view.bayOccupied.size()) {
+				return false;
+			}
+			view.bayOccupied[bay] ^= 1U;
+			next = bay + 1U;
+		}
+		return true;
+	}
+
+} // namespace io
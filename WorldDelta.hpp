@@ -0,0 +1,85 @@
+/*
+==============================================================================
+World Delta - quantized, delta-encoded car poses and bay occupancy for viewers
+==============================================================================
+ - Poses are quantized (1/8 px, 2^16 steps per turn) before they are
+   compared, so the encoder and every viewer hold bit-identical baselines
+   and rounding never drifts
+ - A delta lists only the cars whose quantized pose changed, as index gaps
+   and zigzag varints of the pose difference, and only the bays whose
+   occupancy flipped; a parked car costs nothing
+ - A keyframe is the same body against an all-zero baseline, so a viewer
+   that joins late starts from the encoder's baseline and then follows
+   the shared deltas
+ - Wire format (sf::Packet): kind u8 | tick u32 | [keyframe: cars, bays
+   varints] | changed cars varint | per car: index gap, dx, dy, dheading
+   varints | flipped bays varint | per bay: index gap varint
+==============================================================================
+*/
+
+#pragma once
+
+#include <SFML/Network/Packet.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CarModel.hpp"
+#include "World.hpp"
+
+namespace io {
+
+	struct QuantizedPose {
+		std::int32_t x = 0;        // 1/POSITION_STEPS_PER_PIXEL px
+		std::int32_t y = 0;
+		std::uint16_t heading = 0U; // full turn = 65536
+
+		[[nodiscard]] bool operator==(const QuantizedPose& other) const noexcept {
+			return x == other.x && y == other.y && heading == other.heading;
+		}
+		[[nodiscard]] bool operator!=(const QuantizedPose& other) const noexcept { return !(*this == other); }
+	};
+
+	[[nodiscard]] QuantizedPose quantizePose(const sim::CarState& pose) noexcept;
+	[[nodiscard]] sim::CarState dequantizePose(const QuantizedPose& pose) noexcept;
+
+	// What a viewer has seen so far; the encoder keeps the same state as its baseline
+	struct WorldView {
+		std::uint32_t tick = 0U;
+		std::vector<QuantizedPose> cars;
+		std::vector<std::uint8_t> bayOccupied;
+	};
+
+	class WorldDeltaEncoder {
+	public:
+		/**
+		 * @brief Folds the frame's car poses and bay occupancy into the baseline
+		 *        and writes what changed; false (packet left empty) if nothing did.
+		 *
+		 * The first call after a change in the car or bay count writes a
+		 * keyframe instead.
+		 */
+		bool encode(const sim::WorldFrame& frame, sf::Packet& packet);
+
+		/**
+		 * @brief Writes the whole baseline as a keyframe, for a viewer that just joined.
+		 */
+		void keyframe(sf::Packet& packet) const;
+
+		[[nodiscard]] const WorldView& baseline() const noexcept { return m_baseline; }
+
+	private:
+		WorldView m_baseline;
+		std::vector<std::uint32_t> m_changedCars; // scratch, kept between calls
+		std::vector<std::uint32_t> m_flippedBays;
+	};
+
+	/**
+	 * @brief Applies one keyframe or delta to view; false (view unchanged in
+	 *        size, possibly part-applied) for a malformed packet or a delta that
+	 *        does not fit the view.
+	 */
+	[[nodiscard]] bool applyWorldDelta(sf::Packet& packet, WorldView& view);
+
+} // namespace io
@@ -0,0 +1,37 @@
+#include "WorldEvents.hpp"
+
+namespace sim {
+
+	void EventChannel::publish(WorldEventKind kind, std::uint32_t index, std::uint32_t value) noexcept {
+		FrameSlot& slot = m_slots[slotIndex(m_sealed + 1U)];
+		if (slot.count == FRAME_CAPACITY) {
+			slot.overflowed = true;
+			return;
+		}
+		slot.events[slot.count++] = { kind, index, value };
+	}
+
+	std::uint64_t EventChannel::endFrame() noexcept {
+		const std::uint64_t sealed = m_sealed + 1U;
+		m_slots[slotIndex(sealed)].frame = sealed;
+		m_sealed = sealed;
+
+		// The next frame reuses the slot of frame sealed + 1 - FRAME_SLOTS
+		FrameSlot& next = m_slots[slotIndex(sealed + 1U)];
+		next.count = 0U;
+		next.frame = 0U;
+		next.overflowed = false;
+		return sealed;
+	}
+
+	bool EventChannel::frameEvents(std::uint64_t frame, const WorldEvent*& events, std::size_t& count) const noexcept {
+		const FrameSlot& slot = m_slots[slotIndex(frame)];
+		if (frame == 0U || slot.frame != frame || slot.overflowed) {
+			return false;
+		}
+		events = slot.events.data();
+		count = slot.count;
+		return true;
+	}
+
+} // namespace sim
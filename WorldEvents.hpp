@@ -0,0 +1,143 @@
+/*
+==============================================================================
+World Events - per-frame change events instead of polling the world state
+==============================================================================
+ - The simulation publishes what changed: the car moved, a sensor pass
+   ran, a sensor's warning level or a bay's occupancy flipped, the bays
+   were replaced. Consumers stop comparing whole state every frame
+ - Events go into the open frame's slot of a ring of FRAME_SLOTS fixed-size
+   buffers; endFrame() seals and numbers it, and the last FRAME_SLOTS - 1
+   sealed frames stay readable. Nothing is allocated after construction
+ - Each subscriber keeps an EventCursor with a mask of the kinds it cares
+   about and reads the frames sealed since its last read, so the HUD, the
+   audio hand-off, telemetry and the render batches work only in frames
+   that carried something for them
+ - A frame that overflowed its slot, or whose slot the ring has reused,
+   cannot be replayed: read() returns false and the subscriber refreshes
+   from full state, as a viewer joining late starts from a keyframe
+ - One thread publishes. A reader on another thread reads only frames
+   handed to it through the frame pipeline, which seals at most two frames
+   past the one being drawn, so no slot is written while it is read
+==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace sim {
+
+	enum class WorldEventKind : std::uint8_t {
+		CarMoved,       // index = car
+		SensorsRead,    // a sensor pass ran; readings and poses may differ
+		WarningChanged, // index = sensor, value = new sim::WARNING_LEVEL_*
+		BayChanged,     // index = bay, value = 1 occupied / 0 free
+		BaysReplaced    // index = new bay count, every bay free
+	};
+
+	/**
+	 * @brief Subscription bit of an event kind.
+	 */
+	[[nodiscard]] constexpr std::uint32_t eventMask(WorldEventKind kind) noexcept {
+		return 1U << static_cast<std::uint32_t>(kind);
+	}
+
+	struct WorldEvent {
+		WorldEventKind kind = WorldEventKind::CarMoved;
+		std::uint32_t index = 0U;
+		std::uint32_t value = 0U;
+	};
+
+	class EventChannel {
+	public:
+		// Ring size: the open frame and the FRAME_SLOTS - 1 sealed frames before it can be replayed
+		static constexpr std::size_t FRAME_SLOTS = 4U;
+		// Events one frame holds; past this the frame is marked overflowed
+		static constexpr std::size_t FRAME_CAPACITY = 256U;
+
+		/**
+		 * @brief Appends an event to the open frame.
+		 */
+		void publish(WorldEventKind kind, std::uint32_t index = 0U, std::uint32_t value = 0U) noexcept;
+
+		/**
+		 * @brief Seals the open frame and opens the next; returns the sealed frame's number (1 for the first).
+		 */
+		std::uint64_t endFrame() noexcept;
+
+		[[nodiscard]] std::uint64_t sealedFrames() const noexcept { return m_sealed; }
+
+		/**
+		 * @brief The events of a sealed frame, in publishing order.
+		 *
+		 * Returns false if the frame overflowed or its slot has been reused.
+		 */
+		[[nodiscard]] bool frameEvents(std::uint64_t frame, const WorldEvent*& events, std::size_t& count) const noexcept;
+
+	private:
+		struct FrameSlot {
+			std::array<WorldEvent, FRAME_CAPACITY> events{};
+			std::size_t count = 0U;
+			std::uint64_t frame = 0U; // 0 while open
+			bool overflowed = false;
+		};
+
+		[[nodiscard]] static std::size_t slotIndex(std::uint64_t frame) noexcept {
+			return static_cast<std::size_t>(frame % FRAME_SLOTS);
+		}
+
+		std::array<FrameSlot, FRAME_SLOTS> m_slots{};
+		std::uint64_t m_sealed = 0U;
+	};
+
+	// One subscriber's position in a channel
+	class EventCursor {
+	public:
+		explicit EventCursor(std::uint32_t kinds) noexcept : m_kinds(kinds) {}
+
+		/**
+		 * @brief Calls onEvent(const WorldEvent&) for the subscribed events of every frame
+		 *        after the last one read, through frame through, oldest first.
+		 *
+		 * Returns false if any of those frames could not be replayed; the
+		 * caller then refreshes from full state. The cursor ends at through
+		 * either way. MISRA: through must be sealed.
+		 */
+		template <typename OnEvent>
+		bool read(const EventChannel& channel, std::uint64_t through, OnEvent&& onEvent) {
+			bool complete = true;
+			std::uint64_t frame = m_read + 1U;
+			// Frames older than the ring are gone without looking
+			if (through >= m_read + EventChannel::FRAME_SLOTS) {
+				complete = false;
+				frame = through - EventChannel::FRAME_SLOTS + 2U;
+			}
+			for (; frame <= through; ++frame) {
+				const WorldEvent* events = nullptr;
+				std::size_t count = 0U;
+				if (!channel.frameEvents(frame, events, count)) {
+					complete = false;
+					continue;
+				}
+				for (std::size_t i = 0U; i < count; ++i) {
+					if ((m_kinds & eventMask(events[i].kind)) != 0U) {
+						onEvent(events[i]);
+					}
+				}
+			}
+			if (through > m_read) {
+				m_read = through;
+			}
+			return complete;
+		}
+
+		[[nodiscard]] std::uint64_t lastRead() const noexcept { return m_read; }
+
+	private:
+		std::uint32_t m_kinds;
+		std::uint64_t m_read = 0U;
+	};
+
+} // namespace sim
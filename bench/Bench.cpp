@@ -0,0 +1,67 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+
+namespace bench {
+
+	namespace {
+		struct Entry {
+			const char* name;
+			BenchmarkFn fn;
+			std::vector<std::int64_t> args;
+		};
+
+		// Function-local so registration order across translation units does not matter
+		std::vector<Entry>& registry() {
+			static std::vector<Entry> entries;
+			return entries;
+		}
+	}
+
+	bool registerBenchmark(const char* name, BenchmarkFn fn, std::initializer_list<std::int64_t> args) {
+		registry().push_back({ name, fn, args });
+		return true;
+	}
+
+	void runAll(const std::string& filter, double minSeconds, std::int64_t maxArg, bool csv) {
+		if (csv) {
+			std::printf("benchmark,arg,ns_per_iter,iterations,items_per_s,agreement\n");
+		}
+		else {
+			std::printf("%-32s %10s %14s %12s %14s %8s\n", "benchmark", "arg", "ns/iter", "iterations", "items/s", "agree");
+		}
+
+		for (const auto& entry : registry()) {
+			if (std::string(entry.name).find(filter) == std::string::npos) {
+				continue;
+			}
+			for (const std::int64_t arg : entry.args) {
+				if (arg > maxArg) {
+					continue;
+				}
+
+				Case c(arg, minSeconds);
+				entry.fn(c);
+
+				const double itemsPerSecond = (c.itemsPerIteration() > 0U && c.nsPerIteration() > 0.0)
+					? static_cast<double>(c.itemsPerIteration()) * 1.0e9 / c.nsPerIteration()
+					: 0.0;
+				char agreement[16] = "";
+				if (c.agreement() >= 0.0) {
+					std::snprintf(agreement, sizeof(agreement), csv ? "%.6f" : "%.2f%%", csv ? c.agreement() : 100.0 * c.agreement());
+				}
+				if (csv) {
+					std::printf("%s,%lld,%.3f,%llu,%.0f,%s\n", entry.name, static_cast<long long>(arg),
+						c.nsPerIteration(), static_cast<unsigned long long>(c.iterations()), itemsPerSecond, agreement);
+				}
+				else {
+					std::printf("%-32s %10lld %14.2f %12llu %14.3g %8s\n", entry.name, static_cast<long long>(arg),
+						c.nsPerIteration(), static_cast<unsigned long long>(c.iterations()), itemsPerSecond,
+						(agreement[0] != '\0') ? agreement : "-");
+				}
+				std::fflush(stdout);
+			}
+		}
+	}
+
+} // namespace bench
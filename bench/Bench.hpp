@@ -0,0 +1,114 @@
+/*
+==============================================================================
+Bench - minimal in-house microbenchmark harness
+==============================================================================
+ - OKPP_BENCHMARK(name, args...) defines a benchmark that runs once per
+   argument (e.g. obstacle count); set-up code runs untimed, only the
+   callable handed to Case::measure() is timed
+ - measure() repeats the callable until it has run for the minimum time
+   and reports nanoseconds (and optionally items) per iteration
+ - doNotOptimize() keeps results alive so the compiler cannot drop the work
+ - setAgreement() adds the share of results matching a reference engine,
+   so alternative engines for one query line up by cost and by answer
+==============================================================================
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+	class Case {
+	public:
+		Case(std::int64_t arg, double minSeconds) : m_arg(arg), m_minSeconds(minSeconds) {}
+
+		[[nodiscard]] std::int64_t arg() const noexcept { return m_arg; }
+
+		/**
+		 * @brief Work items per call of the measured callable (adds an items/s column).
+		 */
+		void setItemsPerIteration(std::uint64_t items) noexcept { m_items = items; }
+
+		/**
+		 * @brief Share of results that match the reference engine, 0..1 (adds an agree column).
+		 */
+		void setAgreement(double share) noexcept { m_agreement = share; }
+
+		/**
+		 * @brief Times fn, doubling the batch size until one batch lasts minSeconds.
+		 */
+		template <typename Fn>
+		void measure(Fn&& fn) {
+			using Clock = std::chrono::steady_clock;
+			fn(); // warm caches and lazy state before timing
+
+			std::uint64_t batch = 1U;
+			for (;;) {
+				const auto start = Clock::now();
+				for (std::uint64_t i = 0U; i < batch; ++i) {
+					fn();
+				}
+				const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+				if (seconds >= m_minSeconds || batch >= (std::uint64_t{ 1 } << 40U)) {
+					m_nsPerIteration = seconds * 1.0e9 / static_cast<double>(batch);
+					m_iterations = batch;
+					return;
+				}
+				batch *= 2U;
+			}
+		}
+
+		[[nodiscard]] double nsPerIteration() const noexcept { return m_nsPerIteration; }
+		[[nodiscard]] std::uint64_t iterations() const noexcept { return m_iterations; }
+		[[nodiscard]] std::uint64_t itemsPerIteration() const noexcept { return m_items; }
+		[[nodiscard]] double agreement() const noexcept { return m_agreement; }
+
+	private:
+		std::int64_t m_arg;
+		double m_minSeconds;
+		std::uint64_t m_items = 0U;
+		double m_agreement = -1.0; // negative: not compared
+		double m_nsPerIteration = 0.0;
+		std::uint64_t m_iterations = 0U;
+	};
+
+	using BenchmarkFn = void (*)(Case& c);
+
+	/**
+	 * @brief Adds a benchmark to the global registry; returns true for static init.
+	 */
+	bool registerBenchmark(const char* name, BenchmarkFn fn, std::initializer_list<std::int64_t> args);
+
+	/**
+	 * @brief Runs every registered benchmark whose name contains filter.
+	 *
+	 * Arguments above maxArg are skipped (quick runs); results go to stdout
+	 * as an aligned table, or as CSV when csv is set.
+	 */
+	void runAll(const std::string& filter, double minSeconds, std::int64_t maxArg, bool csv);
+
+	template <typename T>
+	inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+		static const void* volatile sink;
+		sink = &value;
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+} // namespace bench
+
+#define OKPP_BENCH_CONCAT_INNER(a, b) a##b
+#define OKPP_BENCH_CONCAT(a, b) OKPP_BENCH_CONCAT_INNER(a, b)
+
+// Defines and registers a benchmark body: OKPP_BENCHMARK(name, 3, 1000) { ...; c.measure(...); }
+#define OKPP_BENCHMARK(name, ...) \
+	static void name(::bench::Case& c); \
+	static const bool OKPP_BENCH_CONCAT(name, _registered) = ::bench::registerBenchmark(#name, name, { __VA_ARGS__ }); \
+	static void name(::bench::Case& c)
@@ -0,0 +1,67 @@
+/*
+==============================================================================
+Benchmark runner - OKPP_LV1_bench
+==============================================================================
+ Usage: OKPP_LV1_bench [--filter text] [--min-time seconds] [--max-arg n] [--csv]
+                      [--simd scalar|sse2|avx2|avx512|neon]
+ - --filter runs only benchmarks whose name contains text
+ - --max-arg skips larger cases (e.g. --max-arg 10000 for a quick pass)
+ - --csv prints machine-readable rows for regression tracking
+ - --simd pins the dispatched kernels to a level (default: the widest this
+   CPU runs), to compare levels on one machine
+==============================================================================
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "Bench.hpp"
+
+#include "../CpuFeatures.hpp"
+#include "../DeterministicMath.hpp"
+#include "../ObstacleStore.hpp"
+
+int main(int argc, char* argv[]) {
+	std::string filter;
+	double minSeconds = 0.2;
+	std::int64_t maxArg = std::numeric_limits<std::int64_t>::max();
+	bool csv = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg(argv[i]);
+		if (arg == "--filter" && (i + 1) < argc) {
+			filter = argv[++i];
+		}
+		else if (arg == "--min-time" && (i + 1) < argc) {
+			minSeconds = std::strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--max-arg" && (i + 1) < argc) {
+			maxArg = std::strtoll(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--csv") {
+			csv = true;
+		}
+		else if (arg == "--simd" && (i + 1) < argc) {
+			sim::SimdLevel level = sim::SimdLevel::Scalar;
+			const std::string_view name(argv[++i]);
+			if (!sim::parseSimdLevel(name, level) || !sim::setSimdLevel(level)) {
+				std::cerr << "Error: SIMD level " << name << " is unknown or not supported here\n";
+				return 1;
+			}
+		}
+		else {
+			std::cerr << "Warning: ignoring unknown argument " << arg << '\n';
+		}
+	}
+
+	if (!csv) {
+		std::printf("SIMD kernel: %s\n", sim::simdKernelName());
+		std::printf("Math: %s\n", sim::DETERMINISTIC_MATH ? "deterministic polynomials" : "libm");
+	}
+	bench::runAll(filter, minSeconds, maxArg, csv);
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+==============================================================================
+Embedded gate - OKPP_LV1_embedded
+==============================================================================
+ Usage: OKPP_LV1_embedded
+ - Built like okpp_embedded (no exceptions, no RTTI) and linked against it
+   alone, so the warning pipeline is known to stand without okpp_core
+ - Loads the built-in lot (makeDefaultScene()'s pillars and bay, the
+   world's boundary walls, the corner rig) into an EmbeddedCore, then
+   drives past the first pillar and reverses into the bay at SIM_TICK_HZ
+ - Counts heap allocations from the end of init() to the end of the drive;
+   any at all fail the gate, as does a drive that never beeps or parks
+ - Exit code: 0 pass, 1 init refused the lot, 2 allocation or behaviour
+   regression
+==============================================================================
+*/
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "../Constants.hpp"
+#include "../EmbeddedCore.hpp"
+#include "../SensorRig.hpp"
+
+namespace {
+	std::uint64_t g_allocations = 0U;
+}
+
+// Counting replacements of the global allocation functions; without exceptions
+// an exhausted heap has nowhere to go but abort()
+void* operator new(std::size_t size) {
+	++g_allocations;
+	if (void* const memory = std::malloc((size > 0U) ? size : 1U)) {
+		return memory;
+	}
+	std::abort();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+namespace {
+
+	struct GateWaypoint {
+		sf::Vector2f position;
+		float headingDeg;
+		float seconds; // to reach it from the previous one
+	};
+
+	// Past the pillar at (800, 500), round to the bay and backwards into it, then parked for a second
+	constexpr std::array<GateWaypoint, 5U> GATE_DRIVE{ {
+		{ { 250.0F, 250.0F }, 0.0F, 0.0F },
+		{ { 800.0F, 400.0F }, 0.0F, 2.0F },
+		{ { 1810.0F, 620.0F }, 90.0F, 4.0F },
+		{ { 1810.0F, 185.0F }, 90.0F, 3.0F },
+		{ { 1810.0F, 185.0F }, 90.0F, 1.0F },
+	} };
+
+} // namespace
+
+int main() {
+	const std::array<sim::Obstacle, 3U> obstacles{ {
+		{ { 800.0F, 500.0F }, constants::OBSTACLE_RADIUS },
+		{ { 1550.0F, 800.0F }, constants::OBSTACLE_RADIUS },
+		{ { 1810.0F, 800.0F }, constants::OBSTACLE_RADIUS },
+	} };
+	const std::array<sf::FloatRect, 1U> bays{ {
+		{ { constants::WORLD_WIDTH - constants::PARK_WIDTH - constants::PARK_MARGIN, constants::PARK_MARGIN },
+			{ constants::PARK_WIDTH, constants::PARK_HEIGHT } },
+	} };
+	// boundaryWalls(): clockwise, the lot on the right of every side
+	const std::array<sim::WallSegment, 4U> walls{ {
+		{ { 0.0F, 0.0F }, { constants::WORLD_WIDTH, 0.0F }, 1U },
+		{ { constants::WORLD_WIDTH, 0.0F }, { constants::WORLD_WIDTH, constants::WORLD_HEIGHT }, 1U },
+		{ { constants::WORLD_WIDTH, constants::WORLD_HEIGHT }, { 0.0F, constants::WORLD_HEIGHT }, 1U },
+		{ { 0.0F, constants::WORLD_HEIGHT }, { 0.0F, 0.0F }, 1U },
+	} };
+	// defaultWarningProfile()'s bands, for every zone
+	const std::array<sim::WarningBand, 3U> bands{ { { 80.0F, 0.1F }, { 180.0F, 0.25F }, { 300.0F, 0.5F } } };
+	constexpr std::array<sim::SensorMount, 4U> mounts =
+		sim::layoutMounts<sim::CornerRigLayout>(std::make_index_sequence<4U>{});
+
+	sim::EmbeddedConfig config;
+	config.mounts = mounts.data();
+	config.mountCount = mounts.size();
+	config.obstacles = obstacles.data();
+	config.obstacleCount = obstacles.size();
+	config.walls = walls.data();
+	config.wallCount = walls.size();
+	config.bays = bays.data();
+	config.bayCount = bays.size();
+	for (std::size_t zone = 0U; zone < sim::SENSOR_ZONE_COUNT; ++zone) {
+		config.bands[zone] = bands.data();
+		config.bandCounts[zone] = bands.size();
+	}
+	config.carHalfExtent = sim::CornerRigLayout::HALF_EXTENT;
+
+	static sim::EmbeddedCore core; // static storage, as on the head unit
+	const sim::EmbeddedStatus status = core.init(config);
+	if (status != sim::EmbeddedStatus::Ok) {
+		std::fprintf(stderr, "Error: the embedded core refused the lot: %s\n", sim::embeddedStatusName(status));
+		return 1;
+	}
+
+	const std::uint64_t allocationsAtInit = g_allocations;
+	const float dt = 1.0F / constants::SIM_TICK_HZ;
+	std::uint64_t ticks = 0U;
+	std::uint64_t beeps = 0U;
+	std::uint64_t parkedTicks = 0U;
+	for (std::size_t leg = 1U; leg < GATE_DRIVE.size(); ++leg) {
+		const GateWaypoint& from = GATE_DRIVE[leg - 1U];
+		const GateWaypoint& to = GATE_DRIVE[leg];
+		const auto legTicks = static_cast<std::uint32_t>(to.seconds * constants::SIM_TICK_HZ);
+		for (std::uint32_t tick = 1U; tick <= legTicks; ++tick) {
+			const float t = static_cast<float>(tick) / static_cast<float>(legTicks);
+			const sim::CarState car{ from.position + (to.position - from.position) * t,
+				from.headingDeg + (to.headingDeg - from.headingDeg) * t };
+			const sim::EmbeddedOutput& output = core.step(car, dt);
+			beeps += output.beep ? 1U : 0U;
+			parkedTicks += (output.parkedBay != sim::NO_BAY) ? 1U : 0U;
+			++ticks;
+		}
+	}
+	const std::uint64_t allocations = g_allocations - allocationsAtInit;
+
+	std::printf("ticks: %llu\nbeeps: %llu\nparked ticks: %llu\narena: %zu of %zu bytes\n"
+		"core: %zu bytes static\nheap allocations after init: %llu\n",
+		static_cast<unsigned long long>(ticks), static_cast<unsigned long long>(beeps),
+		static_cast<unsigned long long>(parkedTicks), core.arenaUsed(), sim::EmbeddedCore::EMBEDDED_ARENA_BYTES,
+		sizeof(sim::EmbeddedCore), static_cast<unsigned long long>(allocations));
+
+	if (allocations > 0U) {
+		std::fprintf(stderr, "Error: the embedded pipeline allocated %llu times after init\n",
+			static_cast<unsigned long long>(allocations));
+		return 2;
+	}
+	if (beeps == 0U || parkedTicks == 0U) {
+		std::fprintf(stderr, "Error: the gate drive %s\n", (beeps == 0U) ? "never beeped" : "never parked");
+		return 2;
+	}
+	return 0;
+}
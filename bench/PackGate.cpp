@@ -0,0 +1,109 @@
+/*
+==============================================================================
+Asset pack gate - OKPP_LV1_packgate
+==============================================================================
+ Usage: OKPP_LV1_packgate
+ - Packs a scratch assets directory (one file) with writeAssetPack, then
+   checks that the pack opens and reads back the file's bytes
+ - Rewrites copies of the pack with the entry's payload moved past the
+   end of the file, just past it and far enough that the bytes left after
+   the offset wrap; open() must refuse both instead of handing read() a
+   view outside the mapping
+ - Exit code: 0 pass, 1 the scratch pack could not be built, 2 a pack was
+   opened or read wrongly
+==============================================================================
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../AssetPack.hpp"
+
+namespace {
+	// PackHeader is 16 bytes; the first entry's payload offset sits 16 bytes into it
+	constexpr std::size_t GATE_OFFSET_FIELD = 16U + 16U;
+
+	struct GatePatch {
+		const char* label;
+		std::uint64_t offset;
+	};
+
+	[[nodiscard]] std::vector<unsigned char> readFileBytes(const std::filesystem::path& path) {
+		std::ifstream in(path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+	}
+
+	[[nodiscard]] bool writeFileBytes(const std::filesystem::path& path, const std::vector<unsigned char>& bytes) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return static_cast<bool>(out);
+	}
+
+	// The pack's file size rounded up to the payload alignment, so a patched offset passes the alignment check
+	[[nodiscard]] std::uint64_t alignedPast(std::size_t size) noexcept {
+		const std::uint64_t alignment = assets::PAYLOAD_ALIGNMENT;
+		return (static_cast<std::uint64_t>(size) / alignment + 1U) * alignment;
+	}
+}
+
+int main() {
+	std::error_code error;
+	const std::filesystem::path root = std::filesystem::temp_directory_path(error) / "okpp_packgate";
+	std::filesystem::remove_all(root, error);
+	const std::filesystem::path assetsDir = root / "assets";
+	std::filesystem::create_directories(assetsDir, error);
+
+	// Incompressible enough to be stored, so offset and stored bytes are the only guard on the view
+	std::vector<unsigned char> payload(300U);
+	for (std::size_t i = 0U; i < payload.size(); ++i) {
+		payload[i] = static_cast<unsigned char>((i * 197U + 31U) ^ (i >> 3U));
+	}
+	const std::filesystem::path packPath = root / "good.pack";
+	if (error || !writeFileBytes(assetsDir / "probe.bin", payload)
+		|| !assets::writeAssetPack(assetsDir.generic_string(), packPath.generic_string()))
+	{
+		std::fprintf(stderr, "Error: could not build the scratch pack under %s\n", root.string().c_str());
+		return 1;
+	}
+	const std::string entryName = assetsDir.generic_string() + "/probe.bin";
+
+	int failures = 0;
+	{
+		assets::AssetPack pack;
+		assets::AssetBytes bytes;
+		if (!pack.open(packPath.generic_string()) || !pack.read(entryName, bytes) || bytes.size() != payload.size()
+			|| std::memcmp(bytes.data(), payload.data(), payload.size()) != 0)
+		{
+			std::fprintf(stderr, "Error: the scratch pack did not read back %s\n", entryName.c_str());
+			++failures;
+		}
+	}
+
+	const std::vector<unsigned char> good = readFileBytes(packPath);
+	const GatePatch patches[] = {
+		{ "offset just past the end", alignedPast(good.size()) },
+		{ "offset wrapping the bytes left", UINT64_C(0x8000000000000000) },
+	};
+	for (const GatePatch& patch : patches) {
+		std::vector<unsigned char> bad = good;
+		std::memcpy(bad.data() + GATE_OFFSET_FIELD, &patch.offset, sizeof(patch.offset));
+		const std::filesystem::path badPath = root / "bad.pack";
+		assets::AssetPack pack;
+		const bool opened = writeFileBytes(badPath, bad) && pack.open(badPath.generic_string());
+		std::printf("%-32s %s\n", patch.label, opened ? "OPENED" : "refused");
+		if (opened) {
+			std::fprintf(stderr, "Error: a pack with its %s was opened\n", patch.label);
+			++failures;
+		}
+	}
+
+	std::filesystem::remove_all(root, error);
+	return (failures > 0) ? 2 : 0;
+}
@@ -0,0 +1,370 @@
+/*
+==============================================================================
+Performance gate - OKPP_LV1_perfgate
+==============================================================================
+ Usage: OKPP_LV1_perfgate [--manifest file] [--baseline file] [--json file]
+        [--threshold fraction] [--runs n] [--write-baseline]
+ - Replays the golden drives listed in the manifest (bench/golden/golden.txt)
+   through runHeadless and reports, per drive, ticks/s, the p99 tick time
+   and heap allocations per tick as JSON (stdout, or --json file)
+ - Compares against the stored baseline (bench/golden/baseline.json): a
+   drive regresses when ticks/s drops or p99 grows by more than the
+   threshold (default 0.15), or when it allocates more per tick at all
+ - Exit code: 0 pass, 1 bad input, 2 regression; --write-baseline stores
+   this run as the new baseline instead of comparing
+ - Timings are machine-specific: refresh the baseline on the machine that
+   runs the gate whenever it changes
+ - Manifest format (text): one drive per line, "<name> <trace> <tickHz>
+   <arcade|bicycle> <passes>"; trace is relative to the manifest, '-' is
+   the built-in drive. Lines starting with '#' are comments.
+==============================================================================
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Headless.hpp"
+#include "../HeadlessApp.hpp"
+#include "../MemoryAccounting.hpp"
+#include "../Scene.hpp"
+#include "../WarningProfile.hpp"
+
+// Counting replacements of the global allocation functions (the array and
+// nothrow forms forward to these); over-aligned allocations are not counted
+void* operator new(std::size_t size) {
+	prof::countAllocation();
+	if (void* const memory = std::malloc((size > 0U) ? size : 1U)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+namespace {
+
+	struct GoldenDrive {
+		std::string name;
+		std::string tracePath; // empty: the built-in drive
+		float tickHz = 0.0F;
+		sim::VehicleModel model = sim::VehicleModel::Arcade;
+		std::uint32_t passes = 1U;
+	};
+
+	struct DriveResult {
+		std::string name;
+		std::uint64_t ticks = 0U;
+		double ticksPerSecond = 0.0;
+		double p99TickNs = 0.0;
+		double allocationsPerTick = 0.0;
+		const char* status = "ok";
+	};
+
+	[[nodiscard]] bool loadManifest(const std::string& path, std::vector<GoldenDrive>& drives) {
+		std::ifstream file(path);
+		if (!file) {
+			std::cerr << "Error: Failed to open golden manifest " << path << '\n';
+			return false;
+		}
+
+		const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+		std::string line;
+		std::size_t lineNumber = 0U;
+		while (std::getline(file, line)) {
+			++lineNumber;
+			if (line.empty() || line[0] == '#') {
+				continue;
+			}
+
+			std::istringstream fields(line);
+			GoldenDrive drive;
+			std::string trace;
+			std::string model;
+			if (!(fields >> drive.name >> trace >> drive.tickHz >> model >> drive.passes) || drive.tickHz <= 0.0F
+				|| drive.passes == 0U || (model != "arcade" && model != "bicycle"))
+			{
+				std::cerr << "Error: " << path << ':' << lineNumber
+					<< ": expected \"<name> <trace> <tickHz> <arcade|bicycle> <passes>\"\n";
+				return false;
+			}
+			if (trace != "-") {
+				drive.tracePath = (directory / trace).string();
+			}
+			drive.model = (model == "bicycle") ? sim::VehicleModel::Bicycle : sim::VehicleModel::Arcade;
+			drives.push_back(std::move(drive));
+		}
+		if (drives.empty()) {
+			std::cerr << "Error: " << path << " lists no drives\n";
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] double percentileOf(std::vector<std::uint32_t>& values, double p) {
+		if (values.empty()) {
+			return 0.0;
+		}
+		const double rank = p / 100.0 * static_cast<double>(values.size() - 1U);
+		const auto nth = values.begin() + static_cast<std::ptrdiff_t>(rank + 0.5);
+		std::nth_element(values.begin(), nth, values.end());
+		return static_cast<double>(*nth);
+	}
+
+	/**
+	 * @brief Best of runs after a warm-up: plain passes for ticks/s, probed passes for p99 and allocations.
+	 */
+	[[nodiscard]] bool runDrive(const GoldenDrive& drive, const sim::Scene& scene, const sim::WarningProfile& profile,
+		std::uint32_t runs, DriveResult& result)
+	{
+		std::vector<sim::TraceSegment> trace;
+		if (drive.tracePath.empty()) {
+			trace = sim::defaultInputTrace(drive.tickHz);
+		}
+		else if (!sim::loadInputTrace(drive.tracePath, trace)) {
+			return false;
+		}
+
+		result.name = drive.name;
+		(void)sim::runHeadless(scene, trace, drive.tickHz, drive.passes, profile, drive.model); // warm caches and clocks
+
+		sim::TickProbe probe;
+		for (std::uint32_t run = 0U; run < runs; ++run) {
+			const sim::HeadlessStats stats = sim::runHeadless(scene, trace, drive.tickHz, drive.passes, profile,
+				drive.model);
+			if (stats.wallSeconds > 0.0) {
+				result.ticksPerSecond = std::max(result.ticksPerSecond, static_cast<double>(stats.ticks) / stats.wallSeconds);
+			}
+			result.ticks = stats.ticks;
+
+			(void)sim::runHeadless(scene, trace, drive.tickHz, drive.passes, profile, drive.model, {}, &probe);
+			const double p99 = percentileOf(probe.tickNanoseconds, 99.0);
+			result.p99TickNs = (run == 0U) ? p99 : std::min(result.p99TickNs, p99);
+			result.allocationsPerTick = (stats.ticks > 0U)
+				? static_cast<double>(probe.allocations) / static_cast<double>(stats.ticks) : 0.0;
+		}
+		return true;
+	}
+
+	void writeJson(std::ostream& out, const std::vector<DriveResult>& results, double threshold, std::size_t regressions) {
+		char number[64];
+		out << "{\n  \"version\": 1,\n";
+		std::snprintf(number, sizeof(number), "%.3f", threshold);
+		out << "  \"threshold\": " << number << ",\n  \"drives\": [\n";
+		for (std::size_t i = 0U; i < results.size(); ++i) {
+			const DriveResult& r = results[i];
+			out << "    { \"name\": \"" << r.name << "\", \"ticks\": " << r.ticks;
+			std::snprintf(number, sizeof(number), "%.1f", r.ticksPerSecond);
+			out << ", \"ticks_per_second\": " << number;
+			std::snprintf(number, sizeof(number), "%.1f", r.p99TickNs);
+			out << ", \"p99_tick_ns\": " << number;
+			std::snprintf(number, sizeof(number), "%.4f", r.allocationsPerTick);
+			out << ", \"allocations_per_tick\": " << number << ", \"status\": \"" << r.status << "\" }"
+				<< ((i + 1U < results.size()) ? ",\n" : "\n");
+		}
+		out << "  ],\n  \"regressions\": " << regressions << "\n}\n";
+	}
+
+	using BaselineDrive = std::map<std::string, double>;
+
+	/**
+	 * @brief Reads the numeric fields of every drive in a report written by writeJson, keyed by name.
+	 *
+	 * Not a general JSON parser: each "name" string opens a record, later numbers join it.
+	 */
+	[[nodiscard]] bool loadBaseline(const std::string& path, std::map<std::string, BaselineDrive>& baseline) {
+		std::ifstream file(path);
+		if (!file) {
+			std::cerr << "Error: Failed to open baseline " << path << " (create it with --write-baseline)\n";
+			return false;
+		}
+		const std::string text{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+		BaselineDrive* current = nullptr;
+		std::size_t i = 0U;
+		const auto readString = [&text, &i]() {
+			std::string value;
+			for (++i; i < text.size() && text[i] != '"'; ++i) {
+				value += text[i];
+			}
+			++i;
+			return value;
+		};
+		const auto skipSpace = [&text, &i]() {
+			while (i < text.size() && (text[i] == ' ' || text[i] == '\t' || text[i] == '\n' || text[i] == '\r')) {
+				++i;
+			}
+		};
+
+		while (i < text.size()) {
+			if (text[i] != '"') {
+				++i;
+				continue;
+			}
+			const std::string key = readString();
+			skipSpace();
+			if (i >= text.size() || text[i] != ':') {
+				continue;
+			}
+			++i;
+			skipSpace();
+			if (i < text.size() && text[i] == '"') {
+				const std::string value = readString();
+				if (key == "name") {
+					current = &baseline[value];
+				}
+			}
+			else if (current != nullptr) {
+				char* end = nullptr;
+				const double value = std::strtod(text.c_str() + i, &end);
+				if (end != text.c_str() + i) {
+					(*current)[key] = value;
+					i = static_cast<std::size_t>(end - text.c_str());
+				}
+			}
+		}
+		if (baseline.empty()) {
+			std::cerr << "Error: baseline " << path << " lists no drives\n";
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Marks result regressed (and explains why on stderr) if it is worse than its baseline.
+	 */
+	[[nodiscard]] bool compare(DriveResult& result, const BaselineDrive& baseline, double threshold) {
+		const auto field = [&baseline](const char* key) {
+			const auto found = baseline.find(key);
+			return (found != baseline.end()) ? found->second : 0.0;
+		};
+
+		if (static_cast<double>(result.ticks) != field("ticks")) {
+			std::cerr << "Warning: " << result.name << " ran " << result.ticks << " ticks, the baseline "
+				<< field("ticks") << "; the drive changed, refresh the baseline\n";
+		}
+
+		bool regressed = false;
+		const double ticksPerSecond = field("ticks_per_second");
+		if (result.ticksPerSecond < ticksPerSecond * (1.0 - threshold)) {
+			std::cerr << "Regression: " << result.name << " ticks/s " << result.ticksPerSecond
+				<< " < baseline " << ticksPerSecond << '\n';
+			regressed = true;
+		}
+		const double p99 = field("p99_tick_ns");
+		if (result.p99TickNs > p99 * (1.0 + threshold)) {
+			std::cerr << "Regression: " << result.name << " p99 tick " << result.p99TickNs
+				<< " ns > baseline " << p99 << " ns\n";
+			regressed = true;
+		}
+		// Allocation counts are deterministic: any growth is a regression
+		const double allocations = field("allocations_per_tick");
+		if (result.allocationsPerTick > allocations + 1.0e-4) {
+			std::cerr << "Regression: " << result.name << " allocations/tick " << result.allocationsPerTick
+				<< " > baseline " << allocations << '\n';
+			regressed = true;
+		}
+		result.status = regressed ? "regressed" : "ok";
+		return regressed;
+	}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::string manifestPath = "bench/golden/golden.txt";
+	std::string baselinePath = "bench/golden/baseline.json";
+	std::string jsonPath;
+	double threshold = 0.15;
+	std::uint32_t runs = 5U;
+	bool writeBaseline = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg(argv[i]);
+		if (arg == "--manifest" && (i + 1) < argc) {
+			manifestPath = argv[++i];
+		}
+		else if (arg == "--baseline" && (i + 1) < argc) {
+			baselinePath = argv[++i];
+		}
+		else if (arg == "--json" && (i + 1) < argc) {
+			jsonPath = argv[++i];
+		}
+		else if (arg == "--threshold" && (i + 1) < argc) {
+			threshold = std::clamp(std::strtod(argv[++i], nullptr), 0.0, 1.0);
+		}
+		else if (arg == "--runs" && (i + 1) < argc) {
+			const unsigned long value = std::strtoul(argv[++i], nullptr, 10);
+			runs = (value > 0UL) ? static_cast<std::uint32_t>(value) : 1U;
+		}
+		else if (arg == "--write-baseline") {
+			writeBaseline = true;
+		}
+		else {
+			std::cerr << "Warning: ignoring unknown argument " << arg << '\n';
+		}
+	}
+
+	std::vector<GoldenDrive> drives;
+	sim::Scene scene;
+	sim::WarningProfile profile;
+	if (!loadManifest(manifestPath, drives) || !sim::loadScene({}, scene) || !sim::loadWarningProfile({}, {}, profile)) {
+		return 1;
+	}
+
+	std::map<std::string, BaselineDrive> baseline;
+	if (!writeBaseline && !loadBaseline(baselinePath, baseline)) {
+		return 1;
+	}
+
+	std::vector<DriveResult> results;
+	std::size_t regressions = 0U;
+	for (const GoldenDrive& drive : drives) {
+		DriveResult result;
+		if (!runDrive(drive, scene, profile, runs, result)) {
+			return 1;
+		}
+		if (!writeBaseline) {
+			const auto found = baseline.find(drive.name);
+			if (found == baseline.end()) {
+				std::cerr << "Warning: " << drive.name << " has no baseline yet\n";
+				result.status = "new";
+			}
+			else if (compare(result, found->second, threshold)) {
+				++regressions;
+			}
+		}
+		results.push_back(std::move(result));
+	}
+
+	const std::string& reportPath = writeBaseline ? baselinePath : jsonPath;
+	if (reportPath.empty()) {
+		writeJson(std::cout, results, threshold, regressions);
+	}
+	else {
+		std::ofstream file(reportPath, std::ios::trunc);
+		if (!file) {
+			std::cerr << "Error: Failed to write " << reportPath << '\n';
+			return 1;
+		}
+		writeJson(file, results, threshold, regressions);
+	}
+	return (regressions > 0U) ? 2 : 0;
+}
@@ -0,0 +1,1122 @@
+/*
+==============================================================================
+Simulation kernel benchmarks
+==============================================================================
+ - Nearest-obstacle variants: brute force (sqrt per pair), SoA scalar,
+   SoA SIMD, uniform grid, ray-cast cones and the baked distance field;
+   the grid and the cones again with as many polygon islands as pillars;
+   grid radius (within the beep range) and 4-nearest queries; 16-bit
+   fixed-point tiles with integer SIMD distances
+ - Nearest backends (the --nearest switch): each engine's sensor pass over
+   the same poses, with its agreement against the brute-force reference
+ - Occupancy mapping: one tick of a car's sensor rays folded into the
+   log-odds map, then the sensor pass read back from it
+ - Time to collision: a driving car's per-tick prediction on top of the
+   grid sensor pass
+ - Sensor placement and bay occupancy (single check vs. parking lot index)
+ - Sensor rigs: one tick of placement plus the grid pass for rigs of 4 to 256 sensors;
+   the built-in rig's pass with and without the obstacle cluster test ahead of it;
+   the corner rig also through the fixed-capacity embedded core (up to its 1024 pillars)
+ - Bicycle model integration: per-car libm step vs. SoA scalar and SIMD kernels
+ - Heading sine/cosine: libm on radians vs. the degree polynomial
+ - Scenario loading: memory-mapped binary lot of the given obstacle count
+ - Dynamic obstacles: despawn/spawn churn plus a pass over the live ones,
+   id-tagged vector (find + erase) vs. the handle-based entity pool
+ - Moving obstacles: one tick of movers plus a sensor query batch, the
+   static grid rebuilt every tick vs. the incrementally updated loose grid
+ - Sensor noise: Philox words one sensor at a time vs. the vectorized
+   batch, and a full noisy pass (Gaussian error, dropouts, latency)
+ - Sensor query batches: a fleet-sized batch of poses through
+   querySensors() inline and fanned out over the shared pool
+ - Argument = obstacle / bay / car / sensor count; obstacles keep the density of the
+   default scene so larger counts mean a larger lot, not a denser one
+==============================================================================
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+
+#include "../AisleGraph.hpp"
+#include "../BayOccupancy.hpp"
+#include "../CarModel.hpp"
+#include "../CollisionPredictor.hpp"
+#include "../Constants.hpp"
+#include "../DistanceField.hpp"
+#include "../EmbeddedCore.hpp"
+#include "../EntityPool.hpp"
+#include "../FastTrig.hpp"
+#include "../MovingObstacles.hpp"
+#include "../NearestBackends.hpp"
+#include "../ObstacleClusters.hpp"
+#include "../ObstacleGrid.hpp"
+#include "../ObstacleStore.hpp"
+#include "../OccupancyMap.hpp"
+#include "../Parking.hpp"
+#include "../ParkingLot.hpp"
+#include "../PolygonBvh.hpp"
+#include "../QuantizedObstacles.hpp"
+#include "../RayCast.hpp"
+#include "../Scenario.hpp"
+#include "../Scene.hpp"
+#include "../SensorNoise.hpp"
+#include "../SensorQuery.hpp"
+#include "../SensorRig.hpp"
+#include "../Sensors.hpp"
+#include "../SimTypes.hpp"
+#include "../StressScenes.hpp"
+#include "../ThreadPool.hpp"
+#include "../VehicleDynamics.hpp"
+#include "../WarningProfile.hpp"
+
+namespace {
+
+	constexpr std::size_t QUERY_COUNT = 64U;
+	constexpr std::uint32_t SEED = 0x0C0FFEEU;
+	constexpr float BENCH_TICK_DT = 1.0F / 60.0F;
+
+	// Lot that holds count pillars at the default scene's density
+	struct ObstacleScene {
+		sf::Vector2f extent;
+		std::vector<sim::Obstacle> obstacles;
+		std::vector<sf::Vector2f> centers;
+		std::vector<sim::WallSegment> walls; // the lot's sides
+		std::vector<sf::Vector2f> queries;
+
+		explicit ObstacleScene(std::int64_t count) {
+			const float scale = std::sqrt(static_cast<float>(count) / 3.0F);
+			extent = { constants::WORLD_WIDTH * scale, constants::WORLD_HEIGHT * scale };
+
+			std::mt19937 rng(SEED);
+			std::uniform_real_distribution<float> x(0.0F, extent.x);
+			std::uniform_real_distribution<float> y(0.0F, extent.y);
+			obstacles.resize(static_cast<std::size_t>(count));
+			for (auto& obstacle : obstacles) {
+				obstacle = { { x(rng), y(rng) }, constants::OBSTACLE_RADIUS };
+				centers.push_back(obstacle.center);
+			}
+			for (std::size_t i = 0U; i < QUERY_COUNT; ++i) {
+				queries.push_back({ x(rng), y(rng) });
+			}
+			walls = sim::boundaryWalls({ { 0.0F, 0.0F }, extent });
+		}
+	};
+
+	// One concave eight-cornered island per lattice cell, so islands never overlap
+	[[nodiscard]] sim::PolygonSet islandPolygons(const ObstacleScene& scene) {
+		constexpr std::size_t CORNERS = 8U;
+		const float spacing = std::sqrt(scene.extent.x * scene.extent.y / static_cast<float>(scene.centers.size()));
+		const float reach = std::min(0.4F * spacing, 60.0F);
+		std::mt19937 rng(SEED + 2U);
+		std::uniform_real_distribution<float> radius(0.5F * reach, reach);
+		sim::PolygonSet polygons;
+		std::vector<sf::Vector2f> outline(CORNERS);
+		for (float y = 0.5F * spacing; y < scene.extent.y; y += spacing) {
+			for (float x = 0.5F * spacing; x < scene.extent.x; x += spacing) {
+				for (std::size_t i = 0U; i < CORNERS; ++i) {
+					const sim::SinCos sc = sim::sinCosDeg(360.0F * static_cast<float>(i) / static_cast<float>(CORNERS));
+					const float r = radius(rng);
+					outline[i] = { x + r * sc.cos, y + r * sc.sin };
+				}
+				polygons.add(outline);
+			}
+		}
+		return polygons;
+	}
+
+	[[nodiscard]] float distance(const sf::Vector2f& a, const sf::Vector2f& b) {
+		const float dx = a.x - b.x;
+		const float dy = a.y - b.y;
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+} // namespace
+
+// The original playBeepIfNear search: one sqrt per sensor/obstacle pair
+OKPP_BENCHMARK(nearest_bruteforce, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			float best = std::numeric_limits<float>::max();
+			for (const auto& center : scene.centers) {
+				best = std::min(best, distance(query, center));
+			}
+			bench::doNotOptimize(best);
+		}
+	});
+}
+
+OKPP_BENCHMARK(nearest_store_scalar, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleStore store;
+	store.assign(scene.centers);
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(std::sqrt(sim::nearestDistanceSqScalar(store, query)));
+		}
+	});
+}
+
+OKPP_BENCHMARK(nearest_store_simd, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleStore store;
+	store.assign(scene.centers);
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(sim::nearestDistance(store, query));
+		}
+	});
+}
+
+OKPP_BENCHMARK(nearest_grid, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE);
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(grid.nearestDistance(query, constants::BEEP_MAX_RANGE));
+		}
+	});
+}
+
+OKPP_BENCHMARK(nearest_quantized, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::QuantizedObstacleTiles tiles;
+	if (!tiles.build(scene.centers)) {
+		return;
+	}
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(tiles.nearest(query, constants::BEEP_MAX_RANGE).distanceSq);
+		}
+	});
+}
+
+namespace {
+	// One sensor pass of backend over the query points; the agree column is against brute force
+	void nearestBackendCase(bench::Case& c, sim::NearestBackend backend) {
+		const ObstacleScene scene(c.arg());
+		sim::ObstacleGrid grid;
+		grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+		sim::DistanceField field;
+		if (backend == sim::NearestBackend::Field) {
+			field.bake(scene.obstacles, { { 0.0F, 0.0F }, scene.extent }, constants::SDF_CELL_SIZE * 4.0F);
+		}
+		sim::NearestEngines engines;
+		engines.setGrid(&grid);
+		engines.setField(&field);
+		engines.build(scene.obstacles);
+
+		std::vector<sim::SensorPose> poses(scene.queries.size());
+		for (std::size_t i = 0U; i < poses.size(); ++i) {
+			poses[i].position = scene.queries[i];
+		}
+		std::vector<sim::SensorReading> readings;
+		sim::NearestComparison comparison;
+		comparison.begin(scene.obstacles, poses, constants::BEEP_MAX_RANGE);
+		engines.query(backend, poses, constants::BEEP_MAX_RANGE, readings);
+		comparison.record(backend, readings, 0.0, sim::nearestTolerance(backend, &field));
+		c.setAgreement(comparison.tally(backend).agreement());
+
+		c.setItemsPerIteration(poses.size());
+		c.measure([&]() {
+			engines.query(backend, poses, constants::BEEP_MAX_RANGE, readings);
+			bench::doNotOptimize(readings.back().distanceSq);
+		});
+	}
+}
+
+OKPP_BENCHMARK(nearest_backend_brute, 3, 100, 10000, 1000000) {
+	nearestBackendCase(c, sim::NearestBackend::BruteForce);
+}
+
+OKPP_BENCHMARK(nearest_backend_simd, 3, 100, 10000, 1000000) {
+	nearestBackendCase(c, sim::NearestBackend::Simd);
+}
+
+OKPP_BENCHMARK(nearest_backend_grid, 3, 100, 10000, 1000000) {
+	nearestBackendCase(c, sim::NearestBackend::Grid);
+}
+
+OKPP_BENCHMARK(nearest_backend_bvh, 3, 100, 10000, 1000000) {
+	nearestBackendCase(c, sim::NearestBackend::Bvh);
+}
+
+// The bake stops at 10k pillars as in nearest_sdf_sample; it agrees within its (coarser) cell
+OKPP_BENCHMARK(nearest_backend_sdf, 3, 100, 10000) {
+	nearestBackendCase(c, sim::NearestBackend::Field);
+}
+
+namespace {
+	// Poses a fleet of 4096 four-sensor cars reads per tick
+	constexpr std::size_t BATCH_SENSORS = 16384U;
+
+	[[nodiscard]] std::vector<sim::SensorPose> batchPoses(const ObstacleScene& scene) {
+		std::vector<sim::SensorPose> poses(BATCH_SENSORS);
+		for (std::size_t i = 0U; i < poses.size(); ++i) {
+			poses[i].position = scene.queries[i % scene.queries.size()];
+		}
+		return poses;
+	}
+}
+
+// One batch through the grid on the calling thread
+OKPP_BENCHMARK(sensor_batch_inline, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+	const std::vector<sim::SensorPose> poses = batchPoses(scene);
+	std::vector<sim::SensorReading> readings(poses.size());
+	c.setItemsPerIteration(poses.size());
+	c.measure([&]() {
+		sim::querySensors({ &grid, nullptr, constants::BEEP_MAX_RANGE }, poses.data(), poses.size(), readings.data());
+		bench::doNotOptimize(readings.back().distanceSq);
+	});
+}
+
+// The same batch in cache-sized chunks over the shared pool
+OKPP_BENCHMARK(sensor_batch_pool, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+	const std::vector<sim::SensorPose> poses = batchPoses(scene);
+	std::vector<sim::SensorReading> readings(poses.size());
+	sim::ThreadPool& pool = sim::sharedPool();
+	c.setItemsPerIteration(poses.size());
+	c.measure([&]() {
+		sim::querySensors({ &grid, nullptr, constants::BEEP_MAX_RANGE }, poses.data(), poses.size(), readings.data(),
+			&pool);
+		bench::doNotOptimize(readings.back().distanceSq);
+	});
+}
+
+// Everything inside the outermost beep band, into a fixed buffer
+OKPP_BENCHMARK(within_grid, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE);
+	std::array<sim::ObstacleHit, 256> hits;
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(grid.within(query, constants::BEEP_MAX_RANGE, hits.data(), hits.size()));
+		}
+	});
+}
+
+// The four nearest per query, as a sensor's candidate list
+OKPP_BENCHMARK(nearest_k_grid, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE);
+	std::array<sim::ObstacleHit, 4> hits;
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(grid.nearestK(query, constants::BEEP_MAX_RANGE, hits.data(), hits.size()));
+		}
+	});
+}
+
+// As many 120 px curbs as pillars, scattered at random angles: one lookup finds the nearest of each
+OKPP_BENCHMARK(nearest_grid_walls, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	std::vector<sim::WallSegment> walls = scene.walls;
+	std::mt19937 rng(SEED + 1U);
+	std::uniform_real_distribution<float> x(0.0F, scene.extent.x);
+	std::uniform_real_distribution<float> y(0.0F, scene.extent.y);
+	std::uniform_real_distribution<float> angle(0.0F, 360.0F);
+	for (std::size_t i = 0U; i < scene.centers.size(); ++i) {
+		const sf::Vector2f center{ x(rng), y(rng) };
+		const sim::SinCos sc = sim::sinCosDeg(angle(rng));
+		const sf::Vector2f half{ 60.0F * sc.cos, 60.0F * sc.sin };
+		walls.push_back({ center - half, center + half, 0U });
+	}
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, walls);
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			const sim::NearestObstacle nearest = grid.nearest(query, constants::BEEP_MAX_RANGE);
+			bench::doNotOptimize(nearest.distanceSq + nearest.wallDistance);
+		}
+	});
+}
+
+// Pillars plus about as many irregular islands: the edge BVH runs within the nearest pillar's distance
+OKPP_BENCHMARK(nearest_grid_polygons, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls, islandPolygons(scene));
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			const sim::NearestObstacle nearest = grid.nearest(query, constants::BEEP_MAX_RANGE);
+			bench::doNotOptimize(nearest.distanceSq + nearest.wallDistance);
+		}
+	});
+}
+
+OKPP_BENCHMARK(nearest_raycast_cone, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::RayCaster caster;
+	caster.build(scene.obstacles, {}, constants::OBSTACLE_CELL_SIZE);
+	const sim::RayCone cone{ constants::SENSOR_CONE_HALF_ANGLE, constants::SENSOR_CONE_RAYS, constants::BEEP_MAX_RANGE };
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		float facing = 0.0F;
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(caster.castCone(query, facing, cone));
+			facing += 37.0F;
+		}
+	});
+}
+
+OKPP_BENCHMARK(nearest_raycast_cone_polygons, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::RayCaster caster;
+	caster.build(scene.obstacles, {}, constants::OBSTACLE_CELL_SIZE, islandPolygons(scene));
+	const sim::RayCone cone{ constants::SENSOR_CONE_HALF_ANGLE, constants::SENSOR_CONE_RAYS, constants::BEEP_MAX_RANGE };
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		float facing = 0.0F;
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(caster.castCone(query, facing, cone));
+			facing += 37.0F;
+		}
+	});
+}
+
+// One mapping tick per query: the car's four sensors cast their cones into the
+// map and the sensor pass reads the nearest mapped obstacles back
+OKPP_BENCHMARK(occupancy_map_tick, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::RayCaster caster;
+	caster.build(scene.obstacles, {}, constants::OBSTACLE_CELL_SIZE);
+	const sim::RayCone cone{ constants::SENSOR_CONE_HALF_ANGLE, constants::SENSOR_CONE_RAYS, constants::BEEP_MAX_RANGE };
+	const std::vector<sim::SensorMount> mounts =
+		sim::createSensorMounts({ constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT });
+	std::vector<sim::SensorPose> sensors = sim::createSensorPoses();
+	std::vector<sim::SensorReading> readings;
+	sim::OccupancyMap map(constants::OCCUPANCY_CELL_SIZE, constants::OCCUPANCY_TILES);
+	sim::ObstacleGrid walls;
+	walls.build({}, constants::OBSTACLE_CELL_SIZE, scene.walls);
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		float heading = 0.0F;
+		for (const auto& query : scene.queries) {
+			sim::updateSensorPositions(sensors, mounts, { query, heading });
+			map.recenter(query);
+			sim::mapSensors(sensors, caster, cone, map);
+			sim::readSensors(sensors, map, constants::BEEP_MAX_RANGE, walls, readings);
+			heading += 37.0F;
+		}
+		bench::doNotOptimize(readings.front().distanceSq);
+	});
+}
+
+// A car circling through the lot: every tick runs the grid sensor pass and the
+// time-to-collision prediction, which reuses its candidates while the car stays near
+OKPP_BENCHMARK(collision_predictor_tick, 3, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+	const std::vector<sim::SensorMount> mounts =
+		sim::createSensorMounts({ constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT });
+	std::vector<sim::SensorPose> sensors = sim::createSensorPoses();
+	std::vector<sim::SensorReading> readings;
+	std::vector<float> timeToCollision;
+	const sim::CarParams params{ constants::CAR_SPEED, constants::CAR_TURN_RATE * 0.25F };
+	constexpr float dt = 1.0F / constants::SIM_TICK_HZ;
+	sim::CollisionPredictor predictor;
+	sim::CarState car{ scene.extent * 0.5F, 0.0F };
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (std::size_t i = 0U; i < QUERY_COUNT; ++i) {
+			const sim::CarState previous = car;
+			sim::stepCar(car, static_cast<sim::CarInput>(sim::input::FORWARD | sim::input::RIGHT), params, dt);
+			sim::updateSensorPositions(sensors, mounts, car);
+			sim::readSensors(sensors, grid, constants::BEEP_MAX_RANGE, readings);
+			predictor.predict(previous, car, dt, mounts, scene.obstacles, grid, timeToCollision);
+		}
+		bench::doNotOptimize(timeToCollision.front());
+	});
+}
+
+// Bake cost grows with cells x obstacles, so the field stops at 10k pillars
+OKPP_BENCHMARK(nearest_sdf_sample, 3, 100, 10000) {
+	const ObstacleScene scene(c.arg());
+	sim::DistanceField field;
+	field.bake(scene.obstacles, { { 0.0F, 0.0F }, scene.extent }, constants::SDF_CELL_SIZE * 4.0F);
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		for (const auto& query : scene.queries) {
+			bench::doNotOptimize(field.sample(query));
+		}
+	});
+}
+
+// Arg = cars; every car places its four sensors from the mounts
+OKPP_BENCHMARK(update_sensor_positions, 1, 100, 10000) {
+	const std::vector<sim::SensorMount> mounts =
+		sim::createSensorMounts({ constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT });
+	std::vector<std::vector<sim::SensorPose>> sensors(static_cast<std::size_t>(c.arg()), sim::createSensorPoses());
+	std::vector<sim::CarState> cars(sensors.size());
+	for (std::size_t i = 0U; i < cars.size(); ++i) {
+		cars[i] = { { static_cast<float>(i % 100U) * 50.0F, static_cast<float>(i / 100U) * 50.0F },
+			static_cast<float>(i) * 7.0F };
+	}
+	c.setItemsPerIteration(cars.size());
+	c.measure([&]() {
+		for (std::size_t i = 0U; i < cars.size(); ++i) {
+			sim::updateSensorPositions(sensors[i], mounts, cars[i]);
+			cars[i].headingDeg += 1.0F;
+		}
+		bench::doNotOptimize(sensors.front().front().position);
+	});
+}
+
+// Arg = sensors on one car's rig, evenly around the body; one tick places
+// them all in one batch and runs the grid sensor pass over the whole rig
+OKPP_BENCHMARK(sensor_rig_tick, 4, 16, 64, 256) {
+	const ObstacleScene scene(1000);
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+	std::vector<sim::RigSensor> rig(static_cast<std::size_t>(c.arg()));
+	for (std::size_t i = 0U; i < rig.size(); ++i) {
+		const float angle = static_cast<float>(i) * 360.0F / static_cast<float>(rig.size());
+		const sim::SinCos sc = sim::sinCosDeg(angle);
+		rig[i].zone = (sc.cos >= 0.0F) ? sim::SensorZone::Front : sim::SensorZone::Rear;
+		rig[i].anchor = { sc.cos, sc.sin };
+		rig[i].rotationDeg = angle - 90.0F;
+	}
+	const std::vector<sim::SensorMount> mounts =
+		sim::createSensorMounts({ constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT }, rig);
+	std::vector<sim::SensorPose> sensors = sim::createSensorPoses(rig);
+	std::vector<sim::SensorReading> readings;
+	c.setItemsPerIteration(QUERY_COUNT * rig.size());
+	c.measure([&]() {
+		float heading = 0.0F;
+		for (const auto& query : scene.queries) {
+			sim::updateSensorPositions(sensors, mounts, { query, heading });
+			sim::readSensors(sensors, grid, constants::BEEP_MAX_RANGE, readings);
+			heading += 37.0F;
+		}
+		bench::doNotOptimize(readings.front().distanceSq);
+	});
+}
+
+namespace {
+	constexpr std::size_t GROUP_PILLARS = 16U;
+	constexpr float GROUP_SPREAD = 150.0F;
+
+	// The scene's pillars pulled together into groups of GROUP_PILLARS, leaving open aisles between them
+	[[nodiscard]] ObstacleScene groupedScene(std::int64_t count) {
+		ObstacleScene scene(count);
+		std::mt19937 rng(SEED + 3U);
+		std::uniform_real_distribution<float> offset(-GROUP_SPREAD, GROUP_SPREAD);
+		for (std::size_t i = 0U; i < scene.obstacles.size(); ++i) {
+			const sf::Vector2f group = scene.obstacles[i - i % GROUP_PILLARS].center;
+			scene.obstacles[i].center = group + sf::Vector2f{ offset(rng), offset(rng) };
+			scene.centers[i] = scene.obstacles[i].center;
+		}
+		return scene;
+	}
+
+	// The built-in rig's grid pass at every query, behind the cluster test if asked
+	void benchSensorPass(bench::Case& c, bool useClusters) {
+		const ObstacleScene scene = groupedScene(c.arg());
+		sim::ObstacleGrid grid;
+		grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+		sim::ObstacleClusters clusters;
+		clusters.build(scene.obstacles, scene.walls);
+		const std::vector<sim::SensorMount> mounts =
+			sim::createSensorMounts({ constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT });
+		std::vector<sim::SensorPose> sensors = sim::createSensorPoses();
+		std::vector<sim::SensorReading> readings;
+		c.setItemsPerIteration(QUERY_COUNT);
+		c.measure([&]() {
+			float heading = 0.0F;
+			for (const auto& query : scene.queries) {
+				sim::updateSensorPositions(sensors, mounts, { query, heading });
+				if (!useClusters || clusters.anyNear(sensors, constants::BEEP_MAX_RANGE)) {
+					sim::readSensors(sensors, grid, constants::BEEP_MAX_RANGE, readings);
+				}
+				else {
+					readings.assign(sensors.size(), sim::SensorReading{});
+				}
+				heading += 37.0F;
+			}
+			bench::doNotOptimize(readings.front().distanceSq);
+		});
+	}
+}
+
+// Arg = obstacles, in groups with open aisles between; one car's sensor pass at
+// scattered poses, most of them out of beep range of everything: every lookup run
+OKPP_BENCHMARK(sensor_pass_grid, 100, 1000, 10000) {
+	benchSensorPass(c, false);
+}
+
+// The same, cleared after a few cluster bounds whenever nothing is in range
+OKPP_BENCHMARK(sensor_pass_clusters, 100, 1000, 10000) {
+	benchSensorPass(c, true);
+}
+
+// Arg = obstacles; the built-in four-sensor rig both ways, the vector path
+// against the compile-time rig whose mount transforms and queries are unrolled
+OKPP_BENCHMARK(corner_rig_tick_runtime, 100, 10000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+	const std::vector<sim::SensorMount> mounts = sim::createSensorMounts(sim::CornerRigLayout::HALF_EXTENT);
+	std::vector<sim::SensorPose> sensors = sim::createSensorPoses();
+	std::vector<sim::SensorReading> readings;
+	const sim::WarningProfile profile = sim::defaultWarningProfile();
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		float heading = 0.0F;
+		float interval = 0.0F;
+		for (const auto& query : scene.queries) {
+			sim::updateSensorPositions(sensors, mounts, { query, heading });
+			sim::readSensors(sensors, grid, constants::BEEP_MAX_RANGE, readings);
+			interval += sim::warningInterval(readings, mounts, profile);
+			heading += 37.0F;
+		}
+		bench::doNotOptimize(interval);
+	});
+}
+
+OKPP_BENCHMARK(corner_rig_tick_fixed, 100, 10000) {
+	const ObstacleScene scene(c.arg());
+	sim::ObstacleGrid grid;
+	grid.build(scene.centers, constants::OBSTACLE_CELL_SIZE, scene.walls);
+	sim::CornerSensorRig::Poses sensors{};
+	sim::CornerSensorRig::Readings readings{};
+	const sim::WarningProfile profile = sim::defaultWarningProfile();
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		float heading = 0.0F;
+		float interval = 0.0F;
+		for (const auto& query : scene.queries) {
+			const sim::CarState car{ query, heading };
+			sim::CornerSensorRig::place(sim::carTransform(car), car.headingDeg, sensors);
+			sim::CornerSensorRig::read(sensors, grid, constants::BEEP_MAX_RANGE, readings);
+			interval += sim::CornerSensorRig::warningInterval(readings, profile);
+			heading += 37.0F;
+		}
+		bench::doNotOptimize(interval);
+	});
+}
+
+// The same tick on the embedded core, which also times the beep and checks parking
+OKPP_BENCHMARK(corner_rig_tick_embedded, 100, 1000) {
+	const ObstacleScene scene(c.arg());
+	const std::vector<sim::WarningBand> bands{ { 80.0F, 0.1F }, { 180.0F, 0.25F }, { 300.0F, 0.5F } };
+	sim::EmbeddedConfig config;
+	config.mounts = sim::CornerSensorRig::MOUNTS.data();
+	config.mountCount = sim::CornerSensorRig::SIZE;
+	config.obstacles = scene.obstacles.data();
+	config.obstacleCount = scene.obstacles.size();
+	config.walls = scene.walls.data();
+	config.wallCount = scene.walls.size();
+	for (std::size_t zone = 0U; zone < sim::SENSOR_ZONE_COUNT; ++zone) {
+		config.bands[zone] = bands.data();
+		config.bandCounts[zone] = bands.size();
+	}
+	config.carHalfExtent = sim::CornerRigLayout::HALF_EXTENT;
+	static sim::EmbeddedCore core;
+	if (core.init(config) != sim::EmbeddedStatus::Ok) {
+		return;
+	}
+	c.setItemsPerIteration(QUERY_COUNT);
+	c.measure([&]() {
+		float heading = 0.0F;
+		float interval = 0.0F;
+		for (const auto& query : scene.queries) {
+			interval += core.step({ query, heading }, BENCH_TICK_DT).interval;
+			heading += 37.0F;
+		}
+		bench::doNotOptimize(interval);
+	});
+}
+
+// Arg = headings, spread over several turns in both directions
+OKPP_BENCHMARK(heading_sincos_libm, 100, 10000) {
+	std::vector<float> headings(static_cast<std::size_t>(c.arg()));
+	for (std::size_t i = 0U; i < headings.size(); ++i) {
+		headings[i] = static_cast<float>(i) * 0.731F - 360.0F;
+	}
+	c.setItemsPerIteration(headings.size());
+	c.measure([&]() {
+		float sum = 0.0F;
+		for (const float heading : headings) {
+			const float rad = heading * constants::DEG_TO_RAD;
+			sum += std::cos(rad) + std::sin(rad);
+		}
+		bench::doNotOptimize(sum);
+	});
+}
+
+OKPP_BENCHMARK(heading_sincos_fast, 100, 10000) {
+	std::vector<float> headings(static_cast<std::size_t>(c.arg()));
+	for (std::size_t i = 0U; i < headings.size(); ++i) {
+		headings[i] = static_cast<float>(i) * 0.731F - 360.0F;
+	}
+	c.setItemsPerIteration(headings.size());
+	c.measure([&]() {
+		float sum = 0.0F;
+		for (const float heading : headings) {
+			const sim::SinCos sc = sim::sinCosDeg(heading);
+			sum += sc.cos + sc.sin;
+		}
+		bench::doNotOptimize(sum);
+	});
+}
+
+namespace {
+
+	// Arg cars with a spread of inputs that keeps every branch of the model busy
+	[[nodiscard]] std::vector<sim::CarInput> vehicleInputs(std::int64_t count) {
+		std::vector<sim::CarInput> inputs(static_cast<std::size_t>(count));
+		for (std::size_t i = 0U; i < inputs.size(); ++i) {
+			inputs[i] = static_cast<sim::CarInput>((i * 7U) & 0xFU);
+		}
+		return inputs;
+	}
+
+	void benchVehicleBatch(bench::Case& c, bool simd) {
+		const std::vector<sim::CarInput> inputs = vehicleInputs(c.arg());
+		const sim::BicycleParams params;
+		sim::VehicleBatch batch;
+		batch.resize(inputs.size());
+		c.setItemsPerIteration(inputs.size());
+		c.measure([&]() {
+			if (simd) {
+				sim::stepVehiclesSimd(batch, inputs.data(), params, BENCH_TICK_DT, 0U, batch.size());
+			}
+			else {
+				sim::stepVehiclesScalar(batch, inputs.data(), params, BENCH_TICK_DT, 0U, batch.size());
+			}
+			bench::doNotOptimize(batch.pose(0U));
+		});
+	}
+
+} // namespace
+
+// Arg = cars, one fixed tick each
+OKPP_BENCHMARK(bicycle_step_aos, 1, 100, 10000) {
+	const std::vector<sim::CarInput> inputs = vehicleInputs(c.arg());
+	const sim::BicycleParams params;
+	std::vector<sim::BicycleState> cars(inputs.size());
+	c.setItemsPerIteration(cars.size());
+	c.measure([&]() {
+		for (std::size_t i = 0U; i < cars.size(); ++i) {
+			sim::stepBicycle(cars[i], inputs[i], params, BENCH_TICK_DT);
+		}
+		bench::doNotOptimize(cars.front().pose);
+	});
+}
+
+OKPP_BENCHMARK(bicycle_step_soa_scalar, 1, 100, 10000) {
+	benchVehicleBatch(c, false);
+}
+
+OKPP_BENCHMARK(bicycle_step_soa_simd, 1, 100, 10000) {
+	benchVehicleBatch(c, true);
+}
+
+namespace {
+
+	// Square-ish lot of count bays with one car per 10 bays, all on the move
+	struct LotScene {
+		std::vector<sf::FloatRect> bays;
+		std::vector<sf::FloatRect> cars;
+
+		explicit LotScene(std::int64_t count) {
+			const auto columns = static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+			const auto rows = static_cast<std::uint32_t>((count + columns - 1) / columns);
+			bays = sim::layoutBays({ 0.0F, 0.0F }, { constants::PARK_WIDTH, constants::PARK_HEIGHT }, columns, rows, 10.0F);
+			bays.resize(static_cast<std::size_t>(count));
+
+			const std::size_t carCount = std::max<std::size_t>(1U, bays.size() / 10U);
+			for (std::size_t i = 0U; i < carCount; ++i) {
+				const sf::FloatRect& bay = bays[(i * 10U) % bays.size()];
+				cars.push_back({ bay.position + sf::Vector2f{ 20.0F, 20.0F }, { 150.0F, 290.0F } });
+			}
+		}
+	};
+
+} // namespace
+
+// Every car against every bay: the cars x bays cost the lot index avoids
+// (quadratic, so it stops at 10k bays)
+OKPP_BENCHMARK(park_occupied_all_pairs, 1, 100, 10000) {
+	const LotScene lot(c.arg());
+	c.setItemsPerIteration(lot.cars.size());
+	c.measure([&]() {
+		std::size_t occupied = 0U;
+		for (const auto& bay : lot.bays) {
+			for (const auto& car : lot.cars) {
+				occupied += sim::parkOccupied(car, bay) ? 1U : 0U;
+			}
+		}
+		bench::doNotOptimize(occupied);
+	});
+}
+
+// Same pairs through the bay columns: 16 bays per step, one mask per block
+OKPP_BENCHMARK(park_occupied_columns, 1, 100, 10000) {
+	const LotScene lot(c.arg());
+	sim::BayColumns columns;
+	columns.assign(lot.bays);
+	std::vector<std::uint8_t> occupied(lot.bays.size(), 0U);
+	c.setItemsPerIteration(lot.cars.size());
+	c.measure([&]() {
+		std::size_t hits = 0U;
+		for (const auto& car : lot.cars) {
+			hits += columns.markOccupied(car, occupied.data());
+		}
+		bench::doNotOptimize(hits);
+	});
+}
+
+// Every car's move against every bay: oriented containment plus the swept
+// footprint test the lot runs on the bays a move crosses
+OKPP_BENCHMARK(park_swept_all_pairs, 1, 100, 10000) {
+	const LotScene lot(c.arg());
+	std::vector<sim::BayFootprint> bays;
+	bays.reserve(lot.bays.size());
+	for (const auto& bay : lot.bays) {
+		bays.emplace_back(sim::orientedRect(bay));
+	}
+	std::vector<sim::SweptFootprint> sweeps;
+	std::vector<sim::OrientedRect> cars;
+	for (const auto& car : lot.cars) {
+		cars.push_back(sim::orientedRect(car));
+		sim::OrientedRect from = cars.back();
+		from.center.x -= from.halfExtent.x;
+		sweeps.emplace_back(from, cars.back());
+	}
+	c.setItemsPerIteration(lot.cars.size());
+	c.measure([&]() {
+		std::size_t hits = 0U;
+		for (const auto& bay : bays) {
+			for (std::size_t i = 0U; i < cars.size(); ++i) {
+				hits += bay.contains(cars[i]) ? 1U : 0U;
+				hits += sweeps[i].overlaps(bay.rect()) ? 1U : 0U;
+			}
+		}
+		bench::doNotOptimize(hits);
+	});
+}
+
+OKPP_BENCHMARK(parking_lot_update, 1, 100, 10000, 1000000) {
+	LotScene lot(c.arg());
+	sim::ParkingLot parkingLot;
+	parkingLot.setBays(lot.bays, 0.0F);
+	for (std::size_t i = 0U; i < lot.cars.size(); ++i) {
+		(void)parkingLot.addCar();
+	}
+	c.setItemsPerIteration(lot.cars.size());
+	float wiggle = 1.0F;
+	c.measure([&]() {
+		wiggle = -wiggle; // every car moves every iteration
+		for (std::size_t i = 0U; i < lot.cars.size(); ++i) {
+			lot.cars[i].position.x += wiggle;
+			parkingLot.updateCar(static_cast<std::uint32_t>(i), sim::orientedRect(lot.cars[i]));
+		}
+		parkingLot.clearChanged();
+		bench::doNotOptimize(parkingLot.occupiedCount());
+	});
+}
+
+// Free bays near a point from the occupancy bitset, as the dispatcher asks them:
+// 7 in 10 bays taken, ten nearest within ten bay lengths
+OKPP_BENCHMARK(bay_free_query, 1, 100, 10000, 1000000) {
+	const LotScene lot(c.arg());
+	sim::BayOccupancyIndex index;
+	index.build(lot.bays, 0.0F);
+	sim::BayOccupancyBoard board;
+	board.reset(index);
+	std::mt19937 rng(SEED);
+	for (std::uint32_t bay = 0U; bay < lot.bays.size(); ++bay) {
+		board.setOccupied(bay, rng() % 10U < 7U);
+	}
+	board.publish();
+	const sim::BayOccupancyFrame& frame = board.acquire();
+
+	const sf::Vector2f extent = lot.bays.back().position + lot.bays.back().size; // the layout starts at the origin
+	std::uniform_real_distribution<float> across(0.0F, extent.x);
+	std::uniform_real_distribution<float> down(0.0F, extent.y);
+	std::vector<sf::Vector2f> queries(QUERY_COUNT);
+	for (sf::Vector2f& query : queries) {
+		query = { across(rng), down(rng) };
+	}
+	std::vector<sim::FreeBay> found;
+	found.reserve(lot.bays.size());
+	const float radius = 10.0F * constants::PARK_HEIGHT;
+	c.setItemsPerIteration(queries.size());
+	c.measure([&]() {
+		std::uint32_t free = 0U;
+		for (const sf::Vector2f& query : queries) {
+			free += index.nearestFree(frame, query, radius, 10U, found);
+		}
+		bench::doNotOptimize(free);
+	});
+}
+
+// Routes to the nearest free bay from cars spread over a dense-bays lot, 7 in 10 bays taken and
+// ten flipping between passes, so the free-bay field and the route cache both see churn
+OKPP_BENCHMARK(aisle_route, 5, 20, 50) {
+	sim::Scene scene;
+	if (!sim::makeStressScene("dense-bays:" + std::to_string(c.arg()), scene)) {
+		return;
+	}
+	sim::AisleGraph graph;
+	graph.build(scene, sim::sceneBounds(scene));
+	sim::AisleRouter router;
+	router.reset(graph);
+	std::mt19937 rng(SEED);
+	std::vector<std::uint8_t> taken(graph.bayCount());
+	for (std::uint32_t bay = 0U; bay < taken.size(); ++bay) {
+		taken[bay] = (rng() % 10U < 7U) ? 1U : 0U;
+		router.setOccupied(bay, taken[bay] != 0U);
+	}
+	std::vector<std::uint32_t> starts(QUERY_COUNT);
+	for (std::uint32_t& start : starts) {
+		start = static_cast<std::uint32_t>(rng() % graph.nodeCount());
+	}
+	c.setItemsPerIteration(starts.size());
+	c.measure([&]() {
+		for (int flip = 0; flip < 10; ++flip) {
+			const std::uint32_t bay = static_cast<std::uint32_t>(rng() % taken.size());
+			taken[bay] ^= 1U;
+			router.setOccupied(bay, taken[bay] != 0U);
+		}
+		float length = 0.0F;
+		for (const std::uint32_t start : starts) {
+			sim::AisleRoute route;
+			if (router.route(start, router.nearestFreeBay(start), route)) {
+				length += route.cost;
+			}
+		}
+		bench::doNotOptimize(length);
+	});
+}
+
+OKPP_BENCHMARK(scenario_load, 1, 100, 10000, 1000000) {
+	const ObstacleScene scene(c.arg());
+	sim::Scene written = sim::makeDefaultScene();
+	written.obstacles = scene.obstacles;
+	const std::string path = "bench_scenario_" + std::to_string(c.arg()) + ".okscn";
+	if (!sim::saveScenario(path, written)) {
+		return;
+	}
+	c.setItemsPerIteration(scene.obstacles.size());
+	c.measure([&]() {
+		sim::Scene loaded;
+		bench::doNotOptimize(sim::loadScenario(path, loaded));
+		bench::doNotOptimize(loaded.obstacles.data());
+	});
+	(void)std::remove(path.c_str());
+}
+
+namespace {
+
+	// Entities replaced per iteration of the churn benchmarks
+	constexpr std::size_t CHURN_COUNT = 64U;
+
+	struct TaggedObstacle {
+		std::uint32_t id;
+		sim::Obstacle obstacle;
+	};
+
+	[[nodiscard]] float sumRadii(const sim::Obstacle* begin, const sim::Obstacle* end) {
+		float sum = 0.0F;
+		for (const sim::Obstacle* obstacle = begin; obstacle != end; ++obstacle) {
+			sum += obstacle->radius;
+		}
+		return sum;
+	}
+
+} // namespace
+
+// Without handles an entity is found by id, and erasing keeps the rest in order
+OKPP_BENCHMARK(dynamic_obstacles_vector, 100, 10000, 100000) {
+	const ObstacleScene scene(c.arg());
+	std::vector<TaggedObstacle> live;
+	std::vector<std::uint32_t> ids;
+	for (const auto& obstacle : scene.obstacles) {
+		ids.push_back(static_cast<std::uint32_t>(live.size()));
+		live.push_back({ ids.back(), obstacle });
+	}
+	std::uint32_t nextId = static_cast<std::uint32_t>(live.size());
+	std::mt19937 rng(SEED);
+	c.setItemsPerIteration(CHURN_COUNT);
+	c.measure([&]() {
+		for (std::size_t i = 0U; i < CHURN_COUNT; ++i) {
+			std::uniform_int_distribution<std::size_t> pick(0U, ids.size() - 1U);
+			std::uint32_t& id = ids[pick(rng)];
+			const auto found = std::find_if(live.begin(), live.end(), [id](const TaggedObstacle& e) { return e.id == id; });
+			const sim::Obstacle obstacle = found->obstacle;
+			(void)live.erase(found);
+			id = nextId++;
+			live.push_back({ id, obstacle });
+		}
+		float sum = 0.0F;
+		for (const auto& entry : live) {
+			sum += entry.obstacle.radius;
+		}
+		bench::doNotOptimize(sum);
+	});
+}
+
+OKPP_BENCHMARK(dynamic_obstacles_pool, 100, 10000, 100000) {
+	const ObstacleScene scene(c.arg());
+	sim::EntityPool<sim::Obstacle> pool;
+	pool.reserve(scene.obstacles.size());
+	std::vector<sim::EntityHandle> handles;
+	for (const auto& obstacle : scene.obstacles) {
+		handles.push_back(pool.spawn(obstacle));
+	}
+	std::mt19937 rng(SEED);
+	c.setItemsPerIteration(CHURN_COUNT);
+	c.measure([&]() {
+		for (std::size_t i = 0U; i < CHURN_COUNT; ++i) {
+			std::uniform_int_distribution<std::size_t> pick(0U, handles.size() - 1U);
+			sim::EntityHandle& handle = handles[pick(rng)];
+			const sim::Obstacle obstacle = *pool.get(handle);
+			(void)pool.despawn(handle);
+			handle = pool.spawn(obstacle);
+		}
+		bench::doNotOptimize(sumRadii(pool.begin(), pool.end()));
+	});
+}
+
+namespace {
+
+	// Every pillar of the scene becomes a mover pacing to a random point nearby
+	[[nodiscard]] std::vector<sim::MoverRoute> moverRoutes(const ObstacleScene& scene) {
+		std::mt19937 rng(SEED);
+		std::uniform_real_distribution<float> offset(-150.0F, 150.0F);
+		std::vector<sim::MoverRoute> routes;
+		routes.reserve(scene.obstacles.size());
+		for (const auto& obstacle : scene.obstacles) {
+			const sf::Vector2f target{ std::clamp(obstacle.center.x + offset(rng), 0.0F, scene.extent.x),
+				std::clamp(obstacle.center.y + offset(rng), 0.0F, scene.extent.y) };
+			routes.push_back({ sim::MoverKind::Pedestrian, { obstacle.center, target },
+				constants::PEDESTRIAN_SPEED, constants::PEDESTRIAN_RADIUS });
+		}
+		return routes;
+	}
+
+} // namespace
+
+// Arg = movers; the static index cannot move entries, so every tick rebuilds it
+OKPP_BENCHMARK(moving_obstacles_rebuild, 100, 10000, 100000) {
+	const ObstacleScene scene(c.arg());
+	sim::MovingObstacles movers;
+	movers.reset({ { 0.0F, 0.0F }, scene.extent }, constants::MOVER_CELL_SIZE);
+	for (const auto& route : moverRoutes(scene)) {
+		(void)movers.spawn(route);
+	}
+	std::vector<sf::Vector2f> centers;
+	sim::ObstacleGrid grid;
+	constexpr float dt = 1.0F / constants::SIM_TICK_HZ;
+	c.measure([&]() {
+		movers.step(dt);
+		centers.clear();
+		for (const sim::Mover& mover : movers.movers()) {
+			centers.push_back(mover.body.center);
+		}
+		grid.build(centers, constants::MOVER_CELL_SIZE);
+		float sum = 0.0F;
+		for (const auto& query : scene.queries) {
+			sum += grid.nearestDistanceSq(query, constants::BEEP_MAX_RANGE);
+		}
+		bench::doNotOptimize(sum);
+	});
+}
+
+// Same ticks, with the loose grid re-filing only the movers that changed cell
+OKPP_BENCHMARK(moving_obstacles_loose_grid, 100, 10000, 100000) {
+	const ObstacleScene scene(c.arg());
+	sim::MovingObstacles movers;
+	movers.reset({ { 0.0F, 0.0F }, scene.extent }, constants::MOVER_CELL_SIZE);
+	for (const auto& route : moverRoutes(scene)) {
+		(void)movers.spawn(route);
+	}
+	constexpr float dt = 1.0F / constants::SIM_TICK_HZ;
+	c.measure([&]() {
+		movers.step(dt);
+		float sum = 0.0F;
+		for (const auto& query : scene.queries) {
+			sum += movers.nearest(query, constants::BEEP_MAX_RANGE).distanceSq;
+		}
+		bench::doNotOptimize(sum);
+	});
+}
+
+// One Philox call per sensor: the random words of a pass, lane by lane
+OKPP_BENCHMARK(philox_scalar, 4, 1000, 100000) {
+	const std::size_t count = c.arg();
+	std::vector<std::uint32_t> words(count * 4U);
+	std::uint64_t pass = 0U;
+	c.measure([&]() {
+		for (std::size_t i = 0U; i < count; ++i) {
+			const sim::PhiloxCounter out = sim::philox4x32({ static_cast<std::uint32_t>(pass), 0U,
+				static_cast<std::uint32_t>(i), 0U }, { 1U, 0U });
+			std::copy(out.begin(), out.end(), words.begin() + static_cast<std::ptrdiff_t>(i * 4U));
+		}
+		++pass;
+		bench::doNotOptimize(words.data());
+	});
+}
+
+// Same words, four sensors per vector
+OKPP_BENCHMARK(philox_batch, 4, 1000, 100000) {
+	const std::size_t count = c.arg();
+	std::vector<std::uint32_t> words(count * 4U);
+	std::uint32_t* const rows[4] = { words.data(), words.data() + count, words.data() + 2U * count,
+		words.data() + 3U * count };
+	std::uint64_t pass = 0U;
+	c.measure([&]() {
+		sim::philoxSensors({ 1U, 0U }, pass++, 0U, count, rows);
+		bench::doNotOptimize(words.data());
+	});
+}
+
+// A whole noisy pass: words, Box-Muller, dropouts and a two-pass delay
+OKPP_BENCHMARK(sensor_noise_pass, 4, 1000, 100000) {
+	const std::size_t count = c.arg();
+	std::vector<sim::SensorReading> readings(count);
+	sim::SensorNoiseConfig config;
+	config.sigma = 5.0F;
+	config.dropout = 0.05F;
+	config.latency = 2U;
+	sim::SensorNoise noise;
+	noise.configure(config, count);
+	std::uint64_t pass = 0U;
+	c.measure([&]() {
+		for (std::size_t i = 0U; i < count; ++i) {
+			readings[i].distanceSq = 10000.0F;
+			readings[i].wallDistance = 200.0F;
+		}
+		noise.apply(pass++, readings);
+		bench::doNotOptimize(readings.data());
+	});
+}
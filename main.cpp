@@ -6,6 +6,109 @@ Now includes:
  - Car movement using keyboard
  - Sensors move relative to car position
  - Delta-time–based smooth motion
+ - Fixed-step simulation (--tick-hz) with interpolated rendering
+ - Headless batch mode (--headless [trace] --repeat n), no window or audio
+ - Multi-car fleet mode (--fleet n --threads t) spread over a thread pool
+ - Procedurally synthesized beep (--sample-beep plays the MP3 instead)
+ - Input-to-beep latency percentiles, key press to tick to play() to audio buffer (--latency-probe)
+ - Beep lateness, audio underruns, buffer fill and voice steals in the F3 overlay, the telemetry and the exit log
+ - Beeps timed on a dedicated audio thread fed through a lock-free ring
+ - Ray-cast sensor cones against obstacle outlines (--raycast)
+ - Baked, disk-cached signed distance field for the static pillars (--sdf [cache])
+ - Sensors read a log-odds occupancy map built from their own rays (--mapping)
+ - Per-phase frame profiler: F3 toggles the overlay, F4 writes profile.csv
+ - Chrome trace export of hot-path events (--chrome-trace [file])
+ - Car texture and beep sample decoded on pool workers behind a progress bar
+ - Pre-scaled, mipmapped BC1/BC3 car texture (--cook-texture <png> <out>)
+ - Atlas pages are mipmapped and minified sprites packed at the level just above their drawn size (--no-mipmaps, --srgb)
+ - Beep sample baked to mono PCM at the output rate, loaded with no decoder (--cook-sound <in> <out>)
+ - Assets served from one memory-mapped pack with optional LZ4 entries (--pack-assets <dir> <out>, --asset-pack <file>)
+ - Decoded sprite pixels cached on disk by content hash, so later launches skip PNG decoding (--texture-cache <dir|off>)
+ - Sprites under assets/ packed into a texture atlas, drawn as one batch
+ - Drive recording and deterministic replay (--record <file>, --replay <file>)
+ - Memory-mapped scenario files for obstacles, bays and spawns (--scenario <file>)
+ - In-app scenario editor: pillars and bays placed and dragged with the mouse, the indexes, distance field
+   and static layer updated for the edited area only (E toggles, F5 saves to --edit-save <file>)
+ - Synthetic stress lots that log sustained frame, simulation and render times (--stress <name[:size[:spacing]]>)
+ - Very large lots streamed in tiles around the car (--world <file>)
+ - Camera follows the car; only geometry inside its view is submitted
+ - Car bounds and sensor anchors computed once per pose change, shared by the frame
+ - Static background (pillars, bay outlines) cached in a render texture
+ - Adaptive pacing: idle frames block on events instead of redrawing (--adaptive, --vsync)
+ - Sleep-free frame limiter on high-resolution timers with a final spin, aligned to vsync presentations
+   under --vsync, logging frame-time jitter on exit (--pacer [hz])
+ - Lazy work (stale minimap tiles) time-sliced into the slack after each display, carried over to the next frame
+   or spilled to the worker pool (--work-budget <us>)
+ - Debug check that steady-state frames never touch the heap, reporting or trapping on the allocation
+   (--alloc-check [trap], counted in builds configured with OKPP_ALLOC_CHECK=ON)
+ - Kiosk pacing: at rest with no key held the loop sleeps until input, waking at the audio thread's next beep,
+   and the sensor and parking pipeline only restarts on input (--on-demand)
+ - Park occupancy with hysteresis; bay and sensor indicators follow one state byte each, their vertices rewritten only on a transition
+ - The simulation publishes its changes (car moved, sensor pass, warning level, bay occupancy) as per-frame events;
+   beeps, telemetry, labels and indicator batches do work only in frames that carry something for them
+ - Under --instanced, bay fills carry only their state byte; a palette uniform colors them in the shader, so any number of flips is one upload
+ - Per-zone, per-vehicle beep profiles as squared-distance tables (--profiles, --vehicle)
+ - One batched sensor pass per tick feeds beeps, indicator colors and wall checks
+ - The car body collides with the pillars (swept, so fast moves cannot tunnel)
+ - Kinematic bicycle model with acceleration and steering lock (--bicycle);
+   fleet mode integrates it for all cars with an SoA vector kernel
+ - Heading sine/cosine from a degree polynomial instead of libm trig
+ - Monte-Carlo parking evaluation on a work-stealing pool (--evaluate n [trace] --seed s)
+ - Trials fork from a memcpy-able snapshot of a shared approach (--fork-at s)
+ - Fleet and evaluation events written as column blocks by a background thread (--events <file>)
+ - Fleet cars driven by C++20 coroutine scripts resumed at each fixed tick (--script <name>)
+ - Fleet pillars as 16-bit fixed point in tiles with integer SIMD distance kernels (--quantized)
+ - Headless PNG screenshots at each trace segment end from a tiled, SIMD CPU rasterizer (--screenshots <dir>)
+ - Ray-cast sensor training records over random lots and poses, generated in parallel (--dataset <file> <n>)
+ - Dataset images of random lot states, many per off-screen pass, read back asynchronously (--render-batch <dir> <n>)
+ - One shared job system for fleet, evaluation, asset decoding, tile streaming and SDF baking
+ - Pipelined frames (--pipelined): the next frame simulates on a worker while this one draws
+ - Per-frame scratch lists come from linear frame arenas, not the heap
+ - Sample beeps overlap on a fixed voice pool; when it is full the nearest obstacle steals a voice
+ - Positional beeps: each sensor sounds from its corner, heard from the driver seat
+ - Frame-loop messages go through an asynchronous, leveled logger (OKPP_LOG_MIN_LEVEL)
+ - Batched UDP telemetry of car pose, sensor distances, occupancy and beeps played (--telemetry host:port)
+ - Free-bay queries for a fleet dispatcher over UDP, answered off the simulation thread from an occupancy
+   bitset (--occupancy-port port)
+ - Recorded drives and telemetry streamed into block-compressed, seekable logs; replays decode one block at a time
+   (--record, --telemetry-log <file>)
+ - Visualization server: a headless fleet streams world deltas to thin viewers (--serve port, --view host:port);
+   the network thread encodes from epoch-pinned world snapshots (EpochSnapshots.hpp)
+ - Lockstep multi-driver sessions: peers exchange only inputs through a relay and roll back late ones (--relay port --players n, --join host:port)
+ - Occupancy heatmap accumulated on the GPU from car footprints (--heatmap [seconds])
+ - Frame capture through double-buffered pixel buffers and an encoder thread (--capture <dir>)
+ - Rear-camera inset streamed through mapped pixel-unpack buffers from a capture thread, never copied on the draw thread (--camera-feed)
+ - Auto-park (P): a hybrid A* path into the bay, planned on the job system, then driven tick by tick
+ - Beeps also urge by predicted time to collision along the car's current arc (--ttc)
+ - Pedestrians and cars doing laps of the lot, indexed in a loose grid (--movers)
+ - A hitched trailer dragged on the car's ticks, with a corner sensor rig of its own sensed in the car's pass (--trailer)
+ - Overhead operator window drawn from the same snapshot and shared GPU objects (--operator-view)
+ - Draw and display on a render thread holding the GL context, events and simulation stay on main (--render-thread)
+ - Seeded sensor noise, dropouts and latency to stress the warnings (--noise px, --dropout p, --latency n)
+ - Sensor rigs of any size from the vehicle profile ("sensor" records, --profiles/--vehicle)
+ - Nearest and cone sensor queries in a compute shader, read back a pass late (--gpu-sensors)
+ - Nearest-obstacle engine switched while running: brute force, SIMD, grid, BVH, SDF or GPU (N, --nearest <name>),
+   every engine's cost and agreement with brute force side by side in F3 (B, --nearest-compare)
+ - Tiled renderer for the largest lots: persistently mapped buffers, per-tile draws recorded on workers (--tiled)
+ - Pillar and mover level of detail: fewer rim segments when small on screen, impostor quads, lot-scale clusters
+ - Minimap of the whole lot from cached tile images, re-rendered only where they changed (M toggles, wheel zooms)
+ - Sensor distance and beep interval labels from a cached glyph atlas, rebuilt only when the text changes (H)
+ - Sensor cones of the whole rig, graded by distance, drawn by one fragment-shader pass (F)
+ - Frame draws collected in a render queue, radix-sorted by layer, shader, texture and depth
+ - Hot-reloaded calibration values and beep profiles, parsed on the job system (--tuning <file>)
+ - Start-up phase timings logged with the first frame; the audio device only opens at the first beep
+ - Heap and VRAM per subsystem (textures, audio, obstacles, render buffers, arenas) in F3 and --telemetry
+ - CPU cache misses and branch mispredicts around the sensor and beep hot paths, in F3 and the exit log (--hw-counters)
+ - Beeps scheduled on a timer wheel: sample voices and fleet cars fire only when due, not polled per frame
+ - Walls, curbs and the lot boundary are line-segment obstacles in the sensor grid (wall lines in --scenario)
+ - Polygon islands and irregular curbs (polygon lines in --scenario) are sensed through an edge BVH
+ - Grid sensor readings reused while a sensor stays within a tolerance of its last lookup (--sensor-cache <units>)
+ - World drawn at a reduced internal resolution and upscaled with a sharpening pass (--render-scale f),
+   the scale steered by timer-query GPU frame time (--dynamic-resolution [ms])
+ - Optional work shed when frames run over budget and restored with headroom: label refresh, heatmap splats,
+   pillar detail and sensor cone rays (--quality-governor [ms])
+ - Rain and night lighting in the pass that presents the scene texture, budgeted per tier at compile time
+   (--rain [0-1], --night [0-1], --effects-tier low|medium|high)
 ==============================================================================
 */
 
@@ -13,35 +116,212 @@ Now includes:
 #include <iostream>
 #include <SFML/Audio.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "AllocationCheck.hpp"
+#include "AssetLoader.hpp"
+#include "AssetPack.hpp"
+#include "BatchRenderer.hpp"
+#include "BeepScheduler.hpp"
+#include "BudgetedWork.hpp"
+#include "CameraFeed.hpp"
+#include "ChunkedWorld.hpp"
+#include "CarHull.hpp"
+#include "CarModel.hpp"
+#include "Collision.hpp"
+#include "CollisionPredictor.hpp"
+#include "CompressedTexture.hpp"
+#include "CookedSound.hpp"
+#include "DynamicResolution.hpp"
+#include "DistanceField.hpp"
+#include "Constants.hpp"
+#include "EpochSnapshots.hpp"
+#include "Fleet.hpp"
+#include "FrameArena.hpp"
+#include "FrameCapture.hpp"
+#include "FramePacer.hpp"
+#include "FramePipeline.hpp"
+#include "GpuSensorQuery.hpp"
+#include "GuideLines.hpp"
+#include "HardwareCounters.hpp"
+#include "Headless.hpp"
+#include "HeadlessApp.hpp"
+#include "HudText.hpp"
+#include "InputRecording.hpp"
+#include "InstancedRenderer.hpp"
+#include "LatencyProbe.hpp"
+#include "LockstepLink.hpp"
+#include "LockstepSession.hpp"
+#include "Log.hpp"
+#include "Minimap.hpp"
+#include "MovingObstacles.hpp"
+#include "NearestBackends.hpp"
+#include "ObstacleClusters.hpp"
+#include "ObstacleGrid.hpp"
+#include "ObstacleRenderer.hpp"
+#include "OccupancyMap.hpp"
+#include "OccupancyHeatmap.hpp"
+#include "OccupancyServer.hpp"
+#include "OperatorView.hpp"
+#include "PaletteRenderer.hpp"
+#include "Parking.hpp"
+#include "ParkingLot.hpp"
+#include "ParkingPlanner.hpp"
+#include "PngWriter.hpp"
+#include "Profiler.hpp"
+#include "ProfilerOverlay.hpp"
+#include "QualityGovernor.hpp"
+#include "RayCast.hpp"
+#include "RenderQueue.hpp"
+#include "RenderScaler.hpp"
+#include "RenderThread.hpp"
+#include "Scenario.hpp"
+#include "ScenarioEditor.hpp"
+#include "Scene.hpp"
+#include "SceneEffects.hpp"
+#include "SensorField.hpp"
+#include "SensorFusion.hpp"
+#include "SensorNoise.hpp"
+#include "SensorQueryCache.hpp"
+#include "Sensors.hpp"
+#include "SpriteBatch.hpp"
+#include "StartupReport.hpp"
+#include "StaticLayer.hpp"
+#include "Telemetry.hpp"
+#include "TileRenderer.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureCache.hpp"
+#include "TextureCooker.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include "Trailer.hpp"
+#include "Tuning.hpp"
+#include "VehicleDynamics.hpp"
+#include "VehiclePose.hpp"
+#include "VisualizationLink.hpp"
+#include "WarningProfile.hpp"
+#include "WorldEvents.hpp"
+#include "SimTypes.hpp"
+
 
 
 // ===============================
 // Constants
 // ===============================
 
+// Shared simulation values live in Constants.hpp; these are front-end only
 namespace constants {
 	// Window dimensions should be constexpr and have explicit types
 	constexpr unsigned int WINDOW_WIDTH = 1920U;    // MISRA: use unsigned for sizes
 	constexpr unsigned int WINDOW_HEIGHT = 1080U;
+	constexpr unsigned int OPERATOR_WINDOW_WIDTH = 960U; // --operator-view; its height follows the lot
 
-	// Parking sensor rectangle dimensions
-	constexpr float SENSOR_WIDTH = 30.0F;
-	constexpr float SENSOR_HEIGHT = 100.0F;
-
-	// Simulation and layout
-	constexpr std::size_t SENSOR_COUNT = 4U;
-	constexpr float CAR_SPEED = 500.0F; // pixels per second
-	constexpr float CAR_ROTATION_SPEED = 2.5F;
-
-	// Thresholds for colors
-	constexpr float WARNING_THRESHOLD = 60.0F;
-	constexpr float DANGER_THRESHOLD = 30.0F;
-
-	float PI = 3.14;
+	// The car PNG is drawn at this scale; cooked textures are stored pre-scaled
+	constexpr float CAR_SPRITE_SCALE = 0.30F;
 
 	//THE COLORS OF THE PARKING INDICATOR; TRANSPARENT GREEN AND TRANSPARENT RED
 	const sf::Color transGreen = sf::Color(0, 255, 0, 100);
 	const sf::Color transRed = sf::Color(255, 0, 0, 100);
+	const sf::Color bayPalette[] = { transGreen, transRed }; // by occupancy byte
+
+	// Sensor indicator states, the fused warning levels; sensorPalette holds their colors
+	constexpr std::uint8_t SENSOR_CLEAR = sim::WARNING_LEVEL_CLEAR;
+	constexpr std::uint8_t SENSOR_WARNING = sim::WARNING_LEVEL_CAUTION;
+	constexpr std::uint8_t SENSOR_DANGER = sim::WARNING_LEVEL_DANGER;
+	const sf::Color sensorPalette[] = { sf::Color::Green, sf::Color::Yellow, sf::Color::Red };
+
+	const sf::Color background = sf::Color(30, 30, 30);
+
+	// Moving obstacles (--movers)
+	const sf::Color pedestrianColor = sf::Color(255, 200, 60);
+	const sf::Color moverCarColor = sf::Color(120, 140, 255);
+
+	// Pixels cached around the camera view, so small camera moves reuse the static layer
+	constexpr unsigned int STATIC_LAYER_MARGIN = 256U;
+
+	// Occupancy heatmap: world pixels per texel, and the occupied time drawn in full red
+	constexpr float HEATMAP_TEXEL_SIZE = 4.0F;
+	constexpr float HEATMAP_FULL_SCALE = 10.0F;
+
+	// --on-demand: longest sleep without input or a beep, so file-watching chores still run
+	constexpr float ON_DEMAND_MAX_SLEEP_SECONDS = 1.0F;
+
+	// --telemetry: a car with nothing changing still sends a record this often, for the audio counters
+	constexpr float TELEMETRY_IDLE_SECONDS = 1.0F;
+
+	// --render-batch: image width (the height follows the lot) and the largest pass texture
+	constexpr unsigned int BATCH_TILE_WIDTH = 256U;
+	constexpr unsigned int BATCH_PASS_SIZE = 2048U;
+	constexpr float BATCH_LINE_WIDTH = 2.0F;
+	constexpr std::size_t BATCH_CIRCLE_POINTS = 24U;
+	const sf::Color batchCarColor = sf::Color(60, 120, 220);
+
+	// --dynamic-resolution without a value: GPU milliseconds per frame, with room left for 60 FPS
+	constexpr float DYNAMIC_RESOLUTION_TARGET_MS = 12.0F;
+
+	// --quality-governor without a value: CPU milliseconds per frame, one 60 Hz refresh
+	constexpr float QUALITY_GOVERNOR_TARGET_MS = 16.6F;
+
+	// --rain and --night without a value: a steady shower, and dark enough that the headlights matter
+	constexpr float RAIN_INTENSITY = 0.6F;
+	constexpr float NIGHT_DARKNESS = 0.85F;
+
+	// --pacer without a value: the rate setFramerateLimit() would aim for. The timer is set this
+	// much before each deadline and the rest is spun, more than a high-resolution timer oversleeps
+	constexpr double PACER_RATE_HZ = 60.0;
+	constexpr std::chrono::microseconds PACER_SPIN{ 1500 };
+
+	// --work-budget: lazy work run after each display, a small share of a 60 Hz frame
+	constexpr std::uint32_t WORK_BUDGET_US = 1000U;
+
+	// --alloc-check: frames not judged at start and after a rebuild, two seconds at 60 Hz
+	constexpr std::uint32_t ALLOC_CHECK_WARMUP_FRAMES = 120U;
+
+	// Rate sounds are cooked at (--cook-sound); the common native rate of output devices
+	constexpr std::uint32_t AUDIO_OUTPUT_RATE = 48000U;
+
+	// Opened at start-up when present and no --asset-pack is given
+	constexpr const char* ASSET_PACK_PATH = "assets.okpk";
+
+	// Decoded sprites are kept here between launches unless --texture-cache says otherwise
+	constexpr const char* TEXTURE_CACHE_DIR = ".okpp-cache";
+
+	// F5 in the scenario editor writes the scene here unless --edit-save says otherwise
+	constexpr const char* EDIT_SAVE_PATH = "edited.okscn";
+
+	// Captured frames are written uncompressed by default, so the encoder keeps up with 60 FPS
+	constexpr const char* CAPTURE_FORMAT = "bmp";
+
+	// Rear-camera feed (--camera-feed): frame size and rate, and its on-screen inset
+	const sf::Vector2u CAMERA_FEED_SIZE{ 320U, 240U };
+	constexpr float CAMERA_FEED_FPS = 30.0F;
+	const sf::Vector2f CAMERA_FEED_INSET{ 320.0F, 240.0F }; // in the window's bottom-right corner
+	constexpr float CAMERA_FEED_MARGIN = 12.0F;
+
+	// HUD sensor labels (H): world units per font pixel, and the label's corner from the sensor
+	constexpr float SENSOR_LABEL_PIXEL = 2.0F;
+	const sf::Vector2f SENSOR_LABEL_OFFSET{ 8.0F, -6.0F };
+	const sf::Color sensorLabelColor = sf::Color(230, 230, 230);
+
+	// --trailer body, drawn from the atlas white region in the car's sprite batch
+	const sf::Color trailerColor = sf::Color(70, 90, 120);
 
 
 }
@@ -52,363 +332,3442 @@ namespace constants {
 // ===============================
 
 /**
- * @brief Centers a sprite in the given render window.
+ * @brief Centers a sprite of the given local size in the given render window.
  *
  * MISRA C++: Always use const references for read-only parameters.
  *            Avoid raw pointers unless necessary.
  */
-static void centerSprite(sf::Sprite& sprite, const sf::RenderWindow& window) {
-	const sf::FloatRect bounds = sprite.getLocalBounds();
-
+static void centerSprite(sf::Transformable& sprite, const sf::Vector2f& localSize, const sf::RenderWindow& window) {
 	// MISRA: Always use floating-point literals with suffix 'F'
-	sprite.setOrigin({ bounds.size.x / 2.0F, bounds.size.y / 2.0F });
+	sprite.setOrigin({ localSize.x / 2.0F, localSize.y / 2.0F });
 	sprite.setPosition({
 		static_cast<float>(window.getSize().x) / 2.0F,
 		static_cast<float>(window.getSize().y) / 2.0F
 		});
 }
 
-static float distance(const sf::Vector2f& a, const sf::Vector2f& b) {
-	const float dx = b.x - a.x;
-	const float dy = b.y - a.y;
-	return std::sqrt(dx * dx + dy * dy);
+/**
+ * @brief Centers the view on focus, clamped so it does not leave bounds.
+ *
+ * Along an axis where bounds is smaller than the view, the view is centered
+ * on bounds instead, so the built-in 1920x1080 lot stays exactly in frame.
+ */
+static void followCamera(sf::View& view, const sf::Vector2f& focus, const sf::FloatRect& bounds) {
+	const sf::Vector2f half = view.getSize() / 2.0F;
+	const auto clampAxis = [](float value, float low, float size, float halfView) {
+		return (size <= 2.0F * halfView) ? low + size / 2.0F : std::clamp(value, low + halfView, low + size - halfView);
+	};
+	view.setCenter({
+		clampAxis(focus.x, bounds.position.x, bounds.size.x, half.x),
+		clampAxis(focus.y, bounds.position.y, bounds.size.y, half.y)
+	});
 }
 
-static void playBeepIfNear(const std::vector<sf::RectangleShape>& sensors,
-	const std::vector<sf::CircleShape>& stupovi,
-	sf::Sound& beepSound,
-	sf::Clock& beepClock)
+// How readSensors measures the nearest obstacles; the grid is the fallback and always measures the walls
+struct ObstacleSensing {
+	sim::NearestBackend backend = sim::NearestBackend::Grid; // --nearest / N: the engine asked first
+	const sim::ObstacleGrid* grid = nullptr;
+	const sim::RayCaster* rayCaster = nullptr;   // --raycast: first hit along the sensor cones
+	std::uint32_t coneRays = constants::SENSOR_CONE_RAYS; // rays per cone, fewer under --quality-governor
+	const sim::DistanceField* field = nullptr;   // --sdf: baked distance to the pillar outlines
+	const sim::OccupancyMap* occupancy = nullptr; // --mapping: obstacles the sensor rays have seen
+	gfx::GpuSensorQuery* gpu = nullptr;          // --gpu-sensors: grid or cone pass in a compute shader
+	const sim::NearestEngines* engines = nullptr; // brute force, SIMD and BVH over the pillar centers
+	sim::SensorQueryCache* cache = nullptr;      // --sensor-cache: in front of the plain grid lookups
+	const std::vector<sim::Obstacle>* obstacles = nullptr; // the grid's records, for the cache and the comparison
+	const sim::ObstacleClusters* clusters = nullptr; // clears the CPU engines' pass while nothing is in range
+	sim::NearestComparison* comparison = nullptr; // --nearest-compare / B: every engine timed on each pass
+	std::vector<sim::SensorReading>* comparisonReadings = nullptr; // the compared engines' readings, scratch
+
+	[[nodiscard]] bool onGpu() const noexcept { return gpu != nullptr && backend == sim::NearestBackend::Gpu; }
+};
+
+/**
+ * @brief Every nearest engine over the same sensors, timed and checked against brute force.
+ *
+ * The CPU engines run through NearestEngines; the GPU pass is drained,
+ * submitted and waited for, so it is timed as a synchronous round trip and
+ * judged on these poses rather than the last pass's. Returns true if the
+ * GPU is the chosen engine and its readings were copied into readings.
+ */
+static bool compareNearestEngines(const std::vector<sim::SensorPose>& sensors,
+	const ObstacleSensing& sensing,
+	float maxRange,
+	const sf::FloatRect& walls,
+	std::vector<sim::SensorReading>& readings)
 {
-	const float timeSinceLastBeep = beepClock.getElapsedTime().asSeconds();
-	float closestDist = std::numeric_limits<float>::max();
+	OKPP_TRACE_SCOPE("compare nearest engines");
+	std::vector<sim::SensorReading>& compared = *sensing.comparisonReadings;
+	sim::compareNearestBackends(*sensing.engines, *sensing.obstacles, sensors, maxRange, *sensing.comparison, compared);
+	if (sensing.gpu == nullptr) {
+		return false;
+	}
 
-	for (const auto& sensor : sensors) {
-		const sf::Vector2f sensorPos = sensor.getPosition();
-		for (const auto& stup : stupovi) {
-			float dist = distance(sensorPos, stup.getPosition());
-			if (dist < closestDist) {
-				closestDist = dist;
-			}
-		}
+	using Clock = std::chrono::steady_clock;
+	while (sensing.gpu->collect(compared, true)) {
+		// passes queued for the previous poses are dropped
+	}
+	gfx::GpuSensorPass pass;
+	pass.maxRange = maxRange;
+	pass.walls = walls;
+	const auto start = Clock::now();
+	sensing.gpu->submit(sensors, pass);
+	if (!sensing.gpu->collect(compared, true)) {
+		return false;
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	sensing.comparison->record(sim::NearestBackend::Gpu, compared, seconds,
+		sim::nearestTolerance(sim::NearestBackend::Gpu, nullptr));
+	if (!sensing.onGpu() || sensing.rayCaster != nullptr || compared.size() != sensors.size()) {
+		return false;
 	}
+	readings = compared;
+	return true;
+}
 
-	float interval = 0.0f;
+/**
+ * @brief The one sensor pass of a tick: nearest obstacle and wall per sensor.
+ *
+ * Nearest lookups go through the obstacle grid, so only cells around each
+ * sensor are scanned instead of every obstacle; the same lookup finds the
+ * nearest wall segment. A ray caster or the sensors' own occupancy map
+ * replaces the grid for the obstacles when selected on the command line;
+ * otherwise the chosen backend does (brute force, SIMD, BVH, the baked
+ * distance field), and every one still asks the grid for the walls. The GPU engine
+ * answers with the previous pass's results while it queues this one (it
+ * measures walls against the lot rectangle walls only); until its first pass
+ * is back the CPU engines fill in. The query cache only serves the plain grid
+ * lookups: the other engines do not measure distance from one point.
+ * While no obstacle cluster comes within range of the sensors, the CPU
+ * engines are skipped and every sensor reads nothing; the occupancy map is
+ * always asked, as its cells may sit off the obstacles they mapped.
+ * While comparing, every engine runs first (compareNearestEngines()).
+ * Beeps, indicator colors and wall checks all read the result.
+ */
+static void readSensors(const std::vector<sim::SensorPose>& sensors,
+	const ObstacleSensing& sensing,
+	float maxRange,
+	const sf::FloatRect& walls,
+	std::vector<sim::SensorReading>& readings)
+{
+	OKPP_HW_COUNTER_SCOPE("readSensors");
+	if (sensing.comparison != nullptr && compareNearestEngines(sensors, sensing, maxRange, walls, readings)) {
+		return;
+	}
+	if (sensing.onGpu()) {
+		const bool collected = sensing.gpu->collect(readings) && readings.size() == sensors.size();
+		gfx::GpuSensorPass pass;
+		pass.maxRange = maxRange;
+		pass.walls = walls;
+		if (sensing.rayCaster != nullptr) {
+			pass.coneHalfAngleDeg = constants::SENSOR_CONE_HALF_ANGLE;
+			pass.rays = sensing.coneRays;
+		}
+		sensing.gpu->submit(sensors, pass);
+		if (collected) {
+			return;
+		}
+	}
 
-	if (closestDist <= 80.0f) {
-		interval = 0.1f;
+	if (sensing.clusters != nullptr && sensing.occupancy == nullptr && !sensing.clusters->anyNear(sensors, maxRange)) {
+		readings.assign(sensors.size(), sim::SensorReading{});
 	}
-	else if (closestDist <= 180.0f) {
-		interval = 0.25f;
+	else if (sensing.occupancy != nullptr) {
+		sim::readSensors(sensors, *sensing.occupancy, maxRange, *sensing.grid, readings);
 	}
-	else if (closestDist <= 300.0f) {
-		interval = 0.5f;
+	else if (sensing.rayCaster != nullptr) {
+		sim::readSensors(sensors, *sensing.rayCaster,
+			{ constants::SENSOR_CONE_HALF_ANGLE, sensing.coneRays, maxRange }, *sensing.grid, readings);
 	}
-
-	if (timeSinceLastBeep >= interval) {
-		beepSound.play();
-		beepClock.restart();
+	else if (sensing.field != nullptr && sensing.backend == sim::NearestBackend::Field) {
+		sim::readSensors(sensors, *sensing.field, maxRange, *sensing.grid, readings);
+	}
+	else if (sensing.engines != nullptr && sensing.backend != sim::NearestBackend::Grid
+		&& sensing.engines->available(sensing.backend))
+	{
+		sensing.engines->query(sensing.backend, sensors, maxRange, readings);
+	}
+	else if (sensing.cache != nullptr) {
+		sensing.cache->read(sensors, *sensing.grid, *sensing.obstacles, maxRange, readings);
+	}
+	else if (sensing.grid != nullptr) {
+		sim::readSensors(sensors, *sensing.grid, maxRange, readings);
 	}
 }
 
-
 /**
- * @brief Creates a vector of rectangular parking sensor indicators.
+ * @brief Hands the rated sensor results to the audio thread as positional beeps.
  *
- * MISRA: Functions should have single responsibility.
- *        Avoid global mutable data.
+ * Each sensor emits from its mount. Beep timing and panning are owned by the
+ * scheduler's thread; this call never blocks on audio. probe marks the frame a
+ * latency probe's key press reached, which beeps at once. Returns false if the
+ * audio ring was full and the frame was dropped.
  */
-static std::vector<sf::RectangleShape> createSensorIndicators() {
-	std::vector<sf::RectangleShape> sensors;
-	sensors.reserve(constants::SENSOR_COUNT); // Avoid dynamic reallocations
-
-	constexpr float START_X = 800.0F;
-	constexpr float START_Y = 200.0F;
-	constexpr float SPACING = 100.0F;
-
-	for (std::size_t i = 0U; i < constants::SENSOR_COUNT; ++i) {
-		sf::RectangleShape sensor({ constants::SENSOR_WIDTH, constants::SENSOR_HEIGHT });
-		sensor.setFillColor(sf::Color::Green);
-		sensor.setPosition({ START_X + (static_cast<float>(i) * SPACING), START_Y });
-		sensors.push_back(sensor);
+static bool playBeepIfNear(const std::vector<sim::SensorReading>& readings,
+	const std::vector<float>& intervals,
+	const std::vector<sim::SensorMount>& mounts,
+	bool probe,
+	audio::BeepScheduler& beeps)
+{
+	OKPP_HW_COUNTER_SCOPE("playBeepIfNear");
+	audio::BeepFrame frame;
+	frame.listener = { constants::DRIVER_SEAT_FORWARD, -constants::DRIVER_SEAT_LEFT };
+	frame.probe = probe;
+	frame.count = static_cast<std::uint32_t>(std::min({ intervals.size(), mounts.size(), audio::MAX_BEEP_EMITTERS }));
+	for (std::uint32_t i = 0U; i < frame.count; ++i) {
+		audio::BeepEmitter& emitter = frame.emitters[i];
+		emitter.offset = mounts[i].offset;
+		emitter.interval = intervals[i];
+		emitter.distance = std::sqrt(readings[i].distanceSq);
 	}
-
-	return sensors; // Return by value (NRVO applies)
+	return beeps.submit(frame);
 }
 
 /**
- * @brief Loads a texture safely and logs any error.
+ * @brief Refreshes the HUD label next to each sensor: distance in pixels and beep interval in ms.
  *
- * MISRA: Error handling must be explicit and deterministic.
+ * Labels whose text is unchanged keep their geometry; only their position follows the sensor.
  */
-[[nodiscard]] static sf::Texture loadTextureOrExit(const std::string& path) {
-	sf::Texture texture;
-	if (!texture.loadFromFile(path)) {
-		std::cerr << "Error: Failed to load texture from "
-			<< std::filesystem::absolute(path) << '\n';
-		// MISRA: Avoid abrupt termination, but here it’s educational
-	}
-	return texture;
+static void updateSensorLabels(const std::vector<sim::SensorPose>& poses,
+	const std::vector<sim::SensorReading>& readings,
+	const std::vector<float>& intervals,
+	gfx::HudText& labels)
+{
+	const std::size_t count = std::min({ poses.size(), readings.size(), intervals.size(), labels.labelCount() });
+	gfx::LabelText text;
+	for (std::size_t i = 0U; i < count; ++i) {
+		text.clear();
+		if (readings[i].distanceSq < std::numeric_limits<float>::max()) {
+			text << std::lround(std::sqrt(readings[i].distanceSq));
+		}
+		else {
+			text << "--";
+		}
+		if (intervals[i] > 0.0F) {
+			text << " " << std::lround(intervals[i] * 1000.0F) << "MS";
+		}
+		labels.setText(i, text.view());
+		labels.setPosition(i, poses[i].position + constants::SENSOR_LABEL_OFFSET);
+	}
 }
 
-
-
-static void updateSensorPositions(std::vector<sf::RectangleShape>& sensors,
-	const sf::Sprite& car)
+/**
+ * @brief Builds one telemetry record of the car pose, the sensor distances, the occupied bay count,
+ *        the beeps played so far and the audio timing counters.
+ */
+[[nodiscard]] static io::TelemetryRecord makeTelemetryRecord(std::uint32_t tick, const sim::CarState& car,
+	const std::vector<sim::SensorReading>& readings, std::size_t occupiedBays, std::uint64_t beepsPlayed,
+	const prof::AudioReport& audio)
 {
-	const sf::FloatRect carBounds = car.getGlobalBounds();
-	const sf::Vector2f carCenter = car.getPosition();
-
-
-	constexpr float SENSOR_HALF_WIDTH = constants::SENSOR_WIDTH / 2.0F;
-	constexpr float SENSOR_LENGTH = constants::SENSOR_HEIGHT;
-
-
-	constexpr float DIAGONAL_OFFSET = 10.0F;
-
-
-	sensors[0].setRotation(sf::degrees(45.0F));
-
-	sensors[0].setPosition({
-		carBounds.position.x - SENSOR_HALF_WIDTH - DIAGONAL_OFFSET,
-		carBounds.position.y - SENSOR_LENGTH + SENSOR_HALF_WIDTH - DIAGONAL_OFFSET
-		});
+	io::TelemetryRecord record;
+	record.tick = tick;
+	record.x = car.position.x;
+	record.y = car.position.y;
+	record.headingDeg = car.headingDeg;
+	record.occupiedBays = static_cast<std::uint16_t>(std::min<std::size_t>(occupiedBays, 0xFFFFU));
+	record.beeps = static_cast<std::uint32_t>(beepsPlayed);
+	record.lateBeeps = static_cast<std::uint32_t>(audio.lateBeeps);
+	record.underruns = static_cast<std::uint32_t>(audio.underruns);
+	record.voiceSteals = static_cast<std::uint32_t>(audio.voiceSteals);
+	record.lateP99Ms = audio.lateP99Ms;
+	record.fillMs = audio.fillMs;
+	record.sensorCount = static_cast<std::uint8_t>(std::min(readings.size(), io::MAX_TELEMETRY_SENSORS));
+	for (std::size_t i = 0U; i < record.sensorCount; ++i) {
+		const float distanceSq = readings[i].distanceSq;
+		record.distances[i] = (distanceSq < std::numeric_limits<float>::max()) ? std::sqrt(distanceSq) : -1.0F;
+	}
+	for (std::size_t i = record.sensorCount; i < io::MAX_TELEMETRY_SENSORS; ++i) {
+		record.distances[i] = -1.0F;
+	}
+	return record;
+}
 
+/**
+ * @brief Bay fills and outlines of the thin front-ends (--view, --join) as one
+ *        triangle list, colored from one occupancy byte per bay.
+ *
+ * The vertices are built once; update() recolors only the bays whose byte
+ * changed, so a lot where nothing flips writes no vertex at all.
+ */
+class BayFills : public sf::Drawable {
+public:
+	static constexpr std::size_t VERTICES_PER_BAY = 30U; // fill quad, then four outline quads
+
+	explicit BayFills(const std::vector<sf::FloatRect>& bays, float outline = 2.0F) {
+		m_vertices.resize(bays.size() * VERTICES_PER_BAY);
+		m_states.assign(bays.size(), 0U);
+		for (std::size_t bay = 0U; bay < bays.size(); ++bay) {
+			const sf::FloatRect& rect = bays[bay];
+			const sf::Vector2f end = rect.position + rect.size;
+			sf::Vertex* vertex = &m_vertices[bay * VERTICES_PER_BAY];
+			vertex = addQuad(vertex, rect.position, end, constants::bayPalette[0]);
+			// Just outside the rect, like the outline of an sf::RectangleShape
+			vertex = addQuad(vertex, rect.position - sf::Vector2f{ outline, outline }, { end.x + outline, rect.position.y },
+				sf::Color::White);
+			vertex = addQuad(vertex, { rect.position.x - outline, end.y }, end + sf::Vector2f{ outline, outline },
+				sf::Color::White);
+			vertex = addQuad(vertex, { rect.position.x - outline, rect.position.y }, { rect.position.x, end.y },
+				sf::Color::White);
+			(void)addQuad(vertex, { end.x, rect.position.y }, { end.x + outline, end.y }, sf::Color::White);
+		}
+	}
 
-	sensors[1].setRotation(sf::degrees(315.0F));
+	/**
+	 * @brief Recolors the bays whose occupancy byte flipped; missing bytes count as free.
+	 */
+	void update(const std::vector<std::uint8_t>& occupied) {
+		for (std::size_t bay = 0U; bay < m_states.size(); ++bay) {
+			const std::uint8_t state = (bay < occupied.size() && occupied[bay] != 0U) ? 1U : 0U;
+			if (state == m_states[bay]) {
+				continue;
+			}
+			m_states[bay] = state;
+			sf::Vertex* fill = &m_vertices[bay * VERTICES_PER_BAY];
+			for (std::size_t i = 0U; i < 6U; ++i) {
+				fill[i].color = constants::bayPalette[state];
+			}
+		}
+	}
 
-	sensors[1].setPosition({
-		carBounds.position.x + carBounds.size.x + SENSOR_HALF_WIDTH + DIAGONAL_OFFSET,
-		carBounds.position.y - SENSOR_HALF_WIDTH - DIAGONAL_OFFSET
-		});
+private:
+	[[nodiscard]] static sf::Vertex* addQuad(sf::Vertex* out, sf::Vector2f min, sf::Vector2f max, sf::Color color) {
+		const sf::Vector2f corners[4] = { min, { max.x, min.y }, max, { min.x, max.y } };
+		for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+			*out++ = sf::Vertex{ corners[corner], color };
+		}
+		return out;
+	}
 
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+		if (!m_vertices.empty()) {
+			target.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Triangles, states);
+		}
+	}
 
-	sensors[2].setRotation(sf::degrees(135.0F));
+	std::vector<sf::Vertex> m_vertices;
+	std::vector<std::uint8_t> m_states; // occupancy byte each bay's fill carries
+};
 
-	sensors[2].setPosition({
-		carBounds.position.x - SENSOR_HALF_WIDTH - DIAGONAL_OFFSET,
-		carBounds.position.y + carBounds.size.y + SENSOR_HALF_WIDTH + DIAGONAL_OFFSET
-		});
+// A sprite image under assets/: its PNG, or the cooked texture (--cook-texture) next to it
+struct SpriteAsset {
+	std::string name;        // file stem, also the atlas region name
+	std::string pngPath;
+	std::string cookedPath;
+	bool cooked = false;     // the cooked file exists and is loaded instead of the PNG
+	float displayScale = 1.0F; // scale the PNG is drawn at; the atlas packs it pre-scaled
+};
 
+/**
+ * @brief Lists the PNG sprites in directory (sorted by name) and starts loading each one.
+ *
+ * With pack open the sprites are the pack's entries directly under directory instead.
+ */
+static std::vector<SpriteAsset> requestSpriteAssets(const std::string& directory, const assets::AssetPack& pack,
+	assets::AssetLoader& loader) {
+	std::vector<std::filesystem::path> pngPaths;
+	if (pack.isOpen()) {
+		for (const std::string& name : pack.names(directory + '/')) {
+			const std::filesystem::path path(name);
+			if (path.parent_path() == directory && path.extension() == ".png") {
+				pngPaths.push_back(path);
+			}
+		}
+	}
+	else {
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".png") {
+				pngPaths.push_back(entry.path());
+			}
+		}
+		if (error) {
+			std::cerr << "Error: Failed to list sprites in " << std::filesystem::absolute(directory) << '\n';
+		}
+	}
 
-	sensors[3].setRotation(sf::degrees(225.0F));
+	std::vector<SpriteAsset> sprites;
+	for (const auto& path : pngPaths) {
+		SpriteAsset sprite;
+		sprite.name = path.stem().string();
+		sprite.pngPath = path.string();
+		sprite.cookedPath = std::filesystem::path(path).replace_extension(".oktx").string();
+		sprite.cooked = pack.contains(sprite.cookedPath) || std::filesystem::exists(sprite.cookedPath);
+		sprites.push_back(std::move(sprite));
+	}
 
-	sensors[3].setPosition({
-		carBounds.position.x + carBounds.size.x + SENSOR_HALF_WIDTH + DIAGONAL_OFFSET,
-		carBounds.position.y + carBounds.size.y + SENSOR_HALF_WIDTH + DIAGONAL_OFFSET
-		});
+	std::sort(sprites.begin(), sprites.end(), [](const SpriteAsset& a, const SpriteAsset& b) { return a.name < b.name; });
+	for (const auto& sprite : sprites) {
+		if (sprite.cooked) {
+			loader.requestCompressedTexture(sprite.cookedPath);
+		}
+		else {
+			loader.requestImage(sprite.pngPath);
+		}
+	}
+	return sprites;
 }
 
-// FUNC TO HANDLE THE PARK INDICATOR
-static bool parkOccupied(const sf::FloatRect& carBounds, const sf::FloatRect& parkBounds) {
-	const bool isLeftInside = carBounds.position.x >= parkBounds.position.x;
-
-	const bool isRightInside = (carBounds.position.x + carBounds.size.x)
-		<= (parkBounds.position.x + parkBounds.size.x);
-
-	const bool isTopInside = carBounds.position.y >= parkBounds.position.y;
+/**
+ * @brief Packs every loaded sprite into the atlas once all of them have finished.
+ *
+ * Returns false while any sprite is still loading. Cooked textures are
+ * uploaded as pages of their own; one that cannot be read is replaced by
+ * its PNG first. Must run on the thread that owns the window's GL context.
+ */
+static bool buildSpriteAtlas(std::vector<SpriteAsset>& sprites, assets::AssetLoader& loader,
+	const gfx::TextureOptions& options, gfx::TextureAtlas& atlas) {
+	bool pending = false;
+	for (auto& sprite : sprites) {
+		if (sprite.cooked && loader.finished(sprite.cookedPath) && loader.compressedTexture(sprite.cookedPath) == nullptr) {
+			loader.requestImage(sprite.pngPath);
+			sprite.cooked = false;
+		}
+		pending = pending || !loader.finished(sprite.cooked ? sprite.cookedPath : sprite.pngPath);
+	}
+	if (pending) {
+		return false;
+	}
 
-	const bool isBottomInside = (carBounds.position.y + carBounds.size.y)
-		<= (parkBounds.position.y + parkBounds.size.y);
+	std::vector<gfx::TextureAtlas::Image> images;
+	for (const auto& sprite : sprites) {
+		if (!sprite.cooked) {
+			images.push_back({ sprite.name, loader.image(sprite.pngPath), sprite.displayScale }); // failed decodes are skipped
+		}
+	}
+	(void)atlas.build(images, options);
 
-	return isLeftInside && isRightInside && isTopInside && isBottomInside;
+	for (const auto& sprite : sprites) {
+		sf::Texture texture;
+		const gfx::CompressedTexture* cooked = sprite.cooked ? loader.compressedTexture(sprite.cookedPath) : nullptr;
+		if (cooked != nullptr && gfx::uploadCompressedTexture(*cooked, texture)) {
+			atlas.addTexturePage(sprite.name, std::move(texture), gfx::textureBytes(*cooked));
+		}
+	}
+	return true;
 }
 
-
-
-// ===============================
-// Main Application
-// ===============================
-
-int main() {
-	// ====================================
-	// Window setup
-	// ====================================
-	sf::SoundBuffer beepBuffer;
-	beepBuffer.loadFromFile("assets/beep.mp3");
-	sf::Sound beepSound(beepBuffer);
-	sf::Music beepMusic;
-
-	if (!beepMusic.openFromFile("assets/beep.mp3")) {
-		std::cerr << "NEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEEE\n";
+/**
+ * @brief Alpha hull of a loaded sprite stretched over halfExtent, from the PNG or the cooked
+ *        texture's full-size level; the rectangle itself if neither decoded.
+ */
+static sim::CarHull spriteHull(const SpriteAsset& sprite, const assets::AssetLoader& loader, const sf::Vector2f& halfExtent) {
+	if (sprite.cooked) {
+		const gfx::CompressedTexture* cooked = loader.compressedTexture(sprite.cookedPath);
+		if (cooked != nullptr && !cooked->empty()) {
+			const std::vector<std::uint8_t> rgba = gfx::decodeLevel(*cooked, 0U);
+			return sim::alphaHull(rgba.data(), cooked->size(), halfExtent);
+		}
 	}
-
-	sf::RenderWindow window(
-		sf::VideoMode({ constants::WINDOW_WIDTH, constants::WINDOW_HEIGHT }),
-		"Car Parking Sensor Simulation - Task 2",
-		sf::State::Windowed
-	);
-	window.setFramerateLimit(60U);
-
-	sf::Clock beepClock;
-
-
-
-	std::vector<sf::CircleShape> stupovi;
-	std::vector<sf::Vector2f> pozicije = {
-		{800.f, 500.f},
-		{1550.f, 800.f},
-		{1810.f, 800.f}
-	};
-
-	for (const auto& poz : pozicije) {
-		sf::CircleShape stup;
-		stup.setRadius(25.f);
-		stup.setFillColor(sf::Color::White);
-		stup.setPosition(poz);
-		stupovi.push_back(stup);
+	else if (const sf::Image* image = loader.image(sprite.pngPath); image != nullptr && image->getPixelsPtr() != nullptr) {
+		return sim::alphaHull(image->getPixelsPtr(), image->getSize(), halfExtent);
 	}
-
-	// ====================================
-	// Resource setup
-	// ====================================
-
-	// --- SCALING DOWN THE SPRITE ---
-	float SCALE_DOWN_FACTOR = 0.30F; // Scale to 15% of original size
-
-
-	const sf::Texture carTexture = loadTextureOrExit("assets/car_background.png");
-	sf::Sprite carSprite(carTexture);
-
-
-
-
-	// Apply the scaling using setScale()
-
-	carSprite.scale({ SCALE_DOWN_FACTOR, SCALE_DOWN_FACTOR });
-
-
-	centerSprite(carSprite, window);
-	carSprite.setPosition(sf::Vector2f(250, 250));
-	std::vector<sf::RectangleShape> sensors = createSensorIndicators();
-	updateSensorPositions(sensors, carSprite);
-
-
-	//PARK SENSOR - consts
-	constexpr float parkWidth = 200.0F;
-	constexpr float parkHeight = 350.0F;
-	constexpr float margin = 10.0F;
-
-	//Set height/witdh, color and border thickness of the parking indicator
-	sf::RectangleShape parkIndicator({ parkWidth, parkHeight });
-	parkIndicator.setFillColor(constants::transGreen);
-	parkIndicator.setOutlineColor(sf::Color::White);
-	parkIndicator.setOutlineThickness(2.0F);
-
-	//Draw the park indicator
-	parkIndicator.setPosition({ static_cast<float>(constants::WINDOW_WIDTH) - parkWidth - margin, margin });
+	return sim::boxHull(halfExtent);
+}
 
 
 
-	// ====================================
-	// Main loop
-	// ====================================
-	sf::Clock clock;
+// Driving keys, one bit each in DrivingKeys::held (the key's index here)
+struct KeyBinding {
+	sf::Keyboard::Scancode key;
+	sim::CarInput control;
+};
+constexpr KeyBinding DRIVING_KEYS[] = {
+	{ sf::Keyboard::Scancode::W, sim::input::FORWARD },  { sf::Keyboard::Scancode::Up, sim::input::FORWARD },
+	{ sf::Keyboard::Scancode::S, sim::input::BACKWARD }, { sf::Keyboard::Scancode::Down, sim::input::BACKWARD },
+	{ sf::Keyboard::Scancode::A, sim::input::LEFT },     { sf::Keyboard::Scancode::Left, sim::input::LEFT },
+	{ sf::Keyboard::Scancode::D, sim::input::RIGHT },    { sf::Keyboard::Scancode::Right, sim::input::RIGHT }
+};
 
-	while (window.isOpen()) {
-		const float deltaTime = clock.restart().asSeconds();
+/**
+ * @brief Driving keys currently held, kept up to date from keyboard events.
+ *
+ * Replaces per-frame isKeyPressed() polling, which queries the OS once per
+ * key on some platforms. Both keys of a control are tracked separately, so
+ * releasing Up while W is still held keeps the car moving.
+ */
+struct DrivingKeys {
+	std::uint8_t held = 0U;
 
-		// Movement logic
-		sf::Vector2f movement{ 0.0F, 0.0F };
+	void update(const sf::Event& event) {
+		if (const auto* pressed = event.getIf<sf::Event::KeyPressed>()) {
+			held |= bit(pressed->scancode);
+		}
+		else if (const auto* released = event.getIf<sf::Event::KeyReleased>()) {
+			held &= static_cast<std::uint8_t>(~bit(released->scancode));
+		}
+		else if (event.is<sf::Event::FocusLost>()) {
+			held = 0U; // releases are not delivered to an unfocused window
+		}
+	}
 
-		float rotationChange = 0.0F;
+	/**
+	 * @brief True for the press of a driving key (repeats included).
+	 */
+	[[nodiscard]] static bool drives(const sf::Event& event) {
+		const auto* pressed = event.getIf<sf::Event::KeyPressed>();
+		return pressed != nullptr && bit(pressed->scancode) != 0U;
+	}
 
-		// ---- Handle events ----
-		while (auto event = window.pollEvent()) {
-			if (event->is<sf::Event::Closed>()) {
-				window.close();
+	/**
+	 * @brief Input bitmask of the held keys for one tick.
+	 */
+	[[nodiscard]] sim::CarInput input() const {
+		sim::CarInput input = 0U;
+		for (std::size_t i = 0U; i < std::size(DRIVING_KEYS); ++i) {
+			if ((held & (1U << i)) != 0U) {
+				input |= DRIVING_KEYS[i].control;
 			}
-
-			// Window closed or escape key pressed: exit
-			if ((event->is<sf::Event::KeyPressed>() &&
-				event->getIf<sf::Event::KeyPressed>()->code == sf::Keyboard::Key::Space))
-				std::cout << "KeyPressed event has occured, key pressed is: Space\n";
 		}
+		return input;
+	}
 
-		// ---- Update logic ---
+private:
+	[[nodiscard]] static std::uint8_t bit(sf::Keyboard::Scancode key) {
+		for (std::size_t i = 0U; i < std::size(DRIVING_KEYS); ++i) {
+			if (DRIVING_KEYS[i].key == key) {
+				return static_cast<std::uint8_t>(1U << i);
+			}
+		}
+		return 0U;
+	}
+};
 
-		sf::Angle rotation;
+/**
+ * @brief Everything the renderer reads from one simulated frame.
+ *
+ * Under --pipelined the next frame is written into a second snapshot while
+ * this one is drawn, so the renderer never reads the simulation state itself.
+ */
+struct FrameSnapshot {
+	// Inputs, set before the frame is simulated
+	sim::CarInput input = 0U;
+	float frameDt = 0.0F;
+
+	sim::CarState previousCar; // the last two ticks; the sprite is drawn between them
+	sim::CarState car;
+	sim::CarState previousTrailer; // --trailer, the same two ticks
+	sim::CarState trailer;
+	float alpha = 0.0F;        // accumulator left after the ticks, in ticks
+	std::vector<sim::SensorPose> sensorPoses;
+	std::vector<sim::SensorReading> sensorReadings; // walls = camera bounds and scene walls
+	std::vector<float> beepIntervals;               // per sensor, seconds (0 = silent)
+	std::vector<std::uint8_t> sensorLevels;         // per sensor, fused sim::WARNING_LEVEL_*
+	std::uint64_t eventFrame = 0U;                  // sim::EventChannel frame sealed by this simulation
+	std::vector<std::uint8_t> bayOccupied;          // full copy, only when that frame's events overflowed
+	bool autoParking = false;  // the car is driving a planned path
+	bool reversing = false;    // backing up: the guide lines are shown
+	float pathCurvature = 0.0F; // radians per pixel the steering is set for (sim::pathCurvature)
+	std::vector<sim::Mover> movers; // --movers: where the moving obstacles ended up
+	prof::PhaseTimes phases;   // simulation-side phases, added to the frame that shows them
+};
+
+// Render queue layers, back to front; all but the screen layer are drawn under the camera
+constexpr std::uint8_t GROUND_LAYER = 0U;   // static layer, heatmap
+constexpr std::uint8_t MARKINGS_LAYER = 1U; // park path, bay indicators
+constexpr std::uint8_t BODIES_LAYER = 2U;   // car, movers, pillars
+constexpr std::uint8_t OVERLAY_LAYER = 3U;  // sensor field
+constexpr std::uint8_t LABELS_LAYER = 4U;   // sensor labels
+constexpr std::uint8_t SCREEN_LAYER = 5U;   // minimap, loading bar, profiler
 
 
-		float currentRotationDeg = carSprite.getRotation().asDegrees();
-		float currentRotationRad = currentRotationDeg * (constants::PI / 180.0F);
 
-		const float forwardX = cos(currentRotationRad);
-		const float forwardY = sin(currentRotationRad);
+// ===============================
+// Command Line
+// ===============================
 
+// Options selected on the command line
+struct AppOptions {
+	bool instanced = false;                  // --instanced: GPU-instanced obstacle, sensor and bay drawing
+	bool tiled = false;                      // --tiled: per-tile instanced drawing from persistent buffers (OpenGL 4.4)
+	float tickHz = constants::SIM_TICK_HZ;   // --tick-hz <n>: fixed simulation rate
+	bool headless = false;                   // --headless [trace]: batch run, no window or audio
+	std::string tracePath;                   // input trace for --headless (built-in drive if empty)
+	std::uint32_t repeat = 1U;               // --repeat <n>: replay the trace n times
+	std::size_t fleetSize = 0U;              // --fleet <n>: headless run with n cars (0 = single car)
+	std::size_t threads = 0U;                // --threads <n>: shared job system threads (0 = all cores)
+	std::string chromeTracePath;             // --chrome-trace [file]: write hot-path events on exit (empty = off)
+	bool hwCounters = false;                 // --hw-counters: CPU performance counters around the hot scopes
+	std::string eventsPath;                  // --events <file>: fleet and evaluation event log (empty = off)
+	std::string script;                      // --script <name>: fleet cars follow a drive script (empty = the trace)
+	bool quantized = false;                  // --quantized: fleet sensors use fixed-point pillar tiles
+	std::string screenshotDir;               // --screenshots <dir>: headless frames at each trace checkpoint (empty = off)
+	std::string datasetPath;                 // --dataset <file> <n>: headless sensor training records (empty = off)
+	std::uint64_t datasetSamples = 0U;
+	std::string batchDirectory;              // --render-batch <dir> <n>: n top-down images of random lot states (empty = off)
+	std::uint64_t batchCount = 0U;
+	bool sampleBeep = false;                 // --sample-beep: play assets/beep.mp3 (or its cooked PCM) instead of the synth
+	bool latencyProbe = false;               // --latency-probe: time driving key presses to their beep, report on exit
+	bool raycast = false;                    // --raycast: sensors cone-cast rays instead of center distance
+	bool mapping = false;                    // --mapping: sensors read an occupancy map built from their rays
+	bool ttc = false;                        // --ttc: beeps also follow the predicted time to collision
+	float sensorCache = 0.0F;                // --sensor-cache <units>: reuse grid readings within this drift (0 = off)
+	bool movers = false;                     // --movers: pedestrians and cars move along the scene's routes
+	bool trailer = false;                    // --trailer: tow a trailer with its own sensor rig
+	bool operatorView = false;               // --operator-view: second window with the whole lot from above
+	sim::SensorNoiseConfig noise;            // --noise <px>, --dropout <p>, --latency <n>: perturbed sensor passes, seeded by --seed
+	std::string sdfPath;                     // --sdf [cache]: baked distance field (empty = off)
+	std::string cookSource;                  // --cook-texture <png> <out>: cook a texture and exit
+	std::string cookTarget;
+	std::string packSource;                  // --pack-assets <dir> <out>: write an asset pack and exit
+	std::string packTarget;
+	std::string assetPackPath;               // --asset-pack <file>: load assets from a pack (assets.okpk if present and empty)
+	std::string textureCacheDir = constants::TEXTURE_CACHE_DIR; // --texture-cache <dir|off>: decoded sprite cache, empty when off
+	std::string editSavePath = constants::EDIT_SAVE_PATH; // --edit-save <file>: where the scenario editor saves (F5)
+	float cookScale = constants::CAR_SPRITE_SCALE; // --cook-scale <f>: downscale applied while cooking
+	std::string cookSoundSource;             // --cook-sound <in> <out>: bake a sound to PCM and exit
+	std::string cookSoundTarget;
+	std::uint32_t cookRate = constants::AUDIO_OUTPUT_RATE; // --cook-rate <hz>: sample rate a cooked sound is stored at
+	std::string recordPath;                  // --record <file>: stream frame times and inputs into a block log
+	std::string replayPath;                  // --replay <file>: drive from a recording, then exit
+	std::string scenarioPath;                // --scenario <file>: obstacles, bays and spawns (built-in if empty)
+	std::string stressScene;                 // --stress <name[:size[:spacing]]>: a synthetic stress lot instead
+	std::string compileSource;               // --compile-scenario <in> <out>: write the binary form and exit
+	std::string compileTarget;
+	bool compileWorld = false;               // --compile-world <in> <out>: write a tiled world instead
+	std::string worldPath;                   // --world <file>: stream a tiled world around the car
+	bool adaptive = false;                   // --adaptive: skip idle frames, block on events until something changes
+	bool onDemand = false;                   // --on-demand: as --adaptive, but only input (not any event) resumes the simulation
+	bool vsync = false;                      // --vsync: pace frames with vertical sync instead of the sleep limiter
+	double pacerHz = 0.0;                    // --pacer [hz]: timer-and-spin limiter instead of the sleep limiter (0 = off)
+	std::uint32_t workBudgetUs = constants::WORK_BUDGET_US; // --work-budget <us>: lazy work after each display (0 = inline)
+	bool pipelined = false;                  // --pipelined: simulate the next frame while this one is drawn
+	bool renderThread = false;               // --render-thread: draw and display on their own thread
+	bool gpuSensors = false;                 // --gpu-sensors: sensor queries in a compute shader (OpenGL 4.3)
+	std::optional<sim::NearestBackend> nearest; // --nearest <brute|simd|grid|bvh|sdf|gpu>: engine for the nearest pillars
+	bool nearestCompare = false;             // --nearest-compare: every engine on each sensor pass, compared in F3
+	std::string profilesPath;                // --profiles <file>: warning profiles (built-in default if empty)
+	std::string vehicle;                     // --vehicle <name>: profile to use (first one if empty)
+	std::string tuningPath;                  // --tuning <file>: calibration values, reloaded with --profiles while running
+	sim::VehicleModel model = sim::VehicleModel::Arcade; // --bicycle: drive with the bicycle model
+	std::size_t evaluateTrials = 0U;         // --evaluate <n> [trace]: randomized parking trials of a trace
+	std::uint64_t seed = 1U;                 // --seed <n>: random stream for --evaluate and the sensor noise
+	float forkAt = 0.0F;                     // --fork-at <s>: --evaluate trials fork from this far into the script
+	std::string telemetryHost;               // --telemetry <host:port>: stream per-frame records over UDP (empty = off)
+	unsigned short telemetryPort = 0U;
+	std::string telemetryLogPath;            // --telemetry-log <file>: keep the same records in a block log (empty = off)
+	unsigned short occupancyPort = 0U;       // --occupancy-port <port>: answer free-bay queries over UDP (0 = off)
+	unsigned short servePort = 0U;           // --serve <port>: headless fleet that streams world deltas to viewers
+	std::string viewHost;                    // --view <host:port>: render a --serve simulation (empty = off)
+	unsigned short viewPort = 0U;
+	unsigned short relayPort = 0U;           // --relay <port>: forward driver inputs between --join peers
+	std::size_t relayPlayers = 2U;           // --players <n>: drivers a --relay session waits for
+	std::string joinHost;                    // --join <host:port>: drive one car of a lockstep session (empty = off)
+	unsigned short joinPort = 0U;
+	float heatmapSeconds = 0.0F;             // --heatmap [seconds]: occupancy heatmap, full red at seconds (0 = off)
+	std::string captureDirectory;            // --capture <dir>: write every frame as an image (empty = off)
+	std::string captureFormat = constants::CAPTURE_FORMAT; // --capture-format <ext>: bmp, png, tga or jpg
+	bool cameraFeed = false;                 // --camera-feed: rear-camera inset streamed from a capture thread
+	bool mipmaps = true;                     // --no-mipmaps: atlas pages without a mip chain
+	bool srgb = false;                       // --srgb: sRGB atlas pages and an sRGB-capable window
+	float renderScale = 1.0F;                // --render-scale <f>: world drawn at f of the window size, then upscaled (1 = off)
+	float dynamicResolutionMs = 0.0F;        // --dynamic-resolution [ms]: render scale follows GPU frame time to this budget (0 = off)
+	float qualityGovernorMs = 0.0F;          // --quality-governor [ms]: optional work follows CPU frame time to this budget (0 = off)
+	float rain = 0.0F;                       // --rain [0-1]: rain post-process at this intensity (0 = off)
+	float night = 0.0F;                      // --night [0-1]: night lighting at this darkness (0 = off)
+	gfx::EffectTier effectsTier = gfx::EffectTier::High; // --effects-tier low|medium|high: per-pixel budget of --rain/--night
+	bool allocCheck = false;                 // --alloc-check [trap]: count heap allocations of steady-state frames
+	bool allocTrap = false;                  //   trap: abort inside the offending allocation instead of reporting
+};
 
-		const float distancePerFrame = constants::CAR_SPEED * deltaTime;
+/**
+ * @brief Splits text of the form host:port; false for anything else.
+ */
+[[nodiscard]] static bool parseHostPort(std::string_view text, std::string& host, unsigned short& port) {
+	const std::size_t colon = text.rfind(':');
+	if (colon == 0U || colon == std::string_view::npos) {
+		return false;
+	}
+	const unsigned long value = std::strtoul(std::string(text.substr(colon + 1U)).c_str(), nullptr, 10);
+	if (value == 0UL || value > 65535UL) {
+		return false;
+	}
+	host = std::string(text.substr(0U, colon));
+	port = static_cast<unsigned short>(value);
+	return true;
+}
 
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::W) || sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Up)) {
+/**
+ * @brief Parses the command line; unknown arguments are reported and ignored.
+ */
+static AppOptions parseOptions(int argc, char* argv[]) {
+	AppOptions options;
 
-			movement.x += forwardX * distancePerFrame;
-			movement.y += forwardY * distancePerFrame;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg(argv[i]);
+		if (arg == "--instanced") {
+			options.instanced = true;
 		}
-
-
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::S) || sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Down)) {
-			movement.x -= forwardX * distancePerFrame;
-			movement.y -= forwardY * distancePerFrame;
-
-			//movement -= forward * (constants::CAR_SPEED * deltaTime);
+		else if (arg == "--tiled") {
+			options.tiled = true;
 		}
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::A) || sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Left)) {
-			rotation = sf::degrees(-constants::CAR_ROTATION_SPEED);
-
+		else if (arg == "--tick-hz" && (i + 1) < argc) {
+			const float hz = std::strtof(argv[++i], nullptr);
+			if (hz > 0.0F) {
+				options.tickHz = hz;
+			}
+			else {
+				std::cerr << "Warning: invalid --tick-hz value, keeping " << options.tickHz << '\n';
+			}
 		}
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::D) || sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Right)) {
-			rotation = sf::degrees(constants::CAR_ROTATION_SPEED);
+		else if (arg == "--sample-beep") {
+			options.sampleBeep = true;
 		}
-
-		carSprite.rotate(rotation);
-		carSprite.move(movement);
-
-		updateSensorPositions(sensors, carSprite);
-		playBeepIfNear(sensors, stupovi, beepSound, beepClock);
-
-
-
-		// ---- Optional logic ----
-		if (sensors[0].getPosition().y <= 0) {
-			sensors[0].setFillColor(sf::Color::Red);
+		else if (arg == "--latency-probe") {
+			options.latencyProbe = true;
 		}
-		else {
-			sensors[0].setFillColor(sf::Color::Green);
+		else if (arg == "--operator-view") {
+			options.operatorView = true;
 		}
-		if (sensors[2].getPosition().x <= (constants::SENSOR_HEIGHT)) {
-			sensors[2].setFillColor(sf::Color::Red);
+		else if (arg == "--chrome-trace") {
+			options.chromeTracePath = "trace.json";
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				options.chromeTracePath = argv[++i];
+			}
 		}
-		else {
-			sensors[2].setFillColor(sf::Color::Green);
+		else if (arg == "--hw-counters") {
+			options.hwCounters = true;
 		}
-
-		// ---- Rendering ----
-		window.clear(sf::Color(30, 30, 30));
-		window.draw(carSprite);
-
-		//DRAW THE PARK INDICATOR
-		window.draw(parkIndicator);
-
-		//PARKING INDICATION - GET LOCATION OF THE CAR AND THE INDICATOR
-		const sf::FloatRect carBounds = carSprite.getGlobalBounds();
-		const sf::FloatRect parkBounds = parkIndicator.getGlobalBounds();
-
-		//CHANGE COLOR OF PARK INDICATOR; ON OCCUPATION
-		if (parkOccupied(carBounds, parkBounds)) {
-			parkIndicator.setFillColor(constants::transRed);
+		else if (arg == "--events" && (i + 1) < argc) {
+			options.eventsPath = argv[++i];
 		}
-		else {
-			parkIndicator.setFillColor(constants::transGreen);
+		else if (arg == "--script" && (i + 1) < argc) {
+			options.script = argv[++i];
 		}
-
-
-		//UNCOMMENT IF YOU NEED TO HAVE PARK SENSORS AROUND THE CAR
-		//for (const auto& sensor : sensors) {
-			//window.draw(sensor);
-		//}
-		for (auto& s : stupovi) {
-			window.draw(s);
+		else if (arg == "--quantized") {
+			options.quantized = true;
 		}
-		window.display();
+		else if (arg == "--screenshots" && (i + 1) < argc) {
+			options.screenshotDir = argv[++i];
+		}
+		else if (arg == "--dataset" && (i + 2) < argc) {
+			options.datasetPath = argv[++i];
+			options.datasetSamples = static_cast<std::uint64_t>(std::strtoull(argv[++i], nullptr, 10));
+			options.headless = true;
+		}
+		else if (arg == "--render-batch" && (i + 2) < argc) {
+			options.batchDirectory = argv[++i];
+			options.batchCount = static_cast<std::uint64_t>(std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--raycast") {
+			options.raycast = true;
+		}
+		else if (arg == "--mapping") {
+			options.mapping = true;
+		}
+		else if (arg == "--ttc") {
+			options.ttc = true;
+		}
+		else if (arg == "--movers") {
+			options.movers = true;
+		}
+		else if (arg == "--trailer") {
+			options.trailer = true;
+		}
+		else if (arg == "--noise" && (i + 1) < argc) {
+			options.noise.sigma = std::max(std::strtof(argv[++i], nullptr), 0.0F);
+		}
+		else if (arg == "--dropout" && (i + 1) < argc) {
+			options.noise.dropout = std::clamp(std::strtof(argv[++i], nullptr), 0.0F, 1.0F);
+		}
+		else if (arg == "--latency" && (i + 1) < argc) {
+			options.noise.latency = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--sensor-cache" && (i + 1) < argc) {
+			options.sensorCache = std::max(std::strtof(argv[++i], nullptr), 0.0F);
+		}
+		else if (arg == "--sdf") {
+			options.sdfPath = "assets/obstacles.sdf";
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				options.sdfPath = argv[++i];
+			}
+		}
+		else if (arg == "--cook-texture" && (i + 2) < argc) {
+			options.cookSource = argv[++i];
+			options.cookTarget = argv[++i];
+		}
+		else if (arg == "--cook-sound" && (i + 2) < argc) {
+			options.cookSoundSource = argv[++i];
+			options.cookSoundTarget = argv[++i];
+		}
+		else if (arg == "--cook-rate" && (i + 1) < argc) {
+			const unsigned long rate = std::strtoul(argv[++i], nullptr, 10);
+			if (rate >= 8000UL && rate <= 192000UL) {
+				options.cookRate = static_cast<std::uint32_t>(rate);
+			}
+			else {
+				std::cerr << "Warning: invalid --cook-rate value, keeping " << options.cookRate << '\n';
+			}
+		}
+		else if (arg == "--pack-assets" && (i + 2) < argc) {
+			options.packSource = argv[++i];
+			options.packTarget = argv[++i];
+		}
+		else if (arg == "--asset-pack" && (i + 1) < argc) {
+			options.assetPackPath = argv[++i];
+		}
+		else if (arg == "--texture-cache" && (i + 1) < argc) {
+			const std::string dir = argv[++i];
+			options.textureCacheDir = (dir == "off") ? std::string() : dir;
+		}
+		else if (arg == "--edit-save" && (i + 1) < argc) {
+			options.editSavePath = argv[++i];
+		}
+		else if (arg == "--cook-scale" && (i + 1) < argc) {
+			const float scale = std::strtof(argv[++i], nullptr);
+			if (scale > 0.0F) {
+				options.cookScale = scale;
+			}
+			else {
+				std::cerr << "Warning: invalid --cook-scale value, keeping " << options.cookScale << '\n';
+			}
+		}
+		else if (arg == "--record" && (i + 1) < argc) {
+			options.recordPath = argv[++i];
+		}
+		else if (arg == "--replay" && (i + 1) < argc) {
+			options.replayPath = argv[++i];
+		}
+		else if (arg == "--scenario" && (i + 1) < argc) {
+			options.scenarioPath = argv[++i];
+		}
+		else if (arg == "--stress" && (i + 1) < argc) {
+			options.stressScene = argv[++i];
+		}
+		else if ((arg == "--compile-scenario" || arg == "--compile-world") && (i + 2) < argc) {
+			options.compileWorld = (arg == "--compile-world");
+			options.compileSource = argv[++i];
+			options.compileTarget = argv[++i];
+		}
+		else if (arg == "--adaptive") {
+			options.adaptive = true;
+		}
+		else if (arg == "--on-demand") {
+			options.onDemand = true;
+		}
+		else if (arg == "--vsync") {
+			options.vsync = true;
+		}
+		else if (arg == "--no-mipmaps") {
+			options.mipmaps = false;
+		}
+		else if (arg == "--srgb") {
+			options.srgb = true;
+		}
+		else if (arg == "--render-scale" && (i + 1) < argc) {
+			const float scale = std::strtof(argv[++i], nullptr);
+			if (scale > 0.0F && scale <= 1.0F) {
+				options.renderScale = scale;
+			}
+			else {
+				std::cerr << "Warning: invalid --render-scale value, keeping " << options.renderScale << '\n';
+			}
+		}
+		else if (arg == "--dynamic-resolution") {
+			options.dynamicResolutionMs = constants::DYNAMIC_RESOLUTION_TARGET_MS;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				const float ms = std::strtof(argv[++i], nullptr);
+				if (ms > 0.0F) {
+					options.dynamicResolutionMs = ms;
+				}
+				else {
+					std::cerr << "Warning: invalid --dynamic-resolution value, keeping " << options.dynamicResolutionMs << '\n';
+				}
+			}
+		}
+		else if (arg == "--pacer") {
+			options.pacerHz = constants::PACER_RATE_HZ;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				const double hz = std::strtod(argv[++i], nullptr);
+				if (hz >= 1.0 && hz <= 1000.0) {
+					options.pacerHz = hz;
+				}
+				else {
+					std::cerr << "Warning: invalid --pacer value, keeping " << options.pacerHz << '\n';
+				}
+			}
+		}
+		else if (arg == "--work-budget" && (i + 1) < argc) {
+			const unsigned long budget = std::strtoul(argv[++i], nullptr, 10);
+			if (budget <= 100000UL) {
+				options.workBudgetUs = static_cast<std::uint32_t>(budget);
+			}
+			else {
+				std::cerr << "Warning: invalid --work-budget " << argv[i] << ", keeping " << options.workBudgetUs << '\n';
+			}
+		}
+		else if (arg == "--alloc-check") {
+			options.allocCheck = true;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]) == "trap") {
+				options.allocTrap = true;
+				++i;
+			}
+		}
+		else if (arg == "--quality-governor") {
+			options.qualityGovernorMs = constants::QUALITY_GOVERNOR_TARGET_MS;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				const float ms = std::strtof(argv[++i], nullptr);
+				if (ms > 0.0F) {
+					options.qualityGovernorMs = ms;
+				}
+				else {
+					std::cerr << "Warning: invalid --quality-governor value, keeping " << options.qualityGovernorMs << '\n';
+				}
+			}
+		}
+		else if (arg == "--rain" || arg == "--night") {
+			float& level = (arg == "--rain") ? options.rain : options.night;
+			level = (arg == "--rain") ? constants::RAIN_INTENSITY : constants::NIGHT_DARKNESS;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				const float value = std::strtof(argv[++i], nullptr);
+				if (value > 0.0F && value <= 1.0F) {
+					level = value;
+				}
+				else {
+					std::cerr << "Warning: invalid " << arg << " value, keeping " << level << '\n';
+				}
+			}
+		}
+		else if (arg == "--effects-tier" && (i + 1) < argc) {
+			if (const std::optional<gfx::EffectTier> tier = gfx::parseEffectTier(argv[++i])) {
+				options.effectsTier = *tier;
+			}
+			else {
+				std::cerr << "Warning: unknown --effects-tier " << argv[i] << ", expected low, medium or high\n";
+			}
+		}
+		else if (arg == "--pipelined") {
+			options.pipelined = true;
+		}
+		else if (arg == "--render-thread") {
+			options.renderThread = true;
+		}
+		else if (arg == "--gpu-sensors") {
+			options.gpuSensors = true;
+		}
+		else if (arg == "--nearest" && (i + 1) < argc) {
+			sim::NearestBackend backend = sim::NearestBackend::Grid;
+			if (sim::parseNearestBackend(argv[++i], backend)) {
+				options.nearest = backend;
+				options.gpuSensors = options.gpuSensors || backend == sim::NearestBackend::Gpu;
+			}
+			else {
+				std::cerr << "Warning: unknown --nearest " << argv[i] << ", expected brute, simd, grid, bvh, sdf or gpu\n";
+			}
+		}
+		else if (arg == "--nearest-compare") {
+			options.nearestCompare = true;
+		}
+		else if (arg == "--profiles" && (i + 1) < argc) {
+			options.profilesPath = argv[++i];
+		}
+		else if (arg == "--vehicle" && (i + 1) < argc) {
+			options.vehicle = argv[++i];
+		}
+		else if (arg == "--tuning" && (i + 1) < argc) {
+			options.tuningPath = argv[++i];
+		}
+		else if (arg == "--bicycle") {
+			options.model = sim::VehicleModel::Bicycle;
+		}
+		else if (arg == "--world" && (i + 1) < argc) {
+			options.worldPath = argv[++i];
+		}
+		else if (arg == "--headless") {
+			options.headless = true;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				options.tracePath = argv[++i];
+			}
+		}
+		else if (arg == "--repeat" && (i + 1) < argc) {
+			const unsigned long repeat = std::strtoul(argv[++i], nullptr, 10);
+			options.repeat = (repeat > 0UL) ? static_cast<std::uint32_t>(repeat) : 1U;
+		}
+		else if (arg == "--fleet" && (i + 1) < argc) {
+			options.fleetSize = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+			options.headless = true;
+		}
+		else if (arg == "--threads" && (i + 1) < argc) {
+			options.threads = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--evaluate" && (i + 1) < argc) {
+			options.evaluateTrials = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+			options.headless = true;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				options.tracePath = argv[++i];
+			}
+		}
+		else if (arg == "--seed" && (i + 1) < argc) {
+			options.seed = static_cast<std::uint64_t>(std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--fork-at" && (i + 1) < argc) {
+			options.forkAt = std::max(std::strtof(argv[++i], nullptr), 0.0F);
+		}
+		else if (arg == "--telemetry" && (i + 1) < argc) {
+			const std::string_view target(argv[++i]);
+			if (!parseHostPort(target, options.telemetryHost, options.telemetryPort)) {
+				std::cerr << "Warning: --telemetry expects host:port, got " << target << '\n';
+			}
+		}
+		else if (arg == "--telemetry-log" && (i + 1) < argc) {
+			options.telemetryLogPath = argv[++i];
+		}
+		else if (arg == "--occupancy-port" && (i + 1) < argc) {
+			const unsigned long port = std::strtoul(argv[++i], nullptr, 10);
+			if (port > 0UL && port <= 65535UL) {
+				options.occupancyPort = static_cast<unsigned short>(port);
+			}
+			else {
+				std::cerr << "Warning: invalid --occupancy-port " << argv[i] << '\n';
+			}
+		}
+		else if (arg == "--serve" && (i + 1) < argc) {
+			const unsigned long port = std::strtoul(argv[++i], nullptr, 10);
+			if (port > 0UL && port <= 65535UL) {
+				options.servePort = static_cast<unsigned short>(port);
+			}
+			else {
+				std::cerr << "Warning: invalid --serve port " << argv[i] << '\n';
+			}
+		}
+		else if (arg == "--heatmap") {
+			options.heatmapSeconds = constants::HEATMAP_FULL_SCALE;
+			if ((i + 1) < argc && std::string_view(argv[i + 1]).rfind("--", 0) != 0U) {
+				const float seconds = std::strtof(argv[++i], nullptr);
+				if (seconds > 0.0F) {
+					options.heatmapSeconds = seconds;
+				}
+				else {
+					std::cerr << "Warning: invalid --heatmap value, keeping " << options.heatmapSeconds << '\n';
+				}
+			}
+		}
+		else if (arg == "--capture" && (i + 1) < argc) {
+			options.captureDirectory = argv[++i];
+		}
+		else if (arg == "--capture-format" && (i + 1) < argc) {
+			options.captureFormat = argv[++i];
+		}
+		else if (arg == "--camera-feed") {
+			options.cameraFeed = true;
+		}
+		else if (arg == "--view" && (i + 1) < argc) {
+			const std::string_view target(argv[++i]);
+			if (!parseHostPort(target, options.viewHost, options.viewPort)) {
+				std::cerr << "Warning: --view expects host:port, got " << target << '\n';
+			}
+		}
+		else if (arg == "--relay" && (i + 1) < argc) {
+			const unsigned long port = std::strtoul(argv[++i], nullptr, 10);
+			if (port > 0UL && port <= 65535UL) {
+				options.relayPort = static_cast<unsigned short>(port);
+			}
+			else {
+				std::cerr << "Warning: invalid --relay port " << argv[i] << '\n';
+			}
+		}
+		else if (arg == "--players" && (i + 1) < argc) {
+			const unsigned long players = std::strtoul(argv[++i], nullptr, 10);
+			if (players > 0UL && players <= sim::MAX_LOCKSTEP_PLAYERS) {
+				options.relayPlayers = static_cast<std::size_t>(players);
+			}
+			else {
+				std::cerr << "Warning: --players expects 1 to " << sim::MAX_LOCKSTEP_PLAYERS << ", keeping "
+					<< options.relayPlayers << '\n';
+			}
+		}
+		else if (arg == "--join" && (i + 1) < argc) {
+			const std::string_view target(argv[++i]);
+			if (!parseHostPort(target, options.joinHost, options.joinPort)) {
+				std::cerr << "Warning: --join expects host:port, got " << target << '\n';
+			}
+		}
+		else {
+			std::cerr << "Warning: ignoring unknown argument " << arg << '\n';
+		}
+	}
+
+	return options;
+}
+
+/**
+ * @brief The built-in scene, with the --scenario or --stress layout in place of its own if one is given.
+ */
+[[nodiscard]] static bool loadScene(const AppOptions& options, sim::Scene& scene) {
+	return sim::loadScene(options.scenarioPath, scene, options.stressScene);
+}
+
+/**
+ * @brief One line of sustained timings over the profiler history: median and
+ *        99th percentile of the frame, the simulation and the render (draw + display).
+ */
+static void logStressTimings(const std::string& stressScene, const prof::FrameProfiler& profiler) {
+	float renderMs[2] = { 0.0F, 0.0F };
+	const float percentiles[2] = { 50.0F, 99.0F };
+	for (std::size_t i = 0U; i < 2U; ++i) {
+		renderMs[i] = profiler.percentile(prof::Phase::Draw, percentiles[i])
+			+ profiler.percentile(prof::Phase::Display, percentiles[i]);
+	}
+	OKPP_LOG_INFO("Stress %s over %zu frames: frame %.2f / %.2f ms, simulation %.2f / %.2f ms, render %.2f / %.2f ms (p50 / p99)",
+		stressScene.c_str(), profiler.size(), profiler.framePercentile(50.0F), profiler.framePercentile(99.0F),
+		profiler.percentile(prof::Phase::Simulation, 50.0F), profiler.percentile(prof::Phase::Simulation, 99.0F),
+		renderMs[0], renderMs[1]);
+}
+
+/**
+ * @brief The --vehicle warning profile from --profiles, or the built-in default.
+ */
+[[nodiscard]] static bool loadWarningProfile(const AppOptions& options, sim::WarningProfile& profile) {
+	return sim::loadWarningProfile(options.profilesPath, options.vehicle, profile);
+}
+
+/**
+ * @brief Runs the simulation without window or audio and prints throughput.
+ */
+static int runHeadlessMode(const AppOptions& options) {
+	sim::HeadlessOptions headless;
+	headless.tickHz = options.tickHz;
+	headless.tracePath = options.tracePath;
+	headless.repeat = options.repeat;
+	headless.fleetSize = options.fleetSize;
+	headless.evaluateTrials = options.evaluateTrials;
+	headless.seed = options.seed;
+	headless.forkAt = options.forkAt;
+	headless.model = options.model;
+	headless.scenarioPath = options.scenarioPath;
+	headless.stressScene = options.stressScene;
+	headless.profilesPath = options.profilesPath;
+	headless.vehicle = options.vehicle;
+	headless.noise = options.noise;
+	headless.eventsPath = options.eventsPath;
+	headless.script = options.script;
+	headless.quantized = options.quantized;
+	headless.screenshotDir = options.screenshotDir;
+	headless.datasetPath = options.datasetPath;
+	headless.datasetSamples = options.datasetSamples;
+	return sim::runHeadlessApp(headless, sim::sharedPool());
+}
+
+
+/**
+ * @brief --render-batch: draws --render-batch n random states of the lot (car pose and
+ *        bay occupancy, a pure function of --seed and the state number) as PNG images.
+ *
+ * Every image of a pass shares one off-screen texture and one readback; a CSV of
+ * the car pose and the taken bays of each state is written next to them.
+ */
+static int runRenderBatchMode(const AppOptions& options) {
+	sim::Scene scene;
+	if (!loadScene(options, scene)) {
+		return 1;
+	}
+	std::error_code error;
+	std::filesystem::create_directories(options.batchDirectory, error);
+	std::ofstream labels(std::filesystem::path(options.batchDirectory) / "states.csv");
+	if (error || !labels) {
+		std::cerr << "Error: Failed to create batch directory " << options.batchDirectory << '\n';
+		return 1;
+	}
+	labels << "index,x,y,heading_deg,taken_bays\n";
+
+	// The lot does not change between states: built once, drawn into every cell
+	const sf::FloatRect bounds = sim::sceneBounds(scene);
+	sf::VertexArray lot(sf::PrimitiveType::Triangles);
+	const auto addQuad = [&lot](sf::Vector2f a, sf::Vector2f b, sf::Vector2f c, sf::Vector2f d, sf::Color color) {
+		for (const sf::Vector2f corner : { a, b, c, a, c, d }) {
+			lot.append({ corner, color });
+		}
+	};
+	const auto addLine = [&addQuad](sf::Vector2f from, sf::Vector2f to) {
+		const sf::Vector2f along = to - from;
+		const float length = along.length();
+		const sf::Vector2f side = (length > 0.0F)
+			? sf::Vector2f{ -along.y, along.x } * (0.5F * constants::BATCH_LINE_WIDTH / length) : sf::Vector2f{};
+		addQuad(from + side, to + side, to - side, from - side, sf::Color::White);
+	};
+	for (const sf::FloatRect& bay : scene.parkBays) {
+		const sf::Vector2f end = bay.position + bay.size;
+		addLine(bay.position, { end.x, bay.position.y });
+		addLine({ end.x, bay.position.y }, end);
+		addLine(end, { bay.position.x, end.y });
+		addLine({ bay.position.x, end.y }, bay.position);
+	}
+	for (const sim::WallSegment& wall : sim::sceneWalls(scene, bounds)) {
+		addLine(wall.from, wall.to);
+	}
+	const sim::PolygonSet& polygons = scene.polygons;
+	for (std::size_t polygon = 0U; polygon + 1U < polygons.starts.size(); ++polygon) {
+		const std::uint32_t first = polygons.starts[polygon];
+		const std::uint32_t last = polygons.starts[polygon + 1U];
+		for (std::uint32_t v = first; v < last; ++v) {
+			addLine(polygons.vertices[v], polygons.vertices[(v + 1U < last) ? v + 1U : first]);
+		}
+	}
+	for (const sim::Obstacle& obstacle : scene.obstacles) {
+		const std::size_t points = constants::BATCH_CIRCLE_POINTS;
+		for (std::size_t i = 0U; i < points; ++i) {
+			const sf::Angle from = sf::degrees(360.0F * static_cast<float>(i) / static_cast<float>(points));
+			const sf::Angle to = sf::degrees(360.0F * static_cast<float>(i + 1U) / static_cast<float>(points));
+			lot.append({ obstacle.center, sf::Color::White });
+			lot.append({ obstacle.center + sf::Vector2f(obstacle.radius, from), sf::Color::White });
+			lot.append({ obstacle.center + sf::Vector2f(obstacle.radius, to), sf::Color::White });
+		}
+	}
+
+	const sf::Context context;
+	const float aspect = bounds.size.y / bounds.size.x;
+	const sf::Vector2u tileSize{ constants::BATCH_TILE_WIDTH,
+		std::max(1U, static_cast<unsigned>(std::lround(static_cast<float>(constants::BATCH_TILE_WIDTH) * aspect))) };
+	std::atomic<std::uint64_t> failed{ 0U };
+	gfx::BatchRenderer batch;
+	const bool started = batch.start(tileSize, { constants::BATCH_PASS_SIZE, constants::BATCH_PASS_SIZE }, bounds,
+		constants::background, sim::sharedPool(), [&options, &failed](std::uint64_t index, const gfx::SoftImage& tile) {
+			char name[32];
+			std::snprintf(name, sizeof(name), "state_%06llu.png", static_cast<unsigned long long>(index));
+			if (!gfx::writePng((std::filesystem::path(options.batchDirectory) / name).string(), tile)) {
+				failed.fetch_add(1U, std::memory_order_relaxed);
+			}
+		});
+	if (!started) {
+		return 1;
+	}
+
+	// Each state's random words: counter (state, block), key from --seed
+	const sim::PhiloxKey key{ static_cast<std::uint32_t>(options.seed), static_cast<std::uint32_t>(options.seed >> 32U) };
+	constexpr float WORD_UNIT = 1.0F / 4294967296.0F;
+	sf::VertexArray bays(sf::PrimitiveType::Triangles);
+	sf::RectangleShape carShape(scene.carHalfExtent * 2.0F);
+	carShape.setOrigin(scene.carHalfExtent);
+	carShape.setFillColor(constants::batchCarColor);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::uint64_t index = 0U; index < options.batchCount; ++index) {
+		const auto low = static_cast<std::uint32_t>(index);
+		const auto high = static_cast<std::uint32_t>(index >> 32U);
+		const sim::PhiloxCounter pose = sim::philox4x32({ low, high, 0U, 0U }, key);
+		const sf::Vector2f position{ bounds.position.x + bounds.size.x * (static_cast<float>(pose[0]) * WORD_UNIT),
+			bounds.position.y + bounds.size.y * (static_cast<float>(pose[1]) * WORD_UNIT) };
+		const float headingDeg = 360.0F * (static_cast<float>(pose[2]) * WORD_UNIT);
+
+		bays.clear();
+		std::size_t taken = 0U;
+		sim::PhiloxCounter bits{};
+		for (std::size_t bay = 0U; bay < scene.parkBays.size(); ++bay) {
+			if (bay % 128U == 0U) {
+				bits = sim::philox4x32({ low, high, static_cast<std::uint32_t>(1U + bay / 128U), 0U }, key);
+			}
+			const bool occupied = ((bits[(bay % 128U) / 32U] >> (bay % 32U)) & 1U) != 0U;
+			taken += occupied ? 1U : 0U;
+			const sf::FloatRect& rect = scene.parkBays[bay];
+			const sf::Vector2f end = rect.position + rect.size;
+			const sf::Color color = occupied ? constants::transRed : constants::transGreen;
+			for (const sf::Vector2f corner : { rect.position, sf::Vector2f{ end.x, rect.position.y }, end,
+				rect.position, end, sf::Vector2f{ rect.position.x, end.y } }) {
+				bays.append({ corner, color });
+			}
+		}
+		carShape.setPosition(position);
+		carShape.setRotation(sf::degrees(headingDeg));
+		labels << index << ',' << position.x << ',' << position.y << ',' << headingDeg << ',' << taken << '\n';
+
+		batch.add(index, [&](sf::RenderTarget& target) {
+			target.draw(bays);
+			target.draw(lot);
+			target.draw(carShape);
+		});
+	}
+	batch.finish();
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const gfx::BatchStats& stats = batch.stats();
+	std::cout << "rendered: " << stats.tiles << " images (" << tileSize.x << 'x' << tileSize.y << ") in " << stats.passes
+		<< " passes of " << batch.tilesPerPass() << " -> " << options.batchDirectory
+		<< "\nimages/s: " << ((seconds > 0.0) ? static_cast<double>(stats.tiles) / seconds : 0.0)
+		<< "\nfailed: " << failed.load() << '\n';
+	return (failed.load() == 0U && labels) ? 0 : 1;
+}
+
+
+/**
+ * @brief Offline asset step: downscales, mipmaps and block-compresses a texture.
+ */
+static int runCookMode(const AppOptions& options) {
+	sf::Image image;
+	if (!image.loadFromFile(options.cookSource)) {
+		std::cerr << "Error: Failed to load image from "
+			<< std::filesystem::absolute(options.cookSource) << '\n';
+		return 1;
+	}
+
+	const gfx::CompressedTexture cooked = gfx::cookTexture(image.getPixelsPtr(), image.getSize(), options.cookScale);
+	if (!gfx::saveCompressedTexture(options.cookTarget, cooked)) {
+		std::cerr << "Error: Failed to write compressed texture to "
+			<< std::filesystem::absolute(options.cookTarget) << '\n';
+		return 1;
+	}
+
+	std::cout << "cooked: " << options.cookSource << " -> " << options.cookTarget
+		<< "\nsize: " << cooked.size().x << 'x' << cooked.size().y
+		<< "\nmip levels: " << cooked.levels.size()
+		<< "\nformat: " << ((cooked.format == gfx::BlockFormat::Bc1) ? "BC1" : "BC3") << '\n';
+	return 0;
+}
+
+
+/**
+ * @brief Offline asset step: decodes a sound once and stores it as mono PCM at the output rate.
+ */
+static int runCookSoundMode(const AppOptions& options) {
+	sf::SoundBuffer buffer;
+	if (!buffer.loadFromFile(options.cookSoundSource)) {
+		std::cerr << "Error: Failed to load sound from "
+			<< std::filesystem::absolute(options.cookSoundSource) << '\n';
+		return 1;
+	}
+
+	const audio::CookedSound cooked = audio::cookSound(buffer.getSamples(), static_cast<std::size_t>(buffer.getSampleCount()),
+		buffer.getChannelCount(), buffer.getSampleRate(), options.cookRate);
+	if (cooked.empty() || !audio::saveCookedSound(options.cookSoundTarget, cooked)) {
+		std::cerr << "Error: Failed to write cooked sound to "
+			<< std::filesystem::absolute(options.cookSoundTarget) << '\n';
+		return 1;
+	}
+
+	std::cout << "cooked: " << options.cookSoundSource << " -> " << options.cookSoundTarget
+		<< "\nrate: " << buffer.getSampleRate() << " -> " << cooked.sampleRate << " Hz"
+		<< "\nchannels: " << buffer.getChannelCount() << " -> " << cooked.channelCount
+		<< "\nsamples: " << cooked.samples.size() << '\n';
+	return 0;
+}
+
+
+/**
+ * @brief Offline asset step: packs every file under a directory into one asset pack.
+ */
+static int runPackAssetsMode(const AppOptions& options) {
+	assets::AssetPackStats stats;
+	if (!assets::writeAssetPack(options.packSource, options.packTarget, &stats)) {
+		return 1;
+	}
+
+	std::cout << "packed: " << options.packSource << " -> " << options.packTarget
+		<< "\nentries: " << stats.entries << " (" << stats.compressed << " LZ4)"
+		<< "\nbytes: " << stats.sourceBytes << " -> " << stats.packBytes << '\n';
+	return 0;
+}
+
+
+/**
+ * @brief Offline asset step: converts a text (or binary) scenario into the binary
+ *        form, or into a tiled world for streaming (--compile-world).
+ */
+static int runCompileScenarioMode(const AppOptions& options) {
+	sim::Scene scene;
+	if (!sim::loadScenario(options.compileSource, scene)) {
+		return 1;
+	}
+	const bool saved = options.compileWorld
+		? sim::saveChunkedWorld(options.compileTarget, scene, constants::WORLD_TILE_SIZE)
+		: sim::saveScenario(options.compileTarget, scene);
+	if (!saved) {
+		return 1;
+	}
+
+	std::cout << "compiled: " << options.compileSource << " -> " << options.compileTarget
+		<< "\nobstacles: " << scene.obstacles.size()
+		<< "\nbays: " << scene.parkBays.size()
+		<< "\nspawns: " << scene.spawns.size() << '\n';
+	return 0;
+}
+
+
+/**
+ * @brief --serve: runs a fleet (one car unless --fleet) in real time and streams
+ *        the changed car poses and bay flips to every connected viewer.
+ *
+ * Runs the trace --repeat times; viewers may join and leave at any point.
+ */
+static int runServeMode(const AppOptions& options) {
+	std::vector<sim::TraceSegment> trace;
+	if (options.tracePath.empty()) {
+		trace = sim::defaultInputTrace(options.tickHz);
+	}
+	else if (!sim::loadInputTrace(options.tracePath, trace)) {
+		return 1;
+	}
+
+	sim::Scene scene;
+	sim::WarningProfile profile;
+	if (!loadScene(options, scene) || !loadWarningProfile(options, profile)) {
+		return 1;
+	}
+
+	io::VisualizationServer server;
+	if (!server.listen(options.servePort)) {
+		return 1;
+	}
+
+	std::uint32_t totalTicks = 0U;
+	for (const auto& segment : trace) {
+		totalTicks += segment.ticks;
+	}
+	totalTicks *= options.repeat;
+
+	sim::SensorNoiseConfig noise = options.noise;
+	noise.seed = options.seed;
+	sim::FleetSimulation fleet(scene, trace, std::max<std::size_t>(options.fleetSize, 1U), options.tickHz, profile, options.model,
+		noise);
+	if (!options.script.empty() && !fleet.setScript(options.script)) {
+		return 1;
+	}
+	if (options.quantized) {
+		(void)fleet.setQuantized(); // a refusal is logged and keeps the grid
+	}
+	const std::uint32_t ticksPerBroadcast = std::max(1U,
+		static_cast<std::uint32_t>(std::lround(options.tickHz / constants::SERVE_BROADCAST_HZ)));
+	const auto broadcastPeriod = std::chrono::duration<double>(static_cast<double>(ticksPerBroadcast) / options.tickHz);
+
+	OKPP_LOG_INFO("Serving %zu cars on port %u", fleet.world().bodies.size(), static_cast<unsigned>(options.servePort));
+
+	// The simulation publishes one immutable frame per broadcast; the network thread pins the
+	// newest one and encodes from it in place, so neither side waits on the other
+	sim::EpochSnapshots<sim::WorldFrame> frames;
+	const std::size_t networkReader = *frames.addReader();
+	std::atomic<bool> simulationDone{ false };
+	std::thread broadcaster([&]() {
+		prof::setThreadName("serve broadcast");
+		io::WorldDeltaEncoder encoder;
+		sf::Packet delta;
+		auto nextBroadcast = std::chrono::steady_clock::now();
+		for (;;) {
+			const bool last = simulationDone.load(std::memory_order_acquire);
+			{
+				const auto frame = frames.pin(networkReader);
+				if (frame) {
+					OKPP_TRACE_SCOPE("serve broadcast");
+					if (!encoder.encode(*frame, delta)) {
+						delta.clear(); // nothing moved: new viewers still get their keyframe
+					}
+					server.broadcast(encoder, delta);
+				}
+			}
+			if (last) {
+				break;
+			}
+			nextBroadcast += std::chrono::duration_cast<std::chrono::steady_clock::duration>(broadcastPeriod);
+			std::this_thread::sleep_until(nextBroadcast);
+		}
+	});
+
+	auto nextTick = std::chrono::steady_clock::now();
+	for (std::uint32_t tick = 0U; tick < totalTicks; tick += ticksPerBroadcast) {
+		fleet.step(sim::sharedPool(), std::min(ticksPerBroadcast, totalTicks - tick));
+		sim::captureWorldFrame(fleet.world(), fleet.lot(), tick, frames.next());
+		frames.publish();
+
+		nextTick += std::chrono::duration_cast<std::chrono::steady_clock::duration>(broadcastPeriod);
+		std::this_thread::sleep_until(nextTick);
+	}
+	simulationDone.store(true, std::memory_order_release);
+	broadcaster.join();
+	frames.removeReader(networkReader);
+
+	std::cout << "car ticks: " << fleet.stats().carTicks
+		<< "\nviewers at exit: " << server.viewerCount()
+		<< "\nbytes sent: " << server.bytesSent() << '\n';
+	server.close();
+	return 0;
+}
+
+/**
+ * @brief --view: a thin viewer of a --serve simulation. Loads the same scene
+ *        (--scenario) for the pillars and bays and draws the streamed cars.
+ */
+static int runViewerMode(const AppOptions& options) {
+	sim::Scene scene;
+	if (!loadScene(options, scene)) {
+		return 1;
+	}
+
+	io::VisualizationClient client;
+	if (!client.connect(options.viewHost, options.viewPort)) {
+		return 1;
+	}
+
+	sf::RenderWindow window(
+		sf::VideoMode({ constants::WINDOW_WIDTH, constants::WINDOW_HEIGHT }),
+		"Car Parking Sensor Simulation - Viewer",
+		sf::State::Windowed
+	);
+	window.setFramerateLimit(60U);
+	window.setView(sf::View(sim::sceneBounds(scene)));
+
+	gfx::ObstacleRenderer obstacleRenderer;
+	obstacleRenderer.setObstacles(scene.obstacles);
+
+	io::WorldView view;
+	sf::VertexArray cars(sf::PrimitiveType::Triangles);
+	BayFills bays(scene.parkBays);
+	bool bayCountWarned = false;
+
+	// --heatmap: every streamed car adds the wall time it is shown at its pose
+	gfx::OccupancyHeatmap heatmap;
+	const bool heatmapOn = options.heatmapSeconds > 0.0F
+		&& heatmap.create(sim::sceneBounds(scene), constants::HEATMAP_TEXEL_SIZE, options.heatmapSeconds);
+	sf::Clock frameClock;
+
+	while (window.isOpen()) {
+		while (const std::optional event = window.pollEvent()) {
+			if (event->is<sf::Event::Closed>()) {
+				window.close();
+			}
+		}
+		if (!client.poll(view)) {
+			OKPP_LOG_INFO("Server closed the connection");
+			break;
+		}
+		if (!bayCountWarned && client.synced() && view.bayOccupied.size() != scene.parkBays.size()) {
+			OKPP_LOG_WARNING("Server has %zu bays, this scene %zu; pass the server's --scenario",
+				view.bayOccupied.size(), scene.parkBays.size());
+			bayCountWarned = true;
+		}
+
+		// Every car is one quad of the scene car rectangle, all in a single draw
+		cars.clear();
+		const sf::Vector2f half = scene.carHalfExtent;
+		const float frameSeconds = frameClock.restart().asSeconds();
+		for (const io::QuantizedPose& pose : view.cars) {
+			const sf::Transform transform = sim::carTransform(io::dequantizePose(pose));
+			if (heatmapOn && client.synced()) {
+				heatmap.splat(transform, half, frameSeconds);
+			}
+			const sf::Vector2f corners[4] = {
+				transform.transformPoint({ -half.x, -half.y }), transform.transformPoint({ half.x, -half.y }),
+				transform.transformPoint({ half.x, half.y }), transform.transformPoint({ -half.x, half.y })
+			};
+			for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+				cars.append(sf::Vertex{ corners[corner], sf::Color(60, 120, 220) });
+			}
+		}
+
+		window.clear(constants::background);
+		bays.update(view.bayOccupied);
+		window.draw(bays);
+		if (heatmapOn) {
+			heatmap.flush();
+			window.draw(heatmap);
+		}
+		window.draw(obstacleRenderer);
+		window.draw(cars);
+		window.display();
+	}
+	return 0;
+}
+
+/**
+ * @brief --relay: starts a lockstep session once --players drivers have joined
+ *        and forwards their inputs until all have left. Simulates nothing.
+ */
+static int runRelayMode(const AppOptions& options) {
+	io::LockstepRelay relay;
+	if (!relay.listen(options.relayPort, options.relayPlayers)) {
+		return 1;
+	}
+	OKPP_LOG_INFO("Relaying for %zu players on port %u", options.relayPlayers, static_cast<unsigned>(options.relayPort));
+	while (relay.poll()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	std::cout << "bytes relayed: " << relay.bytesSent() << '\n';
+	relay.close();
+	return 0;
+}
+
+/**
+ * @brief --join: drives one car of a --relay session with the keyboard. Every
+ *        peer simulates all cars from the inputs alone (LockstepSession), so
+ *        they need the same --scenario, --tick-hz and --bicycle.
+ */
+static int runJoinMode(const AppOptions& options) {
+	sim::Scene scene;
+	if (!loadScene(options, scene)) {
+		return 1;
+	}
+
+	io::LockstepPeer peer;
+	if (!peer.connect(options.joinHost, options.joinPort, sim::lockstepFingerprint(scene, options.tickHz, options.model))) {
+		return 1;
+	}
+
+	sf::RenderWindow window(
+		sf::VideoMode({ constants::WINDOW_WIDTH, constants::WINDOW_HEIGHT }),
+		"Car Parking Sensor Simulation - Lockstep",
+		sf::State::Windowed
+	);
+	window.setFramerateLimit(60U);
+	window.setView(sf::View(sim::sceneBounds(scene)));
+
+	gfx::ObstacleRenderer obstacleRenderer;
+	obstacleRenderer.setObstacles(scene.obstacles);
+
+	sf::VertexArray cars(sf::PrimitiveType::Triangles);
+	BayFills bays(scene.parkBays);
+	std::vector<std::uint8_t> bayOccupied(scene.parkBays.size(), 0U);
+	sim::BayColumns bayColumns;
+	bayColumns.assign(scene.parkBays);
+	std::vector<sf::FloatRect> carBoxes;
+
+	std::optional<sim::LockstepSession> session;
+	DrivingKeys keys;
+	const float tickDt = 1.0F / options.tickHz;
+	float accumulator = 0.0F;
+	std::uint64_t stalledTicks = 0U;
+	sf::Clock frameClock;
+
+	OKPP_LOG_INFO("Waiting for the other drivers");
+	while (window.isOpen()) {
+		while (const std::optional event = window.pollEvent()) {
+			if (event->is<sf::Event::Closed>()) {
+				window.close();
+			}
+			keys.update(*event);
+		}
+		if (!peer.poll()) {
+			OKPP_LOG_INFO("Relay closed the connection");
+			break;
+		}
+		if (!session && peer.started()) {
+			session.emplace(scene, peer.playerCount(), options.tickHz, options.model);
+			OKPP_LOG_INFO("Driving car %zu of %zu", peer.slot() + 1U, peer.playerCount());
+			frameClock.restart();
+		}
+
+		// Fixed ticks as in the single-car loop; a tick that would outrun the
+		// slowest driver's inputs waits for them instead
+		const float frameSeconds = std::min(frameClock.restart().asSeconds(), constants::MAX_FRAME_TIME);
+		if (session) {
+			peer.apply(*session);
+			accumulator += frameSeconds;
+			while (accumulator >= tickDt) {
+				if (session->nextInputTick(peer.slot()) == session->tick()) {
+					const sim::CarInput input = keys.input();
+					(void)session->addInput(peer.slot(), session->tick(), input);
+					peer.queueInput(session->tick(), input);
+				}
+				if (!session->canAdvance()) {
+					stalledTicks += static_cast<std::uint64_t>(accumulator / tickDt);
+					accumulator = 0.0F;
+					break;
+				}
+				session->advance();
+				accumulator -= tickDt;
+			}
+		}
+
+		// Every car is one quad of the scene car rectangle, all in a single draw; ours is orange
+		cars.clear();
+		const sf::Vector2f half = scene.carHalfExtent;
+		carBoxes.clear();
+		for (std::size_t player = 0U; session && player < session->playerCount(); ++player) {
+			const sim::CarState& pose = session->car(player).vehicle.pose;
+			carBoxes.push_back(sim::carBounds(pose, half));
+			const sf::Transform transform = sim::carTransform(pose);
+			const sf::Vector2f corners[4] = {
+				transform.transformPoint({ -half.x, -half.y }), transform.transformPoint({ half.x, -half.y }),
+				transform.transformPoint({ half.x, half.y }), transform.transformPoint({ -half.x, half.y })
+			};
+			const sf::Color color = (player == peer.slot()) ? sf::Color(230, 140, 40) : sf::Color(60, 120, 220);
+			for (const std::size_t corner : { 0U, 1U, 2U, 0U, 2U, 3U }) {
+				cars.append(sf::Vertex{ corners[corner], color });
+			}
+		}
+
+		std::fill(bayOccupied.begin(), bayOccupied.end(), std::uint8_t{ 0U });
+		for (const sf::FloatRect& box : carBoxes) {
+			bayColumns.markOccupied(box, bayOccupied.data());
+		}
+		bays.update(bayOccupied);
+
+		window.clear(constants::background);
+		window.draw(bays);
+		window.draw(obstacleRenderer);
+		window.draw(cars);
+		window.display();
+	}
+
+	if (session) {
+		std::cout << "ticks: " << session->tick()
+			<< "\nconfirmed ticks: " << std::min(session->confirmedTick(), session->tick())
+			<< "\nrollbacks: " << session->rollbacks()
+			<< "\nresimulated ticks: " << session->resimulatedTicks()
+			<< "\nstalled ticks: " << stalledTicks << '\n';
+	}
+	std::cout << "bytes sent: " << peer.bytesSent() << "\nbytes received: " << peer.bytesReceived() << '\n';
+	return 0;
+}
+
+
+// ===============================
+// Main Application
+// ===============================
+
+int main(int argc, char* argv[]) {
+	// Start-up phases are timed from here until the first frame is on screen
+	prof::StartupReport startup;
+
+	const AppOptions options = parseOptions(argc, argv);
+	sim::setSharedPoolThreads(options.threads);
+
+	// Written on every exit path, including exit() from deep inside SFML
+	if (!options.chromeTracePath.empty()) {
+		prof::startTracing(options.chromeTracePath);
+		prof::setThreadName("main");
+		std::atexit([]() { (void)prof::stopTracing(); });
+	}
+
+	// Messages from inside the frame loop are written by a background thread
+	logging::startLogging();
+	std::atexit([]() { logging::stopLogging(); });
+
+	// Registered after the logger, so the totals are logged before it stops
+	if (options.hwCounters && prof::startHwCounters()) {
+		std::atexit([]() { prof::logHwCounterReport(); });
+	}
+
+	if (!options.cookSource.empty()) {
+		return runCookMode(options);
+	}
+
+	if (!options.cookSoundSource.empty()) {
+		return runCookSoundMode(options);
+	}
+
+	if (!options.packSource.empty()) {
+		return runPackAssetsMode(options);
+	}
+
+	if (!options.compileSource.empty()) {
+		return runCompileScenarioMode(options);
+	}
+
+	if (options.servePort != 0U) {
+		return runServeMode(options);
+	}
+
+	if (!options.viewHost.empty()) {
+		return runViewerMode(options);
+	}
+
+	if (options.relayPort != 0U) {
+		return runRelayMode(options);
+	}
+
+	if (!options.joinHost.empty()) {
+		return runJoinMode(options);
+	}
+
+	if (options.headless) {
+		return runHeadlessMode(options);
+	}
+
+	if (!options.batchDirectory.empty()) {
+		return runRenderBatchMode(options);
+	}
+
+	// ====================================
+	// Window setup
+	// ====================================
+	// The scene is read before the window opens, so a broken --scenario or --profiles fails fast
+	const auto sceneStart = prof::StartupReport::Clock::now();
+	sim::Scene scene;
+	sim::WarningProfile warningProfile;
+	if (!loadScene(options, scene) || !loadWarningProfile(options, warningProfile)) {
+		return 1;
+	}
+
+	// --tuning: calibration values come from a watched file; it and --profiles are
+	// re-read on the job system and applied between frames
+	std::optional<sim::TuningWatcher> tuningWatcher;
+	sim::Tuning tuning;
+	std::uint64_t tuningVersion = 0U;
+	if (!options.tuningPath.empty()) {
+		tuningWatcher.emplace(sim::sharedPool(), options.tuningPath, options.profilesPath, options.vehicle);
+		if (!tuningWatcher->start()) {
+			return 1;
+		}
+		tuning = tuningWatcher->latest()->tuning;
+		tuningVersion = tuningWatcher->latest()->version;
+	}
+
+	// --world keeps only the tiles around the car resident; the first ones are
+	// loaded before the window opens so the car never starts in an empty lot
+	sim::ChunkedWorld world;
+	const bool streaming = !options.worldPath.empty();
+	if (streaming) {
+		if (!world.open(options.worldPath, constants::STREAM_LOAD_RADIUS, constants::STREAM_EVICT_RADIUS)) {
+			return 1;
+		}
+		scene.spawns = world.spawns();
+		(void)world.update(scene.spawns.front().position);
+		world.wait();
+		(void)world.update(scene.spawns.front().position);
+		scene.obstacles = world.obstacles();
+		scene.parkBays = world.bays();
+	}
+	startup.record(prof::StartupPhase::Scene, sceneStart);
+
+	// --replay drives from a recording instead of the clock and keyboard; --record captures a drive
+	// Both stream: a replay decodes one block of frames at a time, a recording writes each block as it fills
+	sim::InputRecordingReader replay;
+	const bool replaying = !options.replayPath.empty() && replay.open(options.replayPath);
+	if (!options.replayPath.empty() && !replaying) {
+		return 1;
+	}
+	std::uint64_t replayCursor = 0U;
+	sim::RecordedFrame replayFrame;
+	sim::InputRecordingWriter recorder;
+	const bool recording = !options.recordPath.empty()
+		&& recorder.open(options.recordPath, (replay.tickHz() > 0.0F) ? replay.tickHz() : options.tickHz);
+	if (!options.recordPath.empty() && !recording) {
+		return 1;
+	}
+
+	// Decoding starts before the window opens and finishes while it already runs.
+	// Cooked textures (--cook-texture) and sounds (--cook-sound) replace their PNGs and
+	// MP3s when present. An asset pack and the texture cache are declared before the
+	// loader, so they stay alive until every decode is done.
+	const std::string carSpriteName = "car_background";
+	assets::AssetPack assetPack;
+	const std::string assetPackPath = options.assetPackPath.empty() ? constants::ASSET_PACK_PATH : options.assetPackPath;
+	if ((!options.assetPackPath.empty() || std::filesystem::exists(assetPackPath))
+		&& !assetPack.open(assetPackPath) && !options.assetPackPath.empty()) {
+		return 1;
+	}
+	const assets::TextureCache textureCache(options.textureCacheDir);
+	assets::AssetLoader assetLoader;
+	assetLoader.setPack(assetPack.isOpen() ? &assetPack : nullptr);
+	assetLoader.setTextureCache(&textureCache);
+	const auto decodeStart = prof::StartupReport::Clock::now();
+	std::vector<SpriteAsset> spriteAssets = requestSpriteAssets("assets", assetPack, assetLoader);
+	for (SpriteAsset& sprite : spriteAssets) {
+		if (sprite.name == carSpriteName) {
+			sprite.displayScale = constants::CAR_SPRITE_SCALE;
+		}
+	}
+	gfx::TextureOptions atlasOptions;
+	atlasOptions.mipmap = options.mipmaps;
+	atlasOptions.srgb = options.srgb;
+	const std::string cookedBeepPath = "assets/beep.okpcm";
+	const bool cookedBeep = assetPack.contains(cookedBeepPath) || std::filesystem::exists(cookedBeepPath);
+	const std::string beepSamplePath = cookedBeep ? cookedBeepPath : "assets/beep.mp3";
+	if (options.sampleBeep && cookedBeep) {
+		assetLoader.requestCookedSound(beepSamplePath);
+	}
+	else if (options.sampleBeep) {
+		assetLoader.requestSound(beepSamplePath);
+	}
+
+	// The beep is synthesized by default; --sample-beep plays the decoded MP3 once it
+	// arrives (the synth stands in if it fails). Either way it is timed on its own audio thread,
+	// which opens the audio device only when the first beep is due.
+	// --latency-probe: every driving key press (one at a time) is followed through the
+	// tick that consumes it to a beep played at once; not with --replay, whose input
+	// does not come from the keys
+	prof::LatencyProbe latencyProbe;
+	const bool latencyProbing = options.latencyProbe && !replaying;
+	prof::LatencyProbe* const beepLatency = latencyProbing ? &latencyProbe : nullptr;
+	std::optional<audio::BeepScheduler> beeps;
+	if (!options.sampleBeep) {
+		beeps.emplace(nullptr, &startup, beepLatency);
+	}
+
+	// --telemetry: the frame loop only queues records; batching and sending run on their own thread
+	io::TelemetryPublisher telemetry;
+	const bool telemetryOn = !options.telemetryHost.empty() && telemetry.start(options.telemetryHost, options.telemetryPort);
+	// --telemetry-log: the same records, appended where they are made; a full block is written on the way
+	io::BlockLogWriter telemetryLog;
+	const bool telemetryLogging = !options.telemetryLogPath.empty()
+		&& telemetryLog.open(options.telemetryLogPath, io::BLOCK_LOG_TELEMETRY, io::TELEMETRY_LOG_FIELDS);
+	// --occupancy-port: the frame loop only marks the bays that flipped; queries are answered on the server's thread
+	io::OccupancyServer occupancyServer;
+	const bool occupancyServing = options.occupancyPort != 0U
+		&& occupancyServer.start(options.occupancyPort, scene.parkBays);
+
+	const auto windowStart = prof::StartupReport::Clock::now();
+	sf::ContextSettings windowSettings;
+	windowSettings.sRgbCapable = options.srgb; // sRGB pages are only linear-correct on an sRGB framebuffer
+	sf::RenderWindow window(
+		sf::VideoMode({ constants::WINDOW_WIDTH, constants::WINDOW_HEIGHT }),
+		"Car Parking Sensor Simulation - Task 2",
+		sf::State::Windowed,
+		windowSettings
+	);
+	if (options.vsync) {
+		window.setVerticalSyncEnabled(true);
+	}
+	else if (options.pacerHz <= 0.0) {
+		window.setFramerateLimit(60U);
+	}
+	startup.record(prof::StartupPhase::Window, windowStart);
+
+	// --pacer: drawFrame() waits right before presenting; with --vsync the blocking present
+	// finishes the wait and the pacer's grid follows the refreshes it returns at
+	prof::FramePacerSettings pacerSettings;
+	pacerSettings.rateHz = options.pacerHz;
+	pacerSettings.spin = constants::PACER_SPIN;
+	pacerSettings.alignToPresent = options.vsync;
+	prof::FramePacer pacer(pacerSettings);
+	const bool pacing = options.pacerHz > 0.0;
+
+
+
+
+	// Simulation records first; the drawables are derived from them
+	const auto obstacleSetupStart = prof::StartupReport::Clock::now();
+	const std::vector<sim::Obstacle>& obstacles = scene.obstacles;
+
+	// All pillars are tessellated into one static vertex buffer (one draw call)
+	gfx::ObstacleRenderer obstacleRenderer;
+
+	// Optional instanced path: obstacles and sensor wedges share one instance buffer
+	gfx::InstancedRenderer instancedRenderer;
+	const bool useInstanced = options.instanced && instancedRenderer.init();
+	if (options.instanced && !useInstanced) {
+		std::cerr << "Warning: instanced rendering unavailable, using the SFML renderer\n";
+	}
+	// With it, bay fills are instanced too: one state byte per bay, colored by a palette uniform
+	gfx::PaletteRectRenderer bayRenderer;
+	const bool usePaletteBays = useInstanced && bayRenderer.init();
+	bayRenderer.setPalette(std::data(constants::bayPalette), std::size(constants::bayPalette));
+
+	// The vehicle profile's rig (or the built-in corners) fixes how many sensors the car carries;
+	// a trailer's rig follows them
+	const sim::TrailerParams trailerParams;
+	const std::size_t carSensorCount = sim::createSensorPoses(warningProfile.rig()).size();
+	const std::size_t sensorCount = carSensorCount
+		+ (options.trailer ? sim::createSensorPoses(sim::defaultTrailerRig()).size() : 0U);
+
+	// Optional tiled path for the largest lots: pillars drawn tile by tile, culled and
+	// recorded on the job system, from buffers that stay mapped
+	gfx::TileRenderer tileRenderer;
+	const bool useTiled = options.tiled && !useInstanced && tileRenderer.init(sensorCount);
+	if (options.tiled && !useTiled) {
+		std::cerr << "Warning: tiled rendering unavailable (OpenGL 4.4, not with --instanced), "
+			"using the " << (useInstanced ? "instanced" : "SFML") << " renderer\n";
+	}
+
+	// Minimap: its tile atlas is created on the first M press
+	gfx::Minimap minimap;
+	bool showMinimap = false;
+
+	// --work-budget: lazy work runs on the drawing thread after each display, within the budget;
+	// what does not fit waits for the next frame, or goes to the worker pool if it may
+	sim::BudgetedWork backgroundWork(&sim::sharedPool());
+	const bool workBudgeted = options.workBudgetUs > 0U;
+	const std::chrono::microseconds workBudget{ options.workBudgetUs };
+	bool minimapWorkQueued = false;
+	minimap.setDeferred(workBudgeted); // its stale tiles become budgeted work
+
+	// Sensor cone overlay (F); the shader is compiled on the first press
+	gfx::SensorField sensorField;
+	bool showSensorField = false;
+
+	// Per-sensor distance and beep interval labels (H); the glyph atlas is built on the first press
+	gfx::HudText sensorLabels;
+	bool showSensorLabels = false;
+
+	// Reversing guide lines: one stream buffer, rewritten in place while the car backs up
+	gfx::GuideLines guideLines;
+	guideLines.create();
+
+	// Static obstacles: the spatial index is only rebuilt when the obstacle set changes
+	sim::ObstacleGrid obstacleGrid;
+	sim::ObstacleClusters obstacleClusters;
+
+	// Ray-cast sensing hits the pillar outlines rather than their centers
+	sim::RayCaster rayCaster;
+
+	// The pillars never move: bake their distance field once, or reuse the cached bake.
+	// A streamed world has no fixed obstacle set to bake.
+	sim::DistanceField distanceField;
+	const bool useField = !options.sdfPath.empty() && !streaming;
+	if (!options.sdfPath.empty() && streaming) {
+		std::cerr << "Warning: --sdf is not supported with --world, using the obstacle grid\n";
+	}
+	const sf::Vector2f fieldMargin{ constants::BEEP_MAX_RANGE, constants::BEEP_MAX_RANGE };
+	const sf::FloatRect fieldBounds{ -fieldMargin,
+		sf::Vector2f{ constants::WORLD_WIDTH, constants::WORLD_HEIGHT } + fieldMargin * 2.0F };
+	if (useField) {
+		distanceField.loadOrBake(obstacles, fieldBounds, constants::SDF_CELL_SIZE, options.sdfPath);
+	}
+
+	// The map only knows what the sensor rays have hit so far; its window follows the car
+	sim::OccupancyMap occupancyMap(constants::OCCUPANCY_CELL_SIZE, constants::OCCUPANCY_TILES);
+	const bool castRays = options.raycast || options.mapping;
+
+	// --ttc: candidates near the car are gathered from the obstacle grid and reused while it stays close
+	sim::CollisionPredictor collisionPredictor;
+	const std::vector<sim::TtcBand> ttcBands = sim::defaultTtcBands();
+	std::vector<float> timeToCollision;
+
+	// One warning state per sensor from the readings, the --mapping echoes and the TTC;
+	// the beeps, the indicators and the labels all read it
+	sim::SensorFusion sensorFusion({ tuning.dangerThreshold, tuning.warningThreshold });
+	sim::FusedWarnings fused;
+	std::vector<float> echoesSq;
+
+	ObstacleSensing sensing;
+	sensing.grid = &obstacleGrid;
+	sensing.clusters = &obstacleClusters;
+	sensing.rayCaster = options.raycast ? &rayCaster : nullptr;
+	sensing.field = useField ? &distanceField : nullptr;
+	sensing.occupancy = options.mapping ? &occupancyMap : nullptr;
+	sensing.obstacles = &obstacles;
+
+	// --sensor-cache: a reused reading is off by at most the tolerance (twice that for
+	// a pillar that stopped being the nearest); forgotten on every rebuild
+	sim::SensorQueryCache sensorCache;
+	sensorCache.setTolerance(options.sensorCache);
+	if (options.sensorCache > 0.0F) {
+		sensing.cache = &sensorCache;
+	}
+
+	// --gpu-sensors: dispatched from the thread holding the GL context, so neither with
+	// --pipelined nor --render-thread; the occupancy map has no GPU counterpart
+	gfx::GpuSensorQuery gpuSensorQuery;
+	const bool useGpuSensors = options.gpuSensors && !options.pipelined && !options.renderThread
+		&& !options.mapping && gpuSensorQuery.create();
+	if (options.gpuSensors && !useGpuSensors) {
+		std::cerr << "Warning: GPU sensor queries unavailable (OpenGL 4.3, no --pipelined, --render-thread or --mapping), "
+			"using the CPU sensor pass\n";
+	}
+	sensing.gpu = useGpuSensors ? &gpuSensorQuery : nullptr;
+
+	// --nearest / N: the engine answering the nearest pillars, by default the one the other
+	// options ask for. The store and BVH are built on first use and again after a rebuild or
+	// edit; a choice made while a frame simulates is applied between sync and launch.
+	// --nearest-compare / B: every engine on each pass, timed and checked in F3
+	sim::NearestEngines nearestEngines;
+	nearestEngines.setGrid(&obstacleGrid);
+	nearestEngines.setField(useField ? &distanceField : nullptr);
+	sensing.engines = &nearestEngines;
+	const auto nearestAvailable = [&](sim::NearestBackend backend) {
+		return (backend != sim::NearestBackend::Field || useField) && (backend != sim::NearestBackend::Gpu || useGpuSensors);
+	};
+	sim::NearestBackend nearestBackend = useField ? sim::NearestBackend::Field
+		: (useGpuSensors ? sim::NearestBackend::Gpu : sim::NearestBackend::Grid);
+	if (options.nearest && nearestAvailable(*options.nearest)) {
+		nearestBackend = *options.nearest;
+	}
+	else if (options.nearest) {
+		std::cerr << "Warning: --nearest " << sim::nearestBackendName(*options.nearest) << " needs "
+			<< (*options.nearest == sim::NearestBackend::Field ? "--sdf" : "GPU sensor queries") << ", using "
+			<< sim::nearestBackendName(nearestBackend) << '\n';
+	}
+	sensing.backend = nearestBackend;
+	sim::NearestComparison nearestComparison;
+	std::vector<sim::SensorReading> nearestComparisonReadings;
+	sensing.comparisonReadings = &nearestComparisonReadings;
+	bool compareNearest = options.nearestCompare;
+
+	// The car is stopped by the pillars; rebuilt with the rest of the static scene
+	sim::CollisionWorld collisionWorld;
+
+	// Occupancy goes through the lot index; the default scene has a single bay
+	sim::ParkingLot parkingLot;
+	parkingLot.setHysteresis(constants::PARK_HYSTERESIS);
+	std::uint32_t parkingCar = 0U;
+	std::uint64_t sceneVersion = 0U;     // bumped whenever the obstacles, bays or warning profile are replaced
+
+	// What each simulated frame changed. The audio hand-off and telemetry read it right
+	// after the frame is sealed; the draw side reads the frames it is shown
+	sim::EventChannel worldEvents;
+	sim::EventCursor audioEvents(sim::eventMask(sim::WorldEventKind::SensorsRead));
+	sim::EventCursor telemetryEvents(~0U);
+	bool beepsPending = false;       // the last beep frame was dropped, or a scheduler has just started
+	std::uint32_t telemetryTick = 0U; // tick of the last telemetry record
+
+	// Park indicators: only bays inside the camera view are drawn, however large the lot is.
+	// Their quads are rebuilt only when a bay flips state or the visible set changes.
+	std::vector<std::uint32_t> visibleBays;
+	bool indicatorsDirty = true;
+	bool operatorBaysDirty = true; // --operator-view shows every bay
+	constexpr float PARK_OUTLINE_THICKNESS = 2.0F;
+	bool sensorInstancesStale = true; // the sensor instances must be rebuilt even without a sensor pass
+
+	// Pillars and bay outlines never change between rebuilds: they are cached in a
+	// render texture. The instanced and tiled paths draw pillars and sensors on the GPU instead.
+	gfx::StaticLayer staticLayer;
+	const bool useStaticLayer = !useInstanced && !useTiled
+		&& staticLayer.create(window.getSize(), constants::STATIC_LAYER_MARGIN);
+
+	// The lot the camera stays in; its sides are the boundary walls the sensors see
+	const sf::FloatRect cameraBounds = streaming ? world.bounds() : sim::sceneBounds(scene);
+
+	// Rebuilds everything derived from the obstacles and bays: once at start-up,
+	// then whenever streaming changes the resident tiles or an edit cannot be applied in place
+	float pillarMaxRadius = 0.0F;
+	const auto rebuildStaticScene = [&]() {
+		OKPP_TRACE_SCOPE("rebuild static scene");
+		pillarMaxRadius = 0.0F;
+		for (const auto& obstacle : obstacles) {
+			pillarMaxRadius = std::max(pillarMaxRadius, obstacle.radius);
+		}
+		obstacleRenderer.setObstacles(obstacles);
+		const std::vector<sim::WallSegment> walls = sim::sceneWalls(scene, cameraBounds);
+		obstacleGrid.build(sim::obstacleCenters(obstacles), constants::OBSTACLE_CELL_SIZE, walls, scene.polygons);
+		obstacleClusters.build(obstacles, walls, scene.polygons);
+		collisionWorld.build(obstacles, {}, constants::OBSTACLE_CELL_SIZE);
+		collisionPredictor.invalidate();
+		sensorCache.invalidate();
+		nearestEngines.invalidate();
+		if (castRays) {
+			rayCaster.build(obstacles, {}, constants::OBSTACLE_CELL_SIZE, scene.polygons);
+		}
+		if (useGpuSensors) {
+			gpuSensorQuery.setObstacles(obstacles, constants::OBSTACLE_CELL_SIZE);
+		}
+
+		// Sensor wedges sit after the static obstacles in the instance buffer
+		if (useInstanced) {
+			std::vector<gfx::CircleInstance> instances;
+			instances.reserve(obstacles.size() + sensorCount);
+			for (const auto& obstacle : obstacles) {
+				instances.push_back(gfx::makeObstacleInstance(obstacle, sf::Color::White));
+			}
+			instances.resize(obstacles.size() + sensorCount);
+			instancedRenderer.upload(instances);
+			sensorInstancesStale = true; // the wedges were reset with the buffer
+		}
+		if (useTiled) {
+			tileRenderer.setObstacles(obstacles, constants::WORLD_TILE_SIZE, sf::Color::White);
+		}
+		minimap.setScene(obstacles, scene.parkBays);
+
+		parkingLot.setBays(scene.parkBays, 0.0F);
+		if (occupancyServing) {
+			occupancyServer.setBays(scene.parkBays);
+		}
+		if (usePaletteBays) {
+			bayRenderer.setRects(scene.parkBays); // states follow the BaysReplaced event below
+		}
+		parkingCar = parkingLot.addCar();
+		worldEvents.publish(sim::WorldEventKind::BaysReplaced, static_cast<std::uint32_t>(scene.parkBays.size()));
+		staticLayer.invalidate();
+		indicatorsDirty = true;
+		operatorBaysDirty = true;
+		++sceneVersion;
+	};
+	rebuildStaticScene();
+	startup.record(prof::StartupPhase::ObstacleSetup, obstacleSetupStart);
+
+	// Scenario editor (E): an edit updates the grid, clusters, collision world, pillar
+	// geometry, distance field, bays and static layer for the edited area only. The ray
+	// caster, the GPU query and the instanced and tiled pillars have no partial update:
+	// with one of them on, an edit rebuilds the static scene instead.
+	gfx::ScenarioEditor sceneEditor(constants::OBSTACLE_RADIUS, { constants::PARK_WIDTH, constants::PARK_HEIGHT });
+	sim::FrameArena editorArena; // bay picks; the draw and simulation arenas may be in use on other threads
+	const bool partialEdits = !castRays && !useGpuSensors && !useInstanced && !useTiled;
+	bool minimapStale = false; // the minimap is redrawn once the held item is let go
+	const auto applySceneEdit = [&](const gfx::SceneEdit& edit) {
+		OKPP_TRACE_SCOPE("apply scene edit");
+		const auto unite = [](const sf::FloatRect& a, const sf::FloatRect& b) {
+			const sf::Vector2f low{ std::min(a.position.x, b.position.x), std::min(a.position.y, b.position.y) };
+			const sf::Vector2f high{ std::max(a.position.x + a.size.x, b.position.x + b.size.x),
+				std::max(a.position.y + a.size.y, b.position.y + b.size.y) };
+			return sf::FloatRect{ low, high - low };
+		};
+		const auto grow = [](const sf::FloatRect& area, float by) {
+			return sf::FloatRect{ area.position - sf::Vector2f{ by, by }, area.size + sf::Vector2f{ 2.0F * by, 2.0F * by } };
+		};
+		const auto circleArea = [](const sim::Obstacle& circle) {
+			return sf::FloatRect{ circle.center - sf::Vector2f{ circle.radius, circle.radius },
+				{ 2.0F * circle.radius, 2.0F * circle.radius } };
+		};
+		minimapStale = true;
+		++sceneVersion;
+
+		if (edit.kind == gfx::SceneEdit::Kind::MovePillar || edit.kind == gfx::SceneEdit::Kind::AddPillar) {
+			const bool adding = edit.kind == gfx::SceneEdit::Kind::AddPillar;
+			if (adding) {
+				scene.obstacles.push_back(edit.pillarAfter);
+			}
+			else {
+				scene.obstacles[edit.index] = edit.pillarAfter;
+			}
+			pillarMaxRadius = std::max(pillarMaxRadius, edit.pillarAfter.radius);
+			const sf::FloatRect touched = adding ? circleArea(edit.pillarAfter)
+				: unite(circleArea(edit.pillarBefore), circleArea(edit.pillarAfter));
+			const bool inPlace = partialEdits
+				&& (adding ? obstacleGrid.insertObstacle(edit.pillarAfter.center)
+					: obstacleGrid.moveObstacle(edit.index, edit.pillarBefore.center, edit.pillarAfter.center))
+				&& obstacleClusters.cover(edit.pillarAfter)
+				&& collisionWorld.setCircle(edit.index, edit.pillarAfter)
+				&& obstacleRenderer.setObstacle(edit.index, edit.pillarAfter);
+			if (inPlace) {
+				collisionPredictor.invalidate();
+				sensorCache.invalidate();
+				nearestEngines.invalidate();
+				staticLayer.invalidate(grow(touched, 2.0F));
+			}
+			else {
+				rebuildStaticScene();
+			}
+			// Readings reach BEEP_MAX_RANGE; two more cells keep the interpolation exact there
+			if (useField && !distanceField.rebake(obstacles, obstacleGrid, touched,
+				constants::BEEP_MAX_RANGE + 2.0F * constants::SDF_CELL_SIZE, pillarMaxRadius))
+			{
+				distanceField.bake(obstacles, fieldBounds, constants::SDF_CELL_SIZE);
+			}
+			return;
+		}
+
+		const bool adding = edit.kind == gfx::SceneEdit::Kind::AddBay;
+		if (adding) {
+			scene.parkBays.push_back(edit.bayAfter);
+			(void)parkingLot.addBay(edit.bayAfter);
+		}
+		else {
+			scene.parkBays[edit.index] = edit.bayAfter;
+			parkingLot.moveBay(edit.index, edit.bayAfter);
+		}
+		if (occupancyServing) {
+			occupancyServer.setBays(scene.parkBays);
+		}
+		if (usePaletteBays) {
+			bayRenderer.setRects(scene.parkBays);
+		}
+		// The drawn states restart from the lot's, which kept every car
+		worldEvents.publish(sim::WorldEventKind::BaysReplaced, static_cast<std::uint32_t>(scene.parkBays.size()));
+		for (std::uint32_t bay = 0U; bay < parkingLot.bayCount(); ++bay) {
+			if (parkingLot.occupied(bay)) {
+				worldEvents.publish(sim::WorldEventKind::BayChanged, bay, 1U);
+			}
+		}
+		staticLayer.invalidate(grow(adding ? edit.bayAfter : unite(edit.bayBefore, edit.bayAfter), PARK_OUTLINE_THICKNESS + 1.0F));
+		indicatorsDirty = true;
+		operatorBaysDirty = true;
+	};
+
+	// ====================================
+	// Resource setup
+	// ====================================
+
+	// Scene sprites and indicators share the atlas pages and draw as one batch.
+	// Until the sprites arrive the atlas only holds its white region.
+	gfx::TextureAtlas spriteAtlas;
+	(void)spriteAtlas.build({});
+	gfx::SpriteBatch spriteBatch(spriteAtlas);
+	gfx::SpriteBatch indicatorBatch(spriteAtlas); // park indicators, kept between frames
+	gfx::SpriteBatch staticBatch(spriteAtlas);    // bay outlines for the static layer
+	bool spritesReady = false;
+
+	// The car appears once its atlas region exists; the placement carries its transform
+	const gfx::AtlasRegion* carRegion = nullptr;
+	sf::Transformable carPlacement;
+	float placedHeadingDeg = std::numeric_limits<float>::quiet_NaN(); // the rotation carPlacement was last given
+	bool carPlaced = false;
+
+	// Simulated car pose; the sprite mirrors an interpolated copy of it.
+	// Until the texture arrives the car uses the nominal extent from Constants.hpp.
+	sf::Vector2f carHalfExtent{ constants::CAR_HALF_WIDTH, constants::CAR_HALF_HEIGHT };
+	sim::CarParams carParams{ tuning.carSpeed, tuning.carTurnRate };
+	const sim::BicycleParams bicycleParams;
+	sim::CarState car = scene.spawns.front();
+	sim::CarState previousCar = car;
+	sim::BicycleState bicycle{ car, 0.0F, 0.0F }; // speed and steering under --bicycle
+
+	// Bounds and sensor anchors of the car, rebuilt once per pose change and read by every consumer
+	sim::VehiclePose vehiclePose(carHalfExtent, sim::createSensorMounts(carHalfExtent, warningProfile.rig()),
+		sim::createSensorPoses(warningProfile.rig()));
+	vehiclePose.setPose(car);
+	sim::CarState trailer = sim::trailerBehind(car, carHalfExtent, trailerParams); // --trailer: towed body
+	sim::CarState previousTrailer = trailer;
+	if (options.trailer) {
+		vehiclePose.setTrailer(trailerParams, sim::createSensorMounts(trailerParams.halfExtent, sim::defaultTrailerRig()),
+			sim::createSensorPoses(sim::defaultTrailerRig()));
+	}
+	// Sensor indicators: one state byte per sensor; the instances are rewritten
+	// only when a state changes or the rig moves
+	std::vector<std::uint8_t> sensorStates(vehiclePose.sensors().size(), constants::SENSOR_CLEAR);
+	std::vector<gfx::CircleInstance> sensorInstances(vehiclePose.sensors().size());
+
+	// --noise, --dropout, --latency: every sensor pass is perturbed before the beeps see it
+	sim::SensorNoiseConfig noiseConfig = options.noise;
+	noiseConfig.seed = options.seed;
+	sim::SensorNoise sensorNoise;
+	sensorNoise.configure(noiseConfig, vehiclePose.sensors().size());
+	std::uint64_t sensorPass = 0U; // the noise counter, one per sensor pass
+
+	// The last full sensor pass: a car still standing where it was measured, over the
+	// same scene, reads and rates the same again, so a parked car skips the pass
+	std::vector<sim::SensorReading> sensedReadings;
+	std::vector<float> sensedIntervals;
+	std::vector<std::uint8_t> sensedLevels;
+	std::uint64_t sensedPoseVersion = std::numeric_limits<std::uint64_t>::max();
+	std::uint64_t sensedSceneVersion = 0U;
+	bool sensedStill = false;
+
+
+
+	// Start-up progress: a thin bar along the bottom edge until every asset has arrived
+	sf::RectangleShape loadingBar({ 0.0F, 6.0F });
+	loadingBar.setFillColor(sf::Color(90, 160, 255));
+	loadingBar.setPosition({ 0.0F, static_cast<float>(constants::WINDOW_HEIGHT) - 6.0F });
+
+	// Per-phase frame timers: F3 toggles the overlay, F4 dumps the history to CSV
+	prof::FrameProfiler profiler;
+	gfx::ProfilerOverlay profilerOverlay;
+	bool showProfiler = false;
+	std::size_t stressFrames = 0U; // --stress: frames since the last timing line
+
+	// --quality-governor: the CPU work of each frame picks the next frame's optional work.
+	// The simulation reads the cone rays between sync and launch, drawFrame() its own
+	// copy of the knobs, taken once the render thread is done with the previous frame
+	gfx::QualitySettings qualitySettings;
+	qualitySettings.targetMs = options.qualityGovernorMs;
+	qualitySettings.fullConeRays = constants::SENSOR_CONE_RAYS;
+	gfx::QualityGovernor qualityGovernor(qualitySettings);
+	gfx::QualityKnobs drawQuality = qualityGovernor.knobs();
+	std::uint64_t drawnFrames = 0U;
+	float heatmapDt = 0.0F; // frame time not yet splatted into the heatmap
+
+	// --alloc-check: each pass of the loop below, idle waits excluded, is one frame
+	prof::AllocationCheckSettings allocCheckSettings;
+	allocCheckSettings.warmupFrames = constants::ALLOC_CHECK_WARMUP_FRAMES;
+	allocCheckSettings.trap = options.allocTrap;
+	prof::FrameAllocationCheck allocCheck(allocCheckSettings);
+	if (options.allocCheck && !prof::allocationHooksActive()) {
+		OKPP_LOG_WARNING("Warning: --alloc-check sees no allocations in this build (configure with OKPP_ALLOC_CHECK=ON)");
+	}
+
+	// The camera follows the car inside the lot; overlays keep the default view
+	sf::View camera = window.getDefaultView();
+
+	// --movers: moving obstacles step with the car; the loose grid follows them without rebuilds
+	sim::MovingObstacles movingObstacles;
+	movingObstacles.reset(cameraBounds, constants::MOVER_CELL_SIZE);
+	if (options.movers) {
+		movingObstacles.spawnScene(scene);
+	}
+	// Movers get as many rim points as their on-screen size needs, up to SFML's default
+	sf::CircleShape moverShape;
+	constexpr std::size_t MOVER_MAX_POINTS = 30U;
+
+	// --heatmap: the drawn car adds each frame's simulated time under its footprint
+	gfx::OccupancyHeatmap heatmap;
+	const bool heatmapOn = options.heatmapSeconds > 0.0F
+		&& heatmap.create(cameraBounds, constants::HEATMAP_TEXEL_SIZE, options.heatmapSeconds);
+
+	// Held driving keys, updated from the event loop below
+	DrivingKeys drivingKeys;
+
+	// --capture: frames are read back asynchronously and written by an encoder thread
+	gfx::FrameCapture capture;
+	const bool capturing = !options.captureDirectory.empty()
+		&& capture.start(options.captureDirectory, options.captureFormat, window.getSize());
+
+	// --camera-feed: the test card stands in for a camera; frames are written straight
+	// into mapped pixel buffers and uploaded from there by whichever thread draws
+	gfx::CameraFeed cameraFeed;
+	const bool cameraFeedOn = options.cameraFeed
+		&& cameraFeed.start(constants::CAMERA_FEED_SIZE, constants::CAMERA_FEED_FPS, gfx::testCardSource());
+	const sf::Vector2f cameraFeedMargin{ constants::CAMERA_FEED_MARGIN, constants::CAMERA_FEED_MARGIN };
+	cameraFeed.setArea({ sf::Vector2f(window.getSize()) - constants::CAMERA_FEED_INSET - cameraFeedMargin,
+		constants::CAMERA_FEED_INSET });
+
+	// --render-scale / --dynamic-resolution: the world layers draw into a smaller texture that is
+	// upscaled and sharpened once; the screen layer still draws at window resolution on top
+	// --rain / --night: drawn by the same pass that copies the scene texture to the window, so
+	// they need that texture (at scale 1 without --render-scale); off, no target is made for them
+	gfx::SceneEffects sceneEffects;
+	gfx::EffectSettings effectSettings;
+	effectSettings.rain = options.rain;
+	effectSettings.night = options.night;
+	effectSettings.tier = options.effectsTier;
+	const bool effectsOn = effectSettings.enabled() && sceneEffects.create(effectSettings);
+	if (effectsOn) {
+		OKPP_LOG_INFO("Scene effects: %u rain layers, %u lights per pixel", sceneEffects.budget().rainLayers,
+			sceneEffects.budget().maxLights);
+	}
+	gfx::RenderScaler renderScaler;
+	const bool scaling = (options.renderScale < 1.0F || options.dynamicResolutionMs > 0.0F || effectsOn)
+		&& renderScaler.create(window.getSize(), options.renderScale);
+	gfx::ResolutionSettings resolutionSettings;
+	resolutionSettings.targetMs = options.dynamicResolutionMs;
+	resolutionSettings.minScale = std::min(resolutionSettings.minScale, options.renderScale);
+	gfx::DynamicResolution dynamicResolution(resolutionSettings, options.renderScale);
+	gfx::GpuFrameTimer gpuFrameTimer;
+	if (scaling && options.dynamicResolutionMs > 0.0F) {
+		(void)gpuFrameTimer.create();
+	}
+
+	// --adaptive, --on-demand: set when a frame changed nothing, so the next one waits for an event
+	bool idle = false;
+
+	// --operator-view: opened last, then the driver window's context is made current
+	// again, since the raw OpenGL paths above expect it
+	gfx::OperatorView operatorView;
+	if (options.operatorView) {
+		if (!operatorView.open(cameraBounds, constants::OPERATOR_WINDOW_WIDTH)) {
+			std::cerr << "Warning: the operator view could not be opened\n";
+		}
+		(void)window.setActive(true);
+	}
+
+
+
+	// ====================================
+	// Main loop
+	// ====================================
+	sf::Clock clock;
+	sf::Clock replayClock;
+	const float tickDt = 1.0F / ((replay.tickHz() > 0.0F) ? replay.tickHz() : options.tickHz);
+	float accumulator = 0.0F;
+	std::uint32_t simTick = 0U; // fixed ticks so far, stamped on telemetry records
+
+	// Scratch lists that live one frame (bay queries, collision candidates) come
+	// from linear arenas instead of the heap: one reset at the start of every
+	// simulated frame, which --pipelined runs on a worker, one at the start of
+	// every draw, which --render-thread runs on its own thread
+	sim::FrameArena drawArena;
+	sim::FrameArena simArena;
+
+	// P plans a path into the first bay on the job system; once it arrives the plan
+	// drives the car tick by tick until it ends or a driving key takes over. Plans
+	// replay exactly only with the arcade model, which stands still without input.
+	sim::PlannerConfig plannerConfig;
+	plannerConfig.car = carParams;
+	plannerConfig.tickDt = tickDt;
+	sim::AsyncParkingPlanner parkPlanner(sim::sharedPool(), plannerConfig);
+	sim::PlannedPath parkPath;
+	std::size_t parkCursor = 0U;
+	bool autoParking = false;
+	bool parkRequested = false;
+	sf::VertexArray parkPathLine(sf::PrimitiveType::LineStrip);
+
+	// Polygon islands and curbs never move: their outlines are built once
+	sf::VertexArray polygonOutlines(sf::PrimitiveType::Lines);
+	for (std::size_t polygon = 0U; polygon < scene.polygons.size(); ++polygon) {
+		const std::uint32_t first = scene.polygons.starts[polygon];
+		const std::uint32_t last = scene.polygons.starts[polygon + 1U];
+		for (std::uint32_t v = first; v < last; ++v) {
+			polygonOutlines.append(sf::Vertex{ scene.polygons.vertices[v], sf::Color::White });
+			polygonOutlines.append(sf::Vertex{ scene.polygons.vertices[(v + 1U < last) ? v + 1U : first], sf::Color::White });
+		}
+	}
+
+	// One frame of simulation: the fixed ticks, the sensor pass with its beeps and
+	// the bay occupancy. Under --pipelined it runs on a pool worker while the
+	// previous frame is drawn; the main thread touches the state it uses only
+	// between pipeline.sync() and pipeline.launch().
+	const auto simulateFrame = [&](FrameSnapshot& frame) {
+		simArena.reset();
+		frame.phases = {};
+		sim::CarInput drivenInput = frame.input; // the last tick's, planned paths included
+		{
+			const prof::ScopedPhase phase(frame.phases, prof::Phase::Simulation);
+			accumulator += frame.frameDt;
+			while (accumulator >= tickDt) {
+				previousCar = car;
+				sim::CarInput tickInput = frame.input;
+				if (latencyProbing && frame.input != 0U) {
+					(void)latencyProbe.stamp(prof::LatencyStage::Tick);
+				}
+				if (autoParking) {
+					if (frame.input != 0U || parkCursor >= parkPath.inputs.size()) {
+						autoParking = false;
+					}
+					else {
+						tickInput = parkPath.inputs[parkCursor++];
+					}
+				}
+				drivenInput = tickInput;
+				if (options.model == sim::VehicleModel::Bicycle) {
+					(void)sim::stepBicycleWithCollisions(bicycle, tickInput, bicycleParams, tickDt, collisionWorld, carHalfExtent,
+						simArena, &vehiclePose.hull());
+					car = bicycle.pose;
+				}
+				else {
+					(void)sim::stepCarWithCollisions(car, tickInput, carParams, tickDt, collisionWorld, carHalfExtent, simArena,
+						&vehiclePose.hull());
+				}
+				if (options.trailer) {
+					previousTrailer = trailer;
+					sim::stepTrailer(trailer, car, carHalfExtent, trailerParams);
+				}
+				movingObstacles.step(tickDt);
+				accumulator -= tickDt;
+				++simTick;
+			}
+			vehiclePose.setPose(car); // only the last tick's pose is sensed and drawn
+			if (options.trailer) {
+				vehiclePose.setTrailerPose(trailer);
+			}
+		}
+
+		// Stationary over an unchanged scene: the last pass still holds. Not with movers,
+		// noise or the mapping and GPU passes, whose results change without the car moving
+		const bool still = previousCar.position == car.position && previousCar.headingDeg == car.headingDeg
+			&& previousTrailer.position == trailer.position && previousTrailer.headingDeg == trailer.headingDeg;
+		const bool stationary = still && sensedStill && vehiclePose.version() == sensedPoseVersion
+			&& sceneVersion == sensedSceneVersion && movingObstacles.movers().empty() && !sensorNoise.enabled()
+			&& !options.mapping && !sensing.onGpu();
+		if (!still) {
+			worldEvents.publish(sim::WorldEventKind::CarMoved, parkingCar);
+		}
+		{
+			const prof::ScopedPhase phase(frame.phases, prof::Phase::Beep);
+			if (stationary) {
+				frame.sensorReadings = sensedReadings;
+				frame.beepIntervals = sensedIntervals;
+				frame.sensorLevels = sensedLevels;
+			}
+			else {
+				if (options.mapping) {
+					occupancyMap.recenter(car.position);
+					sim::mapSensors(vehiclePose.sensors(), rayCaster,
+						{ constants::SENSOR_CONE_HALF_ANGLE, sensing.coneRays, warningProfile.range() }, occupancyMap,
+						&echoesSq);
+				}
+				readSensors(vehiclePose.sensors(), sensing, warningProfile.range(), cameraBounds, frame.sensorReadings);
+				sim::readMovingObstacles(vehiclePose.sensors(), movingObstacles, warningProfile.range(), frame.sensorReadings);
+				sensorNoise.apply(sensorPass++, frame.sensorReadings);
+				if (options.ttc) {
+					collisionPredictor.predict(previousCar, car, tickDt, vehiclePose.mounts(), obstacles, obstacleGrid,
+						timeToCollision);
+				}
+				sim::FusionInputs inputs;
+				inputs.readings = &frame.sensorReadings;
+				inputs.echoesSq = options.mapping ? &echoesSq : nullptr;
+				inputs.timeToCollision = options.ttc ? &timeToCollision : nullptr;
+				sensorFusion.fuse(inputs, vehiclePose.mounts(), warningProfile, ttcBands, fused);
+				for (std::size_t i = 0U; i < fused.distanceSq.size(); ++i) {
+					frame.sensorReadings[i].distanceSq = fused.distanceSq[i];
+				}
+				frame.beepIntervals = fused.intervals;
+				frame.sensorLevels = fused.levels;
+				for (std::size_t i = 0U; i < fused.levels.size(); ++i) {
+					if (i >= sensedLevels.size() || fused.levels[i] != sensedLevels[i]) {
+						worldEvents.publish(sim::WorldEventKind::WarningChanged, static_cast<std::uint32_t>(i), fused.levels[i]);
+					}
+				}
+				worldEvents.publish(sim::WorldEventKind::SensorsRead);
+				sensedReadings = frame.sensorReadings;
+				sensedIntervals = frame.beepIntervals;
+				sensedLevels = frame.sensorLevels;
+				sensedPoseVersion = vehiclePose.version();
+				sensedSceneVersion = sceneVersion;
+				sensedStill = still;
+			}
+		}
+
+		{
+			const prof::ScopedPhase phase(frame.phases, prof::Phase::Parking);
+
+			//PARKING INDICATION - GET LOCATION OF THE CAR AND THE INDICATOR
+			if (!stationary) {
+				parkingLot.updateCar(parkingCar, vehiclePose.footprint());
+			}
+			for (const std::uint32_t bay : parkingLot.changedBays()) {
+				worldEvents.publish(sim::WorldEventKind::BayChanged, bay, parkingLot.occupied(bay) ? 1U : 0U);
+				if (occupancyServing) {
+					occupancyServer.setOccupied(bay, parkingLot.occupied(bay));
+				}
+			}
+			if (occupancyServing) {
+				occupancyServer.publish();
+			}
+			parkingLot.clearChanged();
+		}
+
+		frame.eventFrame = worldEvents.endFrame();
+		const sim::WorldEvent* sealedEvents = nullptr;
+		std::size_t sealedCount = 0U;
+		frame.bayOccupied.clear();
+		if (!worldEvents.frameEvents(frame.eventFrame, sealedEvents, sealedCount)) {
+			frame.bayOccupied.resize(parkingLot.bayCount());
+			for (std::uint32_t bay = 0U; bay < frame.bayOccupied.size(); ++bay) {
+				frame.bayOccupied[bay] = parkingLot.occupied(bay) ? 1U : 0U;
+			}
+		}
+
+		// A parked car's beeps keep sounding from the last frame the scheduler took
+		{
+			const prof::ScopedPhase phase(frame.phases, prof::Phase::Beep);
+			bool sensed = false;
+			if (!audioEvents.read(worldEvents, frame.eventFrame, [&sensed](const sim::WorldEvent&) { sensed = true; })) {
+				sensed = true; // a lost frame may have held a sensor pass
+			}
+			const bool probe = latencyProbing && latencyProbe.awaiting(prof::LatencyStage::Play);
+			if (beeps && (sensed || probe || beepsPending)) {
+				beepsPending = !playBeepIfNear(frame.sensorReadings, frame.beepIntervals, vehiclePose.mounts(), probe, *beeps);
+			}
+		}
+
+		if (telemetryOn || telemetryLogging) {
+			bool changed = false;
+			if (!telemetryEvents.read(worldEvents, frame.eventFrame, [&changed](const sim::WorldEvent&) { changed = true; })) {
+				changed = true;
+			}
+			if (changed || static_cast<float>(simTick - telemetryTick) >= constants::TELEMETRY_IDLE_SECONDS * options.tickHz) {
+				telemetryTick = simTick;
+				const io::TelemetryRecord record = makeTelemetryRecord(simTick, car, frame.sensorReadings,
+					parkingLot.occupiedCount(), beeps ? beeps->beepsPlayed() : 0U,
+					beeps ? beeps->counters().report() : prof::AudioReport{});
+				if (telemetryOn) {
+					telemetry.publish(record);
+				}
+				if (telemetryLogging) {
+					io::appendTelemetry(telemetryLog, record);
+				}
+			}
+		}
+
+		frame.previousCar = previousCar;
+		frame.car = car;
+		frame.previousTrailer = previousTrailer;
+		frame.trailer = trailer;
+		frame.alpha = accumulator / tickDt;
+		frame.sensorPoses = vehiclePose.sensors();
+		frame.autoParking = autoParking;
+		const bool backing = (drivenInput & sim::input::BACKWARD) != 0U && (drivenInput & sim::input::FORWARD) == 0U;
+		if (options.model == sim::VehicleModel::Bicycle) {
+			frame.reversing = backing || bicycle.speed < 0.0F;
+			frame.pathCurvature = sim::pathCurvature(bicycle, bicycleParams);
+		}
+		else {
+			frame.reversing = backing;
+			frame.pathCurvature = sim::pathCurvature(drivenInput, carParams);
+		}
+		frame.movers.assign(movingObstacles.movers().begin(), movingObstacles.movers().end());
+	};
+	sim::FramePipeline<FrameSnapshot> pipeline(options.pipelined ? &sim::sharedPool() : nullptr, simulateFrame);
+
+	// The draw side's subscription: occupancy and warning levels as of the frame shown,
+	// kept up to date from the events of each frame instead of recopied whole
+	sim::EventCursor drawEvents(sim::eventMask(sim::WorldEventKind::SensorsRead) | sim::eventMask(sim::WorldEventKind::WarningChanged)
+		| sim::eventMask(sim::WorldEventKind::BayChanged) | sim::eventMask(sim::WorldEventKind::BaysReplaced));
+	std::vector<std::uint8_t> shownBays;
+	std::vector<std::uint32_t> flippedBays; // bays the frames being drawn flipped
+	bool labelsStale = true;
+
+	// Each frame's draws go through one sorted queue: world layers under the camera,
+	// the screen layer under the default view
+	gfx::RenderQueue renderQueue;
+	const sf::View screenView = window.getDefaultView();
+	for (const std::uint8_t layer : { GROUND_LAYER, MARKINGS_LAYER, BODIES_LAYER, OVERLAY_LAYER, LABELS_LAYER }) {
+		renderQueue.setLayerView(layer, &camera);
+	}
+	renderQueue.setLayerView(SCREEN_LAYER, &screenView);
+	// Under --render-scale the screen layer has its own queue, drawn on the window after the upscale
+	gfx::RenderQueue hudQueue;
+	hudQueue.setLayerView(SCREEN_LAYER, &screenView);
+	gfx::RenderQueue& screenQueue = scaling ? hudQueue : renderQueue;
+
+	// The operator view draws the same world layers over the whole lot; it has no screen layer
+	gfx::RenderQueue operatorQueue;
+	for (const std::uint8_t layer : { GROUND_LAYER, MARKINGS_LAYER, BODIES_LAYER, OVERLAY_LAYER }) {
+		operatorQueue.setLayerView(layer, &operatorView.view());
+	}
+	gfx::SpriteBatch operatorBays(spriteAtlas); // every bay, rebuilt when one flips
+
+	// Draws that are not plain drawables; they read the snapshot being drawn, which
+	// under --render-thread may no longer be the pipeline's front
+	const FrameSnapshot* drawnFrame = &pipeline.front();
+	const gfx::DrawCallback drawMovers([&](sf::RenderTarget& target) {
+		const float unitPixels = gfx::pixelsPerUnit(target);
+		for (const sim::Mover& mover : drawnFrame->movers) {
+			moverShape.setPointCount(gfx::circlePointCount(mover.body.radius * unitPixels, MOVER_MAX_POINTS));
+			moverShape.setRadius(mover.body.radius);
+			moverShape.setOrigin({ mover.body.radius, mover.body.radius });
+			moverShape.setPosition(mover.body.center);
+			moverShape.setFillColor((mover.kind == sim::MoverKind::Car) ? constants::moverCarColor : constants::pedestrianColor);
+			target.draw(moverShape);
+		}
+	});
+	const gfx::DrawCallback drawInstanced([&](sf::RenderTarget& target) { instancedRenderer.draw(target); });
+	const gfx::DrawCallback drawBayStates([&](sf::RenderTarget& target) { bayRenderer.draw(target); });
+	const gfx::DrawCallback drawTiled([&](sf::RenderTarget& target) { tileRenderer.draw(target); });
+	const gfx::DrawCallback drawMinimap([&](sf::RenderTarget& target) {
+		minimap.draw(target, carPlacement.getPosition(), camera);
+	});
+	if (pipeline.pipelined()) {
+		pipeline.launch(); // a zero-length frame, so there is a snapshot to draw first
+	}
+
+	// One frame's draw, display and operator view, from the snapshot shown. Under
+	// --render-thread it runs on the render thread while the loop polls events and
+	// simulates the next frame; the loop touches what it reads only after claimRender()
+	prof::PhaseTimes drawPhases; // Draw and Display of the last drawFrame()
+	const auto drawFrame = [&](const FrameSnapshot& shown) {
+		drawArena.reset();
+		drawPhases = {};
+		drawnFrame = &shown;
+		++drawnFrames;
+
+		// Render between the last two ticks
+		const sim::CarState renderCar = sim::interpolate(shown.previousCar, shown.car, shown.alpha);
+		// Every setter marks the sprite's matrix stale, so a parked car sets nothing
+		if (renderCar.position != carPlacement.getPosition()) {
+			carPlacement.setPosition(renderCar.position);
+		}
+		if (renderCar.headingDeg != placedHeadingDeg) {
+			placedHeadingDeg = renderCar.headingDeg;
+			carPlacement.setRotation(sf::degrees(renderCar.headingDeg));
+		}
+		followCamera(camera, renderCar.position, cameraBounds);
+
+		// --dynamic-resolution: the newest frame the GPU has finished picks this frame's scale
+		if (gpuFrameTimer.ready()) {
+			const std::optional<float> gpuMs = gpuFrameTimer.collect();
+			if (gpuMs && dynamicResolution.update(*gpuMs)) {
+				(void)renderScaler.setScale(dynamicResolution.scale());
+			}
+		}
+
+		// ---- Changes since the last frame drawn ----
+		bool sensorsRead = false;
+		bool sensorInstancesDirty = std::exchange(sensorInstancesStale, false);
+		bool baysReplaced = false;
+		flippedBays.clear();
+		const bool replayed = drawEvents.read(worldEvents, shown.eventFrame, [&](const sim::WorldEvent& event) {
+			switch (event.kind) {
+			case sim::WorldEventKind::SensorsRead:
+				sensorsRead = true;
+				break;
+			case sim::WorldEventKind::WarningChanged:
+				if (event.index < sensorStates.size()) {
+					sensorStates[event.index] = static_cast<std::uint8_t>(event.value);
+					sensorInstancesDirty = true;
+				}
+				break;
+			case sim::WorldEventKind::BayChanged:
+				if (event.index < shownBays.size()) {
+					shownBays[event.index] = static_cast<std::uint8_t>(event.value);
+					flippedBays.push_back(event.index);
+				}
+				break;
+			case sim::WorldEventKind::BaysReplaced:
+				shownBays.assign(event.index, 0U);
+				baysReplaced = true;
+				break;
+			default:
+				break;
+			}
+		});
+		if (!replayed) {
+			// A lost frame: the snapshot's full copies stand in for its events
+			shownBays = shown.bayOccupied;
+			std::copy_n(shown.sensorLevels.begin(), std::min(shown.sensorLevels.size(), sensorStates.size()), sensorStates.begin());
+			sensorsRead = true;
+			sensorInstancesDirty = true;
+			baysReplaced = true;
+		}
+
+		// ---- Sensor indicator instances: rebuilt on a transition or a sensor pass that may have moved the rig ----
+		if ((useInstanced || useTiled) && (sensorInstancesDirty || sensorsRead)) {
+			sensorInstancesDirty = true;
+			for (std::size_t i = 0U; i < shown.sensorPoses.size() && i < sensorInstances.size(); ++i) {
+				sensorInstances[i] = gfx::makeSensorInstance(shown.sensorPoses[i], constants::sensorPalette[sensorStates[i]]);
+			}
+		}
+
+		// ---- Rendering ----
+		{
+			const prof::ScopedPhase phase(drawPhases, prof::Phase::Draw);
+			gpuFrameTimer.begin();
+			sf::RenderTarget& sceneTarget = renderScaler.target(window);
+			sceneTarget.clear(constants::background);
+			const sim::ArenaSpan<std::uint32_t> queriedBays = parkingLot.queryBays(
+				{ camera.getCenter() - camera.getSize() / 2.0F, camera.getSize() }, drawArena);
+			if (!std::equal(queriedBays.begin(), queriedBays.end(), visibleBays.begin(), visibleBays.end())) {
+				visibleBays.assign(queriedBays.begin(), queriedBays.end());
+				indicatorsDirty = true;
+			}
+			if (baysReplaced || !flippedBays.empty()) {
+				// Palette bays: every flip is one upload of the state bytes, the outlines stay
+				if (usePaletteBays) {
+					bayRenderer.setStates(shownBays.data(), shownBays.size());
+				}
+				// Only a flip inside the view touches the indicator batch
+				else if (baysReplaced || std::any_of(flippedBays.begin(), flippedBays.end(), [&visibleBays](std::uint32_t bay) {
+					return std::binary_search(visibleBays.begin(), visibleBays.end(), bay);
+				})) {
+					indicatorsDirty = true;
+				}
+				operatorBaysDirty = true;
+				minimap.setOccupied(shownBays);
+			}
+
+			// Static layer: redrawn only after a rebuild or once the camera leaves its margin
+			if (useStaticLayer) {
+				(void)staticLayer.update(camera, [&](sf::RenderTarget& target) {
+					const sf::View& view = target.getView();
+					target.clear(constants::background);
+					target.draw(obstacleRenderer);
+					const sim::ArenaSpan<std::uint32_t> staticBays = parkingLot.queryBays(
+						{ view.getCenter() - view.getSize() / 2.0F, view.getSize() }, drawArena);
+					staticBatch.clear();
+					for (const std::uint32_t bay : staticBays) {
+						staticBatch.addOutline(parkingLot.bay(bay), PARK_OUTLINE_THICKNESS, sf::Color::White);
+					}
+					target.draw(staticBatch);
+				});
+				renderQueue.push(GROUND_LAYER, staticLayer);
+			}
+			if (heatmapOn) {
+				heatmapDt += shown.frameDt;
+				if (drawnFrames % drawQuality.heatmapEvery == 0U) {
+					heatmap.splat(sim::carTransform(shown.car), carHalfExtent, heatmapDt);
+					heatmap.flush();
+					heatmapDt = 0.0F;
+				}
+				renderQueue.push(GROUND_LAYER, heatmap);
+			}
+			if (polygonOutlines.getVertexCount() > 0U) {
+				renderQueue.push(MARKINGS_LAYER, polygonOutlines);
+			}
+			if (shown.autoParking) {
+				renderQueue.push(MARKINGS_LAYER, parkPathLine);
+			}
+			else if (shown.reversing) {
+				guideLines.update(renderCar, carHalfExtent, shown.pathCurvature, -1.0F);
+				renderQueue.push(OVERLAY_LAYER, guideLines);
+			}
+
+			// Sprites and bay indicators share the atlas; the queue keeps them in one run
+			const sf::Texture* atlasPage = (spriteAtlas.pageCount() > 0U) ? &spriteAtlas.page(0U) : nullptr;
+			spriteBatch.clear();
+			if (options.trailer) {
+				const sim::CarState renderTrailer = sim::interpolate(shown.previousTrailer, shown.trailer, shown.alpha);
+				spriteBatch.addBox(sim::carTransform(renderTrailer), trailerParams.halfExtent, constants::trailerColor);
+			}
+			if (carRegion != nullptr) {
+				spriteBatch.addSprite(*carRegion, carPlacement.getTransform());
+			}
+			renderQueue.push(BODIES_LAYER, spriteBatch, atlasPage);
+
+			//DRAW THE PARK INDICATORS; RED ON OCCUPATION
+			if (indicatorsDirty) {
+				indicatorsDirty = false;
+				indicatorBatch.clear();
+				for (const std::uint32_t bay : visibleBays) {
+					const sf::FloatRect& parkRect = parkingLot.bay(bay);
+					// Bays replaced by streaming since this snapshot show as free for a frame
+					const bool occupied = bay < shownBays.size() && shownBays[bay] != 0U;
+					if (!usePaletteBays) {
+						indicatorBatch.addRect(parkRect, occupied ? constants::transRed : constants::transGreen);
+					}
+					if (!useStaticLayer) {
+						indicatorBatch.addOutline(parkRect, PARK_OUTLINE_THICKNESS, sf::Color::White);
+					}
+				}
+			}
+			if (usePaletteBays) {
+				renderQueue.push(MARKINGS_LAYER, drawBayStates);
+			}
+			renderQueue.push(MARKINGS_LAYER, indicatorBatch, atlasPage);
+
+			if (!shown.movers.empty()) {
+				renderQueue.push(BODIES_LAYER, drawMovers);
+			}
+
+			// Sensor cones of the whole rig in one shader pass (F)
+			if (showSensorField) {
+				sensorField.update(shown.sensorPoses, shown.sensorReadings, warningProfile.range(),
+					constants::SENSOR_CONE_HALF_ANGLE);
+				renderQueue.push(OVERLAY_LAYER, sensorField);
+			}
+			if (sceneEditor.dragging()) {
+				renderQueue.push(OVERLAY_LAYER, sceneEditor);
+			}
+			if (useInstanced) {
+				// One buffer update, and only in frames where an indicator changed
+				if (sensorInstancesDirty) {
+					instancedRenderer.updateRange(obstacles.size(), sensorInstances.data(), sensorInstances.size());
+				}
+				renderQueue.push(BODIES_LAYER, drawInstanced);
+			}
+			else if (useTiled) {
+				// The persistent ring hands out a fresh slot each frame, so it is refilled every time
+				tileRenderer.setSensors(sensorInstances.data(), sensorInstances.size());
+				renderQueue.push(BODIES_LAYER, drawTiled);
+			}
+			else if (!useStaticLayer) {
+				renderQueue.push(BODIES_LAYER, obstacleRenderer);
+			}
+			if (showSensorLabels) {
+				// Text and positions only change with a sensor pass; a pass between refreshes waits for the next
+				labelsStale = labelsStale || sensorsRead;
+				if (labelsStale && drawnFrames % drawQuality.labelsEvery == 0U) {
+					labelsStale = false;
+					updateSensorLabels(shown.sensorPoses, shown.sensorReadings, shown.beepIntervals, sensorLabels);
+				}
+				renderQueue.push(LABELS_LAYER, sensorLabels);
+			}
+
+			if (showMinimap) {
+				screenQueue.push(SCREEN_LAYER, drawMinimap);
+			}
+			if (cameraFeedOn) {
+				cameraFeed.update();
+				screenQueue.push(SCREEN_LAYER, cameraFeed);
+			}
+			if (!assetLoader.done()) {
+				screenQueue.push(SCREEN_LAYER, loadingBar);
+			}
+			if (showProfiler) {
+				screenQueue.push(SCREEN_LAYER, profilerOverlay);
+			}
+
+			renderQueue.submit(sceneTarget);
+			if (scaling) {
+				if (effectsOn) {
+					const std::array<gfx::SceneLight, 4> lights = gfx::carLights(renderCar.position, renderCar.headingDeg,
+						carHalfExtent);
+					sceneEffects.update(shown.frameDt, lights.data(), lights.size(), camera, window.getSize());
+				}
+				renderScaler.present(window, sceneEffects.shader());
+				hudQueue.submit(window);
+			}
+			gpuFrameTimer.end();
+		}
+
+		{
+			const prof::ScopedPhase phase(drawPhases, prof::Phase::Display);
+			if (capturing) {
+				capture.capture();
+			}
+			if (pacing) {
+				pacer.wait();
+			}
+			window.display();
+			if (pacing) {
+				pacer.presented();
+			}
+		}
+		startup.firstFrameShown();
+
+		// ---- Operator view: the snapshot just shown, over the whole lot ----
+		// Only its bay quads are its own; textures and vertex buffers are the driver window's
+		if (operatorView.isOpen()) {
+			const prof::ScopedPhase phase(drawPhases, prof::Phase::Draw);
+			const sf::Texture* atlasPage = (spriteAtlas.pageCount() > 0U) ? &spriteAtlas.page(0U) : nullptr;
+			if (operatorBaysDirty) {
+				operatorBaysDirty = false;
+				operatorBays.clear();
+				for (const std::uint32_t bay : parkingLot.queryBays(cameraBounds, drawArena)) {
+					const sf::FloatRect& parkRect = parkingLot.bay(bay);
+					const bool occupied = bay < shownBays.size() && shownBays[bay] != 0U;
+					operatorBays.addRect(parkRect, occupied ? constants::transRed : constants::transGreen);
+					operatorBays.addOutline(parkRect, PARK_OUTLINE_THICKNESS, sf::Color::White);
+				}
+			}
+			if (heatmapOn) {
+				operatorQueue.push(GROUND_LAYER, heatmap);
+			}
+			if (polygonOutlines.getVertexCount() > 0U) {
+				operatorQueue.push(MARKINGS_LAYER, polygonOutlines);
+			}
+			if (shown.autoParking) {
+				operatorQueue.push(MARKINGS_LAYER, parkPathLine);
+			}
+			operatorQueue.push(MARKINGS_LAYER, operatorBays, atlasPage);
+			operatorQueue.push(BODIES_LAYER, obstacleRenderer);
+			operatorQueue.push(BODIES_LAYER, spriteBatch, atlasPage);
+			if (!shown.movers.empty()) {
+				operatorQueue.push(BODIES_LAYER, drawMovers);
+			}
+			if (showSensorField) {
+				operatorQueue.push(OVERLAY_LAYER, sensorField);
+			}
+			operatorView.present(operatorQueue, constants::background);
+			(void)window.setActive(true);
+		}
+
+		// ---- Lazy work, in the slack after presenting ----
+		if (workBudgeted) {
+			if (showMinimap && minimap.pending() && !minimapWorkQueued) {
+				minimapWorkQueued = true;
+				backgroundWork.post(sim::WorkAffinity::MainThread, [&minimap, &minimapWorkQueued]() {
+					minimapWorkQueued = !minimap.renderStale(1U); // one tile per step
+					return !minimapWorkQueued;
+				});
+			}
+			(void)backgroundWork.run(workBudget);
+		}
+	};
+
+	// --render-thread: the window's context moves to the render thread from here on
+	gfx::RenderThread renderThread;
+	if (options.renderThread && !renderThread.start(window)) {
+		std::cerr << "Warning: no render thread, drawing on the main thread\n";
+	}
+	// Waits for the frame being drawn and takes the context back until the next submit
+	const auto claimRender = [&]() {
+		if (renderThread.running()) {
+			renderThread.acquire();
+		}
+	};
+
+	while (window.isOpen()) {
+		// A replay ends with its last recorded frame
+		if (replaying && replayCursor == replay.frameCount()) {
+			OKPP_LOG_INFO("Replay finished: %llu frames in %g s", static_cast<unsigned long long>(replay.frameCount()),
+				static_cast<double>(replayClock.getElapsedTime().asSeconds()));
+			break;
+		}
+		if (replaying && !replay.frame(replayCursor, replayFrame)) {
+			break; // a damaged block ends the replay where it starts
+		}
+
+		// Idle: sleep in the OS until the next event instead of redrawing an unchanged
+		// frame. Beeps need no frames, the audio thread keeps timing them on its own.
+		std::optional<sf::Event> wakeEvent;
+		if (idle && options.onDemand) {
+			// Beeps play on the audio thread either way; the loop wakes with the next one so its
+			// own chores (tuning reloads) keep the beep's cadence, or once a second when silent
+			sf::Time timeout = sf::seconds(constants::ON_DEMAND_MAX_SLEEP_SECONDS);
+			const std::chrono::steady_clock::duration untilBeep = beeps ? beeps->untilNextBeep()
+				: std::chrono::steady_clock::duration::max();
+			if (untilBeep < timeout.toDuration()) {
+				// Zero would wait forever
+				timeout = std::max(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(untilBeep).count()),
+					sf::milliseconds(1));
+			}
+			wakeEvent = window.waitEvent(timeout);
+			clock.restart();
+		}
+		else if (idle) {
+			wakeEvent = window.waitEvent();
+			clock.restart(); // the time spent idle is not simulated
+		}
+
+		profiler.beginFrame();
+		if (options.allocCheck) {
+			allocCheck.beginFrame();
+		}
+
+		// Clamp long frames so a hitch cannot queue up an unbounded number of ticks
+		float frameDt = std::min(clock.restart().asSeconds(), constants::MAX_FRAME_TIME);
+		if (replaying) {
+			frameDt = replayFrame.dt;
+		}
+
+		// ---- Handle events ----
+		bool hadEvents = false;
+		bool hadInput = false; // keys, buttons and the wheel; not pointer moves or focus
+		bool wakeSimulation = false; // something other than input the sleeping simulation must see
+		{
+			const prof::ScopedPhase phase(profiler, prof::Phase::Events);
+			for (std::optional<sf::Event> event = wakeEvent ? std::move(wakeEvent) : window.pollEvent(); event; event = window.pollEvent()) {
+				hadEvents = true;
+				hadInput |= event->is<sf::Event::KeyPressed>() || event->is<sf::Event::KeyReleased>()
+					|| event->is<sf::Event::MouseButtonPressed>() || event->is<sf::Event::MouseWheelScrolled>()
+					|| event->is<sf::Event::Closed>();
+				drivingKeys.update(*event);
+				if (latencyProbing && DrivingKeys::drives(*event)) {
+					(void)latencyProbe.begin();
+				}
+				if (event->is<sf::Event::Closed>()) {
+					claimRender();
+					window.close();
+				}
+				if (sceneEditor.active()) {
+					claimRender(); // the held item's outline is drawn from the editor
+					if (sceneEditor.handle(*event, window, camera, scene, obstacleGrid, parkingLot, editorArena)) {
+						wakeSimulation = true; // a drag is a pointer move, which alone would not wake it
+						continue;
+					}
+				}
+
+				// Window closed or escape key pressed: exit
+				if ((event->is<sf::Event::KeyPressed>() &&
+					event->getIf<sf::Event::KeyPressed>()->code == sf::Keyboard::Key::Space))
+					OKPP_LOG_INFO("KeyPressed event has occured, key pressed is: Space");
+
+				if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+					if (key->code == sf::Keyboard::Key::F3) {
+						claimRender();
+						showProfiler = !showProfiler;
+					}
+					else if (key->code == sf::Keyboard::Key::F4 && profiler.dumpCsv("profile.csv")) {
+						OKPP_LOG_INFO("Frame profile written to profile.csv");
+					}
+					else if (key->code == sf::Keyboard::Key::P) {
+						parkRequested = true;
+					}
+					else if (key->code == sf::Keyboard::Key::E) {
+						claimRender();
+						if (streaming) {
+							OKPP_LOG_WARNING("Warning: the scenario editor is not available with --world");
+						}
+						else {
+							sceneEditor.setActive(!sceneEditor.active());
+							OKPP_LOG_INFO("Scenario editor %s", sceneEditor.active() ? "on" : "off");
+						}
+					}
+					else if (key->code == sf::Keyboard::Key::F5 && sceneEditor.active()
+						&& sim::saveScenario(options.editSavePath, scene))
+					{
+						OKPP_LOG_INFO("Scene written to %s", options.editSavePath.c_str());
+					}
+					else if (key->code == sf::Keyboard::Key::N) {
+						wakeSimulation = true;
+						do {
+							nearestBackend = static_cast<sim::NearestBackend>(
+								(static_cast<std::size_t>(nearestBackend) + 1U) % sim::NEAREST_BACKEND_COUNT);
+						} while (!nearestAvailable(nearestBackend));
+						OKPP_LOG_INFO("Nearest obstacles through %s%s", sim::nearestBackendName(nearestBackend),
+							castRays ? " (the ray caster and the occupancy map still answer first)" : "");
+					}
+					else if (key->code == sf::Keyboard::Key::B) {
+						claimRender();
+						wakeSimulation = true;
+						compareNearest = !compareNearest;
+						if (compareNearest) {
+							nearestComparison.reset();
+						}
+						for (std::size_t b = 0U; !compareNearest && b < sim::NEAREST_BACKEND_COUNT; ++b) {
+							const auto backend = static_cast<sim::NearestBackend>(b);
+							const sim::NearestTally& tally = nearestComparison.tally(backend);
+							if (tally.passes > 0U) {
+								OKPP_LOG_INFO("Nearest %-5s %9.2f us per pass, %6.2f%% agree, max error %.3f",
+									sim::nearestBackendName(backend), tally.microsPerPass(), 100.0 * tally.agreement(),
+									static_cast<double>(tally.maxError));
+							}
+						}
+					}
+					else if (key->code == sf::Keyboard::Key::M) {
+						claimRender();
+						showMinimap = !showMinimap;
+						if (showMinimap && !minimap.ready()) {
+							showMinimap = minimap.create(cameraBounds, constants::WORLD_TILE_SIZE);
+							minimap.setScene(obstacles, scene.parkBays);
+							minimap.setOccupied(shownBays);
+						}
+					}
+					else if (key->code == sf::Keyboard::Key::F) {
+						claimRender();
+						showSensorField = !showSensorField;
+						if (showSensorField && !sensorField.ready()) {
+							showSensorField = sensorField.create(tuning.dangerThreshold, tuning.warningThreshold);
+						}
+					}
+					else if (key->code == sf::Keyboard::Key::H) {
+						claimRender();
+						showSensorLabels = !showSensorLabels;
+						labelsStale = true;
+						if (showSensorLabels && sensorLabels.labelCount() == 0U) {
+							showSensorLabels = sensorLabels.create(constants::SENSOR_LABEL_PIXEL);
+							for (std::size_t i = 0U; showSensorLabels && i < sensorCount; ++i) {
+								(void)sensorLabels.addLabel(constants::sensorLabelColor);
+							}
+						}
+					}
+				}
+				else if (const auto* wheel = event->getIf<sf::Event::MouseWheelScrolled>()) {
+					if (showMinimap && wheel->wheel == sf::Mouse::Wheel::Vertical) {
+						claimRender();
+						minimap.zoom(wheel->delta);
+					}
+				}
+			}
+		}
+
+		// The frame launched last time becomes the one drawn now; the simulation
+		// state is left alone until the next launch
+		{
+			const prof::ScopedPhase phase(profiler, prof::Phase::Wait);
+			pipeline.sync();
+		}
+
+		// ---- Tuning reloads: applied while no frame is being simulated ----
+		if (tuningWatcher) {
+			tuningWatcher->poll();
+			const std::shared_ptr<const sim::TuningSnapshot> reloaded = tuningWatcher->latest();
+			if (reloaded->version != tuningVersion) {
+				claimRender(); // the draw reads the thresholds
+				allocCheck.settle(); // the profile and its tables are rebuilt
+				wakeSimulation = true;
+				tuningVersion = reloaded->version;
+				tuning = reloaded->tuning;
+				carParams = { tuning.carSpeed, tuning.carTurnRate };
+				sensorField.setThresholds(tuning.dangerThreshold, tuning.warningThreshold);
+				sensorFusion.setThresholds({ tuning.dangerThreshold, tuning.warningThreshold });
+				if (sim::createSensorPoses(reloaded->profile.rig()).size() == carSensorCount) {
+					warningProfile = reloaded->profile;
+					sensorCache.invalidate(); // readings were bounded by the old range
+					++sceneVersion;
+				}
+				else {
+					OKPP_LOG_WARNING("Warning: a changed sensor rig needs a restart, keeping the old warning profile");
+				}
+				OKPP_LOG_INFO("Tuning reloaded (version %llu)", static_cast<unsigned long long>(tuningVersion));
+			}
+		}
+
+		// ---- Finished asset decodes (GPU upload stays on this thread) ----
+		if (!assetLoader.done()) {
+			allocCheck.settle(); // decoded assets are still arriving
+		}
+		if (!assetLoader.done() && assetLoader.poll()) {
+			claimRender();
+			if (!spritesReady && buildSpriteAtlas(spriteAssets, assetLoader, atlasOptions, spriteAtlas)) {
+				spritesReady = true;
+				startup.record(prof::StartupPhase::TextureDecode, decodeStart);
+				if (textureCache.enabled()) {
+					const assets::TextureCacheStats cacheStats = textureCache.stats();
+					OKPP_LOG_INFO("Texture cache: %llu hits, %llu misses, %llu stored",
+						static_cast<unsigned long long>(cacheStats.hits), static_cast<unsigned long long>(cacheStats.misses),
+						static_cast<unsigned long long>(cacheStats.stored));
+				}
+				carRegion = spriteAtlas.region(carSpriteName);
+				indicatorsDirty = true; // the white region may have moved
+				operatorBaysDirty = true;
+			}
+			if (carRegion != nullptr && !carPlaced) {
+				carPlaced = true;
+
+				// The cooked texture is stored at world size; the PNG still has to be scaled down,
+				// by what the atlas has not already applied when it packed a smaller level
+				const auto carAsset = std::find_if(spriteAssets.begin(), spriteAssets.end(),
+					[&](const SpriteAsset& sprite) { return sprite.name == carSpriteName; });
+				const float spriteScale = (carAsset != spriteAssets.end() && carAsset->cooked) ? 1.0F : constants::CAR_SPRITE_SCALE;
+				const sf::Vector2f drawScale{ spriteScale / carRegion->scale.x, spriteScale / carRegion->scale.y };
+
+				// Apply the scaling using setScale()
+				const sf::Vector2f carSize(carRegion->rect.size);
+				carPlacement.setScale(drawScale);
+				centerSprite(carPlacement, carSize, window);
+
+				// Sensors, collisions and bays follow the real sprite from now on: its opaque
+				// pixels, not the transparent margin around them
+				carHalfExtent = carSize.componentWiseMul(drawScale) / 2.0F;
+				const sim::CarHull carHull = (carAsset != spriteAssets.end())
+					? spriteHull(*carAsset, assetLoader, carHalfExtent) : sim::boxHull(carHalfExtent);
+				OKPP_LOG_INFO("Car hull: %u vertices, %.0f%% of the sprite rectangle", carHull.count,
+					100.0 * sim::hullArea(carHull) / (4.0 * carHalfExtent.x * carHalfExtent.y));
+				vehiclePose.setShape(carHalfExtent, sim::createSensorMounts(carHull, warningProfile.rig()), carHull);
+				if (options.trailer) {
+					// The hitch moved with the car's rear edge; the trailer re-hitches straight behind it
+					trailer = sim::trailerBehind(car, carHalfExtent, trailerParams);
+					previousTrailer = trailer;
+					vehiclePose.setTrailerPose(trailer);
+				}
+			}
+			if (!beeps && assetLoader.finished(beepSamplePath)) {
+				beeps.emplace(assetLoader.sound(beepSamplePath), &startup, beepLatency);
+				beepsPending = true; // a parked car's beeps start without waiting for a sensor pass
+			}
+			loadingBar.setSize({ static_cast<float>(constants::WINDOW_WIDTH) * static_cast<float>(assetLoader.finishedCount())
+				/ static_cast<float>(assetLoader.requestedCount()), loadingBar.getSize().y });
+		}
+
+		// ---- Auto-park: queue a plan, start driving one that has arrived ----
+		if (parkRequested) {
+			parkRequested = false;
+			if (options.model != sim::VehicleModel::Arcade || replaying || recording || options.trailer || scene.parkBays.empty()) {
+				OKPP_LOG_WARNING("Auto-park needs a bay, the arcade model and no --record, --replay or --trailer");
+			}
+			else if (parkPlanner.request(car, sim::bayGoal(scene.parkBays.front(), car.headingDeg), carHalfExtent,
+				collisionWorld, cameraBounds)) {
+				autoParking = false;
+				OKPP_LOG_INFO("Planning a path into the bay");
+			}
+		}
+		if (parkPlanner.poll(parkPath)) {
+			claimRender(); // the path line is drawn
+			// The plan starts where the car stood when it was requested; a car moved since cannot use it
+			const bool stillAtStart = parkPath.start.position == car.position && parkPath.start.headingDeg == car.headingDeg;
+			if (parkPath.found && stillAtStart) {
+				autoParking = true;
+				parkCursor = 0U;
+				parkPathLine.resize(parkPath.poses.size() + 1U);
+				parkPathLine[0] = sf::Vertex{ car.position, sf::Color::Cyan };
+				for (std::size_t i = 0U; i < parkPath.poses.size(); ++i) {
+					parkPathLine[i + 1U] = sf::Vertex{ parkPath.poses[i].position, sf::Color::Cyan };
+				}
+				OKPP_LOG_INFO("Auto-park path found: %zu ticks after %u expansions", parkPath.inputs.size(),
+					static_cast<unsigned>(parkPath.expansions));
+			}
+			else {
+				OKPP_LOG_WARNING("No auto-park path from here (%u expansions)", static_cast<unsigned>(parkPath.expansions));
+			}
+		}
+
+		// --on-demand, asleep: a wake without input (the beep timeout, a pointer move) leaves the
+		// sensor and parking pipeline stopped and simulates nothing; a window event still redraws
+		if (idle && options.onDemand && !hadInput && !wakeSimulation) {
+			if (hadEvents && window.isOpen()) {
+				drawFrame(pipeline.front());
+				profiler.add(drawPhases);
+			}
+			profiler.endFrame();
+			if (options.allocCheck) {
+				allocCheck.endFrame();
+			}
+			continue;
+		}
+
+		// ---- Update logic (fixed step) ---
+		sim::CarInput input = 0U;
+		{
+			const prof::ScopedPhase phase(profiler, prof::Phase::Input);
+			if (replaying) {
+				input = replayFrame.input;
+				++replayCursor;
+			}
+			else {
+				input = drivingKeys.input();
+			}
+			if (recording) {
+				recorder.append({ frameDt, input });
+			}
+		}
+
+		// Streamed tiles arrive and leave as the car moves
+		if (streaming) {
+			const prof::ScopedPhase phase(profiler, prof::Phase::Simulation);
+			if (world.update(car.position)) {
+				claimRender();
+				parkPlanner.cancel(); // a query still reads the collision world about to be rebuilt
+				allocCheck.settle();
+				scene.obstacles = world.obstacles();
+				scene.parkBays = world.bays();
+				rebuildStaticScene();
+			}
+		}
+
+		// Scenario edits of this frame's events, applied where a streamed rebuild would be
+		std::vector<gfx::SceneEdit> sceneEdits = sceneEditor.takeEdits();
+		if (!sceneEdits.empty()) {
+			const prof::ScopedPhase phase(profiler, prof::Phase::Simulation);
+			claimRender();
+			parkPlanner.cancel(); // a query may still read the collision world being edited
+			allocCheck.settle();
+			for (const gfx::SceneEdit& edit : sceneEdits) {
+				applySceneEdit(edit);
+			}
+		}
+		if (minimapStale && !sceneEditor.dragging()) {
+			claimRender();
+			minimap.setScene(obstacles, scene.parkBays);
+			minimapStale = false;
+		}
+
+		FrameSnapshot& next = pipeline.next();
+		next.input = input;
+		next.frameDt = frameDt;
+		sensing.coneRays = qualityGovernor.knobs().coneRays;
+		if (sensing.backend != nearestBackend) {
+			if (nearestBackend == sim::NearestBackend::Gpu) {
+				while (gpuSensorQuery.collect(nearestComparisonReadings, true)) {
+					// passes left from when it last answered
+				}
+			}
+			sensing.backend = nearestBackend;
+			++sceneVersion; // a standing car is measured again
+		}
+		sensing.comparison = compareNearest ? &nearestComparison : nullptr;
+		if ((compareNearest || sensing.backend == sim::NearestBackend::BruteForce || sensing.backend == sim::NearestBackend::Simd
+			|| sensing.backend == sim::NearestBackend::Bvh) && !nearestEngines.built())
+		{
+			nearestEngines.build(obstacles);
+		}
+		pipeline.launch();
+		const FrameSnapshot& shown = pipeline.front();
+		profiler.add(shown.phases);
+
+		// ---- Rendering ----
+		// Under --render-thread the previous frame may still be drawing: it must be
+		// displayed before anything its draw reads changes
+		if (renderThread.running()) {
+			const prof::ScopedPhase phase(profiler, prof::Phase::Wait);
+			renderThread.wait();
+			profiler.add(drawPhases); // the previous frame's draw, timed on the render thread
+		}
+		drawQuality = qualityGovernor.knobs();
+		obstacleRenderer.setLodBias(drawQuality.lodBias);
+		if (operatorView.isOpen()) {
+			const prof::ScopedPhase phase(profiler, prof::Phase::Events);
+			operatorView.handleEvents();
+		}
+		if (showProfiler) {
+			profilerOverlay.update(profiler, prof::memoryUsage(), beeps ? beeps->counters().report() : prof::AudioReport{},
+				prof::hwCounterReport(), compareNearest ? &nearestComparison : nullptr, nearestBackend);
+		}
+		if (!renderThread.running()) {
+			drawFrame(shown);
+			profiler.add(drawPhases);
+		}
+		else if (window.isOpen()) {
+			renderThread.submit([&drawFrame, &shown]() { drawFrame(shown); });
+		}
+
+		profiler.endFrame();
+		if (options.allocCheck) {
+			allocCheck.endFrame();
+		}
+		if (options.qualityGovernorMs > 0.0F) {
+			// Presentation is left out: the frame limiter and vsync pad it up to the refresh
+			const prof::FrameProfiler::Frame& last = profiler.frame(profiler.size() - 1U);
+			if (qualityGovernor.update(last.totalMs - last.phaseMs[static_cast<std::size_t>(prof::Phase::Display)])) {
+				OKPP_LOG_INFO("Quality level %u (%.1f ms average work)", qualityGovernor.level(),
+					static_cast<double>(qualityGovernor.averageMs()));
+			}
+		}
+		if (!options.stressScene.empty() && ++stressFrames == prof::FrameProfiler::HISTORY) {
+			logStressTimings(options.stressScene, profiler);
+			stressFrames = 0U;
+		}
+
+		// Nothing pending and nothing moved: the frame just shown stays valid. Not with a
+		// render thread, whose frame may still be drawing and whose minimap state it owns
+		idle = (options.adaptive || options.onDemand) && !renderThread.running() && !replaying && !capturing
+			&& !(options.onDemand ? hadInput : hadEvents) && input == 0U
+			&& assetLoader.done() && !showProfiler && !parkPlanner.busy() && shown.movers.empty() && !(showMinimap && minimap.pending()) && backgroundWork.idle()
+			&& shown.car.position == shown.previousCar.position && shown.car.headingDeg == shown.previousCar.headingDeg
+			&& (!streaming || world.pendingTileCount() == 0U) && !operatorView.isOpen();
+	}
+
+	renderThread.stop();
+	capture.stop();
+	cameraFeed.stop();
+	if (!options.stressScene.empty() && profiler.size() > 0U) {
+		logStressTimings(options.stressScene, profiler);
+	}
+	if (backgroundWork.stats().steps > 0U) {
+		OKPP_LOG_INFO("Budgeted work: %llu steps, %llu jobs finished, %llu spilled, longest step %lld us",
+			static_cast<unsigned long long>(backgroundWork.stats().steps),
+			static_cast<unsigned long long>(backgroundWork.stats().finished),
+			static_cast<unsigned long long>(backgroundWork.stats().spilled),
+			static_cast<long long>(backgroundWork.stats().longestStep.count()));
+	}
+	if (sensing.cache != nullptr) {
+		OKPP_LOG_INFO("Sensor cache: %llu readings reused, %llu grid lookups",
+			static_cast<unsigned long long>(sensorCache.reused()), static_cast<unsigned long long>(sensorCache.lookups()));
+	}
+	if (latencyProbing) {
+		latencyProbe.logReport();
+	}
+	if (pacing) {
+		pacer.logReport();
+	}
+	if (options.allocCheck) {
+		allocCheck.logReport();
+	}
+	if (beeps && beeps->beepsPlayed() > 0U) {
+		beeps->counters().logReport();
+	}
+
+	if (recording && recorder.close()) {
+		std::cout << "Recorded " << recorder.frameCount() << " frames to " << options.recordPath << " ("
+			<< recorder.stats().storedBytes << " bytes)\n";
+	}
+	if (telemetryLogging && telemetryLog.close()) {
+		std::cout << "Logged " << telemetryLog.stats().records << " telemetry records to " << options.telemetryLogPath
+			<< " (" << telemetryLog.stats().storedBytes << " of " << telemetryLog.stats().rawBytes << " bytes)\n";
 	}
 
 	return 0;
@@ -1,100 +1,261 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "/usr/include/GL/glut.h"
-#include "/usr/include/sndfile.hh"
 
 #include <math.h>
-#include <iostream>
-#include <pthread.h>
 #include <unistd.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <ctype.h>
 #include <errno.h>
 #include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "/usr/include/GL/freeglut_ext.h"
+
+#include "GlFunctions.hpp"
+#include "GpuTextures.hpp"
+#include "Log.hpp"
+#include "QuadRenderer.hpp"
+#include "SensorFusion.hpp"
+#include "SensorIngest.hpp"
+#include "SndfileBeep.hpp"
+#include "Trace.hpp"
+#include "WarningArcs.hpp"
 
 using namespace std;
 void display(void);
 void reshape(int, int);
-void idle();
 void readSensors(unsigned char, int, int);
-int zvuk = 0;
-
-unsigned char* loadPPM(const char* filename, int& width, int& height) {
-	const int BUFSIZE = 128;
-	FILE* fp;
-	unsigned int read;
-	unsigned char* rawData;
-	char buf[3][BUFSIZE];
-	char* retval_fgets;
-	size_t retval_sscanf;
-	if((fp = fopen(filename, "rb")) == NULL) {
-		std::cerr << "error reading ppm file, could not locate " << filename << std::endl;
-		width = 0;
-		height = 0;
-		return NULL;
-	}
-	retval_fgets = fgets(buf[0], BUFSIZE, fp);
-	do {
-		retval_fgets = fgets(buf[0], BUFSIZE, fp);
-	} while(buf[0][0] == '#');
-	retval_sscanf = sscanf(buf[0], "%s %s", buf[1], buf[2]);
-	width = atoi(buf[1]);
-	height = atoi(buf[2]);
-	do {
-		retval_fgets = fgets(buf[0], BUFSIZE, fp);
-	} while(buf[0][0] == '#');
-	rawData = new unsigned char[width * height * 3];
-	read = fread(rawData, width * height * 3, 1, fp);
-	fclose(fp);
-	if(read != 1) {
-		std::cerr << "error parsing ppm file, incomplete data" << std::endl;
-		delete[] rawData;
-		width = 0;
-		height = 0;
-		return NULL;
-	}
-	return rawData;
+void pollSensors(int);
+// Beep level and bars, written by pollSensors() only; the audio thread and display() read snapshots
+audio::WarningStateBlock warningState;
+std::uint32_t shownVersion = 0; // warningState version of the last redraw request
+audio::SndfileBeepPlayer beepPlayer;
+int selectedLevel = 0; // last level from the keyboard or the sensor stream, applied by pollSensors()
+io::SensorIngest sensorIngest; // real readings (--sensor-udp, --sensor-serial)
+
+// Nearest echo in metres up to which beep levels 1 (closest) to 3 apply
+const float LEVEL_DISTANCES_M[] = { 0.30f, 0.60f, 1.00f };
+
+// Streamed channels fused like the simulation's sensors: all rear, no map echoes, no TTC
+sim::SensorFusion sensorFusion({ LEVEL_DISTANCES_M[0], LEVEL_DISTANCES_M[1] });
+sim::FusedWarnings fusedWarnings;
+std::vector<sim::SensorReading> channelReadings;
+std::vector<sim::SensorMount> channelMounts;
+const sim::WarningProfile silentProfile; // the level, not the interval, drives the beep here
+const std::vector<sim::TtcBand> noTtcBands;
+unsigned int pollPeriodMs = 16; // sensor poll tick (--tick-ms)
+
+// Binary PPM (P6, maxval 255) mapped read-only; pixels point into the mapping
+struct MappedPPM {
+	void* mapping;
+	size_t size;
+	const unsigned char* pixels;
+	int width;
+	int height;
+};
+
+void unmapPPM(MappedPPM& image) {
+	if(image.mapping != NULL) {
+		munmap(image.mapping, image.size);
+	}
+	image.mapping = NULL;
+	image.pixels = NULL;
+	image.width = 0;
+	image.height = 0;
 }
 
+// Next header number: skips whitespace and '#' comments, advances pos past the digits
+bool readPPMNumber(const unsigned char* data, size_t size, size_t& pos, int& value) {
+	while(pos < size && (isspace(data[pos]) || data[pos] == '#')) {
+		if(data[pos] == '#') {
+			while(pos < size && data[pos] != '\n') ++pos;
+		} else {
+			++pos;
+		}
+	}
+	if(pos >= size || !isdigit(data[pos])) return false;
+	value = 0;
+	while(pos < size && isdigit(data[pos]) && value < 100000) {
+		value = value * 10 + (data[pos] - '0');
+		++pos;
+	}
+	return true;
+}
 
+// Maps the file and parses the header in place, without copying the pixel data
+bool mapPPM(const char* filename, MappedPPM& image) {
+	image.mapping = NULL;
+	unmapPPM(image);
+	const int fd = open(filename, O_RDONLY);
+	if(fd < 0) {
+		OKPP_LOG_ERROR("error reading ppm file, could not locate %s", filename);
+		return false;
+	}
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size < 2) {
+		close(fd);
+		OKPP_LOG_ERROR("error parsing ppm file, %s is empty", filename);
+		return false;
+	}
+	image.size = static_cast<size_t>(info.st_size);
+	void* mapping = mmap(NULL, image.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping stays valid after the descriptor is closed
+	if(mapping == MAP_FAILED) {
+		OKPP_LOG_ERROR("error reading ppm file, mmap failed: %s", strerror(errno));
+		return false;
+	}
+	image.mapping = mapping;
 
+	const unsigned char* data = static_cast<const unsigned char*>(mapping);
+	size_t pos = 2;
+	int maxValue = 0;
+	if(data[0] != 'P' || data[1] != '6'
+		|| !readPPMNumber(data, image.size, pos, image.width)
+		|| !readPPMNumber(data, image.size, pos, image.height)
+		|| !readPPMNumber(data, image.size, pos, maxValue)
+		|| maxValue != 255 || image.width <= 0 || image.height <= 0) {
+		OKPP_LOG_ERROR("error parsing ppm file, unsupported header in %s", filename);
+		unmapPPM(image);
+		return false;
+	}
+	++pos; // exactly one whitespace byte separates the header from the pixels
+	const size_t pixelBytes = static_cast<size_t>(image.width) * static_cast<size_t>(image.height) * 3;
+	if(pos > image.size || image.size - pos < pixelBytes) {
+		OKPP_LOG_ERROR("error parsing ppm file, incomplete data");
+		unmapPPM(image);
+		return false;
+	}
+	image.pixels = data + pos;
+	return true;
+}
+
+// Background quad corners, textured with the car image
+const gfx::QuadVertex BACKGROUND_QUAD[] = {
+	{ -2.0f, -1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f },
+	{ 2.0f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f },
+	{ 2.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f },
+	{ -2.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f },
+};
+
+// The rear-left parking sensor on the car image, facing away from the corner
+const gfx::WarningArcSensor REAR_LEFT_SENSOR = { -0.94f, -0.18f, 3.63f };
+
+gfx::QuadRenderer sceneRenderer;
+gfx::QuadQueue sceneQueue; // sorted and merged like the SFML front-end's render queue
+gfx::WarningArcLayout warningArcs;
+gfx::GpuTextures gpuTextures; // streamed in by display(), deleted with the manager
+gfx::TextureHandle sceneTexture;
+MappedPPM sceneImage; // mapped until its texture is uploaded
+
+// Locks glutSwapBuffers() to the display refresh where the driver allows it
+void enableVsync() {
+	typedef int (*SwapIntervalFn)(int);
+	const SwapIntervalFn swapInterval = reinterpret_cast<SwapIntervalFn>(glutGetProcAddress("glXSwapIntervalSGI"));
+	if(swapInterval == NULL || swapInterval(1) != 0) {
+		OKPP_LOG_WARNING("Warning: could not enable vsync, redraws are limited by input only");
+	}
+}
+
+// Uploads the background and every sensor's warning arcs once; needs initGL() first
+void initScene() {
+	std::vector<gfx::QuadVertex> triangles;
+	gfx::appendQuad(triangles, BACKGROUND_QUAD[0], BACKGROUND_QUAD[1], BACKGROUND_QUAD[2], BACKGROUND_QUAD[3]);
+	warningArcs = gfx::appendWarningArcs(triangles, { REAR_LEFT_SENSOR }, gfx::WarningArcStyle{});
+	sceneRenderer.upload(triangles);
+}
 
+// Draw layers, back to front
+const std::uint8_t BACKGROUND_LAYER = 0;
+const std::uint8_t BARS_LAYER = 1;
 
+// Textured background plus the barCount farthest-first warning bars (0..3): one range per sensor
+void drawScene(int barCount) {
+	sceneQueue.push(BACKGROUND_LAYER, { 0, gfx::QUAD_TRIANGLE_VERTICES, gpuTextures.texture(sceneTexture) });
+	for(size_t sensor = 0; sensor < warningArcs.sensors; ++sensor) {
+		const gfx::WarningArcRange bars = warningArcs.range(sensor, static_cast<std::uint32_t>(barCount));
+		sceneQueue.push(BARS_LAYER, { bars.first, bars.count, 0 });
+	}
+	sceneQueue.submit(sceneRenderer);
+}
 
+// Core-profile state only: the shader pair replaces shading, texturing and
+// smoothing state, and edges are antialiased by the multisampled framebuffer
 void initGL() {
-	glEnable(GL_TEXTURE_2D); // enable texture mapping
-	glShadeModel(GL_SMOOTH); // enable smooth shading
+	if(!sceneRenderer.init([](const char* name) { return reinterpret_cast<gl::ProcAddress>(glutGetProcAddress(name)); })) {
+		OKPP_LOG_ERROR("Error: the GL variant needs an OpenGL 3.3 core context");
+		exit(EXIT_FAILURE);
+	}
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // get clear background (black color)
 	glClearDepth(1.0f); // color depth buffer
 	glDepthFunc(GL_LEQUAL); // configuration of depth testing
-	//enable additional options regarding: perspective correction, anti-aliasing, etc
-	glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
-	glEnable(GL_LINE_SMOOTH);
-	glEnable(GL_POLYGON_SMOOTH);
-	glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
-	glHint(GL_POLYGON_SMOOTH_HINT, GL_NICEST);
+	glEnable(gl::MULTISAMPLE);
+	// orthographic projection with 4x4 unit square canvas
+	sceneRenderer.setOrtho(-2.0f, 2.0f, -2.0f, 2.0f);
 }
 
+// Only queues the upload: display() streams it in under the frame budget,
+// and the background draws untextured until the last row is in
 void loadTexture() {
-	GLuint texture[1]; // declaring space for one texture
-	int twidth, theight; // declaring variable for width and height of an image
-	unsigned char* tdata; // declaring pixel data
-	// loading image data from specific file:
-	tdata = loadPPM("auto3.ppm", twidth, theight);
-	if(tdata == NULL) return; // check if image data is loaded
-	// generating a texture to show the image
-	glGenTextures(1, &texture[0]);
-	glBindTexture(GL_TEXTURE_2D, texture[0]);
-	glTexImage2D(GL_TEXTURE_2D, 0, 3, twidth, theight, 0, GL_RGB, GL_UNSIGNED_BYTE,
-				 tdata);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// pixel data stays in the page cache, no host copy
+	if(!mapPPM("auto3.ppm", sceneImage)) return; // check if image data is loaded
+	gfx::TextureSource source;
+	source.width = sceneImage.width;
+	source.height = sceneImage.height;
+	source.internalFormat = GL_RGB8;
+	source.format = GL_RGB; // PPM rows are tightly packed RGB
+	source.bytesPerPixel = 3;
+	source.pixels = sceneImage.pixels;
+	// the driver has its own copy once uploaded, release the mapping then
+	source.done = []() { unmapPPM(sceneImage); };
+	sceneTexture = gpuTextures.request(std::move(source));
 }
 
 int main(int argc, char** argv) {
 	/* 1) INITIALIZATION */
 	// initialize GLUT
 	glutInit(&argc, argv);
+	// console messages are written by a background thread, flushed on exit
+	logging::startLogging();
+	atexit([]() { logging::stopLogging(); });
+	// optional "--chrome-trace [file]": record the callbacks, written on exit
+	// optional "--beep <file>": beep sample played at the warning level's cadence
+	// optional "--tick-ms <n>": sensor poll period in milliseconds
+	// optional "--sensor-udp <port>" / "--sensor-serial <device>": real sensor frames
+	const char* beepPath = "assets/beep.mp3";
+	for(int i = 1; i < argc; ++i) {
+		if(strcmp(argv[i], "--chrome-trace") == 0) {
+			prof::startTracing((i + 1 < argc) ? argv[i + 1] : "trace.json");
+			prof::setThreadName("glut");
+			atexit([]() { (void)prof::stopTracing(); });
+		}
+		else if(strcmp(argv[i], "--beep") == 0 && i + 1 < argc) {
+			beepPath = argv[++i];
+		}
+		else if(strcmp(argv[i], "--sensor-udp") == 0 && i + 1 < argc) {
+			(void)sensorIngest.openUdp(static_cast<unsigned short>(atoi(argv[++i])));
+		}
+		else if(strcmp(argv[i], "--sensor-serial") == 0 && i + 1 < argc) {
+			(void)sensorIngest.openSerial(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+			const int period = atoi(argv[++i]);
+			if(period > 0) {
+				pollPeriodMs = static_cast<unsigned int>(period);
+			}
+		}
+	}
+	// decoded once up front; without a sample or a device the variant runs silent
+	if(beepPlayer.load(beepPath)) {
+		(void)beepPlayer.start(warningState);
+	}
 	// set window position and size
 	glutInitWindowPosition(545, 180);
 	glutInitWindowSize(720, 720);
@@ -102,7 +263,12 @@ int main(int argc, char** argv) {
 	// set color space (Red, Green, Blue - RGB)
 	// alocate depth buffer
 	// set the size of the buffer (double)
-	glutInitDisplayMode(GLUT_RGB | GLUT_DEPTH | GLUT_DOUBLE);
+	// multisampled, so quad edges are antialiased without polygon smoothing
+	glutInitDisplayMode(GLUT_RGB | GLUT_DEPTH | GLUT_DOUBLE | GLUT_MULTISAMPLE);
+	// OpenGL 3.3 core profile: no fixed-function state for the driver to emulate
+	glutInitContextVersion(3, 3);
+	glutInitContextProfile(GLUT_CORE_PROFILE);
+	glutInitContextFlags(GLUT_FORWARD_COMPATIBLE);
 	// create window
 	glutCreateWindow("Screen");
 	/* 2) REGISTRATION OF CALLBACK FUNCTION */
@@ -110,137 +276,104 @@ int main(int argc, char** argv) {
 	glutDisplayFunc(display);
 	// function called when window changes the size
 	glutReshapeFunc(reshape);
-	// function called when nothing else is executing and CPU is free
-	glutIdleFunc(idle);
+	// no idle callback: GLUT would spin it nonstop; sensors are polled on a timer instead
+	glutTimerFunc(pollPeriodMs, pollSensors, 0);
 	// function called when keyboard key is pressed
 	glutKeyboardFunc(readSensors); // custom function 'readSensors' can	be implemented separately
-	loadTexture();
 	initGL();
+	loadTexture();
+	initScene();
+	enableVsync();
 	/* 3) START GLUT PROCESSING CYCLE */
 	glutMainLoop();
 	return 0;
 }
 
 
+// Input only records the selected level; pollSensors() applies it on its next tick
 void readSensors(unsigned char key, int x, int y) {
+	OKPP_TRACE_SCOPE("readSensors");
 	switch(key) {
-		case 'e':
-			zvuk = 1;
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			glBegin(GL_QUADS);
-			// drawing a background white rectangle
-			glColor3f(1, 1, 1); // choosing a color
-			glTexCoord2f(0, 1); glVertex3f(-2, -1, 0);
-			glTexCoord2f(1, 1); glVertex3f(2, -1, 0);
-			glTexCoord2f(1, 0); glVertex3f(2, 1, 0);
-			glTexCoord2f(0, 0); glVertex3f(-2, 1, 0);
-			glEnd();
-			// drawing a rectangle
-			glColor3f(1.0, 0.0, 0.0);
-			glBegin(GL_QUADS);
-			glVertex3f(-1.22f, -0.20f, 0.0f);
-			glVertex3f(-1.15f, -0.16f, 0.0f);
-			glVertex3f(-1.03f, -0.36f, 0.0f);
-			glVertex3f(-1.1f, -0.40f, 0.0f);
-			// drawing a rectangle
-			glColor3f(1.0, 0.35, 0.35);
-			glVertex3f(-1.35f, -0.20f, 0.00f);
-			glVertex3f(-1.28f, -0.16f, 0.0f);
-			glVertex3f(-1.09f, -0.46f, 0.00f);
-			glVertex3f(-1.15f, -0.50f, 0.0f);
-			// drawing a rectangle
-			glColor3f(1.0, 0.50, 0.50);
-			glVertex3f(-1.48f, -0.21f, 0.0f);
-			glVertex3f(-1.40f, -0.16f, 0.0f);
-			glVertex3f(-1.14f, -0.55f, 0.0f);
-			glVertex3f(-1.22f, -0.60f, 0.0f);
-			glEnd();
-			glutSwapBuffers();
-			break;
-		case 'w':
-			zvuk = 2;
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			glBegin(GL_QUADS);
-			// drawing a background white rectangle
-			glColor3f(1, 1, 1); // choosing a color
-			glTexCoord2f(0, 1); glVertex3f(-2, -1, 0);
-			glTexCoord2f(1, 1); glVertex3f(2, -1, 0);
-			glTexCoord2f(1, 0); glVertex3f(2, 1, 0);
-			glTexCoord2f(0, 0); glVertex3f(-2, 1, 0);
-			// drawing a rectangle
-			glColor3f(1.0, 0.35, 0.35);
-			glVertex3f(-1.35f, -0.20f, 0.00f);
-			glVertex3f(-1.28f, -0.16f, 0.0f);
-			glVertex3f(-1.09f, -0.46f, 0.00f);
-			glVertex3f(-1.15f, -0.50f, 0.0f);
-			// drawing a rectangle
-			glColor3f(1.0, 0.50, 0.50);
-			glVertex3f(-1.48f, -0.21f, 0.0f);
-			glVertex3f(-1.40f, -0.16f, 0.0f);
-			glVertex3f(-1.14f, -0.55f, 0.0f);
-			glVertex3f(-1.22f, -0.60f, 0.0f);
-			glEnd();
-			glutSwapBuffers();
-			break;
-		case 'q':
-			zvuk = 3;
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			glBegin(GL_QUADS);
-			// drawing a background white rectangle
-			glColor3f(1, 1, 1); // choosing a color
-			glTexCoord2f(0, 1); glVertex3f(-2, -1, 0);
-			glTexCoord2f(1, 1); glVertex3f(2, -1, 0);
-			glTexCoord2f(1, 0); glVertex3f(2, 1, 0);
-			glTexCoord2f(0, 0); glVertex3f(-2, 1, 0);
-			// drawing a rectangle
-			glColor3f(1.0, 0.50, 0.50);
-			glVertex3f(-1.48f, -0.21f, 0.0f);
-			glVertex3f(-1.40f, -0.16f, 0.0f);
-			glVertex3f(-1.14f, -0.55f, 0.0f);
-			glVertex3f(-1.22f, -0.60f, 0.0f);
-			glEnd();
-			glutSwapBuffers();
-			break;
-		case 'r':
-			zvuk = 0;
-			display();
-			break;
+		case 'e': selectedLevel = 1; break;
+		case 'w': selectedLevel = 2; break;
+		case 'q': selectedLevel = 3; break;
+		case 'r': selectedLevel = 0; break;
 	}
 }
+
+// Beep level of a streamed sample: the fused rear zone's danger and caution give
+// levels 1 and 2, a nearest fused echo within the last band level 3
+int levelForSample(const io::SensorSample& sample) {
+	channelReadings.assign(sample.count, sim::SensorReading{});
+	channelMounts.assign(sample.count, sim::SensorMount{});
+	for(size_t i = 0; i < sample.count; ++i) {
+		if(sample.distanceMm[i] != io::NO_ECHO_MM) {
+			const float meters = static_cast<float>(sample.distanceMm[i]) * 0.001f;
+			channelReadings[i].distanceSq = meters * meters;
+		}
+		channelMounts[i].zone = sim::SensorZone::Rear;
+	}
+	sim::FusionInputs inputs;
+	inputs.readings = &channelReadings;
+	sensorFusion.fuse(inputs, channelMounts, silentProfile, noTtcBands, fusedWarnings);
+
+	const std::uint8_t zoneLevel = fusedWarnings.zoneLevels[static_cast<size_t>(sim::SensorZone::Rear)];
+	if(zoneLevel == sim::WARNING_LEVEL_DANGER) {
+		return 1;
+	}
+	if(zoneLevel == sim::WARNING_LEVEL_CAUTION) {
+		return 2;
+	}
+	float nearestSq = std::numeric_limits<float>::max();
+	for(const float distanceSq : fusedWarnings.distanceSq) {
+		nearestSq = std::min(nearestSq, distanceSq);
+	}
+	return (nearestSq <= LEVEL_DISTANCES_M[2] * LEVEL_DISTANCES_M[2]) ? 3 : 0;
+}
+
+// Sensor tick: reads the current level and redraws only when it changed,
+// so the window sleeps between ticks instead of spinning an idle callback
+void pollSensors(int) {
+	OKPP_TRACE_SCOPE("pollSensors");
+	// newest streamed sample, if one arrived since the last tick; never blocks
+	io::SensorSample sample;
+	if(sensorIngest.latest(sample)) {
+		selectedLevel = levelForSample(sample);
+	}
+	const int level = selectedLevel;
+	if(level != warningState.load().level) {
+		audio::WarningState state;
+		state.level = level;
+		state.bars = (level == 0) ? 0 : 4 - level; // level 1 (nearest) shows all three bars
+		warningState.store(state);
+	}
+	// one redraw per published change, whoever published it
+	const std::uint32_t version = warningState.version();
+	if(version != shownVersion) {
+		shownVersion = version;
+		glutPostRedisplay();
+	}
+	glutTimerFunc(pollPeriodMs, pollSensors, 0);
+}
 void display() {
-	cerr << "display callback" << endl;
+	OKPP_TRACE_SCOPE("display");
+	// finish deferred deletions and stream queued texture rows within the budget
+	gpuTextures.beginFrame();
 	// clean color buffers
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	// start drawing quads
-	glBegin(GL_QUADS);
-	// choose color (white)
-	glColor3f(1, 1, 1);
-	// coordinates of initial white rectangle for the background
-	glTexCoord2f(0, 1); glVertex3f(-2, -1, 0);
-	glTexCoord2f(1, 1); glVertex3f(2, -1, 0);
-	glTexCoord2f(1, 0); glVertex3f(2, 1, 0);
-	glTexCoord2f(0, 0); glVertex3f(-2, 1, 0);
-	// end of drawing
-	glEnd();
+	// white background rectangle plus the bars of the current warning level
+	drawScene(warningState.load().bars);
 	// swap buffers to show new graphics
 	glutSwapBuffers();
+	// redraws are driven by warning changes; keep drawing while uploads are pending
+	if(gpuTextures.stats().queued > 0) {
+		glutPostRedisplay();
+	}
 }
 
-
 void reshape(int width, int height) {
-	cerr << "reshape callback" << endl;
-	// specify the desired rectangle
+	OKPP_TRACE_SCOPE("reshape");
+	OKPP_LOG_INFO("reshape callback %dx%d", width, height);
+	// specify the desired rectangle; the projection is fixed and set in initGL()
 	glViewport(0, 0, width, height);
-	// switch to matrix projection
-	glMatrixMode(GL_PROJECTION);
-	// clean projection matrix
-	glLoadIdentity();
-	// set camera view (orthographic projection with 4x4 unit square canvas)
-	glOrtho(-2, 2, -2, 2, 2, -2);
-	// swith back to matrix
-	glMatrixMode(GL_MODELVIEW);
-}
-
-void idle() {
-	// here comes the code which will be executed when program state is idle
 }
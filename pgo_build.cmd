@@ -0,0 +1,66 @@
+@echo off
+rem ==========================================================================
+rem PGO build - profile-guided Release build of OKPP_LV1_sample
+rem ==========================================================================
+rem  - Builds an instrumented Release binary, trains it on the canonical
+rem    headless runs below (single car on both traces and both vehicle
+rem    models, a fleet, a Monte-Carlo evaluation), then re-links with the
+rem    collected profile so the sensor queries, parking checks and sweep
+rem    loops are laid out for their real branch behaviour
+rem  - Drive recordings (--record <file>) given as arguments are replayed in
+rem    the window as well, which trains the rendering submission path
+rem  - Run from a Developer Command Prompt:
+rem      pgo_build.cmd [x64^|Win32] [recording ...]
+rem ==========================================================================
+setlocal
+
+set PLATFORM=x64
+if /i "%~1"=="x64" (set PLATFORM=x64& shift)
+if /i "%~1"=="Win32" (set PLATFORM=Win32& shift)
+
+set ROOT=%~dp0
+set PROJECT=%ROOT%OKPP_LV1_sample.vcxproj
+if /i "%PLATFORM%"=="x64" (set OUTDIR=%ROOT%x64\Release\) else (set OUTDIR=%ROOT%Release\)
+set EXE=%OUTDIR%OKPP_LV1_sample.exe
+
+echo === Instrumented build (%PLATFORM%)
+msbuild "%PROJECT%" /m /t:Rebuild /p:Configuration=Release /p:Platform=%PLATFORM% /p:PgoPhase=Instrument /v:minimal || goto :failed
+del /q "%OUTDIR%*.pgc" 2>nul
+
+rem The instrumented binary needs the PGO runtime next to it
+if /i "%PLATFORM%"=="x64" (set PGORT=%VCToolsInstallDir%bin\Hostx64\x64\pgort140.dll) else (set PGORT=%VCToolsInstallDir%bin\Hostx64\x86\pgort140.dll)
+if exist "%PGORT%" copy /y "%PGORT%" "%OUTDIR%" >nul
+
+echo === Training runs
+pushd "%ROOT%"
+call :train --headless --repeat 20 || goto :failedPop
+call :train --headless --repeat 20 --bicycle || goto :failedPop
+call :train --headless assets\park_maneuver.txt --tick-hz 60 --repeat 50 || goto :failedPop
+call :train --headless assets\park_maneuver.txt --tick-hz 60 --repeat 50 --bicycle || goto :failedPop
+call :train --fleet 512 --repeat 4 || goto :failedPop
+call :train --fleet 512 --repeat 4 --bicycle || goto :failedPop
+call :train --evaluate 5000 assets\park_maneuver.txt --tick-hz 60 || goto :failedPop
+:recordings
+if "%~1"=="" goto :trained
+call :train --replay "%~1" || goto :failedPop
+shift
+goto :recordings
+:trained
+popd
+
+echo === Optimized link with the collected profile
+rem Build, not Rebuild: a clean would delete the .pgd; the changed link line is enough to relink
+msbuild "%PROJECT%" /m /t:Build /p:Configuration=Release /p:Platform=%PLATFORM% /p:PgoPhase=Optimize /v:minimal || goto :failed
+echo PGO build done: %EXE%
+exit /b 0
+
+:train
+echo --- %*
+"%EXE%" %* >nul
+exit /b %errorlevel%
+
+:failedPop
+popd
+:failed
+echo PGO build failed
+exit /b 1